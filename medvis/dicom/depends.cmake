@@ -1,4 +1,6 @@
 #--------------------------------------------------------------------
 # Dependencies for current module
 set(dependencies
+    InviwoMemoryBudgetModule
+    InviwoUtilitiesModule
 )
@@ -32,15 +32,18 @@
 #include <inviwo/core/common/inviwo.h>
 
 #include <vector>
+#include <optional>
 #include <ostream>
 
 #include <warn/push>
 #include <warn/ignore/all>
 #include <MediaStorageAndFileFormat/gdcmPixelFormat.h>
+#include <MediaStorageAndFileFormat/gdcmPhotometricInterpretation.h>
 #include <warn/pop>
 
 namespace gdcm {
 class DataSet;
+class File;
 class ImageReader;
 }  // namespace gdcm
 
@@ -78,6 +81,13 @@ struct IVW_MODULE_DICOM_API Image {
      * @param reader     reader used to load the image
      */
     void updateInfo(const gdcm::ImageReader& reader);
+    /**
+     * update the image info from corresponding tags in the gdcm \p file, which only needs to
+     * contain the header of the image
+     *
+     * @param file     file of the image
+     */
+    void updateInfo(const gdcm::File& file);
 
     /**
      * compute z coordinate of the image slice
@@ -86,6 +96,28 @@ struct IVW_MODULE_DICOM_API Image {
     void updateZpos();
 };
 
+/**
+ * Information about a DICOM image file which is read from its header only, i.e. all tags in front
+ * of the pixel data. Reading the header is much faster than reading the image, in particular for
+ * compressed images.
+ */
+struct IVW_MODULE_DICOM_API ImageHeader {
+    std::string seriesUID;
+    std::string modality;
+    Image image;
+    gdcm::PixelFormat pixelformat;
+    gdcm::PhotometricInterpretation photometric;
+    double intercept = 0.0;
+    double slope = 1.0;
+
+    /**
+     * read the header of the DICOM image file at \p path
+     *
+     * @return the header, or std::nullopt if the file is no DICOM image
+     */
+    static std::optional<ImageHeader> read(const std::string& path);
+};
+
 struct IVW_MODULE_DICOM_API Series {
     Series() = default;
     Series(const std::string& description);
@@ -93,7 +125,8 @@ struct IVW_MODULE_DICOM_API Series {
     /**
      * try to read every image of the \p series and update its metadata (image dimension, origin,
      * etc.). The following series properties will be updated accordingly: dimensions, pixel format,
-     * slope, and intercept.
+     * slope, and intercept. Only the headers of the images are read, in parallel and through the
+     * GdcmScanIndex, such that unchanged files are not read again.
      *
      * Also applies sanity checks across all images of the DICOM series. According to the
      * standard the following parameters should be the same for all images within the series:
@@ -111,6 +144,12 @@ struct IVW_MODULE_DICOM_API Series {
      * @see dicomdir::Image
      */
     void updateImageInformation(const std::string& dicompath = "");
+    /**
+     * same as updateImageInformation(const std::string&) with the already read \p headers of the
+     * images, std::nullopt for files which are no DICOM images.
+     */
+    void updateImageInformation(const std::vector<std::optional<ImageHeader>>& headers,
+                                const std::string& dicompath = "");
 
     /**
      * sort images by slice position in patient coords (zPos)
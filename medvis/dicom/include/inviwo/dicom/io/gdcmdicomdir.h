@@ -0,0 +1,119 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/dicom/dicommoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/dicom/datastructures/dicomdirtypes.h>
+#include <inviwo/dicom/io/gdcmvolumereader.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Lazily loaded patient/study/series tree of a DICOMDIR
+ * Opening a DICOMDIR only parses its directory records into the tree, with the paths of the
+ * images of each series, but without touching the images themselves. The metadata of a series
+ * and its volume description are created on demand, when a series is selected through
+ * getVolume or getVolumes. The headers of all series requested together are scanned in one
+ * parallel pass through the GdcmScanIndex.
+ */
+class IVW_MODULE_DICOM_API GdcmDicomDir {
+public:
+    /**
+     * Position of a series in the tree, as indices into getPatients(), Patient::studies, and
+     * Study::series.
+     */
+    struct SeriesRef {
+        size_t patient = 0;
+        size_t study = 0;
+        size_t series = 0;
+        bool operator<(const SeriesRef& rhs) const {
+            return std::tie(patient, study, series) < std::tie(rhs.patient, rhs.study, rhs.series);
+        }
+        bool operator==(const SeriesRef& rhs) const {
+            return std::tie(patient, study, series) == std::tie(rhs.patient, rhs.study, rhs.series);
+        }
+    };
+
+    /**
+     * Parses the directory records of the DICOMDIR \p path. Returns nullptr if \p path is no
+     * DICOMDIR and throws a DataReaderException if it cannot be opened.
+     * @param options used for decoding the volumes created by getVolume
+     */
+    static std::unique_ptr<GdcmDicomDir> open(const std::string& path,
+                                              GdcmDecodingOptions options = {});
+
+    const std::string& getPath() const { return path_; }
+
+    /**
+     * The tree of the DICOMDIR. Only series which were loaded through getVolume or getVolumes
+     * hold their metadata, e.g. dimensions and pixel format, all others only the image paths.
+     */
+    const std::vector<dicomdir::Patient>& getPatients() const { return patients_; }
+    const dicomdir::Series& getSeries(const SeriesRef& ref) const;
+
+    /**
+     * Returns all series of the tree which reference at least one image.
+     */
+    std::vector<SeriesRef> getAllSeries() const;
+
+    bool isLoaded(const SeriesRef& ref) const;
+
+    /**
+     * Returns the volume of the series \p ref, loading its metadata if needed. The voxels are
+     * decoded on first access through the VolumeDisk representation of the volume.
+     */
+    std::shared_ptr<Volume> getVolume(const SeriesRef& ref);
+
+    /**
+     * Returns the volumes of the series \p refs, the metadata of all series not loaded yet is
+     * read in a single parallel scan.
+     */
+    std::vector<std::shared_ptr<Volume>> getVolumes(const std::vector<SeriesRef>& refs);
+
+private:
+    GdcmDicomDir(std::string path, GdcmDecodingOptions options);
+    dicomdir::Series& series(const SeriesRef& ref);
+    std::shared_ptr<Volume> createVolume(const SeriesRef& ref);
+
+    std::string path_;
+    GdcmDecodingOptions options_;
+    std::vector<dicomdir::Patient> patients_;
+    std::map<SeriesRef, std::shared_ptr<Volume>> volumes_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,82 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/dicom/dicommoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <memory>
+
+namespace gdcm {
+class Image;
+}  // namespace gdcm
+
+namespace inviwo {
+
+/**
+ * \brief Decodes compressed DICOM images on the GPU
+ * JPEG baseline images are decoded with nvJPEG and JPEG 2000 images with nvJPEG2000. The decoded
+ * pixels are written to a device staging buffer, which is reused between images, and copied from
+ * there to the destination. The decoders are only available if the module was built with
+ * IVW_DICOM_NVJPEG enabled and a CUDA device is present, otherwise decode always returns false
+ * and the images are decoded by gdcm instead. A decoder can be used from multiple threads.
+ * @see GdcmDecodingOptions::gpuDecoding
+ */
+class IVW_MODULE_DICOM_API GdcmGpuDecoder {
+public:
+    GdcmGpuDecoder();
+    GdcmGpuDecoder(const GdcmGpuDecoder&) = delete;
+    GdcmGpuDecoder& operator=(const GdcmGpuDecoder&) = delete;
+    ~GdcmGpuDecoder();
+
+    /**
+     * Returns true if the module was built with GPU decoding and a CUDA device was found.
+     */
+    static bool isAvailable();
+
+    /**
+     * Returns true if the transfer syntax and pixel format of \p image are handled by one of the
+     * GPU decoders, i.e. 8 bit JPEG baseline or 8 and 16 bit JPEG 2000.
+     */
+    bool canDecode(const gdcm::Image& image) const;
+
+    /**
+     * Decodes the encapsulated pixel data of \p image into \p dest, which holds exactly \p bytes
+     * bytes. Returns false if the image could not be decoded on the GPU, in which case \p dest
+     * is left in an unspecified state and the image should be decoded by gdcm.
+     */
+    bool decode(const gdcm::Image& image, char* dest, size_t bytes);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,103 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/dicom/dicommoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <inviwo/dicom/datastructures/dicomdirtypes.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Persistent cache of the headers of scanned DICOM files
+ * Scanning a directory for DICOM series requires the header of every file in it. The index reads
+ * the headers of files in parallel, without their pixel data, and keeps them keyed by the path,
+ * the modification time and the size of the file. The index is stored on disk, such that
+ * reopening a large study only reads files which were added or modified since.
+ */
+class IVW_MODULE_DICOM_API GdcmScanIndex {
+public:
+    /**
+     * Creates an index stored in \p indexFile, which is loaded if it exists. An empty
+     * \p indexFile gives an index which is only kept in memory.
+     */
+    explicit GdcmScanIndex(std::string indexFile = "");
+
+    /**
+     * Returns the index shared by the DICOM readers, stored in the Inviwo settings directory.
+     */
+    static GdcmScanIndex& get();
+
+    /**
+     * Returns the headers of the files in \p paths, std::nullopt for files which are no DICOM
+     * images. Files which are not in the index or were modified are read in parallel on at most
+     * \p threads threads of the thread pool, 0 for all of them. The index is saved if it changed.
+     */
+    std::vector<std::optional<dicomdir::ImageHeader>> scan(const std::vector<std::string>& paths,
+                                                           size_t threads = 0);
+
+    size_t size() const;
+    void clear();
+
+    /**
+     * Writes the index to its file, if it has one. Called by scan() when entries changed.
+     */
+    void save() const;
+
+private:
+    struct Stamp {
+        std::int64_t modified = 0;
+        std::uintmax_t size = 0;
+        bool operator==(const Stamp& rhs) const {
+            return modified == rhs.modified && size == rhs.size;
+        }
+    };
+    struct Entry {
+        Stamp stamp;
+        std::optional<dicomdir::ImageHeader> header;
+    };
+
+    static std::optional<Stamp> stamp(const std::string& path);
+    void load();
+
+    std::string indexFile_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,88 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/dicom/dicommoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <inviwo/dicom/io/gdcmvolumereader.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace inviwo {
+
+/**
+ * \brief Least recently used cache of the decoded slices of a DICOM volume
+ * Decodes single slices on request, such that a 2D slice viewer can show the current slice
+ * without waiting for the whole series to be decoded. At most getCapacity() slices are kept, the
+ * least recently used slice is dropped first. Slices can be requested from multiple threads.
+ */
+class IVW_MODULE_DICOM_API GdcmSliceCache {
+public:
+    GdcmSliceCache(std::shared_ptr<const GCDMVolumeRAMLoader> loader, size_t capacity = 32);
+
+    /**
+     * Returns slice \p z as a volume with a depth of one, which is decoded unless it is cached.
+     */
+    std::shared_ptr<const VolumeRAM> getSlice(size_t z);
+
+    /**
+     * Decodes the slices within \p radius of slice \p z which are not cached yet, nearest first,
+     * to make scrolling from \p z smooth. Slice \p z itself is decoded as well.
+     */
+    void prefetch(size_t z, size_t radius);
+
+    bool isCached(size_t z) const;
+    size_t size() const;
+    void clear();
+
+    size_t getCapacity() const;
+    void setCapacity(size_t capacity);
+
+    const size3_t& getDimensions() const;
+
+private:
+    void evict();
+
+    using LRU = std::list<size_t>;
+    struct Entry {
+        std::shared_ptr<const VolumeRAM> slice;
+        LRU::iterator used;
+    };
+
+    std::shared_ptr<const GCDMVolumeRAMLoader> loader_;
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    LRU lru_;  // most recently used slice first
+    std::unordered_map<size_t, Entry> slices_;
+};
+
+}  // namespace inviwo
@@ -42,6 +42,8 @@
 
 #include <inviwo/dicom/datastructures/dicomdirtypes.h>
 
+#include <functional>
+
 namespace gdcm {
 class DataSet;
 class File;
@@ -51,6 +53,35 @@ class ImageReader;
 
 namespace inviwo {
 
+class GdcmGpuDecoder;
+
+/**
+ * Settings for decoding the slices of a DICOM series, which is done in parallel.
+ */
+struct IVW_MODULE_DICOM_API GdcmDecodingOptions {
+    /**
+     * Maximum number of threads decoding slices, including the calling thread. The slices are
+     * decoded on the thread pool, 0 uses all of its threads.
+     */
+    size_t threads = 0;
+    /**
+     * Called after each decoded slice with the number of decoded slices and the total number of
+     * slices. Calls are serialized, but may come from any of the decoding threads.
+     */
+    std::function<void(size_t decoded, size_t total)> progress;
+    /**
+     * Polled before each slice is decoded, returning true stops the decoding and the loading
+     * throws a DataReaderException.
+     */
+    std::function<bool()> cancel;
+    /**
+     * Decode JPEG baseline and JPEG 2000 compressed slices on the GPU if available, all other
+     * slices are decoded by gdcm.
+     * @see GdcmGpuDecoder
+     */
+    bool gpuDecoding = false;
+};
+
 class IVW_MODULE_DICOM_API GdcmVolumeReader : public DataReaderType<VolumeSequence> {
 public:
     GdcmVolumeReader();
@@ -70,41 +101,61 @@ public:
      */
     virtual std::shared_ptr<VolumeSequence> readData(const std::string& filePath);
 
+    /**
+     * Set the options used for decoding the series of the volumes read afterwards.
+     */
+    void setDecodingOptions(GdcmDecodingOptions options) { decodingOptions_ = std::move(options); }
+    const GdcmDecodingOptions& getDecodingOptions() const { return decodingOptions_; }
+
+    /**
+     * Creates inviwo volume handle from DICOM series on disk.
+     * Only metadata, no actual voxels are returned.
+     */
+    static std::shared_ptr<Volume> getVolumeDescription(dicomdir::Series& series,
+                                                        const std::string& path = "");
+
+    /**
+     * Same as getVolumeDescription for a \p series whose image information is already updated,
+     * e.g. from headers scanned together with other series.
+     * @see dicomdir::Series::updateImageInformation
+     */
+    static std::shared_ptr<Volume> createVolumeDescription(dicomdir::Series& series,
+                                                           const std::string& path = "");
+
 private:
     /**
      * Try to read all volumes contained in given path using standard  format
+     * @see GdcmDicomDir for browsing a DICOMDIR and loading only selected series
      */
-    static std::shared_ptr<VolumeSequence> tryReadDICOMDIR(const std::string& fileOrDirectory);
+    static std::shared_ptr<VolumeSequence> tryReadDICOMDIR(const std::string& fileOrDirectory,
+                                                           const GdcmDecodingOptions& options);
 
     /**
      * Non-recursive version of tryReadDICOMsequenceRecursive
      */
     static std::shared_ptr<VolumeSequence> tryReadDICOMsequence(
-        const std::string& sequenceDirectory);
+        const std::string& sequenceDirectory, const GdcmDecodingOptions& options);
 
     /**
      * Tries to read all volumes contained in given directory path, including subdirectories.
      * Looks only at all the image files and ignores possibly existing DIOCMDIR.
      */
     static std::shared_ptr<VolumeSequence> tryReadDICOMsequenceRecursive(
-        const std::string& directory);
-
-    /**
-     * Creates inviwo volume handle from DICOM series on disk.
-     * Only metadata, no actual voxels are returned.
-     */
-    static std::shared_ptr<Volume> getVolumeDescription(dicomdir::Series& series,
-                                                        const std::string& path = "");
+        const std::string& directory, const GdcmDecodingOptions& options);
 
     std::string file_;
     const DataFormatBase* format_;
     size3_t dimension_;
     std::shared_ptr<VolumeSequence> volumes_;
+    GdcmDecodingOptions decodingOptions_;
 };
 
 /**
  * \brief A loader for dcm files. Used to create VolumeRAM representations.
- * This class us used by the GdcmVolumeReader.
+ * This class us used by the GdcmVolumeReader. The slices of a series, as well as the frames of a
+ * compressed multi-frame file, are decoded in parallel by a bounded number of threads, each
+ * directly into its place in the volume.
+ * @see GdcmDecodingOptions
  */
 class IVW_MODULE_DICOM_API GCDMVolumeRAMLoader
     : public DiskRepresentationLoader<VolumeRepresentation> {
@@ -124,13 +175,49 @@ public:
     template <class T>
     std::shared_ptr<VolumeRAM> dispatch() const;
 
+    void setDecodingOptions(GdcmDecodingOptions options);
+
+    const size3_t& getDimensions() const { return dimension_; }
+    const DataFormatBase* getDataFormat() const { return format_; }
+
+    /**
+     * Reads the box of \p extent voxels starting at \p offset. Only the images of the slices
+     * intersecting the box are decoded, which for a series or a compressed multi-frame file is a
+     * fraction of the whole volume.
+     * Throws a DataReaderException if the box is not inside the volume.
+     */
+    std::shared_ptr<VolumeRAM> readSubVolume(const size3_t& offset, const size3_t& extent) const;
+
+    /**
+     * Reads slice \p z as a volume with a depth of one, decoding a single image of a series or a
+     * single frame of a compressed multi-frame file.
+     * @see readSubVolume, GdcmSliceCache
+     */
+    std::shared_ptr<VolumeRAM> readSlice(size_t z) const;
+
 private:
-    void getVolumeData(const dicomdir::Series& series, void* outData) const;  // static here?
+    /**
+     * Decodes the \p count images of the series starting at \p first into \p outData, which
+     * holds \p count consecutive slices.
+     */
+    void getVolumeData(size_t first, size_t count, void* outData) const;
+    /**
+     * Decodes the \p count frames of the single file starting at \p first into \p outData,
+     * which holds \p count consecutive slices.
+     */
+    void getFileData(size_t first, size_t count, void* outData) const;
+    /**
+     * Decodes slices [first, first + count) from either the series or the single file.
+     */
+    void getSlices(size_t first, size_t count, void* outData) const;
+    size_t getSliceBytes() const;
     std::string file_;  // only relevant for single volumes
     size3_t dimension_;
     const DataFormatBase* format_;
     bool isPartOfSequence_;
     dicomdir::Series series_;
+    GdcmDecodingOptions decodingOptions_;
+    std::shared_ptr<GdcmGpuDecoder> gpuDecoder_;  // shared with clones, only if gpuDecoding is set
 };
 
 }  // namespace inviwo
@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/dicom/dicommoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Streams the phases of a 4D series, e.g. a cardiac cine or perfusion study, from disk
+ * While phase t is shown, a background thread decodes the phases t+1 to t+k, wrapping around at
+ * the end for looped playback. Decoded phases are kept within a memory budget, the phase furthest
+ * behind the current one is evicted first and its allocation reused for the next phase unless
+ * it is still in use. The decoded phases are also registered with the global MemoryBudget, which
+ * can lower the number of kept phases and ask for phases to be evicted when memory is short.
+ *
+ * The phases are loaded through the VolumeDisk representations of the volumes, e.g. the ones
+ * created by the GdcmVolumeReader, without adding RAM representations to the volumes themselves.
+ * All phases must have the same dimensions and data format.
+ */
+class IVW_MODULE_DICOM_API VolumeSequenceStreamer {
+public:
+    /**
+     * @param phases      volumes with VolumeDisk representations, one per phase
+     * @param memoryBudget maximum number of bytes of decoded phases, at least one phase is kept.
+     *                     The allowance of the global MemoryBudget can lower it further.
+     * @param prefetch    number of phases following the current one decoded in the background
+     * @throws Exception if a phase has no VolumeDisk representation or the phases differ in size
+     */
+    VolumeSequenceStreamer(const VolumeSequence& phases, size_t memoryBudget,
+                           size_t prefetch = 4);
+    VolumeSequenceStreamer(const VolumeSequenceStreamer&) = delete;
+    VolumeSequenceStreamer& operator=(const VolumeSequenceStreamer&) = delete;
+    ~VolumeSequenceStreamer();
+
+    /**
+     * Makes \p phase the current phase and returns it, waiting for it to be decoded if needed.
+     * Rethrows the exception if the phase could not be decoded. The current phase is shared, so
+     * phases should be requested from a single thread, e.g. the one of the playback processor.
+     */
+    std::shared_ptr<const VolumeRAM> getPhase(size_t phase);
+
+    /**
+     * Same as getPhase but wraps the phase in a Volume with the transformations, data map and
+     * meta data of the original volume.
+     */
+    std::shared_ptr<Volume> getVolume(size_t phase);
+
+    /**
+     * Returns true if \p phase is decoded and getPhase will not block.
+     */
+    bool isReady(size_t phase) const;
+
+    size_t size() const { return phases_.size(); }
+
+    void setPrefetch(size_t prefetch);
+    size_t getPrefetch() const;
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+private:
+    void run();
+    // the following expect mutex_ to be locked
+    std::optional<size_t> nextMissing() const;
+    size_t capacity() const;
+    size_t distance(size_t phase) const;
+    std::shared_ptr<VolumeRAM> evict();
+    void reportUsage();
+
+    std::vector<std::shared_ptr<Volume>> phases_;
+    std::vector<std::shared_ptr<const VolumeDisk>> disks_;
+    size_t phaseBytes_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    size_t memoryBudget_;
+    size_t prefetch_;
+    size_t current_ = 0;
+    bool stop_ = false;
+    std::unordered_map<size_t, std::shared_ptr<VolumeRAM>> decoded_;
+    std::unordered_map<size_t, std::exception_ptr> failed_;
+    std::thread worker_;
+    std::unique_ptr<MemoryBudget::Registration> registration_;
+};
+
+}  // namespace inviwo
@@ -31,6 +31,7 @@
 #include <inviwo/dicom/dicommoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 
+#include <inviwo/core/datastructures/datamapper.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/util/stringconversion.h>
 
@@ -94,6 +95,16 @@ IVW_MODULE_DICOM_API const DataFormatBase* getDataFormatBase(const gdcm::Image&
  */
 IVW_MODULE_DICOM_API dvec2 getDataRange(const gdcm::PixelFormat& pixelformat);
 
+/**
+ * Sets up \p dataMap for voxels holding the stored values of \p pixelformat at their native
+ * width. The rescale \p slope and \p intercept of the modality LUT are folded into the value
+ * range, which the shaders apply when mapping data to values, so the voxels are never rescaled
+ * on the CPU. A negative slope results in a flipped value range.
+ */
+IVW_MODULE_DICOM_API void setDataMapping(DataMapper& dataMap, const gdcm::PixelFormat& pixelformat,
+                                         double slope, double intercept,
+                                         const std::string& modality);
+
 template <int N, typename T>
 glm::vec<N, T> toGlmVec(const T* data) {
     glm::vec<N, T> result{0};
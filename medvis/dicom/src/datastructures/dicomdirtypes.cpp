@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/dicom/datastructures/dicomdirtypes.h>
+#include <inviwo/dicom/io/gdcmscanindex.h>
 #include <inviwo/dicom/utils/gdcmutils.h>
 
 #include <inviwo/core/io/datareaderexception.h>
@@ -44,6 +45,7 @@
 
 #include <MediaStorageAndFileFormat/gdcmImageHelper.h>
 #include <MediaStorageAndFileFormat/gdcmImageReader.h>
+#include <DataStructureAndEncodingDefinition/gdcmReader.h>
 #include <DataStructureAndEncodingDefinition/gdcmAttribute.h>
 #include <DataStructureAndEncodingDefinition/gdcmMediaStorage.h>
 #include <warn/pop>
@@ -85,9 +87,9 @@ void Image::updateInfo(const gdcm::DataSet& dataset) {
     updateZpos();
 }
 
-void Image::updateInfo(const gdcm::ImageReader& reader) {
-    const auto& file = reader.GetFile();
+void Image::updateInfo(const gdcm::ImageReader& reader) { updateInfo(reader.GetFile()); }
 
+void Image::updateInfo(const gdcm::File& file) {
     windowCenter = gdcmutil::getTag(file.GetDataSet(), 0x0028, 0x1050);
     windowWidth = gdcmutil::getTag(file.GetDataSet(), 0x0028, 0x1051);
 
@@ -122,28 +124,58 @@ void Image::updateZpos() {
     zPos = glm::dot(origin, glm::cross(orientationX, orientationY));
 }
 
+std::optional<ImageHeader> ImageHeader::read(const std::string& path) {
+    auto stream = filesystem::ifstream(path, std::ios::binary);
+    if (!stream.is_open()) return std::nullopt;
+
+    gdcm::Reader reader;
+    reader.SetStream(stream);
+    // the pixel data is the last element of an image, stop in front of it
+    if (!reader.ReadUpToTag(gdcm::Tag(0x7fe0, 0x0010))) {
+        return std::nullopt;
+    }
+    const gdcm::File& file = reader.GetFile();
+    const gdcm::DataSet& dataset = file.GetDataSet();
+    // DICOM files without rows are no images, e.g. structured reports
+    if (!dataset.FindDataElement(gdcm::Tag(0x0028, 0x0010))) return std::nullopt;
+
+    ImageHeader header;
+    header.seriesUID = gdcmutil::getTag(dataset, 0x0020, 0x000E);
+
+    gdcm::MediaStorage mediaStorage;
+    mediaStorage.SetFromFile(file);
+    if (const char* modality = mediaStorage.GetModality()) header.modality = modality;
+
+    header.image.path = path;
+    header.image.updateInfo(file);
+
+    header.photometric = gdcm::ImageHelper::GetPhotometricInterpretationValue(file);
+    header.pixelformat = gdcm::ImageHelper::GetPixelFormatValue(file);
+    const auto interceptSlopeVec = gdcm::ImageHelper::GetRescaleInterceptSlopeValue(file);
+    header.intercept = interceptSlopeVec[0];
+    header.slope = interceptSlopeVec[1];
+
+    return header;
+}
+
 namespace {
 
 struct ImageMetaData {
     ImageMetaData() = default;
-    ImageMetaData(const gdcm::ImageReader& reader, const dicomdir::Image& imgInfo) {
-        set(reader, imgInfo);
-    }
+    ImageMetaData(const ImageHeader& header) { set(header); }
 
-    void set(const gdcm::ImageReader& reader, const dicomdir::Image& imgInfo) {
+    void set(const ImageHeader& header) {
+        const auto& imgInfo = header.image;
         dims = size2_t{imgInfo.dims};
         pixelSpacing = imgInfo.pixelSpacing;
         orientation[0] = imgInfo.orientationX;
         orientation[1] = imgInfo.orientationY;
         origin = imgInfo.origin;
 
-        const gdcm::File& file = reader.GetFile();
-
-        photometric = gdcm::ImageHelper::GetPhotometricInterpretationValue(file);
-        pixelformat = gdcm::ImageHelper::GetPixelFormatValue(file);
-        auto interceptSlopeVec = gdcm::ImageHelper::GetRescaleInterceptSlopeValue(file);
-        intercept = interceptSlopeVec[0];
-        slope = interceptSlopeVec[1];
+        photometric = header.photometric;
+        pixelformat = header.pixelformat;
+        intercept = header.intercept;
+        slope = header.slope;
     }
 
     size2_t dims;
@@ -161,6 +193,22 @@ struct ImageMetaData {
 Series::Series(const std::string& description) : desc{description} {}
 
 void Series::updateImageInformation(const std::string& dicompath) {
+    std::vector<std::string> paths;
+    paths.reserve(images.size());
+    for (const auto& image : images) {
+        paths.push_back(image.path);
+    }
+    updateImageInformation(GdcmScanIndex::get().scan(paths), dicompath);
+}
+
+void Series::updateImageInformation(const std::vector<std::optional<ImageHeader>>& headers,
+                                    const std::string& dicompath) {
+    if (headers.size() != images.size()) {
+        throw DataReaderException(
+            fmt::format("expected {} image headers in DICOM series '{}', got {} ('{}')",
+                        images.size(), desc, headers.size(), dicompath),
+            IVW_CONTEXT);
+    }
 
     // According to the standard the following parameters should be the same within a
     // series:
@@ -196,7 +244,7 @@ void Series::updateImageInformation(const std::string& dicompath) {
         }
         const double dicomDelta = 1.0e-4;
         if (std::abs(ref.slope - img.slope) > dicomDelta ||
-            std::abs(ref.intercept - img.intercept) < dicomDelta) {
+            std::abs(ref.intercept - img.intercept) > dicomDelta) {
             warnSlopeIntercept = true;
         }
 
@@ -218,29 +266,21 @@ void Series::updateImageInformation(const std::string& dicompath) {
 
     bool first = true;
     ImageMetaData refImage;
-    for (auto& imgInfo : images) {
-        gdcm::ImageReader imageReader;
-        auto imageInputStream = filesystem::ifstream(imgInfo.path, std::ios::binary);
-        imageReader.SetStream(imageInputStream);
-
-        if (!imageInputStream.is_open() || !imageReader.CanRead()) {
+    for (size_t i = 0; i < images.size(); ++i) {
+        auto& imgInfo = images[i];
+        const auto& header = headers[i];
+        if (!header) {
             imgInfo.dims = {0u};
             continue;
         }
-        if (!imageReader.Read()) {
-            throw DataReaderException(
-                fmt::format("could not read image '{}' in DICOM series '{}' ('{}')", imgInfo.path,
-                            desc, dicompath),
-                IVW_CONTEXT);
-        }
 
-        imgInfo.updateInfo(imageReader);
+        imgInfo = header->image;
 
         if (first) {
             first = false;
-            refImage.set(imageReader, imgInfo);
+            refImage.set(*header);
         } else {
-            sanityCheck(refImage, ImageMetaData{imageReader, imgInfo});
+            sanityCheck(refImage, ImageMetaData{*header});
         }
     }
 
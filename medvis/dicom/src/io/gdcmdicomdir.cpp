@@ -0,0 +1,257 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dicom/io/gdcmdicomdir.h>
+#include <inviwo/dicom/io/gdcmscanindex.h>
+
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <DataStructureAndEncodingDefinition/gdcmMediaStorage.h>
+#include <DataStructureAndEncodingDefinition/gdcmReader.h>
+#include <DataStructureAndEncodingDefinition/gdcmSequenceOfItems.h>
+#include <warn/pop>
+
+#include <algorithm>
+
+namespace inviwo {
+
+GdcmDicomDir::GdcmDicomDir(std::string path, GdcmDecodingOptions options)
+    : path_{std::move(path)}, options_{std::move(options)} {}
+
+std::unique_ptr<GdcmDicomDir> GdcmDicomDir::open(const std::string& path,
+                                                 GdcmDecodingOptions options) {
+    auto dicomdirInputStream = filesystem::ifstream(path, std::ios::binary);
+    if (!dicomdirInputStream.is_open()) {
+        throw DataReaderException(fmt::format("could not open DICOM file ('{}')", path),
+                                  IVW_CONTEXT_CUSTOM("GdcmDicomDir::open"));
+    }
+
+    // Analog to gdcm example "ReadAndDumpDICOMDIR"
+    gdcm::Reader reader;
+    reader.SetStream(dicomdirInputStream);
+    if (!reader.Read()) {
+        return nullptr;  // no DICOM file
+    }
+
+    gdcm::File& file = reader.GetFile();
+
+    // First check meta info
+    gdcm::MediaStorage dicomMediaStorage;
+    dicomMediaStorage.SetFromFile(file);
+    if (dicomMediaStorage != gdcm::MediaStorage::MediaStorageDirectoryStorage) {
+        return nullptr;
+    }
+
+    gdcm::FileMetaInformation& metainfo = file.GetHeader();
+    if (!metainfo.FindDataElement(gdcm::Tag(0x0002, 0x0002))) {
+        return nullptr;  // Media Storage Sop Class UID not present
+    }
+    std::stringstream storageUID;
+    metainfo.GetDataElement(gdcm::Tag(0x0002, 0x0002)).GetValue().Print(storageUID);
+    // Trim string because DICOM allows padding with spaces
+    if (trim(storageUID.str()) != "1.2.840.10008.1.3.10") {
+        return nullptr;  // This file is not a DICOMDIR
+    }
+
+    auto getString = [](const auto& ds, const gdcm::Tag& tag) -> std::string {
+        std::stringstream ss;
+        if (ds.FindDataElement(tag)) {
+            auto& elem = ds.GetDataElement(tag);
+            if (!elem.IsEmpty() && !elem.IsUndefinedLength()) {
+                elem.GetValue().Print(ss);
+            }
+        }
+        return trim(ss.str());
+    };
+
+    const gdcm::Tag patientsNameTag(0x0010, 0x0010);
+    const gdcm::Tag patientsIdTag(0x0010, 0x0020);
+    const gdcm::Tag studyDateTag(0x0008, 0x0020);
+    const gdcm::Tag studyDescTag(0x0008, 0x1030);
+    const gdcm::Tag seriesDescTag(0x0008, 0x103e);
+
+    const gdcm::Tag directoryRecordSequenceTag(0x0004, 0x1220);
+    // value can be patient, study, series or image
+    const gdcm::Tag directoryRecordTypeTag(0x0004, 0x1430);
+    const gdcm::Tag referencedFileID(0x0004, 0x1500);  // value is e.g. image path
+
+    const std::string baseDirectory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    std::unique_ptr<GdcmDicomDir> dicomdir{new GdcmDicomDir(path, std::move(options))};
+    auto& patients = dicomdir->patients_;
+
+    const gdcm::DataSet& dataset = file.GetDataSet();
+    if (!dataset.FindDataElement(directoryRecordSequenceTag)) {
+        return dicomdir;
+    }
+    auto recordSequence = dataset.GetDataElement(directoryRecordSequenceTag).GetValueAsSQ();
+    if (!recordSequence) {
+        return dicomdir;
+    }
+
+    // The records are stored as a depth-first traversal of the tree, i.e. each record belongs
+    // to the last record of the level above. Only the paths of the images are collected, the
+    // images themselves are read once a series is requested.
+    for (gdcm::SequenceOfItems::SizeType recIndex = 1;
+         recIndex <= recordSequence->GetNumberOfItems(); recIndex++) {
+        const gdcm::Item& record = recordSequence->GetItem(recIndex);
+        const auto recType = getString(record, directoryRecordTypeTag);
+
+        if (recType == "PATIENT") {
+            patients.push_back(
+                {getString(record, patientsNameTag), getString(record, patientsIdTag), {}});
+        } else if (recType == "STUDY") {
+            // study UID gdcm::Tag (0x0020, 0x000d)
+            if (patients.empty()) continue;
+            patients.back().studies.push_back(
+                {getString(record, studyDateTag), getString(record, studyDescTag), {}});
+        } else if (recType == "SERIES") {
+            // series UID gdcm::Tag (0x0020, 0x000e)
+            if (patients.empty() || patients.back().studies.empty()) continue;
+            patients.back().studies.back().series.emplace_back(
+                getString(record, seriesDescTag));
+        } else if (recType == "IMAGE") {
+            // image UID gdcm::Tag (0x0004, 0x1511))
+            if (patients.empty() || patients.back().studies.empty() ||
+                patients.back().studies.back().series.empty()) {
+                continue;
+            }
+            const auto imagePath = getString(record, referencedFileID);
+            if (!imagePath.empty()) {
+                // relative to absolute path
+                patients.back().studies.back().series.back().images.push_back(
+                    dicomdir::Image{baseDirectory + imagePath});
+            }
+        }
+    }
+
+    return dicomdir;
+}
+
+const dicomdir::Series& GdcmDicomDir::getSeries(const SeriesRef& ref) const {
+    if (ref.patient >= patients_.size() || ref.study >= patients_[ref.patient].studies.size() ||
+        ref.series >= patients_[ref.patient].studies[ref.study].series.size()) {
+        throw RangeException(fmt::format("no series ({}, {}, {}) in DICOMDIR '{}'", ref.patient,
+                                         ref.study, ref.series, path_),
+                             IVW_CONTEXT);
+    }
+    return patients_[ref.patient].studies[ref.study].series[ref.series];
+}
+
+dicomdir::Series& GdcmDicomDir::series(const SeriesRef& ref) {
+    return const_cast<dicomdir::Series&>(getSeries(ref));
+}
+
+std::vector<GdcmDicomDir::SeriesRef> GdcmDicomDir::getAllSeries() const {
+    std::vector<SeriesRef> refs;
+    for (size_t p = 0; p < patients_.size(); ++p) {
+        for (size_t st = 0; st < patients_[p].studies.size(); ++st) {
+            for (size_t se = 0; se < patients_[p].studies[st].series.size(); ++se) {
+                if (!patients_[p].studies[st].series[se].images.empty()) {
+                    refs.push_back({p, st, se});
+                }
+            }
+        }
+    }
+    return refs;
+}
+
+bool GdcmDicomDir::isLoaded(const SeriesRef& ref) const { return volumes_.count(ref) != 0; }
+
+std::shared_ptr<Volume> GdcmDicomDir::getVolume(const SeriesRef& ref) {
+    return getVolumes({ref}).front();
+}
+
+std::vector<std::shared_ptr<Volume>> GdcmDicomDir::getVolumes(const std::vector<SeriesRef>& refs) {
+    std::vector<SeriesRef> missing;
+    std::vector<std::string> paths;
+    for (const auto& ref : refs) {
+        if (isLoaded(ref) || std::find(missing.begin(), missing.end(), ref) != missing.end()) {
+            continue;
+        }
+        missing.push_back(ref);
+        for (const auto& image : getSeries(ref).images) {
+            paths.push_back(image.path);
+        }
+    }
+
+    const auto headers = GdcmScanIndex::get().scan(paths, options_.threads);
+    auto first = headers.begin();
+    for (const auto& ref : missing) {
+        auto& s = series(ref);
+        const auto last = first + s.images.size();
+        // the DICOMDIR does not state the modality, take it from the images
+        if (auto it = std::find_if(first, last, [](auto& h) { return h && !h->modality.empty(); });
+            it != last) {
+            s.modality = (*it)->modality;
+        }
+        s.updateImageInformation(std::vector<std::optional<dicomdir::ImageHeader>>(first, last),
+                                 path_);
+        first = last;
+
+        volumes_[ref] = createVolume(ref);
+    }
+
+    std::vector<std::shared_ptr<Volume>> volumes;
+    for (const auto& ref : refs) {
+        volumes.push_back(volumes_[ref]);
+    }
+    return volumes;
+}
+
+std::shared_ptr<Volume> GdcmDicomDir::createVolume(const SeriesRef& ref) {
+    const auto& patient = patients_[ref.patient];
+    const auto& study = patient.studies[ref.study];
+    auto& s = series(ref);
+
+    auto vol = GdcmVolumeReader::createVolumeDescription(s, path_);
+    // on-demand loading via loader class
+    auto diskRepr =
+        std::make_shared<VolumeDisk>(path_, vol->getDimensions(), vol->getDataFormat());
+    auto loader = util::make_unique<GCDMVolumeRAMLoader>(path_, vol->getDimensions(),
+                                                         vol->getDataFormat(), true, s);
+    loader->setDecodingOptions(options_);
+    diskRepr->setLoader(loader.release());
+    vol->addRepresentation(diskRepr);
+    vol->setMetaData<StringMetaData>("name", s.desc);
+    vol->setMetaData<StringMetaData>("patientName", patient.patientName);
+    vol->setMetaData<StringMetaData>("patientId", patient.patientId);
+    vol->setMetaData<StringMetaData>("studyDesc", study.desc);
+    vol->setMetaData<StringMetaData>("studyDate", study.date);
+    return vol;
+}
+
+}  // namespace inviwo
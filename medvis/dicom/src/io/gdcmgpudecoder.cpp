@@ -0,0 +1,283 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dicom/io/gdcmgpudecoder.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <MediaStorageAndFileFormat/gdcmImage.h>
+#include <DataStructureAndEncodingDefinition/gdcmSequenceOfFragments.h>
+#include <DataStructureAndEncodingDefinition/gdcmTransferSyntax.h>
+#include <warn/pop>
+
+#if defined(IVW_DICOM_NVJPEG)
+#include <cuda_runtime_api.h>
+#include <nvjpeg.h>
+#include <nvjpeg2k.h>
+#endif
+
+#include <mutex>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+bool isJpegBaseline(const gdcm::TransferSyntax& ts) {
+    return ts == gdcm::TransferSyntax::JPEGBaselineProcess1;
+}
+
+bool isJpeg2000(const gdcm::TransferSyntax& ts) {
+    return ts == gdcm::TransferSyntax::JPEG2000Lossless || ts == gdcm::TransferSyntax::JPEG2000;
+}
+
+/**
+ * Concatenates the fragments of the encapsulated pixel data of the single frame \p image into
+ * one code stream. Returns an empty vector if the pixel data is not encapsulated.
+ */
+std::vector<unsigned char> getCodeStream(const gdcm::Image& image) {
+    const gdcm::SequenceOfFragments* fragments = image.GetDataElement().GetSequenceOfFragments();
+    if (!fragments || fragments->GetNumberOfFragments() == 0) return {};
+
+    std::vector<unsigned char> stream(fragments->ComputeByteLength());
+    if (!fragments->GetBuffer(reinterpret_cast<char*>(stream.data()), stream.size())) return {};
+    return stream;
+}
+
+}  // namespace
+
+#if defined(IVW_DICOM_NVJPEG)
+
+struct GdcmGpuDecoder::Impl {
+    /**
+     * Decoding state of one thread, the staging buffer holds the decoded pixels on the device
+     * and only grows.
+     */
+    struct State {
+        nvjpegJpegState_t jpeg = nullptr;
+        nvjpeg2kDecodeState_t jpeg2k = nullptr;
+        nvjpeg2kStream_t codeStream = nullptr;
+        cudaStream_t stream = nullptr;
+        void* staging = nullptr;
+        size_t stagingBytes = 0;
+
+        ~State() {
+            if (staging) cudaFree(staging);
+            if (stream) cudaStreamDestroy(stream);
+            if (codeStream) nvjpeg2kStreamDestroy(codeStream);
+            if (jpeg2k) nvjpeg2kDecodeStateDestroy(jpeg2k);
+            if (jpeg) nvjpegJpegStateDestroy(jpeg);
+        }
+
+        bool reserve(size_t bytes) {
+            if (bytes <= stagingBytes) return true;
+            if (staging) cudaFree(staging);
+            staging = nullptr;
+            stagingBytes = 0;
+            if (cudaMalloc(&staging, bytes) != cudaSuccess) return false;
+            stagingBytes = bytes;
+            return true;
+        }
+    };
+
+    Impl() {
+        if (nvjpegCreateSimple(&jpeg) != NVJPEG_STATUS_SUCCESS) jpeg = nullptr;
+        if (nvjpeg2kCreateSimple(&jpeg2k) != NVJPEG2K_STATUS_SUCCESS) jpeg2k = nullptr;
+    }
+    ~Impl() {
+        idle.clear();
+        if (jpeg2k) nvjpeg2kDestroy(jpeg2k);
+        if (jpeg) nvjpegDestroy(jpeg);
+    }
+
+    std::unique_ptr<State> acquire() {
+        {
+            std::scoped_lock lock{mutex};
+            if (!idle.empty()) {
+                auto state = std::move(idle.back());
+                idle.pop_back();
+                return state;
+            }
+        }
+        auto state = std::make_unique<State>();
+        if (cudaStreamCreateWithFlags(&state->stream, cudaStreamNonBlocking) != cudaSuccess) {
+            return nullptr;
+        }
+        if (jpeg && nvjpegJpegStateCreate(jpeg, &state->jpeg) != NVJPEG_STATUS_SUCCESS) {
+            return nullptr;
+        }
+        if (jpeg2k && (nvjpeg2kDecodeStateCreate(jpeg2k, &state->jpeg2k) !=
+                           NVJPEG2K_STATUS_SUCCESS ||
+                       nvjpeg2kStreamCreate(&state->codeStream) != NVJPEG2K_STATUS_SUCCESS)) {
+            return nullptr;
+        }
+        return state;
+    }
+
+    void release(std::unique_ptr<State> state) {
+        std::scoped_lock lock{mutex};
+        idle.push_back(std::move(state));
+    }
+
+    bool decodeJpeg(State& state, const std::vector<unsigned char>& code,
+                    const gdcm::PixelFormat& pf, size_t bytes) {
+        int components = 0;
+        nvjpegChromaSubsampling_t subsampling;
+        int widths[NVJPEG_MAX_COMPONENT];
+        int heights[NVJPEG_MAX_COMPONENT];
+        if (nvjpegGetImageInfo(jpeg, code.data(), code.size(), &components, &subsampling, widths,
+                               heights) != NVJPEG_STATUS_SUCCESS) {
+            return false;
+        }
+        const size_t samples = pf.GetSamplesPerPixel();
+        const size_t rowBytes = static_cast<size_t>(widths[0]) * samples;
+        if (rowBytes * heights[0] != bytes || !state.reserve(bytes)) return false;
+
+        nvjpegImage_t output{};
+        output.channel[0] = static_cast<unsigned char*>(state.staging);
+        output.pitch[0] = rowBytes;
+        const auto format = samples == 1 ? NVJPEG_OUTPUT_Y : NVJPEG_OUTPUT_RGBI;
+        return nvjpegDecode(jpeg, state.jpeg, code.data(), code.size(), format, &output,
+                            state.stream) == NVJPEG_STATUS_SUCCESS;
+    }
+
+    bool decodeJpeg2000(State& state, const std::vector<unsigned char>& code,
+                        const gdcm::PixelFormat& pf, size_t bytes) {
+        if (nvjpeg2kStreamParse(jpeg2k, code.data(), code.size(), 0, 0, state.codeStream) !=
+            NVJPEG2K_STATUS_SUCCESS) {
+            return false;
+        }
+        nvjpeg2kImageInfo_t info;
+        nvjpeg2kImageComponentInfo_t component;
+        if (nvjpeg2kStreamGetImageInfo(state.codeStream, &info) != NVJPEG2K_STATUS_SUCCESS ||
+            info.num_components != 1 ||
+            nvjpeg2kStreamGetImageComponentInfo(state.codeStream, &component, 0) !=
+                NVJPEG2K_STATUS_SUCCESS) {
+            return false;
+        }
+        // the stored values have to fit the allocated bits with the signedness of the header
+        const bool isSigned = pf.GetPixelRepresentation() == 1;
+        if (component.precision > pf.GetBitsAllocated() || (component.sgn != 0) != isSigned) {
+            return false;
+        }
+
+        const size_t sampleBytes = pf.GetBitsAllocated() / 8;
+        size_t rowBytes = static_cast<size_t>(info.image_width) * sampleBytes;
+        if (rowBytes * info.image_height != bytes || !state.reserve(bytes)) return false;
+
+        void* planes[] = {state.staging};
+        nvjpeg2kImage_t output;
+        output.pixel_data = planes;
+        output.pitch_in_bytes = &rowBytes;
+        output.num_components = 1;
+        if (sampleBytes == 1) {
+            output.pixel_type = NVJPEG2K_UINT8;
+        } else {
+            output.pixel_type = isSigned ? NVJPEG2K_INT16 : NVJPEG2K_UINT16;
+        }
+        return nvjpeg2kDecode(jpeg2k, state.jpeg2k, state.codeStream, &output, state.stream) ==
+               NVJPEG2K_STATUS_SUCCESS;
+    }
+
+    nvjpegHandle_t jpeg = nullptr;
+    nvjpeg2kHandle_t jpeg2k = nullptr;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<State>> idle;
+};
+
+GdcmGpuDecoder::GdcmGpuDecoder() : impl_{isAvailable() ? std::make_unique<Impl>() : nullptr} {}
+
+bool GdcmGpuDecoder::isAvailable() {
+    static const bool available = []() {
+        int devices = 0;
+        return cudaGetDeviceCount(&devices) == cudaSuccess && devices > 0;
+    }();
+    return available;
+}
+
+bool GdcmGpuDecoder::decode(const gdcm::Image& image, char* dest, size_t bytes) {
+    if (!canDecode(image)) return false;
+    const auto code = getCodeStream(image);
+    if (code.empty()) return false;
+
+    auto state = impl_->acquire();
+    if (!state) return false;
+
+    const auto& pf = image.GetPixelFormat();
+    const bool decoded = isJpegBaseline(image.GetTransferSyntax())
+                             ? impl_->decodeJpeg(*state, code, pf, bytes)
+                             : impl_->decodeJpeg2000(*state, code, pf, bytes);
+    // copy the slice from the staging buffer into its place in the volume
+    const bool copied =
+        decoded &&
+        cudaMemcpyAsync(dest, state->staging, bytes, cudaMemcpyDeviceToHost, state->stream) ==
+            cudaSuccess &&
+        cudaStreamSynchronize(state->stream) == cudaSuccess;
+
+    impl_->release(std::move(state));
+    return copied;
+}
+
+#else
+
+struct GdcmGpuDecoder::Impl {
+    bool jpeg = false;
+    bool jpeg2k = false;
+};
+
+GdcmGpuDecoder::GdcmGpuDecoder() = default;
+
+bool GdcmGpuDecoder::isAvailable() { return false; }
+
+bool GdcmGpuDecoder::decode(const gdcm::Image&, char*, size_t) { return false; }
+
+#endif
+
+GdcmGpuDecoder::~GdcmGpuDecoder() = default;
+
+bool GdcmGpuDecoder::canDecode(const gdcm::Image& image) const {
+    if (!impl_) return false;
+
+    // only single frame images, i.e. the slices of a series
+    if (image.GetNumberOfDimensions() > 2 && image.GetDimension(2) > 1) return false;
+
+    const auto& ts = image.GetTransferSyntax();
+    const auto& pf = image.GetPixelFormat();
+    if (isJpegBaseline(ts)) {
+        return impl_->jpeg && pf.GetBitsAllocated() == 8 &&
+               (pf.GetSamplesPerPixel() == 1 ||
+                (pf.GetSamplesPerPixel() == 3 && image.GetPlanarConfiguration() == 0));
+    } else if (isJpeg2000(ts)) {
+        return impl_->jpeg2k && pf.GetSamplesPerPixel() == 1 &&
+               (pf.GetBitsAllocated() == 8 || pf.GetBitsAllocated() == 16);
+    }
+    return false;
+}
+
+}  // namespace inviwo
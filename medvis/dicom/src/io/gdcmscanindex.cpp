@@ -0,0 +1,262 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dicom/io/gdcmscanindex.h>
+#include <inviwo/dicom/utils/gdcmutils.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <locale>
+#include <sstream>
+
+namespace inviwo {
+
+namespace {
+
+constexpr std::string_view indexVersion = "# Inviwo DICOM scan index 1";
+
+// the fields of an entry are separated by tabs and the entries by newlines
+std::string sanitize(std::string str) {
+    std::replace_if(
+        str.begin(), str.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return str;
+}
+
+template <typename T>
+bool parse(const std::string& str, T& value) {
+    std::istringstream ss(str);
+    ss.imbue(std::locale::classic());
+    ss >> value;
+    return !ss.fail();
+}
+
+class FieldReader {
+public:
+    explicit FieldReader(const std::string& line) : fields_{util::splitString(line, '\t')} {}
+
+    bool string(std::string& value) {
+        if (next_ >= fields_.size()) return false;
+        value = fields_[next_++];
+        return true;
+    }
+    template <typename T>
+    bool number(T& value) {
+        return next_ < fields_.size() && parse(fields_[next_++], value);
+    }
+    template <typename V>
+    bool vec(V& value) {
+        for (int i = 0; i < V::length(); ++i) {
+            if (!number(value[i])) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::string> fields_;
+    size_t next_ = 0;
+};
+
+void writeHeader(std::ostream& os, const dicomdir::ImageHeader& header) {
+    const auto& image = header.image;
+    const auto& pf = header.pixelformat;
+    const auto vec = [](const auto& v) { return fmt::format("{}\t{}\t{}", v.x, v.y, v.z); };
+    os << fmt::format("{}\t{}\t{}\t{}\t{}\t", sanitize(header.seriesUID),
+                      sanitize(header.modality), sanitize(image.windowCenter),
+                      sanitize(image.windowWidth), image.sliceThickness)
+       << fmt::format("{}\t{}\t{}\t{}\t{}\t", vec(image.dims), vec(image.orientationX),
+                      vec(image.orientationY), vec(image.origin), vec(image.pixelSpacing))
+       << fmt::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}", pf.GetSamplesPerPixel(),
+                      pf.GetBitsAllocated(), pf.GetBitsStored(), pf.GetHighBit(),
+                      pf.GetPixelRepresentation(),
+                      static_cast<int>(static_cast<gdcm::PhotometricInterpretation::PIType>(
+                          header.photometric)),
+                      header.intercept, header.slope);
+}
+
+std::optional<dicomdir::ImageHeader> readHeader(const std::string& path, FieldReader& reader) {
+    dicomdir::ImageHeader header;
+    auto& image = header.image;
+    image.path = path;
+    unsigned short samplesPerPixel = 0;
+    unsigned short bitsAllocated = 0;
+    unsigned short bitsStored = 0;
+    unsigned short highBit = 0;
+    unsigned short pixelRepresentation = 0;
+    int photometric = 0;
+    if (!reader.string(header.seriesUID) || !reader.string(header.modality) ||
+        !reader.string(image.windowCenter) || !reader.string(image.windowWidth) ||
+        !reader.number(image.sliceThickness) || !reader.vec(image.dims) ||
+        !reader.vec(image.orientationX) || !reader.vec(image.orientationY) ||
+        !reader.vec(image.origin) || !reader.vec(image.pixelSpacing) ||
+        !reader.number(samplesPerPixel) || !reader.number(bitsAllocated) ||
+        !reader.number(bitsStored) || !reader.number(highBit) ||
+        !reader.number(pixelRepresentation) || !reader.number(photometric) ||
+        !reader.number(header.intercept) || !reader.number(header.slope)) {
+        return std::nullopt;
+    }
+    image.updateZpos();
+    header.pixelformat = gdcm::PixelFormat(samplesPerPixel, bitsAllocated, bitsStored, highBit,
+                                           pixelRepresentation);
+    header.photometric = gdcm::PhotometricInterpretation(
+        static_cast<gdcm::PhotometricInterpretation::PIType>(photometric));
+    return header;
+}
+
+}  // namespace
+
+GdcmScanIndex::GdcmScanIndex(std::string indexFile) : indexFile_{std::move(indexFile)} { load(); }
+
+GdcmScanIndex& GdcmScanIndex::get() {
+    static GdcmScanIndex index{filesystem::getPath(PathType::Settings) + "/dicom-scan-index.txt"};
+    return index;
+}
+
+auto GdcmScanIndex::stamp(const std::string& path) -> std::optional<Stamp> {
+    std::error_code ec;
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    return Stamp{static_cast<std::int64_t>(modified.time_since_epoch().count()), size};
+}
+
+std::vector<std::optional<dicomdir::ImageHeader>> GdcmScanIndex::scan(
+    const std::vector<std::string>& paths, size_t threads) {
+    std::vector<std::optional<dicomdir::ImageHeader>> headers(paths.size());
+    bool modified = false;
+
+    const auto scanFile = [&](size_t i) {
+        const auto& path = paths[i];
+        const auto fileStamp = stamp(path);
+        if (!fileStamp) return;  // not a readable file
+        {
+            std::scoped_lock lock{mutex_};
+            const auto it = entries_.find(path);
+            if (it != entries_.end() && it->second.stamp == *fileStamp) {
+                headers[i] = it->second.header;
+                return;
+            }
+        }
+        headers[i] = dicomdir::ImageHeader::read(path);
+
+        std::scoped_lock lock{mutex_};
+        entries_[path] = Entry{*fileStamp, headers[i]};
+        modified = true;
+    };
+    util::forEachRangeParallel(
+        paths.size(), 1,
+        [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) scanFile(i);
+        },
+        nullptr, threads);
+
+    if (modified) {
+        try {
+            save();
+        } catch (const std::exception& e) {
+            LogWarn(fmt::format("could not save the DICOM scan index ('{}'): {}", indexFile_,
+                                e.what()));
+        }
+    }
+    return headers;
+}
+
+size_t GdcmScanIndex::size() const {
+    std::scoped_lock lock{mutex_};
+    return entries_.size();
+}
+
+void GdcmScanIndex::clear() {
+    std::scoped_lock lock{mutex_};
+    entries_.clear();
+}
+
+void GdcmScanIndex::save() const {
+    if (indexFile_.empty()) return;
+
+    // written to a temporary file first, such that an interrupted save keeps the old index
+    const auto tmpFile = indexFile_ + ".tmp";
+    {
+        auto os = filesystem::ofstream(tmpFile);
+        if (!os.is_open()) {
+            throw Exception(fmt::format("could not open '{}'", tmpFile), IVW_CONTEXT);
+        }
+        os.imbue(std::locale::classic());
+        os << indexVersion << '\n';
+
+        std::scoped_lock lock{mutex_};
+        for (const auto& [path, entry] : entries_) {
+            os << sanitize(path) << '\t' << entry.stamp.modified << '\t' << entry.stamp.size
+               << '\t' << (entry.header ? 1 : 0);
+            if (entry.header) {
+                os << '\t';
+                writeHeader(os, *entry.header);
+            }
+            os << '\n';
+        }
+    }
+    std::filesystem::rename(tmpFile, indexFile_);
+}
+
+void GdcmScanIndex::load() {
+    if (indexFile_.empty()) return;
+    auto is = filesystem::ifstream(indexFile_);
+    if (!is.is_open()) return;
+
+    std::string line;
+    // an index of another version is rebuilt
+    if (!std::getline(is, line) || line != indexVersion) return;
+
+    std::scoped_lock lock{mutex_};
+    while (std::getline(is, line)) {
+        FieldReader reader{line};
+        std::string path;
+        Entry entry;
+        int isImage = 0;
+        if (!reader.string(path) || !reader.number(entry.stamp.modified) ||
+            !reader.number(entry.stamp.size) || !reader.number(isImage)) {
+            continue;
+        }
+        if (isImage) {
+            entry.header = readHeader(path, reader);
+            // corrupt entries are read again
+            if (!entry.header) continue;
+        }
+        entries_[path] = std::move(entry);
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,110 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dicom/io/gdcmslicecache.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+GdcmSliceCache::GdcmSliceCache(std::shared_ptr<const GCDMVolumeRAMLoader> loader,
+                               size_t capacity)
+    : loader_{std::move(loader)}, capacity_{std::max(capacity, size_t{1})} {}
+
+std::shared_ptr<const VolumeRAM> GdcmSliceCache::getSlice(size_t z) {
+    {
+        std::scoped_lock lock{mutex_};
+        if (auto it = slices_.find(z); it != slices_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.used);
+            return it->second.slice;
+        }
+    }
+
+    // decode without holding the lock, such that other slices can be served meanwhile
+    std::shared_ptr<const VolumeRAM> slice = loader_->readSlice(z);
+
+    std::scoped_lock lock{mutex_};
+    if (auto it = slices_.find(z); it != slices_.end()) {
+        // decoded concurrently by another thread
+        lru_.splice(lru_.begin(), lru_, it->second.used);
+        return it->second.slice;
+    }
+    lru_.push_front(z);
+    slices_.emplace(z, Entry{slice, lru_.begin()});
+    evict();
+    return slice;
+}
+
+void GdcmSliceCache::prefetch(size_t z, size_t radius) {
+    const size_t depth = loader_->getDimensions().z;
+    // more slices than fit in the cache would evict the nearest ones again
+    radius = std::min(radius, (getCapacity() - 1) / 2);
+    for (size_t d = 0; d <= radius; ++d) {
+        if (z + d < depth && !isCached(z + d)) getSlice(z + d);
+        if (d > 0 && d <= z && !isCached(z - d)) getSlice(z - d);
+    }
+}
+
+bool GdcmSliceCache::isCached(size_t z) const {
+    std::scoped_lock lock{mutex_};
+    return slices_.count(z) != 0;
+}
+
+size_t GdcmSliceCache::size() const {
+    std::scoped_lock lock{mutex_};
+    return slices_.size();
+}
+
+void GdcmSliceCache::clear() {
+    std::scoped_lock lock{mutex_};
+    slices_.clear();
+    lru_.clear();
+}
+
+size_t GdcmSliceCache::getCapacity() const {
+    std::scoped_lock lock{mutex_};
+    return capacity_;
+}
+
+void GdcmSliceCache::setCapacity(size_t capacity) {
+    std::scoped_lock lock{mutex_};
+    capacity_ = std::max(capacity, size_t{1});
+    evict();
+}
+
+const size3_t& GdcmSliceCache::getDimensions() const { return loader_->getDimensions(); }
+
+void GdcmSliceCache::evict() {
+    while (slices_.size() > capacity_) {
+        slices_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+}  // namespace inviwo
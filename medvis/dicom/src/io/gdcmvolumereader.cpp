@@ -28,9 +28,14 @@
  *********************************************************************************/
 
 #include <inviwo/dicom/io/gdcmvolumereader.h>
+#include <inviwo/dicom/io/gdcmdicomdir.h>
+#include <inviwo/dicom/io/gdcmgpudecoder.h>
+#include <inviwo/dicom/io/gdcmscanindex.h>
 #include <inviwo/dicom/io/mevisvolumereader.h>
 #include <inviwo/dicom/utils/gdcmutils.h>
 #include <inviwo/dicom/errorlogging.h>
+#include <inviwo/memorybudget/firsttouch.h>
+#include <inviwo/utilities/util/parallel.h>
 
 #include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/util/formatconversion.h>
@@ -46,10 +51,15 @@
 #include <MediaStorageAndFileFormat/gdcmImageReader.h>
 #include <DataStructureAndEncodingDefinition/gdcmAttribute.h>
 #include <DataStructureAndEncodingDefinition/gdcmMediaStorage.h>
+#include <DataStructureAndEncodingDefinition/gdcmSequenceOfFragments.h>
 #include <warn/pop>
 
 #include <functional>
 #include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace inviwo {
 
@@ -86,12 +96,16 @@ GdcmVolumeReader* GdcmVolumeReader::clone() const { return new GdcmVolumeReader(
  */
 std::shared_ptr<Volume> GdcmVolumeReader::getVolumeDescription(dicomdir::Series& series,
                                                                const std::string& path) {
-
     series.updateImageInformation(path);
+    return createVolumeDescription(series, path);
+}
+
+std::shared_ptr<Volume> GdcmVolumeReader::createVolumeDescription(dicomdir::Series& series,
+                                                                  const std::string& path) {
     if (series.empty()) {
         throw DataReaderException(
             fmt::format("DICOM series '{}' does not contain any images ('{}')", series.desc, path),
-            IVW_CONTEXT_CUSTOM("GdcmVolumeReader::getVolumeDescription"));
+            IVW_CONTEXT_CUSTOM("GdcmVolumeReader::createVolumeDescription"));
     }
 
     // sort images by slice position (z) in patient coords
@@ -106,13 +120,15 @@ std::shared_ptr<Volume> GdcmVolumeReader::getVolumeDescription(dicomdir::Series&
         throw DataReaderException(
             fmt::format("unsupported image format in DICOM series '{}': {} ('{}')", series.desc,
                         series.pixelformat.GetScalarTypeAsString(), path),
-            IVW_CONTEXT_CUSTOM("GdcmVolumeReader::getVolumeDescription"));
+            IVW_CONTEXT_CUSTOM("GdcmVolumeReader::createVolumeDescription"));
     }
 
     auto volume = std::make_shared<Volume>(series.dims, format);
 
-    // set data range according to used bits, e.g. 12bits for signed and unsigned
-    volume->dataMap_.dataRange = gdcmutil::getDataRange(series.pixelformat);
+    // set data range according to used bits, e.g. 12bits for signed and unsigned, and map it
+    // to the rescaled values without touching the stored voxels
+    gdcmutil::setDataMapping(volume->dataMap_, series.pixelformat, series.slope, series.intercept,
+                             series.modality);
 
     // TODO: determine data range based on DICOMDIR tags (largest/smallest pixel value),
     // which might not exist!
@@ -125,12 +141,6 @@ std::shared_ptr<Volume> GdcmVolumeReader::getVolumeDescription(dicomdir::Series&
     }
     */
 
-    volume->dataMap_.valueRange = volume->dataMap_.dataRange * series.slope + series.intercept;
-
-    if (series.modality == "CT") {
-        volume->dataMap_.valueUnit = "HU";
-    }
-
     // basis and offset computations
 
     // CHECK: can we use origin and direction cosines of refImage instead?
@@ -138,7 +148,7 @@ std::shared_ptr<Volume> GdcmVolumeReader::getVolumeDescription(dicomdir::Series&
     dvec3 spacing{series.pixelSpacing};
     if (series.pixelSpacing.z == 0.0) {
         if (dicomImg.sliceThickness == 0.0) {
-            LogWarnCustom("GdcmVolumeReader::getVolumeDescription",
+            LogWarnCustom("GdcmVolumeReader::createVolumeDescription",
                           fmt::format("DICOM series '{}' does not define pixel spacing in z or "
                                       "slice thickness, using 1.0 for z ('{}')",
                                       series.desc, path));
@@ -166,14 +176,14 @@ std::shared_ptr<Volume> GdcmVolumeReader::getVolumeDescription(dicomdir::Series&
  * Looks only at all the image files and ignores possibly existing DIOCMDIR.
  */
 std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMsequenceRecursive(
-    const std::string& directory) {
-    std::shared_ptr<VolumeSequence> outputVolumes = tryReadDICOMsequence(directory);
+    const std::string& directory, const GdcmDecodingOptions& options) {
+    std::shared_ptr<VolumeSequence> outputVolumes = tryReadDICOMsequence(directory, options);
 
     const auto childDirectories =
         filesystem::getDirectoryContents(directory, filesystem::ListMode::Directories);
     for (const auto& childDir : childDirectories) {
         std::shared_ptr<VolumeSequence> childVolumes =
-            tryReadDICOMsequenceRecursive(directory + '/' + childDir);
+            tryReadDICOMsequenceRecursive(directory + '/' + childDir, options);
         for (const auto& childVolume : *childVolumes) {
             outputVolumes->push_back(childVolume);
         }
@@ -186,57 +196,37 @@ std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMsequenceRecursive(
  * Non-recursive version of tryReadDICOMsequenceRecursive
  */
 std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMsequence(
-    const std::string& sequenceDirectory) {
+    const std::string& sequenceDirectory, const GdcmDecodingOptions& options) {
     const auto files = filesystem::getDirectoryContents(sequenceDirectory);
     std::shared_ptr<VolumeSequence> outputVolumes = std::make_shared<VolumeSequence>();
     std::map<std::string, dicomdir::Series> seriesByUID;
 
+    std::vector<std::string> paths;
+    paths.reserve(files.size());
     for (const auto& f : files) {
-        // try to load file as DICOM
-        // if yes: read patient ID and sequence ID
-        // group sequences by sequence ID
-        // add sequences to "outputVolumes"
-        std::string file = sequenceDirectory + '/' + f;
-        if (!filesystem::fileExists(file)) {
-            throw DataReaderException(fmt::format("file does not exist ('{}')", file),
-                                      IVW_CONTEXT_CUSTOM("GdcmVolumeReader::tryReadDICOMsequence"));
-        }
-
-        gdcm::ImageReader imageReader;
-        std::ifstream imageInputStream(file, std::ios::binary);
-        if (!imageInputStream.is_open()) {
-            throw DataReaderException(fmt::format("file cannot be opened ('{}')", file),
-                                      IVW_CONTEXT_CUSTOM("GdcmVolumeReader::tryReadDICOMsequence"));
-        }
+        paths.push_back(sequenceDirectory + '/' + f);
+    }
 
-        /*if (!imageReader.CanRead()) { // call this on file BrainSample 11.7T\4\pdata\1\2dseq
-        => gdcm crash continue; // skip non-dicom files
-        }*/
-        imageReader.SetStream(imageInputStream);
-        if (imageReader.Read()) {
-            const auto dataset = imageReader.GetFile().GetDataSet();
-            const auto seriesUIDTag = gdcm::Tag(0x0020, 0x000E);
-
-            if (dataset.FindDataElement(seriesUIDTag)) {
-                std::stringstream seriesUID;
-                dataset.GetDataElement(seriesUIDTag).GetValue().Print(seriesUID);
-                std::string suid = seriesUID.str();
-                if (seriesByUID.find(suid) == seriesByUID.end()) {
-                    gdcm::MediaStorage dicomMediaStorage;
-                    dicomMediaStorage.SetFromFile(imageReader.GetFile());
-                    dicomdir::Series newSeries;
-                    newSeries.modality = dicomMediaStorage.GetModality();
-                    seriesByUID[suid] = newSeries;
-                }
-                seriesByUID[suid].images.push_back(dicomdir::Image{file});
-            } else {
-                throw DataReaderException(
-                    fmt::format("could not find DICOM series UID ('{}')", file),
-                    IVW_CONTEXT_CUSTOM("GdcmVolumeReader::tryReadDICOMsequence"));
-            }
-        } else {
+    // only the headers of the files are needed to group the images by series. These are read in
+    // parallel and cached in the scan index, which skips unchanged files on subsequent reads.
+    const auto headers = GdcmScanIndex::get().scan(paths, options.threads);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const auto& header = headers[i];
+        if (!header) {
             continue;  // skip non-dicom files
         }
+        if (header->seriesUID.empty()) {
+            throw DataReaderException(
+                fmt::format("could not find DICOM series UID ('{}')", paths[i]),
+                IVW_CONTEXT_CUSTOM("GdcmVolumeReader::tryReadDICOMsequence"));
+        }
+        auto it = seriesByUID.find(header->seriesUID);
+        if (it == seriesByUID.end()) {
+            dicomdir::Series newSeries;
+            newSeries.modality = header->modality;
+            it = seriesByUID.emplace(header->seriesUID, std::move(newSeries)).first;
+        }
+        it->second.images.push_back(header->image);
     }
 
     for (const auto& pair : seriesByUID) {
@@ -250,6 +240,7 @@ std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMsequence(
                                                      vol->getDataFormat());
         auto loader = util::make_unique<GCDMVolumeRAMLoader>(
             sequenceDirectory, vol->getDimensions(), vol->getDataFormat(), true, series);
+        loader->setDecodingOptions(options);
         diskRepr->setLoader(loader.release());
         vol->addRepresentation(diskRepr);
         outputVolumes->push_back(vol);
@@ -261,183 +252,42 @@ std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMsequence(
  * Try to read all volumes contained in given path using standard dicomdir:: format
  */
 std::shared_ptr<VolumeSequence> GdcmVolumeReader::tryReadDICOMDIR(
-    const std::string& fileOrDirectory) {
-    std::string dicomdirPath = fileOrDirectory;
-    std::ifstream dicomdirInputStream(dicomdirPath, std::ios::binary);
-    if (!dicomdirInputStream.is_open()) {
-        throw DataReaderException(fmt::format("could not open DICOM file ('{}')", dicomdirPath),
-                                  IVW_CONTEXT_CUSTOM("GdcmVolumeReader::tryReadDICOMDIR"));
-    }
-
-    // Analog to gdcm example "ReadAndDumpdicomdir::"
-    gdcm::Reader reader;
-    reader.SetStream(dicomdirInputStream);
-    if (!reader.Read()) {
-        // LogInfo(dicomdirPath + " is no DICOM file");
+    const std::string& fileOrDirectory, const GdcmDecodingOptions& options) {
+    const std::string& dicomdirPath = fileOrDirectory;
+    auto dicomdir = GdcmDicomDir::open(dicomdirPath, options);
+    if (!dicomdir) {
         return 0;
     }
-
-    gdcm::File& file = reader.GetFile();
-
-    // First check meta info
-    gdcm::FileMetaInformation& metainfo = file.GetHeader();
-    gdcm::MediaStorage dicomMediaStorage;
-    dicomMediaStorage.SetFromFile(file);
-    if (dicomMediaStorage != gdcm::MediaStorage::MediaStorageDirectoryStorage) {
-        return 0;
-    }
-
-    std::stringstream storageUID;
-    if (metainfo.FindDataElement(gdcm::Tag(0x0002, 0x0002))) {
-        storageUID.str("");
-        metainfo.GetDataElement(gdcm::Tag(0x0002, 0x0002)).GetValue().Print(storageUID);
-    } else {
-        // Media Storage Sop Class UID not present
-        return 0;
-    }
-
-    // Trim string because DICOM allows padding with spaces
-    auto storageUIDstr = trim(storageUID.str());
-
-    if ("1.2.840.10008.1.3.10" != storageUIDstr) {
-        // This file is not a dicomdir::
-        return 0;
-    }
-
-    // Now read actual dataset
-    gdcm::DataSet& dataset = file.GetDataSet();
-
-    auto getString = [](const auto& ds, const gdcm::Tag& tag) -> std::string {
-        std::stringstream ss;
-        if (ds.FindDataElement(tag)) {
-            auto& elem = ds.GetDataElement(tag);
-            if (!elem.IsEmpty() && !elem.IsUndefinedLength()) {
-                elem.GetValue().Print(ss);
-            }
-        }
-        return trim(ss.str());
-    };
-
-    const gdcm::Tag patientsNameTag(0x0010, 0x0010);
-    const gdcm::Tag patientsIdTag(0x0010, 0x0020);
-    const gdcm::Tag studyDateTag(0x0008, 0x0020);
-    const gdcm::Tag studyDescTag(0x0008, 0x1030);
-    const gdcm::Tag seriesDescTag(0x0008, 0x103e);
-
-    const gdcm::Tag directoryRecordSequenceTag(0x0004, 0x1220);
-    const gdcm::Tag directoryRecordTypeTag(0x0004,
-                                           0x1430);  // value can be patient, study, series or image
-    const gdcm::Tag referencedFileID(0x0004, 0x1500);  // value is e.g. image path
-
-    int patientCount = 0;
-    int studyCount = 0;
-    int seriesCount = 0;
-    int imageCount = 0;
-    std::vector<dicomdir::Patient> dataPerPatient;
-    // for each patient: for each study: for each series: get images (in this first loop only
-    // the paths!)
-    for (auto dataElement : dataset.GetDES()) {
-        // only look at directory sequence
-        if (dataElement.GetTag() != directoryRecordSequenceTag) {
-            continue;
-        }
-
-        auto recordSequence = dataElement.GetValueAsSQ();
-        // This loop also iterates all the nested records sequences (like depth-first tree
-        // traversal)
-        for (int recIndex = 1; recIndex <= recordSequence->GetNumberOfItems(); recIndex++) {
-            // Records contain data about either a patient, study, series or image
-            // image records reference image files
-            gdcm::Item& record = recordSequence->GetItem(recIndex);
-            if (!record.FindDataElement(directoryRecordTypeTag)) {
-                continue;
-            }
-
-            std::stringstream recordType;
-            record.GetDataElement(directoryRecordTypeTag).GetValue().Print(recordType);
-            std::string recType = trim(recordType.str());
-
-            if (recType == "PATIENT") {
-                const auto patientName = getString(record, patientsNameTag);
-                const auto patientId = getString(record, patientsIdTag);
-                dataPerPatient.push_back({patientName, patientId, {}});
-
-                patientCount++;
-            } else if (recType == "STUDY") {
-                // study UID gdcm::Tag (0x0020, 0x000d)
-                const auto date = getString(record, studyDateTag);
-                const auto desc = getString(record, studyDescTag);
-                dataPerPatient.back().studies.push_back({date, desc, {}});
-                studyCount++;
-            } else if (recType == "SERIES") {
-                // series UID gdcm::Tag (0x0020, 0x000e)
-                dataPerPatient.back().studies.back().series.emplace_back(
-                    getString(record, seriesDescTag));
-                seriesCount++;
-            } else if (recType == "IMAGE") {
-                // image UID gdcm::Tag (0x0004, 0x1511))
-
-                // save referenced image path to be able to read it later if it's in the volume
-                if (record.FindDataElement(referencedFileID)) {
-                    std::stringstream imagePath;
-                    record.GetDataElement(referencedFileID).GetValue().Print(imagePath);
-                    std::string imagePathStr = trim(imagePath.str());
-
-                    // relative to absolute path
-                    imagePathStr =
-                        dicomdirPath.substr(0, dicomdirPath.find_last_of("/\\") + 1) + imagePathStr;
-
-                    auto& study = dataPerPatient.back().studies.back();
-                    auto& series = study.series.back();
-
-                    series.images.push_back(dicomdir::Image{imagePathStr});
-                }
-
-                imageCount++;
+    const auto& dataPerPatient = dicomdir->getPatients();
+
+    size_t studyCount = 0;
+    size_t seriesCount = 0;
+    size_t imageCount = 0;
+    for (const auto& patient : dataPerPatient) {
+        studyCount += patient.studies.size();
+        for (const auto& study : patient.studies) {
+            seriesCount += study.series.size();
+            for (const auto& series : study.series) {
+                imageCount += series.images.size();
             }
         }
     }
 
     LogInfoCustom("GdcmVolumeReader", "Scanned dicomdir:: ('"
                                           << dicomdirPath << "'):\n    PatientCount = "
-                                          << patientCount << "\n    StudyCount = " << studyCount
-                                          << "\n    ImageCount = " << imageCount);
+                                          << dataPerPatient.size() << "\n    StudyCount = "
+                                          << studyCount << "\n    ImageCount = " << imageCount);
 
-    if (patientCount == 0 || studyCount == 0 || seriesCount == 0 || imageCount == 0) {
+    if (dataPerPatient.empty() || studyCount == 0 || seriesCount == 0 || imageCount == 0) {
         LogWarnCustom("GdcmVolumeReader",
                       "No volumes found in dicomdir::  ('" << dicomdirPath << "')");
         return 0;
     }
 
-    // Build volumes from images
-    std::shared_ptr<VolumeSequence> outputVolumes = std::make_shared<VolumeSequence>();
-    for (dicomdir::Patient& patient : dataPerPatient) {  // push everything in one sequence
-        for (dicomdir::Study& study : patient.studies) {
-            for (dicomdir::Series& series : study.series) {
-                if (series.images.empty()) {
-                    continue;
-                }
-
-                series.modality = dicomMediaStorage.GetModality();
-
-                std::shared_ptr<Volume> vol = getVolumeDescription(series, dicomdirPath);
-                // on-demand loading via loader class
-                auto diskRepr = std::make_shared<VolumeDisk>(dicomdirPath, vol->getDimensions(),
-                                                             vol->getDataFormat());
-                auto loader = util::make_unique<GCDMVolumeRAMLoader>(
-                    dicomdirPath, vol->getDimensions(), vol->getDataFormat(), true, series);
-                diskRepr->setLoader(loader.release());
-                vol->addRepresentation(diskRepr);
-                vol->setMetaData<StringMetaData>("name", series.desc);
-                vol->setMetaData<StringMetaData>("patientName", patient.patientName);
-                vol->setMetaData<StringMetaData>("patientId", patient.patientId);
-                vol->setMetaData<StringMetaData>("studyDesc", study.desc);
-                vol->setMetaData<StringMetaData>("studyDate", study.date);
-
-                outputVolumes->push_back(vol);
-            }
-        }
-    }
+    // Build volumes from images, push everything in one sequence
+    auto volumes = dicomdir->getVolumes(dicomdir->getAllSeries());
+    std::shared_ptr<VolumeSequence> outputVolumes =
+        std::make_shared<VolumeSequence>(volumes.begin(), volumes.end());
 
     // print a summary of all collected volumes
     auto createLine = [](const std::string& tag, auto text, int indent) {
@@ -529,7 +379,8 @@ std::shared_ptr<VolumeSequence> GdcmVolumeReader::readData(const std::string& fi
     gdcm::Trace::DebugOff();  // prevent gdcm from spamming inviwo console
 
     {
-        std::shared_ptr<VolumeSequence> outputVolumes = tryReadDICOMsequenceRecursive(directory);
+        std::shared_ptr<VolumeSequence> outputVolumes =
+            tryReadDICOMsequenceRecursive(directory, decodingOptions_);
         if (outputVolumes) {
             this->file_ = directory;
             this->volumes_ = outputVolumes;
@@ -681,25 +532,17 @@ std::shared_ptr<Volume> GdcmVolumeReader::generateVolume(const gdcm::Image& imag
     volume->setBasis(basis);
     volume->setOffset(offset);
     volume->setWorldMatrix(wtm);
-    volume->dataMap_.dataRange = dvec2(pixelformat.GetMin(), pixelformat.GetMax());
 
     // image.GetSlope() and image.GetIntercept() can be incorrect (failure when calling
     // image.Read()) Use dicom attributes director
     std::vector<double> is = gdcm::ImageHelper::GetRescaleInterceptSlopeValue(file);
     auto intercept = is[0];
     auto slope = is[1];
-    const std::string modality(ms.GetModality());
-
-    // TODO: check this heuristics!!!
-    if (modality == "CT") {
-        // Computed Tomography
-        volume->dataMap_.valueUnit = "HU";  // Hounsfield Unit
-        if (format->getPrecision() == 16) {
-            volume->dataMap_.dataRange = {0.0, 4095};
-        }
-    }
+    ms.SetFromFile(file);
+    const char* modality = ms.GetModality();
 
-    volume->dataMap_.valueRange = volume->dataMap_.dataRange * slope + intercept;
+    gdcmutil::setDataMapping(volume->dataMap_, pixelformat, slope, intercept,
+                             modality ? modality : "");
 
     auto vd = std::make_shared<VolumeDisk>(file_, dimension, format);
     vd->setLoader(new GCDMVolumeRAMLoader(file_, dimension, format));
@@ -719,42 +562,258 @@ GCDMVolumeRAMLoader::GCDMVolumeRAMLoader(std::string file, size3_t dimension,
 
 GCDMVolumeRAMLoader* GCDMVolumeRAMLoader::clone() const { return new GCDMVolumeRAMLoader(*this); }
 
+void GCDMVolumeRAMLoader::setDecodingOptions(GdcmDecodingOptions options) {
+    decodingOptions_ = std::move(options);
+    if (!decodingOptions_.gpuDecoding || !GdcmGpuDecoder::isAvailable()) {
+        gpuDecoder_.reset();
+    } else if (!gpuDecoder_) {
+        gpuDecoder_ = std::make_shared<GdcmGpuDecoder>();
+    }
+}
+
 std::shared_ptr<VolumeRepresentation> GCDMVolumeRAMLoader::createRepresentation(
     const VolumeRepresentation&) const {
     return format_->dispatch(*this);
 }
 
+namespace {
+
 /**
- * Reads DICOM volume data from disk to RAM
- * @param series represents the volume as collection of image file paths
+ * Decodes the DICOM image in \p path into \p dest, which holds exactly \p bytes bytes. Files
+ * which are not DICOM images are skipped, and their slice is filled with zeros. Images supported
+ * by \p gpu, if given, are decoded on the GPU and all others by gdcm.
  */
-void GCDMVolumeRAMLoader::getVolumeData(const dicomdir::Series& series, void* outData) const {
-    unsigned long totalByteCount = 0;
-    for (const auto& imgInfo : series.images) {
-        gdcm::ImageReader imageReader;
-
-        std::ifstream imageInputStream(imgInfo.path, std::ios::binary);
-        if (!imageInputStream.is_open()) {
-            throw DataReaderException(fmt::format("file cannot be opened ('{}')", imgInfo.path),
-                                      IVW_CONTEXT);
-        }
+void decodeSlice(const std::string& path, char* dest, size_t bytes, GdcmGpuDecoder* gpu) {
+    std::ifstream imageInputStream(path, std::ios::binary);
+    if (!imageInputStream.is_open()) {
+        throw DataReaderException(fmt::format("file cannot be opened ('{}')", path),
+                                  IVW_CONTEXT_CUSTOM("GCDMVolumeRAMLoader::decodeSlice"));
+    }
 
-        imageReader.SetStream(imageInputStream);
-        if (!imageReader.CanRead()) {
-            // Image is probably no DICOM file, its best to just skip it
-            continue;
+    gdcm::ImageReader imageReader;
+    imageReader.SetStream(imageInputStream);
+    // Image is probably no DICOM file, its best to just skip it
+    if (!imageReader.CanRead() || !imageReader.Read()) {
+        std::fill(dest, dest + bytes, char{0});
+        return;
+    }
+
+    const gdcm::Image& image = imageReader.GetImage();
+    // the slices are decoded in place, a larger image would overwrite the next slice
+    if (image.GetBufferLength() != bytes) {
+        throw DataReaderException(
+            fmt::format("inconsistent image size: {} byte, expected {} byte ('{}')",
+                        image.GetBufferLength(), bytes, path),
+            IVW_CONTEXT_CUSTOM("GCDMVolumeRAMLoader::decodeSlice"));
+    }
+    // the reader leaves compressed pixel data encapsulated, so it can go to the GPU as is
+    if (gpu && gpu->decode(image, dest, bytes)) return;
+
+    // Get RAW image (gdcm does the decoding for us)
+    if (!image.GetBuffer(dest)) {
+        throw DataReaderException(fmt::format("could not read image data ('{}')", path),
+                                  IVW_CONTEXT_CUSTOM("GCDMVolumeRAMLoader::decodeSlice"));
+    }
+}
+
+/**
+ * Returns the range of fragments [first, last) holding each frame of the encapsulated pixel data
+ * in \p fragments. The frames are located through the Basic Offset Table, whose offsets are
+ * relative to the first fragment and count the 8 byte item header of each fragment. Without a
+ * table each fragment has to hold one frame. Returns an empty vector if the frames cannot be
+ * located, e.g. for an empty table and frames split into several fragments.
+ */
+std::vector<std::pair<size_t, size_t>> getFrameFragments(
+    const gdcm::SequenceOfFragments& fragments, size_t frames) {
+    const size_t count = fragments.GetNumberOfFragments();
+    std::vector<std::pair<size_t, size_t>> result;
+
+    const gdcm::ByteValue* table = fragments.GetTable().GetByteValue();
+    if (!table || table->GetLength() == 0) {
+        if (count != frames) return {};
+        for (size_t i = 0; i < count; ++i) result.emplace_back(i, i + 1);
+        return result;
+    }
+    if (table->GetLength() != frames * sizeof(uint32_t)) return {};
+
+    std::vector<uint32_t> offsets(frames);
+    std::memcpy(offsets.data(), table->GetPointer(), table->GetLength());
+
+    uint64_t offset = 0;
+    size_t frame = 0;
+    for (size_t i = 0; i < count && frame < frames; ++i) {
+        if (offset == offsets[frame]) {
+            if (!result.empty()) result.back().second = i;
+            result.emplace_back(i, count);
+            ++frame;
+        } else if (result.empty()) {
+            return {};  // the first frame has to start with the first fragment
         }
+        offset += 8 + fragments.GetFragment(static_cast<unsigned int>(i)).GetVL();
+    }
+    if (frame != frames) return {};
+    return result;
+}
+
+/**
+ * Creates a single frame image of the fragments in \p range of the multi-frame \p image, such
+ * that gdcm decodes only this frame.
+ */
+gdcm::Image createFrameImage(const gdcm::Image& image, const gdcm::SequenceOfFragments& fragments,
+                             std::pair<size_t, size_t> range) {
+    gdcm::SmartPointer<gdcm::SequenceOfFragments> frameFragments = new gdcm::SequenceOfFragments;
+    for (size_t i = range.first; i < range.second; ++i) {
+        frameFragments->AddFragment(fragments.GetFragment(static_cast<unsigned int>(i)));
+    }
+    gdcm::DataElement pixelData(image.GetDataElement().GetTag());
+    pixelData.SetVR(gdcm::VR::OB);
+    pixelData.SetValue(*frameFragments);
+
+    gdcm::Image frame;
+    frame.SetNumberOfDimensions(2);
+    frame.SetDimension(0, image.GetDimension(0));
+    frame.SetDimension(1, image.GetDimension(1));
+    frame.SetPixelFormat(image.GetPixelFormat());
+    frame.SetPhotometricInterpretation(image.GetPhotometricInterpretation());
+    frame.SetPlanarConfiguration(image.GetPlanarConfiguration());
+    frame.SetTransferSyntax(image.GetTransferSyntax());
+    frame.SetDataElement(pixelData);
+    return frame;
+}
 
-        if (imageReader.Read()) {
-            gdcm::Image image = imageReader.GetImage();
-            // Get RAW image (gdcm does the decoding for us)
-            if (!image.GetBuffer(reinterpret_cast<char*>(outData) + totalByteCount)) {
-                throw DataReaderException(
-                    fmt::format("could not read image data ('{}')", imgInfo.path), IVW_CONTEXT);
+}  // namespace
+
+size_t GCDMVolumeRAMLoader::getSliceBytes() const {
+    return dimension_.x * dimension_.y * format_->getSize();
+}
+
+/**
+ * Reads DICOM volume data from disk to RAM. The slices are handed out one at a time to a bounded
+ * number of threads, the calling thread included, and each is decoded straight into its offset
+ * in \p outData. Compressed series, e.g. JPEG 2000 or JPEG-LS, are dominated by the decoding, so
+ * this scales with the number of threads.
+ */
+void GCDMVolumeRAMLoader::getVolumeData(size_t first, size_t count, void* outData) const {
+    const auto& images = series_.images;
+    if (count == 0) return;
+    if (first + count > images.size()) {
+        throw DataReaderException(
+            fmt::format("slices [{}, {}) are outside of DICOM series '{}' with {} images", first,
+                        first + count, series_.desc, images.size()),
+            IVW_CONTEXT);
+    }
+
+    const size_t sliceBytes = getSliceBytes();
+    auto dest = static_cast<char*>(outData);
+
+    size_t decoded = 0;
+    std::mutex mutex;
+    const bool completed = util::forEachRangeParallel(
+        count, 1,
+        [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                decodeSlice(images[first + i].path, dest + i * sliceBytes, sliceBytes,
+                            gpuDecoder_.get());
+
+                std::scoped_lock lock{mutex};
+                ++decoded;
+                if (decodingOptions_.progress) decodingOptions_.progress(decoded, count);
             }
+        },
+        decodingOptions_.cancel, decodingOptions_.threads);
 
-            totalByteCount += image.GetBufferLength();
+    if (!completed) {
+        throw DataReaderException(
+            fmt::format("decoding of DICOM series '{}' was cancelled", series_.desc), IVW_CONTEXT);
+    }
+}
+
+/**
+ * Reads frames [first, first + count) of a single DICOM file. The frames of compressed
+ * multi-frame files, e.g. enhanced CT or MR images, are located in the encapsulated pixel data
+ * and decoded in parallel, each straight into its offset in \p outData. Other files are decoded
+ * as a whole.
+ */
+void GCDMVolumeRAMLoader::getFileData(size_t first, size_t count, void* outData) const {
+    if (count == 0) return;
+    if (first + count > dimension_.z) {
+        throw DataReaderException(
+            fmt::format("frames [{}, {}) are outside of DICOM file with {} frames ('{}')", first,
+                        first + count, dimension_.z, file_),
+            IVW_CONTEXT);
+    }
+
+    gdcm::ImageReader reader;
+    reader.SetFileName(file_.c_str());
+    if (!reader.Read()) {
+        throw DataReaderException(fmt::format("could not read file ('{}')", file_), IVW_CONTEXT);
+    }
+
+    const gdcm::Image& image = reader.GetImage();
+    const size_t sliceBytes = getSliceBytes();
+    auto dest = static_cast<char*>(outData);
+
+    const gdcm::SequenceOfFragments* fragments = image.GetDataElement().GetSequenceOfFragments();
+    const auto frames = fragments && dimension_.z > 1
+                            ? getFrameFragments(*fragments, dimension_.z)
+                            : std::vector<std::pair<size_t, size_t>>{};
+    if (frames.empty()) {
+        if (first == 0 && count == dimension_.z) {
+            if (!image.GetBuffer(dest)) {
+                throw DataReaderException(fmt::format("could not read image data ('{}')", file_),
+                                          IVW_CONTEXT);
+            }
+            return;
         }
+        std::vector<char> buffer(dimension_.z * sliceBytes);
+        if (!image.GetBuffer(buffer.data())) {
+            throw DataReaderException(fmt::format("could not read image data ('{}')", file_),
+                                      IVW_CONTEXT);
+        }
+        std::copy_n(buffer.data() + first * sliceBytes, count * sliceBytes, dest);
+        return;
+    }
+
+    size_t decoded = 0;
+    std::mutex mutex;
+    const auto decodeFrame = [&](size_t i) {
+        const auto frame = createFrameImage(image, *fragments, frames[first + i]);
+        char* frameDest = dest + i * sliceBytes;
+        if (frame.GetBufferLength() != sliceBytes) {
+            throw DataReaderException(
+                fmt::format("inconsistent frame size: {} byte, expected {} byte ('{}')",
+                            frame.GetBufferLength(), sliceBytes, file_),
+                IVW_CONTEXT_CUSTOM("GCDMVolumeRAMLoader::getFileData"));
+        }
+        if (!(gpuDecoder_ && gpuDecoder_->decode(frame, frameDest, sliceBytes)) &&
+            !frame.GetBuffer(frameDest)) {
+            throw DataReaderException(
+                fmt::format("could not decode frame {} ('{}')", first + i, file_),
+                IVW_CONTEXT_CUSTOM("GCDMVolumeRAMLoader::getFileData"));
+        }
+
+        std::scoped_lock lock{mutex};
+        ++decoded;
+        if (decodingOptions_.progress) decodingOptions_.progress(decoded, count);
+    };
+    const bool completed = util::forEachRangeParallel(
+        count, 1,
+        [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) decodeFrame(i);
+        },
+        decodingOptions_.cancel, decodingOptions_.threads);
+
+    if (!completed) {
+        throw DataReaderException(fmt::format("decoding of DICOM file was cancelled ('{}')", file_),
+                                  IVW_CONTEXT);
+    }
+}
+
+void GCDMVolumeRAMLoader::getSlices(size_t first, size_t count, void* outData) const {
+    if (isPartOfSequence_) {
+        getVolumeData(first, count, outData);
+    } else {
+        getFileData(first, count, outData);
     }
 }
 
@@ -763,51 +822,59 @@ std::shared_ptr<VolumeRAM> GCDMVolumeRAMLoader::dispatch() const {
     // T is the voxel memory format
     // F is the corresponding datatype (i.e. the template arg with which the format was created)
     typedef typename T::type F;
-    const std::size_t size = dimension_[0] * dimension_[1] * dimension_[2];
-    auto data = util::make_unique<F[]>(size);
-    if (!isPartOfSequence_) {
-        gdcm::ImageReader reader;
-        reader.SetFileName(file_.c_str());
-        if (!reader.Read()) {
-            throw DataReaderException(fmt::format("could not read file ('{}')", file_),
-                                      IVW_CONTEXT);
-        }
+    // touched in parallel, spreading the pages over the NUMA nodes of the processing threads
+    auto data = util::allocateFirstTouch<F>(dimension_);
+    getSlices(0, dimension_.z, data.get());
+    auto repr = std::make_shared<VolumeRAMPrecision<F>>(data.get(), dimension_);
+    data.release();
 
-        const gdcm::Image& image = reader.GetImage();
-        image.GetBuffer(reinterpret_cast<char*>(data.get()));
-        auto repr = std::make_shared<VolumeRAMPrecision<F>>(data.get(), dimension_);
-        data.release();
+    return repr;
+}
 
-        return repr;
-    } else {
-        getVolumeData(series_, (void*)data.get());
+void GCDMVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
+                                               const VolumeRepresentation&) const {
+    auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
+    getSlices(0, dimension_.z, volumeDst->getData());
+}
+
+std::shared_ptr<VolumeRAM> GCDMVolumeRAMLoader::readSubVolume(const size3_t& offset,
+                                                              const size3_t& extent) const {
+    if (glm::any(glm::greaterThan(offset + extent, dimension_))) {
+        throw DataReaderException(
+            fmt::format("sub volume at {} of size {} exceeds the volume dimensions {}",
+                        toString(offset), toString(extent), toString(dimension_)),
+            IVW_CONTEXT);
+    }
 
-        auto repr = std::make_shared<VolumeRAMPrecision<F>>(data.get(), dimension_);
-        data.release();
+    auto volume = util::createVolumeRAMFirstTouch(extent, format_);
+    if (extent.x * extent.y * extent.z == 0) return volume;
+    auto dest = static_cast<char*>(volume->getData());
 
-        return repr;
+    // whole slices are decoded in place
+    if (extent.x == dimension_.x && extent.y == dimension_.y) {
+        getSlices(offset.z, extent.z, dest);
+        return volume;
     }
-}
 
-void GCDMVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
-                                               const VolumeRepresentation&) const {
-    if (!isPartOfSequence_) {
-        gdcm::ImageReader reader;
-        reader.SetFileName(file_.c_str());
-        if (!reader.Read()) {
-            throw DataReaderException(fmt::format("could not read file ('{}')", file_),
-                                      IVW_CONTEXT);
-        }
+    const size_t sliceBytes = getSliceBytes();
+    std::vector<char> slices(extent.z * sliceBytes);
+    getSlices(offset.z, extent.z, slices.data());
+    const char* src = slices.data();
 
-        const gdcm::Image& image = reader.GetImage();
-        const std::size_t size = dimension_[0] * dimension_[1] * dimension_[2];
-        auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
-        auto data = volumeDst->getData();
-        image.GetBuffer(reinterpret_cast<char*>(data));
-    } else {
-        std::shared_ptr<VolumeRAM> volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
-        getVolumeData(series_, volumeDst->getData());
+    const size_t voxelBytes = format_->getSize();
+    const size_t rowBytes = extent.x * voxelBytes;
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            const char* row =
+                src + z * sliceBytes + ((offset.y + y) * dimension_.x + offset.x) * voxelBytes;
+            dest = std::copy(row, row + rowBytes, dest);
+        }
     }
+    return volume;
+}
+
+std::shared_ptr<VolumeRAM> GCDMVolumeRAMLoader::readSlice(size_t z) const {
+    return readSubVolume(size3_t{0, 0, z}, size3_t{dimension_.x, dimension_.y, 1});
 }
 
 }  // namespace inviwo
@@ -52,6 +52,9 @@
 #include <inviwo/dicom/io/mevisvolumereader.h>
 #include <inviwo/dicom/errorlogging.h>
 #include <inviwo/dicom/io/gdcmvolumereader.h>
+#include <inviwo/dicom/utils/gdcmutils.h>
+#include <inviwo/utilities/io/mappedfile.h>
+#include <inviwo/utilities/util/parallel.h>
 
 #include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/util/formatconversion.h>
@@ -286,6 +289,67 @@ void MevisVolumeRAMLoader::readDataInto(void* destination) const {
     IVW_ASSERT(tilerowbytes == tilesize.x * bytespersample,
                "tilerowbytes and tilesize.x * bytespersample differ");
 
+    // copies the tile at (x0, y0, z0) into the volume, skipping the padding of border tiles
+    auto copyTile = [&](const unsigned char* pb, size_t x0, size_t y0, size_t z0) {
+        const size_t pv_off = z0 * dimension_.y * dimension_.x + y0 * dimension_.x + x0;
+        unsigned char* pv_slice_ptr = vol + pv_off * bytespersample;
+
+        const std::size_t zmin = std::min(tilesize.z, dimension_.z - z0);
+        const std::size_t ymin = std::min(tilesize.y, dimension_.y - y0);
+        const std::size_t xmin = std::min(tilesize.x, dimension_.x - x0) * bytespersample;
+
+        const std::size_t pv_step = dimension_.x * bytespersample;
+        const std::size_t pb_step = tilesize.x * bytespersample;
+        const std::size_t pv_w_step = dimension_.y * dimension_.x * bytespersample;
+
+        for (std::size_t w = 0; w < zmin; ++w) {
+            unsigned char* pv = pv_slice_ptr;
+            for (std::size_t v = 0; v < ymin; ++v) {
+                std::copy(pb, pb + xmin, pv);
+                pv += pv_step;
+                pb += pb_step;
+            }
+            pv_slice_ptr += pv_w_step;
+        }
+    };
+
+    const size3_t tiles = (dimension_ + tilesize - size3_t{1}) / tilesize;
+    const size_t numberOfTiles = tiles.x * tiles.y * tiles.z;
+    auto tileOrigin = [&](size_t i) {
+        return size3_t{i % tiles.x, (i / tiles.x) % tiles.y, i / (tiles.x * tiles.y)} * tilesize;
+    };
+
+    // Uncompressed tiles are copied straight out of a memory mapping of the file, the pages are
+    // read by the OS on first access and shared with other processes reading the same volume.
+    // As the tiles are independent, they are copied in parallel.
+    uint16 compression = COMPRESSION_NONE;
+    TIFFGetFieldDefaulted(tiffimage, TIFFTAG_COMPRESSION, &compression);
+    toff_t* tileoffsets = nullptr;
+    toff_t* tilebytecounts = nullptr;
+    if (compression == COMPRESSION_NONE && !TIFFIsByteSwapped(tiffimage) &&
+        TIFFGetField(tiffimage, TIFFTAG_TILEOFFSETS, &tileoffsets) &&
+        TIFFGetField(tiffimage, TIFFTAG_TILEBYTECOUNTS, &tilebytecounts)) {
+        try {
+            MappedFile file(tif_file_);
+            util::forEachRangeParallel(numberOfTiles, 1, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i) {
+                    const auto origin = tileOrigin(i);
+                    const auto tile = TIFFComputeTile(tiffimage, static_cast<uint32>(origin.x),
+                                                      static_cast<uint32>(origin.y),
+                                                      static_cast<uint32>(origin.z), 0);
+                    if (tilebytecounts[tile] < tilesz ||
+                        tileoffsets[tile] + tilesz > file.size()) {
+                        throw DataReaderException(formatErrorMsg("tile exceeds the file"));
+                    }
+                    copyTile(file.data() + tileoffsets[tile], origin.x, origin.y, origin.z);
+                }
+            });
+            return;
+        } catch (const FileException& e) {
+            LogWarn(e.getMessage() << ", reading tiles through libtiff instead");
+        }
+    }
+
     unsigned char* tilebuf = static_cast<unsigned char*>(_TIFFmalloc(tilesz));
     if (!tilebuf) {
         throw DataReaderException(formatErrorMsg("could not allocate tile buffer"));
@@ -298,48 +362,15 @@ void MevisVolumeRAMLoader::readDataInto(void* destination) const {
         }
     });
 
-    for (std::size_t z0 = 0; z0 < dimension_[2]; z0 += tilesize.z) {
-        for (std::size_t y0 = 0; y0 < dimension_[1]; y0 += tilesize.y) {
-            for (std::size_t x0 = 0; x0 < dimension_[0]; x0 += tilesize.x) {
-                const auto tiffreadtile_ret = TIFFReadTile(
-                    tiffimage, tilebuf, static_cast<uint32>(x0), static_cast<uint32>(y0),
-                    static_cast<uint32>(z0), static_cast<uint16>(tilesz));
-                if (0 > tiffreadtile_ret) {
-                    throw DataReaderException(formatErrorMsg("error reading tile"));
-                }
-
-                // pointer & offset calculations
-                const size_t pv_off = z0 * dimension_.y * dimension_.x + y0 * dimension_.x + x0;
-                unsigned char* pv = vol + pv_off * bytespersample;
-
-                unsigned char* pb = tilebuf;
-                unsigned char* pv_slice_ptr = pv;
-
-                std::size_t zmin = std::min(tilesize.z, dimension_.z - z0);
-                std::size_t ymin = std::min(tilesize.y, dimension_.y - y0);
-                std::size_t xmin = std::min(tilesize.x, dimension_.x - x0) * bytespersample;
-
-                std::size_t pv_step = dimension_.x * bytespersample;
-                std::size_t pb_step = tilesize.x * bytespersample;
-
-                std::size_t pv_w_step = dimension_.y * dimension_.x * bytespersample;
-
-                // copy the tile
-                for (std::size_t w = 0; w < zmin; ++w) {
-                    for (std::size_t v = 0; v < ymin; ++v) {
-                        for (std::size_t u = 0; u < xmin; ++u) {
-                            pv[u] = pb[u];
-                        }
-
-                        pv += pv_step;
-                        pb += pb_step;
-                    }
-
-                    pv = pv_slice_ptr;
-                    pv_slice_ptr += pv_w_step;
-                }
-            }
+    for (size_t i = 0; i < numberOfTiles; ++i) {
+        const auto origin = tileOrigin(i);
+        const auto tiffreadtile_ret =
+            TIFFReadTile(tiffimage, tilebuf, static_cast<uint32>(origin.x),
+                         static_cast<uint32>(origin.y), static_cast<uint32>(origin.z), 0);
+        if (0 > tiffreadtile_ret) {
+            throw DataReaderException(formatErrorMsg("error reading tile"));
         }
+        copyTile(tilebuf, origin.x, origin.y, origin.z);
     }
 }
 
@@ -0,0 +1,233 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dicom/io/volumesequencestreamer.h>
+
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+VolumeSequenceStreamer::VolumeSequenceStreamer(const VolumeSequence& phases, size_t memoryBudget,
+                                               size_t prefetch)
+    : phases_{phases}, phaseBytes_{0}, memoryBudget_{memoryBudget}, prefetch_{prefetch} {
+
+    registration_ = MemoryBudget::global().add(
+        "DICOM volume sequence", MemoryBudget::Priority::Normal, [this](size_t bytes) {
+            std::unique_lock lock{mutex_, std::try_to_lock};
+            if (!lock || phaseBytes_ == 0) return;
+            // the current phase is always kept
+            const size_t phases = (bytes + phaseBytes_ - 1) / phaseBytes_;
+            const size_t keep = std::max(decoded_.size() - std::min(decoded_.size(), phases),
+                                         size_t{1});
+            while (decoded_.size() > keep) evict();
+            reportUsage();
+        });
+
+    for (const auto& volume : phases_) {
+        if (!volume->hasRepresentation<VolumeDisk>()) {
+            throw Exception("volume of the sequence has no disk representation to stream from",
+                            IVW_CONTEXT);
+        }
+        // aliasing the volume keeps the disk representation alive
+        disks_.emplace_back(volume, volume->getRepresentation<VolumeDisk>());
+
+        const auto& ref = *disks_.front();
+        const auto& disk = *disks_.back();
+        if (disk.getDimensions() != ref.getDimensions() ||
+            disk.getDataFormat() != ref.getDataFormat()) {
+            throw Exception(
+                fmt::format("phases of the sequence differ, expected {} {} but got {} {}",
+                            toString(ref.getDimensions()), ref.getDataFormat()->getString(),
+                            toString(disk.getDimensions()), disk.getDataFormat()->getString()),
+                IVW_CONTEXT);
+        }
+    }
+    if (!disks_.empty()) {
+        const auto dims = disks_.front()->getDimensions();
+        phaseBytes_ = dims.x * dims.y * dims.z * disks_.front()->getDataFormat()->getSize();
+        worker_ = std::thread([this]() { run(); });
+    }
+}
+
+VolumeSequenceStreamer::~VolumeSequenceStreamer() {
+    // no more eviction requests from here on
+    registration_.reset();
+    {
+        std::scoped_lock lock{mutex_};
+        stop_ = true;
+    }
+    changed_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+std::shared_ptr<const VolumeRAM> VolumeSequenceStreamer::getPhase(size_t phase) {
+    if (phase >= phases_.size()) {
+        throw RangeException(
+            fmt::format("phase {} out of range, the sequence has {} phases", phase, size()),
+            IVW_CONTEXT);
+    }
+
+    std::unique_lock lock{mutex_};
+    if (decoded_.count(phase)) {
+        registration_->hit();
+    } else {
+        registration_->miss();
+    }
+    if (current_ != phase) {
+        current_ = phase;
+        changed_.notify_all();
+    }
+    changed_.wait(lock, [&]() { return decoded_.count(phase) || failed_.count(phase); });
+    if (auto it = failed_.find(phase); it != failed_.end()) {
+        std::rethrow_exception(it->second);
+    }
+    return decoded_[phase];
+}
+
+std::shared_ptr<Volume> VolumeSequenceStreamer::getVolume(size_t phase) {
+    // the volume holds on to the phase, which keeps its allocation from being reused
+    auto ram = std::const_pointer_cast<VolumeRAM>(getPhase(phase));
+    auto volume = std::make_shared<Volume>(std::static_pointer_cast<VolumeRepresentation>(ram));
+
+    const auto& src = *phases_[phase];
+    volume->setModelMatrix(src.getModelMatrix());
+    volume->setWorldMatrix(src.getWorldMatrix());
+    volume->dataMap_ = src.dataMap_;
+    volume->axes = src.axes;
+    volume->copyMetaDataFrom(src);
+    return volume;
+}
+
+bool VolumeSequenceStreamer::isReady(size_t phase) const {
+    std::scoped_lock lock{mutex_};
+    return decoded_.count(phase) != 0;
+}
+
+void VolumeSequenceStreamer::setPrefetch(size_t prefetch) {
+    std::scoped_lock lock{mutex_};
+    prefetch_ = prefetch;
+    changed_.notify_all();
+}
+
+size_t VolumeSequenceStreamer::getPrefetch() const {
+    std::scoped_lock lock{mutex_};
+    return prefetch_;
+}
+
+void VolumeSequenceStreamer::setMemoryBudget(size_t bytes) {
+    std::scoped_lock lock{mutex_};
+    memoryBudget_ = bytes;
+    while (decoded_.size() > capacity()) evict();
+    reportUsage();
+    changed_.notify_all();
+}
+
+size_t VolumeSequenceStreamer::getMemoryBudget() const {
+    std::scoped_lock lock{mutex_};
+    return memoryBudget_;
+}
+
+void VolumeSequenceStreamer::run() {
+    std::unique_lock lock{mutex_};
+    while (true) {
+        changed_.wait(lock, [&]() { return stop_ || nextMissing(); });
+        if (stop_) return;
+
+        const size_t phase = *nextMissing();
+        std::shared_ptr<VolumeRAM> recycled;
+        while (decoded_.size() >= capacity()) recycled = evict();
+        lock.unlock();
+
+        std::shared_ptr<VolumeRAM> ram;
+        std::exception_ptr error;
+        try {
+            if (recycled) {
+                disks_[phase]->updateRepresentation(recycled);
+                ram = std::move(recycled);
+            } else {
+                ram = std::static_pointer_cast<VolumeRAM>(disks_[phase]->createRepresentation());
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if (error) {
+            failed_[phase] = error;
+        } else {
+            decoded_[phase] = std::move(ram);
+        }
+        reportUsage();
+        changed_.notify_all();
+    }
+}
+
+std::optional<size_t> VolumeSequenceStreamer::nextMissing() const {
+    // the current phase is always kept, the prefetched ones have to fit besides it
+    const size_t window = std::min({prefetch_ + 1, capacity(), phases_.size()});
+    for (size_t i = 0; i < window; ++i) {
+        const size_t phase = (current_ + i) % phases_.size();
+        if (!decoded_.count(phase) && !failed_.count(phase)) return phase;
+    }
+    return std::nullopt;
+}
+
+size_t VolumeSequenceStreamer::capacity() const {
+    const size_t budget = std::min(memoryBudget_, registration_->allowance());
+    return std::max(budget / std::max(phaseBytes_, size_t{1}), size_t{1});
+}
+
+size_t VolumeSequenceStreamer::distance(size_t phase) const {
+    return (phase + phases_.size() - current_) % phases_.size();
+}
+
+std::shared_ptr<VolumeRAM> VolumeSequenceStreamer::evict() {
+    auto furthest = decoded_.end();
+    for (auto it = decoded_.begin(); it != decoded_.end(); ++it) {
+        if (furthest == decoded_.end() || distance(it->first) > distance(furthest->first)) {
+            furthest = it;
+        }
+    }
+    if (furthest == decoded_.end()) return nullptr;
+
+    auto ram = std::move(furthest->second);
+    decoded_.erase(furthest);
+    // only reuse allocations no longer referenced by a consumer
+    return ram.use_count() == 1 ? ram : nullptr;
+}
+
+void VolumeSequenceStreamer::reportUsage() {
+    registration_->setUsage(decoded_.size() * phaseBytes_);
+}
+
+}  // namespace inviwo
@@ -119,6 +119,15 @@ dvec2 getDataRange(const gdcm::PixelFormat& pixelformat) {
     return range;
 }
 
+void setDataMapping(DataMapper& dataMap, const gdcm::PixelFormat& pixelformat, double slope,
+                    double intercept, const std::string& modality) {
+    dataMap.dataRange = getDataRange(pixelformat);
+    dataMap.valueRange = dataMap.dataRange * slope + intercept;
+    if (modality == "CT") {
+        dataMap.valueUnit = "HU";  // Hounsfield Unit
+    }
+}
+
 }  // namespace gdcmutil
 
 }  // namespace inviwo
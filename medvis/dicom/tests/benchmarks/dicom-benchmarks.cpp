@@ -0,0 +1,310 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/dicom/dicommodulesharedlibrary.h>
+#include <inviwo/dicom/io/gdcmgpudecoder.h>
+#include <inviwo/dicom/io/gdcmscanindex.h>
+#include <inviwo/dicom/io/gdcmvolumereader.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <MediaStorageAndFileFormat/gdcmImage.h>
+#include <MediaStorageAndFileFormat/gdcmImageChangeTransferSyntax.h>
+#include <MediaStorageAndFileFormat/gdcmImageReader.h>
+#include <MediaStorageAndFileFormat/gdcmImageWriter.h>
+#include <MediaStorageAndFileFormat/gdcmUIDGenerator.h>
+#include <DataStructureAndEncodingDefinition/gdcmMediaStorage.h>
+#include <warn/pop>
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+
+/*
+ * Throughput of the DICOM reading stages: directory scanning, header parsing, slice decoding for
+ * the common transfer syntaxes, and loading a whole series, with the number of threads as
+ * benchmark argument (0 uses all hardware threads).
+ *
+ * The benchmarks run on synthetic CT series of 512x512 slices written to the temp directory. For
+ * the scanning and loading benchmarks a real series can be used instead, by setting the
+ * environment variable IVW_DICOM_BENCHMARK_SERIES to the directory holding it.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+constexpr unsigned int sliceSize = 512;
+constexpr size_t numSlices = 64;
+
+struct Syntax {
+    const char* name;
+    gdcm::TransferSyntax::TSType type;
+};
+const std::vector<Syntax> syntaxes = {
+    {"raw", gdcm::TransferSyntax::ExplicitVRLittleEndian},
+    {"rle", gdcm::TransferSyntax::RLELossless},
+    {"jpeg", gdcm::TransferSyntax::JPEGLosslessProcess14_1},
+    {"jpegls", gdcm::TransferSyntax::JPEGLSLossless},
+    {"jpeg2000", gdcm::TransferSyntax::JPEG2000Lossless},
+};
+constexpr int rawSyntax = 0;
+
+void setString(gdcm::DataSet& dataset, const gdcm::Tag& tag, gdcm::VR vr, std::string value) {
+    // values are padded to even length
+    if (value.size() % 2 != 0) value.push_back(vr == gdcm::VR::UI ? '\0' : ' ');
+    gdcm::DataElement element(tag);
+    element.SetVR(vr);
+    element.SetByteValue(value.data(), static_cast<uint32_t>(value.size()));
+    dataset.Replace(element);
+}
+
+void writeSlice(const std::string& path, const std::string& seriesUID, size_t z,
+                gdcm::TransferSyntax::TSType syntax) {
+    // smooth structures with some noise, such that the compression ratios are not unrealistic
+    std::vector<int16_t> pixels(sliceSize * sliceSize);
+    std::mt19937 rand(static_cast<unsigned int>(z));
+    std::normal_distribution<double> noise(0.0, 10.0);
+    for (unsigned int y = 0; y < sliceSize; ++y) {
+        for (unsigned int x = 0; x < sliceSize; ++x) {
+            const double v = 1000.0 * std::sin(0.02 * x + 0.05 * z) * std::cos(0.03 * y);
+            pixels[y * sliceSize + x] = static_cast<int16_t>(v + noise(rand));
+        }
+    }
+
+    gdcm::SmartPointer<gdcm::Image> image = new gdcm::Image;
+    image->SetNumberOfDimensions(2);
+    image->SetDimension(0, sliceSize);
+    image->SetDimension(1, sliceSize);
+    image->SetPixelFormat(gdcm::PixelFormat(gdcm::PixelFormat::INT16));
+    image->SetPhotometricInterpretation(gdcm::PhotometricInterpretation::MONOCHROME2);
+    image->SetSpacing(0, 0.5);
+    image->SetSpacing(1, 0.5);
+    image->SetOrigin(2, static_cast<double>(z));
+    image->SetIntercept(-1024.0);
+    image->SetSlope(1.0);
+    gdcm::DataElement pixelData(gdcm::Tag(0x7fe0, 0x0010));
+    pixelData.SetByteValue(reinterpret_cast<const char*>(pixels.data()),
+                           static_cast<uint32_t>(pixels.size() * sizeof(int16_t)));
+    image->SetDataElement(pixelData);
+    image->SetTransferSyntax(gdcm::TransferSyntax::ExplicitVRLittleEndian);
+
+    gdcm::ImageChangeTransferSyntax change;
+    change.SetTransferSyntax(syntax);
+    change.SetInput(*image);
+    if (!change.Change()) {
+        throw Exception(fmt::format("could not encode '{}'", path),
+                        IVW_CONTEXT_CUSTOM("writeSlice"));
+    }
+
+    gdcm::ImageWriter writer;
+    writer.SetImage(change.GetOutput());
+    auto& dataset = writer.GetFile().GetDataSet();
+    setString(dataset, gdcm::Tag(0x0008, 0x0016), gdcm::VR::UI,
+              gdcm::MediaStorage::GetMSString(gdcm::MediaStorage::CTImageStorage));
+    setString(dataset, gdcm::Tag(0x0008, 0x0060), gdcm::VR::CS, "CT");
+    setString(dataset, gdcm::Tag(0x0020, 0x000e), gdcm::VR::UI, seriesUID);
+    writer.SetFileName(path.c_str());
+    if (!writer.Write()) {
+        throw Exception(fmt::format("could not write '{}'", path),
+                        IVW_CONTEXT_CUSTOM("writeSlice"));
+    }
+}
+
+// Returns the files of the synthetic series in the given syntax, written on first use
+const std::vector<std::string>& syntheticSeries(int syntax) {
+    static std::map<int, std::vector<std::string>> series;
+    auto& files = series[syntax];
+    if (files.empty()) {
+        const auto dir = std::filesystem::temp_directory_path() /
+                         fmt::format("inviwo-dicom-benchmark-{}", syntaxes[syntax].name);
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        const auto seriesUID = gdcm::UIDGenerator{}.Generate();
+        for (size_t z = 0; z < numSlices; ++z) {
+            files.push_back((dir / fmt::format("slice{:04}.dcm", z)).string());
+            writeSlice(files.back(), seriesUID, z, syntaxes[syntax].type);
+        }
+    }
+    return files;
+}
+
+// Returns the files of the series set by IVW_DICOM_BENCHMARK_SERIES, or the synthetic one
+std::vector<std::string> seriesFiles(int syntax) {
+    if (const char* dir = std::getenv("IVW_DICOM_BENCHMARK_SERIES")) {
+        std::vector<std::string> files;
+        for (const auto& f : filesystem::getDirectoryContents(dir)) {
+            files.push_back(std::string(dir) + '/' + f);
+        }
+        return files;
+    }
+    return syntheticSeries(syntax);
+}
+
+int64_t fileBytes(const std::vector<std::string>& files) {
+    int64_t bytes = 0;
+    for (const auto& f : files) bytes += static_cast<int64_t>(std::filesystem::file_size(f));
+    return bytes;
+}
+
+}  // namespace
+
+// Scanning a directory without a prior index, i.e. parsing all headers
+static void scanDirectory(benchmark::State& state) {
+    const auto files = seriesFiles(rawSyntax);
+    const auto threads = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        GdcmScanIndex index;
+        benchmark::DoNotOptimize(index.scan(files, threads));
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK(scanDirectory)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(0)->Unit(benchmark::kMillisecond);
+
+// Rescanning a directory whose files are all in the index
+static void scanDirectoryCached(benchmark::State& state) {
+    const auto files = seriesFiles(rawSyntax);
+    const auto threads = static_cast<size_t>(state.range(0));
+    GdcmScanIndex index;
+    index.scan(files, threads);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.scan(files, threads));
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK(scanDirectoryCached)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
+
+// Parsing the header of a single file, up to the pixel data
+static void parseHeader(benchmark::State& state) {
+    const auto& file = syntheticSeries(rawSyntax).front();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dicomdir::ImageHeader::read(file));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(parseHeader)->Unit(benchmark::kMicrosecond);
+
+// Decoding a single slice, the argument selects the transfer syntax
+static void decodeSlice(benchmark::State& state) {
+    const auto syntax = static_cast<int>(state.range(0));
+    const auto& file = syntheticSeries(syntax).front();
+    state.SetLabel(syntaxes[syntax].name);
+    std::vector<char> buffer(sliceSize * sliceSize * sizeof(int16_t));
+    for (auto _ : state) {
+        gdcm::ImageReader reader;
+        reader.SetFileName(file.c_str());
+        if (!reader.Read() || !reader.GetImage().GetBuffer(buffer.data())) {
+            state.SkipWithError("could not decode slice");
+            break;
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(decodeSlice)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
+
+// Reading and decoding a whole series, the arguments are the transfer syntax and the threads
+static void loadSeries(benchmark::State& state) {
+    const auto syntax = static_cast<int>(state.range(0));
+    const auto files = seriesFiles(syntax);
+    state.SetLabel(std::getenv("IVW_DICOM_BENCHMARK_SERIES") ? "series" : syntaxes[syntax].name);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        GdcmVolumeReader reader;
+        GdcmDecodingOptions options;
+        options.threads = static_cast<size_t>(state.range(1));
+        reader.setDecodingOptions(options);
+        const auto volumes = reader.readData(files.front());
+        for (const auto& volume : *volumes) {
+            const auto ram = volume->getRepresentation<VolumeRAM>();
+            bytes += static_cast<int64_t>(ram->getNumberOfBytes());
+        }
+    }
+    state.SetBytesProcessed(bytes);
+    state.counters["file MB"] = static_cast<double>(fileBytes(files)) / (1 << 20);
+}
+BENCHMARK(loadSeries)
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Same as loadSeries with GPU decoding enabled, the argument is the transfer syntax
+static void loadSeriesGpu(benchmark::State& state) {
+    if (!GdcmGpuDecoder::isAvailable()) {
+        state.SkipWithError("GPU decoding is not available");
+        return;
+    }
+    const auto syntax = static_cast<int>(state.range(0));
+    const auto files = seriesFiles(syntax);
+    state.SetLabel(std::getenv("IVW_DICOM_BENCHMARK_SERIES") ? "series" : syntaxes[syntax].name);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        GdcmVolumeReader reader;
+        GdcmDecodingOptions options;
+        options.gpuDecoding = true;
+        reader.setDecodingOptions(options);
+        const auto volumes = reader.readData(files.front());
+        for (const auto& volume : *volumes) {
+            const auto ram = volume->getRepresentation<VolumeRAM>();
+            bytes += static_cast<int64_t>(ram->getNumberOfBytes());
+        }
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(loadSeriesGpu)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    inviwo::LogCentral::init();
+
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-DICOM");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        modules.emplace_back(createDICOMModule());
+        app.registerModules(std::move(modules));
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -34,6 +34,7 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/transferfunctionproperty.h>
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <modules/opengl/shader/shader.h>
@@ -56,6 +57,7 @@ namespace inviwo {
  *   * __Rotations__ How many rotations the spiral will have.
  *   * __Height__ Hight difference between start and end point of the spiral.
  *   * __Color Mapping__ Used to colorize the spiral.
+ *   * __GPU Timing__ GPU time of the compute shader dispatch, see GpuTimerProperty.
  *
  */
 
@@ -71,6 +73,7 @@ public:
 
 private:
     MeshOutport mesh_;
+    std::shared_ptr<Mesh> meshData_;
 
     Shader shader_;
 
@@ -80,6 +83,7 @@ private:
     FloatProperty height_;
 
     TransferFunctionProperty tf_;
+    GpuTimerProperty timing_;
 };
 
 }  // namespace inviwo
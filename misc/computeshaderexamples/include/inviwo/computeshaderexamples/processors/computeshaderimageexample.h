@@ -34,6 +34,7 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/transferfunctionproperty.h>
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
 #include <inviwo/core/ports/imageport.h>
 
 #include <modules/opengl/shader/shader.h>
@@ -53,6 +54,7 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Roll__ Used as offset in to the sin function in the shader to create an rolling effect.
+ *   * __GPU Timing__ GPU time of the compute shader dispatch, see GpuTimerProperty.
  *
  */
 
@@ -71,6 +73,7 @@ private:
     Shader shader_;
 
     FloatProperty roll_;
+    GpuTimerProperty timing_;
 };
 
 }  // namespace inviwo
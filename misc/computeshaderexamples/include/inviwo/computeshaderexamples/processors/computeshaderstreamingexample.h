@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/transferfunctionproperty.h>
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
+#include <inviwo/computeshaderexamples/util/persistentringbuffer.h>
+#include <inviwo/core/ports/meshport.h>
+#include <modules/opengl/shader/shader.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ComputeShaderStreamingExample, Compute Shader Streaming Example}
+ * ![](org.inviwo.ComputeShaderStreamingExample.png?classIdentifier=org.inviwo.ComputeShaderStreamingExample)
+ *
+ * A processor to show how per-frame data computed on the CPU can be streamed to a compute shader
+ * without allocations or implicit synchronization. Each frame, a trail along a Lissajous curve is
+ * written into a persistently mapped PersistentRingBuffer, which shader stream.comp reads to fill
+ * the vertex buffers of the output mesh. The output mesh is reused as long as no one else holds
+ * on to it.
+ *
+ *
+ * ### Outports
+ *   * __mesh__ Mesh containing the created vertex buffers.
+ *
+ * ### Properties
+ *   * __Number of points__ Number of points in the trail.
+ *   * __Time__ Curve parameter at the head of the trail, animate to stream new data each frame.
+ *   * __Trail length__ Curve parameter range covered by the trail.
+ *   * __Frequencies__ Frequencies of the Lissajous curve along x, y, and z.
+ *   * __Color Mapping__ Used to colorize the trail by age, the head of the trail maps to 0.
+ *   * __GPU Timing__ GPU time of the compute shader dispatch, see GpuTimerProperty.
+ *   * __Stalls__ Number of times the CPU had to wait for the GPU to release a buffer segment.
+ *
+ */
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API ComputeShaderStreamingExample : public Processor {
+public:
+    ComputeShaderStreamingExample();
+    virtual ~ComputeShaderStreamingExample() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    MeshOutport mesh_;
+    std::shared_ptr<Mesh> meshData_;
+
+    Shader shader_;
+    PersistentRingBuffer points_;
+
+    IntProperty numPoints_;
+    FloatProperty time_;
+    FloatProperty trailLength_;
+    FloatVec3Property frequencies_;
+
+    TransferFunctionProperty tf_;
+    GpuTimerProperty timing_;
+    IntSizeTProperty stalls_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,74 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/computeshaderexamples/processors/computevolumeprocessor.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ComputeShaderVolumeExample, Compute Shader Volume Example}
+ * ![](org.inviwo.ComputeShaderVolumeExample.png?classIdentifier=org.inviwo.ComputeShaderVolumeExample)
+ *
+ * An processor to show how a ComputeVolumeProcessor can be used for volume-to-volume compute
+ * kernels. Uses shader volumesmooth.comp to repeatedly apply a 3x3x3 box filter to the first
+ * channel of the input, one pass per iteration.
+ *
+ * ### Inports
+ *   * __inport__ Volume to smooth.
+ *
+ * ### Outports
+ *   * __outport__ Smoothed volume with normalized values in a single float channel.
+ *
+ * ### Properties
+ *   * __Iterations__ Number of times the filter is applied.
+ *   * __GPU Timing__ GPU time of all passes, see GpuTimerProperty.
+ *
+ */
+
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API ComputeShaderVolumeExample
+    : public ComputeVolumeProcessor {
+public:
+    ComputeShaderVolumeExample();
+    virtual ~ComputeShaderVolumeExample() = default;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+protected:
+    virtual size_t getPasses() const override;
+
+private:
+    IntSizeTProperty iterations_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,134 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <memory>
+#include <string_view>
+
+namespace inviwo {
+
+class DataFormatBase;
+
+/**
+ * \brief Base class for processors computing a volume from a volume with a compute shader
+ * Takes care of the boilerplate of volume-to-volume compute kernels:
+ *   * The work group size is chosen from the limits of the GPU and passed to the shader as the
+ *     defines LOCAL_SIZE_X, LOCAL_SIZE_Y, and LOCAL_SIZE_Z. Enough groups are dispatched to cover
+ *     the output volume, invocations outside of it have to return early.
+ *   * The input is bound as `uniform sampler3D volume` with `uniform VolumeParameters
+ *     volumeParameters`, the output as `writeonly uniform image3D dest`, and its size is set as
+ *     `uniform ivec3 dimensions`.
+ *   * With several passes, two output volumes are used in turn, each pass reads the result of
+ *     the previous one through `volume` and the index of the pass is set as `uniform int pass`.
+ *     Output volumes are reused for the next evaluation unless they are still referenced
+ *     elsewhere.
+ *   * A fence is inserted after the last pass, see isComplete() and waitForCompletion(). The
+ *     output is handed on right away since OpenGL orders the commands of consumers after the
+ *     dispatch.
+ *   * The GPU time of all passes is shown in a GpuTimerProperty.
+ *
+ * A minimal shader:
+ * \code{.glsl}
+ * #include "utils/structs.glsl"
+ * #include "utils/sampler3d.glsl"
+ *
+ * layout(local_size_x = LOCAL_SIZE_X, local_size_y = LOCAL_SIZE_Y, local_size_z = LOCAL_SIZE_Z) in;
+ *
+ * uniform VolumeParameters volumeParameters;
+ * uniform sampler3D volume;
+ * uniform ivec3 dimensions;
+ * writeonly uniform image3D dest;
+ *
+ * void main() {
+ *     ivec3 voxel = ivec3(gl_GlobalInvocationID);
+ *     if (any(greaterThanEqual(voxel, dimensions))) return;
+ *     vec3 pos = (vec3(voxel) + 0.5) / vec3(dimensions);
+ *     imageStore(dest, voxel, getNormalizedVoxel(volume, volumeParameters, pos));
+ * }
+ * \endcode
+ */
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API ComputeVolumeProcessor : public Processor {
+public:
+    /**
+     * @param computeShader  file name of the compute shader
+     * @param outputFormat   format of the output volume, it has to be supported by image load
+     *                       store, i.e. have one, two, or four channels
+     */
+    ComputeVolumeProcessor(std::string_view computeShader, const DataFormatBase* outputFormat);
+    virtual ~ComputeVolumeProcessor();
+
+    virtual void initializeResources() override;
+    virtual void process() override;
+
+protected:
+    /// @return number of passes, one by default
+    virtual size_t getPasses() const { return 1; }
+    /**
+     * Sets additional uniforms, called before each pass with the shader active
+     */
+    virtual void setUniforms(Shader& shader, size_t pass);
+    /**
+     * Sets the transformation and data mapping of \p output. By default the output has the same
+     * transformation as \p input, holds normalized values, i.e. a data range of [0, 1], and has
+     * the value range of the input.
+     */
+    virtual void configureOutput(Volume& output, const Volume& input) const;
+
+    /// @return true if the GPU has finished the last dispatch, does not block
+    bool isComplete() const;
+    /// Blocks until the GPU has finished the last dispatch
+    void waitForCompletion() const;
+
+    const size3_t& getWorkGroupSize() const { return workGroupSize_; }
+
+    VolumeInport inport_;
+    VolumeOutport outport_;
+    Shader shader_;
+    GpuTimerProperty timing_;
+
+private:
+    std::shared_ptr<Volume> acquireOutput(size_t index, const Volume& input);
+
+    const DataFormatBase* outputFormat_;
+    size3_t workGroupSize_{8};
+    std::array<std::shared_ptr<Volume>, 2> outputs_;
+    GLsync fence_ = nullptr;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/computeshaderexamples/util/gputimer.h>
+
+namespace inviwo {
+
+/**
+ * \ingroup properties
+ * A property owning a GpuTimer and showing its statistics, i.e. the GPU time of the last, the
+ * fastest, and the slowest measurement as well as the mean, in read-only properties. The shown
+ * values are refreshed whenever a new measurement starts or update() is called, results arrive
+ * with a latency of at least one frame.
+ *
+ * \code{.cpp}
+ * void MyProcessor::process() {
+ *     auto scope = timing_.measure();
+ *     glDispatchCompute(x, y, z);
+ * }
+ * \endcode
+ *
+ * @see GpuTimer
+ */
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API GpuTimerProperty : public CompositeProperty {
+public:
+    virtual std::string getClassIdentifier() const override;
+    static const std::string classIdentifier;
+
+    GpuTimerProperty(std::string identifier, std::string displayName);
+
+    /// Copies the settings, the copy starts with a new timer
+    GpuTimerProperty(const GpuTimerProperty& rhs);
+    virtual GpuTimerProperty* clone() const override;
+    virtual ~GpuTimerProperty() = default;
+
+    /**
+     * Collects finished measurements and starts a new one
+     * @see GpuTimer::measure
+     */
+    [[nodiscard]] GpuTimer::Scope measure();
+    /// Collects finished measurements and refreshes the shown statistics
+    void update();
+
+    GpuTimer& getTimer() { return timer_; }
+
+    DoubleProperty last_;
+    DoubleProperty mean_;
+    DoubleProperty min_;
+    DoubleProperty max_;
+    IntSizeTProperty count_;
+    ButtonProperty reset_;
+
+private:
+    void init();
+    void refresh();
+    auto props() { return std::tie(last_, mean_, min_, max_, count_); }
+
+    GpuTimer timer_;
+};
+
+}  // namespace inviwo
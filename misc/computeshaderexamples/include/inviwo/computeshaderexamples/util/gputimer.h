@@ -0,0 +1,131 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/opengl/inviwoopengl.h>
+
+#include <limits>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Measures the GPU time of OpenGL commands without stalling the pipeline
+ * Each measurement brackets the commands with two GL_TIMESTAMP queries. The results are only
+ * read once the GPU reports them as available, typically during a later frame, and a query is
+ * reused only after its result has been read. Hence no call blocks, at the cost of the results
+ * arriving with a latency of at least one frame. Timestamps, unlike GL_TIME_ELAPSED queries, can
+ * be nested and may overlap with other timers.
+ *
+ * \code{.cpp}
+ * {
+ *     auto scope = timer.measure();
+ *     glDispatchCompute(x, y, z);
+ * }
+ * timer.collect();
+ * LogInfo(timer.getStatistics().last << " ms");
+ * \endcode
+ *
+ * All functions have to be called with an active OpenGL context.
+ */
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API GpuTimer {
+public:
+    /**
+     * Statistics of all collected measurements in milliseconds
+     */
+    struct Statistics {
+        size_t count = 0;
+        double last = 0.0;
+        double min = std::numeric_limits<double>::infinity();
+        double max = 0.0;
+        double total = 0.0;
+
+        double mean() const { return count > 0 ? total / count : 0.0; }
+    };
+
+    /**
+     * Measures the commands issued during its lifetime
+     */
+    class IVW_MODULE_COMPUTESHADEREXAMPLES_API Scope {
+    public:
+        explicit Scope(GpuTimer& timer);
+        Scope(const Scope&) = delete;
+        Scope(Scope&& rhs) noexcept;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+        ~Scope();
+
+    private:
+        GpuTimer* timer_;
+    };
+
+    GpuTimer() = default;
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    ~GpuTimer();
+
+    [[nodiscard]] Scope measure();
+    /**
+     * Starts a measurement
+     * @throw Exception if a measurement is already running
+     */
+    void begin();
+    void end();
+
+    /**
+     * Reads the results of all finished measurements, non-blocking
+     * @return true if any new result was read
+     */
+    bool collect();
+
+    const Statistics& getStatistics() const { return statistics_; }
+    /// @return number of measurements whose result is not yet available
+    size_t getPending() const { return pending_.size(); }
+    /// Clears the statistics, pending measurements are still collected
+    void reset();
+
+private:
+    struct Queries {
+        GLuint begin = 0;
+        GLuint end = 0;
+    };
+
+    Queries acquire();
+
+    std::vector<Queries> free_;
+    std::vector<Queries> pending_;
+    Queries active_;
+    bool running_ = false;
+    Statistics statistics_;
+};
+
+}  // namespace inviwo
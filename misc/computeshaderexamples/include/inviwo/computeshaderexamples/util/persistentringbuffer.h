@@ -0,0 +1,113 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/computeshaderexamples/computeshaderexamplesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/opengl/inviwoopengl.h>
+
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief A persistently mapped buffer for streaming data to the GPU every frame
+ * The buffer is split into a number of segments, three by default, which are written in turn.
+ * It is allocated once with immutable storage and mapped persistently and coherently, so writing
+ * a frame's data is a plain memory write without any allocation, mapping, or implicit
+ * synchronization. A fence is inserted after the commands reading a segment have been issued,
+ * and a segment is only handed out again once the GPU has passed its fence. With three
+ * segments, the CPU can thus write one frame while the GPU still reads the two previous ones.
+ * If a larger segment is requested, the buffer is reallocated.
+ *
+ * \code{.cpp}
+ * auto data = ring.acquire<vec4>(count);
+ * std::copy(points.begin(), points.end(), data);
+ * ring.bind(0);  // binding point 0 of the target, e.g. a shader storage block
+ * glDispatchCompute(groups, 1, 1);
+ * ring.release();
+ * \endcode
+ *
+ * Requires OpenGL 4.4 or ARB_buffer_storage. All functions have to be called with an active
+ * OpenGL context.
+ */
+class IVW_MODULE_COMPUTESHADEREXAMPLES_API PersistentRingBuffer {
+public:
+    /**
+     * @param target    buffer target the segments are bound to, GL_SHADER_STORAGE_BUFFER or
+     *                  GL_UNIFORM_BUFFER
+     * @param segments  number of segments, i.e. frames in flight
+     */
+    explicit PersistentRingBuffer(GLenum target = GL_SHADER_STORAGE_BUFFER, size_t segments = 3);
+    PersistentRingBuffer(const PersistentRingBuffer&) = delete;
+    PersistentRingBuffer& operator=(const PersistentRingBuffer&) = delete;
+    ~PersistentRingBuffer();
+
+    /**
+     * Moves on to the next segment, waiting for the GPU to finish reading it if necessary.
+     * @return pointer to at least \p bytes writable bytes of the segment
+     */
+    void* acquire(size_t bytes);
+    template <typename T>
+    T* acquire(size_t count) {
+        return static_cast<T*>(acquire(count * sizeof(T)));
+    }
+
+    /**
+     * Binds the range of the current segment to binding point \p index of the target
+     */
+    void bind(GLuint index) const;
+    /**
+     * Inserts a fence for the current segment, call after all commands reading it were issued
+     */
+    void release();
+
+    GLuint getId() const { return id_; }
+    size_t getSegmentSize() const { return segmentSize_; }
+    /// @return byte offset of the current segment within the buffer
+    size_t getOffset() const { return current_ * segmentSize_; }
+    /// @return number of times acquire() had to wait for the GPU
+    size_t getStalls() const { return stalls_; }
+
+private:
+    void allocate(size_t segmentSize);
+    void free();
+
+    const GLenum target_;
+    std::vector<GLsync> fences_;
+    size_t current_;
+    GLuint id_ = 0;
+    size_t segmentSize_ = 0;
+    size_t acquired_ = 0;
+    char* data_ = nullptr;
+    size_t stalls_ = 0;
+};
+
+}  // namespace inviwo
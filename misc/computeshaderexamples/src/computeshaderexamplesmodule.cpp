@@ -30,6 +30,9 @@
 #include <inviwo/computeshaderexamples/computeshaderexamplesmodule.h>
 #include <inviwo/computeshaderexamples/processors/computeshaderbufferexample.h>
 #include <inviwo/computeshaderexamples/processors/computeshaderimageexample.h>
+#include <inviwo/computeshaderexamples/processors/computeshaderstreamingexample.h>
+#include <inviwo/computeshaderexamples/processors/computeshadervolumeexample.h>
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
 
 #include <modules/opengl/shader/shadermanager.h>
 
@@ -45,6 +48,11 @@ ComputeShaderExamplesModule::ComputeShaderExamplesModule(InviwoApplication* app)
     // Processors
     registerProcessor<ComputeShaderBufferExample>();
     registerProcessor<ComputeShaderImageExample>();
+    registerProcessor<ComputeShaderStreamingExample>();
+    registerProcessor<ComputeShaderVolumeExample>();
+
+    // Properties
+    registerProperty<GpuTimerProperty>();
 }
 
 }  // namespace inviwo
@@ -57,10 +57,11 @@ ComputeShaderBufferExample::ComputeShaderBufferExample()
     , radius_("radius", "Radius", 1, 0, 10)
     , rotations_("rotations", "Rotations", 1, 0, 10)
     , height_("height", "Height", 1, 0, 10)
-    , tf_("tf", "Color Mapping") {
+    , tf_("tf", "Color Mapping")
+    , timing_("timing", "GPU Timing") {
     addPort(mesh_);
 
-    addProperties(numPoints_, radius_, rotations_, height_, tf_);
+    addProperties(numPoints_, radius_, rotations_, height_, tf_, timing_);
 
     shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
 }
@@ -73,10 +74,24 @@ void ComputeShaderBufferExample::process() {
     TextureUnitContainer cont;
     utilgl::bindAndSetUniforms(shader_, cont, tf_);
 
-    auto bufPos = std::make_shared<Buffer<vec4>>(numPoints_.get(), BufferUsage::Dynamic);
-    auto bufCol = std::make_shared<Buffer<vec4>>(numPoints_.get(), BufferUsage::Dynamic);
-    auto bugPosGL = bufPos->getEditableRepresentation<BufferGL>();
-    auto bugColGL = bufCol->getEditableRepresentation<BufferGL>();
+    // Release our reference in the outport, the mesh can be reused if no one else holds on to it
+    mesh_.clear();
+    const auto numPoints = static_cast<size_t>(numPoints_.get());
+    if (!meshData_ || meshData_.use_count() > 1 ||
+        meshData_->getBuffer(0)->getSize() != numPoints) {
+        meshData_ = std::make_shared<Mesh>();
+        meshData_->addBuffer(BufferType::PositionAttrib,
+                             std::make_shared<Buffer<vec4>>(numPoints, BufferUsage::Dynamic));
+        meshData_->addBuffer(BufferType::ColorAttrib,
+                             std::make_shared<Buffer<vec4>>(numPoints, BufferUsage::Dynamic));
+
+        auto ib = meshData_->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
+        auto& vec = ib->getDataContainer();
+        vec.resize(numPoints);
+        std::iota(vec.begin(), vec.end(), 0);
+    }
+    auto bugPosGL = meshData_->getBuffer(0)->getEditableRepresentation<BufferGL>();
+    auto bugColGL = meshData_->getBuffer(1)->getEditableRepresentation<BufferGL>();
 
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bugPosGL->getId());
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, bugColGL->getId());
@@ -84,22 +99,16 @@ void ComputeShaderBufferExample::process() {
     GLuint numWorkGroupsX = numPoints_.get();
     GLuint numWorkGroupsY = 1;
     GLuint numWorkGroupsZ = 1;
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    {
+        auto scope = timing_.measure();
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
 
     shader_.deactivate();
 
-    auto mesh = std::make_shared<Mesh>();
-    mesh->addBuffer(BufferType::PositionAttrib, bufPos);
-    mesh->addBuffer(BufferType::ColorAttrib, bufCol);
-
-    auto ib = mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
-    auto& vec = ib->getDataContainer();
-    vec.resize(numPoints_.get());
-    std::iota(vec.begin(), vec.end(), 0);
-
-    mesh_.setData(mesh);
+    mesh_.setData(meshData_);
 }
 
 }  // namespace inviwo
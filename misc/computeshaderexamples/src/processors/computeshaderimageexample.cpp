@@ -55,11 +55,12 @@ ComputeShaderImageExample::ComputeShaderImageExample()
     : Processor()
     , outport_("outport")
     , shader_({{ShaderType::Compute, "roll.comp"}})
-    , roll_{"roll", "Roll", 0, 0, 10} {
+    , roll_{"roll", "Roll", 0, 0, 10}
+    , timing_("timing", "GPU Timing") {
 
     addPort(outport_);
 
-    addProperty(roll_);
+    addProperties(roll_, timing_);
 
     shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
 }
@@ -84,7 +85,10 @@ void ComputeShaderImageExample::process() {
 
     shader_.setUniform("dest", 0);
 
-    glDispatchCompute(512 / 16, 512 / 16, 1);  // 512^2 threads in blocks of 16^2
+    {
+        auto scope = timing_.measure();
+        glDispatchCompute(512 / 16, 512 / 16, 1);  // 512^2 threads in blocks of 16^2
+    }
 
     shader_.deactivate();
 
@@ -0,0 +1,133 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/computeshaderexamples/processors/computeshaderstreamingexample.h>
+
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <modules/opengl/buffer/buffergl.h>
+
+#include <modules/opengl/texture/textureutils.h>
+#include <modules/opengl/shader/shaderutils.h>
+
+#include <limits>
+#include <numeric>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo ComputeShaderStreamingExample::processorInfo_{
+    "org.inviwo.ComputeShaderStreamingExample",  // Class identifier
+    "Compute Shader Streaming Example",          // Display name
+    "Example",                                   // Category
+    CodeState::Experimental,                     // Code state
+    Tags::GL,                                    // Tags
+};
+const ProcessorInfo ComputeShaderStreamingExample::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+ComputeShaderStreamingExample::ComputeShaderStreamingExample()
+    : Processor()
+    , mesh_("mesh")
+    , shader_({{ShaderType::Compute, "stream.comp"}})
+    , points_(GL_SHADER_STORAGE_BUFFER, 3)
+    , numPoints_("numPoints", "Number of points", 1024, 2, 100000)
+    , time_("time", "Time", 0.0f, 0.0f, 100.0f, 0.01f)
+    , trailLength_("trailLength", "Trail length", 2.0f, 0.01f, 10.0f)
+    , frequencies_("frequencies", "Frequencies", vec3(3.0f, 2.0f, 1.0f), vec3(0.0f), vec3(10.0f))
+    , tf_("tf", "Color Mapping")
+    , timing_("timing", "GPU Timing")
+    , stalls_("stalls", "Stalls", 0, 0, std::numeric_limits<size_t>::max()) {
+    addPort(mesh_);
+
+    stalls_.setReadOnly(true);
+    stalls_.setSerializationMode(PropertySerializationMode::None);
+    addProperties(numPoints_, time_, trailLength_, frequencies_, tf_, timing_, stalls_);
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+}
+
+void ComputeShaderStreamingExample::process() {
+    const auto numPoints = static_cast<size_t>(numPoints_.get());
+
+    // Write this frame's points straight into the mapped segment, no copies or allocations
+    auto points = points_.acquire<vec4>(numPoints);
+    const float head = time_.get();
+    const vec3 freq = frequencies_.get();
+    for (size_t i = 0; i < numPoints; ++i) {
+        const float age = static_cast<float>(i) / static_cast<float>(numPoints - 1);
+        const float t = head - age * trailLength_.get();
+        points[i] = vec4(glm::sin(freq * t + vec3(0.0f, 0.5f, 0.25f) * glm::pi<float>()), age);
+    }
+
+    // Release our reference in the outport, the mesh can be reused if no one else holds on to it
+    mesh_.clear();
+    if (!meshData_ || meshData_.use_count() > 1 ||
+        meshData_->getBuffer(0)->getSize() != numPoints) {
+        meshData_ = std::make_shared<Mesh>();
+        meshData_->addBuffer(BufferType::PositionAttrib,
+                             std::make_shared<Buffer<vec4>>(numPoints, BufferUsage::Dynamic));
+        meshData_->addBuffer(BufferType::ColorAttrib,
+                             std::make_shared<Buffer<vec4>>(numPoints, BufferUsage::Dynamic));
+
+        auto ib = meshData_->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
+        auto& vec = ib->getDataContainer();
+        vec.resize(numPoints);
+        std::iota(vec.begin(), vec.end(), 0);
+    }
+    auto posGL = meshData_->getBuffer(0)->getEditableRepresentation<BufferGL>();
+    auto colGL = meshData_->getBuffer(1)->getEditableRepresentation<BufferGL>();
+
+    shader_.activate();
+    shader_.setUniform("numPoints", numPoints_.get());
+
+    TextureUnitContainer cont;
+    utilgl::bindAndSetUniforms(shader_, cont, tf_);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, posGL->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, colGL->getId());
+    points_.bind(2);
+
+    const auto numWorkGroups = static_cast<GLuint>((numPoints + 63) / 64);
+    {
+        auto scope = timing_.measure();
+        glDispatchCompute(numWorkGroups, 1, 1);
+    }
+    // The segment can be handed out again once the dispatch has finished reading it
+    points_.release();
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    shader_.deactivate();
+
+    stalls_.set(points_.getStalls());
+    mesh_.setData(meshData_);
+}
+
+}  // namespace inviwo
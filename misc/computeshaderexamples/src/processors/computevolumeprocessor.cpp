@@ -0,0 +1,169 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/computeshaderexamples/processors/computevolumeprocessor.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/util/rendercontext.h>
+#include <modules/opengl/shader/shaderutils.h>
+#include <modules/opengl/texture/texture3d.h>
+#include <modules/opengl/texture/textureunit.h>
+#include <modules/opengl/texture/textureutils.h>
+#include <modules/opengl/volume/volumegl.h>
+#include <modules/opengl/volume/volumeutils.h>
+
+namespace inviwo {
+
+ComputeVolumeProcessor::ComputeVolumeProcessor(std::string_view computeShader,
+                                               const DataFormatBase* outputFormat)
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , shader_({{ShaderType::Compute, std::string{computeShader}}}, Shader::Build::No)
+    , timing_("timing", "GPU Timing")
+    , outputFormat_{outputFormat} {
+
+    addPort(inport_);
+    addPort(outport_);
+    addProperty(timing_);
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+}
+
+ComputeVolumeProcessor::~ComputeVolumeProcessor() {
+    if (fence_) {
+        RenderContext::getPtr()->activateDefaultRenderContext();
+        glDeleteSync(fence_);
+    }
+}
+
+void ComputeVolumeProcessor::initializeResources() {
+    // Largest power of two cube within the limits, halving the longest side as needed
+    GLint maxInvocations = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &maxInvocations);
+    std::array<GLint, 3> maxSize{};
+    for (GLuint i = 0; i < 3; ++i) {
+        glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i, &maxSize[i]);
+    }
+    workGroupSize_ = size3_t{8};
+    for (int i = 0; i < 3; ++i) {
+        workGroupSize_[i] = std::min(workGroupSize_[i], static_cast<size_t>(maxSize[i]));
+    }
+    while (glm::compMul(workGroupSize_) > static_cast<size_t>(maxInvocations)) {
+        auto& longest = workGroupSize_[workGroupSize_.x >= workGroupSize_.y
+                                           ? (workGroupSize_.x >= workGroupSize_.z ? 0 : 2)
+                                           : (workGroupSize_.y >= workGroupSize_.z ? 1 : 2)];
+        longest = std::max(size_t{1}, longest / 2);
+    }
+
+    auto compute = shader_.getShaderObject(ShaderType::Compute);
+    compute->addShaderDefine("LOCAL_SIZE_X", std::to_string(workGroupSize_.x));
+    compute->addShaderDefine("LOCAL_SIZE_Y", std::to_string(workGroupSize_.y));
+    compute->addShaderDefine("LOCAL_SIZE_Z", std::to_string(workGroupSize_.z));
+    shader_.build();
+}
+
+void ComputeVolumeProcessor::process() {
+    const auto input = inport_.getData();
+    const size_t passes = std::max(getPasses(), size_t{1});
+    const size3_t dims = input->getDimensions();
+    const auto groups = (dims + workGroupSize_ - size3_t{1}) / workGroupSize_;
+
+    // Release our reference to the previous result so it can be reused if no one else holds it
+    outport_.clear();
+
+    std::shared_ptr<Volume> result;
+    {
+        auto scope = timing_.measure();
+        shader_.activate();
+        shader_.setUniform("dimensions", ivec3{dims});
+        for (size_t pass = 0; pass < passes; ++pass) {
+            auto output = acquireOutput(pass % 2, *input);
+            const Volume& source = pass == 0 ? *input : *outputs_[(pass + 1) % 2];
+
+            TextureUnitContainer units;
+            utilgl::bindAndSetUniforms(shader_, units, source, "volume");
+            auto texture = output->getEditableRepresentation<VolumeGL>()->getTexture();
+            glBindImageTexture(0, texture->getID(), 0, GL_TRUE, 0, GL_WRITE_ONLY,
+                               texture->getInternalFormat());
+            shader_.setUniform("dest", 0);
+            shader_.setUniform("pass", static_cast<int>(pass));
+            setUniforms(shader_, pass);
+
+            glDispatchCompute(static_cast<GLuint>(groups.x), static_cast<GLuint>(groups.y),
+                              static_cast<GLuint>(groups.z));
+            // The next pass or consumer samples the result
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            result = output;
+        }
+        shader_.deactivate();
+    }
+
+    if (fence_) glDeleteSync(fence_);
+    fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    LGL_ERROR;
+
+    outport_.setData(result);
+}
+
+void ComputeVolumeProcessor::setUniforms(Shader&, size_t) {}
+
+void ComputeVolumeProcessor::configureOutput(Volume& output, const Volume& input) const {
+    output.setModelMatrix(input.getModelMatrix());
+    output.setWorldMatrix(input.getWorldMatrix());
+    output.dataMap_.dataRange = dvec2{0.0, 1.0};
+    output.dataMap_.valueRange = input.dataMap_.valueRange;
+    output.dataMap_.valueUnit = input.dataMap_.valueUnit;
+}
+
+bool ComputeVolumeProcessor::isComplete() const {
+    if (!fence_) return true;
+    return glClientWaitSync(fence_, 0, 0) != GL_TIMEOUT_EXPIRED;
+}
+
+void ComputeVolumeProcessor::waitForCompletion() const {
+    if (!fence_) return;
+    while (glClientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, 100'000'000) ==
+           GL_TIMEOUT_EXPIRED) {
+    }
+}
+
+std::shared_ptr<Volume> ComputeVolumeProcessor::acquireOutput(size_t index,
+                                                              const Volume& input) {
+    auto& output = outputs_[index];
+    if (!output || output.use_count() > 1 || output->getDimensions() != input.getDimensions() ||
+        output->getDataFormat() != outputFormat_) {
+        output = std::make_shared<Volume>(
+            std::make_shared<VolumeGL>(input.getDimensions(), outputFormat_));
+    }
+    configureOutput(*output, input);
+    return output;
+}
+
+}  // namespace inviwo
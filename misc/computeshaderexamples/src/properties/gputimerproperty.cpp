@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/computeshaderexamples/properties/gputimerproperty.h>
+#include <inviwo/core/util/foreacharg.h>
+
+#include <limits>
+
+namespace inviwo {
+
+const std::string GpuTimerProperty::classIdentifier = "org.inviwo.GpuTimerProperty";
+std::string GpuTimerProperty::getClassIdentifier() const { return classIdentifier; }
+
+namespace {
+
+DoubleProperty timeProperty(std::string identifier, std::string displayName) {
+    return DoubleProperty(std::move(identifier), std::move(displayName), 0.0, 0.0,
+                          std::numeric_limits<double>::max(), 0.001, InvalidationLevel::Valid,
+                          PropertySemantics::Text);
+}
+
+}  // namespace
+
+GpuTimerProperty::GpuTimerProperty(std::string identifier, std::string displayName)
+    : CompositeProperty(identifier, displayName)
+    , last_(timeProperty("last", "Last (ms)"))
+    , mean_(timeProperty("mean", "Mean (ms)"))
+    , min_(timeProperty("min", "Min (ms)"))
+    , max_(timeProperty("max", "Max (ms)"))
+    , count_("count", "Measurements", 0, 0, std::numeric_limits<size_t>::max(), 1,
+             InvalidationLevel::Valid, PropertySemantics::Text)
+    , reset_("reset", "Reset", InvalidationLevel::Valid) {
+    init();
+}
+
+GpuTimerProperty::GpuTimerProperty(const GpuTimerProperty& rhs)
+    : CompositeProperty(rhs)
+    , last_(rhs.last_)
+    , mean_(rhs.mean_)
+    , min_(rhs.min_)
+    , max_(rhs.max_)
+    , count_(rhs.count_)
+    , reset_(rhs.reset_) {
+    init();
+}
+
+GpuTimerProperty* GpuTimerProperty::clone() const { return new GpuTimerProperty(*this); }
+
+GpuTimer::Scope GpuTimerProperty::measure() {
+    update();
+    return timer_.measure();
+}
+
+void GpuTimerProperty::update() {
+    timer_.collect();
+    refresh();
+}
+
+void GpuTimerProperty::refresh() {
+    const auto& stats = timer_.getStatistics();
+    last_.set(stats.last);
+    mean_.set(stats.mean());
+    min_.set(stats.count > 0 ? stats.min : 0.0);
+    max_.set(stats.max);
+    count_.set(stats.count);
+}
+
+void GpuTimerProperty::init() {
+    util::for_each_in_tuple(
+        [&](auto& e) {
+            addProperty(e);
+            e.setReadOnly(true);
+            e.setSerializationMode(PropertySerializationMode::None);
+        },
+        props());
+    addProperty(reset_);
+    reset_.onChange([this]() {
+        timer_.reset();
+        refresh();
+    });
+}
+
+}  // namespace inviwo
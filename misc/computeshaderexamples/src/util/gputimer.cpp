@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/computeshaderexamples/util/gputimer.h>
+
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/rendercontext.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+GpuTimer::Scope::Scope(GpuTimer& timer) : timer_{&timer} { timer_->begin(); }
+
+GpuTimer::Scope::Scope(Scope&& rhs) noexcept : timer_{rhs.timer_} { rhs.timer_ = nullptr; }
+
+GpuTimer::Scope::~Scope() {
+    if (timer_) timer_->end();
+}
+
+GpuTimer::~GpuTimer() {
+    if (free_.empty() && pending_.empty() && !running_) return;
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    if (running_) free_.push_back(active_);
+    free_.insert(free_.end(), pending_.begin(), pending_.end());
+    for (const auto& queries : free_) {
+        glDeleteQueries(1, &queries.begin);
+        glDeleteQueries(1, &queries.end);
+    }
+}
+
+GpuTimer::Scope GpuTimer::measure() { return Scope{*this}; }
+
+void GpuTimer::begin() {
+    if (running_) {
+        throw Exception("GpuTimer: a measurement is already running", IVW_CONTEXT);
+    }
+    active_ = acquire();
+    running_ = true;
+    glQueryCounter(active_.begin, GL_TIMESTAMP);
+}
+
+void GpuTimer::end() {
+    if (!running_) return;
+    glQueryCounter(active_.end, GL_TIMESTAMP);
+    pending_.push_back(active_);
+    running_ = false;
+}
+
+bool GpuTimer::collect() {
+    // Queries complete in order, stop at the first one still in flight
+    auto it = pending_.begin();
+    for (; it != pending_.end(); ++it) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(it->end, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(it->begin, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(it->end, GL_QUERY_RESULT, &end);
+        const double ms = static_cast<double>(end - begin) / 1.0e6;
+
+        ++statistics_.count;
+        statistics_.last = ms;
+        statistics_.min = std::min(statistics_.min, ms);
+        statistics_.max = std::max(statistics_.max, ms);
+        statistics_.total += ms;
+        free_.push_back(*it);
+    }
+    const bool collected = it != pending_.begin();
+    pending_.erase(pending_.begin(), it);
+    return collected;
+}
+
+void GpuTimer::reset() { statistics_ = Statistics{}; }
+
+GpuTimer::Queries GpuTimer::acquire() {
+    if (free_.empty()) {
+        Queries queries;
+        glGenQueries(1, &queries.begin);
+        glGenQueries(1, &queries.end);
+        return queries;
+    }
+    auto queries = free_.back();
+    free_.pop_back();
+    return queries;
+}
+
+}  // namespace inviwo
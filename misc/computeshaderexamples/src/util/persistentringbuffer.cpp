@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/computeshaderexamples/util/persistentringbuffer.h>
+
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/rendercontext.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+PersistentRingBuffer::PersistentRingBuffer(GLenum target, size_t segments)
+    : target_{target}, fences_(std::max(segments, size_t{1}), nullptr), current_{0} {
+    // The first acquire moves on to segment 0
+    current_ = fences_.size() - 1;
+}
+
+PersistentRingBuffer::~PersistentRingBuffer() {
+    if (id_ == 0) return;
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    free();
+}
+
+void* PersistentRingBuffer::acquire(size_t bytes) {
+    if (bytes > segmentSize_) {
+        allocate(std::max(bytes, 2 * segmentSize_));
+    }
+    current_ = (current_ + 1) % fences_.size();
+    auto& fence = fences_[current_];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++stalls_;
+            while (status == GL_TIMEOUT_EXPIRED) {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100'000'000);
+            }
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    acquired_ = bytes;
+    return data_ + getOffset();
+}
+
+void PersistentRingBuffer::bind(GLuint index) const {
+    // Binding an empty range is an error, a single element is still valid
+    glBindBufferRange(target_, index, id_, getOffset(),
+                      std::max(acquired_, std::min(segmentSize_, size_t{16})));
+}
+
+void PersistentRingBuffer::release() {
+    auto& fence = fences_[current_];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void PersistentRingBuffer::allocate(size_t segmentSize) {
+    // Segment offsets have to respect the binding alignment of the target
+    GLint alignment = 256;
+    glGetIntegerv(target_ == GL_UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+                                               : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT,
+                  &alignment);
+    const size_t align = static_cast<size_t>(std::max(alignment, 1));
+    segmentSize = (segmentSize + align - 1) / align * align;
+
+    // The GPU may still read the old buffer, it is kept alive by the driver until it is done
+    free();
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto size = static_cast<GLsizeiptr>(segmentSize * fences_.size());
+    glGenBuffers(1, &id_);
+    glBindBuffer(target_, id_);
+    glBufferStorage(target_, size, nullptr, flags);
+    data_ = static_cast<char*>(glMapBufferRange(target_, 0, size, flags));
+    glBindBuffer(target_, 0);
+    if (!data_) {
+        free();
+        throw Exception("Failed to map persistent buffer", IVW_CONTEXT);
+    }
+    segmentSize_ = segmentSize;
+    LGL_ERROR;
+}
+
+void PersistentRingBuffer::free() {
+    for (auto& fence : fences_) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (id_ != 0) {
+        if (data_) {
+            glBindBuffer(target_, id_);
+            glUnmapBuffer(target_);
+            glBindBuffer(target_, 0);
+        }
+        glDeleteBuffers(1, &id_);
+    }
+    id_ = 0;
+    data_ = nullptr;
+    segmentSize_ = 0;
+}
+
+}  // namespace inviwo
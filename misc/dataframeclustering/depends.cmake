@@ -2,6 +2,8 @@
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
     InviwoDataFramePythonModule
+    InviwoPython3Module
+    InviwoUtilitiesModule
 )
 
 # Add an alias for this module. Several modules can share an alias. 
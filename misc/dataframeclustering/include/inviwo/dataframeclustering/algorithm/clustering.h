@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/dataframeclustering/dataframeclusteringmoduledefine.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+class DataFrame;
+
+/**
+ * Native implementations of the clustering methods of DataFrameClustering. They reproduce the
+ * results of the corresponding scikit-learn methods used by dataframeclustering.py up to the
+ * random initialization of k-means.
+ *
+ * The clustering methods take an optional \p progress callback, called on the calling thread with
+ * values in [0, 1], and an optional \p stop callback. Once \p stop returns true, the computation
+ * is aborted and an empty vector of labels is returned.
+ */
+namespace clustering {
+
+/**
+ * \brief row-major matrix of features, one row per data point
+ */
+struct IVW_MODULE_DATAFRAMECLUSTERING_API Features {
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<double> values;
+
+    const double* row(size_t i) const { return values.data() + i * cols; }
+};
+
+/**
+ * Gather the columns of \p dataFrame with the given \p headers, in the order of the data frame,
+ * as features. Non-constant columns are scaled like sklearn.preprocessing.RobustScaler, that is
+ * the median is subtracted and the result is divided by the interquartile range.
+ *
+ * @throws Exception if a column contains NaN or infinite values
+ */
+IVW_MODULE_DATAFRAMECLUSTERING_API Features robustScaledFeatures(
+    const DataFrame& dataFrame, const std::vector<std::string>& headers);
+
+/**
+ * K-means clustering with k-means++ initialization. The best of \p numInit runs, with respect to
+ * the sum of squared distances to the cluster centers, is returned. Point assignments and center
+ * updates are computed in parallel.
+ *
+ * @return cluster label in [0, k) of each point
+ */
+IVW_MODULE_DATAFRAMECLUSTERING_API std::vector<int> kmeans(
+    const Features& features, int k, int numInit = 10, int maxIterations = 300,
+    unsigned int seed = 0, std::function<void(float)> progress = nullptr,
+    std::function<bool()> stop = nullptr);
+
+/**
+ * Mini-batch k-means (Sculley, Web-Scale K-Means Clustering, 2010). Each iteration assigns a random
+ * batch of \p batchSize points to the closest centers and moves the centers towards the means of
+ * their assigned points, with a learning rate decreasing with the number of points assigned so far.
+ * The iterations stop once the centers move less than \p tolerance, and all points are labeled
+ * in parallel chunks at the end.
+ *
+ * @param centers  row-major k x cols matrix of cluster centers. If it has the right size, it is
+ *                 used as initial centers (warm start), otherwise the centers are initialized
+ *                 with k-means++ on a random subset of the points. Contains the final centers on
+ *                 return.
+ * @return cluster label in [0, k) of each point
+ */
+IVW_MODULE_DATAFRAMECLUSTERING_API std::vector<int> miniBatchKMeans(
+    const Features& features, int k, std::vector<double>& centers, int batchSize = 1024,
+    int maxIterations = 100, double tolerance = 1e-3, unsigned int seed = 0,
+    std::function<void(float)> progress = nullptr, std::function<bool()> stop = nullptr);
+
+/**
+ * Density-based clustering (DBSCAN). A point is a core point if at least \p minPoints points,
+ * including itself, lie within distance \p eps. Neighborhoods are found with a kd-tree and
+ * queried in parallel.
+ *
+ * @return cluster label of each point, -1 for noise
+ */
+IVW_MODULE_DATAFRAMECLUSTERING_API std::vector<int> dbscan(
+    const Features& features, double eps, int minPoints,
+    std::function<void(float)> progress = nullptr, std::function<bool()> stop = nullptr);
+
+/**
+ * Relabel the clusters by decreasing size such that the largest cluster gets label 0. Negative
+ * labels, i.e. noise, are left unchanged.
+ *
+ * @return number of distinct labels, including the noise label if present
+ */
+IVW_MODULE_DATAFRAMECLUSTERING_API int remapLabels(std::vector<int>& labels);
+
+}  // namespace clustering
+
+}  // namespace inviwo
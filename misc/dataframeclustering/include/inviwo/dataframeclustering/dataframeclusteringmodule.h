@@ -30,6 +30,8 @@
 
 #include <inviwo/dataframeclustering/dataframeclusteringmoduledefine.h>
 #include <inviwo/core/common/inviwomodule.h>
+#include <modules/python3/pyutils.h>
+#include <modules/python3/pythonprocessorfolderobserver.h>
 
 namespace inviwo {
 
@@ -37,6 +39,9 @@ class IVW_MODULE_DATAFRAMECLUSTERING_API DataFrameClusteringModule : public Invi
 public:
     DataFrameClusteringModule(InviwoApplication* app);
     virtual ~DataFrameClusteringModule() = default;
+
+    pyutil::ModulePath scripts_;
+    PythonProcessorFolderObserver pythonFolderObserver_;
 };
 
 }  // namespace inviwo
@@ -32,21 +32,39 @@
 #include <inviwo/dataframeclustering/dataframeclusteringmoduledefine.h>
 #include <inviwo/dataframe/datastructures/dataframe.h>
 #include <inviwo/core/common/inviwo.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 #include <inviwo/core/properties/boolcompositeproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/ports/imageport.h>
 
 #include <modules/python3/pythonscript.h>
 
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.DataFrameClustering, Data Frame Clustering}
  * ![](org.inviwo.DataFrameClustering.png?classIdentifier=org.inviwo.DataFrameClustering)
+ * Cluster the rows of a DataFrame based on the selected columns, which are scaled robustly to
+ * outliers first. K-means, mini-batch k-means, and DBSCAN are computed natively in parallel, see
+ * clustering::kmeans, clustering::miniBatchKMeans, and clustering::dbscan. Mini-batch k-means
+ * scales to very large data frames and, with Warm Start, continues from the previous centers
+ * when the data changes while the selected columns stay the same. Agglomerative and spectral
+ * clustering use scikit-learn and SciPy through the script dataframeclustering.py.
+ *
+ * The native methods run in the background and report their progress. Runs which are outdated
+ * by changes of the data, the selected columns, the method, or its parameters are stopped and
+ * their results discarded. The Python methods run on the main thread, since they need the
+ * interpreter. The most recent results of all methods are cached and reused when returning to a
+ * previous combination of columns, method, parameters, and data.
  */
-class IVW_MODULE_DATAFRAMECLUSTERING_API DataFrameClustering : public Processor {
+class IVW_MODULE_DATAFRAMECLUSTERING_API DataFrameClustering : public PoolProcessor {
 public:
     DataFrameClustering(InviwoApplication* app);
     virtual ~DataFrameClustering() = default;
@@ -65,6 +83,7 @@ private:
     IntProperty numberOfClusters_;
 
     CompositeProperty kmeans_;
+    CompositeProperty miniBatch_;
     CompositeProperty dbscan_;
     CompositeProperty agglomerative_;
     CompositeProperty spectral_;
@@ -74,6 +93,9 @@ private:
     FloatProperty eps_;
     IntProperty N_;
 
+    IntProperty batchSize_;
+    BoolProperty warmStart_;
+
     IntProperty numberOfFoundClusters_;
 
     OptionPropertyString linkage_;
@@ -82,6 +104,39 @@ private:
 
     PythonScriptDisk script_;
 
+    // mini-batch k-means centers of the last run and the columns they refer to
+    std::vector<double> centers_;
+    std::vector<std::string> centerHeaders_;
+
+    // identifies a clustering result by the method, the selected columns, the parameters of the
+    // method, and a hash of the data of the selected columns
+    struct CacheKey {
+        std::string method;
+        std::vector<std::string> headers;
+        std::string parameters;
+        size_t dataHash = 0;
+
+        bool operator==(const CacheKey& rhs) const {
+            return method == rhs.method && headers == rhs.headers &&
+                   parameters == rhs.parameters && dataHash == rhs.dataHash;
+        }
+    };
+    struct CacheEntry {
+        CacheKey key;
+        std::shared_ptr<const BufferBase> labels;
+        int numberOfFoundClusters = 0;
+        std::vector<double> centers;  // only used by mini-batch k-means
+    };
+    static constexpr size_t cacheSize_ = 8;
+    std::deque<CacheEntry> cache_;  // most recently used first
+    size_t run_ = 0;                // incremented for each process(), identifies current results
+
+    std::vector<std::string> selectedHeaders() const;
+    CacheKey cacheKey(std::vector<std::string> headers) const;
+    void addToCache(CacheEntry entry);
+    void setResult(const CacheEntry& entry);
+
+    void clusterNative(CacheKey key);
     void onDataFrameChange();
 };
 
@@ -0,0 +1,121 @@
+"""
+Zero-copy export of DataFrame columns to NumPy and Apache Arrow.
+
+The NumPy arrays returned here share the memory of the column buffers instead of copying them,
+and keep the DataFrame alive for as long as they are referenced. Arrow arrays and tables are
+built on top of the same memory, so handing a DataFrame with millions of rows, e.g. the output of
+IntegralLinesToDataFrame, PersistenceDiagram, ContourTreeToDataFrame, or
+InvariantSpaceToDataFrame, over to pandas or other Arrow based tools does not touch the values.
+Writing Arrow IPC or Feather files streams the buffers directly to the file.
+
+Requires `pyarrow` for everything but columnViews, `python -m pip install pyarrow`.
+"""
+
+import numpy
+
+import ivwdataframe as dfpy
+
+try:
+    import pyarrow
+    import pyarrow.ipc
+except ImportError:
+    pyarrow = None
+
+
+class _ColumnMemory:
+    """
+    Exposes the memory of a column buffer through the NumPy array interface. Arrays created from
+    it keep a reference to it, and thereby to the DataFrame owning the buffer.
+    """
+
+    def __init__(self, view: numpy.ndarray, owner):
+        self.__array_interface__ = view.__array_interface__
+        self.view = view
+        self.owner = owner
+
+
+def columnView(dataframe, column) -> numpy.ndarray:
+    """
+    The values of a column as read-only NumPy array sharing the memory of the column buffer.
+    Categorical columns are returned as their category indices.
+    """
+    array = numpy.asarray(_ColumnMemory(column.buffer.data, dataframe))
+    array.flags.writeable = False
+    return array
+
+
+def selectColumns(dataframe, headers=None, includeIndex: bool = False) -> list:
+    """
+    The columns with the given headers in DataFrame order, all columns if headers is None. The
+    index column is only included if includeIndex is True.
+    """
+    columns = []
+    for i in range(dataframe.cols):
+        column = dataframe[i]
+        if i == 0 and not includeIndex and column.type == dfpy.ColumnType.Index:
+            continue
+        if headers is None or column.header in headers:
+            columns.append(column)
+    return columns
+
+
+def columnViews(dataframe, headers=None, includeIndex: bool = False) -> dict:
+    """Zero-copy NumPy views of the selected columns, see columnView, by header"""
+    return {column.header: columnView(dataframe, column)
+            for column in selectColumns(dataframe, headers, includeIndex)}
+
+
+def _requireArrow():
+    if pyarrow is None:
+        raise ImportError("Failed to import pyarrow. Run python -m pip install pyarrow")
+
+
+def toArrowArray(dataframe, column):
+    """
+    An Arrow array referencing the memory of the column buffer. Categorical columns become
+    dictionary arrays of their category indices, and columns of vectors fixed size lists.
+    """
+    _requireArrow()
+    view = columnView(dataframe, column)
+
+    if column.type == dfpy.ColumnType.Categorical:
+        # the indices are unsigned, which not all Arrow readers accept as dictionary indices
+        indices = pyarrow.Array.from_buffers(pyarrow.int32(), len(view),
+                                             [None, pyarrow.py_buffer(view.view(numpy.int32))])
+        return pyarrow.DictionaryArray.from_arrays(indices, pyarrow.array(column.categories,
+                                                                          pyarrow.string()))
+
+    flat = numpy.ascontiguousarray(view).reshape(-1)
+    if not numpy.shares_memory(flat, view):
+        raise ValueError(f"Column {column.header} is not contiguous")
+    values = pyarrow.Array.from_buffers(pyarrow.from_numpy_dtype(flat.dtype), len(flat),
+                                        [None, pyarrow.py_buffer(flat)])
+    if view.ndim > 1:
+        return pyarrow.FixedSizeListArray.from_arrays(values, view.shape[1])
+    return values
+
+
+def toArrow(dataframe, headers=None, includeIndex: bool = False):
+    """
+    A pyarrow.Table of the selected columns without copying any values. Use
+    toArrow(dataframe).to_pandas() to continue in pandas.
+    """
+    _requireArrow()
+    columns = selectColumns(dataframe, headers, includeIndex)
+    return pyarrow.table([toArrowArray(dataframe, column) for column in columns],
+                         names=[column.header for column in columns])
+
+
+def writeArrow(dataframe, path, stream: bool = False, compression=None, headers=None,
+               includeIndex: bool = False):
+    """
+    Writes the selected columns to an Arrow IPC file, also known as Feather V2, or to an Arrow
+    IPC stream if stream is True. Buffers are compressed with "lz4" or "zstd" if compression is
+    given, and written as they are otherwise.
+    """
+    table = toArrow(dataframe, headers, includeIndex)
+    options = pyarrow.ipc.IpcWriteOptions(compression=compression)
+    create = pyarrow.ipc.new_stream if stream else pyarrow.ipc.new_file
+    with pyarrow.OSFile(str(path), "wb") as sink:
+        with create(sink, table.schema, options=options) as writer:
+            writer.write_table(table)
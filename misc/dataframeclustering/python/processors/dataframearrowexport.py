@@ -0,0 +1,83 @@
+# Name: DataFrameArrowExport
+
+import inspect
+from pathlib import Path
+
+import inviwopy as ivw
+import ivwdataframe as dfpy
+from inviwopy.properties import FileProperty, ButtonProperty, BoolProperty, OptionPropertyInt, \
+    StringProperty
+
+import dataframearrow
+import importlib
+importlib.reload(dataframearrow)
+
+
+class DataFrameArrowExport(ivw.Processor):
+    """
+    Writes a DataFrame to an Arrow IPC (Feather V2) file or stream without copying the columns,
+    see dataframearrow.writeArrow. The files can be opened with pyarrow, pandas.read_feather,
+    polars, R arrow, and other Arrow based tools.
+    """
+    compressions = [None, "lz4", "zstd"]
+
+    def log(self, msg):
+        frame = inspect.getframeinfo(inspect.currentframe().f_back)
+        ivw.log(msg=str(msg), source=self.identifier, file=frame.filename,
+                line=frame.lineno, function=frame.function)
+
+    def __init__(self, id, name):
+        ivw.Processor.__init__(self, id, name)
+        self.dataframeInport = dfpy.DataFrameInport("dataframe")
+        self.addInport(self.dataframeInport, owner=False)
+
+        self.filePath = FileProperty("filepath", "Arrow Path", "", "arrowdata")
+        self.stream = OptionPropertyInt("format", "Format", [
+            ivw.properties.IntOption("file", "IPC File (Feather V2)", 0),
+            ivw.properties.IntOption("stream", "IPC Stream", 1)], 0)
+        self.compression = OptionPropertyInt("compression", "Compression", [
+            ivw.properties.IntOption("none", "None", 0),
+            ivw.properties.IntOption("lz4", "LZ4", 1),
+            ivw.properties.IntOption("zstd", "Zstandard", 2)], 0)
+        self.columns = StringProperty("columns", "Columns (comma separated, empty for all)", "")
+        self.includeIndex = BoolProperty("includeIndex", "Include Index Column", False)
+        self.overwrite = BoolProperty("overwrite", "Overwrite", False)
+        self.triggerExport = ButtonProperty("export", "Export")
+
+        self.addProperty(self.filePath)
+        self.addProperty(self.stream)
+        self.addProperty(self.compression)
+        self.addProperty(self.columns)
+        self.addProperty(self.includeIndex)
+        self.addProperty(self.overwrite)
+        self.addProperty(self.triggerExport)
+
+    @staticmethod
+    def processorInfo():
+        return ivw.ProcessorInfo(
+            classIdentifier="org.inviwo.dataframe.dataframearrowexport",
+            displayName="DataFrame Arrow Export",
+            category="Data Output",
+            codeState=ivw.CodeState.Experimental,
+            tags=ivw.Tags([ivw.Tag.PY, ivw.Tag("DataFrame"), ivw.Tag("Arrow")])
+        )
+
+    def getProcessorInfo(self):
+        return DataFrameArrowExport.processorInfo()
+
+    def process(self):
+        if not self.triggerExport.isModified:
+            return
+        if len(self.filePath.value) == 0:
+            self.log("File name empty")
+            return
+        if Path(self.filePath.value).exists() and not self.overwrite.value:
+            self.log(f"{self.filePath.value} already exists")
+            return
+
+        headers = [h.strip() for h in self.columns.value.split(",") if h.strip()] or None
+        dataframearrow.writeArrow(self.dataframeInport.getData(), self.filePath.value,
+                                  stream=self.stream.value == 1,
+                                  compression=self.compressions[self.compression.value],
+                                  headers=headers, includeIndex=self.includeIndex.value)
+        self.log(f"Exported {self.filePath.value}")
@@ -0,0 +1,537 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/dataframeclustering/algorithm/clustering.h>
+
+#include <inviwo/dataframe/datastructures/dataframe.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace inviwo {
+
+namespace clustering {
+
+namespace {
+
+constexpr size_t grainSize = 1 << 12;
+
+size_t numChunks(size_t size) { return (size + grainSize - 1) / grainSize; }
+
+// optional progress and stop callbacks of the clustering methods
+struct Monitor {
+    std::function<void(float)> progress;
+    std::function<bool()> stop;
+
+    void report(double f) const {
+        if (progress) progress(static_cast<float>(f));
+    }
+    bool stopped() const { return stop && stop(); }
+};
+
+double squaredDistance(const double* a, const double* b, size_t dims) {
+    double sum = 0.0;
+    for (size_t i = 0; i < dims; ++i) {
+        const double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// quantile with linear interpolation, like numpy.percentile, reorders values
+double quantile(std::vector<double>& values, double q) {
+    const double pos = q * static_cast<double>(values.size() - 1);
+    const auto lo = static_cast<size_t>(std::floor(pos));
+    const auto hi = static_cast<size_t>(std::ceil(pos));
+    std::nth_element(values.begin(), values.begin() + lo, values.end());
+    const double low = values[lo];
+    if (hi == lo) return low;
+    const double high = *std::min_element(values.begin() + lo + 1, values.end());
+    return low + (high - low) * (pos - static_cast<double>(lo));
+}
+
+struct KMeansResult {
+    std::vector<int> labels;
+    double inertia = std::numeric_limits<double>::infinity();
+};
+
+std::vector<double> kmeansPlusPlus(const Features& f, size_t k, std::mt19937& rng) {
+    std::vector<double> centers(k * f.cols);
+    std::vector<double> minDist(f.rows, std::numeric_limits<double>::infinity());
+
+    size_t next = std::uniform_int_distribution<size_t>(0, f.rows - 1)(rng);
+    for (size_t c = 0; c < k; ++c) {
+        std::copy_n(f.row(next), f.cols, centers.begin() + c * f.cols);
+        if (c + 1 == k) break;
+
+        const double* center = centers.data() + c * f.cols;
+        std::vector<double> chunkSums(numChunks(f.rows), 0.0);
+        util::forEachRangeParallel(f.rows, grainSize, [&](size_t begin, size_t end) {
+            const auto chunk = begin / grainSize;
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                minDist[i] = std::min(minDist[i], squaredDistance(f.row(i), center, f.cols));
+                sum += minDist[i];
+            }
+            chunkSums[chunk] = sum;
+        });
+
+        // sample the next center with probability proportional to the squared distance
+        const double total = std::accumulate(chunkSums.begin(), chunkSums.end(), 0.0);
+        if (total <= 0.0) {
+            next = std::uniform_int_distribution<size_t>(0, f.rows - 1)(rng);
+            continue;
+        }
+        double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+        size_t chunk = 0;
+        while (chunk + 1 < chunkSums.size() && target >= chunkSums[chunk]) {
+            target -= chunkSums[chunk++];
+        }
+        next = std::min(f.rows, (chunk + 1) * grainSize) - 1;
+        for (size_t i = chunk * grainSize; i < std::min(f.rows, (chunk + 1) * grainSize); ++i) {
+            if (target < minDist[i]) {
+                next = i;
+                break;
+            }
+            target -= minDist[i];
+        }
+    }
+    return centers;
+}
+
+// index of the closest center and the squared distance to it
+std::pair<int, double> closestCenter(const double* p, const std::vector<double>& centers, size_t k,
+                                     size_t dims) {
+    int best = 0;
+    double bestDist = std::numeric_limits<double>::infinity();
+    for (size_t c = 0; c < k; ++c) {
+        const double d = squaredDistance(p, centers.data() + c * dims, dims);
+        if (d < bestDist) {
+            bestDist = d;
+            best = static_cast<int>(c);
+        }
+    }
+    return {best, bestDist};
+}
+
+// labels are left incomplete if stopped
+KMeansResult lloyd(const Features& f, size_t k, std::vector<double> centers, int maxIterations,
+                   const Monitor& monitor) {
+    KMeansResult result;
+    result.labels.assign(f.rows, -1);
+
+    const size_t chunks = numChunks(f.rows);
+    std::vector<double> sums(chunks * k * f.cols);
+    std::vector<size_t> counts(chunks * k);
+    std::vector<double> inertias(chunks);
+    std::vector<size_t> changes(chunks);
+    std::vector<double> distances(f.rows);
+
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        if (monitor.stopped()) break;
+        // assign points to the closest center and accumulate the new centers per chunk
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), size_t{0});
+        util::forEachRangeParallel(f.rows, grainSize, [&](size_t begin, size_t end) {
+            const auto chunk = begin / grainSize;
+            double* chunkSums = sums.data() + chunk * k * f.cols;
+            size_t* chunkCounts = counts.data() + chunk * k;
+            double inertia = 0.0;
+            size_t changed = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const double* p = f.row(i);
+                const auto [best, bestDist] = closestCenter(p, centers, k, f.cols);
+                if (result.labels[i] != best) ++changed;
+                result.labels[i] = best;
+                distances[i] = bestDist;
+                inertia += bestDist;
+                ++chunkCounts[best];
+                double* sum = chunkSums + best * f.cols;
+                for (size_t j = 0; j < f.cols; ++j) sum[j] += p[j];
+            }
+            inertias[chunk] = inertia;
+            changes[chunk] = changed;
+        });
+        result.inertia = std::accumulate(inertias.begin(), inertias.end(), 0.0);
+        if (std::accumulate(changes.begin(), changes.end(), size_t{0}) == 0) break;
+
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            for (size_t i = 0; i < k * f.cols; ++i) sums[i] += sums[chunk * k * f.cols + i];
+            for (size_t c = 0; c < k; ++c) counts[c] += counts[chunk * k + c];
+        }
+        for (size_t c = 0; c < k; ++c) {
+            double* center = centers.data() + c * f.cols;
+            if (counts[c] > 0) {
+                for (size_t j = 0; j < f.cols; ++j) {
+                    center[j] = sums[c * f.cols + j] / static_cast<double>(counts[c]);
+                }
+            } else {
+                // relocate empty clusters to the point farthest from its center
+                const auto far = static_cast<size_t>(
+                    std::distance(distances.begin(),
+                                  std::max_element(distances.begin(), distances.end())));
+                std::copy_n(f.row(far), f.cols, center);
+                distances[far] = 0.0;
+            }
+        }
+    }
+    return result;
+}
+
+// kd-tree for fixed radius neighbor queries
+class KdTree {
+public:
+    explicit KdTree(const Features& f) : f_{f}, indices_(f.rows) {
+        std::iota(indices_.begin(), indices_.end(), size_t{0});
+        if (f.rows > 0) build(0, f.rows);
+    }
+
+    template <typename Callback>
+    void radiusSearch(const double* query, double radius, Callback&& callback) const {
+        if (nodes_.empty()) return;
+        const double r2 = radius * radius;
+        std::vector<size_t> stack{0};
+        while (!stack.empty()) {
+            const auto& node = nodes_[stack.back()];
+            stack.pop_back();
+            if (node.left == 0) {
+                for (size_t i = node.begin; i < node.end; ++i) {
+                    if (squaredDistance(query, f_.row(indices_[i]), f_.cols) <= r2) {
+                        callback(indices_[i]);
+                    }
+                }
+                continue;
+            }
+            // points left of the split are <= split, points to the right are >= split
+            const double diff = query[node.dim] - node.split;
+            const size_t nearChild = diff < 0.0 ? node.left : node.left + 1;
+            const size_t farChild = diff < 0.0 ? node.left + 1 : node.left;
+            if (diff * diff <= r2) stack.push_back(farChild);
+            stack.push_back(nearChild);
+        }
+    }
+
+private:
+    static constexpr size_t leafSize = 16;
+
+    struct Node {
+        size_t begin;
+        size_t end;
+        size_t dim = 0;
+        double split = 0.0;
+        size_t left = 0;  // index of the left child, the right child follows. 0 for leaves
+    };
+
+    void build(size_t begin, size_t end) {
+        std::vector<size_t> stack{nodes_.size()};
+        nodes_.push_back(Node{begin, end});
+        while (!stack.empty()) {
+            const size_t current = stack.back();
+            stack.pop_back();
+            const size_t b = nodes_[current].begin;
+            const size_t e = nodes_[current].end;
+            if (e - b <= leafSize) continue;
+
+            // split along the dimension with the largest extent
+            size_t dim = 0;
+            double extent = -1.0;
+            for (size_t j = 0; j < f_.cols; ++j) {
+                auto [lo, hi] = std::minmax_element(
+                    indices_.begin() + b, indices_.begin() + e,
+                    [&](size_t x, size_t y) { return f_.row(x)[j] < f_.row(y)[j]; });
+                const double ext = f_.row(*hi)[j] - f_.row(*lo)[j];
+                if (ext > extent) {
+                    extent = ext;
+                    dim = j;
+                }
+            }
+            if (extent <= 0.0) continue;
+
+            const size_t mid = b + (e - b) / 2;
+            std::nth_element(indices_.begin() + b, indices_.begin() + mid, indices_.begin() + e,
+                             [&](size_t x, size_t y) { return f_.row(x)[dim] < f_.row(y)[dim]; });
+
+            const size_t left = nodes_.size();
+            nodes_[current].dim = dim;
+            nodes_[current].split = f_.row(indices_[mid])[dim];
+            nodes_[current].left = left;
+            nodes_.push_back(Node{b, mid});
+            nodes_.push_back(Node{mid, e});
+            stack.push_back(left);
+            stack.push_back(left + 1);
+        }
+    }
+
+    const Features& f_;
+    std::vector<size_t> indices_;
+    std::vector<Node> nodes_;
+};
+
+}  // namespace
+
+Features robustScaledFeatures(const DataFrame& dataFrame, const std::vector<std::string>& headers) {
+    Features features;
+    features.rows = dataFrame.getNumberOfRows();
+
+    std::vector<std::shared_ptr<const Column>> columns;
+    for (size_t i = 0; i < dataFrame.getNumberOfColumns(); ++i) {
+        if (std::find(headers.begin(), headers.end(), dataFrame.getHeader(i)) != headers.end()) {
+            columns.push_back(dataFrame.getColumn(i));
+        }
+    }
+    features.cols = columns.size();
+    features.values.resize(features.rows * features.cols);
+
+    std::vector<double> column(features.rows);
+    for (size_t j = 0; j < columns.size(); ++j) {
+        const auto buffer = columns[j]->getBuffer();
+        if (buffer->getSize() < features.rows) {
+            throw Exception(fmt::format("Column {} has {} rows, expected {}",
+                                        columns[j]->getHeader(), buffer->getSize(),
+                                        features.rows),
+                            IVW_CONTEXT_CUSTOM("clustering::robustScaledFeatures"));
+        }
+        // read the column data directly in its own type
+        buffer->getRepresentation<BufferRAM>()->dispatch<void, dispatching::filter::Scalars>(
+            [&](auto br) {
+                const auto& data = br->getDataContainer();
+                std::transform(data.begin(), data.begin() + features.rows, column.begin(),
+                               [](auto v) { return static_cast<double>(v); });
+            });
+        if (!std::all_of(column.begin(), column.end(), [](double v) { return std::isfinite(v); })) {
+            throw Exception(
+                fmt::format("Column {} has nan/inf values", columns[j]->getHeader()),
+                IVW_CONTEXT_CUSTOM("clustering::robustScaledFeatures"));
+        }
+
+        double center = 0.0;
+        double scale = 1.0;
+        if (features.rows > 0) {
+            const auto [minIt, maxIt] = std::minmax_element(column.begin(), column.end());
+            if (*minIt != *maxIt) {
+                std::vector<double> sorted(column);
+                center = quantile(sorted, 0.5);
+                const double iqr = quantile(sorted, 0.75) - quantile(sorted, 0.25);
+                // constant interquartile ranges are not scaled, like in RobustScaler
+                if (iqr != 0.0) scale = iqr;
+            }
+        }
+        for (size_t i = 0; i < features.rows; ++i) {
+            features.values[i * features.cols + j] = (column[i] - center) / scale;
+        }
+    }
+    return features;
+}
+
+std::vector<int> kmeans(const Features& features, int k, int numInit, int maxIterations,
+                        unsigned int seed, std::function<void(float)> progress,
+                        std::function<bool()> stop) {
+    if (features.rows == 0) return {};
+    const Monitor monitor{std::move(progress), std::move(stop)};
+    const size_t clusters =
+        std::min(features.rows, static_cast<size_t>(std::max(k, 1)));
+
+    std::mt19937 rng{seed};
+    KMeansResult best;
+    const int runs = std::max(numInit, 1);
+    for (int run = 0; run < runs; ++run) {
+        auto result = lloyd(features, clusters, kmeansPlusPlus(features, clusters, rng),
+                            maxIterations, monitor);
+        if (monitor.stopped()) return {};
+        if (result.inertia < best.inertia) best = std::move(result);
+        monitor.report(static_cast<double>(run + 1) / runs);
+    }
+    return std::move(best.labels);
+}
+
+std::vector<int> miniBatchKMeans(const Features& features, int k, std::vector<double>& centers,
+                                 int batchSize, int maxIterations, double tolerance,
+                                 unsigned int seed, std::function<void(float)> progress,
+                                 std::function<bool()> stop) {
+    if (features.rows == 0) return {};
+    const Monitor monitor{std::move(progress), std::move(stop)};
+    const size_t clusters = std::min(features.rows, static_cast<size_t>(std::max(k, 1)));
+    const size_t dims = features.cols;
+    const size_t batch = std::min(features.rows, static_cast<size_t>(std::max(batchSize, 1)));
+
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<size_t> randomRow(0, features.rows - 1);
+
+    // warm started centers count as if one batch had been assigned already, which keeps them
+    // from being replaced by the first batch means
+    const bool warmStart = centers.size() == clusters * dims;
+    std::vector<size_t> counts(clusters, warmStart ? std::max<size_t>(batch / clusters, 1) : 0);
+    if (!warmStart) {
+        // k-means++ on a random subset, like the init_size of scikit-learn
+        Features subset;
+        subset.rows = std::min(features.rows, std::max(3 * batch, clusters));
+        subset.cols = dims;
+        subset.values.resize(subset.rows * dims);
+        for (size_t i = 0; i < subset.rows; ++i) {
+            std::copy_n(features.row(randomRow(rng)), dims, subset.values.begin() + i * dims);
+        }
+        centers = kmeansPlusPlus(subset, clusters, rng);
+    }
+
+    std::vector<size_t> rows(batch);
+    std::vector<int> batchLabels(batch);
+    std::vector<double> sums(clusters * dims);
+    std::vector<size_t> batchCounts(clusters);
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        if (monitor.stopped()) return {};
+        monitor.report(0.9 * iteration / maxIterations);
+        for (auto& row : rows) row = randomRow(rng);
+        util::forEachRangeParallel(batch, grainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                batchLabels[i] =
+                    closestCenter(features.row(rows[i]), centers, clusters, dims).first;
+            }
+        });
+
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(batchCounts.begin(), batchCounts.end(), size_t{0});
+        for (size_t i = 0; i < batch; ++i) {
+            const double* p = features.row(rows[i]);
+            double* sum = sums.data() + batchLabels[i] * dims;
+            for (size_t j = 0; j < dims; ++j) sum[j] += p[j];
+            ++batchCounts[batchLabels[i]];
+        }
+
+        // per center learning rate of 1 / number of assigned points
+        double shift = 0.0;
+        for (size_t c = 0; c < clusters; ++c) {
+            if (batchCounts[c] == 0) continue;
+            counts[c] += batchCounts[c];
+            const double rate = 1.0 / static_cast<double>(counts[c]);
+            double* center = centers.data() + c * dims;
+            for (size_t j = 0; j < dims; ++j) {
+                const double delta =
+                    rate * (sums[c * dims + j] - static_cast<double>(batchCounts[c]) * center[j]);
+                center[j] += delta;
+                shift += delta * delta;
+            }
+        }
+        if (shift < tolerance * tolerance) break;
+    }
+
+    std::vector<int> labels(features.rows);
+    util::forEachRangeParallel(features.rows, grainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            labels[i] = closestCenter(features.row(i), centers, clusters, dims).first;
+        }
+    });
+    monitor.report(1.0);
+    return labels;
+}
+
+std::vector<int> dbscan(const Features& features, double eps, int minPoints,
+                        std::function<void(float)> progress, std::function<bool()> stop) {
+    const Monitor monitor{std::move(progress), std::move(stop)};
+    const KdTree tree{features};
+    monitor.report(0.1);
+
+    std::vector<std::vector<size_t>> neighbors(features.rows);
+    util::forEachRangeParallel(
+        features.rows, grainSize,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                tree.radiusSearch(features.row(i), eps,
+                                  [&](size_t neighbor) { neighbors[i].push_back(neighbor); });
+            }
+        },
+        monitor.stop);
+    if (monitor.stopped()) return {};
+    monitor.report(0.8);
+    auto isCore = [&](size_t i) { return neighbors[i].size() >= static_cast<size_t>(minPoints); };
+
+    std::vector<int> labels(features.rows, -1);
+    int cluster = 0;
+    std::vector<size_t> stack;
+    for (size_t i = 0; i < features.rows; ++i) {
+        if (labels[i] != -1 || !isCore(i)) continue;
+
+        // expand the cluster through the neighborhoods of its core points
+        labels[i] = cluster;
+        stack.push_back(i);
+        while (!stack.empty()) {
+            const size_t current = stack.back();
+            stack.pop_back();
+            for (auto neighbor : neighbors[current]) {
+                if (labels[neighbor] != -1) continue;
+                labels[neighbor] = cluster;
+                if (isCore(neighbor)) stack.push_back(neighbor);
+            }
+        }
+        ++cluster;
+    }
+    monitor.report(1.0);
+    return labels;
+}
+
+int remapLabels(std::vector<int>& labels) {
+    const int maxLabel =
+        labels.empty() ? -1 : *std::max_element(labels.begin(), labels.end());
+    std::vector<size_t> sizes(static_cast<size_t>(maxLabel + 1), 0);
+    bool noise = false;
+    for (auto label : labels) {
+        if (label < 0) {
+            noise = true;
+        } else {
+            ++sizes[label];
+        }
+    }
+
+    std::vector<int> order;
+    for (size_t label = 0; label < sizes.size(); ++label) {
+        if (sizes[label] > 0) order.push_back(static_cast<int>(label));
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return sizes[a] > sizes[b]; });
+    std::vector<int> mapping(sizes.size(), -1);
+    for (size_t i = 0; i < order.size(); ++i) {
+        mapping[order[i]] = static_cast<int>(i);
+    }
+    for (auto& label : labels) {
+        if (label >= 0) label = mapping[label];
+    }
+    return static_cast<int>(order.size()) + (noise ? 1 : 0);
+}
+
+}  // namespace clustering
+
+}  // namespace inviwo
@@ -33,7 +33,9 @@
 namespace inviwo {
 
 DataFrameClusteringModule::DataFrameClusteringModule(InviwoApplication* app)
-    : InviwoModule(app, "DataFrameClustering") {
+    : InviwoModule(app, "DataFrameClustering")
+    , scripts_{getPath() + "/python"}
+    , pythonFolderObserver_{app, getPath() + "/python/processors", *this} {
     // Add a directory to the search path of the Shadermanager
     // ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
 
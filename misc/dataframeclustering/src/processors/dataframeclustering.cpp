@@ -29,10 +29,44 @@
 
 #include <inviwo/dataframeclustering/processors/dataframeclustering.h>
 #include <inviwo/dataframeclustering/dataframeclusteringmodule.h>
+#include <inviwo/dataframeclustering/algorithm/clustering.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/util/hashcombine.h>
 #include <modules/python3/pybindutils.h>
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <string_view>
+
 namespace inviwo {
 
+namespace {
+
+// hash of the number of rows and the raw data of the columns with the given headers
+size_t hashColumns(const DataFrame& dataFrame, const std::vector<std::string>& headers) {
+    size_t hash = 0;
+    util::hash_combine(hash, dataFrame.getNumberOfRows());
+    for (size_t i = 0; i < dataFrame.getNumberOfColumns(); ++i) {
+        if (std::find(headers.begin(), headers.end(), dataFrame.getHeader(i)) == headers.end()) {
+            continue;
+        }
+        dataFrame.getColumn(i)
+            ->getBuffer()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<void, dispatching::filter::All>([&](auto br) {
+                const auto& data = br->getDataContainer();
+                const std::string_view bytes{reinterpret_cast<const char*>(data.data()),
+                                             data.size() * sizeof(data[0])};
+                util::hash_combine(hash, bytes);
+            });
+    }
+    return hash;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming
 // scheme
 const ProcessorInfo DataFrameClustering::processorInfo_{
@@ -45,12 +79,13 @@ const ProcessorInfo DataFrameClustering::processorInfo_{
 const ProcessorInfo DataFrameClustering::getProcessorInfo() const { return processorInfo_; }
 
 DataFrameClustering::DataFrameClustering(InviwoApplication* app)
-    : Processor()
+    : PoolProcessor()
     , dataFrame_("dataFrame")
     , newDataFrame_("newDataFrame")
 
     , method_("method", "Method",
               {{"kmeans", "KMeans"},
+               {"minibatch", "Mini-Batch KMeans"},
                {"dbscan", "DBSCAN"},
                {"agglo", "Agglomerative"},
                {"spectral", "Spectral"}})
@@ -59,6 +94,7 @@ DataFrameClustering::DataFrameClustering(InviwoApplication* app)
                         {1, ConstraintBehavior::Immutable}, {10, ConstraintBehavior::Ignore})
 
     , kmeans_("kmeans_", "K-Means")
+    , miniBatch_("miniBatch", "Mini-Batch K-Means")
     , dbscan_("dbscan_", "DBSCAN")
     , agglomerative_("agglomerative_", "Agglomerative")
     , spectral_("spectral", "Spectral")
@@ -69,6 +105,9 @@ DataFrameClustering::DataFrameClustering(InviwoApplication* app)
            {1.f, ConstraintBehavior::Ignore}, 0.001f)
     , N_("N", "Min Points", 10, {1, ConstraintBehavior::Immutable},
          {100, ConstraintBehavior::Ignore})
+    , batchSize_("batchSize", "Batch Size", 1024, {1, ConstraintBehavior::Immutable},
+                 {65536, ConstraintBehavior::Ignore})
+    , warmStart_("warmStart", "Warm Start", true)
 
     , numberOfFoundClusters_("numberOfFoundClusters", "NumberOfFoundClusters", 0,
                              {0, ConstraintBehavior::Immutable}, {1000, ConstraintBehavior::Ignore},
@@ -92,14 +131,17 @@ DataFrameClustering::DataFrameClustering(InviwoApplication* app)
     addPort(dataFrame_);
     addPort(newDataFrame_);
     kmeans_.addProperty(numberOfClusters_);
+    miniBatch_.addProperties(numberOfClusters_, batchSize_, warmStart_);
     dbscan_.addProperties(eps_, N_);
     agglomerative_.addProperties(numberOfClusters_, linkage_);
     spectral_.addProperty(numberOfClusters_);
-    addProperties(method_, kmeans_, dbscan_, agglomerative_, spectral_, columnName_, columns_,
-                  numberOfFoundClusters_);
+    addProperties(method_, kmeans_, miniBatch_, dbscan_, agglomerative_, spectral_, columnName_,
+                  columns_, numberOfFoundClusters_);
 
     kmeans_.visibilityDependsOn(
         method_, [](const auto& p) { return p.getSelectedIdentifier() == "kmeans"; });
+    miniBatch_.visibilityDependsOn(
+        method_, [](const auto& p) { return p.getSelectedIdentifier() == "minibatch"; });
     dbscan_.visibilityDependsOn(
         method_, [](const auto& p) { return p.getSelectedIdentifier() == "dbscan"; });
     agglomerative_.visibilityDependsOn(
@@ -109,17 +151,39 @@ DataFrameClustering::DataFrameClustering(InviwoApplication* app)
 
     method_.set("agglo");
 
-    script_.onChange([&]() { this->invalidate(InvalidationLevel::InvalidOutput); });
+    script_.onChange([&]() {
+        cache_.clear();
+        this->invalidate(InvalidationLevel::InvalidOutput);
+    });
 
     dataFrame_.onChange([&]() { onDataFrameChange(); });
 }
 
 void DataFrameClustering::process() {
+    auto key = cacheKey(selectedHeaders());
+    // results of earlier runs, which are still running, are discarded
+    const auto run = ++run_;
+
+    if (auto it = std::find_if(cache_.begin(), cache_.end(),
+                               [&](const CacheEntry& entry) { return entry.key == key; });
+        it != cache_.end()) {
+        auto entry = std::move(*it);
+        cache_.erase(it);
+        cache_.push_front(std::move(entry));
+        setResult(cache_.front());
+        return;
+    }
+
+    // k-means and DBSCAN run natively in the background, the remaining methods use the Python
+    // script on the main thread
+    if (key.method == "kmeans" || key.method == "minibatch" || key.method == "dbscan") {
+        clusterNative(std::move(key));
+        return;
+    }
+
     pybind11::list cols;
-    for (auto& p : columns_.getPropertiesByType<BoolProperty>()) {
-        if (p->getVisible() && p->get()) {
-            cols.append(p->getDisplayName());
-        }
+    for (auto& header : key.headers) {
+        cols.append(header);
     }
 
     std::unordered_map<std::string, pybind11::object> vars = {
@@ -132,16 +196,111 @@ void DataFrameClustering::process() {
         {"dataframe", pybind11::cast(dataFrame_.getData())}};
 
     script_.run(vars, [&](pybind11::dict locals) {
-        auto newDF = std::make_shared<DataFrame>(*dataFrame_.getData());
+        if (run != run_) return;
         if (locals.contains("labels")) {
             auto pyArr = locals["labels"].cast<pybind11::array>();
-            std::shared_ptr<BufferBase> buf = pyutil::createBuffer(pyArr);
-            newDF->addColumnFromBuffer(columnName_.get(), buf);
-            if (locals.contains("numberOfFoundClusters")) {
-                numberOfFoundClusters_.set(locals["numberOfFoundClusters"].cast<int>());
-            }
+            CacheEntry entry{std::move(key), pyutil::createBuffer(pyArr),
+                             locals.contains("numberOfFoundClusters")
+                                 ? locals["numberOfFoundClusters"].cast<int>()
+                                 : numberOfFoundClusters_.get()};
+            addToCache(std::move(entry));
+            setResult(cache_.front());
+        } else {
+            newDataFrame_.setData(std::make_shared<DataFrame>(*dataFrame_.getData()));
         }
-        newDataFrame_.setData(newDF);
+    });
+}
+
+std::vector<std::string> DataFrameClustering::selectedHeaders() const {
+    std::vector<std::string> headers;
+    for (auto& p : columns_.getPropertiesByType<BoolProperty>()) {
+        if (p->getVisible() && p->get()) {
+            headers.push_back(p->getDisplayName());
+        }
+    }
+    return headers;
+}
+
+auto DataFrameClustering::cacheKey(std::vector<std::string> headers) const -> CacheKey {
+    const auto& method = method_.getSelectedIdentifier();
+    const auto parameters = [&]() -> std::string {
+        if (method == "minibatch") {
+            return fmt::format("{} {} {}", numberOfClusters_.get(), batchSize_.get(),
+                               warmStart_.get());
+        } else if (method == "dbscan") {
+            return fmt::format("{} {}", eps_.get(), N_.get());
+        } else if (method == "agglo") {
+            return fmt::format("{} {}", numberOfClusters_.get(), linkage_.getSelectedIdentifier());
+        } else {
+            return fmt::format("{}", numberOfClusters_.get());
+        }
+    }();
+    const auto dataHash = hashColumns(*dataFrame_.getData(), headers);
+    return CacheKey{method, std::move(headers), parameters, dataHash};
+}
+
+void DataFrameClustering::addToCache(CacheEntry entry) {
+    cache_.push_front(std::move(entry));
+    if (cache_.size() > cacheSize_) cache_.pop_back();
+}
+
+void DataFrameClustering::setResult(const CacheEntry& entry) {
+    numberOfFoundClusters_.set(entry.numberOfFoundClusters);
+    if (entry.key.method == "minibatch") {
+        centers_ = entry.centers;
+        centerHeaders_ = entry.key.headers;
+    }
+
+    auto newDF = std::make_shared<DataFrame>(*dataFrame_.getData());
+    newDF->addColumnFromBuffer(columnName_.get(),
+                               std::shared_ptr<BufferBase>(entry.labels->clone()));
+    newDataFrame_.setData(newDF);
+}
+
+void DataFrameClustering::clusterNative(CacheKey key) {
+    using Result = std::shared_ptr<CacheEntry>;
+
+    // start from the previous centers if only the data changed
+    std::vector<double> centers;
+    if (key.method == "minibatch" && warmStart_ && key.headers == centerHeaders_) {
+        centers = centers_;
+    }
+
+    auto compute = [dataFrame = dataFrame_.getData(), key = std::move(key),
+                    k = numberOfClusters_.get(), eps = eps_.get(), minPoints = N_.get(),
+                    batchSize = batchSize_.get(),
+                    centers = std::move(centers)](pool::Stop stop,
+                                                  pool::Progress progress) mutable -> Result {
+        const auto onProgress = [&progress](float f) { progress(f); };
+        const auto stopped = [&stop]() { return stop(); };
+
+        const auto features = clustering::robustScaledFeatures(*dataFrame, key.headers);
+        auto labels = [&]() {
+            if (key.method == "dbscan") {
+                return clustering::dbscan(features, eps, minPoints, onProgress, stopped);
+            } else if (key.method == "minibatch") {
+                return clustering::miniBatchKMeans(features, k, centers, batchSize, 100, 1e-3, 0,
+                                                   onProgress, stopped);
+            } else {
+                return clustering::kmeans(features, k, 10, 300, 0, onProgress, stopped);
+            }
+        }();
+        if (stop()) return nullptr;
+
+        auto entry = std::make_shared<CacheEntry>();
+        entry->numberOfFoundClusters = clustering::remapLabels(labels);
+        entry->labels = util::makeBuffer<int>(std::move(labels));
+        entry->centers = std::move(centers);
+        entry->key = std::move(key);
+        return entry;
+    };
+
+    dispatchOne(compute, [this, run = run_](Result result) {
+        // discard results of runs outdated by changes of the columns, the method, or the data
+        if (!result || run != run_) return;
+        addToCache(std::move(*result));
+        setResult(cache_.front());
+        newResults();
     });
 }
 
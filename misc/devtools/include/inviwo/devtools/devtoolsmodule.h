@@ -31,12 +31,19 @@
 #include <inviwo/devtools/devtoolsmoduledefine.h>
 #include <inviwo/core/common/inviwomodule.h>
 
+#include <memory>
+
 namespace inviwo {
 
+class RegressionProfiler;
+
 class IVW_MODULE_DEVTOOLS_API DevToolsModule : public InviwoModule {
 public:
     DevToolsModule(InviwoApplication* app);
-    virtual ~DevToolsModule() = default;
+    virtual ~DevToolsModule();
+
+private:
+    std::unique_ptr<RegressionProfiler> regressionProfiler_;
 };
 
 }  // namespace inviwo
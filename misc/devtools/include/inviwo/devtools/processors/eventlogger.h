@@ -36,6 +36,8 @@
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/boolcompositeproperty.h>
 #include <inviwo/core/properties/buttongroupproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/ports/volumeport.h>
 #include <inviwo/core/ports/meshport.h>
@@ -48,10 +50,12 @@
 #include <inviwo/core/interaction/events/resizeevent.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
 #include <inviwo/core/util/zip.h>
+#include <inviwo/devtools/util/eventtrace.h>
 
 #include <fmt/format.h>
 
 #include <functional>
+#include <memory>
 
 namespace inviwo {
 
@@ -67,6 +71,12 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Enable__ Enable or disable logging of events.
+ *   * __Trace Mode__ Instead of logging each event right away, only record a compact record of
+ *     it in a lock-free ring buffer. The records are formatted and logged in batches on a
+ *     background thread, see EventTrace.
+ *   * __Trace Buffer Size__ Number of records the ring buffer holds, further events are dropped
+ *     until the buffer has been drained.
+ *   * __Flush Trace__ Log all pending records right away.
  */
 
 template <typename Inport, typename Outport>
@@ -95,6 +105,11 @@ private:
     const std::unordered_map<uint64_t, std::reference_wrapper<BoolProperty>> eventMap_;
 
     BoolProperty enableOtherEvents_;
+
+    BoolProperty traceMode_;
+    IntSizeTProperty traceCapacity_;
+    ButtonProperty flushTrace_;
+    std::unique_ptr<EventTrace> trace_;
 };
 
 template <typename Inport, typename Outport>
@@ -132,7 +147,10 @@ EventLogger<Inport, Outport>::EventLogger()
         }
         return map;
     }())
-    , enableOtherEvents_("enableOtherEvents", "Enable Other Events", true) {
+    , enableOtherEvents_("enableOtherEvents", "Enable Other Events", true)
+    , traceMode_("traceMode", "Trace Mode", false)
+    , traceCapacity_("traceCapacity", "Trace Buffer Size", 4096, 64, 1 << 20)
+    , flushTrace_("flushTrace", "Flush Trace") {
 
     addPort(inport_);
     addPort(outport_);
@@ -143,6 +161,19 @@ EventLogger<Inport, Outport>::EventLogger()
         enable_.addProperty(p);
     }
     enable_.addProperty(enableOtherEvents_);
+
+    enable_.addProperty(traceMode_);
+    enable_.addProperty(traceCapacity_);
+    enable_.addProperty(flushTrace_);
+    traceCapacity_.visibilityDependsOn(traceMode_, [](const auto& p) { return p.get(); });
+    flushTrace_.visibilityDependsOn(traceMode_, [](const auto& p) { return p.get(); });
+
+    // Resetting the trace logs its pending records, a new one is created with the next event
+    traceMode_.onChange([this]() { trace_.reset(); });
+    traceCapacity_.onChange([this]() { trace_.reset(); });
+    flushTrace_.onChange([this]() {
+        if (trace_) trace_->flush();
+    });
 }
 
 template <typename Inport, typename Outport>
@@ -157,7 +188,18 @@ void EventLogger<Inport, Outport>::invokeEvent(Event* event) {
     const auto it = eventMap_.find(event->hash());
     if ((it == eventMap_.end() && enableOtherEvents_.get()) ||
         (it != eventMap_.end() && it->second.get())) {
-        LogProcessorInfo(std::setw(15) << getDisplayName() << " " << *event);
+        if (traceMode_) {
+            if (!trace_) {
+                trace_ = std::make_unique<EventTrace>(
+                    traceCapacity_.get(), std::chrono::milliseconds{100},
+                    [name = getDisplayName()](const std::string& records) {
+                        LogInfoCustom(name, "\n" << records);
+                    });
+            }
+            trace_->record(*event);
+        } else {
+            LogProcessorInfo(std::setw(15) << getDisplayName() << " " << *event);
+        }
     }
 }
 
@@ -0,0 +1,98 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/devtools/devtoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/devtools/util/networkprofiler.h>
+#include <modules/fontrendering/properties/fontproperty.h>
+#include <modules/fontrendering/textrenderer.h>
+
+#include <memory>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ProcessorProfiler, Processor Profiler}
+ * ![](org.inviwo.ProcessorProfiler.png?classIdentifier=org.inviwo.ProcessorProfiler)
+ * Profiles all other processors in the network and renders a live timeline. Each row shows one
+ * processor, sorted by the total time spent in process(), with bars for the wall time (top) and
+ * the GPU time measured with timer queries (bottom) of every call within the time window. The
+ * label of a row lists the number of calls, the mean wall and GPU time, the number of
+ * invalidations, and the size of the images, volumes, and meshes on its outports. The recorded
+ * samples can be exported in the Chrome trace event format, see NetworkProfiler.
+ *
+ * ### Outports
+ *   * __outport__ The timeline
+ *
+ * ### Properties
+ *   * __Enable Profiling__ Record samples
+ *   * __GPU Timing__ Measure the GPU time of each processor using timer queries
+ *   * __Max Samples__ Number of samples kept for the timeline and the trace export
+ *   * __Time Window__ Duration shown in the timeline, ending with the most recent sample
+ *   * __Max Rows__ Maximum number of processors shown
+ *   * __Clear__ Remove all samples and statistics
+ *   * __Trace File__ / __Export Chrome Trace__ Write the samples to a JSON trace file
+ */
+class IVW_MODULE_DEVTOOLS_API ProcessorProfiler : public Processor {
+public:
+    ProcessorProfiler();
+    virtual ~ProcessorProfiler() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void exportTrace();
+
+    ImageOutport outport_;
+
+    BoolProperty enable_;
+    BoolProperty gpuTiming_;
+    IntSizeTProperty capacity_;
+    DoubleProperty window_;
+    IntSizeTProperty rows_;
+    FontProperty font_;
+    ButtonProperty clear_;
+    FileProperty traceFile_;
+    ButtonProperty export_;
+
+    TextRenderer textRenderer_;
+    std::unique_ptr<NetworkProfiler> profiler_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,125 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/devtools/devtoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+class Event;
+
+/**
+ * \brief Records events with minimal overhead and formats them on a background thread
+ * Recording an event only copies a compact record, its hash, a timestamp, the normalized
+ * position, and the key or mouse button, into a fixed-size single-producer single-consumer
+ * ring buffer, without locks or allocations. A background thread drains the buffer periodically
+ * and passes the formatted records in batches to a sink, e.g. the log. Records arriving while
+ * the buffer is full are dropped and counted.
+ *
+ * record() must only be called from a single thread, i.e. the thread propagating events.
+ */
+class IVW_MODULE_DEVTOOLS_API EventTrace {
+public:
+    struct Record {
+        uint64_t hash;
+        /// nanoseconds since the trace was started
+        int64_t time;
+        /// normalized position, NaN for events without a position
+        dvec2 position;
+        /// key of keyboard events, button and state of mouse events
+        int32_t detail;
+    };
+
+    using Sink = std::function<void(const std::string&)>;
+
+    /**
+     * @param capacity  number of records the buffer holds, rounded up to a power of two
+     * @param interval  time between draining the buffer
+     * @param sink      receives the formatted records of each drain, one record per line
+     */
+    EventTrace(size_t capacity, std::chrono::milliseconds interval, Sink sink);
+    EventTrace(const EventTrace&) = delete;
+    EventTrace& operator=(const EventTrace&) = delete;
+    /**
+     * Formats the remaining records and stops the background thread
+     */
+    ~EventTrace();
+
+    /**
+     * Records \p event, wait-free.
+     * @return false if the buffer was full and the event was dropped
+     */
+    bool record(const Event& event) noexcept;
+
+    /**
+     * Wakes the background thread to format all pending records right away
+     */
+    void flush();
+
+    size_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    static std::string format(const Record& record);
+
+private:
+    void run();
+    /// Formats all pending records, only called by the background thread
+    void drain();
+
+    const std::chrono::steady_clock::time_point start_;
+    const std::chrono::milliseconds interval_;
+    Sink sink_;
+    std::vector<Record> records_;
+    const size_t mask_;
+
+    /// written by the producer only
+    alignas(64) std::atomic<size_t> head_{0};
+    /// written by the consumer only
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<size_t> dropped_{0};
+    size_t reportedDropped_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool stop_ = false;
+    bool flush_ = false;
+    std::thread worker_;
+};
+
+}  // namespace inviwo
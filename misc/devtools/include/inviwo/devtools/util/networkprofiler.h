@@ -0,0 +1,195 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/devtools/devtoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/network/processornetworkevaluationobserver.h>
+#include <inviwo/core/network/processornetworkobserver.h>
+#include <inviwo/core/processors/processorobserver.h>
+#include <modules/opengl/inviwoopengl.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+class ProcessorNetwork;
+class ProcessorNetworkEvaluator;
+
+/**
+ * \brief Records the cost of every processor in a network
+ * For each call to Processor::process the wall time, the GPU time measured with OpenGL timer
+ * queries, and the number of bytes held by the image, volume, and mesh outports afterwards are
+ * recorded. Invalidations are counted per processor. The most recent samples are kept in a ring
+ * buffer while the per-processor statistics accumulate until clear() is called. The samples can
+ * be exported in the Chrome trace event format, viewable in chrome://tracing or Perfetto.
+ *
+ * All observer callbacks are invoked on the main thread by the network evaluator.
+ */
+class IVW_MODULE_DEVTOOLS_API NetworkProfiler : public ProcessorNetworkObserver,
+                                                public ProcessorNetworkEvaluationObserver,
+                                                public ProcessorObserver {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Sample {
+        std::string processor;
+        /// microseconds since the profiler was created
+        double start;
+        double cpuTime;
+        /// only available once the GPU has finished the commands issued by the processor
+        std::optional<double> gpuTime;
+        size_t outportBytes;
+        size_t evaluation;
+    };
+
+    struct Evaluation {
+        double start;
+        double duration;
+    };
+
+    struct Statistics {
+        std::string processor;
+        size_t count = 0;
+        size_t invalidations = 0;
+        double totalCpuTime = 0.0;
+        double maxCpuTime = 0.0;
+        size_t gpuCount = 0;
+        double totalGpuTime = 0.0;
+        /// bytes on the outports after the most recent and the largest call
+        size_t outportBytes = 0;
+        size_t peakOutportBytes = 0;
+
+        double meanCpuTime() const { return count > 0 ? totalCpuTime / count : 0.0; }
+        double meanGpuTime() const { return gpuCount > 0 ? totalGpuTime / gpuCount : 0.0; }
+    };
+
+    /**
+     * @param network    network to observe, processors added later are observed as well
+     * @param evaluator  evaluator of the network
+     * @param capacity   number of samples to keep
+     * @param ignore     processor to leave out, typically the one displaying the profile
+     */
+    NetworkProfiler(ProcessorNetwork* network, ProcessorNetworkEvaluator* evaluator,
+                    size_t capacity, const Processor* ignore = nullptr);
+    NetworkProfiler(const NetworkProfiler&) = delete;
+    NetworkProfiler& operator=(const NetworkProfiler&) = delete;
+    virtual ~NetworkProfiler();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+    /**
+     * Enables GPU timing, requires the default render context to be available
+     */
+    void setGpuTiming(bool enabled);
+    void setCapacity(size_t capacity);
+    /// Removes all samples and statistics
+    void clear();
+
+    /**
+     * Called at the end of each network evaluation in which a processor was sampled or GPU
+     * timings of earlier samples became available
+     */
+    void setOnEvaluated(std::function<void()> callback);
+
+    const std::deque<Sample>& getSamples() const { return samples_; }
+    const std::deque<Evaluation>& getEvaluations() const { return evaluations_; }
+    /// @return statistics of all sampled processors, sorted by decreasing total wall time
+    std::vector<Statistics> getStatistics() const;
+
+    /**
+     * Writes the samples as Chrome trace events. Wall times are written to one track and GPU
+     * times to another, network evaluations to a third.
+     */
+    void writeChromeTrace(std::ostream& os) const;
+    /**
+     * @throw FileException if \p file could not be opened
+     */
+    void writeChromeTrace(const std::string& file) const;
+
+    // ProcessorNetworkObserver
+    virtual void onProcessorNetworkDidAddProcessor(Processor* processor) override;
+    virtual void onProcessorNetworkWillRemoveProcessor(Processor* processor) override;
+
+    // ProcessorNetworkEvaluationObserver
+    virtual void onProcessorNetworkEvaluationBegin() override;
+    virtual void onProcessorNetworkEvaluationEnd() override;
+
+    // ProcessorObserver
+    virtual void onProcessorInvalidationBegin(Processor* processor) override;
+    virtual void onProcessorAboutToProcess(Processor* processor) override;
+    virtual void onProcessorFinishedProcess(Processor* processor) override;
+
+private:
+    struct PendingQuery {
+        size_t sample;
+        GLuint query;
+    };
+
+    double now() const;
+    /// Reads the results of finished timer queries, @return true if any were finished
+    bool collectQueries();
+    void releaseQueries();
+    Sample* findSample(size_t id);
+
+    ProcessorNetwork* network_;
+    ProcessorNetworkEvaluator* evaluator_;
+    const Processor* ignore_;
+    size_t capacity_;
+    bool enabled_ = true;
+    bool gpuTiming_ = true;
+    std::function<void()> onEvaluated_;
+
+    clock::time_point origin_;
+    std::deque<Sample> samples_;
+    /// id of samples_.front(), ids increase monotonically
+    size_t firstSample_ = 0;
+    std::deque<Evaluation> evaluations_;
+    std::unordered_map<std::string, Statistics> statistics_;
+
+    double evaluationStart_ = 0.0;
+    size_t evaluationCount_ = 0;
+    bool sampled_ = false;
+
+    const Processor* current_ = nullptr;
+    double currentStart_ = 0.0;
+    GLuint activeQuery_ = 0;
+    std::vector<PendingQuery> pendingQueries_;
+    std::vector<GLuint> freeQueries_;
+};
+
+}  // namespace inviwo
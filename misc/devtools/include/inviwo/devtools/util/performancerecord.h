@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/devtools/devtoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/devtools/util/networkprofiler.h>
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * Relative increases tolerated when comparing a PerformanceRecord with its baseline.
+ * Processors faster than minTime in the baseline are not compared, their timings are too noisy.
+ */
+struct IVW_MODULE_DEVTOOLS_API PerformanceThresholds {
+    double time = 0.25;
+    double memory = 0.1;
+    /// milliseconds
+    double minTime = 1.0;
+};
+
+struct IVW_MODULE_DEVTOOLS_API PerformanceRegression {
+    /// empty for the peak memory of the process
+    std::string processor;
+    std::string measure;
+    double baseline;
+    double current;
+
+    std::string toString() const;
+};
+
+/**
+ * \brief Per-processor timings and memory use of a workspace evaluation
+ * Used by the regression runs to compare the cost of a workspace against a stored baseline. The
+ * record is stored as tab separated text, the peak memory of the process on the first line
+ * followed by a header and one line per processor:
+ *
+ *     peak memory    1073741824
+ *     processor      calls    time (ms)    gpu time (ms)    outport bytes
+ *     Raycaster      3        12.500       4.250            8294400
+ *
+ * Times are the means over all calls of Processor::process, the GPU time is written as '-' when
+ * it was not measured. The outport bytes are the largest size of the images, volumes, and meshes
+ * on the outports of the processor.
+ */
+struct IVW_MODULE_DEVTOOLS_API PerformanceRecord {
+    struct Entry {
+        std::string processor;
+        size_t calls = 0;
+        double time = 0.0;
+        std::optional<double> gpuTime;
+        size_t outportBytes = 0;
+    };
+
+    size_t peakMemory = 0;
+    std::vector<Entry> entries;
+
+    static PerformanceRecord create(const std::vector<NetworkProfiler::Statistics>& statistics,
+                                    size_t peakMemory);
+
+    /**
+     * @throw Exception if the record is malformed
+     */
+    static PerformanceRecord read(std::istream& is);
+    /**
+     * @throw FileException if \p file could not be opened
+     * @throw Exception if the record is malformed
+     */
+    static PerformanceRecord read(const std::string& file);
+
+    void write(std::ostream& os) const;
+    /**
+     * @throw FileException if \p file could not be opened
+     */
+    void write(const std::string& file) const;
+
+    const Entry* find(std::string_view processor) const;
+
+    /**
+     * Lists the timings and memory sizes exceeding the ones of \p baseline by more than the
+     * given thresholds. Processors missing from either record are ignored.
+     */
+    std::vector<PerformanceRegression> compare(
+        const PerformanceRecord& baseline, const PerformanceThresholds& thresholds = {}) const;
+};
+
+namespace util {
+
+/**
+ * Peak resident memory of the process in bytes, 0 if not available on the platform
+ */
+IVW_MODULE_DEVTOOLS_API size_t peakProcessMemory();
+
+}  // namespace util
+
+}  // namespace inviwo
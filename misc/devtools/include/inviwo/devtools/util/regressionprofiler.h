@@ -0,0 +1,90 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/devtools/devtoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/network/workspacemanager.h>
+#include <inviwo/devtools/util/networkprofiler.h>
+#include <inviwo/devtools/util/performancerecord.h>
+
+#include <optional>
+#include <string>
+
+namespace inviwo {
+
+class InviwoApplication;
+
+/**
+ * \brief Records the performance of every workspace loaded during a regression run
+ * The processors of each loaded workspace are profiled with a NetworkProfiler. When the
+ * workspace is cleared, i.e. before the next one is loaded or the application closes, a
+ * PerformanceRecord is written to `<output>/<workspace>-performance.tsv` and compared with the
+ * baseline `<workspace>-performance.tsv` stored next to the workspace, if there is one. Each
+ * measure exceeding the thresholds is logged as an error, which fails the regression test.
+ *
+ * The peak memory is the one of the process, so it is only meaningful when each workspace is
+ * loaded by its own process, as in the regression runs.
+ *
+ * The DevToolsModule enables the profiler from the environment, see configFromEnvironment.
+ */
+class IVW_MODULE_DEVTOOLS_API RegressionProfiler {
+public:
+    struct Config {
+        std::string outputDir;
+        PerformanceThresholds thresholds;
+        /// write the records as new baselines next to the workspaces instead of comparing
+        bool updateBaseline = false;
+    };
+
+    /**
+     * Reads the configuration from the environment variables
+     *   * INVIWO_PERFORMANCE_OUTPUT     output directory, the profiler is disabled if not set
+     *   * INVIWO_PERFORMANCE_THRESHOLD  tolerated relative slowdown, defaults to 0.25
+     *   * INVIWO_PERFORMANCE_BASELINE   if set to 1, update the baselines
+     */
+    static std::optional<Config> configFromEnvironment();
+
+    RegressionProfiler(InviwoApplication* app, Config config);
+    RegressionProfiler(const RegressionProfiler&) = delete;
+    RegressionProfiler& operator=(const RegressionProfiler&) = delete;
+    ~RegressionProfiler();
+
+private:
+    void finish();
+
+    Config config_;
+    NetworkProfiler profiler_;
+    std::string workspace_;
+    WorkspaceManager::ClearHandle clearHandle_;
+    WorkspaceManager::DeserializationHandle loadHandle_;
+};
+
+}  // namespace inviwo
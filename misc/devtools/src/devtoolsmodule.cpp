@@ -30,14 +30,23 @@
 #include <inviwo/devtools/devtoolsmodule.h>
 #include <inviwo/devtools/processors/eventlogger.h>
 #include <inviwo/devtools/processors/logrendererprocessors.h>
+#include <inviwo/devtools/processors/processorprofiler.h>
+#include <inviwo/devtools/util/regressionprofiler.h>
 
 namespace inviwo {
 
 DevToolsModule::DevToolsModule(InviwoApplication* app) : InviwoModule(app, "DevTools") {
     registerProcessor<ImageEventLogger>();
     registerProcessor<LogRendererProcessors>();
+    registerProcessor<ProcessorProfiler>();
     registerProcessor<VolumeEventLogger>();
     registerProcessor<MeshEventLogger>();
+
+    if (auto config = RegressionProfiler::configFromEnvironment()) {
+        regressionProfiler_ = std::make_unique<RegressionProfiler>(app, std::move(*config));
+    }
 }
 
+DevToolsModule::~DevToolsModule() = default;
+
 }  // namespace inviwo
@@ -0,0 +1,221 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/devtools/processors/processorprofiler.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/util/colorconversion.h>
+#include <inviwo/core/util/fileextension.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/texture/textureutils.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace {
+
+std::string formatBytes(size_t bytes) {
+    constexpr std::array<const char*, 4> units = {"B", "KB", "MB", "GB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < units.size()) {
+        value /= 1024.0;
+        ++unit;
+    }
+    return fmt::format("{:.1f} {}", value, units[unit]);
+}
+
+vec4 processorColor(const std::string& identifier) {
+    const auto hue = static_cast<float>(std::hash<std::string>{}(identifier) % 360) / 360.0f;
+    return vec4(color::hsv2rgb(vec3(hue, 0.6f, 0.9f)), 1.0f);
+}
+
+}  // namespace
+
+const ProcessorInfo ProcessorProfiler::processorInfo_{
+    "org.inviwo.ProcessorProfiler",  // Class identifier
+    "Processor Profiler",            // Display name
+    "Debugging",                     // Category
+    CodeState::Experimental,         // Code state
+    Tags::GL,                        // Tags
+};
+const ProcessorInfo ProcessorProfiler::getProcessorInfo() const { return processorInfo_; }
+
+ProcessorProfiler::ProcessorProfiler()
+    : Processor()
+    , outport_("outport")
+    , enable_("enable", "Enable Profiling", true)
+    , gpuTiming_("gpuTiming", "GPU Timing", true)
+    , capacity_("capacity", "Max Samples", 10000, 100, 1000000)
+    , window_("window", "Time Window (ms)", 1000.0, 1.0, 60000.0)
+    , rows_("rows", "Max Rows", 20, 1, 100)
+    , font_("font", "Font")
+    , clear_("clear", "Clear")
+    , traceFile_("traceFile", "Trace File", "", "trace")
+    , export_("export", "Export Chrome Trace")
+    , textRenderer_{} {
+
+    addPort(outport_);
+    addProperties(enable_, gpuTiming_, capacity_, window_, rows_, font_, clear_, traceFile_,
+                  export_);
+    font_.anchorPos_.setVisible(false);
+    traceFile_.setAcceptMode(AcceptMode::Save);
+    traceFile_.addNameFilter(FileExtension("json", "Chrome Trace"));
+
+    auto app = InviwoApplication::getPtr();
+    profiler_ = std::make_unique<NetworkProfiler>(
+        app->getProcessorNetwork(), app->getProcessorNetworkEvaluator(), capacity_.get(), this);
+    profiler_->setOnEvaluated([this]() {
+        if (!getNetwork()) return;
+        dispatchFront([network = getNetwork(), id = getIdentifier()]() {
+            auto p = network->getProcessorByIdentifier(id);
+            if (p) p->invalidate(InvalidationLevel::InvalidOutput);
+        });
+    });
+
+    enable_.onChange([this]() { profiler_->setEnabled(enable_); });
+    gpuTiming_.onChange([this]() { profiler_->setGpuTiming(gpuTiming_); });
+    capacity_.onChange([this]() { profiler_->setCapacity(capacity_); });
+    clear_.onChange([this]() {
+        profiler_->clear();
+        invalidate(InvalidationLevel::InvalidOutput);
+    });
+    export_.onChange([this]() { exportTrace(); });
+}
+
+void ProcessorProfiler::process() {
+    utilgl::activateAndClearTarget(outport_, ImageType::ColorDepth);
+    utilgl::DepthFuncState depthFunc(GL_ALWAYS);
+    utilgl::BlendModeState blending(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    const ivec2 dim(outport_.getDimensions());
+    const vec2 invDim = 2.0f / vec2(dim);
+
+    textRenderer_.setFont(font_.getFontFace());
+    textRenderer_.setFontSize(font_.getFontSize());
+    textRenderer_.setLineSpacing(font_.getLineSpacing());
+
+    const int rowHeight = static_cast<int>(textRenderer_.getLineHeight()) + 4;
+    const int labelWidth = dim.x * 2 / 5;
+    const int barWidth = dim.x - labelWidth;
+    const vec4 textColor(1.0f);
+
+    // Top left corner of the text in pixels
+    const auto renderText = [&](const std::string& text, int x, int y) {
+        textRenderer_.render(text, vec2(x, y) * invDim - 1.0f, invDim, textColor);
+    };
+    // Rectangles are drawn by clearing a scissor region
+    vec4 clearColor;
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, &clearColor[0]);
+    const auto fillRect = [&](int x, int y, int width, int height, const vec4& color) {
+        glScissor(x, y, width, height);
+        glClearColor(color.r, color.g, color.b, color.a);
+        glClear(GL_COLOR_BUFFER_BIT);
+    };
+
+    const auto& samples = profiler_->getSamples();
+    const auto statistics = profiler_->getStatistics();
+
+    // The window ends with the most recent sample
+    const double windowLength = window_.get() * 1000.0;
+    const double windowEnd =
+        samples.empty() ? 0.0 : samples.back().start + samples.back().cpuTime;
+    const double windowStart = windowEnd - windowLength;
+    const double scale = barWidth / windowLength;
+
+    renderText(fmt::format("Evaluations: {}  Samples: {}  Window: {:.0f} ms",
+                           profiler_->getEvaluations().size(), samples.size(), window_.get()),
+               2, dim.y - 2);
+
+    const size_t maxRows =
+        std::min(rows_.get(), static_cast<size_t>(std::max(dim.y / rowHeight - 1, 0)));
+    const size_t rowCount = std::min(maxRows, statistics.size());
+    std::unordered_map<std::string, size_t> rowIndex;
+    for (size_t row = 0; row < rowCount; ++row) rowIndex[statistics[row].processor] = row;
+    // Bottom of a row in pixels, the first row is below the header
+    const auto rowBottom = [&](size_t row) {
+        return dim.y - static_cast<int>(row + 2) * rowHeight;
+    };
+
+    {
+        utilgl::GlBoolState scissor(GL_SCISSOR_TEST, true);
+        for (size_t row = 0; row < rowCount; row += 2) {
+            fillRect(0, rowBottom(row), dim.x, rowHeight, vec4(0.15f, 0.15f, 0.15f, 1.0f));
+        }
+        for (const auto& sample : samples) {
+            if (sample.start + sample.cpuTime < windowStart) continue;
+            auto it = rowIndex.find(sample.processor);
+            if (it == rowIndex.end()) continue;
+
+            const int y = rowBottom(it->second);
+            const int x = labelWidth + static_cast<int>((sample.start - windowStart) * scale);
+            const auto color = processorColor(sample.processor);
+            fillRect(x, y + rowHeight / 2, std::max(1, static_cast<int>(sample.cpuTime * scale)),
+                     rowHeight / 2 - 1, color);
+            if (sample.gpuTime) {
+                fillRect(x, y + 1, std::max(1, static_cast<int>(*sample.gpuTime * scale)),
+                         rowHeight / 2 - 1, vec4(vec3(color) * 0.6f, 1.0f));
+            }
+        }
+        glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    }
+
+    for (size_t row = 0; row < rowCount; ++row) {
+        const auto& stats = statistics[row];
+        renderText(fmt::format("{}  {}x  cpu {:.2f} ms  gpu {:.2f} ms  inv {}  {}",
+                               stats.processor, stats.count, stats.meanCpuTime() / 1000.0,
+                               stats.meanGpuTime() / 1000.0, stats.invalidations,
+                               formatBytes(stats.outportBytes)),
+                   2, rowBottom(row) + rowHeight - 2);
+    }
+
+    utilgl::deactivateCurrentTarget();
+}
+
+void ProcessorProfiler::exportTrace() {
+    if (traceFile_.get().empty()) {
+        LogProcessorWarn("No trace file specified");
+        return;
+    }
+    try {
+        profiler_->writeChromeTrace(traceFile_.get());
+        LogProcessorInfo("Wrote " << profiler_->getSamples().size()
+                                  << " samples to: " << traceFile_.get());
+    } catch (const Exception& e) {
+        LogProcessorError(e.getMessage());
+    }
+}
+
+}  // namespace inviwo
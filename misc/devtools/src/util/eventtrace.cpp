@@ -0,0 +1,182 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/devtools/util/eventtrace.h>
+
+#include <inviwo/core/interaction/events/event.h>
+#include <inviwo/core/interaction/events/gestureevent.h>
+#include <inviwo/core/interaction/events/keyboardevent.h>
+#include <inviwo/core/interaction/events/mouseevent.h>
+#include <inviwo/core/interaction/events/pickingevent.h>
+#include <inviwo/core/interaction/events/resizeevent.h>
+#include <inviwo/core/interaction/events/touchevent.h>
+#include <inviwo/core/interaction/events/wheelevent.h>
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace inviwo {
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) result *= 2;
+    return result;
+}
+
+const char* eventName(uint64_t hash) {
+    if (hash == KeyboardEvent::chash()) return "Keyboard";
+    if (hash == MouseEvent::chash()) return "Mouse";
+    if (hash == WheelEvent::chash()) return "Wheel";
+    if (hash == GestureEvent::chash()) return "Gesture";
+    if (hash == TouchEvent::chash()) return "Touch";
+    if (hash == ResizeEvent::chash()) return "Resize";
+    if (hash == PickingEvent::chash()) return "Picking";
+    return nullptr;
+}
+
+}  // namespace
+
+EventTrace::EventTrace(size_t capacity, std::chrono::milliseconds interval, Sink sink)
+    : start_{std::chrono::steady_clock::now()}
+    , interval_{interval}
+    , sink_{std::move(sink)}
+    , records_(roundUpToPowerOfTwo(capacity))
+    , mask_{records_.size() - 1}
+    , worker_{[this]() { run(); }} {}
+
+EventTrace::~EventTrace() {
+    {
+        std::scoped_lock lock{mutex_};
+        stop_ = true;
+    }
+    changed_.notify_one();
+    worker_.join();
+}
+
+bool EventTrace::record(const Event& event) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto& record = records_[head & mask_];
+    record.hash = event.hash();
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start_)
+                      .count();
+    record.position = dvec2{std::numeric_limits<double>::quiet_NaN()};
+    record.detail = 0;
+    if (auto mouse = dynamic_cast<const MouseInteractionEvent*>(&event)) {
+        record.position = mouse->posNormalized();
+        if (auto button = dynamic_cast<const MouseEvent*>(&event)) {
+            record.detail = static_cast<int32_t>(button->button()) |
+                            (static_cast<int32_t>(button->state()) << 16);
+        }
+    } else if (auto touch = dynamic_cast<const TouchEvent*>(&event)) {
+        record.position = touch->centerPointNormalized();
+    } else if (auto key = dynamic_cast<const KeyboardEvent*>(&event)) {
+        record.detail =
+            static_cast<int32_t>(key->key()) | (static_cast<int32_t>(key->state()) << 16);
+    }
+
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void EventTrace::flush() {
+    {
+        std::scoped_lock lock{mutex_};
+        flush_ = true;
+    }
+    changed_.notify_one();
+}
+
+std::string EventTrace::format(const Record& record) {
+    std::stringstream ss;
+    ss << fmt::format("{:12.3f} ms ", static_cast<double>(record.time) / 1.0e6);
+    if (auto name = eventName(record.hash)) {
+        ss << fmt::format("{:<8}", name);
+    } else {
+        ss << fmt::format("{:#018x}", record.hash);
+    }
+    if (!std::isnan(record.position.x)) {
+        ss << fmt::format(" ({:.4f}, {:.4f})", record.position.x, record.position.y);
+    }
+    if (record.hash == MouseEvent::chash()) {
+        ss << " " << static_cast<MouseButton>(record.detail & 0xffff) << " "
+           << static_cast<MouseState>(record.detail >> 16);
+    } else if (record.hash == KeyboardEvent::chash()) {
+        ss << " " << static_cast<IvwKey>(record.detail & 0xffff) << " "
+           << static_cast<KeyState>(record.detail >> 16);
+    }
+    return ss.str();
+}
+
+void EventTrace::run() {
+    std::unique_lock lock{mutex_};
+    while (!stop_) {
+        changed_.wait_for(lock, interval_, [this]() { return stop_ || flush_; });
+        flush_ = false;
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+    lock.unlock();
+    drain();
+}
+
+void EventTrace::drain() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (head == tail && dropped == reportedDropped_) return;
+
+    std::string lines;
+    for (size_t i = tail; i != head; ++i) {
+        if (!lines.empty()) lines += '\n';
+        lines += format(records_[i & mask_]);
+    }
+    tail_.store(head, std::memory_order_release);
+
+    if (dropped != reportedDropped_) {
+        if (!lines.empty()) lines += '\n';
+        lines += fmt::format("{} events dropped, the trace buffer was full",
+                             dropped - reportedDropped_);
+        reportedDropped_ = dropped;
+    }
+    sink_(lines);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,354 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/devtools/util/networkprofiler.h>
+
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/rendercontext.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+namespace inviwo {
+
+namespace {
+
+size_t layerBytes(const Layer* layer) {
+    return layer ? glm::compMul(layer->getDimensions()) * layer->getDataFormat()->getSize() : 0;
+}
+
+/**
+ * Size of the data held by \p outport. Only images, volumes, and meshes are accounted for.
+ */
+size_t outportBytes(const Outport* outport) {
+    if (auto imagePort = dynamic_cast<const ImageOutport*>(outport)) {
+        if (!imagePort->hasData()) return 0;
+        auto image = imagePort->getData();
+        size_t bytes = layerBytes(image->getDepthLayer()) + layerBytes(image->getPickingLayer());
+        for (size_t i = 0; i < image->getNumberOfColorLayers(); ++i) {
+            bytes += layerBytes(image->getColorLayer(i));
+        }
+        return bytes;
+    } else if (auto volumePort = dynamic_cast<const VolumeOutport*>(outport)) {
+        if (!volumePort->hasData()) return 0;
+        auto volume = volumePort->getData();
+        return glm::compMul(volume->getDimensions()) * volume->getDataFormat()->getSize();
+    } else if (auto meshPort = dynamic_cast<const MeshOutport*>(outport)) {
+        if (!meshPort->hasData()) return 0;
+        auto mesh = meshPort->getData();
+        size_t bytes = 0;
+        for (const auto& buffer : mesh->getBuffers()) {
+            bytes += buffer.second->getSize() * buffer.second->getDataFormat()->getSize();
+        }
+        for (const auto& buffer : mesh->getIndexBuffers()) {
+            bytes += buffer.second->getSize() * buffer.second->getDataFormat()->getSize();
+        }
+        return bytes;
+    }
+    return 0;
+}
+
+std::string escapeJson(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    result += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+NetworkProfiler::NetworkProfiler(ProcessorNetwork* network, ProcessorNetworkEvaluator* evaluator,
+                                 size_t capacity, const Processor* ignore)
+    : network_{network}
+    , evaluator_{evaluator}
+    , ignore_{ignore}
+    , capacity_{std::max(capacity, size_t{1})}
+    , origin_{clock::now()} {
+
+    network_->ProcessorNetworkObservable::addObserver(this);
+    evaluator_->addObserver(this);
+    for (auto processor : network_->getProcessors()) {
+        onProcessorNetworkDidAddProcessor(processor);
+    }
+}
+
+NetworkProfiler::~NetworkProfiler() { releaseQueries(); }
+
+void NetworkProfiler::setEnabled(bool enabled) { enabled_ = enabled; }
+
+void NetworkProfiler::setGpuTiming(bool enabled) {
+    if (gpuTiming_ == enabled) return;
+    gpuTiming_ = enabled;
+    if (!gpuTiming_) releaseQueries();
+}
+
+void NetworkProfiler::setCapacity(size_t capacity) {
+    capacity_ = std::max(capacity, size_t{1});
+    while (samples_.size() > capacity_) {
+        samples_.pop_front();
+        ++firstSample_;
+    }
+    while (evaluations_.size() > capacity_) evaluations_.pop_front();
+}
+
+void NetworkProfiler::clear() {
+    firstSample_ += samples_.size();
+    samples_.clear();
+    evaluations_.clear();
+    statistics_.clear();
+}
+
+void NetworkProfiler::setOnEvaluated(std::function<void()> callback) {
+    onEvaluated_ = std::move(callback);
+}
+
+std::vector<NetworkProfiler::Statistics> NetworkProfiler::getStatistics() const {
+    std::vector<Statistics> result;
+    result.reserve(statistics_.size());
+    for (const auto& item : statistics_) result.push_back(item.second);
+    std::sort(result.begin(), result.end(), [](const Statistics& a, const Statistics& b) {
+        return a.totalCpuTime > b.totalCpuTime;
+    });
+    return result;
+}
+
+void NetworkProfiler::writeChromeTrace(std::ostream& os) const {
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, "
+          "\"args\": {\"name\": \"Network\"}},\n";
+    os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, "
+          "\"args\": {\"name\": \"Process\"}},\n";
+    os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 3, "
+          "\"args\": {\"name\": \"GPU\"}}";
+    for (const auto& evaluation : evaluations_) {
+        os << fmt::format(
+            ",\n{{\"name\": \"Evaluation\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+            "\"ts\": {:.3f}, \"dur\": {:.3f}}}",
+            evaluation.start, evaluation.duration);
+    }
+    for (const auto& sample : samples_) {
+        const auto name = escapeJson(sample.processor);
+        os << fmt::format(
+            ",\n{{\"name\": \"{}\", \"cat\": \"process\", \"ph\": \"X\", \"pid\": 1, \"tid\": 2, "
+            "\"ts\": {:.3f}, \"dur\": {:.3f}, \"args\": {{\"outportBytes\": {}, "
+            "\"evaluation\": {}}}}}",
+            name, sample.start, sample.cpuTime, sample.outportBytes, sample.evaluation);
+        // GPU work has no meaningful start time on the CPU clock, it is aligned with process
+        if (sample.gpuTime) {
+            os << fmt::format(
+                ",\n{{\"name\": \"{}\", \"cat\": \"gpu\", \"ph\": \"X\", \"pid\": 1, "
+                "\"tid\": 3, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+                name, sample.start, *sample.gpuTime);
+        }
+    }
+    os << "\n]}\n";
+}
+
+void NetworkProfiler::writeChromeTrace(const std::string& file) const {
+    std::ofstream os(file);
+    if (!os) {
+        throw FileException(fmt::format("Could not open '{}' for writing", file), IVW_CONTEXT);
+    }
+    writeChromeTrace(os);
+}
+
+void NetworkProfiler::onProcessorNetworkDidAddProcessor(Processor* processor) {
+    if (processor != ignore_) processor->ProcessorObservable::addObserver(this);
+}
+
+void NetworkProfiler::onProcessorNetworkWillRemoveProcessor(Processor* processor) {
+    processor->ProcessorObservable::removeObserver(this);
+    if (current_ == processor) current_ = nullptr;
+}
+
+void NetworkProfiler::onProcessorNetworkEvaluationBegin() {
+    if (!enabled_) return;
+    evaluationStart_ = now();
+    sampled_ = false;
+    if (gpuTiming_) RenderContext::getPtr()->activateDefaultRenderContext();
+}
+
+void NetworkProfiler::onProcessorNetworkEvaluationEnd() {
+    if (!enabled_) return;
+    if (activeQuery_ != 0) {
+        // A processor threw, its timing is discarded
+        glEndQuery(GL_TIME_ELAPSED);
+        freeQueries_.push_back(activeQuery_);
+        activeQuery_ = 0;
+    }
+    current_ = nullptr;
+    const bool collected = gpuTiming_ && collectQueries();
+    if (sampled_) {
+        evaluations_.push_back({evaluationStart_, now() - evaluationStart_});
+        while (evaluations_.size() > capacity_) evaluations_.pop_front();
+        ++evaluationCount_;
+    }
+    if ((sampled_ || collected) && onEvaluated_) onEvaluated_();
+}
+
+void NetworkProfiler::onProcessorInvalidationBegin(Processor* processor) {
+    if (!enabled_) return;
+    auto& stats = statistics_[processor->getIdentifier()];
+    stats.processor = processor->getIdentifier();
+    ++stats.invalidations;
+}
+
+void NetworkProfiler::onProcessorAboutToProcess(Processor* processor) {
+    if (!enabled_) return;
+    if (gpuTiming_) {
+        if (activeQuery_ != 0) {
+            // The previous processor threw, its timing is discarded
+            glEndQuery(GL_TIME_ELAPSED);
+            freeQueries_.push_back(activeQuery_);
+        }
+        if (freeQueries_.empty()) {
+            freeQueries_.emplace_back();
+            glGenQueries(1, &freeQueries_.back());
+        }
+        activeQuery_ = freeQueries_.back();
+        freeQueries_.pop_back();
+        glBeginQuery(GL_TIME_ELAPSED, activeQuery_);
+    }
+    current_ = processor;
+    currentStart_ = now();
+}
+
+void NetworkProfiler::onProcessorFinishedProcess(Processor* processor) {
+    if (!enabled_ || current_ != processor) return;
+    const double end = now();
+    current_ = nullptr;
+
+    Sample sample{processor->getIdentifier(), currentStart_, end - currentStart_, std::nullopt,
+                  0, evaluationCount_};
+    for (auto outport : processor->getOutports()) {
+        sample.outportBytes += outportBytes(outport);
+    }
+
+    const size_t id = firstSample_ + samples_.size();
+    if (activeQuery_ != 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pendingQueries_.push_back({id, activeQuery_});
+        activeQuery_ = 0;
+    }
+
+    auto& stats = statistics_[sample.processor];
+    stats.processor = sample.processor;
+    ++stats.count;
+    stats.totalCpuTime += sample.cpuTime;
+    stats.maxCpuTime = std::max(stats.maxCpuTime, sample.cpuTime);
+    stats.outportBytes = sample.outportBytes;
+    stats.peakOutportBytes = std::max(stats.peakOutportBytes, sample.outportBytes);
+
+    samples_.push_back(std::move(sample));
+    while (samples_.size() > capacity_) {
+        samples_.pop_front();
+        ++firstSample_;
+    }
+    sampled_ = true;
+}
+
+double NetworkProfiler::now() const {
+    return std::chrono::duration<double, std::micro>(clock::now() - origin_).count();
+}
+
+bool NetworkProfiler::collectQueries() {
+    auto it = pendingQueries_.begin();
+    for (; it != pendingQueries_.end(); ++it) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(it->query, GL_QUERY_RESULT_AVAILABLE, &available);
+        // Results become available in order, stop at the first pending one
+        if (!available) break;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(it->query, GL_QUERY_RESULT, &elapsed);
+        freeQueries_.push_back(it->query);
+
+        if (auto sample = findSample(it->sample)) {
+            sample->gpuTime = static_cast<double>(elapsed) / 1000.0;
+            auto& stats = statistics_[sample->processor];
+            ++stats.gpuCount;
+            stats.totalGpuTime += *sample->gpuTime;
+        }
+    }
+    const bool collected = it != pendingQueries_.begin();
+    pendingQueries_.erase(pendingQueries_.begin(), it);
+    return collected;
+}
+
+void NetworkProfiler::releaseQueries() {
+    if (activeQuery_ == 0 && pendingQueries_.empty() && freeQueries_.empty()) return;
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    if (activeQuery_ != 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        freeQueries_.push_back(activeQuery_);
+        activeQuery_ = 0;
+    }
+    for (const auto& pending : pendingQueries_) freeQueries_.push_back(pending.query);
+    pendingQueries_.clear();
+    glDeleteQueries(static_cast<GLsizei>(freeQueries_.size()), freeQueries_.data());
+    freeQueries_.clear();
+}
+
+NetworkProfiler::Sample* NetworkProfiler::findSample(size_t id) {
+    if (id < firstSample_ || id - firstSample_ >= samples_.size()) return nullptr;
+    return &samples_[id - firstSample_];
+}
+
+}  // namespace inviwo
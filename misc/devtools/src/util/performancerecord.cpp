@@ -0,0 +1,232 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/devtools/util/performancerecord.h>
+
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace inviwo {
+
+namespace {
+
+constexpr std::string_view peakMemoryKey = "peak memory";
+
+template <typename T>
+T parse(const std::string& str, size_t line) {
+    try {
+        size_t pos = 0;
+        T value;
+        if constexpr (std::is_floating_point_v<T>) {
+            value = static_cast<T>(std::stod(str, &pos));
+        } else {
+            value = static_cast<T>(std::stoull(str, &pos));
+        }
+        if (pos == str.size()) return value;
+    } catch (const std::logic_error&) {
+    }
+    throw Exception(fmt::format("Invalid number '{}' on line {} of performance record", str, line),
+                    IVW_CONTEXT_CUSTOM("PerformanceRecord"));
+}
+
+bool exceeds(double current, double baseline, double threshold) {
+    return current > baseline * (1.0 + threshold);
+}
+
+}  // namespace
+
+std::string PerformanceRegression::toString() const {
+    const auto change = baseline > 0.0 ? 100.0 * (current / baseline - 1.0) : 100.0;
+    if (processor.empty()) {
+        return fmt::format("{} increased by {:.0f}% from {:.0f} to {:.0f}", measure, change,
+                           baseline, current);
+    }
+    return fmt::format("{} of '{}' increased by {:.0f}% from {:.3f} to {:.3f}", measure, processor,
+                       change, baseline, current);
+}
+
+PerformanceRecord PerformanceRecord::create(
+    const std::vector<NetworkProfiler::Statistics>& statistics, size_t peakMemory) {
+    PerformanceRecord record;
+    record.peakMemory = peakMemory;
+    for (const auto& stats : statistics) {
+        if (stats.count == 0) continue;
+        Entry entry;
+        entry.processor = stats.processor;
+        entry.calls = stats.count;
+        entry.time = stats.meanCpuTime() / 1000.0;
+        if (stats.gpuCount > 0) entry.gpuTime = stats.meanGpuTime() / 1000.0;
+        entry.outportBytes = stats.peakOutportBytes;
+        record.entries.push_back(std::move(entry));
+    }
+    // sorted by identifier to keep the diffs of stored baselines small
+    std::sort(record.entries.begin(), record.entries.end(),
+              [](const Entry& a, const Entry& b) { return a.processor < b.processor; });
+    return record;
+}
+
+PerformanceRecord PerformanceRecord::read(std::istream& is) {
+    PerformanceRecord record;
+    std::string line;
+    size_t lineNumber = 0;
+    bool header = false;
+    while (std::getline(is, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        const auto columns = util::splitString(line, '\t');
+        if (lineNumber == 1) {
+            if (columns.size() != 2 || columns[0] != peakMemoryKey) {
+                throw Exception("Performance record does not start with the peak memory",
+                                IVW_CONTEXT_CUSTOM("PerformanceRecord"));
+            }
+            record.peakMemory = parse<size_t>(columns[1], lineNumber);
+        } else if (!header) {
+            header = true;
+        } else {
+            if (columns.size() != 5) {
+                throw Exception(fmt::format("Expected 5 columns on line {} of performance "
+                                            "record, found {}",
+                                            lineNumber, columns.size()),
+                                IVW_CONTEXT_CUSTOM("PerformanceRecord"));
+            }
+            Entry entry;
+            entry.processor = columns[0];
+            entry.calls = parse<size_t>(columns[1], lineNumber);
+            entry.time = parse<double>(columns[2], lineNumber);
+            if (columns[3] != "-") entry.gpuTime = parse<double>(columns[3], lineNumber);
+            entry.outportBytes = parse<size_t>(columns[4], lineNumber);
+            record.entries.push_back(std::move(entry));
+        }
+    }
+    return record;
+}
+
+PerformanceRecord PerformanceRecord::read(const std::string& file) {
+    std::ifstream is(file);
+    if (!is) {
+        throw FileException(fmt::format("Could not open '{}' for reading", file),
+                            IVW_CONTEXT_CUSTOM("PerformanceRecord"));
+    }
+    return read(is);
+}
+
+void PerformanceRecord::write(std::ostream& os) const {
+    os << fmt::format("{}\t{}\n", peakMemoryKey, peakMemory);
+    os << "processor\tcalls\ttime (ms)\tgpu time (ms)\toutport bytes\n";
+    for (const auto& entry : entries) {
+        os << fmt::format("{}\t{}\t{:.3f}\t{}\t{}\n", entry.processor, entry.calls, entry.time,
+                          entry.gpuTime ? fmt::format("{:.3f}", *entry.gpuTime) : "-",
+                          entry.outportBytes);
+    }
+}
+
+void PerformanceRecord::write(const std::string& file) const {
+    std::ofstream os(file);
+    if (!os) {
+        throw FileException(fmt::format("Could not open '{}' for writing", file), IVW_CONTEXT);
+    }
+    write(os);
+}
+
+const PerformanceRecord::Entry* PerformanceRecord::find(std::string_view processor) const {
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&](const Entry& entry) { return entry.processor == processor; });
+    return it != entries.end() ? &*it : nullptr;
+}
+
+std::vector<PerformanceRegression> PerformanceRecord::compare(
+    const PerformanceRecord& baseline, const PerformanceThresholds& thresholds) const {
+    std::vector<PerformanceRegression> result;
+    if (baseline.peakMemory > 0 && exceeds(static_cast<double>(peakMemory),
+                                           static_cast<double>(baseline.peakMemory),
+                                           thresholds.memory)) {
+        result.push_back({"", "Peak memory (bytes)", static_cast<double>(baseline.peakMemory),
+                          static_cast<double>(peakMemory)});
+    }
+    for (const auto& entry : entries) {
+        const auto ref = baseline.find(entry.processor);
+        if (!ref) continue;
+
+        if (ref->time >= thresholds.minTime &&
+            exceeds(entry.time, ref->time, thresholds.time)) {
+            result.push_back({entry.processor, "Time (ms)", ref->time, entry.time});
+        }
+        if (entry.gpuTime && ref->gpuTime && *ref->gpuTime >= thresholds.minTime &&
+            exceeds(*entry.gpuTime, *ref->gpuTime, thresholds.time)) {
+            result.push_back({entry.processor, "GPU time (ms)", *ref->gpuTime, *entry.gpuTime});
+        }
+        if (ref->outportBytes > 0 && exceeds(static_cast<double>(entry.outportBytes),
+                                             static_cast<double>(ref->outportBytes),
+                                             thresholds.memory)) {
+            result.push_back({entry.processor, "Outport bytes",
+                              static_cast<double>(ref->outportBytes),
+                              static_cast<double>(entry.outportBytes)});
+        }
+    }
+    return result;
+}
+
+size_t util::peakProcessMemory() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // reported in kilobytes
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+}  // namespace inviwo
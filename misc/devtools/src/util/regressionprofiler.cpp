@@ -0,0 +1,121 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/devtools/util/regressionprofiler.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/io/serialization/deserializer.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/logcentral.h>
+
+#include <fmt/format.h>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t sampleCapacity = 1024;
+
+std::string recordName(const std::string& workspace) {
+    return filesystem::getFileNameWithoutExtension(workspace) + "-performance.tsv";
+}
+
+}  // namespace
+
+std::optional<RegressionProfiler::Config> RegressionProfiler::configFromEnvironment() {
+    const char* output = std::getenv("INVIWO_PERFORMANCE_OUTPUT");
+    if (!output || std::string_view{output}.empty()) return std::nullopt;
+
+    Config config;
+    config.outputDir = output;
+    if (const char* threshold = std::getenv("INVIWO_PERFORMANCE_THRESHOLD")) {
+        try {
+            config.thresholds.time = std::stod(threshold);
+        } catch (const std::logic_error&) {
+            LogWarnCustom("RegressionProfiler",
+                          "Ignoring invalid INVIWO_PERFORMANCE_THRESHOLD '" << threshold << "'");
+        }
+    }
+    if (const char* baseline = std::getenv("INVIWO_PERFORMANCE_BASELINE")) {
+        config.updateBaseline = std::string_view{baseline} == "1";
+    }
+    return config;
+}
+
+RegressionProfiler::RegressionProfiler(InviwoApplication* app, Config config)
+    : config_{std::move(config)}
+    , profiler_{app->getProcessorNetwork(), app->getProcessorNetworkEvaluator(), sampleCapacity}
+    , clearHandle_{app->getWorkspaceManager()->onClear([this]() { finish(); })}
+    // The network is deserialized, and possibly evaluated, by an earlier callback. The samples
+    // are therefore cleared together with the workspace and not here
+    , loadHandle_{app->getWorkspaceManager()->onLoad(
+          [this](Deserializer& d) { workspace_ = d.getFileName(); })} {
+
+    filesystem::createDirectoryRecursively(config_.outputDir);
+}
+
+RegressionProfiler::~RegressionProfiler() { finish(); }
+
+void RegressionProfiler::finish() {
+    if (workspace_.empty()) {
+        profiler_.clear();
+        return;
+    }
+
+    try {
+        const auto record =
+            PerformanceRecord::create(profiler_.getStatistics(), util::peakProcessMemory());
+        const auto name = recordName(workspace_);
+        const auto baselineFile = filesystem::getFileDirectory(workspace_) + "/" + name;
+        record.write(config_.outputDir + "/" + name);
+
+        if (config_.updateBaseline) {
+            record.write(baselineFile);
+            LogInfo("Updated performance baseline " << baselineFile);
+        } else if (filesystem::fileExists(baselineFile)) {
+            const auto baseline = PerformanceRecord::read(baselineFile);
+            for (const auto& regression : record.compare(baseline, config_.thresholds)) {
+                LogError("Performance regression in "
+                         << filesystem::getFileNameWithExtension(workspace_) << ": "
+                         << regression.toString());
+            }
+        }
+    } catch (const Exception& e) {
+        LogError("Could not record the performance of " << workspace_ << ": " << e.getMessage());
+    }
+
+    workspace_.clear();
+    profiler_.clear();
+}
+
+}  // namespace inviwo
@@ -0,0 +1,111 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/devtools/util/performancerecord.h>
+#include <inviwo/core/util/exception.h>
+
+#include <sstream>
+
+namespace inviwo {
+
+namespace {
+
+PerformanceRecord testRecord() {
+    PerformanceRecord record;
+    record.peakMemory = 1000;
+    record.entries.push_back({"Raycaster", 3, 10.0, 4.0, 800});
+    record.entries.push_back({"Volume Source", 1, 0.5, std::nullopt, 100});
+    return record;
+}
+
+}  // namespace
+
+TEST(PerformanceRecordTests, roundTrip) {
+    const auto record = testRecord();
+    std::stringstream ss;
+    record.write(ss);
+    const auto read = PerformanceRecord::read(ss);
+
+    EXPECT_EQ(record.peakMemory, read.peakMemory);
+    ASSERT_EQ(record.entries.size(), read.entries.size());
+    for (size_t i = 0; i < record.entries.size(); ++i) {
+        EXPECT_EQ(record.entries[i].processor, read.entries[i].processor);
+        EXPECT_EQ(record.entries[i].calls, read.entries[i].calls);
+        EXPECT_DOUBLE_EQ(record.entries[i].time, read.entries[i].time);
+        EXPECT_EQ(record.entries[i].gpuTime, read.entries[i].gpuTime);
+        EXPECT_EQ(record.entries[i].outportBytes, read.entries[i].outportBytes);
+    }
+}
+
+TEST(PerformanceRecordTests, malformed) {
+    std::stringstream missingPeak{"processor\tcalls\n"};
+    EXPECT_THROW(PerformanceRecord::read(missingPeak), Exception);
+
+    std::stringstream badNumber{"peak memory\t10\nheader\nRaycaster\t1\tfast\t-\t0\n"};
+    EXPECT_THROW(PerformanceRecord::read(badNumber), Exception);
+}
+
+TEST(PerformanceRecordTests, compare) {
+    const auto baseline = testRecord();
+    EXPECT_TRUE(baseline.compare(baseline).empty());
+
+    auto current = testRecord();
+    // within the thresholds
+    current.entries[0].time = 12.0;
+    current.peakMemory = 1050;
+    EXPECT_TRUE(current.compare(baseline).empty());
+
+    current.entries[0].time = 13.0;
+    current.entries[0].gpuTime = 6.0;
+    current.entries[0].outportBytes = 1600;
+    current.peakMemory = 2000;
+    // below the minimum time
+    current.entries[1].time = 2.0;
+
+    const auto regressions = current.compare(baseline);
+    ASSERT_EQ(4, regressions.size());
+    EXPECT_TRUE(regressions[0].processor.empty());
+    for (size_t i = 1; i < regressions.size(); ++i) {
+        EXPECT_EQ("Raycaster", regressions[i].processor);
+    }
+    EXPECT_DOUBLE_EQ(10.0, regressions[1].baseline);
+    EXPECT_DOUBLE_EQ(13.0, regressions[1].current);
+
+    PerformanceThresholds loose;
+    loose.time = 1.0;
+    loose.memory = 1.0;
+    EXPECT_TRUE(current.compare(baseline, loose).empty());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,82 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/memorybudget/memorybudgetmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+namespace inviwo {
+
+class DataFormatBase;
+class VolumeRAM;
+
+namespace util {
+
+/**
+ * Calls callback(begin, end) for ranges of the z slices of a volume of size \p dims on the
+ * Inviwo thread pool. The slices are split into about four ranges per pool thread, the same
+ * partitioning as tensorutil::forEachVoxelParallel, and the function returns once all ranges
+ * are done. Runs on the calling thread if the pool is empty. See forEachRangeParallel, it may be
+ * called from pool jobs.
+ */
+IVW_MODULE_MEMORYBUDGET_API void forEachSliceRangeParallel(
+    const size3_t& dims, const std::function<void(size_t, size_t)>& callback);
+
+/**
+ * Allocates an array for a volume of size \p dims and value-initializes it in parallel, slice
+ * range by slice range, see forEachSliceRangeParallel. Operating systems place a page on the
+ * NUMA node of the thread first writing to it, so the pages are spread over the nodes of the
+ * threads later processing the volume with the same partitioning instead of all ending up on
+ * the node of the allocating thread. Intended for trivially constructible voxel types, which
+ * are left uninitialized by the allocation itself.
+ */
+template <typename T>
+std::unique_ptr<T[]> allocateFirstTouch(const size3_t& dims) {
+    const size_t sliceSize = dims.x * dims.y;
+    std::unique_ptr<T[]> data(new T[sliceSize * dims.z]);
+    forEachSliceRangeParallel(dims, [&](size_t begin, size_t end) {
+        std::fill(data.get() + begin * sliceSize, data.get() + end * sliceSize, T{});
+    });
+    return data;
+}
+
+/**
+ * Same as createVolumeRAM but with the data allocated by allocateFirstTouch.
+ */
+IVW_MODULE_MEMORYBUDGET_API std::shared_ptr<VolumeRAM> createVolumeRAMFirstTouch(
+    const size3_t& dims, const DataFormatBase* format);
+
+}  // namespace util
+
+}  // namespace inviwo
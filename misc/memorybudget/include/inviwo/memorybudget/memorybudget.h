@@ -0,0 +1,144 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/memorybudget/memorybudgetmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class MemoryBudget
+ * \brief Memory budget shared by the caches of several readers and sequences
+ *
+ * Caches register with a name, a priority, and an eviction callback, and report their memory
+ * usage through the returned Registration. When a cache reports a usage that makes the total
+ * exceed the budget, the other caches of lower or equal priority are asked to free the excess,
+ * lower priorities first and, within a priority, the least recently used cache first. A cache
+ * can also limit itself to its allowance(), the part of the budget not used by caches of higher
+ * priority.
+ *
+ * The budget is soft: eviction callbacks can decline, e.g. when a cache is busy or all its
+ * entries are in use, and usage reported during an ongoing eviction is only considered by the
+ * next report. All functions are thread safe.
+ */
+class IVW_MODULE_MEMORYBUDGET_API MemoryBudget {
+public:
+    enum class Priority { Low, Normal, High };
+
+    /**
+     * Asked to free at least the given number of bytes, the cache reports its new usage through
+     * Registration::setUsage. The callback is called from the thread reporting a usage, which
+     * might hold the locks of another cache, and must therefore never block on a lock held while
+     * calling setUsage: use try_lock and free nothing if the cache is busy. It is not called
+     * anymore once the Registration has been destroyed.
+     */
+    using Evict = std::function<void(size_t bytes)>;
+
+    struct Usage {
+        std::string name;
+        Priority priority;
+        size_t bytes;
+        size_t hits;
+        size_t misses;
+        // number of times the cache was asked to free memory
+        size_t evictions;
+    };
+
+    class Entry;
+
+    class IVW_MODULE_MEMORYBUDGET_API Registration {
+    public:
+        Registration(MemoryBudget& budget, std::shared_ptr<Entry> entry);
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+        // Removes the cache from the budget, waits for a running eviction callback
+        ~Registration();
+
+        /**
+         * Reports the memory used by the cache in bytes. Evicts from other caches if the total
+         * exceeds the budget.
+         */
+        void setUsage(size_t bytes);
+        /**
+         * The budget minus the usage of the other caches of higher priority.
+         */
+        size_t allowance() const;
+
+        // Counts a lookup for the usage report, also marks the cache as recently used
+        void hit();
+        void miss();
+
+    private:
+        MemoryBudget& budget_;
+        std::shared_ptr<Entry> entry_;
+    };
+
+    static constexpr size_t defaultBudget = size_t{8} << 30;
+
+    explicit MemoryBudget(size_t budget = defaultBudget);
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    /**
+     * The budget used by the caches of all modules, configured in the MemoryBudgetSettings.
+     */
+    static MemoryBudget& global();
+
+    std::unique_ptr<Registration> add(std::string name, Priority priority, Evict evict);
+
+    // Evicts from all caches if the usage exceeds the new budget
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+    // Total usage of all caches in bytes
+    size_t getUsage() const;
+    std::vector<Usage> getUsages() const;
+    // Table of the usages, one line per cache
+    std::string report() const;
+
+private:
+    void evict(const Entry* caller);
+
+    mutable std::mutex mutex_;
+    size_t budget_;
+    size_t usage_ = 0;
+    std::vector<std::shared_ptr<Entry>> entries_;
+    std::atomic<size_t> clock_{0};
+    std::atomic<bool> evicting_{false};
+};
+
+}  // namespace inviwo
@@ -0,0 +1,65 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/memorybudget/firsttouch.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/formatdispatching.h>
+
+namespace inviwo {
+
+namespace {
+
+struct FirstTouchDispatcher {
+    template <typename Result, typename Format>
+    Result operator()(const size3_t& dims) {
+        using T = typename Format::type;
+        auto data = util::allocateFirstTouch<T>(dims);
+        auto ram = std::make_shared<VolumeRAMPrecision<T>>(data.get(), dims);
+        data.release();
+        return ram;
+    }
+};
+
+}  // namespace
+
+void util::forEachSliceRangeParallel(const size3_t& dims,
+                                     const std::function<void(size_t, size_t)>& callback) {
+    if (dims.x * dims.y * dims.z == 0) return;
+    forEachRangeParallel(dims.z, defaultGrainSize(dims.z, 1), callback);
+}
+
+std::shared_ptr<VolumeRAM> util::createVolumeRAMFirstTouch(const size3_t& dims,
+                                                           const DataFormatBase* format) {
+    return dispatching::singleDispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
+        format->getId(), FirstTouchDispatcher{}, dims);
+}
+
+}  // namespace inviwo
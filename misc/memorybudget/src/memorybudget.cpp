@@ -0,0 +1,232 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+const char* priorityName(MemoryBudget::Priority priority) {
+    switch (priority) {
+        case MemoryBudget::Priority::Low:
+            return "low";
+        case MemoryBudget::Priority::High:
+            return "high";
+        case MemoryBudget::Priority::Normal:
+        default:
+            return "normal";
+    }
+}
+
+}  // namespace
+
+class MemoryBudget::Entry {
+public:
+    Entry(std::string aName, Priority aPriority, Evict aEvict)
+        : name{std::move(aName)}, priority{aPriority}, evict{std::move(aEvict)} {}
+
+    const std::string name;
+    const Priority priority;
+    const Evict evict;
+
+    // held while calling evict, which is only called while active
+    std::mutex evictMutex;
+    bool active = true;
+    // thread calling evict, to allow destroying the registration from within the callback
+    std::atomic<std::thread::id> evictThread{};
+
+    // guarded by MemoryBudget::mutex_
+    size_t bytes = 0;
+    size_t evictions = 0;
+
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    std::atomic<size_t> lastUse{0};
+};
+
+MemoryBudget::Registration::Registration(MemoryBudget& budget, std::shared_ptr<Entry> entry)
+    : budget_{budget}, entry_{std::move(entry)} {}
+
+MemoryBudget::Registration::~Registration() {
+    if (entry_->evictThread.load() == std::this_thread::get_id()) {
+        entry_->active = false;
+    } else {
+        std::scoped_lock lock{entry_->evictMutex};
+        entry_->active = false;
+    }
+
+    std::scoped_lock lock{budget_.mutex_};
+    budget_.usage_ -= entry_->bytes;
+    budget_.entries_.erase(std::find(budget_.entries_.begin(), budget_.entries_.end(), entry_));
+}
+
+void MemoryBudget::Registration::setUsage(size_t bytes) {
+    entry_->lastUse = ++budget_.clock_;
+    bool exceeded = false;
+    {
+        std::scoped_lock lock{budget_.mutex_};
+        budget_.usage_ = budget_.usage_ - entry_->bytes + bytes;
+        entry_->bytes = bytes;
+        exceeded = budget_.usage_ > budget_.budget_;
+    }
+    if (exceeded) budget_.evict(entry_.get());
+}
+
+size_t MemoryBudget::Registration::allowance() const {
+    std::scoped_lock lock{budget_.mutex_};
+    size_t used = 0;
+    for (const auto& entry : budget_.entries_) {
+        if (entry->priority > entry_->priority) used += entry->bytes;
+    }
+    return budget_.budget_ > used ? budget_.budget_ - used : 0;
+}
+
+void MemoryBudget::Registration::hit() {
+    ++entry_->hits;
+    entry_->lastUse = ++budget_.clock_;
+}
+
+void MemoryBudget::Registration::miss() {
+    ++entry_->misses;
+    entry_->lastUse = ++budget_.clock_;
+}
+
+MemoryBudget::MemoryBudget(size_t budget) : budget_{budget} {}
+
+MemoryBudget& MemoryBudget::global() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+auto MemoryBudget::add(std::string name, Priority priority, Evict evict)
+    -> std::unique_ptr<Registration> {
+    auto entry = std::make_shared<Entry>(std::move(name), priority, std::move(evict));
+    entry->lastUse = ++clock_;
+    {
+        std::scoped_lock lock{mutex_};
+        entries_.push_back(entry);
+    }
+    return std::make_unique<Registration>(*this, std::move(entry));
+}
+
+void MemoryBudget::setBudget(size_t bytes) {
+    bool exceeded = false;
+    {
+        std::scoped_lock lock{mutex_};
+        budget_ = bytes;
+        exceeded = usage_ > budget_;
+    }
+    if (exceeded) evict(nullptr);
+}
+
+size_t MemoryBudget::getBudget() const {
+    std::scoped_lock lock{mutex_};
+    return budget_;
+}
+
+size_t MemoryBudget::getUsage() const {
+    std::scoped_lock lock{mutex_};
+    return usage_;
+}
+
+auto MemoryBudget::getUsages() const -> std::vector<Usage> {
+    std::scoped_lock lock{mutex_};
+    std::vector<Usage> usages;
+    for (const auto& entry : entries_) {
+        usages.push_back(
+            {entry->name, entry->priority, entry->bytes, entry->hits, entry->misses,
+             entry->evictions});
+    }
+    return usages;
+}
+
+std::string MemoryBudget::report() const {
+    const auto usages = getUsages();
+    const auto toMB = [](size_t bytes) { return static_cast<double>(bytes) / (1 << 20); };
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << "Memory budget: " << toMB(getUsage()) << " of "
+       << toMB(getBudget()) << " MB used by " << usages.size() << " caches";
+    for (const auto& usage : usages) {
+        const auto lookups = usage.hits + usage.misses;
+        ss << "\n  " << usage.name << " (" << priorityName(usage.priority)
+           << " priority): " << toMB(usage.bytes) << " MB, "
+           << (lookups > 0 ? 100.0 * usage.hits / lookups : 0.0) << "% hits of " << lookups
+           << " lookups, asked to evict " << usage.evictions << " times";
+    }
+    return ss.str();
+}
+
+void MemoryBudget::evict(const Entry* caller) {
+    // A single thread evicts at a time, a report during the eviction is picked up by its loop
+    if (evicting_.exchange(true)) return;
+
+    std::vector<std::shared_ptr<Entry>> asked;
+    while (true) {
+        std::shared_ptr<Entry> victim;
+        size_t excess = 0;
+        {
+            std::scoped_lock lock{mutex_};
+            if (usage_ <= budget_) break;
+            excess = usage_ - budget_;
+
+            for (const auto& entry : entries_) {
+                if (entry.get() == caller || entry->bytes == 0 ||
+                    (caller && entry->priority > caller->priority) ||
+                    std::find(asked.begin(), asked.end(), entry) != asked.end()) {
+                    continue;
+                }
+                if (!victim || entry->priority < victim->priority ||
+                    (entry->priority == victim->priority && entry->lastUse < victim->lastUse)) {
+                    victim = entry;
+                }
+            }
+            if (!victim) break;
+            ++victim->evictions;
+        }
+        asked.push_back(victim);
+
+        std::scoped_lock lock{victim->evictMutex};
+        if (victim->active && victim->evict) {
+            victim->evictThread = std::this_thread::get_id();
+            victim->evict(excess);
+            victim->evictThread = std::thread::id{};
+        }
+    }
+
+    evicting_ = false;
+}
+
+}  // namespace inviwo
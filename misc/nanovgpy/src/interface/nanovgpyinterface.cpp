@@ -30,10 +30,89 @@
 #include <inviwo/nanovgpy/interface/nanovgpyinterface.h>
 #include <inviwo/nanovgutils/nanovgutils.h>
 
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <fmt/format.h>
+
+#include <optional>
+
 namespace py = pybind11;
 
 namespace inviwo {
 namespace nanopy {
+
+namespace {
+
+template <typename T>
+using CArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Converts an array of shape (N, D) or, if allowSingle is set, (D,)
+CArray<float> ensureRows(py::handle obj, const char* name, py::ssize_t d, bool allowSingle) {
+    auto array = CArray<float>::ensure(obj);
+    if (!array || !((array.ndim() == 2 && array.shape(1) == d) ||
+                    (allowSingle && array.ndim() == 1 && array.shape(0) == d))) {
+        throw py::value_error(fmt::format("{} should be an array of shape (N, {}){}", name, d,
+                                          allowSingle ? fmt::format(" or ({},)", d) : ""));
+    }
+    return array;
+}
+
+std::vector<vec2> toPoints(const CArray<float>& array) {
+    const auto a = array.unchecked<2>();
+    std::vector<vec2> points(static_cast<size_t>(a.shape(0)));
+    for (py::ssize_t i = 0; i < a.shape(0); ++i) points[i] = vec2{a(i, 0), a(i, 1)};
+    return points;
+}
+
+// Draws filled circles at positions, radii is a scalar or has one value per circle, and colors is
+// a single color, one color per circle, or None to use the current fill style.
+void circles(NanoVGContext& nvg, py::handle positions, py::handle radii, py::handle colors) {
+    const auto pos = ensureRows(positions, "positions", 2, false).unchecked<2>();
+    const auto n = pos.shape(0);
+
+    auto r = CArray<float>::ensure(radii);
+    if (!r || !(r.ndim() == 0 || (r.ndim() == 1 && (r.shape(0) == 1 || r.shape(0) == n)))) {
+        throw py::value_error("radii should be a scalar or an array of shape (N,)");
+    }
+    const auto radius = [&, data = r.data(), many = r.ndim() == 1 && r.shape(0) == n](
+                            py::ssize_t i) { return many ? data[i] : data[0]; };
+
+    std::optional<CArray<float>> c;
+    if (!colors.is_none()) c = ensureRows(colors, "colors", 4, true);
+    if (c && c->ndim() == 2 && c->shape(0) != n) {
+        throw py::value_error("colors should have one row per position");
+    }
+
+    if (!c || c->ndim() == 1) {
+        // A single fill style, draw all circles as one path and fill them at once
+        if (c) nvg.fillColor(vec4{c->at(0), c->at(1), c->at(2), c->at(3)});
+        nvg.beginPath();
+        for (py::ssize_t i = 0; i < n; ++i) nvg.circle(vec2{pos(i, 0), pos(i, 1)}, radius(i));
+        nvg.fill();
+    } else {
+        const auto col = c->unchecked<2>();
+        for (py::ssize_t i = 0; i < n; ++i) {
+            nvg.beginPath();
+            nvg.circle(vec2{pos(i, 0), pos(i, 1)}, radius(i));
+            nvg.fillColor(vec4{col(i, 0), col(i, 1), col(i, 2), col(i, 3)});
+            nvg.fill();
+        }
+    }
+}
+
+// Strokes a line through points with the current stroke style
+void polyline(NanoVGContext& nvg, py::handle points, bool closed) {
+    const auto p = ensureRows(points, "points", 2, false).unchecked<2>();
+    if (p.shape(0) < 2) return;
+    nvg.beginPath();
+    nvg.moveTo(vec2{p(0, 0), p(0, 1)});
+    for (py::ssize_t i = 1; i < p.shape(0); ++i) nvg.lineTo(vec2{p(i, 0), p(i, 1)});
+    if (closed) nvg.closePath();
+    nvg.stroke();
+}
+
+}  // namespace
 void init(py::module ivwmodule, InviwoApplication* app) {
     auto m = ivwmodule.def_submodule("nvg", "NanoVG Python Interface");
     m.def(
@@ -170,6 +249,31 @@ void init(py::module ivwmodule, InviwoApplication* app) {
     nanoVGContext.def("skewX", &NanoVGContext::skewX, py::arg("kx"));
     nanoVGContext.def("skewY", &NanoVGContext::skewY, py::arg("ky"));
 
+    nanoVGContext.def(
+        "circles",
+        [](NanoVGContext& self, py::handle positions, py::handle radii, py::handle colors) {
+            circles(self, positions, radii, colors);
+        },
+        py::arg("positions"), py::arg("radii"), py::arg("colors") = py::none(),
+        "Draws filled circles. positions has shape (N, 2), radii is a scalar or has shape (N,) "
+        "and colors has shape (4,), shape (N, 4) or is None to use the current fill style.");
+    nanoVGContext.def(
+        "polyline",
+        [](NanoVGContext& self, py::handle points, bool closed) { polyline(self, points, closed); },
+        py::arg("points"), py::arg("closed") = false,
+        "Strokes a line through points of shape (N, 2) using the current stroke style.");
+    nanoVGContext.def(
+        "text_batch",
+        [](NanoVGContext& self, py::handle positions, const std::vector<std::string>& labels) {
+            self.texts(toPoints(ensureRows(positions, "positions", 2, false)), labels);
+        },
+        py::arg("positions"), py::arg("labels"),
+        "Draws labels[i] at positions[i] with the current text style, positions has shape "
+        "(N, 2). Labels outside of the frame are skipped.");
+    nanoVGContext.def("cachedTextBounds", &NanoVGContext::cachedTextBounds, py::arg("position"),
+                      py::arg("string"));
+    nanoVGContext.def("clearTextCache", &NanoVGContext::clearTextCache);
+
     nanoVGContext.def("arrow", &nanovgutil::arrow, py::arg("from"), py::arg("to"),
                       py::arg("width") = 30, py::arg("headSize") = 30, py::arg("normalize") = true);
 }
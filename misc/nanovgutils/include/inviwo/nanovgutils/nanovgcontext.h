@@ -35,6 +35,10 @@
 
 #include <GL/glew.h>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <warn/push>
 #include <warn/ignore/all>
 #include <nanovg.h>
@@ -112,6 +116,7 @@ public:
     void cancel();
     // Returns the currently active NanoVG context
     const NVGcontext* getContext() const;
+    NVGcontext* getContext();
 
     /**********************************************************************************************
      * NanoVG states
@@ -241,6 +246,15 @@ public:
     // if the bounding box of the text should be returned. The bounds value are [xmin,ymin,
     // xmax,ymax] Measured values are returned in local coordinate space.
     vec4 textBoxBounds(const ivec2& position, float textBoxWidth, const std::string& text);
+    // Same as textBounds, but the text is only measured the first time a combination of text, font,
+    // font size and alignment is seen. Later calls only offset the cached bounds by position.
+    vec4 cachedTextBounds(const vec2& position, const std::string& text);
+    // Draws many text labels with the current text style in one call, labels[i] at positions[i].
+    // The labels are measured through the text cache and labels that fall outside of the frame,
+    // given the current transform, are skipped without being laid out.
+    void texts(const std::vector<vec2>& positions, const std::vector<std::string>& labels);
+    // Drops all measurements of the text cache.
+    void clearTextCache();
     // Finds a loaded font of specified name, and returns handle to it, or -1 if the font is not
     // found.
 
@@ -286,6 +300,13 @@ public:
     NVGpaint radialGradient(const vec2& center, float innerRadius, float outerRadius,
                             const vec4& startColor, const vec4& endColor);
 
+    // Creates and returns an image pattern. Parameter origin specifies the left-top location of the
+    // image pattern, dimensions the size of one image, angle the rotation around the top-left
+    // corner, image is handle to the image to render. The pattern is transformed by the current
+    // transform when it is passed to fillPaint() or strokePaint().
+    NVGpaint imagePattern(const vec2& origin, const vec2& dimensions, float angle, int image,
+                          float alpha);
+
     /**********************************************************************************************
      * NanoVG transformations
      **********************************************************************************************/
@@ -312,7 +333,26 @@ public:
     void skewY(float ky);
 
 private:
+    // The parts of the NanoVG text state that affect text layout, tracked to key the text cache
+    struct TextStyle {
+        int font = -1;
+        float size = 16.0f;
+        int align = NVG_ALIGN_LEFT | NVG_ALIGN_BASELINE;
+    };
+    struct TextKey {
+        std::string text;
+        TextStyle style;
+        bool operator==(const TextKey& rhs) const;
+    };
+    struct TextKeyHash {
+        size_t operator()(const TextKey& key) const;
+    };
+    static constexpr size_t maxCachedTexts = 1 << 16;
+
     NVGcontext* activeNanoVGContext_;
+    vec2 frameSize_{0.0f};
+    std::vector<TextStyle> textStyles_{TextStyle{}};  // Mirrors the NanoVG state stack
+    std::unordered_map<TextKey, vec4, TextKeyHash> textCache_;
 
 };  // NVG
 
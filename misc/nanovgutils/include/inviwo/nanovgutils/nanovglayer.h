@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/nanovgutils/nanovgutilsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/nanovgutils/nanovgcontext.h>
+
+#include <functional>
+
+struct NVGLUframebuffer;
+
+namespace inviwo {
+
+/**
+ * \brief Retained mode drawing on top of NanoVGContext
+ * The content of a layer is drawn once into an offscreen framebuffer owned by the layer and then
+ * composited with draw() using the current transform of the context. The paths and glyphs of the
+ * content are only tessellated again when the layer has been invalidated or its size changed, so
+ * static overlays cost a single textured rectangle per frame.
+ *
+ * Since the content is rasterized, transforms that scale the layer up will blur it. Make the layer
+ * as large as it will be drawn instead.
+ *
+ * \code{.cpp}
+ * layer.update(dimensions, [&](NanoVGContext& nvg) { drawManyLabels(nvg); });
+ * utilgl::activateAndClearTarget(outport_);
+ * nvg.activate(dimensions);
+ * nvg.translate(offset.x, offset.y);
+ * layer.draw();
+ * nvg.deactivate();
+ * \endcode
+ *
+ * Layers holding picking colors have to use Sampling::Nearest, and be drawn unscaled at whole
+ * pixel positions with anti-aliasing disabled, so that no ids are blended.
+ */
+class IVW_MODULE_NANOVGUTILS_API NanoVGLayer {
+public:
+    enum class Sampling { Linear, Nearest };
+
+    explicit NanoVGLayer(NanoVGContext& context, Sampling sampling = Sampling::Linear);
+    NanoVGLayer(const NanoVGLayer&) = delete;
+    NanoVGLayer(NanoVGLayer&&) = delete;
+    NanoVGLayer& operator=(const NanoVGLayer&) = delete;
+    NanoVGLayer& operator=(NanoVGLayer&&) = delete;
+    ~NanoVGLayer();
+
+    // Marks the content as changed, it will be drawn again by the next call to update().
+    void invalidate();
+    bool isValid() const;
+
+    // Draws the content into the layer by calling drawContent with an activated context, if the
+    // layer was invalidated or dimensions or pixelRatio changed. Has to be called outside of
+    // NanoVGContext::activate() / deactivate() since it renders a frame of its own. The bound
+    // framebuffer and the viewport are restored afterwards.
+    // Returns true if the content was drawn.
+    bool update(const size2_t& dimensions, const std::function<void(NanoVGContext&)>& drawContent,
+                float pixelRatio = 1.f);
+
+    // Draws the cached content as a rectangle of the layer's dimensions at position, transformed by
+    // the current transform of the context. Has to be called between NanoVGContext::activate() and
+    // deactivate().
+    void draw(const vec2& position = vec2{0.0f}, float alpha = 1.0f);
+
+    const size2_t& getDimensions() const;
+
+private:
+    NanoVGContext& context_;
+    Sampling sampling_;
+    NVGLUframebuffer* framebuffer_ = nullptr;
+    size2_t dimensions_{0};
+    float pixelRatio_ = 1.f;
+    bool valid_ = false;
+};
+
+}  // namespace inviwo
@@ -35,18 +35,25 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/nanovgutils/properties/nanovgfontproperty.h>
+#include <inviwo/nanovgutils/nanovglayer.h>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.NanoVGExampleProcessor, Nano VGExample Processor}
  * ![](org.inviwo.NanoVGExampleProcessor.png?classIdentifier=org.inviwo.NanoVGExampleProcessor)
  *
- * A processors that demos how to render using NanoVG together with Inviwos picking
+ * A processors that demos how to render using NanoVG together with Inviwos picking. The shapes
+ * and text are drawn once into a NanoVGLayer and only redrawn when the font or the size of the
+ * outport changes, moving them only updates the transform.
  *
  *
  * ### Outports
  *   * __outport__ Image rendered with picking using NanoVG.
  *
+ * ### Properties
+ *   * __Font settings__ Font used for the text.
+ *   * __Offset__ Translation of the drawn content in pixels.
+ *
  */
 class IVW_MODULE_NANOVGUTILS_API NanoVGExampleProcessor : public Processor {
 public:
@@ -61,6 +68,8 @@ public:
 private:
     ImageOutport outport_;
     NanoVGFontProperty fontProperty_;
+    FloatVec2Property offset_;
+    NanoVGLayer layer_;
 };
 
 }  // namespace inviwo
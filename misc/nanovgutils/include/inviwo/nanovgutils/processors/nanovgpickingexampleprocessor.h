@@ -35,17 +35,33 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/interaction/pickingmapper.h>
+#include <inviwo/nanovgutils/nanovglayer.h>
+
+#include <optional>
+#include <vector>
 
 namespace inviwo {
 
+class NanoVGContext;
+
 /** \docpage{org.inviwo.NanoVGPickingExampleProcessor, Nano VGPicking Example Processor}
  * ![](org.inviwo.NanoVGPickingExampleProcessor.png?classIdentifier=org.inviwo.NanoVGPickingExampleProcessor)
  *
- * A processors that demos how to render using NanoVG
+ * A processors that demos how to render using NanoVG together with Inviwos picking, for many
+ * items. Randomly placed markers are drawn once into a NanoVGLayer with their colors and once,
+ * without anti-aliasing, into a second layer with their picking colors. Both layers are only
+ * redrawn when the markers or the size of the outport change. Each frame composites the layers
+ * into the color and picking attachments, so finding the hovered marker is a single texel read
+ * of the picking buffer regardless of the number of markers.
  *
  *
  * ### Outports
- *   * __outport__ Image rendered using NanoVG.
+ *   * __outport__ Image rendered with picking using NanoVG.
+ *
+ * ### Properties
+ *   * __Markers__ Number of markers.
+ *   * __Radius__ Radius of the markers in pixels.
+ *   * __Seed__ Seed of the random marker positions and colors.
  *
  */
 class IVW_MODULE_NANOVGUTILS_API NanoVGPickingExampleProcessor : public Processor {
@@ -59,13 +75,26 @@ public:
     static const ProcessorInfo processorInfo_;
 
 private:
-    ImageOutport outport_;
-
-    PickingMapper picking_;
+    struct Marker {
+        vec2 position;  // in [0 1], relative to the outport size
+        vec4 color;
+    };
 
-    void draw(bool picking);
+    void createMarkers();
+    void draw(NanoVGContext& nvg, bool picking) const;
 
     void onItemPicked(PickingEvent* pe);
+
+    ImageOutport outport_;
+    IntSizeTProperty numMarkers_;
+    FloatProperty radius_;
+    IntProperty seed_;
+
+    PickingMapper picking_;
+    std::vector<Marker> markers_;
+    std::optional<size_t> hovered_;
+    NanoVGLayer colorLayer_;
+    NanoVGLayer pickingLayer_;
 };
 
 }  // namespace inviwo
@@ -30,11 +30,15 @@
 #include <inviwo/nanovgutils/nanovgcontext.h>
 
 #include <inviwo/nanovgutils/nanovgutils.h>
+#include <inviwo/core/util/hashcombine.h>
+
+#include <algorithm>
 
 #include <warn/push>
 #include <warn/ignore/all>
 #include <nanovg.h>
 #include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
 #include <warn/pop>
 
 namespace inviwo {
@@ -49,14 +53,17 @@ NanoVGContext::~NanoVGContext() { nvgDeleteGL3(activeNanoVGContext_); }
 
 const NVGcontext* NanoVGContext::getContext() const { return activeNanoVGContext_; }
 
+NVGcontext* NanoVGContext::getContext() { return activeNanoVGContext_; }
+
 void NanoVGContext::activate(int windowWidth, int windowHeight, float pixelRatio) {
     nvgBeginFrame(activeNanoVGContext_, static_cast<float>(windowWidth),
                   static_cast<float>(windowHeight), pixelRatio);
+    frameSize_ = vec2{static_cast<float>(windowWidth), static_cast<float>(windowHeight)};
+    textStyles_.assign(1, TextStyle{});
 }
 
 void NanoVGContext::activate(const size2_t& dimensions, float pixelRatio) {
-    nvgBeginFrame(activeNanoVGContext_, static_cast<float>(dimensions.x),
-                  static_cast<float>(dimensions.y), pixelRatio);
+    activate(static_cast<int>(dimensions.x), static_cast<int>(dimensions.y), pixelRatio);
 }
 
 void NanoVGContext::deactivate() { nvgEndFrame(activeNanoVGContext_); }
@@ -71,11 +78,20 @@ void NanoVGContext::lineTo(const vec2& coordinates) {
     nvgLineTo(activeNanoVGContext_, coordinates.x, coordinates.y);
 }
 
-void NanoVGContext::save() { nvgSave(activeNanoVGContext_); }
+void NanoVGContext::save() {
+    nvgSave(activeNanoVGContext_);
+    textStyles_.push_back(textStyles_.back());
+}
 
-void NanoVGContext::restore() { nvgRestore(activeNanoVGContext_); }
+void NanoVGContext::restore() {
+    nvgRestore(activeNanoVGContext_);
+    if (textStyles_.size() > 1) textStyles_.pop_back();
+}
 
-void NanoVGContext::reset() { nvgReset(activeNanoVGContext_); }
+void NanoVGContext::reset() {
+    nvgReset(activeNanoVGContext_);
+    textStyles_.back() = TextStyle{};
+}
 
 void NanoVGContext::shapeAntiAlias(bool enabled) {
     nvgShapeAntiAlias(activeNanoVGContext_, enabled);
@@ -125,10 +141,14 @@ void NanoVGContext::strokePaint(const NVGpaint& paint) {
 
 void NanoVGContext::fillPaint(const NVGpaint& paint) { nvgFillPaint(activeNanoVGContext_, paint); }
 
-void NanoVGContext::fontSize(float size) { nvgFontSize(activeNanoVGContext_, size); }
+void NanoVGContext::fontSize(float size) {
+    nvgFontSize(activeNanoVGContext_, size);
+    textStyles_.back().size = size;
+}
 
 void NanoVGContext::fontFace(const std::string& name) {
     nvgFontFace(activeNanoVGContext_, name.c_str());
+    textStyles_.back().font = nvgFindFont(activeNanoVGContext_, name.c_str());
 }
 
 // Horizontal align
@@ -140,12 +160,13 @@ void NanoVGContext::fontFace(const std::string& name) {
 // NVG_ALIGN_MIDDLE = 1 << 4,	// Align text vertically to middle.
 // NVG_ALIGN_BOTTOM = 1 << 5,	// Align text vertically to bottom.
 // NVG_ALIGN_BASELINE = 1 << 6, // Default, align text vertically to baseline.
-void NanoVGContext::textAlign(const int flags) { nvgTextAlign(activeNanoVGContext_, flags); }
-
-void NanoVGContext::textAlign(const Alignment flags) {
-    nvgTextAlign(activeNanoVGContext_, static_cast<int>(flags));
+void NanoVGContext::textAlign(const int flags) {
+    nvgTextAlign(activeNanoVGContext_, flags);
+    textStyles_.back().align = flags;
 }
 
+void NanoVGContext::textAlign(const Alignment flags) { textAlign(static_cast<int>(flags)); }
+
 void NanoVGContext::fontBlur(float blur) { nvgFontBlur(activeNanoVGContext_, blur); }
 
 void NanoVGContext::text(const ivec2& coordinates, const std::string& text, size_t text_cutoff) {
@@ -198,6 +219,63 @@ vec4 NanoVGContext::textBoxBounds(const ivec2& position, float textBoxWidth,
     return vec4(bounds[0], bounds[1], bounds[2], bounds[3]);
 }
 
+bool NanoVGContext::TextKey::operator==(const TextKey& rhs) const {
+    return text == rhs.text && style.font == rhs.style.font && style.size == rhs.style.size &&
+           style.align == rhs.style.align;
+}
+
+size_t NanoVGContext::TextKeyHash::operator()(const TextKey& key) const {
+    size_t seed = std::hash<std::string>{}(key.text);
+    util::hash_combine(seed, key.style.font);
+    util::hash_combine(seed, key.style.size);
+    util::hash_combine(seed, key.style.align);
+    return seed;
+}
+
+vec4 NanoVGContext::cachedTextBounds(const vec2& position, const std::string& text) {
+    TextKey key{text, textStyles_.back()};
+    auto it = textCache_.find(key);
+    if (it == textCache_.end()) {
+        if (textCache_.size() >= maxCachedTexts) textCache_.clear();
+        float bounds[4];
+        nvgTextBounds(activeNanoVGContext_, 0.0f, 0.0f, text.c_str(), text.c_str() + text.size(),
+                      bounds);
+        it = textCache_.emplace(std::move(key), vec4{bounds[0], bounds[1], bounds[2], bounds[3]})
+                 .first;
+    }
+    return it->second + vec4{position, position};
+}
+
+void NanoVGContext::texts(const std::vector<vec2>& positions,
+                          const std::vector<std::string>& labels) {
+    // Current transform as [a b c d e f], mapping (x, y) to (a*x + c*y + e, b*x + d*y + f)
+    float t[6];
+    nvgCurrentTransform(activeNanoVGContext_, t);
+    const auto toFrame = [&](float x, float y) {
+        return vec2{t[0] * x + t[2] * y + t[4], t[1] * x + t[3] * y + t[5]};
+    };
+
+    const auto count = std::min(positions.size(), labels.size());
+    for (size_t i = 0; i < count; ++i) {
+        const auto& label = labels[i];
+        const auto b = cachedTextBounds(positions[i], label);
+        const auto p0 = toFrame(b.x, b.y);
+        const auto p1 = toFrame(b.z, b.y);
+        const auto p2 = toFrame(b.x, b.w);
+        const auto p3 = toFrame(b.z, b.w);
+        const auto lower = glm::min(glm::min(p0, p1), glm::min(p2, p3));
+        const auto upper = glm::max(glm::max(p0, p1), glm::max(p2, p3));
+        if (glm::any(glm::lessThan(upper, vec2{0.0f})) ||
+            glm::any(glm::greaterThan(lower, frameSize_))) {
+            continue;
+        }
+        nvgText(activeNanoVGContext_, positions[i].x, positions[i].y, label.c_str(),
+                label.c_str() + label.size());
+    }
+}
+
+void NanoVGContext::clearTextCache() { textCache_.clear(); }
+
 vec3 NanoVGContext::textMetrics() {
     vec3 res;
     nvgTextMetrics(activeNanoVGContext_, &res.x, &res.y, &res.z);
@@ -254,6 +332,12 @@ NVGpaint NanoVGContext::radialGradient(const vec2& center, const float innerRadi
                              glm2nanovg(startColor), glm2nanovg(endColor));
 }
 
+NVGpaint NanoVGContext::imagePattern(const vec2& origin, const vec2& dimensions, float angle,
+                                     int image, float alpha) {
+    return nvgImagePattern(activeNanoVGContext_, origin.x, origin.y, dimensions.x, dimensions.y,
+                           angle, image, alpha);
+}
+
 void NanoVGContext::lineCap(const LineCapMode mode) {
     nvgLineCap(activeNanoVGContext_, static_cast<int>(mode));
 }
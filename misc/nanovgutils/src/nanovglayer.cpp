@@ -0,0 +1,121 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/nanovgutils/nanovglayer.h>
+
+#include <inviwo/core/util/rendercontext.h>
+
+// Only the declarations are needed here, the implementation is part of nanovgcontext.cpp
+#ifdef NANOVG_GL3_IMPLEMENTATION
+#undef NANOVG_GL3_IMPLEMENTATION
+#endif
+#ifndef NANOVG_GL3
+#define NANOVG_GL3 1
+#endif
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <nanovg.h>
+#include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
+#include <warn/pop>
+
+namespace inviwo {
+
+NanoVGLayer::NanoVGLayer(NanoVGContext& context, Sampling sampling)
+    : context_{context}, sampling_{sampling} {}
+
+NanoVGLayer::~NanoVGLayer() {
+    if (framebuffer_) {
+        RenderContext::getPtr()->activateDefaultRenderContext();
+        nvgluDeleteFramebuffer(framebuffer_);
+    }
+}
+
+void NanoVGLayer::invalidate() { valid_ = false; }
+
+bool NanoVGLayer::isValid() const { return valid_; }
+
+const size2_t& NanoVGLayer::getDimensions() const { return dimensions_; }
+
+bool NanoVGLayer::update(const size2_t& dimensions,
+                         const std::function<void(NanoVGContext&)>& drawContent,
+                         float pixelRatio) {
+    if (valid_ && dimensions == dimensions_ && pixelRatio == pixelRatio_) return false;
+    if (dimensions.x == 0 || dimensions.y == 0) return false;
+
+    const ivec2 size{vec2{dimensions} * pixelRatio};
+    if (!framebuffer_ || dimensions != dimensions_ || pixelRatio != pixelRatio_) {
+        if (framebuffer_) nvgluDeleteFramebuffer(framebuffer_);
+        // The content is rendered with premultiplied alpha, and the framebuffer is upside down
+        // compared to NanoVG's image coordinates
+        const int flags = NVG_IMAGE_PREMULTIPLIED | NVG_IMAGE_FLIPY |
+                          (sampling_ == Sampling::Nearest ? NVG_IMAGE_NEAREST : 0);
+        framebuffer_ = nvgluCreateFramebuffer(context_.getContext(), size.x, size.y, flags);
+        if (!framebuffer_) {
+            throw Exception("Could not create a NanoVG framebuffer", IVW_CONTEXT);
+        }
+        dimensions_ = dimensions;
+        pixelRatio_ = pixelRatio;
+    }
+
+    GLint prevFramebuffer = 0;
+    GLint prevViewport[4];
+    GLfloat prevClearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClearColor);
+
+    nvgluBindFramebuffer(framebuffer_);
+    glViewport(0, 0, size.x, size.y);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    context_.activate(dimensions, pixelRatio);
+    drawContent(context_);
+    context_.deactivate();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevFramebuffer));
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glClearColor(prevClearColor[0], prevClearColor[1], prevClearColor[2], prevClearColor[3]);
+
+    valid_ = true;
+    return true;
+}
+
+void NanoVGLayer::draw(const vec2& position, float alpha) {
+    if (!framebuffer_) return;
+    const vec2 dims{dimensions_};
+    context_.beginPath();
+    context_.rect(position, dims);
+    context_.fillPaint(context_.imagePattern(position, dims, 0.0f, framebuffer_->image, alpha));
+    context_.fill();
+}
+
+}  // namespace inviwo
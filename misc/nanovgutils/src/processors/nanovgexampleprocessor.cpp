@@ -44,8 +44,13 @@ const ProcessorInfo NanoVGExampleProcessor::processorInfo_{
 const ProcessorInfo NanoVGExampleProcessor::getProcessorInfo() const { return processorInfo_; }
 
 NanoVGExampleProcessor::NanoVGExampleProcessor()
-    : Processor(), outport_("outport"), fontProperty_("fontProperty", "Font settings") {
+    : Processor()
+    , outport_("outport")
+    , fontProperty_("fontProperty", "Font settings")
+    , offset_("offset", "Offset", vec2{0.0f}, vec2{-1000.0f}, vec2{1000.0f})
+    , layer_(nanovgutil::getContext()) {
     addProperty(fontProperty_);
+    addProperty(offset_);
     addPort(outport_);
 }
 
@@ -53,33 +58,40 @@ void NanoVGExampleProcessor::process() {
 
     auto& nvg = nanovgutil::getContext();
 
-    utilgl::activateAndClearTarget(outport_, ImageType::ColorOnly);
+    if (fontProperty_.isModified()) layer_.invalidate();
 
-    // Activate NVG for drawing using "pixel coordinates" i.e. Coordinates used for defining shapes
-    // are in the range of [0 canvassize]
-    nvg.activate(outport_.getDimensions());
+    // Draw the content into the layer, this only happens when it was invalidated or the size
+    // changed. Coordinates used for defining shapes are in the range of [0 canvassize].
+    layer_.update(outport_.getDimensions(), [&](NanoVGContext& nvg) {
+        const static std::array<std::pair<vec2, vec4>, 4> circles{
+            std::pair{vec2{150, 150}, vec4{1.0f, 0.0f, 0.0f, 0.6f}},
+            std::pair{vec2{200, 150}, vec4{0.0f, 1.0f, 0.0f, 0.6f}},
+            std::pair{vec2{175, 100}, vec4{0.0f, 0.0f, 1.0f, 0.6f}},
+            std::pair{vec2{175, 175}, vec4{0.5f, 0.5f, 0.5f, 0.2f}}};
 
-    const static std::array<std::pair<vec2, vec4>, 4> circles{
-        std::pair{vec2{150, 150}, vec4{1.0f, 0.0f, 0.0f, 0.6f}},
-        std::pair{vec2{200, 150}, vec4{0.0f, 1.0f, 0.0f, 0.6f}},
-        std::pair{vec2{175, 100}, vec4{0.0f, 0.0f, 1.0f, 0.6f}},
-        std::pair{vec2{175, 175}, vec4{0.5f, 0.5f, 0.5f, 0.2f}}};
+        for (int i{0}; i < 4; ++i) {
+            nvg.beginPath();
+            // Draw a circle
+            nvg.circle(circles[i].first, float((5 - i) * 30));
+            nvg.closePath();
 
-    for (int i{0}; i < 4; ++i) {
-        nvg.beginPath();
-        // Draw a circle
-        nvg.circle(circles[i].first, float((5 - i) * 30));
-        nvg.closePath();
+            // Set fill color to red
+            nvg.fillColor(circles[i].second);
+            nvg.fill();  // tell NVG to fill current shape
+        }
 
-        // Set fill color to red
-        nvg.fillColor(circles[i].second);
-        nvg.fill();  // tell NVG to fill current shape
-    }
+        nanovgutil::setFontProperties(nvg, fontProperty_);
+        nvg.text({175, 150}, "Testing", 4);
+    });
 
-    nanovgutil::setFontProperties(nvg, fontProperty_);
-    nvg.text({175, 150}, "Testing", 4);
+    utilgl::activateAndClearTarget(outport_, ImageType::ColorOnly);
 
+    // Activate NVG for drawing using "pixel coordinates" and composite the cached layer
+    nvg.activate(outport_.getDimensions());
+    nvg.translate(offset_.get().x, offset_.get().y);
+    layer_.draw();
     nvg.deactivate();
+
     utilgl::deactivateCurrentTarget();
 }
 
@@ -33,6 +33,10 @@
 #include <inviwo/core/interaction/pickingstate.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
 
+#include <random>
+
+#include <fmt/format.h>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -50,55 +54,103 @@ const ProcessorInfo NanoVGPickingExampleProcessor::getProcessorInfo() const {
 NanoVGPickingExampleProcessor::NanoVGPickingExampleProcessor()
     : Processor()
     , outport_("outport")
-    , picking_(this, 4, [&](PickingEvent* pe) { onItemPicked(pe); }) {
+    , numMarkers_("numMarkers", "Markers", 1000, 1, 200000)
+    , radius_("radius", "Radius", 4.0f, 1.0f, 50.0f)
+    , seed_("seed", "Seed", 0, 0, 1000)
+    , picking_(this, 1, [&](PickingEvent* pe) { onItemPicked(pe); })
+    , colorLayer_(nanovgutil::getContext())
+    , pickingLayer_(nanovgutil::getContext(), NanoVGLayer::Sampling::Nearest) {
 
     addPort(outport_);
+    addProperties(numMarkers_, radius_, seed_);
 }
 
-void NanoVGPickingExampleProcessor::process() {
-    utilgl::activateAndClearTarget(outport_, ImageType::ColorOnly);
-    draw(false);
-    glDrawBuffer(GL_COLOR_ATTACHMENT7);  // Tell GL to render to the Picking Attachment of the FBO
-    draw(true);
-    utilgl::deactivateCurrentTarget();
+void NanoVGPickingExampleProcessor::createMarkers() {
+    std::mt19937 rand(static_cast<std::mt19937::result_type>(seed_.get()));
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    markers_.resize(numMarkers_.get());
+    for (auto& marker : markers_) {
+        marker.position = vec2{dist(rand), dist(rand)};
+        marker.color = vec4{dist(rand), dist(rand), dist(rand), 1.0f};
+    }
+    picking_.resize(markers_.size());
+    hovered_.reset();
 }
 
-void NanoVGPickingExampleProcessor::draw(bool picking) {
-    const static std::array<std::tuple<vec2, float, vec4>, 4> objects = {
-        std::make_tuple(vec2{50, 50}, 40.f, vec4(1, 0, 0, 1)),
-        std::make_tuple(vec2{250, 50}, 20.f, vec4(0, 1, 0, 1)),
-        std::make_tuple(vec2{50, 250}, 30.f, vec4(0, 0, 1, 1)),
-        std::make_tuple(vec2{200, 220}, 75.f, vec4(1, 0, 1, 1))};
+void NanoVGPickingExampleProcessor::process() {
+    // Resizing the picking mapper can move its ids, so both layers are drawn again
+    if (markers_.empty() || numMarkers_.isModified() || seed_.isModified()) createMarkers();
+    if (numMarkers_.isModified() || seed_.isModified() || radius_.isModified()) {
+        colorLayer_.invalidate();
+        pickingLayer_.invalidate();
+    }
 
-    auto& nvg = nanovgutil::getContext();
-    nvg.activate(outport_.getDimensions());
-    if (picking) {
+    // The markers are only drawn again when they, or the size of the outport, changed. Hovering
+    // only composites the layers and draws the highlight.
+    const auto dims = outport_.getDimensions();
+    colorLayer_.update(dims, [&](NanoVGContext& nvg) { draw(nvg, false); });
+    pickingLayer_.update(dims, [&](NanoVGContext& nvg) {
         nvg.shapeAntiAlias(false);
+        draw(nvg, true);
+        nvg.shapeAntiAlias(true);
+    });
+
+    auto& nvg = nanovgutil::getContext();
+    utilgl::activateAndClearTarget(outport_, ImageType::ColorOnly);
+    nvg.activate(dims);
+    colorLayer_.draw();
+    if (hovered_ && *hovered_ < markers_.size()) {
+        nvg.beginPath();
+        nvg.circle(markers_[*hovered_].position * vec2{dims}, radius_.get() + 2.0f);
+        nvg.strokeColor(vec4{1.0f});
+        nvg.strokeWidth(2.0f);
+        nvg.stroke();
     }
+    nvg.deactivate();
+
+    glDrawBuffer(GL_COLOR_ATTACHMENT7);  // Tell GL to render to the Picking Attachment of the FBO
+    nvg.activate(dims);
+    // The edges of the layer must not be blended either
+    nvg.shapeAntiAlias(false);
+    pickingLayer_.draw();
+    nvg.shapeAntiAlias(true);
+    nvg.deactivate();
+    utilgl::deactivateCurrentTarget();
+}
 
-    size_t i = 0;
-    for (auto [pos, r, color] : objects) {
-        auto id = i++;
+void NanoVGPickingExampleProcessor::draw(NanoVGContext& nvg, bool picking) const {
+    const vec2 dims{outport_.getDimensions()};
+    for (size_t i = 0; i < markers_.size(); ++i) {
         nvg.beginPath();
-        nvg.circle(pos, r);
+        nvg.circle(markers_[i].position * dims, radius_.get());
         if (picking) {
-            nvg.fillColor(vec4(picking_.getColor(id), 1.0f));
+            nvg.fillColor(vec4(picking_.getColor(i), 1.0f));
         } else {
-            nvg.fillColor(color);
+            nvg.fillColor(markers_[i].color);
         }
         nvg.fill();
         nvg.closePath();
     }
-    if (picking) {
-        nvg.shapeAntiAlias(true);
-    }
-    nvg.deactivate();
 }
 
 void NanoVGPickingExampleProcessor::onItemPicked(PickingEvent* p) {
+    const auto id = p->getPickedId();
+    if (p->getHoverState() == PickingHoverState::Enter ||
+        p->getHoverState() == PickingHoverState::Move) {
+        if (hovered_ != id) {
+            hovered_ = id;
+            p->setToolTip(fmt::format("Marker {}", id));
+            invalidate(InvalidationLevel::InvalidOutput);
+        }
+    } else if (p->getHoverState() == PickingHoverState::Exit) {
+        hovered_.reset();
+        p->setToolTip("");
+        invalidate(InvalidationLevel::InvalidOutput);
+    }
+
     if (p->getState() == PickingState::Updated && p->getPressState() == PickingPressState::Press &&
         p->getPressItem() == PickingPressItem::Primary) {
-        auto [_, id] = p->getCurrentLocalPickingId();
         LogInfo("Item " << id << " picked");
     }
 }
@@ -0,0 +1,124 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <ivwnetcdf/pynetcdf.h>
+
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <memory>
+#include <string>
+
+namespace py = pybind11;
+
+namespace inviwo {
+
+namespace {
+
+/*
+ * Registration of a Python cache with the global MemoryBudget. The eviction callback is called
+ * from the thread reporting a usage, it acquires the GIL, and the GIL is released while calling
+ * into the budget so that such a thread never waits for a thread waiting for it.
+ */
+class PyRegistration {
+public:
+    PyRegistration(std::string name, py::function evict) {
+        // The budget might release the callback on any thread
+        std::shared_ptr<py::function> callback{new py::function(std::move(evict)),
+                                               [](py::function* f) {
+                                                   py::gil_scoped_acquire gil;
+                                                   delete f;
+                                               }};
+        registration_ = MemoryBudget::global().add(
+            std::move(name), MemoryBudget::Priority::Normal, [callback](size_t bytes) {
+                py::gil_scoped_acquire gil;
+                try {
+                    (*callback)(bytes);
+                } catch (const py::error_already_set& e) {
+                    LogErrorCustom("MemoryBudget", "Error evicting from a Python cache: "
+                                                       << e.what());
+                }
+            });
+    }
+    PyRegistration(const PyRegistration&) = delete;
+    PyRegistration& operator=(const PyRegistration&) = delete;
+    ~PyRegistration() { close(); }
+
+    void setUsage(size_t bytes) {
+        py::gil_scoped_release release;
+        if (registration_) registration_->setUsage(bytes);
+    }
+    size_t allowance() const {
+        py::gil_scoped_release release;
+        return registration_ ? registration_->allowance() : 0;
+    }
+    void hit() {
+        if (registration_) registration_->hit();
+    }
+    void miss() {
+        if (registration_) registration_->miss();
+    }
+    void close() {
+        py::gil_scoped_release release;
+        registration_.reset();
+    }
+
+private:
+    std::unique_ptr<MemoryBudget::Registration> registration_;
+};
+
+}  // namespace
+
+void exposeMemoryBudget(pybind11::module& m) {
+    py::class_<PyRegistration>(m, "MemoryBudgetRegistration",
+                               "A cache registered with the global memory budget")
+        .def("setUsage", &PyRegistration::setUsage, py::arg("bytes"),
+             "Report the memory used by the cache in bytes, might ask other caches to evict")
+        .def("allowance", &PyRegistration::allowance,
+             "The budget minus the usage of the other caches of higher priority")
+        .def("hit", &PyRegistration::hit)
+        .def("miss", &PyRegistration::miss)
+        .def("close", &PyRegistration::close,
+             "Remove the cache from the budget, the callback is not called anymore");
+
+    m.def(
+        "addToMemoryBudget",
+        [](std::string name, py::function evict) {
+            return std::make_unique<PyRegistration>(std::move(name), std::move(evict));
+        },
+        py::arg("name"), py::arg("evict"),
+        R"doc(Register a cache with the global memory budget of the MemoryBudget module.
+
+evict(bytes) is called, from any thread, when the cache is asked to free at least the given
+number of bytes. It must not block on a lock held while calling setUsage, but skip evicting if the
+cache is busy. Call close() when the cache is discarded, the registration keeps the callback alive
+until then.)doc");
+}
+
+}  // namespace inviwo
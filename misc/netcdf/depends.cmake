@@ -2,4 +2,5 @@
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
     InviwoPython3Module
+    InviwoMemoryBudgetModule
 )
\ No newline at end of file
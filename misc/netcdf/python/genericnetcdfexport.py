@@ -0,0 +1,250 @@
+import os
+import zlib
+import inspect
+import numpy
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from itertools import product
+from pathlib import Path
+from netCDF4 import Dataset
+
+import inviwopy as ivw
+from inviwopy.properties import FileProperty, ButtonProperty, BoolProperty, IntProperty, \
+    OptionPropertyInt, StringProperty
+
+try:
+    import h5py
+except ImportError:
+    h5py = None
+
+H5Z_FILTER_DEFLATE = 1
+H5Z_FILTER_SHUFFLE = 2
+
+
+def chunkShape(shape: tuple[int, ...], itemsize: int, layout: str = "brick",
+               chunkBytes: int = 1 << 20) -> tuple[int, ...]:
+    """
+    Chunk sizes, in file order, for a variable of the given shape holding about chunkBytes each.
+    Dimensions in front of the last three, i.e. time, get a chunk size of one so that a single
+    time step is read without touching the others. With the "slice" layout the chunks span
+    whole planes of the two last (fastest) dimensions, which suits reading slices and
+    consecutive planes. With the "brick" layout the chunks are close to cubes, which suits
+    reading sub volumes.
+    """
+    spatial = list(shape[-3:])
+    leading = [1] * (len(shape) - len(spatial))
+    elements = max(1, chunkBytes // itemsize)
+
+    if layout == "slice":
+        chunks = [1] * len(spatial)
+        for i in reversed(range(len(spatial))):
+            chunks[i] = max(1, min(spatial[i], elements))
+            elements = max(1, elements // chunks[i])
+        return tuple(leading + chunks)
+
+    # Distribute the elements evenly, starting with the smallest dimensions since they limit
+    # the chunk size along them and leave more for the others
+    chunks = [1] * len(spatial)
+    remaining = float(elements)
+    order = sorted(range(len(spatial)), key=lambda i: spatial[i])
+    for k, i in enumerate(order):
+        side = remaining ** (1.0 / (len(order) - k))
+        chunks[i] = max(1, min(spatial[i], int(side)))
+        remaining /= chunks[i]
+    return tuple(leading + chunks)
+
+
+def encodeChunk(data: numpy.ndarray, chunks: tuple[int, ...],
+                filters: list[tuple[int, int]]) -> bytes:
+    """
+    Applies the HDF5 filter pipeline, shuffle and deflate, to a chunk. Chunks at the border of a
+    variable are stored padded to the full chunk shape.
+    """
+    if data.shape != chunks:
+        full = numpy.zeros(chunks, dtype=data.dtype)
+        full[tuple(slice(0, s) for s in data.shape)] = data
+        data = full
+    raw = numpy.ascontiguousarray(data).tobytes()
+    for code, level in filters:
+        if code == H5Z_FILTER_SHUFFLE:
+            raw = numpy.frombuffer(raw, dtype=numpy.uint8).reshape(
+                -1, data.dtype.itemsize).T.tobytes()
+        elif code == H5Z_FILTER_DEFLATE:
+            raw = zlib.compress(raw, level)
+    return raw
+
+
+class ChunkedNetCDFWriter:
+    """
+    Writes variables to a NetCDF4 file, chunked and deflate compressed. The netCDF library
+    compresses the chunks one at a time, so when h5py is available the file is only defined
+    with netCDF4 and the chunks are then compressed in parallel, in a pool of threads, and
+    written as they are to the HDF5 datasets of the variables. The result is the same file
+    either way. The data of a variable is given by a function returning the values of a tuple
+    of slices in file order, it is called once per chunk from the worker threads.
+    """
+
+    def __init__(self, path: str, complevel: int = 4, shuffle: bool = True, threads: int = 0):
+        self.path = path
+        self.complevel = complevel
+        self.shuffle = shuffle
+        self.threads = threads if threads > 0 else (os.cpu_count() or 1)
+        self.nc = Dataset(path, "w", format="NETCDF4")
+        self.pending = []
+
+    def addDimension(self, name: str, size: int, coordinates=None, units: str = None):
+        self.nc.createDimension(name, size)
+        if coordinates is not None:
+            var = self.nc.createVariable(name, "f8", (name,))
+            var[:] = coordinates
+            if units is not None:
+                var.units = units
+
+    def addVariable(self, name: str, dimensions: tuple[str, ...], dtype, source,
+                    chunks: tuple[int, ...], attributes: dict = None):
+        var = self.nc.createVariable(name, numpy.dtype(dtype), dimensions,
+                                     zlib=self.complevel > 0, complevel=self.complevel,
+                                     shuffle=self.shuffle and self.complevel > 0,
+                                     chunksizes=chunks, fill_value=False)
+        if attributes:
+            var.setncatts(attributes)
+        self.pending.append((name, var.shape, chunks, source))
+
+    @staticmethod
+    def chunkSlices(shape, chunks):
+        for index in product(*[range(0, n, c) for n, c in zip(shape, chunks)]):
+            yield index, tuple(slice(o, min(o + c, n)) for o, c, n in zip(index, chunks, shape))
+
+    def close(self):
+        """Writes the data of all added variables and closes the file"""
+        if h5py is None:
+            for name, shape, chunks, source in self.pending:
+                var = self.nc.variables[name]
+                for _, slices in self.chunkSlices(shape, chunks):
+                    var[slices] = source(slices)
+            self.nc.close()
+            return
+
+        self.nc.close()
+        with h5py.File(self.path, "r+") as f:
+            for name, shape, chunks, source in self.pending:
+                self.writeDirect(f[name], shape, chunks, source)
+        self.pending = []
+
+    def writeDirect(self, dataset, shape, chunks, source):
+        plist = dataset.id.get_create_plist()
+        filters = []
+        for i in range(plist.get_nfilters()):
+            code, _, values, _ = plist.get_filter(i)
+            if code not in (H5Z_FILTER_SHUFFLE, H5Z_FILTER_DEFLATE):
+                # Let the library apply filters we can not
+                for _, slices in self.chunkSlices(shape, chunks):
+                    dataset[slices] = source(slices)
+                return
+            filters.append((code, values[0] if code == H5Z_FILTER_DEFLATE else 0))
+
+        dtype = dataset.dtype
+
+        def encode(slices):
+            return encodeChunk(numpy.asarray(source(slices), dtype=dtype), chunks, filters)
+
+        # Bound the number of compressed chunks held in memory while waiting to be written
+        window = deque()
+        with ThreadPoolExecutor(max_workers=self.threads,
+                                thread_name_prefix="netcdf-compress") as pool:
+            for index, slices in self.chunkSlices(shape, chunks):
+                window.append((index, pool.submit(encode, slices)))
+                if len(window) >= 4 * self.threads:
+                    index, future = window.popleft()
+                    dataset.id.write_direct_chunk(index, future.result())
+            while window:
+                index, future = window.popleft()
+                dataset.id.write_direct_chunk(index, future.result())
+
+
+class GenericNetCDFExport(ivw.Processor):
+    layouts = ["brick", "slice"]
+
+    def log(self, msg):
+        frame = inspect.getframeinfo(inspect.currentframe().f_back)
+        ivw.log(msg=str(msg), source=self.identifier, file=frame.filename,
+                line=frame.lineno, function=frame.function)
+
+    def __init__(self, id, name):
+        ivw.Processor.__init__(self, id, name)
+
+        self.filePath = FileProperty("filepath", "NetCDF Path", "", "netcdfdata")
+        self.variableName = StringProperty("variableName", "Variable Name", "data")
+        self.overwrite = BoolProperty("overwrite", "Overwrite", False)
+        self.layout = OptionPropertyInt("layout", "Chunk Layout", [
+            ivw.properties.IntOption("brick", "Bricks (sub volumes)", 0),
+            ivw.properties.IntOption("slice", "Slices (planes)", 1)], 0)
+        self.chunkSize = IntProperty("chunkSize", "Chunk Size (KB)", 1024, 4, 65536)
+        self.compression = IntProperty("compression", "Compression Level", 4, 0, 9)
+        self.shuffle = BoolProperty("shuffle", "Shuffle", True)
+        self.threads = IntProperty("threads", "Compression Threads (0 = all)", 0, 0, 256)
+        self.triggerExport = ButtonProperty("export", "Export")
+
+        self.addProperty(self.filePath)
+        self.addProperty(self.variableName)
+        self.addProperty(self.overwrite)
+        self.addProperty(self.layout)
+        self.addProperty(self.chunkSize)
+        self.addProperty(self.compression)
+        self.addProperty(self.shuffle)
+        self.addProperty(self.threads)
+        self.addProperty(self.triggerExport)
+
+    def process(self):
+        if not self.triggerExport.isModified:
+            return
+        if len(self.filePath.value) == 0:
+            self.log("File name empty")
+            return
+        if Path(self.filePath.value).exists() and not self.overwrite.value:
+            self.log(f"{self.filePath.value} already exists")
+            return
+
+        writer = ChunkedNetCDFWriter(self.filePath.value, self.compression.value,
+                                     self.shuffle.value, self.threads.value)
+        try:
+            self.exportData(writer)  # implemented in child
+        finally:
+            writer.close()
+        self.log(f"Exported {self.filePath.value}")
+
+    @staticmethod
+    def fileOrder(volume) -> numpy.ndarray:
+        """
+        The values of a volume in file order, (z, y, x, components), the inverse of the
+        HyperslabReader. The buffer is reinterpreted with the dimensions flipped.
+        """
+        data = numpy.ascontiguousarray(volume.data)
+        comps = data.shape[3] if data.ndim > 3 else 1
+        return data.reshape(tuple(reversed(data.shape[:3])) + (comps,))
+
+    @staticmethod
+    def coordinates(volume, shape: tuple[int, ...]) -> list[numpy.ndarray]:
+        """Cell coordinates along z, y, x from the offset and basis of the model matrix"""
+        m = volume.modelMatrix
+        coords = []
+        for axis, n in zip((2, 1, 0), shape):
+            col = m[axis]
+            length = float(numpy.sqrt(col.x * col.x + col.y * col.y + col.z * col.z))
+            offset = float((m[3].x, m[3].y, m[3].z)[axis])
+            coords.append(offset + numpy.arange(n) * (length / max(1, n - 1)))
+        return coords
+
+    def addVolumeVariables(self, writer, dims, data, shape, source, dataRange):
+        """
+        Adds one variable per component. Several variables can be selected in the sources to
+        be read back as the components of one volume.
+        """
+        comps = data.shape[-1]
+        chunks = chunkShape(shape, data.dtype.itemsize, self.layouts[self.layout.value],
+                            self.chunkSize.value * 1024)
+        name = self.variableName.value
+        for c in range(comps):
+            writer.addVariable(name if comps == 1 else f"{name}_{c}", dims, data.dtype,
+                               lambda slices, c=c: source(slices, c), chunks,
+                               {"actual_range": numpy.array([dataRange.x, dataRange.y])})
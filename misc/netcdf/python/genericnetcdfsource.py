@@ -1,11 +1,187 @@
 import numpy
 import inspect
+import threading
+from collections import OrderedDict
+from concurrent.futures import Future, ThreadPoolExecutor
 from pathlib import Path
 from netCDF4 import Dataset, Dimension, Variable
 
 import inviwopy as ivw
+import ivwnetcdf
 from inviwopy.properties import FileProperty, ButtonProperty, BoolProperty, \
-    BoolCompositeProperty, CompositeProperty, IntMinMaxProperty, StringProperty
+    BoolCompositeProperty, CompositeProperty, IntMinMaxProperty, IntProperty, StringProperty
+
+
+class HyperslabReader:
+    """
+    Reads the selected ranges of a set of variables on demand. The file is kept open and only the
+    requested hyperslabs are read from disk, the values are written straight into the output
+    array with the components of all variables interleaved in the last axis.
+    """
+
+    def __init__(self, path: str, names: list[str], ranges: list[list[tuple[int, int]]],
+                 dtype=None, chunkCache: int = 0):
+        self.nc = Dataset(path, "r")
+        self.variables: list[Variable] = [self.nc.variables[name] for name in names]
+        self.ranges = ranges
+        if chunkCache > 0:
+            for var in self.variables:
+                var.set_var_chunk_cache(size=chunkCache)
+        self.components = [int(numpy.amax(1, var.datatype.ndim)) for var in self.variables]
+        self.dtype = numpy.dtype(dtype) if dtype is not None else \
+            numpy.result_type(*[var.dtype for var in self.variables])
+        # Sizes of the dimensions that are not collapsed, equal for all variables
+        self.sizes = [r[1] - r[0] + 1 for r in ranges[0] if r[0] != r[1]]
+
+    def close(self):
+        self.nc.close()
+
+    def attributeRange(self) -> tuple[float, float]:
+        """
+        The value range given by the valid_range, valid_min/valid_max or actual_range attributes
+        of the variables, or None if a variable has none of them.
+        """
+        lows, highs = [], []
+        for var in self.variables:
+            attrs = var.ncattrs()
+            if 'valid_range' in attrs:
+                low, high = var.valid_range[0], var.valid_range[1]
+            elif 'valid_min' in attrs and 'valid_max' in attrs:
+                low, high = var.valid_min, var.valid_max
+            elif 'actual_range' in attrs:
+                low, high = var.actual_range[0], var.actual_range[1]
+            else:
+                return None
+            # The attributes are given in packed units
+            scale = getattr(var, 'scale_factor', 1.0)
+            offset = getattr(var, 'add_offset', 0.0)
+            lows.append(float(low) * scale + offset)
+            highs.append(float(high) * scale + offset)
+        return (min(lows), max(highs))
+
+    def stepBytes(self) -> int:
+        """Size in bytes of the array returned by read(step)"""
+        return int(numpy.prod(self.sizes[1:])) * sum(self.components) * self.dtype.itemsize
+
+    def steps(self) -> int:
+        """Number of steps along the first dimension that is not collapsed"""
+        return self.sizes[0]
+
+    def read(self, step: int = None) -> numpy.ndarray:
+        """
+        Reads all selected ranges. If step is given only that index of the first dimension that
+        is not collapsed is read, i.e. a single time step, and that dimension is dropped.
+        """
+        sizes = self.sizes if step is None else self.sizes[1:]
+        out = numpy.empty(list(reversed(sizes)) + [sum(self.components)], dtype=self.dtype)
+        offset = 0
+        for var, ranges, comps in zip(self.variables, self.ranges, self.components):
+            slices = []
+            fixed = step is None
+            for r in ranges:
+                if not fixed and r[0] != r[1]:
+                    slices.append(r[0] + step)
+                    fixed = True
+                else:
+                    slices.append(slice(r[0], r[1] + 1))
+            data = numpy.ma.getdata(var[tuple(slices)])
+            # The hyperslab is in file order, reinterpreted with the dimensions flipped
+            out[..., offset:offset + comps] = data.reshape(out.shape[:-1] + (comps,))
+            offset += comps
+        return out
+
+
+class StepPrefetcher:
+    """
+    Reads steps of a HyperslabReader in a background thread and keeps them in a least recently
+    used cache bounded by a memory budget in bytes, and by the allowance of the prefetcher in the
+    global memory budget. Other caches of the global budget can ask the prefetcher to free memory
+    as well. The value range of each step is taken from the variable attributes if available and
+    otherwise computed in the background as well. Reads are serialized since the netCDF library
+    is not thread safe.
+    """
+
+    def __init__(self, reader: HyperslabReader, budget: int):
+        self.reader = reader
+        self.budget = budget
+        self.attributeRange = reader.attributeRange()
+        self.readLock = threading.Lock()
+        self.lock = threading.Lock()
+        self.cache: OrderedDict[int, tuple[numpy.ndarray, tuple[float, float]]] = OrderedDict()
+        self.pending: dict[int, Future] = {}
+        self.executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="netcdf-prefetch")
+        self.registration = ivwnetcdf.addToMemoryBudget("NetCDF step prefetcher", self.evict)
+
+    def close(self):
+        # Wait for a running read to finish before the reader can be closed
+        self.executor.shutdown(wait=True, cancel_futures=True)
+        self.registration.close()
+
+    def limit(self):
+        return min(self.budget, self.registration.allowance())
+
+    def evict(self, nbytes: int):
+        # Called by the global memory budget from any thread, skipped if the cache is busy
+        if not self.lock.acquire(blocking=False):
+            return
+        try:
+            freed = 0
+            while self.cache and freed < nbytes:
+                self.cache.popitem(last=False)
+                freed += self.reader.stepBytes()
+            if freed > 0:
+                self.registration.setUsage(len(self.cache) * self.reader.stepBytes())
+        finally:
+            self.lock.release()
+
+    def decode(self, step: int):
+        with self.readLock:
+            buffer = self.reader.read(step)
+        dataRange = self.attributeRange or (float(numpy.amin(buffer)), float(numpy.amax(buffer)))
+        return buffer, dataRange
+
+    def store(self, step: int, result):
+        with self.lock:
+            self.pending.pop(step, None)
+            self.cache[step] = result
+            self.cache.move_to_end(step)
+            usage = len(self.cache) * self.reader.stepBytes()
+            self.registration.setUsage(usage)
+            limit = self.limit()
+            while len(self.cache) > 1 and \
+                    len(self.cache) * self.reader.stepBytes() > limit:
+                self.cache.popitem(last=False)
+            if len(self.cache) * self.reader.stepBytes() != usage:
+                self.registration.setUsage(len(self.cache) * self.reader.stepBytes())
+
+    def get(self, step: int):
+        """Returns the buffer and value range of step, reading it now if not yet prefetched"""
+        with self.lock:
+            if step in self.cache:
+                self.registration.hit()
+                self.cache.move_to_end(step)
+                return self.cache[step]
+            self.registration.miss()
+            future = self.pending.get(step)
+        result = future.result() if future is not None else self.decode(step)
+        self.store(step, result)
+        return result
+
+    def prefetch(self, steps: list[int]):
+        """Queues reading of steps, in order, as long as they fit in the memory budget"""
+        with self.lock:
+            available = self.limit() // max(1, self.reader.stepBytes())
+            for step in steps:
+                if step in self.cache or step in self.pending:
+                    continue
+                if len(self.cache) + len(self.pending) >= available:
+                    break
+                self.pending[step] = self.executor.submit(self.prefetched, step)
+
+    def prefetched(self, step: int):
+        result = self.decode(step)
+        self.store(step, result)
+        return result
 
 
 class GenericNetCDFSource(ivw.Processor):
@@ -24,6 +200,7 @@ class GenericNetCDFSource(ivw.Processor):
         self.dimensions = CompositeProperty("dimensions", "Restrict Dimensions")
         self.ignoreDimNames = BoolProperty('ignoreDimNames', 'Ignore Dim Names', False)
         self.toFloat = BoolProperty('toFloat', 'Convert to float', True)
+        self.chunkCache = IntProperty('chunkCache', 'Chunk Cache (MB)', 64, 0, 4096)
         self.triggerLoad = ButtonProperty("load", "Load")
 
         self.addProperty(self.filePath)
@@ -32,10 +209,12 @@ class GenericNetCDFSource(ivw.Processor):
         self.addProperty(self.dimensions)
         self.addProperty(self.toFloat)
         self.addProperty(self.ignoreDimNames)
+        self.addProperty(self.chunkCache)
         self.addProperty(self.triggerLoad)
 
         self.displayInfo.onChange(self.displayDataInfo)
         self.firstRun = True
+        self.reader: HyperslabReader = None
 
     @staticmethod
     def enabled(prop: BoolCompositeProperty):
@@ -98,6 +277,7 @@ class GenericNetCDFSource(ivw.Processor):
         first = self.firstRun
         self.firstRun = False
         if len(self.filePath.value) == 0 or not Path(self.filePath.value).exists():
+            self.closeReader()
             self.variables.clear()
             self.dimensions.clear()
             return
@@ -163,16 +343,13 @@ class GenericNetCDFSource(ivw.Processor):
                     self.log("No variables selected")
                     return
 
-                data = []
-                for var in request:
-                    ranges = [self.minmax(dim) for dim in var.get_dims()]
-                    sizeDims = [r.y - r.x + 1 for r in ranges if r.x != r.y]
-                    dims = [slice(item.x, item.y + 1) for item in ranges]
-                    varData = var[tuple(dims)]
-                    buffer = numpy.array(varData).astype(
-                        'float32' if self.toFloat.value else var.datatype)
-                    buffer.shape = numpy.flip([numpy.amax(1, var.datatype.ndim)] + sizeDims)
-                    data.append(buffer)
+                # Only open the file here, the child decides which hyperslabs to read
+                self.closeReader()
+                self.reader = HyperslabReader(
+                    self.filePath.value, [var.name for var in request],
+                    [[(r.x, r.y) for r in map(self.minmax, var.get_dims())] for var in request],
+                    'float32' if self.toFloat.value else None,
+                    self.chunkCache.value * 1024 * 1024)
 
                 # Assemble data extent.
                 extents = []
@@ -185,7 +362,12 @@ class GenericNetCDFSource(ivw.Processor):
                     cellNum = dimRange.y - dimRange.x
                     extents.append(cellExt * cellNum)
 
-                self.dataLoaded(data, extents)  # implemented in child
+                self.dataLoaded(self.reader, extents)  # implemented in child
+
+    def closeReader(self):
+        if self.reader is not None:
+            self.reader.close()
+            self.reader = None
 
     def displayDataInfo(self):
         if len(self.filePath.value) == 0:
@@ -2,7 +2,6 @@
 
 import inviwopy as ivw
 from genericnetcdfsource import GenericNetCDFSource
-import numpy
 
 
 class NetCDFImageSource(GenericNetCDFSource):
@@ -25,8 +24,8 @@ class NetCDFImageSource(GenericNetCDFSource):
     def getProcessorInfo(self):
         return NetCDFImageSource.processorInfo()
 
-    def dataLoaded(self, data, extents):
-        buffer = numpy.concatenate(data, axis=2)
+    def dataLoaded(self, reader, extents):
+        buffer = reader.read()
         imageLayer = ivw.data.Layer(buffer)
         image = ivw.data.Image(imageLayer)
         self.imageOutport.setData(image)
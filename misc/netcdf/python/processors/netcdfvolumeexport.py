@@ -0,0 +1,39 @@
+# Name: NetCDFVolumeExport
+
+import inviwopy as ivw
+import genericnetcdfexport
+import importlib
+importlib.reload(genericnetcdfexport)
+
+
+class NetCDFVolumeExport(genericnetcdfexport.GenericNetCDFExport):
+    def __init__(self, id, name):
+        genericnetcdfexport.GenericNetCDFExport.__init__(self, id, name)
+        self.volumeInport = ivw.data.VolumeInport("data3D")
+        self.addInport(self.volumeInport, owner=False)
+
+    @staticmethod
+    def processorInfo():
+        return ivw.ProcessorInfo(
+            classIdentifier="org.inviwo.netcdf.netcdfvolumeexport",
+            displayName="NetCDF Volume Export",
+            category="Data Output",
+            codeState=ivw.CodeState.Experimental,
+            tags=ivw.Tags([ivw.Tag.PY, ivw.Tag("NetCDF"),
+                           ivw.Tag("Volume")])
+        )
+
+    def getProcessorInfo(self):
+        return NetCDFVolumeExport.processorInfo()
+
+    def exportData(self, writer):
+        volume = self.volumeInport.getData()
+        data = self.fileOrder(volume)
+        shape = data.shape[:3]
+        dims = ("z", "y", "x")
+        for dim, n, coords in zip(dims, shape, self.coordinates(volume, shape)):
+            writer.addDimension(dim, n, coords)
+
+        self.addVolumeVariables(writer, dims, data, shape,
+                                lambda slices, c: data[slices + (c,)],
+                                volume.dataMap.dataRange)
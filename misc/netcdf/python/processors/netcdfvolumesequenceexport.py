@@ -0,0 +1,54 @@
+# Name: NetCDFVolumeSequenceExport
+
+import inviwopy as ivw
+import genericnetcdfexport
+import numpy
+import importlib
+importlib.reload(genericnetcdfexport)
+
+
+class NetCDFVolumeSequenceExport(genericnetcdfexport.GenericNetCDFExport):
+    def __init__(self, id, name):
+        genericnetcdfexport.GenericNetCDFExport.__init__(self, id, name)
+        self.volumeInport = ivw.data.VolumeSequenceInport("data4D")
+        self.addInport(self.volumeInport, owner=False)
+
+    @staticmethod
+    def processorInfo():
+        return ivw.ProcessorInfo(
+            classIdentifier="org.inviwo.netcdf.netcdfvolumesequenceexport",
+            displayName="NetCDF Volume Sequence Export",
+            category="Data Output",
+            codeState=ivw.CodeState.Experimental,
+            tags=ivw.Tags([ivw.Tag.PY, ivw.Tag("NetCDF"),
+                           ivw.Tag("Volume Sequence")])
+        )
+
+    def getProcessorInfo(self):
+        return NetCDFVolumeSequenceExport.processorInfo()
+
+    def exportData(self, writer):
+        volumes = list(self.volumeInport.getData())
+        if len(volumes) == 0:
+            self.log("Empty volume sequence")
+            return
+        steps = [self.fileOrder(volume) for volume in volumes]
+        if any(step.shape != steps[0].shape or step.dtype != steps[0].dtype for step in steps):
+            self.log("All time steps need to have the same dimensions and format")
+            return
+
+        shape = (len(steps),) + steps[0].shape[:3]
+        dims = ("time", "z", "y", "x")
+        writer.addDimension("time", len(steps), numpy.arange(len(steps)))
+        for dim, n, coords in zip(dims[1:], shape[1:],
+                                  self.coordinates(volumes[0], shape[1:])):
+            writer.addDimension(dim, n, coords)
+
+        # The chunks of a time step are read from that volume only
+        def source(slices, c):
+            return numpy.stack([steps[t][slices[1:] + (c,)]
+                                for t in range(*slices[0].indices(len(steps)))])
+
+        ranges = [volume.dataMap.dataRange for volume in volumes]
+        dataRange = ivw.glm.dvec2(min(r.x for r in ranges), max(r.y for r in ranges))
+        self.addVolumeVariables(writer, dims, steps[0], shape, source, dataRange)
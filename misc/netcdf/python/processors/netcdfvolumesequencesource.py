@@ -3,7 +3,7 @@
 import inviwopy as ivw
 from inviwopy.glm import dvec2, mat4, vec4
 from inviwopy.properties import BoolProperty, DoubleMinMaxProperty, OptionPropertyInt, \
-    FloatMat4Property
+    FloatMat4Property, IntProperty
 import genericnetcdfsource
 import numpy
 import importlib
@@ -20,6 +20,23 @@ class NetCDFVolumeSequenceSource(genericnetcdfsource.GenericNetCDFSource):
         genericnetcdfsource.GenericNetCDFSource.__init__(self, id, name, outputDimension=4)
         self.volumeOutport = ivw.data.VolumeSequenceOutport("data4D")
         self.addOutport(self.volumeOutport, owner=False)
+        self.stepOutport = ivw.data.VolumeOutport("timeStep")
+        self.addOutport(self.stepOutport, owner=False)
+
+        # When only the current step is loaded, each time step is read from the file on demand,
+        # which makes data sets usable that do not fit in memory.
+        self.loadAllSteps = BoolProperty("loadAllSteps", "Load All Time Steps", True)
+        self.addProperty(self.loadAllSteps)
+        self.timeStep = IntProperty("timeStepIndex", "Time Step", 0, 0, 0)
+        self.addProperty(self.timeStep)
+        # Steps around the current one are read in the background while only one is shown
+        self.prefetchSteps = IntProperty("prefetchSteps", "Prefetch Steps", 4, 0, 64)
+        self.addProperty(self.prefetchSteps)
+        self.memoryBudget = IntProperty("memoryBudget", "Prefetch Memory Budget (MB)",
+                                        1024, 16, 65536)
+        self.addProperty(self.memoryBudget)
+        self.extents = None
+        self.prefetcher: genericnetcdfsource.StepPrefetcher = None
 
         self.interpolation = OptionPropertyInt(
             "interpolation", "Interpolation", options(ivw.data.InterpolationType), 0)
@@ -66,43 +83,77 @@ class NetCDFVolumeSequenceSource(genericnetcdfsource.GenericNetCDFSource):
     def getProcessorInfo(self):
         return NetCDFVolumeSequenceSource.processorInfo()
 
-    def dataLoaded(self, data, extents):
-        volumeSequence = []
-        for timeStep in range(data[0].shape[3]):
-            subData = []
-            for comp in data:
-                # A bit brute force, but delivers correct data.
-                numElems = comp.shape[0] * comp.shape[1] * comp.shape[2]
-                subBuffer = comp.flat[(numElems * timeStep): (numElems * (timeStep + 1))]
-                subBuffer.shape = (comp.shape[0],
-                                   comp.shape[1], comp.shape[2], 1)
-                subData.append(subBuffer)
-            buffer = numpy.concatenate(subData, axis=3)
-            volume = ivw.data.Volume(buffer)
-            if self.overwriteDataRange.value:
-                volume.dataMap.dataRange = self.dataRange.value
-            else:
-                minVal = numpy.amin(buffer)
-                maxVal = numpy.amax(buffer)
-                volume.dataMap.dataRange = dvec2(minVal, maxVal)
-            volume.dataMap.valueRange = volume.dataMap.dataRange
-
-            if self.overwriteModel:
-                volume.modelMatrix = self.modelMatrix.value
-            else:
-                volume.modelMatrix = mat4(
-                    vec4(extents[2], 0, 0, 0),
-                    vec4(0, extents[1], 0, 0),
-                    vec4(0, 0, extents[0], 0),
-                    vec4(0, 0, 0, 1)
-                )
-            volume.interpolation = ivw.data.InterpolationType(self.interpolation.value)
-            volume.wrapping = [
-                ivw.data.Wrapping(self.wrappingX.value),
-                ivw.data.Wrapping(self.wrappingY.value),
-                ivw.data.Wrapping(self.wrappingZ.value)
-            ]
-            volumeSequence.append(volume)
-
-        sequence = ivw.data.VolumeSequence(volumeSequence)
-        self.volumeOutport.setData(sequence)
+    def process(self):
+        self.stepLoaded = False
+        genericnetcdfsource.GenericNetCDFSource.process(self)
+        if (self.timeStep.isModified or self.loadAllSteps.isModified or
+                self.memoryBudget.isModified) and not self.stepLoaded and self.reader is not None:
+            self.loadSteps()
+
+    def closeReader(self):
+        if self.prefetcher is not None:
+            self.prefetcher.close()
+            self.prefetcher = None
+        genericnetcdfsource.GenericNetCDFSource.closeReader(self)
+
+    def dataLoaded(self, reader, extents):
+        self.extents = extents
+        self.timeStep.maxValue = reader.steps() - 1
+        self.loadSteps()
+
+    def loadSteps(self):
+        # Every step is read as its own hyperslab, directly into the buffer of that volume
+        self.stepLoaded = True
+        if self.loadAllSteps.value:
+            dataRange = self.reader.attributeRange()
+            volumeSequence = [self.createVolume(self.reader.read(step), dataRange)
+                              for step in range(self.reader.steps())]
+            self.volumeOutport.setData(ivw.data.VolumeSequence(volumeSequence))
+            self.stepOutport.setData(volumeSequence[min(self.timeStep.value,
+                                                        len(volumeSequence) - 1)])
+        else:
+            if self.prefetcher is None or self.memoryBudget.isModified:
+                if self.prefetcher is not None:
+                    self.prefetcher.close()
+                self.prefetcher = genericnetcdfsource.StepPrefetcher(
+                    self.reader, self.memoryBudget.value * 1024 * 1024)
+            steps = self.reader.steps()
+            step = min(self.timeStep.value, steps - 1)
+            volume = self.createVolume(*self.prefetcher.get(step))
+            self.volumeOutport.setData(ivw.data.VolumeSequence([volume]))
+            self.stepOutport.setData(volume)
+
+            # Prefetch the following steps first, for forward playback
+            k = self.prefetchSteps.value
+            neighbours = [step + i for i in range(1, k + 1)] + [step - i for i in range(1, k + 1)]
+            self.prefetcher.prefetch([s for s in neighbours if 0 <= s < steps])
+
+    def createVolume(self, buffer, dataRange=None):
+        extents = self.extents
+        volume = ivw.data.Volume(buffer)
+        if self.overwriteDataRange.value:
+            volume.dataMap.dataRange = self.dataRange.value
+        elif dataRange is not None:
+            volume.dataMap.dataRange = dvec2(dataRange[0], dataRange[1])
+        else:
+            minVal = numpy.amin(buffer)
+            maxVal = numpy.amax(buffer)
+            volume.dataMap.dataRange = dvec2(minVal, maxVal)
+        volume.dataMap.valueRange = volume.dataMap.dataRange
+
+        if self.overwriteModel:
+            volume.modelMatrix = self.modelMatrix.value
+        else:
+            volume.modelMatrix = mat4(
+                vec4(extents[2], 0, 0, 0),
+                vec4(0, extents[1], 0, 0),
+                vec4(0, 0, extents[0], 0),
+                vec4(0, 0, 0, 1)
+            )
+        volume.interpolation = ivw.data.InterpolationType(self.interpolation.value)
+        volume.wrapping = [
+            ivw.data.Wrapping(self.wrappingX.value),
+            ivw.data.Wrapping(self.wrappingY.value),
+            ivw.data.Wrapping(self.wrappingZ.value)
+        ]
+        return volume
@@ -66,8 +66,8 @@ class NetCDFVolumeSource(genericnetcdfsource.GenericNetCDFSource):
     def getProcessorInfo(self):
         return NetCDFVolumeSource.processorInfo()
 
-    def dataLoaded(self, data, extents):
-        buffer = numpy.concatenate(data, axis=3)
+    def dataLoaded(self, reader, extents):
+        buffer = reader.read()
         volume = ivw.data.Volume(buffer)
         if self.overwriteDataRange.value:
             volume.dataMap.dataRange = self.dataRange.value
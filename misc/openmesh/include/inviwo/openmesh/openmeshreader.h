@@ -42,6 +42,8 @@ namespace inviwo {
  * \class OpenMeshReader
  * \ingroup dataio
  * \brief Reader for various mesh types using the OpenMesh library
+ * Binary PLY and STL files are parsed directly into Inviwo buffers without building an OpenMesh
+ * halfedge structure, see openmeshutil::readBinaryMesh.
  */
 class IVW_MODULE_OPENMESH_API OpenMeshReader : public DataReaderType<Mesh> {
 public:
@@ -42,6 +42,8 @@ namespace inviwo {
  * \class OpenMeshWriter
  * \ingroup dataio
  * \brief Writer for various mesh types using the OpenMesh library
+ * PLY and STL files are written as binary files directly from the Inviwo buffers, see
+ * openmeshutil::writeBinaryMesh.
  */
 class IVW_MODULE_OPENMESH_API OpenMeshWriter : public DataWriterType<Mesh> {
 public:
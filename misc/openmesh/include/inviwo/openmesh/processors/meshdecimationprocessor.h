@@ -34,6 +34,8 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/openmesh/utils/meshdecimation.h>
 #include <inviwo/core/ports/meshport.h>
 
 namespace inviwo {
@@ -54,6 +56,9 @@ namespace inviwo {
  * ### Properties
  *   * __Vertex Decimation ratio__ Percentage of vertices to keep.
  *   * __Face Decimation ratio__ Percentage of faces to keep.
+ *   * __Engine__ Decimation algorithm, see openmeshutil::DecimationEngine. Multiple choice is
+ *     faster than the heap at a slightly lower quality, the parallel engine scales with the
+ *     number of cores for large meshes.
  */
 
 class IVW_MODULE_OPENMESH_API MeshDecimationProcessor : public Processor {
@@ -73,6 +78,14 @@ private:
     FloatProperty vertDecimation_{
         "vertDecimation", "Vertex Decimation ratio", 0.5f, 0.f, 1.f, 0.01f};
     FloatProperty faceDecimation_{"faceDecimation", "Face Decimation ratio", 0.5f, 0.f, 1.f, 0.01f};
+    TemplateOptionProperty<openmeshutil::DecimationEngine> engine_{
+        "engine",
+        "Engine",
+        {{"heap", "Heap (serial)", openmeshutil::DecimationEngine::Heap},
+         {"multipleChoice", "Multiple Choice (serial)",
+          openmeshutil::DecimationEngine::MultipleChoice},
+         {"parallel", "Parallel", openmeshutil::DecimationEngine::Parallel}},
+        0};
 };
 
 }  // namespace inviwo
@@ -35,6 +35,10 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/meshport.h>
 
+#include <map>
+#include <memory>
+#include <tuple>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.MeshDecimationProcessor, Mesh Decimation}
@@ -43,6 +47,10 @@ namespace inviwo {
  * Reduces the number of triangles in all input meshes.
  * Stops when either the Vertex- or the Face decimation ratio is reached.
  *
+ * The meshes are decimated concurrently, in batches whose estimated memory use stays within the
+ * memory budget. Results are cached by a hash of the mesh buffers and the ratios, so only new
+ * meshes and ratios are decimated when the sequence or the ratios change.
+ *
  *
  * ### Inports
  *   * __inmeshes__ Input meshes.
@@ -53,6 +61,8 @@ namespace inviwo {
  * ### Properties
  *   * __Vertex Decimation ratio__ Percentage of vertices to keep.
  *   * __Face Decimation ratio__ Percentage of faces to keep.
+ *   * __Memory budget__ Estimated memory in MB that the concurrent decimations may use.
+ *   * __Cache size__ Maximum number of decimated meshes kept.
  */
 
 class IVW_MODULE_OPENMESH_API MeshSequenceDecimationProcessor : public Processor {
@@ -72,6 +82,17 @@ private:
     FloatProperty vertDecimation_{
         "vertDecimation", "Vertex Decimation ratio", 0.5f, 0.f, 1.f, 0.01f};
     FloatProperty faceDecimation_{"faceDecimation", "Face Decimation ratio", 0.5f, 0.f, 1.f, 0.01f};
+    IntSizeTProperty memoryBudget_{"memoryBudget", "Memory budget (MB)", 4096, 64, 65536, 64};
+    IntSizeTProperty cacheSize_{"cacheSize", "Cache size", 2000, 0, 100000, 100};
+
+    // hash of the input mesh and the ratios
+    using Key = std::tuple<size_t, float, float>;
+    struct CacheEntry {
+        std::shared_ptr<Mesh> mesh;
+        size_t lastUse;
+    };
+    std::map<Key, CacheEntry> cache_;
+    size_t useCount_ = 0;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,117 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/openmesh/openmeshmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/openmesh/utils/progressivemesh.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ProgressiveMeshProcessor, Progressive Mesh}
+ * ![](org.inviwo.ProgressiveMeshProcessor.png?classIdentifier=org.inviwo.ProgressiveMeshProcessor)
+ * Decimates the input mesh once while recording the collapses as a progressive mesh, see
+ * openmeshutil::ProgressiveMesh, and outputs a level of detail of it. Changing the level only
+ * applies or undoes the vertex splits in between, the vertex buffers are shared by all levels.
+ * The level is either given as a ratio of the faces, or chosen such that the estimated error
+ * of the level projected onto the screen stays below a number of pixels.
+ *
+ * ### Inports
+ *   * __inmesh__ Input mesh.
+ *
+ * ### Outports
+ *   * __outmesh__ Level of detail of the input mesh.
+ *
+ * ### Properties
+ *   * __Base Face Ratio__ Faces of the coarsest level relative to the input mesh.
+ *   * __Engine__ Decimation algorithm recording the collapses, see
+ *     openmeshutil::DecimationEngine.
+ *   * __Level Selection__ Select the level by face ratio or by screen-space error.
+ *   * __Face Ratio__ Faces of the output relative to the input mesh.
+ *   * __Pixel Error__ Largest tolerated error in pixels.
+ *   * __Viewport Height__ Height in pixels of the canvas the mesh is rendered to.
+ *   * __Camera__ Camera used for the screen-space error, link it with the renderer.
+ */
+class IVW_MODULE_OPENMESH_API ProgressiveMeshProcessor : public Processor {
+public:
+    enum class LevelSelection { FaceRatio, ScreenSpaceError };
+
+    ProgressiveMeshProcessor();
+    virtual ~ProgressiveMeshProcessor() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void build();
+    size_t selectLevel() const;
+
+    MeshInport inmesh_{"inmesh"};
+    MeshOutport outmesh_{"outmesh"};
+
+    FloatProperty baseFaces_{"baseFaces", "Base Face Ratio", 0.01f, 0.f, 1.f, 0.001f};
+    TemplateOptionProperty<openmeshutil::DecimationEngine> engine_{
+        "engine",
+        "Engine",
+        {{"heap", "Heap", openmeshutil::DecimationEngine::Heap},
+         {"multipleChoice", "Multiple Choice", openmeshutil::DecimationEngine::MultipleChoice}},
+        0};
+    TemplateOptionProperty<LevelSelection> selection_{
+        "selection",
+        "Level Selection",
+        {{"faceRatio", "Face Ratio", LevelSelection::FaceRatio},
+         {"screenSpaceError", "Screen-Space Error", LevelSelection::ScreenSpaceError}},
+        0};
+    FloatProperty faces_{"faces", "Face Ratio", 1.f, 0.f, 1.f, 0.01f};
+    FloatProperty pixelError_{"pixelError", "Pixel Error", 1.f, 0.1f, 20.f, 0.1f};
+    IntSizeTProperty viewportHeight_{"viewportHeight", "Viewport Height", 1024, 1, 8192};
+    CameraProperty camera_{"camera", "Camera"};
+
+    std::unique_ptr<openmeshutil::ProgressiveMesh> progressive_;
+    /// vertex buffers of all levels, in model space
+    std::shared_ptr<Mesh> vertices_;
+    vec3 center_{0.f};
+    float radius_ = 0.f;
+    size_t level_ = 0;
+    std::vector<std::uint32_t> indices_;
+};
+
+}  // namespace inviwo
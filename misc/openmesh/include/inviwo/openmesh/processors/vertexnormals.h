@@ -34,23 +34,30 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/ports/meshport.h>
 #include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/openmesh/utils/meshnormals.h>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.VertexNormals, Vertex Normals}
  * ![](org.inviwo.VertexNormals.png?classIdentifier=org.inviwo.VertexNormals)
  * generates vertex normals for the input mesh. Existing vertex normals will only be overwritten if
- * enforced.
+ * enforced. The normals are computed in parallel directly on the position and index buffers, and
+ * all other buffers are shared with the input mesh.
  *
  * ### Inports
  *   * __mesh__  input mesh
  *
  * ### Outports
  *   * __outport__  output mesh with vertex normals
+ *
+ * ### Properties
+ *   * __Override Normals__  recompute normals even if the mesh already has a normal buffer
+ *   * __Weighting__  how the faces around a vertex are weighted, by area, angle or equally
  */
 
 /**
- * \brief generate vertex normals for a Mesh using OpenMesh
+ * \brief generate vertex normals for a Mesh
  */
 class IVW_MODULE_OPENMESH_API VertexNormals : public Processor {
 public:
@@ -67,6 +74,13 @@ private:
     MeshOutport outport_{"outport"};
 
     BoolProperty override_{"overrideNormals", "Override Normals", false};
+    TemplateOptionProperty<openmeshutil::NormalWeighting> weighting_{
+        "weighting",
+        "Weighting",
+        {{"area", "Area", openmeshutil::NormalWeighting::Area},
+         {"angle", "Angle", openmeshutil::NormalWeighting::Angle},
+         {"equal", "Equal", openmeshutil::NormalWeighting::Equal}},
+        0};
 };
 
 }  // namespace inviwo
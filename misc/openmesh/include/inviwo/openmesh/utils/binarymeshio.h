@@ -0,0 +1,66 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/openmesh/openmeshmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+
+#include <memory>
+#include <string>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+/**
+ * Reads a binary PLY or binary STL file directly into the buffers of an Inviwo Mesh, without
+ * building an OpenMesh halfedge structure. The file is memory mapped and the vertex and face
+ * records are decoded in parallel. Duplicated STL vertices are merged and vertex normals are
+ * computed when the file has none, matching the result of reading through OpenMesh.
+ *
+ * Returns nullptr for files the direct path does not handle, like ASCII files or PLY files with
+ * list properties outside of the face element, the caller should then fall back to OpenMesh.
+ * @throw DataReaderException if a binary file is truncated or references missing vertices
+ */
+IVW_MODULE_OPENMESH_API std::shared_ptr<Mesh> readBinaryMesh(const std::string& filePath);
+
+/**
+ * Writes the triangles of \p mesh as a binary little endian PLY or a binary STL file, depending
+ * on the extension of \p filePath. Positions are transformed to world space. The records are
+ * encoded in parallel and written with a single call.
+ *
+ * Returns false if the extension is neither ply nor stl.
+ * @throw FileException if the file cannot be written
+ */
+IVW_MODULE_OPENMESH_API bool writeBinaryMesh(const Mesh& mesh, const std::string& filePath);
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
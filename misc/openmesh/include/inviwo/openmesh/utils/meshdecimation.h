@@ -34,6 +34,9 @@
 #include <inviwo/core/common/inviwo.h>
 
 #include <inviwo/core/util/clock.h>
+#include <inviwo/openmesh/utils/openmeshconverters.h>
+
+#include <type_traits>
 
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES_WAS_DEFINED
@@ -45,6 +48,7 @@
 #include <OpenMesh/Core/IO/MeshIO.hh>  // this needs to be included before TriMesh_ArrayKernelT
 #include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
 #include <OpenMesh/Tools/Decimater/DecimaterT.hh>
+#include <OpenMesh/Tools/Decimater/McDecimaterT.hh>
 #include <OpenMesh/Tools/Decimater/ModQuadricT.hh>
 #include <warn/pop>
 
@@ -69,6 +73,51 @@ struct VertexFraction {
     float fraction;
 };
 
+/**
+ * Algorithm used to select the edges to collapse in openmeshutil::decimate
+ */
+enum class DecimationEngine {
+    //! Always collapses the edge with the smallest quadric error, kept in a heap. Serial.
+    Heap,
+    //! Collapses the best of a few randomly chosen edges, avoiding the heap updates. Serial.
+    MultipleChoice,
+    /**
+     * Splits the mesh into spatial clusters that are decimated in parallel with multiple
+     * choice while their common vertices are locked. The clusters are then stitched and the
+     * result is decimated once more to the target without locks.
+     */
+    Parallel
+};
+
+namespace detail {
+
+template <typename OMesh>
+void decimateMultipleChoice(OMesh& mesh, size_t vertices, size_t faces) {
+    using Decimater = typename OpenMesh::Decimater::McDecimaterT<OMesh>;
+    using HModQuadric = typename OpenMesh::Decimater::ModQuadricT<OMesh>::Handle;
+
+    Decimater decimater(mesh);
+    HModQuadric hModQuadric;
+
+    decimater.add(hModQuadric);
+    decimater.module(hModQuadric).unset_max_err();
+    decimater.initialize();
+    decimater.decimate_to_faces(vertices, faces);
+}
+
+}  // namespace detail
+
+/**
+ * Decimates \p mesh with DecimationEngine::Parallel.
+ *
+ * @param mesh   (@see inviwo::openmeshutil::fromInviwo)
+ * @param vertexFraction percentage of vertices to keep
+ * @param faceFraction percentage of faces to keep
+ * @param clusters number of clusters, 0 uses twice the number of hardware threads
+ */
+IVW_MODULE_OPENMESH_API void decimateParallel(TriMesh& mesh, VertexFraction vertexFraction,
+                                              FaceFraction faceFraction, size_t clusters = 0);
+
 /**
  * Utility function to reduce the number of triangles in a mesh.
  * Stops when either the Vertex- or the Face decimation ratio is reach.
@@ -79,9 +128,27 @@ struct VertexFraction {
  * @param mesh An OpenMesh mesh (see fromInviwo(...) and ::toInviwo(...))
  * @param vertexFraction percentage of vertices to keep
  * @param faceFraction percentage of faces to keep
+ * @param engine algorithm to use, DecimationEngine::Parallel is only available for TriMesh and
+ *     falls back to DecimationEngine::MultipleChoice for other meshes
  */
 template <typename OMesh>
-void decimate(OMesh& mesh, VertexFraction vertexFraction, FaceFraction faceFraction) {
+void decimate(OMesh& mesh, VertexFraction vertexFraction, FaceFraction faceFraction,
+              DecimationEngine engine = DecimationEngine::Heap) {
+    if constexpr (std::is_same_v<OMesh, TriMesh>) {
+        if (engine == DecimationEngine::Parallel) {
+            decimateParallel(mesh, vertexFraction, faceFraction);
+            return;
+        }
+    }
+
+    const auto vertices = static_cast<size_t>(mesh.n_vertices() * vertexFraction.fraction);
+    const auto faces = static_cast<size_t>(mesh.n_faces() * faceFraction.fraction);
+    if (engine != DecimationEngine::Heap) {
+        detail::decimateMultipleChoice(mesh, vertices, faces);
+        mesh.garbage_collection();
+        return;
+    }
+
     using Decimater = typename OpenMesh::Decimater::DecimaterT<OMesh>;
     using HModQuadric = typename OpenMesh::Decimater::ModQuadricT<OMesh>::Handle;
 
@@ -91,8 +158,7 @@ void decimate(OMesh& mesh, VertexFraction vertexFraction, FaceFraction faceFract
     decimater.add(hModQuadric);
     decimater.module(hModQuadric).unset_max_err();
     decimater.initialize();
-    decimater.decimate_to_faces(static_cast<size_t>(mesh.n_vertices() * vertexFraction.fraction),
-                                static_cast<size_t>(mesh.n_faces() * faceFraction.fraction));
+    decimater.decimate_to_faces(vertices, faces);
     mesh.garbage_collection();
 }
 
@@ -0,0 +1,66 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/openmesh/openmeshmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+/**
+ * How the normals of the faces around a vertex contribute to the vertex normal
+ */
+enum class NormalWeighting {
+    //! Each face contributes proportionally to its area
+    Area,
+    //! Each face contributes proportionally to the angle of the face at the vertex
+    Angle,
+    //! All faces contribute equally
+    Equal
+};
+
+/**
+ * Computes vertex normals for the triangles of \p mesh directly on its position and index
+ * buffers, without converting to OpenMesh. Face normals are computed in parallel and then
+ * gathered per vertex through a vertex-to-face adjacency list. The normals are given in the
+ * data space of the mesh. Vertices not referenced by any triangle get a zero normal.
+ *
+ * @throw Exception if the mesh has no position buffer or its type is not vec3 or vec4
+ */
+IVW_MODULE_OPENMESH_API std::vector<vec3> computeVertexNormals(
+    const Mesh& mesh, NormalWeighting weighting = NormalWeighting::Area);
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
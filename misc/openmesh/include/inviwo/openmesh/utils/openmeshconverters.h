@@ -37,6 +37,7 @@
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/foreach.h>
 #include <modules/base/algorithm/meshutils.h>
 
 #ifndef _USE_MATH_DEFINES
@@ -97,9 +98,12 @@ void convertOMtoInviwoBuffer(inviwo::Mesh& ivwMesh, const OM_Mesh& omMesh, Buffe
     auto vertices = std::make_shared<typename Helper::type>();
     auto& vec = vertices->getEditableRAMRepresentation()->getDataContainer();
     ivwMesh.addBuffer(bufferType, vertices);
-    for (const OpenMesh::VertexHandle& v_it : omMesh.vertices()) {
-        vec.push_back(Helper::convertValue(callback(v_it)));
-    }
+    // Vertex handles of a garbage collected mesh are contiguous, fill the preallocated buffer
+    // directly instead of growing it one vertex at a time.
+    vec.resize(omMesh.n_vertices());
+    util::forEachParallel(vec, [&](const auto&, size_t i) {
+        vec[i] = Helper::convertValue(callback(OpenMesh::VertexHandle(static_cast<int>(i))));
+    });
 };
 
 }  // namespace detail
@@ -144,17 +148,25 @@ std::shared_ptr<Mesh> toInviwo(const OM_Mesh& mesh) {
     auto indices = std::make_shared<IndexBuffer>(indicesRam);
     auto& indVec = indicesRam->getDataContainer();
     newmesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None), indices);
+
+    std::vector<int> triangles;
+    triangles.reserve(mesh.n_faces());
     size_t skipped = 0;
     for (auto f_it : mesh.faces()) {
         if (mesh.valence(f_it) != 3) {
             skipped++;
-            continue;
-        }
-
-        for (auto i = mesh.cfv_begin(f_it); i != mesh.cfv_end(f_it); i++) {
-            indVec.push_back(i->idx());
+        } else {
+            triangles.push_back(f_it.idx());
         }
     }
+    indVec.resize(3 * triangles.size());
+    util::forEachParallel(triangles, [&](int face, size_t i) {
+        auto dst = indVec.begin() + 3 * i;
+        for (auto v_it = mesh.cfv_begin(OpenMesh::FaceHandle(face));
+             v_it != mesh.cfv_end(OpenMesh::FaceHandle(face)); ++v_it) {
+            *dst++ = static_cast<std::uint32_t>(v_it->idx());
+        }
+    });
     if (skipped) {
         LogWarnCustom("openmeshutil::toInviwo",
                       "Skipped " << skipped << " faces since they weren't triangles");
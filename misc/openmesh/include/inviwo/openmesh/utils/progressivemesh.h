@@ -0,0 +1,143 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/openmesh/openmeshmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/openmesh/utils/meshdecimation.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+/**
+ * \brief Progressive mesh recorded from the edge collapses of a decimation
+ * Stores the coarsest mesh reached by the decimation together with the vertex splits undoing
+ * its collapses in reverse order, as in Hoppe's progressive meshes. Level k is the base mesh
+ * refined by the first k vertex splits, level getNumSplits() is the input mesh.
+ *
+ * The vertices keep the indices of the input mesh, so its vertex buffers can be used for every
+ * level and only the triangle indices change. The faces are ordered by the level at which they
+ * appear, the indices of level k are therefore the first 3 * getNumFaces(k) ones. updateIndices
+ * moves between two levels in time proportional to the number of changed indices.
+ *
+ * Each split stores the distance the collapse it undoes moved its vertex. getError(k) is the
+ * largest such distance of the splits missing at level k, an estimate of the geometric error
+ * of the level in the space of the input positions.
+ */
+class IVW_MODULE_OPENMESH_API ProgressiveMesh {
+public:
+    /**
+     * Halfedge collapse moving vertex from onto vertex to, removing the faces left and right of
+     * the edge. Missing faces at the boundary are given as -1.
+     */
+    struct Collapse {
+        std::uint32_t from;
+        std::uint32_t to;
+        std::int32_t left;
+        std::int32_t right;
+        float distance;
+    };
+
+    struct VertexSplit {
+        /// vertex added by the split
+        std::uint32_t vertex;
+        /// vertex it is split from
+        std::uint32_t parent;
+    };
+
+    ProgressiveMesh() = default;
+    /**
+     * @param numVertices number of vertices of the input mesh
+     * @param faces       triangles of the input mesh
+     * @param collapses   collapses in the order they were applied
+     * @param removed     faces not part of the decimated mesh. Removed faces not listed by any
+     *                    collapse only appear at the finest level.
+     * @throw Exception if a collapse or face refers to a vertex or face out of range
+     */
+    ProgressiveMesh(size_t numVertices, const std::vector<std::array<std::uint32_t, 3>>& faces,
+                    const std::vector<Collapse>& collapses, const std::vector<bool>& removed);
+
+    size_t getNumSplits() const { return splits_.size(); }
+    size_t getNumVertices(size_t level) const { return numBaseVertices_ + level; }
+    size_t getNumFaces(size_t level) const { return faceCounts_[level]; }
+    const std::vector<VertexSplit>& getSplits() const { return splits_; }
+    float getError(size_t level) const { return errors_[level]; }
+
+    /**
+     * Vertices of the input mesh in the order they appear, base vertices first. Useful for
+     * streaming the vertices together with the splits.
+     */
+    std::vector<std::uint32_t> getVertexOrder() const;
+
+    /// Smallest level with at least \p faces faces
+    size_t levelForFaces(size_t faces) const;
+    /// Smallest level with an error of at most \p error
+    size_t levelForError(float error) const;
+
+    /// Triangle indices of \p level
+    std::vector<std::uint32_t> getIndices(size_t level) const;
+    /**
+     * Updates the triangle indices of level \p from, as returned by getIndices, to level \p to
+     * by applying or undoing the vertex splits in between.
+     */
+    void updateIndices(std::vector<std::uint32_t>& indices, size_t from, size_t to) const;
+
+private:
+    size_t numBaseVertices_ = 0;
+    std::vector<VertexSplit> splits_;
+    /// number of faces and error per level, getNumSplits() + 1 entries
+    std::vector<size_t> faceCounts_{0};
+    std::vector<float> errors_{0.0f};
+    /// corners of the faces in order of appearance, with the vertices of the level they appear
+    std::vector<std::uint32_t> corners_;
+    /// corners set to the vertex of split j are updateCorners_[updateOffsets_[j]...[j + 1]]
+    std::vector<size_t> updateOffsets_{0};
+    std::vector<std::uint32_t> updateCorners_;
+};
+
+/**
+ * Decimates a copy of \p mesh with the quadric error metric and records the collapses as a
+ * ProgressiveMesh, whose base mesh has about \p baseFaces of the faces of \p mesh. The vertex
+ * indices of \p mesh must be contiguous, e.g. as returned by fromInviwo.
+ *
+ * @param engine DecimationEngine::Heap or DecimationEngine::MultipleChoice, the parallel engine
+ *     does not keep a single collapse sequence and falls back to multiple choice
+ */
+IVW_MODULE_OPENMESH_API ProgressiveMesh createProgressiveMesh(
+    const TriMesh& mesh, FaceFraction baseFaces = FaceFraction{0.01f},
+    DecimationEngine engine = DecimationEngine::Heap);
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
@@ -40,6 +40,7 @@
 #endif
 
 #include <inviwo/openmesh/processors/meshsequencedecimationprocessor.h>
+#include <inviwo/openmesh/processors/progressivemeshprocessor.h>
 #include <inviwo/openmesh/processors/vertexnormals.h>
 #include <warn/push>
 #include <warn/ignore/all>
@@ -55,6 +56,7 @@ namespace inviwo {
 OpenMeshModule::OpenMeshModule(InviwoApplication* app) : InviwoModule(app, "OpenMesh") {
     registerProcessor<MeshDecimationProcessor>();
     registerProcessor<MeshSequenceDecimationProcessor>();
+    registerProcessor<ProgressiveMeshProcessor>();
     registerProcessor<VertexNormals>();
 
     // Readers and writes
@@ -30,6 +30,7 @@
 #include <inviwo/openmesh/openmeshreader.h>
 
 #include <inviwo/openmesh/utils/openmeshconverters.h>
+#include <inviwo/openmesh/utils/binarymeshio.h>
 
 #define _USE_MATH_DEFINES
 #include <warn/push>
@@ -60,6 +61,9 @@ OpenMeshReader::OpenMeshReader() : DataReaderType<Mesh>() {
 }
 
 std::shared_ptr<inviwo::Mesh> OpenMeshReader::readData(const std::string& filePath) {
+    // Binary PLY and STL files are read directly into Inviwo buffers
+    if (auto mesh = openmeshutil::readBinaryMesh(filePath)) return mesh;
+
     TriMesh mesh;
     if (!OpenMesh::IO::read_mesh(mesh, filePath)) {
         throw inviwo::Exception("Failed reading mesh from disk " + filePath, IvwContext);
@@ -30,6 +30,7 @@
 #include <inviwo/openmesh/openmeshwriter.h>
 
 #include <inviwo/openmesh/utils/openmeshconverters.h>
+#include <inviwo/openmesh/utils/binarymeshio.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -62,6 +63,9 @@ OpenMeshWriter::OpenMeshWriter() : DataWriterType<Mesh>() {
 inviwo::OpenMeshWriter* OpenMeshWriter::clone() const { return new OpenMeshWriter(*this); }
 
 void OpenMeshWriter::writeData(const Mesh* data, const std::string filePath) const {
+    // PLY and STL files are written as binary files directly from the Inviwo buffers
+    if (openmeshutil::writeBinaryMesh(*data, filePath)) return;
+
     auto mesh = openmeshutil::fromInviwo(*data);
     OpenMesh::IO::write_mesh(mesh, filePath);
 }
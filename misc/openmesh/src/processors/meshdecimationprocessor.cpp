@@ -49,13 +49,14 @@ MeshDecimationProcessor::MeshDecimationProcessor() : Processor() {
 
     addProperty(vertDecimation_);
     addProperty(faceDecimation_);
+    addProperty(engine_);
 }
 
 void MeshDecimationProcessor::process() {
     //! [OpenMesh Decimation]
     using namespace openmeshutil;
     auto mesh = fromInviwo(*inmesh_.getData(), TransformCoordinates::DataToModel);
-    decimate(mesh, vertDecimation_.get(), faceDecimation_.get());
+    decimate(mesh, vertDecimation_.get(), faceDecimation_.get(), engine_.get());
     auto newMesh = toInviwo(mesh);
     newMesh->copyMetaDataFrom(*inmesh_.getData());
     newMesh->setWorldMatrix(inmesh_.getData()->getWorldMatrix());
@@ -30,9 +30,52 @@
 #include <inviwo/openmesh/processors/meshsequencedecimationprocessor.h>
 #include <inviwo/openmesh/utils/meshdecimation.h>
 #include <inviwo/openmesh/utils/openmeshconverters.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/hashcombine.h>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
 
 namespace inviwo {
 
+namespace {
+
+// rough ratio between the memory used while decimating and the size of the mesh buffers
+constexpr size_t decimationMemoryFactor = 10;
+
+size_t bufferBytes(const BufferBase& buffer) {
+    return buffer.getSize() * buffer.getDataFormat()->getSize();
+}
+
+size_t meshBytes(const Mesh& mesh) {
+    size_t bytes = 0;
+    for (const auto& [info, buffer] : mesh.getBuffers()) bytes += bufferBytes(*buffer);
+    for (const auto& [info, indices] : mesh.getIndexBuffers()) bytes += bufferBytes(*indices);
+    return bytes;
+}
+
+size_t meshHash(const Mesh& mesh) {
+    size_t seed = 0;
+    const auto hashBuffer = [&](const BufferBase& buffer) {
+        const auto ram = buffer.getRepresentation<BufferRAM>();
+        const std::string_view bytes{static_cast<const char*>(ram->getData()),
+                                     bufferBytes(buffer)};
+        util::hash_combine(seed, std::hash<std::string_view>{}(bytes));
+    };
+    for (const auto& [info, buffer] : mesh.getBuffers()) {
+        util::hash_combine(seed, static_cast<int>(info.type));
+        hashBuffer(*buffer);
+    }
+    for (const auto& [info, indices] : mesh.getIndexBuffers()) {
+        util::hash_combine(seed, static_cast<int>(info.dt));
+        hashBuffer(*indices);
+    }
+    return seed;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo MeshSequenceDecimationProcessor::processorInfo_{
     "org.inviwo.MeshSequenceDecimationProcessor",  // Class identifier
@@ -51,23 +94,80 @@ MeshSequenceDecimationProcessor::MeshSequenceDecimationProcessor() : Processor()
 
     addProperty(vertDecimation_);
     addProperty(faceDecimation_);
+    addProperty(memoryBudget_);
+    addProperty(cacheSize_);
+
+    memoryBudget_.setInvalidationLevel(InvalidationLevel::Valid);
+    cacheSize_.onChange([this]() { cache_.clear(); });
 }
 
 void MeshSequenceDecimationProcessor::process() {
     using namespace openmeshutil;
-    auto meshes = std::make_shared<decltype(outmesh_)::type>();
-
-    for (auto inMesh : inmesh_) {
-        auto mesh = fromInviwo(*inMesh, TransformCoordinates::NoTransform);
-        decimate(mesh, vertDecimation_.get(), faceDecimation_.get());
-        auto newMesh = toInviwo(mesh);
-        newMesh->copyMetaDataFrom(*inmesh_.getData());
-        newMesh->setModelMatrix(inmesh_.getData()->getModelMatrix());
-        newMesh->setWorldMatrix(inmesh_.getData()->getWorldMatrix());
-        meshes->push_back(newMesh);
+
+    std::vector<std::shared_ptr<const Mesh>> inMeshes(inmesh_.begin(), inmesh_.end());
+    const float vertexFraction = vertDecimation_.get();
+    const float faceFraction = faceDecimation_.get();
+
+    std::vector<Key> keys(inMeshes.size());
+    util::forEachParallel(inMeshes, [&](const auto& inMesh, size_t i) {
+        keys[i] = Key{meshHash(*inMesh), vertexFraction, faceFraction};
+    });
+
+    std::vector<std::shared_ptr<Mesh>> results(inMeshes.size());
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < inMeshes.size(); ++i) {
+        if (auto it = cache_.find(keys[i]); it != cache_.end()) {
+            it->second.lastUse = ++useCount_;
+            results[i] = it->second.mesh;
+        } else if (auto dup = std::find(keys.begin(), keys.begin() + i, keys[i]);
+                   dup != keys.begin() + i) {
+            // decimated along with an identical earlier mesh of the sequence
+            continue;
+        } else {
+            missing.push_back(i);
+        }
+    }
+
+    // decimate in batches that fit the memory budget, at least one mesh per batch
+    const size_t budget = memoryBudget_.get() * 1024 * 1024;
+    for (auto first = missing.begin(); first != missing.end();) {
+        size_t bytes = 0;
+        auto last = first;
+        do {
+            bytes += decimationMemoryFactor * meshBytes(*inMeshes[*last]);
+            ++last;
+        } while (last != missing.end() &&
+                 bytes + decimationMemoryFactor * meshBytes(*inMeshes[*last]) <= budget);
+
+        std::vector<size_t> batch(first, last);
+        util::forEachParallel(batch, [&](size_t i, size_t) {
+            auto mesh = fromInviwo(*inMeshes[i], TransformCoordinates::NoTransform);
+            decimate(mesh, vertexFraction, faceFraction);
+            auto newMesh = toInviwo(mesh);
+            newMesh->copyMetaDataFrom(*inmesh_.getData());
+            newMesh->setModelMatrix(inmesh_.getData()->getModelMatrix());
+            newMesh->setWorldMatrix(inmesh_.getData()->getWorldMatrix());
+            results[i] = newMesh;
+        });
+        first = last;
+    }
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i]) {
+            results[i] = results[std::find(keys.begin(), keys.end(), keys[i]) - keys.begin()];
+        }
+    }
+
+    if (cacheSize_.get() > 0) {
+        for (auto i : missing) cache_[keys[i]] = CacheEntry{results[i], ++useCount_};
+        while (cache_.size() > cacheSize_.get()) {
+            cache_.erase(std::min_element(cache_.begin(), cache_.end(), [](auto& a, auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            }));
+        }
     }
 
-    outmesh_.setData(meshes);
+    outmesh_.setData(std::make_shared<std::vector<std::shared_ptr<Mesh>>>(std::move(results)));
 }
 
 }  // namespace inviwo
@@ -0,0 +1,146 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/openmesh/processors/progressivemeshprocessor.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/openmesh/utils/openmeshconverters.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo ProgressiveMeshProcessor::processorInfo_{
+    "org.inviwo.openmesh.ProgressiveMeshProcessor",  // Class identifier
+    "Progressive Mesh",                              // Display name
+    "Mesh Processing",                               // Category
+    CodeState::Experimental,                         // Code state
+    Tags::CPU,                                       // Tags
+};
+const ProcessorInfo ProgressiveMeshProcessor::getProcessorInfo() const { return processorInfo_; }
+
+ProgressiveMeshProcessor::ProgressiveMeshProcessor() : Processor() {
+    addPort(inmesh_);
+    addPort(outmesh_);
+
+    addProperties(baseFaces_, engine_, selection_, faces_, pixelError_, viewportHeight_, camera_);
+
+    auto updateVisibility = [this]() {
+        const bool screenSpace = selection_ == LevelSelection::ScreenSpaceError;
+        faces_.setVisible(!screenSpace);
+        pixelError_.setVisible(screenSpace);
+        viewportHeight_.setVisible(screenSpace);
+        camera_.setVisible(screenSpace);
+    };
+    selection_.onChange(updateVisibility);
+    updateVisibility();
+}
+
+void ProgressiveMeshProcessor::process() {
+    if (!progressive_ || inmesh_.isChanged() || baseFaces_.isModified() ||
+        engine_.isModified()) {
+        build();
+    }
+
+    const auto level = selectLevel();
+    progressive_->updateIndices(indices_, level_, level);
+    level_ = level;
+
+    // The output shares the vertex buffers, only the indices of the level are copied
+    auto mesh = std::make_shared<Mesh>();
+    for (const auto& buffer : vertices_->getBuffers()) {
+        mesh->addBuffer(buffer.first, buffer.second);
+    }
+    auto indicesRam = std::make_shared<IndexBufferRAM>();
+    indicesRam->getDataContainer() = indices_;
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                     std::make_shared<IndexBuffer>(indicesRam));
+    mesh->copyMetaDataFrom(*vertices_);
+    mesh->setWorldMatrix(vertices_->getWorldMatrix());
+    outmesh_.setData(mesh);
+}
+
+void ProgressiveMeshProcessor::build() {
+    using namespace openmeshutil;
+    auto input = inmesh_.getData();
+    const auto mesh = fromInviwo(*input, TransformCoordinates::DataToModel);
+
+    progressive_ = std::make_unique<ProgressiveMesh>(
+        createProgressiveMesh(mesh, FaceFraction{baseFaces_.get()}, engine_.get()));
+
+    vertices_ = toInviwo(mesh);
+    vertices_->copyMetaDataFrom(*input);
+    vertices_->setWorldMatrix(input->getWorldMatrix());
+
+    vec3 min{std::numeric_limits<float>::max()};
+    vec3 max{std::numeric_limits<float>::lowest()};
+    for (const auto vertex : mesh.vertices()) {
+        const auto& p = mesh.point(vertex);
+        const vec3 pos{p[0], p[1], p[2]};
+        min = glm::min(min, pos);
+        max = glm::max(max, pos);
+    }
+    center_ = mesh.n_vertices() > 0 ? 0.5f * (min + max) : vec3{0.f};
+    radius_ = mesh.n_vertices() > 0 ? 0.5f * glm::length(max - min) : 0.f;
+
+    level_ = 0;
+    indices_ = progressive_->getIndices(level_);
+}
+
+size_t ProgressiveMeshProcessor::selectLevel() const {
+    const auto finest = progressive_->getNumSplits();
+    if (selection_ == LevelSelection::FaceRatio) {
+        const auto faces = progressive_->getNumFaces(finest);
+        return progressive_->levelForFaces(static_cast<size_t>(faces_.get() * faces));
+    }
+
+    const auto& camera = camera_.get();
+    const mat4 projection = camera.getProjectionMatrix();
+    const mat4 world = vertices_->getWorldMatrix();
+    // The errors are measured in model space, scale them by the largest world scaling
+    const float scale = std::max({glm::length(vec3(world[0])), glm::length(vec3(world[1])),
+                                  glm::length(vec3(world[2]))});
+    if (scale <= 0.f || projection[1][1] == 0.f) return finest;
+
+    // Perspective projections scale with the distance to the closest point of the bounds
+    float distance = 1.f;
+    if (projection[2][3] != 0.f) {
+        const vec3 center{world * vec4(center_, 1.f)};
+        distance = std::max(glm::distance(camera.getLookFrom(), center) - radius_ * scale,
+                            camera.getNearPlaneDist());
+    }
+    const float pixelSize =
+        2.f * distance / (projection[1][1] * static_cast<float>(viewportHeight_.get()));
+    return progressive_->levelForError(pixelError_.get() * pixelSize / scale);
+}
+
+}  // namespace inviwo
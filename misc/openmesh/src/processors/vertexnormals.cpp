@@ -29,7 +29,9 @@
 
 #include <inviwo/openmesh/processors/vertexnormals.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
-#include <inviwo/openmesh/utils/openmeshconverters.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/openmesh/utils/meshnormals.h>
 
 namespace inviwo {
 
@@ -48,6 +50,7 @@ VertexNormals::VertexNormals() : Processor() {
     addPort(inport_);
     addPort(outport_);
     addProperty(override_);
+    addProperty(weighting_);
 }
 
 void VertexNormals::process() {
@@ -56,17 +59,30 @@ void VertexNormals::process() {
         return;
     }
 
-    auto mesh = openmeshutil::fromInviwo(*inport_.getData(),
-                                         openmeshutil::TransformCoordinates::DataToModel);
+    const auto& inMesh = *inport_.getData();
+    auto normals = std::make_shared<Buffer<vec3>>(
+        std::make_shared<BufferRAMPrecision<vec3>>(
+            openmeshutil::computeVertexNormals(inMesh, weighting_.get())));
 
-    // generate face normals in order to update the vertex normals
-    mesh.request_face_normals();
-    mesh.update_normals();
-    mesh.release_face_normals();
+    // Share all other buffers with the input mesh, only the normals are new
+    auto newMesh = std::make_shared<Mesh>(inMesh.getDefaultMeshInfo());
+    bool replaced = false;
+    for (const auto& [info, buffer] : inMesh.getBuffers()) {
+        if (info.type == BufferType::NormalAttrib && !replaced) {
+            newMesh->addBuffer(info, normals);
+            replaced = true;
+        } else if (info.type != BufferType::NormalAttrib) {
+            newMesh->addBuffer(info, buffer);
+        }
+    }
+    if (!replaced) newMesh->addBuffer(BufferType::NormalAttrib, normals);
+    for (const auto& [info, indices] : inMesh.getIndexBuffers()) {
+        newMesh->addIndices(info, indices);
+    }
 
-    auto newMesh = openmeshutil::toInviwo(mesh);
-    newMesh->copyMetaDataFrom(*inport_.getData());
-    newMesh->setWorldMatrix(inport_.getData()->getWorldMatrix());
+    newMesh->copyMetaDataFrom(inMesh);
+    newMesh->setModelMatrix(inMesh.getModelMatrix());
+    newMesh->setWorldMatrix(inMesh.getWorldMatrix());
     outport_.setData(newMesh);
 }
 
@@ -0,0 +1,652 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/openmesh/utils/binarymeshio.h>
+#include <inviwo/openmesh/utils/meshnormals.h>
+#include <inviwo/utilities/io/mappedfile.h>
+
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/hashcombine.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <modules/base/algorithm/meshutils.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+namespace {
+
+bool hostIsLittleEndian() {
+    const std::uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+const bool littleEndian = hostIsLittleEndian();
+
+template <typename T>
+T load(const unsigned char* src, bool swap) {
+    std::array<unsigned char, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), src, sizeof(T));
+    if (swap) std::reverse(bytes.begin(), bytes.end());
+    T value;
+    std::memcpy(&value, bytes.data(), sizeof(T));
+    return value;
+}
+
+// Stores value in little endian byte order and returns the position after it
+template <typename T>
+unsigned char* store(unsigned char* dst, T value) {
+    std::memcpy(dst, &value, sizeof(T));
+    if (!littleEndian) std::reverse(dst, dst + sizeof(T));
+    return dst + sizeof(T);
+}
+
+constexpr size_t chunkSize = 1 << 16;
+
+// First indices of consecutive chunks of chunkSize items, used to process records in parallel
+std::vector<size_t> chunks(size_t count) {
+    std::vector<size_t> res;
+    res.reserve(count / chunkSize + 1);
+    for (size_t first = 0; first < count; first += chunkSize) res.push_back(first);
+    return res;
+}
+
+std::shared_ptr<Mesh> makeMesh(std::vector<vec3> positions, std::vector<vec4> colors,
+                               std::vector<vec3> normals, std::vector<vec3> texCoords,
+                               std::vector<std::uint32_t> indices) {
+    auto mesh = std::make_shared<Mesh>(DrawType::Triangles, ConnectivityType::None);
+    mesh->addBuffer(BufferType::PositionAttrib,
+                    std::make_shared<Buffer<vec3>>(
+                        std::make_shared<BufferRAMPrecision<vec3>>(std::move(positions))));
+    if (!colors.empty()) {
+        mesh->addBuffer(BufferType::ColorAttrib,
+                        std::make_shared<Buffer<vec4>>(
+                            std::make_shared<BufferRAMPrecision<vec4>>(std::move(colors))));
+    }
+    mesh->addIndices(
+        Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+        std::make_shared<IndexBuffer>(std::make_shared<IndexBufferRAM>(std::move(indices))));
+
+    // Same as OpenMesh::update_vertex_normals, which sums the unit face normals
+    if (normals.empty()) normals = computeVertexNormals(*mesh, NormalWeighting::Equal);
+    mesh->addBuffer(BufferType::NormalAttrib,
+                    std::make_shared<Buffer<vec3>>(
+                        std::make_shared<BufferRAMPrecision<vec3>>(std::move(normals))));
+    if (!texCoords.empty()) {
+        mesh->addBuffer(BufferType::TexCoordAttrib,
+                        std::make_shared<Buffer<vec3>>(
+                            std::make_shared<BufferRAMPrecision<vec3>>(std::move(texCoords))));
+    }
+    return mesh;
+}
+
+void checkIndices(const std::vector<std::uint32_t>& indices, size_t numVertices,
+                  const std::string& filePath) {
+    if (std::any_of(indices.begin(), indices.end(),
+                    [numVertices](std::uint32_t i) { return i >= numVertices; })) {
+        throw DataReaderException(
+            fmt::format("Face references a missing vertex in '{}'", filePath),
+            IVW_CONTEXT_CUSTOM("openmeshutil::readBinaryMesh"));
+    }
+}
+
+[[noreturn]] void truncated(const std::string& filePath) {
+    throw DataReaderException(fmt::format("Unexpected end of file in '{}'", filePath),
+                              IVW_CONTEXT_CUSTOM("openmeshutil::readBinaryMesh"));
+}
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+std::optional<PlyType> plyType(const std::string& name) {
+    static const std::unordered_map<std::string, PlyType> types{
+        {"char", PlyType::Int8},       {"int8", PlyType::Int8},
+        {"uchar", PlyType::UInt8},     {"uint8", PlyType::UInt8},
+        {"short", PlyType::Int16},     {"int16", PlyType::Int16},
+        {"ushort", PlyType::UInt16},   {"uint16", PlyType::UInt16},
+        {"int", PlyType::Int32},       {"int32", PlyType::Int32},
+        {"uint", PlyType::UInt32},     {"uint32", PlyType::UInt32},
+        {"float", PlyType::Float32},   {"float32", PlyType::Float32},
+        {"double", PlyType::Float64},  {"float64", PlyType::Float64}};
+    auto it = types.find(name);
+    return it != types.end() ? std::optional<PlyType>{it->second} : std::nullopt;
+}
+
+size_t plySize(PlyType type) {
+    switch (type) {
+        case PlyType::Int8:
+        case PlyType::UInt8:
+            return 1;
+        case PlyType::Int16:
+        case PlyType::UInt16:
+            return 2;
+        case PlyType::Int32:
+        case PlyType::UInt32:
+        case PlyType::Float32:
+            return 4;
+        case PlyType::Float64:
+        default:
+            return 8;
+    }
+}
+
+double loadPly(const unsigned char* src, PlyType type, bool swap) {
+    switch (type) {
+        case PlyType::Int8:
+            return load<std::int8_t>(src, swap);
+        case PlyType::UInt8:
+            return load<std::uint8_t>(src, swap);
+        case PlyType::Int16:
+            return load<std::int16_t>(src, swap);
+        case PlyType::UInt16:
+            return load<std::uint16_t>(src, swap);
+        case PlyType::Int32:
+            return load<std::int32_t>(src, swap);
+        case PlyType::UInt32:
+            return load<std::uint32_t>(src, swap);
+        case PlyType::Float32:
+            return load<float>(src, swap);
+        case PlyType::Float64:
+        default:
+            return load<double>(src, swap);
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::Float32;
+    std::optional<PlyType> countType;  // Only set for list properties
+    size_t offset = 0;                 // Offset in the record, for properties before any list
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    bool hasList() const {
+        return std::any_of(properties.begin(), properties.end(),
+                           [](const PlyProperty& p) { return p.countType.has_value(); });
+    }
+    // Size of one record, only valid for elements without lists
+    size_t stride() const {
+        size_t res = 0;
+        for (const auto& p : properties) res += plySize(p.type);
+        return res;
+    }
+    const PlyProperty* find(std::initializer_list<std::string_view> names) const {
+        for (auto name : names) {
+            auto it = std::find_if(properties.begin(), properties.end(),
+                                   [&](const PlyProperty& p) { return p.name == name; });
+            if (it != properties.end()) return &*it;
+        }
+        return nullptr;
+    }
+};
+
+struct PlyHeader {
+    bool swap = false;
+    size_t size = 0;
+    std::vector<PlyElement> elements;
+};
+
+std::optional<PlyHeader> parsePlyHeader(const MappedFile& file) {
+    if (file.size() < 4 || std::memcmp(file.data(), "ply", 3) != 0) return std::nullopt;
+
+    const std::string_view view(reinterpret_cast<const char*>(file.data()),
+                                std::min<size_t>(file.size(), 1 << 20));
+    const auto end = view.find("end_header");
+    if (end == std::string_view::npos) return std::nullopt;
+    const auto body = view.find('\n', end);
+    if (body == std::string_view::npos) return std::nullopt;
+
+    PlyHeader header;
+    header.size = body + 1;
+    bool binary = false;
+    std::istringstream lines{std::string{view.substr(0, end)}};
+    for (std::string line; std::getline(lines, line);) {
+        std::istringstream tokens{line};
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "format") {
+            std::string format;
+            tokens >> format;
+            if (format == "binary_little_endian") {
+                header.swap = !littleEndian;
+            } else if (format == "binary_big_endian") {
+                header.swap = littleEndian;
+            } else {
+                return std::nullopt;
+            }
+            binary = true;
+        } else if (keyword == "element") {
+            PlyElement element;
+            tokens >> element.name >> element.count;
+            header.elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            if (header.elements.empty()) return std::nullopt;
+            PlyProperty property;
+            std::string type;
+            tokens >> type;
+            if (type == "list") {
+                std::string countType;
+                tokens >> countType >> type;
+                property.countType = plyType(countType);
+                if (!property.countType) return std::nullopt;
+            }
+            if (auto t = plyType(type)) {
+                property.type = *t;
+            } else {
+                return std::nullopt;
+            }
+            tokens >> property.name;
+            header.elements.back().properties.push_back(std::move(property));
+        }
+    }
+    if (!binary) return std::nullopt;
+
+    for (auto& element : header.elements) {
+        size_t offset = 0;
+        for (auto& property : element.properties) {
+            if (property.countType) break;
+            property.offset = offset;
+            offset += plySize(property.type);
+        }
+    }
+    return header;
+}
+
+std::shared_ptr<Mesh> readPly(const MappedFile& file, const std::string& filePath) {
+    const auto header = parsePlyHeader(file);
+    if (!header) return nullptr;
+    const bool swap = header->swap;
+
+    const unsigned char* data = file.data() + header->size;
+    const unsigned char* end = file.data() + file.size();
+    const PlyElement* vertex = nullptr;
+    const unsigned char* vertexData = nullptr;
+    const PlyElement* face = nullptr;
+    const unsigned char* faceData = nullptr;
+    for (const auto& element : header->elements) {
+        if (element.name == "face") {
+            face = &element;
+            faceData = data;
+            break;
+        }
+        // Without a list the size of the element is known, otherwise we would have to walk it
+        if (element.hasList()) return nullptr;
+        if (element.name == "vertex") {
+            vertex = &element;
+            vertexData = data;
+        }
+        if (static_cast<size_t>(end - data) < element.count * element.stride()) {
+            truncated(filePath);
+        }
+        data += element.count * element.stride();
+    }
+    if (!vertex) return nullptr;
+    const auto x = vertex->find({"x"});
+    const auto y = vertex->find({"y"});
+    const auto z = vertex->find({"z"});
+    if (!x || !y || !z) return nullptr;
+
+    const auto stride = vertex->stride();
+    const auto get = [&](const unsigned char* record, const PlyProperty* p) {
+        return static_cast<float>(loadPly(record + p->offset, p->type, swap));
+    };
+
+    std::vector<vec3> positions(vertex->count);
+    util::forEachParallel(positions, [&](const vec3&, size_t i) {
+        const auto record = vertexData + i * stride;
+        positions[i] = vec3{get(record, x), get(record, y), get(record, z)};
+    });
+
+    std::vector<vec3> normals;
+    const auto nx = vertex->find({"nx"});
+    const auto ny = vertex->find({"ny"});
+    const auto nz = vertex->find({"nz"});
+    if (nx && ny && nz) {
+        normals.resize(vertex->count);
+        util::forEachParallel(normals, [&](const vec3&, size_t i) {
+            const auto record = vertexData + i * stride;
+            normals[i] = vec3{get(record, nx), get(record, ny), get(record, nz)};
+        });
+    }
+
+    std::vector<vec4> colors;
+    const auto red = vertex->find({"red", "diffuse_red"});
+    const auto green = vertex->find({"green", "diffuse_green"});
+    const auto blue = vertex->find({"blue", "diffuse_blue"});
+    const auto alpha = vertex->find({"alpha"});
+    if (red && green && blue) {
+        const auto scale = [](const PlyProperty* p) {
+            if (p->type == PlyType::UInt8) return 1.0f / 255.0f;
+            if (p->type == PlyType::UInt16) return 1.0f / 65535.0f;
+            return 1.0f;
+        };
+        colors.resize(vertex->count);
+        util::forEachParallel(colors, [&](const vec4&, size_t i) {
+            const auto record = vertexData + i * stride;
+            colors[i] = vec4{get(record, red) * scale(red), get(record, green) * scale(green),
+                             get(record, blue) * scale(blue),
+                             alpha ? get(record, alpha) * scale(alpha) : 1.0f};
+        });
+    }
+
+    std::vector<vec3> texCoords;
+    const auto s = vertex->find({"s", "u", "texture_u"});
+    const auto t = vertex->find({"t", "v", "texture_v"});
+    if (s && t) {
+        texCoords.resize(vertex->count);
+        util::forEachParallel(texCoords, [&](const vec3&, size_t i) {
+            const auto record = vertexData + i * stride;
+            texCoords[i] = vec3{get(record, s), get(record, t), 0.0f};
+        });
+    }
+
+    std::vector<std::uint32_t> indices;
+    if (face) {
+        const auto list = face->find({"vertex_indices", "vertex_index"});
+        if (!list || !list->countType) return nullptr;
+        size_t before = 0;
+        size_t after = 0;
+        for (const auto& p : face->properties) {
+            if (&p == list) continue;
+            if (p.countType) return nullptr;
+            (&p < list ? before : after) += plySize(p.type);
+        }
+        const auto countSize = plySize(*list->countType);
+        const auto indexSize = plySize(list->type);
+        const auto index = [&](const unsigned char* src) {
+            return static_cast<std::uint32_t>(
+                static_cast<std::int64_t>(loadPly(src, list->type, swap)));
+        };
+
+        // Assume a pure triangle mesh, then every face record has the same size and the faces
+        // can be decoded in parallel. Otherwise fall back to walking the records.
+        const auto triangleStride = before + countSize + 3 * indexSize + after;
+        std::atomic<bool> triangles{face->count * triangleStride <=
+                                    static_cast<size_t>(end - faceData)};
+        if (triangles) {
+            indices.resize(3 * face->count);
+            util::forEachParallel(chunks(face->count), [&](size_t first, size_t) {
+                const auto last = std::min(first + chunkSize, face->count);
+                for (auto f = first; f < last && triangles; ++f) {
+                    const auto record = faceData + f * triangleStride + before;
+                    if (loadPly(record, *list->countType, swap) != 3.0) {
+                        triangles = false;
+                        return;
+                    }
+                    for (size_t k = 0; k < 3; ++k) {
+                        indices[3 * f + k] = index(record + countSize + k * indexSize);
+                    }
+                }
+            });
+        }
+        if (!triangles) {
+            // Triangulate polygons as fans
+            indices.clear();
+            indices.reserve(3 * face->count);
+            auto record = faceData;
+            for (size_t f = 0; f < face->count; ++f) {
+                if (static_cast<size_t>(end - record) < before + countSize) truncated(filePath);
+                record += before;
+                const auto n = static_cast<size_t>(loadPly(record, *list->countType, swap));
+                record += countSize;
+                if (static_cast<size_t>(end - record) < n * indexSize + after) {
+                    truncated(filePath);
+                }
+                for (size_t k = 2; k < n; ++k) {
+                    indices.push_back(index(record));
+                    indices.push_back(index(record + (k - 1) * indexSize));
+                    indices.push_back(index(record + k * indexSize));
+                }
+                record += n * indexSize + after;
+            }
+        }
+        checkIndices(indices, positions.size(), filePath);
+    }
+
+    return makeMesh(std::move(positions), std::move(colors), std::move(normals),
+                    std::move(texCoords), std::move(indices));
+}
+
+struct Vec3Hash {
+    size_t operator()(const vec3& v) const {
+        size_t seed = 0;
+        util::hash_combine(seed, v.x);
+        util::hash_combine(seed, v.y);
+        util::hash_combine(seed, v.z);
+        return seed;
+    }
+};
+
+std::shared_ptr<Mesh> readStl(const MappedFile& file) {
+    constexpr size_t headerSize = 84;
+    constexpr size_t recordSize = 50;
+    if (file.size() < headerSize) return nullptr;
+    const bool swap = !littleEndian;
+    const size_t count = load<std::uint32_t>(file.data() + 80, swap);
+    // ASCII files, which start with "solid", will not match the size of a binary file
+    if (headerSize + count * recordSize != file.size()) return nullptr;
+
+    std::vector<vec3> corners(3 * count);
+    util::forEachParallel(corners, [&](const vec3&, size_t i) {
+        const auto src = file.data() + headerSize + (i / 3) * recordSize + 12 * (1 + i % 3);
+        corners[i] = vec3{load<float>(src, swap), load<float>(src + 4, swap),
+                          load<float>(src + 8, swap)};
+    });
+
+    // STL stores every triangle separately, merge equal corners into shared vertices
+    std::unordered_map<vec3, std::uint32_t, Vec3Hash> unique;
+    unique.reserve(corners.size() / 2);
+    std::vector<vec3> positions;
+    positions.reserve(corners.size() / 2);
+    std::vector<std::uint32_t> indices(corners.size());
+    for (size_t i = 0; i < corners.size(); ++i) {
+        const auto [it, inserted] =
+            unique.try_emplace(corners[i], static_cast<std::uint32_t>(positions.size()));
+        if (inserted) positions.push_back(corners[i]);
+        indices[i] = it->second;
+    }
+
+    return makeMesh(std::move(positions), {}, {}, {}, std::move(indices));
+}
+
+template <typename T>
+const std::vector<T>* findContainer(const Mesh& mesh, BufferType type) {
+    if (auto buffer = dynamic_cast<const Buffer<T>*>(mesh.findBuffer(type).first)) {
+        return &buffer->getRAMRepresentation()->getDataContainer();
+    }
+    return nullptr;
+}
+
+std::vector<vec3> worldPositions(const Mesh& mesh) {
+    const mat4 m = mesh.getCoordinateTransformer().getDataToWorldMatrix();
+    std::vector<vec3> res;
+    if (auto p3 = findContainer<vec3>(mesh, BufferType::PositionAttrib)) {
+        res.resize(p3->size());
+        util::forEachParallel(*p3, [&](const vec3& p, size_t i) {
+            const auto p4 = m * vec4{p, 1.0f};
+            res[i] = vec3{p4} / p4.w;
+        });
+    } else if (auto p4 = findContainer<vec4>(mesh, BufferType::PositionAttrib)) {
+        res.resize(p4->size());
+        util::forEachParallel(*p4, [&](const vec4& p, size_t i) {
+            const auto w = m * p;
+            res[i] = vec3{w} / w.w;
+        });
+    } else {
+        throw Exception("Unknown position buffer type",
+                        IVW_CONTEXT_CUSTOM("openmeshutil::writeBinaryMesh"));
+    }
+    return res;
+}
+
+std::vector<glm::u32vec3> triangles(const Mesh& mesh, size_t numVertices) {
+    std::vector<glm::u32vec3> res;
+    for (const auto& ib : mesh.getIndexBuffers()) {
+        if (ib.first.dt == DrawType::Triangles) {
+            res.reserve(res.size() + ib.second->getSize() / 3);
+            meshutil::forEachTriangle(ib.first, *ib.second,
+                                      [&](std::uint32_t i0, std::uint32_t i1, std::uint32_t i2) {
+                                          if (i0 < numVertices && i1 < numVertices &&
+                                              i2 < numVertices) {
+                                              res.emplace_back(i0, i1, i2);
+                                          }
+                                      });
+        }
+    }
+    return res;
+}
+
+std::vector<unsigned char> encodePly(const Mesh& mesh, const std::vector<vec3>& positions,
+                                     const std::vector<glm::u32vec3>& tris) {
+    const auto normals = findContainer<vec3>(mesh, BufferType::NormalAttrib);
+    const auto colors = findContainer<vec4>(mesh, BufferType::ColorAttrib);
+    const bool hasNormals = normals && normals->size() == positions.size();
+    const bool hasColors = colors && colors->size() == positions.size();
+
+    std::string header = fmt::format(
+        "ply\nformat binary_little_endian 1.0\ncomment Inviwo\nelement vertex {}\n"
+        "property float x\nproperty float y\nproperty float z\n",
+        positions.size());
+    if (hasNormals) header += "property float nx\nproperty float ny\nproperty float nz\n";
+    if (hasColors) {
+        header +=
+            "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+            "property uchar alpha\n";
+    }
+    header += fmt::format(
+        "element face {}\nproperty list uchar int vertex_indices\nend_header\n", tris.size());
+
+    const size_t vertexStride = 12 + (hasNormals ? 12 : 0) + (hasColors ? 4 : 0);
+    const size_t faceStride = 1 + 3 * 4;
+    const auto vertexData = header.size();
+    const auto faceData = vertexData + positions.size() * vertexStride;
+    std::vector<unsigned char> bytes(faceData + tris.size() * faceStride);
+    std::memcpy(bytes.data(), header.data(), header.size());
+
+    const mat3 normalMatrix =
+        glm::transpose(glm::inverse(mat3(mesh.getCoordinateTransformer().getDataToWorldMatrix())));
+    util::forEachParallel(positions, [&](const vec3& p, size_t i) {
+        auto dst = bytes.data() + vertexData + i * vertexStride;
+        for (size_t k = 0; k < 3; ++k) dst = store(dst, p[k]);
+        if (hasNormals) {
+            const auto n = normalMatrix * (*normals)[i];
+            const auto length = glm::length(n);
+            for (size_t k = 0; k < 3; ++k) dst = store(dst, length > 0.0f ? n[k] / length : 0.0f);
+        }
+        if (hasColors) {
+            const auto c = glm::clamp((*colors)[i], vec4{0.0f}, vec4{1.0f}) * 255.0f + 0.5f;
+            for (size_t k = 0; k < 4; ++k) dst = store(dst, static_cast<std::uint8_t>(c[k]));
+        }
+    });
+    util::forEachParallel(tris, [&](const glm::u32vec3& t, size_t i) {
+        auto dst = store(bytes.data() + faceData + i * faceStride, std::uint8_t{3});
+        for (size_t k = 0; k < 3; ++k) dst = store(dst, static_cast<std::int32_t>(t[k]));
+    });
+    return bytes;
+}
+
+std::vector<unsigned char> encodeStl(const std::vector<vec3>& positions,
+                                     const std::vector<glm::u32vec3>& tris) {
+    constexpr size_t headerSize = 84;
+    constexpr size_t recordSize = 50;
+    std::vector<unsigned char> bytes(headerSize + tris.size() * recordSize, 0);
+    constexpr std::string_view comment = "binary STL written by Inviwo";
+    std::memcpy(bytes.data(), comment.data(), comment.size());
+    store(bytes.data() + 80, static_cast<std::uint32_t>(tris.size()));
+
+    util::forEachParallel(tris, [&](const glm::u32vec3& t, size_t i) {
+        const auto& p0 = positions[t[0]];
+        const auto& p1 = positions[t[1]];
+        const auto& p2 = positions[t[2]];
+        const auto n = glm::cross(p1 - p0, p2 - p0);
+        const auto length = glm::length(n);
+        const auto normal = length > 0.0f ? n / length : vec3{0.0f};
+
+        auto dst = bytes.data() + headerSize + i * recordSize;
+        for (const auto& v : {normal, p0, p1, p2}) {
+            for (size_t k = 0; k < 3; ++k) dst = store(dst, v[k]);
+        }
+        store(dst, std::uint16_t{0});
+    });
+    return bytes;
+}
+
+}  // namespace
+
+std::shared_ptr<Mesh> readBinaryMesh(const std::string& filePath) {
+    const auto ext = toLower(filesystem::getFileExtension(filePath));
+    if (ext != "ply" && ext != "stl") return nullptr;
+
+    const MappedFile file(filePath);
+    return ext == "ply" ? readPly(file, filePath) : readStl(file);
+}
+
+bool writeBinaryMesh(const Mesh& mesh, const std::string& filePath) {
+    const auto ext = toLower(filesystem::getFileExtension(filePath));
+    if (ext != "ply" && ext != "stl") return false;
+
+    const auto positions = worldPositions(mesh);
+    const auto tris = triangles(mesh, positions.size());
+    const auto bytes = ext == "ply" ? encodePly(mesh, positions, tris) : encodeStl(positions, tris);
+
+    auto out = filesystem::ofstream(filePath, std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!out) {
+        throw FileException(fmt::format("Could not write to file '{}'", filePath),
+                            IVW_CONTEXT_CUSTOM("openmeshutil::writeBinaryMesh"));
+    }
+    return true;
+}
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
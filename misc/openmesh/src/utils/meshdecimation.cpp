@@ -28,5 +28,182 @@
  *********************************************************************************/
 
 #include <inviwo/openmesh/utils/meshdecimation.h>
+#include <inviwo/core/util/foreach.h>
 
-namespace inviwo {}  // namespace inviwo
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+namespace {
+
+// meshes smaller than this are not worth partitioning
+constexpr size_t minFacesPerCluster = 10000;
+constexpr size_t partitionBins = 4096;
+
+constexpr int unassigned = -1;
+constexpr int border = -2;
+
+void requestAttributes(TriMesh& mesh) {
+    mesh.request_vertex_status();
+    mesh.request_edge_status();
+    mesh.request_face_status();
+}
+
+template <typename Handle>
+void copyAttributes(const TriMesh& src, Handle from, TriMesh& dst, Handle to) {
+    if (src.has_vertex_normals()) dst.set_normal(to, src.normal(from));
+    if (src.has_vertex_colors()) dst.set_color(to, src.color(from));
+    if (src.has_vertex_texcoords3D()) dst.set_texcoord3D(to, src.texcoord3D(from));
+}
+
+/**
+ * Assigns the faces to slabs along the longest axis of the bounding box, with about the same
+ * number of faces in each slab.
+ */
+std::vector<int> partitionFaces(const TriMesh& mesh, size_t clusters) {
+    TriMesh::Point lower;
+    TriMesh::Point upper;
+    lower.vectorize(std::numeric_limits<float>::max());
+    upper.vectorize(std::numeric_limits<float>::lowest());
+    for (auto vh : mesh.vertices()) {
+        lower.minimize(mesh.point(vh));
+        upper.maximize(mesh.point(vh));
+    }
+    const auto extent = upper - lower;
+    const int axis = extent[0] >= extent[1] && extent[0] >= extent[2] ? 0
+                     : extent[1] >= extent[2]                         ? 1
+                                                                      : 2;
+    const float scale = extent[axis] > 0.0f ? partitionBins / extent[axis] : 0.0f;
+
+    std::vector<size_t> faceBins(mesh.n_faces());
+    std::vector<size_t> histogram(partitionBins, 0);
+    for (auto fh : mesh.faces()) {
+        float center = 0.0f;
+        for (auto vh : mesh.fv_range(fh)) center += mesh.point(vh)[axis];
+        const auto bin = std::min(
+            partitionBins - 1, static_cast<size_t>((center / 3.0f - lower[axis]) * scale));
+        faceBins[fh.idx()] = bin;
+        ++histogram[bin];
+    }
+
+    std::vector<int> binCluster(partitionBins);
+    const size_t facesPerCluster = (mesh.n_faces() + clusters - 1) / clusters;
+    size_t count = 0;
+    for (size_t bin = 0; bin < partitionBins; ++bin) {
+        binCluster[bin] = static_cast<int>(std::min(clusters - 1, count / facesPerCluster));
+        count += histogram[bin];
+    }
+
+    std::vector<int> faceCluster(mesh.n_faces(), 0);
+    for (size_t i = 0; i < faceBins.size(); ++i) faceCluster[i] = binCluster[faceBins[i]];
+    return faceCluster;
+}
+
+struct Cluster {
+    TriMesh mesh;
+    // vertex index in the input mesh of each vertex of the cluster
+    std::vector<int> inputVertex;
+};
+
+}  // namespace
+
+void decimateParallel(TriMesh& mesh, VertexFraction vertexFraction, FaceFraction faceFraction,
+                      size_t clusters) {
+    const auto targetVertices = static_cast<size_t>(mesh.n_vertices() * vertexFraction.fraction);
+    const auto targetFaces = static_cast<size_t>(mesh.n_faces() * faceFraction.fraction);
+
+    if (clusters == 0) {
+        clusters = 2 * std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    clusters = std::min(clusters, mesh.n_faces() / minFacesPerCluster);
+    if (clusters < 2) {
+        detail::decimateMultipleChoice(mesh, targetVertices, targetFaces);
+        mesh.garbage_collection();
+        return;
+    }
+
+    const auto faceCluster = partitionFaces(mesh, clusters);
+
+    // vertices used by faces of several clusters are locked while the clusters are decimated
+    std::vector<int> vertexCluster(mesh.n_vertices(), unassigned);
+    std::vector<std::vector<TriMesh::FaceHandle>> clusterFaces(clusters);
+    for (auto fh : mesh.faces()) {
+        const int c = faceCluster[fh.idx()];
+        clusterFaces[c].push_back(fh);
+        for (auto vh : mesh.fv_range(fh)) {
+            auto& vc = vertexCluster[vh.idx()];
+            vc = vc == unassigned || vc == c ? c : border;
+        }
+    }
+
+    std::vector<Cluster> parts(clusters);
+    util::forEachParallel(parts, [&](Cluster& part, size_t c) {
+        auto& sub = part.mesh;
+        requestAttributes(sub);
+
+        std::unordered_map<int, TriMesh::VertexHandle> local;
+        local.reserve(clusterFaces[c].size());
+        for (auto fh : clusterFaces[c]) {
+            std::array<TriMesh::VertexHandle, 3> handles;
+            size_t i = 0;
+            for (auto vh : mesh.fv_range(fh)) {
+                auto [it, inserted] = local.try_emplace(vh.idx());
+                if (inserted) {
+                    it->second = sub.add_vertex(mesh.point(vh));
+                    copyAttributes(mesh, vh, sub, it->second);
+                    sub.status(it->second).set_locked(vertexCluster[vh.idx()] == border);
+                    part.inputVertex.push_back(vh.idx());
+                }
+                handles[i++] = it->second;
+            }
+            sub.add_face(handles[0], handles[1], handles[2]);
+        }
+
+        detail::decimateMultipleChoice(
+            sub, static_cast<size_t>(sub.n_vertices() * vertexFraction.fraction),
+            static_cast<size_t>(sub.n_faces() * faceFraction.fraction));
+    });
+
+    // stitch the clusters, the locked vertices are shared between them
+    TriMesh result;
+    requestAttributes(result);
+    std::vector<TriMesh::VertexHandle> borderVertices(mesh.n_vertices());
+    for (auto& part : parts) {
+        auto& sub = part.mesh;
+        std::vector<TriMesh::VertexHandle> handles(sub.n_vertices());
+        for (auto vh : sub.vertices()) {
+            const int input = part.inputVertex[vh.idx()];
+            const bool isBorder = vertexCluster[input] == border;
+            if (isBorder && borderVertices[input].is_valid()) {
+                handles[vh.idx()] = borderVertices[input];
+                continue;
+            }
+            handles[vh.idx()] = result.add_vertex(sub.point(vh));
+            copyAttributes(sub, vh, result, handles[vh.idx()]);
+            if (isBorder) borderVertices[input] = handles[vh.idx()];
+        }
+        for (auto fh : sub.faces()) {
+            std::array<TriMesh::VertexHandle, 3> face;
+            size_t i = 0;
+            for (auto vh : sub.fv_range(fh)) face[i++] = handles[vh.idx()];
+            result.add_face(face[0], face[1], face[2]);
+        }
+        sub.clear();
+    }
+
+    // the dense areas around the cluster borders are reduced in a final pass
+    detail::decimateMultipleChoice(result, targetVertices, targetFaces);
+    result.garbage_collection();
+    mesh = result;
+}
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
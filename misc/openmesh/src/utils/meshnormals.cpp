@@ -0,0 +1,152 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/openmesh/utils/meshnormals.h>
+
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/foreach.h>
+#include <modules/base/algorithm/meshutils.h>
+
+#include <numeric>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+namespace {
+
+// Returns the positions of the mesh, vec4 positions are converted into storage
+const std::vector<vec3>& positions(const Mesh& mesh, std::vector<vec3>& storage) {
+    const auto buffer = mesh.findBuffer(BufferType::PositionAttrib).first;
+    if (!buffer) {
+        throw Exception("Mesh has no position buffer",
+                        IVW_CONTEXT_CUSTOM("openmeshutil::computeVertexNormals"));
+    }
+    if (auto b3 = dynamic_cast<const Buffer<vec3>*>(buffer)) {
+        return b3->getRAMRepresentation()->getDataContainer();
+    } else if (auto b4 = dynamic_cast<const Buffer<vec4>*>(buffer)) {
+        const auto& src = b4->getRAMRepresentation()->getDataContainer();
+        storage.resize(src.size());
+        util::forEachParallel(src, [&](const vec4& p, size_t i) { storage[i] = vec3{p} / p.w; });
+        return storage;
+    } else {
+        throw Exception("Unknown position buffer type",
+                        IVW_CONTEXT_CUSTOM("openmeshutil::computeVertexNormals"));
+    }
+}
+
+std::vector<glm::u32vec3> triangles(const Mesh& mesh, size_t numVertices) {
+    std::vector<glm::u32vec3> res;
+    const auto add = [&](std::uint32_t i0, std::uint32_t i1, std::uint32_t i2) {
+        if (i0 < numVertices && i1 < numVertices && i2 < numVertices) {
+            res.emplace_back(i0, i1, i2);
+        }
+    };
+    for (const auto& ib : mesh.getIndexBuffers()) {
+        if (ib.first.dt == DrawType::Triangles) {
+            res.reserve(res.size() + ib.second->getSize() / 3);
+            meshutil::forEachTriangle(ib.first, *ib.second, add);
+        }
+    }
+    // A mesh without index buffers draws its vertices in order
+    if (mesh.getIndexBuffers().empty() && mesh.getDefaultMeshInfo().dt == DrawType::Triangles) {
+        res.reserve(numVertices / 3);
+        for (std::uint32_t i = 0; i + 2 < numVertices; i += 3) add(i, i + 1, i + 2);
+    }
+    return res;
+}
+
+}  // namespace
+
+std::vector<vec3> computeVertexNormals(const Mesh& mesh, NormalWeighting weighting) {
+    std::vector<vec3> storage;
+    const auto& pos = positions(mesh, storage);
+    const auto tris = triangles(mesh, pos.size());
+
+    // Unnormalized face normals, their length is twice the area of the triangle
+    std::vector<vec3> faceNormals(tris.size());
+    util::forEachParallel(tris, [&](const glm::u32vec3& t, size_t i) {
+        faceNormals[i] = glm::cross(pos[t[1]] - pos[t[0]], pos[t[2]] - pos[t[0]]);
+    });
+
+    // Vertex-to-face adjacency in compressed sparse row format, each entry is the corner
+    // 3 * face + k of the triangle touching the vertex
+    std::vector<std::uint32_t> offsets(pos.size() + 1, 0);
+    for (const auto& t : tris) {
+        ++offsets[t[0] + 1];
+        ++offsets[t[1] + 1];
+        ++offsets[t[2] + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::uint32_t> corners(offsets.back());
+    {
+        auto next = offsets;
+        for (std::uint32_t f = 0; f < static_cast<std::uint32_t>(tris.size()); ++f) {
+            for (std::uint32_t k = 0; k < 3; ++k) corners[next[tris[f][k]]++] = 3 * f + k;
+        }
+    }
+
+    const auto weight = [&](std::uint32_t corner) -> vec3 {
+        const auto f = corner / 3;
+        const auto k = corner % 3;
+        switch (weighting) {
+            case NormalWeighting::Angle: {
+                const auto& t = tris[f];
+                const auto e1 = glm::normalize(pos[t[(k + 1) % 3]] - pos[t[k]]);
+                const auto e2 = glm::normalize(pos[t[(k + 2) % 3]] - pos[t[k]]);
+                const auto angle = std::acos(glm::clamp(glm::dot(e1, e2), -1.0f, 1.0f));
+                return glm::normalize(faceNormals[f]) * angle;
+            }
+            case NormalWeighting::Equal:
+                return glm::normalize(faceNormals[f]);
+            case NormalWeighting::Area:
+            default:
+                return faceNormals[f];
+        }
+    };
+
+    std::vector<vec3> normals(pos.size());
+    util::forEachParallel(normals, [&](const vec3&, size_t v) {
+        vec3 n{0.0f};
+        for (auto c = offsets[v]; c < offsets[v + 1]; ++c) {
+            const auto w = weight(corners[c]);
+            // Skip degenerate triangles, they would add NaNs for angle and equal weighting
+            if (!glm::any(glm::isnan(w))) n += w;
+        }
+        const auto length = glm::length(n);
+        normals[v] = length > 0.0f ? n / length : vec3{0.0f};
+    });
+
+    return normals;
+}
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
@@ -30,121 +30,132 @@
 #include <inviwo/openmesh/utils/openmeshconverters.h>
 
 #include <inviwo/core/datastructures/geometry/typedmesh.h>
-#include <inviwo/core/util/zip.h>
+#include <inviwo/core/util/foreach.h>
 #include <inviwo/core/datastructures/geometry/simplemesh.h>
 
 namespace inviwo {
 namespace openmeshutil {
 namespace detail {
 
-void createVertexBuffers(TriMesh& mesh, const BasicMesh& inmesh, TransformCoordinates transform) {
-    auto& vertices = inmesh.getVertices()->getRAMRepresentation()->getDataContainer();
-    auto& normals = inmesh.getNormals()->getRAMRepresentation()->getDataContainer();
-    auto& texCoords = inmesh.getTexCoords()->getRAMRepresentation()->getDataContainer();
-    auto& colors = inmesh.getColors()->getRAMRepresentation()->getDataContainer();
+using VH = OpenMesh::VertexHandle;
 
-    mat4 m{1.0f};
+mat4 transformMatrix(const Mesh& inmesh, TransformCoordinates transform) {
     if (transform == TransformCoordinates::DataToModel) {
-        m = inmesh.getCoordinateTransformer().getDataToModelMatrix();
+        return inmesh.getCoordinateTransformer().getDataToModelMatrix();
     } else if (transform == TransformCoordinates::DataToWorld) {
-        m = inmesh.getCoordinateTransformer().getDataToWorldMatrix();
+        return inmesh.getCoordinateTransformer().getDataToWorldMatrix();
+    } else {
+        return mat4{1.0f};
     }
+}
 
-    for (const auto& [pos, normal, texCoord, color] :
-         util::zip(vertices, normals, texCoords, colors)) {
-        auto i = [&](const auto& pos) {
-            if (transform == TransformCoordinates::NoTransform) {
-                return mesh.add_vertex({pos.x, pos.y, pos.z});
-            } else {
-                auto pos4 = m * vec4{pos, 1};
-                return mesh.add_vertex({pos4.x / pos4.w, pos4.y / pos4.w, pos4.z / pos4.w});
-            }
-        }(pos);
+/**
+ * Allocates all vertices of the mesh at once and fills the positions in parallel.
+ */
+template <typename T, typename Transform>
+void addVertices(TriMesh& mesh, const std::vector<T>& positions, Transform transform) {
+    const auto offset = mesh.n_vertices();
+    mesh.resize(offset + positions.size(), mesh.n_edges(), mesh.n_faces());
+    util::forEachParallel(positions, [&](const T& pos, size_t i) {
+        const auto v = transform(pos);
+        mesh.point(VH(static_cast<int>(offset + i))) = {v.x, v.y, v.z};
+    });
+}
 
+/**
+ * Calls func(vertexHandle, value) in parallel for each value that has a matching vertex.
+ */
+template <typename T, typename Func>
+void setAttribute(TriMesh& mesh, const std::vector<T>& values, Func func) {
+    const auto size = mesh.n_vertices();
+    util::forEachParallel(values, [&](const T& value, size_t i) {
+        if (i < size) func(VH(static_cast<int>(i)), value);
+    });
+}
+
+template <typename T>
+auto positionTransform(const mat4& m, TransformCoordinates transform) {
+    return [m, transform](const T& pos) {
+        if (transform == TransformCoordinates::NoTransform) {
+            return vec3{pos};
+        } else {
+            const auto pos4 = m * vec4{pos, 1};
+            return vec3{pos4} / pos4.w;
+        }
+    };
+}
+
+void createVertexBuffers(TriMesh& mesh, const BasicMesh& inmesh, TransformCoordinates transform) {
+    auto& vertices = inmesh.getVertices()->getRAMRepresentation()->getDataContainer();
+    auto& normals = inmesh.getNormals()->getRAMRepresentation()->getDataContainer();
+    auto& texCoords = inmesh.getTexCoords()->getRAMRepresentation()->getDataContainer();
+    auto& colors = inmesh.getColors()->getRAMRepresentation()->getDataContainer();
+
+    const auto m = transformMatrix(inmesh, transform);
+    addVertices(mesh, vertices, positionTransform<vec3>(m, transform));
+    setAttribute(mesh, normals, [&](VH i, const vec3& normal) {
         mesh.set_normal(i, {normal.x, normal.y, normal.z});
+    });
+    setAttribute(mesh, texCoords, [&](VH i, const vec3& texCoord) {
         mesh.set_texcoord3D(i, {texCoord.x, texCoord.y, texCoord.z});
+    });
+    setAttribute(mesh, colors, [&](VH i, const vec4& color) {
         mesh.set_color(i, {color.r, color.g, color.b, color.a});
-    }
+    });
 }
 
 void createVertexBuffers(TriMesh& mesh, const SimpleMesh& inmesh, TransformCoordinates transform) {
-
     auto& vertices = inmesh.getVertexList()->getRAMRepresentation()->getDataContainer();
     auto& texCoords = inmesh.getTexCoordList()->getRAMRepresentation()->getDataContainer();
     auto& colors = inmesh.getColorList()->getRAMRepresentation()->getDataContainer();
 
-    mat4 m{1.0f};
-    if (transform == TransformCoordinates::DataToModel) {
-        m = inmesh.getCoordinateTransformer().getDataToModelMatrix();
-    } else if (transform == TransformCoordinates::DataToWorld) {
-        m = inmesh.getCoordinateTransformer().getDataToWorldMatrix();
-    }
-
-    for (const auto& [pos, texCoord, color] : util::zip(vertices, texCoords, colors)) {
-        auto i = [&](const auto& pos) {
-            if (transform == TransformCoordinates::NoTransform) {
-                return mesh.add_vertex({pos.x, pos.y, pos.z});
-            } else {
-                auto pos4 = m * vec4{pos, 1};
-                return mesh.add_vertex({pos4.x / pos4.w, pos4.y / pos4.w, pos4.z / pos4.w});
-            }
-        }(pos);
+    const auto m = transformMatrix(inmesh, transform);
+    addVertices(mesh, vertices, positionTransform<vec3>(m, transform));
+    setAttribute(mesh, texCoords, [&](VH i, const vec3& texCoord) {
         mesh.set_texcoord3D(i, {texCoord.x, texCoord.y, texCoord.z});
+    });
+    setAttribute(mesh, colors, [&](VH i, const vec4& color) {
         mesh.set_color(i, {color.r, color.g, color.b, color.a});
-    }
+    });
 }
 
 void createVertexBuffers(TriMesh& mesh, const Mesh& inmesh, TransformCoordinates transform) {
-
-    mat4 m{1.0f};
-    if (transform == TransformCoordinates::DataToModel) {
-        m = inmesh.getCoordinateTransformer().getDataToModelMatrix();
-    } else if (transform == TransformCoordinates::DataToWorld) {
-        m = inmesh.getCoordinateTransformer().getDataToWorldMatrix();
-    }
+    const auto m = transformMatrix(inmesh, transform);
 
     for (auto& buf : inmesh.getBuffers()) {
         if (buf.first.type == BufferType::PositionAttrib) {
-            auto loop = [&](auto buf, auto t) {
-                for (auto& v1 : buf->getRAMRepresentation()->getDataContainer()) {
-                    auto v = t(v1);
-                    mesh.add_vertex({v.x, v.y, v.z});
-                }
-            };
-
             if (auto b4 = std::dynamic_pointer_cast<const Buffer<vec4>>(buf.second)) {
-                loop(b4, [&m](auto v) { return m * v; });
+                addVertices(mesh, b4->getRAMRepresentation()->getDataContainer(),
+                            [&m](const vec4& v) { return m * v; });
             } else if (auto b3 = std::dynamic_pointer_cast<const Buffer<vec3>>(buf.second)) {
-                loop(b3, [&m](auto v) {
-                    auto tmp = m * vec4{v, 1.f};
-                    return vec3(tmp) / tmp.w;
-                });
+                addVertices(mesh, b3->getRAMRepresentation()->getDataContainer(),
+                            [&m](const vec3& v) {
+                                auto tmp = m * vec4{v, 1.f};
+                                return vec3(tmp) / tmp.w;
+                            });
             } else {
                 throw inviwo::Exception("Unknown position buffer type",
                                         IvwContextCustom("openmeshutil::meshHelper"));
             }
         }
     }
-    using VH = OpenMesh::VertexHandle;
     // Make a second loop for other buffers, to make sure the Positions has been added first
     for (auto& buf : inmesh.getBuffers()) {
         if (buf.first.type == BufferType::NormalAttrib) {
             if (auto b3 = std::dynamic_pointer_cast<const Buffer<vec3>>(buf.second)) {
-                int i = 0;
-                for (auto& n : b3->getRAMRepresentation()->getDataContainer()) {
-                    mesh.set_normal(VH(i++), {n.x, n.y, n.z});
-                }
+                setAttribute(mesh, b3->getRAMRepresentation()->getDataContainer(),
+                             [&](VH i, const vec3& n) { mesh.set_normal(i, {n.x, n.y, n.z}); });
             } else {
                 throw inviwo::Exception("Unknown normals buffer type",
                                         IvwContextCustom("openmeshutil::meshHelper"));
             }
         } else if (buf.first.type == BufferType::ColorAttrib) {
             auto loop = [&](auto& buf, auto toVec4) {
-                int i = 0;
-                for (auto& v : buf->getRAMRepresentation()->getDataContainer()) {
-                    auto c = toVec4(v);
-                    mesh.set_color(VH(i++), {c.x, c.y, c.z, c.a});
-                }
+                setAttribute(mesh, buf->getRAMRepresentation()->getDataContainer(),
+                             [&](VH i, const auto& v) {
+                                 auto c = toVec4(v);
+                                 mesh.set_color(i, {c.x, c.y, c.z, c.a});
+                             });
             };
 
             if (auto f3 = std::dynamic_pointer_cast<const Buffer<vec3>>(buf.second)) {
@@ -161,25 +172,19 @@ void createVertexBuffers(TriMesh& mesh, const Mesh& inmesh, TransformCoordinates
             }
         } else if (buf.first.type == BufferType::TexCoordAttrib) {
             if (auto t1 = std::dynamic_pointer_cast<const Buffer<float>>(buf.second)) {
-                int i = 0;
-                for (auto& v : t1->getRAMRepresentation()->getDataContainer()) {
-                    mesh.set_texcoord3D(VH(i++), {v, 0, 0});
-                }
+                setAttribute(mesh, t1->getRAMRepresentation()->getDataContainer(),
+                             [&](VH i, const float& v) { mesh.set_texcoord3D(i, {v, 0, 0}); });
             } else if (auto t2 = std::dynamic_pointer_cast<const Buffer<vec2>>(buf.second)) {
-                int i = 0;
-                for (auto& v : t2->getRAMRepresentation()->getDataContainer()) {
-                    mesh.set_texcoord3D(VH(i++), {v.x, v.y, 0});
-                }
+                setAttribute(mesh, t2->getRAMRepresentation()->getDataContainer(),
+                             [&](VH i, const vec2& v) { mesh.set_texcoord3D(i, {v.x, v.y, 0}); });
             } else if (auto t3 = std::dynamic_pointer_cast<const Buffer<vec3>>(buf.second)) {
-                int i = 0;
-                for (auto& v : t3->getRAMRepresentation()->getDataContainer()) {
-                    mesh.set_texcoord3D(VH(i++), {v.x, v.y, v.z});
-                }
+                setAttribute(
+                    mesh, t3->getRAMRepresentation()->getDataContainer(),
+                    [&](VH i, const vec3& v) { mesh.set_texcoord3D(i, {v.x, v.y, v.z}); });
             } else if (auto t4 = std::dynamic_pointer_cast<const Buffer<vec4>>(buf.second)) {
-                int i = 0;
-                for (auto& v : t4->getRAMRepresentation()->getDataContainer()) {
-                    mesh.set_texcoord3D(VH(i++), {v.x, v.y, v.z});
-                }
+                setAttribute(
+                    mesh, t4->getRAMRepresentation()->getDataContainer(),
+                    [&](VH i, const vec4& v) { mesh.set_texcoord3D(i, {v.x, v.y, v.z}); });
             } else {
                 throw inviwo::Exception("Unknown normals buffer type",
                                         IvwContextCustom("openmeshutil::meshHelper"));
@@ -193,6 +198,14 @@ void createVertexBuffers(TriMesh& mesh, const Mesh& inmesh, TransformCoordinates
 TriMesh fromInviwo(const Mesh& inmesh, TransformCoordinates transform) {
     TriMesh mesh;
 
+    // The vertices are allocated in one go when the positions are added, reserve the
+    // connectivity up front as well. A closed triangle mesh has about 3/2 edges per face.
+    size_t numTriangles = 0;
+    for (auto& ib : inmesh.getIndexBuffers()) {
+        if (ib.first.dt == DrawType::Triangles) numTriangles += ib.second->getSize() / 3;
+    }
+    mesh.reserve(0, 3 * numTriangles / 2, numTriangles);
+
     if (auto bm = dynamic_cast<const BasicMesh*>(&inmesh)) {
         detail::createVertexBuffers(mesh, *bm, transform);
     } else if (auto sm = dynamic_cast<const SimpleMesh*>(&inmesh)) {
@@ -201,12 +214,17 @@ TriMesh fromInviwo(const Mesh& inmesh, TransformCoordinates transform) {
         detail::createVertexBuffers(mesh, inmesh, transform);
     }
 
+    // Faces are built in a single pass, the half edge connectivity has to be added sequentially.
+    const auto numVerts = static_cast<std::uint32_t>(mesh.n_vertices());
     for (auto& ib : inmesh.getIndexBuffers()) {
         if (ib.first.dt == DrawType::Triangles) {
             meshutil::forEachTriangle(ib.first, *ib.second,
-                                      [&mesh](uint32_t i0, uint32_t i1, uint32_t i2) {
-                                          using VH = OpenMesh::VertexHandle;
-                                          mesh.add_face(VH(i0), VH(i1), VH(i2));
+                                      [&mesh, numVerts](uint32_t i0, uint32_t i1, uint32_t i2) {
+                                          if (i0 >= numVerts || i1 >= numVerts || i2 >= numVerts) {
+                                              return;
+                                          }
+                                          mesh.add_face(detail::VH(i0), detail::VH(i1),
+                                                        detail::VH(i2));
                                       });
         }
     }
@@ -0,0 +1,265 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/openmesh/utils/progressivemesh.h>
+#include <inviwo/core/util/exception.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace inviwo {
+
+namespace openmeshutil {
+
+namespace {
+
+/**
+ * Binary decimater module recording every collapse, see OpenMesh::Decimater::ModProgMeshT
+ */
+template <typename MeshT>
+class ModCollapseRecorderT : public OpenMesh::Decimater::ModBaseT<MeshT> {
+public:
+    DECIMATING_MODULE(ModCollapseRecorderT, MeshT, CollapseRecorder);
+
+    explicit ModCollapseRecorderT(MeshT& mesh) : Base(mesh, true) {}
+
+    virtual void preprocess_collapse(const CollapseInfo& ci) override {
+        collapses.push_back({static_cast<std::uint32_t>(ci.v0.idx()),
+                             static_cast<std::uint32_t>(ci.v1.idx()), ci.fl.idx(), ci.fr.idx(),
+                             static_cast<float>((ci.p1 - ci.p0).norm())});
+    }
+
+    std::vector<ProgressiveMesh::Collapse> collapses;
+};
+
+/**
+ * Decimates \p mesh to \p faces faces, @return the collapses and the removed faces
+ */
+template <typename Decimater>
+std::pair<std::vector<ProgressiveMesh::Collapse>, std::vector<bool>> decimateAndRecord(
+    TriMesh& mesh, size_t faces) {
+    using HModQuadric = typename OpenMesh::Decimater::ModQuadricT<TriMesh>::Handle;
+    using HModRecorder = typename ModCollapseRecorderT<TriMesh>::Handle;
+
+    Decimater decimater(mesh);
+    HModQuadric hModQuadric;
+    HModRecorder hModRecorder;
+
+    decimater.add(hModQuadric);
+    decimater.add(hModRecorder);
+    decimater.module(hModQuadric).unset_max_err();
+    decimater.initialize();
+    decimater.decimate_to_faces(0, faces);
+
+    // The status flags are released together with the decimater
+    std::vector<bool> removed(mesh.n_faces());
+    for (size_t i = 0; i < removed.size(); ++i) {
+        removed[i] = mesh.status(OpenMesh::FaceHandle(static_cast<int>(i))).deleted();
+    }
+    return {std::move(decimater.module(hModRecorder).collapses), std::move(removed)};
+}
+
+constexpr auto noVertex = std::numeric_limits<std::uint32_t>::max();
+
+}  // namespace
+
+ProgressiveMesh::ProgressiveMesh(size_t numVertices,
+                                 const std::vector<std::array<std::uint32_t, 3>>& faces,
+                                 const std::vector<Collapse>& collapses,
+                                 const std::vector<bool>& removed) {
+    const auto numSplits = collapses.size();
+    if (numSplits > numVertices || removed.size() != faces.size()) {
+        throw Exception(fmt::format("{} collapses and {} removal flags do not match {} vertices "
+                                    "and {} faces",
+                                    numSplits, removed.size(), numVertices, faces.size()),
+                        IVW_CONTEXT);
+    }
+    numBaseVertices_ = numVertices - numSplits;
+
+    // Split j undoes the collapse numSplits - 1 - j and adds vertex j at level j + 1
+    std::vector<size_t> introduced(numVertices, 0);
+    std::vector<std::uint32_t> parents(numVertices, noVertex);
+    std::vector<size_t> appears(faces.size(), 0);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        // Removed faces not listed by a collapse are only part of the finest level
+        if (removed[i]) appears[i] = numSplits;
+    }
+
+    splits_.resize(numSplits);
+    errors_.assign(numSplits + 1, 0.0f);
+    for (size_t j = 0; j < numSplits; ++j) {
+        const auto& collapse = collapses[numSplits - 1 - j];
+        if (collapse.from >= numVertices || collapse.to >= numVertices) {
+            throw Exception(fmt::format("Collapse of vertex {} onto {} out of range, the mesh has "
+                                        "{} vertices",
+                                        collapse.from, collapse.to, numVertices),
+                            IVW_CONTEXT);
+        }
+        splits_[j] = {collapse.from, collapse.to};
+        introduced[collapse.from] = j + 1;
+        parents[collapse.from] = collapse.to;
+        for (const auto face : {collapse.left, collapse.right}) {
+            if (face < 0) continue;
+            if (static_cast<size_t>(face) >= faces.size()) {
+                throw Exception(fmt::format("Collapse removes face {} out of range, the mesh has "
+                                            "{} faces",
+                                            face, faces.size()),
+                                IVW_CONTEXT);
+            }
+            appears[face] = j + 1;
+        }
+    }
+    for (size_t j = numSplits; j-- > 0;) {
+        errors_[j] = std::max(errors_[j + 1], collapses[numSplits - 1 - j].distance);
+    }
+
+    // Order the faces by the level they appear at
+    faceCounts_.assign(numSplits + 2, 0);
+    for (const auto level : appears) ++faceCounts_[level + 1];
+    for (size_t k = 1; k < faceCounts_.size(); ++k) faceCounts_[k] += faceCounts_[k - 1];
+    std::vector<size_t> order(faces.size());
+    {
+        auto next = faceCounts_;
+        for (size_t i = 0; i < faces.size(); ++i) order[next[appears[i]]++] = i;
+    }
+    // faceCounts_[k + 1] is now the number of faces of level k
+    faceCounts_.erase(faceCounts_.begin());
+
+    // Each corner starts at the ancestor of its vertex at the level of the face and is updated
+    // by the splits adding the vertices further down the chain of parents
+    std::vector<size_t> updateCounts(numSplits + 1, 0);
+    std::vector<std::pair<size_t, std::uint32_t>> updates;
+    corners_.resize(3 * faces.size());
+    for (size_t f = 0; f < order.size(); ++f) {
+        const auto face = order[f];
+        const auto level = appears[face];
+        for (size_t i = 0; i < 3; ++i) {
+            auto vertex = faces[face][i];
+            if (vertex >= numVertices) {
+                throw Exception(fmt::format("Face {} refers to vertex {} out of range, the mesh "
+                                            "has {} vertices",
+                                            face, vertex, numVertices),
+                                IVW_CONTEXT);
+            }
+            const auto corner = static_cast<std::uint32_t>(3 * f + i);
+            while (introduced[vertex] > level) {
+                const auto split = introduced[vertex] - 1;
+                updates.emplace_back(split, corner);
+                ++updateCounts[split + 1];
+                vertex = parents[vertex];
+            }
+            corners_[corner] = vertex;
+        }
+    }
+
+    for (size_t j = 1; j < updateCounts.size(); ++j) updateCounts[j] += updateCounts[j - 1];
+    updateOffsets_ = updateCounts;
+    updateCorners_.resize(updates.size());
+    for (const auto& [split, corner] : updates) updateCorners_[updateCounts[split]++] = corner;
+}
+
+std::vector<std::uint32_t> ProgressiveMesh::getVertexOrder() const {
+    std::vector<bool> split(numBaseVertices_ + splits_.size(), false);
+    for (const auto& s : splits_) split[s.vertex] = true;
+
+    std::vector<std::uint32_t> order;
+    order.reserve(split.size());
+    for (size_t i = 0; i < split.size(); ++i) {
+        if (!split[i]) order.push_back(static_cast<std::uint32_t>(i));
+    }
+    for (const auto& s : splits_) order.push_back(s.vertex);
+    return order;
+}
+
+size_t ProgressiveMesh::levelForFaces(size_t faces) const {
+    const auto it = std::lower_bound(faceCounts_.begin(), faceCounts_.end(), faces);
+    return std::min(static_cast<size_t>(it - faceCounts_.begin()), splits_.size());
+}
+
+size_t ProgressiveMesh::levelForError(float error) const {
+    // The errors are non-increasing with the level
+    const auto it = std::lower_bound(errors_.begin(), errors_.end(), error,
+                                     [](float levelError, float e) { return levelError > e; });
+    return std::min(static_cast<size_t>(it - errors_.begin()), splits_.size());
+}
+
+std::vector<std::uint32_t> ProgressiveMesh::getIndices(size_t level) const {
+    std::vector<std::uint32_t> indices(corners_.begin(), corners_.begin() + 3 * faceCounts_[0]);
+    updateIndices(indices, 0, level);
+    return indices;
+}
+
+void ProgressiveMesh::updateIndices(std::vector<std::uint32_t>& indices, size_t from,
+                                    size_t to) const {
+    to = std::min(to, splits_.size());
+    for (auto j = from; j < to; ++j) {
+        // The faces added by split j already refer to its vertex
+        indices.insert(indices.end(), corners_.begin() + 3 * faceCounts_[j],
+                       corners_.begin() + 3 * faceCounts_[j + 1]);
+        for (auto i = updateOffsets_[j]; i < updateOffsets_[j + 1]; ++i) {
+            indices[updateCorners_[i]] = splits_[j].vertex;
+        }
+    }
+    for (auto j = from; j-- > to;) {
+        for (auto i = updateOffsets_[j]; i < updateOffsets_[j + 1]; ++i) {
+            indices[updateCorners_[i]] = splits_[j].parent;
+        }
+        indices.resize(3 * faceCounts_[j]);
+    }
+}
+
+ProgressiveMesh createProgressiveMesh(const TriMesh& mesh, FaceFraction baseFaces,
+                                      DecimationEngine engine) {
+    std::vector<std::array<std::uint32_t, 3>> faces;
+    faces.reserve(mesh.n_faces());
+    for (const auto face : mesh.faces()) {
+        std::array<std::uint32_t, 3> corners{};
+        size_t i = 0;
+        for (auto v_it = mesh.cfv_begin(face); v_it != mesh.cfv_end(face) && i < 3; ++v_it) {
+            corners[i++] = static_cast<std::uint32_t>(v_it->idx());
+        }
+        faces.push_back(corners);
+    }
+
+    TriMesh decimated{mesh};
+    const auto targetFaces = static_cast<size_t>(mesh.n_faces() * baseFaces.fraction);
+    const auto [collapses, removed] =
+        engine == DecimationEngine::Heap
+            ? decimateAndRecord<OpenMesh::Decimater::DecimaterT<TriMesh>>(decimated, targetFaces)
+            : decimateAndRecord<OpenMesh::Decimater::McDecimaterT<TriMesh>>(decimated,
+                                                                            targetFaces);
+    return ProgressiveMesh{mesh.n_vertices(), faces, collapses, removed};
+}
+
+}  // namespace openmeshutil
+
+}  // namespace inviwo
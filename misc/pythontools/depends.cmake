@@ -2,6 +2,7 @@
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
     InviwoPython3Module 
+    InviwoOpenGLModule
 )
 
 # Mark the module as protected to prevent it from being reloaded
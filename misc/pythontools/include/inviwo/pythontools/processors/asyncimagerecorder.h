@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/pythontools/properties/framerecorderproperty.h>
+#include <inviwo/pythontools/util/framerecorder.h>
+
+#include <memory>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.AsyncImageRecorder, Async Image Recorder}
+ * ![](org.inviwo.AsyncImageRecorder.png?classIdentifier=org.inviwo.AsyncImageRecorder)
+ *
+ * Records the color layer of the input image without stalling the network. The layer is read
+ * back asynchronously into pixel buffer objects and handed to a pool of encoder threads once the
+ * GPU has finished the transfer, a frame is thus written while the following frames are
+ * rendered. Frames are either written as an image sequence, e.g. PNG or EXR depending on the
+ * extension of the file, or piped to FFmpeg. See FrameRecorder.
+ *
+ * ### Inports
+ *   * __inport__ Image to record, passed on unchanged
+ *
+ * ### Outports
+ *   * __outport__ The input image
+ *
+ * ### Properties
+ *   * __Recording__ Output settings
+ *     * __File__ Output file. For image sequences, the frame number is appended to the file name.
+ *     * __Output__ Image sequence or FFmpeg
+ *     * __Encoder Threads__ Number of threads writing image files
+ *     * __Queue Size__ Maximum number of frames waiting to be written before recording blocks
+ *     * __FFmpeg Executable__ Path to, or name of, the ffmpeg executable
+ *     * __FFmpeg Arguments__ Output arguments passed to FFmpeg, e.g. codec and quality
+ *     * __Frame Rate__ Frame rate of the video
+ *   * __Start Recording__ / __Stop Recording__ Records all frames processed in between
+ */
+class IVW_MODULE_PYTHONTOOLS_API AsyncImageRecorder : public Processor {
+public:
+    AsyncImageRecorder();
+    virtual ~AsyncImageRecorder();
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void start();
+    void stop();
+
+    ImageInport inport_;
+    ImageOutport outport_;
+
+    FrameRecorderProperty recording_;
+    ButtonProperty start_;
+    ButtonProperty stop_;
+
+    std::unique_ptr<FrameRecorder> recorder_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,128 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
+#include <inviwo/pythontools/properties/framerecorderproperty.h>
+#include <inviwo/pythontools/util/camerapath.h>
+#include <inviwo/pythontools/util/framerecorder.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.CameraPathRenderer, Camera Path Renderer}
+ * ![](org.inviwo.CameraPathRenderer.png?classIdentifier=org.inviwo.CameraPathRenderer)
+ *
+ * Renders a camera path frame by frame and records the resulting images. The path is given by
+ * the same control points as used by the Python CameraTrajectory processor, and the keyframes
+ * property can be linked to its control points. The path is evaluated natively with the same
+ * cubic spline, and the frames are rendered back to back: once a frame arrives at the inport,
+ * its readback is started and the camera is moved to the next pose. The camera property is
+ * meant to be linked to the camera of the renderer producing the input image.
+ *
+ * ### Inports
+ *   * __inport__ Image rendered with the current camera, passed on unchanged
+ *
+ * ### Outports
+ *   * __outport__ The input image
+ *
+ * ### Properties
+ *   * __Keyframes__ Control points as JSON, {"from": [[x, y, z], ...], "to": ..., "up": ...}
+ *   * __Steps__ Number of frames per control point
+ *   * __Frame__ Frame of the path applied to the camera
+ *   * __Frame Range__ Frames to render
+ *   * __Camera__ Camera set to the poses of the path
+ *   * __Recording__ Output settings, see Async Image Recorder
+ *   * __Write Timing__ Write the render and readback time of each frame to
+ *     <file>_timing.csv
+ *   * __Render__ Render and record all frames in the frame range
+ *   * __Cancel__ Stop rendering, frames rendered so far are kept
+ */
+class IVW_MODULE_PYTHONTOOLS_API CameraPathRenderer : public Processor {
+public:
+    CameraPathRenderer();
+    virtual ~CameraPathRenderer();
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct FrameTiming {
+        size_t frame;
+        double renderMs;
+        double recordMs;
+    };
+
+    void updatePath();
+    void applyPose(size_t frame);
+    void start();
+    void renderFrame(size_t frame);
+    void stop();
+    void writeTiming() const;
+
+    ImageInport inport_;
+    ImageOutport outport_;
+
+    StringProperty keyframes_;
+    IntSizeTProperty steps_;
+    IntSizeTProperty frame_;
+    IntSizeTMinMaxProperty frameRange_;
+    CameraProperty camera_;
+    FrameRecorderProperty recording_;
+    BoolProperty writeTiming_;
+    ButtonProperty render_;
+    ButtonProperty cancel_;
+
+    std::vector<util::CameraPose> poses_;
+    std::unique_ptr<FrameRecorder> recorder_;
+    bool awaitingFrame_ = false;
+    size_t currentFrame_ = 0;
+    clock::time_point frameStart_;
+    clock::time_point renderStart_;
+    std::vector<FrameTiming> timings_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,231 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/datareaderfactory.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/filepatternproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/pythontools/util/fileprefetcher.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace inviwo {
+
+/**
+ * Type specific parts of a FileSequenceSource: the outport, how to turn loaded data into the
+ * data of the outport, and which representation to create while prefetching.
+ */
+template <typename DataType>
+struct FileSequenceSourceTraits;
+
+template <>
+struct FileSequenceSourceTraits<Volume> {
+    using Outport = VolumeOutport;
+    static void preload(const Volume& volume) { volume.getRepresentation<VolumeRAM>(); }
+    static std::shared_ptr<Volume> output(std::shared_ptr<Volume> volume) { return volume; }
+};
+
+template <>
+struct FileSequenceSourceTraits<Layer> {
+    using Outport = ImageOutport;
+    static void preload(const Layer& layer) { layer.getRepresentation<LayerRAM>(); }
+    static std::shared_ptr<Image> output(std::shared_ptr<Layer> layer) {
+        return std::make_shared<Image>(layer);
+    }
+};
+
+/** \docpage{org.inviwo.VolumeFileSequenceSource, Volume File Sequence Source}
+ * ![](org.inviwo.VolumeFileSequenceSource.png?classIdentifier=org.inviwo.VolumeFileSequenceSource)
+ * Steps through the files matching a pattern, like the FileGlob processor, but loads the files
+ * itself. The pattern is resolved once and the files following the current one, in the direction
+ * of the last step, are loaded on a background thread. Stepping through a sequence is thus not
+ * limited by disk latency as long as the files are loaded faster than they are shown.
+ *
+ * ### Outports
+ *   * __outport__ The current file
+ *
+ * ### Properties
+ *   * __Files__ Pattern of the files, sorted by name
+ *   * __Index__ Index of the current file
+ *   * __Prefetch__ Number of files loaded ahead of the current one
+ *   * __Current File__ Path of the current file
+ */
+template <typename DataType>
+class FileSequenceSource : public Processor {
+public:
+    using Traits = FileSequenceSourceTraits<DataType>;
+
+    FileSequenceSource();
+    virtual ~FileSequenceSource() = default;
+
+    virtual void process() override;
+    virtual const ProcessorInfo getProcessorInfo() const override;
+
+private:
+    std::unique_ptr<FilePrefetcher<DataType>> createPrefetcher() const;
+
+    typename Traits::Outport outport_;
+    FilePatternProperty files_;
+    IntSizeTProperty index_;
+    IntSizeTProperty prefetch_;
+    StringProperty currentFile_;
+
+    std::unique_ptr<FilePrefetcher<DataType>> prefetcher_;
+};
+
+template <typename DataType>
+FileSequenceSource<DataType>::FileSequenceSource()
+    : Processor()
+    , outport_("outport")
+    , files_("files", "Files", "")
+    , index_("index", "Index", 0, 0, 0)
+    , prefetch_("prefetch", "Prefetch", 4, 0, 64)
+    , currentFile_("currentFile", "Current File") {
+
+    addPort(outport_);
+
+    for (const auto& ext :
+         InviwoApplication::getPtr()->getDataReaderFactory()->getExtensionsForType<DataType>()) {
+        files_.addNameFilter(ext);
+    }
+    currentFile_.setReadOnly(true);
+    addProperties(files_, index_, prefetch_, currentFile_);
+
+    files_.onChange([this]() { prefetcher_.reset(); });
+    prefetch_.onChange([this]() {
+        if (prefetcher_) prefetcher_->setPrefetch(prefetch_);
+    });
+}
+
+template <typename DataType>
+void FileSequenceSource<DataType>::process() {
+    if (!prefetcher_) {
+        prefetcher_ = createPrefetcher();
+        index_.setMaxValue(std::max(prefetcher_->size(), size_t{1}) - 1);
+    }
+    if (prefetcher_->size() == 0) {
+        outport_.clear();
+        currentFile_.set("");
+        return;
+    }
+
+    const size_t index = std::min(index_.get(), prefetcher_->size() - 1);
+    currentFile_.set(prefetcher_->files()[index]);
+    outport_.setData(Traits::output(prefetcher_->get(index)));
+}
+
+template <typename DataType>
+std::unique_ptr<FilePrefetcher<DataType>> FileSequenceSource<DataType>::createPrefetcher() const {
+    auto files = files_.getFileList();
+    std::sort(files.begin(), files.end());
+
+    // Readers are created up front, the loader is called on the background thread
+    auto factory = InviwoApplication::getPtr()->getDataReaderFactory();
+    std::unordered_map<std::string, std::shared_ptr<DataReaderType<DataType>>> readers;
+    for (const auto& file : files) {
+        const auto ext = toLower(filesystem::getFileExtension(file));
+        if (readers.count(ext)) continue;
+        if (auto reader = factory->template getReaderForTypeAndExtension<DataType>(ext)) {
+            readers[ext] = std::move(reader);
+        }
+    }
+
+    return std::make_unique<FilePrefetcher<DataType>>(
+        std::move(files),
+        [readers = std::move(readers)](const std::string& file) {
+            const auto ext = toLower(filesystem::getFileExtension(file));
+            auto it = readers.find(ext);
+            if (it == readers.end()) {
+                throw DataReaderException(fmt::format("No reader found for '{}'", file),
+                                          IVW_CONTEXT_CUSTOM("FileSequenceSource"));
+            }
+            auto data = it->second->readData(file);
+            // Make sure the data is in memory, readers might defer loading to a disk
+            // representation
+            if (data) Traits::preload(*data);
+            return data;
+        },
+        prefetch_);
+}
+
+template <typename DataType>
+const ProcessorInfo FileSequenceSource<DataType>::getProcessorInfo() const {
+    return ProcessorTraits<FileSequenceSource<DataType>>::getProcessorInfo();
+}
+
+using VolumeFileSequenceSource = FileSequenceSource<Volume>;
+template <>
+struct ProcessorTraits<VolumeFileSequenceSource> {
+    static ProcessorInfo getProcessorInfo() {
+        return {
+            "org.inviwo.VolumeFileSequenceSource",  // Class identifier
+            "Volume File Sequence Source",          // Display name
+            "Data Input",                           // Category
+            CodeState::Experimental,                // Code state
+            Tags::CPU                               // Tags
+        };
+    }
+};
+
+using ImageFileSequenceSource = FileSequenceSource<Layer>;
+template <>
+struct ProcessorTraits<ImageFileSequenceSource> {
+    static ProcessorInfo getProcessorInfo() {
+        return {
+            "org.inviwo.ImageFileSequenceSource",  // Class identifier
+            "Image File Sequence Source",          // Display name
+            "Data Input",                          // Category
+            CodeState::Experimental,               // Code state
+            Tags::CPU                              // Tags
+        };
+    }
+};
+
+}  // namespace inviwo
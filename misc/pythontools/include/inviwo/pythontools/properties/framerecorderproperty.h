@@ -0,0 +1,78 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
+#include <inviwo/pythontools/util/framerecorder.h>
+
+namespace inviwo {
+
+/**
+ * \ingroup properties
+ * A property holding the output settings of a FrameRecorder, i.e. the output file, whether to
+ * write an image sequence or a video with FFmpeg, and the number of encoder threads.
+ *
+ * @see FrameRecorder
+ */
+class IVW_MODULE_PYTHONTOOLS_API FrameRecorderProperty : public CompositeProperty {
+public:
+    virtual std::string getClassIdentifier() const override;
+    static const std::string classIdentifier;
+
+    FrameRecorderProperty(std::string identifier, std::string displayName);
+
+    FrameRecorderProperty(const FrameRecorderProperty& rhs);
+    virtual FrameRecorderProperty* clone() const override;
+    virtual ~FrameRecorderProperty() = default;
+
+    FrameRecorder::Settings getSettings() const;
+
+    FileProperty file_;
+    TemplateOptionProperty<FrameRecorder::Output> output_;
+    IntSizeTProperty encoderThreads_;
+    IntSizeTProperty queueSize_;
+    StringProperty ffmpeg_;
+    StringProperty ffmpegArgs_;
+    IntProperty fps_;
+
+private:
+    void init();
+    auto props() {
+        return std::tie(file_, output_, encoderThreads_, queueSize_, ffmpeg_, ffmpegArgs_, fps_);
+    }
+};
+
+}  // namespace inviwo
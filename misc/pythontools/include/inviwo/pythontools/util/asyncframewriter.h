@@ -0,0 +1,107 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+class LayerRAM;
+
+/**
+ * \brief Encodes and writes recorded frames on a pool of background threads
+ * Frames are kept in a bounded queue. push() only blocks if the queue is full, i.e. if the
+ * encoders cannot keep up with the recording, which limits the memory used by pending frames.
+ * Frames might be encoded out of order if more than one thread is used, encoders which need the
+ * frames in order, e.g. a pipe to a video encoder, should therefore use a single thread.
+ */
+class IVW_MODULE_PYTHONTOOLS_API AsyncFrameWriter {
+public:
+    struct Frame {
+        size_t index;
+        std::shared_ptr<LayerRAM> layer;
+    };
+    using Encoder = std::function<void(const Frame&)>;
+
+    /**
+     * @param encoder   called on the worker threads to write each frame
+     * @param threads   number of worker threads, at least one
+     * @param capacity  maximum number of queued frames, at least one
+     */
+    AsyncFrameWriter(Encoder encoder, size_t threads, size_t capacity);
+    AsyncFrameWriter(const AsyncFrameWriter&) = delete;
+    AsyncFrameWriter& operator=(const AsyncFrameWriter&) = delete;
+    /**
+     * Waits for all queued frames to be written, errors are discarded.
+     */
+    ~AsyncFrameWriter();
+
+    /**
+     * Queue \p frame for writing, blocks while the queue is full.
+     * Rethrows the first error of an encoder, no further frames are written after an error.
+     */
+    void push(Frame frame);
+
+    /**
+     * Waits for all queued frames to be written and stops the worker threads. Rethrows the first
+     * error of an encoder.
+     */
+    void finish();
+
+    /// @return number of frames queued or being written
+    size_t pending() const;
+
+private:
+    void run();
+    void rethrow();
+
+    Encoder encoder_;
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<Frame> queue_;
+    size_t active_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,83 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <string_view>
+#include <vector>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Control points of a camera path, as edited by the CameraTrajectory processor
+ */
+struct IVW_MODULE_PYTHONTOOLS_API CameraKeyframes {
+    std::vector<dvec3> from;
+    std::vector<dvec3> to;
+    std::vector<dvec3> up;
+};
+
+struct IVW_MODULE_PYTHONTOOLS_API CameraPose {
+    vec3 from;
+    vec3 to;
+    vec3 up;
+};
+
+/**
+ * Parses the control points stored by the CameraTrajectory processor, a JSON object of the form
+ * `{"to": [[x, y, z], ...], "from": [[x, y, z], ...], "up": [[x, y, z], ...]}`.
+ * @throw Exception if a key is missing, a point does not have three components, or the number of
+ * points differ
+ */
+IVW_MODULE_PYTHONTOOLS_API CameraKeyframes parseCameraKeyframes(std::string_view json);
+
+/**
+ * Interpolates \p points, placed at equidistant parameters in [0, 1], with a cubic not-a-knot
+ * spline and evaluates it at \p count equidistant parameters in [0, 1]. This matches
+ * scipy.interpolate.make_interp_spline as used by CameraTrajectory. With less than four points,
+ * the interpolating polynomial of lower degree is used instead.
+ */
+IVW_MODULE_PYTHONTOOLS_API std::vector<dvec3> interpolateSpline(const std::vector<dvec3>& points,
+                                                                size_t count);
+
+/**
+ * Evaluates the camera path defined by \p keyframes at `steps` samples per control point. The up
+ * vector of each pose is made orthogonal to the view direction.
+ */
+IVW_MODULE_PYTHONTOOLS_API std::vector<CameraPose> evaluateCameraPath(
+    const CameraKeyframes& keyframes, size_t steps);
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,248 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/exception.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Loads the files of a sequence on a background thread ahead of their use
+ * While file i is shown, the files i+d to i+k*d are loaded in the background, where d is the
+ * direction of the last step through the sequence and k the number of files to prefetch. The
+ * file preceding the current one, i-d, is kept as well so that a single step back is immediate.
+ * Loaded files outside of this window are released, at most k+2 files are kept in memory.
+ *
+ * The loader is only ever called on the background thread.
+ */
+template <typename T>
+class FilePrefetcher {
+public:
+    using Loader = std::function<std::shared_ptr<T>(const std::string&)>;
+
+    /**
+     * @param files     paths of the sequence
+     * @param loader    called on the background thread to load a file, may throw
+     * @param prefetch  number of files loaded ahead of the current one
+     */
+    FilePrefetcher(std::vector<std::string> files, Loader loader, size_t prefetch = 4);
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+    ~FilePrefetcher();
+
+    /**
+     * Makes \p index the current file and returns it, waiting for it to be loaded if needed.
+     * Rethrows the exception if the file could not be loaded.
+     */
+    std::shared_ptr<T> get(size_t index);
+
+    /**
+     * Returns true if file \p index is loaded and get will not block.
+     */
+    bool isReady(size_t index) const;
+
+    size_t size() const { return files_.size(); }
+    const std::vector<std::string>& files() const { return files_; }
+
+    void setPrefetch(size_t prefetch);
+    size_t getPrefetch() const;
+
+private:
+    void run();
+    // the following expect mutex_ to be locked
+    /// files of the window in order of priority
+    std::vector<size_t> window() const;
+    std::optional<size_t> nextMissing() const;
+    void evict();
+
+    std::vector<std::string> files_;
+    Loader loader_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    size_t prefetch_;
+    size_t current_ = 0;
+    bool forward_ = true;
+    bool stop_ = false;
+    std::unordered_map<size_t, std::shared_ptr<T>> loaded_;
+    std::unordered_map<size_t, std::exception_ptr> failed_;
+    std::thread worker_;
+};
+
+template <typename T>
+FilePrefetcher<T>::FilePrefetcher(std::vector<std::string> files, Loader loader, size_t prefetch)
+    : files_{std::move(files)}, loader_{std::move(loader)}, prefetch_{prefetch} {
+    if (!files_.empty()) {
+        worker_ = std::thread([this]() { run(); });
+    }
+}
+
+template <typename T>
+FilePrefetcher<T>::~FilePrefetcher() {
+    {
+        std::scoped_lock lock{mutex_};
+        stop_ = true;
+    }
+    changed_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+template <typename T>
+std::shared_ptr<T> FilePrefetcher<T>::get(size_t index) {
+    if (index >= files_.size()) {
+        throw RangeException(
+            fmt::format("file {} out of range, the sequence has {} files", index, size()),
+            IVW_CONTEXT);
+    }
+
+    std::unique_lock lock{mutex_};
+    if (current_ != index) {
+        forward_ = index > current_;
+        current_ = index;
+        evict();
+        changed_.notify_all();
+    }
+    changed_.wait(lock, [&]() { return loaded_.count(index) || failed_.count(index); });
+    if (auto it = failed_.find(index); it != failed_.end()) {
+        std::rethrow_exception(it->second);
+    }
+    return loaded_[index];
+}
+
+template <typename T>
+bool FilePrefetcher<T>::isReady(size_t index) const {
+    std::scoped_lock lock{mutex_};
+    return loaded_.count(index) != 0;
+}
+
+template <typename T>
+void FilePrefetcher<T>::setPrefetch(size_t prefetch) {
+    std::scoped_lock lock{mutex_};
+    prefetch_ = prefetch;
+    evict();
+    changed_.notify_all();
+}
+
+template <typename T>
+size_t FilePrefetcher<T>::getPrefetch() const {
+    std::scoped_lock lock{mutex_};
+    return prefetch_;
+}
+
+template <typename T>
+void FilePrefetcher<T>::run() {
+    std::unique_lock lock{mutex_};
+    while (true) {
+        changed_.wait(lock, [&]() { return stop_ || nextMissing(); });
+        if (stop_) return;
+
+        const size_t index = *nextMissing();
+        lock.unlock();
+
+        std::shared_ptr<T> data;
+        std::exception_ptr error;
+        try {
+            data = loader_(files_[index]);
+            if (!data) {
+                throw Exception(fmt::format("Could not load '{}'", files_[index]), IVW_CONTEXT);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if (error) {
+            failed_[index] = error;
+        } else {
+            loaded_[index] = std::move(data);
+        }
+        // the window might have moved on while loading
+        evict();
+        changed_.notify_all();
+    }
+}
+
+template <typename T>
+std::vector<size_t> FilePrefetcher<T>::window() const {
+    std::vector<size_t> indices{current_};
+    for (size_t i = 1; i <= prefetch_; ++i) {
+        if (forward_ && current_ + i < files_.size()) {
+            indices.push_back(current_ + i);
+        } else if (!forward_ && current_ >= i) {
+            indices.push_back(current_ - i);
+        }
+    }
+    if (forward_ && current_ > 0) {
+        indices.push_back(current_ - 1);
+    } else if (!forward_ && current_ + 1 < files_.size()) {
+        indices.push_back(current_ + 1);
+    }
+    return indices;
+}
+
+template <typename T>
+std::optional<size_t> FilePrefetcher<T>::nextMissing() const {
+    for (auto index : window()) {
+        if (!loaded_.count(index) && !failed_.count(index)) return index;
+    }
+    return std::nullopt;
+}
+
+template <typename T>
+void FilePrefetcher<T>::evict() {
+    const auto indices = window();
+    const auto outside = [&](const auto& item) {
+        return std::find(indices.begin(), indices.end(), item.first) == indices.end();
+    };
+    for (auto it = loaded_.begin(); it != loaded_.end();) {
+        it = outside(*it) ? loaded_.erase(it) : std::next(it);
+    }
+    for (auto it = failed_.begin(); it != failed_.end();) {
+        it = outside(*it) ? failed_.erase(it) : std::next(it);
+    }
+}
+
+}  // namespace inviwo
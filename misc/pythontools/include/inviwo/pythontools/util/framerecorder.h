@@ -0,0 +1,130 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/pythontools/pythontoolsmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/pythontools/util/asyncframewriter.h>
+#include <modules/opengl/inviwoopengl.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+namespace inviwo {
+
+class LayerGL;
+
+/**
+ * \brief Records layers without stalling rendering
+ * Each recorded layer is read back asynchronously into one of a few pixel buffer objects. Once the
+ * GPU has finished a transfer, i.e. while the following frames are rendered, the frame is handed
+ * to an AsyncFrameWriter and written on its encoder threads. Frames are either written as an
+ * image sequence, where the writer is chosen by the file extension and EXR files are read back as
+ * floats, or piped as raw RGBA to FFmpeg.
+ *
+ * All functions have to be called with an active OpenGL context.
+ */
+class IVW_MODULE_PYTHONTOOLS_API FrameRecorder {
+public:
+    enum class Output { ImageSequence, FFmpeg };
+
+    struct Settings {
+        /// output file, the frame number is appended to the file name of image sequences
+        std::string file;
+        Output output = Output::ImageSequence;
+        /// number of threads writing image files, FFmpeg always uses a single thread
+        size_t encoderThreads = 1;
+        /// maximum number of frames waiting to be written before recording blocks
+        size_t queueSize = 16;
+        std::string ffmpeg = "ffmpeg";
+        /// output arguments passed to FFmpeg, e.g. codec and quality
+        std::string ffmpegArgs;
+        int fps = 30;
+    };
+
+    /**
+     * @throw Exception if no image writer is available for the file extension
+     */
+    explicit FrameRecorder(Settings settings);
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+    /**
+     * Discards pending readbacks and waits for queued frames to be written.
+     */
+    ~FrameRecorder();
+
+    /**
+     * Start reading back \p layer and hand over earlier frames which are ready. Blocks only if
+     * all pixel buffers are in use or the queue of the writer is full.
+     * @return false if the frame was skipped since the size of a video changed
+     * @throw Exception if writing an earlier frame failed
+     */
+    bool record(const LayerGL& layer);
+
+    /**
+     * Waits for all readbacks and for all frames to be written.
+     * @return number of recorded frames
+     * @throw Exception if writing a frame failed
+     */
+    size_t finish();
+
+    size_t getFrameCount() const { return frameIndex_; }
+    const Settings& getSettings() const { return settings_; }
+
+private:
+    /**
+     * Pixel buffer object receiving the texture of a single frame
+     */
+    struct Readback {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        size_t bytes = 0;
+        size2_t dims{0};
+        size_t index = 0;
+    };
+
+    /// Collect finished readbacks in order, waits for all of them if \p wait is true
+    void collect(bool wait);
+    /// @return false if the readback is not yet complete and \p wait is false
+    bool collect(Readback& readback, bool wait);
+    std::unique_ptr<AsyncFrameWriter> createWriter(const size2_t& dims) const;
+    void releaseReadbacks();
+
+    Settings settings_;
+    bool floatFrames_;
+    size_t frameIndex_ = 0;
+    size2_t frameDims_{0};
+    std::array<Readback, 3> readbacks_;
+    size_t nextReadback_ = 0;
+    std::unique_ptr<AsyncFrameWriter> writer_;
+};
+
+}  // namespace inviwo
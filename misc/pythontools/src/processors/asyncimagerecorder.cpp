@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/processors/asyncimagerecorder.h>
+
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/util/rendercontext.h>
+#include <modules/opengl/image/layergl.h>
+
+namespace inviwo {
+
+const ProcessorInfo AsyncImageRecorder::processorInfo_{
+    "org.inviwo.AsyncImageRecorder",  // Class identifier
+    "Async Image Recorder",           // Display name
+    "Data Output",                    // Category
+    CodeState::Experimental,          // Code state
+    Tags::GL,                         // Tags
+};
+const ProcessorInfo AsyncImageRecorder::getProcessorInfo() const { return processorInfo_; }
+
+AsyncImageRecorder::AsyncImageRecorder()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , recording_("recording", "Recording")
+    , start_("start", "Start Recording")
+    , stop_("stop", "Stop Recording") {
+
+    addPort(inport_);
+    addPort(outport_);
+
+    addProperties(recording_, start_, stop_);
+
+    start_.onChange([this]() { start(); });
+    stop_.onChange([this]() { stop(); });
+}
+
+AsyncImageRecorder::~AsyncImageRecorder() {
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+void AsyncImageRecorder::process() {
+    outport_.setData(inport_.getData());
+    if (!recorder_) return;
+
+    try {
+        if (!recorder_->record(
+                *inport_.getData()->getColorLayer()->getRepresentation<LayerGL>())) {
+            LogProcessorWarn("Skipping frame, the image size changed while recording a video");
+        }
+    } catch (const Exception& e) {
+        LogProcessorError("Recording stopped: " << e.getMessage());
+        recorder_.reset();
+    }
+}
+
+void AsyncImageRecorder::start() {
+    if (recorder_) return;
+    if (recording_.file_.get().empty()) {
+        LogProcessorWarn("No output file specified");
+        return;
+    }
+    try {
+        recorder_ = std::make_unique<FrameRecorder>(recording_.getSettings());
+    } catch (const Exception& e) {
+        LogProcessorError("Could not start recording: " << e.getMessage());
+        return;
+    }
+    LogProcessorInfo("Recording to: " << recording_.file_.get());
+    invalidate(InvalidationLevel::InvalidOutput);
+}
+
+void AsyncImageRecorder::stop() {
+    if (!recorder_) return;
+
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    try {
+        const auto frames = recorder_->finish();
+        LogProcessorInfo("Recorded " << frames << " frames to: " << recording_.file_.get());
+    } catch (const Exception& e) {
+        LogProcessorError("Recording failed: " << e.getMessage());
+    }
+    recorder_.reset();
+}
+
+}  // namespace inviwo
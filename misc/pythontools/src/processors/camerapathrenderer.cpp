@@ -0,0 +1,233 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/processors/camerapathrenderer.h>
+
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/rendercontext.h>
+#include <modules/opengl/image/layergl.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace inviwo {
+
+namespace {
+
+constexpr auto defaultKeyframes = R"({
+    "to": [[1.0, 0.0, 0.0], [2.0, 0.0, 0.0], [3.0, 0.0, 0.0], [4.0, 0.0, 0.0]],
+    "from": [[-10.0, -10.0, 0.0], [10.0, -10.0, 0.0], [10.0, 10.0, 0.0], [-10.0, 10.0, 0.0]],
+    "up": [[0.0, 0.0, 1.0], [0.0, 0.0, 1.0], [0.0, 0.0, 1.0], [0.0, 0.0, 1.0]]
+})";
+
+double milliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+const ProcessorInfo CameraPathRenderer::processorInfo_{
+    "org.inviwo.CameraPathRenderer",  // Class identifier
+    "Camera Path Renderer",           // Display name
+    "Data Output",                    // Category
+    CodeState::Experimental,          // Code state
+    Tags::GL,                         // Tags
+};
+const ProcessorInfo CameraPathRenderer::getProcessorInfo() const { return processorInfo_; }
+
+CameraPathRenderer::CameraPathRenderer()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , keyframes_("keyframes", "Keyframes", defaultKeyframes)
+    , steps_("steps", "Steps", 100, 1, 1000)
+    , frame_("frame", "Frame", 0, 0, 399)
+    , frameRange_("frameRange", "Frame Range", 0, 399, 0, 399, 1, 0)
+    , camera_("camera", "Camera")
+    , recording_("recording", "Recording")
+    , writeTiming_("writeTiming", "Write Timing", false)
+    , render_("render", "Render")
+    , cancel_("cancel", "Cancel") {
+
+    addPort(inport_);
+    addPort(outport_);
+
+    keyframes_.setSemantics(PropertySemantics::Multiline);
+    addProperties(keyframes_, steps_, frame_, frameRange_, camera_, recording_, writeTiming_,
+                  render_, cancel_);
+
+    keyframes_.onChange([this]() { updatePath(); });
+    steps_.onChange([this]() { updatePath(); });
+    frame_.onChange([this]() { applyPose(frame_.get()); });
+    render_.onChange([this]() { start(); });
+    cancel_.onChange([this]() { stop(); });
+
+    updatePath();
+}
+
+CameraPathRenderer::~CameraPathRenderer() {
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+void CameraPathRenderer::process() {
+    outport_.setData(inport_.getData());
+    if (!awaitingFrame_) return;
+    awaitingFrame_ = false;
+
+    const auto rendered = clock::now();
+    try {
+        if (!recorder_->record(
+                *inport_.getData()->getColorLayer()->getRepresentation<LayerGL>())) {
+            LogProcessorWarn("Skipping frame " << currentFrame_
+                                               << ", the image size changed while rendering");
+        }
+    } catch (const Exception& e) {
+        LogProcessorError("Rendering stopped: " << e.getMessage());
+        recorder_.reset();
+        return;
+    }
+    timings_.push_back({currentFrame_, milliseconds(rendered - frameStart_),
+                        milliseconds(clock::now() - rendered)});
+
+    if (currentFrame_ + 1 < std::min(frameRange_.getEnd() + 1, poses_.size())) {
+        // Move on once the current evaluation has finished
+        dispatchFront([this, next = currentFrame_ + 1]() {
+            if (recorder_) renderFrame(next);
+        });
+    } else {
+        stop();
+    }
+}
+
+void CameraPathRenderer::updatePath() {
+    try {
+        poses_ = util::evaluateCameraPath(util::parseCameraKeyframes(keyframes_.get()),
+                                          steps_.get());
+    } catch (const Exception& e) {
+        LogProcessorError(e.getMessage());
+        poses_.clear();
+    }
+
+    const size_t last = std::max(poses_.size(), size_t{1}) - 1;
+    const bool fullRange = frameRange_.getStart() == 0 &&
+                           frameRange_.getEnd() == frameRange_.getRangeMax();
+    frame_.setMaxValue(last);
+    frameRange_.setRangeMax(last);
+    if (fullRange) frameRange_.set(size2_t{0, last});
+    applyPose(frame_.get());
+}
+
+void CameraPathRenderer::applyPose(size_t frame) {
+    if (frame >= poses_.size()) return;
+    const auto& pose = poses_[frame];
+    camera_.setLook(pose.from, pose.to, pose.up);
+}
+
+void CameraPathRenderer::start() {
+    if (recorder_) return;
+    if (poses_.empty()) {
+        LogProcessorWarn("The camera path is empty");
+        return;
+    }
+    if (recording_.file_.get().empty()) {
+        LogProcessorWarn("No output file specified");
+        return;
+    }
+    try {
+        recorder_ = std::make_unique<FrameRecorder>(recording_.getSettings());
+    } catch (const Exception& e) {
+        LogProcessorError("Could not start rendering: " << e.getMessage());
+        return;
+    }
+    timings_.clear();
+    renderStart_ = clock::now();
+    renderFrame(frameRange_.getStart());
+}
+
+void CameraPathRenderer::renderFrame(size_t frame) {
+    currentFrame_ = frame;
+    awaitingFrame_ = true;
+    frameStart_ = clock::now();
+    frame_.set(frame);
+    applyPose(frame);
+    // The pose might equal the previous one, make sure the frame is still recorded
+    invalidate(InvalidationLevel::InvalidOutput);
+}
+
+void CameraPathRenderer::stop() {
+    if (!recorder_) return;
+    awaitingFrame_ = false;
+
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    try {
+        const auto frames = recorder_->finish();
+        const auto seconds = milliseconds(clock::now() - renderStart_) / 1000.0;
+        LogProcessorInfo(fmt::format("Rendered {} frames in {:.2f} s ({:.1f} fps) to: {}", frames,
+                                     seconds, seconds > 0.0 ? frames / seconds : 0.0,
+                                     recording_.file_.get()));
+    } catch (const Exception& e) {
+        LogProcessorError("Rendering failed: " << e.getMessage());
+    }
+    recorder_.reset();
+
+    if (!timings_.empty()) {
+        const auto [min, max] = std::minmax_element(
+            timings_.begin(), timings_.end(),
+            [](const FrameTiming& a, const FrameTiming& b) { return a.renderMs < b.renderMs; });
+        double sum = 0.0;
+        for (const auto& timing : timings_) sum += timing.renderMs;
+        LogProcessorInfo(fmt::format("Frame time min: {:.2f} ms, mean: {:.2f} ms, max: {:.2f} ms",
+                                     min->renderMs, sum / timings_.size(), max->renderMs));
+        if (writeTiming_) writeTiming();
+    }
+}
+
+void CameraPathRenderer::writeTiming() const {
+    const auto& file = recording_.file_.get();
+    const auto path = fmt::format("{}/{}_timing.csv", filesystem::getFileDirectory(file),
+                                  filesystem::getFileNameWithoutExtension(file));
+    std::ofstream out(path);
+    if (!out) {
+        LogProcessorError("Could not write timing to: " << path);
+        return;
+    }
+    out << "frame,render_ms,record_ms\n";
+    for (const auto& timing : timings_) {
+        out << fmt::format("{},{:.3f},{:.3f}\n", timing.frame, timing.renderMs, timing.recordMs);
+    }
+}
+
+}  // namespace inviwo
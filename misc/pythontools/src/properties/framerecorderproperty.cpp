@@ -0,0 +1,100 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/properties/framerecorderproperty.h>
+#include <inviwo/core/util/foreacharg.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace inviwo {
+
+const std::string FrameRecorderProperty::classIdentifier = "org.inviwo.FrameRecorderProperty";
+std::string FrameRecorderProperty::getClassIdentifier() const { return classIdentifier; }
+
+FrameRecorderProperty::FrameRecorderProperty(std::string identifier, std::string displayName)
+    : CompositeProperty(identifier, displayName)
+    , file_("file", "File", "", "image")
+    , output_("output", "Output",
+              {{"imageSequence", "Image Sequence", FrameRecorder::Output::ImageSequence},
+               {"ffmpeg", "FFmpeg", FrameRecorder::Output::FFmpeg}},
+              0)
+    , encoderThreads_("encoderThreads", "Encoder Threads",
+                      std::max(size_t{1}, size_t{std::thread::hardware_concurrency()} / 2), 1,
+                      std::max(size_t{1}, size_t{std::thread::hardware_concurrency()}))
+    , queueSize_("queueSize", "Queue Size", 16, 1, 256)
+    , ffmpeg_("ffmpeg", "FFmpeg Executable", "ffmpeg")
+    , ffmpegArgs_("ffmpegArgs", "FFmpeg Arguments", "-c:v libx264 -pix_fmt yuv420p -crf 18")
+    , fps_("fps", "Frame Rate", 30, 1, 240) {
+    file_.setAcceptMode(AcceptMode::Save);
+    init();
+}
+
+FrameRecorderProperty::FrameRecorderProperty(const FrameRecorderProperty& rhs)
+    : CompositeProperty(rhs)
+    , file_(rhs.file_)
+    , output_(rhs.output_)
+    , encoderThreads_(rhs.encoderThreads_)
+    , queueSize_(rhs.queueSize_)
+    , ffmpeg_(rhs.ffmpeg_)
+    , ffmpegArgs_(rhs.ffmpegArgs_)
+    , fps_(rhs.fps_) {
+    init();
+}
+
+FrameRecorderProperty* FrameRecorderProperty::clone() const {
+    return new FrameRecorderProperty(*this);
+}
+
+FrameRecorder::Settings FrameRecorderProperty::getSettings() const {
+    FrameRecorder::Settings settings;
+    settings.file = file_.get();
+    settings.output = output_.get();
+    settings.encoderThreads = encoderThreads_.get();
+    settings.queueSize = queueSize_.get();
+    settings.ffmpeg = ffmpeg_.get();
+    settings.ffmpegArgs = ffmpegArgs_.get();
+    settings.fps = fps_.get();
+    return settings;
+}
+
+void FrameRecorderProperty::init() {
+    util::for_each_in_tuple([&](auto& e) { addProperty(e); }, props());
+
+    const auto isImageSequence = [](const auto& p) {
+        return p.get() == FrameRecorder::Output::ImageSequence;
+    };
+    const auto isFFmpeg = [](const auto& p) { return p.get() == FrameRecorder::Output::FFmpeg; };
+    encoderThreads_.visibilityDependsOn(output_, isImageSequence);
+    ffmpeg_.visibilityDependsOn(output_, isFFmpeg);
+    ffmpegArgs_.visibilityDependsOn(output_, isFFmpeg);
+    fps_.visibilityDependsOn(output_, isFFmpeg);
+}
+
+}  // namespace inviwo
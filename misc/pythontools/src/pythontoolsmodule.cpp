@@ -28,11 +28,23 @@
  *********************************************************************************/
 
 #include <inviwo/pythontools/pythontoolsmodule.h>
+#include <inviwo/pythontools/processors/asyncimagerecorder.h>
+#include <inviwo/pythontools/processors/camerapathrenderer.h>
+#include <inviwo/pythontools/processors/filesequencesource.h>
+#include <inviwo/pythontools/properties/framerecorderproperty.h>
 
 namespace inviwo {
 
 PythonToolsModule::PythonToolsModule(InviwoApplication* app)
     : InviwoModule(app, "PythonTools")
-    , pythonFolderObserver_{app, getPath() + "/processors", *this} {}
+    , pythonFolderObserver_{app, getPath() + "/processors", *this} {
+
+    registerProcessor<AsyncImageRecorder>();
+    registerProcessor<CameraPathRenderer>();
+    registerProcessor<ImageFileSequenceSource>();
+    registerProcessor<VolumeFileSequenceSource>();
+
+    registerProperty<FrameRecorderProperty>();
+}
 
 }  // namespace inviwo
@@ -0,0 +1,114 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/util/asyncframewriter.h>
+
+#include <inviwo/core/datastructures/image/layerram.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+AsyncFrameWriter::AsyncFrameWriter(Encoder encoder, size_t threads, size_t capacity)
+    : encoder_{std::move(encoder)}, capacity_{std::max(size_t{1}, capacity)} {
+    threads = std::max(size_t{1}, threads);
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+AsyncFrameWriter::~AsyncFrameWriter() {
+    try {
+        finish();
+    } catch (...) {
+    }
+}
+
+void AsyncFrameWriter::push(Frame frame) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    changed_.wait(lock, [&]() { return queue_.size() < capacity_ || error_ || stop_; });
+    rethrow();
+    if (stop_) return;
+    queue_.push_back(std::move(frame));
+    lock.unlock();
+    changed_.notify_all();
+}
+
+void AsyncFrameWriter::finish() {
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        changed_.wait(lock, [&]() { return (queue_.empty() && active_ == 0) || error_; });
+        stop_ = true;
+    }
+    changed_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    std::scoped_lock lock{mutex_};
+    rethrow();
+}
+
+size_t AsyncFrameWriter::pending() const {
+    std::scoped_lock lock{mutex_};
+    return queue_.size() + active_;
+}
+
+void AsyncFrameWriter::run() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true) {
+        changed_.wait(lock, [&]() { return !queue_.empty() || stop_ || error_; });
+        if (stop_ || error_) return;
+
+        auto frame = std::move(queue_.front());
+        queue_.pop_front();
+        ++active_;
+        lock.unlock();
+        changed_.notify_all();
+
+        std::exception_ptr error;
+        try {
+            encoder_(frame);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        frame.layer.reset();
+
+        lock.lock();
+        --active_;
+        if (error && !error_) error_ = error;
+        changed_.notify_all();
+    }
+}
+
+void AsyncFrameWriter::rethrow() {
+    if (error_) std::rethrow_exception(error_);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,248 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/util/camerapath.h>
+
+#include <inviwo/core/util/exception.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <utility>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+class KeyframeParser {
+public:
+    explicit KeyframeParser(std::string_view json) : json_{json} {}
+
+    /// Parses the array of points following "key":
+    std::vector<dvec3> points(std::string_view key) {
+        const auto quoted = fmt::format("\"{}\"", key);
+        pos_ = json_.find(quoted);
+        if (pos_ == std::string_view::npos) {
+            throw Exception(fmt::format("Camera keyframes are missing '{}'", key),
+                            IVW_CONTEXT_CUSTOM("parseCameraKeyframes"));
+        }
+        pos_ += quoted.size();
+        expect(':');
+        expect('[');
+        std::vector<dvec3> result;
+        if (accept(']')) return result;
+        do {
+            result.push_back(point(key, result.size()));
+        } while (accept(','));
+        expect(']');
+        return result;
+    }
+
+private:
+    dvec3 point(std::string_view key, size_t index) {
+        expect('[');
+        std::vector<double> components;
+        if (!accept(']')) {
+            do {
+                components.push_back(number());
+            } while (accept(','));
+            expect(']');
+        }
+        if (components.size() != 3) {
+            throw Exception(fmt::format("Camera keyframe {} of '{}' has {} components, expected 3",
+                                        index, key, components.size()),
+                            IVW_CONTEXT_CUSTOM("parseCameraKeyframes"));
+        }
+        return dvec3{components[0], components[1], components[2]};
+    }
+
+    double number() {
+        skipSpace();
+        // from_chars does not accept a leading '+'
+        if (pos_ < json_.size() && json_[pos_] == '+') ++pos_;
+        double value = 0.0;
+        const auto end = json_.data() + json_.size();
+        const auto [p, ec] = std::from_chars(json_.data() + pos_, end, value);
+        if (ec != std::errc()) error("a number");
+        pos_ = p - json_.data();
+        return value;
+    }
+
+    void skipSpace() {
+        while (pos_ < json_.size() && std::isspace(static_cast<unsigned char>(json_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    bool accept(char c) {
+        skipSpace();
+        if (pos_ < json_.size() && json_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) error(fmt::format("'{}'", c));
+    }
+
+    [[noreturn]] void error(std::string_view expected) const {
+        throw Exception(fmt::format("Invalid camera keyframes, expected {} at position {}",
+                                    expected, pos_),
+                        IVW_CONTEXT_CUSTOM("parseCameraKeyframes"));
+    }
+
+    std::string_view json_;
+    size_t pos_ = 0;
+};
+
+/**
+ * Solves the dense system \p a x = \p b with partial pivoting, \p b is overwritten with x
+ */
+void solve(std::vector<std::vector<double>> a, std::vector<dvec3>& b) {
+    const size_t n = b.size();
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; ++row) {
+            if (std::abs(a[row][col]) > std::abs(a[pivot][col])) pivot = row;
+        }
+        std::swap(a[col], a[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (size_t row = col + 1; row < n; ++row) {
+            const double f = a[row][col] / a[col][col];
+            for (size_t k = col; k < n; ++k) a[row][k] -= f * a[col][k];
+            b[row] -= f * b[col];
+        }
+    }
+    for (size_t col = n; col-- > 0;) {
+        for (size_t k = col + 1; k < n; ++k) b[col] -= a[col][k] * b[k];
+        b[col] /= a[col][col];
+    }
+}
+
+}  // namespace
+
+CameraKeyframes parseCameraKeyframes(std::string_view json) {
+    KeyframeParser parser{json};
+    CameraKeyframes keyframes{parser.points("from"), parser.points("to"), parser.points("up")};
+    if (keyframes.to.size() != keyframes.from.size() ||
+        keyframes.up.size() != keyframes.from.size()) {
+        throw Exception(fmt::format("Camera keyframes differ in length, from: {}, to: {}, up: {}",
+                                    keyframes.from.size(), keyframes.to.size(),
+                                    keyframes.up.size()),
+                        IVW_CONTEXT_CUSTOM("parseCameraKeyframes"));
+    }
+    return keyframes;
+}
+
+std::vector<dvec3> interpolateSpline(const std::vector<dvec3>& points, size_t count) {
+    const size_t n = points.size();
+    std::vector<dvec3> result(n == 0 ? 0 : count);
+    if (result.empty()) return result;
+
+    const auto param = [&](size_t i) {
+        return count > 1 ? static_cast<double>(i) / static_cast<double>(count - 1) : 0.0;
+    };
+
+    if (n < 4) {
+        // Interpolating polynomial of degree n - 1 in Lagrange form
+        for (size_t i = 0; i < count; ++i) {
+            const double t = param(i) * static_cast<double>(n - 1);
+            dvec3 value{0.0};
+            for (size_t j = 0; j < n; ++j) {
+                double w = 1.0;
+                for (size_t k = 0; k < n; ++k) {
+                    if (k == j) continue;
+                    w *= (t - static_cast<double>(k)) /
+                         (static_cast<double>(j) - static_cast<double>(k));
+                }
+                value += w * points[j];
+            }
+            result[i] = value;
+        }
+        return result;
+    }
+
+    // Second derivatives with respect to the segment parameter, i.e. knot spacing h = 1. The
+    // not-a-knot conditions make the third derivative continuous at the second and second to
+    // last knots.
+    std::vector<std::vector<double>> a(n, std::vector<double>(n, 0.0));
+    std::vector<dvec3> m(n, dvec3{0.0});
+    a[0][0] = 1.0;
+    a[0][1] = -2.0;
+    a[0][2] = 1.0;
+    for (size_t i = 1; i + 1 < n; ++i) {
+        a[i][i - 1] = 1.0;
+        a[i][i] = 4.0;
+        a[i][i + 1] = 1.0;
+        m[i] = 6.0 * (points[i + 1] - 2.0 * points[i] + points[i - 1]);
+    }
+    a[n - 1][n - 3] = 1.0;
+    a[n - 1][n - 2] = -2.0;
+    a[n - 1][n - 1] = 1.0;
+    solve(std::move(a), m);
+
+    for (size_t i = 0; i < count; ++i) {
+        const double t = param(i) * static_cast<double>(n - 1);
+        const size_t k = std::min(static_cast<size_t>(t), n - 2);
+        const double s = t - static_cast<double>(k);
+        const double r = 1.0 - s;
+        result[i] = m[k] * (r * r * r / 6.0) + m[k + 1] * (s * s * s / 6.0) +
+                    (points[k] - m[k] / 6.0) * r + (points[k + 1] - m[k + 1] / 6.0) * s;
+    }
+    return result;
+}
+
+std::vector<CameraPose> evaluateCameraPath(const CameraKeyframes& keyframes, size_t steps) {
+    const size_t count = keyframes.from.size() * steps;
+    const auto from = interpolateSpline(keyframes.from, count);
+    const auto to = interpolateSpline(keyframes.to, count);
+    const auto up = interpolateSpline(keyframes.up, count);
+
+    std::vector<CameraPose> poses(from.size());
+    for (size_t i = 0; i < poses.size(); ++i) {
+        const auto normal = to[i] - from[i];
+        const auto right = glm::cross(normal, up[i]);
+        const auto orthoUp = glm::cross(right, normal);
+        const auto length = glm::length(orthoUp);
+        poses[i] = CameraPose{vec3{from[i]}, vec3{to[i]},
+                              length > 0.0 ? vec3{orthoUp / length} : vec3{up[i]}};
+    }
+    return poses;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,223 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/pythontools/util/framerecorder.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/io/datawriter.h>
+#include <inviwo/core/io/datawriterfactory.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/rendercontext.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <modules/opengl/image/layergl.h>
+#include <modules/opengl/texture/texture2d.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<FILE> openPipe(const std::string& command) {
+#ifdef WIN32
+    return std::shared_ptr<FILE>(_popen(command.c_str(), "wb"), [](FILE* f) {
+        if (f) _pclose(f);
+    });
+#else
+    return std::shared_ptr<FILE>(popen(command.c_str(), "w"), [](FILE* f) {
+        if (f) pclose(f);
+    });
+#endif
+}
+
+}  // namespace
+
+FrameRecorder::FrameRecorder(Settings settings)
+    : settings_{std::move(settings)}
+    , floatFrames_{settings_.output == Output::ImageSequence &&
+                   toLower(filesystem::getFileExtension(settings_.file)) == "exr"} {
+    // The video size is only known with the first frame, image writers are checked right away
+    if (settings_.output == Output::ImageSequence) {
+        writer_ = createWriter(size2_t{0});
+    }
+}
+
+FrameRecorder::~FrameRecorder() {
+    writer_.reset();
+    releaseReadbacks();
+}
+
+bool FrameRecorder::record(const LayerGL& layer) {
+    const auto dims = layer.getDimensions();
+    if (frameIndex_ == 0) {
+        frameDims_ = dims;
+        if (!writer_) writer_ = createWriter(dims);
+    } else if (settings_.output == Output::FFmpeg && dims != frameDims_) {
+        return false;
+    }
+
+    // Hand over finished transfers and make room for the next one
+    collect(false);
+    auto& readback = readbacks_[nextReadback_];
+    if (readback.fence) collect(readback, true);
+
+    const size_t bytes = dims.x * dims.y * 4 * (floatFrames_ ? sizeof(float) : 1);
+    if (readback.pbo == 0) glGenBuffers(1, &readback.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    if (readback.bytes != bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        readback.bytes = bytes;
+    }
+
+    GLint packAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    layer.getTexture()->bind();
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, floatFrames_ ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+    layer.getTexture()->unbind();
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.dims = dims;
+    readback.index = frameIndex_++;
+    nextReadback_ = (nextReadback_ + 1) % readbacks_.size();
+    LGL_ERROR;
+    return true;
+}
+
+size_t FrameRecorder::finish() {
+    collect(true);
+    if (writer_) writer_->finish();
+    return frameIndex_;
+}
+
+void FrameRecorder::collect(bool wait) {
+    // nextReadback_ refers to the oldest readback
+    for (size_t i = 0; i < readbacks_.size(); ++i) {
+        auto& readback = readbacks_[(nextReadback_ + i) % readbacks_.size()];
+        if (readback.fence && !collect(readback, wait)) return;
+    }
+}
+
+bool FrameRecorder::collect(Readback& readback, bool wait) {
+    GLenum status = glClientWaitSync(readback.fence, 0, 0);
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100'000'000);
+    }
+    if (status == GL_TIMEOUT_EXPIRED) return false;
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+    if (status == GL_WAIT_FAILED) {
+        throw Exception("Failed to read back frame", IVW_CONTEXT);
+    }
+
+    std::shared_ptr<LayerRAM> ram;
+    if (floatFrames_) {
+        ram = std::make_shared<LayerRAMPrecision<vec4>>(readback.dims);
+    } else {
+        ram = std::make_shared<LayerRAMPrecision<glm::u8vec4>>(readback.dims);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    if (auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.bytes, GL_MAP_READ_BIT)) {
+        std::memcpy(ram->getData(), data, readback.bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    writer_->push({readback.index, std::move(ram)});
+    return true;
+}
+
+std::unique_ptr<AsyncFrameWriter> FrameRecorder::createWriter(const size2_t& dims) const {
+    const auto& file = settings_.file;
+    if (settings_.output == Output::FFmpeg) {
+        const auto command = fmt::format(
+            "\"{}\" -y -loglevel error -f rawvideo -pix_fmt rgba -s {}x{} -r {} -i - -vf vflip "
+            "{} \"{}\"",
+            settings_.ffmpeg, dims.x, dims.y, settings_.fps, settings_.ffmpegArgs, file);
+        auto pipe = openPipe(command);
+        if (!pipe) {
+            throw Exception(fmt::format("Could not start FFmpeg: {}", command), IVW_CONTEXT);
+        }
+        // Frames have to arrive in order, use a single thread and let FFmpeg parallelize
+        return std::make_unique<AsyncFrameWriter>(
+            [pipe](const AsyncFrameWriter::Frame& frame) {
+                const auto bytes = frame.layer->getNumberOfBytes();
+                if (std::fwrite(frame.layer->getData(), 1, bytes, pipe.get()) != bytes) {
+                    throw Exception("Writing to FFmpeg failed",
+                                    IVW_CONTEXT_CUSTOM("FrameRecorder"));
+                }
+            },
+            1, settings_.queueSize);
+    }
+
+    const auto ext = filesystem::getFileExtension(file);
+    auto factory = InviwoApplication::getPtr()->getDataWriterFactory();
+    std::shared_ptr<const DataWriterType<Layer>> prototype =
+        factory->getWriterForTypeAndExtension<Layer>(ext);
+    if (!prototype) {
+        throw Exception(fmt::format("No image writer found for extension '{}'", ext),
+                        IVW_CONTEXT);
+    }
+    const auto base = fmt::format("{}/{}_", filesystem::getFileDirectory(file),
+                                  filesystem::getFileNameWithoutExtension(file));
+    return std::make_unique<AsyncFrameWriter>(
+        [prototype, base, ext](const AsyncFrameWriter::Frame& frame) {
+            std::unique_ptr<DataWriterType<Layer>> writer{prototype->clone()};
+            writer->setOverwrite(Overwrite::Yes);
+            const Layer layer{frame.layer};
+            writer->writeData(&layer, fmt::format("{}{:05}.{}", base, frame.index, ext));
+        },
+        settings_.encoderThreads, settings_.queueSize);
+}
+
+void FrameRecorder::releaseReadbacks() {
+    if (std::none_of(readbacks_.begin(), readbacks_.end(),
+                     [](const Readback& r) { return r.pbo != 0; })) {
+        return;
+    }
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    for (auto& readback : readbacks_) {
+        if (readback.fence) glDeleteSync(readback.fence);
+        if (readback.pbo) glDeleteBuffers(1, &readback.pbo);
+        readback = Readback{};
+    }
+    nextReadback_ = 0;
+}
+
+}  // namespace inviwo
@@ -3,4 +3,6 @@
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
     InviwoBaseModule 
+    InviwoEigenUtilsModule
+    InviwoOpenGLModule
 )
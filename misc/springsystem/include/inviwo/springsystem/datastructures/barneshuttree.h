@@ -0,0 +1,267 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018-2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/springsystem/springsystemmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Quadtree/octree over a set of points for Barnes-Hut approximations of all-pairs
+ * repulsive forces, for 1 to 3 components.
+ *
+ * Each cell stores the center of mass and the bounding box of its points. Cells are opened
+ * during the force evaluation if the diagonal of the bounding box is larger than \p theta times
+ * the distance to the center of mass, theta = 0 gives the exact O(n^2) sum and theta < 1 makes
+ * sure that the cells containing the evaluated point are always opened. When the points have
+ * moved a little, refit() updates centers and bounding boxes in O(n) while keeping the topology,
+ * the approximation stays consistent but gets slower as the cells start to overlap. A full
+ * build() is O(n log n).
+ */
+template <size_t N, typename T>
+class BarnesHutTree {
+public:
+    static_assert(N >= 1 && N <= 3, "BarnesHutTree supports one to three components");
+    using Vector = glm::vec<N, T>;
+    static constexpr size_t leafSize = 8;
+    static constexpr size_t maxDepth = 32;
+
+    /**
+     * Build the tree from scratch. \p positions has to support size() and operator[] returning
+     * something convertible to Vector.
+     */
+    template <typename Positions>
+    void build(const Positions& positions);
+
+    /**
+     * Update centers of mass and bounding boxes for moved points, keeping the cells. The number
+     * of points has to be the same as in the last build().
+     */
+    template <typename Positions>
+    void refit(const Positions& positions);
+
+    /**
+     * Sum of (p_i - p_j) / (|p_i - p_j|^2 + softening^2) over all points j != i, i.e. a repulsion
+     * decaying with the inverse of the distance.
+     */
+    template <typename Positions>
+    Vector repulsion(size_t i, const Positions& positions, T theta, T softening) const;
+
+    size_t getNumberOfPoints() const { return indices_.size(); }
+    size_t getNumberOfCells() const { return cells_.size(); }
+
+private:
+    static constexpr size_t numOctants = size_t{1} << N;
+
+    struct Cell {
+        Vector center{0};
+        Vector min{0};
+        Vector max{0};
+        T mass{0};
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+        // children are consecutive cells, none for leaves
+        std::uint32_t firstChild = 0;
+        std::uint32_t numChildren = 0;
+    };
+
+    template <typename Positions>
+    void split(std::uint32_t cell, const Positions& positions, Vector boxCenter, T boxHalfSize,
+               size_t depth);
+    template <typename Positions>
+    void fit(Cell& cell, const Positions& positions) const;
+
+    std::vector<Cell> cells_;
+    // point indices ordered such that each cell covers a contiguous range
+    std::vector<std::uint32_t> indices_;
+    std::vector<std::uint32_t> scratch_;
+    std::vector<std::uint8_t> octants_;
+};
+
+template <size_t N, typename T>
+template <typename Positions>
+void BarnesHutTree<N, T>::build(const Positions& positions) {
+    const auto numPoints = positions.size();
+    cells_.clear();
+    indices_.resize(numPoints);
+    std::iota(indices_.begin(), indices_.end(), std::uint32_t{0});
+    if (numPoints == 0) return;
+
+    scratch_.resize(numPoints);
+    octants_.resize(numPoints);
+
+    Vector min{positions[0]};
+    Vector max{positions[0]};
+    for (size_t i = 1; i < numPoints; ++i) {
+        min = glm::min(min, Vector{positions[i]});
+        max = glm::max(max, Vector{positions[i]});
+    }
+    T halfSize{0};
+    for (size_t c = 0; c < N; ++c) halfSize = std::max(halfSize, (max[c] - min[c]) / T{2});
+
+    cells_.reserve(2 * numPoints / leafSize + 1);
+    cells_.emplace_back();
+    cells_[0].end = static_cast<std::uint32_t>(numPoints);
+    split(0, positions, (min + max) / T{2}, halfSize, 0);
+    refit(positions);
+}
+
+template <size_t N, typename T>
+template <typename Positions>
+void BarnesHutTree<N, T>::split(std::uint32_t cell, const Positions& positions, Vector boxCenter,
+                                T boxHalfSize, size_t depth) {
+    const auto begin = cells_[cell].begin;
+    const auto end = cells_[cell].end;
+    if (end - begin <= leafSize || depth >= maxDepth) return;
+
+    // counting sort of the points by octant of the box
+    std::array<std::uint32_t, numOctants + 1> offsets{};
+    for (auto i = begin; i < end; ++i) {
+        const Vector p{positions[indices_[i]]};
+        std::uint8_t octant = 0;
+        for (size_t c = 0; c < N; ++c) {
+            if (p[c] >= boxCenter[c]) octant |= static_cast<std::uint8_t>(1 << c);
+        }
+        octants_[i] = octant;
+        ++offsets[octant + 1];
+    }
+    for (size_t o = 0; o < numOctants; ++o) offsets[o + 1] += offsets[o];
+    auto insert = offsets;
+    for (auto i = begin; i < end; ++i) scratch_[begin + insert[octants_[i]]++] = indices_[i];
+    std::copy(scratch_.begin() + begin, scratch_.begin() + end, indices_.begin() + begin);
+
+    const auto firstChild = static_cast<std::uint32_t>(cells_.size());
+    for (size_t o = 0; o < numOctants; ++o) {
+        if (offsets[o] == offsets[o + 1]) continue;
+        Cell child;
+        child.begin = begin + offsets[o];
+        child.end = begin + offsets[o + 1];
+        cells_.push_back(child);
+    }
+    cells_[cell].firstChild = firstChild;
+    cells_[cell].numChildren = static_cast<std::uint32_t>(cells_.size()) - firstChild;
+
+    const T childHalfSize = boxHalfSize / T{2};
+    auto child = firstChild;
+    for (size_t o = 0; o < numOctants; ++o) {
+        if (offsets[o] == offsets[o + 1]) continue;
+        Vector childCenter{boxCenter};
+        for (size_t c = 0; c < N; ++c) {
+            childCenter[c] += (o & (size_t{1} << c)) ? childHalfSize : -childHalfSize;
+        }
+        split(child++, positions, childCenter, childHalfSize, depth + 1);
+    }
+}
+
+template <size_t N, typename T>
+template <typename Positions>
+void BarnesHutTree<N, T>::refit(const Positions& positions) {
+    // children are always stored after their parent, a reverse sweep visits them first
+    for (auto it = cells_.rbegin(); it != cells_.rend(); ++it) {
+        fit(*it, positions);
+    }
+}
+
+template <size_t N, typename T>
+template <typename Positions>
+void BarnesHutTree<N, T>::fit(Cell& cell, const Positions& positions) const {
+    if (cell.numChildren == 0) {
+        const Vector first{positions[indices_[cell.begin]]};
+        Vector sum{0};
+        cell.min = first;
+        cell.max = first;
+        for (auto i = cell.begin; i < cell.end; ++i) {
+            const Vector p{positions[indices_[i]]};
+            sum += p;
+            cell.min = glm::min(cell.min, p);
+            cell.max = glm::max(cell.max, p);
+        }
+        cell.mass = static_cast<T>(cell.end - cell.begin);
+        cell.center = sum / cell.mass;
+    } else {
+        const auto& first = cells_[cell.firstChild];
+        Vector sum{0};
+        cell.min = first.min;
+        cell.max = first.max;
+        cell.mass = T{0};
+        for (auto c = cell.firstChild; c < cell.firstChild + cell.numChildren; ++c) {
+            const auto& child = cells_[c];
+            sum += child.mass * child.center;
+            cell.mass += child.mass;
+            cell.min = glm::min(cell.min, child.min);
+            cell.max = glm::max(cell.max, child.max);
+        }
+        cell.center = sum / cell.mass;
+    }
+}
+
+template <size_t N, typename T>
+template <typename Positions>
+auto BarnesHutTree<N, T>::repulsion(size_t i, const Positions& positions, T theta,
+                                    T softening) const -> Vector {
+    Vector force{0};
+    if (cells_.empty()) return force;
+
+    const Vector pos{positions[i]};
+    const T soft2 = softening * softening;
+    const T theta2 = theta * theta;
+
+    // depth first traversal, each level adds at most numOctants - 1 cells to the stack
+    std::array<std::uint32_t, maxDepth * (numOctants - 1) + 2> stack;
+    size_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const auto& cell = cells_[stack[--size]];
+        const Vector extent = cell.max - cell.min;
+        const Vector d = pos - cell.center;
+        const T dist2 = glm::dot(d, d);
+        if (glm::dot(extent, extent) < theta2 * dist2) {
+            force += (cell.mass / (dist2 + soft2)) * d;
+        } else if (cell.numChildren == 0) {
+            for (auto j = cell.begin; j < cell.end; ++j) {
+                if (indices_[j] == i) continue;
+                const Vector dj = pos - Vector{positions[indices_[j]]};
+                force += dj / (glm::dot(dj, dj) + soft2);
+            }
+        } else {
+            for (auto c = cell.firstChild; c < cell.firstChild + cell.numChildren; ++c) {
+                stack[size++] = c;
+            }
+        }
+    }
+    return force;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,190 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/springsystem/springsystemmoduledefine.h>
+#include <inviwo/springsystem/datastructures/gravityspringsystem.h>
+#include <inviwo/springsystem/datastructures/zerospringsystem.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <vector>
+#include <utility>
+
+namespace inviwo {
+
+/**
+ * \class GLSpringSystem
+ *
+ * \brief Verlet integration of a spring mass system using compute shaders
+ *
+ * GPU counterpart of GravitySpringSystem and ZeroSpringSystem, i.e. systems with a global node
+ * mass, spring constant, spring length, dampening, and external force. Positions, velocities,
+ * and forces stay in shader storage buffers between calls to integrate(), only the changes done
+ * through setPosition() and setLocked() are uploaded. Each time step uses two dispatches, the
+ * first updates the positions of all nodes, the second gathers the spring forces of each node
+ * and finishes the velocity update, see SpringSystem::verletIntegration.
+ *
+ * Computations are done in single precision and without periodic boundary conditions. Requires
+ * OpenGL 4.3.
+ */
+class IVW_MODULE_SPRINGSYSTEM_API GLSpringSystem {
+public:
+    using SpringIndices = std::pair<std::size_t, std::size_t>;
+
+    struct Parameters {
+        float timeStep = 0.01f;
+        vec3 externalForce{0.0f};
+        float nodeMass = 1.0f;
+        float springConstant = 1.0f;
+        float springLength = 1.0f;
+        float springDampning = 1.0f;
+    };
+
+    GLSpringSystem(const std::vector<vec3>& positions, const std::vector<SpringIndices>& springs,
+                   const std::vector<bool>& locked, const Parameters& parameters);
+    template <size_t N, typename T, typename Storage>
+    explicit GLSpringSystem(const GravitySpringSystem<N, T, Storage>& sys);
+    template <size_t N, typename T, typename Storage>
+    explicit GLSpringSystem(const ZeroSpringSystem<N, T, Storage>& sys);
+
+    const Parameters& getParameters() const;
+    void setParameters(const Parameters& parameters);
+
+    void integrate(size_t steps = 1);
+
+    size_t getNumberOfNodes() const;
+    size_t getNumberOfSprings() const;
+
+    void setPosition(size_t i, const vec3& position);
+    void setLocked(size_t i, bool locked);
+
+    /**
+     * Download the current state into \p sys, which has to have the same nodes as the system
+     * this was created from.
+     */
+    template <size_t N, typename T, typename Derived, typename PBC, typename Storage>
+    void download(SpringSystem<N, T, Derived, PBC, Storage>& sys) const;
+
+    /**
+     * Node positions in xyz, can be used directly as a position buffer of a Mesh.
+     */
+    std::shared_ptr<const Buffer<vec4>> getPositionBuffer() const;
+
+    template <size_t N, typename T, typename Storage>
+    static Parameters parameters(const GravitySpringSystem<N, T, Storage>& sys);
+    template <size_t N, typename T, typename Storage>
+    static Parameters parameters(const ZeroSpringSystem<N, T, Storage>& sys);
+
+private:
+    template <typename Sys>
+    static std::vector<vec3> positions(const Sys& sys);
+
+    void bindBuffers();
+
+    Parameters parameters_;
+    size_t numNodes_;
+    size_t numSprings_;
+
+    std::shared_ptr<Buffer<vec4>> positions_;
+    std::shared_ptr<Buffer<vec4>> velocities_;
+    std::shared_ptr<Buffer<vec4>> forces_;
+    std::shared_ptr<Buffer<std::uint32_t>> locked_;
+    // Springs of each node in CSR layout, see SpringSystem::nodeSprings_
+    std::shared_ptr<Buffer<glm::uvec2>> springs_;
+    std::shared_ptr<Buffer<std::uint32_t>> nodeSpringOffsets_;
+    std::shared_ptr<Buffer<std::uint32_t>> nodeSprings_;
+
+    Shader integrateShader_;
+    Shader forcesShader_;
+};
+
+template <size_t N, typename T, typename Storage>
+GLSpringSystem::GLSpringSystem(const GravitySpringSystem<N, T, Storage>& sys)
+    : GLSpringSystem(positions(sys), sys.getSprings(), sys.lockedNodes, parameters(sys)) {}
+
+template <size_t N, typename T, typename Storage>
+GLSpringSystem::GLSpringSystem(const ZeroSpringSystem<N, T, Storage>& sys)
+    : GLSpringSystem(positions(sys), sys.getSprings(), sys.lockedNodes, parameters(sys)) {}
+
+template <size_t N, typename T, typename Storage>
+auto GLSpringSystem::parameters(const GravitySpringSystem<N, T, Storage>& sys) -> Parameters {
+    static_assert(N <= 3, "GLSpringSystem supports up to three components");
+    vec3 force{0.0f};
+    for (size_t i = 0; i < N; ++i) force[i] = static_cast<float>(sys.globalExternalForce[i]);
+    return {static_cast<float>(sys.getTimeStep()),
+            force,
+            static_cast<float>(sys.globalNodeMass),
+            static_cast<float>(sys.globalSpringConstant),
+            static_cast<float>(sys.globalSpringLength),
+            static_cast<float>(sys.globalSpringDampning)};
+}
+
+template <size_t N, typename T, typename Storage>
+auto GLSpringSystem::parameters(const ZeroSpringSystem<N, T, Storage>& sys) -> Parameters {
+    static_assert(N <= 3, "GLSpringSystem supports up to three components");
+    return {static_cast<float>(sys.getTimeStep()),
+            vec3{0.0f},
+            static_cast<float>(sys.globalNodeMass),
+            static_cast<float>(sys.globalSpringConstant),
+            static_cast<float>(sys.globalSpringLength),
+            static_cast<float>(sys.globalSpringDampning)};
+}
+
+template <typename Sys>
+std::vector<vec3> GLSpringSystem::positions(const Sys& sys) {
+    std::vector<vec3> res(sys.getNumberOfNodes(), vec3{0.0f});
+    for (size_t i = 0; i < res.size(); ++i) {
+        for (size_t c = 0; c < Sys::Components; ++c) {
+            res[i][c] = static_cast<float>(sys.position(i)[c]);
+        }
+    }
+    return res;
+}
+
+template <size_t N, typename T, typename Derived, typename PBC, typename Storage>
+void GLSpringSystem::download(SpringSystem<N, T, Derived, PBC, Storage>& sys) const {
+    static_assert(N <= 3, "GLSpringSystem supports up to three components");
+    const auto& pos = positions_->getRAMRepresentation()->getDataContainer();
+    const auto& vel = velocities_->getRAMRepresentation()->getDataContainer();
+    const auto& force = forces_->getRAMRepresentation()->getDataContainer();
+    for (size_t i = 0; i < std::min(numNodes_, sys.getNumberOfNodes()); ++i) {
+        for (size_t c = 0; c < N; ++c) {
+            sys.position(i)[c] = static_cast<T>(pos[i][c]);
+            sys.velocity(i)[c] = static_cast<T>(vel[i][c]);
+            sys.force(i)[c] = static_cast<T>(force[i][c]);
+        }
+    }
+}
+
+}  // namespace inviwo
@@ -40,11 +40,13 @@ namespace inviwo {
  * @see SpringMassConfig
  * @see SpringSystem
  */
-template <size_t N, typename ComponentType = double>
+template <size_t N, typename ComponentType = double, typename Storage = PackedStorage>
 class GravitySpringSystem
-    : public SpringSystem<N, ComponentType, GravitySpringSystem<N, ComponentType>> {
+    : public SpringSystem<N, ComponentType, GravitySpringSystem<N, ComponentType, Storage>,
+                          util::fill_integer_sequence<N, false>, Storage> {
 public:
-    using Base = SpringSystem<N, ComponentType, GravitySpringSystem<N, ComponentType>>;
+    using Base = SpringSystem<N, ComponentType, GravitySpringSystem<N, ComponentType, Storage>,
+                              util::fill_integer_sequence<N, false>, Storage>;
     using SpringIndices = typename Base::SpringIndices;
     static constexpr size_t Components = N;
     using Vector = glm::vec<Components, ComponentType>;
@@ -72,6 +74,8 @@ public:
     void constrainPosition(size_t, Vector&) const {}
     void constrainVelocity(size_t, Vector&) const {}
 
+    void permuteNodes(const std::vector<size_t>& order) { detail::permute(lockedNodes, order); }
+
     std::vector<bool> lockedNodes;
     Vector globalExternalForce = Vector{0};
     ComponentType globalNodeMass{1};
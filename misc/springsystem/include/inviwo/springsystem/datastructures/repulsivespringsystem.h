@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018-2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/springsystem/springsystemmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <inviwo/springsystem/datastructures/springsystem.h>
+#include <inviwo/springsystem/datastructures/barneshuttree.h>
+
+namespace inviwo {
+
+/**
+ * \brief Spring mass system config for graph layouts, a constant force plus a repulsion between
+ * all pairs of nodes.
+ *
+ * The repulsion on node i is globalRepulsion * sum_j (p_i - p_j) / (|p_i - p_j|^2 + softening^2)
+ * and is evaluated in parallel with a Barnes-Hut tree, see BarnesHutTree. Between full rebuilds,
+ * done every rebuildInterval steps, the tree is only refitted to the moved nodes.
+ * @see SpringSystem
+ * @see GravitySpringSystem
+ */
+template <size_t N, typename ComponentType = double, typename Storage = PackedStorage>
+class RepulsiveSpringSystem
+    : public SpringSystem<N, ComponentType, RepulsiveSpringSystem<N, ComponentType, Storage>,
+                          util::fill_integer_sequence<N, false>, Storage> {
+public:
+    using Base = SpringSystem<N, ComponentType, RepulsiveSpringSystem<N, ComponentType, Storage>,
+                              util::fill_integer_sequence<N, false>, Storage>;
+    using SpringIndices = typename Base::SpringIndices;
+    using StoredVector = typename Base::StoredVector;
+    static constexpr size_t Components = N;
+    using Vector = glm::vec<Components, ComponentType>;
+
+    RepulsiveSpringSystem(ComponentType timeStep, std::vector<Vector> positions,
+                          std::vector<SpringIndices> springs, std::vector<bool> aLockedNodes,
+                          Vector externalForce, ComponentType repulsion, ComponentType nodeMass,
+                          ComponentType springConstant, ComponentType springLength,
+                          ComponentType springDampning)
+        : Base(timeStep, std::move(positions), std::move(springs))
+        , lockedNodes{std::move(aLockedNodes)}
+        , globalExternalForce{externalForce}
+        , globalRepulsion{repulsion}
+        , globalNodeMass{nodeMass}
+        , globalSpringConstant{springConstant}
+        , globalSpringLength{springLength}
+        , globalSpringDampning{springDampning} {}
+
+    bool isLocked(size_t i) const { return lockedNodes[i]; }
+    void externalForces(std::vector<StoredVector>& forces) {
+        const auto& positions = this->getPositions();
+        if (tree_.getNumberOfPoints() != positions.size() || stepsSinceBuild_ >= rebuildInterval) {
+            tree_.build(positions);
+            stepsSinceBuild_ = 0;
+        } else {
+            tree_.refit(positions);
+        }
+        ++stepsSinceBuild_;
+
+        this->forEachIndex(forces.size(), [&](size_t i) {
+            forces[i] = globalExternalForce +
+                        globalRepulsion * tree_.repulsion(i, positions, theta, softening);
+        });
+    }
+    ComponentType nodeMass(size_t) { return globalNodeMass; }
+
+    ComponentType springConstant(size_t) const { return globalSpringConstant; }
+    ComponentType springLength(size_t) const { return globalSpringLength; }
+    ComponentType springDampning(size_t) const { return globalSpringDampning; }
+
+    void constrainPosition(size_t, Vector&) const {}
+    void constrainVelocity(size_t, Vector&) const {}
+
+    void permuteNodes(const std::vector<size_t>& order) {
+        detail::permute(lockedNodes, order);
+        // the cells refer to the old node indices
+        stepsSinceBuild_ = rebuildInterval;
+    }
+
+    std::vector<bool> lockedNodes;
+    Vector globalExternalForce = Vector{0};
+    ComponentType globalRepulsion{1};
+    ComponentType globalNodeMass{1};
+    ComponentType globalSpringConstant{1};
+    ComponentType globalSpringLength{1};
+    ComponentType globalSpringDampning{1};
+
+    /// opening angle of the Barnes-Hut approximation, 0 gives the exact sum
+    ComponentType theta{0.5};
+    /// avoids the singularity of the repulsion for coinciding nodes
+    ComponentType softening{0.001};
+    /// number of steps between full rebuilds of the tree, the tree is refitted in between
+    size_t rebuildInterval = 10;
+
+private:
+    BarnesHutTree<N, ComponentType> tree_;
+    size_t stepsSinceBuild_ = 0;
+};
+
+}  // namespace inviwo
@@ -34,11 +34,20 @@
 #include <inviwo/core/util/zip.h>
 #include <glm/gtc/epsilon.hpp>
 
+#include <warn/push>
+#include <warn/ignore/all>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <warn/pop>
+
+#include <memory>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <utility>
 #include <algorithm>
+#include <numeric>
+#include <limits>
 
 #ifdef __cpp_lib_parallel_algorithm
 #include <execution>
@@ -104,23 +113,129 @@ auto for_each_parallel(I1&& begin, I2&& end, F&& fun) {
 #endif
 }
 
+template <typename I1, typename I2, typename T, typename R, typename F>
+T transform_reduce_parallel(I1&& begin, I2&& end, T init, R&& reduce, F&& transform) {
+
+#ifdef __cpp_lib_parallel_algorithm
+    return std::transform_reduce(std::execution::par_unseq, std::forward<I1>(begin),
+                                 std::forward<I2>(end), init, std::forward<R>(reduce),
+                                 std::forward<F>(transform));
+#else
+    return std::transform_reduce(std::forward<I1>(begin), std::forward<I2>(end), init,
+                                 std::forward<R>(reduce), std::forward<F>(transform));
+#endif
+}
+
 }  // namespace util
 
+/**
+ * glm::vec<3, T> padded to the size and alignment of four components, see PaddedStorage
+ */
+template <typename T>
+struct alignas(4 * sizeof(T)) PaddedVec3 : glm::vec<3, T> {
+    PaddedVec3() = default;
+    PaddedVec3(const glm::vec<3, T>& v) : glm::vec<3, T>{v} {}
+    T padding{0};
+};
+
+/**
+ * Storage policy of the node state of a SpringSystem, i.e. positions, velocities, and forces,
+ * as consecutive glm vectors. This is the most compact layout, 12 bytes per vec3.
+ */
+struct PackedStorage {
+    template <size_t N, typename T>
+    using Element = glm::vec<N, T>;
+};
+
+/**
+ * Storage policy padding three component vectors to four components. Each vec3 is then aligned
+ * to 16 bytes for float, such that the update of a node compiles to single aligned SIMD
+ * operations, at the cost of a third more memory. The elements derive from glm::vec and are
+ * accessed as such.
+ */
+struct PaddedStorage {
+    template <size_t N, typename T>
+    using Element = std::conditional_t<N == 3, PaddedVec3<T>, glm::vec<N, T>>;
+};
+
+/**
+ * Time integration schemes of a SpringSystem
+ */
+enum class SpringIntegrator {
+    /// explicit velocity Verlet, stiff springs require small time steps
+    Verlet,
+    /// implicit projective dynamics, see SpringSystem::setIntegrator
+    Projective
+};
+
+namespace detail {
+
+/**
+ * Factorized system matrix and buffers of the projective integrator of a SpringSystem. The
+ * inputs of the factorization are kept to detect when it has to be recomputed.
+ */
+template <size_t Components, typename T>
+struct ProjectiveSolver {
+    using Vector = glm::vec<Components, T>;
+
+    T timeStep{0};
+    // mass plus time step times damping of each node, zero for locked nodes
+    std::vector<T> diagonal;
+    // stiffness of each spring
+    std::vector<T> weights;
+
+    // index of each node among the unlocked nodes, -1 for locked nodes
+    std::vector<int> freeIndex;
+    int numFree = 0;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<T>> ldlt;
+
+    // inertia and damping terms of the right hand side of each node
+    std::vector<Vector> inertia;
+    // periodic offset and projected difference of the nodes of each spring
+    std::vector<Vector> shifts;
+    std::vector<Vector> targets;
+    std::vector<Vector> next;
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> rhs;
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> solution;
+};
+
+/**
+ * Owning pointer to a cache that is cheap to recreate, copies start out empty.
+ */
+template <typename T>
+struct CachePtr : std::unique_ptr<T> {
+    CachePtr() = default;
+    CachePtr(std::unique_ptr<T> ptr) : std::unique_ptr<T>{std::move(ptr)} {}
+    CachePtr(const CachePtr&) : std::unique_ptr<T>{} {}
+    CachePtr(CachePtr&&) = default;
+    CachePtr& operator=(const CachePtr&) {
+        this->reset();
+        return *this;
+    }
+    CachePtr& operator=(CachePtr&&) = default;
+};
+
+}  // namespace detail
+
 /**
  * \class SpringSystem
  *
  * \brief this class is representing a spring mass system including a solver using either the Verlet
- * integration scheme.
+ * integration scheme or projective dynamics, see SpringIntegrator. The node state is stored as
+ * given by the \p Storage policy, see PackedStorage and PaddedStorage.
  *
  * @see SpringMassConfig
  * @see ConstGravityConfig
  */
 template <size_t Components, typename ComponentType, typename Derived,
-          typename PBC = util::fill_integer_sequence<Components, false>>
+          typename PBC = util::fill_integer_sequence<Components, false>,
+          typename Storage = PackedStorage>
 class SpringSystem {
 public:
     using SpringIndices = std::pair<std::size_t, std::size_t>;
     using Vector = glm::vec<Components, ComponentType>;
+    /// element type of the node state, Vector or derived from Vector
+    using StoredVector = typename Storage::template Element<Components, ComponentType>;
 
     SpringSystem(ComponentType timeStep, std::vector<Vector> positions,
                  std::vector<SpringIndices> springs, Vector origin = Vector{1},
@@ -132,12 +247,55 @@ public:
 
     void integrate(size_t steps = 1);
 
+    /**
+     * Select the integration scheme, Verlet by default. The projective scheme does implicit
+     * (backward Euler) steps with projective dynamics (Liu et al., Fast Simulation of Mass-Spring
+     * Systems, 2013). Each step alternates between projecting every spring onto its rest state
+     * and solving one sparse linear system over the spring graph. Spring forces other than
+     * linear ones are matched exactly in the projection. The system matrix only depends on the
+     * springs, the masses, the spring stiffnesses, the damping, the locked nodes, and the time
+     * step. Its sparse Cholesky factorization is computed once and reused until one of them
+     * changes. The projective scheme stays stable for time steps orders of magnitude larger
+     * than Verlet with stiff springs, at the cost of artificial damping.
+     */
+    void setIntegrator(SpringIntegrator integrator);
+    SpringIntegrator getIntegrator() const;
+
+    /**
+     * Number of local projection and global solve iterations of each projective step,
+     * 10 by default. More iterations converge further towards the exact implicit step.
+     */
+    void setProjectiveIterations(size_t iterations);
+    size_t getProjectiveIterations() const;
+
+    /**
+     * Integrate until the system is at rest, i.e. no node moves more than \p tolerance during
+     * one step, or until \p maxSteps steps have been done. The displacement is estimated from
+     * the velocities as |v| * time step and checked every \p checkInterval steps.
+     * @return the number of steps done
+     */
+    size_t integrateUntilConverged(size_t maxSteps, ComponentType tolerance,
+                                   size_t checkInterval = 10);
+
+    /**
+     * Largest displacement of an unlocked node during the next step, estimated as the largest
+     * |v| * time step.
+     */
+    ComponentType maxDisplacement() const;
+
+    /**
+     * Toggle the parallel loops over nodes and springs, enabled by default. Disable when many
+     * small systems are integrated concurrently, see springmass::integrate.
+     */
+    void setParallel(bool parallel);
+    bool isParallel() const;
+
     size_t getNumberOfNodes() const;
     size_t getNumberOfSprings() const;
 
-    const std::vector<Vector>& getPositions() const;
-    const std::vector<Vector>& getVelocities() const;
-    const std::vector<Vector>& getForces() const;
+    const std::vector<StoredVector>& getPositions() const;
+    const std::vector<StoredVector>& getVelocities() const;
+    const std::vector<StoredVector>& getForces() const;
 
     const Vector& position(size_t i) const;
     const Vector& velocity(size_t i) const;
@@ -149,6 +307,24 @@ public:
 
     const std::vector<SpringIndices>& getSprings() const;
 
+    /**
+     * Reorder the nodes along a Morton curve through their bounding box and sort the springs by
+     * their nodes. Nodes close in space are then close in memory, which makes force
+     * accumulation and integration cache friendly for large systems. All node and spring
+     * indices refer to the new order afterwards, use nodeIndex() and getNodeOrder() to map
+     * between the input order and the new order. Derived classes with per node or per spring
+     * data apply the permutations in permuteNodes() and permuteSprings().
+     */
+    void reorderNodes();
+    /**
+     * Input index of each node, empty if the nodes have not been reordered.
+     */
+    const std::vector<size_t>& getNodeOrder() const;
+    /**
+     * Index of the node with input index \p inputIndex.
+     */
+    size_t nodeIndex(size_t inputIndex) const;
+
     template <class Elem, class Traits>
     void print(std::basic_ostream<Elem, Traits>& ss) const;
 
@@ -158,122 +334,599 @@ protected:
     inline Derived& derived() { return *static_cast<Derived*>(this); }
     inline const Derived& derived() const { return *static_cast<const Derived*>(this); }
 
-    void externalForces(std::vector<Vector>& forces);
+    void externalForces(std::vector<StoredVector>& forces);
     Vector externalForce(size_t i);
     void updateForces();
     void verletIntegration();
+    void projectiveIntegration();
+    void wrapPosition(Vector& pos) const;
 
     ComponentType forceMagnitude(size_t i, ComponentType displacement) const;
+    /**
+     * Stiffness of spring \p i used in the system matrix of the projective integrator, defaults
+     * to the force at unit displacement. Only affects the convergence of the projective steps,
+     * the spring forces are given by forceMagnitude().
+     */
+    ComponentType springStiffness(size_t i);
+
+    /**
+     * Called by reorderNodes(), new node i is old node \p order[i].
+     */
+    void permuteNodes(const std::vector<size_t>& order);
+    /**
+     * Called by reorderNodes(), new spring i is old spring \p order[i].
+     */
+    void permuteSprings(const std::vector<size_t>& order);
+
+    void updateAdjacency();
+
+    // calls f(i) for all i in [0, size), in parallel if enabled
+    template <typename F>
+    void forEachIndex(size_t size, F&& f) const;
+    // calls f(begin, end) for consecutive ranges covering [0, size), in parallel if enabled
+    template <typename F>
+    void forEachRange(size_t size, F&& f) const;
 
     ComponentType timeStep_;
-    std::vector<Vector> positions_;
-    std::vector<Vector> velocities_;
-    std::vector<Vector> forces_;
+    std::vector<StoredVector> positions_;
+    std::vector<StoredVector> velocities_;
+    std::vector<StoredVector> forces_;
     std::vector<SpringIndices> springs_;
     Vector origin_;
     Vector extent_;
+
+    // Springs attached to each node in CSR layout, the springs of node i are
+    // nodeSprings_[nodeSpringOffsets_[i]] to nodeSprings_[nodeSpringOffsets_[i + 1] - 1].
+    // Each entry is 2 * spring index + 1 if the node is the second node of the spring.
+    std::vector<size_t> nodeSpringOffsets_;
+    std::vector<size_t> nodeSprings_;
+    std::vector<Vector> springForces_;
+
+    // input index of each node and its inverse, empty unless reordered
+    std::vector<size_t> nodeOrder_;
+    std::vector<size_t> inputToNode_;
+    bool parallel_ = true;
+
+    // per node factors of the Verlet integration, see verletIntegration()
+    std::vector<ComponentType> moving_;
+    std::vector<ComponentType> halfStepScale_;
+
+    SpringIntegrator integrator_ = SpringIntegrator::Verlet;
+    size_t projectiveIterations_ = 10;
+    detail::CachePtr<detail::ProjectiveSolver<Components, ComponentType>> projective_;
 };
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-SpringSystem<Components, ComponentType, Derived, PBC>::SpringSystem(
+namespace detail {
+
+template <typename Stored, typename T>
+std::vector<Stored> toStorage(std::vector<T> data) {
+    if constexpr (std::is_same_v<Stored, T>) {
+        return data;
+    } else {
+        return std::vector<Stored>(data.begin(), data.end());
+    }
+}
+
+template <typename T>
+void permute(std::vector<T>& data, const std::vector<size_t>& order) {
+    std::vector<T> result;
+    result.reserve(order.size());
+    for (auto i : order) result.push_back(data[i]);
+    data = std::move(result);
+}
+
+}  // namespace detail
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+SpringSystem<Components, ComponentType, Derived, PBC, Storage>::SpringSystem(
     ComponentType timeStep, std::vector<Vector> positions, std::vector<SpringIndices> springs,
     Vector origin, Vector extent)
     : timeStep_{timeStep}
-    , positions_{std::move(positions)}
+    , positions_{detail::toStorage<StoredVector>(std::move(positions))}
     , velocities_(positions_.size(), Vector{0})
     , forces_(positions_.size(), Vector{0})
     , springs_{std::move(springs)}
     , origin_{origin}
-    , extent_{extent} {}
+    , extent_{extent} {
+    updateAdjacency();
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::reorderNodes() {
+    const auto numNodes = positions_.size();
+    if (numNodes == 0) return;
+
+    Vector min{positions_.front()};
+    Vector max{positions_.front()};
+    for (const auto& p : positions_) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    const auto range = glm::max(max - min, Vector{std::numeric_limits<ComponentType>::epsilon()});
+
+    // interleave the bits of the quantized coordinates
+    constexpr size_t bits = 63 / Components;
+    constexpr auto maxCoord = static_cast<ComponentType>((uint64_t{1} << bits) - 1);
+    std::vector<uint64_t> codes(numNodes);
+    forEachIndex(numNodes, [&](size_t i) {
+        const auto q = glm::vec<Components, uint64_t>((positions_[i] - min) / range * maxCoord);
+        uint64_t code = 0;
+        for (size_t b = bits; b-- > 0;) {
+            for (size_t d = 0; d < Components; ++d) {
+                code = (code << 1) | ((q[d] >> b) & uint64_t{1});
+            }
+        }
+        codes[i] = code;
+    });
+
+    std::vector<size_t> order(numNodes);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return codes[a] < codes[b]; });
+
+    std::vector<size_t> newIndex(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) newIndex[order[i]] = i;
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-void SpringSystem<Components, ComponentType, Derived, PBC>::integrate(size_t steps) {
+    detail::permute(positions_, order);
+    detail::permute(velocities_, order);
+    detail::permute(forces_, order);
+    derived().permuteNodes(order);
+
+    for (auto& spring : springs_) {
+        spring = {newIndex[spring.first], newIndex[spring.second]};
+    }
+    std::vector<size_t> springOrder(springs_.size());
+    std::iota(springOrder.begin(), springOrder.end(), size_t{0});
+    std::stable_sort(springOrder.begin(), springOrder.end(), [&](size_t a, size_t b) {
+        const auto& sa = springs_[a];
+        const auto& sb = springs_[b];
+        return std::minmax(sa.first, sa.second) < std::minmax(sb.first, sb.second);
+    });
+    detail::permute(springs_, springOrder);
+    derived().permuteSprings(springOrder);
+
+    // compose with an earlier reordering
+    if (nodeOrder_.empty()) {
+        nodeOrder_ = std::move(order);
+    } else {
+        detail::permute(nodeOrder_, order);
+    }
+    inputToNode_.resize(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) inputToNode_[nodeOrder_[i]] = i;
+
+    updateAdjacency();
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getNodeOrder() const
+    -> const std::vector<size_t>& {
+    return nodeOrder_;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+size_t SpringSystem<Components, ComponentType, Derived, PBC, Storage>::nodeIndex(
+    size_t inputIndex) const {
+    return inputToNode_.empty() ? inputIndex : inputToNode_[inputIndex];
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::permuteNodes(
+    const std::vector<size_t>&) {}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::permuteSprings(
+    const std::vector<size_t>&) {}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::updateAdjacency() {
+    nodeSpringOffsets_.assign(positions_.size() + 1, 0);
+    for (const auto& spring : springs_) {
+        ++nodeSpringOffsets_[spring.first + 1];
+        ++nodeSpringOffsets_[spring.second + 1];
+    }
+    std::partial_sum(nodeSpringOffsets_.begin(), nodeSpringOffsets_.end(),
+                     nodeSpringOffsets_.begin());
+
+    nodeSprings_.resize(2 * springs_.size());
+    auto next = nodeSpringOffsets_;
+    for (size_t i = 0; i < springs_.size(); ++i) {
+        nodeSprings_[next[springs_[i].first]++] = 2 * i;
+        nodeSprings_[next[springs_[i].second]++] = 2 * i + 1;
+    }
+    springForces_.resize(springs_.size());
+    projective_.reset();
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::integrate(size_t steps) {
     for (size_t i = 0; i < steps; ++i) {
-        verletIntegration();
+        if (integrator_ == SpringIntegrator::Projective) {
+            projectiveIntegration();
+        } else {
+            verletIntegration();
+        }
+    }
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::setIntegrator(
+    SpringIntegrator integrator) {
+    integrator_ = integrator;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getIntegrator() const
+    -> SpringIntegrator {
+    return integrator_;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::setProjectiveIterations(
+    size_t iterations) {
+    projectiveIterations_ = std::max(iterations, size_t{1});
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getProjectiveIterations() const
+    -> size_t {
+    return projectiveIterations_;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+size_t SpringSystem<Components, ComponentType, Derived, PBC, Storage>::integrateUntilConverged(
+    size_t maxSteps, ComponentType tolerance, size_t checkInterval) {
+    checkInterval = std::max(checkInterval, size_t{1});
+    size_t steps = 0;
+    while (steps < maxSteps) {
+        const auto count = std::min(checkInterval, maxSteps - steps);
+        integrate(count);
+        steps += count;
+        if (maxDisplacement() < tolerance) break;
+    }
+    return steps;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::maxDisplacement() const
+    -> ComponentType {
+    const auto seq = util::make_sequence(size_t{0}, velocities_.size(), size_t{1});
+    const auto max = [](ComponentType a, ComponentType b) { return std::max(a, b); };
+    const auto speed = [&](size_t i) {
+        return derived().isLocked(i) ? ComponentType{0} : glm::length(velocities_[i]);
+    };
+    const auto maxSpeed =
+        parallel_ ? util::transform_reduce_parallel(seq.begin(), seq.end(), ComponentType{0}, max,
+                                                    speed)
+                  : std::transform_reduce(seq.begin(), seq.end(), ComponentType{0}, max, speed);
+    return maxSpeed * timeStep_;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::setParallel(bool parallel) {
+    parallel_ = parallel;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+bool SpringSystem<Components, ComponentType, Derived, PBC, Storage>::isParallel() const {
+    return parallel_;
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+template <typename F>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::forEachIndex(size_t size,
+                                                                        F&& f) const {
+    const auto seq = util::make_sequence(size_t{0}, size, size_t{1});
+    if (parallel_) {
+        util::for_each_parallel(seq.begin(), seq.end(), std::forward<F>(f));
+    } else {
+        std::for_each(seq.begin(), seq.end(), std::forward<F>(f));
     }
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-void SpringSystem<Components, ComponentType, Derived, PBC>::verletIntegration() {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+template <typename F>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::forEachRange(size_t size,
+                                                                                 F&& f) const {
+    constexpr size_t rangeSize = 4096;
+    const size_t numRanges = (size + rangeSize - 1) / rangeSize;
+    forEachIndex(numRanges,
+                 [&](size_t r) { f(r * rangeSize, std::min(size, (r + 1) * rangeSize)); });
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::verletIntegration() {
     const std::size_t numNodes = positions_.size();
 
     // Verlet integration see <https://en.wikipedia.org/wiki/Verlet_integration>
 
+    // 0) per node factors, such that the update loops below contain neither branches nor calls
+    // to the derived class and can be vectorized. Locked nodes get zero for both factors.
+    const ComponentType h = timeStep_;
+    moving_.resize(numNodes);
+    halfStepScale_.resize(numNodes);
+    forEachRange(numNodes, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const bool locked = derived().isLocked(i);
+            moving_[i] = locked ? ComponentType{0} : ComponentType{1};
+            halfStepScale_[i] =
+                locked ? ComponentType{0} : ComponentType{0.5} * h / derived().nodeMass(i);
+        }
+    });
+
     // 1) calculate pos(t + timeStep_) and first part of v(t + timeStep_) based on current forces
-    const auto seq = util::make_sequence(size_t{0}, numNodes, size_t{1});
-    util::for_each_parallel(seq.begin(), seq.end(), [&](size_t i) {
-        if (derived().isLocked(i)) return;
+    forEachRange(numNodes, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Vector deltaV = halfStepScale_[i] * forces_[i];
+            positions_[i] += (moving_[i] * h) * (velocities_[i] + deltaV);
+            velocities_[i] += deltaV;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (moving_[i] == ComponentType{0}) continue;
+            wrapPosition(positions_[i]);
+            derived().constrainPosition(i, positions_[i]);
+            derived().constrainVelocity(i, velocities_[i]);
+        }
+    });
+
+    // 2) update forces of all nodes by iterating all springs
+    derived().updateForces();
+
+    // 3) adding 0.5 * v based on new forces
+    forEachRange(numNodes, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            velocities_[i] += halfStepScale_[i] * forces_[i];
+        }
+        for (size_t i = begin; i < end; ++i) {
+            if (moving_[i] == ComponentType{0}) continue;
+            derived().constrainVelocity(i, velocities_[i]);
+        }
+    });
+}
+
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::wrapPosition(
+    Vector& pos) const {
+    util::for_each_index<Components>([&](auto wd) {
+        constexpr auto d = decltype(wd)::value;
+        if constexpr (hasPBC(d)) {
+            if (pos[d] < origin_[d])
+                pos[d] += extent_[d];
+            else if (pos[d] >= origin_[d] + extent_[d])
+                pos[d] -= extent_[d];
+        }
+    });
+}
 
-        const auto a = forces_[i] / derived().nodeMass(i);  // acceleration
-        const auto deltaV = ComponentType{0.5} * a * timeStep_;
-        const auto posOffset = velocities_[i] * timeStep_ + deltaV * timeStep_;
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::projectiveIntegration() {
+    using T = ComponentType;
+    const size_t numNodes = positions_.size();
+    const size_t numSprings = springs_.size();
+    const T h = timeStep_;
+    const T h2 = h * h;
+
+    if (!projective_) {
+        projective_ = std::make_unique<detail::ProjectiveSolver<Components, T>>();
+    }
+    auto& ps = *projective_;
+
+    // 1) inputs of the system matrix, the damping of a node is the sum over its springs as in
+    // updateForces()
+    std::vector<T> diagonal(numNodes);
+    std::vector<T> weights(numSprings);
+    // a spring without force at unit displacement still needs a positive weight
+    forEachIndex(numSprings, [&](size_t i) {
+        const auto stiffness = std::abs(derived().springStiffness(i));
+        weights[i] = stiffness > T{0} ? stiffness : T{1};
+    });
+    forEachIndex(numNodes, [&](size_t n) {
+        if (derived().isLocked(n)) {
+            diagonal[n] = T{0};
+            return;
+        }
+        T damping{0};
+        for (size_t j = nodeSpringOffsets_[n]; j < nodeSpringOffsets_[n + 1]; ++j) {
+            damping += derived().springDampning(nodeSprings_[j] / 2);
+        }
+        diagonal[n] = derived().nodeMass(n) + h * damping;
+    });
 
-        auto newPos = positions_[i] + posOffset;
+    // 2) factorize (M + h C + h^2 L) over the unlocked nodes, where L is the graph Laplacian
+    // weighted by the spring stiffnesses, unless nothing changed since the last step
+    if (ps.timeStep != h || ps.diagonal != diagonal || ps.weights != weights ||
+        ps.freeIndex.size() != numNodes) {
+        ps.timeStep = h;
+        ps.diagonal = std::move(diagonal);
+        ps.weights = std::move(weights);
+
+        ps.freeIndex.assign(numNodes, -1);
+        ps.numFree = 0;
+        for (size_t n = 0; n < numNodes; ++n) {
+            if (!derived().isLocked(n)) ps.freeIndex[n] = ps.numFree++;
+        }
 
+        std::vector<Eigen::Triplet<T>> triplets;
+        triplets.reserve(numNodes + 4 * numSprings);
+        for (size_t n = 0; n < numNodes; ++n) {
+            if (ps.freeIndex[n] >= 0) {
+                triplets.emplace_back(ps.freeIndex[n], ps.freeIndex[n], ps.diagonal[n]);
+            }
+        }
+        for (size_t i = 0; i < numSprings; ++i) {
+            const auto a = ps.freeIndex[springs_[i].first];
+            const auto b = ps.freeIndex[springs_[i].second];
+            const T w = h2 * ps.weights[i];
+            if (a >= 0) triplets.emplace_back(a, a, w);
+            if (b >= 0) triplets.emplace_back(b, b, w);
+            if (a >= 0 && b >= 0) {
+                triplets.emplace_back(a, b, -w);
+                triplets.emplace_back(b, a, -w);
+            }
+        }
+        Eigen::SparseMatrix<T> matrix(ps.numFree, ps.numFree);
+        matrix.setFromTriplets(triplets.begin(), triplets.end());
+        ps.ldlt.compute(matrix);
+        if (ps.ldlt.info() != Eigen::Success) {
+            ps.freeIndex.clear();
+            throw Exception("Failed to factorize the spring system matrix, all unlocked nodes "
+                            "need a positive mass",
+                            IVW_CONTEXT_CUSTOM("SpringSystem"));
+        }
+    }
+    if (ps.numFree == 0) return;
+
+    // 3) periodic offsets of the springs, the difference of the nodes of spring i is
+    // x[second] - x[first] + shifts[i], and the constant terms of the right hand side
+    derived().externalForces(forces_);
+    ps.shifts.resize(numSprings);
+    ps.targets.resize(numSprings);
+    ps.inertia.resize(numNodes);
+    ps.next.resize(numNodes);
+    forEachIndex(numSprings, [&](size_t i) {
+        const auto& pos1 = positions_[springs_[i].first];
+        const auto& pos2 = positions_[springs_[i].second];
+        Vector shift{0};
         util::for_each_index<Components>([&](auto wd) {
             constexpr auto d = decltype(wd)::value;
             if constexpr (hasPBC(d)) {
-                if (newPos[d] < origin_[d])
-                    newPos[d] += extent_[d];
-                else if (newPos[d] >= origin_[d] + extent_[d])
-                    newPos[d] -= extent_[d];
+                const auto diff = pos1[d] - pos2[d];
+                shift[d] = (int{diff > 0.5f * extent_[d]} - int{diff < -0.5f * extent_[d]}) *
+                           extent_[d];
             }
         });
-
-        derived().constrainPosition(i, newPos);
-        positions_[i] = newPos;
-
-        auto newVel = velocities_[i] + deltaV;
-        derived().constrainVelocity(i, newVel);
-        velocities_[i] = newVel;
+        ps.shifts[i] = shift;
+    });
+    forEachIndex(numNodes, [&](size_t n) {
+        if (ps.freeIndex[n] < 0) {
+            ps.next[n] = positions_[n];
+            return;
+        }
+        const T mass = derived().nodeMass(n);
+        const T damping = ps.diagonal[n] - mass;
+        ps.inertia[n] = mass * (positions_[n] + h * velocities_[n]) + damping * positions_[n] +
+                        h2 * forces_[n];
+        // start from the explicit prediction
+        ps.next[n] = positions_[n] + h * velocities_[n] +
+                     (mass > T{0} ? h2 / mass : T{0}) * forces_[n];
     });
 
-    // 2) update forces of all nodes by iterating all springs
-    derived().updateForces();
-
-    // 3) adding 0.5 * v based on new forces
-    util::for_each_parallel(seq.begin(), seq.end(), [&](size_t i) {
-        if (derived().isLocked(i)) return;
+    ps.rhs.resize(ps.numFree, Components);
+    for (size_t iteration = 0; iteration < projectiveIterations_; ++iteration) {
+        // 4) local step, the difference of the nodes of each spring for which the quadratic
+        // spring energy w / 2 |d - target|^2 gives the force of forceMagnitude()
+        forEachIndex(numSprings, [&](size_t i) {
+            const auto diff =
+                ps.next[springs_[i].second] - ps.next[springs_[i].first] + ps.shifts[i];
+            const auto dist = glm::length(diff);
+            const auto dir = dist > T{0} ? diff / dist : Vector{0};
+            const T length =
+                dist -
+                derived().forceMagnitude(i, dist - derived().springLength(i)) / ps.weights[i];
+            ps.targets[i] = length * dir - ps.shifts[i];
+        });
 
-        const auto acceleration = forces_[i] / derived().nodeMass(i);
-        const auto deltaV = ComponentType{0.5} * acceleration * timeStep_;
+        // 5) global step, gather the spring terms of each node and solve
+        forEachIndex(numNodes, [&](size_t n) {
+            const auto row = ps.freeIndex[n];
+            if (row < 0) return;
+            auto b = ps.inertia[n];
+            for (size_t j = nodeSpringOffsets_[n]; j < nodeSpringOffsets_[n + 1]; ++j) {
+                const auto i = nodeSprings_[j] / 2;
+                const bool second = nodeSprings_[j] % 2;
+                const auto other = second ? springs_[i].first : springs_[i].second;
+                auto term = second ? ps.targets[i] : -ps.targets[i];
+                if (ps.freeIndex[other] < 0) term += positions_[other];
+                b += h2 * ps.weights[i] * term;
+            }
+            for (size_t d = 0; d < Components; ++d) ps.rhs(row, d) = b[d];
+        });
+        ps.solution = ps.ldlt.solve(ps.rhs);
+        forEachIndex(numNodes, [&](size_t n) {
+            const auto row = ps.freeIndex[n];
+            if (row < 0) return;
+            for (size_t d = 0; d < Components; ++d) ps.next[n][d] = ps.solution(row, d);
+        });
+    }
 
-        auto newVel = velocities_[i] + deltaV;
-        derived().constrainVelocity(i, newVel);
-        velocities_[i] = newVel;
+    // 6) velocities from the displacement, then wrap and constrain as in verletIntegration()
+    forEachIndex(numNodes, [&](size_t n) {
+        if (ps.freeIndex[n] < 0) return;
+        auto newVel = (ps.next[n] - positions_[n]) / h;
+        auto newPos = ps.next[n];
+        wrapPosition(newPos);
+        derived().constrainPosition(n, newPos);
+        positions_[n] = newPos;
+        derived().constrainVelocity(n, newVel);
+        velocities_[n] = newVel;
     });
+
+    // keep the forces up to date for inspection
+    derived().updateForces();
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-ComponentType SpringSystem<Components, ComponentType, Derived, PBC>::forceMagnitude(
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+ComponentType SpringSystem<Components, ComponentType, Derived, PBC, Storage>::forceMagnitude(
     size_t i, ComponentType displacement) const {
 
     return displacement * derived().springConstant(i);
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-void SpringSystem<Components, ComponentType, Derived, PBC>::externalForces(
-    std::vector<Vector>& forces) {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::springStiffness(size_t i)
+    -> ComponentType {
+    return derived().forceMagnitude(i, ComponentType{1});
+}
 
-    const auto fseq = util::make_sequence(size_t{0}, forces.size(), size_t{1});
-    util::for_each_parallel(fseq.begin(), fseq.end(),
-                            [&](size_t i) { forces[i] = derived().externalForce(i); });
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::externalForces(
+    std::vector<StoredVector>& forces) {
+
+    forEachIndex(forces.size(), [&](size_t i) { forces[i] = derived().externalForce(i); });
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::externalForce(size_t) -> Vector {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::externalForce(size_t)
+    -> Vector {
     return Vector{0};
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-void SpringSystem<Components, ComponentType, Derived, PBC>::updateForces() {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::updateForces() {
 
     derived().externalForces(forces_);
 
     const auto& positions = getPositions();
 
-    const auto seq = util::make_sequence(size_t{0}, springs_.size(), size_t{1});
-    util::for_each_parallel(seq.begin(), seq.end(), [&](size_t i) {
+    // Compute the force of each spring, then let each node gather the forces of its springs.
+    // Every force is written by a single thread and summed in a fixed order, which makes the
+    // result independent of the scheduling.
+    forEachIndex(springs_.size(), [&](size_t i) {
         const auto& spring = springs_[i];
 
         auto pos1 = positions[spring.first];
@@ -293,88 +946,115 @@ void SpringSystem<Components, ComponentType, Derived, PBC>::updateForces() {
         }
 
         const auto displacement = dist - derived().springLength(i);
-        const auto force = -derived().forceMagnitude(i, displacement) * dir;
-        const auto dampning = derived().springDampning(i);
+        springForces_[i] = -derived().forceMagnitude(i, displacement) * dir;
+    });
 
-        // add force to both nodes
-        forces_[spring.first] += -force - dampning * velocities_[spring.first];
-        forces_[spring.second] += force - dampning * velocities_[spring.second];
+    forEachIndex(positions_.size(), [&](size_t n) {
+        auto force = forces_[n];
+        for (size_t j = nodeSpringOffsets_[n]; j < nodeSpringOffsets_[n + 1]; ++j) {
+            const auto i = nodeSprings_[j] / 2;
+            const auto& springForce = springForces_[i];
+            // the force pulls the two nodes of a spring in opposite directions
+            force += (nodeSprings_[j] % 2 ? springForce : -springForce) -
+                     derived().springDampning(i) * velocities_[n];
+        }
+        forces_[n] = force;
     });
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getNumberOfNodes() const -> size_t {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getNumberOfNodes() const
+    -> size_t {
     return positions_.size();
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getNumberOfSprings() const -> size_t {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getNumberOfSprings() const
+    -> size_t {
     return springs_.size();
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getTimeStep() const -> ComponentType {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getTimeStep() const
+    -> ComponentType {
     return timeStep_;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-void SpringSystem<Components, ComponentType, Derived, PBC>::setTimeStep(ComponentType timestep) {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::setTimeStep(
+    ComponentType timestep) {
     timeStep_ = timestep;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getPositions() const
-    -> const std::vector<Vector>& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getPositions() const
+    -> const std::vector<StoredVector>& {
     return positions_;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getVelocities() const
-    -> const std::vector<Vector>& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getVelocities() const
+    -> const std::vector<StoredVector>& {
     return velocities_;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getForces() const
-    -> const std::vector<Vector>& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getForces() const
+    -> const std::vector<StoredVector>& {
     return forces_;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::position(size_t i) const
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::position(size_t i) const
     -> const Vector& {
     return positions_[i];
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::velocity(size_t i) const
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::velocity(size_t i) const
     -> const Vector& {
     return velocities_[i];
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::force(size_t i) const -> const Vector& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::force(size_t i) const
+    -> const Vector& {
     return forces_[i];
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::position(size_t i) -> Vector& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::position(size_t i) -> Vector& {
     return positions_[i];
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::velocity(size_t i) -> Vector& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::velocity(size_t i) -> Vector& {
     return velocities_[i];
 }
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::force(size_t i) -> Vector& {
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::force(size_t i) -> Vector& {
     return forces_[i];
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
-auto SpringSystem<Components, ComponentType, Derived, PBC>::getSprings() const
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
+auto SpringSystem<Components, ComponentType, Derived, PBC, Storage>::getSprings() const
     -> const std::vector<SpringIndices>& {
     return springs_;
 }
 
-template <size_t Components, typename ComponentType, typename Derived, typename PBC>
+template <size_t Components, typename ComponentType, typename Derived, typename PBC,
+          typename Storage>
 template <class Elem, class Traits>
-void SpringSystem<Components, ComponentType, Derived, PBC>::print(
+void SpringSystem<Components, ComponentType, Derived, PBC, Storage>::print(
     std::basic_ostream<Elem, Traits>& ss) const {
     ss << "Nodes:";
     for (std::size_t i = 0; i < positions_.size(); ++i) {
@@ -398,10 +1078,10 @@ void SpringSystem<Components, ComponentType, Derived, PBC>::print(
 }
 
 template <class Elem, class Traits, size_t Components, typename ComponentType, typename Derived,
-          typename PBC>
+          typename PBC, typename Storage>
 std::basic_ostream<Elem, Traits>& operator<<(
     std::basic_ostream<Elem, Traits>& ss,
-    const SpringSystem<Components, ComponentType, Derived, PBC>& sms) {
+    const SpringSystem<Components, ComponentType, Derived, PBC, Storage>& sms) {
     sms.print(ss);
     return ss;
 }
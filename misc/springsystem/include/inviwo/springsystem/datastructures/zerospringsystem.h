@@ -41,10 +41,13 @@ namespace inviwo {
  * This instance will set all initial forces to zero.
  * @see SpringSystem
  */
-template <size_t N, typename ComponentType = double>
-class ZeroSpringSystem : public SpringSystem<N, ComponentType, ZeroSpringSystem<N, ComponentType>> {
+template <size_t N, typename ComponentType = double, typename Storage = PackedStorage>
+class ZeroSpringSystem
+    : public SpringSystem<N, ComponentType, ZeroSpringSystem<N, ComponentType, Storage>,
+                          util::fill_integer_sequence<N, false>, Storage> {
 public:
-    using Base = SpringSystem<N, ComponentType, ZeroSpringSystem<N, ComponentType>>;
+    using Base = SpringSystem<N, ComponentType, ZeroSpringSystem<N, ComponentType, Storage>,
+                              util::fill_integer_sequence<N, false>, Storage>;
     using SpringIndices = typename Base::SpringIndices;
     static constexpr size_t Components = N;
     using Vector = glm::vec<Components, ComponentType>;
@@ -71,6 +74,8 @@ public:
     void constrainPosition(size_t, Vector&) const {}
     void constrainVelocity(size_t, Vector&) const {}
 
+    void permuteNodes(const std::vector<size_t>& order) { detail::permute(lockedNodes, order); }
+
     std::vector<bool> lockedNodes;
     ComponentType globalNodeMass{1};
     ComponentType globalSpringConstant{1};
@@ -31,17 +31,21 @@
 
 #include <inviwo/springsystem/springsystemmoduledefine.h>
 #include <inviwo/springsystem/datastructures/gravityspringsystem.h>
+#include <inviwo/springsystem/datastructures/glspringsystem.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/interaction/pickingmapper.h>
 #include <inviwo/core/properties/cameraproperty.h>
 #include <inviwo/core/ports/meshport.h>
 #include <inviwo/core/util/timer.h>
 #include <inviwo/core/processors/activityindicator.h>
 
+#include <optional>
+
 namespace inviwo {
 
 class Mesh;
@@ -66,6 +70,12 @@ class PickingEvent;
  *   * __Spring Length [m]__
  *   * __Delta T [s]__
  *   * __Iterations Per Step_
+ *   * __Integrator__ explicit Verlet or implicit projective dynamics, which allows much larger
+ *                    time steps for stiff springs, see SpringSystem::setIntegrator
+ *   * __Projective Iterations__ local/global iterations of each projective step
+ *   * __GPU Solver__ integrate on the GPU using compute shaders, the state stays on the GPU
+ *                    between steps and is only downloaded once per update. Always uses Verlet
+ *                    integration.
  *   * __Ext. Force F [N]__
  *   * __Scale Factor for Mesh coloring__
  *   * __Advance__
@@ -109,6 +119,9 @@ private:
 
     DoubleProperty deltaT_;
     IntProperty iterationsPerStep_;
+    TemplateOptionProperty<SpringIntegrator> integrator_;
+    IntSizeTProperty projectiveIterations_;
+    BoolProperty gpuSolver_;
     DoubleVec2Property externalForce_;
     FloatProperty scaleFactor_;
     ButtonProperty advanceButton_;
@@ -125,6 +138,8 @@ private:
 
     GravitySpringSystem<2, double> springSystem_;
     PickingMapper nodePicking_;
+    // created from springSystem_ on the first GPU step, reset whenever springSystem_ is replaced
+    std::optional<GLSpringSystem> glSpringSystem_;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,177 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/springsystem/datastructures/glspringsystem.h>
+
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/rendercontext.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglutils.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+
+constexpr GLuint workGroupSize = 128;
+
+template <typename T>
+std::shared_ptr<Buffer<T>> makeBuffer(std::vector<T> data) {
+    return std::make_shared<Buffer<T>>(
+        std::make_shared<BufferRAMPrecision<T>>(std::move(data), BufferUsage::Dynamic));
+}
+
+template <typename T>
+GLuint bufferId(Buffer<T>& buffer) {
+    return buffer.template getEditableRepresentation<BufferGL>()->getId();
+}
+
+// might be called from event handlers, outside of process()
+template <typename T>
+void uploadElement(Buffer<T>& buffer, size_t i, const T& value) {
+    RenderContext::getPtr()->activateDefaultRenderContext();
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferId(buffer));
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, i * sizeof(T), sizeof(T), &value);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+}  // namespace
+
+GLSpringSystem::GLSpringSystem(const std::vector<vec3>& positions,
+                               const std::vector<SpringIndices>& springs,
+                               const std::vector<bool>& locked, const Parameters& parameters)
+    : parameters_{parameters}
+    , numNodes_{positions.size()}
+    , numSprings_{springs.size()}
+    , integrateShader_({{ShaderType::Compute, "springsystemintegrate.comp"}})
+    , forcesShader_({{ShaderType::Compute, "springsystemforces.comp"}}) {
+
+    std::vector<vec4> pos(numNodes_);
+    std::transform(positions.begin(), positions.end(), pos.begin(),
+                   [](const vec3& p) { return vec4{p, 1.0f}; });
+    positions_ = makeBuffer(std::move(pos));
+    velocities_ = makeBuffer(std::vector<vec4>(numNodes_, vec4{0.0f}));
+    forces_ = makeBuffer(std::vector<vec4>(numNodes_, vec4{0.0f}));
+
+    std::vector<std::uint32_t> lockedNodes(numNodes_, 0);
+    for (size_t i = 0; i < std::min(numNodes_, locked.size()); ++i) {
+        lockedNodes[i] = locked[i] ? 1 : 0;
+    }
+    locked_ = makeBuffer(std::move(lockedNodes));
+
+    std::vector<glm::uvec2> springNodes(numSprings_);
+    std::vector<std::uint32_t> offsets(numNodes_ + 1, 0);
+    for (size_t i = 0; i < numSprings_; ++i) {
+        springNodes[i] = glm::uvec2{springs[i].first, springs[i].second};
+        ++offsets[springs[i].first + 1];
+        ++offsets[springs[i].second + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::uint32_t> nodeSprings(2 * numSprings_);
+    auto next = offsets;
+    for (size_t i = 0; i < numSprings_; ++i) {
+        nodeSprings[next[springs[i].first]++] = static_cast<std::uint32_t>(2 * i);
+        nodeSprings[next[springs[i].second]++] = static_cast<std::uint32_t>(2 * i + 1);
+    }
+    springs_ = makeBuffer(std::move(springNodes));
+    nodeSpringOffsets_ = makeBuffer(std::move(offsets));
+    nodeSprings_ = makeBuffer(std::move(nodeSprings));
+}
+
+auto GLSpringSystem::getParameters() const -> const Parameters& { return parameters_; }
+
+void GLSpringSystem::setParameters(const Parameters& parameters) { parameters_ = parameters; }
+
+size_t GLSpringSystem::getNumberOfNodes() const { return numNodes_; }
+
+size_t GLSpringSystem::getNumberOfSprings() const { return numSprings_; }
+
+void GLSpringSystem::setPosition(size_t i, const vec3& position) {
+    uploadElement(*positions_, i, vec4{position, 1.0f});
+}
+
+void GLSpringSystem::setLocked(size_t i, bool locked) {
+    uploadElement(*locked_, i, std::uint32_t{locked ? 1u : 0u});
+}
+
+std::shared_ptr<const Buffer<vec4>> GLSpringSystem::getPositionBuffer() const {
+    return positions_;
+}
+
+void GLSpringSystem::bindBuffers() {
+    // the GL representations are made the valid ones, the RAM representations are updated on
+    // the next download
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bufferId(*positions_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, bufferId(*velocities_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, bufferId(*forces_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, bufferId(*locked_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, bufferId(*springs_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, bufferId(*nodeSpringOffsets_));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, bufferId(*nodeSprings_));
+}
+
+void GLSpringSystem::integrate(size_t steps) {
+    if (numNodes_ == 0 || steps == 0) return;
+
+    bindBuffers();
+
+    const auto setUniforms = [&](Shader& shader) {
+        shader.setUniform("numNodes", static_cast<int>(numNodes_));
+        shader.setUniform("timeStep", parameters_.timeStep);
+        shader.setUniform("nodeMass", parameters_.nodeMass);
+    };
+    integrateShader_.activate();
+    setUniforms(integrateShader_);
+    forcesShader_.activate();
+    setUniforms(forcesShader_);
+    forcesShader_.setUniform("externalForce", parameters_.externalForce);
+    forcesShader_.setUniform("springConstant", parameters_.springConstant);
+    forcesShader_.setUniform("springLength", parameters_.springLength);
+    forcesShader_.setUniform("springDampning", parameters_.springDampning);
+
+    const auto numGroups = static_cast<GLuint>((numNodes_ + workGroupSize - 1) / workGroupSize);
+    for (size_t i = 0; i < steps; ++i) {
+        integrateShader_.activate();
+        glDispatchCompute(numGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        forcesShader_.activate();
+        glDispatchCompute(numGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+    forcesShader_.deactivate();
+
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    LGL_ERROR;
+}
+
+}  // namespace inviwo
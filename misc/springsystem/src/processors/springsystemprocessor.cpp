@@ -65,8 +65,14 @@ SpringSystemProcessor::SpringSystemProcessor()
     , springConst_("springConst", "Spring Elasticity k [N/m]", 20.0f, 0.1f, 100.0f)
     , springRestLength_("springRestLength", "Spring Length [m]", 0.1f, 0.0f, 10.0f)
     , deltaT_("deltaT", "Delta T [s]", 0.01f, 0.0001f, 1.0f)
-    , iterationsPerStep_("iterationsPerStep", "Iterations Per Step", 1, 1, 100, 1,
+    , iterationsPerStep_("iterationsPerStep", "Iterations Per Step", 1, 1, 1000, 1,
                          InvalidationLevel::Valid)
+    , integrator_("integrator", "Integrator",
+                  {{"verlet", "Verlet", SpringIntegrator::Verlet},
+                   {"projective", "Projective Dynamics", SpringIntegrator::Projective}},
+                  0)
+    , projectiveIterations_("projectiveIterations", "Projective Iterations", 10, 1, 100)
+    , gpuSolver_("gpuSolver", "GPU Solver", false)
     , externalForce_("externalForce", "Ext. Force F [N]", dvec2(0.0f, -9.81f), dvec2(-10.0f),
                      dvec2(10.0f))
     , scaleFactor_("scaleFactor", "Scale Factor for Mesh coloring", 1.0f, 0.01f, 1000.0f)
@@ -99,6 +105,9 @@ SpringSystemProcessor::SpringSystemProcessor()
     addProperty(springRestLength_);
     addProperty(deltaT_);
     addProperty(iterationsPerStep_);
+    addProperty(integrator_);
+    addProperty(projectiveIterations_);
+    addProperty(gpuSolver_);
     addProperty(externalForce_);
     addProperty(scaleFactor_);
 
@@ -111,7 +120,7 @@ SpringSystemProcessor::SpringSystemProcessor()
     addProperty(camera_);
 
     advanceButton_.onChange([&]() { advance_ = true; });
-    resetButton_.onChange([&]() { springSystem_ = getSystem(); });
+    resetButton_.onChange([&]() { updateSystemFromProperties(); });
     logStatusButton_.onChange([&]() { LogInfo(springSystem_); });
 
     startButton_.onChange([&]() { updateTimer_.start(); });
@@ -150,19 +159,33 @@ void SpringSystemProcessor::process() {
     using Sys = GravitySpringSystem<2, double>;
 
     if (springLayout_.isModified() || nodeCount_.isModified() || nodeSpacing_.isModified()) {
-        springSystem_ = getSystem();
+        updateSystemFromProperties();
         nodePicking_.resize(springSystem_.getNumberOfNodes());
     }
+    if (!gpuSolver_) {
+        glSpringSystem_.reset();
+    }
 
     syncer(springSystem_, std::make_pair(dampingCoeff_, &Sys::globalSpringDampning),
            std::make_pair(nodeMass_, &Sys::globalNodeMass),
            std::make_pair(springConst_, &Sys::globalSpringConstant),
            std::make_pair(springRestLength_, &Sys::globalSpringLength),
            std::make_pair(externalForce_, &Sys::globalExternalForce));
+    springSystem_.setIntegrator(integrator_.get());
+    springSystem_.setProjectiveIterations(projectiveIterations_.get());
 
     if (advance_) {
         advance_ = false;
-        springSystem_.integrate(iterationsPerStep_);
+        if (gpuSolver_) {
+            if (!glSpringSystem_) {
+                glSpringSystem_.emplace(springSystem_);
+            }
+            glSpringSystem_->setParameters(GLSpringSystem::parameters(springSystem_));
+            glSpringSystem_->integrate(iterationsPerStep_);
+            glSpringSystem_->download(springSystem_);
+        } else {
+            springSystem_.integrate(iterationsPerStep_);
+        }
         meshDirty_ = true;
     }
 
@@ -211,7 +234,10 @@ void SpringSystemProcessor::updateMesh() {
     springOutport_.setData(springMesh);
 }
 
-void SpringSystemProcessor::updateSystemFromProperties() { springSystem_ = getSystem(); }
+void SpringSystemProcessor::updateSystemFromProperties() {
+    springSystem_ = getSystem();
+    glSpringSystem_.reset();
+}
 
 GravitySpringSystem<2, double> SpringSystemProcessor::getSystem() {
     meshDirty_ = true;
@@ -262,6 +288,9 @@ void SpringSystemProcessor::handlePicking(PickingEvent* p) {
         const auto ind = p->getPickedId();
 
         springSystem_.position(ind) += dvec2{worldDelta};
+        if (glSpringSystem_) {
+            glSpringSystem_->setPosition(ind, vec3{springSystem_.position(ind), 0.0f});
+        }
         p->markAsUsed();
         meshDirty_ = true;
         invalidate(InvalidationLevel::InvalidOutput);
@@ -269,10 +298,12 @@ void SpringSystemProcessor::handlePicking(PickingEvent* p) {
     if (p->getPressState() == PickingPressState::Press &&
         p->getPressItem() == PickingPressItem::Primary) {
         springSystem_.lockedNodes[p->getPickedId()] = true;
+        if (glSpringSystem_) glSpringSystem_->setLocked(p->getPickedId(), true);
     }
     if (p->getPressState() == PickingPressState::Release &&
         p->getPressItem() == PickingPressItem::Primary) {
         springSystem_.lockedNodes[p->getPickedId()] = false;
+        if (glSpringSystem_) glSpringSystem_->setLocked(p->getPickedId(), false);
     }
 
     if (p->getHoverState() != PickingHoverState::Exit) {
@@ -30,11 +30,13 @@
 #include <inviwo/springsystem/springsystemmodule.h>
 #include <inviwo/springsystem/processors/springsystemprocessor.h>
 
+#include <modules/opengl/shader/shadermanager.h>
+
 namespace inviwo {
 
 SpringSystemModule::SpringSystemModule(InviwoApplication* app) : InviwoModule(app, "SpringSystem") {
     // Add a directory to the search path of the Shadermanager
-    // ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
+    ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
 
     // Register objects that can be shared with the rest of inviwo here:
 
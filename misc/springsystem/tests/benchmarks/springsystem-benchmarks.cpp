@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/springsystem/datastructures/gravityspringsystem.h>
+#include <inviwo/springsystem/datastructures/repulsivespringsystem.h>
+#include <inviwo/springsystem/utils/springsystemutils.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <warn/pop>
+
+/*
+ * Verlet integration of SpringSystem<3, float> with the packed and the padded node storage. The
+ * scene is the rectangular grid of the spingssystem regression workspace with the parameters
+ * given there, the argument is the number of nodes along each side of the grid, starting at the
+ * five nodes of the workspace. Each iteration performs ten integration steps.
+ *
+ * The repulsion benchmarks run the same grids as a RepulsiveSpringSystem, i.e. with all-pairs
+ * node repulsion through the Barnes-Hut tree. The second argument is the number of steps between
+ * full rebuilds of the tree.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+template <typename Storage>
+GravitySpringSystem<3, float, Storage> regressionScene(size_t nodeCount) {
+    const float spacing = 0.15f;
+    const float offset = (nodeCount - 1) * spacing * 0.5f;
+    auto grid = springmass::createRectangularGrid<3, float>(
+        size2_t(nodeCount), vec3{-offset, offset, 0.0f}, vec3{spacing});
+    return {0.001f,
+            std::move(grid.positions),
+            std::move(grid.springs),
+            std::move(grid.locked),
+            vec3{0.0f, -0.1f, 0.0f},
+            0.01f,
+            20.0f,
+            0.1f,
+            0.05f};
+}
+
+}  // namespace
+
+template <typename Storage>
+static void verletIntegration(benchmark::State& state) {
+    const auto nodeCount = static_cast<size_t>(state.range(0));
+    auto sys = regressionScene<Storage>(nodeCount);
+    sys.setParallel(state.range(1) != 0);
+    for (auto _ : state) {
+        sys.integrate(10);
+        benchmark::DoNotOptimize(sys.getPositions().data());
+    }
+    state.SetItemsProcessed(state.iterations() * 10 * sys.getNumberOfNodes());
+}
+BENCHMARK_TEMPLATE(verletIntegration, PackedStorage)
+    ->ArgsProduct({{5, 32, 128, 512}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(verletIntegration, PaddedStorage)
+    ->ArgsProduct({{5, 32, 128, 512}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void barnesHutRepulsion(benchmark::State& state) {
+    const auto nodeCount = static_cast<size_t>(state.range(0));
+    auto grid = regressionScene<PackedStorage>(nodeCount);
+    std::vector<vec3> positions(grid.getPositions().begin(), grid.getPositions().end());
+    RepulsiveSpringSystem<3, float> sys{0.001f,
+                                        std::move(positions),
+                                        grid.getSprings(),
+                                        grid.lockedNodes,
+                                        vec3{0.0f, -0.1f, 0.0f},
+                                        0.001f,
+                                        0.01f,
+                                        20.0f,
+                                        0.1f,
+                                        0.05f};
+    sys.rebuildInterval = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        sys.integrate(10);
+        benchmark::DoNotOptimize(sys.getPositions().data());
+    }
+    state.SetItemsProcessed(state.iterations() * 10 * sys.getNumberOfNodes());
+}
+BENCHMARK(barnesHutRepulsion)
+    ->ArgsProduct({{32, 128, 512}, {1, 10}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
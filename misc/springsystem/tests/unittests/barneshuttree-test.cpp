@@ -0,0 +1,137 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/springsystem/datastructures/barneshuttree.h>
+#include <inviwo/springsystem/datastructures/repulsivespringsystem.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<dvec2> randomPoints(size_t numPoints) {
+    std::mt19937 rand(1);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<dvec2> points(numPoints);
+    for (auto& p : points) p = dvec2{dist(rand), dist(rand)};
+    return points;
+}
+
+dvec2 bruteForceRepulsion(size_t i, const std::vector<dvec2>& points, double softening) {
+    dvec2 force{0.0};
+    for (size_t j = 0; j < points.size(); ++j) {
+        if (j == i) continue;
+        const auto d = points[i] - points[j];
+        force += d / (glm::dot(d, d) + softening * softening);
+    }
+    return force;
+}
+
+}  // namespace
+
+TEST(BarnesHutTree, zeroThetaGivesExactSum) {
+    const auto points = randomPoints(2000);
+    BarnesHutTree<2, double> tree;
+    tree.build(points);
+    ASSERT_EQ(tree.getNumberOfPoints(), points.size());
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto exact = bruteForceRepulsion(i, points, 0.001);
+        const auto approx = tree.repulsion(i, points, 0.0, 0.001);
+        EXPECT_LT(glm::distance(exact, approx), 1e-9 * glm::length(exact)) << "point " << i;
+    }
+}
+
+TEST(BarnesHutTree, approximationIsClose) {
+    const auto points = randomPoints(2000);
+    BarnesHutTree<2, double> tree;
+    tree.build(points);
+
+    // single forces can be off where the repulsion cancels out, compare the total error
+    double error = 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto exact = bruteForceRepulsion(i, points, 0.001);
+        error += glm::distance(exact, tree.repulsion(i, points, 0.5, 0.001));
+        total += glm::length(exact);
+    }
+    EXPECT_LT(error, 0.01 * total);
+}
+
+TEST(BarnesHutTree, refitFollowsMovedPoints) {
+    auto points = randomPoints(2000);
+    BarnesHutTree<2, double> tree;
+    tree.build(points);
+    const auto numCells = tree.getNumberOfCells();
+
+    std::mt19937 rand(2);
+    std::normal_distribution<double> dist(0.0, 0.05);
+    for (auto& p : points) p += dvec2{dist(rand), dist(rand)};
+    tree.refit(points);
+    EXPECT_EQ(tree.getNumberOfCells(), numCells);
+
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto exact = bruteForceRepulsion(i, points, 0.001);
+        const auto approx = tree.repulsion(i, points, 0.0, 0.001);
+        EXPECT_LT(glm::distance(exact, approx), 1e-9 * glm::length(exact)) << "point " << i;
+    }
+}
+
+TEST(RepulsiveSpringSystem, repulsionStretchesSpring) {
+    // one spring with a locked node, at rest the spring force balances the repulsion
+    const double stiffness = 10.0;
+    const double length = 0.1;
+    const double repulsion = 0.1;
+    RepulsiveSpringSystem<2, double> sys{0.001,
+                                         {dvec2{0.0}, dvec2{length, 0.0}},
+                                         {{0, 1}},
+                                         {true, false},
+                                         dvec2{0.0},
+                                         repulsion,
+                                         0.1,
+                                         stiffness,
+                                         length,
+                                         0.5};
+    sys.softening = 0.0;
+    sys.integrateUntilConverged(100000, 1e-9, 10);
+
+    // stiffness * (d - length) = repulsion / d
+    const double expected =
+        (length + std::sqrt(length * length + 4.0 * repulsion / stiffness)) / 2.0;
+    EXPECT_NEAR(sys.position(1).x, expected, 1e-4);
+    EXPECT_NEAR(sys.position(1).y, 0.0, 1e-6);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,267 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/springsystem/datastructures/gravityspringsystem.h>
+#include <inviwo/springsystem/datastructures/zerospringsystem.h>
+#include <inviwo/springsystem/utils/springsystemutils.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+
+GravitySpringSystem<2, double> createCloth(size2_t dims) {
+    auto grid = springmass::createRectangularGrid<2, double>(dims, dvec2{0.0}, dvec2{0.1});
+    return {0.001,
+            std::move(grid.positions),
+            std::move(grid.springs),
+            std::move(grid.locked),
+            dvec2{0.0, -9.81},
+            0.1,
+            100.0,
+            0.1,
+            0.05};
+}
+
+// horizontal chain with the first node locked, it comes to rest hanging straight down
+GravitySpringSystem<2, double> createChain(size_t numNodes, double stiffness) {
+    auto grid = springmass::createLineGrid<2, double>(numNodes, 0.1);
+    return {0.001,
+            std::move(grid.positions),
+            std::move(grid.springs),
+            std::move(grid.locked),
+            dvec2{0.0, -9.81},
+            0.1,
+            stiffness,
+            0.1,
+            0.05};
+}
+
+// each spring is stretched by the external force on all nodes below it
+void expectHangingChain(const GravitySpringSystem<2, double>& sys, double stiffness) {
+    const auto numNodes = sys.getNumberOfNodes();
+    double y = sys.position(0).y;
+    for (size_t i = 1; i < numNodes; ++i) {
+        y -= 0.1 + static_cast<double>(numNodes - i) * 9.81 / stiffness;
+        EXPECT_NEAR(sys.position(0).x, sys.position(i).x, 1e-6) << "node " << i;
+        EXPECT_NEAR(y, sys.position(i).y, 1e-6) << "node " << i;
+    }
+}
+
+}  // namespace
+
+TEST(SpringSystem, forcesAreEqualAndOpposite) {
+    ZeroSpringSystem<2, double> sys{
+        0.01, {dvec2{0.0, 0.0}, dvec2{2.0, 0.0}}, {{0, 1}}, {false, false}, 1.0, 1.0, 1.0, 0.0};
+
+    sys.integrate(1);
+
+    EXPECT_DOUBLE_EQ(1.0, sys.force(0).x);
+    EXPECT_DOUBLE_EQ(-1.0, sys.force(1).x);
+    EXPECT_DOUBLE_EQ(0.0, sys.force(0).y);
+    EXPECT_DOUBLE_EQ(0.0, sys.force(1).y);
+}
+
+TEST(SpringSystem, sharedNodesGatherAllSprings) {
+    // three springs pulling the center node in different directions
+    ZeroSpringSystem<2, double> sys{0.01,
+                                    {dvec2{0.0, 0.0}, dvec2{2.0, 0.0}, dvec2{0.0, 2.0},
+                                     dvec2{-2.0, 0.0}},
+                                    {{0, 1}, {2, 0}, {0, 3}},
+                                    {false, false, false, false},
+                                    1.0,
+                                    1.0,
+                                    1.0,
+                                    0.0};
+
+    sys.integrate(1);
+
+    EXPECT_DOUBLE_EQ(0.0, sys.force(0).x);
+    EXPECT_DOUBLE_EQ(1.0, sys.force(0).y);
+    EXPECT_DOUBLE_EQ(0.0, sys.force(2).x);
+    EXPECT_DOUBLE_EQ(-1.0, sys.force(2).y);
+}
+
+TEST(SpringSystem, integrationIsDeterministic) {
+    auto sys1 = createCloth(size2_t{64, 64});
+    auto sys2 = createCloth(size2_t{64, 64});
+
+    sys1.integrate(50);
+    sys2.integrate(50);
+
+    ASSERT_EQ(sys1.getNumberOfNodes(), sys2.getNumberOfNodes());
+    for (size_t i = 0; i < sys1.getNumberOfNodes(); ++i) {
+        EXPECT_EQ(sys1.position(i), sys2.position(i)) << "node " << i;
+        EXPECT_EQ(sys1.velocity(i), sys2.velocity(i)) << "node " << i;
+    }
+}
+
+TEST(SpringSystem, paddedStorageMatchesPackedStorage) {
+    static_assert(sizeof(PaddedStorage::Element<3, float>) == 4 * sizeof(float));
+
+    const auto create = [](auto storage) {
+        using Sys = GravitySpringSystem<3, float, decltype(storage)>;
+        auto grid = springmass::createRectangularGrid<3, float>(size2_t{32, 32}, vec3{0.0f},
+                                                                vec3{0.15f});
+        return Sys{0.001f,
+                   std::move(grid.positions),
+                   std::move(grid.springs),
+                   std::move(grid.locked),
+                   vec3{0.0f, -0.1f, 0.0f},
+                   0.01f,
+                   20.0f,
+                   0.1f,
+                   0.05f};
+    };
+    auto packed = create(PackedStorage{});
+    auto padded = create(PaddedStorage{});
+
+    packed.integrate(50);
+    padded.integrate(50);
+
+    ASSERT_EQ(packed.getNumberOfNodes(), padded.getNumberOfNodes());
+    for (size_t i = 0; i < packed.getNumberOfNodes(); ++i) {
+        EXPECT_LT(glm::distance(packed.position(i), padded.position(i)), 1e-5f) << "node " << i;
+        EXPECT_LT(glm::distance(packed.velocity(i), padded.velocity(i)), 1e-4f) << "node " << i;
+    }
+}
+
+TEST(SpringSystem, reorderedNodesMapToInput) {
+    auto reference = createCloth(size2_t{32, 32});
+    auto sys = createCloth(size2_t{32, 32});
+    sys.reorderNodes();
+
+    const auto& order = sys.getNodeOrder();
+    ASSERT_EQ(reference.getNumberOfNodes(), order.size());
+    auto sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<size_t> identity(order.size());
+    std::iota(identity.begin(), identity.end(), size_t{0});
+    EXPECT_EQ(identity, sorted);
+
+    for (size_t i = 0; i < reference.getNumberOfNodes(); ++i) {
+        EXPECT_EQ(i, order[sys.nodeIndex(i)]);
+        EXPECT_EQ(reference.isLocked(i), sys.isLocked(sys.nodeIndex(i)));
+    }
+
+    reference.integrate(50);
+    sys.integrate(50);
+    for (size_t i = 0; i < reference.getNumberOfNodes(); ++i) {
+        const auto& expected = reference.position(i);
+        const auto& actual = sys.position(sys.nodeIndex(i));
+        EXPECT_NEAR(expected.x, actual.x, 1e-9) << "node " << i;
+        EXPECT_NEAR(expected.y, actual.y, 1e-9) << "node " << i;
+    }
+}
+
+TEST(SpringSystem, batchedIntegrationMatchesSingleSystems) {
+    std::vector<GravitySpringSystem<2, double>> batch;
+    std::vector<GravitySpringSystem<2, double>> single;
+    for (size_t i = 0; i < 16; ++i) {
+        batch.push_back(createCloth(size2_t{4 + i, 5}));
+        single.push_back(createCloth(size2_t{4 + i, 5}));
+    }
+
+    springmass::integrate(batch, 100);
+    for (auto& sys : single) sys.integrate(100);
+
+    for (size_t s = 0; s < batch.size(); ++s) {
+        EXPECT_TRUE(batch[s].isParallel());
+        for (size_t i = 0; i < batch[s].getNumberOfNodes(); ++i) {
+            EXPECT_EQ(single[s].position(i), batch[s].position(i));
+        }
+    }
+}
+
+TEST(SpringSystem, integrationStopsWhenConverged) {
+    auto sys = createCloth(size2_t{8, 8});
+    const size_t maxSteps = 1000000;
+
+    const auto steps = sys.integrateUntilConverged(maxSteps, 1e-6, 10);
+
+    EXPECT_LT(steps, maxSteps);
+    EXPECT_EQ(0u, steps % 10);
+    EXPECT_LT(sys.maxDisplacement(), 1e-6);
+
+    auto limited = createCloth(size2_t{8, 8});
+    EXPECT_EQ(25u, limited.integrateUntilConverged(25, 0.0, 10));
+}
+
+TEST(SpringSystem, projectiveStepsAreStableForStiffSprings) {
+    // a time step about 8x larger than the stability limit 2 sqrt(m / k) of Verlet
+    const double stiffness = 1.0e4;
+    GravitySpringSystem<2, double> sys{0.05,
+                                       {dvec2{0.0, 0.0}, dvec2{0.0, -0.1}},
+                                       {{0, 1}},
+                                       {true, false},
+                                       dvec2{0.0, -9.81},
+                                       0.1,
+                                       stiffness,
+                                       0.1,
+                                       0.05};
+    sys.setIntegrator(SpringIntegrator::Projective);
+
+    const auto steps = sys.integrateUntilConverged(10000, 1e-9, 10);
+    EXPECT_LT(steps, 10000u);
+    EXPECT_DOUBLE_EQ(0.0, sys.position(0).y);
+    EXPECT_NEAR(0.0, sys.position(1).x, 1e-9);
+    EXPECT_NEAR(-0.1 - 9.81 / stiffness, sys.position(1).y, 1e-7);
+}
+
+TEST(SpringSystem, projectiveRestStateOfHangingChain) {
+    auto sys = createChain(5, 1000.0);
+    sys.setIntegrator(SpringIntegrator::Projective);
+    sys.setTimeStep(0.02);
+
+    const auto steps = sys.integrateUntilConverged(100000, 1e-9, 10);
+    EXPECT_LT(steps, 100000u);
+    expectHangingChain(sys, 1000.0);
+}
+
+TEST(SpringSystem, projectiveFactorizationFollowsParameters) {
+    auto sys = createChain(5, 1000.0);
+    sys.setIntegrator(SpringIntegrator::Projective);
+    sys.setTimeStep(0.02);
+    sys.integrate(20);
+
+    // the changed stiffness has to be picked up by the next step
+    sys.globalSpringConstant = 100.0;
+    sys.integrateUntilConverged(100000, 1e-9, 10);
+    expectHangingChain(sys, 100.0);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,4 @@
+# Inviwo module dependencies for current module
+# List modules on the format "Inviwo<ModuleName>Module"
+set(dependencies
+)
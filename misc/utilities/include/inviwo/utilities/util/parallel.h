@@ -0,0 +1,131 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/utilities/utilitiesmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace inviwo {
+namespace util {
+
+/**
+ * Calls callback(begin, end) for consecutive ranges of [0, size) with at most grainSize elements
+ * each, on the Inviwo thread pool. At most as many jobs as the pool has threads are dispatched,
+ * and the calling thread processes ranges as well, so concurrency stays bounded by the pool size
+ * regardless of how many callers run at once. A non-zero maxConcurrency limits the number of
+ * threads, including the calling one, further. Ranges are handed out one at a time; once stop
+ * returns true no further ranges are started. Runs on the calling thread if the pool is empty.
+ *
+ * The function returns as soon as all ranges are done and never waits for a job that has not
+ * started, so it may be called from pool jobs, also nested, without deadlocking the pool. Jobs
+ * starting after that find no ranges left and return without touching the callback.
+ *
+ * @return false if the loop was cancelled through stop, true otherwise
+ */
+template <typename C>
+bool forEachRangeParallel(size_t size, size_t grainSize, C callback,
+                          const std::function<bool()>& stop = nullptr, size_t maxConcurrency = 0) {
+    if (size == 0) return true;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    const auto numRanges = (size + grainSize - 1) / grainSize;
+
+    // Shared with the jobs, which may outlive this call
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t finished = 0;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    // Only ranges claimed before all ranges are finished are run, and the caller waits for those,
+    // so the callback and stop are never accessed after this function returns
+    const auto worker = [state, numRanges, size, grainSize, &callback, &stop]() {
+        for (auto range = state->next++; range < numRanges; range = state->next++) {
+            std::exception_ptr error;
+            if (!state->cancelled.load(std::memory_order_relaxed)) {
+                try {
+                    if (stop && stop()) {
+                        state->cancelled.store(true, std::memory_order_relaxed);
+                    } else {
+                        callback(range * grainSize, std::min(size, (range + 1) * grainSize));
+                    }
+                } catch (...) {
+                    state->cancelled.store(true, std::memory_order_relaxed);
+                    error = std::current_exception();
+                }
+            }
+            std::scoped_lock lock{state->mutex};
+            if (error && !state->error) state->error = error;
+            if (++state->finished == numRanges) state->done.notify_all();
+        }
+    };
+
+    const auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
+    const auto poolSize = static_cast<size_t>(std::max(0, settings->poolSize_.get()));
+    auto jobs = std::min(poolSize, numRanges - 1);
+    if (maxConcurrency > 0) jobs = std::min(jobs, maxConcurrency - 1);
+    for (size_t job = 0; job < jobs; ++job) {
+        dispatchPool(worker);
+    }
+    worker();
+
+    std::unique_lock lock{state->mutex};
+    state->done.wait(lock, [&]() { return state->finished == numRanges; });
+    if (state->error) std::rethrow_exception(state->error);
+
+    return !state->cancelled.load();
+}
+
+/**
+ * Grain size splitting size elements into roughly four ranges per pool thread, but no ranges
+ * smaller than minGrainSize.
+ */
+inline size_t defaultGrainSize(size_t size, size_t minGrainSize = 1024) {
+    const auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
+    const auto ranges = 4 * static_cast<size_t>(std::max(1, settings->poolSize_.get()));
+    return std::max(minGrainSize, (size + ranges - 1) / ranges);
+}
+
+}  // namespace util
+}  // namespace inviwo
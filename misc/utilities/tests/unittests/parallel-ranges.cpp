@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/utilities/util/parallel.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace inviwo {
+TEST(ParallelRangesTests, coversAllElementsOnce) {
+    std::vector<std::atomic<int>> visits(10007);
+
+    const auto completed =
+        util::forEachRangeParallel(visits.size(), 100, [&](size_t begin, size_t end) {
+            EXPECT_LE(end - begin, size_t{100});
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+
+    EXPECT_TRUE(completed);
+    for (const auto& v : visits) {
+        EXPECT_EQ(1, v.load());
+    }
+}
+
+TEST(ParallelRangesTests, stopsStartingRangesWhenCancelled) {
+    std::atomic<size_t> ranges{0};
+
+    const auto completed = util::forEachRangeParallel(
+        1000, 1, [&](size_t, size_t) { ++ranges; }, [&]() { return ranges.load() >= 10; });
+
+    EXPECT_FALSE(completed);
+    EXPECT_LT(ranges.load(), size_t{1000});
+}
+
+TEST(ParallelRangesTests, emptyRangeCompletes) {
+    bool called = false;
+    EXPECT_TRUE(util::forEachRangeParallel(0, 16, [&](size_t, size_t) { called = true; }));
+    EXPECT_FALSE(called);
+}
+
+TEST(ParallelRangesTests, nestedCallsFromPoolJobsComplete) {
+    auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
+    const auto poolSize = settings->poolSize_.get();
+
+    // A single pool thread used to deadlock waiting for jobs that could never start
+    for (const int size : {1, 2}) {
+        settings->poolSize_.set(size);
+        std::atomic<size_t> visits{0};
+        dispatchPool([&]() {
+            util::forEachRangeParallel(8, 1, [&](size_t, size_t) {
+                util::forEachRangeParallel(16, 1, [&](size_t, size_t) { ++visits; });
+            });
+        }).get();
+        EXPECT_EQ(size_t{8 * 16}, visits.load());
+    }
+
+    settings->poolSize_.set(poolSize);
+}
+
+TEST(ParallelRangesTests, rethrowsExceptionsAfterAllRanges) {
+    std::atomic<size_t> running{0};
+    EXPECT_THROW(util::forEachRangeParallel(64, 1,
+                                            [&](size_t begin, size_t) {
+                                                ++running;
+                                                if (begin == 3) throw Exception("range");
+                                                --running;
+                                            }),
+                 Exception);
+    EXPECT_EQ(size_t{1}, running.load());
+}
+
+TEST(ParallelRangesTests, limitsConcurrency) {
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> maxRunning{0};
+
+    util::forEachRangeParallel(
+        256, 1,
+        [&](size_t, size_t) {
+            const auto current = ++running;
+            for (auto prev = maxRunning.load(); prev < current;) {
+                if (maxRunning.compare_exchange_weak(prev, current)) break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            --running;
+        },
+        nullptr, 2);
+    EXPECT_LE(maxRunning.load(), size_t{2});
+    EXPECT_EQ(size_t{0}, running.load());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,5 @@
+# Inviwo module dependencies for current module
+# List modules on the format "Inviwo<ModuleName>Module"
+set(dependencies
+    InviwoOpenGLModule
+)
@@ -0,0 +1,67 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/utilitiesgl/utilitiesglmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/opengl/inviwoopengl.h>
+
+#include <functional>
+#include <string_view>
+
+namespace inviwo {
+
+class Shader;
+
+namespace utilgl {
+
+/**
+ * Dispatches \p numGroups work groups along x with the active \p shader. Each dispatch is limited
+ * to 65535 work groups, the minimum GL_MAX_COMPUTE_WORK_GROUP_COUNT guaranteed by OpenGL, so
+ * larger counts are split into several dispatches. Before each of them the uint uniform
+ * \p offsetUniform is set to the index of its first invocation, i.e. its first work group times
+ * \p groupSize, which the shader adds to gl_GlobalInvocationID.x. \p progress is called after each
+ * dispatch with the number of work groups dispatched so far.
+ *
+ * \code{.cpp}
+ * uniform uint offset = 0u;
+ * void main() {
+ *     uint i = offset + gl_GlobalInvocationID.x;
+ *     ...
+ * \endcode
+ *
+ * @throw Exception if the invocation indices exceed the range of uint
+ */
+IVW_MODULE_UTILITIESGL_API void dispatchChunked(
+    Shader& shader, size_t numGroups, std::string_view offsetUniform, size_t groupSize = 1,
+    const std::function<void(size_t)>& progress = {});
+
+}  // namespace utilgl
+
+}  // namespace inviwo
@@ -0,0 +1,66 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/utilitiesgl/util/dispatch.h>
+
+#include <inviwo/core/util/exception.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace utilgl {
+
+namespace {
+constexpr size_t maxWorkGroupsPerDispatch = 65535;
+}  // namespace
+
+void dispatchChunked(Shader& shader, size_t numGroups, std::string_view offsetUniform,
+                     size_t groupSize, const std::function<void(size_t)>& progress) {
+    if (numGroups > 0 && (numGroups * groupSize - 1) > std::numeric_limits<GLuint>::max()) {
+        throw Exception(fmt::format("{} invocations exceed the range of the '{}' uniform",
+                                    numGroups * groupSize, offsetUniform),
+                        IVW_CONTEXT_CUSTOM("dispatchChunked"));
+    }
+
+    for (size_t first = 0; first < numGroups; first += maxWorkGroupsPerDispatch) {
+        const auto count = std::min(maxWorkGroupsPerDispatch, numGroups - first);
+        shader.setUniform(offsetUniform, static_cast<GLuint>(first * groupSize));
+        glDispatchCompute(static_cast<GLuint>(count), 1, 1);
+        if (progress) progress(first + count);
+    }
+}
+
+}  // namespace utilgl
+
+}  // namespace inviwo
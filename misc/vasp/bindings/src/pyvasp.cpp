@@ -0,0 +1,181 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <ivwvasp/pyvasp.h>
+
+#include <warn/push>
+#include <warn/ignore/shadow>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/vasp/algorithm/periodicimages.h>
+#include <inviwo/vasp/io/vaspparsing.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace py = pybind11;
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+using CArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+std::string_view toStringView(const py::bytes& data) {
+    char* buffer = nullptr;
+    Py_ssize_t length = 0;
+    if (PyBytes_AsStringAndSize(data.ptr(), &buffer, &length) != 0) {
+        throw py::error_already_set();
+    }
+    return {buffer, static_cast<size_t>(length)};
+}
+
+py::array_t<float> toArray(const std::vector<vec3>& positions) {
+    py::array_t<float> array({positions.size(), size_t{3}});
+    std::copy_n(reinterpret_cast<const float*>(positions.data()), positions.size() * 3,
+                array.mutable_data());
+    return array;
+}
+
+std::vector<vec3> toPositions(const CArray<float>& array) {
+    if (array.ndim() != 2 || array.shape(1) != 3) {
+        throw py::value_error("expected an array of positions with shape (N, 3)");
+    }
+    std::vector<vec3> positions(static_cast<size_t>(array.shape(0)));
+    std::copy_n(array.data(), positions.size() * 3, reinterpret_cast<float*>(positions.data()));
+    return positions;
+}
+
+py::tuple toTuple(vasp::ChgcarData data) {
+    auto positions = toArray(data.positions);
+    return py::make_tuple(std::move(data.volume), std::move(positions), std::move(data.elements),
+                          std::move(data.counts), std::move(data.elementTypes));
+}
+
+py::tuple toTuple(vasp::CubeData data) {
+    auto positions = toArray(data.positions);
+    return py::make_tuple(std::move(data.volume), std::move(positions),
+                          std::move(data.atomicNumbers));
+}
+
+}  // namespace
+
+void exposeVASP(pybind11::module& m) {
+    // The GIL is released while parsing, the contents of a bytes object are immutable.
+    m.def(
+        "parseChgcar",
+        [](const py::bytes& data) {
+            auto contents = toStringView(data);
+            auto res = [&]() {
+                py::gil_scoped_release release;
+                return vasp::parseChgcar(contents);
+            }();
+            return toTuple(std::move(res));
+        },
+        py::arg("data"),
+        R"doc(Parse the contents of a CHGCAR file.
+
+Returns a tuple of (volume, positions, elements, counts, elementTypes) where positions are the
+atom positions in direct coordinates as a (N, 3) float32 array.)doc");
+
+    m.def(
+        "readChgcar",
+        [](const std::string& filename) {
+            auto res = [&]() {
+                py::gil_scoped_release release;
+                return vasp::readChgcar(filename);
+            }();
+            return toTuple(std::move(res));
+        },
+        py::arg("filename"), "Read an uncompressed CHGCAR file, see parseChgcar");
+
+    m.def(
+        "parseCube",
+        [](const py::bytes& data) {
+            auto contents = toStringView(data);
+            auto res = [&]() {
+                py::gil_scoped_release release;
+                return vasp::parseCube(contents);
+            }();
+            return toTuple(std::move(res));
+        },
+        py::arg("data"),
+        R"doc(Parse the contents of a Gaussian CUBE file.
+
+Returns a tuple of (volume, positions, atomicNumbers) where positions are the atom positions
+in Angstrom relative to the origin of the grid as a (N, 3) float32 array.)doc");
+
+    m.def(
+        "readCube",
+        [](const std::string& filename) {
+            auto res = [&]() {
+                py::gil_scoped_release release;
+                return vasp::readCube(filename);
+            }();
+            return toTuple(std::move(res));
+        },
+        py::arg("filename"), "Read an uncompressed CUBE file, see parseCube");
+
+    m.def(
+        "periodicImages",
+        [](const CArray<float>& positions, float margin) {
+            auto images = [&, pos = toPositions(positions)]() {
+                py::gil_scoped_release release;
+                return vasp::periodicImages(pos, margin);
+            }();
+            py::array_t<std::uint32_t> indices(images.indices.size());
+            std::copy(images.indices.begin(), images.indices.end(), indices.mutable_data());
+            return py::make_tuple(toArray(images.positions), std::move(indices));
+        },
+        py::arg("positions"), py::arg("margin"),
+        R"doc(Replicate atoms given in direct coordinates into the neighboring cells.
+
+Images are kept if all coordinates are within (-margin, 1 + margin). Returns a tuple of
+(positions, indices) where indices refer to the original atom of each image.)doc");
+
+    m.def(
+        "createMolecularStructure",
+        [](const CArray<float>& positions, const std::vector<std::string>& elementTypes,
+           const mat3& basis, const vec3& offset, float margin) {
+            auto pos = toPositions(positions);
+            py::gil_scoped_release release;
+            return vasp::createMolecularStructure(pos, elementTypes, basis, offset, margin);
+        },
+        py::arg("positions"), py::arg("elementTypes"), py::arg("basis"), py::arg("offset"),
+        py::arg("margin"),
+        R"doc(Create a MolecularStructure of the atoms given in direct coordinates and their
+periodic images. Covalent bonds are determined across cell boundaries.)doc");
+}
+
+}  // namespace inviwo
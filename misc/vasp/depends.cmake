@@ -3,6 +3,8 @@
 set(dependencies
     InviwoPython3Module
     InviwoDataFramePythonModule
+    InviwoMolVisBaseModule
+    InviwoMolVisPythonModule
 )
 
 # Add an alias for this module. Several modules can share an alias. 
@@ -0,0 +1,88 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/vasp/vaspmoduledefine.h>
+#include <inviwo/core/util/glm.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+class MolecularStructure;
+}
+
+namespace vasp {
+
+/**
+ * Atoms of a unit cell replicated into the neighboring cells
+ */
+struct IVW_MODULE_VASP_API PeriodicImages {
+    /// positions of the images in direct (fractional) coordinates
+    std::vector<vec3> positions;
+    /// index of the original atom of each image
+    std::vector<std::uint32_t> indices;
+};
+
+/**
+ * Replicate the atoms at the direct coordinates \p positions into the 26 neighboring cells. An
+ * image is kept if all of its coordinates lie within (-margin, 1 + margin), this includes the
+ * original atom. Images are ordered by atom and then by shift, the shift along x changing
+ * slowest. If \p margin is zero, only the original positions are returned.
+ *
+ * Atoms are processed in parallel.
+ */
+IVW_MODULE_VASP_API PeriodicImages periodicImages(const std::vector<vec3>& positions,
+                                                  float margin);
+
+/**
+ * Create a molecular structure from the periodic images of the atoms at the direct coordinates
+ * \p positions, see periodicImages(). Positions are transformed to world space with \p basis and
+ * \p offset. Covalent bonds are determined using the atom grid of the structure, which includes
+ * bonds across cell boundaries as long as both atoms are within \p margin.
+ *
+ * @param positions     atom positions in direct coordinates
+ * @param elementTypes  element symbol of each atom
+ * @param basis         lattice vectors
+ * @param offset        world space position of the cell origin
+ * @param margin        margin in direct coordinates for periodic images
+ * @throw Exception if the sizes of \p positions and \p elementTypes do not match
+ */
+IVW_MODULE_VASP_API std::shared_ptr<molvis::MolecularStructure> createMolecularStructure(
+    const std::vector<vec3>& positions, const std::vector<std::string>& elementTypes,
+    const mat3& basis, const vec3& offset, float margin);
+
+}  // namespace vasp
+
+}  // namespace inviwo
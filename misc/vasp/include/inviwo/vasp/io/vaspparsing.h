@@ -0,0 +1,121 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/vasp/vaspmoduledefine.h>
+#include <inviwo/core/util/glm.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inviwo {
+
+class Volume;
+
+namespace vasp {
+
+/**
+ * Contents of a VASP CHGCAR file
+ */
+struct IVW_MODULE_VASP_API ChgcarData {
+    /// charge density, its basis is spanned by the lattice vectors and centered around the origin
+    std::shared_ptr<Volume> volume;
+    /// atom positions in direct (fractional) coordinates of the lattice
+    std::vector<vec3> positions;
+    /// element name of each element group
+    std::vector<std::string> elements;
+    /// number of atoms in each element group
+    std::vector<int> counts;
+    /// element name of each atom
+    std::vector<std::string> elementTypes;
+};
+
+/**
+ * Contents of a Gaussian CUBE file
+ */
+struct IVW_MODULE_VASP_API CubeData {
+    /// first volumetric value, its basis is centered around the origin and given in Angstrom
+    std::shared_ptr<Volume> volume;
+    /// atom positions in Angstrom, relative to the origin of the grid
+    std::vector<vec3> positions;
+    /// atomic number of each atom
+    std::vector<int> atomicNumbers;
+};
+
+/**
+ * Parse the VASP CHGCAR file given in \p contents. Only the first data set, i.e. the total
+ * charge density, is read. Numbers are parsed with std::from_chars, if available, and the
+ * grid data is split into blocks which are parsed in parallel.
+ *
+ * @throw DataReaderException if \p contents is not a valid CHGCAR file
+ */
+IVW_MODULE_VASP_API ChgcarData parseChgcar(std::string_view contents);
+
+/**
+ * Parse the Gaussian CUBE file given in \p contents. Only the first value of each voxel is read
+ * if the file holds multiple values, e.g. several molecular orbitals. The grid data is parsed
+ * in parallel, see parseChgcar.
+ *
+ * @throw DataReaderException if \p contents is not a valid CUBE file
+ */
+IVW_MODULE_VASP_API CubeData parseCube(std::string_view contents);
+
+/**
+ * Read and parse the uncompressed CHGCAR file \p filename.
+ * @see parseChgcar
+ * @throw FileException if the file could not be read
+ */
+IVW_MODULE_VASP_API ChgcarData readChgcar(const std::string& filename);
+
+/**
+ * Read and parse the uncompressed CUBE file \p filename.
+ * @see parseCube
+ * @throw FileException if the file could not be read
+ */
+IVW_MODULE_VASP_API CubeData readCube(const std::string& filename);
+
+namespace detail {
+
+/**
+ * Parse all whitespace separated floating point numbers in \p text. The text is split into
+ * blocks at whitespace, which are first counted and then parsed in parallel directly into the
+ * result.
+ *
+ * @throw DataReaderException if a token is not a valid number
+ */
+IVW_MODULE_VASP_API std::vector<float> parseFloats(std::string_view text);
+
+}  // namespace detail
+
+}  // namespace vasp
+
+}  // namespace inviwo
@@ -2,6 +2,7 @@
 
 import inviwopy as ivw
 import ivwdataframe as df
+import ivwmolvis
 import atomdata
 import vasputil
 
@@ -24,6 +25,9 @@ class ChgcarSource(ivw.Processor):
         self.dataframeOutport = df.DataFrameOutport("atomInformation")
         self.addOutport(self.dataframeOutport)
 
+        self.structureOutport = ivwmolvis.MolecularStructureOutport("structure")
+        self.addOutport(self.structureOutport)
+
         self.chgcar = ivw.properties.FileProperty("chgcar", "CHGCAR")
         self.addProperty(self.chgcar)
 
@@ -83,12 +87,16 @@ class ChgcarSource(ivw.Processor):
         self.dataframe = vasputil.createDataFrame(self.atomPos, self.elemtype,
                                                   self.volume.modelMatrix)
 
+        self.structure = vasputil.createMolecularStructure(
+            self.atomPos, self.elemtype, self.volume.basis, self.volume.offset, self.margin.value)
+
         print("Loaded CHGCAR: {}\nDims:  {}\nElem:  {}\nNElem  {}\nRange: {}".format(
             self.chgcar.value, self.volume.dimensions, self.elem, self.nelem, self.volume.dataMap.dataRange))
 
         self.volumeOutport.setData(self.volume)
         self.meshOutport.setData(self.mesh)
         self.dataframeOutport.setData(self.dataframe)
+        self.structureOutport.setData(self.structure)
 
     def callback(self, pickevent):
         if (pickevent.state == inviwopy.PickingState.Updated):
@@ -0,0 +1,143 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vasp/algorithm/periodicimages.h>
+
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/molvisbase/util/atomicelement.h>
+#include <inviwo/molvisbase/util/molvisutils.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace inviwo {
+
+namespace vasp {
+
+namespace {
+
+/**
+ * Call \p callback(shift) for all shifts in {-1, 0, 1}^3 which move \p pos into the cell extended
+ * by \p margin, x changing slowest.
+ */
+template <typename Callback>
+void forEachShift(const vec3& pos, float margin, Callback callback) {
+    // valid shifts per axis, at most three each
+    std::array<std::array<float, 3>, 3> shifts;
+    std::array<size_t, 3> counts{0, 0, 0};
+    for (int axis = 0; axis < 3; ++axis) {
+        for (float s : {-1.0f, 0.0f, 1.0f}) {
+            const float x = pos[axis] + s;
+            if (x > -margin && x < 1.0f + margin) shifts[axis][counts[axis]++] = s;
+        }
+    }
+    for (size_t i = 0; i < counts[0]; ++i) {
+        for (size_t j = 0; j < counts[1]; ++j) {
+            for (size_t k = 0; k < counts[2]; ++k) {
+                callback(vec3{shifts[0][i], shifts[1][j], shifts[2][k]});
+            }
+        }
+    }
+}
+
+}  // namespace
+
+PeriodicImages periodicImages(const std::vector<vec3>& positions, float margin) {
+    PeriodicImages images;
+    if (margin <= 0.0f) {
+        images.positions = positions;
+        images.indices.resize(positions.size());
+        std::iota(images.indices.begin(), images.indices.end(), std::uint32_t{0});
+        return images;
+    }
+
+    std::vector<size_t> offsets(positions.size() + 1, 0);
+    util::forEachParallel(positions, [&](const vec3& pos, size_t i) {
+        size_t count = 0;
+        forEachShift(pos, margin, [&](const vec3&) { ++count; });
+        offsets[i + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    images.positions.resize(offsets.back());
+    images.indices.resize(offsets.back());
+    util::forEachParallel(positions, [&](const vec3& pos, size_t i) {
+        auto dest = offsets[i];
+        forEachShift(pos, margin, [&](const vec3& shift) {
+            images.positions[dest] = pos + shift;
+            images.indices[dest] = static_cast<std::uint32_t>(i);
+            ++dest;
+        });
+    });
+    return images;
+}
+
+std::shared_ptr<molvis::MolecularStructure> createMolecularStructure(
+    const std::vector<vec3>& positions, const std::vector<std::string>& elementTypes,
+    const mat3& basis, const vec3& offset, float margin) {
+    if (positions.size() != elementTypes.size()) {
+        throw Exception(fmt::format("Number of positions ({}) and element types ({}) differ",
+                                    positions.size(), elementTypes.size()),
+                        IVW_CONTEXT_CUSTOM("vasp::createMolecularStructure"));
+    }
+
+    std::vector<molvis::Element> elements(elementTypes.size());
+    std::transform(elementTypes.begin(), elementTypes.end(), elements.begin(),
+                   [](const std::string& symbol) { return molvis::element::fromAbbr(symbol); });
+
+    const auto images = periodicImages(positions, margin);
+
+    molvis::MolecularData data;
+    auto& atoms = data.atoms;
+    atoms.positions.resize(images.positions.size());
+    atoms.atomicNumbers.resize(images.positions.size());
+    atoms.fullNames.resize(images.positions.size());
+    const dmat3 dbasis{basis};
+    const dvec3 doffset{offset};
+    util::forEachParallel(images.positions, [&](const vec3& pos, size_t i) {
+        atoms.positions[i] = dbasis * dvec3{pos} + doffset;
+        atoms.atomicNumbers[i] = elements[images.indices[i]];
+        atoms.fullNames[i] = elementTypes[images.indices[i]];
+    });
+
+    auto grid = std::make_shared<molvis::AtomGrid>(atoms.positions, molvis::maxCovalentBondLength);
+    data.bonds = molvis::computeCovalentBonds(atoms, *grid);
+
+    return std::make_shared<molvis::MolecularStructure>(std::move(data), std::move(grid));
+}
+
+}  // namespace vasp
+
+}  // namespace inviwo
@@ -0,0 +1,389 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vasp/io/vaspparsing.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+namespace inviwo {
+
+namespace vasp {
+
+namespace {
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+constexpr bool charconvFloat = true;
+#else
+constexpr bool charconvFloat = false;
+#endif
+
+constexpr double bohrToAngstrom = 0.529177249;
+
+constexpr bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+template <typename Callback>
+void forEachToken(std::string_view text, Callback callback) {
+    size_t pos = 0;
+    while (true) {
+        while (pos < text.size() && isSpace(text[pos])) ++pos;
+        if (pos == text.size()) return;
+        size_t end = pos;
+        while (end < text.size() && !isSpace(text[end])) ++end;
+        callback(text.substr(pos, end - pos));
+        pos = end;
+    }
+}
+
+std::vector<std::string_view> tokenize(std::string_view line) {
+    std::vector<std::string_view> tokens;
+    forEachToken(line, [&](std::string_view token) { tokens.push_back(token); });
+    return tokens;
+}
+
+template <typename T>
+bool fromStr(std::string_view str, T& dest) {
+    if (!str.empty() && str.front() == '+') str.remove_prefix(1);
+    const auto end = str.data() + str.size();
+    if constexpr (std::is_integral_v<T> || charconvFloat) {
+        auto [p, ec] = std::from_chars(str.data(), end, dest);
+        return ec == std::errc() && p == end;
+    } else {
+        std::istringstream stream{std::string{str}};
+        stream >> dest;
+        return !stream.fail() && stream.eof();
+    }
+}
+
+/**
+ * Sequential access to the lines of a file, keeping track of the line number for error messages
+ */
+class LineReader {
+public:
+    LineReader(std::string_view contents, std::string_view format)
+        : contents_{contents}, format_{format} {}
+
+    std::string_view next() {
+        if (pos_ >= contents_.size()) {
+            error("unexpected end of file");
+        }
+        const auto end = std::min(contents_.find('\n', pos_), contents_.size());
+        auto line = contents_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+        ++lineNumber_;
+        return line;
+    }
+
+    std::string_view nextNonEmpty() {
+        auto line = next();
+        while (util::trim(line).empty()) line = next();
+        return line;
+    }
+
+    std::vector<std::string_view> tokens(size_t minCount) {
+        auto tokens = tokenize(next());
+        if (tokens.size() < minCount) {
+            error(fmt::format("expected at least {} values, found {}", minCount, tokens.size()));
+        }
+        return tokens;
+    }
+
+    /**
+     * Consume the next \p count lines and return them as one block of text
+     */
+    std::string_view take(size_t count) {
+        const auto begin = std::min(pos_, contents_.size());
+        for (size_t i = 0; i < count && pos_ < contents_.size(); ++i) {
+            pos_ = std::min(contents_.find('\n', pos_), contents_.size()) + 1;
+            ++lineNumber_;
+        }
+        return contents_.substr(begin, std::min(pos_, contents_.size()) - begin);
+    }
+
+    std::string_view remaining() const {
+        return contents_.substr(std::min(pos_, contents_.size()));
+    }
+
+    template <typename T>
+    T number(std::string_view token) {
+        T value{};
+        if (!fromStr(token, value)) {
+            error(fmt::format("invalid number '{}'", token));
+        }
+        return value;
+    }
+
+    template <typename T>
+    glm::tvec3<T> vec(const std::vector<std::string_view>& tokens, size_t first) {
+        return {number<T>(tokens[first]), number<T>(tokens[first + 1]),
+                number<T>(tokens[first + 2])};
+    }
+
+    [[noreturn]] void error(std::string_view message) const {
+        throw DataReaderException(fmt::format("{}: {} (line {})", format_, message, lineNumber_),
+                                  IVW_CONTEXT_CUSTOM("vasp::LineReader"));
+    }
+
+private:
+    std::string_view contents_;
+    std::string_view format_;
+    size_t pos_ = 0;
+    size_t lineNumber_ = 0;
+};
+
+/**
+ * Create a volume centered around the origin with the given \p basis. The data range is set to
+ * the range of the data.
+ */
+std::shared_ptr<Volume> createVolume(std::shared_ptr<VolumeRAMPrecision<float>> ram,
+                                     const dmat3& basis) {
+    const auto data = ram->getDataTyped();
+    const auto size = glm::compMul(ram->getDimensions());
+    const auto [min, max] = std::minmax_element(data, data + size);
+
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(mat3(basis));
+    volume->setOffset(vec3(-0.5 * (basis[0] + basis[1] + basis[2])));
+    if (size > 0) {
+        volume->dataMap_.dataRange = dvec2(*min, *max);
+        volume->dataMap_.valueRange = volume->dataMap_.dataRange;
+    }
+    return volume;
+}
+
+std::string readFile(const std::string& filename, std::string_view format) {
+    auto file = filesystem::ifstream(filename, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileException(fmt::format("{}: Could not open file '{}'", format, filename),
+                            IVW_CONTEXT_CUSTOM("vasp::readFile"));
+    }
+    std::string contents;
+    file.seekg(0, std::ios::end);
+    contents.reserve(file.tellg());
+    file.seekg(0, std::ios::beg);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return contents;
+}
+
+}  // namespace
+
+std::vector<float> detail::parseFloats(std::string_view text) {
+    // Split the text into blocks at whitespace, so that no number straddles two blocks
+    constexpr size_t blockSize = 1 << 18;
+    std::vector<std::string_view> blocks;
+    for (size_t begin = 0; begin < text.size();) {
+        auto end = std::min(text.size(), begin + blockSize);
+        while (end < text.size() && !isSpace(text[end])) ++end;
+        blocks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<size_t> offsets(blocks.size() + 1, 0);
+    util::forEachParallel(blocks, [&](std::string_view block, size_t i) {
+        size_t count = 0;
+        forEachToken(block, [&](std::string_view) { ++count; });
+        offsets[i + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<float> values(offsets.back());
+    std::vector<std::string_view> invalid(blocks.size());
+    util::forEachParallel(blocks, [&](std::string_view block, size_t i) {
+        auto dest = values.data() + offsets[i];
+        forEachToken(block, [&](std::string_view token) {
+            if (!fromStr(token, *dest) && invalid[i].empty()) {
+                invalid[i] = token;
+            }
+            ++dest;
+        });
+    });
+
+    for (auto token : invalid) {
+        if (!token.empty()) {
+            throw DataReaderException(fmt::format("Invalid number '{}' in grid data", token),
+                                      IVW_CONTEXT_CUSTOM("vasp::parseFloats"));
+        }
+    }
+    return values;
+}
+
+ChgcarData parseChgcar(std::string_view contents) {
+    LineReader lines{contents, "CHGCAR"};
+    lines.next();  // comment
+
+    const auto scale = lines.number<double>(util::trim(lines.next()));
+    const auto a1 = lines.vec<double>(lines.tokens(3), 0);
+    const auto a2 = lines.vec<double>(lines.tokens(3), 0);
+    const auto a3 = lines.vec<double>(lines.tokens(3), 0);
+
+    ChgcarData res;
+    for (auto name : tokenize(lines.next())) {
+        res.elements.emplace_back(name);
+    }
+    for (auto count : tokenize(lines.next())) {
+        res.counts.push_back(lines.number<int>(count));
+        if (res.counts.back() < 0) lines.error("negative element count");
+    }
+    if (res.elements.size() != res.counts.size()) {
+        lines.error("the number of element names and element counts do not match");
+    }
+    for (size_t i = 0; i < res.elements.size(); ++i) {
+        res.elementTypes.insert(res.elementTypes.end(), static_cast<size_t>(res.counts[i]),
+                                 res.elements[i]);
+    }
+
+    const auto mode = util::trim(lines.next());
+    const bool direct = mode.empty() || std::string_view{"KkCc"}.find(mode[0]) == std::string::npos;
+
+    // A negative scale denotes the volume of the cell
+    const auto factor =
+        scale >= 0.0 ? scale : std::cbrt(-scale / std::abs(glm::dot(a1, glm::cross(a2, a3))));
+    const dmat3 basis = dmat3(a1, a2, a3) * factor;
+    const dmat3 toDirect = glm::inverse(basis) * factor;
+
+    res.positions.reserve(res.elementTypes.size());
+    for (size_t i = 0; i < res.elementTypes.size(); ++i) {
+        const auto pos = lines.vec<double>(lines.tokens(3), 0);
+        res.positions.emplace_back(direct ? pos : toDirect * pos);
+    }
+
+    const auto dimTokens = tokenize(lines.nextNonEmpty());
+    if (dimTokens.size() < 3) lines.error("expected grid dimensions");
+    const auto dims = lines.vec<int>(dimTokens, 0);
+    if (glm::any(glm::lessThanEqual(dims, ivec3{0}))) {
+        lines.error(fmt::format("invalid grid dimensions {} {} {}", dims.x, dims.y, dims.z));
+    }
+    const auto voxels = glm::compMul(size3_t{dims});
+
+    // Only read the rows of the first data set, a second one with the magnetization density
+    // might follow the augmentation occupancies.
+    const auto perRow = tokenize(LineReader{lines.remaining(), "CHGCAR"}.next()).size();
+    if (perRow == 0) lines.error("expected grid data");
+    const auto values = detail::parseFloats(lines.take((voxels + perRow - 1) / perRow));
+    if (values.size() < voxels) {
+        lines.error(fmt::format("expected {} grid values, found {}", voxels, values.size()));
+    }
+
+    // CHGCAR stores the grid with x running fastest, just as VolumeRAM
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t{dims});
+    std::copy_n(values.begin(), voxels, ram->getDataTyped());
+    res.volume = createVolume(ram, basis);
+
+    return res;
+}
+
+CubeData parseCube(std::string_view contents) {
+    LineReader lines{contents, "CUBE"};
+    lines.next();  // comments
+    lines.next();
+
+    auto tokens = lines.tokens(4);
+    auto numAtoms = lines.number<int>(tokens[0]);
+    auto origin = lines.vec<double>(tokens, 1);
+    // A negative number of atoms indicates an additional line with orbital information
+    const bool extraLine = numAtoms < 0;
+    numAtoms = std::abs(numAtoms);
+    const auto nVal = tokens.size() > 4 ? lines.number<int>(tokens[4]) : 1;
+    if (nVal < 1) lines.error(fmt::format("invalid number of values per voxel {}", nVal));
+
+    // A negative number of voxels along x indicates that units are in Angstrom instead of Bohr
+    bool unitsInAngstrom = false;
+    size3_t dims{0};
+    dmat3 basis{0.0};
+    for (int i = 0; i < 3; ++i) {
+        tokens = lines.tokens(4);
+        auto size = lines.number<int>(tokens[0]);
+        if (i == 0 && size < 0) unitsInAngstrom = true;
+        size = std::abs(size);
+        if (size == 0) lines.error("invalid grid dimensions");
+        dims[i] = static_cast<size_t>(size);
+        basis[i] = static_cast<double>(size) * lines.vec<double>(tokens, 1);
+    }
+    const double unit = unitsInAngstrom ? 1.0 : bohrToAngstrom;
+    basis *= unit;
+    origin *= unit;
+
+    CubeData res;
+    res.positions.reserve(numAtoms);
+    res.atomicNumbers.reserve(numAtoms);
+    for (int i = 0; i < numAtoms; ++i) {
+        tokens = lines.tokens(5);
+        res.atomicNumbers.push_back(lines.number<int>(tokens[0]));
+        res.positions.emplace_back(unit * lines.vec<double>(tokens, 2) - origin);
+    }
+    if (extraLine) lines.next();
+
+    const auto values = detail::parseFloats(lines.remaining());
+    const auto voxels = glm::compMul(dims);
+    if (values.size() < voxels * nVal) {
+        lines.error(fmt::format("expected {} grid values, found {}", voxels * nVal, values.size()));
+    }
+
+    // CUBE files store the grid with z running fastest, transpose it for VolumeRAM and keep
+    // only the first value of each voxel
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t x = 0; x < dims.x; ++x) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            const auto src = values.data() + (x * dims.y + y) * dims.z * nVal;
+            for (size_t z = 0; z < dims.z; ++z) {
+                data[x + dims.x * (y + dims.y * z)] = src[z * nVal];
+            }
+        }
+    }
+    res.volume = createVolume(ram, basis);
+
+    return res;
+}
+
+ChgcarData readChgcar(const std::string& filename) {
+    return parseChgcar(readFile(filename, "CHGCAR"));
+}
+
+CubeData readCube(const std::string& filename) { return parseCube(readFile(filename, "CUBE")); }
+
+}  // namespace vasp
+
+}  // namespace inviwo
@@ -0,0 +1,127 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vasp/io/vaspparsing.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/datareaderexception.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<float> volumeData(const Volume& volume) {
+    auto ram = static_cast<const VolumeRAMPrecision<float>*>(volume.getRepresentation<VolumeRAM>());
+    return {ram->getDataTyped(), ram->getDataTyped() + glm::compMul(ram->getDimensions())};
+}
+
+constexpr std::string_view chgcar = R"(methane
+  1.0
+  2.0 0.0 0.0
+  0.0 3.0 0.0
+  0.0 0.0 4.0
+ C H
+ 1 2
+Cartesian
+  1.0 1.5 2.0
+  0.0 0.0 0.0
+  0.5 0.5 0.5
+
+  2 2 2
+ 0.1E+01 0.2E+01 3 4 5
+ 6 7 8
+augmentation occupancies 1 1
+ 9 9 9
+)";
+
+}  // namespace
+
+TEST(VASPParsing, Chgcar) {
+    const auto data = vasp::parseChgcar(chgcar);
+
+    EXPECT_EQ(data.elements, (std::vector<std::string>{"C", "H"}));
+    EXPECT_EQ(data.counts, (std::vector<int>{1, 2}));
+    EXPECT_EQ(data.elementTypes, (std::vector<std::string>{"C", "H", "H"}));
+    ASSERT_EQ(data.positions.size(), 3);
+    EXPECT_EQ(data.positions[0], vec3(0.5f));
+    EXPECT_EQ(data.positions[1], vec3(0.0f));
+
+    ASSERT_TRUE(data.volume);
+    EXPECT_EQ(data.volume->getDimensions(), size3_t(2));
+    EXPECT_EQ(data.volume->getBasis(), mat3(vec3(2, 0, 0), vec3(0, 3, 0), vec3(0, 0, 4)));
+    EXPECT_EQ(data.volume->getOffset(), vec3(-1.0f, -1.5f, -2.0f));
+    EXPECT_EQ(volumeData(*data.volume), (std::vector<float>{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(data.volume->dataMap_.dataRange, dvec2(1.0, 8.0));
+}
+
+TEST(VASPParsing, ChgcarTruncated) {
+    EXPECT_THROW(vasp::parseChgcar(chgcar.substr(0, chgcar.find(" 6 7 8"))),
+                 DataReaderException);
+    EXPECT_THROW(vasp::parseChgcar(chgcar.substr(0, chgcar.find("Cartesian"))),
+                 DataReaderException);
+}
+
+TEST(VASPParsing, Cube) {
+    constexpr std::string_view cube = R"(comment
+comment
+ 2 0.0 1.0 0.0 2
+ -2 1.0 0.0 0.0
+ 2 0.0 1.0 0.0
+ 3 0.0 0.0 1.0
+ 6 0.0 1.0 1.0 0.0
+ 1 0.0 0.0 2.0 0.0
+ 0 -1 1 -1 2 -1 3 -1 4 -1 5 -1
+ 6 -1 7 -1 8 -1 9 -1 10 -1 11 -1
+)";
+    const auto data = vasp::parseCube(cube);
+
+    EXPECT_EQ(data.atomicNumbers, (std::vector<int>{6, 1}));
+    ASSERT_EQ(data.positions.size(), 2);
+    EXPECT_EQ(data.positions[0], vec3(1.0f, 0.0f, 0.0f));
+    EXPECT_EQ(data.positions[1], vec3(0.0f, 1.0f, 0.0f));
+
+    ASSERT_TRUE(data.volume);
+    EXPECT_EQ(data.volume->getDimensions(), size3_t(2, 2, 3));
+    EXPECT_EQ(data.volume->getBasis(), mat3(vec3(2, 0, 0), vec3(0, 2, 0), vec3(0, 0, 3)));
+    // CUBE files store z fastest, the volume x fastest
+    EXPECT_EQ(volumeData(*data.volume),
+              (std::vector<float>{0, 6, 3, 9, 1, 7, 4, 10, 2, 8, 5, 11}));
+}
+
+TEST(VASPParsing, InvalidNumber) {
+    EXPECT_THROW(vasp::detail::parseFloats("1.0 2.0 abc 4.0"), DataReaderException);
+    EXPECT_EQ(vasp::detail::parseFloats(" 1.0\n-2.5E-01\t+3 "), (std::vector<float>{1, -0.25f, 3}));
+}
+
+}  // namespace inviwo
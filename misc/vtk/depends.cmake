@@ -5,6 +5,8 @@ set(dependencies
     InviwoBaseModule
     InviwoBaseGLModule
     InviwoOpenGLModule
+    InviwoMemoryBudgetModule
+    InviwoUtilitiesGLModule
 )
 
 set(protected ON)
\ No newline at end of file
@@ -31,8 +31,10 @@
 #include <inviwo/vtk/vtkmoduledefine.h>
 
 #include <inviwo/core/common/inviwo.h>
+#include <memory>
 #include <utility>
 #include <optional>
+#include <vector>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -50,7 +52,7 @@ namespace inviwo {
 class IVW_MODULE_VTK_API VTKDataSet {
 public:
     VTKDataSet() = delete;
-    explicit VTKDataSet(vtkSmartPointer<vtkDataSet> dataSet) : dataSet_(dataSet) {}
+    explicit VTKDataSet(vtkSmartPointer<vtkDataSet> dataSet);
     virtual ~VTKDataSet() {}
 
     vtkSmartPointer<vtkDataSet> operator->() const { return dataSet_; }
@@ -66,8 +68,34 @@ public:
      * */
     std::optional<size3_t> getDimensions() const;
 
+    struct ArraySummary {
+        std::string name;
+        std::string dataType;
+        int numberOfComponents;
+        vtkIdType numberOfTuples;
+        std::vector<std::string> componentNames;
+        /// min and max of each component, not including NaN
+        std::vector<dvec2> ranges;
+    };
+    struct Summary {
+        std::vector<ArraySummary> pointArrays;
+        std::vector<ArraySummary> cellArrays;
+        /// true if the ranges are computed from a subset of the tuples
+        bool approximate;
+    };
+
+    /**
+     * Returns the names, types, and component ranges of the point and cell arrays. The ranges
+     * are computed in parallel the first time and cached until the data set is modified. If
+     * \p maxSamples is non-zero, at most that many evenly spaced tuples of each array are
+     * considered and the ranges are approximate. An exact summary is returned if one is cached.
+     */
+    std::shared_ptr<const Summary> getSummary(size_t maxSamples = 0) const;
+
 private:
     vtkSmartPointer<vtkDataSet> dataSet_;
+    struct SummaryCache;
+    std::shared_ptr<SummaryCache> summaryCache_;
 
     // Helpers
     inline std::string getHTMLTableColumnString(const std::string& item) const {
@@ -33,6 +33,8 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/ports/datainport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 #include <inviwo/core/properties/compositeproperty.h>
 #include <inviwo/vtk/ports/vtkdatasetport.h>
@@ -52,22 +54,16 @@ namespace inviwo {
 
 /** \docpage{org.inviwo.VTKDataSetInformation, VTKData Set Information}
  * ![](org.inviwo.VTKDataSetInformation.png?classIdentifier=org.inviwo.VTKDataSetInformation)
- * Explanation of how to use the processor.
+ * Shows the class name and the point and cell data arrays of a VTK data set, with the data
+ * type, number of tuples, and range of each component. The summary is cached on the data set,
+ * see VTKDataSet::getSummary(), and only recomputed when the data set is modified.
  *
  * ### Inports
- *   * __<Inport1>__ <description>.
- *
- * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __inport__ VTK data set.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
- */
-
-/**
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ *   * __Approximate ranges__ Computes the ranges from a subset of the tuples.
+ *   * __Sampled tuples__ Maximum number of tuples per array used for approximate ranges.
  */
 class IVW_MODULE_VTK_API VTKDataSetInformation : public Processor {
 public:
@@ -83,32 +79,38 @@ private:
     class ArrayInformationProperty : public CompositeProperty {
     public:
         ArrayInformationProperty() = delete;
-        ArrayInformationProperty(const std::string& arrayName, const std::string& identifier,
-                                 const vtkDataArray* array)
-            : CompositeProperty(identifier, arrayName)
-            , dataType_(identifier + "dataType", "Data type",
-                        std::string{array->GetDataTypeAsString()})
+        ArrayInformationProperty(const std::string& identifier,
+                                 const VTKDataSet::ArraySummary& array, bool approximate)
+            : CompositeProperty(identifier, array.name)
+            , dataType_(identifier + "dataType", "Data type", array.dataType)
             , numberOfComponents_(identifier + "numberOfComponents", "Components",
-                                  std::to_string(array->GetNumberOfComponents()))
+                                  std::to_string(array.numberOfComponents))
             , componentInformation_("componentInformation", "Component info") {
             addProperties(dataType_, numberOfComponents_, componentInformation_);
 
             dataType_.setReadOnly(true);
             numberOfComponents_.setReadOnly(true);
 
-            for (auto i{0}; i < array->GetNumberOfComponents(); ++i) {
+            for (auto i{0}; i < array.numberOfComponents; ++i) {
                 auto compInfo = new CompositeProperty(fmt::format("component{}", i),
                                                       fmt::format("Component {}", i));
 
                 auto name = new StringProperty(fmt::format("name{}", i), "Name",
-                                               array->GetComponentName(i));
+                                               array.componentNames[i]);
                 name->setReadOnly(true);
                 auto numValues = new StringProperty(fmt::format("numVal{}", i), "Number of tuples",
-                                                    std::to_string(array->GetNumberOfTuples()));
+                                                    std::to_string(array.numberOfTuples));
                 numValues->setReadOnly(true);
 
+                const auto& r = array.ranges[i];
+                auto range = new StringProperty(
+                    fmt::format("range{}", i), approximate ? "Range (approx.)" : "Range",
+                    r.x <= r.y ? fmt::format("[{}, {}]", r.x, r.y) : std::string{"-"});
+                range->setReadOnly(true);
+
                 compInfo->addProperty(name);
                 compInfo->addProperty(numValues);
+                compInfo->addProperty(range);
 
                 componentInformation_.addProperty(compInfo);
             }
@@ -126,8 +128,13 @@ private:
     VTKDataSetInport inport_;
 
     StringProperty className_;
+    BoolProperty approximate_;
+    IntSizeTProperty samples_;
     CompositeProperty pointDataArrays_;
     CompositeProperty cellDataArrays_;
+
+    // the summary shown, the properties are kept as long as it is returned from the cache
+    std::shared_ptr<const VTKDataSet::Summary> summary_;
 };
 
 }  // namespace inviwo
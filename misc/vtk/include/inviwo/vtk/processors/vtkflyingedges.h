@@ -0,0 +1,92 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/vtk/vtkmoduledefine.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/vtk/ports/vtkdatasetport.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkFlyingEdges3D.h>
+#include <vtkSmartPointer.h>
+#include <warn/pop>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.VTKFlyingEdges, VTK Flying Edges}
+ * ![](org.inviwo.VTKFlyingEdges.png?classIdentifier=org.inviwo.VTKFlyingEdges)
+ * Extracts an isosurface of a point data array of VTK image data with vtkFlyingEdges3D, which
+ * runs in parallel using the vtkSMPTools backend VTK was built with. The filter is kept between
+ * evaluations, so changing the isovalue only repeats the extraction and the conversion of the
+ * surface into a mesh, see vtkutil::polyDataToMesh().
+ *
+ * ### Inports
+ *   * __inport__  VTK image data
+ *
+ * ### Outports
+ *   * __outport__  isosurface as a triangle mesh, with normals if enabled
+ *
+ * ### Properties
+ *   * __Point array__  point data array to extract the isosurface of
+ *   * __Component__    component of the array
+ *   * __Isovalue__     value of the isosurface, the range follows the array component
+ *   * __Normals__      compute normals from the gradient of the data
+ */
+class IVW_MODULE_VTK_API VTKFlyingEdges : public Processor {
+public:
+    VTKFlyingEdges();
+    virtual ~VTKFlyingEdges() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void updateArrays();
+    void updateRange();
+
+    VTKDataSetInport inport_;
+    MeshOutport outport_;
+
+    OptionPropertyString pointArray_;
+    IntProperty component_;
+    DoubleProperty isoValue_;
+    BoolProperty normals_;
+
+    vtkSmartPointer<vtkFlyingEdges3D> flyingEdges_;
+};
+
+}  // namespace inviwo
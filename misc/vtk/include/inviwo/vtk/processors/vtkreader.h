@@ -31,28 +31,25 @@
 
 #include <inviwo/vtk/vtkmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/dataoutport.h>
-#include <inviwo/core/processors/progressbarowner.h>
-#include <inviwo/core/processors/activityindicator.h>
 #include <inviwo/vtk/ports/vtkdatasetport.h>
 
-#include <warn/push>
-#include <warn/ignore/all>
-#include <vtkSmartPointer.h>
-#include <vtkXMLGenericDataObjectReader.h>
-#include <vtkGenericDataObjectReader.h>
-#include <vtkDataSet.h>
-#include <vtkDataObject.h>
-#include <warn/pop>
+#include <memory>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.VTKReader, VTKReader}
  * ![](org.inviwo.VTKReader.png?classIdentifier=org.inviwo.VTKReader)
- * Browse for a VTK file to load it.
+ * Browse for a VTK file to load it. Files are read in the background.
+ *
+ * The pieces of partitioned unstructured grids and poly data (.pvtu, .pvtp) are read in
+ * parallel and appended into one data set. Other partitioned files are read by VTK.
+ * ParaView collections (.pvd) are read as time series, where the time steps following the
+ * current one are prefetched in the background.
  *
  * ### Outports
  *   * __VTKDataObjectOutport__ Outputs the VTK data object.
@@ -61,14 +58,13 @@ namespace inviwo {
  *   * __VTK file__ VTK file to load.
  *   * __Reload Data__ If you have updated the data outside Inviwo, you can use this button to
  * manually reload the data.
+ *   * __Time step__ Time step of a collection to output.
+ *   * __Prefetched steps__ Number of time steps after the current one to read in advance.
  */
-
-class IVW_MODULE_VTK_API VTKReader : public Processor,
-                                     public ProgressBarOwner,
-                                     public ActivityIndicatorOwner {
+class IVW_MODULE_VTK_API VTKReader : public PoolProcessor {
 public:
     VTKReader();
-    virtual ~VTKReader() = default;
+    virtual ~VTKReader();
 
     virtual void process() override;
 
@@ -76,32 +72,20 @@ public:
     static const ProcessorInfo processorInfo_;
 
 private:
-    enum class VTKFileType { XML_Serial, XML_Parallel, Legacy, Unknown };
+    enum class VTKFileType { XML_Serial, XML_Parallel, Legacy, Collection, Unknown };
+    struct TimeSeries;
+
+    VTKFileType determineFileType(const std::string& fileName) const;
+    void prefetch(size_t step);
 
     FileProperty file_;
     ButtonProperty reloadButton_;
+    IntSizeTProperty timeStep_;
+    IntSizeTProperty prefetch_;
     VTKDataSetOutport outport_;
 
-    vtkSmartPointer<vtkXMLGenericDataObjectReader> xmlreader_;
-    vtkSmartPointer<vtkGenericDataObjectReader> legacyreader_;
-
-    std::shared_ptr<VTKDataSet> data_;
-    vtkSmartPointer<vtkDataSet> dataSet_;
-
-    VTKFileType determineFileType(const std::string& fileName) const;
-
-    template <VTKFileType T>
-    vtkSmartPointer<vtkDataSet> read(const std::string path) {
-        using V = std::conditional_t<T == VTKFileType::Legacy, vtkGenericDataObjectReader,
-                                     vtkXMLGenericDataObjectReader>;
-
-        auto reader = vtkSmartPointer<V>::New();
-
-        reader->SetFileName(path.c_str());
-        reader->Update();
-
-        return vtkDataSet::SafeDownCast(V::SafeDownCast(reader.GetPointer())->GetOutput());
-    }
+    std::shared_ptr<TimeSeries> series_;
+    bool reload_ = true;
 };
 
 }  // namespace inviwo
@@ -48,6 +48,7 @@
 #include <vtkGenericDataObjectReader.h>
 #include <vtkDataSet.h>
 #include <vtkDataObject.h>
+#include <vtkDataArray.h>
 #include <warn/pop>
 
 namespace inviwo {
@@ -91,10 +92,11 @@ private:
         VTKArrayList(const std::string& identifier, const std::string& displayName)
             : CompositeProperty(identifier, displayName) {}
         void clear();
-        void addArray(const std::string& name, int numChannels, void* dataPtr);
+        void addArray(const std::string& name, vtkDataArray* array);
         DataFormatId selectedFormat;
         std::vector<size_t> numArrayComponents;
         std::vector<unsigned char*> ptrArrayData;
+        std::vector<vtkDataArray*> arrays;
 
     protected:
         using CompositeProperty::addProperties;
@@ -32,6 +32,7 @@
 #include <inviwo/vtk/vtkmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
@@ -45,6 +46,7 @@
 #include <warn/ignore/all>
 #include <vtkSmartPointer.h>
 #include <vtkDataSet.h>
+#include <vtkCellTreeLocator.h>
 #include <warn/pop>
 
 namespace inviwo {
@@ -52,6 +54,13 @@ namespace inviwo {
 /** \docpage{org.inviwo.VTKUnstructuredGridToRectilinearGrid, VTK Unstructured Grid To Rectilinear
  * Grid}
  * ![](org.inviwo.VTKUnstructuredGridReader.png?classIdentifier=org.inviwo.VTKUnstructuredGridToRectilinearGrid)
+ * Resamples the point and cell data of an unstructured grid onto a rectilinear grid covering its
+ * bounds, probing the slices of the output grid in parallel.
+ *
+ * ### Properties
+ *   * __Max output dimension__ Number of grid points along the largest extent of the input.
+ *   * __Progressive refinement__ Outputs grids of an eighth, a quarter, and half of the resolution
+ *     before the full one, such that a first result is available quickly.
  */
 
 class IVW_MODULE_VTK_API VTKUnstructuredGridToRectilinearGrid : public Processor,
@@ -75,11 +84,17 @@ protected:
         std::atomic<bool> processorExists_ = true;
 
         ivec3 dims_ = ivec3(1);
+
+        // cell locator of the input, kept as long as the input is not modified
+        vtkSmartPointer<vtkCellTreeLocator> locator_;
+        vtkDataSet* locatorDataSet_ = nullptr;
+        vtkMTimeType locatorMTime_ = 0;
     };
 
     void loadData();
 
     IntProperty maxDimension_;
+    BoolProperty progressive_;
 
     ButtonProperty button_;
     ButtonProperty abortButton_;
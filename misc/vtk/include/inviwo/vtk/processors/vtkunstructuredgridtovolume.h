@@ -0,0 +1,101 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/vtk/vtkmoduledefine.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/vtk/ports/vtkdatasetport.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <memory>
+
+namespace inviwo {
+
+class BufferObject;
+class Volume;
+
+/** \docpage{org.inviwo.VTKUnstructuredGridToVolume, VTK Unstructured Grid To Volume}
+ * ![](org.inviwo.VTKUnstructuredGridToVolume.png?classIdentifier=org.inviwo.VTKUnstructuredGridToVolume)
+ * Resamples a point data array of a VTK unstructured grid into a volume on the GPU. The cells
+ * are split into tetrahedra and uploaded once per input, each tetrahedron is then rasterized
+ * into the voxels it covers by a compute shader using barycentric interpolation. Changing the
+ * resolution thus only repeats the rasterization. Tetrahedra, hexahedra, voxels, wedges and
+ * pyramids are supported, other cells are skipped. Voxels outside of the grid are zero.
+ *
+ * The output volume is kept on the GPU. For the CPU alternative producing a VTK data set, see
+ * VTKUnstructuredGridToRectilinearGrid.
+ *
+ * ### Inports
+ *   * __inport__  VTK unstructured grid
+ *
+ * ### Outports
+ *   * __outport__  resampled volume with one float channel
+ *
+ * ### Properties
+ *   * __Point array__       point data array to resample
+ *   * __Component__         component of the array
+ *   * __Max output dimension__ number of voxels along the largest side of the bounds
+ */
+class IVW_MODULE_VTK_API VTKUnstructuredGridToVolume : public Processor {
+public:
+    VTKUnstructuredGridToVolume();
+    virtual ~VTKUnstructuredGridToVolume();
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void updateArrays();
+    void uploadCells();
+
+    VTKDataSetInport inport_;
+    VolumeOutport outport_;
+
+    OptionPropertyString pointArray_;
+    IntProperty component_;
+    IntProperty maxDimension_;
+
+    Shader shader_;
+    // vertex positions with the value of the selected array component in w
+    std::unique_ptr<BufferObject> vertices_;
+    // four vertex indices per tetrahedron
+    std::unique_ptr<BufferObject> tetrahedra_;
+    size_t numTetrahedra_ = 0;
+    dvec2 valueRange_{0.0, 1.0};
+    bool cellsDirty_ = true;
+    std::shared_ptr<Volume> volume_;
+};
+
+}  // namespace inviwo
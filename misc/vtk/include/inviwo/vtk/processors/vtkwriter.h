@@ -32,41 +32,46 @@
 #include <inviwo/vtk/vtkmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/progressbarowner.h>
+#include <inviwo/core/processors/activityindicator.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/vtk/ports/vtkdatasetport.h>
 
-#include <warn/push>
-#include <warn/ignore/all>
-#include <vtkXMLDataSetWriter.h>
-#include <vtkSmartPointer.h>
-#include <warn/pop>
+#include <atomic>
+#include <memory>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.VTKWriter, VTKWriter}
  * ![](org.inviwo.VTKWriter.png?classIdentifier=org.inviwo.VTKWriter)
- * Explanation of how to use the processor.
+ * Writes a VTK data set to a VTK XML file in the background. The data is written in appended
+ * binary format and optionally compressed.
  *
- * ### Inports
- *   * __<Inport1>__ <description>.
+ * With more than one piece, the data set is split into pieces that are written in parallel
+ * to separate files, along with a partitioned summary file (.pvtu, .pvti, ...) referencing
+ * them. Grids are split into slabs along z, unstructured data by ranges of cells.
  *
- * ### Outports
- *   * __<Outport1>__ <description>.
+ * ### Inports
+ *   * __inport__ VTK data set to write.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
- */
-
-/**
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ *   * __File name__ File to write, the extension is replaced by the one of the data type.
+ *   * __Compression__ Compressor of the binary data.
+ *   * __Compression level__ Trade-off between speed (1) and size (9).
+ *   * __Pieces__ Number of pieces to split the data set into.
+ *   * __Export__ Writes the current data set.
  */
-class IVW_MODULE_VTK_API VTKWriter : public Processor {
+class IVW_MODULE_VTK_API VTKWriter : public Processor,
+                                     public ProgressBarOwner,
+                                     public ActivityIndicatorOwner {
 public:
+    enum class Compression { None, ZLib, LZ4 };
+
     VTKWriter();
-    virtual ~VTKWriter() = default;
+    virtual ~VTKWriter();
 
     virtual void process() override;
 
@@ -75,11 +80,16 @@ public:
 
 private:
     VTKDataSetInport inport_;
-    vtkSmartPointer<vtkXMLDataSetWriter> writer_;
 
     FileProperty file_;
+    TemplateOptionProperty<Compression> compression_;
+    IntProperty compressionLevel_;
+    IntProperty pieces_;
     ButtonProperty button_;
 
+    // shared with the background writes, cleared when the processor is removed
+    std::shared_ptr<std::atomic<bool>> processorExists_;
+
     void export_isacppkeyword();
 };
 
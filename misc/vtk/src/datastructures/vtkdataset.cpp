@@ -38,10 +38,142 @@
 #include <vtkPointData.h>
 #include <vtkArray.h>
 #include <vtkImageData.h>
+#include <vtkDataArray.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <warn/pop>
 
+#include <cmath>
+#include <limits>
+#include <mutex>
+
 namespace inviwo {
 
+namespace {
+
+constexpr dvec2 emptyRange{std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::lowest()};
+
+template <typename Get>
+std::vector<dvec2> computeRanges(vtkIdType numTuples, int numComponents, vtkIdType stride,
+                                 Get get) {
+    vtkSMPThreadLocal<std::vector<dvec2>> localRanges(
+        std::vector<dvec2>(static_cast<size_t>(numComponents), emptyRange));
+
+    const vtkIdType numSamples = (numTuples + stride - 1) / stride;
+    vtkSMPTools::For(0, numSamples, [&](vtkIdType begin, vtkIdType end) {
+        auto& ranges = localRanges.Local();
+        for (vtkIdType s = begin; s < end; ++s) {
+            const vtkIdType tuple = s * stride;
+            for (int c = 0; c < numComponents; ++c) {
+                const double v = get(tuple, c);
+                if (std::isnan(v)) continue;
+                ranges[c].x = std::min(ranges[c].x, v);
+                ranges[c].y = std::max(ranges[c].y, v);
+            }
+        }
+    });
+
+    std::vector<dvec2> result(static_cast<size_t>(numComponents), emptyRange);
+    for (const auto& ranges : localRanges) {
+        for (int c = 0; c < numComponents; ++c) {
+            result[c].x = std::min(result[c].x, ranges[c].x);
+            result[c].y = std::max(result[c].y, ranges[c].y);
+        }
+    }
+    return result;
+}
+
+VTKDataSet::ArraySummary summarize(vtkDataArray* array, size_t maxSamples) {
+    VTKDataSet::ArraySummary summary{array->GetName() ? array->GetName() : "",
+                                     array->GetDataTypeAsString(), array->GetNumberOfComponents(),
+                                     array->GetNumberOfTuples(), {}, {}};
+    for (int c = 0; c < summary.numberOfComponents; ++c) {
+        const char* name = array->GetComponentName(c);
+        summary.componentNames.emplace_back(name ? name : "");
+    }
+
+    const vtkIdType numTuples = summary.numberOfTuples;
+    const int numComponents = summary.numberOfComponents;
+    const vtkIdType stride =
+        maxSamples > 0 && static_cast<size_t>(numTuples) > maxSamples
+            ? (numTuples + static_cast<vtkIdType>(maxSamples) - 1) /
+                  static_cast<vtkIdType>(maxSamples)
+            : 1;
+
+    if (array->HasStandardMemoryLayout()) {
+        switch (array->GetDataType()) {
+            vtkTemplateMacro(summary.ranges = computeRanges(
+                                 numTuples, numComponents, stride,
+                                 [data = static_cast<const VTK_TT*>(array->GetVoidPointer(0)),
+                                  numComponents](vtkIdType t, int c) {
+                                     return static_cast<double>(data[t * numComponents + c]);
+                                 }));
+            default:
+                break;
+        }
+    }
+    if (summary.ranges.empty()) {
+        summary.ranges = computeRanges(numTuples, numComponents, stride,
+                                       [array](vtkIdType t, int c) {
+                                           return array->GetComponent(t, c);
+                                       });
+    }
+    return summary;
+}
+
+std::vector<VTKDataSet::ArraySummary> summarize(vtkDataSetAttributes* attributes,
+                                                size_t maxSamples) {
+    std::vector<VTKDataSet::ArraySummary> result;
+    if (!attributes) return result;
+    for (int i = 0; i < attributes->GetNumberOfArrays(); ++i) {
+        if (auto array = attributes->GetArray(i)) result.push_back(summarize(array, maxSamples));
+    }
+    return result;
+}
+
+}  // namespace
+
+struct VTKDataSet::SummaryCache {
+    std::mutex mutex;
+    vtkMTimeType mTime = 0;
+    size_t maxSamples = 0;
+    std::shared_ptr<const Summary> summary;
+};
+
+VTKDataSet::VTKDataSet(vtkSmartPointer<vtkDataSet> dataSet)
+    : dataSet_(dataSet), summaryCache_(std::make_shared<SummaryCache>()) {}
+
+std::shared_ptr<const VTKDataSet::Summary> VTKDataSet::getSummary(size_t maxSamples) const {
+    std::scoped_lock lock{summaryCache_->mutex};
+    auto& cache = *summaryCache_;
+
+    const auto mTime = dataSet_->GetMTime();
+    // an exact summary can answer any request, an approximate one only requests with at most
+    // as many samples
+    const bool usable = cache.summary && cache.mTime == mTime &&
+                        (!cache.summary->approximate ||
+                         (maxSamples > 0 && maxSamples <= cache.maxSamples));
+    if (usable) return cache.summary;
+
+    auto summary = std::make_shared<Summary>();
+    summary->pointArrays = summarize(dataSet_->GetPointData(), maxSamples);
+    summary->cellArrays = summarize(dataSet_->GetCellData(), maxSamples);
+    summary->approximate = false;
+    for (const auto* arrays : {&summary->pointArrays, &summary->cellArrays}) {
+        for (const auto& array : *arrays) {
+            if (maxSamples > 0 && static_cast<size_t>(array.numberOfTuples) > maxSamples) {
+                summary->approximate = true;
+            }
+        }
+    }
+
+    cache.mTime = mTime;
+    cache.maxSamples = maxSamples;
+    cache.summary = summary;
+    return summary;
+}
+
 std::optional<size3_t> VTKDataSet::getDimensions() const {
     ivec3 dims{0};
 
@@ -56,6 +56,8 @@ VTKDataSetInformation::VTKDataSetInformation()
     : Processor()
     , inport_("inport")
     , className_("className", "Class name", "", InvalidationLevel::Valid)
+    , approximate_("approximate", "Approximate ranges", false)
+    , samples_("samples", "Sampled tuples", 100000, 1000, 100000000, 1000)
     , pointDataArrays_("pointDataArrays", "Point data arrays")
     , cellDataArrays_("cellDataArrays", "Cell data arrays") {
     addPort(inport_);
@@ -63,8 +65,11 @@ VTKDataSetInformation::VTKDataSetInformation()
     className_.setReadOnly(true);
 
     addProperty(className_);
+    addProperties(approximate_, samples_);
     addProperty(pointDataArrays_);
     addProperty(cellDataArrays_);
+
+    samples_.visibilityDependsOn(approximate_, [](const auto& p) { return p.get(); });
 }
 
 void VTKDataSetInformation::process() {
@@ -72,8 +77,15 @@ void VTKDataSetInformation::process() {
 
     className_.set(std::string{dataSet->GetClassName()});
 
-    const auto pointData = dataSet->GetPointData();
-    const auto cellData = dataSet->GetCellData();
+    auto summary = dataSet.getSummary(approximate_ ? samples_.get() : 0);
+    if (summary == summary_) return;
+    summary_ = summary;
+
+    const auto makeIdentifier = [](std::string identifier) {
+        replaceInString(identifier, ".", "");
+        replaceInString(identifier, " ", "");
+        return identifier;
+    };
 
     {
         NetworkLock lock;
@@ -82,27 +94,14 @@ void VTKDataSetInformation::process() {
 
         cellDataArrays_.clear();
 
-        for (int i{0}; i < pointData->GetNumberOfArrays(); ++i) {
-            const auto array = pointData->GetArray(i);
-            auto arrayName = std::string{array->GetName()};
-            auto identifier = arrayName;
-
-            replaceInString(identifier, ".", "");
-            replaceInString(identifier, " ", "");
-
-            pointDataArrays_.addProperty(
-                new ArrayInformationProperty{arrayName, identifier, array});
+        for (const auto& array : summary->pointArrays) {
+            pointDataArrays_.addProperty(new ArrayInformationProperty{
+                makeIdentifier(array.name), array, summary->approximate});
         }
 
-        for (int i{0}; i < cellData->GetNumberOfArrays(); ++i) {
-            const auto array = cellData->GetArray(i);
-            const auto arrayName = std::string{array->GetName()};
-            auto identifier = arrayName;
-
-            replaceInString(identifier, ".", "");
-            replaceInString(identifier, " ", "");
-
-            cellDataArrays_.addProperty(new ArrayInformationProperty{arrayName, identifier, array});
+        for (const auto& array : summary->cellArrays) {
+            cellDataArrays_.addProperty(new ArrayInformationProperty{
+                makeIdentifier(array.name), array, summary->approximate});
         }
     }
 }
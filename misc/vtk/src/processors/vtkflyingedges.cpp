@@ -0,0 +1,147 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vtk/processors/vtkflyingedges.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/vtk/util/vtkmeshutils.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkDataArray.h>
+#include <vtkDataObject.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo VTKFlyingEdges::processorInfo_{
+    "org.inviwo.VTKFlyingEdges",  // Class identifier
+    "VTK Flying Edges",           // Display name
+    "VTK",                        // Category
+    CodeState::Experimental,      // Code state
+    Tags::CPU,                    // Tags
+};
+const ProcessorInfo VTKFlyingEdges::getProcessorInfo() const { return processorInfo_; }
+
+VTKFlyingEdges::VTKFlyingEdges()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , pointArray_("pointArray", "Point array")
+    , component_("component", "Component", 0, 0, 0)
+    , isoValue_("isoValue", "Isovalue", 0.5, 0.0, 1.0, 0.001)
+    , normals_("normals", "Normals", true)
+    , flyingEdges_(vtkSmartPointer<vtkFlyingEdges3D>::New()) {
+
+    addPort(inport_);
+    addPort(outport_);
+    addProperties(pointArray_, component_, isoValue_, normals_);
+
+    flyingEdges_->ComputeScalarsOff();
+    flyingEdges_->ComputeGradientsOff();
+
+    inport_.onChange([this]() { updateArrays(); });
+    pointArray_.onChange([this]() { updateArrays(); });
+    component_.onChange([this]() { updateRange(); });
+}
+
+void VTKFlyingEdges::updateArrays() {
+    if (!inport_.hasData()) return;
+
+    auto pointData = (*inport_.getData())->GetPointData();
+    std::vector<OptionPropertyOption<std::string>> options;
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+        if (auto array = pointData->GetArray(i); array && array->GetName()) {
+            std::string identifier{array->GetName()};
+            replaceInString(identifier, ".", "");
+            replaceInString(identifier, " ", "");
+            options.emplace_back(identifier, array->GetName(), array->GetName());
+        }
+    }
+    pointArray_.replaceOptions(options);
+
+    const int numComponents =
+        pointArray_.size() > 0 && pointData->GetArray(pointArray_.get().c_str())
+            ? pointData->GetArray(pointArray_.get().c_str())->GetNumberOfComponents()
+            : 1;
+    component_.setMaxValue(numComponents - 1);
+    updateRange();
+}
+
+void VTKFlyingEdges::updateRange() {
+    if (!inport_.hasData() || pointArray_.size() == 0) return;
+
+    // The range only bounds the slider, a sampled summary is enough and avoids a full pass
+    constexpr size_t maxSamples = 1 << 20;
+    const auto summary = inport_.getData()->getSummary(maxSamples);
+    const auto it = std::find_if(summary->pointArrays.begin(), summary->pointArrays.end(),
+                                 [&](const auto& a) { return a.name == pointArray_.get(); });
+    if (it == summary->pointArrays.end() || it->ranges.empty()) return;
+
+    const auto component = std::min(static_cast<size_t>(component_.get()), it->ranges.size() - 1);
+    const dvec2 range = it->ranges[component];
+    isoValue_.setMinValue(range.x);
+    isoValue_.setMaxValue(range.y);
+    isoValue_.setIncrement((range.y - range.x) / 1000.0);
+}
+
+void VTKFlyingEdges::process() {
+    vtkSmartPointer<vtkDataSet> dataSet = **inport_.getData();
+    auto image = vtkImageData::SafeDownCast(dataSet);
+    if (!image) {
+        throw Exception(
+            fmt::format("Flying edges requires image data, got {}", dataSet->GetClassName()),
+            IVW_CONTEXT);
+    }
+    if (pointArray_.size() == 0) {
+        throw Exception("The data set has no point data arrays", IVW_CONTEXT);
+    }
+
+    // Only reassigning the input marks the filter as modified, keep it if it is the same
+    if (flyingEdges_->GetInput() != image) flyingEdges_->SetInputData(image);
+    flyingEdges_->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                         pointArray_.get().c_str());
+    flyingEdges_->SetArrayComponent(component_.get());
+    flyingEdges_->SetComputeNormals(normals_.get());
+    flyingEdges_->SetValue(0, isoValue_.get());
+    flyingEdges_->Update();
+
+    outport_.setData(vtkutil::polyDataToMesh(*flyingEdges_->GetOutput()));
+}
+
+}  // namespace inviwo
@@ -35,15 +35,257 @@
 
 #include <warn/push>
 #include <warn/ignore/all>
+#include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
 #include <vtkCallbackCommand.h>
+#include <vtkDataSet.h>
+#include <vtkGenericDataObjectReader.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkXMLDataElement.h>
+#include <vtkXMLDataParser.h>
+#include <vtkXMLGenericDataObjectReader.h>
 #include <warn/pop>
 
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string_view>
 #include <inviwo/vtk/util/vtkutil.h>
 #include <fmt/format.h>
 
 namespace inviwo {
 
+namespace {
+
+using StopFunc = std::function<bool()>;
+using ProgressFunc = std::function<void(float)>;
+
+struct ReadObserver {
+    const StopFunc& stop;
+    const ProgressFunc& progress;
+};
+
+void readProgressCallback(vtkObject* caller, long unsigned int, void* clientData, void*) {
+    if (auto algorithm = vtkAlgorithm::SafeDownCast(caller)) {
+        auto observer = static_cast<ReadObserver*>(clientData);
+        if (observer->stop()) algorithm->AbortExecuteOn();
+        observer->progress(static_cast<float>(algorithm->GetProgress()));
+    }
+}
+
+template <typename Reader>
+vtkSmartPointer<vtkDataSet> readFile(const std::string& path, const StopFunc& stop,
+                                     const ProgressFunc& progress) {
+    auto reader = vtkSmartPointer<Reader>::New();
+    ReadObserver observer{stop, progress};
+    auto callback = vtkSmartPointer<vtkCallbackCommand>::New();
+    callback->SetCallback(readProgressCallback);
+    callback->SetClientData(&observer);
+    reader->AddObserver(vtkCommand::ProgressEvent, callback);
+
+    reader->SetFileName(path.c_str());
+    reader->Update();
+    if (stop()) return nullptr;
+
+    vtkSmartPointer<vtkDataSet> dataSet = vtkDataSet::SafeDownCast(reader->GetOutput());
+    if (!dataSet) {
+        throw DataReaderException(fmt::format("'{}' does not contain a VTK data set", path),
+                                  IVW_CONTEXT_CUSTOM("VTKReader"));
+    }
+    return dataSet;
+}
+
+std::string resolve(const std::string& base, const std::string& file) {
+    const std::filesystem::path path{file};
+    if (path.is_absolute()) return file;
+    return (std::filesystem::path{base}.parent_path() / path).generic_string();
+}
+
+std::unique_ptr<vtkXMLDataParser, void (*)(vtkXMLDataParser*)> parseXML(const std::string& path) {
+    std::unique_ptr<vtkXMLDataParser, void (*)(vtkXMLDataParser*)> parser{
+        vtkXMLDataParser::New(), [](vtkXMLDataParser* p) { p->Delete(); }};
+    parser->SetFileName(path.c_str());
+    if (!parser->Parse() || !parser->GetRootElement()) {
+        throw DataReaderException(fmt::format("Could not parse '{}'", path),
+                                  IVW_CONTEXT_CUSTOM("VTKReader"));
+    }
+    return parser;
+}
+
+/**
+ * Returns the files of the pieces of a partitioned unstructured grid or poly data, which can be
+ * appended. Other partitioned data sets return nothing and are read by VTK.
+ */
+std::vector<std::string> appendablePieces(const std::string& path) {
+    auto parser = parseXML(path);
+    auto root = parser->GetRootElement();
+    const std::string type = root->GetAttribute("type") ? root->GetAttribute("type") : "";
+    if (type != "PUnstructuredGrid" && type != "PPolyData") return {};
+
+    std::vector<std::string> pieces;
+    if (auto data = root->FindNestedElementWithName(type.c_str())) {
+        for (int i = 0; i < data->GetNumberOfNestedElements(); ++i) {
+            auto element = data->GetNestedElement(i);
+            if (std::string_view{element->GetName()} == "Piece" &&
+                element->GetAttribute("Source")) {
+                pieces.push_back(resolve(path, element->GetAttribute("Source")));
+            }
+        }
+    }
+    return pieces;
+}
+
+/**
+ * Returns the files of each time step of a ParaView collection, sorted by time. Several files
+ * of one time step are parts that are appended.
+ */
+std::vector<std::vector<std::string>> collectionSteps(const std::string& path) {
+    auto parser = parseXML(path);
+    std::map<double, std::vector<std::string>> steps;
+    if (auto collection = parser->GetRootElement()->FindNestedElementWithName("Collection")) {
+        for (int i = 0; i < collection->GetNumberOfNestedElements(); ++i) {
+            auto element = collection->GetNestedElement(i);
+            if (std::string_view{element->GetName()} != "DataSet" ||
+                !element->GetAttribute("file")) {
+                continue;
+            }
+            double time = 0.0;
+            element->GetScalarAttribute("timestep", time);
+            steps[time].push_back(resolve(path, element->GetAttribute("file")));
+        }
+    }
+    if (steps.empty()) {
+        throw DataReaderException(fmt::format("'{}' contains no data sets", path),
+                                  IVW_CONTEXT_CUSTOM("VTKReader"));
+    }
+
+    std::vector<std::vector<std::string>> result;
+    for (auto& step : steps) result.push_back(std::move(step.second));
+    return result;
+}
+
+std::string fileExtension(const std::string& path) {
+    return toLower(filesystem::getFileExtension(path));
+}
+
+/**
+ * Reads the given pieces in parallel and appends them into one data set. Poly data is appended
+ * into poly data, everything else into an unstructured grid.
+ */
+vtkSmartPointer<vtkDataSet> readPieces(const std::vector<std::string>& pieces,
+                                       const StopFunc& stop, const ProgressFunc& progress) {
+    std::vector<vtkSmartPointer<vtkDataSet>> dataSets(pieces.size());
+    std::vector<std::exception_ptr> errors(pieces.size());
+    std::atomic<size_t> done{0};
+    std::mutex progressMutex;
+    const ProgressFunc noProgress = [](float) {};
+
+    vtkSMPTools::For(0, static_cast<vtkIdType>(pieces.size()), [&](vtkIdType begin,
+                                                                   vtkIdType end) {
+        for (auto i = begin; i < end; ++i) {
+            try {
+                if (fileExtension(pieces[i]) == "vtk") {
+                    dataSets[i] = readFile<vtkGenericDataObjectReader>(pieces[i], stop, noProgress);
+                } else {
+                    dataSets[i] =
+                        readFile<vtkXMLGenericDataObjectReader>(pieces[i], stop, noProgress);
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            const auto f = static_cast<float>(++done) / static_cast<float>(pieces.size());
+            std::scoped_lock lock{progressMutex};
+            progress(f);
+        }
+    });
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    if (stop()) return nullptr;
+    if (dataSets.size() == 1) return dataSets.front();
+
+    const bool polyData = std::all_of(dataSets.begin(), dataSets.end(),
+                                      [](auto& d) { return vtkPolyData::SafeDownCast(d); });
+    if (polyData) {
+        auto append = vtkSmartPointer<vtkAppendPolyData>::New();
+        for (auto& dataSet : dataSets) append->AddInputData(vtkPolyData::SafeDownCast(dataSet));
+        append->Update();
+        return append->GetOutput();
+    } else {
+        auto append = vtkSmartPointer<vtkAppendFilter>::New();
+        for (auto& dataSet : dataSets) append->AddInputData(dataSet);
+        append->Update();
+        return append->GetOutput();
+    }
+}
+
+}  // namespace
+
+/**
+ * The files of each time step and the data sets read so far. A single file is a series of one
+ * step. Shared with the background jobs and replaced when the file changes.
+ */
+struct VTKReader::TimeSeries {
+    using Future = std::shared_future<vtkSmartPointer<vtkDataSet>>;
+
+    TimeSeries(std::vector<std::vector<std::string>> steps, VTKFileType type)
+        : steps{std::move(steps)}, type{type} {}
+
+    vtkSmartPointer<vtkDataSet> read(size_t step, const StopFunc& stop,
+                                     const ProgressFunc& progress) const {
+        const auto& files = steps[step];
+        if (files.size() > 1) return readPieces(files, stop, progress);
+
+        const auto& file = files.front();
+        if (type == VTKFileType::Legacy) {
+            return readFile<vtkGenericDataObjectReader>(file, stop, progress);
+        } else if (auto pieces = appendablePieces(file); !pieces.empty()) {
+            return readPieces(pieces, stop, progress);
+        } else {
+            return readFile<vtkXMLGenericDataObjectReader>(file, stop, progress);
+        }
+    }
+
+    // Returns the data set of the step if it is read already. Steps that are still being
+    // prefetched are read again rather than blocking a pool thread on another job.
+    vtkSmartPointer<vtkDataSet> get(size_t step) {
+        std::scoped_lock lock{mutex};
+        auto it = cache.find(step);
+        if (it != cache.end() &&
+            it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            try {
+                return it->second.get();
+            } catch (...) {
+                cache.erase(it);
+            }
+        }
+        return nullptr;
+    }
+
+    void set(size_t step, vtkSmartPointer<vtkDataSet> dataSet) {
+        std::promise<vtkSmartPointer<vtkDataSet>> promise;
+        promise.set_value(std::move(dataSet));
+        std::scoped_lock lock{mutex};
+        cache[step] = promise.get_future().share();
+    }
+
+    const std::vector<std::vector<std::string>> steps;
+    const VTKFileType type;
+
+    // set when the series is replaced, stops the prefetching
+    std::atomic<bool> cancelled{false};
+
+    std::mutex mutex;
+    std::map<size_t, Future> cache;
+};
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo VTKReader::processorInfo_{
     "org.inviwo.VTKReader",   // Class identifier
@@ -55,13 +297,12 @@ const ProcessorInfo VTKReader::processorInfo_{
 const ProcessorInfo VTKReader::getProcessorInfo() const { return processorInfo_; }
 
 VTKReader::VTKReader()
-    : Processor()
+    : PoolProcessor()
     , file_("vtkFile", "VTK file", "", "VTK")
     , reloadButton_("reload", "Reload Data")
-    , outport_("VTKDataObjectOutport")
-    , xmlreader_(nullptr)
-    , legacyreader_(nullptr)
-    , data_(nullptr) {
+    , timeStep_("timeStep", "Time step", 0, 0, 0)
+    , prefetch_("prefetch", "Prefetched steps", 2, 0, 16, 1, InvalidationLevel::Valid)
+    , outport_("VTKDataObjectOutport") {
 
     file_.addNameFilter(FileExtension("vti", "VTK ImageData (structured)"));
     file_.addNameFilter(FileExtension("vtp", "VTK PolyData (unstructured)"));
@@ -74,22 +315,28 @@ VTKReader::VTKReader()
     file_.addNameFilter(FileExtension("pvtr", "Parallel vtkRectilinearGrid (structured)"));
     file_.addNameFilter(FileExtension("pvts", "Parallel vtkStructuredGrid (structured)"));
     file_.addNameFilter(FileExtension("pvtu", "Parallel vtkUnstructuredGrid (unstructured)"));
+    file_.addNameFilter(FileExtension("pvd", "ParaView Data Collection (time series)"));
 
-    addProperty(file_);
+    addProperties(file_, reloadButton_, timeStep_, prefetch_);
+    timeStep_.setVisible(false);
+    prefetch_.setVisible(false);
 
     addPort(outport_);
 
-    progressBar_.hide();
+    file_.onChange([this]() { reload_ = true; });
+    reloadButton_.onChange([this]() { reload_ = true; });
+    prefetch_.onChange([this]() { prefetch(timeStep_.get()); });
+}
 
-    reloadButton_.onChange([this]() {
-        xmlreader_ = nullptr;
-        legacyreader_ = nullptr;
-    });
+VTKReader::~VTKReader() {
+    if (series_) series_->cancelled = true;
 }
 
 void VTKReader::process() {
-    if (file_.isModified()) {
-        auto fileName = file_.get();
+    if (reload_) {
+        const auto fileName = file_.get();
+        if (series_) series_->cancelled = true;
+        series_.reset();
 
         if (!filesystem::fileExists(fileName)) {
             LogError(fmt::format("File {} not found.", fileName));
@@ -97,50 +344,93 @@ void VTKReader::process() {
         }
 
         const auto fileType = determineFileType(fileName);
-
         switch (fileType) {
             case VTKFileType::Unknown:
                 throw DataReaderException("Unknown file type", IVW_CONTEXT);
-                return;
-            case VTKFileType::XML_Parallel:
-                throw DataReaderException("Parallel VTK files are not (yet) supported.",
-                                          IVW_CONTEXT);
-                return;
-            case VTKFileType::Legacy:
-                dataSet_ = read<VTKFileType::Legacy>(std::move(fileName));
-                break;
-            case VTKFileType::XML_Serial:
-                dataSet_ = read<VTKFileType::XML_Serial>(std::move(fileName));
+            case VTKFileType::Collection:
+                series_ = std::make_shared<TimeSeries>(collectionSteps(fileName), fileType);
                 break;
             default:
+                series_ = std::make_shared<TimeSeries>(
+                    std::vector<std::vector<std::string>>{{fileName}}, fileType);
                 break;
         }
+        reload_ = false;
+
+        const bool isSeries = series_->steps.size() > 1;
+        timeStep_.setMaxValue(series_->steps.size() - 1);
+        timeStep_.setVisible(isSeries);
+        prefetch_.setVisible(isSeries);
+    }
+    if (!series_) return;
+
+    const auto step = std::min(timeStep_.get(), series_->steps.size() - 1);
+    if (auto dataSet = series_->get(step)) {
+        outport_.setData(std::make_shared<VTKDataSet>(dataSet));
+        prefetch(step);
+        return;
+    }
 
-        dispatchFront([this]() {
-            data_ = std::make_shared<VTKDataSet>(dataSet_);
-            getActivityIndicator().setActive(false);
-            outport_.setData(data_);
-            invalidate(InvalidationLevel::InvalidOutput);
-        });
+    using Result = std::shared_ptr<VTKDataSet>;
+    auto read = [series = series_, step](pool::Stop stop, pool::Progress progress) -> Result {
+        auto dataSet = series->read(
+            step, [&stop]() { return static_cast<bool>(stop); },
+            [&progress](float f) { progress(f); });
+        if (!dataSet) return nullptr;
+        series->set(step, dataSet);
+        return std::make_shared<VTKDataSet>(dataSet);
+    };
+
+    dispatchOne(read, [this, step](Result result) {
+        outport_.setData(std::move(result));
+        newResults();
+        prefetch(step);
+    });
+}
+
+void VTKReader::prefetch(size_t step) {
+    if (!series_) return;
+    const size_t last = std::min(step + prefetch_.get(), series_->steps.size() - 1);
+
+    std::scoped_lock lock{series_->mutex};
+    // only the current step and the prefetched ones are kept in memory
+    for (auto it = series_->cache.begin(); it != series_->cache.end();) {
+        it = (it->first < step || it->first > last) ? series_->cache.erase(it) : std::next(it);
+    }
+    for (size_t i = step + 1; i <= last; ++i) {
+        if (series_->cache.count(i)) continue;
+        auto read = [series = series_, i]() {
+            return series->read(
+                i, [&series]() { return series->cancelled.load(); }, [](float) {});
+        };
+        series_->cache[i] = dispatchPool(read).share();
     }
 }
 
 VTKReader::VTKFileType VTKReader::determineFileType(const std::string& fileName) const {
+    if (fileExtension(fileName) == "pvd") return VTKFileType::Collection;
+
     std::string line{};
     std::ifstream infile = filesystem::ifstream(fileName);
     if (!infile.is_open()) {
         throw inviwo::Exception(fmt::format("Could not open file '{}'", fileName), IVW_CONTEXT);
     }
 
-    // VTK file header is always ASCII so we can just read the first line.
+    // VTK file header is always ASCII so we can just read the first line. XML files might start
+    // with an XML declaration, so the line of the VTKFile element is used if there is one.
     std::getline(infile, line);
-
     line = toLower(line);
+    if (line.find("<?xml") != std::string::npos && line.find("vtkfile") == std::string::npos) {
+        std::string next{};
+        std::getline(infile, next);
+        line += toLower(next);
+    }
 
     // "xml" is what should be in the header according to documentation, "vtkfile" is what Paraview
     // puts into their header...
     if ((line.find("xml") != std::string::npos) || (line.find("vtkfile") != std::string::npos)) {
-        if (line.find("\"P") != std::string::npos) {
+        if (line.find("type=\"p") != std::string::npos &&
+            line.find("type=\"polydata") == std::string::npos) {
             return VTKFileType::XML_Parallel;
         } else {
             return VTKFileType::XML_Serial;
@@ -0,0 +1,71 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vtk/processors/vtktomesh.h>
+#include <inviwo/vtk/util/vtkmeshutils.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkGeometryFilter.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <warn/pop>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo VTKToMesh::processorInfo_{
+    "org.inviwo.VTKToMesh",   // Class identifier
+    "VTK To Mesh",            // Display name
+    "VTK",                    // Category
+    CodeState::Experimental,  // Code state
+    Tags::CPU,                // Tags
+};
+const ProcessorInfo VTKToMesh::getProcessorInfo() const { return processorInfo_; }
+
+VTKToMesh::VTKToMesh() : Processor(), inport_("inport"), outport_("outport") {
+    addPort(inport_);
+    addPort(outport_);
+}
+
+void VTKToMesh::process() {
+    vtkSmartPointer<vtkDataSet> dataSet = **inport_.getData();
+
+    vtkSmartPointer<vtkPolyData> polyData = vtkPolyData::SafeDownCast(dataSet);
+    if (!polyData) {
+        auto geometry = vtkSmartPointer<vtkGeometryFilter>::New();
+        geometry->SetInputData(dataSet);
+        geometry->Update();
+        polyData = geometry->GetOutput();
+    }
+
+    outport_.setData(vtkutil::polyDataToMesh(*polyData));
+}
+
+}  // namespace inviwo
@@ -32,7 +32,8 @@
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/network/networklock.h>
 #include <inviwo/core/util/formats.h>
-#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/memorybudget/firsttouch.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -47,7 +48,9 @@
 #include <vtkImageData.h>
 #include <vtkType.h>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <inviwo/vtk/util/vtkutil.h>
 #include <fmt/format.h>
 
@@ -127,17 +130,20 @@ void VTKtoVolume::serialize(Serializer& s) const {
     s.serialize("selectedArrays", arraySelection);
 }
 
-void VTKtoVolume::VTKArrayList::addArray(const std::string& name, int numChannels, void* dataPtr) {
+void VTKtoVolume::VTKArrayList::addArray(const std::string& name, vtkDataArray* array) {
+    const int numChannels = array->GetNumberOfComponents();
     auto boolProp = new BoolProperty(name, name + " (" + std::to_string(numChannels) + ')', false);
     addProperty(boolProp);
     numArrayComponents.push_back(numChannels);
-    ptrArrayData.push_back(reinterpret_cast<unsigned char*>(dataPtr));
+    ptrArrayData.push_back(reinterpret_cast<unsigned char*>(array->GetVoidPointer(0)));
+    arrays.push_back(array);
 }
 
 void VTKtoVolume::VTKArrayList::clear() {
     while (size() > 0) removeProperty(size_t(0));
     numArrayComponents.clear();
     ptrArrayData.clear();
+    arrays.clear();
 }
 
 void VTKtoVolume::updateFormats() {
@@ -239,7 +245,7 @@ void VTKtoVolume::updateArrays() {
         int numComps = array->GetNumberOfComponents();
 
         numTotalComps += numComps;
-        dataArrays_.addArray(arrayName, numComps, array->GetVoidPointer(0));
+        dataArrays_.addArray(arrayName, array);
 
         // Set previous arrays to true if existing.
         BoolProperty* prop = dynamic_cast<BoolProperty*>(dataArrays_[dataArrays_.size() - 1]);
@@ -302,8 +308,9 @@ void VTKtoVolume::convertData() {
         for (size_t d = 0; d < 3; ++d) dimensions[d]--;
 
     struct RawArrayData {
-        unsigned char* ptr;
+        const unsigned char* ptr;
         size_t byteSize;
+        vtkDataArray* array;
     };
     std::vector<RawArrayData> arrayDataPointers;
 
@@ -314,8 +321,9 @@ void VTKtoVolume::convertData() {
     for (size_t p = 0; p < dataArrays_.size(); ++p) {
         BoolProperty* prop = dynamic_cast<BoolProperty*>(dataArrays_[p]);
         if (prop && prop->get()) {
-            arrayDataPointers.push_back(
-                {dataArrays_.ptrArrayData[p], dataArrays_.numArrayComponents[p] * sizeElement});
+            arrayDataPointers.push_back({dataArrays_.ptrArrayData[p],
+                                         dataArrays_.numArrayComponents[p] * sizeElement,
+                                         dataArrays_.arrays[p]});
             numTotalComps += dataArrays_.numArrayComponents[p];
         }
     }
@@ -381,28 +389,49 @@ void VTKtoVolume::convertData() {
     volume->setBasis(basis);
     volume->setOffset(offset);
 
-    // Create RAM volume
-    auto volRAM = createVolumeRAM(dimensions, multichannelFormat);
+    // Create RAM volume, its pages are first touched in parallel to spread them over NUMA nodes
+    auto volRAM = util::createVolumeRAMFirstTouch(dimensions, multichannelFormat);
     unsigned char* dataPtr = static_cast<unsigned char*>(volRAM->getData());
 
-    // Copy the data from the other volumes to the new multichannel volume
-    size_t numElements = dimensions.x * dimensions.y * dimensions.z;
-    for (size_t e = 0; e < numElements; e++) {
-        for (auto& arrayData : arrayDataPointers) {
-            memcpy(dataPtr, arrayData.ptr, arrayData.byteSize);
-            dataPtr += arrayData.byteSize;
-            arrayData.ptr += arrayData.byteSize;
+    // Copy the data from the selected arrays to the new multichannel volume, in parallel blocks
+    // of voxels. A single array is copied in bulk, several arrays are interleaved.
+    const size_t numElements = dimensions.x * dimensions.y * dimensions.z;
+    const size_t voxelBytes = multichannelFormat->getSize();
+    constexpr size_t blockSize = 1 << 16;
+    std::vector<size_t> blocks((numElements + blockSize - 1) / blockSize);
+    util::forEachParallel(blocks, [&](size_t, size_t block) {
+        const size_t begin = block * blockSize;
+        const size_t end = std::min(numElements, begin + blockSize);
+        if (arrayDataPointers.size() == 1) {
+            const auto& arrayData = arrayDataPointers.front();
+            std::copy(arrayData.ptr + begin * arrayData.byteSize,
+                      arrayData.ptr + end * arrayData.byteSize, dataPtr + begin * voxelBytes);
+            return;
         }
-    }
+        size_t channelOffset = 0;
+        for (const auto& arrayData : arrayDataPointers) {
+            const unsigned char* src = arrayData.ptr + begin * arrayData.byteSize;
+            unsigned char* dst = dataPtr + begin * voxelBytes + channelOffset;
+            for (size_t e = begin; e < end; ++e) {
+                std::copy(src, src + arrayData.byteSize, dst);
+                src += arrayData.byteSize;
+                dst += voxelBytes;
+            }
+            channelOffset += arrayData.byteSize;
+        }
+    });
 
     volume->addRepresentation(volRAM);
 
-    auto extent = util::volumeMinMax(volume.get());
-    double minVal = extent.first[0];
-    double maxVal = extent.second[0];
-    for (size_t d = 1; d < numTotalComps; ++d) {
-        minVal = std::min(extent.first[d], minVal);
-        maxVal = std::max(extent.second[d], maxVal);
+    // VTK caches the ranges of its arrays, no need for another pass over the volume
+    double minVal = std::numeric_limits<double>::max();
+    double maxVal = std::numeric_limits<double>::lowest();
+    for (const auto& arrayData : arrayDataPointers) {
+        for (int c = 0; c < arrayData.array->GetNumberOfComponents(); ++c) {
+            const auto range = arrayData.array->GetRange(c);
+            minVal = std::min(range[0], minVal);
+            maxVal = std::max(range[1], maxVal);
+        }
     }
 
     volume->dataMap_.valueRange = {minVal, maxVal};
@@ -42,14 +42,146 @@
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
-#include <vtkProbeFilter.h>
-#include <vtkCallbackCommand.h>
+#include <vtkCellData.h>
 #include <vtkCellTreeLocator.h>
+#include <vtkCharArray.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
 #include <vtkRectilinearGrid.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <warn/pop>
 
+#include <functional>
+#include <vector>
+
 namespace inviwo {
 
+namespace {
+
+vtkSmartPointer<vtkRectilinearGrid> createGrid(const double* bounds, const ivec3& gridSize) {
+    auto grid = vtkSmartPointer<vtkRectilinearGrid>::New();
+    grid->SetDimensions(gridSize.x, gridSize.y, gridSize.z);
+
+    auto coordinates = [&](int dim) {
+        auto coords = vtkSmartPointer<vtkDoubleArray>::New();
+        coords->SetNumberOfValues(gridSize[dim]);
+        const double range = std::abs(bounds[2 * dim] - bounds[2 * dim + 1]);
+        const double stepSize = gridSize[dim] > 1 ? range / (gridSize[dim] - 1) : 0.0;
+        for (int i = 0; i < gridSize[dim]; i++) {
+            coords->SetValue(i, bounds[2 * dim] + static_cast<double>(i) * stepSize);
+        }
+        return coords;
+    };
+    grid->SetXCoordinates(coordinates(0));
+    grid->SetYCoordinates(coordinates(1));
+    grid->SetZCoordinates(coordinates(2));
+    return grid;
+}
+
+/**
+ * Interpolates the point data and copies the cell data of \p source at the points of \p grid,
+ * like vtkProbeFilter, but with the prebuilt \p locator and processing the z slices of the grid
+ * in parallel through vtkSMPTools. Points outside of \p source are zero and marked invalid in
+ * the "vtkValidPointMask" array. Returns false if \p aborted returned true.
+ */
+bool probe(vtkDataSet* source, vtkAbstractCellLocator* locator, vtkRectilinearGrid* grid,
+           const std::function<bool()>& aborted, const std::function<void(float)>& progress) {
+    const vtkIdType numPoints = grid->GetNumberOfPoints();
+    int dims[3];
+    grid->GetDimensions(dims);
+    const vtkIdType sliceSize = static_cast<vtkIdType>(dims[0]) * dims[1];
+
+    struct Mapping {
+        vtkDataArray* src;
+        vtkDataArray* dst;
+    };
+    std::vector<Mapping> pointArrays;
+    std::vector<Mapping> cellArrays;
+    auto addArrays = [&](vtkDataSetAttributes* attributes, std::vector<Mapping>& mappings) {
+        for (int i = 0; i < attributes->GetNumberOfArrays(); ++i) {
+            auto src = attributes->GetArray(i);
+            if (!src || (src->GetName() && grid->GetPointData()->GetArray(src->GetName()))) {
+                continue;
+            }
+            auto dst = vtkSmartPointer<vtkDataArray>::Take(src->NewInstance());
+            dst->SetName(src->GetName());
+            dst->SetNumberOfComponents(src->GetNumberOfComponents());
+            dst->SetNumberOfTuples(numPoints);
+            grid->GetPointData()->AddArray(dst);
+            mappings.push_back({src, dst});
+        }
+    };
+    addArrays(source->GetPointData(), pointArrays);
+    addArrays(source->GetCellData(), cellArrays);
+
+    auto validMask = vtkSmartPointer<vtkCharArray>::New();
+    validMask->SetName("vtkValidPointMask");
+    validMask->SetNumberOfValues(numPoints);
+    grid->GetPointData()->AddArray(validMask);
+
+    const double tol = 1.0e-6 * source->GetLength();
+    const double tol2 = tol * tol;
+    const int maxCellSize = std::max(source->GetMaxCellSize(), 1);
+
+    vtkSMPThreadLocalObject<vtkGenericCell> cells;
+    std::atomic<vtkIdType> slicesDone{0};
+    std::atomic<bool> stopped{false};
+
+    auto probeSlices = [&](vtkIdType zBegin, vtkIdType zEnd) {
+        vtkGenericCell* cell = cells.Local();
+        std::vector<double> weights(maxCellSize);
+        double x[3];
+        double pcoords[3];
+        for (vtkIdType z = zBegin; z < zEnd; ++z) {
+            if (stopped || aborted()) {
+                stopped = true;
+                return;
+            }
+            for (vtkIdType i = z * sliceSize; i < (z + 1) * sliceSize; ++i) {
+                grid->GetPoint(i, x);
+                const vtkIdType cellId = locator->FindCell(x, tol2, cell, pcoords, weights.data());
+                validMask->SetValue(i, cellId >= 0 ? 1 : 0);
+                if (cellId < 0) {
+                    for (const auto& m : pointArrays) {
+                        for (int c = 0; c < m.dst->GetNumberOfComponents(); ++c) {
+                            m.dst->SetComponent(i, c, 0.0);
+                        }
+                    }
+                    for (const auto& m : cellArrays) {
+                        for (int c = 0; c < m.dst->GetNumberOfComponents(); ++c) {
+                            m.dst->SetComponent(i, c, 0.0);
+                        }
+                    }
+                    continue;
+                }
+
+                vtkIdList* pointIds = cell->PointIds;
+                for (const auto& m : pointArrays) {
+                    for (int c = 0; c < m.dst->GetNumberOfComponents(); ++c) {
+                        double value = 0.0;
+                        for (vtkIdType j = 0; j < pointIds->GetNumberOfIds(); ++j) {
+                            value += weights[j] * m.src->GetComponent(pointIds->GetId(j), c);
+                        }
+                        m.dst->SetComponent(i, c, value);
+                    }
+                }
+                for (const auto& m : cellArrays) {
+                    for (int c = 0; c < m.dst->GetNumberOfComponents(); ++c) {
+                        m.dst->SetComponent(i, c, m.src->GetComponent(cellId, c));
+                    }
+                }
+            }
+            progress(static_cast<float>(++slicesDone) / static_cast<float>(dims[2]));
+        }
+    };
+    vtkSMPTools::For(0, dims[2], probeSlices);
+
+    return !stopped;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo VTKUnstructuredGridToRectilinearGrid::processorInfo_{
     "org.inviwo.VTKUnstructuredGridToRectilinearGrid",  // Class identifier
@@ -66,12 +198,14 @@ VTKUnstructuredGridToRectilinearGrid::VTKUnstructuredGridToRectilinearGrid()
     : Processor()
     , ActivityIndicatorOwner()
     , maxDimension_("maxDimension", "Max output dimension", 32, 2, 2048)
+    , progressive_("progressive", "Progressive refinement", false)
     , button_("button", "Convert Data")
     , abortButton_("abortButton", "Abort Conversion", InvalidationLevel::Valid)
     , inport_("inport")
     , outport_("outport")
     , state_(std::make_shared<WorkerState>()) {
     addProperty(maxDimension_);
+    addProperty(progressive_);
     addProperty(button_);
     addProperty(abortButton_);
 
@@ -123,7 +257,7 @@ void VTKUnstructuredGridToRectilinearGrid::loadData() {
         return;
     }
 
-    auto unstructuredGrid = vtkUnstructuredGrid::SafeDownCast(grid);
+    vtkSmartPointer<vtkUnstructuredGrid> unstructuredGrid = vtkUnstructuredGrid::SafeDownCast(grid);
 
     auto bounds = unstructuredGrid->GetBounds();
 
@@ -141,7 +275,7 @@ void VTKUnstructuredGridToRectilinearGrid::loadData() {
 
     state_->dims_ = {xDim, yDim, zDim};
 
-    auto dispatch = [this, done, abort, unstructuredGrid,
+    auto dispatch = [this, done, abort, unstructuredGrid, progressive = progressive_.get(),
                      activityIndicator = &getActivityIndicator(),
                      state = state_]() mutable -> void {
         auto updateActivity = [activityIndicator, state](bool active) {
@@ -159,84 +293,70 @@ void VTKUnstructuredGridToRectilinearGrid::loadData() {
             return;
         }
 
-        const auto bounds = unstructuredGrid->GetBounds();
-        const auto gridSize = this->state_->dims_;
-        const auto gridBounds = dvec3(gridSize - ivec3(1));
-
-        vtkSmartPointer<vtkCallbackCommand> progressCallback =
-            vtkSmartPointer<vtkCallbackCommand>::New();
-        progressCallback->SetCallback(vtkProgressBarCallback);
-        progressCallback->SetClientData(&progressBar_);
-
-        auto pointSet = vtkSmartPointer<vtkRectilinearGrid>::New();
-        pointSet->SetDimensions(glm::value_ptr(gridSize));
-
-        auto xCoordinates = vtkSmartPointer<vtkDoubleArray>::New();
-        auto yCoordinates = vtkSmartPointer<vtkDoubleArray>::New();
-        auto zCoordinates = vtkSmartPointer<vtkDoubleArray>::New();
-
-        const auto xRange = std::abs(bounds[0] - bounds[1]);
-        const auto yRange = std::abs(bounds[2] - bounds[3]);
-        const auto zRange = std::abs(bounds[4] - bounds[5]);
-
-        const auto stepSize =
-            dvec3(xRange / gridBounds.x, yRange / gridBounds.y, zRange / gridBounds.z);
-
-        for (int z = 0; z < gridSize.z; z++) {
-            const auto zCoord = bounds[4] + static_cast<double>(z) * stepSize.z;
-            zCoordinates->InsertNextValue(zCoord);
+        // the locator only depends on the input, resampling at other resolutions reuses it
+        if (!state->locator_ || state->locatorDataSet_ != unstructuredGrid.GetPointer() ||
+            state->locatorMTime_ != unstructuredGrid->GetMTime()) {
+            auto locator = vtkSmartPointer<vtkCellTreeLocator>::New();
+            locator->SetDataSet(unstructuredGrid);
+            locator->BuildLocator();
+            state->locator_ = locator;
+            state->locatorDataSet_ = unstructuredGrid.GetPointer();
+            state->locatorMTime_ = unstructuredGrid->GetMTime();
         }
-        for (int y = 0; y < gridSize.y; y++) {
-            const auto yCoord = bounds[2] + static_cast<double>(y) * stepSize.y;
-            yCoordinates->InsertNextValue(yCoord);
-        }
-        for (int x = 0; x < gridSize.x; x++) {
-            const auto xCoord = bounds[0] + static_cast<double>(x) * stepSize.x;
-            xCoordinates->InsertNextValue(xCoord);
-        }
-
-        pointSet->SetXCoordinates(xCoordinates);
-        pointSet->SetYCoordinates(yCoordinates);
-        pointSet->SetZCoordinates(zCoordinates);
 
         if (this->state_->abortConversion_) {
             abort();
             return;
         }
 
-        vtkSmartPointer<vtkCellTreeLocator> cellLocator =
-            vtkSmartPointer<vtkCellTreeLocator>::New();
-        cellLocator->SetDataSet(pointSet);
-        cellLocator->BuildLocator();
-
-        if (this->state_->abortConversion_) {
-            abort();
-            return;
+        // coarse levels first in progressive mode, each one is output when done
+        std::vector<ivec3> levels;
+        if (progressive) {
+            for (int divisor : {8, 4, 2}) {
+                const auto dims = state->dims_ / divisor;
+                if (glm::all(glm::greaterThanEqual(dims, ivec3(2)))) levels.push_back(dims);
+            }
         }
+        levels.push_back(state->dims_);
+
+        const auto aborted = [state]() -> bool { return state->abortConversion_; };
+        for (size_t level = 0; level < levels.size(); ++level) {
+            auto lastUpdate = std::make_shared<std::atomic<float>>(0.0f);
+            const auto progress = [this, state, lastUpdate, level,
+                                   numLevels = levels.size()](float f) {
+                const float total = (static_cast<float>(level) + f) / numLevels;
+                // throttle the updates of the progress bar to percent steps
+                float last = lastUpdate->load();
+                if (total - last < 0.01f || !lastUpdate->compare_exchange_strong(last, total)) {
+                    return;
+                }
+                if (state->processorExists_) {
+                    dispatchFront([this, total]() {
+                        progressBar_.show();
+                        progressBar_.updateProgress(total);
+                    });
+                }
+            };
+
+            auto grid = createGrid(unstructuredGrid->GetBounds(), levels[level]);
+            if (!probe(unstructuredGrid, state->locator_, grid, aborted, progress)) {
+                abort();
+                return;
+            }
 
-        auto probeFilter = vtkSmartPointer<vtkProbeFilter>::New();
-        probeFilter->SetSourceData(unstructuredGrid);
-        probeFilter->SetCellLocatorPrototype(cellLocator);
-        probeFilter->SetInputData(pointSet);
-        probeFilter->AddObserver(vtkCommand::ProgressEvent, progressCallback);
-
-        probeFilter->Update();
-
-        if (this->state_->abortConversion_) {
-            abort();
-            return;
+            if (state->processorExists_) {
+                dispatchFront([this, grid, state]() {
+                    if (!state->processorExists_) return;
+                    dataSet_ = grid;
+                    data_ = std::make_shared<VTKDataSet>(dataSet_);
+                    outport_.setData(data_);
+                });
+            }
         }
 
-        dataSet_ = probeFilter->GetRectilinearGridOutput();
-
         done();
         updateActivity(false);
         this->state_->state = State::Done;
-
-        dispatchFront([this]() {
-            data_ = std::make_shared<VTKDataSet>(dataSet_);
-            outport_.setData(data_);
-        });
     };
 
     state_->state = State::NotStarted;
@@ -0,0 +1,264 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vtk/processors/vtkunstructuredgridtovolume.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/bufferobject.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/texture/texture3d.h>
+#include <modules/opengl/volume/volumegl.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkCellType.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t workGroupSize = 64;
+
+// Splits of the linear 3D cells into tetrahedra, as indices into the points of the cell
+constexpr std::array<std::array<int, 4>, 6> hexahedronSplit{{{0, 1, 2, 6},
+                                                             {0, 2, 3, 6},
+                                                             {0, 3, 7, 6},
+                                                             {0, 7, 4, 6},
+                                                             {0, 4, 5, 6},
+                                                             {0, 5, 1, 6}}};
+// vtkVoxel orders its points along x, y, and z instead of around the faces
+constexpr std::array<std::array<int, 4>, 6> voxelSplit{{{0, 1, 3, 7},
+                                                        {0, 3, 2, 7},
+                                                        {0, 2, 6, 7},
+                                                        {0, 6, 4, 7},
+                                                        {0, 4, 5, 7},
+                                                        {0, 5, 1, 7}}};
+constexpr std::array<std::array<int, 4>, 3> wedgeSplit{{{0, 1, 2, 3}, {1, 2, 3, 4}, {2, 3, 4, 5}}};
+constexpr std::array<std::array<int, 4>, 2> pyramidSplit{{{0, 1, 2, 4}, {0, 2, 3, 4}}};
+
+std::unique_ptr<BufferObject> makeBuffer(const void* data, size_t bytes) {
+    bytes = std::max<size_t>(bytes, sizeof(GLuint));
+    auto buffer = std::make_unique<BufferObject>(bytes, DataUInt32::get(), BufferUsage::Static,
+                                                 BufferTarget::Data);
+    buffer->initialize(data, bytes);
+    return buffer;
+}
+
+}  // namespace
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo VTKUnstructuredGridToVolume::processorInfo_{
+    "org.inviwo.VTKUnstructuredGridToVolume",  // Class identifier
+    "VTK Unstructured Grid To Volume",         // Display name
+    "VTK",                                     // Category
+    CodeState::Experimental,                   // Code state
+    Tags::GL,                                  // Tags
+};
+const ProcessorInfo VTKUnstructuredGridToVolume::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+VTKUnstructuredGridToVolume::VTKUnstructuredGridToVolume()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , pointArray_("pointArray", "Point array")
+    , component_("component", "Component", 0, 0, 0)
+    , maxDimension_("maxDimension", "Max output dimension", 128, 2, 2048)
+    , shader_({{ShaderType::Compute, "tetrahedrarasterization.comp"}}) {
+
+    addPort(inport_);
+    addPort(outport_);
+    addProperties(pointArray_, component_, maxDimension_);
+
+    inport_.onChange([this]() { updateArrays(); });
+    pointArray_.onChange([this]() { updateArrays(); });
+    component_.onChange([this]() { cellsDirty_ = true; });
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+}
+
+VTKUnstructuredGridToVolume::~VTKUnstructuredGridToVolume() = default;
+
+void VTKUnstructuredGridToVolume::updateArrays() {
+    cellsDirty_ = true;
+    if (!inport_.hasData()) return;
+
+    auto pointData = (*inport_.getData())->GetPointData();
+    std::vector<OptionPropertyOption<std::string>> options;
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
+        if (auto array = pointData->GetArray(i); array && array->GetName()) {
+            std::string identifier{array->GetName()};
+            replaceInString(identifier, ".", "");
+            replaceInString(identifier, " ", "");
+            options.emplace_back(identifier, array->GetName(), array->GetName());
+        }
+    }
+    pointArray_.replaceOptions(options);
+
+    const int numComponents =
+        pointArray_.size() > 0 && pointData->GetArray(pointArray_.get().c_str())
+            ? pointData->GetArray(pointArray_.get().c_str())->GetNumberOfComponents()
+            : 1;
+    component_.setMaxValue(numComponents - 1);
+}
+
+void VTKUnstructuredGridToVolume::uploadCells() {
+    auto grid = vtkUnstructuredGrid::SafeDownCast(**inport_.getData());
+    vtkDataArray* array = pointArray_.size() > 0
+                              ? grid->GetPointData()->GetArray(pointArray_.get().c_str())
+                              : nullptr;
+    const int component =
+        array ? std::min(component_.get(), array->GetNumberOfComponents() - 1) : 0;
+
+    // positions are stored relative to the lower bound to retain float precision
+    const auto bounds = grid->GetBounds();
+    const dvec3 lower{bounds[0], bounds[2], bounds[4]};
+
+    const vtkIdType numPoints = grid->GetNumberOfPoints();
+    std::vector<vec4> vertices(static_cast<size_t>(numPoints));
+    for (vtkIdType i = 0; i < numPoints; ++i) {
+        double p[3];
+        grid->GetPoint(i, p);
+        const double value = array ? array->GetComponent(i, component) : 0.0;
+        vertices[i] = vec4{vec3{dvec3{p[0], p[1], p[2]} - lower}, static_cast<float>(value)};
+    }
+    valueRange_ = array ? dvec2{array->GetRange(component)[0], array->GetRange(component)[1]}
+                        : dvec2{0.0, 1.0};
+
+    std::vector<uvec4> tetrahedra;
+    tetrahedra.reserve(static_cast<size_t>(grid->GetNumberOfCells()));
+    auto ids = vtkSmartPointer<vtkIdList>::New();
+    size_t skipped = 0;
+    auto split = [&](const auto& splits) {
+        for (const auto& t : splits) {
+            tetrahedra.emplace_back(ids->GetId(t[0]), ids->GetId(t[1]), ids->GetId(t[2]),
+                                    ids->GetId(t[3]));
+        }
+    };
+    for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i) {
+        grid->GetCellPoints(i, ids);
+        switch (grid->GetCellType(i)) {
+            case VTK_TETRA:
+                split(std::array<std::array<int, 4>, 1>{{{0, 1, 2, 3}}});
+                break;
+            case VTK_HEXAHEDRON:
+                split(hexahedronSplit);
+                break;
+            case VTK_VOXEL:
+                split(voxelSplit);
+                break;
+            case VTK_WEDGE:
+                split(wedgeSplit);
+                break;
+            case VTK_PYRAMID:
+                split(pyramidSplit);
+                break;
+            default:
+                ++skipped;
+        }
+    }
+    if (skipped > 0) {
+        LogWarn(fmt::format("Skipped {} cells that are not linear 3D cells", skipped));
+    }
+
+    vertices_ = makeBuffer(vertices.data(), vertices.size() * sizeof(vec4));
+    tetrahedra_ = makeBuffer(tetrahedra.data(), tetrahedra.size() * sizeof(uvec4));
+    numTetrahedra_ = tetrahedra.size();
+    cellsDirty_ = false;
+}
+
+void VTKUnstructuredGridToVolume::process() {
+    auto dataSet = **inport_.getData();
+    if (dataSet->GetDataObjectType() != VTK_UNSTRUCTURED_GRID) {
+        throw Exception(fmt::format("Input is not an unstructured grid but a {}",
+                                    dataSet->GetClassName()),
+                        IVW_CONTEXT);
+    }
+
+    if (cellsDirty_ || inport_.isChanged()) uploadCells();
+
+    const auto bounds = dataSet->GetBounds();
+    const dvec3 lower{bounds[0], bounds[2], bounds[4]};
+    const dvec3 extent = glm::max(dvec3{bounds[1], bounds[3], bounds[5]} - lower, dvec3{1.0e-6});
+    const double largest = glm::compMax(extent);
+    const size3_t dims{glm::max(dvec3{1.0}, glm::round(extent / largest *
+                                                       static_cast<double>(maxDimension_)))};
+
+    // the volume is reused as long as the resolution is unchanged
+    if (!volume_ || volume_->getDimensions() != dims) {
+        volume_ = std::make_shared<Volume>(std::make_shared<VolumeGL>(dims, DataFloat32::get()));
+    }
+    const vec3 ext{extent};
+    volume_->setBasis(
+        mat3(vec3(ext.x, 0.0f, 0.0f), vec3(0.0f, ext.y, 0.0f), vec3(0.0f, 0.0f, ext.z)));
+    volume_->setOffset(vec3{lower});
+    // voxels outside of the grid are zero
+    const dvec2 range{std::min(valueRange_.x, 0.0), std::max(valueRange_.y, 0.0)};
+    volume_->dataMap_.dataRange = range;
+    volume_->dataMap_.valueRange = range;
+
+    auto texture = volume_->getEditableRepresentation<VolumeGL>()->getTexture();
+    const float zero = 0.0f;
+    glClearTexImage(texture->getID(), 0, GL_RED, GL_FLOAT, &zero);
+
+    shader_.activate();
+    shader_.setUniform("dimensions", ivec3{dims});
+    shader_.setUniform("voxelSize", vec3{extent / dvec3{dims}});
+    shader_.setUniform("numTetrahedra", static_cast<int>(numTetrahedra_));
+
+    glBindImageTexture(0, texture->getID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R32F);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertices_->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, tetrahedra_->getId());
+
+    const auto numWorkGroups = (numTetrahedra_ + workGroupSize - 1) / workGroupSize;
+    utilgl::dispatchChunked(shader_, numWorkGroups, "offset", workGroupSize);
+    shader_.deactivate();
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    LGL_ERROR;
+
+    outport_.setData(volume_);
+}
+
+}  // namespace inviwo
@@ -29,9 +29,341 @@
 
 #include <inviwo/vtk/processors/vtkwriter.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkExtractPolyDataPiece.h>
+#include <vtkExtractUnstructuredGridPiece.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+#include <vtkPolyData.h>
+#include <vtkRectilinearGrid.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkXMLDataSetWriter.h>
+#include <vtkXMLImageDataWriter.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <vtkXMLRectilinearGridWriter.h>
+#include <vtkXMLStructuredDataWriter.h>
+#include <vtkXMLStructuredGridWriter.h>
+#include <vtkXMLUnstructuredGridWriter.h>
+#include <warn/pop>
+
+#include <array>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
 
 namespace inviwo {
 
+namespace {
+
+struct WriteSettings {
+    VTKWriter::Compression compression;
+    int compressionLevel;
+};
+
+void configure(vtkXMLWriter& writer, const WriteSettings& settings) {
+    writer.SetDataModeToAppended();
+    writer.EncodeAppendedDataOff();
+    switch (settings.compression) {
+        case VTKWriter::Compression::None:
+            writer.SetCompressorTypeToNone();
+            break;
+        case VTKWriter::Compression::ZLib:
+            writer.SetCompressorTypeToZLib();
+            break;
+        case VTKWriter::Compression::LZ4:
+            writer.SetCompressorTypeToLZ4();
+            break;
+    }
+    writer.SetCompressionLevel(settings.compressionLevel);
+}
+
+std::string fileEnding(int dataObjectType) {
+    switch (dataObjectType) {
+        case VTK_STRUCTURED_GRID:
+            return "vts";
+        case VTK_IMAGE_DATA:
+            return "vti";
+        case VTK_POLY_DATA:
+            return "vtp";
+        case VTK_RECTILINEAR_GRID:
+            return "vtr";
+        case VTK_UNSTRUCTURED_GRID:
+            return "vtu";
+        default:
+            return "vtk";
+    }
+}
+
+std::string xmlTypeName(int dataType) {
+    switch (dataType) {
+        case VTK_CHAR:
+        case VTK_SIGNED_CHAR:
+            return "Int8";
+        case VTK_UNSIGNED_CHAR:
+            return "UInt8";
+        case VTK_SHORT:
+            return "Int16";
+        case VTK_UNSIGNED_SHORT:
+            return "UInt16";
+        case VTK_INT:
+            return "Int32";
+        case VTK_UNSIGNED_INT:
+            return "UInt32";
+        case VTK_LONG:
+        case VTK_LONG_LONG:
+        case VTK_ID_TYPE:
+            return sizeof(vtkIdType) == 4 && dataType == VTK_ID_TYPE ? "Int32" : "Int64";
+        case VTK_UNSIGNED_LONG:
+        case VTK_UNSIGNED_LONG_LONG:
+            return "UInt64";
+        case VTK_FLOAT:
+            return "Float32";
+        default:
+            return "Float64";
+    }
+}
+
+std::string arrayDeclaration(vtkDataArray* array, const std::string& indent) {
+    return fmt::format("{}<PDataArray type=\"{}\"{} NumberOfComponents=\"{}\"/>\n", indent,
+                       xmlTypeName(array->GetDataType()),
+                       array->GetName() ? fmt::format(" Name=\"{}\"", array->GetName()) : "",
+                       array->GetNumberOfComponents());
+}
+
+std::string attributesDeclaration(vtkDataSetAttributes* attributes, const std::string& tag) {
+    std::string xml = fmt::format("    <{}>\n", tag);
+    for (int i = 0; i < attributes->GetNumberOfArrays(); ++i) {
+        if (auto array = attributes->GetArray(i)) xml += arrayDeclaration(array, "      ");
+    }
+    return xml + fmt::format("    </{}>\n", tag);
+}
+
+std::string extentString(const int* e) {
+    return fmt::format("{} {} {} {} {} {}", e[0], e[1], e[2], e[3], e[4], e[5]);
+}
+
+std::string summaryType(int dataObjectType) {
+    switch (dataObjectType) {
+        case VTK_IMAGE_DATA:
+            return "PImageData";
+        case VTK_RECTILINEAR_GRID:
+            return "PRectilinearGrid";
+        case VTK_STRUCTURED_GRID:
+            return "PStructuredGrid";
+        case VTK_POLY_DATA:
+            return "PPolyData";
+        default:
+            return "PUnstructuredGrid";
+    }
+}
+
+/**
+ * Splits the extent into slabs along z, neighboring slabs share one layer of points as in the
+ * pieces written by VTK.
+ */
+std::vector<std::array<int, 6>> slabs(const int* extent, int pieces) {
+    const int layers = extent[5] - extent[4];
+    pieces = std::max(1, std::min(pieces, layers));
+    std::vector<std::array<int, 6>> result;
+    for (int i = 0; i < pieces; ++i) {
+        result.push_back({extent[0], extent[1], extent[2], extent[3],
+                          extent[4] + layers * i / pieces, extent[4] + layers * (i + 1) / pieces});
+    }
+    return result;
+}
+
+/**
+ * Writes the partitioned summary file referencing the pieces, which are given relative to the
+ * summary file. \p extents is empty for unstructured data.
+ */
+void writeSummary(const std::string& path, vtkDataSet* dataSet,
+                  const std::vector<std::string>& pieces,
+                  const std::vector<std::array<int, 6>>& extents) {
+    const auto type = summaryType(dataSet->GetDataObjectType());
+
+    std::string attributes{" GhostLevel=\"0\""};
+    if (!extents.empty()) {
+        int whole[6] = {0, 0, 0, 0, 0, 0};
+        if (auto image = vtkImageData::SafeDownCast(dataSet)) {
+            image->GetExtent(whole);
+        } else if (auto rectilinear = vtkRectilinearGrid::SafeDownCast(dataSet)) {
+            rectilinear->GetExtent(whole);
+        } else if (auto structured = vtkStructuredGrid::SafeDownCast(dataSet)) {
+            structured->GetExtent(whole);
+        }
+        attributes = fmt::format(" WholeExtent=\"{}\"{}", extentString(whole), attributes);
+        if (auto image = vtkImageData::SafeDownCast(dataSet)) {
+            const double* o = image->GetOrigin();
+            const double* s = image->GetSpacing();
+            attributes += fmt::format(" Origin=\"{} {} {}\" Spacing=\"{} {} {}\"", o[0], o[1],
+                                      o[2], s[0], s[1], s[2]);
+        }
+    }
+
+    std::string xml = "<?xml version=\"1.0\"?>\n";
+#ifdef VTK_WORDS_BIGENDIAN
+    const std::string byteOrder = "BigEndian";
+#else
+    const std::string byteOrder = "LittleEndian";
+#endif
+    xml += fmt::format("<VTKFile type=\"{}\" version=\"0.1\" byte_order=\"{}\">\n", type,
+                       byteOrder);
+    xml += fmt::format("  <{}{}>\n", type, attributes);
+    xml += attributesDeclaration(dataSet->GetPointData(), "PPointData");
+    xml += attributesDeclaration(dataSet->GetCellData(), "PCellData");
+    if (auto pointSet = vtkPointSet::SafeDownCast(dataSet); pointSet && pointSet->GetPoints()) {
+        xml += "    <PPoints>\n" + arrayDeclaration(pointSet->GetPoints()->GetData(), "      ") +
+               "    </PPoints>\n";
+    } else if (auto rectilinear = vtkRectilinearGrid::SafeDownCast(dataSet)) {
+        xml += "    <PCoordinates>\n";
+        for (auto coords : {rectilinear->GetXCoordinates(), rectilinear->GetYCoordinates(),
+                            rectilinear->GetZCoordinates()}) {
+            xml += arrayDeclaration(coords, "      ");
+        }
+        xml += "    </PCoordinates>\n";
+    }
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        xml += extents.empty()
+                   ? fmt::format("    <Piece Source=\"{}\"/>\n", pieces[i])
+                   : fmt::format("    <Piece Extent=\"{}\" Source=\"{}\"/>\n",
+                                 extentString(extents[i].data()), pieces[i]);
+    }
+    xml += fmt::format("  </{}>\n</VTKFile>\n", type);
+
+    auto file = filesystem::ofstream(path);
+    if (!file) {
+        throw FileException(fmt::format("Could not open '{}'", path),
+                            IVW_CONTEXT_CUSTOM("VTKWriter"));
+    }
+    file << xml;
+}
+
+template <typename Writer>
+void writeFile(vtkDataSet* dataSet, const std::string& path, const WriteSettings& settings,
+               const int* extent = nullptr) {
+    auto writer = vtkSmartPointer<Writer>::New();
+    configure(*writer, settings);
+    writer->SetInputData(dataSet);
+    if constexpr (std::is_base_of_v<vtkXMLStructuredDataWriter, Writer>) {
+        if (extent) writer->SetWriteExtent(const_cast<int*>(extent));
+    }
+    writer->SetFileName(path.c_str());
+    if (!writer->Write()) {
+        throw FileException(fmt::format("Could not write '{}'", path),
+                            IVW_CONTEXT_CUSTOM("VTKWriter"));
+    }
+}
+
+template <typename Writer>
+void writeSlab(vtkDataSet* dataSet, const std::string& path, const WriteSettings& settings,
+               const int* extent) {
+    // every writer gets its own shallow copy, the pipeline information of the input is not
+    // thread safe
+    auto copy = vtkSmartPointer<vtkDataSet>::Take(dataSet->NewInstance());
+    copy->ShallowCopy(dataSet);
+    writeFile<Writer>(copy, path, settings, extent);
+}
+
+template <typename Extract, typename Writer>
+void writeCellRange(vtkDataSet* dataSet, const std::string& path, const WriteSettings& settings,
+                    int piece, int pieces) {
+    auto copy = vtkSmartPointer<vtkDataSet>::Take(dataSet->NewInstance());
+    copy->ShallowCopy(dataSet);
+    // without ghost information the cells are assigned to pieces by ranges of cell ids
+    auto extract = vtkSmartPointer<Extract>::New();
+    extract->SetInputData(copy);
+    extract->UpdatePiece(piece, pieces, 0);
+    writeFile<Writer>(vtkDataSet::SafeDownCast(extract->GetOutputDataObject(0)), path, settings);
+}
+
+/**
+ * Writes the data set as pieces in parallel along with the summary file, returns the path of the
+ * summary file. Progress is reported in finished pieces.
+ */
+std::string writePieces(vtkDataSet* dataSet, const std::string& path, int pieces,
+                        const WriteSettings& settings,
+                        const std::function<void(float)>& progress) {
+    const auto type = dataSet->GetDataObjectType();
+    const auto ending = fileEnding(type);
+    const auto stem = filesystem::getFileNameWithoutExtension(path);
+    const auto dir = filesystem::getFileDirectory(path);
+
+    std::vector<std::array<int, 6>> extents;
+    if (auto image = vtkImageData::SafeDownCast(dataSet)) {
+        extents = slabs(image->GetExtent(), pieces);
+    } else if (auto rectilinear = vtkRectilinearGrid::SafeDownCast(dataSet)) {
+        extents = slabs(rectilinear->GetExtent(), pieces);
+    } else if (auto structured = vtkStructuredGrid::SafeDownCast(dataSet)) {
+        extents = slabs(structured->GetExtent(), pieces);
+    }
+    if (!extents.empty()) pieces = static_cast<int>(extents.size());
+
+    std::vector<std::string> names(pieces);
+    for (int i = 0; i < pieces; ++i) names[i] = fmt::format("{}_{}.{}", stem, i, ending);
+
+    std::vector<std::exception_ptr> errors(pieces);
+    std::atomic<int> done{0};
+    vtkSMPTools::For(0, static_cast<vtkIdType>(pieces), [&](vtkIdType begin, vtkIdType end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto file = dir + "/" + names[i];
+            try {
+                switch (type) {
+                    case VTK_IMAGE_DATA:
+                        writeSlab<vtkXMLImageDataWriter>(dataSet, file, settings,
+                                                         extents[i].data());
+                        break;
+                    case VTK_RECTILINEAR_GRID:
+                        writeSlab<vtkXMLRectilinearGridWriter>(dataSet, file, settings,
+                                                               extents[i].data());
+                        break;
+                    case VTK_STRUCTURED_GRID:
+                        writeSlab<vtkXMLStructuredGridWriter>(dataSet, file, settings,
+                                                              extents[i].data());
+                        break;
+                    case VTK_POLY_DATA:
+                        writeCellRange<vtkExtractPolyDataPiece, vtkXMLPolyDataWriter>(
+                            dataSet, file, settings, static_cast<int>(i), pieces);
+                        break;
+                    default:
+                        writeCellRange<vtkExtractUnstructuredGridPiece,
+                                       vtkXMLUnstructuredGridWriter>(
+                            dataSet, file, settings, static_cast<int>(i), pieces);
+                        break;
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+            progress(static_cast<float>(++done) / static_cast<float>(pieces));
+        }
+    });
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    const auto summary = fmt::format("{}/{}.p{}", dir, stem, ending);
+    writeSummary(summary, dataSet, names, extents);
+    return summary;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo VTKWriter::processorInfo_{
     "org.inviwo.VTKWriter",   // Class identifier
@@ -44,59 +376,95 @@ const ProcessorInfo VTKWriter::getProcessorInfo() const { return processorInfo_;
 
 VTKWriter::VTKWriter()
     : Processor()
+    , ProgressBarOwner()
+    , ActivityIndicatorOwner()
     , inport_("inport")
-    , writer_(vtkSmartPointer<vtkXMLDataSetWriter>::New())
     , file_("file", "File name", "", "vtk")
-    , button_("button", "Export") {
+    , compression_("compression", "Compression",
+                   {{"none", "None", Compression::None},
+                    {"zlib", "ZLib", Compression::ZLib},
+                    {"lz4", "LZ4", Compression::LZ4}},
+                   1, InvalidationLevel::Valid)
+    , compressionLevel_("compressionLevel", "Compression level", 5, 1, 9, 1,
+                        InvalidationLevel::Valid)
+    , pieces_("pieces", "Pieces", 1, 1, 256, 1, InvalidationLevel::Valid)
+    , button_("button", "Export")
+    , processorExists_(std::make_shared<std::atomic<bool>>(true)) {
     addPort(inport_);
 
     addProperty(file_);
     file_.setAcceptMode(AcceptMode::Save);
 
+    addProperties(compression_, compressionLevel_, pieces_);
+
     addProperty(button_);
     button_.onChange([this]() { this->export_isacppkeyword(); });
+
+    progressBar_.hide();
 }
 
+VTKWriter::~VTKWriter() { *processorExists_ = false; }
+
 void VTKWriter::process() {}
 
 void VTKWriter::export_isacppkeyword() {
     if (!inport_.hasData()) return;
 
-    auto dataSet = *inport_.getData();
+    // keeps the data set alive while it is written
+    auto data = inport_.getData();
+    vtkDataSet* dataSet = **data;
 
     if (file_.get().empty()) file_.requestFile();
+    if (file_.get().empty()) return;
+
+    const std::string vtkConvention =
+        filesystem::replaceFileExtension(file_.get(), fileEnding(dataSet->GetDataObjectType()));
+    const WriteSettings settings{compression_.get(), compressionLevel_.get()};
+    const int pieces = pieces_.get();
 
-    std::string ending{};
-
-    if (!file_.get().empty()) {
-        switch (dataSet->GetDataObjectType()) {
-            case VTK_STRUCTURED_GRID:
-                ending = "vts";
-                break;
-            case VTK_IMAGE_DATA:
-                ending = "vti";
-                break;
-            case VTK_POLY_DATA:
-                ending = "vtp";
-                break;
-            case VTK_RECTILINEAR_GRID:
-                ending = "vtr";
-                break;
-            case VTK_UNSTRUCTURED_GRID:
-                ending = "vtu";
-                break;
-            default:
-                ending = "vtk";
-                break;
+    getActivityIndicator().setActive(true);
+    dispatchPool([this, data, dataSet, vtkConvention, settings, pieces,
+                  exists = processorExists_]() {
+        const auto progress = [this, exists](float f) {
+            if (!*exists) return;
+            dispatchFront([this, exists, f]() {
+                if (!*exists) return;
+                progressBar_.show();
+                progressBar_.updateProgress(f);
+            });
+        };
+
+        std::string message;
+        bool failed = false;
+        try {
+            // pieces are only supported for the data types with an XML format of their own
+            if (pieces > 1 && fileEnding(dataSet->GetDataObjectType()) != "vtk") {
+                message = "File written to " +
+                          writePieces(dataSet, vtkConvention, pieces, settings, progress);
+            } else {
+                writeFile<vtkXMLDataSetWriter>(dataSet, vtkConvention, settings);
+                message = "File written to " + vtkConvention;
+            }
+        } catch (const Exception& e) {
+            message = e.getMessage();
+            failed = true;
+        } catch (const std::exception& e) {
+            message = e.what();
+            failed = true;
         }
 
-        std::string vtkConvention = filesystem::replaceFileExtension(file_.get(), ending);
-        // write
-        writer_->SetInputData(*dataSet);
-        writer_->SetFileName(vtkConvention.c_str());
-        writer_->Write();
-        LogProcessorInfo("File written to " << vtkConvention);
-    }
+        if (!*exists) return;
+        dispatchFront([this, exists, message, failed]() {
+            if (!*exists) return;
+            progressBar_.hide();
+            getActivityIndicator().setActive(false);
+            if (failed) {
+                LogProcessorError(message);
+            } else {
+                LogProcessorInfo(message);
+            }
+        });
+    });
 }
 
 }  // namespace inviwo
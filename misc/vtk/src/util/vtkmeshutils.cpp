@@ -0,0 +1,251 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/vtk/util/vtkmeshutils.h>
+
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkVersion.h>
+#include <warn/pop>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+
+namespace vtkutil {
+
+namespace {
+
+template <typename Func>
+void parallelFor(size_t count, Func func) {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(count), [&](vtkIdType begin, vtkIdType end) {
+        for (auto i = begin; i < end; ++i) func(static_cast<size_t>(i));
+    });
+}
+
+std::vector<vec3> toVec3(vtkDataArray* array) {
+    std::vector<vec3> result(static_cast<size_t>(array->GetNumberOfTuples()));
+    if (array->GetDataType() == VTK_FLOAT && array->GetNumberOfComponents() == 3 &&
+        array->HasStandardMemoryLayout()) {
+        std::memcpy(result.data(), array->GetVoidPointer(0), result.size() * sizeof(vec3));
+    } else {
+        parallelFor(result.size(), [&](size_t i) {
+            const auto t = static_cast<vtkIdType>(i);
+            result[i] = vec3{array->GetComponent(t, 0), array->GetComponent(t, 1),
+                             array->GetComponent(t, 2)};
+        });
+    }
+    return result;
+}
+
+/**
+ * Calls \p func with the offsets and connectivity of the cells, where the points of cell i are
+ * connectivity[offsets[i]] to connectivity[offsets[i + 1]].
+ */
+template <typename Func>
+void visitCells(vtkCellArray& cells, Func func) {
+#if VTK_MAJOR_VERSION >= 9
+    if (cells.IsStorage64Bit()) {
+        func(cells.GetOffsetsArray64()->GetPointer(0),
+             cells.GetConnectivityArray64()->GetPointer(0));
+    } else {
+        func(cells.GetOffsetsArray32()->GetPointer(0),
+             cells.GetConnectivityArray32()->GetPointer(0));
+    }
+#else
+    // the legacy layout stores the number of points before the points of each cell
+    const vtkIdType* legacy = cells.GetPointer();
+    std::vector<vtkIdType> offsets{0};
+    std::vector<vtkIdType> connectivity;
+    connectivity.reserve(cells.GetNumberOfConnectivityEntries());
+    for (vtkIdType i = 0, pos = 0; i < cells.GetNumberOfCells(); ++i) {
+        const auto n = legacy[pos];
+        connectivity.insert(connectivity.end(), legacy + pos + 1, legacy + pos + 1 + n);
+        offsets.push_back(offsets.back() + n);
+        pos += n + 1;
+    }
+    func(offsets.data(), connectivity.data());
+#endif
+}
+
+/**
+ * Splits the cells into primitives of \p N indices. \p count returns the number of primitives
+ * of a cell of n points, \p emit writes primitive j of a cell.
+ */
+template <size_t N, typename Count, typename Emit>
+std::vector<std::uint32_t> split(vtkCellArray& cells, Count count, Emit emit) {
+    std::vector<std::uint32_t> indices;
+    visitCells(cells, [&](const auto* offsets, const auto* connectivity) {
+        const auto numCells = static_cast<size_t>(cells.GetNumberOfCells());
+        std::vector<size_t> first(numCells + 1, 0);
+        for (size_t i = 0; i < numCells; ++i) {
+            first[i + 1] = first[i] + count(static_cast<size_t>(offsets[i + 1] - offsets[i]));
+        }
+        indices.resize(first.back() * N);
+        parallelFor(numCells, [&](size_t i) {
+            const auto* points = connectivity + offsets[i];
+            for (size_t j = 0; j < first[i + 1] - first[i]; ++j) {
+                emit(points, j, &indices[(first[i] + j) * N]);
+            }
+        });
+    });
+    return indices;
+}
+
+std::vector<std::uint32_t> copyConnectivity(vtkCellArray& cells) {
+    std::vector<std::uint32_t> indices;
+    visitCells(cells, [&](const auto* offsets, const auto* connectivity) {
+        using Index = std::remove_cv_t<std::remove_pointer_t<decltype(connectivity)>>;
+        indices.resize(static_cast<size_t>(offsets[cells.GetNumberOfCells()]));
+        if constexpr (sizeof(Index) == sizeof(std::uint32_t)) {
+            std::memcpy(indices.data(), connectivity, indices.size() * sizeof(std::uint32_t));
+        } else {
+            parallelFor(indices.size(), [&](size_t i) {
+                indices[i] = static_cast<std::uint32_t>(connectivity[i]);
+            });
+        }
+    });
+    return indices;
+}
+
+bool allCellsOfSize(vtkCellArray& cells, vtkIdType size) {
+#if VTK_MAJOR_VERSION >= 9
+    const vtkIdType numIds = cells.GetNumberOfConnectivityIds();
+#else
+    const vtkIdType numIds = cells.GetNumberOfConnectivityEntries() - cells.GetNumberOfCells();
+#endif
+    return numIds == size * cells.GetNumberOfCells() && cells.GetMaxCellSize() == size;
+}
+
+bool isIdentity(const std::vector<std::uint32_t>& indices, size_t numPoints) {
+    if (indices.size() != numPoints) return false;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] != i) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::shared_ptr<Mesh> polyDataToMesh(vtkPolyData& polyData) {
+    const auto numPoints = static_cast<size_t>(polyData.GetNumberOfPoints());
+
+    std::vector<std::uint32_t> verts;
+    if (polyData.GetNumberOfVerts() > 0) verts = copyConnectivity(*polyData.GetVerts());
+    const bool pointCloud = isIdentity(verts, numPoints);
+
+    auto mesh = pointCloud ? std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None)
+                           : std::make_shared<Mesh>();
+
+    if (numPoints > 0) {
+        mesh->addBuffer(BufferType::PositionAttrib,
+                        util::makeBuffer(toVec3(polyData.GetPoints()->GetData())));
+    }
+    if (auto normals = polyData.GetPointData()->GetNormals()) {
+        mesh->addBuffer(BufferType::NormalAttrib, util::makeBuffer(toVec3(normals)));
+    }
+    if (auto scalars = polyData.GetPointData()->GetScalars();
+        scalars && scalars->GetDataType() == VTK_UNSIGNED_CHAR &&
+        (scalars->GetNumberOfComponents() == 3 || scalars->GetNumberOfComponents() == 4)) {
+        std::vector<vec4> colors(numPoints, vec4{1.0f});
+        const int numComponents = scalars->GetNumberOfComponents();
+        const auto* data = static_cast<const unsigned char*>(scalars->GetVoidPointer(0));
+        parallelFor(numPoints, [&](size_t i) {
+            for (int c = 0; c < numComponents; ++c) {
+                colors[i][c] = static_cast<float>(data[i * numComponents + c]) / 255.0f;
+            }
+        });
+        mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
+    }
+
+    if (!verts.empty() && !pointCloud) {
+        mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
+                         util::makeIndexBuffer(std::move(verts)));
+    }
+
+    if (polyData.GetNumberOfLines() > 0) {
+        auto segments = split<2>(
+            *polyData.GetLines(), [](size_t n) { return n > 1 ? n - 1 : 0; },
+            [](const auto* points, size_t j, std::uint32_t* out) {
+                out[0] = static_cast<std::uint32_t>(points[j]);
+                out[1] = static_cast<std::uint32_t>(points[j + 1]);
+            });
+        mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                         util::makeIndexBuffer(std::move(segments)));
+    }
+
+    if (polyData.GetNumberOfPolys() > 0) {
+        auto& polys = *polyData.GetPolys();
+        // triangle meshes have the same layout as the index buffer
+        auto triangles =
+            allCellsOfSize(polys, 3)
+                ? copyConnectivity(polys)
+                : split<3>(
+                      polys, [](size_t n) { return n > 2 ? n - 2 : 0; },
+                      [](const auto* points, size_t j, std::uint32_t* out) {
+                          out[0] = static_cast<std::uint32_t>(points[0]);
+                          out[1] = static_cast<std::uint32_t>(points[j + 1]);
+                          out[2] = static_cast<std::uint32_t>(points[j + 2]);
+                      });
+        mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                         util::makeIndexBuffer(std::move(triangles)));
+    }
+
+    if (polyData.GetNumberOfStrips() > 0) {
+        auto triangles = split<3>(
+            *polyData.GetStrips(), [](size_t n) { return n > 2 ? n - 2 : 0; },
+            [](const auto* points, size_t j, std::uint32_t* out) {
+                // every other triangle of a strip is flipped to keep the orientation
+                const size_t odd = j % 2;
+                out[0] = static_cast<std::uint32_t>(points[j + odd]);
+                out[1] = static_cast<std::uint32_t>(points[j + 1 - odd]);
+                out[2] = static_cast<std::uint32_t>(points[j + 2]);
+            });
+        mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                         util::makeIndexBuffer(std::move(triangles)));
+    }
+
+    return mesh;
+}
+
+}  // namespace vtkutil
+
+}  // namespace inviwo
@@ -38,10 +38,14 @@
 
 #include <inviwo/vtk/ports/vtkdatasetport.h>
 #include <inviwo/vtk/processors/vtkdatasetinformation.h>
+#include <inviwo/vtk/processors/vtkflyingedges.h>
 #include <inviwo/vtk/processors/vtkreader.h>
+#include <inviwo/vtk/processors/vtktomesh.h>
 #include <inviwo/vtk/processors/vtktovolume.h>
 #include <inviwo/vtk/processors/vtkunstructuredgridtorectilineargrid.h>
+#include <inviwo/vtk/processors/vtkunstructuredgridtovolume.h>
 #include <inviwo/vtk/processors/vtkwriter.h>
+#include <modules/opengl/shader/shadermanager.h>
 
 namespace inviwo {
 
@@ -50,10 +54,15 @@ VTKModule::VTKModule(InviwoApplication* app)
 
     LogInfo("VTK Version: " << vtkVersion::GetVTKVersion());
 
+    ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
+
     registerProcessor<VTKDataSetInformation>();
+    registerProcessor<VTKFlyingEdges>();
     registerProcessor<VTKReader>();
+    registerProcessor<VTKToMesh>();
     registerProcessor<VTKtoVolume>();
     registerProcessor<VTKUnstructuredGridToRectilinearGrid>();
+    registerProcessor<VTKUnstructuredGridToVolume>();
     registerProcessor<VTKWriter>();
 
     registerPort<VTKDataSetInport>();
@@ -2,6 +2,9 @@
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
 	InviwoBaseModule
+	InviwoDataFrameModule
+    InviwoMemoryBudgetModule
+    InviwoUtilitiesModule
 )
 
 # Add an alias for this module. Several modules can share an alias. 
@@ -0,0 +1,176 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+class MolecularStructure;
+
+/**
+ * \brief per-atom boolean mask of a molecular structure, stored as a bitset
+ *
+ * Bit `i` corresponds to atom `i` of the structure. Bits are packed into 64 bit words, bits beyond
+ * size() are always zero.
+ */
+class IVW_MODULE_MOLVISBASE_API AtomMask {
+public:
+    explicit AtomMask(size_t size = 0, bool value = false);
+
+    size_t size() const;
+    /// @return number of set bits
+    size_t count() const;
+    bool any() const;
+    bool none() const;
+    bool all() const;
+
+    bool test(size_t i) const;
+    void set(size_t i, bool value = true);
+
+    /// @return indices of all set bits in ascending order
+    std::vector<uint32_t> indices() const;
+
+    /**
+     * Call \p callback(i) for each set bit in ascending order.
+     */
+    template <typename Callback>
+    void forEachSet(Callback callback) const;
+
+    AtomMask& operator&=(const AtomMask& rhs);
+    AtomMask& operator|=(const AtomMask& rhs);
+    /// flip all bits
+    AtomMask& flip();
+
+    bool operator==(const AtomMask& rhs) const;
+    bool operator!=(const AtomMask& rhs) const;
+
+    std::vector<uint64_t>& words();
+    const std::vector<uint64_t>& words() const;
+
+    static constexpr size_t bitsPerWord = 64;
+
+private:
+    void clearPadding();
+
+    size_t size_;
+    std::vector<uint64_t> words_;
+};
+
+template <typename Callback>
+void AtomMask::forEachSet(Callback callback) const {
+    for (size_t w = 0; w < words_.size(); ++w) {
+        size_t i = w * bitsPerWord;
+        for (uint64_t word = words_[w]; word != 0; word >>= 1, ++i) {
+            if (word & 1u) callback(i);
+        }
+    }
+}
+
+namespace detail {
+struct SelectionNode;
+}  // namespace detail
+
+/**
+ * \brief atom selection query compiled into predicates over the atom columns
+ *
+ * The query language follows VMD and PyMOL, for example `chain A and within 5 of resname HEM`.
+ * Each predicate of a query is evaluated for all atoms at once, column by column, and the results
+ * are combined with bitwise operations on AtomMask.
+ *
+ * Predicates
+ *   * `all`, `none`
+ *   * `index i...`    atom indices, starting at 0
+ *   * `serial s...`   serial numbers of the atoms
+ *   * `name n...`     full atom names, e.g. `name CA CB`
+ *   * `element e...`  element symbols, e.g. `element C N O`
+ *   * `resid r...`    residue IDs
+ *   * `resname r...`  residue names, e.g. `resname ALA HEM`
+ *   * `chain c...`    chain names
+ *   * `model m...`    model IDs
+ *   * `beta op x`     B factors compared by `<`, `<=`, `>`, `>=`, `==`, or `!=`
+ *   * `protein`, `backbone`, `sidechain`, `water`, `hydrogen`
+ *
+ * Integer values can be given as ranges `10-20` or `10 to 20`, both inclusive. Names are matched
+ * case insensitive.
+ *
+ * Operators, from highest to lowest precedence
+ *   * `( ... )`
+ *   * `not x`, `within d of x`, `same residue as x`, which apply to the following predicate or
+ *     parenthesized expression
+ *   * `x and y`
+ *   * `x or y`
+ *
+ * `within d of x` selects all atoms closer than `d` Ångström to any atom of `x`, including the
+ * atoms of `x`, and uses the atom grid of the structure for the neighborhood queries.
+ *
+ * \see MolecularStructure::getAtomGrid
+ */
+class IVW_MODULE_MOLVISBASE_API AtomSelection {
+public:
+    /**
+     * Compile \p query.
+     *
+     * @throws Exception if \p query is not a valid selection
+     */
+    explicit AtomSelection(std::string_view query);
+
+    const std::string& getQuery() const;
+
+    /**
+     * Evaluate the selection for all atoms of structure \p s. Predicates referring to information
+     * not available in \p s, e.g. residue names without any residues, select no atoms.
+     */
+    AtomMask evaluate(const MolecularStructure& s) const;
+
+private:
+    std::string query_;
+    std::shared_ptr<const detail::SelectionNode> root_;
+};
+
+/**
+ * Convenience function for compiling \p query and evaluating it for structure \p s.
+ *
+ * @throws Exception if \p query is not a valid selection
+ * \see AtomSelection
+ */
+IVW_MODULE_MOLVISBASE_API AtomMask selectAtoms(const MolecularStructure& s, std::string_view query);
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,84 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+class MolecularStructure;
+
+/**
+ * \brief pair of atoms closer than a cutoff distance
+ */
+struct AtomContact {
+    size_t atom1;  //!< atom index, always smaller than atom2
+    size_t atom2;
+    double distance;
+};
+
+/**
+ * \brief pair of residues with atoms closer than a cutoff distance
+ */
+struct ResidueContact {
+    size_t residue1;  //!< index into MolecularStructure::residues(), smaller than residue2
+    size_t residue2;
+    double distance;  //!< minimum distance between the atoms of both residues
+};
+
+/**
+ * Find all pairs of atoms of structure \p s closer than \p cutoff Ångström. The neighborhoods are
+ * queried in parallel using the atom grid of \p s, which also handles cutoffs larger than its cell
+ * size. Covalently bonded atoms are included.
+ *
+ * @return contacts ordered by their first atom
+ * \see MolecularStructure::getAtomGrid
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<AtomContact> computeAtomContacts(const MolecularStructure& s,
+                                                                       double cutoff);
+
+/**
+ * Find all pairs of residues of structure \p s with atoms closer than \p cutoff Ångström, i.e.
+ * the contact map of the residues. Contacts within a residue are ignored. Residues closer than
+ * \p minSeparation along the sequence of the same chain are skipped, e.g. 1 omits the trivial
+ * contacts between consecutive residues.
+ *
+ * @return contacts ordered by their first and second residue, empty if \p s has no residues
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<ResidueContact> computeResidueContacts(
+    const MolecularStructure& s, double cutoff, size_t minSeparation = 0);
+
+}  // namespace molvis
+
+}  // namespace inviwo
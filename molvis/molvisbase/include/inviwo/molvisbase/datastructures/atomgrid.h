@@ -0,0 +1,144 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+
+#include <inviwo/core/util/glm.h>
+
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief uniform grid of atom positions for neighborhood queries
+ *
+ * The grid encloses all atoms with a margin of 1Å. Atoms are sorted by cell with a counting sort
+ * and stored as a compressed cell list, i.e. the atoms of cell `c` are found in the range
+ * `[cellOffsets()[c], cellOffsets()[c + 1])` of atomIndices() and positions(). Within a cell,
+ * atoms keep their original order.
+ *
+ * Trajectory frames update the grid of the previous frame instead of creating a new one, see
+ * AtomGrid(const AtomGrid&, const std::vector<dvec3>&).
+ *
+ * \see MolecularStructure::getAtomGrid
+ */
+class IVW_MODULE_MOLVISBASE_API AtomGrid {
+public:
+    /**
+     * Create a grid for \p positions with cells of at least \p cellSize in each dimension.
+     */
+    AtomGrid(const std::vector<dvec3>& positions, double cellSize);
+    /**
+     * Create a grid for the moved atoms \p positions, reusing the bounds and cells of \p grid.
+     * If no atom changed its cell, the cell list of \p grid is kept and only the sorted positions
+     * are updated. A new grid is created if an atom left the bounds of \p grid or the number of
+     * atoms differs.
+     */
+    AtomGrid(const AtomGrid& grid, const std::vector<dvec3>& positions);
+
+    double getCellSize() const;
+    const size3_t& getDimensions() const;
+    /// @return position of the lower corner of the grid
+    const dvec3& getOrigin() const;
+    /// @return extent of a single cell, at least getCellSize() in each dimension
+    const dvec3& getCellExtent() const;
+
+    /// @return grid coordinate of the cell containing \p pos, clamped to the grid
+    size3_t cellCoord(const dvec3& pos) const;
+    /// @return linear index of the cell at grid coordinate \p coord
+    size_t cellIndex(const size3_t& coord) const;
+    /// start of the atoms within each cell, has one additional element holding the atom count
+    const std::vector<size_t>& cellOffsets() const;
+    /// original atom indices sorted by cell
+    const std::vector<size_t>& atomIndices() const;
+    /// atom positions sorted by cell
+    const std::vector<dvec3>& positions() const;
+
+    /**
+     * Call \p callback(atomIndex, position) for all atoms within distance \p radius of \p pos.
+     * Atoms are visited cell by cell.
+     */
+    template <typename Callback>
+    void forEachAtomWithin(const dvec3& pos, double radius, Callback callback) const;
+
+    /**
+     * @return original indices of all atoms within distance \p radius of \p pos in ascending
+     *         order
+     */
+    std::vector<size_t> atomsWithin(const dvec3& pos, double radius) const;
+
+    /**
+     * Find the \p k atoms closest to \p pos. Cells are visited in growing shells around \p pos
+     * until no unvisited cell can contain a closer atom.
+     *
+     * @return original indices of at most \p k atoms, sorted by increasing distance
+     */
+    std::vector<size_t> nearestAtoms(const dvec3& pos, size_t k) const;
+
+private:
+    // bin the atoms into cells, requires the grid geometry
+    void sortAtoms(const std::vector<dvec3>& positions);
+    bool contains(const dvec3& pos) const;
+
+    double cellSize_;
+    dvec3 min_;
+    size3_t dims_;
+    dvec3 cellExt_;
+    std::vector<size_t> cellOffsets_;
+    std::vector<size_t> atomIndices_;
+    std::vector<dvec3> positions_;
+};
+
+template <typename Callback>
+void AtomGrid::forEachAtomWithin(const dvec3& pos, double radius, Callback callback) const {
+    const auto minCell = cellCoord(pos - radius);
+    const auto maxCell = cellCoord(pos + radius);
+    const double radiusSq = radius * radius;
+
+    for (size_t z = minCell.z; z <= maxCell.z; ++z) {
+        for (size_t y = minCell.y; y <= maxCell.y; ++y) {
+            for (size_t x = minCell.x; x <= maxCell.x; ++x) {
+                const auto cell = cellIndex(size3_t{x, y, z});
+                for (size_t i = cellOffsets_[cell]; i < cellOffsets_[cell + 1]; ++i) {
+                    if (glm::distance2(pos, positions_[i]) < radiusSq) {
+                        callback(atomIndices_[i], positions_[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -30,12 +30,16 @@
 
 #include <inviwo/molvisbase/molvisbasemoduledefine.h>
 #include <inviwo/core/util/glmvec.h>
+#include <inviwo/core/util/glmmat.h>
 #include <inviwo/core/util/hashcombine.h>
 
 #include <inviwo/molvisbase/util/atomicelement.h>
 #include <inviwo/molvisbase/util/aminoacid.h>
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
+#include <inviwo/molvisbase/util/span.h>
 
 #include <optional>
+#include <memory>
 #include <iostream>
 #include <unordered_map>
 #include <string_view>
@@ -111,6 +115,10 @@ using Bond = std::pair<size_t, size_t>;
  * in turn contain individual atoms. This data structure assumes that only atoms refer to residues
  * and chains via IDs. The hierarchical information is extracted in and used by MolecularStructure.
  *
+ * Biological assemblies like capsids or fibrils consist of many copies of one asymmetric unit.
+ * Instead of duplicating the atoms, the asymmetric unit is stored once along with the transforms
+ * placing each copy. Without instance transforms, the atoms are used as is.
+ *
  * \see MolecularStructure
  */
 struct IVW_MODULE_MOLVISBASE_API MolecularData {
@@ -120,6 +128,7 @@ struct IVW_MODULE_MOLVISBASE_API MolecularData {
     std::vector<Residue> residues;
     std::vector<Chain> chains;
     std::vector<Bond> bonds;
+    std::vector<dmat4> instances;  //!< transforms of the copies of the atoms, applied to positions
 };
 
 /// residue's ID and chain ID for unique identification
@@ -200,12 +209,18 @@ struct fmt::formatter<inviwo::molvis::PeptideType> : fmt::formatter<std::string_
 namespace inviwo {
 namespace molvis {
 
+namespace detail {
+struct InternalState;
+}  // namespace detail
+
 /**
  * \brief a data structure holding molecular data and its acceleration structures
  *
  * A MolecularStructure holds and provides access to the hierarchical information of molecular data,
  * i.e. chains, residues, and atoms, if existing. Acceleration structures are used for faster
- * lookups of, e.g. querying all atoms in a particular residue.
+ * lookups of, e.g. querying all atoms in a particular residue. The atoms of all residues and
+ * the residues of all chains are stored in flat index arrays, one contiguous range per residue and
+ * chain, which are built in parallel.
  *
  * Note: acceleration structures can only be created if the molecular data provides information on
  * residues or both residues and chains.
@@ -250,11 +265,26 @@ public:
      * Performs some basic sanity checks like ID consistency, equal size of atom attributes
      * (positions, IDs, atomic numbers, etc.) and builds acceleration structures.
      *
+     * @param data   molecular data
+     * @param grid   atom grid of the atom positions in \p data, e.g. the one used to compute the
+     *               bonds. A new grid is created if nullptr.
      * @throws Exception if atoms refer to invalid residues/chains, an atom's chain ID mismatches
      *         the chain ID of the residue, or if attributes stored in atom have different sizes
      *         (empty attributes are ignored).
      */
-    MolecularStructure(MolecularData data);
+    MolecularStructure(MolecularData data, std::shared_ptr<const AtomGrid> grid = nullptr);
+    /**
+     * \brief create a frame of a trajectory with the topology of \p topology
+     *
+     * Only the atom positions differ from \p topology. Residue and chain lookups are shared with
+     * \p topology instead of being rebuilt, only the dihedral angles of the backbone segments are
+     * computed from \p positions. The atom grid of \p topology is updated with \p positions, see
+     * AtomGrid(const AtomGrid&, const std::vector<dvec3>&).
+     *
+     * @throws Exception if the number of positions does not match the number of atoms
+     * \see sharesTopology
+     */
+    MolecularStructure(const MolecularStructure& topology, std::vector<dvec3> positions);
     MolecularStructure() = delete;
     ~MolecularStructure() = default;
 
@@ -263,6 +293,15 @@ public:
     const std::vector<Residue>& residues() const;
     const std::vector<Chain>& chains() const;
     const std::vector<Bond>& bonds() const;
+    /**
+     * returns the transforms of the instances of the atoms, empty if there is only a single
+     * instance at the atom positions
+     */
+    const std::vector<dmat4>& instances() const;
+    /**
+     * returns the number of instances of the atoms, at least one
+     */
+    size_t getNumberOfInstances() const;
 
     /**
      * get the global index of an atom. Both \p fullAtomName, \p residueId, and \p chainId
@@ -285,18 +324,19 @@ public:
     /**
      * query a residue matching \p residueId and \p chainId for its atoms.
      *
-     * @return list of atom indices which belong to the residue
+     * @return atom indices which belong to the residue in ascending order. The span refers to the
+     *         acceleration structures shared by all trajectory frames of this structure.
      * @throws Exception if residue does not exist
      */
-    const std::vector<size_t>& getResidueAtoms(int residueId, int chainId) const;
+    Span<size_t> getResidueAtoms(int residueId, int chainId) const;
 
     /**
      * query a chain matching \p chainId for its residues.
      *
-     * @return list of residue indices which belong to the chain
+     * @return residue indices which belong to the chain in ascending order
      * @throws Exception if chain does not exist
      */
-    const std::vector<size_t>& getChainResidues(int chainId) const;
+    Span<size_t> getChainResidues(int chainId) const;
 
     /**
      * query a chain matching \p chainId for its backbone segments.
@@ -315,6 +355,15 @@ public:
      */
     const std::vector<size_t>& getResidueIndices() const;
 
+    /**
+     * returns an index for each residue referring to its parent chain. Together with
+     * getResidueIndices() this maps atoms to their chains without locating the chain by ID. The
+     * returned list might be empty if residue and chain information is not available.
+     *
+     * @return list of per-residue chain indices
+     */
+    const std::vector<size_t>& getResidueChainIndices() const;
+
     /**
      * returns an index for each atom referring to its parent backbone segment. This provides faster
      * access to backbone segments through indexing instead of locating a matching backbone by
@@ -325,22 +374,41 @@ public:
      */
     const std::vector<size_t>& getBackboneSegmentIndices() const;
 
+    /**
+     * returns a uniform grid of the atom positions for neighborhood queries. The cell size is the
+     * maximum covalent bond length used by computeCovalentBonds(), unless a different grid was
+     * given on construction.
+     *
+     * \see AtomGrid
+     */
+    const AtomGrid& getAtomGrid() const;
+
+    /**
+     * returns the minimum and maximum corner of the axis-aligned bounds of all atoms including
+     * their van der Waals radii. The bounds enclose all instances of the atoms and are computed
+     * once on construction. Both corners are zero if there are no atoms.
+     *
+     * \see boundingBox
+     */
+    const std::pair<dvec3, dvec3>& getBounds() const;
+
+    /**
+     * returns true if \p other was created from this structure, or vice versa, using the
+     * trajectory frame constructor, i.e. both refer to the same atoms, residues, chains, and bonds
+     * and only the atom positions might differ.
+     */
+    bool sharesTopology(const MolecularStructure& other) const;
+
 private:
     MolecularData data_;
 
-    // mapping chain IDs to a list of global residue indices
-    std::unordered_map<int, std::vector<size_t>> chainResidues_;
-    // mapping residue IDs to a list of global atom indices
-    std::unordered_map<ResidueID, std::vector<size_t>> residueAtoms_;
-    // mapping residue IDs to global residue indices
-    std::unordered_map<ResidueID, size_t> residueIndices_;
-    // residue index of each atom
-    std::vector<size_t> atomResidueIndices_;
-
+    // acceleration structures independent of the atom positions, shared by trajectory frames
+    std::shared_ptr<const detail::InternalState> state_;
     // mapping chain IDs to a list of backbone segments
     std::unordered_map<int, std::vector<BackboneSegment>> chainSegments_;
-    // backbone segment index of each atom
-    std::vector<size_t> chainSegmentIndices_;
+
+    std::shared_ptr<const AtomGrid> atomGrid_;
+    std::pair<dvec3, dvec3> bounds_;
 };
 
 }  // namespace molvis
@@ -0,0 +1,142 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/util/dispatcher.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief molecular dynamics trajectory with frames that are loaded on demand
+ *
+ * The topology, i.e. atoms, residues, chains, and bonds, is given by a single MolecularStructure.
+ * A loader function, in general a trajectory file reader, provides the atom positions of each
+ * frame. Frames share the acceleration structures of the topology, see
+ * MolecularStructure::sharesTopology.
+ *
+ * Requesting a frame schedules loading it and the next prefetch frames, wrapping around at the
+ * end of the trajectory, on the thread pool. At most cacheSize frames are kept in memory, and no
+ * more than the allowance of the trajectory in the global MemoryBudget, evicting the least recently
+ * used frames first. Other caches of the budget can ask the trajectory to free memory as well. The
+ * requested frame and its prefetch window are never evicted.
+ *
+ * All functions are thread safe. The loader is called from the worker threads.
+ */
+class IVW_MODULE_MOLVISBASE_API MolecularTrajectory {
+public:
+    using Loader = std::function<std::vector<dvec3>(size_t frame)>;
+    using Callback = std::function<void(size_t frame)>;
+
+    MolecularTrajectory(std::shared_ptr<const MolecularStructure> topology, size_t numFrames,
+                        Loader loader, size_t prefetch = 4, size_t cacheSize = 16);
+    MolecularTrajectory(const MolecularTrajectory&) = delete;
+    MolecularTrajectory& operator=(const MolecularTrajectory&) = delete;
+    ~MolecularTrajectory() = default;
+
+    size_t size() const;
+    const std::shared_ptr<const MolecularStructure>& getTopology() const;
+
+    /*
+     * Returns the frame, waits for it if it is not loaded yet. Rethrows loader exceptions.
+     */
+    std::shared_ptr<const MolecularStructure> get(size_t frame) const;
+    /*
+     * Returns the frame if it is loaded and nullptr otherwise, never waits for the loader.
+     * Rethrows loader exceptions.
+     */
+    std::shared_ptr<const MolecularStructure> tryGet(size_t frame) const;
+    // Schedules loading of the frame and its prefetch window
+    void prefetch(size_t frame) const;
+    bool isLoaded(size_t frame) const;
+
+    void setPrefetch(size_t prefetch);
+    size_t getPrefetch() const;
+    // Maximum number of frames kept in memory, at least the prefetch window is kept
+    void setCacheSize(size_t frames);
+    size_t getCacheSize() const;
+
+    /*
+     * The callback is called from the worker thread when a frame has been loaded. It is removed
+     * when the returned handle is destroyed.
+     */
+    std::shared_ptr<Callback> onLoaded(Callback callback) const;
+
+private:
+    struct Frame {
+        std::shared_future<std::shared_ptr<const MolecularStructure>> structure;
+        bool loaded = false;
+        size_t bytes = 0;
+        size_t lastUse = 0;
+    };
+
+    // Shared with the loading tasks, which might outlive the trajectory
+    struct State {
+        std::shared_ptr<const MolecularStructure> topology;
+        Loader loader;
+        size_t numFrames;
+        size_t prefetch;
+        size_t cacheSize;
+
+        std::mutex mutex;
+        std::map<size_t, Frame> frames;
+        size_t current = 0;
+        size_t useCounter = 0;
+        size_t memoryUsage = 0;
+        std::unique_ptr<MemoryBudget::Registration> registration;
+
+        std::mutex callbackMutex;
+        Dispatcher<void(size_t)> loaded;
+
+        Frame& request(size_t frame, const std::shared_ptr<State>& self);
+        bool inWindow(size_t frame) const;
+        void evict();
+        void evictTo(size_t bytes);
+    };
+
+    std::shared_future<std::shared_ptr<const MolecularStructure>> use(size_t frame) const;
+
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,66 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/io/datareader.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+
+#include <string>
+
+namespace inviwo {
+
+/**
+ * \ingroup dataio
+ *
+ * Basic reader for macromolecular Crystallographic Information Files (mmCIF/PDBx). Will only
+ * interpret the loop of the _atom_site category, with one atom per line. Unlike PDB files, mmCIF
+ * files are not limited to 99,999 atoms and chain names can consist of several characters.
+ * Author-provided chain names and residue sequence numbers are used if present.
+ *
+ * \see https://mmcif.wwpdb.org/dictionaries/mmcif_pdbx_v50.dic/Categories/atom_site.html
+ */
+class IVW_MODULE_MOLVISBASE_API BasicMMCIFReader
+    : public DataReaderType<molvis::MolecularStructure> {
+public:
+    BasicMMCIFReader();
+    BasicMMCIFReader(const BasicMMCIFReader&) = default;
+    BasicMMCIFReader(BasicMMCIFReader&&) noexcept = default;
+    BasicMMCIFReader& operator=(const BasicMMCIFReader&) = default;
+    BasicMMCIFReader& operator=(BasicMMCIFReader&&) noexcept = default;
+    virtual BasicMMCIFReader* clone() const override;
+    virtual ~BasicMMCIFReader() = default;
+    using DataReaderType<molvis::MolecularStructure>::readData;
+
+    virtual std::shared_ptr<molvis::MolecularStructure> readData(
+        const std::string& fileName) override;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,85 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/util/glmvec.h>
+
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief random access to the frames of a DCD trajectory file (CHARMM, NAMD, X-PLOR)
+ *
+ * The header is parsed on construction. Frames are located by their offset, which is constant
+ * since all frames have the same size. The number of frames is determined from the file size
+ * since the frame count in the header is not reliable for files still being written.
+ * Little and big endian files are supported, trajectories with fixed atoms are not.
+ *
+ * readFrame() opens its own file stream and can be called concurrently.
+ */
+class IVW_MODULE_MOLVISBASE_API DCDFile {
+public:
+    /**
+     * @throws FileException if the file cannot be opened
+     * @throws DataReaderException if the header is invalid or unsupported
+     */
+    explicit DCDFile(const std::string& fileName);
+
+    const std::string& getFileName() const;
+    size_t getNumberOfFrames() const;
+    size_t getNumberOfAtoms() const;
+
+    /**
+     * Read the atom positions of \p frame in Å.
+     *
+     * @throws RangeException if \p frame is out of range
+     * @throws DataReaderException if the frame cannot be read
+     */
+    std::vector<dvec3> readFrame(size_t frame) const;
+
+private:
+    std::string fileName_;
+    bool swapBytes_;
+    bool hasUnitCell_;
+    bool has4D_;
+    size_t numAtoms_;
+    size_t numFrames_;
+    size_t headerSize_;
+    size_t frameSize_;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,136 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <charconv>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief registers chains and residues while a reader appends atoms to MolecularData
+ *
+ * Atoms of the same residue and chain are usually stored consecutively in structure files. The
+ * most recent chain and residue are therefore checked first, before falling back to a hash
+ * lookup. This keeps the registration constant time per atom, unlike findChain() and
+ * findResidue() which are linear in the number of chains and residues.
+ *
+ * Single letter chain names use the IDs of ChainId. Longer chain names, as found in mmCIF files,
+ * are assigned consecutive IDs following those.
+ */
+class IVW_MODULE_MOLVISBASE_API MolecularDataBuilder {
+public:
+    explicit MolecularDataBuilder(MolecularData& data);
+
+    /**
+     * Register chain \p chainName in the molecular data unless it already exists.
+     *
+     * @return ID of the chain
+     */
+    int addChain(std::string_view chainName);
+    /**
+     * Register residue \p residueId of chain \p chainId in the molecular data unless it already
+     * exists.
+     */
+    void addResidue(int residueId, std::string_view residueName, int chainId);
+
+private:
+    MolecularData& data_;
+    std::unordered_map<std::string, int> chains_;
+    std::unordered_set<ResidueID> residues_;
+    std::optional<std::string> lastChainName_;
+    int lastChainId_;
+    std::optional<ResidueID> lastResidue_;
+    int nextChainId_;
+};
+
+namespace detail {
+
+namespace config {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+constexpr bool charconv = true;
+#else
+constexpr bool charconv = false;
+#endif
+}  // namespace config
+
+/**
+ * Parse the trimmed \p value into \p dest. Numbers are parsed with std::from_chars, if
+ * available, and thus without allocations.
+ *
+ * @return false if \p value is not a valid number
+ */
+template <class T>
+bool fromStr(std::string_view value, T& dest, bool parseHexadecimal = false) {
+    std::string_view trimmed = util::trim(value);
+    if constexpr (std::is_same_v<std::string, T>) {
+        dest = std::string(trimmed);
+    } else if constexpr (config::charconv &&
+                         (std::is_same_v<double, T> || std::is_same_v<float, T>)) {
+        const auto end = trimmed.data() + trimmed.size();
+        if (auto [p, ec] = std::from_chars(trimmed.data(), end, dest);
+            ec != std::errc() || p != end) {
+            return false;
+        }
+    } else if constexpr (config::charconv && (std::is_integral_v<T> && !std::is_same_v<bool, T>)) {
+        const auto end = trimmed.data() + trimmed.size();
+        const int base = parseHexadecimal ? 16 : 10;
+        if (auto [p, ec] = std::from_chars(trimmed.data(), end, dest, base);
+            ec != std::errc() || p != end) {
+            return false;
+        }
+    } else {
+        std::istringstream stream{std::string{trimmed}};
+        if (std::is_integral_v<T> && parseHexadecimal) {
+            stream >> std::hex;
+        }
+        stream >> dest;
+    }
+    return true;
+}
+
+}  // namespace detail
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace inviwo {
+
+class InviwoApplication;
+
+namespace molvis {
+
+class MolecularStructure;
+
+/**
+ * \brief module wide cache of parsed molecular structures
+ *
+ * Structures are identified by their file path and the modification time of the file, a modified
+ * file is therefore never served from the cache. The cached structures include their acceleration
+ * structures, i.e. the atom grid and the residue and chain lookups, so reopening a workspace or
+ * switching between files does not parse or build anything again.
+ *
+ * At most capacity structures are kept, evicting the least recently used ones first. The cache is
+ * not thread safe and meant to be used from the main thread.
+ */
+class IVW_MODULE_MOLVISBASE_API StructureCache {
+public:
+    explicit StructureCache(size_t capacity = 8);
+    StructureCache(const StructureCache&) = delete;
+    StructureCache& operator=(const StructureCache&) = delete;
+
+    /**
+     * Return the structure read from \p file, or nullptr if it is not cached or the file was
+     * modified since, i.e. \p modified does not match.
+     */
+    std::shared_ptr<const MolecularStructure> get(const std::string& file, std::time_t modified);
+    /**
+     * Cache \p structure read from \p file with modification time \p modified, replacing a
+     * previous structure of the same file.
+     */
+    void put(const std::string& file, std::time_t modified,
+             std::shared_ptr<const MolecularStructure> structure);
+
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+    size_t size() const;
+    void clear();
+
+private:
+    struct Entry {
+        std::time_t modified;
+        std::shared_ptr<const MolecularStructure> structure;
+        size_t lastUse = 0;
+    };
+    void evict(size_t capacity);
+
+    size_t capacity_;
+    size_t useCounter_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+/**
+ * Return the structure cache of the MolVisBase module.
+ */
+IVW_MODULE_MOLVISBASE_API StructureCache& getStructureCache(InviwoApplication* app);
+IVW_MODULE_MOLVISBASE_API StructureCache& getStructureCache();
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -30,6 +30,7 @@
 
 #include <inviwo/molvisbase/molvisbasemoduledefine.h>
 #include <inviwo/core/common/inviwomodule.h>
+#include <inviwo/molvisbase/io/structurecache.h>
 
 namespace inviwo {
 
@@ -37,6 +38,11 @@ class IVW_MODULE_MOLVISBASE_API MolVisBaseModule : public InviwoModule {
 public:
     MolVisBaseModule(InviwoApplication* app);
     virtual ~MolVisBaseModule() = default;
+
+    molvis::StructureCache& getStructureCache();
+
+private:
+    molvis::StructureCache structures_;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,84 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+
+#include <inviwo/molvisbase/ports/molecularstructureport.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.molvis.MolecularContactMap, Molecular Contact Map}
+ * ![](org.inviwo.molvis.MolecularContactMap.png?classIdentifier=org.inviwo.molvis.MolecularContactMap)
+ * Lists all pairs of atoms or residues closer than a cutoff distance. The neighborhoods are
+ * queried in parallel with the atom grid of the structure, see molvis::computeAtomContacts and
+ * molvis::computeResidueContacts.
+ *
+ * ### Inports
+ *   * __inport__  molecular structure
+ *
+ * ### Outports
+ *   * __outport__ one row per contact. Atom contacts have the columns Atom 1, Atom 2, and
+ *                 Distance. Residue contacts have the columns Residue 1, Chain 1, Residue 2,
+ *                 Chain 2, and Distance, where Distance is the smallest distance between their
+ *                 atoms.
+ *
+ * ### Properties
+ *   * __Level__            contacts between atoms or between residues
+ *   * __Cutoff__           maximum distance of a contact in Ångström
+ *   * __Min. Separation__  residues of the same chain closer than this along the sequence are
+ *                          not considered to be in contact
+ */
+class IVW_MODULE_MOLVISBASE_API MolecularContactMap : public Processor {
+public:
+    MolecularContactMap();
+    virtual ~MolecularContactMap() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    enum class Level { Atoms, Residues };
+
+    molvis::MolecularStructureInport inport_;
+    DataFrameOutport outport_;
+
+    TemplateOptionProperty<Level> level_;
+    DoubleProperty cutoff_;
+    IntSizeTProperty minSeparation_;
+};
+
+}  // namespace inviwo
@@ -30,31 +30,48 @@
 #pragma once
 
 #include <inviwo/molvisbase/molvisbasemoduledefine.h>
-#include <inviwo/core/processors/processor.h>
-#include <modules/base/processors/datasource.h>
+#include <inviwo/core/processors/poolprocessor.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/fileproperty.h>
 
 #include <inviwo/molvisbase/ports/molecularstructureport.h>
 
 namespace inviwo {
 
-/** \docpage{org.inviwo.MolecularStructureSource, MolecularStructureSource}
+class InviwoApplication;
+
+/** \docpage{org.inviwo.MolecularStructureSource, MolecularStructure Source}
  * ![](org.inviwo.MolecularStructureSource.png?classIdentifier=org.inviwo.MolecularStructureSource)
  * Loads a molecular structures/atoms and creates a MolecularStructure object.
  *
+ * The file is read on the thread pool. Parsed structures are kept in a module wide cache, see
+ * molvis::StructureCache, which makes reopening a workspace or switching between files instant as
+ * long as the files have not been modified.
+ *
  * ### Outports
- *   * __outport__  molecular structure
+ *   * __data__  molecular structure
  *
  * ### Properties
  *   * __File name__ File to load.
+ *   * __Reload data__ Read the file again, bypassing the cache.
  */
-class IVW_MODULE_MOLVISBASE_API MolecularStructureSource
-    : public DataSource<molvis::MolecularStructure, molvis::MolecularStructureOutport> {
+class IVW_MODULE_MOLVISBASE_API MolecularStructureSource : public PoolProcessor {
 public:
     MolecularStructureSource(InviwoApplication* app, const std::string& file = "");
     virtual ~MolecularStructureSource() = default;
 
+    virtual void process() override;
+
     virtual const ProcessorInfo getProcessorInfo() const override;
     static const ProcessorInfo processorInfo_;
+
+private:
+    InviwoApplication* app_;
+    molvis::MolecularStructureOutport outport_;
+    FileProperty file_;
+    ButtonProperty reload_;
+    // set by the reload button, the next load ignores the cache
+    bool bypassCache_ = false;
 };
 
 }  // namespace inviwo
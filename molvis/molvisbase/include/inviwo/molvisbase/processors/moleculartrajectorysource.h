@@ -0,0 +1,92 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+
+#include <inviwo/molvisbase/ports/molecularstructureport.h>
+#include <inviwo/molvisbase/datastructures/moleculartrajectory.h>
+
+#include <atomic>
+#include <limits>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.MolecularTrajectorySource, Molecular Trajectory Source}
+ * ![](org.inviwo.MolecularTrajectorySource.png?classIdentifier=org.inviwo.MolecularTrajectorySource)
+ * Plays a molecular dynamics trajectory stored in a DCD file. The input structure provides the
+ * topology, the trajectory only the atom positions of each frame. Frames are read on demand in
+ * background threads, see molvis::MolecularTrajectory. All frames share the residue and chain
+ * lookups of the topology, which lets renderers update only the atom positions.
+ *
+ * ### Inports
+ *   * __inport__  molecular structure with the same atoms as the trajectory
+ *
+ * ### Outports
+ *   * __outport__  molecular structure of the selected frame
+ *
+ * ### Properties
+ *   * __Trajectory__ DCD file to load.
+ *   * __Frame__ Selected frame of the trajectory.
+ *   * __Prefetched frames__ Number of frames read ahead of the selected frame.
+ *   * __Cached frames__ Number of frames kept in memory.
+ *   * __Wait for frame__ Wait until the selected frame is loaded instead of keeping the previous
+ *     frame until then.
+ */
+class IVW_MODULE_MOLVISBASE_API MolecularTrajectorySource : public Processor {
+public:
+    MolecularTrajectorySource();
+    virtual ~MolecularTrajectorySource() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    molvis::MolecularStructureInport inport_;
+    molvis::MolecularStructureOutport outport_;
+
+    FileProperty file_;
+    IntSizeTProperty frame_;
+    IntSizeTProperty prefetch_;
+    IntSizeTProperty cacheSize_;
+    BoolProperty waitForFrame_;
+
+    std::shared_ptr<molvis::MolecularTrajectory> trajectory_;
+    std::shared_ptr<molvis::MolecularTrajectory::Callback> onLoaded_;
+    std::atomic<size_t> pending_{std::numeric_limits<size_t>::max()};
+};
+
+}  // namespace inviwo
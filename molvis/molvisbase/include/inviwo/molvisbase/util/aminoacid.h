@@ -147,18 +147,21 @@ constexpr std::string_view letter(AminoAcid a) noexcept { return {&detail::lette
  */
 constexpr std::string_view symbol(AminoAcid a) noexcept { return detail::symbols[index(a)]; }
 constexpr vec4 color(AminoAcid a) noexcept { return detail::colorsAmino[index(a)]; }
-constexpr vec4 color(AminoAcid a, Colormap map) noexcept {
+/**
+ * returns the color table of \p map, indexed by index(AminoAcid)
+ */
+constexpr const std::array<vec4, num_aminoacids>& colors(Colormap map) noexcept {
     switch (map) {
-        case Colormap::Amino:
-            return detail::colorsAmino[index(a)];
         case Colormap::Shapely:
-            return detail::colorsShapely[index(a)];
+            return detail::colorsShapely;
         case Colormap::Ugene:
-            return detail::colorsUgene[index(a)];
+            return detail::colorsUgene;
+        case Colormap::Amino:
         default:
-            return color(a);
+            return detail::colorsAmino;
     }
 }
+constexpr vec4 color(AminoAcid a, Colormap map) noexcept { return colors(map)[index(a)]; }
 
 /**
  * create an AminoAcid from a single letter.
@@ -205,16 +205,21 @@ constexpr std::string_view symbol(Element symbol) noexcept {
 constexpr vec4 color(Element symbol) noexcept {
     return detail::colorsRasmolCPKnew[atomicNumber(symbol)];
 }
-constexpr vec4 color(Element symbol, Colormap map) noexcept {
+/**
+ * returns the color table of \p map, indexed by atomic number
+ */
+constexpr const std::array<vec4, num_elements>& colors(Colormap map) noexcept {
     switch (map) {
         case Colormap::RasmolCPK:
-            return detail::colorsRasmol[atomicNumber(symbol)];
+            return detail::colorsRasmol;
         case Colormap::RasmolCPKnew:
-            return detail::colorsRasmolCPKnew[atomicNumber(symbol)];
         default:
-            return color(symbol);
+            return detail::colorsRasmolCPKnew;
     }
 }
+constexpr vec4 color(Element symbol, Colormap map) noexcept {
+    return colors(map)[atomicNumber(symbol)];
+}
 constexpr double vdwRadius(Element symbol) noexcept {
     return detail::vdw_radii[atomicNumber(symbol)];
 }
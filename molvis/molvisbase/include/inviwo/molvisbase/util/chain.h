@@ -107,16 +107,19 @@ constexpr ChainId fromFullName(std::string_view fullName) noexcept {
 }
 
 constexpr vec4 color(ChainId c) noexcept { return detail::colorsJmol[index(c)]; }
-constexpr vec4 color(ChainId c, Colormap map) noexcept {
+/**
+ * returns the color table of \p map, indexed by index(ChainId)
+ */
+constexpr const std::array<vec4, num_chains>& colors(Colormap map) noexcept {
     switch (map) {
-        case Colormap::Jmol:
-            return detail::colorsJmol[index(c)];
         case Colormap::JmolHetero:
-            return detail::colorsJmolHetero[index(c)];
+            return detail::colorsJmolHetero;
+        case Colormap::Jmol:
         default:
-            return color(c);
+            return detail::colorsJmol;
     }
 }
+constexpr vec4 color(ChainId c, Colormap map) noexcept { return colors(map)[index(c)]; }
 constexpr vec4 color(int chainId) noexcept { return color(fromId(chainId)); }
 constexpr vec4 color(int chainId, Colormap map) noexcept { return color(fromId(chainId), map); }
 constexpr vec4 color(std::string_view fullName) noexcept { return color(fromFullName(fullName)); }
@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/molvisbase/util/molecularmesh.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Mesh;
+
+namespace molvis {
+
+/**
+ * \brief proxy spheres of the residues and chains of a molecular structure
+ *
+ * Level-of-detail representation for large assemblies where individual atoms cover only a few
+ * pixels. Each residue and each chain is represented by the bounding sphere of its atoms, colored
+ * with the mean color of its atoms. The proxy meshes have the same buffers as the atom mesh of
+ * MolecularMesh, i.e. positions, colors, radii, and picking IDs, and can be rendered with the same
+ * shaders. The picking ID of a proxy is the one of its first atom.
+ */
+struct IVW_MODULE_MOLVISBASE_API LodHierarchy {
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> atomResidues;   //!< residue index of each atom, or none
+    std::vector<uint32_t> residueChains;  //!< chain index of each residue, or none
+    std::shared_ptr<Mesh> residues;  //!< one point per residue of MolecularStructure::residues()
+    std::shared_ptr<Mesh> chains;    //!< one point per chain of MolecularStructure::chains()
+};
+
+/**
+ * Compute the residue and chain proxies of \p s. The residues and chains are processed in
+ * parallel.
+ *
+ * @param s          molecular structure
+ * @param colormap   color mapping of the atoms, the proxies get the mean color of their atoms
+ * @param pickingId  picking ID of the first atom, see MolecularMesh::update
+ */
+IVW_MODULE_MOLVISBASE_API LodHierarchy createLodHierarchy(const MolecularStructure& s,
+                                                          const ColorMapping& colormap,
+                                                          uint32_t pickingId);
+
+}  // namespace molvis
+
+}  // namespace inviwo
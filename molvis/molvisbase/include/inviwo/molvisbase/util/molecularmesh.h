@@ -0,0 +1,136 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisbase/molvisbasemoduledefine.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/util/glmvec.h>
+#include <inviwo/core/util/glmmat.h>
+
+#include <inviwo/molvisbase/algorithm/atomselection.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/molvisbase/util/atomicelement.h>
+#include <inviwo/molvisbase/util/aminoacid.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace inviwo {
+
+class Mesh;
+
+namespace molvis {
+
+enum class Coloring { Atoms, Residues, Chains, Fixed };
+
+/**
+ * \brief determines the per-atom colors of a molecular structure
+ */
+struct IVW_MODULE_MOLVISBASE_API ColorMapping {
+    Coloring coloring = Coloring::Atoms;
+    element::Colormap atoms = element::Colormap::RasmolCPKnew;
+    aminoacid::Colormap aminoacids = aminoacid::Colormap::Amino;
+    vec4 fixedColor{0.8f, 0.8f, 0.8f, 1.0f};
+
+    bool operator==(const ColorMapping& rhs) const;
+    bool operator!=(const ColorMapping& rhs) const;
+};
+
+/**
+ * Determine the color of each atom in \p s. Atoms without the required element, residue, or chain
+ * information are colored as unknown.
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<vec4> atomColors(const MolecularStructure& s,
+                                                       const ColorMapping& colormap);
+
+/**
+ * Determine the van der Waals radius of each atom in \p s.
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<float> atomRadii(const MolecularStructure& s);
+
+/**
+ * Determine the transforms of the instances of \p s in data space, a single identity transform
+ * if \p s has no instances. A mesh of \p s is drawn once per transform.
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<mat4> instanceTransforms(const MolecularStructure& s);
+
+/**
+ * \brief mesh of a molecular structure with separately updated attribute buffers
+ *
+ * The mesh consists of positions, colors, van der Waals radii, and picking IDs of the atoms, and
+ * index buffers for atoms and bonds. It is kept across calls to update(), which only rewrites the
+ * buffers affected by the change. The mesh is recreated if the structure has a different
+ * topology, positions are rewritten for trajectory frames of the same topology, and colors and
+ * picking IDs if the color mapping or the picking ID change. Only the rewritten buffers are
+ * uploaded to the GPU again.
+ *
+ * An optional atom mask restricts the index buffers to the selected atoms and the bonds between
+ * them, the attribute buffers always hold all atoms.
+ *
+ * \see MolecularStructure::sharesTopology
+ */
+class IVW_MODULE_MOLVISBASE_API MolecularMesh {
+public:
+    /**
+     * Update the mesh for structure \p s, see class description.
+     *
+     * @param s          molecular structure
+     * @param colormap   color mapping of the atoms
+     * @param pickingId  picking ID of the first atom, atom i gets pickingId + i
+     * @param mask       atoms to draw, all atoms if nullptr
+     * @return mesh of \p s
+     */
+    std::shared_ptr<Mesh> update(std::shared_ptr<const MolecularStructure> s,
+                                 const ColorMapping& colormap, uint32_t pickingId,
+                                 const AtomMask* mask = nullptr);
+
+    const std::shared_ptr<Mesh>& getMesh() const;
+
+private:
+    // rewrite the atom and bond indices for the atoms in \p mask, or all atoms if nullptr
+    void updateIndices(const MolecularStructure& s, const AtomMask* mask);
+
+    std::shared_ptr<const MolecularStructure> structure_;
+    ColorMapping colormap_;
+    uint32_t pickingId_ = 0;
+    std::optional<AtomMask> mask_;
+
+    std::shared_ptr<Mesh> mesh_;
+    std::shared_ptr<Buffer<vec3>> positions_;
+    std::shared_ptr<Buffer<vec4>> colors_;
+    std::shared_ptr<Buffer<uint32_t>> picking_;
+    std::shared_ptr<IndexBuffer> atomIndices_;
+    std::shared_ptr<IndexBuffer> bondIndices_;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -89,6 +89,9 @@ IVW_MODULE_MOLVISBASE_API PeptideType getPeptideType(AminoAcid residue, AminoAci
 IVW_MODULE_MOLVISBASE_API PeptideType getPeptideType(std::string_view resName,
                                                      std::string_view nextResName);
 
+/// maximum distance in Å between two atoms considered by computeCovalentBonds()
+constexpr double maxCovalentBondLength = 4.0;
+
 /**
  * Determine covalent bonds based on heuristics. A bond is valid if the distance between two
  * atoms lies in between (r_1 + r_2 - 0.5) and (r_1 + r_2 + 0.3) where r_i is the covalent radius of
@@ -101,7 +104,23 @@ IVW_MODULE_MOLVISBASE_API PeptideType getPeptideType(std::string_view resName,
 IVW_MODULE_MOLVISBASE_API std::vector<Bond> computeCovalentBonds(const Atoms& atoms);
 
 /**
- * Determines the atomic numbers of each atom based on the respective \p fullNames.
+ * Determine covalent bonds based on heuristics using an existing \p grid of the atoms, e.g.
+ * MolecularStructure::getAtomGrid(). Atoms are processed in parallel and the bonds are ordered by
+ * their first atom.
+ *
+ * @param atoms  requires only atom positions and atomic numbers
+ * @param grid   atom grid created from the positions of \p atoms
+ * @return list of covalent bonds
+ * @throws Exception if sizes of positions, atomic numbers, and the grid do not match
+ *
+ * \see computeCovalentBonds(const Atoms&)
+ */
+IVW_MODULE_MOLVISBASE_API std::vector<Bond> computeCovalentBonds(const Atoms& atoms,
+                                                                 const AtomGrid& grid);
+
+/**
+ * Determines the atomic numbers of each atom based on the respective \p fullNames. The names are
+ * processed in parallel.
  *
  * @return list of atomic numbers matching the full names of the input
  *
@@ -129,6 +148,21 @@ IVW_MODULE_MOLVISBASE_API std::shared_ptr<Mesh> createMesh(const MolecularStruct
                                                            bool enablePicking = false,
                                                            uint32_t startId = 0);
 
+/**
+ * \brief replace the atom positions of \p mesh with the ones of \p s
+ *
+ * Only the position buffer is modified, i.e. colors, radii, picking IDs, and indices of the mesh
+ * are kept. This is sufficient if \p s is a trajectory frame of the structure \p mesh was created
+ * from.
+ *
+ * @param mesh   mesh created by createMesh() or a similar function with a vec3 position buffer
+ * @param s      molecular structure with the same number of atoms
+ * @throws Exception if the position buffer is missing or its size does not match \p s
+ *
+ * \see MolecularStructure::sharesTopology
+ */
+IVW_MODULE_MOLVISBASE_API void updateMeshPositions(Mesh& mesh, const MolecularStructure& s);
+
 /**
  * \brief create a tool tip for the given \p atom of molecular structure \p s
  *
@@ -0,0 +1,585 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/algorithm/atomselection.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/molvisbase/io/readerutils.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/molvisbase/util/chain.h>
+
+#include <inviwo/core/util/assertion.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stdextensions.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <functional>
+#include <numeric>
+
+namespace inviwo {
+
+namespace molvis {
+
+AtomMask::AtomMask(size_t size, bool value)
+    : size_{size}
+    , words_((size + bitsPerWord - 1) / bitsPerWord, value ? ~uint64_t{0} : uint64_t{0}) {
+    clearPadding();
+}
+
+size_t AtomMask::size() const { return size_; }
+
+size_t AtomMask::count() const {
+    return std::accumulate(words_.begin(), words_.end(), size_t{0}, [](size_t sum, uint64_t w) {
+        size_t bits = 0;
+        for (; w != 0; w &= w - 1) ++bits;
+        return sum + bits;
+    });
+}
+
+bool AtomMask::any() const {
+    return std::any_of(words_.begin(), words_.end(), [](uint64_t w) { return w != 0; });
+}
+
+bool AtomMask::none() const { return !any(); }
+
+bool AtomMask::all() const { return count() == size_; }
+
+bool AtomMask::test(size_t i) const {
+    return (words_[i / bitsPerWord] >> (i % bitsPerWord)) & 1u;
+}
+
+void AtomMask::set(size_t i, bool value) {
+    const uint64_t bit = uint64_t{1} << (i % bitsPerWord);
+    if (value) {
+        words_[i / bitsPerWord] |= bit;
+    } else {
+        words_[i / bitsPerWord] &= ~bit;
+    }
+}
+
+std::vector<uint32_t> AtomMask::indices() const {
+    std::vector<uint32_t> result;
+    result.reserve(count());
+    forEachSet([&](size_t i) { result.push_back(static_cast<uint32_t>(i)); });
+    return result;
+}
+
+AtomMask& AtomMask::operator&=(const AtomMask& rhs) {
+    IVW_ASSERT(size_ == rhs.size_, "atom masks of different size");
+    for (size_t i = 0; i < words_.size(); ++i) words_[i] &= rhs.words_[i];
+    return *this;
+}
+
+AtomMask& AtomMask::operator|=(const AtomMask& rhs) {
+    IVW_ASSERT(size_ == rhs.size_, "atom masks of different size");
+    for (size_t i = 0; i < words_.size(); ++i) words_[i] |= rhs.words_[i];
+    return *this;
+}
+
+AtomMask& AtomMask::flip() {
+    for (auto& w : words_) w = ~w;
+    clearPadding();
+    return *this;
+}
+
+bool AtomMask::operator==(const AtomMask& rhs) const {
+    return size_ == rhs.size_ && words_ == rhs.words_;
+}
+
+bool AtomMask::operator!=(const AtomMask& rhs) const { return !(*this == rhs); }
+
+std::vector<uint64_t>& AtomMask::words() { return words_; }
+
+const std::vector<uint64_t>& AtomMask::words() const { return words_; }
+
+void AtomMask::clearPadding() {
+    if (const size_t bits = size_ % bitsPerWord; bits != 0) {
+        words_.back() &= (uint64_t{1} << bits) - 1;
+    }
+}
+
+namespace detail {
+
+using Evaluator = std::function<AtomMask(const MolecularStructure&)>;
+
+struct SelectionNode {
+    Evaluator evaluate;
+};
+
+namespace {
+
+/*
+ * Evaluate \p pred(i) for all atoms of \p s. Each thread fills whole words of the mask.
+ */
+template <typename Pred>
+AtomMask atomMask(const MolecularStructure& s, Pred pred) {
+    const size_t size = s.atoms().positions.size();
+    AtomMask mask(size);
+    auto& words = mask.words();
+    util::forEachRangeParallel(words.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t w = begin; w < end; ++w) {
+            const size_t first = w * AtomMask::bitsPerWord;
+            const size_t last = std::min(size, first + AtomMask::bitsPerWord);
+            uint64_t word = 0;
+            for (size_t i = first; i < last; ++i) {
+                if (pred(i)) word |= uint64_t{1} << (i - first);
+            }
+            words[w] = word;
+        }
+    });
+    return mask;
+}
+
+/*
+ * Evaluate \p pred(residue) once per residue and assign the result to the atoms of the residue.
+ */
+template <typename Pred>
+AtomMask residueMask(const MolecularStructure& s, Pred pred) {
+    if (!s.hasResidues()) return AtomMask(s.atoms().positions.size());
+
+    std::vector<unsigned char> selected(s.residues().size());
+    std::transform(s.residues().begin(), s.residues().end(), selected.begin(),
+                   [&](const Residue& res) { return static_cast<unsigned char>(pred(res)); });
+    const auto& residueIndices = s.getResidueIndices();
+    return atomMask(s, [&](size_t i) { return selected[residueIndices[i]] != 0; });
+}
+
+struct IntRange {
+    int min;
+    int max;
+};
+
+bool contains(const std::vector<IntRange>& ranges, int value) {
+    return std::any_of(ranges.begin(), ranges.end(),
+                       [value](const IntRange& r) { return value >= r.min && value <= r.max; });
+}
+
+bool contains(const std::vector<std::string>& names, std::string_view name) {
+    const auto trimmed = util::trim(name);
+    return std::any_of(names.begin(), names.end(),
+                       [&](const std::string& n) { return iCaseCmp(n, trimmed); });
+}
+
+const std::array<std::string_view, 4> backboneNames = {"N", "CA", "C", "O"};
+const std::array<std::string_view, 5> waterNames = {"HOH", "WAT", "SOL", "H2O", "TIP3"};
+
+bool isBackboneName(std::string_view name) {
+    const auto trimmed = util::trim(name);
+    return std::any_of(backboneNames.begin(), backboneNames.end(),
+                       [&](std::string_view n) { return trimmed == n; });
+}
+
+bool isWater(const Residue& res) {
+    const auto trimmed = util::trim(res.fullName);
+    return std::any_of(waterNames.begin(), waterNames.end(),
+                       [&](std::string_view n) { return iCaseCmp(trimmed, n); });
+}
+
+AtomMask within(const MolecularStructure& s, const AtomMask& inner, double distance) {
+    const auto& grid = s.getAtomGrid();
+    const auto& positions = s.atoms().positions;
+    if (inner.none()) return inner;
+
+    if (inner.count() * 2 <= inner.size()) {
+        // few source atoms, mark the neighbors of each of them
+        AtomMask mask(inner.size());
+        inner.forEachSet([&](size_t i) {
+            grid.forEachAtomWithin(positions[i], distance,
+                                   [&](size_t neighbor, const dvec3&) { mask.set(neighbor); });
+        });
+        return mask;
+    } else {
+        // test the neighborhood of each atom in parallel
+        return atomMask(s, [&](size_t i) {
+            if (inner.test(i)) return true;
+            bool found = false;
+            grid.forEachAtomWithin(positions[i], distance, [&](size_t neighbor, const dvec3&) {
+                found = found || inner.test(neighbor);
+            });
+            return found;
+        });
+    }
+}
+
+AtomMask sameResidue(const MolecularStructure& s, const AtomMask& inner) {
+    if (!s.hasResidues()) return inner;
+    const auto& residueIndices = s.getResidueIndices();
+    std::vector<unsigned char> selected(s.residues().size(), 0);
+    inner.forEachSet([&](size_t i) { selected[residueIndices[i]] = 1; });
+    return atomMask(s, [&](size_t i) { return selected[residueIndices[i]] != 0; });
+}
+
+enum class TokenType { Word, Operator, Open, Close, End };
+
+struct Token {
+    TokenType type;
+    std::string text;
+    size_t pos;
+};
+
+std::vector<Token> tokenize(std::string_view query) {
+    std::vector<Token> tokens;
+    auto isOperator = [](char c) { return c == '<' || c == '>' || c == '=' || c == '!'; };
+    auto isSeparator = [&](char c) {
+        return std::isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')' ||
+               isOperator(c);
+    };
+
+    size_t i = 0;
+    while (i < query.size()) {
+        const char c = query[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '(' || c == ')') {
+            tokens.push_back({c == '(' ? TokenType::Open : TokenType::Close, std::string(1, c), i});
+            ++i;
+        } else if (isOperator(c)) {
+            const size_t start = i;
+            while (i < query.size() && isOperator(query[i])) ++i;
+            tokens.push_back({TokenType::Operator, std::string(query.substr(start, i - start)),
+                              start});
+        } else if (c == '"' || c == '\'') {
+            const size_t start = i;
+            const size_t end = query.find(c, i + 1);
+            if (end == std::string_view::npos) {
+                throw Exception(fmt::format("Invalid atom selection '{}': unterminated quote at "
+                                            "position {}",
+                                            query, start),
+                                IVW_CONTEXT_CUSTOM("molvis::AtomSelection"));
+            }
+            tokens.push_back({TokenType::Word, std::string(query.substr(i + 1, end - i - 1)),
+                              start});
+            i = end + 1;
+        } else {
+            const size_t start = i;
+            while (i < query.size() && !isSeparator(query[i])) ++i;
+            tokens.push_back({TokenType::Word, std::string(query.substr(start, i - start)),
+                              start});
+        }
+    }
+    tokens.push_back({TokenType::End, "", query.size()});
+    return tokens;
+}
+
+/*
+ * Recursive descent parser of the grammar
+ *  or      := and ('or' and)*
+ *  and     := unary ('and' unary)*
+ *  unary   := 'not' unary | 'within' number 'of' unary | 'same' 'residue' 'as' unary | primary
+ *  primary := '(' or ')' | predicate
+ */
+class Parser {
+public:
+    Parser(std::string_view query) : query_{query}, tokens_{tokenize(query)} {}
+
+    Evaluator parse() {
+        auto result = parseOr();
+        if (peek().type != TokenType::End) error(fmt::format("unexpected '{}'", peek().text));
+        return result;
+    }
+
+private:
+    [[noreturn]] void error(std::string_view message) const {
+        throw Exception(fmt::format("Invalid atom selection '{}': {} at position {}", query_,
+                                    message, peek().pos),
+                        IVW_CONTEXT_CUSTOM("molvis::AtomSelection"));
+    }
+
+    const Token& peek() const { return tokens_[current_]; }
+    Token next() { return tokens_[current_ < tokens_.size() - 1 ? current_++ : current_]; }
+
+    bool isKeyword(const Token& token, std::string_view keyword) const {
+        return token.type == TokenType::Word && iCaseCmp(token.text, keyword);
+    }
+    bool accept(std::string_view keyword) {
+        if (isKeyword(peek(), keyword)) {
+            next();
+            return true;
+        }
+        return false;
+    }
+    void expect(std::string_view keyword) {
+        if (!accept(keyword)) error(fmt::format("expected '{}'", keyword));
+    }
+
+    bool isValue(const Token& token) const {
+        static constexpr std::array<std::string_view, 10> reserved = {
+            "and", "or", "not", "within", "same", "of", "as", "to", "all", "none"};
+        return token.type == TokenType::Word &&
+               std::none_of(reserved.begin(), reserved.end(),
+                            [&](std::string_view k) { return iCaseCmp(token.text, k); });
+    }
+
+    Evaluator parseOr() {
+        auto lhs = parseAnd();
+        while (accept("or")) {
+            auto rhs = parseAnd();
+            lhs = [lhs, rhs](const MolecularStructure& s) { return lhs(s) |= rhs(s); };
+        }
+        return lhs;
+    }
+
+    Evaluator parseAnd() {
+        auto lhs = parseUnary();
+        while (accept("and")) {
+            auto rhs = parseUnary();
+            lhs = [lhs, rhs](const MolecularStructure& s) {
+                auto mask = lhs(s);
+                return mask.any() ? mask &= rhs(s) : mask;
+            };
+        }
+        return lhs;
+    }
+
+    Evaluator parseUnary() {
+        if (accept("not")) {
+            auto arg = parseUnary();
+            return [arg](const MolecularStructure& s) { return arg(s).flip(); };
+        } else if (accept("within")) {
+            const double distance = parseNumber();
+            expect("of");
+            auto arg = parseUnary();
+            return [arg, distance](const MolecularStructure& s) {
+                return within(s, arg(s), distance);
+            };
+        } else if (accept("same")) {
+            expect("residue");
+            expect("as");
+            auto arg = parseUnary();
+            return [arg](const MolecularStructure& s) { return sameResidue(s, arg(s)); };
+        }
+        return parsePrimary();
+    }
+
+    double parseNumber() {
+        double value = 0.0;
+        if (peek().type != TokenType::Word || !fromStr(peek().text, value)) {
+            error("expected a number");
+        }
+        next();
+        return value;
+    }
+
+    std::vector<std::string> parseNames() {
+        std::vector<std::string> names;
+        while (isValue(peek())) names.push_back(next().text);
+        if (names.empty()) error("expected a name");
+        return names;
+    }
+
+    std::vector<IntRange> parseRanges() {
+        std::vector<IntRange> ranges;
+        auto parseInt = [&](std::string_view str) {
+            int value = 0;
+            if (!fromStr(str, value)) error("expected an integer");
+            return value;
+        };
+        while (isValue(peek())) {
+            const std::string text = peek().text;
+            // '-' at the beginning is the sign of the first value
+            if (auto dash = text.find('-', 1); dash != std::string::npos) {
+                ranges.push_back({parseInt(std::string_view{text}.substr(0, dash)),
+                                  parseInt(std::string_view{text}.substr(dash + 1))});
+                next();
+            } else {
+                const int value = parseInt(text);
+                next();
+                if (accept("to")) {
+                    if (!isValue(peek())) error("expected an integer");
+                    ranges.push_back({value, parseInt(peek().text)});
+                    next();
+                } else {
+                    ranges.push_back({value, value});
+                }
+            }
+        }
+        if (ranges.empty()) error("expected an integer");
+        return ranges;
+    }
+
+    std::function<bool(double)> parseComparison() {
+        if (peek().type != TokenType::Operator) error("expected a comparison");
+        const std::string op = next().text;
+        const double value = parseNumber();
+        if (op == "<") return [value](double x) { return x < value; };
+        if (op == "<=") return [value](double x) { return x <= value; };
+        if (op == ">") return [value](double x) { return x > value; };
+        if (op == ">=") return [value](double x) { return x >= value; };
+        if (op == "==" || op == "=") return [value](double x) { return x == value; };
+        if (op == "!=") return [value](double x) { return x != value; };
+        error(fmt::format("invalid comparison '{}'", op));
+    }
+
+    Evaluator parsePrimary() {
+        if (peek().type == TokenType::Open) {
+            next();
+            auto result = parseOr();
+            if (peek().type != TokenType::Close) error("expected ')'");
+            next();
+            return result;
+        }
+        if (peek().type != TokenType::Word) error("expected a selection");
+
+        const auto keyword = toLower(next().text);
+        if (keyword == "all") {
+            return [](const MolecularStructure& s) {
+                return AtomMask(s.atoms().positions.size(), true);
+            };
+        } else if (keyword == "none") {
+            return [](const MolecularStructure& s) { return AtomMask(s.atoms().positions.size()); };
+        } else if (keyword == "index") {
+            auto ranges = parseRanges();
+            return [ranges](const MolecularStructure& s) {
+                return atomMask(s,
+                                [&](size_t i) { return contains(ranges, static_cast<int>(i)); });
+            };
+        } else if (keyword == "serial") {
+            return columnPredicate(&Atoms::serialNumbers, parseRanges());
+        } else if (keyword == "resid") {
+            return columnPredicate(&Atoms::residueIds, parseRanges());
+        } else if (keyword == "model") {
+            return columnPredicate(&Atoms::modelIds, parseRanges());
+        } else if (keyword == "name") {
+            auto names = parseNames();
+            return [names](const MolecularStructure& s) {
+                const auto& fullNames = s.atoms().fullNames;
+                if (fullNames.empty()) return AtomMask(s.atoms().positions.size());
+                return atomMask(s, [&](size_t i) { return contains(names, fullNames[i]); });
+            };
+        } else if (keyword == "element") {
+            std::vector<Element> elements;
+            for (const auto& name : parseNames()) {
+                const auto elem = element::fromAbbr(name);
+                if (elem == Element::Unknown) error(fmt::format("unknown element '{}'", name));
+                elements.push_back(elem);
+            }
+            return elementPredicate(std::move(elements));
+        } else if (keyword == "hydrogen") {
+            return elementPredicate({Element::H});
+        } else if (keyword == "resname") {
+            auto names = parseNames();
+            return [names](const MolecularStructure& s) {
+                return residueMask(
+                    s, [&](const Residue& res) { return contains(names, res.fullName); });
+            };
+        } else if (keyword == "chain") {
+            auto names = parseNames();
+            return [names](const MolecularStructure& s) {
+                std::vector<int> ids;
+                if (!s.chains().empty()) {
+                    for (const auto& c : s.chains()) {
+                        if (contains(names, c.name)) ids.push_back(c.id);
+                    }
+                } else {
+                    for (const auto& name : names) {
+                        if (auto c = chain::fromName(name); c != ChainId::Unknown) {
+                            ids.push_back(chain::id(c));
+                        }
+                    }
+                }
+                const auto& chainIds = s.atoms().chainIds;
+                if (ids.empty() || chainIds.empty()) return AtomMask(s.atoms().positions.size());
+                return atomMask(s, [&](size_t i) { return util::contains(ids, chainIds[i]); });
+            };
+        } else if (keyword == "beta" || keyword == "bfactor") {
+            auto compare = parseComparison();
+            return [compare](const MolecularStructure& s) {
+                const auto& bFactors = s.atoms().bFactors;
+                if (bFactors.empty()) return AtomMask(s.atoms().positions.size());
+                return atomMask(s, [&](size_t i) { return compare(bFactors[i]); });
+            };
+        } else if (keyword == "protein") {
+            return [](const MolecularStructure& s) {
+                return residueMask(
+                    s, [](const Residue& res) { return res.aminoacid != AminoAcid::Unknown; });
+            };
+        } else if (keyword == "water") {
+            return [](const MolecularStructure& s) { return residueMask(s, isWater); };
+        } else if (keyword == "backbone" || keyword == "sidechain") {
+            const bool backbone = keyword == "backbone";
+            return [backbone](const MolecularStructure& s) {
+                auto mask = residueMask(
+                    s, [](const Residue& res) { return res.aminoacid != AminoAcid::Unknown; });
+                const auto& fullNames = s.atoms().fullNames;
+                if (fullNames.empty()) return backbone ? AtomMask(mask.size()) : mask;
+                return mask &= atomMask(
+                           s, [&](size_t i) { return isBackboneName(fullNames[i]) == backbone; });
+            };
+        }
+        --current_;
+        error(fmt::format("unknown keyword '{}'", peek().text));
+    }
+
+    template <typename Column>
+    static Evaluator columnPredicate(Column column, std::vector<IntRange> ranges) {
+        return [column, ranges](const MolecularStructure& s) {
+            const auto& values = s.atoms().*column;
+            if (values.empty()) return AtomMask(s.atoms().positions.size());
+            return atomMask(s, [&](size_t i) { return contains(ranges, values[i]); });
+        };
+    }
+
+    static Evaluator elementPredicate(std::vector<Element> elements) {
+        return [elements](const MolecularStructure& s) {
+            const auto& atomicNumbers = s.atoms().atomicNumbers;
+            if (atomicNumbers.empty()) return AtomMask(s.atoms().positions.size());
+            return atomMask(s,
+                            [&](size_t i) { return util::contains(elements, atomicNumbers[i]); });
+        };
+    }
+
+    std::string_view query_;
+    std::vector<Token> tokens_;
+    size_t current_ = 0;
+};
+
+}  // namespace
+
+}  // namespace detail
+
+AtomSelection::AtomSelection(std::string_view query)
+    : query_{query}
+    , root_{std::make_shared<detail::SelectionNode>(
+          detail::SelectionNode{detail::Parser{query}.parse()})} {}
+
+const std::string& AtomSelection::getQuery() const { return query_; }
+
+AtomMask AtomSelection::evaluate(const MolecularStructure& s) const { return root_->evaluate(s); }
+
+AtomMask selectAtoms(const MolecularStructure& s, std::string_view query) {
+    return AtomSelection{query}.evaluate(s);
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -31,71 +31,52 @@
 
 #include <inviwo/molvisbase/datastructures/molecularstructure.h>
 
-#include <inviwo/core/util/zip.h>
-#include <numeric>
+#include <limits>
 #include <utility>
 
 namespace inviwo {
 
 namespace molvis {
 
-mat4 boundingBox(const MolecularStructure& structure) {
-    dvec3 worldMin(std::numeric_limits<double>::max());
-    dvec3 worldMax(std::numeric_limits<double>::lowest());
+namespace {
 
-    if (structure.hasAtoms()) {
-        if (!structure.atoms().atomicNumbers.empty()) {
-            for (auto&& [pos, element] :
-                 util::zip(structure.atoms().positions, structure.atoms().atomicNumbers)) {
-                const dvec3 radius{element::vdwRadius(element)};
-                worldMin = glm::min(worldMin, pos - radius);
-                worldMax = glm::max(worldMax, pos + radius);
-            }
-        } else {
-            for (const auto& pos : structure.atoms().positions) {
-                const dvec3 radius{element::vdwRadius(Element::Unknown)};
-                worldMin = glm::min(worldMin, pos - radius);
-                worldMax = glm::max(worldMax, pos + radius);
-            }
-        }
-    } else {
-        worldMin = worldMax = dvec3(0.0, 0.0, 0.0);
-    }
-
-    auto m = glm::scale(vec3(worldMax) - vec3(worldMin));
+mat4 toBasis(const vec3& worldMin, const vec3& worldMax) {
+    auto m = glm::scale(worldMax - worldMin);
     m[3] = vec4(worldMin, 1.0f);
     return m;
 }
 
+}  // namespace
+
+mat4 boundingBox(const MolecularStructure& structure) {
+    const auto& [worldMin, worldMax] = structure.getBounds();
+    return toBasis(vec3(worldMin), vec3(worldMax));
+}
+
 template <typename const_iterator>
 mat4 boundingBox(const_iterator begin, const_iterator end) {
     if (begin == end) return mat4(0.0f);
 
-    vec3 worldMin(std::numeric_limits<float>::max());
-    vec3 worldMax(std::numeric_limits<float>::lowest());
-
-    const std::array<vec3, 8> corners = {vec3{0, 0, 0}, vec3{1, 0, 0}, vec3{1, 1, 0},
-                                         vec3{0, 1, 0}, vec3{0, 0, 1}, vec3{1, 0, 1},
-                                         vec3{1, 1, 1}, vec3{0, 1, 1}};
+    // merge the cached bounds of the structures
+    dvec3 worldMin(std::numeric_limits<double>::max());
+    dvec3 worldMax(std::numeric_limits<double>::lowest());
     bool validBbox = false;
     while (begin != end) {
         auto structure = *begin++;
         if (!structure->hasAtoms()) continue;
         validBbox = true;
-        auto bb = boundingBox(*structure);
-        for (const auto& corner : corners) {
-            const auto point = vec3(bb * vec4(corner, 1.f));
-            worldMin = glm::min(worldMin, point);
-            worldMax = glm::max(worldMax, point);
-        }
+        const auto& bounds = structure->getBounds();
+        worldMin = glm::min(worldMin, bounds.first);
+        worldMax = glm::max(worldMax, bounds.second);
     }
     if (!validBbox) {
-        worldMin = worldMax = vec3(0.0f, 0.0f, 0.0f);
+        worldMin = worldMax = dvec3(0.0, 0.0, 0.0);
     }
+    return toBasis(vec3(worldMin), vec3(worldMax));
+}
 
-    auto m = glm::scale(worldMax - worldMin);
-    m[3] = vec4(worldMin, 1.0f);
-    return m;
+mat4 boundingBox(const std::vector<std::shared_ptr<const MolecularStructure>>& structures) {
+    return boundingBox(structures.begin(), structures.end());
 }
 
 std::function<std::optional<mat4>()> boundingBox(const MolecularStructureInport& structure) {
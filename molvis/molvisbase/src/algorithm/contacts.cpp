@@ -0,0 +1,114 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/algorithm/contacts.h>
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace inviwo {
+
+namespace molvis {
+
+std::vector<AtomContact> computeAtomContacts(const MolecularStructure& s, double cutoff) {
+    const auto& positions = s.atoms().positions;
+    const auto& grid = s.getAtomGrid();
+    if (positions.empty() || cutoff <= 0.0) return {};
+
+    // search contacts of consecutive atom ranges in parallel, each with its own buffer
+    const size_t chunkSize = 1 << 14;
+    std::vector<std::vector<AtomContact>> chunkContacts((positions.size() + chunkSize - 1) /
+                                                        chunkSize);
+    util::forEachRangeParallel(positions.size(), chunkSize, [&](size_t begin, size_t end) {
+        auto& contacts = chunkContacts[begin / chunkSize];
+        for (size_t atom1 = begin; atom1 < end; ++atom1) {
+            const auto& pos1 = positions[atom1];
+            const auto first = contacts.size();
+            grid.forEachAtomWithin(pos1, cutoff, [&](size_t atom2, const dvec3& pos2) {
+                if (atom1 < atom2) {
+                    contacts.push_back({atom1, atom2, glm::distance(pos1, pos2)});
+                }
+            });
+            // the grid visits neighbors cell by cell
+            std::sort(contacts.begin() + first, contacts.end(),
+                      [](const auto& a, const auto& b) { return a.atom2 < b.atom2; });
+        }
+    });
+
+    std::vector<AtomContact> contacts;
+    contacts.reserve(std::accumulate(chunkContacts.begin(), chunkContacts.end(), size_t{0},
+                                     [](size_t sum, auto& c) { return sum + c.size(); }));
+    for (auto& c : chunkContacts) {
+        contacts.insert(contacts.end(), c.begin(), c.end());
+    }
+    return contacts;
+}
+
+std::vector<ResidueContact> computeResidueContacts(const MolecularStructure& s, double cutoff,
+                                                   size_t minSeparation) {
+    const auto& residueIndices = s.getResidueIndices();
+    const auto& chainIndices = s.getResidueChainIndices();
+    if (residueIndices.empty()) return {};
+
+    auto separated = [&](size_t res1, size_t res2) {
+        return chainIndices.empty() || chainIndices[res1] != chainIndices[res2] ||
+               res2 - res1 >= minSeparation;
+    };
+
+    std::vector<ResidueContact> contacts;
+    for (const auto& contact : computeAtomContacts(s, cutoff)) {
+        auto res1 = residueIndices[contact.atom1];
+        auto res2 = residueIndices[contact.atom2];
+        if (res1 == res2) continue;
+        if (res1 > res2) std::swap(res1, res2);
+        if (separated(res1, res2)) {
+            contacts.push_back({res1, res2, contact.distance});
+        }
+    }
+
+    // keep the closest contact of each residue pair
+    std::sort(contacts.begin(), contacts.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.residue1, a.residue2, a.distance) <
+               std::tie(b.residue1, b.residue2, b.distance);
+    });
+    contacts.erase(std::unique(contacts.begin(), contacts.end(),
+                               [](const auto& a, const auto& b) {
+                                   return a.residue1 == b.residue1 && a.residue2 == b.residue2;
+                               }),
+                   contacts.end());
+    return contacts;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,216 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+namespace inviwo {
+
+namespace molvis {
+
+AtomGrid::AtomGrid(const std::vector<dvec3>& positions, double cellSize)
+    : cellSize_{cellSize}
+    , min_{0.0}
+    , dims_{1}
+    , cellExt_{cellSize}
+    , cellOffsets_(2, 0) {
+    if (positions.empty()) return;
+
+    // create uniform grid enclosing all atoms +- 1.0Å
+    dvec3 max{positions.front()};
+    min_ = positions.front();
+    for (auto& pos : positions) {
+        min_ = glm::min(min_, pos);
+        max = glm::max(max, pos);
+    }
+    min_ -= 1.0;
+    max += 1.0;
+
+    dims_ = glm::max(size3_t(1), size3_t((max - min_) / cellSize_));
+    cellExt_ = (max - min_) / dvec3{dims_};
+
+    sortAtoms(positions);
+}
+
+AtomGrid::AtomGrid(const AtomGrid& grid, const std::vector<dvec3>& positions)
+    : cellSize_{grid.cellSize_}, min_{grid.min_}, dims_{grid.dims_}, cellExt_{grid.cellExt_} {
+    if (positions.size() != grid.atomIndices_.size() || positions.empty() ||
+        !std::all_of(positions.begin(), positions.end(),
+                     [&](const dvec3& pos) { return contains(pos); })) {
+        *this = AtomGrid{positions, cellSize_};
+        return;
+    }
+
+    // atoms moving only a little between frames mostly stay in their cells
+    std::atomic<bool> moved{false};
+    const auto grainSize = util::defaultGrainSize(positions.size());
+    util::forEachRangeParallel(positions.size(), grainSize, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto atom = grid.atomIndices_[i];
+            if (cellCoord(grid.positions_[i]) != cellCoord(positions[atom])) moved = true;
+        }
+    });
+    if (moved) {
+        sortAtoms(positions);
+        return;
+    }
+
+    cellOffsets_ = grid.cellOffsets_;
+    atomIndices_ = grid.atomIndices_;
+    positions_.resize(positions.size());
+    util::forEachRangeParallel(positions.size(), grainSize, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) positions_[i] = positions[atomIndices_[i]];
+    });
+}
+
+void AtomGrid::sortAtoms(const std::vector<dvec3>& positions) {
+    std::vector<size_t> atomCells(positions.size());
+    util::forEachRangeParallel(
+        positions.size(), util::defaultGrainSize(positions.size()), [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) atomCells[i] = cellIndex(cellCoord(positions[i]));
+        });
+
+    // counting sort of the atoms by cell index
+    cellOffsets_.assign(glm::compMul(dims_) + 1, 0);
+    for (auto cell : atomCells) {
+        ++cellOffsets_[cell + 1];
+    }
+    std::partial_sum(cellOffsets_.begin(), cellOffsets_.end(), cellOffsets_.begin());
+
+    std::vector<size_t> next(cellOffsets_.begin(), cellOffsets_.end() - 1);
+    atomIndices_.resize(positions.size());
+    positions_.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const auto dst = next[atomCells[i]]++;
+        atomIndices_[dst] = i;
+        positions_[dst] = positions[i];
+    }
+}
+
+double AtomGrid::getCellSize() const { return cellSize_; }
+
+const size3_t& AtomGrid::getDimensions() const { return dims_; }
+
+const dvec3& AtomGrid::getOrigin() const { return min_; }
+
+const dvec3& AtomGrid::getCellExtent() const { return cellExt_; }
+
+size3_t AtomGrid::cellCoord(const dvec3& pos) const {
+    return glm::clamp(size3_t(glm::max(dvec3{0.0}, (pos - min_) / cellExt_)), size3_t(0),
+                      dims_ - size_t{1});
+}
+
+size_t AtomGrid::cellIndex(const size3_t& coord) const {
+    return coord.x + dims_.x * (coord.y + dims_.y * coord.z);
+}
+
+const std::vector<size_t>& AtomGrid::cellOffsets() const { return cellOffsets_; }
+
+const std::vector<size_t>& AtomGrid::atomIndices() const { return atomIndices_; }
+
+const std::vector<dvec3>& AtomGrid::positions() const { return positions_; }
+
+std::vector<size_t> AtomGrid::atomsWithin(const dvec3& pos, double radius) const {
+    std::vector<size_t> atoms;
+    forEachAtomWithin(pos, radius, [&](size_t atom, const dvec3&) { atoms.push_back(atom); });
+    std::sort(atoms.begin(), atoms.end());
+    return atoms;
+}
+
+std::vector<size_t> AtomGrid::nearestAtoms(const dvec3& pos, size_t k) const {
+    k = std::min(k, atomIndices_.size());
+    if (k == 0) return {};
+
+    // max-heap of the k closest atoms found so far, by squared distance
+    std::priority_queue<std::pair<double, size_t>> nearest;
+    auto visitCell = [&](const size3_t& coord) {
+        const auto cell = cellIndex(coord);
+        for (size_t i = cellOffsets_[cell]; i < cellOffsets_[cell + 1]; ++i) {
+            const double dist2 = glm::distance2(pos, positions_[i]);
+            if (nearest.size() < k) {
+                nearest.emplace(dist2, atomIndices_[i]);
+            } else if (dist2 < nearest.top().first) {
+                nearest.pop();
+                nearest.emplace(dist2, atomIndices_[i]);
+            }
+        }
+    };
+
+    const auto center = cellCoord(pos);
+    const size_t maxRing = glm::compMax(dims_);
+    for (size_t ring = 0; ring < maxRing; ++ring) {
+        // cells at Chebyshev distance ring from the center cell
+        const size3_t lower{glm::max(size3_t{ring}, center) - size3_t{ring}};
+        const size3_t upper{glm::min(center + ring, dims_ - size_t{1})};
+        for (size_t z = lower.z; z <= upper.z; ++z) {
+            for (size_t y = lower.y; y <= upper.y; ++y) {
+                for (size_t x = lower.x; x <= upper.x; ++x) {
+                    const size3_t coord{x, y, z};
+                    const auto offset = glm::max(coord, center) - glm::min(coord, center);
+                    if (glm::compMax(offset) == ring) visitCell(coord);
+                }
+            }
+        }
+        if (nearest.size() < k) continue;
+
+        // distance from pos to the closest unvisited cell, sides at the grid border are closed
+        double bound = std::numeric_limits<double>::max();
+        for (int dim = 0; dim < 3; ++dim) {
+            if (lower[dim] > 0) {
+                bound = std::min(bound, pos[dim] - (min_[dim] + lower[dim] * cellExt_[dim]));
+            }
+            if (upper[dim] + 1 < dims_[dim]) {
+                bound = std::min(bound, min_[dim] + (upper[dim] + 1) * cellExt_[dim] - pos[dim]);
+            }
+        }
+        if (nearest.top().first <= bound * bound) break;
+    }
+
+    std::vector<size_t> atoms(nearest.size());
+    for (auto it = atoms.rbegin(); it != atoms.rend(); ++it) {
+        *it = nearest.top().second;
+        nearest.pop();
+    }
+    return atoms;
+}
+
+bool AtomGrid::contains(const dvec3& pos) const {
+    return glm::all(glm::greaterThanEqual(pos, min_)) &&
+           glm::all(glm::lessThan(pos, min_ + cellExt_ * dvec3{dims_}));
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -37,9 +37,12 @@
 #include <inviwo/core/util/exception.h>
 
 #include <inviwo/molvisbase/util/molvisutils.h>
+#include <inviwo/utilities/util/parallel.h>
 
 #include <fmt/format.h>
+#include <algorithm>
 #include <limits>
+#include <numeric>
 
 namespace inviwo {
 
@@ -56,133 +59,179 @@ inline double dihedralAngle(const dvec3& p0, const dvec3& p1, const dvec3& p2, c
     return glm::atan(glm::dot(glm::cross(c1, c2), glm::normalize(b2)), glm::dot(c1, c2));
 }
 
-void computeDihedralAngles(
-    std::unordered_map<int, std::vector<MolecularStructure::BackboneSegment>>& chainSegments,
-    const std::unordered_map<ResidueID, size_t>& residueIndices, const MolecularData& data) {
-    for (auto& [chainId, segments] : chainSegments) {
-        if (segments.size() < 2) continue;
+void computeDihedralAngles(std::vector<MolecularStructure::BackboneSegment>& segments,
+                           const std::unordered_map<ResidueID, size_t>& residueIndices,
+                           const MolecularData& data) {
+    if (segments.size() < 2) return;
 
-        auto begin = segments.begin();
-        auto end = segments.end();
+    auto begin = segments.begin();
+    auto end = segments.end();
+
+    auto pos = [&](auto idx) { return data.atoms.positions[idx]; };
+
+    if (begin->complete()) {
+        begin->psi = detail::dihedralAngle(pos(begin->n.value()), pos(begin->ca.value()),
+                                           pos(begin->c.value()), pos((begin + 1)->n.value()));
+    }
+    if ((end - 1)->complete()) {
+        (end - 1)->phi =
+            detail::dihedralAngle(pos((end - 2)->c.value()), pos((end - 1)->n.value()),
+                                  pos((end - 1)->ca.value()), pos((end - 1)->c.value()));
+    }
 
-        auto pos = [&](auto idx) { return data.atoms.positions[idx]; };
+    for (auto&& [prev, current, next] :
+         util::zip(util::as_range(begin, end - 2), util::as_range(begin + 1, end - 1),
+                   util::as_range(begin + 2, end))) {
+        if (!current.complete()) {
+            continue;
+        }
+        const dvec3& ca{pos(current.ca.value())};
+        const dvec3& n{pos(current.n.value())};
+        const dvec3& c{pos(current.c.value())};
 
-        if (begin->complete()) {
-            begin->psi = detail::dihedralAngle(pos(begin->n.value()), pos(begin->ca.value()),
-                                               pos(begin->c.value()), pos((begin + 1)->n.value()));
+        if (prev.c.has_value()) {
+            current.phi = detail::dihedralAngle(pos(prev.c.value()), n, ca, c);
         }
-        if ((end - 1)->complete()) {
-            (end - 1)->phi =
-                detail::dihedralAngle(pos((end - 2)->c.value()), pos((end - 1)->n.value()),
-                                      pos((end - 1)->ca.value()), pos((end - 1)->c.value()));
+        if (next.n.has_value()) {
+            current.psi = detail::dihedralAngle(n, ca, c, pos(next.n.value()));
         }
+    }
 
-        for (auto&& [prev, current, next] :
-             util::zip(util::as_range(begin, end - 2), util::as_range(begin + 1, end - 1),
-                       util::as_range(begin + 2, end))) {
-            if (!current.complete()) {
-                continue;
-            }
-            const dvec3& ca{pos(current.ca.value())};
-            const dvec3& n{pos(current.n.value())};
-            const dvec3& c{pos(current.c.value())};
+    // determine peptide types
+    for (auto&& [current, next] :
+         util::zip(util::as_range(begin, end - 1), util::as_range(begin + 1, end))) {
+        current.type = getPeptideType(
+            data.residues[residueIndices.at({current.resId, current.chainId})].aminoacid,
+            data.residues[residueIndices.at({next.resId, next.chainId})].aminoacid);
+    }
+    (end - 1)->type = getPeptideType(
+        data.residues[residueIndices.at({(end - 1)->resId, (end - 1)->chainId})].aminoacid,
+        AminoAcid::Unknown);
+}
 
-            if (prev.c.has_value()) {
-                current.phi = detail::dihedralAngle(pos(prev.c.value()), n, ca, c);
-            }
-            if (next.n.has_value()) {
-                current.psi = detail::dihedralAngle(n, ca, c, pos(next.n.value()));
-            }
+void computeDihedralAngles(
+    std::unordered_map<int, std::vector<MolecularStructure::BackboneSegment>>& chainSegments,
+    const std::unordered_map<ResidueID, size_t>& residueIndices, const MolecularData& data) {
+    std::vector<std::vector<MolecularStructure::BackboneSegment>*> segments;
+    segments.reserve(chainSegments.size());
+    for (auto& item : chainSegments) {
+        segments.push_back(&item.second);
+    }
+    util::forEachRangeParallel(segments.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            computeDihedralAngles(*segments[i], residueIndices, data);
         }
+    });
+}
+
+/*
+ * Flat index storage in compressed sparse row layout. The items of group i are
+ * items[offsets[i]] to items[offsets[i + 1] - 1].
+ */
+struct IndexRanges {
+    Span<size_t> operator[](size_t i) const {
+        return Span<size_t>{items.data() + offsets[i], offsets[i + 1] - offsets[i]};
+    }
 
-        // determine peptide types
-        for (auto&& [current, next] :
-             util::zip(util::as_range(begin, end - 1), util::as_range(begin + 1, end))) {
-            current.type = getPeptideType(
-                data.residues[residueIndices.at({current.resId, current.chainId})].aminoacid,
-                data.residues[residueIndices.at({next.resId, next.chainId})].aminoacid);
+    std::vector<size_t> offsets;
+    std::vector<size_t> items;
+};
+
+/*
+ * Group the indices [0, groups.size()) by the group each one belongs to, keeping them in
+ * ascending order within a group. Already sorted groups, the common case for atoms and residues
+ * in structure files, skip the counting sort.
+ */
+IndexRanges groupIndices(const std::vector<size_t>& groups, size_t groupCount) {
+    IndexRanges ranges;
+    ranges.offsets.resize(groupCount + 1, 0);
+    for (auto group : groups) {
+        ++ranges.offsets[group + 1];
+    }
+    std::partial_sum(ranges.offsets.begin(), ranges.offsets.end(), ranges.offsets.begin());
+
+    ranges.items.resize(groups.size());
+    if (std::is_sorted(groups.begin(), groups.end())) {
+        std::iota(ranges.items.begin(), ranges.items.end(), size_t{0});
+    } else {
+        std::vector<size_t> cursor(ranges.offsets.begin(), ranges.offsets.end() - 1);
+        for (auto&& [i, group] : util::enumerate(groups)) {
+            ranges.items[cursor[group]++] = i;
         }
-        (end - 1)->type = getPeptideType(
-            data.residues[residueIndices.at({(end - 1)->resId, (end - 1)->chainId})].aminoacid,
-            AminoAcid::Unknown);
     }
+    return ranges;
 }
 
-std::pair<std::unordered_map<int, std::vector<MolecularStructure::BackboneSegment>>,
-          std::vector<size_t>>
-computeBackboneSegments(const MolecularData& data,
-                        std::unordered_map<int, std::vector<size_t>> chainResidues,
-                        std::unordered_map<ResidueID, std::vector<size_t>> residueAtoms,
-                        std::unordered_map<ResidueID, size_t> residueIndices) {
+struct InternalState {
+    // mapping residue and chain IDs to indices in MolecularData::residues and ::chains
+    std::unordered_map<ResidueID, size_t> residueIndices;
+    std::unordered_map<int, size_t> chainIndices;
+    std::vector<size_t> atomResidueIndices;
+    std::vector<size_t> residueChainIndices;
+    // atom indices of each residue and residue indices of each chain
+    IndexRanges residueAtoms;
+    IndexRanges chainResidues;
     std::unordered_map<int, std::vector<MolecularStructure::BackboneSegment>> chainSegments;
-    std::vector<size_t> indices(data.atoms.positions.size());
-
-    const size_t minCount = 4;
+    std::vector<size_t> chainSegmentIndices;
+};
 
-    for (auto& chain : chainResidues) {
-        std::vector<MolecularStructure::BackboneSegment> segments;
+std::vector<MolecularStructure::BackboneSegment> computeBackboneSegments(
+    const MolecularData& data, const InternalState& state, size_t chainIndex,
+    std::vector<size_t>& indices) {
+    std::vector<MolecularStructure::BackboneSegment> segments;
 
-        for (auto& resIdx : chain.second) {
-            const auto& res = data.residues[resIdx];
+    const size_t minCount = 4;
 
-            auto it = residueAtoms.find({res.id, res.chainId});
-            if (it == residueAtoms.end()) continue;
+    const auto chainResidues = state.chainResidues[chainIndex];
+    segments.reserve(chainResidues.size());
+    for (auto resIdx : chainResidues) {
+        const auto& res = data.residues[resIdx];
+        const auto resAtoms = state.residueAtoms[resIdx];
+        if (resAtoms.empty()) continue;
 
-            const auto& resAtoms = it->second;
-            MolecularStructure::BackboneSegment seg;
-            seg.resId = res.id;
-            seg.chainId = res.chainId;
+        MolecularStructure::BackboneSegment seg;
+        seg.resId = res.id;
+        seg.chainId = res.chainId;
 
-            for (auto& atomIdx : resAtoms) {
-                indices[atomIdx] = segments.size();
-            }
+        for (auto atomIdx : resAtoms) {
+            indices[atomIdx] = segments.size();
+        }
 
-            if (resAtoms.size() < minCount) {
-                segments.push_back(seg);
-                continue;
-            }
+        if (resAtoms.size() < minCount) {
+            segments.push_back(seg);
+            continue;
+        }
 
-            // locate atoms
-            for (auto& atomIdx : resAtoms) {
-                switch (data.atoms.atomicNumbers[atomIdx]) {
-                    case Element::N:
-                        if (!seg.n) seg.n = atomIdx;
-                        break;
-                    case Element::C:
-                        if (data.atoms.fullNames[atomIdx] == "CA") {
-                            if (!seg.ca) seg.ca = atomIdx;
-                        } else {
-                            if (!seg.c) seg.c = atomIdx;
-                        }
-                        break;
-                    case Element::O:
-                        if (!seg.o) seg.o = atomIdx;
-                        break;
-                    default:
-                        break;
-                }
-                if (seg.complete()) break;
+        // locate atoms
+        for (auto atomIdx : resAtoms) {
+            switch (data.atoms.atomicNumbers[atomIdx]) {
+                case Element::N:
+                    if (!seg.n) seg.n = atomIdx;
+                    break;
+                case Element::C:
+                    if (data.atoms.fullNames[atomIdx] == "CA") {
+                        if (!seg.ca) seg.ca = atomIdx;
+                    } else {
+                        if (!seg.c) seg.c = atomIdx;
+                    }
+                    break;
+                case Element::O:
+                    if (!seg.o) seg.o = atomIdx;
+                    break;
+                default:
+                    break;
             }
-
-            segments.push_back(seg);
+            if (seg.complete()) break;
         }
-        chainSegments.emplace(chain.first, std::move(segments));
+
+        segments.push_back(seg);
     }
 
-    detail::computeDihedralAngles(chainSegments, residueIndices, data);
+    detail::computeDihedralAngles(segments, state.residueIndices, data);
 
-    return {chainSegments, indices};
+    return segments;
 }
 
-struct InternalState {
-    std::unordered_map<int, std::vector<size_t>> chainResidues;
-    std::unordered_map<ResidueID, std::vector<size_t>> residueAtoms;
-    std::unordered_map<ResidueID, size_t> residueIndices;
-    std::vector<size_t> atomResidueIndices;
-    std::unordered_map<int, std::vector<MolecularStructure::BackboneSegment>> chainSegments;
-    std::vector<size_t> chainSegmentIndices;
-};
-
 InternalState createInternalState(const MolecularData& data) {
     InternalState state;
 
@@ -196,46 +245,66 @@ InternalState createInternalState(const MolecularData& data) {
         }
     };
 
-    // create index maps from atoms to residues and residues to atoms
-    for (size_t i = 0; i < atomCount; ++i) {
-        const auto resId = data.atoms.residueIds[i];
-        const auto chainId = data.atoms.chainIds[i];
-        auto it = util::find_if(data.residues, [id = resId, chainId](const Residue& r) {
-            return r.id == id && r.chainId == chainId;
-        });
-        if (it == data.residues.end()) {
-            throw Exception(fmt::format("Invalid residue ID '{}' in atom {}", resId, atomToStr(i)),
-                            IVW_CONTEXT_CUSTOM("MolecularStructure::MolecularStructure()"));
-        }
-        // add atom to residue
-        state.residueAtoms[{resId, chainId}].push_back(i);
-
-        const auto residueIndex = std::distance(data.residues.begin(), it);
-        state.atomResidueIndices.push_back(residueIndex);
-    }
-
+    state.residueIndices.reserve(data.residues.size());
     for (auto&& [i, res] : util::enumerate(data.residues)) {
         state.residueIndices[{res.id, res.chainId}] = i;
     }
 
+    // create index maps from atoms to residues, consecutive atoms of the same residue are
+    // resolved without a hash lookup
+    state.atomResidueIndices.resize(atomCount);
+    util::forEachRangeParallel(atomCount, size_t{1} << 14, [&](size_t begin, size_t end) {
+        std::optional<ResidueID> lastResidue;
+        size_t lastIndex = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const ResidueID residue{data.atoms.residueIds[i], data.atoms.chainIds[i]};
+            if (residue != lastResidue) {
+                auto it = state.residueIndices.find(residue);
+                if (it == state.residueIndices.end()) {
+                    throw Exception(fmt::format("Invalid residue ID '{}' in atom {}",
+                                                data.atoms.residueIds[i], atomToStr(i)),
+                                    IVW_CONTEXT_CUSTOM("MolecularStructure::MolecularStructure()"));
+                }
+                lastResidue = residue;
+                lastIndex = it->second;
+            }
+            state.atomResidueIndices[i] = lastIndex;
+        }
+    });
+    state.residueAtoms = groupIndices(state.atomResidueIndices, data.residues.size());
+
     if (!data.chains.empty()) {
+        state.chainIndices.reserve(data.chains.size());
+        for (auto&& [i, c] : util::enumerate(data.chains)) {
+            state.chainIndices.try_emplace(c.id, i);
+        }
         // update chain information
+        auto& residueChainIndices = state.residueChainIndices;
+        residueChainIndices.resize(data.residues.size());
         for (auto&& [residueIndex, res] : util::enumerate(data.residues)) {
-            auto chainIt = util::find_if(data.chains,
-                                         [id = res.chainId](const Chain& c) { return c.id == id; });
-            if (chainIt == data.chains.end()) {
+            auto it = state.chainIndices.find(res.chainId);
+            if (it == state.chainIndices.end()) {
                 throw Exception(fmt::format("Invalid chain ID '{}' in residue {} '{}'", res.chainId,
                                             res.id, aminoacid::symbol(res.aminoacid)),
                                 IVW_CONTEXT_CUSTOM("MolecularStructure::MolecularStructure()"));
             }
-            state.chainResidues[res.chainId].push_back(residueIndex);
+            residueChainIndices[residueIndex] = it->second;
         }
+        state.chainResidues = groupIndices(residueChainIndices, data.chains.size());
 
         if (!data.atoms.atomicNumbers.empty()) {
-            auto result = detail::computeBackboneSegments(data, state.chainResidues,
-                                                          state.residueAtoms, state.residueIndices);
-            state.chainSegments = std::move(result.first);
-            state.chainSegmentIndices = std::move(result.second);
+            // chains have disjoint atoms and can thus write their segment indices concurrently
+            std::vector<std::vector<MolecularStructure::BackboneSegment>> segments(
+                data.chains.size());
+            state.chainSegmentIndices.resize(atomCount, 0);
+            util::forEachRangeParallel(data.chains.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    segments[i] = computeBackboneSegments(data, state, i, state.chainSegmentIndices);
+                }
+            });
+            for (auto&& [i, c] : util::enumerate(data.chains)) {
+                state.chainSegments.try_emplace(c.id, std::move(segments[i]));
+            }
         }
     }
 
@@ -287,21 +356,114 @@ void verifyData(const MolecularData& data) {
     }
 }
 
+std::pair<dvec3, dvec3> computeBounds(const Atoms& atoms) {
+    const size_t atomCount = atoms.positions.size();
+    if (atomCount == 0) return {dvec3{0.0}, dvec3{0.0}};
+
+    const size_t chunkSize = 1 << 16;
+    const size_t numChunks = (atomCount + chunkSize - 1) / chunkSize;
+    std::vector<std::pair<dvec3, dvec3>> chunkBounds(
+        numChunks, {dvec3{std::numeric_limits<double>::max()},
+                    dvec3{std::numeric_limits<double>::lowest()}});
+
+    util::forEachRangeParallel(atomCount, chunkSize, [&](size_t begin, size_t end) {
+        auto& [worldMin, worldMax] = chunkBounds[begin / chunkSize];
+        for (size_t i = begin; i < end; ++i) {
+            const dvec3 radius{element::vdwRadius(
+                atoms.atomicNumbers.empty() ? Element::Unknown : atoms.atomicNumbers[i])};
+            worldMin = glm::min(worldMin, atoms.positions[i] - radius);
+            worldMax = glm::max(worldMax, atoms.positions[i] + radius);
+        }
+    });
+
+    auto bounds = chunkBounds.front();
+    for (const auto& [chunkMin, chunkMax] : chunkBounds) {
+        bounds.first = glm::min(bounds.first, chunkMin);
+        bounds.second = glm::max(bounds.second, chunkMax);
+    }
+    return bounds;
+}
+
+/*
+ * Bounds of all instances of the atoms within \p bounds, each instance contributes the transformed
+ * corners of \p bounds.
+ */
+std::pair<dvec3, dvec3> instanceBounds(const std::pair<dvec3, dvec3>& bounds,
+                                       const std::vector<dmat4>& instances) {
+    if (instances.empty()) return bounds;
+
+    std::pair<dvec3, dvec3> result{dvec3{std::numeric_limits<double>::max()},
+                                   dvec3{std::numeric_limits<double>::lowest()}};
+    for (const auto& instance : instances) {
+        for (int corner = 0; corner < 8; ++corner) {
+            const dvec3 p{(corner & 1) ? bounds.second.x : bounds.first.x,
+                          (corner & 2) ? bounds.second.y : bounds.first.y,
+                          (corner & 4) ? bounds.second.z : bounds.first.z};
+            const dvec3 transformed{instance * dvec4{p, 1.0}};
+            result.first = glm::min(result.first, transformed);
+            result.second = glm::max(result.second, transformed);
+        }
+    }
+    return result;
+}
+
+MolecularData frameData(const MolecularData& topology, std::vector<dvec3> positions) {
+    if (positions.size() != topology.atoms.positions.size()) {
+        throw Exception(fmt::format("Number of positions ({}) does not match number of atoms ({})",
+                                    positions.size(), topology.atoms.positions.size()),
+                        IVW_CONTEXT_CUSTOM("MolecularStructure::MolecularStructure()"));
+    }
+
+    // copy everything but the positions
+    MolecularData data;
+    data.source = topology.source;
+    data.atoms.positions = std::move(positions);
+    data.atoms.serialNumbers = topology.atoms.serialNumbers;
+    data.atoms.bFactors = topology.atoms.bFactors;
+    data.atoms.modelIds = topology.atoms.modelIds;
+    data.atoms.chainIds = topology.atoms.chainIds;
+    data.atoms.residueIds = topology.atoms.residueIds;
+    data.atoms.atomicNumbers = topology.atoms.atomicNumbers;
+    data.atoms.fullNames = topology.atoms.fullNames;
+    data.residues = topology.residues;
+    data.chains = topology.chains;
+    data.bonds = topology.bonds;
+    data.instances = topology.instances;
+    return data;
+}
+
 }  // namespace detail
 
-MolecularStructure::MolecularStructure(MolecularData data) : data_{std::move(data)} {
+MolecularStructure::MolecularStructure(MolecularData data, std::shared_ptr<const AtomGrid> grid)
+    : data_{std::move(data)}, atomGrid_{std::move(grid)} {
     detail::verifyData(data_);
 
+    if (!atomGrid_) {
+        atomGrid_ = std::make_shared<AtomGrid>(data_.atoms.positions, maxCovalentBondLength);
+    } else if (atomGrid_->atomIndices().size() != data_.atoms.positions.size()) {
+        throw Exception(fmt::format("Number of atoms ({}) does not match atom grid ({})",
+                                    data_.atoms.positions.size(), atomGrid_->atomIndices().size()),
+                        IVW_CONTEXT);
+    }
+
     if (!data_.atoms.residueIds.empty() && !data_.residues.empty() &&
         !data_.atoms.chainIds.empty()) {
-        auto state = detail::createInternalState(data_);
-        chainResidues_ = std::move(state.chainResidues);
-        residueAtoms_ = std::move(state.residueAtoms);
-        residueIndices_ = std::move(state.residueIndices);
-        atomResidueIndices_ = std::move(state.atomResidueIndices);
-        chainSegments_ = std::move(state.chainSegments);
-        chainSegmentIndices_ = std::move(state.chainSegmentIndices);
+        state_ = std::make_shared<detail::InternalState>(detail::createInternalState(data_));
+    } else {
+        state_ = std::make_shared<detail::InternalState>();
     }
+    chainSegments_ = state_->chainSegments;
+    bounds_ = detail::instanceBounds(detail::computeBounds(data_.atoms), data_.instances);
+}
+
+MolecularStructure::MolecularStructure(const MolecularStructure& topology,
+                                       std::vector<dvec3> positions)
+    : data_{detail::frameData(topology.data_, std::move(positions))}
+    , state_{topology.state_}
+    , chainSegments_{topology.chainSegments_}
+    , atomGrid_{std::make_shared<AtomGrid>(*topology.atomGrid_, data_.atoms.positions)}
+    , bounds_{detail::instanceBounds(detail::computeBounds(data_.atoms), data_.instances)} {
+    detail::computeDihedralAngles(chainSegments_, state_->residueIndices, data_);
 }
 
 const MolecularData& MolecularStructure::data() const { return data_; }
@@ -314,17 +476,23 @@ const std::vector<Chain>& MolecularStructure::chains() const { return data_.chai
 
 const std::vector<Bond>& MolecularStructure::bonds() const { return data_.bonds; }
 
+const std::vector<dmat4>& MolecularStructure::instances() const { return data_.instances; }
+
+size_t MolecularStructure::getNumberOfInstances() const {
+    return std::max<size_t>(data_.instances.size(), 1);
+}
+
 std::optional<size_t> MolecularStructure::getAtomIndex(std::string_view fullAtomName, int residueId,
                                                        int chainId) const {
-    if (auto resIt = residueAtoms_.find({residueId, chainId}); resIt != residueAtoms_.end()) {
-        auto pred = [&](size_t i) {
-            return ((data_.atoms.fullNames[i] == fullAtomName) &&
-                    (data_.atoms.residueIds[i] == residueId) &&
-                    (data_.atoms.chainIds[i] == chainId));
-        };
-
-        if (auto atomIt = util::find_if(resIt->second, pred); atomIt != resIt->second.end()) {
-            return std::distance(resIt->second.begin(), atomIt);
+    if (data_.atoms.fullNames.empty()) return std::nullopt;
+
+    const auto& residueIndices = state_->residueIndices;
+    if (auto resIt = residueIndices.find({residueId, chainId}); resIt != residueIndices.end()) {
+        const auto atoms = state_->residueAtoms[resIt->second];
+        auto pred = [&](size_t i) { return data_.atoms.fullNames[i] == fullAtomName; };
+
+        if (auto atomIt = std::find_if(atoms.begin(), atoms.end(), pred); atomIt != atoms.end()) {
+            return *atomIt;
         }
     }
     return std::nullopt;
@@ -332,21 +500,22 @@ std::optional<size_t> MolecularStructure::getAtomIndex(std::string_view fullAtom
 
 bool MolecularStructure::hasAtoms() const { return !data_.atoms.positions.empty(); }
 
-bool MolecularStructure::hasResidues() const { return !atomResidueIndices_.empty(); }
+bool MolecularStructure::hasResidues() const { return !state_->atomResidueIndices.empty(); }
 
 bool MolecularStructure::hasResidue(int residueId, int chainId) const {
-    return residueAtoms_.find({residueId, chainId}) != residueAtoms_.end();
+    return state_->residueIndices.find({residueId, chainId}) != state_->residueIndices.end();
 }
 
-bool MolecularStructure::hasChains() const { return !chainResidues_.empty(); }
+bool MolecularStructure::hasChains() const { return !state_->chainIndices.empty(); }
 
 bool MolecularStructure::hasChain(int chainId) const {
-    return chainResidues_.find(chainId) != chainResidues_.end();
+    return state_->chainIndices.find(chainId) != state_->chainIndices.end();
 }
 
-const std::vector<size_t>& MolecularStructure::getResidueAtoms(int residueId, int chainId) const {
-    if (auto it = residueAtoms_.find({residueId, chainId}); it != residueAtoms_.end()) {
-        return it->second;
+Span<size_t> MolecularStructure::getResidueAtoms(int residueId, int chainId) const {
+    if (auto it = state_->residueIndices.find({residueId, chainId});
+        it != state_->residueIndices.end()) {
+        return state_->residueAtoms[it->second];
     } else {
         throw Exception(fmt::format("Residue with ID '{}' and chain ID '{}' does not exist",
                                     residueId, chainId),
@@ -354,9 +523,9 @@ const std::vector<size_t>& MolecularStructure::getResidueAtoms(int residueId, in
     }
 }
 
-const std::vector<size_t>& MolecularStructure::getChainResidues(int chainId) const {
-    if (auto it = chainResidues_.find(chainId); it != chainResidues_.end()) {
-        return it->second;
+Span<size_t> MolecularStructure::getChainResidues(int chainId) const {
+    if (auto it = state_->chainIndices.find(chainId); it != state_->chainIndices.end()) {
+        return state_->chainResidues[it->second];
     } else {
         throw Exception(fmt::format("Chain with chain ID '{}' does not exist", chainId),
                         IVW_CONTEXT);
@@ -374,11 +543,23 @@ auto MolecularStructure::getBackboneSegments(int chainId) const
 }
 
 const std::vector<size_t>& MolecularStructure::getResidueIndices() const {
-    return atomResidueIndices_;
+    return state_->atomResidueIndices;
+}
+
+const std::vector<size_t>& MolecularStructure::getResidueChainIndices() const {
+    return state_->residueChainIndices;
 }
 
 const std::vector<size_t>& MolecularStructure::getBackboneSegmentIndices() const {
-    return chainSegmentIndices_;
+    return state_->chainSegmentIndices;
+}
+
+const AtomGrid& MolecularStructure::getAtomGrid() const { return *atomGrid_; }
+
+const std::pair<dvec3, dvec3>& MolecularStructure::getBounds() const { return bounds_; }
+
+bool MolecularStructure::sharesTopology(const MolecularStructure& other) const {
+    return state_ == other.state_;
 }
 
 }  // namespace molvis
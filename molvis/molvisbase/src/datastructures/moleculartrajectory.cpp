@@ -0,0 +1,222 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/datastructures/moleculartrajectory.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/exception.h>
+
+#include <chrono>
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+template <typename T>
+size_t vectorBytes(const std::vector<T>& values) {
+    return values.size() * sizeof(T);
+}
+
+// Estimated memory of a frame, without the acceleration structures shared with the topology
+size_t frameBytes(const MolecularStructure& structure) {
+    const auto& atoms = structure.atoms();
+    return vectorBytes(atoms.positions) + vectorBytes(atoms.serialNumbers) +
+           vectorBytes(atoms.bFactors) + vectorBytes(atoms.modelIds) +
+           vectorBytes(atoms.chainIds) + vectorBytes(atoms.residueIds) +
+           vectorBytes(atoms.atomicNumbers) + vectorBytes(atoms.fullNames) +
+           vectorBytes(structure.residues()) + vectorBytes(structure.chains()) +
+           vectorBytes(structure.bonds());
+}
+
+}  // namespace
+
+MolecularTrajectory::MolecularTrajectory(std::shared_ptr<const MolecularStructure> topology,
+                                         size_t numFrames, Loader loader, size_t prefetch,
+                                         size_t cacheSize)
+    : state_{std::make_shared<State>()} {
+    if (!topology) {
+        throw Exception("MolecularTrajectory: topology is missing", IVW_CONTEXT);
+    }
+    state_->topology = std::move(topology);
+    state_->loader = std::move(loader);
+    state_->numFrames = numFrames;
+    state_->prefetch = prefetch;
+    state_->cacheSize = cacheSize;
+    state_->registration = MemoryBudget::global().add(
+        "Molecular trajectory", MemoryBudget::Priority::Normal,
+        [weak = std::weak_ptr<State>{state_}](size_t bytes) {
+            auto self = weak.lock();
+            if (!self) return;
+            std::unique_lock lock{self->mutex, std::try_to_lock};
+            if (!lock) return;
+            self->evictTo(self->memoryUsage > bytes ? self->memoryUsage - bytes : 0);
+        });
+}
+
+size_t MolecularTrajectory::size() const { return state_->numFrames; }
+
+const std::shared_ptr<const MolecularStructure>& MolecularTrajectory::getTopology() const {
+    return state_->topology;
+}
+
+std::shared_ptr<const MolecularStructure> MolecularTrajectory::get(size_t frame) const {
+    return use(frame).get();
+}
+
+std::shared_ptr<const MolecularStructure> MolecularTrajectory::tryGet(size_t frame) const {
+    const auto structure = use(frame);
+    if (structure.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return nullptr;
+    return structure.get();
+}
+
+void MolecularTrajectory::prefetch(size_t frame) const { use(frame); }
+
+bool MolecularTrajectory::isLoaded(size_t frame) const {
+    std::scoped_lock lock{state_->mutex};
+    const auto it = state_->frames.find(frame);
+    return it != state_->frames.end() && it->second.loaded;
+}
+
+void MolecularTrajectory::setPrefetch(size_t prefetch) {
+    std::scoped_lock lock{state_->mutex};
+    state_->prefetch = prefetch;
+    state_->evict();
+}
+
+size_t MolecularTrajectory::getPrefetch() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->prefetch;
+}
+
+void MolecularTrajectory::setCacheSize(size_t frames) {
+    std::scoped_lock lock{state_->mutex};
+    state_->cacheSize = frames;
+    state_->evict();
+}
+
+size_t MolecularTrajectory::getCacheSize() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->cacheSize;
+}
+
+auto MolecularTrajectory::onLoaded(Callback callback) const -> std::shared_ptr<Callback> {
+    std::scoped_lock lock{state_->callbackMutex};
+    return state_->loaded.add(std::move(callback));
+}
+
+std::shared_future<std::shared_ptr<const MolecularStructure>> MolecularTrajectory::use(
+    size_t frame) const {
+    if (frame >= state_->numFrames) {
+        throw RangeException(
+            fmt::format("Frame {} out of range [0, {})", frame, state_->numFrames), IVW_CONTEXT);
+    }
+
+    std::scoped_lock lock{state_->mutex};
+    if (auto it = state_->frames.find(frame); it != state_->frames.end() && it->second.loaded) {
+        state_->registration->hit();
+    } else {
+        state_->registration->miss();
+    }
+    state_->current = frame;
+    auto structure = state_->request(frame, state_).structure;
+    for (size_t i = 1; i <= std::min(state_->prefetch, state_->numFrames - 1); ++i) {
+        state_->request((frame + i) % state_->numFrames, state_);
+    }
+    state_->evict();
+
+    return structure;
+}
+
+auto MolecularTrajectory::State::request(size_t frame, const std::shared_ptr<State>& self)
+    -> Frame& {
+    auto it = frames.find(frame);
+    if (it == frames.end()) {
+        it = frames.emplace(frame, Frame{}).first;
+
+        auto promise = std::make_shared<std::promise<std::shared_ptr<const MolecularStructure>>>();
+        it->second.structure = promise->get_future().share();
+
+        dispatchPool([self, frame, promise]() {
+            try {
+                std::shared_ptr<const MolecularStructure> structure =
+                    std::make_shared<MolecularStructure>(*self->topology, self->loader(frame));
+                const auto bytes = frameBytes(*structure);
+                {
+                    std::scoped_lock lock{self->mutex};
+                    if (auto loaded = self->frames.find(frame); loaded != self->frames.end()) {
+                        loaded->second.loaded = true;
+                        loaded->second.bytes = bytes;
+                        self->memoryUsage += bytes;
+                        self->registration->setUsage(self->memoryUsage);
+                        self->evict();
+                    }
+                }
+                promise->set_value(std::move(structure));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+
+            std::scoped_lock lock{self->callbackMutex};
+            self->loaded.invoke(frame);
+        });
+    }
+
+    it->second.lastUse = ++useCounter;
+    return it->second;
+}
+
+bool MolecularTrajectory::State::inWindow(size_t frame) const {
+    return (frame + numFrames - current) % numFrames <= prefetch;
+}
+
+void MolecularTrajectory::State::evict() { evictTo(registration->allowance()); }
+
+void MolecularTrajectory::State::evictTo(size_t bytes) {
+    const auto usage = memoryUsage;
+    while (frames.size() > cacheSize || memoryUsage > bytes) {
+        auto victim = frames.end();
+        for (auto it = frames.begin(); it != frames.end(); ++it) {
+            if (it->second.loaded && !inWindow(it->first) &&
+                (victim == frames.end() || it->second.lastUse < victim->second.lastUse)) {
+                victim = it;
+            }
+        }
+        if (victim == frames.end()) break;
+
+        memoryUsage -= victim->second.bytes;
+        frames.erase(victim);
+    }
+    if (memoryUsage != usage) registration->setUsage(memoryUsage);
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,279 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/io/basicmmcifreader.h>
+
+#include <inviwo/core/util/fileextension.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/io/datareaderexception.h>
+
+#include <inviwo/molvisbase/io/readerutils.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/molvisbase/util/molvisutils.h>
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+namespace inviwo {
+
+BasicMMCIFReader::BasicMMCIFReader() {
+    addExtension(FileExtension("cif", "Macromolecular Crystallographic Information File (mmCIF)"));
+}
+
+BasicMMCIFReader* BasicMMCIFReader::clone() const { return new BasicMMCIFReader(*this); }
+
+namespace {
+
+constexpr std::string_view atomSitePrefix = "_atom_site.";
+
+struct Record {
+    std::string_view line;
+    int lineNumber;
+};
+
+constexpr bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+/**
+ * Split \p line into whitespace separated tokens. A quoted token ends at the matching quote
+ * followed by whitespace, which allows quotes within, e.g. 'O5'' for atom names.
+ */
+void tokenize(std::string_view line, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        if (isSpace(line[i])) {
+            ++i;
+        } else if (line[i] == '\'' || line[i] == '"') {
+            const char quote = line[i];
+            size_t end = i + 1;
+            while ((end < line.size()) &&
+                   !((line[end] == quote) && (end + 1 == line.size() || isSpace(line[end + 1])))) {
+                ++end;
+            }
+            tokens.push_back(line.substr(i + 1, end - i - 1));
+            i = end + 1;
+        } else {
+            size_t end = i;
+            while ((end < line.size()) && !isSpace(line[end])) {
+                ++end;
+            }
+            tokens.push_back(line.substr(i, end - i));
+            i = end;
+        }
+    }
+}
+
+/// '?' denotes an unknown and '.' an inapplicable value
+constexpr bool isMissing(std::string_view value) { return value == "?" || value == "."; }
+
+template <typename T>
+T parseColumn(const std::vector<std::string_view>& tokens, std::optional<size_t> column,
+              std::string_view name, const Record& record, T fallback = T{}) {
+    if (!column || isMissing(tokens[*column])) {
+        return fallback;
+    }
+    T res = T{};
+    if (!molvis::detail::fromStr(tokens[*column], res)) {
+        throw DataReaderException(
+            fmt::format("BasicMMCIFReader: invalid {}{} entry detected ({})\n'{}'", atomSitePrefix,
+                        name, record.lineNumber, record.line),
+            IVW_CONTEXT_CUSTOM("BasicMMCIFReader"));
+    }
+    return res;
+}
+
+std::string_view getColumn(const std::vector<std::string_view>& tokens,
+                           std::optional<size_t> column, std::optional<size_t> fallback = {}) {
+    if (column && !isMissing(tokens[*column])) {
+        return tokens[*column];
+    } else if (fallback && !isMissing(tokens[*fallback])) {
+        return tokens[*fallback];
+    }
+    return {};
+}
+
+}  // namespace
+
+std::shared_ptr<molvis::MolecularStructure> BasicMMCIFReader::readData(
+    const std::string& fileName) {
+    auto file = filesystem::ifstream(fileName);
+
+    if (!file.is_open()) {
+        throw FileException(fmt::format("BasicMMCIFReader: Could not open file '{}'", fileName),
+                            IVW_CONTEXT);
+    }
+    std::string contents;
+    file.seekg(0, std::ios::end);
+    contents.reserve(file.tellg());
+    file.seekg(0, std::ios::beg);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // First pass: locate the column names and rows of the first _atom_site loop
+    enum class State { None, LoopHeader, AtomSiteHeader, AtomSiteRows, Done };
+    State state = State::None;
+    std::vector<std::string_view> columns;
+    std::vector<Record> records;
+
+    int lineNumber = 0;
+    auto parseline = [&](std::string_view line) {
+        ++lineNumber;
+        if (state == State::Done) return;
+
+        const auto trimmed = util::trim(line);
+        if (trimmed.empty()) return;
+
+        const bool isAtomSiteItem = trimmed.substr(0, atomSitePrefix.size()) == atomSitePrefix;
+        if (state == State::AtomSiteHeader && !isAtomSiteItem) {
+            state = State::AtomSiteRows;
+        }
+
+        if (state == State::AtomSiteRows) {
+            if (trimmed[0] != '#' && trimmed[0] != '_' && trimmed.substr(0, 5) != "loop_" &&
+                trimmed.substr(0, 5) != "data_") {
+                if (trimmed[0] == ';') {
+                    throw DataReaderException(
+                        fmt::format("BasicMMCIFReader: multi-line values are not supported in "
+                                    "_atom_site ({})",
+                                    lineNumber),
+                        IVW_CONTEXT_CUSTOM("BasicMMCIFReader"));
+                }
+                records.push_back({trimmed, lineNumber});
+                return;
+            }
+            state = State::Done;
+        } else if (trimmed.substr(0, 5) == "loop_") {
+            state = State::LoopHeader;
+        } else if ((state == State::LoopHeader || state == State::AtomSiteHeader) &&
+                   isAtomSiteItem) {
+            columns.push_back(util::trim(trimmed.substr(atomSitePrefix.size())));
+            state = State::AtomSiteHeader;
+        } else if (trimmed[0] != '_') {
+            state = State::None;
+        }
+    };
+
+    util::forEachStringPart(contents, "\n", parseline);
+
+    auto column = [&](std::string_view name) -> std::optional<size_t> {
+        auto it = std::find(columns.begin(), columns.end(), name);
+        if (it == columns.end()) return std::nullopt;
+        return static_cast<size_t>(std::distance(columns.begin(), it));
+    };
+    const auto x = column("Cartn_x");
+    const auto y = column("Cartn_y");
+    const auto z = column("Cartn_z");
+    if (!x || !y || !z) {
+        throw DataReaderException(
+            fmt::format("BasicMMCIFReader: no atom coordinates found in '{}'", fileName),
+            IVW_CONTEXT);
+    }
+    const auto serialNumber = column("id");
+    const auto element = column("type_symbol");
+    const auto atomName = column("label_atom_id");
+    const auto authResName = column("auth_comp_id");
+    const auto labelResName = column("label_comp_id");
+    const auto authChainName = column("auth_asym_id");
+    const auto labelChainName = column("label_asym_id");
+    const auto authResId = column("auth_seq_id");
+    const auto labelResId = column("label_seq_id");
+    const auto bFactor = column("B_iso_or_equiv");
+    const auto model = column("pdbx_PDB_model_num");
+
+    molvis::MolecularData data;
+    data.source = filesystem::getFileNameWithExtension(fileName);
+    auto& atoms = data.atoms;
+
+    // Second pass, parallel: tokenize and parse the rows
+    const auto numAtoms = records.size();
+    atoms.positions.resize(numAtoms);
+    atoms.serialNumbers.resize(numAtoms);
+    atoms.bFactors.resize(numAtoms);
+    atoms.modelIds.resize(numAtoms);
+    atoms.residueIds.resize(numAtoms);
+    atoms.atomicNumbers.resize(numAtoms);
+    atoms.fullNames.resize(numAtoms);
+    std::vector<std::string_view> chainNames(numAtoms);
+    std::vector<std::string_view> residueNames(numAtoms);
+    util::forEachRangeParallel(numAtoms, size_t{1} << 14, [&](size_t begin, size_t end) {
+        std::vector<std::string_view> tokens;
+        tokens.reserve(columns.size());
+        for (size_t i = begin; i < end; ++i) {
+            const auto& record = records[i];
+            tokenize(record.line, tokens);
+            if (tokens.size() != columns.size()) {
+                throw DataReaderException(
+                    fmt::format("BasicMMCIFReader: expected {} values in _atom_site row, got {} "
+                                "({})\n'{}'",
+                                columns.size(), tokens.size(), record.lineNumber, record.line),
+                    IVW_CONTEXT_CUSTOM("BasicMMCIFReader"));
+            }
+
+            atoms.positions[i] = dvec3{parseColumn<double>(tokens, x, "Cartn_x", record),
+                                       parseColumn<double>(tokens, y, "Cartn_y", record),
+                                       parseColumn<double>(tokens, z, "Cartn_z", record)};
+            atoms.serialNumbers[i] = parseColumn<int>(tokens, serialNumber, "id", record);
+            atoms.bFactors[i] = parseColumn<double>(tokens, bFactor, "B_iso_or_equiv", record);
+            atoms.modelIds[i] = parseColumn<int>(tokens, model, "pdbx_PDB_model_num", record);
+            if (authResId && !isMissing(tokens[*authResId])) {
+                atoms.residueIds[i] = parseColumn<int>(tokens, authResId, "auth_seq_id", record);
+            } else {
+                atoms.residueIds[i] = parseColumn<int>(tokens, labelResId, "label_seq_id", record);
+            }
+            atoms.fullNames[i] = getColumn(tokens, atomName);
+            if (auto elem = molvis::element::fromAbbr(getColumn(tokens, element));
+                elem != molvis::Element::Unknown) {
+                atoms.atomicNumbers[i] = elem;
+            } else {
+                atoms.atomicNumbers[i] = molvis::element::fromFullName(atoms.fullNames[i]);
+            }
+            chainNames[i] = getColumn(tokens, authChainName, labelChainName);
+            residueNames[i] = getColumn(tokens, authResName, labelResName);
+        }
+    });
+
+    // Third pass, sequential: register chains and residues
+    molvis::MolecularDataBuilder builder{data};
+    atoms.chainIds.resize(numAtoms);
+    for (size_t i = 0; i < numAtoms; ++i) {
+        atoms.chainIds[i] = builder.addChain(chainNames[i]);
+        builder.addResidue(atoms.residueIds[i], residueNames[i], atoms.chainIds[i]);
+    }
+
+    auto grid =
+        std::make_shared<molvis::AtomGrid>(data.atoms.positions, molvis::maxCovalentBondLength);
+    data.bonds = molvis::computeCovalentBonds(data.atoms, *grid);
+
+    return std::make_shared<molvis::MolecularStructure>(std::move(data), std::move(grid));
+}
+
+}  // namespace inviwo
@@ -34,13 +34,11 @@
 #include <inviwo/core/util/stringconversion.h>
 #include <inviwo/core/io/datareaderexception.h>
 
+#include <inviwo/molvisbase/io/readerutils.h>
+#include <inviwo/utilities/util/parallel.h>
 #include <inviwo/molvisbase/util/molvisutils.h>
-#include <inviwo/molvisbase/util/chain.h>
-#include <inviwo/molvisbase/util/aminoacid.h>
 
 #include <string_view>
-#include <sstream>
-#include <charconv>
 #include <fmt/format.h>
 
 namespace inviwo {
@@ -51,52 +49,11 @@ BasicPDBReader::BasicPDBReader() {
 
 BasicPDBReader* BasicPDBReader::clone() const { return new BasicPDBReader(*this); }
 
-namespace detail {
-
-namespace config {
-#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
-constexpr bool charconv = true;
-#else
-constexpr bool charconv = false;
-#endif
-}  // namespace config
-
-template <class T>
-bool fromStr(std::string_view value, T& dest, bool parseHexadecimal = false) {
-    std::string_view trimmed = util::trim(value);
-    if constexpr (std::is_same_v<std::string, T>) {
-        dest = std::string(trimmed);
-    } else if constexpr (config::charconv &&
-                         (std::is_same_v<double, T> || std::is_same_v<float, T>)) {
-        const auto end = trimmed.data() + trimmed.size();
-        if (auto [p, ec] = std::from_chars(trimmed.data(), end, dest);
-            ec != std::errc() || p != end) {
-            return false;
-        }
-    } else if constexpr (config::charconv && (std::is_integral_v<T> && !std::is_same_v<bool, T>)) {
-        const auto end = trimmed.data() + trimmed.size();
-        const int base = parseHexadecimal ? 16 : 10;
-        if (auto [p, ec] = std::from_chars(trimmed.data(), end, dest, base);
-            ec != std::errc() || p != end) {
-            return false;
-        }
-    } else {
-        std::istringstream stream{std::string{trimmed}};
-        if (std::is_integral_v<T> && parseHexadecimal) {
-            stream >> std::hex;
-        }
-        stream >> dest;
-    }
-    return true;
-}
-
-}  // namespace detail
-
 template <typename T>
 T parseSection(std::string_view line, size_t begin, size_t size, std::string_view tag,
                std::string_view desc, int lineNumber, bool parseHexadecimal = false) {
     T res = T{};
-    if (!detail::fromStr(line.substr(begin, size), res, parseHexadecimal)) {
+    if (!molvis::detail::fromStr(line.substr(begin, size), res, parseHexadecimal)) {
         throw DataReaderException(
             fmt::format("BasicPDBReader: invalid {} entry detected{} ({})\n'{}'", tag,
                         desc.empty() ? "" : fmt::format(", {}", desc), lineNumber, line),
@@ -121,6 +78,17 @@ std::shared_ptr<molvis::MolecularStructure> BasicPDBReader::readData(const std::
     molvis::MolecularData data;
     data.source = filesystem::getFileNameWithExtension(fileName);
 
+    // First pass, sequential: model, serial numbers, and residue IDs depend on the preceding
+    // records. Chains and residues are registered on the fly.
+    struct Record {
+        std::string_view line;
+        std::string_view tag;
+        int lineNumber;
+    };
+    std::vector<Record> records;
+    molvis::MolecularDataBuilder builder{data};
+    auto& atoms = data.atoms;
+
     int lineNumber = 0;
     int currentModel = 0;
     bool serialNoHexBase = false;
@@ -140,8 +108,6 @@ std::shared_ptr<molvis::MolecularStructure> BasicPDBReader::readData(const std::
                 serialNoHexBase = true;
             }
 
-            std::string_view fullName(util::trim(line.substr(12, 4)));
-            std::string_view element(util::trim(line.substr(76, 2)));
             std::string_view residueName(util::trim(line.substr(17, 4)));
             std::string_view chainName(util::trim(line.substr(21, 1)));
 
@@ -151,43 +117,51 @@ std::shared_ptr<molvis::MolecularStructure> BasicPDBReader::readData(const std::
                 resIdHexBase = true;
             }
 
-            const dvec3 pos{parseSection<double>(line, 30, 8, tag, "invalid position", lineNumber),
-                            parseSection<double>(line, 38, 8, tag, "invalid position", lineNumber),
-                            parseSection<double>(line, 46, 8, tag, "invalid position", lineNumber)};
+            const int chainId = builder.addChain(chainName);
+            builder.addResidue(residueId, residueName, chainId);
 
-            const double bFactor =
-                parseSection<double>(line, 60, 6, tag, "invalid temperature factor", lineNumber);
+            records.push_back({line, tag, lineNumber});
+            atoms.serialNumbers.push_back(serialNumber);
+            atoms.modelIds.push_back(currentModel);
+            atoms.chainIds.push_back(chainId);
+            atoms.residueIds.push_back(residueId);
+        }
+    };
+
+    util::forEachStringPart(contents, "\n", parseline);
+
+    // Second pass, parallel: the remaining fields of each record are independent
+    const auto numAtoms = records.size();
+    atoms.positions.resize(numAtoms);
+    atoms.bFactors.resize(numAtoms);
+    atoms.atomicNumbers.resize(numAtoms);
+    atoms.fullNames.resize(numAtoms);
+    util::forEachRangeParallel(numAtoms, size_t{1} << 14, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& [line, tag, number] = records[i];
+
+            atoms.positions[i] =
+                dvec3{parseSection<double>(line, 30, 8, tag, "invalid position", number),
+                      parseSection<double>(line, 38, 8, tag, "invalid position", number),
+                      parseSection<double>(line, 46, 8, tag, "invalid position", number)};
+            atoms.bFactors[i] =
+                parseSection<double>(line, 60, 6, tag, "invalid temperature factor", number);
             [[maybe_unused]] const double occupancy =
-                parseSection<double>(line, 54, 6, tag, "invalid occupancy", lineNumber);
+                parseSection<double>(line, 54, 6, tag, "invalid occupancy", number);
             // charge is optional and might not exist in PDB file
             [[maybe_unused]] double charge = 0.0;
-            detail::fromStr(line.substr(78, 2), charge);
+            molvis::detail::fromStr(line.substr(78, 2), charge);
 
-            molvis::ChainId chain = molvis::chain::fromName(chainName);
-            int chainId = molvis::chain::id(chain);
-            if (!molvis::findChain(data, chainId)) {
-                data.chains.push_back({chainId, std::string(molvis::chain::name(chain))});
-            }
-            if (!molvis::findResidue(data, residueId, chainId)) {
-                data.residues.push_back({residueId, molvis::aminoacid::fromFullName(residueName),
-                                         std::string(residueName), chainId});
-            }
-            data.atoms.positions.push_back(pos);
-            data.atoms.serialNumbers.push_back(serialNumber);
-            data.atoms.bFactors.push_back(bFactor);
-            data.atoms.modelIds.push_back(currentModel);
-            data.atoms.chainIds.push_back(chainId);
-            data.atoms.residueIds.push_back(residueId);
-            data.atoms.atomicNumbers.push_back(molvis::element::fromAbbr(element));
-            data.atoms.fullNames.emplace_back(fullName);
+            atoms.atomicNumbers[i] = molvis::element::fromAbbr(util::trim(line.substr(76, 2)));
+            atoms.fullNames[i] = util::trim(line.substr(12, 4));
         }
-    };
-
-    util::forEachStringPart(contents, "\n", parseline);
+    });
 
-    data.bonds = molvis::computeCovalentBonds(data.atoms);
+    auto grid =
+        std::make_shared<molvis::AtomGrid>(data.atoms.positions, molvis::maxCovalentBondLength);
+    data.bonds = molvis::computeCovalentBonds(data.atoms, *grid);
 
-    return std::make_shared<molvis::MolecularStructure>(data);
+    return std::make_shared<molvis::MolecularStructure>(std::move(data), std::move(grid));
 }
 
 }  // namespace inviwo
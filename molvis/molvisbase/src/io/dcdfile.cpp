@@ -0,0 +1,189 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/io/dcdfile.h>
+
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/io/datareaderexception.h>
+
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+constexpr uint32_t swap32(uint32_t v) {
+    return (v >> 24) | ((v >> 8) & 0xff00u) | ((v << 8) & 0xff0000u) | (v << 24);
+}
+
+template <typename T>
+T fromRaw(uint32_t raw, bool swapBytes) {
+    static_assert(sizeof(T) == sizeof(uint32_t));
+    if (swapBytes) raw = swap32(raw);
+    T value;
+    std::memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+template <typename T>
+T readValue(std::istream& in, bool swapBytes) {
+    uint32_t raw = 0;
+    in.read(reinterpret_cast<char*>(&raw), sizeof(raw));
+    return fromRaw<T>(raw, swapBytes);
+}
+
+/**
+ * Read a Fortran unformatted record, which is enclosed by its size in bytes, into \p dest.
+ * @return false if the record size does not match \p size
+ */
+bool readRecord(std::istream& in, bool swapBytes, char* dest, size_t size) {
+    if (readValue<int32_t>(in, swapBytes) != static_cast<int32_t>(size)) return false;
+    in.read(dest, size);
+    return readValue<int32_t>(in, swapBytes) == static_cast<int32_t>(size) && in.good();
+}
+
+}  // namespace
+
+DCDFile::DCDFile(const std::string& fileName)
+    : fileName_{fileName}
+    , swapBytes_{false}
+    , hasUnitCell_{false}
+    , has4D_{false}
+    , numAtoms_{0}
+    , numFrames_{0}
+    , headerSize_{0}
+    , frameSize_{0} {
+    auto file = filesystem::ifstream(fileName_, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileException(fmt::format("DCDFile: Could not open file '{}'", fileName_),
+                            IVW_CONTEXT);
+    }
+    auto invalid = [&](std::string_view reason) {
+        return DataReaderException(fmt::format("DCDFile: {} '{}'", reason, fileName_),
+                                   IVW_CONTEXT);
+    };
+
+    // the first record holds 84 bytes, which also reveals the byte order
+    constexpr int32_t headerRecordSize = 84;
+    const auto marker = readValue<uint32_t>(file, false);
+    if (marker != headerRecordSize) {
+        if (swap32(marker) != headerRecordSize) throw invalid("Not a DCD file");
+        swapBytes_ = true;
+    }
+    std::array<char, 4> magic{};
+    file.read(magic.data(), magic.size());
+    if (std::string_view(magic.data(), magic.size()) != "CORD") {
+        throw invalid("Not a DCD coordinate file");
+    }
+    std::array<int32_t, 20> control{};
+    for (auto& value : control) {
+        value = readValue<int32_t>(file, swapBytes_);
+    }
+    if (readValue<int32_t>(file, swapBytes_) != headerRecordSize) {
+        throw invalid("Invalid header in");
+    }
+
+    // non-zero CHARMM version, X-PLOR files have neither unit cells nor 4D coordinates
+    const bool charmm = control[19] != 0;
+    hasUnitCell_ = charmm && control[10] != 0;
+    has4D_ = charmm && control[11] != 0;
+    const int32_t numFixedAtoms = control[8];
+    if (numFixedAtoms != 0) {
+        throw invalid("Trajectories with fixed atoms are not supported,");
+    }
+
+    // title, skipped
+    const auto titleSize = readValue<int32_t>(file, swapBytes_);
+    if (titleSize < 0) throw invalid("Invalid title in");
+    file.seekg(titleSize, std::ios::cur);
+    if (readValue<int32_t>(file, swapBytes_) != titleSize) throw invalid("Invalid title in");
+
+    int32_t numAtoms = 0;
+    if (!readRecord(file, swapBytes_, reinterpret_cast<char*>(&numAtoms), sizeof(numAtoms))) {
+        throw invalid("Invalid atom count in");
+    }
+    numAtoms = fromRaw<int32_t>(static_cast<uint32_t>(numAtoms), swapBytes_);
+    if (numAtoms <= 0) throw invalid("No atoms in");
+    numAtoms_ = static_cast<size_t>(numAtoms);
+
+    headerSize_ = static_cast<size_t>(file.tellg());
+    const size_t coordRecordSize = 2 * sizeof(int32_t) + numAtoms_ * sizeof(float);
+    frameSize_ = (hasUnitCell_ ? 2 * sizeof(int32_t) + 6 * sizeof(double) : 0) +
+                 (has4D_ ? 4 : 3) * coordRecordSize;
+
+    file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<size_t>(file.tellg());
+    numFrames_ = (fileSize - headerSize_) / frameSize_;
+}
+
+const std::string& DCDFile::getFileName() const { return fileName_; }
+
+size_t DCDFile::getNumberOfFrames() const { return numFrames_; }
+
+size_t DCDFile::getNumberOfAtoms() const { return numAtoms_; }
+
+std::vector<dvec3> DCDFile::readFrame(size_t frame) const {
+    if (frame >= numFrames_) {
+        throw RangeException(
+            fmt::format("DCDFile: frame {} out of range [0, {})", frame, numFrames_), IVW_CONTEXT);
+    }
+
+    auto file = filesystem::ifstream(fileName_, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw FileException(fmt::format("DCDFile: Could not open file '{}'", fileName_),
+                            IVW_CONTEXT);
+    }
+    const size_t unitCellSize = hasUnitCell_ ? 2 * sizeof(int32_t) + 6 * sizeof(double) : 0;
+    file.seekg(headerSize_ + frame * frameSize_ + unitCellSize);
+
+    std::vector<dvec3> positions(numAtoms_);
+    std::vector<uint32_t> coords(numAtoms_);
+    for (int dim = 0; dim < 3; ++dim) {
+        if (!readRecord(file, swapBytes_, reinterpret_cast<char*>(coords.data()),
+                        coords.size() * sizeof(float))) {
+            throw DataReaderException(
+                fmt::format("DCDFile: Invalid coordinates in frame {} of '{}'", frame, fileName_),
+                IVW_CONTEXT);
+        }
+        for (size_t i = 0; i < numAtoms_; ++i) {
+            positions[i][dim] = fromRaw<float>(coords[i], swapBytes_);
+        }
+    }
+    return positions;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,93 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/io/readerutils.h>
+#include <inviwo/molvisbase/util/chain.h>
+#include <inviwo/molvisbase/util/aminoacid.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+ResidueID toResidueID(int residueId, int chainId) {
+    return {static_cast<size_t>(residueId), static_cast<size_t>(chainId)};
+}
+
+}  // namespace
+
+MolecularDataBuilder::MolecularDataBuilder(MolecularData& data)
+    : data_{data}
+    , lastChainId_{0}
+    , nextChainId_{chain::num_chains - 1} {
+    for (auto& c : data_.chains) {
+        chains_.emplace(c.name, c.id);
+        nextChainId_ = std::max(nextChainId_, c.id + 1);
+    }
+    for (auto& r : data_.residues) {
+        residues_.insert(toResidueID(r.id, r.chainId));
+    }
+}
+
+int MolecularDataBuilder::addChain(std::string_view chainName) {
+    if (lastChainName_ && chainName == *lastChainName_) {
+        return lastChainId_;
+    }
+    lastChainName_ = std::string(chainName);
+    // names not covered by ChainId, i.e. longer mmCIF chain names, get their own IDs
+    const ChainId c = chain::fromName(chainName);
+    const bool enumerated = (c != ChainId::Unknown) || (chainName.size() <= 1);
+    const std::string key = enumerated ? std::string(chain::name(c)) : *lastChainName_;
+    auto [it, inserted] = chains_.try_emplace(key, 0);
+    if (inserted) {
+        it->second = enumerated ? chain::id(c) : nextChainId_++;
+        data_.chains.push_back({it->second, key});
+    }
+    lastChainId_ = it->second;
+    return lastChainId_;
+}
+
+void MolecularDataBuilder::addResidue(int residueId, std::string_view residueName, int chainId) {
+    const auto id = toResidueID(residueId, chainId);
+    if (lastResidue_ && id == *lastResidue_) {
+        return;
+    }
+    lastResidue_ = id;
+    if (residues_.insert(id).second) {
+        data_.residues.push_back(
+            {residueId, aminoacid::fromFullName(residueName), std::string(residueName), chainId});
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
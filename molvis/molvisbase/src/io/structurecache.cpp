@@ -0,0 +1,97 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/io/structurecache.h>
+
+#include <inviwo/molvisbase/molvisbasemodule.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+StructureCache::StructureCache(size_t capacity) : capacity_{capacity} {}
+
+std::shared_ptr<const MolecularStructure> StructureCache::get(const std::string& file,
+                                                              std::time_t modified) {
+    auto it = entries_.find(file);
+    if (it == entries_.end()) return nullptr;
+    if (it->second.modified != modified) {
+        entries_.erase(it);
+        return nullptr;
+    }
+    it->second.lastUse = ++useCounter_;
+    return it->second.structure;
+}
+
+void StructureCache::put(const std::string& file, std::time_t modified,
+                         std::shared_ptr<const MolecularStructure> structure) {
+    if (!structure) return;
+    entries_[file] = Entry{modified, std::move(structure), ++useCounter_};
+    evict(capacity_);
+}
+
+void StructureCache::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    evict(capacity_);
+}
+
+size_t StructureCache::getCapacity() const { return capacity_; }
+
+size_t StructureCache::size() const { return entries_.size(); }
+
+void StructureCache::clear() { entries_.clear(); }
+
+void StructureCache::evict(size_t capacity) {
+    if (entries_.size() <= capacity) return;
+
+    std::vector<decltype(entries_)::iterator> entries;
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        entries.push_back(it);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](auto a, auto b) { return a->second.lastUse < b->second.lastUse; });
+    for (size_t i = 0; i < entries.size() - capacity; ++i) {
+        entries_.erase(entries[i]);
+    }
+}
+
+StructureCache& getStructureCache(InviwoApplication* app) {
+    return app->getModuleByType<MolVisBaseModule>()->getStructureCache();
+}
+
+StructureCache& getStructureCache() { return getStructureCache(util::getInviwoApplication()); }
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -30,23 +30,31 @@
 #include <inviwo/molvisbase/molvisbasemodule.h>
 #include <inviwo/molvisbase/datavisualizer/molecularmeshvisualizer.h>
 #include <inviwo/molvisbase/datavisualizer/molecularsourcevisualizer.h>
+#include <inviwo/molvisbase/processors/molecularcontactmap.h>
 #include <inviwo/molvisbase/processors/molecularstructuresource.h>
 #include <inviwo/molvisbase/processors/molecularstructuretomesh.h>
+#include <inviwo/molvisbase/processors/moleculartrajectorysource.h>
 #include <inviwo/molvisbase/ports/molecularstructureport.h>
+#include <inviwo/molvisbase/io/basicmmcifreader.h>
 #include <inviwo/molvisbase/io/basicpdbreader.h>
 
 namespace inviwo {
 
 MolVisBaseModule::MolVisBaseModule(InviwoApplication* app) : InviwoModule(app, "MolVisBase") {
+    registerProcessor<MolecularContactMap>();
     registerProcessor<MolecularStructureSource>();
     registerProcessor<MolecularStructureToMesh>();
+    registerProcessor<MolecularTrajectorySource>();
 
     registerDefaultsForDataType<molvis::MolecularStructure>();
 
     registerDataReader(std::make_unique<BasicPDBReader>());
+    registerDataReader(std::make_unique<BasicMMCIFReader>());
 
     registerDataVisualizer(std::make_unique<MolecularMeshVisualizer>(app));
     registerDataVisualizer(std::make_unique<MolecularSourceVisualizer>(app));
 }
 
+molvis::StructureCache& MolVisBaseModule::getStructureCache() { return structures_; }
+
 }  // namespace inviwo
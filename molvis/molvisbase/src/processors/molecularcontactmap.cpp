@@ -0,0 +1,103 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/processors/molecularcontactmap.h>
+
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <inviwo/molvisbase/algorithm/contacts.h>
+
+#include <string>
+#include <string_view>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo MolecularContactMap::processorInfo_{
+    "org.inviwo.molvis.MolecularContactMap",  // Class identifier
+    "Molecular Contact Map",                  // Display name
+    "MolVis",                                 // Category
+    CodeState::Experimental,                  // Code state
+    "CPU, MolVis, DataFrame",                 // Tags
+};
+const ProcessorInfo MolecularContactMap::getProcessorInfo() const { return processorInfo_; }
+
+MolecularContactMap::MolecularContactMap()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , level_("level", "Level",
+             {{"atoms", "Atoms", Level::Atoms}, {"residues", "Residues", Level::Residues}}, 1)
+    , cutoff_("cutoff", "Cutoff (Å)", 4.0, 0.1, 20.0, 0.1)
+    , minSeparation_("minSeparation", "Min. Separation", 3, 0, 20) {
+
+    addPort(inport_);
+    addPort(outport_);
+
+    minSeparation_.visibilityDependsOn(
+        level_, [](auto& prop) { return prop.getSelectedValue() == Level::Residues; });
+
+    addProperties(level_, cutoff_, minSeparation_);
+}
+
+void MolecularContactMap::process() {
+    const auto& s = *inport_.getData();
+    auto dataframe = std::make_shared<DataFrame>();
+    auto addColumn = [&](const auto& contacts, std::string_view header, auto value) {
+        dataframe->addColumnFromBuffer(std::string{header},
+                                       util::makeBuffer(util::transform(contacts, value)));
+    };
+    auto distance = [](const auto& c) { return static_cast<float>(c.distance); };
+
+    if (level_ == Level::Atoms) {
+        const auto contacts = molvis::computeAtomContacts(s, cutoff_);
+        addColumn(contacts, "Atom 1",
+                  [](const molvis::AtomContact& c) { return static_cast<uint32_t>(c.atom1); });
+        addColumn(contacts, "Atom 2",
+                  [](const molvis::AtomContact& c) { return static_cast<uint32_t>(c.atom2); });
+        addColumn(contacts, "Distance", distance);
+    } else {
+        const auto contacts = molvis::computeResidueContacts(s, cutoff_, minSeparation_);
+        const auto& residues = s.residues();
+        using Contact = molvis::ResidueContact;
+        addColumn(contacts, "Residue 1", [&](const Contact& c) { return residues[c.residue1].id; });
+        addColumn(contacts, "Chain 1",
+                  [&](const Contact& c) { return residues[c.residue1].chainId; });
+        addColumn(contacts, "Residue 2", [&](const Contact& c) { return residues[c.residue2].id; });
+        addColumn(contacts, "Chain 2",
+                  [&](const Contact& c) { return residues[c.residue2].chainId; });
+        addColumn(contacts, "Distance", distance);
+    }
+    dataframe->updateIndexBuffer();
+
+    outport_.setData(dataframe);
+}
+
+}  // namespace inviwo
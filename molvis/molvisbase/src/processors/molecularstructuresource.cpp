@@ -29,6 +29,16 @@
 
 #include <inviwo/molvisbase/processors/molecularstructuresource.h>
 
+#include <inviwo/molvisbase/io/structurecache.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/io/datareaderfactory.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <fmt/format.h>
+
+#include <utility>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -42,7 +52,66 @@ const ProcessorInfo MolecularStructureSource::processorInfo_{
 const ProcessorInfo MolecularStructureSource::getProcessorInfo() const { return processorInfo_; }
 
 MolecularStructureSource::MolecularStructureSource(InviwoApplication* app, const std::string& file)
-    : DataSource<molvis::MolecularStructure, molvis::MolecularStructureOutport>(
-          app, file, "molecularstructure") {}
+    : PoolProcessor()
+    , app_(app)
+    , outport_("data")
+    , file_("filename", "File name", file, "molecularstructure")
+    , reload_("reload", "Reload data") {
+
+    addPort(outport_);
+
+    for (const auto& ext :
+         app_->getDataReaderFactory()->getExtensionsForType<molvis::MolecularStructure>()) {
+        file_.addNameFilter(ext);
+    }
+    reload_.onChange([this]() { bypassCache_ = true; });
+    addProperties(file_, reload_);
+}
+
+void MolecularStructureSource::process() {
+    const auto file = file_.get();
+    const bool bypassCache = std::exchange(bypassCache_, false);
+    if (file.empty()) {
+        outport_.clear();
+        return;
+    }
+    if (!filesystem::fileExists(file)) {
+        outport_.clear();
+        throw Exception(fmt::format("Could not find input file: '{}'", file), IVW_CONTEXT);
+    }
+
+    const auto modified = filesystem::fileModificationTime(file);
+    if (!bypassCache) {
+        if (auto structure = molvis::getStructureCache(app_).get(file, modified)) {
+            outport_.setData(structure);
+            return;
+        }
+    }
+
+    // the reader is created here, only reading the file happens on the background thread
+    const auto ext = toLower(filesystem::getFileExtension(file));
+    std::shared_ptr<DataReaderType<molvis::MolecularStructure>> reader =
+        app_->getDataReaderFactory()->getReaderForTypeAndExtension<molvis::MolecularStructure>(
+            ext);
+    if (!reader) {
+        outport_.clear();
+        throw Exception(fmt::format("No reader found for '{}'", file), IVW_CONTEXT);
+    }
+
+    using Result = std::shared_ptr<const molvis::MolecularStructure>;
+    // the readers do not report their progress, stopping discards the result once read
+    auto load = [reader, file](pool::Stop stop) -> Result {
+        Result structure = reader->readData(file);
+        if (stop) return nullptr;
+        return structure;
+    };
+
+    outport_.clear();
+    dispatchOne(load, [this, file, modified](Result result) {
+        molvis::getStructureCache(app_).put(file, modified, result);
+        outport_.setData(result);
+        newResults();
+    });
+}
 
 }  // namespace inviwo
@@ -32,9 +32,7 @@
 #include <inviwo/core/interaction/events/pickingevent.h>
 
 #include <inviwo/molvisbase/util/molvisutils.h>
-#include <inviwo/molvisbase/util/aminoacid.h>
-#include <inviwo/molvisbase/util/atomicelement.h>
-#include <inviwo/molvisbase/util/chain.h>
+#include <inviwo/molvisbase/util/molecularmesh.h>
 
 namespace inviwo {
 
@@ -118,51 +116,22 @@ void MolecularStructureToMesh::handlePicking(PickingEvent* p) {
 }
 
 std::vector<vec4> MolecularStructureToMesh::colors() const {
-    auto s = inport_.getData();
-    const size_t atomCount = s->atoms().positions.size();
-
-    using namespace molvis;
-
-    switch (coloring_) {
-        case Coloring::Atoms:
-            if (!s->atoms().atomicNumbers.empty()) {
-                std::vector<vec4> colors;
-                for (auto elem : s->atoms().atomicNumbers) {
-                    colors.emplace_back(element::color(elem, atomColormap_));
-                }
-                return colors;
-            } else {
-                return std::vector<vec4>(atomCount,
-                                         element::color(Element::Unknown, atomColormap_));
-            }
-        case Coloring::Residues:
-            if (s->hasResidues()) {
-                std::vector<vec4> colors;
-                const auto& residues = s->residues();
-                for (auto resIndex : s->getResidueIndices()) {
-                    colors.emplace_back(
-                        aminoacid::color(residues[resIndex].aminoacid, aminoColormap_));
-                }
-                return colors;
-            } else {
-                return std::vector<vec4>(atomCount,
-                                         aminoacid::color(AminoAcid::Unknown, aminoColormap_));
-            }
-        case Coloring::Chains:
-            if (s->hasChains()) {
-                std::vector<vec4> colors;
-                for (auto chainId : s->atoms().chainIds) {
-                    colors.emplace_back(chain::color(chainId));
-                }
-                return colors;
-            } else {
-                return std::vector<vec4>(atomCount, chain::color(ChainId::Unknown));
-            }
-        case Coloring::Fixed:
-        case Coloring::Default:
-        default:
-            return std::vector<vec4>(atomCount, fixedColor_);
-    }
+    const auto coloring = [&]() {
+        switch (coloring_) {
+            case Coloring::Atoms:
+                return molvis::Coloring::Atoms;
+            case Coloring::Residues:
+                return molvis::Coloring::Residues;
+            case Coloring::Chains:
+                return molvis::Coloring::Chains;
+            case Coloring::Fixed:
+            case Coloring::Default:
+            default:
+                return molvis::Coloring::Fixed;
+        }
+    }();
+    return molvis::atomColors(*inport_.getData(),
+                              {coloring, atomColormap_, aminoColormap_, fixedColor_});
 }
 
 }  // namespace inviwo
@@ -0,0 +1,128 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/processors/moleculartrajectorysource.h>
+#include <inviwo/molvisbase/io/dcdfile.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo MolecularTrajectorySource::processorInfo_{
+    "org.inviwo.MolecularTrajectorySource",  // Class identifier
+    "Molecular Trajectory Source",           // Display name
+    "Data Input",                            // Category
+    CodeState::Experimental,                 // Code state
+    "MolVis, Source, DCD"                    // Tags
+};
+const ProcessorInfo MolecularTrajectorySource::getProcessorInfo() const { return processorInfo_; }
+
+MolecularTrajectorySource::MolecularTrajectorySource()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , file_("trajectory", "Trajectory", "", "moleculartrajectory")
+    , frame_("frame", "Frame", 0, 0, 0)
+    , prefetch_("prefetch", "Prefetched frames", 4, 0, 64)
+    , cacheSize_("cacheSize", "Cached frames", 16, 1, 1024)
+    , waitForFrame_("waitForFrame", "Wait for frame", false) {
+    addPort(inport_);
+    addPort(outport_);
+
+    file_.clearNameFilters();
+    file_.addNameFilter("DCD trajectory (*.dcd)");
+    addProperties(file_, frame_, prefetch_, cacheSize_, waitForFrame_);
+
+    auto reset = [this]() {
+        onLoaded_.reset();
+        trajectory_.reset();
+        pending_ = std::numeric_limits<size_t>::max();
+    };
+    file_.onChange(reset);
+    inport_.onChange(reset);
+}
+
+void MolecularTrajectorySource::process() {
+    if (!trajectory_) {
+        if (file_.get().empty()) {
+            outport_.setData(inport_.getData());
+            return;
+        }
+
+        auto dcd = std::make_shared<molvis::DCDFile>(file_.get());
+        const auto topology = inport_.getData();
+        if (dcd->getNumberOfAtoms() != topology->atoms().positions.size()) {
+            LogError(fmt::format("Number of atoms in the trajectory ({}) does not match the input "
+                                 "structure ({})",
+                                 dcd->getNumberOfAtoms(), topology->atoms().positions.size()));
+            outport_.clear();
+            return;
+        }
+
+        trajectory_ = std::make_shared<molvis::MolecularTrajectory>(
+            topology, dcd->getNumberOfFrames(),
+            [dcd](size_t frame) { return dcd->readFrame(frame); }, prefetch_, cacheSize_);
+        frame_.setMaxValue(std::max<size_t>(trajectory_->size(), 1) - 1);
+
+        onLoaded_ = trajectory_->onLoaded([this](size_t frame) {
+            if (frame == pending_) {
+                dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+            }
+        });
+    } else {
+        trajectory_->setPrefetch(prefetch_);
+        trajectory_->setCacheSize(cacheSize_);
+    }
+
+    if (trajectory_->size() == 0) {
+        outport_.setData(trajectory_->getTopology());
+        return;
+    }
+
+    const auto frame = std::min(frame_.get(), trajectory_->size() - 1);
+    if (waitForFrame_) {
+        pending_ = std::numeric_limits<size_t>::max();
+        outport_.setData(trajectory_->get(frame));
+        return;
+    }
+
+    // Set before checking, a frame loaded in between still invalidates the processor
+    pending_ = frame;
+    if (auto structure = trajectory_->tryGet(frame)) {
+        pending_ = std::numeric_limits<size_t>::max();
+        outport_.setData(structure);
+    } else if (!outport_.hasData()) {
+        outport_.setData(trajectory_->getTopology());
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,178 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/util/molecularlod.h>
+
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/stdextensions.h>
+#include <inviwo/core/util/zip.h>
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+struct Proxies {
+    explicit Proxies(size_t size) : positions(size), colors(size), radii(size), picking(size) {}
+
+    std::shared_ptr<Mesh> createMesh() {
+        auto mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
+        std::vector<uint32_t> indices(positions.size());
+        std::iota(indices.begin(), indices.end(), 0);
+
+        mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
+        mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
+        mesh->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(std::move(radii)));
+        mesh->addBuffer(BufferType::PickingAttrib, util::makeBuffer(std::move(picking)));
+        mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
+                         util::makeIndexBuffer(std::move(indices)));
+        return mesh;
+    }
+
+    std::vector<vec3> positions;
+    std::vector<vec4> colors;
+    std::vector<float> radii;
+    std::vector<uint32_t> picking;
+};
+
+}  // namespace
+
+LodHierarchy createLodHierarchy(const MolecularStructure& s, const ColorMapping& colormap,
+                                uint32_t pickingId) {
+    const auto& positions = s.atoms().positions;
+    const auto& residues = s.residues();
+
+    LodHierarchy lod;
+    if (!s.hasResidues() || s.getResidueIndices().size() != positions.size()) {
+        lod.atomResidues.assign(positions.size(), LodHierarchy::none);
+        lod.residues = Proxies{0}.createMesh();
+        lod.chains = Proxies{0}.createMesh();
+        return lod;
+    }
+
+    const auto colors = atomColors(s, colormap);
+    const auto radii = atomRadii(s);
+
+    lod.atomResidues = util::transform(s.getResidueIndices(),
+                                       [](size_t index) { return static_cast<uint32_t>(index); });
+
+    std::unordered_map<int, uint32_t> chainIndices;
+    for (auto&& [index, chain] : util::enumerate(s.chains())) {
+        chainIndices[chain.id] = static_cast<uint32_t>(index);
+    }
+    lod.residueChains = util::transform(residues, [&](const Residue& res) {
+        auto it = chainIndices.find(res.chainId);
+        return it != chainIndices.end() ? it->second : LodHierarchy::none;
+    });
+
+    // bounding spheres of the atoms, centered at their mean position
+    Proxies residueProxies(residues.size());
+    std::vector<size_t> residueSizes(residues.size(), 0);
+    const auto residueProxy = [&](size_t i) {
+        const auto& res = residues[i];
+        const auto atoms = s.getResidueAtoms(res.id, res.chainId);
+        residueSizes[i] = atoms.size();
+        if (atoms.empty()) return;
+
+        dvec3 center{0.0};
+        dvec4 color{0.0};
+        size_t first = atoms.front();
+        for (auto atom : atoms) {
+            center += positions[atom];
+            color += dvec4{colors[atom]};
+            first = std::min(first, atom);
+        }
+        center /= static_cast<double>(atoms.size());
+        double radius = 0.0;
+        for (auto atom : atoms) {
+            radius = std::max(radius, glm::distance(center, positions[atom]) + radii[atom]);
+        }
+        residueProxies.positions[i] = vec3{center};
+        residueProxies.colors[i] = vec4{color / static_cast<double>(atoms.size())};
+        residueProxies.radii[i] = static_cast<float>(radius);
+        residueProxies.picking[i] = pickingId + static_cast<uint32_t>(first);
+    };
+    util::forEachRangeParallel(
+        residues.size(), util::defaultGrainSize(residues.size(), 64),
+        [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) residueProxy(i);
+        });
+
+    // bounding spheres of the residue spheres, centered at the mean atom position
+    Proxies chainProxies(s.hasChains() ? s.chains().size() : 0);
+    if (s.hasChains()) {
+        const auto chainProxy = [&](size_t i) {
+            const auto chainResidues = s.getChainResidues(s.chains()[i].id);
+            dvec3 center{0.0};
+            dvec4 color{0.0};
+            size_t atomCount = 0;
+            uint32_t picking = std::numeric_limits<uint32_t>::max();
+            for (auto res : chainResidues) {
+                if (residueSizes[res] == 0) continue;
+                const auto weight = static_cast<double>(residueSizes[res]);
+                center += dvec3{residueProxies.positions[res]} * weight;
+                color += dvec4{residueProxies.colors[res]} * weight;
+                atomCount += residueSizes[res];
+                picking = std::min(picking, residueProxies.picking[res]);
+            }
+            if (atomCount == 0) return;
+
+            center /= static_cast<double>(atomCount);
+            double radius = 0.0;
+            for (auto res : chainResidues) {
+                if (residueSizes[res] == 0) continue;
+                const dvec3 residueCenter{residueProxies.positions[res]};
+                radius = std::max(radius, glm::distance(center, residueCenter) +
+                                              residueProxies.radii[res]);
+            }
+            chainProxies.positions[i] = vec3{center};
+            chainProxies.colors[i] = vec4{color / static_cast<double>(atomCount)};
+            chainProxies.radii[i] = static_cast<float>(radius);
+            chainProxies.picking[i] = picking;
+        };
+        util::forEachRangeParallel(s.chains().size(), 1, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) chainProxy(i);
+        });
+    }
+
+    lod.residues = residueProxies.createMesh();
+    lod.chains = chainProxies.createMesh();
+    return lod;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
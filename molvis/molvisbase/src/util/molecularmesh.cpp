@@ -0,0 +1,214 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/util/molecularmesh.h>
+#include <inviwo/molvisbase/util/chain.h>
+
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace inviwo {
+
+namespace molvis {
+
+bool ColorMapping::operator==(const ColorMapping& rhs) const {
+    return coloring == rhs.coloring && atoms == rhs.atoms && aminoacids == rhs.aminoacids &&
+           fixedColor == rhs.fixedColor;
+}
+
+bool ColorMapping::operator!=(const ColorMapping& rhs) const { return !(*this == rhs); }
+
+namespace {
+
+/*
+ * Gather the color of every key from the dense table \p lut in parallel, \p index maps a key to
+ * its table entry.
+ */
+template <typename Key, typename Table, typename Index>
+std::vector<vec4> gatherColors(const std::vector<Key>& keys, const Table& lut, Index index) {
+    std::vector<vec4> colors(keys.size());
+    util::forEachRangeParallel(
+        colors.size(), util::defaultGrainSize(colors.size()), [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) colors[i] = lut[index(keys[i])];
+        });
+    return colors;
+}
+
+}  // namespace
+
+std::vector<vec4> atomColors(const MolecularStructure& s, const ColorMapping& colormap) {
+    const size_t atomCount = s.atoms().positions.size();
+
+    switch (colormap.coloring) {
+        case Coloring::Atoms:
+            if (!s.atoms().atomicNumbers.empty()) {
+                return gatherColors(s.atoms().atomicNumbers, element::colors(colormap.atoms),
+                                    element::atomicNumber);
+            } else {
+                return std::vector<vec4>(atomCount,
+                                         element::color(Element::Unknown, colormap.atoms));
+            }
+        case Coloring::Residues:
+            if (s.hasResidues()) {
+                // one color per residue, looked up once and gathered through the residue indices
+                const auto& lut = aminoacid::colors(colormap.aminoacids);
+                const auto residueColors = util::transform(s.residues(), [&](const Residue& res) {
+                    return lut[aminoacid::index(res.aminoacid)];
+                });
+                return gatherColors(s.getResidueIndices(), residueColors,
+                                    [](size_t resIndex) { return resIndex; });
+            } else {
+                return std::vector<vec4>(
+                    atomCount, aminoacid::color(AminoAcid::Unknown, colormap.aminoacids));
+            }
+        case Coloring::Chains:
+            if (s.hasChains()) {
+                return gatherColors(s.atoms().chainIds, chain::colors(chain::Colormap::Jmol),
+                                    [](int id) { return chain::index(chain::fromId(id)); });
+            } else {
+                return std::vector<vec4>(atomCount, chain::color(ChainId::Unknown));
+            }
+        case Coloring::Fixed:
+        default:
+            return std::vector<vec4>(atomCount, colormap.fixedColor);
+    }
+}
+
+std::vector<float> atomRadii(const MolecularStructure& s) {
+    if (s.atoms().atomicNumbers.empty()) {
+        // fall-back if atomic numbers are not available
+        return std::vector<float>(s.atoms().positions.size(),
+                                  static_cast<float>(element::vdwRadius(Element::Unknown)));
+    }
+    return util::transform(s.atoms().atomicNumbers, [](Element elem) {
+        return static_cast<float>(element::vdwRadius(elem));
+    });
+}
+
+std::vector<mat4> instanceTransforms(const MolecularStructure& s) {
+    if (s.instances().empty()) return {mat4(1.0f)};
+    return util::transform(s.instances(), [](const dmat4& m) { return mat4{m}; });
+}
+
+std::shared_ptr<Mesh> MolecularMesh::update(std::shared_ptr<const MolecularStructure> s,
+                                            const ColorMapping& colormap, uint32_t pickingId,
+                                            const AtomMask* mask) {
+    const size_t atomCount = s->atoms().positions.size();
+
+    auto pickingIds = [&](std::vector<uint32_t>& ids) {
+        ids.resize(atomCount);
+        std::iota(ids.begin(), ids.end(), pickingId);
+    };
+
+    if (!mesh_ || !structure_ || !s->sharesTopology(*structure_)) {
+        mesh_ = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
+        positions_.reset();
+        colors_.reset();
+        picking_.reset();
+        atomIndices_.reset();
+        bondIndices_.reset();
+        if (atomCount > 0) {
+            positions_ = util::makeBuffer(util::transform(
+                s->atoms().positions, [](const dvec3& p) { return glm::vec3{p}; }));
+            colors_ = util::makeBuffer(atomColors(*s, colormap));
+            std::vector<uint32_t> ids;
+            pickingIds(ids);
+            picking_ = util::makeBuffer(std::move(ids));
+
+            mesh_->addBuffer(BufferType::PositionAttrib, positions_);
+            mesh_->addBuffer(BufferType::ColorAttrib, colors_);
+            mesh_->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(atomRadii(*s)));
+            mesh_->addBuffer(BufferType::PickingAttrib, picking_);
+
+            atomIndices_ = util::makeIndexBuffer(std::vector<uint32_t>{});
+            mesh_->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
+                              atomIndices_);
+            if (!s->bonds().empty()) {
+                bondIndices_ = util::makeIndexBuffer(std::vector<uint32_t>{});
+                mesh_->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                                  bondIndices_);
+            }
+            updateIndices(*s, mask);
+        }
+    } else if (atomCount > 0) {
+        if (s != structure_) {
+            auto& positions = positions_->getEditableRAMRepresentation()->getDataContainer();
+            std::transform(s->atoms().positions.begin(), s->atoms().positions.end(),
+                           positions.begin(), [](const dvec3& p) { return vec3{p}; });
+        }
+        if (colormap != colormap_) {
+            colors_->getEditableRAMRepresentation()->getDataContainer() = atomColors(*s, colormap);
+        }
+        if (pickingId != pickingId_) {
+            pickingIds(picking_->getEditableRAMRepresentation()->getDataContainer());
+        }
+        if ((mask != nullptr) != mask_.has_value() || (mask && *mask != *mask_)) {
+            updateIndices(*s, mask);
+        }
+    }
+
+    structure_ = std::move(s);
+    colormap_ = colormap;
+    pickingId_ = pickingId;
+    mask_ = mask ? std::optional<AtomMask>{*mask} : std::nullopt;
+    return mesh_;
+}
+
+const std::shared_ptr<Mesh>& MolecularMesh::getMesh() const { return mesh_; }
+
+void MolecularMesh::updateIndices(const MolecularStructure& s, const AtomMask* mask) {
+    auto& atoms = atomIndices_->getEditableRAMRepresentation()->getDataContainer();
+    if (mask) {
+        atoms = mask->indices();
+    } else {
+        atoms.resize(s.atoms().positions.size());
+        std::iota(atoms.begin(), atoms.end(), 0);
+    }
+
+    if (bondIndices_) {
+        auto& bonds = bondIndices_->getEditableRAMRepresentation()->getDataContainer();
+        bonds.clear();
+        bonds.reserve(s.bonds().size() * 2);
+        for (const auto& bond : s.bonds()) {
+            if (!mask || (mask->test(bond.first) && mask->test(bond.second))) {
+                bonds.push_back(static_cast<uint32_t>(bond.first));
+                bonds.push_back(static_cast<uint32_t>(bond.second));
+            }
+        }
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
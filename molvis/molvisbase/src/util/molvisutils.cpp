@@ -29,19 +29,23 @@
  *********************************************************************************/
 
 #include <inviwo/molvisbase/util/molvisutils.h>
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
+#include <inviwo/utilities/util/parallel.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
-#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/stringconversion.h>
 #include <inviwo/core/util/exception.h>
-#include <inviwo/core/util/zip.h>
 
 #include <inviwo/molvisbase/util/atomicelement.h>
 #include <inviwo/molvisbase/util/aminoacid.h>
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace inviwo {
 
 namespace molvis {
@@ -134,80 +138,59 @@ PeptideType getPeptideType(std::string_view resName, std::string_view nextResNam
 }
 
 std::vector<Element> getAtomicNumbers(const std::vector<std::string>& fullNames) {
-    return util::transform(fullNames,
-                           [](const std::string& name) { return element::fromFullName(name); });
+    // fromFullName is a table lookup without allocations, the atoms are independent
+    std::vector<Element> elements(fullNames.size());
+    util::forEachRangeParallel(
+        fullNames.size(), util::defaultGrainSize(fullNames.size()), [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) elements[i] = element::fromFullName(fullNames[i]);
+        });
+    return elements;
 }
 
 std::vector<Bond> computeCovalentBonds(const Atoms& atoms) {
     if (atoms.positions.empty()) return {};
 
+    return computeCovalentBonds(atoms, AtomGrid{atoms.positions, maxCovalentBondLength});
+}
+
+std::vector<Bond> computeCovalentBonds(const Atoms& atoms, const AtomGrid& grid) {
+    if (atoms.positions.empty()) return {};
+
     if (atoms.positions.size() != atoms.atomicNumbers.size()) {
         throw Exception(
             fmt::format("Number of atoms ({}) does not match size of atomic numbers ({})",
                         atoms.positions.size(), atoms.atomicNumbers.size()),
             IVW_CONTEXT_CUSTOM("computeCovalentBonds"));
     }
-
-    const double maxCovalentBondLength = 4.0;
-    const dvec3 cellSize{maxCovalentBondLength};
-
-    // create uniform grid enclosing all atoms +- 1.0Å
-    dvec3 min{atoms.positions.front()};
-    dvec3 max{atoms.positions.front()};
-    for (size_t i = 0; i < atoms.positions.size(); ++i) {
-        min = glm::min(min, atoms.positions[i]);
-        max = glm::max(max, atoms.positions[i]);
+    if (atoms.positions.size() != grid.atomIndices().size()) {
+        throw Exception(fmt::format("Number of atoms ({}) does not match atom grid ({})",
+                                    atoms.positions.size(), grid.atomIndices().size()),
+                        IVW_CONTEXT_CUSTOM("computeCovalentBonds"));
     }
-    min -= 1.0;
-    max += 1.0;
-
-    const size3_t dims{glm::max(size3_t(1), size3_t((max - min) / cellSize))};
-    const dvec3 cellExt{(max - min) / dvec3{dims}};
-
-    std::vector<int> cells(glm::compMul(dims), -1);
-    std::vector<std::vector<size_t>> cellData;
 
-    auto cellCoord = [&](const dvec3& pos) -> size3_t {
-        return glm::clamp(size3_t((pos - min) / cellExt), size3_t(0), dims - size_t{1});
-    };
-
-    util::IndexMapper3D im(dims);
-    for (auto&& [i, pos] : util::enumerate(atoms.positions)) {
-        const auto cellIndex = im(cellCoord(pos));
-        if (cells[cellIndex] == -1) {
-            cells[cellIndex] = static_cast<int>(cellData.size());
-            cellData.push_back({});
+    // search bonds of consecutive atom ranges in parallel, each with its own bond buffer
+    const size_t chunkSize = 1 << 14;
+    std::vector<std::vector<Bond>> chunkBonds((atoms.positions.size() + chunkSize - 1) / chunkSize);
+    util::forEachRangeParallel(atoms.positions.size(), chunkSize, [&](size_t begin, size_t end) {
+        auto& bonds = chunkBonds[begin / chunkSize];
+        for (size_t atom1 = begin; atom1 < end; ++atom1) {
+            const auto& pos1 = atoms.positions[atom1];
+            const auto element1 = atoms.atomicNumbers[atom1];
+            auto addBond = [&](size_t atom2, const dvec3& pos2) {
+                if ((atom1 < atom2) &&
+                    covalentBondHeuristics(element1, pos1, atoms.atomicNumbers[atom2], pos2)) {
+                    bonds.push_back({atom1, atom2});
+                }
+            };
+            grid.forEachAtomWithin(pos1, maxCovalentBondLength, addBond);
         }
-        cellData[cells[cellIndex]].push_back(i);
-    }
-
-    auto covalentBond = [&](size_t atom1, size_t atom2) {
-        return covalentBondHeuristics(atoms.atomicNumbers[atom1], atoms.positions[atom1],
-                                      atoms.atomicNumbers[atom2], atoms.positions[atom2]);
-    };
+    });
 
     std::vector<Bond> bonds;
-    for (auto&& [atom1, pos] : util::enumerate(atoms.positions)) {
-        const auto minCell = cellCoord(pos - maxCovalentBondLength);
-        const auto maxCell = cellCoord(pos + maxCovalentBondLength);
-
-        for (size_t z = minCell.z; z <= maxCell.z; ++z) {
-            for (size_t y = minCell.y; y <= maxCell.y; ++y) {
-                for (size_t x = minCell.x; x <= maxCell.x; ++x) {
-                    const auto cellIndex = im(size3_t{x, y, z});
-                    if (cells[cellIndex] > -1) {
-                        for (auto atom2 : cellData[cells[cellIndex]]) {
-                            if (glm::distance2(atoms.positions[atom1], atoms.positions[atom2]) <
-                                square(maxCovalentBondLength)) {
-                                if ((atom1 < atom2) && covalentBond(atom1, atom2)) {
-                                    bonds.push_back({atom1, atom2});
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    bonds.reserve(std::accumulate(chunkBonds.begin(), chunkBonds.end(), size_t{0},
+                                  [](size_t sum, auto& b) { return sum + b.size(); }));
+    for (auto& b : chunkBonds) {
+        bonds.insert(bonds.end(), b.begin(), b.end());
     }
     return bonds;
 }
@@ -266,6 +249,26 @@ std::shared_ptr<Mesh> createMesh(const MolecularStructure& s, bool enablePicking
     return mesh;
 }
 
+void updateMeshPositions(Mesh& mesh, const MolecularStructure& s) {
+    const auto& atomPositions = s.atoms().positions;
+
+    for (auto& [info, buffer] : mesh.getBuffers()) {
+        if (info.type != BufferType::PositionAttrib) continue;
+
+        auto positions = dynamic_cast<Buffer<vec3>*>(buffer.get());
+        if (!positions || positions->getSize() != atomPositions.size()) {
+            throw Exception(fmt::format("Mesh positions do not match the {} atoms of the structure",
+                                        atomPositions.size()),
+                            IVW_CONTEXT_CUSTOM("updateMeshPositions"));
+        }
+        auto& data = positions->getEditableRAMRepresentation()->getDataContainer();
+        std::transform(atomPositions.begin(), atomPositions.end(), data.begin(),
+                       [](const dvec3& p) { return vec3{p}; });
+        return;
+    }
+    throw Exception("Mesh has no position buffer", IVW_CONTEXT_CUSTOM("updateMeshPositions"));
+}
+
 Document createToolTip(const MolecularStructure& s, int atomIndex) {
     using H = utildoc::TableBuilder::Header;
     using P = Document::PathComponent;
@@ -286,20 +289,26 @@ Document createToolTip(const MolecularStructure& s, int atomIndex) {
         tb(H("Full Name"), atoms.fullNames[atomIndex]);
     }
     tb(H("Position"), fmt::format("{:.3f}, {:.3f}, {:.3f}", pos.x, pos.y, pos.z));
+    // residue and chain are looked up through the per-atom and per-residue indices of the
+    // structure, since tooltips are updated on every hover event
+    const auto& residueIndices = s.getResidueIndices();
+    const auto& residueChains = s.getResidueChainIndices();
+    const bool hasResidue = static_cast<size_t>(atomIndex) < residueIndices.size();
     if (!atoms.residueIds.empty()) {
-        const auto resId = atoms.residueIds[atomIndex];
-        if (!atoms.chainIds.empty()) {
-            if (auto res = findResidue(s.data(), resId, atoms.chainIds[atomIndex])) {
-                tb(H("Residue"), fmt::format("{} ('{}', id: {})", aminoacid::symbol(res->aminoacid),
-                                             res->fullName, res->id));
-            }
-        } else {
+        if (hasResidue) {
+            const auto& res = s.residues()[residueIndices[atomIndex]];
+            tb(H("Residue"), fmt::format("{} ('{}', id: {})", aminoacid::symbol(res.aminoacid),
+                                         res.fullName, res.id));
+        } else if (atoms.chainIds.empty()) {
             tb(H("Residue"), atoms.residueIds[atomIndex]);
         }
     }
     if (!atoms.chainIds.empty()) {
         const auto chainId = atoms.chainIds[atomIndex];
-        if (auto chain = findChain(s.data(), chainId)) {
+        if (hasResidue && !residueChains.empty()) {
+            const auto& chain = s.chains()[residueChains[residueIndices[atomIndex]]];
+            tb(H("Chain"), fmt::format("{} (id: {})", chain.name, chain.id));
+        } else if (auto chain = findChain(s.data(), chainId)) {
             tb(H("Chain"), fmt::format("{} (id: {})", chain->name, chain->id));
         } else {
             tb(H("Chain"), chainId);
@@ -0,0 +1,100 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/molvisbase/util/molvisutils.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <warn/pop>
+
+#include <string>
+
+/*
+ * Cost of the atom tooltips of the molecular renderers, which are created on every hover event.
+ * The structures are chains of glycine residues with four atoms each and a new chain every 1000
+ * residues. The argument is the number of atoms, the tooltips of atoms spread over the whole
+ * structure are created in turn. The lookup should not depend on the atom count.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+molvis::MolecularStructure testStructure(size_t size) {
+    using namespace molvis;
+    constexpr size_t residueAtoms = 4;
+    constexpr size_t chainResidues = 1000;
+    static constexpr const char* names[] = {"N", "CA", "C", "O"};
+    static constexpr Element elements[] = {Element::N, Element::C, Element::C, Element::O};
+
+    MolecularData data;
+    for (size_t i = 0; i < size; ++i) {
+        const auto residue = i / residueAtoms;
+        const auto chain = residue / chainResidues;
+        data.atoms.positions.emplace_back(1.5 * static_cast<double>(i % 64),
+                                          1.5 * static_cast<double>(i / 64 % 64),
+                                          1.5 * static_cast<double>(i / 4096));
+        data.atoms.serialNumbers.push_back(static_cast<int>(i + 1));
+        data.atoms.bFactors.push_back(10.0);
+        data.atoms.modelIds.push_back(1);
+        data.atoms.chainIds.push_back(static_cast<int>(chain));
+        data.atoms.residueIds.push_back(static_cast<int>(residue + 1));
+        data.atoms.atomicNumbers.push_back(elements[i % residueAtoms]);
+        data.atoms.fullNames.emplace_back(names[i % residueAtoms]);
+        if (i % residueAtoms == 0) {
+            data.residues.push_back(
+                {static_cast<int>(residue + 1), AminoAcid::Gly, "GLY", static_cast<int>(chain)});
+        }
+        if (residue % chainResidues == 0 && i % residueAtoms == 0) {
+            data.chains.push_back({static_cast<int>(chain), std::to_string(chain)});
+        }
+    }
+    return MolecularStructure(std::move(data));
+}
+
+}  // namespace
+
+static void createToolTip(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto structure = testStructure(size);
+    // Walk the structure with a stride coprime to the sizes to avoid hitting the same atoms
+    constexpr size_t stride = 7919;
+    size_t atom = 0;
+    for (auto _ : state) {
+        auto doc = molvis::createToolTip(structure, static_cast<int>(atom));
+        benchmark::DoNotOptimize(doc);
+        atom = (atom + stride) % size;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(createToolTip)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
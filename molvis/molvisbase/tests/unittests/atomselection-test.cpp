@@ -0,0 +1,149 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/molvisbase/algorithm/atomselection.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/core/util/exception.h>
+
+namespace inviwo {
+
+namespace {
+
+/*
+ * Alanine in chain A, followed by a water and a heme iron in chain B. The iron is 1.5 Å from the
+ * CB atom of the alanine and further away from all other atoms.
+ */
+molvis::MolecularStructure testStructure() {
+    using namespace molvis;
+    MolecularData data;
+    data.atoms.positions = {{0.0, 0.0, 0.0},  {1.5, 0.0, 0.0},  {3.0, 0.0, 0.0}, {3.0, 1.2, 0.0},
+                            {1.5, 1.5, 0.0},  {20.0, 0.0, 0.0}, {1.5, 3.0, 0.0}};
+    data.atoms.serialNumbers = {1, 2, 3, 4, 5, 6, 7};
+    data.atoms.bFactors = {10.0, 20.0, 30.0, 40.0, 50.0, 60.0, 70.0};
+    data.atoms.modelIds = {1, 1, 1, 1, 1, 1, 1};
+    data.atoms.chainIds = {0, 0, 0, 0, 0, 1, 1};
+    data.atoms.residueIds = {1, 1, 1, 1, 1, 2, 3};
+    data.atoms.atomicNumbers = {Element::N, Element::C, Element::C, Element::O,
+                                Element::C, Element::O, Element::Fe};
+    data.atoms.fullNames = {"N", "CA", "C", "O", "CB", "O", "FE"};
+    data.residues = {{1, AminoAcid::Ala, "ALA", 0},
+                     {2, AminoAcid::Unknown, "HOH", 1},
+                     {3, AminoAcid::Unknown, "HEM", 1}};
+    data.chains = {{0, "A"}, {1, "B"}};
+    return MolecularStructure(std::move(data));
+}
+
+std::vector<uint32_t> select(std::string_view query) {
+    static const auto structure = testStructure();
+    return molvis::selectAtoms(structure, query).indices();
+}
+
+using Indices = std::vector<uint32_t>;
+
+}  // namespace
+
+TEST(AtomSelection, operatorPrecedence) {
+    // and binds stronger than or
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4, 5}), select("chain A or chain B and water"));
+    EXPECT_EQ((Indices{1, 5}), select("name CA or resid 2 and element O"));
+    // not applies to the following predicate only
+    EXPECT_EQ((Indices{6}), select("not water and chain B"));
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4, 6}), select("not (water and chain B)"));
+    EXPECT_EQ((Indices{}), select("not all"));
+}
+
+TEST(AtomSelection, parentheses) {
+    EXPECT_EQ((Indices{5}), select("(chain A or chain B) and water"));
+    EXPECT_EQ((Indices{0, 2, 3}), select("((name N) or (name C O)) and chain A"));
+    EXPECT_EQ(select("chain A"), select("((chain A))"));
+}
+
+TEST(AtomSelection, within) {
+    // Includes the atoms of the inner selection
+    EXPECT_EQ((Indices{4, 6}), select("within 2 of resname HEM"));
+    EXPECT_EQ((Indices{3, 4, 6}), select("within 2.5 of resname HEM"));
+    EXPECT_EQ((Indices{5}), select("within 5 of water"));
+    EXPECT_EQ((Indices{4}), select("within 2 of resname HEM and chain A"));
+    EXPECT_EQ((Indices{}), select("within 2 of none"));
+    // Many inner atoms take the per atom path
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4, 6}), select("within 2 of not water"));
+}
+
+TEST(AtomSelection, residuePredicates) {
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4}), select("resname ala"));
+    EXPECT_EQ((Indices{5, 6}), select("resname HOH HEM"));
+    EXPECT_EQ((Indices{5, 6}), select("resid 2-3"));
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4, 5}), select("resid 1 to 2"));
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4}), select("same residue as name CB"));
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4}), select("protein"));
+    EXPECT_EQ((Indices{0, 1, 2, 3}), select("backbone"));
+    EXPECT_EQ((Indices{4}), select("sidechain"));
+    EXPECT_EQ((Indices{5}), select("water"));
+}
+
+TEST(AtomSelection, chainPredicates) {
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4}), select("chain A"));
+    EXPECT_EQ((Indices{5, 6}), select("chain b"));
+    EXPECT_EQ((Indices{0, 1, 2, 3, 4, 5, 6}), select("chain A B"));
+    EXPECT_EQ((Indices{}), select("chain C"));
+}
+
+TEST(AtomSelection, atomPredicates) {
+    EXPECT_EQ((Indices{0, 6}), select("index 0 6"));
+    EXPECT_EQ((Indices{0, 2, 3}), select("serial 1 3-4"));
+    EXPECT_EQ((Indices{3, 4, 5, 6}), select("beta >= 40"));
+    EXPECT_EQ((Indices{0}), select("bfactor < 20"));
+    EXPECT_EQ((Indices{6}), select("element Fe"));
+    EXPECT_EQ((Indices{3, 5}), select("name \"O\""));
+    EXPECT_EQ((Indices{}), select("hydrogen"));
+}
+
+TEST(AtomSelection, malformedQueries) {
+    for (const auto query :
+         {"", "chain", "(chain A", "chain A)", "chain A and", "or chain A", "resid x",
+          "resid 1 to", "beta 3", "beta >> 3", "within of chain A", "within 2 chain A",
+          "same residue chain A", "element Xx", "name \"CA", "bogus"}) {
+        EXPECT_THROW(molvis::AtomSelection{query}, Exception) << "query: '" << query << "'";
+    }
+
+    try {
+        molvis::AtomSelection{"chain A and bogus"};
+        FAIL() << "expected an exception";
+    } catch (const Exception& e) {
+        EXPECT_NE(std::string::npos, e.getMessage().find("unknown keyword 'bogus'"));
+        EXPECT_NE(std::string::npos, e.getMessage().find("position 12"));
+    }
+}
+
+}  // namespace inviwo
@@ -34,6 +34,8 @@
 #endif
 #endif
 
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
 #include <inviwo/core/util/logcentral.h>
 #include <inviwo/core/util/consolelogger.h>
 #include <inviwo/testutil/configurablegtesteventlistener.h>
@@ -53,6 +55,14 @@ int main(int argc, char** argv) {
     LogCentral::getPtr()->setVerbosity(LogVerbosity::Info);
     LogCentral::getPtr()->registerLogger(logger);
 
+    // The structures and readers process their data on the thread pool
+    InviwoApplication app(argc, argv, "Inviwo-Unittests-MolVisBase");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        app.registerModules(std::move(modules));
+    }
+
     int ret = -1;
     {
 #ifdef IVW_ENABLE_MSVC_MEM_LEAK_TEST
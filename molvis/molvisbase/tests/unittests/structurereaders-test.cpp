@@ -0,0 +1,194 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/molvisbase/io/basicpdbreader.h>
+#include <inviwo/molvisbase/io/basicmmcifreader.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace {
+
+// Serials 99998 and 99999 are decimal, the following ones hexadecimal
+constexpr std::string_view hexadecimalSerials =
+    "HEADER    TEST\n"
+    "ATOM  99998  N   ALA A   1       0.000   0.000   0.000  1.00 10.00           N  \n"
+    "ATOM  99999  CA  ALA A   1       1.458   0.000   0.000  1.00 11.50           C  \n"
+    "ATOM  186A0  C   ALA A   1       2.009   1.420   0.000  1.00 12.25           C  \n"
+    "HETATM186A1  O   HOH B   2       8.000  -3.500   1.250  1.00 30.00           O  \n"
+    "END\n";
+
+std::string writeFile(std::string_view name, std::string_view contents) {
+    const auto path = std::filesystem::temp_directory_path() / std::string(name);
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    return path.string();
+}
+
+struct TestAtom {
+    int serial;
+    std::string name;
+    std::string residue;
+    std::string chain;
+    int residueId;
+    dvec3 position;
+    double bFactor;
+    std::string element;
+};
+
+/*
+ * Glycines of four atoms each, the first half of the residues in chain A and the rest in chain B.
+ * Positions lie on a grid with a spacing of 1.5 Å.
+ */
+std::vector<TestAtom> testAtoms(size_t size) {
+    constexpr std::array<std::string_view, 4> names = {"N", "CA", "C", "O"};
+    constexpr std::array<std::string_view, 4> elements = {"N", "C", "C", "O"};
+    std::vector<TestAtom> atoms;
+    for (size_t i = 0; i < size; ++i) {
+        atoms.push_back({static_cast<int>(i + 1), std::string(names[i % 4]), "GLY",
+                         i / 4 < size / 8 ? "A" : "B", static_cast<int>(i / 4 + 1),
+                         1.5 * dvec3(i % 100, (i / 100) % 100, i / 10000),
+                         0.25 * static_cast<double>(i % 400), std::string(elements[i % 4])});
+    }
+    return atoms;
+}
+
+std::string toPDB(const std::vector<TestAtom>& atoms) {
+    std::string pdb = "MODEL        1\n";
+    for (const auto& a : atoms) {
+        pdb += fmt::format(
+            "ATOM  {:>5} {:<4} {:<3} {}{:>4}    {:8.3f}{:8.3f}{:8.3f}{:6.2f}{:6.2f}{:>12}  \n",
+            a.serial, " " + a.name, a.residue, a.chain, a.residueId, a.position.x, a.position.y,
+            a.position.z, 1.0, a.bFactor, a.element);
+    }
+    pdb += "ENDMDL\nEND\n";
+    return pdb;
+}
+
+std::string toMMCIF(const std::vector<TestAtom>& atoms) {
+    std::string cif =
+        "data_test\n#\nloop_\n_atom_site.group_PDB\n_atom_site.id\n_atom_site.type_symbol\n"
+        "_atom_site.label_atom_id\n_atom_site.label_comp_id\n_atom_site.label_asym_id\n"
+        "_atom_site.label_seq_id\n_atom_site.Cartn_x\n_atom_site.Cartn_y\n_atom_site.Cartn_z\n"
+        "_atom_site.occupancy\n_atom_site.B_iso_or_equiv\n_atom_site.auth_seq_id\n"
+        "_atom_site.auth_comp_id\n_atom_site.auth_asym_id\n_atom_site.pdbx_PDB_model_num\n";
+    for (const auto& a : atoms) {
+        cif += fmt::format("ATOM {} {} {} {} {} {} {:.3f} {:.3f} {:.3f} 1.00 {:.2f} {} {} {} 1\n",
+                           a.serial, a.element, a.name, a.residue, a.chain, a.residueId,
+                           a.position.x, a.position.y, a.position.z, a.bFactor, a.residueId,
+                           a.residue, a.chain);
+    }
+    cif += "#\n";
+    return cif;
+}
+
+}  // namespace
+
+TEST(StructureReaders, pdbHexadecimalSerials) {
+    const auto s =
+        BasicPDBReader{}.readData(writeFile("molvis-hexserials.pdb", hexadecimalSerials));
+
+    const auto& atoms = s->atoms();
+    ASSERT_EQ(4u, atoms.positions.size());
+    EXPECT_EQ((std::vector<int>{99998, 99999, 100000, 100001}), atoms.serialNumbers);
+    EXPECT_EQ((std::vector<std::string>{"N", "CA", "C", "O"}), atoms.fullNames);
+    EXPECT_EQ(molvis::Element::O, atoms.atomicNumbers[3]);
+    EXPECT_EQ(dvec3(8.0, -3.5, 1.25), atoms.positions[3]);
+    EXPECT_DOUBLE_EQ(12.25, atoms.bFactors[2]);
+    EXPECT_EQ(2u, s->residues().size());
+    EXPECT_EQ(2u, s->chains().size());
+}
+
+TEST(StructureReaders, pdbChunkBoundaries) {
+    // Records are parsed in parallel chunks of 2^14 atoms, use a partial third chunk
+    const auto expected = testAtoms(2 * (1 << 14) + 5);
+    const auto s = BasicPDBReader{}.readData(writeFile("molvis-chunks.pdb", toPDB(expected)));
+
+    const auto& atoms = s->atoms();
+    ASSERT_EQ(expected.size(), atoms.positions.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i].serial, atoms.serialNumbers[i]) << i;
+        ASSERT_EQ(expected[i].position, atoms.positions[i]) << i;
+        ASSERT_EQ(expected[i].name, atoms.fullNames[i]) << i;
+        ASSERT_EQ(expected[i].residueId, atoms.residueIds[i]) << i;
+        ASSERT_DOUBLE_EQ(expected[i].bFactor, atoms.bFactors[i]) << i;
+    }
+    EXPECT_EQ(expected.size() / 4 + 1, s->residues().size());
+    EXPECT_EQ(2u, s->chains().size());
+}
+
+TEST(StructureReaders, pdbAndMMCIFParity) {
+    const auto expected = testAtoms(1000);
+    const auto pdb = BasicPDBReader{}.readData(writeFile("molvis-parity.pdb", toPDB(expected)));
+    const auto cif =
+        BasicMMCIFReader{}.readData(writeFile("molvis-parity.cif", toMMCIF(expected)));
+
+    const auto& a = pdb->atoms();
+    const auto& b = cif->atoms();
+    ASSERT_EQ(expected.size(), a.positions.size());
+    EXPECT_EQ(a.positions, b.positions);
+    EXPECT_EQ(a.serialNumbers, b.serialNumbers);
+    EXPECT_EQ(a.bFactors, b.bFactors);
+    EXPECT_EQ(a.modelIds, b.modelIds);
+    EXPECT_EQ(a.chainIds, b.chainIds);
+    EXPECT_EQ(a.residueIds, b.residueIds);
+    EXPECT_EQ(a.atomicNumbers, b.atomicNumbers);
+    EXPECT_EQ(a.fullNames, b.fullNames);
+
+    ASSERT_EQ(pdb->residues().size(), cif->residues().size());
+    for (size_t i = 0; i < pdb->residues().size(); ++i) {
+        EXPECT_EQ(pdb->residues()[i].id, cif->residues()[i].id);
+        EXPECT_EQ(pdb->residues()[i].fullName, cif->residues()[i].fullName);
+        EXPECT_EQ(pdb->residues()[i].chainId, cif->residues()[i].chainId);
+    }
+    ASSERT_EQ(pdb->chains().size(), cif->chains().size());
+    for (size_t i = 0; i < pdb->chains().size(); ++i) {
+        EXPECT_EQ(pdb->chains()[i].name, cif->chains()[i].name);
+    }
+
+    auto bondsA = pdb->bonds();
+    auto bondsB = cif->bonds();
+    std::sort(bondsA.begin(), bondsA.end());
+    std::sort(bondsB.begin(), bondsB.end());
+    EXPECT_EQ(bondsA, bondsB);
+}
+
+}  // namespace inviwo
@@ -5,6 +5,7 @@ set(dependencies
     InviwoOpenGLModule
     InviwoBaseGLModule
     InviwoMeshRenderingGLModule
+    InviwoUtilitiesGLModule
 )
 
 # Add an alias for this module. Several modules can share an alias. 
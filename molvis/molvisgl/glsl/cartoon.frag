@@ -0,0 +1,86 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+// Shading of the cartoon surface, see cartoon.tese. Transparent fragments are either stored in
+// fragment lists or accumulated with weighted blended transparency like the atom impostors.
+
+#include "utils/structs.glsl"
+#include "utils/shading.glsl"
+
+#ifdef USE_FRAGMENT_LIST
+#include "oit/abufferlinkedlist.glsl"
+
+// this is important for the occlusion query
+layout(early_fragment_tests) in;
+
+layout(pixel_center_integer) in vec4 gl_FragCoord;
+#elif defined(USE_WEIGHTED_OIT)
+#include "weightedoit.glsl"
+#endif
+
+uniform CameraParameters camera;
+uniform LightParameters lighting;
+uniform float uniformAlpha;
+
+in Fragment {
+    smooth vec3 world_pos;
+    smooth vec3 normal;
+    smooth vec4 color;
+    flat vec4 picking_color;
+} in_frag;
+
+void main() {
+    vec3 campos = camera.viewToWorld[3].xyz;
+    vec3 normal = normalize(in_frag.normal);
+    if (!gl_FrontFacing) normal = -normal;
+
+    vec4 color;
+    color.rgb = APPLY_LIGHTING(lighting, in_frag.color.rgb, in_frag.color.rgb, vec3(1.0f),
+                               in_frag.world_pos, normal, normalize(campos - in_frag.world_pos));
+#if defined(UNIFORM_ALPHA)
+    color.a = uniformAlpha;
+#else
+    color.a = in_frag.color.a;
+#endif // UNIFORM_ALPHA
+    if (color.a < 0.01) discard;
+
+#if defined(USE_FRAGMENT_LIST)
+    // fragment list rendering
+    ivec2 coords = ivec2(gl_FragCoord.xy);
+    abufferRender(coords, gl_FragCoord.z, color);
+    discard;
+#elif defined(USE_WEIGHTED_OIT)
+    // the revealage is written to the second render target instead of the picking colors
+    float viewDepth = (camera.worldToView * vec4(in_frag.world_pos, 1.0)).z;
+    weightedOitRender(color, viewDepth, FragData0, PickingData);
+#else
+    FragData0 = color;
+    PickingData = in_frag.picking_color;
+#endif  // USE_FRAGMENT_LIST
+}
@@ -0,0 +1,92 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+// Control points of the cartoon patches, see molvis::CartoonTessellation. Each vertex is one of
+// the four control points of a patch. The color and picking ID are the ones of the CA atom, the
+// attributes of the atoms are read from shader storage buffers, see
+// molvis::bindVertexPullingBuffers.
+
+#include "utils/structs.glsl"
+#include "utils/pickingutils.glsl"
+
+uniform GeometryParameters geometry;
+
+uniform vec4 defaultColor = vec4(1, 0, 0, 1);
+uniform sampler2D metaColor;
+// picking IDs of the instance drawn, see MolecularRenderer
+uniform uint pickingOffset = 0u;
+
+#if defined(HAS_COLOR)
+layout(std430, binding = 1) readonly buffer ColorBuffer { vec4 colors[]; };
+#endif
+#if defined(HAS_PICKING)
+layout(std430, binding = 3) readonly buffer PickingBuffer { uint picking[]; };
+#endif
+#if defined(HAS_SCALARMETA)
+layout(std430, binding = 4) readonly buffer ScalarMetaBuffer { float scalarMeta[]; };
+#endif
+// four control points per patch
+layout(std430, binding = 5) readonly buffer IndexBuffer { uint indices[]; };
+// position and secondary structure, and side direction of each control point
+layout(std430, binding = 6) readonly buffer FrameBuffer { vec4 frames[]; };
+layout(std430, binding = 7) readonly buffer ControlBuffer { uvec4 controls[]; };
+
+out Control {
+    vec3 position;
+    vec3 side;
+    float type;
+    vec4 color;
+    vec4 pickColor;
+} out_vert;
+
+void main(void) {
+    const uint control = indices[gl_VertexID];
+    const uint atom = controls[control].x;
+    const vec4 frame = frames[2 * control];
+
+#if defined(HAS_SCALARMETA) && defined(USE_SCALARMETACOLOR) && !defined(FORCE_COLOR)
+    out_vert.color = texture(metaColor, vec2(scalarMeta[atom], 0.5));
+#elif defined(HAS_COLOR) && !defined(FORCE_COLOR)
+    out_vert.color = colors[atom];
+#else
+    out_vert.color = defaultColor;
+#endif
+
+#if defined(HAS_PICKING)
+    const uint pickID = picking[atom] == 0u ? 0u : picking[atom] + pickingOffset;
+#else 
+    const uint pickID = 0u;
+#endif
+    out_vert.pickColor = vec4(pickingIndexToColor(pickID), pickID == 0u ? 0.0 : 1.0);
+
+    out_vert.position = (geometry.dataToWorld * vec4(frame.xyz, 1.0)).xyz;
+    out_vert.side = normalize(mat3(geometry.dataToWorld) * frames[2 * control + 1].xyz);
+    out_vert.type = frame.w;
+    gl_Position = vec4(out_vert.position, 1.0);
+}
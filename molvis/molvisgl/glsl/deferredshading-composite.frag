@@ -0,0 +1,64 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+// lights the G-buffer of molvis::DeferredShading and writes the visible impostors to the target
+
+#include "utils/structs.glsl"
+#include "utils/shading.glsl"
+
+uniform CameraParameters camera;
+uniform LightParameters lighting;
+
+uniform sampler2D color;
+uniform sampler2D normal;
+uniform sampler2D picking;
+uniform sampler2D depth;
+uniform vec2 reciprocalDimensions;
+
+void main() {
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+    vec4 albedo = texelFetch(color, coord, 0);
+    // no impostor covers this pixel
+    if (albedo.a <= 0.0) discard;
+
+    vec4 n = texelFetch(normal, coord, 0);
+    if (n.w > 0.0) {
+        // reconstruct the world position from the depth of the impostor
+        float z = texelFetch(depth, coord, 0).r;
+        vec4 pos = camera.clipToWorld * vec4(gl_FragCoord.xy * reciprocalDimensions * 2.0 - 1.0,
+                                             z * 2.0 - 1.0, 1.0);
+        pos /= pos.w;
+        vec3 campos = camera.viewToWorld[3].xyz;
+        albedo.rgb = APPLY_LIGHTING(lighting, albedo.rgb, albedo.rgb, vec3(1.0f), pos.xyz,
+                                    normalize(n.xyz), normalize(campos - pos.xyz));
+    }
+
+    FragData0 = albedo;
+    PickingData = texelFetch(picking, coord, 0);
+}
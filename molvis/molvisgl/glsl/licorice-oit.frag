@@ -44,6 +44,8 @@
 layout(early_fragment_tests) in;
 
 layout(pixel_center_integer) in vec4 gl_FragCoord;
+#elif defined(USE_WEIGHTED_OIT)
+#include "weightedoit.glsl"
 #endif
 
 uniform CameraParameters camera;
@@ -110,6 +112,10 @@ void main() {
         abufferRender(coords, depth, color);
     }
     discard;
+#elif defined(USE_WEIGHTED_OIT)
+    // the revealage is written to the second render target instead of the picking colors
+    weightedOitRender(color, view_coord.z, FragData0, PickingData);
+    gl_FragDepth = depth;
 #else
     FragData0 = color;
     gl_FragDepth = depth;
@@ -0,0 +1,159 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+// Vertex pulling variant of licorice.vert and licorice.geom. Each instance is one bond, expanded
+// into a box of 14 vertices enclosing the capsule. The attributes are read from shader storage
+// buffers instead of vertex attributes, see molvis::bindVertexPullingBuffers.
+
+#include "utils/structs.glsl"
+#include "utils/pickingutils.glsl"
+
+uniform GeometryParameters geometry;
+uniform CameraParameters camera;
+
+uniform vec4 defaultColor = vec4(1, 0, 0, 1);
+uniform sampler2D metaColor;
+
+uniform float radius_ = 1.0;
+// picking IDs of the instance drawn, see MolecularRenderer
+uniform uint pickingOffset = 0u;
+
+layout(std430, binding = 0) readonly buffer PositionBuffer { float positions[]; };
+#if defined(HAS_COLOR)
+layout(std430, binding = 1) readonly buffer ColorBuffer { vec4 colors[]; };
+#endif
+#if defined(HAS_PICKING)
+layout(std430, binding = 3) readonly buffer PickingBuffer { uint picking[]; };
+#endif
+#if defined(HAS_SCALARMETA)
+layout(std430, binding = 4) readonly buffer ScalarMetaBuffer { float scalarMeta[]; };
+#endif
+// two indices per bond
+layout(std430, binding = 5) readonly buffer IndexBuffer { uint indices[]; };
+
+out Fragment {
+    flat vec4 color[2];
+    flat vec4 picking_color[2];
+    smooth vec3 view_pos;
+    flat float scalar[2];
+
+    flat vec4 capsule_center_radius;
+    flat vec4 capsule_axis_length;
+} out_frag;
+
+// Corners of the box as a single triangle strip covering all six faces. Bit 0 selects the side
+// along i, bit 1 the end point, and bit 2 the side along k.
+const int boxStrip[14] = int[14](3, 7, 1, 5, 4, 7, 6, 3, 2, 1, 0, 4, 2, 6);
+
+vec4 atomColor(uint atom) {
+#if defined(HAS_SCALARMETA) && defined(USE_SCALARMETACOLOR) && !defined(FORCE_COLOR)
+    return texture(metaColor, vec2(scalarMeta[atom], 0.5));
+#elif defined(HAS_COLOR) && !defined(FORCE_COLOR)
+    return colors[atom];
+#else
+    return defaultColor;
+#endif
+}
+
+float atomScalar(uint atom) {
+#if defined(HAS_SCALARMETA) && defined(USE_SCALARMETACOLOR) && !defined(FORCE_COLOR)
+    return scalarMeta[atom];
+#else
+    return 0.0;
+#endif
+}
+
+vec4 atomPickingColor(uint atom) {
+#if defined(HAS_PICKING)
+    const uint pickID = picking[atom] == 0u ? 0u : picking[atom] + pickingOffset;
+#else 
+    const uint pickID = 0;
+#endif
+    return vec4(pickingIndexToColor(pickID), pickID == 0 ? 0.0 : 1.0);
+}
+
+vec3 viewPosition(uint atom) {
+    const vec3 position = vec3(positions[3 * atom], positions[3 * atom + 1],
+                               positions[3 * atom + 2]);
+    return (camera.worldToView * geometry.dataToWorld * vec4(position, 1.0)).xyz;
+}
+
+vec3 get_ortho_vec(vec3 v, vec3 A, vec3 B) {
+    if (abs(1-dot(v,A)) > 0.001){
+        return normalize(cross(v, A));
+    } else {
+        return normalize(cross(v, B));
+    }
+}
+
+void main() {
+    const uint atom0 = indices[2 * gl_InstanceID];
+    const uint atom1 = indices[2 * gl_InstanceID + 1];
+
+    out_frag.color[0] = atomColor(atom0);
+    out_frag.color[1] = atomColor(atom1);
+    if (out_frag.color[0].a == 0 || out_frag.color[1].a == 0) {
+        // all vertices of the box end up outside the clip volume
+        gl_Position = vec4(-2.0, -2.0, -2.0, 1.0);
+        return;
+    }
+    out_frag.scalar[0] = atomScalar(atom0);
+    out_frag.scalar[1] = atomScalar(atom1);
+    out_frag.picking_color[0] = atomPickingColor(atom0);
+    out_frag.picking_color[1] = atomPickingColor(atom1);
+
+    vec3 p0 = viewPosition(atom0);
+    vec3 p1 = viewPosition(atom1);
+    float r = radius_;
+    float l = distance(p0, p1);
+    vec3 a = (p1 - p0) / l;
+    vec3 c = (p0 + p1) * 0.5;
+
+    out_frag.capsule_center_radius = vec4(c, r);
+    out_frag.capsule_axis_length = vec4(a, l);
+
+    // Extend end points to properly fit the sphere caps
+    p0 -= a * r;
+    p1 += a * r;
+
+    const vec3 B = vec3(0,0,1);
+    const vec3 A = vec3(1,0,0);
+    vec3 o = get_ortho_vec(a,A,B);
+
+    // Compute the basis of the prismoid:
+    vec3 i, j, k;
+    j = a; i = o; k = normalize(cross(i, j)); i = cross(k, j); i *= r; k *= r;
+
+    const int corner = boxStrip[gl_VertexID];
+    const vec3 v = ((corner & 2) == 0 ? p0 : p1) + ((corner & 1) == 0 ? -i : i) +
+                   ((corner & 4) == 0 ? -k : k);
+
+    out_frag.view_pos = v;
+    gl_Position = camera.viewToClip * vec4(v, 1.0);
+}
@@ -50,6 +50,14 @@ in Fragment {
     flat vec4 capsule_axis_length;
 } in_frag;
 
+#if defined(GBUFFER_PASS)
+// G-buffer outputs of molvis::DeferredShading besides FragData0 and PickingData
+out vec4 NormalData;
+out float DepthData;
+// the pre-pass might compute a slightly different depth for the same fragment
+const float depthBias = 1e-6;
+#endif
+
 void main() {
 #ifdef ORTHO
     vec3 ro = vec3(in_frag.view_pos.xy, 0);
@@ -80,13 +88,30 @@ void main() {
     vec3 normal = inverse(transpose(mat3(camera.viewToWorld))) * view_normal;
 
     vec4 color;
+#if defined(DEPTH_PREPASS) || defined(GBUFFER_PASS)
+    // only the visible fragments are lit, see molvis::DeferredShading
+    color.rgb = in_frag.color[side].rgb;
+#else
     color.rgb = APPLY_LIGHTING(lighting, in_frag.color[side].rgb, in_frag.color[side].rgb, vec3(1.0f), 
                                intersection, normal, normalize(campos - intersection));
+#endif
     color.a = in_frag.color[side].a;
 
     vec4 curr_clip_coord = camera.viewToClip * vec4(view_coord, 1);
+    float depth = (curr_clip_coord.z / curr_clip_coord.w) * 0.5 + 0.5;
 
+#if defined(DEPTH_PREPASS)
+    gl_FragDepth = depth;
+#elif defined(GBUFFER_PASS)
+    FragData0 = color;
+    NormalData = vec4(normalize(normal), 1.0);
+    DepthData = depth;
+    // never in front of the bounding box, which is declared as conservative depth
+    gl_FragDepth = max(depth - depthBias, gl_FragCoord.z);
+    PickingData = in_frag.picking_color[side];
+#else
     FragData0 = color;
-    gl_FragDepth = (curr_clip_coord.z / curr_clip_coord.w) * 0.5 + 0.5;
+    gl_FragDepth = depth;
     PickingData = in_frag.picking_color[side];
+#endif // DEPTH_PREPASS
 }
\ No newline at end of file
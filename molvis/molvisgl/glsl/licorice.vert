@@ -42,6 +42,8 @@ uniform vec4 defaultColor = vec4(1, 0, 0, 1);
 uniform sampler2D metaColor;
 
 uniform float radiusScaling_ = 1.0;
+// picking IDs of the instance drawn, see MolecularRenderer
+uniform uint pickingOffset = 0u;
 
 out Vertex {
     smooth vec4 worldPosition;
@@ -64,7 +66,7 @@ void main(void) {
 #endif
 
 #if defined(HAS_PICKING)
-    out_vert.pickID = in_Picking;
+    out_vert.pickID = in_Picking == 0u ? 0u : in_Picking + pickingOffset;
 #else 
     out_vert.pickID = 0;
 #endif
@@ -37,6 +37,8 @@
 layout(early_fragment_tests) in;
 
 layout(pixel_center_integer) in vec4 gl_FragCoord;
+#elif defined(USE_WEIGHTED_OIT)
+#include "weightedoit.glsl"
 #endif
 
 uniform CameraParameters camera;
@@ -140,6 +142,10 @@ void main() {
         abufferRender(coords, depth, glyphColor);
     }
     discard;
+#elif defined(USE_WEIGHTED_OIT)
+    // the revealage is written to the second render target instead of the picking colors
+    weightedOitRender(glyphColor, (camera.worldToView * pos).z, FragData0, PickingData);
+    gl_FragDepth = depth;
 #else
     FragData0 = glyphColor;
     gl_FragDepth = depth;
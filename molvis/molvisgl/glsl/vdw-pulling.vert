@@ -0,0 +1,147 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+// Vertex pulling variant of vdw.vert and vdw.geom. Each instance is one atom, expanded into a
+// camera-aligned quad of four vertices. The attributes are read from shader storage buffers
+// instead of vertex attributes, see molvis::bindVertexPullingBuffers.
+
+#include "utils/structs.glsl"
+#include "utils/pickingutils.glsl"
+
+uniform GeometryParameters geometry;
+uniform CameraParameters camera;
+
+uniform vec4 defaultColor = vec4(1, 0, 0, 1);
+uniform float defaultRadius = 0.1;
+uniform sampler2D metaColor;
+
+uniform float radiusScaling_ = 1.0;
+// picking IDs of the instance drawn, see MolecularRenderer
+uniform uint pickingOffset = 0u;
+
+layout(std430, binding = 0) readonly buffer PositionBuffer { float positions[]; };
+#if defined(HAS_COLOR)
+layout(std430, binding = 1) readonly buffer ColorBuffer { vec4 colors[]; };
+#endif
+#if defined(HAS_RADII)
+layout(std430, binding = 2) readonly buffer RadiiBuffer { float radii[]; };
+#endif
+#if defined(HAS_PICKING)
+layout(std430, binding = 3) readonly buffer PickingBuffer { uint picking[]; };
+#endif
+#if defined(HAS_SCALARMETA)
+layout(std430, binding = 4) readonly buffer ScalarMetaBuffer { float scalarMeta[]; };
+#endif
+// one index per atom
+layout(std430, binding = 5) readonly buffer IndexBuffer { uint indices[]; };
+
+out float radius_;
+out vec3 camPos_;
+out vec4 center_;
+out vec4 color_;
+flat out vec4 pickColor_;
+flat out float scalar_;
+
+// corners of the quad in triangle strip order
+const vec2 corners[4] = vec2[4](vec2(1, -1), vec2(-1, -1), vec2(1, 1), vec2(-1, 1));
+
+void discardGlyph() {
+    // all vertices of the quad end up outside the clip volume
+    gl_Position = vec4(-2.0, -2.0, -2.0, 1.0);
+}
+
+void main(void) {
+    const uint atom = indices[gl_InstanceID];
+
+#if defined(HAS_SCALARMETA) && defined(USE_SCALARMETACOLOR) && !defined(FORCE_COLOR)
+    scalar_ = scalarMeta[atom];
+    color_ = texture(metaColor, vec2(scalar_, 0.5));
+#elif defined(HAS_COLOR) && !defined(FORCE_COLOR)
+    color_ = colors[atom];
+    scalar_ = 0.0;
+#else
+    color_ = defaultColor;
+    scalar_ = 0.0;
+#endif
+
+#if defined(HAS_RADII) && !defined(FORCE_RADIUS)
+    radius_ = radii[atom];
+#else 
+    radius_ = defaultRadius;
+#endif
+    radius_ *= radiusScaling_;
+
+#if defined(HAS_PICKING)
+    const uint pickID = picking[atom] == 0u ? 0u : picking[atom] + pickingOffset;
+#else 
+    const uint pickID = 0;
+#endif
+    pickColor_ = vec4(pickingIndexToColor(pickID), pickID == 0 ? 0.0 : 1.0);
+
+    if (radius_ <= 0 || color_.a <= 0) {
+        discardGlyph();
+        return;
+    }
+
+    const vec3 position = vec3(positions[3 * atom], positions[3 * atom + 1],
+                               positions[3 * atom + 2]);
+    center_ = geometry.dataToWorld * vec4(position, 1.0);
+
+    vec3 camDir = normalize(camera.viewToWorld[2].xyz);
+    // calculate cam position (in model space of the sphere)
+    camPos_ = camera.viewToWorld[3].xyz - center_.xyz;
+
+#ifdef DISCARD_CLIPPED_GLYPHS
+    if (dot(camPos_, camDir) < camera.nearPlane + radius_) {
+        // glyph intersects with the near plane of the camera, discard entire glyph
+        discardGlyph();
+        return;
+    }
+#endif // DISCARD_CLIPPED_GLYPHS
+
+    vec4 centerMVP = camera.worldToClip * center_;
+    float glyphDepth = centerMVP.z / centerMVP.w;
+#ifdef FRONT_DEPTH
+    // place the quad at the depth of the sphere point closest to the camera, the intersection is
+    // never in front of it, which allows a conservative depth layout in the fragment shader
+    vec4 frontMVP = camera.worldToClip * vec4(center_.xyz + radius_ * camDir, 1.0);
+    glyphDepth = frontMVP.w > 0.0 ? max(frontMVP.z / frontMVP.w, -0.999999) : -0.999999;
+#endif // FRONT_DEPTH
+
+    // camera coordinate system in object space
+    vec3 camUp = camera.viewToWorld[1].xyz;
+    vec3 camRight = normalize(cross(camDir, camUp));
+    camUp = normalize(cross(camDir, camRight));
+
+    const vec2 corner = corners[gl_VertexID] * radius_ * 1.41421356;
+    vec4 projPos = camera.worldToClip * vec4(center_.xyz + corner.x * camRight + corner.y * camUp,
+                                             1.0);
+    projPos /= projPos.w;
+    gl_Position = vec4(projPos.xy, glyphDepth, 1.0);
+}
@@ -43,6 +43,14 @@ in vec4 center_;
 flat in vec4 pickColor_;
 flat in float scalar_;
 
+#if defined(GBUFFER_PASS)
+// G-buffer outputs of molvis::DeferredShading besides FragData0 and PickingData
+out vec4 NormalData;
+out float DepthData;
+// the pre-pass might compute a slightly different depth for the same fragment
+const float depthBias = 1e-6;
+#endif
+
 
 void clipToSolid(in vec4 coord, in vec3 srcColor, out vec4 dstColor, out float dstDepth) { 
     dstDepth = 0.000001;
@@ -95,8 +103,14 @@ void main() {
 
     // shading
     vec4 glyphColor;
+#if defined(DEPTH_PREPASS) || defined(GBUFFER_PASS)
+    // only the visible fragments are lit, see molvis::DeferredShading
+    glyphColor.rgb = color_.rgb;
+    float lit = 1.0;
+#else
     glyphColor.rgb = APPLY_LIGHTING(lighting, color_.rgb, color_.rgb, vec3(1.0f), intersection,
                                normal, normalize(camPos_ - intersection));
+#endif
     glyphColor.a = color_.a;
 
     // depth correction for glyph
@@ -112,12 +126,30 @@ void main() {
         // first intersection lies behind the camera
 #ifdef DISCARD_CLIPPED_GLYPHS
         discard;
+#elif defined(DEPTH_PREPASS) || defined(GBUFFER_PASS)
+        depth = 0.000001;
+        glyphColor.rgb = color_.rgb * clipShadingFactor;
+        normal = normalize((camera.viewToWorld[2]).xyz);
+#if !defined(SHADE_CLIPPED_AREA)
+        lit = 0.0;
+#endif // SHADE_CLIPPED_AREA
 #else
         clipToSolid(coord, color_.rgb * clipShadingFactor, glyphColor, depth);
 #endif // DISCARD_CLIPPED_GLYPHS
     }
 
+#if defined(DEPTH_PREPASS)
+    gl_FragDepth = depth;
+#elif defined(GBUFFER_PASS)
+    FragData0 = glyphColor;
+    NormalData = vec4(normal, lit);
+    DepthData = depth;
+    // never in front of the impostor itself, which might be declared as conservative depth
+    gl_FragDepth = max(depth - depthBias, gl_FragCoord.z);
+    PickingData = pickColor_;
+#else
     FragData0 = glyphColor;
     gl_FragDepth = depth;
     PickingData = pickColor_;
+#endif // DEPTH_PREPASS
 }
@@ -36,6 +36,8 @@ uniform float defaultRadius = 0.1;
 uniform sampler2D metaColor;
 
 uniform float radiusScaling_ = 1.0;
+// picking IDs of the instance drawn, see MolecularRenderer
+uniform uint pickingOffset = 0u;
 
 out vec4 worldPosition_;
 out vec4 sphereColor_;
@@ -63,7 +65,7 @@ void main(void) {
     sphereRadius_ *= radiusScaling_;
 
 #if defined(HAS_PICKING)
-    pickID_ = in_Picking;
+    pickID_ = in_Picking == 0u ? 0u : in_Picking + pickingOffset;
 #else 
     pickID_ = 0;
 #endif
@@ -30,6 +30,7 @@
 
 #include <inviwo/molvisgl/molvisglmoduledefine.h>
 #include <inviwo/core/common/inviwomodule.h>
+#include <inviwo/molvisgl/rendering/shadervariantcache.h>
 
 namespace inviwo {
 
@@ -37,6 +38,11 @@ class IVW_MODULE_MOLVISGL_API MolVisGLModule : public InviwoModule {
 public:
     MolVisGLModule(InviwoApplication* app);
     virtual ~MolVisGLModule() = default;
+
+    molvis::ShaderVariantCache& getShaderVariantCache();
+
+private:
+    molvis::ShaderVariantCache shaderVariants_;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <inviwo/molvisbase/ports/molecularstructureport.h>
+
+#include <memory>
+
+namespace inviwo {
+
+class BufferObject;
+class Volume;
+
+/** \docpage{org.inviwo.MolecularDensityVolume, Molecular Density Volume}
+ * ![](org.inviwo.MolecularDensityVolume.png?classIdentifier=org.inviwo.MolecularDensityVolume)
+ * Computes a Gaussian density volume of the atoms of a molecular structure on the GPU. Each atom
+ * contributes exp(-b (d^2 / r^2 - 1)) at distance d, where r is the van der Waals radius and b
+ * the blobbiness. The isosurface at 1 is a smooth molecular surface enclosing the van der Waals
+ * spheres, and can be extracted or ray cast with the regular volume processors.
+ *
+ * Each voxel only gathers the atoms of nearby cells of the atom grid of the structure, see
+ * molvis::MolecularStructure::getAtomGrid(). The grid of each trajectory frame is thus reused and
+ * the volume can be updated every frame. The output volume is kept on the GPU.
+ *
+ * ### Inports
+ *   * __inport__  molecular structure
+ *
+ * ### Outports
+ *   * __volume__  density volume with a data range of [0, 2]
+ *
+ * ### Properties
+ *   * __Voxel Size__   edge length of a voxel in Ångström
+ *   * __Blobbiness__   larger values yield a surface closer to the van der Waals spheres
+ *   * __Radius Scaling__ scaling of the van der Waals radii
+ */
+class IVW_MODULE_MOLVISGL_API MolecularDensityVolume : public Processor {
+public:
+    MolecularDensityVolume();
+    virtual ~MolecularDensityVolume();
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    molvis::MolecularStructureInport inport_;
+    VolumeOutport outport_;
+
+    FloatProperty voxelSize_;
+    FloatProperty blobbiness_;
+    FloatProperty radiusScaling_;
+
+    Shader shader_;
+    std::unique_ptr<BufferObject> cellOffsets_;
+    std::unique_ptr<BufferObject> atoms_;
+    std::shared_ptr<Volume> volume_;
+};
+
+}  // namespace inviwo
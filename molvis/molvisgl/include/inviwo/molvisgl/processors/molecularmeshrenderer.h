@@ -42,6 +42,7 @@
 #include <inviwo/core/ports/meshport.h>
 
 #include <modules/basegl/datastructures/meshshadercache.h>
+#include <inviwo/molvisgl/rendering/shadervariantcache.h>
 
 namespace inviwo {
 
@@ -83,8 +84,9 @@ private:
     const float BallAndStickVDWScale = 0.3f;
     const float BallAndStickLicoriceScale = 0.5f;
 
-    void configureVdWShader(Shader& shader);
-    void configureLicoriceShader(Shader& shader);
+    // the shader configuration only depends on the arguments since variants are shared
+    static void configureVdWShader(Shader& shader, ShadingMode::Modes shading, bool forceRadius);
+    static void configureLicoriceShader(Shader& shader, ShadingMode::Modes shading);
 
     MeshFlatMultiInport inport_;
     ImageInport imageInport_;
@@ -100,8 +102,10 @@ private:
     SimpleLightingProperty lighting_;
     CameraTrackball trackball_;
 
-    MeshShaderCache vdwShaders_;
-    MeshShaderCache licoriceShaders_;
+    // variants of the shared molvis::ShaderVariantCache for the current configuration
+    std::shared_ptr<MeshShaderCache> vdwShaders_;
+    std::shared_ptr<MeshShaderCache> licoriceShaders_;
+    std::shared_ptr<molvis::ShaderVariantCache::Callback> shaderReload_;
 };
 
 }  // namespace inviwo
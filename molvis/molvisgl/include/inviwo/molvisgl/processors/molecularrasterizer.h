@@ -42,10 +42,18 @@
 #include <modules/basegl/datastructures/meshshadercache.h>
 #include <inviwo/molvisbase/ports/molecularstructureport.h>
 #include <inviwo/molvisbase/util/aminoacid.h>
+#include <inviwo/molvisbase/util/molecularmesh.h>
+#include <inviwo/molvisgl/rendering/cartoontessellation.h>
+#include <inviwo/molvisgl/rendering/molecularculling.h>
+#include <inviwo/molvisgl/rendering/shadervariantcache.h>
+#include <inviwo/molvisgl/rendering/vertexpulling.h>
+#include <inviwo/molvisgl/rendering/weightedblendedoit.h>
 
 #include <modules/meshrenderinggl/datastructures/rasterization.h>
 #include <modules/meshrenderinggl/ports/rasterizationport.h>
 
+#include <string>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.MolecularRasterizer, Molecular Rasterizer}
@@ -58,13 +66,30 @@ namespace inviwo {
  *    - VDW (van der Waals): considers only atoms
  *    - Licorice:            considers both atoms and bonds
  *    - Ball & Stick:        considers both atoms and bonds
+ *    - Ribbon:              flat ribbon through the CA atoms of the protein backbone
+ *    - Cartoon:             backbone with helices and sheets as wide and coils as thin tubes
+ *
+ * Ribbons and cartoons are tessellated on the GPU, see molvis::CartoonTessellation, and require
+ * OpenGL 4.3.
+ *
+ * Atoms and bonds outside the view frustum are culled on the GPU, see molvis::MolecularCulling.
+ * Occlusion culling is not used since transparent fragments behind other atoms are still needed.
+ * The impostors are either generated in geometry shaders or with vertex pulling, see
+ * molvis::ImpostorPipeline. Structures with instance transforms are drawn from a single mesh once
+ * per instance.
+ *
+ * Transparent molecules are either rendered exactly into fragment lists, or approximately with
+ * weighted blended order-independent transparency in a fixed amount of memory, see
+ * molvis::WeightedBlendedOit. The automatic transparency mode renders opaquely if all atoms are
+ * opaque, that is for "Shade Opaque", a uniform alpha of one, or opaque colors, and otherwise
+ * prefers fragment lists if supported.
  *
  * ### Inports
  *   * __inport__      Molecular datastructures
  *
  * ### Outports
- *   * __rasterization__ rasterization functor rendering  the molecule either opaquely or into
- *                    fragment buffer
+ *   * __rasterization__ rasterization functor rendering  the molecule either opaquely, into
+ *                    fragment buffer, or with weighted blended transparency
  */
 class IVW_MODULE_MOLVISGL_API MolecularRasterizer : public Processor {
     friend class MolecularRasterization;
@@ -82,24 +107,27 @@ public:
 
 private:
     enum class Representation { VDW, Licorice, BallAndStick, Ribbon, Cartoon };
-    enum class Coloring { Atoms, Residues, Chains, Fixed };
-
-    struct ColorMapping {
-        Coloring coloring;
-        molvis::element::Colormap atoms;
-        molvis::aminoacid::Colormap aminoacids;
-        vec4 fixedColor;
-    };
+    enum class Transparency { Automatic, Opaque, FragmentLists, WeightedBlended };
+    using Coloring = molvis::Coloring;
+    using ColorMapping = molvis::ColorMapping;
 
     const float BallAndStickVDWScale = 0.3f;
     const float BallAndStickLicoriceScale = 0.5f;
 
-    void configureVdWShader(Shader& shader);
-    void configureLicoriceShader(Shader& shader);
-    void configureOITShader(Shader& shader);
-
-    static std::shared_ptr<Mesh> createMesh(const molvis::MolecularStructure& s,
-                                            ColorMapping colormap, size_t pickingId);
+    // Shader configuration of a variant of the shared molvis::ShaderVariantCache
+    struct ShaderConfig {
+        ShadingMode::Modes shading;
+        bool forceRadius;
+        Transparency transparency;
+        bool uniformAlpha;
+        std::string variant() const;
+    };
+    static void configureVdWShader(Shader& shader, const ShaderConfig& config);
+    static void configureLicoriceShader(Shader& shader, const ShaderConfig& config);
+    static void configureCartoonShader(Shader& shader, const ShaderConfig& config, bool ribbon);
+    static void configureOITShader(Shader& shader, const ShaderConfig& config);
+    // resolves Transparency::Automatic and unsupported modes
+    Transparency transparencyMode() const;
 
     molvis::MolecularStructureFlatMultiInport inport_;
     RasterizationOutport outport_;
@@ -113,20 +141,38 @@ private:
     BoolProperty forceOpaque_;
     BoolProperty useUniformAlpha_;
     FloatProperty uniformAlpha_;
+    TemplateOptionProperty<Transparency> transparency_;
 
     FloatProperty radiusScaling_;
     BoolProperty forceRadius_;
     FloatProperty defaultRadius_;
 
     BoolProperty enableTooltips_;
+    BoolProperty frustumCulling_;
+    TemplateOptionProperty<molvis::ImpostorPipeline> impostors_;
 
     CameraProperty camera_;
     SimpleLightingProperty lighting_;
 
     std::shared_ptr<MeshShaderCache> vdwShaders_;
     std::shared_ptr<MeshShaderCache> licoriceShaders_;
-
+    std::shared_ptr<MeshShaderCache> vdwPullingShaders_;
+    std::shared_ptr<MeshShaderCache> licoricePullingShaders_;
+    std::shared_ptr<MeshShaderCache> ribbonShaders_;
+    std::shared_ptr<MeshShaderCache> cartoonShaders_;
+    std::shared_ptr<molvis::ShaderVariantCache::Callback> shaderReload_;
+    // created on first use, if supported
+    std::shared_ptr<molvis::MolecularCulling> culling_;
+    std::shared_ptr<molvis::CartoonTessellation> cartoon_;
+    std::shared_ptr<molvis::WeightedBlendedOit> weightedOit_;
+    // transparency mode the shaders were configured for
+    Transparency shaderTransparency_ = Transparency::Opaque;
+
+    // persistent meshes, only the buffers affected by a change are updated
+    std::vector<molvis::MolecularMesh> molecularMeshes_;
     std::vector<std::shared_ptr<Mesh>> meshes_;
+    // instance transforms of each mesh, see molvis::instanceTransforms
+    std::vector<std::vector<mat4>> instances_;
 };
 
 /**
@@ -147,14 +193,27 @@ protected:
 
     MolecularRasterizer::Representation representation_;
     float radiusScaling_;
+    bool forceRadius_;
     float defaultRadius_;
     LightingState lighting_;
     float uniformAlpha_;
-    const bool forceOpaque_;
+    const MolecularRasterizer::Transparency transparency_;
 
     std::shared_ptr<MeshShaderCache> vdwShaders_;
     std::shared_ptr<MeshShaderCache> licoriceShaders_;
+    // null unless vertex pulling is selected
+    std::shared_ptr<MeshShaderCache> vdwPullingShaders_;
+    std::shared_ptr<MeshShaderCache> licoricePullingShaders_;
+    std::shared_ptr<MeshShaderCache> ribbonShaders_;
+    std::shared_ptr<MeshShaderCache> cartoonShaders_;
+    // null unless the ribbon or cartoon representation is selected
+    std::shared_ptr<const molvis::CartoonTessellation> cartoon_;
+    // null if frustum culling is disabled
+    std::shared_ptr<molvis::MolecularCulling> culling_;
+    // null unless weighted blended transparency is used
+    std::shared_ptr<molvis::WeightedBlendedOit> weightedOit_;
     std::vector<std::shared_ptr<Mesh>> meshes_;
+    std::vector<std::vector<mat4>> instances_;
 };
 
 }  // namespace inviwo
@@ -37,12 +37,25 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/simplelightingproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
 #include <inviwo/core/ports/imageport.h>
 #include <inviwo/core/interaction/pickingmapper.h>
 
 #include <modules/basegl/datastructures/meshshadercache.h>
 #include <inviwo/molvisbase/ports/molecularstructureport.h>
 #include <inviwo/molvisbase/util/aminoacid.h>
+#include <inviwo/molvisbase/util/molecularlod.h>
+#include <inviwo/molvisbase/util/molecularmesh.h>
+#include <inviwo/molvisgl/rendering/cartoontessellation.h>
+#include <inviwo/molvisgl/rendering/deferredshading.h>
+#include <inviwo/molvisgl/rendering/gputimer.h>
+#include <inviwo/molvisgl/rendering/lodselection.h>
+#include <inviwo/molvisgl/rendering/molecularculling.h>
+#include <inviwo/molvisgl/rendering/shadervariantcache.h>
+#include <inviwo/molvisgl/rendering/vertexpulling.h>
+
+#include <array>
+#include <optional>
 
 namespace inviwo {
 
@@ -59,6 +72,25 @@ class PickingEvent;
  *    - VDW (van der Waals): considers only atoms
  *    - Licorice:            considers both atoms and bonds
  *    - Ball & Stick:        considers both atoms and bonds
+ *    - Ribbon:              flat ribbon through the CA atoms of the protein backbone
+ *    - Cartoon:             backbone with helices and sheets as wide and coils as thin tubes
+ *
+ * Ribbons and cartoons are tessellated on the GPU from the current backbone atom positions, see
+ * molvis::CartoonTessellation. The secondary structure is derived from the backbone dihedral
+ * angles. They are neither culled nor affected by the selection, and require OpenGL 4.3.
+ *
+ * Atoms and bonds outside the view frustum, or hidden behind other atoms and bonds, are culled on
+ * the GPU before the impostors are generated, see molvis::MolecularCulling. For very large
+ * assemblies, the VDW representation can replace residues and chains covering only a few pixels
+ * with proxy spheres, see molvis::LodSelection.
+ *
+ * Biological assemblies with instance transforms, see molvis::MolecularData, are drawn from a
+ * single mesh once per instance. Every instance is culled separately and has picking IDs of its
+ * own.
+ *
+ * With deferred shading, the VDW, licorice, and ball & stick impostors are first drawn into the
+ * depth buffer only. They are then drawn again into a G-buffer, where early depth testing rejects
+ * the hidden fragments, and only the visible fragments are lit, see molvis::DeferredShading.
  *
  * ### Inports
  *   * __inport__      Molecular datastructures
@@ -67,6 +99,25 @@ class PickingEvent;
  * ### Outports
  *   * __outport__ output image containing the moleculare rendering of the input
  *
+ * ### Properties
+ *   * __Culling__    GPU culling of atoms and bonds against the view frustum and optionally the
+ *                    depth of the previous pass. Requires OpenGL 4.3, otherwise everything is
+ *                    drawn.
+ *   * __Impostors__  Expand atoms and bonds into impostors in a geometry shader or with
+ *                    instanced vertex pulling, see molvis::ImpostorPipeline. Meshes not supported
+ *                    by vertex pulling fall back to the geometry shader.
+ *   * __GPU Time__   GPU time of the molecular rendering in the previous frame, for comparing
+ *                    culling modes and impostor pipelines.
+ *   * __Level of Detail__  Draw residues and chains with a projected radius below the residue
+ *                    and chain thresholds as proxy spheres. Only used for the VDW representation
+ *                    with vertex pulling, and replaces culling for the affected meshes.
+ *   * __Selection__  Only draw the atoms matching this query and the bonds between them, e.g.
+ *                    `chain A and within 5 of resname HEM`. Everything is drawn if empty, see
+ *                    molvis::AtomSelection. Level of detail is not used while a selection is
+ *                    active.
+ *   * __Deferred Shading__  Depth pre-pass and deferred lighting of the VDW, licorice, and
+ *                    ball & stick impostors, which pays off for dense structures with a lot of
+ *                    overdraw. Level of detail is not used with deferred shading.
  */
 class IVW_MODULE_MOLVISGL_API MolecularRenderer : public Processor {
 public:
@@ -84,22 +135,22 @@ private:
     void handlePicking(PickingEvent* p);
 
     enum class Representation { VDW, Licorice, BallAndStick, Ribbon, Cartoon };
-    enum class Coloring { Atoms, Residues, Chains, Fixed };
-
-    struct ColorMapping {
-        Coloring coloring;
-        molvis::element::Colormap atoms;
-        molvis::aminoacid::Colormap aminoacids;
-        vec4 fixedColor;
-    };
+    using Coloring = molvis::Coloring;
+    using ColorMapping = molvis::ColorMapping;
 
     const float BallAndStickVDWScale = 0.3f;
     const float BallAndStickLicoriceScale = 0.5f;
 
-    void configureVdWShader(Shader& shader);
-    void configureLicoriceShader(Shader& shader);
-    static std::shared_ptr<Mesh> createMesh(const molvis::MolecularStructure& s,
-                                            ColorMapping colormap, size_t pickingId);
+    // the shader configuration only depends on the arguments since variants are shared
+    using ShadingPass = std::optional<molvis::DeferredShading::Pass>;
+    static void configureVdWShader(Shader& shader, ShadingMode::Modes shading, bool forceRadius,
+                                   ShadingPass pass = std::nullopt);
+    static void configureLicoriceShader(Shader& shader, ShadingMode::Modes shading,
+                                        ShadingPass pass = std::nullopt);
+    // declares the impostor depth as never in front of the rasterized depth, if supported
+    static void addConservativeDepth(Shader& shader);
+    static void configureCartoonShader(Shader& shader, ShadingMode::Modes shading, bool ribbon);
+    void configureProxyShader();
 
     molvis::MolecularStructureFlatMultiInport inport_;
     ImageInport imageInport_;
@@ -117,16 +168,60 @@ private:
     FloatProperty defaultRadius_;
 
     BoolProperty enableTooltips_;
+    TemplateOptionProperty<molvis::MolecularCulling::Mode> cullingMode_;
+    TemplateOptionProperty<molvis::ImpostorPipeline> impostors_;
+    FloatProperty gpuTime_;
+    BoolProperty lod_;
+    FloatProperty lodResiduePixels_;
+    FloatProperty lodChainPixels_;
+    FloatProperty lodTransition_;
+    StringProperty selection_;
+    BoolProperty deferredShading_;
 
     CameraProperty camera_;
     SimpleLightingProperty lighting_;
     CameraTrackball trackball_;
 
-    MeshShaderCache vdwShaders_;
-    MeshShaderCache licoriceShaders_;
+    // variants of the shared molvis::ShaderVariantCache for the current configuration
+    std::shared_ptr<MeshShaderCache> vdwShaders_;
+    std::shared_ptr<MeshShaderCache> licoriceShaders_;
+    std::shared_ptr<MeshShaderCache> vdwPullingShaders_;
+    std::shared_ptr<MeshShaderCache> licoricePullingShaders_;
+    std::shared_ptr<MeshShaderCache> ribbonShaders_;
+    std::shared_ptr<MeshShaderCache> cartoonShaders_;
+    // depth pre-pass and G-buffer variants, indexed by molvis::DeferredShading::Pass. Only
+    // created while deferred shading is enabled.
+    using DeferredShaders = std::array<std::shared_ptr<MeshShaderCache>, 2>;
+    DeferredShaders vdwDeferredShaders_;
+    DeferredShaders licoriceDeferredShaders_;
+    DeferredShaders vdwPullingDeferredShaders_;
+    DeferredShaders licoricePullingDeferredShaders_;
+    std::shared_ptr<molvis::ShaderVariantCache::Callback> shaderReload_;
+    // residue and chain proxies, which have colors, radii, and picking IDs
+    Shader proxyShader_;
     PickingMapper atomPicking_;
 
+    // persistent meshes, only the buffers affected by a change are updated
+    std::vector<molvis::MolecularMesh> molecularMeshes_;
     std::vector<std::shared_ptr<Mesh>> meshes_;
+    // instance transforms of each mesh, the picking IDs of an instance are offset by the number of
+    // atoms from the ones of the previous instance
+    struct Instances {
+        std::vector<mat4> transforms;
+        uint32_t atomCount;
+    };
+    std::vector<Instances> instances_;
+    // selected atoms of each structure, empty if nothing is selected
+    std::vector<molvis::AtomMask> masks_;
+    // created on first use, if supported
+    std::unique_ptr<molvis::MolecularCulling> culling_;
+    molvis::GpuTimer timer_;
+    std::vector<std::shared_ptr<const molvis::LodHierarchy>> lods_;
+    std::unique_ptr<molvis::LodSelection> lodSelection_;
+    // backbone of each mesh, shared by all of its instances
+    std::unique_ptr<molvis::CartoonTessellation> cartoon_;
+    // created on first use, if supported
+    std::unique_ptr<molvis::DeferredShading> deferred_;
 };
 
 }  // namespace inviwo
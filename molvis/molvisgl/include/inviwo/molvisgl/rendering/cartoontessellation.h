@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class BufferObject;
+class Mesh;
+
+namespace molvis {
+
+class MolecularStructure;
+
+/**
+ * \brief ribbon and cartoon representation of the protein backbone tessellated on the GPU
+ *
+ * Every backbone segment with a CA atom is a control point of a Catmull-Rom spline through the CA
+ * atoms of its chain. Only the atom indices of the control points are uploaded, and only when the
+ * topology changes. A compute shader derives the frame of every control point from the current
+ * atom positions, i.e. the CA position, the direction towards the O atom made consistent along the
+ * chain, and the secondary structure classified from the backbone dihedral angles. Trajectory
+ * frames therefore only require the compute pass and no remeshing on the CPU.
+ *
+ * The spline between two consecutive control points is one patch, which is tessellated depending
+ * on its projected length, see cartoon.tesc and cartoon.tese. The cross section is an ellipse
+ * depending on the style and the secondary structure of the control points.
+ */
+class IVW_MODULE_MOLVISGL_API CartoonTessellation {
+public:
+    enum class Style { Ribbon, Cartoon };
+
+    /**
+     * Create the compute shader, which requires isSupported() to be true.
+     *
+     * @param onShaderReload  called when the compute shader is reloaded
+     */
+    explicit CartoonTessellation(std::function<void()> onShaderReload = nullptr);
+    CartoonTessellation(const CartoonTessellation&) = delete;
+    CartoonTessellation& operator=(const CartoonTessellation&) = delete;
+    ~CartoonTessellation();
+
+    /**
+     * Check whether compute shaders, shader storage buffers, and tessellation shaders are
+     * supported by the OpenGL context.
+     */
+    static bool isSupported();
+
+    /**
+     * Compute the control point frames of the backbone of \p structure for the mesh with index
+     * \p meshIndex. Nothing is done if \p structure did not change since the last update, the
+     * control points are only uploaded again if the topology changed.
+     *
+     * @param meshIndex  index of the mesh among the meshes drawn each frame
+     * @param structure  structure of the mesh
+     * @param atoms      atom mesh of \p structure created by MolecularMesh
+     */
+    void update(size_t meshIndex, std::shared_ptr<const MolecularStructure> structure,
+                const Mesh& atoms);
+
+    /**
+     * Draw the backbone of mesh \p meshIndex with the active cartoon shader. The buffers of the
+     * atom mesh have to be bound with bindVertexPullingBuffers(), they provide the colors and
+     * picking IDs of the CA atoms.
+     */
+    void draw(size_t meshIndex) const;
+
+    /**
+     * Release the backbones of meshes with an index of \p numMeshes and above.
+     */
+    void resize(size_t numMeshes);
+
+private:
+    struct Backbone {
+        std::shared_ptr<const MolecularStructure> structure;
+        size_t numControls = 0;
+        size_t numChains = 0;
+        size_t numPatches = 0;
+        // atom indices of CA, N, C, and O of each control point
+        std::unique_ptr<BufferObject> controls;
+        // first control point and number of control points of each chain
+        std::unique_ptr<BufferObject> chains;
+        // four control points per patch
+        std::unique_ptr<BufferObject> patches;
+        // position and secondary structure, and side direction of each control point
+        std::unique_ptr<BufferObject> frames;
+    };
+
+    Shader shader_;
+    std::vector<Backbone> backbones_;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/util/glmvec.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief Depth pre-pass and deferred shading of impostors
+ *
+ * Impostors are intersected and lit per fragment, and in dense structures most of these fragments
+ * are overdrawn again. Deferred shading draws the impostors twice. The first pass only writes the
+ * depth of the target, without any color output. The second pass draws the impostors again with a
+ * depth test of GL_LEQUAL and no depth writes, so only the front-most fragments remain, and writes
+ * their unlit color, normal, picking color, i.e. atom ID, and depth into a G-buffer. Finally, the
+ * G-buffer is lit once per pixel and composited onto the target. If the impostor shaders declare
+ * their depth as conservative, e.g. layout(depth_greater), the hidden fragments of the second pass
+ * are rejected by early depth testing before the intersection is computed.
+ *
+ * Usage: call beginDepth() while the target image is bound and draw the impostors with the
+ * DEPTH_PREPASS shader variants. Then call beginGBuffer(), activate the GBUFFER_PASS shader
+ * variants and call bindOutputs() for each of them, draw again, and finally light and composite
+ * the G-buffer with end(). The shaders write the unlit color to FragData0, the world space normal
+ * to NormalData, the picking color to PickingData, and the depth to DepthData. The w component of
+ * the normal is 0 for fragments which should not be lit.
+ */
+class IVW_MODULE_MOLVISGL_API DeferredShading {
+public:
+    enum class Pass { Depth, GBuffer };
+
+    explicit DeferredShading(std::function<void()> onShaderReload = nullptr);
+    DeferredShading(const DeferredShading&) = delete;
+    DeferredShading& operator=(const DeferredShading&) = delete;
+    ~DeferredShading();
+
+    /**
+     * Check whether multiple render targets with floating point formats are supported by the
+     * OpenGL context.
+     */
+    static bool isSupported();
+
+    /**
+     * Disable all color writes of the currently bound target for the depth pre-pass.
+     */
+    void beginDepth();
+
+    /**
+     * Redirect rendering into the G-buffer of size \p size. The depth of the currently bound
+     * framebuffer, filled by the depth pre-pass, is used for depth testing, but not written.
+     */
+    void beginGBuffer(const ivec2& size);
+
+    /**
+     * Map the outputs of the active \p shader to the G-buffer.
+     */
+    void bindOutputs(const Shader& shader);
+
+    /**
+     * Restore the framebuffer bound in beginGBuffer(), and light the G-buffer with \p shading and
+     * composite it onto the framebuffer. The color and picking of the target are replaced where
+     * an impostor is visible.
+     *
+     * @param shading      shading mode of the lighting
+     * @param setUniforms  callback setting the "camera" and "lighting" uniforms of the shader
+     */
+    void end(ShadingMode::Modes shading, const std::function<void(Shader&)>& setUniforms);
+
+private:
+    void resize(const ivec2& size);
+
+    Shader compositeShader_;
+    ShadingMode::Modes compositeShading_ = ShadingMode::None;
+    bool compositeBuilt_ = false;
+
+    GLuint framebuffer_ = 0;
+    // unlit color, normal, picking color, and depth
+    std::array<GLuint, 4> textures_{0, 0, 0, 0};
+    ivec2 size_{0};
+
+    std::array<GLboolean, 4> previousColorMask_{GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
+    GLint previousFramebuffer_ = 0;
+    std::vector<GLenum> previousDrawBuffers_;
+    GLint previousDepthFunc_ = GL_LESS;
+    GLboolean previousDepthMask_ = GL_TRUE;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,139 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/util/glmvec.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class BufferObject;
+class Mesh;
+
+namespace molvis {
+
+struct LodHierarchy;
+
+/**
+ * \brief GPU selection of atoms, residue proxies, and chain proxies by projected size
+ *
+ * A compute shader computes the projected radius of the bounding sphere of each chain and residue
+ * of a LodHierarchy. Clusters smaller than a threshold are drawn as their proxy sphere instead of
+ * their atoms. Within a transition band above the threshold, the proxy grows from zero to its full
+ * radius while the finer level is still drawn, which avoids popping. Clusters outside the view
+ * frustum are skipped together with all their atoms.
+ *
+ * The selected atoms and proxies are drawn with vertex pulling, one indirect draw call per level,
+ * see vdw-pulling.vert.
+ */
+class IVW_MODULE_MOLVISGL_API LodSelection {
+public:
+    enum class Level { Atoms, Residues, Chains };
+
+    struct Thresholds {
+        float residuePixels;  //!< residues with a smaller projected radius are replaced
+        float chainPixels;    //!< chains with a smaller projected radius are replaced
+        float transition;     //!< width of the transition band relative to the thresholds
+    };
+
+    /**
+     * Create the compute shader, which requires isSupported() to be true.
+     *
+     * @param onShaderReload  called when the compute shader is reloaded
+     */
+    explicit LodSelection(std::function<void()> onShaderReload = nullptr);
+    LodSelection(const LodSelection&) = delete;
+    LodSelection& operator=(const LodSelection&) = delete;
+    ~LodSelection();
+
+    /**
+     * Check whether compute shaders, shader storage buffers, and indirect draw calls are
+     * supported by the OpenGL context.
+     */
+    static bool isSupported();
+
+    /**
+     * Select the atoms and proxies to draw for the mesh with index \p meshIndex, see class
+     * description. The hierarchy is uploaded again whenever \p lod changes.
+     *
+     * @param meshIndex    index of the mesh among the meshes drawn each frame
+     * @param atoms        atom mesh created by MolecularMesh
+     * @param lod          proxies of the atoms in \p atoms
+     * @param thresholds   thresholds in pixels of the residue and chain levels
+     * @param viewport     size of the render target in pixels
+     * @param setUniforms  callback setting the "camera" and "geometry" uniforms of the shader
+     */
+    void select(size_t meshIndex, const Mesh& atoms, std::shared_ptr<const LodHierarchy> lod,
+                const Thresholds& thresholds, ivec2 viewport,
+                const std::function<void(Shader&)>& setUniforms);
+
+    /**
+     * Draw the atoms or proxies of \p level selected by the last select() of mesh \p meshIndex
+     * with the active vertex pulling shader. The buffers of the atom mesh have to be bound with
+     * bindVertexPullingBuffers() for Level::Atoms, the buffers of the proxies are bound here.
+     */
+    void draw(size_t meshIndex, Level level) const;
+
+    /**
+     * Release the selection state of meshes with an index of \p numMeshes and above.
+     */
+    void resize(size_t numMeshes);
+
+private:
+    struct Selected {
+        size_t size = 0;
+        std::unique_ptr<BufferObject> drawIndices;
+        std::unique_ptr<BufferObject> command;
+        // radii of the proxies, scaled during transitions
+        std::unique_ptr<BufferObject> radii;
+    };
+    struct Selection {
+        std::shared_ptr<const LodHierarchy> lod;
+        // residue chains followed by atom residues
+        std::unique_ptr<BufferObject> parents;
+        // chain states followed by residue states
+        std::unique_ptr<BufferObject> states;
+        std::array<Selected, 3> levels;
+    };
+
+    Shader shader_;
+    std::vector<Selection> selections_;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
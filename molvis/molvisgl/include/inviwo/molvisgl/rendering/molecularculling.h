@@ -0,0 +1,168 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/datastructures/geometry/geometrytype.h>
+#include <inviwo/core/util/glmvec.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class BufferBase;
+class BufferObject;
+class Image;
+class Mesh;
+
+namespace molvis {
+
+/**
+ * \brief GPU frustum and occlusion culling of atoms and bonds
+ *
+ * A compute shader tests the bounding spheres of the atoms or bonds of a mesh against the view
+ * frustum and writes the indices of the remaining ones into a compacted index buffer. This buffer
+ * is then drawn with a single indirect draw call, and only atoms and bonds which might be visible
+ * reach the geometry shaders of the VdW and licorice impostors.
+ *
+ * Occlusion culling requires two passes per frame. The first pass draws the primitives visible in
+ * the previous frame (Pass::Visible). A hierarchical depth buffer is then built from the resulting
+ * depth, see updateDepthPyramid(), and the second pass culls all primitives against it
+ * (Pass::Occlusion). The second pass draws the primitives which were not visible in the previous
+ * frame and updates the visibility for the next frame. The depth pyramid only contains primitives
+ * which are actually drawn, so no visible primitive is lost even if the previous visibility is
+ * outdated, for example after a camera change.
+ */
+class IVW_MODULE_MOLVISGL_API MolecularCulling {
+public:
+    enum class Mode { None, Frustum, FrustumAndOcclusion };
+    enum class Pass {
+        Frustum,    //!< primitives inside the view frustum
+        Visible,    //!< primitives inside the view frustum and visible in the previous frame
+        Occlusion,  //!< newly visible primitives, neither outside the frustum nor occluded
+    };
+
+    /**
+     * Atoms (DrawType::Points) or bonds (DrawType::Lines) of a mesh and their radius
+     */
+    struct Primitives {
+        DrawType drawType;
+        float radius;       //!< radius of the primitives, or scaling factor of the atom radii
+        bool useAtomRadii;  //!< use the radii buffer of the mesh scaled by radius
+    };
+
+    /**
+     * Create the compute shaders, which requires isSupported() to be true.
+     *
+     * @param onShaderReload  called when one of the compute shaders is reloaded
+     */
+    explicit MolecularCulling(std::function<void()> onShaderReload = nullptr);
+    MolecularCulling(const MolecularCulling&) = delete;
+    MolecularCulling& operator=(const MolecularCulling&) = delete;
+    ~MolecularCulling();
+
+    /**
+     * Check whether compute shaders, shader storage buffers, and indirect draw calls are
+     * supported by the OpenGL context.
+     */
+    static bool isSupported();
+
+    /**
+     * Cull the primitives of the mesh with index \p meshIndex, see class description. The
+     * culling state of each mesh is kept until the mesh indices change.
+     *
+     * @param meshIndex    index of the mesh among the meshes drawn each frame
+     * @param mesh         mesh with a vec3 position buffer and an index buffer of the primitives
+     * @param primitives   primitives to cull
+     * @param pass         culling pass
+     * @param setUniforms  callback setting the "camera" and "geometry" uniforms of the shader
+     * @return false if the mesh has no suitable buffers and has to be drawn without culling
+     */
+    bool cull(size_t meshIndex, const Mesh& mesh, const Primitives& primitives, Pass pass,
+              const std::function<void(Shader&)>& setUniforms);
+
+    /**
+     * Draw the primitives which passed the last cull() of mesh \p meshIndex and \p drawType. The
+     * vertex array of the mesh and the shader have to be bound.
+     */
+    void draw(size_t meshIndex, DrawType drawType) const;
+
+    /**
+     * Draw one instance of a triangle strip with \p verticesPerInstance vertices for each
+     * primitive which passed the last cull() of mesh \p meshIndex and \p drawType. The vertex
+     * indices of the primitives are bound as shader storage buffer \p indexBinding, instance i
+     * corresponds to the indices [i * n, (i + 1) * n) for n vertices per primitive.
+     *
+     * @see drawPulledImpostors
+     */
+    void drawInstances(size_t meshIndex, DrawType drawType, GLuint verticesPerInstance,
+                       GLuint indexBinding) const;
+
+    /**
+     * Build the depth pyramid of Pass::Occlusion from the depth layer of \p image. The image must
+     * not be the active render target.
+     */
+    void updateDepthPyramid(const Image& image);
+
+    /**
+     * Release the culling state of meshes with an index of \p numMeshes and above.
+     */
+    void resize(size_t numMeshes);
+
+private:
+    struct Culled {
+        const BufferBase* indices = nullptr;
+        size_t numPrimitives = 0;
+        std::unique_ptr<BufferObject> visibility;
+        std::unique_ptr<BufferObject> drawIndices;
+        std::unique_ptr<BufferObject> command;
+    };
+    static size_t slot(DrawType drawType);
+
+    Shader cullingShader_;
+    Shader copyDepthShader_;
+    Shader reduceDepthShader_;
+
+    // atoms and bonds of each mesh
+    std::vector<std::array<Culled, 2>> culled_;
+
+    GLuint depthPyramid_ = 0;
+    ivec2 pyramidSize_{0};
+    int pyramidLevels_ = 0;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,117 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/util/dispatcher.h>
+#include <modules/basegl/datastructures/meshshadercache.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+class InviwoApplication;
+
+namespace molvis {
+
+/**
+ * \brief module wide cache of shader variants shared between processors
+ *
+ * A variant is a MeshShaderCache, i.e. the shaders of one set of shader files for all mesh buffer
+ * layouts, configured for one combination of shader defines. Variants are identified by a name,
+ * which determines the shader files and buffer requirements, and by a variant key describing the
+ * configuration, e.g. the shading mode and the defines derived from processor properties.
+ *
+ * Processors with the same configuration share the variant and its compiled shaders. Unused
+ * variants are kept until more than the capacity of them exist, releasing the least recently
+ * used ones first. Switching back to a previous configuration, for example toggling Force Radius,
+ * therefore reuses the shaders compiled before instead of recompiling them.
+ */
+class IVW_MODULE_MOLVISGL_API ShaderVariantCache {
+public:
+    using Callback = std::function<void()>;
+
+    explicit ShaderVariantCache(size_t capacity = 32);
+    ShaderVariantCache(const ShaderVariantCache&) = delete;
+    ShaderVariantCache& operator=(const ShaderVariantCache&) = delete;
+
+    /**
+     * Return variant \p variant of the shaders \p name, which is created from \p items and
+     * \p requirements if it does not exist yet. Every new shader of the variant is passed to
+     * \p configure, which has to build it. As the variant is shared, \p configure must only depend
+     * on \p name and \p variant.
+     */
+    std::shared_ptr<MeshShaderCache> get(std::string_view name,
+                                         std::vector<std::pair<ShaderType, std::string>> items,
+                                         std::vector<MeshShaderCache::Requirement> requirements,
+                                         std::string_view variant,
+                                         std::function<void(Shader&)> configure);
+
+    /**
+     * The callback is called when a shader of any variant has been reloaded. It is removed when
+     * the returned handle is destroyed.
+     */
+    std::shared_ptr<Callback> onReload(Callback callback);
+
+    // Maximum number of unused variants kept
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+    size_t size() const;
+    // Release all variants not in use
+    void clear();
+
+private:
+    struct Variant {
+        std::shared_ptr<MeshShaderCache> shaders;
+        size_t lastUse = 0;
+    };
+    void evict(size_t capacity);
+
+    size_t capacity_;
+    size_t useCounter_ = 0;
+    std::unordered_map<std::string, Variant> variants_;
+    Dispatcher<void()> reloaded_;
+};
+
+/**
+ * Return the shader variant cache of the MolVisGL module.
+ */
+IVW_MODULE_MOLVISGL_API ShaderVariantCache& getShaderVariantCache(InviwoApplication* app);
+IVW_MODULE_MOLVISGL_API ShaderVariantCache& getShaderVariantCache();
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,84 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/datastructures/geometry/geometrytype.h>
+#include <modules/opengl/inviwoopengl.h>
+
+namespace inviwo {
+
+class Mesh;
+
+namespace molvis {
+
+/**
+ * How the VdW spheres and licorice capsules are expanded into screen-space impostors
+ */
+enum class ImpostorPipeline {
+    GeometryShader,  //!< points and lines are expanded in a geometry shader
+    /**
+     * instanced triangle strips reading the atom attributes from shader storage buffers, see
+     * vdw-pulling.vert and licorice-pulling.vert
+     */
+    VertexPulling,
+};
+
+/// shader storage buffer binding of the atom or bond indices read by the vertex pulling shaders
+constexpr GLuint vertexPullingIndexBinding = 5;
+
+/// number of vertices of one impostor instance, a quad for atoms and a box for bonds
+constexpr GLuint impostorVertices(DrawType drawType) {
+    return drawType == DrawType::Lines ? 14 : 4;
+}
+
+/**
+ * Check whether the atoms (DrawType::Points) or bonds (DrawType::Lines) of \p mesh can be drawn
+ * with vertex pulling. This requires shader storage buffers and mesh buffers in the formats created
+ * by MolecularMesh, i.e. vec3 positions, vec4 colors, float radii, uint32 picking IDs, and float
+ * scalar meta data.
+ */
+IVW_MODULE_MOLVISGL_API bool supportsVertexPulling(const Mesh& mesh, DrawType drawType);
+
+/**
+ * Bind the attribute buffers of \p mesh to the shader storage buffer bindings of the vertex
+ * pulling shaders. Call after activating the shader.
+ */
+IVW_MODULE_MOLVISGL_API void bindVertexPullingBuffers(const Mesh& mesh);
+
+/**
+ * Draw one impostor instance per atom or bond of all index buffers of \p mesh matching
+ * \p drawType. The attribute buffers have to be bound with bindVertexPullingBuffers() before.
+ */
+IVW_MODULE_MOLVISGL_API void drawPulledImpostors(const Mesh& mesh, DrawType drawType);
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,106 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/molvisgl/molvisglmoduledefine.h>
+#include <inviwo/core/util/glmvec.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace inviwo {
+
+namespace molvis {
+
+/**
+ * \brief Weighted blended order-independent transparency
+ *
+ * Approximate alternative to fragment lists with a fixed amount of memory, two render targets of
+ * the image size, see McGuire and Bavoil, Weighted Blended Order-Independent Transparency, JCGT
+ * 2(2), 2013. Transparent fragments are accumulated in any order with additive blending, no
+ * sorting and no per pixel storage of fragments is needed. The result is exact for fragments of
+ * the same color and a good approximation for moderate opacities.
+ *
+ * Usage: call begin() while the target image is bound, activate the shaders and call
+ * bindOutputs() for each of them, draw, and finally blend the result into the target image with
+ * end(). The shaders write the outputs of weightedOitRender() in weightedoit.glsl to FragData0
+ * and PickingData.
+ */
+class IVW_MODULE_MOLVISGL_API WeightedBlendedOit {
+public:
+    explicit WeightedBlendedOit(std::function<void()> onShaderReload = nullptr);
+    WeightedBlendedOit(const WeightedBlendedOit&) = delete;
+    WeightedBlendedOit& operator=(const WeightedBlendedOit&) = delete;
+    ~WeightedBlendedOit();
+
+    /**
+     * Check whether per render target blend functions are supported by the OpenGL context.
+     */
+    static bool isSupported();
+
+    /**
+     * Redirect rendering into the accumulation targets of size \p size. The depth of the
+     * currently bound framebuffer is used for depth testing, but not written.
+     */
+    void begin(const ivec2& size);
+
+    /**
+     * Map the outputs of the active \p shader to the accumulation targets and set up the blending.
+     */
+    void bindOutputs(const Shader& shader);
+
+    /**
+     * Restore the framebuffer bound in begin() and composite the transparent fragments onto it.
+     */
+    void end();
+
+private:
+    void resize(const ivec2& size);
+
+    Shader compositeShader_;
+
+    GLuint framebuffer_ = 0;
+    // accumulated color and revealage
+    std::array<GLuint, 2> textures_{0, 0};
+    ivec2 size_{0};
+
+    GLint previousFramebuffer_ = 0;
+    std::vector<GLenum> previousDrawBuffers_;
+    GLboolean previousBlend_ = GL_FALSE;
+    std::array<GLint, 4> previousBlendFunc_{GL_ONE, GL_ZERO, GL_ONE, GL_ZERO};
+    GLboolean previousDepthMask_ = GL_TRUE;
+};
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -30,6 +30,7 @@
 #include <inviwo/molvisgl/molvisglmodule.h>
 #include <inviwo/molvisgl/datavisualizer/molecularmeshrendervisualizer.h>
 #include <inviwo/molvisgl/datavisualizer/molecularstructurevisualizer.h>
+#include <inviwo/molvisgl/processors/moleculardensityvolume.h>
 #include <inviwo/molvisgl/processors/molecularmeshrenderer.h>
 #include <inviwo/molvisgl/processors/molecularrasterizer.h>
 #include <inviwo/molvisgl/processors/molecularrenderer.h>
@@ -40,6 +41,7 @@ namespace inviwo {
 MolVisGLModule::MolVisGLModule(InviwoApplication* app) : InviwoModule(app, "MolVisGL") {
     ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
 
+    registerProcessor<MolecularDensityVolume>();
     registerProcessor<MolecularMeshRenderer>();
     registerProcessor<MolecularRasterizer>();
     registerProcessor<MolecularRenderer>();
@@ -48,4 +50,6 @@ MolVisGLModule::MolVisGLModule(InviwoApplication* app) : InviwoModule(app, "MolV
     registerDataVisualizer(std::make_unique<MolecularMeshRenderVisualizer>(app));
 }
 
+molvis::ShaderVariantCache& MolVisGLModule::getShaderVariantCache() { return shaderVariants_; }
+
 }  // namespace inviwo
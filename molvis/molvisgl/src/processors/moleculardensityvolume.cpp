@@ -0,0 +1,165 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/processors/moleculardensityvolume.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/molvisbase/util/molecularmesh.h>
+#include <modules/opengl/buffer/bufferobject.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/texture/texture3d.h>
+#include <modules/opengl/volume/volumegl.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inviwo {
+
+namespace {
+
+constexpr GLuint groupSize = 4;
+// atoms contribute less than this fraction of their central density beyond the cutoff
+constexpr double contributionCutoff = 1.0e-3;
+
+std::unique_ptr<BufferObject> makeBuffer(const void* data, size_t bytes) {
+    bytes = std::max<size_t>(bytes, sizeof(GLuint));
+    auto buffer = std::make_unique<BufferObject>(bytes, DataUInt32::get(), BufferUsage::Dynamic,
+                                                 BufferTarget::Data);
+    buffer->initialize(data, bytes);
+    return buffer;
+}
+
+}  // namespace
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo MolecularDensityVolume::processorInfo_{
+    "org.inviwo.molvis.MolecularDensityVolume",  // Class identifier
+    "Molecular Density Volume",                  // Display name
+    "MolVis",                                    // Category
+    CodeState::Experimental,                     // Code state
+    "GL, MolVis, Surface",                       // Tags
+};
+const ProcessorInfo MolecularDensityVolume::getProcessorInfo() const { return processorInfo_; }
+
+MolecularDensityVolume::MolecularDensityVolume()
+    : Processor()
+    , inport_("inport")
+    , outport_("volume")
+    , voxelSize_("voxelSize", "Voxel Size", 0.5f, 0.05f, 5.0f, 0.05f)
+    , blobbiness_("blobbiness", "Blobbiness", 2.0f, 0.1f, 10.0f, 0.1f)
+    , radiusScaling_("radiusScaling", "Radius Scaling", 1.0f, 0.1f, 2.0f, 0.01f)
+    , shader_({{ShaderType::Compute, "moleculardensity.comp"}}) {
+
+    addPort(inport_);
+    addPort(outport_);
+    addProperties(voxelSize_, blobbiness_, radiusScaling_);
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+}
+
+MolecularDensityVolume::~MolecularDensityVolume() = default;
+
+void MolecularDensityVolume::process() {
+    auto s = inport_.getData();
+    if (!s->hasAtoms()) {
+        outport_.clear();
+        return;
+    }
+
+    const auto& grid = s->getAtomGrid();
+    const auto radii = molvis::atomRadii(*s);
+    const double maxRadius = *std::max_element(radii.begin(), radii.end()) * radiusScaling_;
+    // squared distance in multiples of the radius beyond which an atom is ignored
+    const double cutoffScale = 1.0 - std::log(contributionCutoff) / blobbiness_;
+    const double cutoff = maxRadius * std::sqrt(cutoffScale);
+
+    if (inport_.isChanged() || !atoms_) {
+        std::vector<GLuint> offsets(grid.cellOffsets().begin(), grid.cellOffsets().end());
+        // positions sorted by grid cell with the radius in w
+        std::vector<vec4> atoms(grid.positions().size());
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            atoms[i] = vec4{vec3{grid.positions()[i]},
+                            static_cast<float>(radii[grid.atomIndices()[i]])};
+        }
+        cellOffsets_ = makeBuffer(offsets.data(), offsets.size() * sizeof(GLuint));
+        atoms_ = makeBuffer(atoms.data(), atoms.size() * sizeof(vec4));
+    }
+
+    // the volume encloses all atoms and their surface
+    dvec3 min{s->atoms().positions.front()};
+    dvec3 max{min};
+    for (auto& p : s->atoms().positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    min -= cutoff;
+    max += cutoff;
+    const size3_t dims{glm::max(dvec3{1.0}, glm::ceil((max - min) / double{voxelSize_}))};
+    const dvec3 extent = dvec3{dims} * double{voxelSize_};
+
+    // the volume is reused for trajectory frames of the same size
+    if (!volume_ || volume_->getDimensions() != dims) {
+        volume_ = std::make_shared<Volume>(std::make_shared<VolumeGL>(dims, DataFloat32::get()));
+    }
+    const vec3 ext{extent};
+    volume_->setBasis(
+        mat3(vec3(ext.x, 0.0f, 0.0f), vec3(0.0f, ext.y, 0.0f), vec3(0.0f, 0.0f, ext.z)));
+    volume_->setOffset(vec3{min});
+    volume_->dataMap_.dataRange = dvec2{0.0, 2.0};
+    volume_->dataMap_.valueRange = dvec2{0.0, 2.0};
+
+    auto texture = volume_->getEditableRepresentation<VolumeGL>()->getTexture();
+
+    shader_.activate();
+    shader_.setUniform("dimensions", ivec3{dims});
+    shader_.setUniform("volumeOrigin", vec3{min});
+    shader_.setUniform("voxelSize", static_cast<float>(voxelSize_));
+    shader_.setUniform("gridOrigin", vec3{grid.getOrigin()});
+    shader_.setUniform("cellExtent", vec3{grid.getCellExtent()});
+    shader_.setUniform("gridDimensions", ivec3{grid.getDimensions()});
+    shader_.setUniform("blobbiness", static_cast<float>(blobbiness_));
+    shader_.setUniform("radiusScaling", static_cast<float>(radiusScaling_));
+    shader_.setUniform("cutoff", static_cast<float>(cutoff));
+    shader_.setUniform("cutoffScale", static_cast<float>(cutoffScale));
+
+    glBindImageTexture(0, texture->getID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R32F);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellOffsets_->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, atoms_->getId());
+
+    const auto groups = (uvec3{dims} + groupSize - 1u) / groupSize;
+    glDispatchCompute(groups.x, groups.y, groups.z);
+    shader_.deactivate();
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    LGL_ERROR;
+
+    outport_.setData(volume_);
+}
+
+}  // namespace inviwo
@@ -66,34 +66,8 @@ MolecularMeshRenderer::MolecularMeshRenderer()
     , camera_("camera", "Camera", util::boundingBox(inport_))
     , lighting_("lighting", "Lighting", &camera_)
     , trackball_(&camera_)
-
-    , vdwShaders_{{{ShaderType::Vertex, std::string{"vdw.vert"}},
-                   {ShaderType::Geometry, std::string{"vdw.geom"}},
-                   {ShaderType::Fragment, std::string{"vdw.frag"}}},
-                  {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-                   {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-                   {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
-                   {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
-                   {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
-
-                  [&](Shader& shader) -> void {
-                      shader.onReload(
-                          [this]() { invalidate(InvalidationLevel::InvalidResources); });
-                      configureVdWShader(shader);
-                  }}
-    , licoriceShaders_{
-          {{ShaderType::Vertex, std::string{"licorice.vert"}},
-           {ShaderType::Geometry, std::string{"licorice.geom"}},
-           {ShaderType::Fragment, std::string{"licorice.frag"}}},
-          {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-           {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-           {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
-           {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
-
-          [&](Shader& shader) -> void {
-              shader.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
-              configureLicoriceShader(shader);
-          }} {
+    , shaderReload_{molvis::getShaderVariantCache().onReload(
+          [this]() { invalidate(InvalidationLevel::InvalidResources); })} {
     addPort(inport_);
     addPort(imageInport_);
     addPort(outport_);
@@ -131,7 +105,7 @@ void MolecularMeshRenderer::process() {
 
     auto drawVdW = [&](float radius) {
         for (auto mesh : inport_) {
-            auto& shader = vdwShaders_.getShader(*mesh);
+            auto& shader = vdwShaders_->getShader(*mesh);
 
             shader.activate();
             utilgl::setUniforms(shader, camera_, lighting_, defaultRadius_);
@@ -148,7 +122,7 @@ void MolecularMeshRenderer::process() {
     };
     auto drawLicorice = [&](float radius) {
         for (auto mesh : inport_) {
-            auto& shader = licoriceShaders_.getShader(*mesh);
+            auto& shader = licoriceShaders_->getShader(*mesh);
             shader.activate();
             utilgl::setUniforms(shader, camera_, lighting_, defaultRadius_);
             shader.setUniform("radius_", 0.25f * radius);
@@ -187,24 +161,48 @@ void MolecularMeshRenderer::process() {
 }
 
 void MolecularMeshRenderer::initializeResources() {
-    for (auto& item : vdwShaders_.getShaders()) {
-        configureVdWShader(item.second);
-    }
-    for (auto& item : licoriceShaders_.getShaders()) {
-        configureLicoriceShader(item.second);
-    }
+    auto& variants = molvis::getShaderVariantCache();
+    const auto shading = static_cast<ShadingMode::Modes>(lighting_.shadingMode_.get());
+    const bool forceRadius = forceRadius_;
+
+    vdwShaders_ = variants.get(
+        "MolecularMeshRenderer.vdw",
+        {{ShaderType::Vertex, std::string{"vdw.vert"}},
+         {ShaderType::Geometry, std::string{"vdw.geom"}},
+         {ShaderType::Fragment, std::string{"vdw.frag"}}},
+        {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+         {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+         {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
+         {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+         {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+        fmt::format("{}|{}", static_cast<int>(shading), forceRadius),
+        [shading, forceRadius](Shader& shader) {
+            configureVdWShader(shader, shading, forceRadius);
+        });
+    licoriceShaders_ = variants.get(
+        "MolecularMeshRenderer.licorice",
+        {{ShaderType::Vertex, std::string{"licorice.vert"}},
+         {ShaderType::Geometry, std::string{"licorice.geom"}},
+         {ShaderType::Fragment, std::string{"licorice.frag"}}},
+        {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+         {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+         {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+         {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+        fmt::format("{}", static_cast<int>(shading)),
+        [shading](Shader& shader) { configureLicoriceShader(shader, shading); });
 }
 
-void MolecularMeshRenderer::configureVdWShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularMeshRenderer::configureVdWShader(Shader& shader, ShadingMode::Modes shading,
+                                               bool forceRadius) {
+    utilgl::addShaderDefines(shader, shading);
 
-    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", forceRadius_);
+    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", forceRadius);
 
     shader.build();
 }
 
-void MolecularMeshRenderer::configureLicoriceShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularMeshRenderer::configureLicoriceShader(Shader& shader, ShadingMode::Modes shading) {
+    utilgl::addShaderDefines(shader, shading);
 
     const bool arbExt = OpenGLCapabilities::isExtensionSupported("GL_ARB_conservative_depth");
     const bool extExt = OpenGLCapabilities::isExtensionSupported("GL_EXT_conservative_depth");
@@ -35,6 +35,7 @@
 #include <modules/opengl/openglutils.h>
 #include <modules/opengl/openglcapabilities.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/util/zip.h>
 #include <inviwo/core/util/document.h>
 
 #include <inviwo/molvisbase/util/molvisutils.h>
@@ -46,6 +47,8 @@
 
 #include <fmt/format.h>
 
+#include <numeric>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -66,7 +69,9 @@ MolecularRasterizer::MolecularRasterizer()
     , representation_("representation", "Representation",
                       {{"vdw", "VDW", Representation::VDW},
                        {"licorice", "Licorice", Representation::Licorice},
-                       {"ballAndStick", "Ball & Stick", Representation::BallAndStick}},
+                       {"ballAndStick", "Ball & Stick", Representation::BallAndStick},
+                       {"ribbon", "Ribbon", Representation::Ribbon},
+                       {"cartoon", "Cartoon", Representation::Cartoon}},
                       0)
     , coloring_{"coloring",
                 "Coloring",
@@ -90,38 +95,25 @@ MolecularRasterizer::MolecularRasterizer()
     , useUniformAlpha_("useUniformAlpha", "Uniform Alpha", false,
                        InvalidationLevel::InvalidResources)
     , uniformAlpha_("alphaValue", "Alpha", 0.7f, 0, 1, 0.1f, InvalidationLevel::InvalidOutput)
+    , transparency_("transparency", "Transparency",
+                    {{"automatic", "Automatic", Transparency::Automatic},
+                     {"fragmentLists", "Fragment Lists (exact)", Transparency::FragmentLists},
+                     {"weightedBlended", "Weighted Blended (approximate)",
+                      Transparency::WeightedBlended}},
+                    0, InvalidationLevel::InvalidResources)
     , radiusScaling_("radiusScaling", "Radius Scaling", 1.0f, 0.0f, 2.0f)
     , forceRadius_("forceRadius", "Force Radius", false, InvalidationLevel::InvalidResources)
     , defaultRadius_("defaultRadius", "Default Radius", 0.15f, 0.00001f, 2.0f, 0.01f)
     , enableTooltips_("enableTooltips", "Enable Tooltips", true)
+    , frustumCulling_("frustumCulling", "Frustum Culling", true)
+    , impostors_("impostors", "Impostors",
+                 {{"geometryShader", "Geometry Shader", molvis::ImpostorPipeline::GeometryShader},
+                  {"vertexPulling", "Vertex Pulling", molvis::ImpostorPipeline::VertexPulling}},
+                 0)
     , camera_("camera", "Camera", molvis::boundingBox(inport_))
     , lighting_("lighting", "Lighting", &camera_)
-
-    , vdwShaders_{new MeshShaderCache(
-          {{ShaderType::Vertex, std::string{"vdw.vert"}},
-           {ShaderType::Geometry, std::string{"vdw.geom"}},
-           {ShaderType::Fragment, std::string{"vdw-oit.frag"}}},
-          {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-           {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-           {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
-           {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
-
-          [&](Shader& shader) -> void {
-              shader.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
-              configureVdWShader(shader);
-          })}
-    , licoriceShaders_{new MeshShaderCache(
-          {{ShaderType::Vertex, std::string{"licorice.vert"}},
-           {ShaderType::Geometry, std::string{"licorice.geom"}},
-           {ShaderType::Fragment, std::string{"licorice-oit.frag"}}},
-          {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-           {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-           {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
-
-          [&](Shader& shader) -> void {
-              shader.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
-              configureLicoriceShader(shader);
-          })} {
+    , shaderReload_{molvis::getShaderVariantCache().onReload(
+          [this]() { invalidate(InvalidationLevel::InvalidResources); })} {
 
     addPort(inport_);
     addPort(outport_);
@@ -134,8 +126,9 @@ MolecularRasterizer::MolecularRasterizer()
         coloring_, [](auto& prop) { return prop.getSelectedValue() == Coloring::Residues; });
 
     addProperties(representation_, coloring_, fixedColor_, atomColormap_, aminoColormap_,
-                  forceOpaque_, useUniformAlpha_, uniformAlpha_, radiusScaling_, forceRadius_,
-                  defaultRadius_, enableTooltips_, camera_, lighting_);
+                  forceOpaque_, useUniformAlpha_, uniformAlpha_, transparency_, radiusScaling_,
+                  forceRadius_, defaultRadius_, enableTooltips_, frustumCulling_, impostors_,
+                  camera_, lighting_);
 
     camera_.setCollapsed(true);
 
@@ -150,6 +143,11 @@ MolecularRasterizer::MolecularRasterizer()
 }
 
 void MolecularRasterizer::process() {
+    // the alpha values and colors decide whether transparency is needed at all
+    if (transparencyMode() != shaderTransparency_) {
+        initializeResources();
+    }
+
     const bool updateColorMap = [&]() {
         if (coloring_.isModified()) return true;
         switch (coloring_) {
@@ -166,38 +164,134 @@ void MolecularRasterizer::process() {
     }();
 
     if (meshes_.empty() || inport_.isChanged() || updateColorMap) {
+        const ColorMapping colormap{coloring_, atomColormap_, aminoColormap_, fixedColor_};
+        const auto structures = inport_.getVectorData();
+        molecularMeshes_.resize(structures.size());
         meshes_.clear();
-        for (auto structure : inport_) {
-            meshes_.push_back(
-                createMesh(*structure, {coloring_, atomColormap_, aminoColormap_, fixedColor_}, 0));
+        instances_.clear();
+        for (auto&& [molMesh, structure] : util::zip(molecularMeshes_, structures)) {
+            meshes_.push_back(molMesh.update(structure, colormap, 0));
+            instances_.push_back(molvis::instanceTransforms(*structure));
         }
     }
 
+    if (frustumCulling_ && !culling_ && molvis::MolecularCulling::isSupported()) {
+        culling_ = std::make_shared<molvis::MolecularCulling>(
+            [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+    }
+    if (culling_) {
+        // every instance of every mesh is culled in its own slot
+        culling_->resize(std::accumulate(
+            instances_.begin(), instances_.end(), size_t{0},
+            [](size_t val, const std::vector<mat4>& instances) { return val + instances.size(); }));
+    }
+    if (representation_ == Representation::Ribbon || representation_ == Representation::Cartoon) {
+        if (!cartoon_ && !molvis::CartoonTessellation::isSupported()) {
+            throw Exception(fmt::format("Unsupported representation: '{}', requires compute and "
+                                        "tessellation shaders",
+                                        representation_.getSelectedDisplayName()),
+                            IVW_CONTEXT);
+        }
+        if (!cartoon_) {
+            cartoon_ = std::make_shared<molvis::CartoonTessellation>(
+                [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+        }
+        const auto structures = inport_.getVectorData();
+        cartoon_->resize(meshes_.size());
+        for (auto&& [index, structure] : util::enumerate(structures)) {
+            cartoon_->update(index, structure, *meshes_[index]);
+        }
+    }
+    if (shaderTransparency_ == Transparency::WeightedBlended && !weightedOit_) {
+        weightedOit_ = std::make_shared<molvis::WeightedBlendedOit>(
+            [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+    }
+
     std::shared_ptr<const Rasterization> rasterization =
         std::make_shared<MolecularRasterization>(*this);
     outport_.setData(rasterization);
 }
 
 void MolecularRasterizer::initializeResources() {
-    for (auto& item : vdwShaders_->getShaders()) {
-        configureVdWShader(item.second);
-    }
-    for (auto& item : licoriceShaders_->getShaders()) {
-        configureLicoriceShader(item.second);
-    }
+    shaderTransparency_ = transparencyMode();
+
+    auto& variants = molvis::getShaderVariantCache();
+    const ShaderConfig config{static_cast<ShadingMode::Modes>(lighting_.shadingMode_.get()),
+                              forceRadius_, shaderTransparency_, useUniformAlpha_};
+    const auto variant = config.variant();
+    auto configureVdW = [config](Shader& shader) { configureVdWShader(shader, config); };
+    auto configureLicorice = [config](Shader& shader) { configureLicoriceShader(shader, config); };
+
+    vdwShaders_ =
+        variants.get("MolecularRasterizer.vdw",
+                     {{ShaderType::Vertex, std::string{"vdw.vert"}},
+                      {ShaderType::Geometry, std::string{"vdw.geom"}},
+                      {ShaderType::Fragment, std::string{"vdw-oit.frag"}}},
+                     {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+                      {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+                      {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
+                      {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+                     variant, configureVdW);
+    licoriceShaders_ =
+        variants.get("MolecularRasterizer.licorice",
+                     {{ShaderType::Vertex, std::string{"licorice.vert"}},
+                      {ShaderType::Geometry, std::string{"licorice.geom"}},
+                      {ShaderType::Fragment, std::string{"licorice-oit.frag"}}},
+                     {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+                      {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+                      {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+                     variant, configureLicorice);
+    vdwPullingShaders_ =
+        variants.get("MolecularRasterizer.vdwPulling",
+                     {{ShaderType::Vertex, std::string{"vdw-pulling.vert"}},
+                      {ShaderType::Fragment, std::string{"vdw-oit.frag"}}},
+                     {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+                      {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+                      {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
+                      {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+                     variant, configureVdW);
+    licoricePullingShaders_ =
+        variants.get("MolecularRasterizer.licoricePulling",
+                     {{ShaderType::Vertex, std::string{"licorice-pulling.vert"}},
+                      {ShaderType::Fragment, std::string{"licorice-oit.frag"}}},
+                     {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+                      {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+                      {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}},
+                     variant, configureLicorice);
+
+    const std::vector<std::pair<ShaderType, std::string>> cartoonStages{
+        {ShaderType::Vertex, std::string{"cartoon.vert"}},
+        {ShaderType::TessellationControl, std::string{"cartoon.tesc"}},
+        {ShaderType::TessellationEvaluation, std::string{"cartoon.tese"}},
+        {ShaderType::Fragment, std::string{"cartoon.frag"}}};
+    const std::vector<MeshShaderCache::Requirement> cartoonBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}};
+    ribbonShaders_ = variants.get(
+        "MolecularRasterizer.ribbon", cartoonStages, cartoonBuffers, variant,
+        [config](Shader& shader) { configureCartoonShader(shader, config, true); });
+    cartoonShaders_ = variants.get(
+        "MolecularRasterizer.cartoon", cartoonStages, cartoonBuffers, variant,
+        [config](Shader& shader) { configureCartoonShader(shader, config, false); });
+}
+
+std::string MolecularRasterizer::ShaderConfig::variant() const {
+    return fmt::format("{}|{}|{}|{}", static_cast<int>(shading), forceRadius,
+                       static_cast<int>(transparency), uniformAlpha);
 }
 
-void MolecularRasterizer::configureVdWShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularRasterizer::configureVdWShader(Shader& shader, const ShaderConfig& config) {
+    utilgl::addShaderDefines(shader, config.shading);
 
-    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", forceRadius_);
+    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", config.forceRadius);
 
-    configureOITShader(shader);
+    configureOITShader(shader, config);
     shader.build();
 }
 
-void MolecularRasterizer::configureLicoriceShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularRasterizer::configureLicoriceShader(Shader& shader, const ShaderConfig& config) {
+    utilgl::addShaderDefines(shader, config.shading);
 
     const bool arbExt = OpenGLCapabilities::isExtensionSupported("GL_ARB_conservative_depth");
     const bool extExt = OpenGLCapabilities::isExtensionSupported("GL_EXT_conservative_depth");
@@ -215,11 +309,21 @@ void MolecularRasterizer::configureLicoriceShader(Shader& shader) {
         shader.getFragmentShaderObject()->addOutDeclaration(outdecl);
     }
 
-    configureOITShader(shader);
+    configureOITShader(shader, config);
     shader.build();
 }
 
-void MolecularRasterizer::configureOITShader(Shader& shader) {
+void MolecularRasterizer::configureCartoonShader(Shader& shader, const ShaderConfig& config,
+                                                 bool ribbon) {
+    utilgl::addShaderDefines(shader, config.shading);
+
+    shader[ShaderType::TessellationEvaluation]->setShaderDefine("RIBBON", ribbon);
+
+    configureOITShader(shader, config);
+    shader.build();
+}
+
+void MolecularRasterizer::configureOITShader(Shader& shader, const ShaderConfig& config) {
     auto fso = shader.getFragmentShaderObject();
 
     fso->addShaderExtension("GL_NV_gpu_shader5", true);
@@ -227,103 +331,31 @@ void MolecularRasterizer::configureOITShader(Shader& shader) {
     fso->addShaderExtension("GL_NV_shader_buffer_load", true);
     fso->addShaderExtension("GL_EXT_bindable_uniform", true);
 
-    fso->setShaderDefine("USE_FRAGMENT_LIST",
-                         !forceOpaque_.get() && FragmentListRenderer::supportsFragmentLists());
+    fso->setShaderDefine("USE_FRAGMENT_LIST", config.transparency == Transparency::FragmentLists);
+    fso->setShaderDefine("USE_WEIGHTED_OIT", config.transparency == Transparency::WeightedBlended);
 
-    fso->setShaderDefine("UNIFORM_ALPHA", useUniformAlpha_.get());
+    fso->setShaderDefine("UNIFORM_ALPHA", config.uniformAlpha);
 }
 
-std::shared_ptr<Mesh> MolecularRasterizer::createMesh(const molvis::MolecularStructure& s,
-                                                      ColorMapping colormap, size_t pickingId) {
-    if (s.atoms().positions.empty()) {
-        return std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    }
-
-    using namespace molvis;
-
-    const size_t atomCount = s.atoms().positions.size();
-    std::vector<vec3> positions{
-        util::transform(s.atoms().positions, [](const dvec3& p) { return glm::vec3{p}; })};
-
-    std::vector<vec4> colors = [&]() {
-        switch (colormap.coloring) {
-            case Coloring::Atoms:
-                if (!s.atoms().atomicNumbers.empty()) {
-                    std::vector<vec4> colors;
-                    for (auto elem : s.atoms().atomicNumbers) {
-                        colors.emplace_back(element::color(elem, colormap.atoms));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(atomCount,
-                                             element::color(Element::Unknown, colormap.atoms));
-                }
-            case Coloring::Residues:
-                if (s.hasResidues()) {
-                    std::vector<vec4> colors;
-                    const auto& residues = s.residues();
-                    for (auto resIndex : s.getResidueIndices()) {
-                        colors.emplace_back(
-                            aminoacid::color(residues[resIndex].aminoacid, colormap.aminoacids));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(
-                        atomCount, aminoacid::color(AminoAcid::Unknown, colormap.aminoacids));
-                }
-            case Coloring::Chains:
-                if (s.hasChains()) {
-                    std::vector<vec4> colors;
-                    for (auto chainId : s.atoms().chainIds) {
-                        colors.emplace_back(chain::color(chainId));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(atomCount, chain::color(ChainId::Unknown));
-                }
-            case Coloring::Fixed:
-            default:
-                return std::vector<vec4>(atomCount, colormap.fixedColor);
-        }
-    }();
-
-    std::vector<float> radii;
-    for (auto elem : s.atoms().atomicNumbers) {
-        radii.emplace_back(static_cast<float>(element::vdwRadius(elem)));
+MolecularRasterizer::Transparency MolecularRasterizer::transparencyMode() const {
+    if (forceOpaque_) return Transparency::Opaque;
+
+    const bool transparent = useUniformAlpha_
+                                 ? uniformAlpha_ < 1.0f
+                                 : coloring_ == Coloring::Fixed && fixedColor_.get().a < 1.0f;
+    if (!transparent) return Transparency::Opaque;
+
+    const bool fragmentLists = FragmentListRenderer::supportsFragmentLists();
+    const bool weightedBlended = molvis::WeightedBlendedOit::isSupported();
+    if (transparency_ == Transparency::WeightedBlended && weightedBlended) {
+        return Transparency::WeightedBlended;
+    } else if (fragmentLists) {
+        return Transparency::FragmentLists;
+    } else if (weightedBlended) {
+        return Transparency::WeightedBlended;
+    } else {
+        return Transparency::Opaque;
     }
-    if (s.atoms().atomicNumbers.empty()) {
-        // fall-back if atomic numbers are not available
-        radii.resize(atomCount, static_cast<float>(element::vdwRadius(Element::Unknown)));
-    }
-
-    auto mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
-    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
-    mesh->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(std::move(radii)));
-
-    std::vector<uint32_t> picking(atomCount);
-    std::iota(std::begin(picking), std::end(picking), static_cast<uint32_t>(pickingId));
-    mesh->addBuffer(BufferType::PickingAttrib, util::makeBuffer(std::move(picking)));
-
-    // atoms
-    std::vector<uint32_t> indices(atomCount);
-    std::iota(indices.begin(), indices.end(), 0);
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(indices)));
-
-    // bonds
-    if (!s.bonds().empty()) {
-        indices.clear();
-        indices.reserve(s.bonds().size() * 2);
-        for (const auto& bond : s.bonds()) {
-            indices.push_back(static_cast<uint32_t>(bond.first));
-            indices.push_back(static_cast<uint32_t>(bond.second));
-        }
-        mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
-                         util::makeIndexBuffer(std::move(indices)));
-    }
-
-    return mesh;
 }
 
 MolecularRasterization::MolecularRasterization(const MolecularRasterizer& processor)
@@ -331,13 +363,31 @@ MolecularRasterization::MolecularRasterization(const MolecularRasterizer& proces
     , BallAndStickLicoriceScale(processor.BallAndStickLicoriceScale)
     , representation_(processor.representation_)
     , radiusScaling_(processor.radiusScaling_)
+    , forceRadius_(processor.forceRadius_)
     , defaultRadius_(processor.defaultRadius_)
     , lighting_(processor.lighting_.getState())
     , uniformAlpha_(processor.uniformAlpha_)
-    , forceOpaque_(processor.forceOpaque_)
+    , transparency_(processor.shaderTransparency_)
     , vdwShaders_(processor.vdwShaders_)
     , licoriceShaders_(processor.licoriceShaders_)
-    , meshes_(processor.meshes_) {}
+    , vdwPullingShaders_(processor.impostors_ == molvis::ImpostorPipeline::VertexPulling
+                             ? processor.vdwPullingShaders_
+                             : nullptr)
+    , licoricePullingShaders_(processor.impostors_ == molvis::ImpostorPipeline::VertexPulling
+                                  ? processor.licoricePullingShaders_
+                                  : nullptr)
+    , ribbonShaders_(processor.ribbonShaders_)
+    , cartoonShaders_(processor.cartoonShaders_)
+    , cartoon_(representation_ == MolecularRasterizer::Representation::Ribbon ||
+                       representation_ == MolecularRasterizer::Representation::Cartoon
+                   ? processor.cartoon_
+                   : nullptr)
+    , culling_(processor.frustumCulling_ ? processor.culling_ : nullptr)
+    , weightedOit_(transparency_ == MolecularRasterizer::Transparency::WeightedBlended
+                       ? processor.weightedOit_
+                       : nullptr)
+    , meshes_(processor.meshes_)
+    , instances_(processor.instances_) {}
 
 void MolecularRasterization::rasterize(const ivec2& imageSize, const mat4& worldMatrixTransform,
                                        std::function<void(Shader&)> setUniforms) const {
@@ -355,79 +405,163 @@ void MolecularRasterization::rasterize(const ivec2& imageSize, const mat4& world
         }
     };
 
-    auto drawVdW = [&](std::shared_ptr<const Mesh> mesh, MeshDrawerGL::DrawObject& drawer,
-                       float radius) {
-        auto& shader = vdwShaders_->getShader(*mesh);
+    using Primitives = molvis::MolecularCulling::Primitives;
+
+    // transform of the instance currently drawn, applied in data space
+    mat4 instance{1.0f};
+
+    // returns false if the mesh has to be drawn without culling
+    auto cull = [&](size_t index, std::shared_ptr<const Mesh> mesh, const Primitives& primitives,
+                    const CompositeTransform& transform) {
+        return culling_ &&
+               culling_->cull(index, *mesh, primitives, molvis::MolecularCulling::Pass::Frustum,
+                              [&](Shader& shader) {
+                                  setUniforms(shader);
+                                  utilgl::setShaderUniforms(shader, transform, "geometry");
+                              });
+    };
+
+    auto draw = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                    MeshDrawerGL::DrawObject& drawer, DrawType dt, bool culled, bool pulling) {
+        if (pulling) molvis::bindVertexPullingBuffers(*mesh);
+        if (culled && pulling) {
+            culling_->drawInstances(index, dt, molvis::impostorVertices(dt),
+                                    molvis::vertexPullingIndexBinding);
+        } else if (culled) {
+            culling_->draw(index, dt);
+        } else if (pulling) {
+            molvis::drawPulledImpostors(*mesh, dt);
+        } else {
+            drawMesh(mesh, drawer, dt);
+        }
+    };
+
+    auto drawVdW = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                       MeshDrawerGL::DrawObject& drawer, float radius) {
+        auto transform = CompositeTransform(mesh->getModelMatrix() * instance,
+                                            mesh->getWorldMatrix() * worldMatrixTransform);
+        const bool culled =
+            cull(index, mesh,
+                 forceRadius_ ? Primitives{DrawType::Points, radius * defaultRadius_, false}
+                              : Primitives{DrawType::Points, radius, true},
+                 transform);
+        const bool pulling =
+            vdwPullingShaders_ && molvis::supportsVertexPulling(*mesh, DrawType::Points);
+        auto& shader =
+            pulling ? vdwPullingShaders_->getShader(*mesh) : vdwShaders_->getShader(*mesh);
 
         shader.activate();
+        if (weightedOit_) weightedOit_->bindOutputs(shader);
         shader.setUniform("defaultRadius", defaultRadius_);
         shader.setUniform("viewport", vec4(0.0f, 0.0f, 2.0f / imageSize.x, 2.0f / imageSize.y));
         shader.setUniform("radiusScaling_", radius);
         shader.setUniform("uniformAlpha", uniformAlpha_);
         utilgl::setShaderUniforms(shader, lighting_, "lighting");
         setUniforms(shader);
-        auto transform = CompositeTransform(mesh->getModelMatrix(),
-                                            mesh->getWorldMatrix() * worldMatrixTransform);
         utilgl::setShaderUniforms(shader, transform, "geometry");
-        drawMesh(mesh, drawer, DrawType::Points);
+        draw(index, mesh, drawer, DrawType::Points, culled, pulling);
         shader.deactivate();
     };
-    auto drawLicorice = [&](std::shared_ptr<const Mesh> mesh, MeshDrawerGL::DrawObject& drawer,
-                            float radius) {
-        auto& shader = licoriceShaders_->getShader(*mesh);
+    auto drawLicorice = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                            MeshDrawerGL::DrawObject& drawer, float radius) {
+        auto transform = CompositeTransform(mesh->getModelMatrix() * instance,
+                                            mesh->getWorldMatrix() * worldMatrixTransform);
+        const bool culled =
+            cull(index, mesh, Primitives{DrawType::Lines, 0.25f * radius, false}, transform);
+        const bool pulling =
+            licoricePullingShaders_ && molvis::supportsVertexPulling(*mesh, DrawType::Lines);
+        auto& shader = pulling ? licoricePullingShaders_->getShader(*mesh)
+                               : licoriceShaders_->getShader(*mesh);
         shader.activate();
+        if (weightedOit_) weightedOit_->bindOutputs(shader);
         shader.setUniform("defaultRadius", defaultRadius_);
         shader.setUniform("radius_", 0.25f * radius);
         shader.setUniform("uniformAlpha", uniformAlpha_);
         utilgl::setShaderUniforms(shader, lighting_, "lighting");
-        auto transform = CompositeTransform(mesh->getModelMatrix(),
+        setUniforms(shader);
+        utilgl::setShaderUniforms(shader, transform, "geometry");
+        draw(index, mesh, drawer, DrawType::Lines, culled, pulling);
+        shader.deactivate();
+    };
+    // the backbone is not culled, \p index refers to the mesh since all instances share it
+    auto drawCartoon = [&](size_t index, std::shared_ptr<const Mesh> mesh) {
+        auto transform = CompositeTransform(mesh->getModelMatrix() * instance,
                                             mesh->getWorldMatrix() * worldMatrixTransform);
+        auto& shader = representation_ == MolecularRasterizer::Representation::Ribbon
+                           ? ribbonShaders_->getShader(*mesh)
+                           : cartoonShaders_->getShader(*mesh);
+        shader.activate();
+        if (weightedOit_) weightedOit_->bindOutputs(shader);
+        shader.setUniform("viewport", vec2(imageSize));
+        shader.setUniform("uniformAlpha", uniformAlpha_);
+        utilgl::setShaderUniforms(shader, lighting_, "lighting");
         setUniforms(shader);
         utilgl::setShaderUniforms(shader, transform, "geometry");
-        drawMesh(mesh, drawer, DrawType::Lines);
+        molvis::bindVertexPullingBuffers(*mesh);
+        cartoon_->draw(index);
         shader.deactivate();
     };
 
     utilgl::GlBoolState depthTest(GL_DEPTH_TEST, !usesFragmentLists());
+    if (weightedOit_) weightedOit_->begin(imageSize);
 
-    for (auto mesh : meshes_) {
-        if (mesh->getNumberOfBuffers() == 0) continue;
+    size_t slot = 0;
+    for (auto&& [index, mesh] : util::enumerate(meshes_)) {
+        if (mesh->getNumberOfBuffers() == 0) {
+            slot += instances_[index].size();
+            continue;
+        }
 
         MeshDrawerGL::DrawObject drawer{mesh->getRepresentation<MeshGL>(),
                                         mesh->getDefaultMeshInfo()};
-        switch (representation_) {
-            case MolecularRasterizer::Representation::VDW:
-                drawVdW(mesh, drawer, radiusScaling_);
-                break;
-            case MolecularRasterizer::Representation::Licorice:
-                drawLicorice(mesh, drawer, radiusScaling_);
-                break;
-            case MolecularRasterizer::Representation::BallAndStick:
-                drawVdW(mesh, drawer, radiusScaling_ * BallAndStickVDWScale);
-                drawLicorice(mesh, drawer, radiusScaling_ * BallAndStickLicoriceScale);
-                break;
-            case MolecularRasterizer::Representation::Ribbon:
-                throw Exception("Unsupported representation: 'Ribbon'", IVW_CONTEXT);
-                break;
-            case MolecularRasterizer::Representation::Cartoon:
-                throw Exception("Unsupported representation: 'Cartoon'", IVW_CONTEXT);
-                break;
-            default:
-                drawVdW(mesh, drawer, radiusScaling_);
-                break;
+        for (const auto& transform : instances_[index]) {
+            instance = transform;
+            switch (representation_) {
+                case MolecularRasterizer::Representation::VDW:
+                    drawVdW(slot, mesh, drawer, radiusScaling_);
+                    break;
+                case MolecularRasterizer::Representation::Licorice:
+                    drawLicorice(slot, mesh, drawer, radiusScaling_);
+                    break;
+                case MolecularRasterizer::Representation::BallAndStick:
+                    drawVdW(slot, mesh, drawer, radiusScaling_ * BallAndStickVDWScale);
+                    drawLicorice(slot, mesh, drawer, radiusScaling_ * BallAndStickLicoriceScale);
+                    break;
+                case MolecularRasterizer::Representation::Ribbon:
+                case MolecularRasterizer::Representation::Cartoon:
+                    drawCartoon(index, mesh);
+                    break;
+                default:
+                    drawVdW(slot, mesh, drawer, radiusScaling_);
+                    break;
+            }
+            ++slot;
         }
     }
+
+    if (weightedOit_) weightedOit_->end();
 }
 
 bool MolecularRasterization::usesFragmentLists() const {
-    return !forceOpaque_ && FragmentListRenderer::supportsFragmentLists();
+    return transparency_ == MolecularRasterizer::Transparency::FragmentLists;
 }
 
 Document MolecularRasterization::getInfo() const {
     Document doc;
+    const auto mode = [&]() {
+        switch (transparency_) {
+            case MolecularRasterizer::Transparency::FragmentLists:
+                return "Using A-buffer";
+            case MolecularRasterizer::Transparency::WeightedBlended:
+                return "Using weighted blended transparency";
+            case MolecularRasterizer::Transparency::Automatic:
+            case MolecularRasterizer::Transparency::Opaque:
+            default:
+                return "Rendering opaque";
+        }
+    }();
     doc.append("p", fmt::format("Molecular rasterization functor with {} molecule{}. {}.",
-                                meshes_.size(), (meshes_.size() == 1) ? "" : "s",
-                                usesFragmentLists() ? "Using A-buffer" : "Rendering opaque"));
+                                meshes_.size(), (meshes_.size() == 1) ? "" : "s", mode));
     return doc;
 }
 
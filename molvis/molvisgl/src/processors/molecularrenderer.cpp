@@ -34,7 +34,10 @@
 #include <modules/opengl/shader/shadertype.h>
 #include <modules/opengl/openglutils.h>
 #include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/texture/textureutils.h>
+#include <modules/meshrenderinggl/datastructures/transformedrasterization.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/util/zip.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
 
 #include <inviwo/molvisbase/util/molvisutils.h>
@@ -43,6 +46,8 @@
 
 #include <fmt/format.h>
 
+#include <optional>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -63,7 +68,9 @@ MolecularRenderer::MolecularRenderer()
     , representation_("representation", "Representation",
                       {{"vdw", "VDW", Representation::VDW},
                        {"licorice", "Licorice", Representation::Licorice},
-                       {"ballAndStick", "Ball & Stick", Representation::BallAndStick}},
+                       {"ballAndStick", "Ball & Stick", Representation::BallAndStick},
+                       {"ribbon", "Ribbon", Representation::Ribbon},
+                       {"cartoon", "Cartoon", Representation::Cartoon}},
                       0)
     , coloring_{"coloring",
                 "Coloring",
@@ -87,37 +94,32 @@ MolecularRenderer::MolecularRenderer()
     , forceRadius_("forceRadius", "Force Radius", false, InvalidationLevel::InvalidResources)
     , defaultRadius_("defaultRadius", "Default Radius", 0.15f, 0.00001f, 2.0f, 0.01f)
     , enableTooltips_("enableTooltips", "Enable Tooltips", true)
+    , cullingMode_("culling", "Culling",
+                   {{"none", "None", molvis::MolecularCulling::Mode::None},
+                    {"frustum", "Frustum", molvis::MolecularCulling::Mode::Frustum},
+                    {"frustumAndOcclusion", "Frustum & Occlusion",
+                     molvis::MolecularCulling::Mode::FrustumAndOcclusion}},
+                   2)
+    , impostors_("impostors", "Impostors",
+                 {{"geometryShader", "Geometry Shader", molvis::ImpostorPipeline::GeometryShader},
+                  {"vertexPulling", "Vertex Pulling", molvis::ImpostorPipeline::VertexPulling}},
+                 0)
+    , gpuTime_("gpuTime", "GPU Time (ms)", 0.0f, 0.0f, 1000.0f, 0.001f, InvalidationLevel::Valid,
+               PropertySemantics::Text)
+    , lod_("levelOfDetail", "Level of Detail", false)
+    , lodResiduePixels_("lodResiduePixels", "Residue Threshold (px)", 2.0f, 0.0f, 20.0f, 0.1f)
+    , lodChainPixels_("lodChainPixels", "Chain Threshold (px)", 4.0f, 0.0f, 50.0f, 0.1f)
+    , lodTransition_("lodTransition", "Transition Width", 0.5f, 0.01f, 2.0f, 0.01f)
+    , selection_("selection", "Selection", "")
+    , deferredShading_("deferredShading", "Deferred Shading", false,
+                       InvalidationLevel::InvalidResources)
     , camera_("camera", "Camera", molvis::boundingBox(inport_))
     , lighting_("lighting", "Lighting", &camera_)
     , trackball_(&camera_)
-
-    , vdwShaders_{{{ShaderType::Vertex, std::string{"vdw.vert"}},
-                   {ShaderType::Geometry, std::string{"vdw.geom"}},
-                   {ShaderType::Fragment, std::string{"vdw.frag"}}},
-                  {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-                   {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-                   {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
-                   {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
-                   {BufferType::TexCoordAttrib, MeshShaderCache::Optional, "uint"}},
-
-                  [&](Shader& shader) -> void {
-                      shader.onReload(
-                          [this]() { invalidate(InvalidationLevel::InvalidResources); });
-                      configureVdWShader(shader);
-                  }}
-    , licoriceShaders_{{{ShaderType::Vertex, std::string{"licorice.vert"}},
-                        {ShaderType::Geometry, std::string{"licorice.geom"}},
-                        {ShaderType::Fragment, std::string{"licorice.frag"}}},
-                       {{BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
-                        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
-                        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
-                        {BufferType::TexCoordAttrib, MeshShaderCache::Optional, "uint"}},
-
-                       [&](Shader& shader) -> void {
-                           shader.onReload(
-                               [this]() { invalidate(InvalidationLevel::InvalidResources); });
-                           configureLicoriceShader(shader);
-                       }}
+    , shaderReload_{molvis::getShaderVariantCache().onReload(
+          [this]() { invalidate(InvalidationLevel::InvalidResources); })}
+    , proxyShader_({{ShaderType::Vertex, "vdw-pulling.vert"}, {ShaderType::Fragment, "vdw.frag"}},
+                   Shader::Build::No)
     , atomPicking_(this, 1, [this](PickingEvent* e) { handlePicking(e); }) {
 
     addPort(inport_);
@@ -126,6 +128,14 @@ MolecularRenderer::MolecularRenderer()
 
     imageInport_.setOptional(true);
 
+    gpuTime_.setReadOnly(true);
+    gpuTime_.setSerializationMode(PropertySerializationMode::None);
+
+    for (auto prop : {&lodResiduePixels_, &lodChainPixels_, &lodTransition_}) {
+        prop->visibilityDependsOn(lod_, [](auto& p) { return p.get(); });
+    }
+    proxyShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+
     fixedColor_.visibilityDependsOn(
         coloring_, [](auto& prop) { return prop.getSelectedValue() == Coloring::Fixed; });
     atomColormap_.visibilityDependsOn(
@@ -134,8 +144,9 @@ MolecularRenderer::MolecularRenderer()
         coloring_, [](auto& prop) { return prop.getSelectedValue() == Coloring::Residues; });
 
     addProperties(representation_, coloring_, fixedColor_, atomColormap_, aminoColormap_,
-                  radiusScaling_, forceRadius_, defaultRadius_, enableTooltips_, camera_, lighting_,
-                  trackball_);
+                  radiusScaling_, forceRadius_, defaultRadius_, enableTooltips_, cullingMode_,
+                  impostors_, gpuTime_, lod_, lodResiduePixels_, lodChainPixels_, lodTransition_,
+                  selection_, deferredShading_, camera_, lighting_, trackball_);
 
     lighting_.lightPosition_.set(vec3(550.0f, 680.0f, 1000.0f));
     lighting_.ambientColor_.set(vec3(0.515f));
@@ -149,10 +160,15 @@ MolecularRenderer::MolecularRenderer()
 
 void MolecularRenderer::process() {
     atomPicking_.resize(std::accumulate(inport_.begin(), inport_.end(), 0u, [](size_t val, auto s) {
-        return val + s->atoms().positions.size();
+        return val + s->atoms().positions.size() * s->getNumberOfInstances();
     }));
 
+    if (auto elapsed = timer_.elapsed()) {
+        gpuTime_.set(static_cast<float>(*elapsed));
+    }
+
     utilgl::activateTargetAndClearOrCopySource(outport_, imageInport_);
+    timer_.begin();
 
     auto drawMesh = [](std::shared_ptr<const Mesh> mesh, MeshDrawerGL::DrawObject& drawer,
                        DrawType dt) {
@@ -167,27 +183,157 @@ void MolecularRenderer::process() {
         }
     };
 
-    auto drawVdW = [&](std::shared_ptr<const Mesh> mesh, MeshDrawerGL::DrawObject& drawer,
-                       float radius) {
-        auto& shader = vdwShaders_.getShader(*mesh);
+    using Mode = molvis::MolecularCulling::Mode;
+    using Pass = molvis::MolecularCulling::Pass;
+    using Primitives = molvis::MolecularCulling::Primitives;
+
+    // instance currently drawn, its transform is applied in data space and its picking IDs follow
+    // the ones of the previous instance
+    mat4 instance{1.0f};
+    uint32_t pickingOffset = 0;
+    // pass of the deferred shading currently drawn, forward shading if not set
+    ShadingPass shadingPass;
+    auto setGeometryUniforms = [&](Shader& shader, const Mesh& mesh) {
+        utilgl::setShaderUniforms(
+            shader, CompositeTransform(mesh.getModelMatrix() * instance, mesh.getWorldMatrix()),
+            "geometry");
+        shader.setUniform("pickingOffset", pickingOffset);
+    };
 
+    // returns false if the mesh has to be drawn without culling
+    auto cull = [&](size_t index, std::shared_ptr<const Mesh> mesh, const Primitives& primitives,
+                    std::optional<Pass> pass) {
+        return pass && culling_->cull(index, *mesh, primitives, *pass, [&](Shader& shader) {
+            utilgl::setUniforms(shader, camera_);
+            setGeometryUniforms(shader, *mesh);
+        });
+    };
+    // meshes drawn without culling are drawn completely in the first pass
+    auto draw = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                    MeshDrawerGL::DrawObject& drawer, DrawType dt, bool culled, bool pulling,
+                    std::optional<Pass> pass) {
+        if (culled && pulling) {
+            culling_->drawInstances(index, dt, molvis::impostorVertices(dt),
+                                    molvis::vertexPullingIndexBinding);
+        } else if (culled) {
+            culling_->draw(index, dt);
+        } else if (pass == Pass::Occlusion) {
+            return;
+        } else if (pulling) {
+            molvis::drawPulledImpostors(*mesh, dt);
+        } else {
+            drawMesh(mesh, drawer, dt);
+        }
+    };
+    // the vertex array of the mesh stays bound while pulling, but none of its attributes are used
+    auto usePulling = [&](const Mesh& mesh, DrawType dt) {
+        return impostors_ == molvis::ImpostorPipeline::VertexPulling &&
+               molvis::supportsVertexPulling(mesh, dt);
+    };
+
+    // the forward shaders, or the variant of the current deferred shading pass
+    auto impostorShader = [&](const std::shared_ptr<MeshShaderCache>& forward,
+                              const DeferredShaders& deferred, const Mesh& mesh) -> Shader& {
+        return shadingPass ? deferred[static_cast<size_t>(*shadingPass)]->getShader(mesh)
+                           : forward->getShader(mesh);
+    };
+    auto activate = [&](Shader& shader) {
         shader.activate();
+        if (shadingPass == molvis::DeferredShading::Pass::GBuffer) deferred_->bindOutputs(shader);
+    };
+
+    auto setVdWUniforms = [&](Shader& shader, const Mesh& mesh, float radius) {
         utilgl::setUniforms(shader, camera_, lighting_, defaultRadius_);
         shader.setUniform("viewport", vec4(0.0f, 0.0f, 2.0f / outport_.getDimensions().x,
                                            2.0f / outport_.getDimensions().y));
         shader.setUniform("radiusScaling_", radius);
-        utilgl::setShaderUniforms(shader, *mesh, "geometry");
-        drawMesh(mesh, drawer, DrawType::Points);
+        setGeometryUniforms(shader, mesh);
+    };
+    auto drawVdW = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                       MeshDrawerGL::DrawObject& drawer, float radius, std::optional<Pass> pass) {
+        const bool culled =
+            cull(index, mesh,
+                 forceRadius_ ? Primitives{DrawType::Points, radius * defaultRadius_, false}
+                              : Primitives{DrawType::Points, radius, true},
+                 pass);
+        const bool pulling = usePulling(*mesh, DrawType::Points);
+        auto& shader = pulling
+                           ? impostorShader(vdwPullingShaders_, vdwPullingDeferredShaders_, *mesh)
+                           : impostorShader(vdwShaders_, vdwDeferredShaders_, *mesh);
+
+        activate(shader);
+        setVdWUniforms(shader, *mesh, radius);
+        if (pulling) molvis::bindVertexPullingBuffers(*mesh);
+        draw(index, mesh, drawer, DrawType::Points, culled, pulling, pass);
         shader.deactivate();
     };
-    auto drawLicorice = [&](std::shared_ptr<const Mesh> mesh, MeshDrawerGL::DrawObject& drawer,
-                            float radius) {
-        auto& shader = licoriceShaders_.getShader(*mesh);
+    // returns false if the mesh has to be drawn without level of detail. The selection of every
+    // instance is kept in its own slot, \p lodIndex refers to the hierarchy of the mesh.
+    auto drawVdWLod = [&](size_t index, size_t lodIndex, std::shared_ptr<const Mesh> mesh,
+                          float radius, std::optional<Pass> pass) {
+        using Level = molvis::LodSelection::Level;
+        if (!lodSelection_ || lodIndex >= lods_.size() || !masks_.empty() || shadingPass ||
+            !molvis::supportsVertexPulling(*mesh, DrawType::Points)) {
+            return false;
+        }
+        // everything is drawn in the first pass
+        if (pass == Pass::Occlusion) return true;
+
+        lodSelection_->select(index, *mesh, lods_[lodIndex],
+                              {lodResiduePixels_, lodChainPixels_, lodTransition_},
+                              outport_.getDimensions(), [&](Shader& shader) {
+                                  utilgl::setUniforms(shader, camera_);
+                                  setGeometryUniforms(shader, *mesh);
+                              });
+
+        auto& shader = vdwPullingShaders_->getShader(*mesh);
         shader.activate();
+        setVdWUniforms(shader, *mesh, radius);
+        molvis::bindVertexPullingBuffers(*mesh);
+        lodSelection_->draw(index, Level::Atoms);
+        shader.deactivate();
+
+        // the proxy radii already include the transition
+        proxyShader_.activate();
+        setVdWUniforms(proxyShader_, *mesh, 1.0f);
+        lodSelection_->draw(index, Level::Residues);
+        lodSelection_->draw(index, Level::Chains);
+        proxyShader_.deactivate();
+        return true;
+    };
+    auto drawLicorice = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                            MeshDrawerGL::DrawObject& drawer, float radius,
+                            std::optional<Pass> pass) {
+        const bool culled =
+            cull(index, mesh, Primitives{DrawType::Lines, 0.25f * radius, false}, pass);
+        const bool pulling = usePulling(*mesh, DrawType::Lines);
+        auto& shader =
+            pulling
+                ? impostorShader(licoricePullingShaders_, licoricePullingDeferredShaders_, *mesh)
+                : impostorShader(licoriceShaders_, licoriceDeferredShaders_, *mesh);
+        activate(shader);
         utilgl::setUniforms(shader, camera_, lighting_, defaultRadius_);
         shader.setUniform("radius_", 0.25f * radius);
-        utilgl::setShaderUniforms(shader, *mesh, "geometry");
-        drawMesh(mesh, drawer, DrawType::Lines);
+        setGeometryUniforms(shader, *mesh);
+        if (pulling) molvis::bindVertexPullingBuffers(*mesh);
+        draw(index, mesh, drawer, DrawType::Lines, culled, pulling, pass);
+        shader.deactivate();
+    };
+    // the backbone is not culled and drawn completely in the first pass, \p index refers to the
+    // mesh since all instances share the same backbone
+    auto drawCartoon = [&](size_t index, std::shared_ptr<const Mesh> mesh,
+                           std::optional<Pass> pass) {
+        if (pass == Pass::Occlusion) return;
+
+        auto& shader = representation_ == Representation::Ribbon
+                           ? ribbonShaders_->getShader(*mesh)
+                           : cartoonShaders_->getShader(*mesh);
+        shader.activate();
+        utilgl::setUniforms(shader, camera_, lighting_);
+        shader.setUniform("viewport", vec2(outport_.getDimensions()));
+        setGeometryUniforms(shader, *mesh);
+        molvis::bindVertexPullingBuffers(*mesh);
+        cartoon_->draw(index);
         shader.deactivate();
     };
 
@@ -206,65 +352,348 @@ void MolecularRenderer::process() {
         }
     }();
 
-    if (meshes_.empty() || inport_.isChanged() || updateColorMap) {
-        meshes_.clear();
-        size_t pickingId = atomPicking_.getPickingId(0);
-        for (auto structure : inport_) {
-            meshes_.push_back(createMesh(
-                *structure, {coloring_, atomColormap_, aminoColormap_, fixedColor_}, pickingId));
-            pickingId += structure->atoms().positions.size();
+    const bool updateSelection = inport_.isChanged() || selection_.isModified();
+    if (updateSelection) {
+        masks_.clear();
+        if (!selection_.get().empty()) {
+            try {
+                const molvis::AtomSelection selection{selection_.get()};
+                for (const auto& structure : inport_) {
+                    masks_.push_back(selection.evaluate(*structure));
+                }
+            } catch (const Exception& e) {
+                masks_.clear();
+                LogError(e.getMessage());
+            }
         }
     }
 
-    for (auto mesh : meshes_) {
-        MeshDrawerGL::DrawObject drawer{mesh->getRepresentation<MeshGL>(),
-                                        mesh->getDefaultMeshInfo()};
-        switch (representation_) {
-            case Representation::VDW:
-                drawVdW(mesh, drawer, radiusScaling_);
+    const bool updateMeshes =
+        meshes_.empty() || inport_.isChanged() || updateColorMap || updateSelection;
+    const bool updateLods = lod_ && (updateMeshes || lods_.size() != meshes_.size());
+    if (updateMeshes || updateLods) {
+        const ColorMapping colormap{coloring_, atomColormap_, aminoColormap_, fixedColor_};
+        const auto structures = inport_.getVectorData();
+        if (updateMeshes) {
+            molecularMeshes_.resize(structures.size());
+            meshes_.clear();
+            instances_.clear();
+        }
+        lods_.clear();
+        auto pickingId = static_cast<uint32_t>(atomPicking_.getPickingId(0));
+        for (auto&& [index, structure] : util::enumerate(structures)) {
+            if (updateMeshes) {
+                const auto* mask = masks_.empty() ? nullptr : &masks_[index];
+                meshes_.push_back(
+                    molecularMeshes_[index].update(structure, colormap, pickingId, mask));
+                instances_.push_back({molvis::instanceTransforms(*structure),
+                                      static_cast<uint32_t>(structure->atoms().positions.size())});
+            }
+            if (lod_) {
+                lods_.push_back(std::make_shared<molvis::LodHierarchy>(
+                    molvis::createLodHierarchy(*structure, colormap, pickingId)));
+            }
+            pickingId += static_cast<uint32_t>(structure->atoms().positions.size() *
+                                               structure->getNumberOfInstances());
+        }
+    }
+    if (!lod_) lods_.clear();
+
+    // every instance of every mesh is culled and selected in its own slot
+    const size_t numSlots = std::accumulate(
+        instances_.begin(), instances_.end(), size_t{0},
+        [](size_t val, const Instances& instances) { return val + instances.transforms.size(); });
+
+    auto render = [&](std::optional<Pass> pass) {
+        size_t slot = 0;
+        for (auto&& [index, mesh] : util::enumerate(meshes_)) {
+            MeshDrawerGL::DrawObject drawer{mesh->getRepresentation<MeshGL>(),
+                                            mesh->getDefaultMeshInfo()};
+            pickingOffset = 0;
+            for (const auto& transform : instances_[index].transforms) {
+                instance = transform;
+                switch (representation_) {
+                    case Representation::VDW:
+                        if (!drawVdWLod(slot, index, mesh, radiusScaling_, pass)) {
+                            drawVdW(slot, mesh, drawer, radiusScaling_, pass);
+                        }
+                        break;
+                    case Representation::Licorice:
+                        drawLicorice(slot, mesh, drawer, radiusScaling_, pass);
+                        break;
+                    case Representation::BallAndStick:
+                        drawVdW(slot, mesh, drawer, radiusScaling_ * BallAndStickVDWScale, pass);
+                        drawLicorice(slot, mesh, drawer,
+                                     radiusScaling_ * BallAndStickLicoriceScale, pass);
+                        break;
+                    case Representation::Ribbon:
+                    case Representation::Cartoon:
+                        drawCartoon(index, mesh, pass);
+                        break;
+                    default:
+                        drawVdW(slot, mesh, drawer, radiusScaling_, pass);
+                        break;
+                }
+                pickingOffset += instances_[index].atomCount;
+                ++slot;
+            }
+        }
+    };
+
+    if (cullingMode_ != Mode::None && !culling_ && molvis::MolecularCulling::isSupported()) {
+        culling_ = std::make_unique<molvis::MolecularCulling>(
+            [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+    }
+    if (culling_) {
+        culling_->resize(numSlots);
+    }
+    if (lod_ && !lodSelection_ && molvis::LodSelection::isSupported()) {
+        lodSelection_ = std::make_unique<molvis::LodSelection>(
+            [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+    }
+    if (lodSelection_) {
+        lodSelection_->resize(lods_.empty() ? 0 : numSlots);
+    }
+    if (representation_ == Representation::Ribbon || representation_ == Representation::Cartoon) {
+        if (!cartoon_ && !molvis::CartoonTessellation::isSupported()) {
+            throw Exception(fmt::format("Unsupported representation: '{}', requires compute and "
+                                        "tessellation shaders",
+                                        representation_.getSelectedDisplayName()),
+                            IVW_CONTEXT);
+        }
+        if (!cartoon_) {
+            cartoon_ = std::make_unique<molvis::CartoonTessellation>(
+                [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+        }
+        const auto structures = inport_.getVectorData();
+        cartoon_->resize(meshes_.size());
+        for (auto&& [index, structure] : util::enumerate(structures)) {
+            cartoon_->update(index, structure, *meshes_[index]);
+        }
+    }
+
+    auto renderCulled = [&]() {
+        switch (culling_ ? cullingMode_.get() : Mode::None) {
+            case Mode::FrustumAndOcclusion:
+                // draw what was visible in the previous frame, then everything not occluded by it
+                render(Pass::Visible);
+                utilgl::deactivateCurrentTarget();
+                culling_->updateDepthPyramid(*outport_.getData());
+                utilgl::activateTarget(outport_, ImageType::AllLayers);
+                render(Pass::Occlusion);
                 break;
-            case Representation::Licorice:
-                drawLicorice(mesh, drawer, radiusScaling_);
+            case Mode::Frustum:
+                render(Pass::Frustum);
                 break;
-            case Representation::BallAndStick:
-                drawVdW(mesh, drawer, radiusScaling_ * BallAndStickVDWScale);
-                drawLicorice(mesh, drawer, radiusScaling_ * BallAndStickLicoriceScale);
+            case Mode::None:
+            default:
+                render(std::nullopt);
                 break;
-            case Representation::Ribbon:
-                throw Exception("Unsupported representation: 'Ribbon'", IVW_CONTEXT);
+        }
+    };
+
+    const bool impostors = representation_ == Representation::VDW ||
+                           representation_ == Representation::Licorice ||
+                           representation_ == Representation::BallAndStick;
+    if (deferredShading_ && impostors && !deferred_ && molvis::DeferredShading::isSupported()) {
+        deferred_ = std::make_unique<molvis::DeferredShading>(
+            [this]() { invalidate(InvalidationLevel::InvalidOutput); });
+    }
+
+    if (deferredShading_ && impostors && deferred_ && vdwDeferredShaders_[0]) {
+        using DeferredPass = molvis::DeferredShading::Pass;
+        // the depth of all visible impostors, including the culling passes
+        shadingPass = DeferredPass::Depth;
+        deferred_->beginDepth();
+        renderCulled();
+
+        // the impostors visible in this frame once more, only the front-most fragments remain
+        shadingPass = DeferredPass::GBuffer;
+        deferred_->beginGBuffer(ivec2(outport_.getDimensions()));
+        switch (culling_ ? cullingMode_.get() : Mode::None) {
+            case Mode::FrustumAndOcclusion:
+                // the visibility was updated by the occlusion pass of the pre-pass
+                render(Pass::Visible);
                 break;
-            case Representation::Cartoon:
-                throw Exception("Unsupported representation: 'Cartoon'", IVW_CONTEXT);
+            case Mode::Frustum:
+                render(Pass::Frustum);
                 break;
+            case Mode::None:
             default:
-                drawVdW(mesh, drawer, radiusScaling_);
+                render(std::nullopt);
                 break;
         }
+        deferred_->end(static_cast<ShadingMode::Modes>(lighting_.shadingMode_.get()),
+                       [&](Shader& shader) { utilgl::setUniforms(shader, camera_, lighting_); });
+        shadingPass.reset();
+    } else {
+        renderCulled();
     }
 
+    timer_.end();
     utilgl::deactivateCurrentTarget();
 }
 
 void MolecularRenderer::initializeResources() {
-    for (auto& item : vdwShaders_.getShaders()) {
-        configureVdWShader(item.second);
+    auto& variants = molvis::getShaderVariantCache();
+    const auto shading = static_cast<ShadingMode::Modes>(lighting_.shadingMode_.get());
+    const bool forceRadius = forceRadius_;
+    const auto vdwVariant = fmt::format("{}|{}", static_cast<int>(shading), forceRadius);
+    const auto licoriceVariant = fmt::format("{}", static_cast<int>(shading));
+    const auto cartoonVariant = licoriceVariant;
+
+    using Stages = std::vector<std::pair<ShaderType, std::string>>;
+    using Requirements = std::vector<MeshShaderCache::Requirement>;
+    const Stages vdwStages{{ShaderType::Vertex, std::string{"vdw.vert"}},
+                           {ShaderType::Geometry, std::string{"vdw.geom"}},
+                           {ShaderType::Fragment, std::string{"vdw.frag"}}};
+    const Requirements vdwBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
+        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+        {BufferType::TexCoordAttrib, MeshShaderCache::Optional, "uint"}};
+    const Stages licoriceStages{{ShaderType::Vertex, std::string{"licorice.vert"}},
+                                {ShaderType::Geometry, std::string{"licorice.geom"}},
+                                {ShaderType::Fragment, std::string{"licorice.frag"}}};
+    const Requirements licoriceBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+        {BufferType::TexCoordAttrib, MeshShaderCache::Optional, "uint"}};
+    const Stages vdwPullingStages{{ShaderType::Vertex, std::string{"vdw-pulling.vert"}},
+                                  {ShaderType::Fragment, std::string{"vdw.frag"}}};
+    const Requirements vdwPullingBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::RadiiAttrib, MeshShaderCache::Optional, "float"},
+        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+        {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}};
+    const Stages licoricePullingStages{{ShaderType::Vertex, std::string{"licorice-pulling.vert"}},
+                                       {ShaderType::Fragment, std::string{"licorice.frag"}}};
+    const Requirements licoricePullingBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+        {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}};
+
+    auto configureVdW = [shading, forceRadius](ShadingPass pass) {
+        return [shading, forceRadius, pass](Shader& shader) {
+            configureVdWShader(shader, shading, forceRadius, pass);
+        };
+    };
+    auto configureLicorice = [shading](ShadingPass pass) {
+        return [shading, pass](Shader& shader) { configureLicoriceShader(shader, shading, pass); };
+    };
+
+    vdwShaders_ = variants.get("MolecularRenderer.vdw", vdwStages, vdwBuffers, vdwVariant,
+                               configureVdW(std::nullopt));
+    licoriceShaders_ = variants.get("MolecularRenderer.licorice", licoriceStages, licoriceBuffers,
+                                    licoriceVariant, configureLicorice(std::nullopt));
+    vdwPullingShaders_ =
+        variants.get("MolecularRenderer.vdwPulling", vdwPullingStages, vdwPullingBuffers,
+                     vdwVariant, configureVdW(std::nullopt));
+    licoricePullingShaders_ =
+        variants.get("MolecularRenderer.licoricePulling", licoricePullingStages,
+                     licoricePullingBuffers, licoriceVariant, configureLicorice(std::nullopt));
+
+    using DeferredPass = molvis::DeferredShading::Pass;
+    for (auto pass : {DeferredPass::Depth, DeferredPass::GBuffer}) {
+        const auto i = static_cast<size_t>(pass);
+        if (!deferredShading_) {
+            vdwDeferredShaders_[i].reset();
+            licoriceDeferredShaders_[i].reset();
+            vdwPullingDeferredShaders_[i].reset();
+            licoricePullingDeferredShaders_[i].reset();
+            continue;
+        }
+        const auto vdwPassVariant = fmt::format("{}|pass{}", vdwVariant, i);
+        const auto licoricePassVariant = fmt::format("{}|pass{}", licoriceVariant, i);
+        vdwDeferredShaders_[i] = variants.get("MolecularRenderer.vdw", vdwStages, vdwBuffers,
+                                              vdwPassVariant, configureVdW(pass));
+        licoriceDeferredShaders_[i] =
+            variants.get("MolecularRenderer.licorice", licoriceStages, licoriceBuffers,
+                         licoricePassVariant, configureLicorice(pass));
+        vdwPullingDeferredShaders_[i] =
+            variants.get("MolecularRenderer.vdwPulling", vdwPullingStages, vdwPullingBuffers,
+                         vdwPassVariant, configureVdW(pass));
+        licoricePullingDeferredShaders_[i] =
+            variants.get("MolecularRenderer.licoricePulling", licoricePullingStages,
+                         licoricePullingBuffers, licoricePassVariant, configureLicorice(pass));
     }
-    for (auto& item : licoriceShaders_.getShaders()) {
-        configureLicoriceShader(item.second);
+
+    const std::vector<std::pair<ShaderType, std::string>> cartoonStages{
+        {ShaderType::Vertex, std::string{"cartoon.vert"}},
+        {ShaderType::TessellationControl, std::string{"cartoon.tesc"}},
+        {ShaderType::TessellationEvaluation, std::string{"cartoon.tese"}},
+        {ShaderType::Fragment, std::string{"cartoon.frag"}}};
+    const std::vector<MeshShaderCache::Requirement> cartoonBuffers{
+        {BufferType::PositionAttrib, MeshShaderCache::Mandatory, "vec3"},
+        {BufferType::ColorAttrib, MeshShaderCache::Optional, "vec4"},
+        {BufferType::PickingAttrib, MeshShaderCache::Optional, "uint"},
+        {BufferType::ScalarMetaAttrib, MeshShaderCache::Optional, "float"}};
+    ribbonShaders_ = variants.get("MolecularRenderer.ribbon", cartoonStages, cartoonBuffers,
+                                  cartoonVariant, [shading](Shader& shader) {
+                                      configureCartoonShader(shader, shading, true);
+                                  });
+    cartoonShaders_ = variants.get("MolecularRenderer.cartoon", cartoonStages, cartoonBuffers,
+                                   cartoonVariant, [shading](Shader& shader) {
+                                       configureCartoonShader(shader, shading, false);
+                                   });
+    configureProxyShader();
+}
+
+void MolecularRenderer::configureVdWShader(Shader& shader, ShadingMode::Modes shading,
+                                           bool forceRadius, ShadingPass pass) {
+    utilgl::addShaderDefines(shader, shading);
+
+    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", forceRadius);
+    // the quad is placed in front of the sphere, by vdw.geom or vdw-pulling.vert
+    for (auto type : {ShaderType::Vertex, ShaderType::Geometry}) {
+        if (auto object = shader[type]) object->setShaderDefine("FRONT_DEPTH", true);
     }
+    addConservativeDepth(shader);
+
+    auto frag = shader.getFragmentShaderObject();
+    frag->setShaderDefine("DEPTH_PREPASS", pass == molvis::DeferredShading::Pass::Depth);
+    frag->setShaderDefine("GBUFFER_PASS", pass == molvis::DeferredShading::Pass::GBuffer);
+
+    shader.build();
 }
 
-void MolecularRenderer::configureVdWShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularRenderer::configureCartoonShader(Shader& shader, ShadingMode::Modes shading,
+                                               bool ribbon) {
+    utilgl::addShaderDefines(shader, shading);
 
-    shader[ShaderType::Vertex]->setShaderDefine("FORCE_RADIUS", forceRadius_);
+    shader[ShaderType::TessellationEvaluation]->setShaderDefine("RIBBON", ribbon);
 
     shader.build();
 }
 
-void MolecularRenderer::configureLicoriceShader(Shader& shader) {
-    utilgl::addDefines(shader, lighting_);
+void MolecularRenderer::configureProxyShader() {
+    utilgl::addDefines(proxyShader_, lighting_);
+
+    auto vert = proxyShader_[ShaderType::Vertex];
+    vert->addShaderDefine("HAS_COLOR");
+    vert->addShaderDefine("HAS_RADII");
+    vert->addShaderDefine("HAS_PICKING");
+
+    proxyShader_.build();
+}
+
+void MolecularRenderer::configureLicoriceShader(Shader& shader, ShadingMode::Modes shading,
+                                                ShadingPass pass) {
+    utilgl::addShaderDefines(shader, shading);
+    addConservativeDepth(shader);
 
+    auto frag = shader.getFragmentShaderObject();
+    frag->setShaderDefine("DEPTH_PREPASS", pass == molvis::DeferredShading::Pass::Depth);
+    frag->setShaderDefine("GBUFFER_PASS", pass == molvis::DeferredShading::Pass::GBuffer);
+
+    shader.build();
+}
+
+void MolecularRenderer::addConservativeDepth(Shader& shader) {
     const bool arbExt = OpenGLCapabilities::isExtensionSupported("GL_ARB_conservative_depth");
     const bool extExt = OpenGLCapabilities::isExtensionSupported("GL_EXT_conservative_depth");
     if (arbExt || extExt) {
@@ -280,111 +709,22 @@ void MolecularRenderer::configureLicoriceShader(Shader& shader) {
             fmt::format("#ifdef {}\nlayout (depth_greater) out float gl_FragDepth;\n#endif", ext);
         shader.getFragmentShaderObject()->addOutDeclaration(outdecl);
     }
-
-    shader.build();
-}
-
-std::shared_ptr<Mesh> MolecularRenderer::createMesh(const molvis::MolecularStructure& s,
-                                                    ColorMapping colormap, size_t pickingId) {
-    if (s.atoms().positions.empty()) {
-        return std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    }
-
-    using namespace molvis;
-
-    const size_t atomCount = s.atoms().positions.size();
-    std::vector<vec3> positions{
-        util::transform(s.atoms().positions, [](const dvec3& p) { return glm::vec3{p}; })};
-
-    std::vector<vec4> colors = [&]() {
-        switch (colormap.coloring) {
-            case Coloring::Atoms:
-                if (!s.atoms().atomicNumbers.empty()) {
-                    std::vector<vec4> colors;
-                    for (auto elem : s.atoms().atomicNumbers) {
-                        colors.emplace_back(element::color(elem, colormap.atoms));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(atomCount,
-                                             element::color(Element::Unknown, colormap.atoms));
-                }
-            case Coloring::Residues:
-                if (s.hasResidues()) {
-                    std::vector<vec4> colors;
-                    const auto& residues = s.residues();
-                    for (auto resIndex : s.getResidueIndices()) {
-                        colors.emplace_back(
-                            aminoacid::color(residues[resIndex].aminoacid, colormap.aminoacids));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(
-                        atomCount, aminoacid::color(AminoAcid::Unknown, colormap.aminoacids));
-                }
-            case Coloring::Chains:
-                if (s.hasChains()) {
-                    std::vector<vec4> colors;
-                    for (auto chainId : s.atoms().chainIds) {
-                        colors.emplace_back(chain::color(chainId));
-                    }
-                    return colors;
-                } else {
-                    return std::vector<vec4>(atomCount, chain::color(ChainId::Unknown));
-                }
-            case Coloring::Fixed:
-            default:
-                return std::vector<vec4>(atomCount, colormap.fixedColor);
-        }
-    }();
-
-    std::vector<float> radii;
-    for (auto elem : s.atoms().atomicNumbers) {
-        radii.emplace_back(static_cast<float>(element::vdwRadius(elem)));
-    }
-    if (s.atoms().atomicNumbers.empty()) {
-        // fall-back if atomic numbers are not available
-        radii.resize(atomCount, static_cast<float>(element::vdwRadius(Element::Unknown)));
-    }
-
-    auto mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
-    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
-    mesh->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(std::move(radii)));
-
-    std::vector<uint32_t> picking(atomCount);
-    std::iota(std::begin(picking), std::end(picking), static_cast<uint32_t>(pickingId));
-    mesh->addBuffer(BufferType::PickingAttrib, util::makeBuffer(std::move(picking)));
-
-    // atoms
-    std::vector<uint32_t> indices(atomCount);
-    std::iota(indices.begin(), indices.end(), 0);
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(indices)));
-
-    // bonds
-    if (!s.bonds().empty()) {
-        indices.clear();
-        indices.reserve(s.bonds().size() * 2);
-        for (const auto& bond : s.bonds()) {
-            indices.push_back(static_cast<uint32_t>(bond.first));
-            indices.push_back(static_cast<uint32_t>(bond.second));
-        }
-        mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
-                         util::makeIndexBuffer(std::move(indices)));
-    }
-
-    return mesh;
 }
 
 void MolecularRenderer::handlePicking(PickingEvent* p) {
-    const uint32_t atomId = static_cast<uint32_t>(p->getPickedId());
+    uint32_t atomId = static_cast<uint32_t>(p->getPickedId());
+    // all instances refer to the same atoms
+    const auto& structure = *inport_.getData();
+    const size_t atomCount = structure.atoms().positions.size();
+    if (atomId < atomCount * structure.getNumberOfInstances()) {
+        atomId %= static_cast<uint32_t>(atomCount);
+    }
 
     // Show tooltip for current item
     if (enableTooltips_ && p->getPressState() == PickingPressState::None) {
         if (p->getHoverState() == PickingHoverState::Move ||
             p->getHoverState() == PickingHoverState::Enter) {
-            p->setToolTip(molvis::createToolTip(*inport_.getData(), atomId));
+            p->setToolTip(molvis::createToolTip(structure, atomId));
         } else if (p->getHoverState() == PickingHoverState::Exit) {
             p->setToolTip("");
         }
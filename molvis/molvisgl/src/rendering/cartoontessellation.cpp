@@ -0,0 +1,176 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/cartoontessellation.h>
+#include <inviwo/molvisgl/rendering/vertexpulling.h>
+
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/molvisbase/datastructures/molecularstructure.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/bufferobject.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/openglutils.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+constexpr GLuint groupSize = 64;
+// marks missing N, C, and O atoms of a control point
+constexpr GLuint noAtom = std::numeric_limits<GLuint>::max();
+
+// shader storage buffer bindings of cartoon-frames.comp and cartoon.vert
+constexpr GLuint positionBinding = 0;
+constexpr GLuint controlBinding = 7;
+constexpr GLuint chainBinding = 8;
+constexpr GLuint frameBinding = 6;
+
+std::unique_ptr<BufferObject> makeBuffer(size_t bytes, const void* data = nullptr) {
+    bytes = std::max<size_t>(bytes, sizeof(GLuint));
+    auto buffer = std::make_unique<BufferObject>(bytes, DataUInt32::get(), BufferUsage::Dynamic,
+                                                 BufferTarget::Data);
+    buffer->initialize(data, bytes);
+    return buffer;
+}
+
+GLuint atomIndex(const std::optional<size_t>& atom) {
+    return atom ? static_cast<GLuint>(*atom) : noAtom;
+}
+
+}  // namespace
+
+CartoonTessellation::CartoonTessellation(std::function<void()> onShaderReload)
+    : shader_({{ShaderType::Compute, "cartoon-frames.comp"}}) {
+    if (onShaderReload) shader_.onReload(onShaderReload);
+}
+
+CartoonTessellation::~CartoonTessellation() = default;
+
+bool CartoonTessellation::isSupported() {
+    return OpenGLCapabilities::isExtensionSupported("GL_ARB_compute_shader") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_shader_storage_buffer_object") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_tessellation_shader");
+}
+
+void CartoonTessellation::update(size_t meshIndex,
+                                 std::shared_ptr<const MolecularStructure> structure,
+                                 const Mesh& atoms) {
+    if (backbones_.size() <= meshIndex) {
+        backbones_.resize(meshIndex + 1);
+    }
+    auto& backbone = backbones_[meshIndex];
+    if (backbone.structure == structure) return;
+
+    if (!backbone.structure || !structure->sharesTopology(*backbone.structure)) {
+        std::vector<GLuint> controls;
+        std::vector<GLuint> chains;
+        std::vector<GLuint> patches;
+        for (const auto& chain : structure->chains()) {
+            if (!structure->hasChain(chain.id)) continue;
+
+            const auto first = static_cast<GLuint>(controls.size() / 4);
+            for (const auto& segment : structure->getBackboneSegments(chain.id)) {
+                if (!segment.ca) continue;
+                controls.insert(controls.end(), {atomIndex(segment.ca), atomIndex(segment.n),
+                                                 atomIndex(segment.c), atomIndex(segment.o)});
+            }
+            const auto count = static_cast<GLuint>(controls.size() / 4) - first;
+            if (count < 2) {
+                controls.resize(first * 4);
+                continue;
+            }
+            chains.insert(chains.end(), {first, count});
+
+            // the end points are repeated at the ends of the chain
+            const GLuint last = first + count - 1;
+            for (GLuint i = first; i < last; ++i) {
+                patches.insert(patches.end(), {i > first ? i - 1 : i, i, i + 1,
+                                               i + 1 < last ? i + 2 : last});
+            }
+        }
+
+        backbone.numControls = controls.size() / 4;
+        backbone.numChains = chains.size() / 2;
+        backbone.numPatches = patches.size() / 4;
+        backbone.controls = makeBuffer(controls.size() * sizeof(GLuint), controls.data());
+        backbone.chains = makeBuffer(chains.size() * sizeof(GLuint), chains.data());
+        backbone.patches = makeBuffer(patches.size() * sizeof(GLuint), patches.data());
+        backbone.frames = makeBuffer(backbone.numControls * 2 * sizeof(vec4));
+    }
+    backbone.structure = std::move(structure);
+    if (backbone.numChains == 0) return;
+
+    auto positions = atoms.findBuffer(BufferType::PositionAttrib).first;
+    if (!positions) return;
+
+    shader_.activate();
+    shader_.setUniform("numChains", static_cast<int>(backbone.numChains));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, positionBinding,
+                     positions->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, controlBinding, backbone.controls->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, chainBinding, backbone.chains->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, frameBinding, backbone.frames->getId());
+
+    const auto groups = (backbone.numChains + groupSize - 1) / groupSize;
+    utilgl::dispatchChunked(shader_, groups, "invocationOffset", groupSize);
+    shader_.deactivate();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    LGL_ERROR;
+}
+
+void CartoonTessellation::draw(size_t meshIndex) const {
+    if (meshIndex >= backbones_.size()) return;
+    const auto& backbone = backbones_[meshIndex];
+    if (backbone.numPatches == 0) return;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, vertexPullingIndexBinding,
+                     backbone.patches->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, controlBinding, backbone.controls->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, frameBinding, backbone.frames->getId());
+    glPatchParameteri(GL_PATCH_VERTICES, 4);
+    glDrawArrays(GL_PATCHES, 0, static_cast<GLsizei>(backbone.numPatches * 4));
+}
+
+void CartoonTessellation::resize(size_t numMeshes) {
+    if (backbones_.size() > numMeshes) {
+        backbones_.resize(numMeshes);
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
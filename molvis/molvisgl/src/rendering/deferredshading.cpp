@@ -0,0 +1,213 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/molvisgl/rendering/deferredshading.h>
+
+#include <modules/opengl/texture/textureunit.h>
+#include <modules/opengl/texture/textureutils.h>
+#include <modules/opengl/shader/shaderutils.h>
+#include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/openglutils.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace molvis {
+
+DeferredShading::DeferredShading(std::function<void()> onShaderReload)
+    : compositeShader_({{ShaderType::Vertex, "img_identity.vert"},
+                        {ShaderType::Fragment, "deferredshading-composite.frag"}},
+                       Shader::Build::No) {
+    if (onShaderReload) {
+        compositeShader_.onReload(onShaderReload);
+    }
+}
+
+DeferredShading::~DeferredShading() {
+    if (framebuffer_ != 0) {
+        glDeleteFramebuffers(1, &framebuffer_);
+    }
+    if (textures_[0] != 0) {
+        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+    }
+}
+
+bool DeferredShading::isSupported() { return OpenGLCapabilities::getOpenGLVersion() >= 330; }
+
+void DeferredShading::resize(const ivec2& size) {
+    if (size == size_ && framebuffer_ != 0) return;
+    size_ = size;
+
+    if (framebuffer_ == 0) {
+        glGenFramebuffers(1, &framebuffer_);
+    }
+    if (textures_[0] != 0) {
+        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+    }
+    glGenTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+
+    const std::array<GLenum, 4> formats{GL_RGBA8, GL_RGBA16F, GL_RGBA8, GL_R32F};
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer_);
+    for (size_t i = 0; i < textures_.size(); ++i) {
+        glBindTexture(GL_TEXTURE_2D, textures_[i]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, formats[i], std::max(size.x, 1), std::max(size.y, 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i),
+                             textures_[i], 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    LGL_ERROR;
+}
+
+void DeferredShading::beginDepth() {
+    glGetBooleanv(GL_COLOR_WRITEMASK, previousColorMask_.data());
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+}
+
+void DeferredShading::beginGBuffer(const ivec2& size) {
+    glColorMask(previousColorMask_[0], previousColorMask_[1], previousColorMask_[2],
+                previousColorMask_[3]);
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer_);
+
+    GLint maxDrawBuffers = 0;
+    glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+    previousDrawBuffers_.assign(static_cast<size_t>(maxDrawBuffers), GL_NONE);
+    for (GLint i = 0; i < maxDrawBuffers; ++i) {
+        GLint buffer = GL_NONE;
+        glGetIntegerv(GL_DRAW_BUFFER0 + i, &buffer);
+        previousDrawBuffers_[i] = static_cast<GLenum>(buffer);
+    }
+    while (!previousDrawBuffers_.empty() && previousDrawBuffers_.back() == GL_NONE) {
+        previousDrawBuffers_.pop_back();
+    }
+
+    // the depth of the pre-pass is shared for depth testing
+    GLint depthType = GL_NONE;
+    GLint depthName = 0;
+    if (previousFramebuffer_ != 0) {
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                              GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &depthType);
+        if (depthType != GL_NONE) {
+            glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                                  GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME,
+                                                  &depthName);
+        }
+    }
+
+    resize(size);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer_);
+    if (depthType == GL_RENDERBUFFER) {
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                                  static_cast<GLuint>(depthName));
+    } else if (depthType == GL_TEXTURE) {
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                             static_cast<GLuint>(depthName), 0);
+    } else {
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0);
+    }
+
+    const std::array<GLenum, 4> drawBuffers{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1,
+                                            GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3};
+    glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    const std::array<GLfloat, 4> zero{0.0f, 0.0f, 0.0f, 0.0f};
+    for (GLint i = 0; i < static_cast<GLint>(drawBuffers.size()); ++i) {
+        glClearBufferfv(GL_COLOR, i, zero.data());
+    }
+
+    // only fragments at the depth of the pre-pass remain
+    glGetIntegerv(GL_DEPTH_FUNC, &previousDepthFunc_);
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &previousDepthMask_);
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+    LGL_ERROR;
+}
+
+void DeferredShading::bindOutputs(const Shader& shader) {
+    const std::array<GLint, 4> outputs{glGetFragDataLocation(shader.getID(), "FragData0"),
+                                       glGetFragDataLocation(shader.getID(), "NormalData"),
+                                       glGetFragDataLocation(shader.getID(), "PickingData"),
+                                       glGetFragDataLocation(shader.getID(), "DepthData")};
+    if (std::any_of(outputs.begin(), outputs.end(), [](GLint loc) { return loc < 0; })) return;
+
+    std::vector<GLenum> drawBuffers(
+        static_cast<size_t>(*std::max_element(outputs.begin(), outputs.end())) + 1, GL_NONE);
+    drawBuffers[outputs[0]] = GL_COLOR_ATTACHMENT0;
+    drawBuffers[outputs[1]] = GL_COLOR_ATTACHMENT1;
+    drawBuffers[outputs[2]] = GL_COLOR_ATTACHMENT2;
+    drawBuffers[outputs[3]] = GL_COLOR_ATTACHMENT3;
+    glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+}
+
+void DeferredShading::end(ShadingMode::Modes shading,
+                          const std::function<void(Shader&)>& setUniforms) {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer_));
+    if (!previousDrawBuffers_.empty()) {
+        glDrawBuffers(static_cast<GLsizei>(previousDrawBuffers_.size()),
+                      previousDrawBuffers_.data());
+    }
+    glDepthFunc(previousDepthFunc_);
+
+    if (!compositeBuilt_ || shading != compositeShading_) {
+        utilgl::addShaderDefines(compositeShader_, shading);
+        compositeShader_.build();
+        compositeShading_ = shading;
+        compositeBuilt_ = true;
+    }
+
+    {
+        // the depth of the target is already final
+        utilgl::GlBoolState depthTest(GL_DEPTH_TEST, false);
+
+        std::array<TextureUnit, 4> units;
+        for (size_t i = 0; i < units.size(); ++i) {
+            glActiveTexture(units[i].getEnum());
+            glBindTexture(GL_TEXTURE_2D, textures_[i]);
+        }
+        glActiveTexture(GL_TEXTURE0);
+
+        compositeShader_.activate();
+        setUniforms(compositeShader_);
+        compositeShader_.setUniform("color", units[0].getUnitNumber());
+        compositeShader_.setUniform("normal", units[1].getUnitNumber());
+        compositeShader_.setUniform("picking", units[2].getUnitNumber());
+        compositeShader_.setUniform("depth", units[3].getUnitNumber());
+        compositeShader_.setUniform("reciprocalDimensions", vec2(1.0f) / vec2(size_));
+        utilgl::singleDrawImagePlaneRect();
+        compositeShader_.deactivate();
+    }
+
+    glDepthMask(previousDepthMask_);
+    LGL_ERROR;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,74 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/gputimer.h>
+
+namespace inviwo {
+
+namespace molvis {
+
+GpuTimer::~GpuTimer() {
+    if (queries_[0] != 0) {
+        glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+    }
+}
+
+void GpuTimer::begin() {
+    if (queries_[0] == 0) {
+        glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries_[current_]);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[current_] = true;
+    current_ = (current_ + 1) % queries_.size();
+}
+
+std::optional<double> GpuTimer::elapsed() {
+    // the next query to begin is the oldest one
+    if (!pending_[current_]) return std::nullopt;
+
+    GLint available = 0;
+    glGetQueryObjectiv(queries_[current_], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        // drop the measurement rather than waiting for it
+        pending_[current_] = false;
+        return std::nullopt;
+    }
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries_[current_], GL_QUERY_RESULT, &nanoseconds);
+    pending_[current_] = false;
+    return static_cast<double>(nanoseconds) * 1.0e-6;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,205 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/lodselection.h>
+#include <inviwo/molvisgl/rendering/vertexpulling.h>
+
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/molvisbase/util/molecularlod.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/bufferobject.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/openglutils.h>
+#include <inviwo/core/util/zip.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+constexpr GLuint groupSize = 128;
+
+// parameters of glDrawArraysIndirect
+struct DrawArraysIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint first;
+    GLuint baseInstance;
+};
+
+std::unique_ptr<BufferObject> makeBuffer(size_t bytes, const void* data = nullptr) {
+    bytes = std::max<size_t>(bytes, sizeof(GLuint));
+    auto buffer = std::make_unique<BufferObject>(bytes, DataUInt32::get(), BufferUsage::Dynamic,
+                                                 BufferTarget::Data);
+    buffer->initialize(data, bytes);
+    return buffer;
+}
+
+// falls back to the positions for missing buffers, which are then not accessed by the shader
+GLuint bufferId(const Mesh& mesh, BufferType type) {
+    auto buffer = mesh.findBuffer(type).first;
+    if (!buffer) buffer = mesh.findBuffer(BufferType::PositionAttrib).first;
+    return buffer->getRepresentation<BufferGL>()->getId();
+}
+
+}  // namespace
+
+LodSelection::LodSelection(std::function<void()> onShaderReload)
+    : shader_({{ShaderType::Compute, "molecularlod.comp"}}) {
+    if (onShaderReload) shader_.onReload(onShaderReload);
+}
+
+LodSelection::~LodSelection() = default;
+
+bool LodSelection::isSupported() {
+    return OpenGLCapabilities::isExtensionSupported("GL_ARB_compute_shader") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_shader_storage_buffer_object") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_draw_indirect");
+}
+
+void LodSelection::select(size_t meshIndex, const Mesh& atoms,
+                          std::shared_ptr<const LodHierarchy> lod, const Thresholds& thresholds,
+                          ivec2 viewport, const std::function<void(Shader&)>& setUniforms) {
+    if (selections_.size() <= meshIndex) {
+        selections_.resize(meshIndex + 1);
+    }
+    auto& selection = selections_[meshIndex];
+    const std::array<const Mesh*, 3> meshes{&atoms, lod->residues.get(), lod->chains.get()};
+    const size_t numChains = lod->chains->getBuffer(0)->getSize();
+    const size_t numResidues = lod->residueChains.size();
+    const size_t numAtoms = lod->atomResidues.size();
+
+    if (selection.lod != lod) {
+        selection.lod = lod;
+        std::vector<GLuint> parents;
+        parents.reserve(numResidues + numAtoms);
+        parents.insert(parents.end(), lod->residueChains.begin(), lod->residueChains.end());
+        parents.insert(parents.end(), lod->atomResidues.begin(), lod->atomResidues.end());
+        selection.parents = makeBuffer(parents.size() * sizeof(GLuint), parents.data());
+        selection.states = makeBuffer((numChains + numResidues) * sizeof(GLfloat));
+
+        const std::array<size_t, 3> sizes{numAtoms, numResidues, numChains};
+        for (auto&& [selected, size] : util::zip(selection.levels, sizes)) {
+            selected.size = size;
+            selected.drawIndices = makeBuffer(size * sizeof(GLuint));
+            selected.command = makeBuffer(sizeof(DrawArraysIndirectCommand));
+            selected.radii = makeBuffer(size * sizeof(GLfloat));
+        }
+    }
+
+    shader_.activate();
+    setUniforms(shader_);
+    shader_.setUniform("viewport", vec2(viewport));
+    // a transition band of zero width would divide by zero
+    shader_.setUniform("transition", std::max(thresholds.transition, 0.001f));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, selection.parents->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, selection.states->getId());
+
+    // coarse to fine, each level depends on the states of its parent level
+    for (auto level : {Level::Chains, Level::Residues, Level::Atoms}) {
+        const auto l = static_cast<size_t>(level);
+        auto& selected = selection.levels[l];
+        const DrawArraysIndirectCommand command{impostorVertices(DrawType::Points), 0, 0, 0};
+        selected.command->upload(&command, sizeof(command));
+        if (selected.size == 0) continue;
+
+        shader_.setUniform("numPrimitives", static_cast<int>(selected.size));
+        shader_.setUniform("level", static_cast<int>(l));
+        switch (level) {
+            case Level::Chains:
+                shader_.setUniform("thresholdPixels", thresholds.chainPixels);
+                shader_.setUniform("stateOffset", 0);
+                shader_.setUniform("parentOffset", -1);
+                break;
+            case Level::Residues:
+                shader_.setUniform("thresholdPixels", thresholds.residuePixels);
+                shader_.setUniform("stateOffset", static_cast<int>(numChains));
+                shader_.setUniform("parentStateOffset", 0);
+                // residues without any chains have no parents
+                shader_.setUniform("parentOffset", numChains > 0 ? 0 : -1);
+                break;
+            case Level::Atoms:
+            default:
+                shader_.setUniform("parentStateOffset", static_cast<int>(numChains));
+                shader_.setUniform("parentOffset",
+                                   numResidues > 0 ? static_cast<int>(numResidues) : -1);
+                break;
+        }
+
+        const auto& mesh = *meshes[l];
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bufferId(mesh, BufferType::PositionAttrib));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, bufferId(mesh, BufferType::RadiiAttrib));
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, selected.radii->getId());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, selected.drawIndices->getId());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, selected.command->getId());
+
+        const auto groups = (selected.size + groupSize - 1) / groupSize;
+        utilgl::dispatchChunked(shader_, groups, "invocationOffset", groupSize);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+    shader_.deactivate();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+    LGL_ERROR;
+}
+
+void LodSelection::draw(size_t meshIndex, Level level) const {
+    if (meshIndex >= selections_.size()) return;
+    const auto& selection = selections_[meshIndex];
+    const auto& selected = selection.levels[static_cast<size_t>(level)];
+    if (!selection.lod || selected.size == 0) return;
+
+    if (level != Level::Atoms) {
+        const auto& proxies =
+            level == Level::Residues ? *selection.lod->residues : *selection.lod->chains;
+        bindVertexPullingBuffers(proxies);
+        // binding of the radii in vdw-pulling.vert
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, selected.radii->getId());
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, vertexPullingIndexBinding,
+                     selected.drawIndices->getId());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, selected.command->getId());
+    glDrawArraysIndirect(GL_TRIANGLE_STRIP, nullptr);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void LodSelection::resize(size_t numMeshes) {
+    if (selections_.size() > numMeshes) {
+        selections_.resize(numMeshes);
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
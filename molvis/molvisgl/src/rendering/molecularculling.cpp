@@ -0,0 +1,296 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/molecularculling.h>
+
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/bufferobject.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/image/layergl.h>
+#include <modules/opengl/texture/textureunit.h>
+#include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/openglutils.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+constexpr GLuint cullingGroupSize = 128;
+constexpr GLuint depthGroupSize = 16;
+
+// parameters of glDrawElementsIndirect for the culled indices, followed by the parameters of
+// glDrawArraysIndirect for one instance per culled primitive
+struct IndirectCommands {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+
+    GLuint verticesPerInstance;
+    GLuint numInstances;
+    GLuint first;
+    GLuint instanceBase;
+};
+constexpr size_t arraysCommandOffset = offsetof(IndirectCommands, verticesPerInstance);
+
+GLuint numGroups(size_t size, GLuint groupSize) {
+    return static_cast<GLuint>((size + groupSize - 1) / groupSize);
+}
+
+std::unique_ptr<BufferObject> makeBuffer(size_t bytes) {
+    auto buffer = std::make_unique<BufferObject>(bytes, DataUInt32::get(), BufferUsage::Dynamic,
+                                                 BufferTarget::Data);
+    buffer->initialize(nullptr, bytes);
+    return buffer;
+}
+
+}  // namespace
+
+MolecularCulling::MolecularCulling(std::function<void()> onShaderReload)
+    : cullingShader_({{ShaderType::Compute, "molecularculling.comp"}})
+    , copyDepthShader_({{ShaderType::Compute, "depthpyramid-copy.comp"}})
+    , reduceDepthShader_({{ShaderType::Compute, "depthpyramid-reduce.comp"}}) {
+    if (onShaderReload) {
+        cullingShader_.onReload(onShaderReload);
+        copyDepthShader_.onReload(onShaderReload);
+        reduceDepthShader_.onReload(onShaderReload);
+    }
+}
+
+MolecularCulling::~MolecularCulling() {
+    if (depthPyramid_ != 0) {
+        glDeleteTextures(1, &depthPyramid_);
+    }
+}
+
+bool MolecularCulling::isSupported() {
+    return OpenGLCapabilities::isExtensionSupported("GL_ARB_compute_shader") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_shader_storage_buffer_object") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_shader_image_load_store") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_draw_indirect") &&
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_clear_buffer_object");
+}
+
+size_t MolecularCulling::slot(DrawType drawType) { return drawType == DrawType::Lines ? 1 : 0; }
+
+bool MolecularCulling::cull(size_t meshIndex, const Mesh& mesh, const Primitives& primitives,
+                            Pass pass, const std::function<void(Shader&)>& setUniforms) {
+    if (primitives.drawType != DrawType::Points && primitives.drawType != DrawType::Lines) {
+        return false;
+    }
+    const IndexBuffer* indices = nullptr;
+    for (size_t i = 0; i < mesh.getNumberOfIndicies(); ++i) {
+        if (mesh.getIndexMeshInfo(i).dt == primitives.drawType) {
+            indices = mesh.getIndices(i);
+            break;
+        }
+    }
+    const auto positions = mesh.findBuffer(BufferType::PositionAttrib).first;
+    const auto radii = mesh.findBuffer(BufferType::RadiiAttrib).first;
+    if (!indices || !positions ||
+        positions->getDataFormat()->getId() != DataFormatId::Vec3Float32) {
+        return false;
+    }
+    if (primitives.useAtomRadii &&
+        (!radii || radii->getDataFormat()->getId() != DataFormatId::Float32)) {
+        return false;
+    }
+
+    const GLuint verticesPerPrimitive = primitives.drawType == DrawType::Lines ? 2 : 1;
+    const size_t numPrimitives = indices->getSize() / verticesPerPrimitive;
+
+    if (culled_.size() <= meshIndex) {
+        culled_.resize(meshIndex + 1);
+    }
+    auto& culled = culled_[meshIndex][slot(primitives.drawType)];
+    if (!culled.command || culled.indices != indices || culled.numPrimitives != numPrimitives) {
+        // new mesh or topology, nothing was visible in the previous frame
+        culled.indices = indices;
+        culled.numPrimitives = numPrimitives;
+        culled.visibility = makeBuffer(std::max<size_t>(numPrimitives, 1) * sizeof(GLuint));
+        culled.drawIndices = makeBuffer(std::max<size_t>(indices->getSize(), 1) * sizeof(GLuint));
+        culled.command = makeBuffer(sizeof(IndirectCommands));
+
+        const GLuint zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, culled.visibility->getId());
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT,
+                          &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    const IndirectCommands commands{0, 1, 0, 0, 0, 0, 0, 0, 0};
+    culled.command->upload(&commands, sizeof(commands));
+    if (numPrimitives == 0) return true;
+
+    const bool occlusion = (pass == Pass::Occlusion) && (depthPyramid_ != 0);
+
+    cullingShader_.activate();
+    setUniforms(cullingShader_);
+    cullingShader_.setUniform("numPrimitives", static_cast<int>(numPrimitives));
+    cullingShader_.setUniform("verticesPerPrimitive", static_cast<int>(verticesPerPrimitive));
+    cullingShader_.setUniform("radius", primitives.radius);
+    cullingShader_.setUniform("useAtomRadii", primitives.useAtomRadii);
+    cullingShader_.setUniform("pass", static_cast<int>(pass));
+    cullingShader_.setUniform("occlusion", occlusion);
+
+    TextureUnit unit;
+    if (occlusion) {
+        glActiveTexture(unit.getEnum());
+        glBindTexture(GL_TEXTURE_2D, depthPyramid_);
+        glActiveTexture(GL_TEXTURE0);
+        cullingShader_.setUniform("depthPyramid", unit.getUnitNumber());
+        cullingShader_.setUniform("depthPyramidSize", pyramidSize_);
+        cullingShader_.setUniform("depthPyramidLevels", pyramidLevels_);
+    }
+
+    const auto positionsId = positions->getRepresentation<BufferGL>()->getId();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, positionsId);
+    // the radii are not accessed without useAtomRadii, any buffer can be bound
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                     primitives.useAtomRadii ? radii->getRepresentation<BufferGL>()->getId()
+                                             : positionsId);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indices->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, culled.visibility->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, culled.drawIndices->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, culled.command->getId());
+
+    // large meshes exceed the maximum number of work groups of a single dispatch
+    const auto groups = numGroups(numPrimitives, cullingGroupSize);
+    utilgl::dispatchChunked(cullingShader_, groups, "invocationOffset", cullingGroupSize);
+    cullingShader_.deactivate();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
+                    GL_COMMAND_BARRIER_BIT);
+    LGL_ERROR;
+    return true;
+}
+
+void MolecularCulling::draw(size_t meshIndex, DrawType drawType) const {
+    if (meshIndex >= culled_.size()) return;
+    const auto& culled = culled_[meshIndex][slot(drawType)];
+    if (!culled.command || culled.numPrimitives == 0) return;
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, culled.drawIndices->getId());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culled.command->getId());
+    glDrawElementsIndirect(drawType == DrawType::Lines ? GL_LINES : GL_POINTS, GL_UNSIGNED_INT,
+                           nullptr);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void MolecularCulling::drawInstances(size_t meshIndex, DrawType drawType,
+                                     GLuint verticesPerInstance, GLuint indexBinding) const {
+    if (meshIndex >= culled_.size()) return;
+    const auto& culled = culled_[meshIndex][slot(drawType)];
+    if (!culled.command || culled.numPrimitives == 0) return;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, indexBinding, culled.drawIndices->getId());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, culled.command->getId());
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, arraysCommandOffset, sizeof(GLuint),
+                    &verticesPerInstance);
+    glDrawArraysIndirect(GL_TRIANGLE_STRIP, reinterpret_cast<const void*>(arraysCommandOffset));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void MolecularCulling::updateDepthPyramid(const Image& image) {
+    const auto depthLayer = image.getDepthLayer();
+    if (!depthLayer) return;
+
+    const ivec2 size{image.getDimensions()};
+    if (size != pyramidSize_) {
+        if (depthPyramid_ != 0) {
+            glDeleteTextures(1, &depthPyramid_);
+            depthPyramid_ = 0;
+        }
+        pyramidSize_ = size;
+        pyramidLevels_ = 0;
+        if (size.x <= 0 || size.y <= 0) return;
+
+        while ((std::max(size.x, size.y) >> pyramidLevels_) > 0) {
+            ++pyramidLevels_;
+        }
+        glGenTextures(1, &depthPyramid_);
+        glBindTexture(GL_TEXTURE_2D, depthPyramid_);
+        glTexStorage2D(GL_TEXTURE_2D, pyramidLevels_, GL_R32F, size.x, size.y);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (depthPyramid_ == 0) return;
+
+    // level 0 is a copy of the depth layer
+    {
+        TextureUnit unit;
+        depthLayer->getRepresentation<LayerGL>()->bindTexture(unit.getEnum());
+        glBindImageTexture(0, depthPyramid_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+        copyDepthShader_.activate();
+        copyDepthShader_.setUniform("depth", unit.getUnitNumber());
+        copyDepthShader_.setUniform("size", size);
+        glDispatchCompute(numGroups(size.x, depthGroupSize), numGroups(size.y, depthGroupSize), 1);
+        copyDepthShader_.deactivate();
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    // each texel of level i holds the maximum depth of the corresponding texels of level i - 1
+    reduceDepthShader_.activate();
+    ivec2 sourceSize = size;
+    for (int level = 1; level < pyramidLevels_; ++level) {
+        const ivec2 destSize = glm::max(sourceSize / 2, ivec2{1});
+        glBindImageTexture(0, depthPyramid_, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glBindImageTexture(1, depthPyramid_, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        reduceDepthShader_.setUniform("sourceSize", sourceSize);
+        reduceDepthShader_.setUniform("destSize", destSize);
+        glDispatchCompute(numGroups(destSize.x, depthGroupSize),
+                          numGroups(destSize.y, depthGroupSize), 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        sourceSize = destSize;
+    }
+    reduceDepthShader_.deactivate();
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    LGL_ERROR;
+}
+
+void MolecularCulling::resize(size_t numMeshes) {
+    if (culled_.size() > numMeshes) {
+        culled_.resize(numMeshes);
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,108 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/shadervariantcache.h>
+
+#include <inviwo/molvisgl/molvisglmodule.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace molvis {
+
+ShaderVariantCache::ShaderVariantCache(size_t capacity) : capacity_{capacity} {}
+
+std::shared_ptr<MeshShaderCache> ShaderVariantCache::get(
+    std::string_view name, std::vector<std::pair<ShaderType, std::string>> items,
+    std::vector<MeshShaderCache::Requirement> requirements, std::string_view variant,
+    std::function<void(Shader&)> configure) {
+
+    auto key = fmt::format("{}|{}", name, variant);
+    auto it = variants_.find(key);
+    if (it == variants_.end()) {
+        auto shaders = std::make_shared<MeshShaderCache>(
+            std::move(items), std::move(requirements),
+            [this, configure = std::move(configure)](Shader& shader) {
+                shader.onReload([this]() { reloaded_.invoke(); });
+                configure(shader);
+            });
+        it = variants_.emplace(std::move(key), Variant{std::move(shaders), 0}).first;
+    }
+    it->second.lastUse = ++useCounter_;
+
+    auto shaders = it->second.shaders;
+    evict(capacity_);
+    return shaders;
+}
+
+auto ShaderVariantCache::onReload(Callback callback) -> std::shared_ptr<Callback> {
+    return reloaded_.add(std::move(callback));
+}
+
+void ShaderVariantCache::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    evict(capacity_);
+}
+
+size_t ShaderVariantCache::getCapacity() const { return capacity_; }
+
+size_t ShaderVariantCache::size() const { return variants_.size(); }
+
+void ShaderVariantCache::clear() { evict(0); }
+
+void ShaderVariantCache::evict(size_t capacity) {
+    // variants held by a processor are never released
+    std::vector<decltype(variants_)::iterator> unused;
+    for (auto it = variants_.begin(); it != variants_.end(); ++it) {
+        if (it->second.shaders.use_count() == 1) unused.push_back(it);
+    }
+    if (unused.size() <= capacity) return;
+
+    std::sort(unused.begin(), unused.end(),
+              [](auto a, auto b) { return a->second.lastUse < b->second.lastUse; });
+    for (size_t i = 0; i < unused.size() - capacity; ++i) {
+        variants_.erase(unused[i]);
+    }
+}
+
+ShaderVariantCache& getShaderVariantCache(InviwoApplication* app) {
+    return app->getModuleByType<MolVisGLModule>()->getShaderVariantCache();
+}
+
+ShaderVariantCache& getShaderVariantCache() {
+    return getShaderVariantCache(util::getInviwoApplication());
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -0,0 +1,105 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/vertexpulling.h>
+
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <inviwo/core/util/zip.h>
+#include <modules/opengl/openglcapabilities.h>
+
+#include <array>
+#include <utility>
+
+namespace inviwo {
+
+namespace molvis {
+
+namespace {
+
+// attribute buffers read by the vertex pulling shaders, their bindings, and formats
+constexpr std::array<std::pair<BufferType, DataFormatId>, 5> pulledBuffers{
+    {{BufferType::PositionAttrib, DataFormatId::Vec3Float32},
+     {BufferType::ColorAttrib, DataFormatId::Vec4Float32},
+     {BufferType::RadiiAttrib, DataFormatId::Float32},
+     {BufferType::PickingAttrib, DataFormatId::UInt32},
+     {BufferType::ScalarMetaAttrib, DataFormatId::Float32}}};
+
+bool isSupported() {
+    static const bool supported =
+        OpenGLCapabilities::isExtensionSupported("GL_ARB_shader_storage_buffer_object") &&
+        OpenGLCapabilities::isExtensionSupported("GL_ARB_draw_instanced");
+    return supported;
+}
+
+}  // namespace
+
+bool supportsVertexPulling(const Mesh& mesh, DrawType drawType) {
+    if (!isSupported() || (drawType != DrawType::Points && drawType != DrawType::Lines)) {
+        return false;
+    }
+    if (!mesh.findBuffer(BufferType::PositionAttrib).first) return false;
+    for (auto [type, format] : pulledBuffers) {
+        if (auto buffer = mesh.findBuffer(type).first;
+            buffer && buffer->getDataFormat()->getId() != format) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < mesh.getNumberOfIndicies(); ++i) {
+        if (mesh.getIndexMeshInfo(i).dt == drawType) return true;
+    }
+    return false;
+}
+
+void bindVertexPullingBuffers(const Mesh& mesh) {
+    for (auto&& [binding, buffer] : util::enumerate(pulledBuffers)) {
+        if (auto attrib = mesh.findBuffer(buffer.first).first) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(binding),
+                             attrib->getRepresentation<BufferGL>()->getId());
+        }
+    }
+}
+
+void drawPulledImpostors(const Mesh& mesh, DrawType drawType) {
+    const GLuint verticesPerPrimitive = drawType == DrawType::Lines ? 2 : 1;
+    for (size_t i = 0; i < mesh.getNumberOfIndicies(); ++i) {
+        if (mesh.getIndexMeshInfo(i).dt != drawType) continue;
+        const auto indices = mesh.getIndices(i);
+        const auto numPrimitives = static_cast<GLsizei>(indices->getSize() / verticesPerPrimitive);
+        if (numPrimitives == 0) continue;
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, vertexPullingIndexBinding,
+                         indices->getRepresentation<BufferGL>()->getId());
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, impostorVertices(drawType), numPrimitives);
+    }
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
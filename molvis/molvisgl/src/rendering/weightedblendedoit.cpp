@@ -0,0 +1,203 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/molvisgl/rendering/weightedblendedoit.h>
+
+#include <modules/opengl/texture/textureunit.h>
+#include <modules/opengl/texture/textureutils.h>
+#include <modules/opengl/openglcapabilities.h>
+#include <modules/opengl/openglutils.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace molvis {
+
+WeightedBlendedOit::WeightedBlendedOit(std::function<void()> onShaderReload)
+    : compositeShader_("img_identity.vert", "weightedoit-composite.frag") {
+    if (onShaderReload) {
+        compositeShader_.onReload(onShaderReload);
+    }
+}
+
+WeightedBlendedOit::~WeightedBlendedOit() {
+    if (framebuffer_ != 0) {
+        glDeleteFramebuffers(1, &framebuffer_);
+    }
+    if (textures_[0] != 0) {
+        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+    }
+}
+
+bool WeightedBlendedOit::isSupported() {
+    return OpenGLCapabilities::getOpenGLVersion() >= 400 ||
+           OpenGLCapabilities::isExtensionSupported("GL_ARB_draw_buffers_blend");
+}
+
+void WeightedBlendedOit::resize(const ivec2& size) {
+    if (size == size_ && framebuffer_ != 0) return;
+    size_ = size;
+
+    if (framebuffer_ == 0) {
+        glGenFramebuffers(1, &framebuffer_);
+    }
+    if (textures_[0] != 0) {
+        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+    }
+    glGenTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
+
+    const std::array<GLenum, 2> formats{GL_RGBA16F, GL_R16F};
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer_);
+    for (size_t i = 0; i < textures_.size(); ++i) {
+        glBindTexture(GL_TEXTURE_2D, textures_[i]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, formats[i], std::max(size.x, 1), std::max(size.y, 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i),
+                             textures_[i], 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    LGL_ERROR;
+}
+
+void WeightedBlendedOit::begin(const ivec2& size) {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer_);
+
+    GLint maxDrawBuffers = 0;
+    glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+    previousDrawBuffers_.assign(static_cast<size_t>(maxDrawBuffers), GL_NONE);
+    for (GLint i = 0; i < maxDrawBuffers; ++i) {
+        GLint buffer = GL_NONE;
+        glGetIntegerv(GL_DRAW_BUFFER0 + i, &buffer);
+        previousDrawBuffers_[i] = static_cast<GLenum>(buffer);
+    }
+    while (!previousDrawBuffers_.empty() && previousDrawBuffers_.back() == GL_NONE) {
+        previousDrawBuffers_.pop_back();
+    }
+
+    // the depth attachment of the target is shared for depth testing against opaque geometry
+    GLint depthType = GL_NONE;
+    GLint depthName = 0;
+    if (previousFramebuffer_ != 0) {
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                              GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &depthType);
+        if (depthType != GL_NONE) {
+            glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                                  GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME,
+                                                  &depthName);
+        }
+    }
+
+    resize(size);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer_);
+    if (depthType == GL_RENDERBUFFER) {
+        glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                                  static_cast<GLuint>(depthName));
+    } else if (depthType == GL_TEXTURE) {
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                             static_cast<GLuint>(depthName), 0);
+    } else {
+        glFramebufferTexture(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, 0, 0);
+    }
+
+    const std::array<GLenum, 2> drawBuffers{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    const std::array<GLfloat, 4> zero{0.0f, 0.0f, 0.0f, 0.0f};
+    const std::array<GLfloat, 4> one{1.0f, 1.0f, 1.0f, 1.0f};
+    glClearBufferfv(GL_COLOR, 0, zero.data());
+    glClearBufferfv(GL_COLOR, 1, one.data());
+
+    previousBlend_ = glIsEnabled(GL_BLEND);
+    const std::array<GLenum, 4> blendParams{GL_BLEND_SRC_RGB, GL_BLEND_DST_RGB,
+                                            GL_BLEND_SRC_ALPHA, GL_BLEND_DST_ALPHA};
+    for (size_t i = 0; i < blendParams.size(); ++i) {
+        glGetIntegerv(blendParams[i], &previousBlendFunc_[i]);
+    }
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &previousDepthMask_);
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+    LGL_ERROR;
+}
+
+void WeightedBlendedOit::bindOutputs(const Shader& shader) {
+    const GLint color = glGetFragDataLocation(shader.getID(), "FragData0");
+    const GLint revealage = glGetFragDataLocation(shader.getID(), "PickingData");
+    if (color < 0 || revealage < 0) return;
+
+    std::vector<GLenum> drawBuffers(static_cast<size_t>(std::max(color, revealage)) + 1, GL_NONE);
+    drawBuffers[color] = GL_COLOR_ATTACHMENT0;
+    drawBuffers[revealage] = GL_COLOR_ATTACHMENT1;
+    glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+    // sum of weighted colors and product of (1 - alpha)
+    glBlendFunci(static_cast<GLuint>(color), GL_ONE, GL_ONE);
+    glBlendFunci(static_cast<GLuint>(revealage), GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+}
+
+void WeightedBlendedOit::end() {
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previousFramebuffer_));
+    // only the color is composited, the picking and depth of the target stay unchanged
+    if (!previousDrawBuffers_.empty()) {
+        glDrawBuffers(1, previousDrawBuffers_.data());
+    }
+
+    {
+        utilgl::GlBoolState depthTest(GL_DEPTH_TEST, false);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        TextureUnit accumulationUnit;
+        TextureUnit revealageUnit;
+        glActiveTexture(accumulationUnit.getEnum());
+        glBindTexture(GL_TEXTURE_2D, textures_[0]);
+        glActiveTexture(revealageUnit.getEnum());
+        glBindTexture(GL_TEXTURE_2D, textures_[1]);
+        glActiveTexture(GL_TEXTURE0);
+
+        compositeShader_.activate();
+        compositeShader_.setUniform("accumulation", accumulationUnit.getUnitNumber());
+        compositeShader_.setUniform("revealage", revealageUnit.getUnitNumber());
+        utilgl::singleDrawImagePlaneRect();
+        compositeShader_.deactivate();
+    }
+
+    if (!previousDrawBuffers_.empty()) {
+        glDrawBuffers(static_cast<GLsizei>(previousDrawBuffers_.size()),
+                      previousDrawBuffers_.data());
+    }
+    glBlendFuncSeparate(previousBlendFunc_[0], previousBlendFunc_[1], previousBlendFunc_[2],
+                        previousBlendFunc_[3]);
+    if (!previousBlend_) glDisable(GL_BLEND);
+    glDepthMask(previousDepthMask_);
+    LGL_ERROR;
+}
+
+}  // namespace molvis
+
+}  // namespace inviwo
@@ -32,12 +32,16 @@
 #include <warn/push>
 #include <warn/ignore/shadow>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 #include <warn/pop>
 
 #include <inviwo/core/datastructures/geometry/mesh.h>
 
+#include <inviwo/molvisbase/algorithm/atomselection.h>
+#include <inviwo/molvisbase/algorithm/contacts.h>
+#include <inviwo/molvisbase/datastructures/atomgrid.h>
 #include <inviwo/molvisbase/datastructures/molecularstructure.h>
 #include <inviwo/molvisbase/datastructures/molecularstructuretraits.h>
 #include <inviwo/molvisbase/util/molvisutils.h>
@@ -48,6 +52,8 @@
 
 #include <fmt/format.h>
 
+#include <type_traits>
+
 namespace py = pybind11;
 
 namespace inviwo {
@@ -307,13 +313,106 @@ void exposeChainId(pybind11::module& m) {
         .value("Z", ChainId::Z);
 }
 
+template <typename T>
+using CArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// element type of the NumPy arrays of a column, enums are represented by their underlying type
+template <typename T, typename = void>
+struct ArrayValue {
+    using type = T;
+};
+template <typename T>
+struct ArrayValue<T, std::enable_if_t<std::is_enum_v<T>>> {
+    using type = std::underlying_type_t<T>;
+};
+
+/*
+ * NumPy array referring to the elements of \p column without copying them. The array keeps
+ * \p base, the Python object owning \p column, alive. The view is invalidated if the column is
+ * resized.
+ */
+template <typename T, typename U>
+py::array columnView(const std::vector<U>& column, py::handle base, bool writable,
+                     std::vector<py::ssize_t> shape) {
+    static_assert(sizeof(U) % sizeof(T) == 0, "incompatible column type");
+    std::vector<py::ssize_t> strides{static_cast<py::ssize_t>(sizeof(U))};
+    if (shape.size() == 2) strides.push_back(sizeof(T));
+    py::array_t<T> array(std::move(shape), std::move(strides),
+                         reinterpret_cast<const T*>(column.data()), base);
+    if (!writable) array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+template <typename T>
+py::array columnView(const std::vector<T>& column, py::handle base, bool writable) {
+    return columnView<typename ArrayValue<T>::type>(column, base, writable,
+                                                    {static_cast<py::ssize_t>(column.size())});
+}
+
+py::array positionsView(const std::vector<dvec3>& positions, py::handle base, bool writable) {
+    static_assert(sizeof(dvec3) == 3 * sizeof(double), "dvec3 is not tightly packed");
+    return columnView<double>(positions, base, writable,
+                              {static_cast<py::ssize_t>(positions.size()), 3});
+}
+
+// copy a one dimensional array into \p column with a single bulk copy
+template <typename T>
+void assignColumn(std::vector<T>& column, const py::array& array) {
+    using Value = typename ArrayValue<T>::type;
+    auto values = CArray<Value>::ensure(array);
+    if (!values || values.ndim() != 1) {
+        throw py::value_error("expected a one dimensional array");
+    }
+    column.resize(values.size());
+    std::copy_n(values.data(), values.size(), reinterpret_cast<Value*>(column.data()));
+}
+
+// getter of a read-only view of an atom column of a MolecularStructure
+template <typename T>
+auto structureColumnView(std::vector<T> Atoms::*column) {
+    return [column](py::object self) {
+        const auto& s = self.cast<const MolecularStructure&>();
+        return columnView(s.atoms().*column, self, false);
+    };
+}
+
+std::vector<dvec3> toPositions(const py::array& array) {
+    auto values = CArray<double>::ensure(array);
+    if (!values || values.ndim() != 2 || values.shape(1) != 3) {
+        throw py::value_error("expected an array of shape (n, 3)");
+    }
+    std::vector<dvec3> positions(values.shape(0));
+    std::copy_n(values.data(), values.size(), reinterpret_cast<double*>(positions.data()));
+    return positions;
+}
+
 void exposeMolVisUtil(pybind11::module& m) {
+    py::class_<AtomContact>(m, "AtomContact")
+        .def_readonly("atom1", &AtomContact::atom1)
+        .def_readonly("atom2", &AtomContact::atom2)
+        .def_readonly("distance", &AtomContact::distance)
+        .def("__repr__", [](const AtomContact& c) {
+            return fmt::format("<AtomContact: {}, {}, {}>", c.atom1, c.atom2, c.distance);
+        });
+    py::class_<ResidueContact>(m, "ResidueContact")
+        .def_readonly("residue1", &ResidueContact::residue1)
+        .def_readonly("residue2", &ResidueContact::residue2)
+        .def_readonly("distance", &ResidueContact::distance)
+        .def("__repr__", [](const ResidueContact& c) {
+            return fmt::format("<ResidueContact: {}, {}, {}>", c.residue1, c.residue2,
+                               c.distance);
+        });
+
     m.def("findResidue", &findResidue, py::arg("data"), py::arg("residueId"), py::arg("chainId"))
         .def("findChainId", &findChain, py::arg("data"), py::arg("chainId"))
         .def("getGlobalAtomIndex", &getGlobalAtomIndex, py::arg("atoms"), py::arg("fullAtomName"),
              py::arg("residueId"), py::arg("chainId"))
-        .def("computeCovalentBonds", &computeCovalentBonds, py::arg("atoms"))
+        .def("computeCovalentBonds",
+             py::overload_cast<const Atoms&>(&computeCovalentBonds), py::arg("atoms"))
         .def("getAtomicNumbers", &getAtomicNumbers, py::arg("fullNames"))
+        .def("computeAtomContacts", &computeAtomContacts, py::arg("structure"), py::arg("cutoff"))
+        .def("computeResidueContacts", &computeResidueContacts, py::arg("structure"),
+             py::arg("cutoff"), py::arg("minSeparation") = 0)
         .def("createMesh", &createMesh, py::arg("structure"), py::arg("enablePicking") = false,
              py::arg("globalStartId") = 0);
 }
@@ -342,6 +441,49 @@ void exposeMolVis(pybind11::module& m) {
         .def_readwrite("residueids", &Atoms::residueIds)
         .def_readwrite("atomicnumbers", &Atoms::atomicNumbers)
         .def_readwrite("fullnames", &Atoms::fullNames)
+        // NumPy views of the columns, assigning an array copies it in bulk
+        .def_property(
+            "positionsArray",
+            [](py::object self) {
+                return detail::positionsView(self.cast<Atoms&>().positions, self, true);
+            },
+            [](Atoms& a, const py::array& array) { a.positions = detail::toPositions(array); })
+        .def_property(
+            "serialNumbersArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().serialNumbers, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.serialNumbers, array); })
+        .def_property(
+            "bfactorsArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().bFactors, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.bFactors, array); })
+        .def_property(
+            "modelidsArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().modelIds, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.modelIds, array); })
+        .def_property(
+            "chainidsArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().chainIds, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.chainIds, array); })
+        .def_property(
+            "residueidsArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().residueIds, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.residueIds, array); })
+        .def_property(
+            "atomicnumbersArray",
+            [](py::object self) {
+                return detail::columnView(self.cast<Atoms&>().atomicNumbers, self, true);
+            },
+            [](Atoms& a, const py::array& array) { detail::assignColumn(a.atomicNumbers, array); })
         .def("__len__", [](Atoms& a) { return a.positions.size(); })
         .def("__repr__", [](Atoms& a) {
             return fmt::format(
@@ -399,6 +541,7 @@ void exposeMolVis(pybind11::module& m) {
         .def_readwrite("residues", &MolecularData::residues)
         .def_readwrite("chains", &MolecularData::chains)
         .def_readwrite("bonds", &MolecularData::bonds)
+        .def_readwrite("instances", &MolecularData::instances)
         .def("__repr__", [](const MolecularData& md) {
             return fmt::format(
                 "<MolecularStructure: '{}', {} atom(s), {} residue(s), {} chain(s), {} bonds>",
@@ -409,27 +552,90 @@ void exposeMolVis(pybind11::module& m) {
     py::class_<MolecularStructure, std::shared_ptr<MolecularStructure>>(m, "MolecularStructure")
         .def(py::init([](MolecularData data) -> MolecularStructure { return {std::move(data)}; }),
              py::arg("data"))
+        .def(py::init([](const MolecularStructure& topology, const py::array& positions) {
+                 return MolecularStructure{topology, detail::toPositions(positions)};
+             }),
+             py::arg("topology"), py::arg("positions"),
+             "trajectory frame sharing the topology of topology, positions of shape (n, 3)")
         .def("data", &MolecularStructure::data)
         .def("atoms", &MolecularStructure::atoms)
         .def("residues", &MolecularStructure::residues)
         .def("chains", &MolecularStructure::chains)
         .def("bonds", &MolecularStructure::bonds)
+        .def("instances", &MolecularStructure::instances)
+        .def("getNumberOfInstances", &MolecularStructure::getNumberOfInstances)
         .def("hasResidues", &MolecularStructure::hasResidues)
         .def("hasResidue", &MolecularStructure::hasResidue, py::arg("residueId"),
              py::arg("chainId"))
         .def("hasChains", &MolecularStructure::hasChains)
         .def("hasChain", &MolecularStructure::hasChain, py::arg("chainId"))
-        .def("getResidueAtoms", &MolecularStructure::getResidueAtoms, py::arg("residueId"),
-             py::arg("chainId"))
-        .def("getChainResidues", &MolecularStructure::getChainResidues, py::arg("chainId"))
+        .def(
+            "getResidueAtoms",
+            [](const MolecularStructure& s, int residueId, int chainId) {
+                return s.getResidueAtoms(residueId, chainId).toVector();
+            },
+            py::arg("residueId"), py::arg("chainId"))
+        .def(
+            "getChainResidues",
+            [](const MolecularStructure& s, int chainId) {
+                return s.getChainResidues(chainId).toVector();
+            },
+            py::arg("chainId"))
         .def("getResidueIndices", &MolecularStructure::getResidueIndices)
-
+        .def("getResidueChainIndices", &MolecularStructure::getResidueChainIndices)
+        .def(
+            "atomsWithin",
+            [](const MolecularStructure& s, const dvec3& pos, double radius) {
+                return s.getAtomGrid().atomsWithin(pos, radius);
+            },
+            py::arg("pos"), py::arg("radius"))
+        .def(
+            "nearestAtoms",
+            [](const MolecularStructure& s, const dvec3& pos, size_t k) {
+                return s.getAtomGrid().nearestAtoms(pos, k);
+            },
+            py::arg("pos"), py::arg("k"))
+        // read-only NumPy views of the atom columns, which keep the structure alive
+        .def_property_readonly("positionsArray",
+                               [](py::object self) {
+                                   const auto& s = self.cast<const MolecularStructure&>();
+                                   return detail::positionsView(s.atoms().positions, self, false);
+                               })
+        .def_property_readonly("bfactorsArray",
+                               detail::structureColumnView(&Atoms::bFactors))
+        .def_property_readonly("chainidsArray",
+                               detail::structureColumnView(&Atoms::chainIds))
+        .def_property_readonly("residueidsArray",
+                               detail::structureColumnView(&Atoms::residueIds))
+        .def_property_readonly("atomicnumbersArray",
+                               detail::structureColumnView(&Atoms::atomicNumbers))
         .def("__repr__", [](const MolecularStructure& s) {
             return fmt::format("<MolecularStructure: {} atom(s), residues {}, chains {}>",
                                s.atoms().positions.size(), s.hasResidues() ? "yes" : "no",
                                s.hasChains() ? "yes" : "no");
         });
 
+    py::class_<AtomSelection>(m, "AtomSelection")
+        .def(py::init<std::string_view>(), py::arg("query"))
+        .def_property_readonly("query", &AtomSelection::getQuery)
+        .def(
+            "indices",
+            [](const AtomSelection& sel, const MolecularStructure& s) {
+                return sel.evaluate(s).indices();
+            },
+            py::arg("structure"), "indices of the selected atoms of structure in ascending order")
+        .def("__repr__", [](const AtomSelection& sel) {
+            return fmt::format("<AtomSelection: '{}'>", sel.getQuery());
+        });
+
+    m.def(
+        "selectAtoms",
+        [](const MolecularStructure& s, std::string_view query) {
+            return selectAtoms(s, query).indices();
+        },
+        py::arg("structure"), py::arg("query"),
+        "indices of the atoms of structure matching the selection query, see AtomSelection");
+
     exposeStandardDataPorts<MolecularStructure>(m, "MolecularStructure");
 }
 
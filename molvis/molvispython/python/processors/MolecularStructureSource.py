@@ -131,15 +131,13 @@ class MolecularStructureSource(ivw.Processor):
             elements.append(ivwmolvis.atomicelement.fromAbbr(atom.element))
 
         atoms = ivwmolvis.Atoms()
-        dvec3pos = []
-        for p in pos:
-            dvec3pos.append(ivw.glm.dvec3(p[0], p[1], p[2]))
-        atoms.positions = dvec3pos
-        atoms.serialNumbers = serialNumbers
-        atoms.bfactors = bfactors
-        atoms.modelids = modelId
-        atoms.chainids = chainId
-        atoms.residueids = residueId
+        # arrays are copied in bulk, without converting each element
+        atoms.positionsArray = np.array(pos, dtype=np.float64).reshape(-1, 3)
+        atoms.serialNumbersArray = np.array(serialNumbers, dtype=np.int32)
+        atoms.bfactorsArray = np.array(bfactors, dtype=np.float64)
+        atoms.modelidsArray = np.array(modelId, dtype=np.int32)
+        atoms.chainidsArray = np.array(chainId, dtype=np.int32)
+        atoms.residueidsArray = np.array(residueId, dtype=np.int32)
         atoms.fullnames = atomFullName
         atoms.atomicnumbers = elements
 
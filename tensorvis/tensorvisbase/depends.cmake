@@ -9,4 +9,7 @@ set(dependencies
     InviwoVectorFieldVisualizationModule
 	InviwoNanoVGUtilsModule
 	InviwoPlottingModule
+    InviwoMemoryBudgetModule
+    InviwoUtilitiesModule
+    InviwoUtilitiesGLModule
 )
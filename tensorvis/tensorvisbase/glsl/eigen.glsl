@@ -91,3 +91,74 @@ vec2 getEigenvector(mat2 tensor, float eigenValue, bool useMinor) {
     
     return vec2(0.0);
 }
+
+/*
+ * Closed-form eigenvalues of a symmetric 3x3 tensor given by its six unique components, see
+ * O.K. Smith, Eigenvalues of a symmetric 3x3 matrix, Communications of the ACM (1961).
+ * The result is sorted such that lambda1 >= lambda2 >= lambda3.
+ */
+vec3 getSymmetricEigenvalues(float xx, float yy, float zz, float xy, float yz, float xz) {
+    float p1 = xy * xy + xz * xz + yz * yz;
+    float q = (xx + yy + zz) / 3.0;
+
+    float p2 = (xx - q) * (xx - q) + (yy - q) * (yy - q) + (zz - q) * (zz - q) + 2.0 * p1;
+    float p = sqrt(p2 / 6.0);
+
+    if (p < 1e-30) {
+        return vec3(q);
+    }
+
+    if (p1 < 1e-30) {
+        // Diagonal tensor, sort the diagonal
+        vec3 d = vec3(xx, yy, zz);
+        float lambda1 = max(d.x, max(d.y, d.z));
+        float lambda3 = min(d.x, min(d.y, d.z));
+        return vec3(lambda1, d.x + d.y + d.z - lambda1 - lambda3, lambda3);
+    }
+
+    // B = (A - qI) / p, r = det(B) / 2
+    float bxx = (xx - q) / p;
+    float byy = (yy - q) / p;
+    float bzz = (zz - q) / p;
+    float bxy = xy / p;
+    float byz = yz / p;
+    float bxz = xz / p;
+    float r = 0.5 * (bxx * (byy * bzz - byz * byz) - bxy * (bxy * bzz - byz * bxz) +
+                     bxz * (bxy * byz - byy * bxz));
+    r = clamp(r, -1.0, 1.0);
+
+    float phi = acos(r) / 3.0;
+
+    float lambda1 = q + 2.0 * p * cos(phi);
+    float lambda3 = q + 2.0 * p * cos(phi + (2.0 * 3.14159265358979 / 3.0));
+    float lambda2 = 3.0 * q - lambda1 - lambda3;
+
+    return vec3(lambda1, lambda2, lambda3);
+}
+
+/*
+ * Eigenvector of a symmetric 3x3 tensor for the given eigenvalue. The eigenvector is orthogonal to
+ * the rows of A - lambda * I, hence the largest cross product of two rows is used. Returns
+ * fallback if the eigenvalue is not simple.
+ */
+vec3 getSymmetricEigenvector(float xx, float yy, float zz, float xy, float yz, float xz,
+                             float lambda, vec3 fallback) {
+    vec3 r0 = vec3(xx - lambda, xy, xz);
+    vec3 r1 = vec3(xy, yy - lambda, yz);
+    vec3 r2 = vec3(xz, yz, zz - lambda);
+
+    vec3 c01 = cross(r0, r1);
+    vec3 c02 = cross(r0, r2);
+    vec3 c12 = cross(r1, r2);
+
+    float d01 = dot(c01, c01);
+    float d02 = dot(c02, c02);
+    float d12 = dot(c12, c12);
+
+    float dmax = max(d01, max(d02, d12));
+    if (dmax < 1e-20) return fallback;
+
+    if (dmax == d01) return c01 * inversesqrt(d01);
+    if (dmax == d02) return c02 * inversesqrt(d02);
+    return c12 * inversesqrt(d12);
+}
@@ -0,0 +1,128 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include "utils/structs.glsl"
+#include "utils/shading.glsl"
+#include "colortools.glsl"
+
+// Ray casts the superquadric set up in superquadric.geom, shading as in tensorglyphpicking.frag
+
+uniform GeometryParameters geometry;
+uniform CameraParameters camera;
+uniform LightParameters light;
+
+in vec4 worldPosition_;
+flat in mat3 toGlyph_;
+flat in vec3 center_;
+flat in vec3 shape_;
+flat in vec4 color_;
+flat in vec3 pickingColor_;
+flat in int highlight_;
+
+const int marchingSteps = 48;
+const int bisectionSteps = 10;
+
+// Implicit form of the superquadric of TensorGlyphProperty::createSuperquadric, negative inside
+float superquadric(vec3 p) {
+    p = abs(p);
+    if (shape_.z > 0.5) p = p.zyx;
+
+    float alpha = max(shape_.x, 0.01);
+    float beta = max(shape_.y, 0.01);
+    return pow(pow(p.y, 2.0 / alpha) + pow(p.z, 2.0 / alpha), alpha / beta) +
+           pow(p.x, 2.0 / beta) - 1.0;
+}
+
+vec3 superquadricGradient(vec3 p) {
+    const vec2 h = vec2(1e-3, 0.0);
+    return vec3(superquadric(p + h.xyy) - superquadric(p - h.xyy),
+                superquadric(p + h.yxy) - superquadric(p - h.yxy),
+                superquadric(p + h.yyx) - superquadric(p - h.yyx));
+}
+
+void main() {
+    // Ray in glyph space, the glyph fills [-1, 1]^3
+    vec3 dataPosition = (geometry.worldToData * worldPosition_).xyz;
+    vec3 dataCamera = (geometry.worldToData * vec4(camera.position, 1.0)).xyz;
+    vec3 origin = toGlyph_ * (dataCamera - center_);
+    vec3 dir = toGlyph_ * (dataPosition - dataCamera);
+
+    vec3 invDir = 1.0 / dir;
+    vec3 t0 = (vec3(-1.0) - origin) * invDir;
+    vec3 t1 = (vec3(1.0) - origin) * invDir;
+    vec3 tmin = min(t0, t1);
+    vec3 tmax = max(t0, t1);
+    float tNear = max(max(max(tmin.x, tmin.y), tmin.z), 0.0);
+    float tFar = min(min(tmax.x, tmax.y), tmax.z);
+    if (tNear >= tFar) discard;
+
+    // March to the first sign change and refine by bisection
+    float dt = (tFar - tNear) / float(marchingSteps);
+    float tPrev = tNear;
+    float t = tNear;
+    bool hit = superquadric(origin + tNear * dir) <= 0.0;
+    for (int i = 1; i <= marchingSteps && !hit; ++i) {
+        tPrev = t;
+        t = tNear + float(i) * dt;
+        hit = superquadric(origin + t * dir) <= 0.0;
+    }
+    if (!hit) discard;
+
+    for (int i = 0; i < bisectionSteps && t > tPrev; ++i) {
+        float tMid = 0.5 * (tPrev + t);
+        if (superquadric(origin + tMid * dir) <= 0.0) {
+            t = tMid;
+        } else {
+            tPrev = tMid;
+        }
+    }
+
+    vec3 p = origin + t * dir;
+    vec3 n = transpose(toGlyph_) * superquadricGradient(p);
+    if (dot(n, n) < 1e-20) n = -dir;
+
+    vec4 worldPosition = geometry.dataToWorld * vec4(center_ + inverse(toGlyph_) * p, 1.0);
+    vec3 normal = normalize(geometry.dataToWorldNormalMatrix * n);
+
+    vec4 clip = camera.worldToClip * worldPosition;
+    gl_FragDepth = 0.5 * (clip.z / clip.w) + 0.5;
+
+    vec3 hl_color = rgb2hcl(color_.xyz);
+    hl_color *= vec3(1.0, 0.25, 1.2);
+    hl_color = hcl2rgb(hl_color);
+
+    vec4 color = highlight_ != 0 ? vec4(hl_color, 1.0) : color_;
+
+    vec4 fragColor = vec4(1.0);
+    fragColor.rgb = APPLY_LIGHTING(light, color.rgb, color.rgb, vec3(1.0f), worldPosition.xyz,
+                                   normal, normalize(camera.position - worldPosition.xyz));
+
+    FragData0 = fragColor;
+    PickingData = vec4(pickingColor_, 1.0);
+}
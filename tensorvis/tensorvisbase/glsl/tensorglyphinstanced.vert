@@ -0,0 +1,121 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include "utils/structs.glsl"
+#include "utils/pickingutils.glsl"
+
+// Same layout as TensorGlyphProperty::GlyphInstance
+struct GlyphInstance {
+    vec4 position;  // xyz position, w glyph size
+    vec4 basis[3];
+    vec4 color;
+    vec4 shape;  // superquadric alpha, beta, swap x and z axes, is superquadric
+};
+
+layout(std430, binding = 0) readonly buffer instanceBuffer {
+    GlyphInstance instances[];
+};
+
+// Picking id (x) and state (y) per instance, bit 0 selected and bit 1 hovered
+layout(std430, binding = 1) readonly buffer pickingBuffer {
+    uvec2 picking[];
+};
+
+// Indices of the drawn instances, written by tensorglyphculling.comp. The instances of the level
+// of detail being drawn start at visibleOffset.
+layout(std430, binding = 3) readonly buffer visibleBuffer {
+    uint visible[];
+};
+uniform uint visibleOffset = 0u;
+
+uniform GeometryParameters geometry;
+uniform CameraParameters camera;
+
+out vec4 worldPosition_;
+out vec3 normal_;
+out vec3 viewNormal_;
+out vec3 texCoord_;
+out vec4 color_;
+flat out vec3 pickingColor_;
+flat out int highlight_;
+flat out int hovered_;
+
+float signedPow(float x, float a) { return sign(x) * pow(abs(x), a); }
+
+// Same deformation as TensorGlyphProperty::createSuperquadric, the normal follows from the
+// implicit superquadric surface, see Barr, Superquadrics and Angle-Preserving Transformations
+void superquadric(inout vec3 v, out vec3 n, float alpha, float beta, bool swapAxes) {
+    float r = length(v);
+    float phi = acos(v.z / r);
+    float theta = atan(v.y, v.x);
+
+    float sinphi = sin(phi);
+    float cosphi = cos(phi);
+    float sintheta = sin(theta);
+    float costheta = cos(theta);
+
+    v = vec3(signedPow(cosphi, beta),
+             -signedPow(sintheta, alpha) * signedPow(sinphi, beta),
+             signedPow(costheta, alpha) * signedPow(sinphi, beta));
+    n = vec3(signedPow(cosphi, 2.0 - beta),
+             -signedPow(sintheta, 2.0 - alpha) * signedPow(sinphi, 2.0 - beta),
+             signedPow(costheta, 2.0 - alpha) * signedPow(sinphi, 2.0 - beta));
+
+    if (swapAxes) {
+        v = vec3(v.z, -v.y, v.x);
+        n = vec3(n.z, -n.y, n.x);
+    }
+}
+
+void main() {
+    uint index = visible[visibleOffset + uint(gl_InstanceID)];
+    GlyphInstance instance = instances[index];
+
+    mat3 basis = mat3(instance.basis[0].xyz, instance.basis[1].xyz, instance.basis[2].xyz);
+
+    vec3 vertex = in_Vertex.xyz;
+    vec3 normal = in_Normal;
+    if (instance.shape.w > 0.5) {
+        superquadric(vertex, normal, instance.shape.x, instance.shape.y, instance.shape.z > 0.5);
+    }
+
+    vec3 position = instance.position.xyz + instance.position.w * (basis * vertex);
+
+    color_ = instance.color;
+    texCoord_ = in_TexCoord;
+    worldPosition_ = geometry.dataToWorld * vec4(position, 1.0);
+    normal_ = geometry.dataToWorldNormalMatrix * (transpose(inverse(basis)) * normal);
+    viewNormal_ = (camera.worldToView * vec4(normal_, 0)).xyz;
+    uvec2 pickingState = picking[index];
+    pickingColor_ = pickingIndexToColor(pickingState.x);
+    highlight_ = int((pickingState.y & 1u) != 0u);
+    hovered_ = int((pickingState.y & 2u) != 0u);
+
+    gl_Position = camera.worldToClip * worldPosition_;
+}
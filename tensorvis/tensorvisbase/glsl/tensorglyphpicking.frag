@@ -31,8 +31,19 @@
 #include "colortools.glsl"
 
 // Same as geometryrendering.frag with the exception of picking
+#ifdef INSTANCED_GLYPHS
+// Picking color and highlighting are per instance, see tensorglyphinstanced.vert
+flat in vec3 pickingColor_;
+flat in int highlight_;
+flat in int hovered_;
+#define pickingColor pickingColor_
+#define highlight (highlight_ != 0)
+#define hovered (hovered_ != 0)
+#else
 uniform vec3 pickingColor;
 uniform bool highlight;
+uniform bool hovered = false;
+#endif
 
 uniform LightParameters light;
 uniform CameraParameters camera;
@@ -53,6 +64,7 @@ void main() {
 
     vec4 color;
     color = highlight ? vec4(hl_color, 1.0) : color_;
+    if (hovered && !highlight) color.rgb = mix(color.rgb, vec3(1.0), 0.3);
     
     fragColor.rgb = APPLY_LIGHTING(light, color.rgb, color.rgb, vec3(1.0f), worldPosition_.xyz,
                                    normalize(normal_), normalize(toCameraDir_));
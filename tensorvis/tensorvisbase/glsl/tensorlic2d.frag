@@ -33,6 +33,7 @@
 uniform sampler2D tensorFieldColor;
 uniform sampler2D noiseTextureColor;
 uniform sampler2D imageInportColor;
+uniform sampler2D previousFrameColor;
 uniform sampler2D tf;
 uniform ImageParameters tensorFieldParameters;
 uniform ImageParameters noiseTextureParameters;
@@ -50,6 +51,13 @@ uniform bool hasInputImage;
 uniform float ratio;
 uniform vec4 backgroundColor;
 
+// Shortens the kernel in isotropic regions, down to minKernelLength times the full length
+uniform bool adaptiveKernel;
+uniform float minKernelLength;
+// Progressive refinement, frame is the number of frames accumulated in previousFrameColor
+uniform int frame;
+uniform vec2 jitter;
+
 in vec3 texCoord_;
 
 void traverse(inout float v, inout int c, vec2 posForTensorFieldSampling, float stepSize,
@@ -89,7 +97,7 @@ void traverse(inout float v, inout int c, vec2 posForTensorFieldSampling, float
         // vec2 delta = vec2(1.0 / (2.0 * n));
         // vec2 newTexForNoiseTextureSampling = mix(delta, 1.0 - delta, posForTensorFieldSampling);
 
-        v += texture(noiseTextureColor, posForTensorFieldSampling).r;
+        v += texture(noiseTextureColor, posForTensorFieldSampling + jitter).r;
         c += 1;
     }
 }
@@ -114,10 +122,21 @@ void main() {
         return;
     }
 
-    float colorValue = texture(noiseTextureColor, newTexForNoiseTextureSampling).r;
+    float colorValue = texture(noiseTextureColor, newTexForNoiseTextureSampling + jitter).r;
+
+    int steps = samples / 2;
+    if (adaptiveKernel) {
+        // Anisotropy (l1 - l2) / (|l1| + |l2|) of the symmetric part of the tensor
+        float mean = 0.5 * (tensorVector.r + tensorVector.a);
+        float radius = length(vec2(0.5 * (tensorVector.r - tensorVector.a),
+                                   0.5 * (tensorVector.g + tensorVector.b)));
+        float anisotropy =
+            2.0 * radius / max(abs(mean + radius) + abs(mean - radius), 1.0e-12);
+        steps = max(1, int(float(steps) * mix(minKernelLength, 1.0, clamp(anisotropy, 0.0, 1.0))));
+    }
 
-    traverse(colorValue, c, newTexForTensorFieldSampling, stepLength, samples / 2);
-    traverse(colorValue, c, newTexForTensorFieldSampling, -stepLength, samples / 2);
+    traverse(colorValue, c, newTexForTensorFieldSampling, stepLength, steps);
+    traverse(colorValue, c, newTexForTensorFieldSampling, -stepLength, steps);
 
     colorValue /= c;
 
@@ -133,5 +152,10 @@ void main() {
         finalColor = finalColor * texture(imageInportColor, texCoord_.xy);
     }
 
+    if (frame > 0) {
+        finalColor =
+            mix(texture(previousFrameColor, texCoord_.xy), finalColor, 1.0 / float(frame + 1));
+    }
+
     FragData0 = finalColor;
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3dsequence.h>
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace inviwo {
+namespace tensorutil {
+
+/*
+ * Frobenius: Frobenius norm of the difference to the mean tensor.
+ * LogEuclidean: Frobenius norm of the difference of the matrix logarithms to the Log-Euclidean
+ * mean, only symmetric positive definite tensors are considered.
+ * EigenAngle: angle in radians between the major eigenvectors of the tensor and the mean tensor.
+ */
+enum class EnsembleDistance { Frobenius, LogEuclidean, EigenAngle };
+
+/*
+ * Per voxel statistics of the distances of the ensemble members to the ensemble mean.
+ */
+struct EnsembleStatistics {
+    size3_t dimensions{0};
+    mat4 basisAndOffset{1.0f};
+
+    std::vector<double> mean;
+    // Population variance
+    std::vector<double> variance;
+    // Deviation of the most distant member in standard deviations, zero where all members agree
+    std::vector<double> outlierScore;
+};
+
+/*
+ * Computes the statistics in two passes over the members of the ensemble, one for the mean
+ * tensors and one for the distances. The members are visited one at a time, so only the member
+ * being processed, the prefetch window of the sequence, and the per voxel accumulators are held
+ * in memory. Each member is processed in parallel over voxel ranges while the sequence loads the
+ * next members in the background. All members need the dimensions of the first one.
+ *
+ * Returns std::nullopt if stopped.
+ */
+IVW_MODULE_TENSORVISBASE_API std::optional<EnsembleStatistics> ensembleStatistics(
+    const TensorField3DSequence& ensemble, EnsembleDistance distance,
+    const std::function<bool()>& stop = nullptr,
+    const std::function<void(float)>& progress = nullptr);
+
+}  // namespace tensorutil
+}  // namespace inviwo
@@ -0,0 +1,67 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+
+#include <functional>
+#include <memory>
+
+namespace inviwo {
+namespace tensorutil {
+
+/*
+ * Settings of a synthetic, symmetric positive definite tensor field. The eigen frame twists
+ * around the z axis and tilts along x, the eigenvalues vary smoothly along y. Noise perturbs
+ * the frame and multiplies the eigenvalues by a factor in [1 - noise, 1 + noise].
+ */
+struct SyntheticTensorField3D {
+    size3_t dimensions{64};
+    vec3 extent{1.0f};
+    uint64_t seed{0};
+    double noise{0.0};
+    // Symmetric, SymmetricFloat and FullFloat generate straight into the storage of the field
+    TensorStorage storage{TensorStorage::Symmetric};
+    // Pass on the analytical eigen system so the field does not have to be decomposed
+    bool eigenSystem{true};
+};
+
+/*
+ * Generates the field in parallel, one z slice per task, writing straight into preallocated
+ * storage. Every slice has its own random engine seeded from the seed and the slice index, so
+ * the result only depends on the settings and not on the scheduling.
+ */
+IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField3D> generateTensorField3D(
+    const SyntheticTensorField3D& settings, std::function<void(float)> progress = nullptr);
+
+}  // namespace tensorutil
+}  // namespace inviwo
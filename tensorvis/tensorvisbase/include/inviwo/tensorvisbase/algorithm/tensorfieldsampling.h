@@ -34,6 +34,10 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 
+#include <array>
+#include <functional>
+#include <vector>
+
 namespace inviwo {
 namespace tensorutil {
 enum class InterpolationMethod { Linear, Nearest, Barycentric };
@@ -136,10 +140,9 @@ IVW_MODULE_TENSORVISBASE_API dmat2 sample(std::shared_ptr<const TensorField2D> t
  * the mask value return will always be 0.
  */
 template <tensorutil::InterpolationMethod method>
-std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorField,
-                                    const dvec3& position) {
+std::pair<glm::uint8, dmat3> sample(const TensorField3D& tensorField, const dvec3& position) {
     // Position is in texture space [0,1], translate to index space
-    const auto bounds = tensorField->getBounds<double>();
+    const auto bounds = tensorField.getBounds<double>();
     const auto indexPosition = position * bounds;
 
     dmat3 val{0.0};
@@ -158,23 +161,23 @@ std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorF
         const auto zFrac = glm::fract(position.z * bounds.z);
 
         // Upper layer
-        const auto& tensor010 = tensorField->at(size3_t(xm, yp, zm)).second;
-        const auto& tensor011 = tensorField->at(size3_t(xm, yp, zp)).second;
+        const auto& tensor010 = tensorField.at(size3_t(xm, yp, zm)).second;
+        const auto& tensor011 = tensorField.at(size3_t(xm, yp, zp)).second;
         const auto tensorUpperLeft = glm::mix(tensor010, tensor011, zFrac);
 
-        const auto& tensor111 = tensorField->at(size3_t(xp, yp, zp)).second;
-        const auto& tensor110 = tensorField->at(size3_t(xp, yp, zm)).second;
+        const auto& tensor111 = tensorField.at(size3_t(xp, yp, zp)).second;
+        const auto& tensor110 = tensorField.at(size3_t(xp, yp, zm)).second;
         const auto tensorUpperRight = glm::mix(tensor110, tensor111, zFrac);
 
         const auto tensorUpper = glm::mix(tensorUpperLeft, tensorUpperRight, xFrac);
 
         // Lower layer
-        const auto& tensor000 = tensorField->at(size3_t(xm, ym, zm)).second;
-        const auto& tensor001 = tensorField->at(size3_t(xm, ym, zp)).second;
+        const auto& tensor000 = tensorField.at(size3_t(xm, ym, zm)).second;
+        const auto& tensor001 = tensorField.at(size3_t(xm, ym, zp)).second;
         const auto tensorLowerLeft = glm::mix(tensor000, tensor001, zFrac);
 
-        const auto& tensor100 = tensorField->at(size3_t(xp, ym, zm)).second;
-        const auto& tensor101 = tensorField->at(size3_t(xp, ym, zp)).second;
+        const auto& tensor100 = tensorField.at(size3_t(xp, ym, zm)).second;
+        const auto& tensor101 = tensorField.at(size3_t(xp, ym, zp)).second;
         const auto tensorLowerRight = glm::mix(tensor100, tensor101, zFrac);
 
         const auto tensorLower = glm::mix(tensorLowerLeft, tensorLowerRight, xFrac);
@@ -182,12 +185,18 @@ std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorF
         val = glm::mix(tensorLower, tensorUpper, yFrac);
     } else {
         if constexpr (method == tensorutil::InterpolationMethod::Nearest) {
-            val = tensorField->at(size3_t(glm::round(indexPosition))).second;
+            val = tensorField.at(size3_t(glm::round(indexPosition))).second;
         }
     }
     return std::pair<glm::uint8, dmat3>(glm::uint8{1}, val);
 }
 
+template <tensorutil::InterpolationMethod method>
+std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorField,
+                                    const dvec3& position) {
+    return sample<method>(*tensorField, position);
+}
+
 /**
  * Returns a pair of a glm::uint8 and dmat3.
  * The dmat3 is the tensor. Since the field stores tensors at every position
@@ -199,4 +208,74 @@ std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorF
 IVW_MODULE_TENSORVISBASE_API std::pair<glm::uint8, dmat3> sample(
     std::shared_ptr<const TensorField3D> tensorField, const dvec3& position,
     const tensorutil::InterpolationMethod method);
+
+using TensorField3DSampleFunction = std::function<std::pair<glm::uint8, dmat3>(const dvec3&)>;
+
+/**
+ * Returns a functor sampling the tensor field at positions in texture space [0,1] with the given
+ * interpolation method. The method is dispatched once here instead of for every sample, and the
+ * functor keeps the tensor field alive so calls do not copy the shared_ptr. Use this in loops
+ * where the interpolation method is only known at runtime.
+ */
+IVW_MODULE_TENSORVISBASE_API TensorField3DSampleFunction
+makeSampleFunction(std::shared_ptr<const TensorField3D> tensorField,
+                   const tensorutil::InterpolationMethod method);
+
+/**
+ * \class TensorField3DSampler
+ * \brief Batched sampling of a TensorField3D at positions in texture space [0,1].
+ *
+ * Bounds, strides, and data pointers are set up once on construction so sampling many
+ * positions does not pay for shared_ptr copies, mask lookups, and index mapping per corner. Full,
+ * single precision, and packed symmetric tensor storage are sampled directly without expanding
+ * the field.
+ * Positions outside [0,1] are clamped to the border. InterpolationMethod::Nearest selects the
+ * closest voxel, all other methods use trilinear interpolation.
+ *
+ * The sampler keeps raw pointers into the tensor field, which has to outlive the sampler.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DSampler {
+public:
+    explicit TensorField3DSampler(
+        const TensorField3D& tensorField,
+        tensorutil::InterpolationMethod method = tensorutil::InterpolationMethod::Linear);
+
+    dmat3 sample(const dvec3& position) const;
+
+    /*
+     * Samples count positions and writes the tensors to result, which has to hold at least count
+     * elements.
+     */
+    void sample(const dvec3* positions, size_t count, dmat3* result) const;
+    std::vector<dmat3> sample(const std::vector<dvec3>& positions) const;
+
+    tensorutil::InterpolationMethod getInterpolationMethod() const { return method_; }
+
+private:
+    struct Corners {
+        std::array<size_t, 8> indices;
+        std::array<double, 8> weights;
+    };
+
+    size_t nearestIndex(const dvec3& position) const;
+    Corners corners(const dvec3& position) const;
+    dmat3 get(size_t index) const;
+    dmat3 interpolate(const Corners& corners) const;
+
+    template <typename T>
+    static dmat3 interpolatePacked(const std::array<const T*, 6>& components,
+                                   const Corners& corners);
+
+    tensorutil::InterpolationMethod method_;
+    size3_t dimensions_;
+    dvec3 bounds_;
+    size_t strideY_;
+    size_t strideZ_;
+
+    const dmat3* tensors_ = nullptr;
+    const mat3* floatTensors_ = nullptr;
+    std::array<const double*, 6> components_{};
+    std::array<const float*, 6> floatComponents_{};
+};
+
 }  // namespace inviwo
@@ -35,6 +35,10 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/geometry/geometrytype.h>
 
+#include <array>
+#include <list>
+#include <memory>
+
 namespace inviwo {
 namespace detail {
 IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField2D> getSlice2D(
@@ -55,4 +59,45 @@ auto slice(std::shared_ptr<const TensorField3D> inTensorField, const CartesianCo
         return detail::getSlice3D(inTensorField, axis, sliceNumber);
     }
 }
+
+/**
+ * Keeps the most recently extracted slices of a tensor field, per slicing axis, so that moving
+ * back and forth between slices does not extract them again. The cache follows a single tensor
+ * field and is cleared when slices of a different one are requested.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorFieldSliceCache {
+public:
+    /// capacity is the number of 2D and 3D slices kept per axis, 0 disables caching
+    explicit TensorFieldSliceCache(size_t capacity = 16);
+
+    std::shared_ptr<const TensorField2D> slice2D(std::shared_ptr<const TensorField3D> tensorField,
+                                                 const CartesianCoordinateAxis axis,
+                                                 const size_t sliceNumber);
+    std::shared_ptr<const TensorField3D> slice3D(std::shared_ptr<const TensorField3D> tensorField,
+                                                 const CartesianCoordinateAxis axis,
+                                                 const size_t sliceNumber);
+
+    size_t getCapacity() const { return capacity_; }
+    void setCapacity(size_t capacity);
+
+    void clear();
+
+private:
+    template <typename T>
+    struct Entry {
+        size_t sliceNumber;
+        std::shared_ptr<const T> field;
+    };
+
+    void setSource(const std::shared_ptr<const TensorField3D>& tensorField);
+
+    template <typename T, typename Create>
+    std::shared_ptr<const T> lookup(std::list<Entry<T>>& slices, size_t sliceNumber,
+                                    Create create);
+
+    size_t capacity_;
+    std::weak_ptr<const TensorField3D> source_;
+    std::array<std::list<Entry<TensorField2D>>, 3> slices2D_;
+    std::array<std::list<Entry<TensorField3D>>, 3> slices3D_;
+};
 }  // namespace inviwo
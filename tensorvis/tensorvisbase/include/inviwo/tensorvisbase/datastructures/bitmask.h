@@ -0,0 +1,155 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace inviwo {
+
+namespace bitmask {
+
+inline size_t popcount(std::uint64_t word) {
+#if defined(_MSC_VER)
+    return static_cast<size_t>(__popcnt64(word));
+#else
+    return static_cast<size_t>(__builtin_popcountll(word));
+#endif
+}
+
+// Index of the lowest set bit, word must not be zero
+inline size_t countTrailingZeros(std::uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<size_t>(index);
+#else
+    return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+}
+
+}  // namespace bitmask
+
+/**
+ * \brief Binary mask with one bit per voxel
+ *
+ * The bits are packed into 64 bit words, using an eighth of the memory of a byte per voxel.
+ * Counting, combining, and copying ranges of masks works on whole words, and iterating the set
+ * bits skips empty words. Bits beyond size() in the last word are always zero.
+ */
+class IVW_MODULE_TENSORVISBASE_API BitMask {
+public:
+    using Word = std::uint64_t;
+    static constexpr size_t wordBits = 64;
+
+    BitMask() = default;
+    explicit BitMask(size_t size, bool value = false);
+    /*
+     * Sets the bits of the non-zero entries of \p mask.
+     */
+    explicit BitMask(const std::vector<glm::uint8>& mask);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t sizeInBytes() const { return words_.size() * sizeof(Word); }
+
+    bool operator[](size_t i) const { return (words_[i / wordBits] >> (i % wordBits)) & Word{1}; }
+    void set(size_t i, bool value = true) {
+        const auto bit = Word{1} << (i % wordBits);
+        if (value) {
+            words_[i / wordBits] |= bit;
+        } else {
+            words_[i / wordBits] &= ~bit;
+        }
+    }
+
+    // Number of set bits
+    size_t count() const;
+    bool any() const;
+
+    /*
+     * Word-wise combination with a mask of the same size.
+     * @throw Exception if the sizes differ
+     */
+    BitMask& operator&=(const BitMask& rhs);
+    BitMask& operator|=(const BitMask& rhs);
+    // Clears the bits set in rhs
+    BitMask& subtract(const BitMask& rhs);
+    BitMask& flip();
+
+    /*
+     * Copies the \p count bits of \p src starting at \p srcFirst to the bits starting at
+     * \p first, a word at a time.
+     */
+    void copyBits(const BitMask& src, size_t srcFirst, size_t first, size_t count);
+
+    /*
+     * Calls f(index) for each set bit in increasing order.
+     */
+    template <typename F>
+    void forEachSetBit(F&& f) const {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            for (auto word = words_[w]; word != 0; word &= word - 1) {
+                f(w * wordBits + bitmask::countTrailingZeros(word));
+            }
+        }
+    }
+    std::vector<size_t> setIndices() const;
+    // One byte per bit, 1 for set bits
+    std::vector<glm::uint8> toBytes() const;
+    // The bits packed into 32 bit words, bit i in bit i % 32 of word i / 32, e.g. for shaders
+    std::vector<std::uint32_t> toWords32() const;
+
+    const std::vector<Word>& words() const { return words_; }
+
+    friend bool operator==(const BitMask& a, const BitMask& b) {
+        return a.size_ == b.size_ && a.words_ == b.words_;
+    }
+    friend bool operator!=(const BitMask& a, const BitMask& b) { return !(a == b); }
+
+private:
+    // Bits of the word starting at bit index first, may straddle two words
+    Word wordAt(size_t first) const;
+    void clearPadding();
+
+    size_t size_{0};
+    std::vector<Word> words_;
+};
+
+IVW_MODULE_TENSORVISBASE_API BitMask operator&(BitMask a, const BitMask& b);
+IVW_MODULE_TENSORVISBASE_API BitMask operator|(BitMask a, const BitMask& b);
+
+}  // namespace inviwo
@@ -3,6 +3,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/tensorvisbase/datastructures/glyphtopology.h>
 #include <functional>
 
 namespace inviwo {
@@ -23,11 +24,19 @@ public:
     void transform(const vec3& pos, const vec3& scale);
     std::shared_ptr<BasicMesh> getGeometry();
 
+    /*
+     * Undeformed unit cube, shared between all cubes
+     */
+    static std::shared_ptr<const GlyphTopology> topology();
+
 private:
-    std::vector<size3_t> faces_;
-    std::shared_ptr<BasicMesh> mesh_;
+    std::shared_ptr<const GlyphTopology> topology_;
+    std::vector<vec3> vertices_;
+    std::vector<vec3> normals_;
+    std::vector<vec4> colors_;
+    mat4 worldMatrix_{1.0f};
 
-    void createCube(const vec4& color);
+    static std::shared_ptr<const GlyphTopology> createCube();
     void calculateNormals();
 };
 
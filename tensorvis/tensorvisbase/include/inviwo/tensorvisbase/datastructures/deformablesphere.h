@@ -33,6 +33,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/tensorvisbase/datastructures/glyphtopology.h>
 #include <functional>
 
 namespace inviwo {
@@ -53,11 +54,21 @@ public:
     void transform(const vec3& pos, const vec3& scale);
     std::shared_ptr<BasicMesh> getGeometry();
 
+    /*
+     * Undeformed unit sphere, generated once per resolution and shared between all spheres
+     */
+    static std::shared_ptr<const GlyphTopology> topology(const size_t& numTheta,
+                                                         const size_t& numPhi);
+
 private:
-    std::vector<size3_t> faces_;
-    std::shared_ptr<BasicMesh> mesh_;
+    std::shared_ptr<const GlyphTopology> topology_;
+    std::vector<vec3> vertices_;
+    std::vector<vec3> normals_;
+    std::vector<vec4> colors_;
+    mat4 worldMatrix_{1.0f};
 
-    void createSphere(const size_t& numTheta, const size_t& numPhi, const vec4& color);
+    static std::shared_ptr<const GlyphTopology> createSphere(const size_t& numTheta,
+                                                             const size_t& numPhi);
     void calculateNormals();
 };
 
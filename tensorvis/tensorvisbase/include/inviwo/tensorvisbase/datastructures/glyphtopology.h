@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/basicmesh.h>
+
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Undeformed template of a deformable glyph
+ *
+ * The triangles of a glyph only depend on its kind and resolution. The Deformable* glyphs
+ * generate a topology once per resolution and share it, including its index buffer, between
+ * all glyph meshes they create.
+ */
+struct IVW_MODULE_TENSORVISBASE_API GlyphTopology {
+    // How the normals accumulated from the face normals are oriented
+    enum class NormalOrientation { AwayFromCenter, Reversed };
+
+    std::vector<vec3> vertices;  // centered at the origin
+    std::vector<vec3> texCoords;
+    std::vector<size3_t> faces;
+    NormalOrientation orientation{NormalOrientation::AwayFromCenter};
+    // Triangle list of the faces, shared by all meshes created from this topology
+    std::shared_ptr<IndexBuffer> indices;
+
+    size_t numVertices() const { return vertices.size(); }
+
+    /*
+     * Creates the index buffer from faces, needs to be called once the faces are complete.
+     */
+    void finalize();
+
+    /*
+     * Computes area weighted vertex normals of the deformed vertices of one glyph. Normals
+     * oriented away from the center are flipped towards the outside of the glyph.
+     */
+    void computeNormals(const vec3* vertices, vec3* normals, const vec3& center = vec3(0.f)) const;
+
+    /*
+     * Creates a mesh for one glyph from its deformed vertex data, the index buffer of the mesh
+     * is the shared one of this topology.
+     */
+    std::shared_ptr<BasicMesh> createMesh(std::vector<vec3> vertices, std::vector<vec3> normals,
+                                          std::vector<vec4> colors) const;
+};
+
+}  // namespace inviwo
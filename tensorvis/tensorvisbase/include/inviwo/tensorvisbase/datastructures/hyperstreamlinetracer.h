@@ -4,8 +4,14 @@
 #include <inviwo/core/common/inviwo.h>
 #include <modules/vectorfieldvisualization/datastructures/integralline.h>
 #include <modules/vectorfieldvisualization/properties/integrallineproperties.h>
+#include <inviwo/tensorvisbase/datastructures/packedlineset.h>
+#include <inviwo/tensorvisbase/datastructures/lineoccupancygrid.h>
 #include <inviwo/core/util/spatialsampler.h>
 
+#include <array>
+#include <cmath>
+#include <limits>
+
 namespace inviwo {
 
 namespace detail {
@@ -70,6 +76,87 @@ std::tuple<SpatialVector, DataVector, bool> hyperstep(const SpatialVector &oldPo
 
     return {move(oldPos, K, stepSize), k1, flipped};
 }
+
+template <typename SpatialVector, typename DataVector>
+struct AdaptiveHyperStep {
+    SpatialVector position;
+    DataVector velocity;   // oriented sample at the start of the step
+    DataVector direction;  // oriented direction of the step, reference for the next step
+    double stepSize;       // signed step size taken
+    double nextStepSize;   // signed step size proposed for the next step
+};
+
+/*
+ * Dormand-Prince 5(4) step with error control. All stages are oriented towards the reference
+ * direction of the previous step, since eigenvectors have no sign. The local error is measured as
+ * the difference between the 5th and 4th order displacement. A step is retried with a smaller step
+ * size until the error is below the tolerance or the minimum step size is reached.
+ */
+template <typename SpatialVector, typename DataVector, typename Sampler, typename DataMatrix>
+AdaptiveHyperStep<SpatialVector, DataVector> adaptiveHyperstep(
+    const SpatialVector &oldPos, double stepSize, double tolerance, double minStepSize,
+    double maxStepSize, const DataMatrix &invBasis, bool normalizeSamples, const Sampler &sampler,
+    const DataVector &reference) {
+
+    static constexpr double c[7][6] = {
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0},
+        {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0},
+        {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0},
+        {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0},
+        {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}};
+    // 5th order weights are the last row of c, e holds the difference to the 4th order weights
+    static constexpr double e[7] = {71.0 / 57600.0,      0.0, -71.0 / 16695.0, 71.0 / 1920.0,
+                                    -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0};
+
+    const auto orient = [&](DataVector v, const DataVector &ref) {
+        if (normalizeSamples) {
+            const auto l = glm::length(v);
+            if (l > 0.0) v /= l;
+        }
+        return glm::dot(v, ref) < 0.0 ? -v : v;
+    };
+
+    const double sign = stepSize < 0.0 ? -1.0 : 1.0;
+    double h = glm::clamp(std::abs(stepSize), minStepSize, maxStepSize);
+
+    std::array<DataVector, 7> k;
+    k[0] = orient(sampler.sample(oldPos), reference);
+    const DataVector ref = glm::length(k[0]) > 0.0 ? k[0] : reference;
+
+    for (;;) {
+        const double sh = sign * h;
+        for (size_t i = 1; i < 7; ++i) {
+            DataVector offset{0.0};
+            for (size_t j = 0; j < i; ++j) offset += c[i][j] * k[j];
+            k[i] = orient(sampler.sample(oldPos + invBasis * (offset * sh)), ref);
+        }
+
+        // The 7th stage is evaluated at the 5th order solution (first same as last)
+        DataVector error{0.0};
+        for (size_t i = 0; i < 7; ++i) error += e[i] * k[i];
+        const double err = glm::length(error) * h;
+
+        if (err <= tolerance || h <= minStepSize) {
+            DataVector displacement{0.0};
+            for (size_t j = 0; j < 6; ++j) displacement += c[6][j] * k[j];
+
+            const double scale =
+                err > 0.0 ? glm::clamp(0.9 * std::pow(tolerance / err, 0.2), 0.2, 5.0) : 5.0;
+            return {oldPos + invBasis * (displacement * sh), k[0], displacement, sh,
+                    sign * glm::clamp(h * scale, minStepSize, maxStepSize)};
+        }
+
+        if (!std::isfinite(err)) {
+            h = minStepSize;
+        } else {
+            h = std::max(minStepSize,
+                         h * glm::clamp(0.9 * std::pow(tolerance / err, 0.25), 0.1, 1.0));
+        }
+    }
+}
+
 }  // namespace detail
 
 class IVW_MODULE_TENSORVISBASE_API HyperStreamLineTracer {
@@ -91,11 +178,31 @@ public:
     using DataHomogenouSpatialMatrixrix =
         Matrix<SpatialSampler<3, 3, double>::DataDimensions + 1, double>;
 
+    /*
+     * Settings for adaptive step size integration. When enabled the step size of the integral
+     * line properties is only used as initial step size, the number of steps is an upper bound,
+     * and lines are also terminated once they reach maxArcLength in each direction.
+     */
+    struct AdaptiveStepping {
+        bool enabled{false};
+        double tolerance{1e-4};
+        double minStepSize{1e-5};
+        double maxStepSize{0.1};
+        double maxArcLength{std::numeric_limits<double>::infinity()};
+    };
+
     HyperStreamLineTracer(std::shared_ptr<const SpatialSampler<3, 3, double>> sampler,
                           const IntegralLineProperties &properties);
 
     Result traceFrom(const SpatialVector &pIn);
 
+    /*
+     * Traces the line from \p pIn and appends it to \p lines, whose positions and metadata
+     * channels grow with every line instead of being allocated per line. Lines with fewer than
+     * two vertices are discarded. Returns true if the line was added.
+     */
+    bool traceInto(const SpatialVector &pIn, size_t seedID, PackedLineSet &lines);
+
     void addMetaDataSampler(const std::string &name,
                             std::shared_ptr<const SpatialSampler<3, 3, double>> sampler);
 
@@ -104,12 +211,69 @@ public:
     void setTransformOutputToWorldSpace(bool transform);
     bool isTransformingOutputToWorldSpace() const;
 
+    void setAdaptiveStepping(const AdaptiveStepping &adaptive);
+    const AdaptiveStepping &getAdaptiveStepping() const;
+
+    /*
+     * Enables evenly spaced tracing in data space. Seeds closer than the separation of
+     * \p occupancy to an already traced line are skipped, and lines are terminated once they come
+     * closer than \p testRatio times the separation to another line. Traced lines insert a sample
+     * into \p occupancy every half separation. The grid may be shared by tracers on several
+     * threads, which makes the result depend on the order the lines are traced in.
+     * Pass nullptr to trace all seeds in full again.
+     */
+    void setOccupancy(std::shared_ptr<LineOccupancyGrid> occupancy, double testRatio = 0.5);
+    const std::shared_ptr<LineOccupancyGrid> &getOccupancy() const;
+
 private:
-    bool addPoint(IntegralLine &line, const SpatialVector &pos);
-    bool addPoint(IntegralLine &line, const SpatialVector &pos, const DataVector &worldVelocity);
+    /*
+     * Positions and metadata vectors of the line being traced, looked up once per line instead
+     * of once per step.
+     */
+    struct LineBuffers {
+        LineBuffers(IntegralLine &line,
+                    const std::unordered_map<std::string,
+                                             std::shared_ptr<const SpatialSampler<3, 3, double>>>
+                        &metaSamplers,
+                    size_t capacity);
+        // Appends to the channels of lines, which are not reserved to keep their growth amortized
+        LineBuffers(PackedLineSet &lines,
+                    const std::unordered_map<std::string,
+                                             std::shared_ptr<const SpatialSampler<3, 3, double>>>
+                        &metaSamplers);
+
+        /*
+         * Reverses the vertices [begin, end) of all channels.
+         */
+        void reverse(size_t begin);
+
+        std::vector<dvec3> &positions;
+        std::vector<dvec3> &velocities;
+        std::vector<std::pair<const SpatialSampler<3, 3, double> *, std::vector<dvec3> *>> meta;
+
+        // Tag of the line in the occupancy grid and the last sample inserted into it
+        uint32_t occupancyTag{0};
+        dvec3 lastOccupied{0.0};
+    };
+
+    /*
+     * Traces backward and forward from \p pIn, appending the vertices of the line after index
+     * \p begin of the buffers. The seed ID of the returned info is not set.
+     */
+    PackedLineSet::LineInfo trace(const SpatialVector &pIn, LineBuffers &buffers, size_t begin);
+
+    bool addPoint(LineBuffers &line, const SpatialVector &pos);
+    /*
+     * Returns true if \p pos is too close to another line in the occupancy grid, otherwise
+     * inserts \p pos into the grid if it is far enough from the last inserted sample.
+     */
+    bool occupy(LineBuffers &line, const SpatialVector &pos);
+    bool addPoint(LineBuffers &line, const SpatialVector &pos, const DataVector &worldVelocity);
 
-    IntegralLine::TerminationReason integrate(size_t steps, SpatialVector pos, IntegralLine &line,
+    IntegralLine::TerminationReason integrate(size_t steps, SpatialVector pos, LineBuffers &line,
                                               bool fwd);
+    IntegralLine::TerminationReason integrateAdaptive(size_t steps, SpatialVector pos,
+                                                      LineBuffers &line, bool fwd);
 
     IntegralLineProperties::IntegrationScheme integrationScheme_;
 
@@ -126,6 +290,9 @@ private:
     DataHomogenouSpatialMatrixrix seedTransformation_;
     DataHomogenouSpatialMatrixrix toWorld_;
     bool transformOutputToWorldSpace_;
+    AdaptiveStepping adaptive_;
+    std::shared_ptr<LineOccupancyGrid> occupancy_;
+    double occupancyTestRatio_{0.5};
 };
 
 }  // namespace inviwo
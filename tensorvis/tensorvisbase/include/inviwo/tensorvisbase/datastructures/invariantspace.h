@@ -6,9 +6,21 @@
 #include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 
+#include <memory>
+#include <type_traits>
+
 namespace inviwo {
 using InvariantSpaceAxis = std::vector<glm::f64>;
+/**
+ * Column store of invariants, one axis per invariant. Axes are shared, immutable columns: when the
+ * axis is added from tensor field meta data the column is a non-owning view onto the meta data
+ * buffer that keeps the tensor field alive, and copying an invariant space or adding the axes of
+ * another one shares the columns. Columns are copied on write by addPoint and
+ * setNumberOfElements only.
+ */
 struct IVW_MODULE_TENSORVISBASE_API InvariantSpace {
+    using Column = std::shared_ptr<const InvariantSpaceAxis>;
+
     InvariantSpace() = default;
     InvariantSpace(size_t numberOfDimensions, const std::vector<std::string>& identifiers,
                    const std::vector<TensorFeature>& metaDataTypes);
@@ -22,131 +34,72 @@ struct IVW_MODULE_TENSORVISBASE_API InvariantSpace {
         else
             return data_[0]->size();
     }
-    void addAxis(const std::string& identifier, std::vector<double>* data, TensorFeature type) {
-        identifiers_.push_back(identifier);
-        metaDataTypes_.push_back(type);
 
-        auto minmax = std::minmax_element(data->begin(), data->end());
+    /// Adds a shared column, the data is not copied.
+    void addAxis(const std::string& identifier, Column data, TensorFeature type);
 
-        minmax_.push_back({*minmax.first, *minmax.second});
-
-        data_.push_back(data);
-    }
+    void addAxis(const std::string& identifier, InvariantSpaceAxis data, TensorFeature type);
 
+    /**
+     * Adds the meta data as an axis. For double meta data the column is a view onto the meta data
+     * buffer and keeps owner, usually the tensor field holding the meta data, alive.
+     */
     template <typename T>
-    void addAxis(const MetaDataType<T>* metaData, const std::string& name = "") {
+    void addAxis(std::shared_ptr<const void> owner, const MetaDataType<T>* metaData,
+                 const std::string& name = "") {
         identifiers_.push_back(name.empty() ? metaData->getDisplayName() : name);
         metaDataTypes_.push_back(metaData->type_);
-        minmax_.push_back({{metaData->getMinMax().first, metaData->getMinMax().second}});
-
-        data_.push_back(new std::vector<T>(metaData->getData()));
-    }
-
-    void addAxes(const InvariantSpace& invariantSpace) {
-        for (int i = 0; i < invariantSpace.getNumberOfDimensions(); ++i) {
-            identifiers_.push_back(invariantSpace.identifiers_[i]);
-            metaDataTypes_.push_back(invariantSpace.metaDataTypes_[i]);
-            minmax_.push_back(invariantSpace.minmax_[i]);
-
-            data_.push_back(new std::vector<double>(invariantSpace.data_[i]->begin(),
-                                                    invariantSpace.data_[i]->end()));
+        minmax_.push_back({{static_cast<double>(metaData->getMinMax().first),
+                            static_cast<double>(metaData->getMinMax().second)}});
+
+        if constexpr (std::is_same_v<T, glm::f64>) {
+            data_.push_back(Column(std::move(owner), &metaData->getData()));
+        } else {
+            const auto& src = metaData->getData();
+            data_.push_back(std::make_shared<InvariantSpaceAxis>(src.begin(), src.end()));
         }
+        owned_.push_back(nullptr);
     }
 
-    void addAxes(std::shared_ptr<const InvariantSpace> invariantSpace) {
-        for (int i = 0; i < invariantSpace->getNumberOfDimensions(); ++i) {
-            identifiers_.push_back(invariantSpace->identifiers_[i]);
-            metaDataTypes_.push_back(invariantSpace->metaDataTypes_[i]);
-            minmax_.push_back(invariantSpace->minmax_[i]);
+    /// Adds all axes of invariantSpace, the columns are shared.
+    void addAxes(const InvariantSpace& invariantSpace);
+    void addAxes(std::shared_ptr<const InvariantSpace> invariantSpace);
 
-            data_.push_back(new std::vector<double>(invariantSpace->data_[i]->begin(),
-                                                    invariantSpace->data_[i]->end()));
-        }
-    }
+    void addPoint(const std::vector<double>& v);
 
-    void addPoint(const std::vector<double>& v) {
-        if (v.size() != data_.size()) {
-            LogError("Tried to add feature of wrong dimensionality ("
-                     << std::to_string(v.size()) << " instead of " << std::to_string(data_.size())
-                     << ")");
-            return;
-        }
-        size_t i = 0;
-        for (const auto val : v) {
-            data_[i]->push_back(val);
+    /// Returns the value of axis at row idx
+    double get(size_t axis, size_t idx) const { return (*data_[axis])[idx]; }
 
-            // update minmax
-            minmax_[i][0] = std::min(minmax_[i][0], val);
-            minmax_[i][1] = std::max(minmax_[i][1], val);
+    /// Writes row idx into point, reusing its storage
+    void getPoint(size_t idx, std::vector<double>& point) const;
 
-            i++;
-        }
-    }
+    std::vector<double> getPoint(size_t idx) const;
 
-    std::vector<double> getPoint(size_t idx) const {
-        std::vector<double> feature;
+    std::vector<double> flatten() const;
 
-        if (!data_.size()) return feature;
-        if (!getNumElements()) return feature;
+    /**
+     * Returns a new invariant space holding the given rows, in the order given. Only the selected
+     * rows are copied.
+     */
+    std::shared_ptr<InvariantSpace> select(const std::vector<size_t>& indices) const;
 
-        for (size_t j = 0; j < getNumberOfDimensions(); j++) {
-            feature.push_back((*(data_[j]))[idx]);
-        }
+    void clear();
 
-        return feature;
-    }
+    void setNumberOfDimensions(size_t n);
 
-    std::vector<double> flatten() const {
-        std::vector<double> flattened;
+    void setNumberOfElements(size_t n);
 
-        if (!data_.size()) return flattened;
-        if (!getNumElements()) return flattened;
+    const InvariantSpaceAxis& operator[](size_t idx) const { return *data_[idx]; }
 
-        for (size_t i = 0; i < getNumElements(); i++) {
-            for (size_t j = 0; j < getNumberOfDimensions(); j++) {
-                flattened.push_back((*(data_[j]))[i]);
-            }
-        }
-
-        return flattened;
-    }
-
-    void clear() { data_.clear(); }
-
-    void setNumberOfDimensions(size_t n) {
-        if (data_.size() > n) {
-            LogError("Reduction of dimensionality would mean loss of data. Aborting");
-        }
-
-        data_.resize(n);
-        for (auto& entry : data_) {
-            entry = new InvariantSpaceAxis();
-        }
-    }
-
-    void setNumberOfElements(size_t n) {
-        for (auto axis : data_) {
-            axis->resize(n);
-        }
-    }
-
-    const std::vector<double>& operator[](size_t idx) const { return *data_[idx]; }
-
-    const std::vector<double>& operator[](int idx) const { return *data_[idx]; }
-
-    /// \returns the begin iterator
-    std::vector<std::vector<double>*>::iterator begin() { return data_.begin(); }
+    const InvariantSpaceAxis& operator[](int idx) const { return *data_[idx]; }
 
     /// \returns the begin const iterator
-    std::vector<std::vector<double>*>::const_iterator begin() const { return data_.cbegin(); }
-
-    /// \returns the end iterator
-    std::vector<std::vector<double>*>::iterator end() { return data_.end(); }
+    std::vector<Column>::const_iterator begin() const { return data_.cbegin(); }
 
     /// \returns the end const iterator
-    std::vector<std::vector<double>*>::const_iterator end() const { return data_.cend(); }
+    std::vector<Column>::const_iterator end() const { return data_.cend(); }
 
-    const std::vector<InvariantSpaceAxis*>& data() const { return data_; }
+    const std::vector<Column>& data() const { return data_; }
 
     const auto& getIdentifier(size_t index) const { return identifiers_[index]; }
     const auto& getIdentifiers() const { return identifiers_; }
@@ -160,7 +113,15 @@ struct IVW_MODULE_TENSORVISBASE_API InvariantSpace {
     std::string getDataInfo() const;
 
 private:
-    std::vector<InvariantSpaceAxis*> data_;
+    /*
+     * Returns a column that is safe to modify, copying the column if it is a view or shared with
+     * another invariant space.
+     */
+    InvariantSpaceAxis& editableAxis(size_t index);
+
+    std::vector<Column> data_;
+    // Writable handle to columns allocated by an invariant space, null for views
+    std::vector<std::shared_ptr<InvariantSpaceAxis>> owned_;
     std::vector<std::string> identifiers_;
     std::vector<TensorFeature> metaDataTypes_;
     std::vector<std::array<glm::f64, 2>> minmax_;
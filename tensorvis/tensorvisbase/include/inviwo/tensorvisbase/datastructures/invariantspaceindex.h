@@ -0,0 +1,85 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/datastructures/invariantspace.h>
+
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * Index over the axes of an InvariantSpace answering range queries without scanning all rows.
+ * For every axis it stores the permutation sorting the rows by their value along that axis, built
+ * once in parallel. A range on an axis maps to a contiguous span of its permutation, found by
+ * binary search. A multi-dimensional query walks the narrowest span only and tests the remaining
+ * axes row by row, so its cost is proportional to the number of rows inside the most selective
+ * range.
+ *
+ * The index shares the columns of the invariant space it was built from and stays valid when the
+ * invariant space is destroyed.
+ */
+class IVW_MODULE_TENSORVISBASE_API InvariantSpaceIndex {
+public:
+    /// Selected rows, one flag per row
+    using Selection = std::vector<bool>;
+
+    explicit InvariantSpaceIndex(const InvariantSpace& invariantSpace);
+
+    size_t getNumberOfDimensions() const { return columns_.size(); }
+    size_t getNumElements() const { return numElements_; }
+
+    /// Number of rows with range.x <= value <= range.y along axis
+    size_t count(size_t axis, dvec2 range) const;
+
+    /// Rows inside all ranges, one inclusive range per axis
+    Selection query(const std::vector<dvec2>& ranges) const;
+
+    /**
+     * Updates selection, the result of a query with previousRanges, to the result of a query with
+     * ranges. When a single axis changed, as when dragging a brush, only the rows between the old
+     * and the new bounds on that axis are visited. Otherwise the query is run from scratch.
+     */
+    void update(Selection& selection, const std::vector<dvec2>& previousRanges,
+                const std::vector<dvec2>& ranges) const;
+
+private:
+    // [first, last) of the rows of axis inside range, in the sort order of that axis
+    std::pair<size_t, size_t> span(size_t axis, dvec2 range) const;
+    bool contains(size_t row, const std::vector<dvec2>& ranges, size_t skipAxis) const;
+
+    size_t numElements_;
+    std::vector<InvariantSpace::Column> columns_;
+    std::vector<std::vector<glm::u32>> order_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,105 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace inviwo {
+
+/**
+ * \brief Uniform grid of line samples for evenly spaced line placement
+ *
+ * Stores samples of already traced lines in a uniform grid with a cell size equal to the
+ * separation distance, so that all samples closer than the separation to a position are found in
+ * the 27 cells around it, see Jobard and Lefer, "Creating Evenly-Spaced Streamlines of Arbitrary
+ * Density", 1997. Tracers query the grid to skip seeds in occupied regions and to terminate lines
+ * that come too close to other lines.
+ *
+ * Every cell holds at most slotsPerCell samples in fixed storage. Samples are inserted without
+ * locks and concurrently with queries: a slot is claimed with an atomic counter and published by
+ * storing the tag of its line last. Samples inserted into a full cell are dropped, which only
+ * happens if lines are spaced much denser than the separation.
+ */
+class IVW_MODULE_TENSORVISBASE_API LineOccupancyGrid {
+public:
+    static constexpr size_t slotsPerCell = 8;
+    static constexpr size_t maxCells = size_t{1} << 21;
+
+    /*
+     * Creates a grid covering [\p lower, \p upper] with cells of size \p separation. Throws an
+     * Exception if the separation is not positive or the grid would exceed maxCells cells.
+     */
+    LineOccupancyGrid(const dvec3& lower, const dvec3& upper, double separation);
+
+    double getSeparation() const { return separation_; }
+    size3_t getDimensions() const { return dims_; }
+
+    /*
+     * Returns a new tag to mark the samples of one line with, tags are never zero.
+     */
+    uint32_t newLineTag();
+
+    /*
+     * Inserts a sample at \p pos belonging to the line \p tag. Samples outside of the grid are
+     * ignored. Returns false if the sample was dropped.
+     */
+    bool insert(const dvec3& pos, uint32_t tag);
+
+    /*
+     * Returns true if any sample closer than \p distance to \p pos exists, ignoring samples of
+     * the line \p tag. A \p distance larger than the separation is clamped to the separation.
+     */
+    bool isOccupied(const dvec3& pos, double distance, uint32_t tag = 0) const;
+
+private:
+    struct Slot {
+        std::array<float, 3> pos;
+        std::atomic<uint32_t> tag{0};  // zero until the position is written
+    };
+    struct Cell {
+        std::atomic<uint32_t> count{0};
+        std::array<Slot, slotsPerCell> slots;
+    };
+
+    size3_t cellIndex(const dvec3& pos) const;
+
+    dvec3 lower_;
+    double separation_;
+    size3_t dims_;
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<uint32_t> nextTag_{1};
+};
+
+}  // namespace inviwo
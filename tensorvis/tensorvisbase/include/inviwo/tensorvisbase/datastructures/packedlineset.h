@@ -0,0 +1,134 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <modules/vectorfieldvisualization/datastructures/integralline.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \brief Integral lines stored in one buffer per channel
+ *
+ * The positions of all lines are stored back to back in one vector, as is every metadata
+ * channel, e.g. "velocity". Line i occupies the vertices [getOffsets()[i], getOffsets()[i + 1]).
+ * Compared to an IntegralLineSet, which allocates a positions vector and a map of metadata
+ * vectors per line, tracing millions of lines only grows a few vectors, and the lines can be
+ * traversed linearly or uploaded to the GPU as a single buffer.
+ *
+ * Lines are added by appending vertices to all channels and then calling commitLine, or
+ * discardLine to drop them again. Tracers fill one set per thread and the sets are joined with
+ * append afterwards.
+ */
+class IVW_MODULE_TENSORVISBASE_API PackedLineSet {
+public:
+    struct LineInfo {
+        size_t seedID{0};     // index of the seed the line was traced from
+        size_t seedIndex{0};  // index of the seed vertex within the line
+        IntegralLine::TerminationReason backward{IntegralLine::TerminationReason::StartPoint};
+        IntegralLine::TerminationReason forward{IntegralLine::TerminationReason::StartPoint};
+    };
+
+    PackedLineSet(const mat4& modelMatrix = mat4(1.0f), const mat4& worldMatrix = mat4(1.0f));
+
+    size_t size() const { return lines_.size(); }
+    bool empty() const { return lines_.empty(); }
+    size_t getNumberOfVertices() const { return positions_.size(); }
+
+    /*
+     * Offsets of the first vertex of each line, followed by the total number of vertices of all
+     * committed lines, i.e. size() + 1 entries.
+     */
+    const std::vector<size_t>& getOffsets() const { return offsets_; }
+    const std::vector<LineInfo>& getLineInfos() const { return lines_; }
+
+    std::vector<dvec3>& getPositions() { return positions_; }
+    const std::vector<dvec3>& getPositions() const { return positions_; }
+
+    bool hasMetaData(const std::string& name) const;
+    /*
+     * Returns the metadata channel \p name, which is created if \p create is true and it does
+     * not exist yet. Throws an Exception if the channel does not exist otherwise.
+     */
+    std::vector<dvec3>& getMetaData(const std::string& name, bool create = false);
+    const std::vector<dvec3>& getMetaData(const std::string& name) const;
+    const std::map<std::string, std::vector<dvec3>>& getAllMetaData() const { return metaData_; }
+
+    /*
+     * Index of the first vertex of the line being added, i.e. of the first uncommitted vertex.
+     */
+    size_t getLineBegin() const { return offsets_.back(); }
+    /*
+     * Makes the vertices appended since the last commit a line. All channels need to hold the
+     * same number of vertices.
+     */
+    void commitLine(const LineInfo& info);
+    /*
+     * Removes the vertices appended since the last commit from all channels.
+     */
+    void discardLine();
+
+    /*
+     * Appends the lines of \p other, which needs to have the same metadata channels unless
+     * either set is empty.
+     */
+    void append(PackedLineSet&& other);
+
+    const mat4& getModelMatrix() const { return modelMatrix_; }
+    const mat4& getWorldMatrix() const { return worldMatrix_; }
+
+    /*
+     * Copies the lines into an IntegralLineSet, using the seed IDs as line indices.
+     */
+    std::shared_ptr<IntegralLineSet> toIntegralLineSet() const;
+    /*
+     * Creates a line mesh with a single position buffer holding the vertices of all lines, and
+     * an index buffer of line segments.
+     */
+    std::shared_ptr<Mesh> toMesh() const;
+
+private:
+    mat4 modelMatrix_;
+    mat4 worldMatrix_;
+    std::vector<dvec3> positions_;
+    std::map<std::string, std::vector<dvec3>> metaData_;
+    std::vector<size_t> offsets_;
+    std::vector<LineInfo> lines_;
+};
+
+}  // namespace inviwo
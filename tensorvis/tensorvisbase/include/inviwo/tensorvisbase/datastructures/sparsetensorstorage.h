@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/tensorvisbase/datastructures/bitmask.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class SparseTensorStorage3D
+ * \brief Compact storage of the tensors of the voxels defined by a binary mask.
+ *
+ * Only the tensors of the defined voxels are stored, together with the sorted list of their
+ * voxel indices. Tensors of undefined voxels are zero. Iterating the defined voxels through
+ * indices() and values() needs no lookup, random access through get() is a binary search.
+ */
+class SparseTensorStorage3D {
+public:
+    SparseTensorStorage3D() = default;
+    /*
+     * Keeps the tensors of the voxels with a non-zero mask value.
+     */
+    SparseTensorStorage3D(const std::vector<dmat3>& tensors, const std::vector<glm::uint8>& mask)
+        : size_{tensors.size()} {
+        for (size_t i = 0; i < mask.size(); ++i) {
+            if (mask[i]) indices_.push_back(i);
+        }
+        values_.reserve(indices_.size());
+        for (const auto i : indices_) values_.push_back(tensors[i]);
+    }
+    /*
+     * Keeps the tensors of the voxels with a set bit in the mask.
+     */
+    SparseTensorStorage3D(const std::vector<dmat3>& tensors, const BitMask& mask)
+        : size_{tensors.size()}, indices_{mask.setIndices()} {
+        values_.reserve(indices_.size());
+        for (const auto i : indices_) values_.push_back(tensors[i]);
+    }
+
+    // Number of voxels, defined or not
+    size_t size() const { return size_; }
+    size_t numDefined() const { return indices_.size(); }
+    size_t sizeInBytes() const { return indices_.size() * (sizeof(size_t) + sizeof(dmat3)); }
+
+    dmat3 get(size_t index) const {
+        const auto it = std::lower_bound(indices_.begin(), indices_.end(), index);
+        if (it == indices_.end() || *it != index) return dmat3(0.0);
+        return values_[static_cast<size_t>(it - indices_.begin())];
+    }
+
+    std::vector<dmat3> toTensors() const {
+        std::vector<dmat3> tensors(size_, dmat3(0.0));
+        for (size_t i = 0; i < indices_.size(); ++i) {
+            tensors[indices_[i]] = values_[i];
+        }
+        return tensors;
+    }
+
+    // Sorted voxel indices of the defined voxels
+    const std::vector<size_t>& indices() const { return indices_; }
+    // Tensors of the defined voxels, in the order of indices()
+    const std::vector<dmat3>& values() const { return values_; }
+
+private:
+    size_t size_{0};
+    std::vector<size_t> indices_;
+    std::vector<dmat3> values_;
+};
+
+}  // namespace inviwo
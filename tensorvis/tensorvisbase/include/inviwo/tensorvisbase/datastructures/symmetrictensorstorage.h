@@ -0,0 +1,200 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+
+#include <array>
+#include <vector>
+
+namespace inviwo {
+
+/*
+ * Storage modes of the tensors in TensorField2D and TensorField3D.
+ * Full: one glm matrix in double precision per tensor.
+ * Symmetric: packed unique components of symmetric tensors in double precision.
+ * SymmetricFloat: packed unique components of symmetric tensors in float precision.
+ * Sparse: only the tensors of the voxels defined by the mask, in double precision. TensorField3D
+ * only, see SparseTensorStorage3D.
+ * FullFloat: one glm matrix in float precision per tensor, see FullTensorStorage.
+ */
+enum class TensorStorage { Full, Symmetric, SymmetricFloat, Sparse, FullFloat };
+
+/**
+ * \class SymmetricTensorStorage
+ * \brief Packed structure-of-arrays storage for symmetric N x N tensors.
+ *
+ * Only the N(N+1)/2 unique components of each tensor are stored, one contiguous array per
+ * component. For 3D tensors the component order is (xx, yy, zz, xy, yz, xz), for 2D tensors
+ * (xx, yy, xy). The storage precision T can be float or double, tensors are always returned in
+ * double precision.
+ */
+template <unsigned int N, typename T>
+class SymmetricTensorStorage {
+    static_assert(N == 2 || N == 3, "Only 2D and 3D tensors are supported");
+
+public:
+    static constexpr size_t numComponents = N * (N + 1) / 2;
+    using value_type = T;
+    using tensor_type = glm::mat<N, N, double>;
+
+    SymmetricTensorStorage() = default;
+    explicit SymmetricTensorStorage(size_t size) {
+        for (auto& c : components_) c.resize(size);
+    }
+    /*
+     * Packs the given tensors. Only the lower triangle of the tensors is considered.
+     */
+    explicit SymmetricTensorStorage(const std::vector<tensor_type>& tensors)
+        : SymmetricTensorStorage(tensors.size()) {
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            set(i, tensors[i]);
+        }
+    }
+
+    size_t size() const { return components_[0].size(); }
+    size_t sizeInBytes() const { return numComponents * size() * sizeof(T); }
+
+    tensor_type get(size_t index) const {
+        tensor_type tensor;
+        for (size_t c = 0; c < numComponents; ++c) {
+            const auto [col, row] = indices()[c];
+            tensor[col][row] = tensor[row][col] = static_cast<double>(components_[c][index]);
+        }
+        return tensor;
+    }
+
+    void set(size_t index, const tensor_type& tensor) {
+        for (size_t c = 0; c < numComponents; ++c) {
+            const auto [col, row] = indices()[c];
+            components_[c][index] = static_cast<T>(tensor[col][row]);
+        }
+    }
+
+    std::vector<tensor_type> toTensors() const {
+        std::vector<tensor_type> tensors(size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            tensors[i] = get(i);
+        }
+        return tensors;
+    }
+
+    /*
+     * Returns the contiguous array of a single component, see the class description for the
+     * component order.
+     */
+    const std::vector<T>& component(size_t c) const { return components_[c]; }
+    std::vector<T>& component(size_t c) { return components_[c]; }
+
+    /*
+     * Returns the (column, row) index of each stored component
+     */
+    static constexpr std::array<std::pair<glm::length_t, glm::length_t>, numComponents>
+    indices() {
+        if constexpr (N == 3) {
+            return {{{0, 0}, {1, 1}, {2, 2}, {0, 1}, {1, 2}, {0, 2}}};
+        } else {
+            return {{{0, 0}, {1, 1}, {0, 1}}};
+        }
+    }
+
+private:
+    std::array<std::vector<T>, numComponents> components_;
+};
+
+template <typename T>
+using SymmetricTensorStorage2D = SymmetricTensorStorage<2, T>;
+template <typename T>
+using SymmetricTensorStorage3D = SymmetricTensorStorage<3, T>;
+
+/**
+ * \class FullTensorStorage
+ * \brief Storage for general N x N tensors in a reduced precision T.
+ *
+ * Keeps tensors that are not symmetric in the precision they were read in, e.g. float32 input at
+ * half the memory of the full double precision storage. Tensors are always returned in double
+ * precision.
+ */
+template <unsigned int N, typename T>
+class FullTensorStorage {
+    static_assert(N == 2 || N == 3, "Only 2D and 3D tensors are supported");
+
+public:
+    using value_type = T;
+    using stored_type = glm::mat<N, N, T>;
+    using tensor_type = glm::mat<N, N, double>;
+
+    FullTensorStorage() = default;
+    explicit FullTensorStorage(size_t size) : tensors_(size) {}
+    explicit FullTensorStorage(std::vector<stored_type>&& tensors)
+        : tensors_(std::move(tensors)) {}
+    /*
+     * Converts the given tensors to precision T.
+     */
+    template <typename U>
+    explicit FullTensorStorage(const std::vector<glm::mat<N, N, U>>& tensors)
+        : tensors_(tensors.size()) {
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            set(i, tensors[i]);
+        }
+    }
+
+    size_t size() const { return tensors_.size(); }
+    size_t sizeInBytes() const { return size() * sizeof(stored_type); }
+
+    tensor_type get(size_t index) const { return tensor_type(tensors_[index]); }
+
+    template <typename U>
+    void set(size_t index, const glm::mat<N, N, U>& tensor) {
+        tensors_[index] = stored_type(tensor);
+    }
+
+    std::vector<tensor_type> toTensors() const {
+        std::vector<tensor_type> tensors(size());
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            tensors[i] = get(i);
+        }
+        return tensors;
+    }
+
+    const std::vector<stored_type>& tensors() const { return tensors_; }
+    std::vector<stored_type>& tensors() { return tensors_; }
+
+private:
+    std::vector<stored_type> tensors_;
+};
+
+template <typename T>
+using FullTensorStorage2D = FullTensorStorage<2, T>;
+template <typename T>
+using FullTensorStorage3D = FullTensorStorage<3, T>;
+
+}  // namespace inviwo
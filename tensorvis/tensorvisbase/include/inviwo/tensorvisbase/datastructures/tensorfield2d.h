@@ -34,6 +34,7 @@
 #include <inviwo/core/datastructures/image/image.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/tensorvisbase/datastructures/symmetrictensorstorage.h>
 #include <inviwo/core/util/indexmapper.h>
 #include <inviwo/core/datastructures/datatraits.h>
 #include <inviwo/core/util/document.h>
@@ -43,6 +44,10 @@
 #include <Eigen/Dense>
 #include <warn/pop>
 
+#include <mutex>
+#include <atomic>
+#include <variant>
+
 namespace inviwo {
 /**
  * \class TensorField2D
@@ -84,11 +89,27 @@ public:
                   const std::vector<dvec2>& majorEigenvectors,
                   const std::vector<dvec2>& minorEigenvectors, const dvec2& extends = dvec2(1.0));
 
+    // Constructors with packed or single precision tensors, see TensorStorage
+    TensorField2D(size2_t dimensions, SymmetricTensorStorage2D<double> data,
+                  const dvec2& extends = dvec2(1.0));
+    TensorField2D(size2_t dimensions, SymmetricTensorStorage2D<float> data,
+                  const dvec2& extends = dvec2(1.0));
+    TensorField2D(size2_t dimensions, FullTensorStorage2D<float> data,
+                  const dvec2& extends = dvec2(1.0));
+
+    TensorField2D(const TensorField2D& tf);
+    TensorField2D& operator=(const TensorField2D&) = delete;
+
     // Destructors
     virtual ~TensorField2D() = default;
 
     std::string getDataInfo() const;
-    std::shared_ptr<Image> getImageRepresentation() const;
+    /*
+     * Returns the tensors as an RGBA float image (xx, yx, xy, yy). The image is created on first
+     * access and shared by all callers until the tensors are modified, so the GPU representation
+     * uploaded by one consumer is reused by the others.
+     */
+    std::shared_ptr<const Image> getImageRepresentation() const;
 
     dmat2& at(size2_t position);
     dmat2& at(size_t x, size_t y);
@@ -139,8 +160,36 @@ public:
     const std::vector<double>& minorEigenValues() const;
     const std::vector<double>& majorEigenValues() const;
     const std::vector<dvec2>& normalizedImagePositions() const;
+    /*
+     * Returns all tensors. If the field uses packed or single precision storage, the full tensors
+     * are expanded and cached on first access. Prefer tensor() for element-wise access.
+     */
     const std::vector<dmat2>& tensors() const;
 
+    /*
+     * Returns the tensor at the given position by value. Works for all storage modes without
+     * expanding packed storage.
+     */
+    dmat2 tensor(size_t index) const;
+    dmat2 tensor(const size2_t& position) const;
+
+    TensorStorage getTensorStorage() const;
+    /*
+     * Converts the tensor storage. Converting to a symmetric storage mode only keeps the lower
+     * triangle of each tensor, i.e. any antisymmetric part is lost. Converting to a float
+     * storage mode rounds the tensors to single precision. Sparse storage is not supported.
+     */
+    void setTensorStorage(TensorStorage storage);
+
+    template <typename T>
+    const SymmetricTensorStorage2D<T>* symmetricTensors() const {
+        return std::get_if<SymmetricTensorStorage2D<T>>(&packedTensors_);
+    }
+
+    const FullTensorStorage2D<float>* floatTensors() const {
+        return std::get_if<FullTensorStorage2D<float>>(&packedTensors_);
+    }
+
     std::array<std::pair<double, dvec2>, 2> getSortedEigenValuesAndEigenVectorsForTensor(
         size_t index) const;
     std::array<std::pair<double, dvec2>, 2> getSortedEigenValuesAndEigenVectorsForTensor(
@@ -153,6 +202,8 @@ public:
 private:
     void computeEigenValuesAndEigenVectors();
     void computeNormalizedScreenCoordinates();
+    void ensureFullTensors() const;
+    void unpackTensors();
 
     std::vector<dvec2> majorEigenVectors_;
     std::vector<dvec2> minorEigenVectors_;
@@ -167,7 +218,14 @@ private:
     glm::u8 rank_;
     glm::u8 dimensionality_;
     util::IndexMapper2D indexMapper_;
-    std::vector<dmat2> tensors_;
+    mutable std::vector<dmat2> tensors_;
+    std::variant<std::monostate, SymmetricTensorStorage2D<double>, SymmetricTensorStorage2D<float>,
+                 FullTensorStorage2D<float>>
+        packedTensors_;
+    mutable std::mutex tensorsMutex_;
+    mutable std::atomic<bool> fullTensorsPending_{false};
+    mutable std::shared_ptr<const Image> imageRepresentation_;
+    mutable std::mutex imageRepresentationMutex_;
 };
 
 template <>
@@ -35,6 +35,10 @@
 #include <inviwo/core/datastructures/image/image.h>
 #include <inviwo/core/util/indexmapper.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
+#include <inviwo/tensorvisbase/datastructures/symmetrictensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/sparsetensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/bitmask.h>
+#include <inviwo/tensorvisbase/util/copyonwrite.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/tensorvisbase/util/tensorutil.h>
 #include <inviwo/core/datastructures/spatialdata.h>
@@ -45,7 +49,13 @@
 #include <warn/ignore/all>
 #include <Eigen/Dense>
 #include <warn/pop>
+#include <array>
 #include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <variant>
+#include <type_traits>
+#include <utility>
 
 namespace inviwo {
 /**
@@ -112,6 +122,14 @@ public:
                   const std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>>& metaData,
                   const vec3& extent = vec3(1.0f), float sliceCoord = 0.0f);
 
+    // Constructors with packed or single precision tensors, see TensorStorage
+    TensorField3D(size3_t dimensions, SymmetricTensorStorage3D<double> data,
+                  const vec3& extent = vec3(1.0f), float sliceCoord = 0.0f);
+    TensorField3D(size3_t dimensions, SymmetricTensorStorage3D<float> data,
+                  const vec3& extent = vec3(1.0f), float sliceCoord = 0.0f);
+    TensorField3D(size3_t dimensions, FullTensorStorage3D<float> data,
+                  const vec3& extent = vec3(1.0f), float sliceCoord = 0.0f);
+
     TensorField3D& operator=(const TensorField3D&) = delete;
 
     // Destructors
@@ -122,7 +140,13 @@ public:
     virtual TensorField3D* clone() const final;
 
     std::string getDataInfo() const;
-    std::pair<std::shared_ptr<Volume>, std::shared_ptr<Volume>> getVolumeRepresentation() const;
+    /*
+     * Returns the tensors as a pair of float volumes, see the implementation for the layout. The
+     * volumes are created on first access and shared by all callers until the tensors are
+     * modified, so the GPU representation uploaded by one consumer is reused by the others.
+     */
+    std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>
+    getVolumeRepresentation() const;
 
     /*
      * Returns a pair of a glm::uint8 and dmat3.
@@ -242,10 +266,86 @@ public:
     const std::vector<double>& middleEigenValues() const;
     const std::vector<double>& minorEigenValues() const;
 
+    /*
+     * Returns all tensors. If the field uses packed or single precision storage, the full tensors
+     * are expanded and cached on first access, which requires the memory of the full storage.
+     * Prefer tensor() for element-wise access.
+     */
     const std::vector<dmat3>& tensors() const;
 
-    void setMask(const std::vector<glm::uint8>& mask) { binaryMask_ = mask; }
-    const std::vector<glm::uint8>& getMask() const { return binaryMask_; }
+    /*
+     * Returns the tensor at the given position by value. Works for all storage modes without
+     * expanding packed storage.
+     */
+    dmat3 tensor(size_t index) const;
+    dmat3 tensor(const size3_t& position) const;
+
+    TensorStorage getTensorStorage() const;
+    /*
+     * Converts the tensor storage. Converting to a symmetric storage mode only keeps the lower
+     * triangle of each tensor, i.e. any antisymmetric part is lost. Converting to sparse storage
+     * drops the tensors of the undefined voxels and requires a mask. Converting to a float
+     * storage mode rounds the tensors to single precision.
+     */
+    void setTensorStorage(TensorStorage storage);
+
+    /*
+     * Returns the packed symmetric tensors, or nullptr if the field does not use packed storage
+     * with precision T.
+     */
+    template <typename T>
+    const SymmetricTensorStorage3D<T>* symmetricTensors() const {
+        return std::get_if<SymmetricTensorStorage3D<T>>(&packedTensors_.get());
+    }
+
+    /*
+     * Returns the single precision tensors, or nullptr if the field does not use FullFloat
+     * storage.
+     */
+    const FullTensorStorage3D<float>* floatTensors() const {
+        return std::get_if<FullTensorStorage3D<float>>(&packedTensors_.get());
+    }
+
+    /*
+     * Returns the sparse tensors, or nullptr if the field does not use sparse storage.
+     */
+    const SparseTensorStorage3D* sparseTensors() const {
+        return std::get_if<SparseTensorStorage3D>(&packedTensors_.get());
+    }
+
+    /*
+     * Sets the mask of defined voxels. Sparse storage is recompacted on the new mask, tensors of
+     * voxels that were undefined before are zero. The byte overload sets the voxels with non-zero
+     * entries.
+     */
+    void setMask(BitMask mask);
+    void setMask(const std::vector<glm::uint8>& mask);
+    /*
+     * The mask of defined voxels with one bit per voxel, empty if the field has no mask.
+     */
+    const BitMask& getMask() const { return *binaryMask_; }
+
+    /*
+     * Sorted indices of the voxels defined by the mask, empty if the field has no mask.
+     */
+    const std::vector<size_t>& definedIndices() const;
+
+    /*
+     * Calls callback(index, tensor) for every defined voxel in index order, or for every voxel
+     * if the field has no mask. Sparse storage is iterated without lookups.
+     */
+    template <typename C>
+    void forEachDefinedTensor(C callback) const {
+        if (const auto sparse = sparseTensors()) {
+            const auto& indices = sparse->indices();
+            const auto& values = sparse->values();
+            for (size_t i = 0; i < indices.size(); ++i) callback(indices[i], values[i]);
+        } else if (hasMask()) {
+            for (const auto index : *definedIndices_) callback(index, tensor(index));
+        } else {
+            for (size_t index = 0; index < size_; ++index) callback(index, tensor(index));
+        }
+    }
 
     /*
     If the tensor field has a mask, this method return the number of 1s in it -
@@ -256,19 +356,32 @@ public:
     /*
      * 0 = major, 1 = middle, 2 = minor
      */
-    std::array<DataMapper, 3> dataMapEigenValues_;
+    const std::array<DataMapper, 3>& dataMapEigenValues() const;
     /*
      * 0 = major, 1 = middle, 2 = minor
      */
-    std::array<DataMapper, 3> dataMapEigenVectors_;
+    const std::array<DataMapper, 3>& dataMapEigenVectors() const;
+
+    void setDataMapEigenValues(const std::array<DataMapper, 3>& dataMaps);
+    void setDataMapEigenVectors(const std::array<DataMapper, 3>& dataMaps);
+
+    /*
+     * Returns true if the eigen decomposition of the tensors has been computed. Fields created
+     * from raw tensors defer the decomposition until eigenvalues or eigenvectors are requested.
+     */
+    bool hasEigenDecomposition() const { return !eigenDecompositionPending_.load(); }
 
-    bool hasMask() const { return binaryMask_.size() == size_; }
+    bool hasMask() const { return binaryMask_->size() == size_; }
 
     const util::IndexMapper3D& indexMapper() const { return indexMapper_; }
 
     template <typename T>
     bool hasMetaData() const {
-        return metaData_.find(T::id()) != std::end(metaData_);
+        if constexpr (tensorutil::hasMetaDataSlot<T>()) {
+            return metaDataSlots_[tensorutil::metaDataSlot(T::id())] != nullptr;
+        } else {
+            return metaData_.find(T::id()) != std::end(metaData_);
+        }
     }
     bool hasMetaData(TensorFeature feature) const;
     bool hasMetaData(const uint64_t id) const;
@@ -276,81 +389,204 @@ public:
     // Returns a reference to the actual data
     template <typename T>
     const typename T::DataType& getMetaData() const {
-        const auto it = metaData_.find(T::id());
-        if (it == metaData_.end()) {
-            throw Exception("Could not locate metadata for ID " + std::to_string(T::id()));
-        }
-        const auto ptr = static_cast<const T*>(it->second.get());
-        return ptr->data_;
+        return findMetaData<T>()->data_;
     }
 
     // returns a pointer to the MetaDataType object
     template <typename T>
     auto getMetaDataContainer() const {
-        const auto it = metaData_.find(T::id());
-        if (it == metaData_.end()) {
-            throw Exception("Could not locate metadata for ID " + std::to_string(T::id()));
-        }
-        return static_cast<const T*>(it->second.get());
+        return findMetaData<T>();
     }
 
     // Returns a pointer to the actual data
     template <typename T>
     auto getMetaDataPtr() const {
-        const auto it = metaData_.find(T::id());
-        if (it == metaData_.end()) {
-            throw Exception("Could not locate metadata for ID " + std::to_string(T::id()));
-        }
-        const auto ptr = static_cast<const T*>(it->second.get());
-        return &(ptr->data_);
+        return &(findMetaData<T>()->data_);
     }
 
     auto getMetaDataContainer(const uint64_t id) const {
-        const auto it = metaData_.find(id);
-        if (it == metaData_.end()) {
+        if (isEigenMetaData(id)) ensureEigenDecomposition();
+        const auto slot = tensorutil::metaDataSlot(id);
+        const MetaDataBase* ptr = nullptr;
+        if (slot < metaDataSlots_.size()) {
+            ptr = metaDataSlots_[slot];
+        } else if (const auto it = metaData_.find(id); it != metaData_.end()) {
+            ptr = it->second.get();
+        }
+        if (!ptr) {
             throw Exception("Could not locate metadata for ID " + std::to_string(id));
         }
-        return it->second.get();
+        return ptr;
+    }
+
+    /*
+     * Plain view of the data of one meta data entry. Fetch it once outside of loops over the
+     * voxels, indexing it is a single array load. The view is invalidated when the entry is
+     * replaced or removed.
+     */
+    template <typename T>
+    struct MetaDataView {
+        const typename T::TType* data = nullptr;
+        size_t size = 0;
+
+        const typename T::TType& operator[](size_t i) const { return data[i]; }
+    };
+
+    template <typename T>
+    MetaDataView<T> getMetaDataView() const {
+        const auto& data = getMetaData<T>();
+        return {data.data(), data.size()};
     }
 
+    /*
+     * Eigen values and eigen vectors of all voxels, sorted as major, intermediate and minor.
+     * Fetching the view triggers a deferred eigen decomposition.
+     */
+    struct EigenView {
+        std::array<const double*, 3> values{};
+        std::array<const dvec3*, 3> vectors{};
+
+        std::array<double, 3> eigenValues(size_t i) const {
+            return {values[0][i], values[1][i], values[2][i]};
+        }
+        std::array<dvec3, 3> eigenVectors(size_t i) const {
+            return {vectors[0][i], vectors[1][i], vectors[2][i]};
+        }
+        std::array<std::pair<double, dvec3>, 3> eigenSystem(size_t i) const {
+            return {{{values[0][i], vectors[0][i]},
+                     {values[1][i], vectors[1][i]},
+                     {values[2][i], vectors[2][i]}}};
+        }
+    };
+
+    EigenView getEigenView() const;
+
     template <typename T, typename S>
     void addMetaData(const S& data, TensorFeature type) {
-        auto metaData = std::make_unique<T>(data, type);
-        metaData_.insert(std::make_pair(T::id(), std::move(metaData)));
+        metaData_.insert(std::make_pair(T::id(), std::make_shared<const T>(data, type)));
+        updateMetaDataSlot(T::id());
+    }
+
+    // Moves the data into the meta data entry instead of copying it
+    template <typename T, typename S, typename = std::enable_if_t<!std::is_reference_v<S>>>
+    void addMetaData(S&& data, TensorFeature type) {
+        metaData_.insert(
+            std::make_pair(T::id(), std::make_shared<const T>(std::move(data), type)));
+        updateMetaDataSlot(T::id());
     }
 
     template <typename T, typename S>
     void addMetaData(const uint64_t id, const S& data, TensorFeature type) {
-        auto metaData = std::make_unique<T>(data, type);
-        metaData_.insert(std::make_pair(id, std::move(metaData)));
+        metaData_.insert(std::make_pair(id, std::make_shared<const T>(data, type)));
+        updateMetaDataSlot(id);
     }
 
+    /*
+     * Takes ownership of the given meta data, replacing existing entries with the same id. If all
+     * eigen value and eigen vector entries are given, the deferred eigen decomposition is skipped.
+     */
+    void setMetaData(std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData);
+
     template <typename T>
     void removeMetaData() {
-        if (hasMetaData<T>()) {
-            metaData_.erase(T::id());
-        }
+        removeMetaData(T::id());
     }
 
-    const std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>>& metaData() const {
+    void removeMetaData(const uint64_t id) {
+        metaData_.erase(id);
+        updateMetaDataSlot(id);
+    }
+
+    /*
+     * Meta data entries are immutable and shared with copies of the field.
+     */
+    const std::unordered_map<uint64_t, std::shared_ptr<const MetaDataBase>>& metaData() const {
+        ensureEigenDecomposition();
         return metaData_;
     }
 
 protected:
-    void computeEigenValuesAndEigenVectors();
+    template <typename T>
+    const T* findMetaData() const {
+        if constexpr (isEigenMetaData(T::id())) ensureEigenDecomposition();
+        const MetaDataBase* ptr = nullptr;
+        if constexpr (tensorutil::hasMetaDataSlot<T>()) {
+            ptr = metaDataSlots_[tensorutil::metaDataSlot(T::id())];
+        } else if (const auto it = metaData_.find(T::id()); it != metaData_.end()) {
+            ptr = it->second.get();
+        }
+        if (!ptr) {
+            throw Exception("Could not locate metadata for ID " + std::to_string(T::id()));
+        }
+        return static_cast<const T*>(ptr);
+    }
+
+    /*
+     * Mirrors the map entry of the given id into its slot, ids without a slot are ignored.
+     */
+    void updateMetaDataSlot(uint64_t id) const;
+    /*
+     * True if all six eigen value and eigen vector entries are present.
+     */
+    bool hasEigenMetaData() const;
+
+    static constexpr bool isEigenMetaData(const uint64_t id) {
+        return id == MajorEigenValues::id() || id == IntermediateEigenValues::id() ||
+               id == MinorEigenValues::id() || id == MajorEigenVectors::id() ||
+               id == IntermediateEigenVectors::id() || id == MinorEigenVectors::id();
+    }
+
+    /*
+     * Adds empty eigen meta data entries that will be filled by ensureEigenDecomposition() on
+     * first access. Adding the entries up front keeps the meta data map itself unchanged by the
+     * deferred computation.
+     */
+    void deferEigenDecomposition();
+    void ensureEigenDecomposition() const;
+    void computeEigenValuesAndEigenVectors() const;
     void computeNormalizedScreenCoordinates(double sliceCoord);
-    void computeDataMaps();
+    void computeDataMaps() const;
+    /*
+     * Expands packed symmetric tensors into tensors_ the first time full tensors are requested.
+     */
+    void ensureFullTensors() const;
+    /*
+     * Switches to full storage before handing out mutable references to the tensors.
+     */
+    void unpackTensors();
+    void updateDefinedIndices();
 
     size3_t dimensions_;
     util::IndexMapper3D indexMapper_;
-    std::vector<dmat3> tensors_;
+    // The per voxel buffers are shared between copies of the field until modified, so copies
+    // that only change the basis or offset do not duplicate the data
+    mutable tensorutil::CopyOnWrite<std::vector<dmat3>> tensors_;
+    tensorutil::CopyOnWrite<std::variant<std::monostate, SymmetricTensorStorage3D<double>,
+                                         SymmetricTensorStorage3D<float>, SparseTensorStorage3D,
+                                         FullTensorStorage3D<float>>>
+        packedTensors_;
     size_t size_;
     glm::u8 rank_;
     glm::u8 dimensionality_;
-    std::vector<vec3> normalizedVolumePositions_;
-    std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData_;
-
-    std::vector<glm::uint8> binaryMask_;
+    tensorutil::CopyOnWrite<std::vector<vec3>> normalizedVolumePositions_;
+    // Mutable since the deferred eigen decomposition replaces its placeholder entries
+    mutable std::unordered_map<uint64_t, std::shared_ptr<const MetaDataBase>> metaData_;
+    // Non-owning entries of metaData_ for the ids in tensorutil::metaDataIds, indexed by slot
+    mutable std::array<const MetaDataBase*, tensorutil::metaDataIds.size()> metaDataSlots_{};
+
+    tensorutil::CopyOnWrite<BitMask> binaryMask_;
+    // Defined voxels of the mask, not used with sparse storage which keeps its own list
+    tensorutil::CopyOnWrite<std::vector<size_t>> definedIndices_;
+
+    mutable std::array<DataMapper, 3> dataMapEigenValues_;
+    mutable std::array<DataMapper, 3> dataMapEigenVectors_;
+    mutable std::mutex eigenDecompositionMutex_;
+    mutable std::atomic<bool> eigenDecompositionPending_{false};
+    mutable std::mutex tensorsMutex_;
+    mutable std::atomic<bool> fullTensorsPending_{false};
+    mutable std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>
+        volumeRepresentation_;
+    mutable std::mutex volumeRepresentationMutex_;
 };
 
 template <>
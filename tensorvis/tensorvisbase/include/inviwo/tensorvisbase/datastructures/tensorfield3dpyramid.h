@@ -0,0 +1,101 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class TensorField3DPyramid
+ * \brief Multiresolution pyramid of a 3D tensor field for level of detail rendering.
+ *
+ * Level 0 is the input tensor field itself. Every following level halves the dimensions, rounding
+ * up, and averages blocks of up to 2x2x2 tensors of the previous level until all dimensions are
+ * one. The coarse levels are stored in cubic bricks of brickSize^3 tensors, so that neighbouring
+ * tensors are close in memory for all three axes.
+ *
+ * Log-Euclidean averaging averages the matrix logarithms, which preserves the determinant and
+ * avoids the swelling of plain averaging. It is only defined for positive definite tensors,
+ * blocks with other tensors are averaged linearly.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DPyramid {
+public:
+    using Averaging = tensorutil::Averaging;
+
+    explicit TensorField3DPyramid(std::shared_ptr<const TensorField3D> tensorField,
+                                  Averaging averaging = Averaging::Linear, size_t brickSize = 16);
+
+    size_t getNumberOfLevels() const;
+    size3_t getDimensions(size_t level) const;
+    // Distance between neighbouring tensors of the level in world space
+    dvec3 getSpacing(size_t level) const;
+
+    dmat3 tensor(size_t level, const size3_t& position) const;
+
+    /*
+     * Returns the coarsest level whose largest tensor spacing covers at most maxPixelError
+     * pixels on screen. pixelsPerUnit is the number of screen pixels per world space unit at
+     * the tensor field, for a perspective camera viewportHeight / (2 * distance * tan(fov / 2)).
+     */
+    size_t coarsestLevel(double pixelsPerUnit, double maxPixelError = 1.0) const;
+
+    /*
+     * Returns the tensor field of a level with the same basis and offset as the input field. The
+     * field of a coarse level is created on first access and cached.
+     */
+    std::shared_ptr<const TensorField3D> getLevel(size_t level) const;
+
+private:
+    struct Level {
+        size3_t dimensions;
+        size3_t numBricks;
+        // Bricks padded to brickSize^3, x fastest within and between bricks
+        std::vector<dmat3> tensors;
+        mutable std::shared_ptr<const TensorField3D> field;
+    };
+
+    size_t brickIndex(const Level& level, const size3_t& position) const;
+    Level downsample(size_t fineLevel, Averaging averaging) const;
+
+    std::shared_ptr<const TensorField3D> tensorField_;
+    size_t brickSize_;
+    std::vector<Level> levels_;  // levels 1 and coarser
+    mutable std::mutex mutex_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,167 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/datatraits.h>
+#include <inviwo/core/util/dispatcher.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace inviwo {
+
+/**
+ * \class TensorField3DSequence
+ * \brief Time series of 3D tensor fields that are loaded on demand.
+ *
+ * The time steps are produced by a loader function, in general a file reader, and only a window
+ * of them is kept in memory. Requesting a time step schedules loading it and the next prefetch
+ * steps, wrapping around at the end of the sequence, on the thread pool. Loaded steps are evicted
+ * least recently used first once the estimated memory of all loaded steps exceeds the memory
+ * budget, or the allowance of the sequence in the global MemoryBudget if that is smaller. Other
+ * caches exceeding the global budget can evict steps as well. The requested step and its
+ * prefetch window are never evicted.
+ *
+ * All functions are thread safe. The loader is called from the worker threads.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DSequence {
+public:
+    using Loader = std::function<std::shared_ptr<TensorField3D>(size_t step)>;
+    using Callback = std::function<void(size_t step)>;
+
+    static constexpr size_t defaultMemoryBudget = size_t{2} << 30;
+
+    TensorField3DSequence(size_t numSteps, Loader loader, size_t prefetch = 4,
+                          size_t memoryBudget = defaultMemoryBudget);
+    TensorField3DSequence(const TensorField3DSequence&) = delete;
+    TensorField3DSequence& operator=(const TensorField3DSequence&) = delete;
+    ~TensorField3DSequence() = default;
+
+    size_t size() const;
+
+    /*
+     * Returns the time step, waits for it if it is not loaded yet. Rethrows loader exceptions.
+     * A step whose loader job has not started yet is loaded on the calling thread instead, so
+     * pool jobs never wait for a loader queued behind them.
+     */
+    std::shared_ptr<const TensorField3D> get(size_t step) const;
+    /*
+     * Returns the time step if it is loaded and nullptr otherwise, never waits for the loader.
+     * Rethrows loader exceptions.
+     */
+    std::shared_ptr<const TensorField3D> tryGet(size_t step) const;
+    // Schedules loading of the time step and its prefetch window
+    void prefetch(size_t step) const;
+    bool isLoaded(size_t step) const;
+
+    void setPrefetch(size_t prefetch);
+    size_t getPrefetch() const;
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+    // Estimated memory of all loaded time steps in bytes
+    size_t getMemoryUsage() const;
+
+    /*
+     * The callback is called from the worker thread when a time step has been loaded. It is
+     * removed when the returned handle is destroyed.
+     */
+    std::shared_ptr<Callback> onLoaded(Callback callback) const;
+
+    std::string getDataInfo() const;
+
+    // Estimated memory of the tensors and meta data of a tensor field in bytes
+    static size_t memoryUsage(const TensorField3D& tensorField);
+
+private:
+    using Promise = std::promise<std::shared_ptr<const TensorField3D>>;
+
+    struct Step {
+        std::shared_future<std::shared_ptr<const TensorField3D>> field;
+        std::shared_ptr<Promise> promise;
+        // Set by the thread running the loader, either the pool job or a waiting get()
+        std::shared_ptr<std::atomic<bool>> started;
+        size_t bytes = 0;
+        bool loaded = false;
+        size_t lastUse = 0;
+    };
+
+    // Shared with the loading tasks, which might outlive the sequence
+    struct State {
+        Loader loader;
+        size_t numSteps;
+        size_t prefetch;
+        size_t memoryBudget;
+
+        std::mutex mutex;
+        std::map<size_t, Step> steps;
+        size_t current = 0;
+        size_t useCounter = 0;
+        size_t memoryUsage = 0;
+        std::unique_ptr<MemoryBudget::Registration> registration;
+
+        std::mutex callbackMutex;
+        Dispatcher<void(size_t)> loaded;
+
+        Step& request(size_t step, const std::shared_ptr<State>& self);
+        void load(size_t step, Promise& promise);
+        void prefetchWindow(size_t step, const std::shared_ptr<State>& self);
+        bool inWindow(size_t step) const;
+        // The smaller of memoryBudget and the allowance in the global budget
+        size_t budget() const;
+        void evict();
+        void evictTo(size_t bytes);
+    };
+
+    Step use(size_t step) const;
+
+    std::shared_ptr<State> state_;
+};
+
+template <>
+struct DataTraits<TensorField3DSequence> {
+    static std::string classIdentifier() { return "org.inviwo.TensorField3DSequence"; }
+    static std::string dataName() { return "TensorField3DSequence"; }
+    static uvec3 colorCode() { return uvec3(10, 110, 135); }
+    static Document info(const TensorField3DSequence& data) {
+        Document doc;
+        doc.append("p", data.getDataInfo());
+        return doc;
+    }
+};
+
+}  // namespace inviwo
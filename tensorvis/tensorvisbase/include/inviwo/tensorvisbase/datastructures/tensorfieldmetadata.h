@@ -7,6 +7,7 @@
 #include <modules/base/algorithm/dataminmax.h>
 
 #include <algorithm>
+#include <array>
 #include <utility>
 #include <sstream>
 #include <fstream>
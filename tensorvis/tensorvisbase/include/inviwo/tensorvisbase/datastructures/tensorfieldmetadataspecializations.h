@@ -5,7 +5,8 @@
 struct I1 : public MetaDataType<glm::f64> {
     I1() = default;
 
-    explicit I1(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit I1(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     I1* clone() const final { return new I1(data_, type_); }
 
@@ -17,7 +18,8 @@ struct I1 : public MetaDataType<glm::f64> {
 struct I2 : MetaDataType<glm::f64> {
     I2() = default;
 
-    explicit I2(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit I2(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     I2* clone() const final { return new I2(data_, type_); }
 
@@ -29,7 +31,8 @@ struct I2 : MetaDataType<glm::f64> {
 struct I3 : MetaDataType<glm::f64> {
     I3() = default;
 
-    explicit I3(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit I3(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     I3* clone() const final { return new I3(data_, type_); }
 
@@ -41,7 +44,8 @@ struct I3 : MetaDataType<glm::f64> {
 struct J1 : MetaDataType<glm::f64> {
     J1() = default;
 
-    explicit J1(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit J1(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     J1* clone() const final { return new J1(data_, type_); }
 
@@ -53,7 +57,8 @@ struct J1 : MetaDataType<glm::f64> {
 struct J2 : MetaDataType<glm::f64> {
     J2() = default;
 
-    explicit J2(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit J2(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     J2* clone() const final { return new J2(data_, type_); }
 
@@ -65,7 +70,8 @@ struct J2 : MetaDataType<glm::f64> {
 struct J3 : MetaDataType<glm::f64> {
     J3() = default;
 
-    explicit J3(const std::vector<double>& data, TensorFeature type) : MetaDataType(data, type){};
+    explicit J3(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     J3* clone() const final { return new J3(data_, type_); }
 
@@ -77,8 +83,8 @@ struct J3 : MetaDataType<glm::f64> {
 struct MajorEigenVectors : MetaDataType<dvec3> {
     MajorEigenVectors() = default;
 
-    explicit MajorEigenVectors(const std::vector<dvec3>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit MajorEigenVectors(std::vector<dvec3> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     MajorEigenVectors* clone() const final { return new MajorEigenVectors(data_, type_); }
 
@@ -90,8 +96,8 @@ struct MajorEigenVectors : MetaDataType<dvec3> {
 struct IntermediateEigenVectors : MetaDataType<dvec3> {
     IntermediateEigenVectors() = default;
 
-    explicit IntermediateEigenVectors(const std::vector<dvec3>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit IntermediateEigenVectors(std::vector<dvec3> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     IntermediateEigenVectors* clone() const final {
         return new IntermediateEigenVectors(data_, type_);
@@ -105,8 +111,8 @@ struct IntermediateEigenVectors : MetaDataType<dvec3> {
 struct MinorEigenVectors : MetaDataType<dvec3> {
     MinorEigenVectors() = default;
 
-    explicit MinorEigenVectors(const std::vector<dvec3>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit MinorEigenVectors(std::vector<dvec3> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     MinorEigenVectors* clone() const final { return new MinorEigenVectors(data_, type_); }
 
@@ -118,8 +124,8 @@ struct MinorEigenVectors : MetaDataType<dvec3> {
 struct MajorEigenValues : MetaDataType<glm::f64> {
     MajorEigenValues() = default;
 
-    explicit MajorEigenValues(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit MajorEigenValues(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     MajorEigenValues* clone() const final { return new MajorEigenValues(data_, type_); }
 
@@ -131,8 +137,8 @@ struct MajorEigenValues : MetaDataType<glm::f64> {
 struct IntermediateEigenValues : MetaDataType<glm::f64> {
     IntermediateEigenValues() = default;
 
-    explicit IntermediateEigenValues(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit IntermediateEigenValues(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     IntermediateEigenValues* clone() const final {
         return new IntermediateEigenValues(data_, type_);
@@ -146,8 +152,8 @@ struct IntermediateEigenValues : MetaDataType<glm::f64> {
 struct MinorEigenValues : MetaDataType<glm::f64> {
     MinorEigenValues() = default;
 
-    explicit MinorEigenValues(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit MinorEigenValues(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     MinorEigenValues* clone() const final { return new MinorEigenValues(data_, type_); }
 
@@ -159,8 +165,8 @@ struct MinorEigenValues : MetaDataType<glm::f64> {
 struct LodeAngle : MetaDataType<glm::f64> {
     LodeAngle() = default;
 
-    explicit LodeAngle(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit LodeAngle(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     LodeAngle* clone() const final { return new LodeAngle(data_, type_); }
 
@@ -172,8 +178,8 @@ struct LodeAngle : MetaDataType<glm::f64> {
 struct Anisotropy : MetaDataType<glm::f64> {
     Anisotropy() = default;
 
-    explicit Anisotropy(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit Anisotropy(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     Anisotropy* clone() const final { return new Anisotropy(data_, type_); }
 
@@ -185,8 +191,8 @@ struct Anisotropy : MetaDataType<glm::f64> {
 struct LinearAnisotropy : MetaDataType<glm::f64> {
     LinearAnisotropy() = default;
 
-    explicit LinearAnisotropy(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit LinearAnisotropy(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     LinearAnisotropy* clone() const final { return new LinearAnisotropy(data_, type_); }
 
@@ -198,8 +204,8 @@ struct LinearAnisotropy : MetaDataType<glm::f64> {
 struct PlanarAnisotropy : MetaDataType<glm::f64> {
     PlanarAnisotropy() = default;
 
-    explicit PlanarAnisotropy(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit PlanarAnisotropy(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     PlanarAnisotropy* clone() const final { return new PlanarAnisotropy(data_, type_); }
 
@@ -211,8 +217,8 @@ struct PlanarAnisotropy : MetaDataType<glm::f64> {
 struct SphericalAnisotropy : MetaDataType<glm::f64> {
     SphericalAnisotropy() = default;
 
-    explicit SphericalAnisotropy(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit SphericalAnisotropy(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     SphericalAnisotropy* clone() const final { return new SphericalAnisotropy(data_, type_); }
 
@@ -224,8 +230,8 @@ struct SphericalAnisotropy : MetaDataType<glm::f64> {
 struct Diffusivity : MetaDataType<glm::f64> {
     Diffusivity() = default;
 
-    explicit Diffusivity(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit Diffusivity(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     Diffusivity* clone() const final { return new Diffusivity(data_, type_); }
 
@@ -237,8 +243,8 @@ struct Diffusivity : MetaDataType<glm::f64> {
 struct ShearStress : MetaDataType<glm::f64> {
     ShearStress() = default;
 
-    explicit ShearStress(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit ShearStress(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     ShearStress* clone() const final { return new ShearStress(data_, type_); }
 
@@ -250,8 +256,8 @@ struct ShearStress : MetaDataType<glm::f64> {
 struct PureShear : MetaDataType<glm::f64> {
     PureShear() = default;
 
-    explicit PureShear(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit PureShear(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     PureShear* clone() const final { return new PureShear(data_, type_); }
 
@@ -263,8 +269,8 @@ struct PureShear : MetaDataType<glm::f64> {
 struct ShapeFactor : MetaDataType<glm::f64> {
     ShapeFactor() = default;
 
-    explicit ShapeFactor(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit ShapeFactor(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     ShapeFactor* clone() const final { return new ShapeFactor(data_, type_); }
 
@@ -276,8 +282,8 @@ struct ShapeFactor : MetaDataType<glm::f64> {
 struct IsotropicScaling : MetaDataType<glm::f64> {
     IsotropicScaling() = default;
 
-    explicit IsotropicScaling(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit IsotropicScaling(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     IsotropicScaling* clone() const final { return new IsotropicScaling(data_, type_); }
 
@@ -289,8 +295,8 @@ struct IsotropicScaling : MetaDataType<glm::f64> {
 struct Rotation : MetaDataType<glm::f64> {
     Rotation() = default;
 
-    explicit Rotation(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit Rotation(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     Rotation* clone() const final { return new Rotation(data_, type_); }
 
@@ -302,8 +308,8 @@ struct Rotation : MetaDataType<glm::f64> {
 struct FrobeniusNorm : MetaDataType<glm::f64> {
     FrobeniusNorm() = default;
 
-    explicit FrobeniusNorm(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit FrobeniusNorm(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     FrobeniusNorm* clone() const final { return new FrobeniusNorm(data_, type_); }
 
@@ -315,8 +321,8 @@ struct FrobeniusNorm : MetaDataType<glm::f64> {
 struct HillYieldCriterion : MetaDataType<glm::f64> {
     HillYieldCriterion() = default;
 
-    explicit HillYieldCriterion(const std::vector<double>& data, TensorFeature type)
-        : MetaDataType(data, type){};
+    explicit HillYieldCriterion(std::vector<double> data, TensorFeature type)
+        : MetaDataType(std::move(data), type){};
 
     HillYieldCriterion* clone() const final { return new HillYieldCriterion(data_, type_); }
 
@@ -324,3 +330,61 @@ struct HillYieldCriterion : MetaDataType<glm::f64> {
 
     static constexpr uint64_t id() { return util::constexpr_hash("HillYieldCriterion"); }
 };
+
+/***************************************************
+ *                  SLOT TABLE                     *
+ ***************************************************/
+
+namespace tensorutil {
+
+/*
+ * Ids of the specializations above. The position of an id is the slot of the meta data in the
+ * fixed size table of a tensor field, so that typed lookups resolve at compile time.
+ */
+constexpr std::array<uint64_t, 25> metaDataIds{
+    I1::id(),
+    I2::id(),
+    I3::id(),
+    J1::id(),
+    J2::id(),
+    J3::id(),
+    MajorEigenValues::id(),
+    IntermediateEigenValues::id(),
+    MinorEigenValues::id(),
+    MajorEigenVectors::id(),
+    IntermediateEigenVectors::id(),
+    MinorEigenVectors::id(),
+    LodeAngle::id(),
+    Anisotropy::id(),
+    LinearAnisotropy::id(),
+    PlanarAnisotropy::id(),
+    SphericalAnisotropy::id(),
+    Diffusivity::id(),
+    ShearStress::id(),
+    PureShear::id(),
+    ShapeFactor::id(),
+    IsotropicScaling::id(),
+    Rotation::id(),
+    FrobeniusNorm::id(),
+    HillYieldCriterion::id()};
+
+/*
+ * Returns the slot of the given id, or metaDataIds.size() if the id has no slot.
+ */
+constexpr size_t metaDataSlot(const uint64_t id) {
+    for (size_t i = 0; i < metaDataIds.size(); ++i) {
+        if (metaDataIds[i] == id) return i;
+    }
+    return metaDataIds.size();
+}
+
+constexpr size_t metaDataSlot(const TensorFeature feature) {
+    return metaDataSlot(static_cast<uint64_t>(feature));
+}
+
+template <typename T>
+constexpr bool hasMetaDataSlot() {
+    return metaDataSlot(T::id()) < metaDataIds.size();
+}
+
+}  // namespace tensorutil
@@ -35,6 +35,7 @@
 #include <inviwo/core/datastructures/datatraits.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfield2d.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3dsequence.h>
 
 namespace inviwo {
 
@@ -58,4 +59,14 @@ using TensorField3DInport = DataInport<TensorField3D>;
  */
 using TensorField3DOutport = DataOutport<TensorField3D>;
 
+/**
+ * \ingroup ports
+ */
+using TensorField3DSequenceInport = DataInport<TensorField3DSequence>;
+
+/**
+ * \ingroup ports
+ */
+using TensorField3DSequenceOutport = DataOutport<TensorField3DSequence>;
+
 }  // namespace inviwo
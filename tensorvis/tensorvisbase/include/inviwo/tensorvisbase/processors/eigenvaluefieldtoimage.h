@@ -68,7 +68,6 @@ public:
     EigenvalueFieldToImage();
     virtual ~EigenvalueFieldToImage() = default;
 
-    virtual void initializeResources() override;
     virtual void process() override;
 
     virtual const ProcessorInfo getProcessorInfo() const override;
@@ -86,9 +85,12 @@ private:
 
     TransferFunctionProperty tf_;
     Shader shader_;
-    Image tf_texture_;
     BoolProperty majorMinor_;
 
+    // The value ranges only depend on the input field, they are not recomputed when only the
+    // transfer function or output settings change
+    bool rangesDirty_ = true;
+
     float minVal_;
     float maxVal_;
     float eigenValueRange_;
@@ -97,8 +99,7 @@ private:
     float anisotropyMaxVal_;
     float anisotropyValueRange_;
 
-    void updateEigenValues();
-    void updateAnisotropy();
+    void updateRanges();
 };
 
 }  // namespace inviwo
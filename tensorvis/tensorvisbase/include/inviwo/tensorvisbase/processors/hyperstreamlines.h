@@ -2,8 +2,11 @@
 
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/boolcompositeproperty.h>
 #include <inviwo/core/ports/datainport.h>
+#include <inviwo/core/ports/meshport.h>
 #include <inviwo/core/util/utilities.h>
 #include <inviwo/core/util/foreach.h>
 #include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
@@ -12,7 +15,22 @@
 
 namespace inviwo {
 
-class IVW_MODULE_TENSORVISBASE_API HyperStreamlines : public Processor {
+/*
+ * Traces one hyperstreamline per seed point. Seeds are traced in parallel in batches of
+ * batchSize_ seeds. Each batch is split into chunks of consecutive seeds, every chunk traces its
+ * lines into its own PackedLineSet, and the chunks are appended in seed order once the batch is
+ * done. The packed lines are converted into an IntegralLineSet and a line mesh with a single
+ * vertex buffer, each only if its outport is connected.
+ *
+ * With "Evenly spaced" checked, lines are placed with a minimum separation in data space: seeds
+ * closer than the separation to an already traced line are skipped, and lines stop once they come
+ * closer than the termination ratio times the separation to another line. All threads share one
+ * LineOccupancyGrid, so which seeds survive depends on the order lines finish in.
+ *
+ * Tracing runs on the thread pool. New input or property changes stop the running job before
+ * its next batch, and only the latest settings are traced.
+ */
+class IVW_MODULE_TENSORVISBASE_API HyperStreamlines : public PoolProcessor {
 public:
     HyperStreamlines();
     virtual ~HyperStreamlines();
@@ -27,7 +45,19 @@ private:
     SeedPointsInport<SpatialSampler<3, 3, double>::SpatialDimensions> seeds_;
 
     IntegralLineSetOutport lines_;
+    MeshOutport mesh_;
 
     IntegralLineProperties properties_;
+    OrdinalProperty<size_t> batchSize_;
+
+    BoolCompositeProperty adaptive_;
+    DoubleProperty tolerance_;
+    DoubleProperty minStepSize_;
+    DoubleProperty maxStepSize_;
+    DoubleProperty maxArcLength_;
+
+    BoolCompositeProperty evenlySpaced_;
+    DoubleProperty separation_;
+    DoubleProperty terminationRatio_;
 };
 }  // namespace inviwo
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <modules/opengl/shader/shader.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+#include <modules/vectorfieldvisualization/ports/seedpointsport.h>
+#include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.HyperStreamlinesGL, Hyper Streamlines GL}
+ * ![](org.inviwo.HyperStreamlinesGL.png?classIdentifier=org.inviwo.HyperStreamlinesGL)
+ * Traces hyperstreamlines of the major, intermediate, or minor eigenvector field in a compute
+ * shader, one invocation per seed point.
+ *
+ * ### Inports
+ *   * __tensorField__ Symmetric tensor field, uploaded as tensor field textures.
+ *   * __seeds__ Seed points in data space of the tensor field.
+ *
+ * ### Outports
+ *   * __mesh__ Line mesh, the vertex buffers are written by the compute shader and stay on the
+ *     GPU.
+ *   * __lines__ Integral lines read back from the GPU, only computed if connected.
+ *
+ * ### Properties
+ *   * __Eigenvector__ Eigenvector field to trace.
+ *   * __Direction__ Trace forward, backward, or in both directions from the seed.
+ *   * __Steps__ Number of RK4 steps per line.
+ *   * __Step size__ Step size in data space.
+ */
+class IVW_MODULE_TENSORVISBASE_API HyperStreamlinesGL : public Processor {
+public:
+    enum class Eigenvector { Major, Intermediate, Minor };
+    enum class Direction { Forward, Backward, Both };
+
+    HyperStreamlinesGL();
+    virtual ~HyperStreamlinesGL() = default;
+
+    virtual void initializeResources() override;
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    /*
+     * Every line occupies stepsBackward + 1 + stepsForward vertices with the seed at index
+     * stepsBackward. Vertices past the termination of a line repeat the last valid vertex, so
+     * the segment index buffer only depends on the number of seeds and steps.
+     */
+    std::shared_ptr<IndexBuffer> segmentIndices(size_t numLines, size_t verticesPerLine);
+    std::shared_ptr<IntegralLineSet> readBack(const Buffer<vec4>& positions, size_t numLines,
+                                              size_t verticesPerLine, size_t seedVertex) const;
+
+    TensorField3DInport tensorField_;
+    SeedPointsInport<3> seeds_;
+    MeshOutport mesh_;
+    IntegralLineSetOutport lines_;
+
+    TemplateOptionProperty<Eigenvector> eigenvector_;
+    TemplateOptionProperty<Direction> direction_;
+    IntSizeTProperty steps_;
+    FloatProperty stepSize_;
+
+    Shader shader_;
+
+    std::shared_ptr<IndexBuffer> indices_;
+    size2_t indicesShape_{0};  // number of lines and vertices per line of indices_
+    std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>> tensorFieldVolumes_;
+};
+
+}  // namespace inviwo
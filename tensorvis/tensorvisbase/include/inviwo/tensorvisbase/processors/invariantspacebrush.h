@@ -0,0 +1,83 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/tensorvisbase/datastructures/invariantspace.h>
+#include <inviwo/tensorvisbase/datastructures/invariantspaceindex.h>
+
+#include <memory>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.InvariantSpaceBrush, Invariant Space Brush}
+ * ![](org.inviwo.InvariantSpaceBrush.png?classIdentifier=org.inviwo.InvariantSpaceBrush)
+ * Selects the rows of an invariant space inside a range per axis.
+ *
+ * ### Inports
+ *   * __inport__ Invariant space to brush.
+ *
+ * ### Outports
+ *   * __outport__ Invariant space holding the selected rows only.
+ *
+ * ### Properties
+ *   * __Ranges__ One range per axis of the invariant space.
+ *
+ * An InvariantSpaceIndex is built once per input. Changing a single range only visits the rows
+ * between its old and its new bounds.
+ */
+class IVW_MODULE_TENSORVISBASE_API InvariantSpaceBrush : public Processor {
+public:
+    InvariantSpaceBrush();
+    virtual ~InvariantSpaceBrush() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void updateRanges();
+
+    InvariantSpaceInport inport_;
+    InvariantSpaceOutport outport_;
+
+    CompositeProperty ranges_;
+
+    std::unique_ptr<InvariantSpaceIndex> index_;
+    InvariantSpaceIndex::Selection selection_;
+    std::vector<dvec2> previousRanges_;
+};
+
+}  // namespace inviwo
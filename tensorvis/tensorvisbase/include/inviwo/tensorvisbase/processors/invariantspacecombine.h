@@ -38,22 +38,19 @@ namespace inviwo {
 
 /** \docpage{org.inviwo.InvariantSpaceCombine, Invariant Space Combine}
  * ![](org.inviwo.InvariantSpaceCombine.png?classIdentifier=org.inviwo.InvariantSpaceCombine)
- * Explanation of how to use the processor.
+ * Combines the axes of two invariant spaces into one.
  *
  * ### Inports
- *   * __<Inport1>__ <description>.
+ *   * __invariantSpaceInport1__ first invariant space.
+ *   * __invariantSpaceInport2__ second invariant space, its axes follow the ones of the first.
  *
  * ### Outports
- *   * __<Outport1>__ <description>.
- *
- * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __outport__ invariant space with the axes of both inputs.
  */
 
 /**
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ * \brief combines the axes of two invariant spaces
+ * The axes of the inputs are shared with the output, not copied, see InvariantSpace::addAxes.
  */
 class IVW_MODULE_TENSORVISBASE_API InvariantSpaceCombine : public Processor {
 public:
@@ -8,6 +8,12 @@
 
 namespace inviwo {
 
+/**
+ * Converts each axis of an InvariantSpace into a float column of a DataFrame. The converted
+ * buffers are kept as long as their axes are alive, and shared by the columns of all following
+ * DataFrames. Exporting an invariant space whose axes were exported before, e.g. the output of
+ * InvariantSpaceCombine, therefore costs O(axes).
+ */
 class IVW_MODULE_TENSORVISBASE_API InvariantSpaceToDataFrame : public Processor {
 public:
     InvariantSpaceToDataFrame();
@@ -21,6 +27,12 @@ public:
 private:
     InvariantSpaceInport inport_;
     DataFrameOutport outport_;
+
+    struct ConvertedAxis {
+        std::weak_ptr<const InvariantSpaceAxis> axis;
+        std::shared_ptr<Buffer<glm::f32>> buffer;
+    };
+    std::vector<ConvertedAxis> converted_;
 };
 
 }  // namespace inviwo
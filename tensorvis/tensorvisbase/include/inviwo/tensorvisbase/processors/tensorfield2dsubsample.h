@@ -35,6 +35,7 @@
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfield2d.h>
 #include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+#include <inviwo/core/properties/boolproperty.h>
 
 namespace inviwo {
 
@@ -75,6 +76,9 @@ private:
 
     FloatProperty resolutionMultiplier_;
     TemplateOptionProperty<tensorutil::InterpolationMethod> interpolationMethod_;
+    // Average the covered blocks instead of interpolating when the resolution decreases
+    BoolProperty averageBlocks_;
+    TemplateOptionProperty<tensorutil::Averaging> averaging_;
 };
 
 }  // namespace inviwo
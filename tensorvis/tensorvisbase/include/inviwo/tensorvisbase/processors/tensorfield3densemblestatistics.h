@@ -0,0 +1,83 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/poolprocessor.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+#include <inviwo/tensorvisbase/algorithm/tensorfieldensemble.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.TensorField3DEnsembleStatistics, Tensor Field 3D Ensemble Statistics}
+ * ![](org.inviwo.TensorField3DEnsembleStatistics.png?classIdentifier=org.inviwo.TensorField3DEnsembleStatistics)
+ * Compares the members of a tensor field ensemble to the ensemble mean, voxel by voxel.
+ *
+ * ### Inports
+ *   * __inport__ Tensor field ensemble, one member per time step of the sequence.
+ *
+ * ### Outports
+ *   * __mean__ Mean distance of the members to the ensemble mean.
+ *   * __variance__ Variance of the distances.
+ *   * __outlier__ Distance of the most deviating member in standard deviations.
+ *
+ * ### Properties
+ *   * __Distance__ Frobenius norm, Log-Euclidean distance, or angle between the major
+ *     eigenvectors.
+ */
+
+/**
+ * \class TensorField3DEnsembleStatistics
+ * \brief Streams the members of an ensemble through the thread pool, see
+ * tensorutil::ensembleStatistics.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DEnsembleStatistics : public PoolProcessor {
+public:
+    TensorField3DEnsembleStatistics();
+    virtual ~TensorField3DEnsembleStatistics() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    TensorField3DSequenceInport inport_;
+    VolumeOutport meanOutport_;
+    VolumeOutport varianceOutport_;
+    VolumeOutport outlierOutport_;
+
+    TemplateOptionProperty<tensorutil::EnsembleDistance> distance_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,84 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3dpyramid.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.TensorField3DLevelOfDetail, Tensor Field 3D Level Of Detail}
+ * ![](org.inviwo.TensorField3DLevelOfDetail.png?classIdentifier=org.inviwo.TensorField3DLevelOfDetail)
+ * Builds a multiresolution pyramid of the input tensor field once and outputs the coarsest level
+ * whose tensor spacing stays below a screen space error for the current camera.
+ *
+ * ### Inports
+ *   * __inport__ Input tensor field.
+ *
+ * ### Outports
+ *   * __outport__ Tensor field of the selected level.
+ *
+ * ### Properties
+ *   * __Averaging__ Linear or Log-Euclidean averaging of the coarser levels.
+ *   * __Max pixel error__ Maximum spacing between tensors on screen in pixels.
+ *   * __Viewport height__ Height of the rendered image in pixels.
+ *   * __Camera__ Camera that the tensor field is rendered with.
+ *   * __Level__ Selected level, 0 is the input tensor field.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DLevelOfDetail : public Processor {
+public:
+    TensorField3DLevelOfDetail();
+    virtual ~TensorField3DLevelOfDetail() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    TensorField3DInport inport_;
+    TensorField3DOutport outport_;
+
+    TemplateOptionProperty<TensorField3DPyramid::Averaging> averaging_;
+    FloatProperty maxPixelError_;
+    IntProperty viewportHeight_;
+    CameraProperty camera_;
+    IntSizeTProperty level_;
+
+    std::unique_ptr<TensorField3DPyramid> pyramid_;
+};
+
+}  // namespace inviwo
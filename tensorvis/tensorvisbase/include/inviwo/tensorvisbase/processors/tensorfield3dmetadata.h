@@ -32,10 +32,17 @@
 
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <modules/opengl/shader/shader.h>
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <vector>
 
 namespace inviwo {
 
@@ -59,8 +66,17 @@ namespace inviwo {
  * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
  * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
  */
-class IVW_MODULE_TENSORVISBASE_API TensorField3DMetaData : public Processor {
+class IVW_MODULE_TENSORVISBASE_API TensorField3DMetaData : public PoolProcessor {
 public:
+    /*
+     * CPU computes all selected features in a single pass over the tensors on the thread pool,
+     * a new input or selection stops a running job. GPU uploads the unique components of the
+     * tensor field once and computes all selected features in a single compute shader pass on
+     * the main thread. The GPU backend requires a symmetric tensor field and falls back to the
+     * CPU otherwise.
+     */
+    enum class Backend { CPU, GPU };
+
     TensorField3DMetaData();
     virtual ~TensorField3DMetaData() = default;
 
@@ -103,10 +119,47 @@ private:
     ButtonProperty selectAll_;
     ButtonProperty deselectAll_;
 
+    TemplateOptionProperty<Backend> backend_;
+
+    Shader shader_;
+
     std::shared_ptr<TensorField3D> tensorFieldOut_;
 
-    void addMetaData();
-    void removeMetaData();
+    static constexpr size_t numFeatures = 18;
+
+    struct FeatureInfo {
+        const BoolProperty* property;
+        uint64_t id;
+        void (*add)(TensorField3D&, std::vector<double>);
+    };
+
+    /*
+     * Returns the features which can be computed for the tensor field, in the order of the
+     * feature indices used by the fused CPU kernel and tensorfeatures.comp.
+     */
+    std::array<FeatureInfo, numFeatures> features() const;
+    /*
+     * Assigns consecutive output slots to the selected features which are not yet present on the
+     * output tensor field and -1 to all others. Returns the number of requested features.
+     */
+    size_t requestedFeatures(std::array<int, numFeatures>& outputSlot) const;
+
+    /*
+     * Computes the requested features in parallel over slices, one vector per output slot.
+     * Returns std::nullopt if stopped.
+     */
+    static std::optional<std::vector<std::vector<double>>> computeFeatures(
+        const TensorField3D& tensorField, const std::array<int, numFeatures>& outputSlot,
+        size_t numRequested, const std::function<bool()>& stop,
+        const std::function<void(float)>& progress);
+    /*
+     * Computes the selected features in a compute shader. Returns false if the tensor field
+     * cannot be handled on the GPU, i.e. if it is not symmetric or its components or features
+     * cannot be indexed with 32 bit unsigned integers.
+     */
+    bool addMetaDataGPU();
+    // Ids of the features that are not selected and have to be removed from the output
+    std::vector<uint64_t> deselectedFeatures() const;
 
     void selectAll();
     void deselectAll();
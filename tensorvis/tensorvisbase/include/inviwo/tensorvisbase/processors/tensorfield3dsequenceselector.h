@@ -0,0 +1,81 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+
+#include <atomic>
+#include <limits>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.TensorField3DSequenceSelector, Tensor Field 3D Sequence Selector}
+ * ![](org.inviwo.TensorField3DSequenceSelector.png?classIdentifier=org.inviwo.TensorField3DSequenceSelector)
+ * Selects one time step of a tensor field sequence.
+ *
+ * ### Inports
+ *   * __inport__ Tensor field sequence.
+ *
+ * ### Outports
+ *   * __outport__ Tensor field of the selected time step.
+ *
+ * ### Properties
+ *   * __Time step__ Selected time step, starting at 1.
+ *   * __Wait for time step__ Wait for the selected time step to be loaded. Otherwise the
+ *     previous output is kept until the time step has been loaded in the background.
+ */
+class IVW_MODULE_TENSORVISBASE_API TensorField3DSequenceSelector : public Processor {
+public:
+    TensorField3DSequenceSelector();
+    virtual ~TensorField3DSequenceSelector() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    TensorField3DSequenceInport inport_;
+    TensorField3DOutport outport_;
+
+    IntSizeTProperty timeStep_;
+    BoolProperty waitForTimeStep_;
+
+    std::shared_ptr<TensorField3DSequence::Callback> onLoaded_;
+    // Time step that is not loaded yet, the processor is invalidated once it is
+    std::atomic<size_t> pending_{std::numeric_limits<size_t>::max()};
+};
+
+}  // namespace inviwo
@@ -31,11 +31,11 @@
 #define IVW_TENSORFIELD3DSUBSAMPLE_H
 
 #include <inviwo/core/common/inviwo.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/tensorvisbase/util/tensorfieldutil.h>
-#include <inviwo/core/processors/progressbarowner.h>
+#include <inviwo/core/properties/boolproperty.h>
 
 namespace inviwo {
 
@@ -55,17 +55,16 @@ namespace inviwo {
  */
 
 /**
- * \class <name>
- * \brief <brief description>
- * <Detailed description from a developer prespective>
+ * \class TensorField3DSubsample
+ * \brief Resamples a 3D tensor field to a multiple of its resolution
+ * The resampling runs on the thread pool. A change of the input or the properties stops the
+ * running job at the next slice and only the latest settings are computed.
  */
-class IVW_MODULE_TENSORVISBASE_API TensorField3DSubsample : public Processor,
-                                                            public ProgressBarOwner {
+class IVW_MODULE_TENSORVISBASE_API TensorField3DSubsample : public PoolProcessor {
 public:
     TensorField3DSubsample();
     virtual ~TensorField3DSubsample() = default;
 
-    virtual void initializeResources() override;
     virtual void process() override;
 
     virtual const ProcessorInfo getProcessorInfo() const override;
@@ -77,12 +76,9 @@ private:
 
     FloatProperty resolutionMultiplier_;
     TemplateOptionProperty<tensorutil::InterpolationMethod> interpolationMethod_;
-
-    std::shared_ptr<TensorField3D> tf_;
-
-    void subsample();
-
-    bool isRunning_ = false;
+    // Average the covered blocks instead of interpolating when the resolution decreases
+    BoolProperty averageBlocks_;
+    TemplateOptionProperty<tensorutil::Averaging> averaging_;
 };
 
 }  // namespace inviwo
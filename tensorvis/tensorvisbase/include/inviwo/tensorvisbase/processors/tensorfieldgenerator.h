@@ -35,6 +35,10 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
 
 namespace inviwo {
 
@@ -126,7 +130,18 @@ private:
 
     TensorField2DOutport outport2D_;
 
+    // Synthetic 3D field for load testing, only generated while the outport is connected
+    CompositeProperty field3D_;
+    IntSize3Property dimensions3D_;
+    IntProperty seed_;
+    DoubleProperty noise_;
+    TemplateOptionProperty<TensorStorage> storage_;
+    BoolProperty eigenSystem_;
+
+    TensorField3DOutport outport3D_;
+
     void generate2DField();
+    void generate3DField();
 
     enum Singularities { Trisector, WedgePoint, Collection, Custom };
 };
@@ -86,9 +86,17 @@ private:
     BoolProperty useRK4_;
     BoolProperty majorMinor_;
     FloatVec4Property backgroundColor_;
+    BoolProperty adaptiveKernel_;
+    FloatProperty minKernelLength_;
+    // Accumulates jittered frames until progressiveFrames_ frames are reached or anything changes
+    BoolProperty progressive_;
+    IntProperty progressiveFrames_;
 
     Shader shader_;
-    Image tf_texture_;
+    // Rebuilt only when the inport data changes
+    std::shared_ptr<const Image> tensorFieldTexture_;
+    std::unique_ptr<Image> previousFrame_;
+    int frame_ = 0;
 
     float minVal_;
     float maxVal_;
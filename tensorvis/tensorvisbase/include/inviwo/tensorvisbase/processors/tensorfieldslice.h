@@ -38,6 +38,7 @@
 #include <inviwo/core/ports/dataoutport.h>
 
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+#include <inviwo/tensorvisbase/algorithm/tensorfieldslicing.h>
 
 namespace inviwo {
 
@@ -68,6 +69,8 @@ private:
     OrdinalProperty<size_t> sliceNr_;
     FloatVec4Property sliceColor_;
     FloatVec4Property planeColor_;
+
+    TensorFieldSliceCache sliceCache_;
 };
 
 }  // namespace inviwo
@@ -78,6 +78,12 @@ private:
     TemplateOptionProperty<TensorFeature> feature_;
 
     BoolProperty normalizeVectors_;
+    // Streams the converted meta data through pixel buffers straight into a VolumeGL instead of
+    // filling a RAM representation first
+    BoolProperty directUpload_;
+
+    std::shared_ptr<Volume> uploadToGL(const MetaDataBase& metaData, const size3_t& dimensions,
+                                       DataMapper& dataMap) const;
 };
 
 }  // namespace inviwo
@@ -32,10 +32,11 @@
 
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/ports/imageport.h>
-#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <inviwo/core/ports/dataoutport.h>
 #include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/tensorvisbase/properties/tensorglyphproperty.h>
 
@@ -61,7 +62,7 @@ namespace inviwo {
  * \brief VERY_BRIEFLY_DESCRIBE_THE_CLASS
  * DESCRIBE_THE_CLASS_FROM_A_DEVELOPER_PERSPECTIVE
  */
-class IVW_MODULE_TENSORVISBASE_API TensorGlyphProcessor : public Processor {
+class IVW_MODULE_TENSORVISBASE_API TensorGlyphProcessor : public PoolProcessor {
 public:
     TensorGlyphProcessor();
     virtual ~TensorGlyphProcessor() = default;
@@ -76,6 +77,8 @@ private:
     DataOutport<std::vector<std::shared_ptr<Mesh>>> outport_;
 
     TensorGlyphProperty glyphParameters_;
+    // Generate all glyphs into a single mesh, only for glyph types supporting instancing
+    BoolProperty mergeGlyphs_;
 };
 
 }  // namespace inviwo
@@ -38,15 +38,19 @@
 #include <inviwo/core/ports/datainport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/rendering/meshdrawer.h>
 #include <inviwo/core/interaction/pickingmapper.h>
 #include <inviwo/core/properties/cameraproperty.h>
 #include <inviwo/core/interaction/cameratrackball.h>
 #include <inviwo/core/properties/simplelightingproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
 
 #include <modules/basegl/processors/meshrenderprocessorgl.h>
 
 #include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/buffer/bufferobject.h>
 #include <modules/opengl/image/imagecompositor.h>
 #include <modules/opengl/shader/shader.h>
 
@@ -83,6 +87,8 @@ private:
     ImageInport imageInport_;
     MeshOutport selectedMeshOutport_;
     DataOutport<unsigned int> indexOutport_;
+    // Tensor field indices of the selected glyphs, an alternative to copying the selected mesh
+    DataOutport<std::vector<size_t>> selectedIndicesOutport_;
 
     ImageOutport outport_;
 
@@ -104,14 +110,72 @@ private:
 
     int selectedID_;
     int previouslySelectedID_;
+    int hoveredID_ = -1;
     std::shared_ptr<BasicMesh> selectedMesh_;
 
     bool triggerSelect_ = false;
 
     void addCommonShaderDefines(Shader& shader);
 
+    /*
+     * Meshes draws the glyph meshes of the mesh inport, one draw call per glyph.
+     * Instanced draws a single template glyph for all non-zero tensors of the tensor field
+     * inport, with per-instance transformation, shape, and color read from a shader storage
+     * buffer.
+     * Impostors only uploads one point per non-zero tensor. Superquadric glyphs are ray cast on
+     * the GPU from the eigen system computed from the tensor field textures.
+     * The mesh inport is only used for Meshes. Instanced and Impostors fall back to Meshes for
+     * glyph types they do not support.
+     *
+     * Before an Instanced draw a compute pass, tensorglyphculling.comp, culls the instances
+     * outside of the view frustum or below a projected size and picks a level of detail of the
+     * template glyph per instance from its projected size. It writes the drawn instances of each
+     * level and the indirect draw commands, so the culled glyphs never reach the CPU.
+     */
+    enum class RenderMode { Meshes, Instanced, Impostors };
+    RenderMode activeRenderMode() const;
+
+    void updateInstances();
+    // Uploads the picking id and selection/hover state of the instances changed since last draw
+    void updateInstanceStates();
+    void setHovered(int id);
+    void updateImpostors();
+    void renderInstanced();
+    // Runs the culling pass and fills drawCommands_ and visibleInstances_
+    void cullInstances();
+    void renderImpostors();
+    // Tensor field index of the glyph with the given picking id
+    size_t glyphIndex(size_t id) const;
+
     BoolProperty selectMode_;
+    BoolProperty outputSelectedMesh_;
     TensorGlyphProperty glyphType_;
+
+    TemplateOptionProperty<RenderMode> renderMode_;
+    Shader instancedShader_;
+    Shader impostorShader_;
+    // Template glyph per level of detail, from full resolution to the coarsest
+    std::vector<std::shared_ptr<BasicMesh>> templateGlyphs_;
+    std::shared_ptr<Buffer<vec4>> instanceBuffer_;
+    // Per instance picking id (x) and state (y), bit 0 selected and bit 1 hovered
+    std::unique_ptr<BufferObject> pickingBuffer_;
+    std::vector<int> dirtyInstances_;
+    std::shared_ptr<Mesh> impostorPoints_;
+    std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>> tensorFieldVolumes_;
+    std::vector<size_t> instanceIndices_;
+    bool instancesDirty_ = true;
+
+    static constexpr size_t maxLodLevels = 4;  // MAX_LEVELS in tensorglyphculling.comp
+    CompositeProperty lod_;
+    BoolProperty cullGlyphs_;
+    FloatProperty minPixelSize_;
+    FloatProperty fullDetailSize_;
+    IntSizeTProperty lodLevels_;
+    Shader cullingShader_;
+    // One glDrawElementsIndirect command per level of detail
+    std::unique_ptr<BufferObject> drawCommands_;
+    // Indices of the drawn instances, maxLodLevels ranges of one index per instance
+    std::unique_ptr<BufferObject> visibleInstances_;
 };
 
 }  // namespace inviwo
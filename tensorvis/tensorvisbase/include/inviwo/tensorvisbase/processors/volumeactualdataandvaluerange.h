@@ -34,28 +34,37 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/tensorvisbase/util/volumerange.h>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.VolumeActualDataAndValueRange, Volume Actual Data And Value Range}
  * ![](org.inviwo.VolumeActualDataAndValueRange.png?classIdentifier=org.inviwo.VolumeActualDataAndValueRange)
- * Explanation of how to use the processor.
+ * Sets the data and value range of a volume to the actual minimum and maximum of its voxels,
+ * over all channels.
  *
  * ### Inports
- *   * __<Inport1>__ <description>.
+ *   * __inport__ input volume.
  *
  * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __outport__ copy of the input volume with the actual data and value range.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __Brick Size__ voxels along each axis of the bricks whose ranges are stored.
+ *   * __Restrict to Region__ only use the range of the bricks overlapping the region.
+ *   * __X/Y/Z Range__ region of voxels, both ends inclusive.
  */
 
 /**
  * \class VolumeActualDataAndValueRange
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ * \brief sets the data and value range of a volume to the range of its voxels
+ *
+ * The range of each brick is computed once per input volume, see tensorutil::VolumeRangeSummary,
+ * and kept until new data arrives on the inport, also if it is the same volume modified in place.
+ * Changes of the region only combine the stored brick ranges.
  */
 class IVW_MODULE_TENSORVISBASE_API VolumeActualDataAndValueRange : public Processor {
 public:
@@ -70,6 +79,15 @@ public:
 private:
     VolumeInport inport_;
     VolumeOutport outport_;
+
+    IntSizeTProperty brickSize_;
+    BoolProperty restrictToRegion_;
+    IntSizeTMinMaxProperty rangeX_;
+    IntSizeTMinMaxProperty rangeY_;
+    IntSizeTMinMaxProperty rangeZ_;
+
+    tensorutil::VolumeRangeSummary summary_;
+    std::shared_ptr<Volume> result_;
 };
 
 }  // namespace inviwo
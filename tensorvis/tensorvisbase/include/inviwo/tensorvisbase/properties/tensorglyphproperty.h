@@ -37,6 +37,9 @@
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 
+#include <array>
+#include <tuple>
+
 namespace inviwo {
 
 /**
@@ -72,6 +75,7 @@ public:
     float size() const;
     vec4 color() const;
     float gamma() const;
+    bool useEigenBasis() const;
 
     const std::shared_ptr<BasicMesh> generateGlyph(std::shared_ptr<const TensorField3D> tensorField,
                                                    size_t index, const dvec3 pos);
@@ -96,6 +100,47 @@ public:
                                                      const float size,
                                                      const dvec4& color = dvec4(1.)) const;
 
+    /*
+     * Per-glyph data for instanced rendering of the mesh returned by generateTemplateGlyph. The
+     * layout matches the GlyphInstance struct in tensorglyphinstanced.vert (std430).
+     * position: xyz is the glyph center, w the glyph size
+     * basis:    transformation applied to the (deformed) template vertices
+     * shape:    superquadric exponents alpha and beta, z > 0.5 if the x and z axes are swapped,
+     *           w > 0.5 if the template should be deformed into a superquadric
+     */
+    struct GlyphInstance {
+        vec4 position;
+        std::array<vec4, 3> basis;
+        vec4 color;
+        vec4 shape;
+    };
+
+    /*
+     * Glyph types that can be rendered as instances of a single template mesh, i.e. quadrics,
+     * cubes, cylinders, and superquadrics.
+     */
+    bool supportsInstancing() const;
+
+    /*
+     * Returns the template mesh centered at the origin for the current glyph type: a unit sphere
+     * for quadrics and superquadrics, a cube or a cylinder. The resolution is halved for each
+     * coarser level of detail, down to the minimum of the resolution properties.
+     */
+    std::shared_ptr<BasicMesh> generateTemplateGlyph(size_t level = 0) const;
+
+    GlyphInstance generateGlyphInstance(const TensorField3D& tensorField, size_t index,
+                                        const dvec3& pos) const;
+
+    /*
+     * Generates the glyphs of the given tensors at the given positions into a single mesh, in
+     * one parallel pass over the glyphs. The shared template topology of the current glyph type
+     * is deformed per glyph, with positions and normals in world space. Returns nullptr for
+     * glyph types that do not support instancing.
+     */
+    std::shared_ptr<BasicMesh> generateGlyphs(const TensorField3D& tensorField,
+                                              const std::vector<size_t>& indices,
+                                              const std::vector<dvec3>& positions) const;
+
 protected:
     // Properties go here
     TemplateOptionProperty<GlyphType> glyphType_;
@@ -170,6 +215,21 @@ private:
     std::shared_ptr<BasicMesh> createSuperquadric(const std::array<double, 3>& eigenValues,
                                                   const dvec3& pos, const float size,
                                                   const dvec4& color) const;
+    // Deforms a vertex of the unit sphere into a superquadric with the given exponents
+    vec3 superquadricVertex(const vec3& v, double alpha, double beta, bool swapAxes) const;
+
+    /*
+     * Normalizes the eigen system of the tensor for superquadric glyphs. Returns the glyph basis
+     * and the absolute normalized eigenvalues, sorted by magnitude.
+     */
+    std::pair<dmat3, std::array<double, 3>> superquadricBasis(const TensorField3D& tensorField,
+                                                              size_t index) const;
+
+    /*
+     * Returns the superquadric exponents alpha and beta and whether the x and z axes are swapped.
+     */
+    std::tuple<double, double, bool> superquadricExponents(
+        const std::array<double, 3>& eigenValues) const;
 
     //    static constexpr std::array<std::array<dvec2, 3>, 10> tri_uv{
     //        {{dvec2(0.00, 0.00), dvec2(0.50, 0.00), dvec2(0.25, 0.25)},
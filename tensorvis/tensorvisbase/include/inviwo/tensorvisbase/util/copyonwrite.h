@@ -0,0 +1,78 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <memory>
+
+namespace inviwo {
+namespace tensorutil {
+
+/**
+ * \brief Value that shares its data between copies until one of them is modified.
+ *
+ * Copying a CopyOnWrite only copies a shared pointer. The data is copied by modify() if it is
+ * shared at that point, readers never copy. Like a plain value, concurrent modification and
+ * copying of the same instance has to be synchronized by the owner.
+ */
+template <typename T>
+class CopyOnWrite {
+public:
+    CopyOnWrite() : data_{std::make_shared<T>()} {}
+    CopyOnWrite(T value) : data_{std::make_shared<T>(std::move(value))} {}
+
+    CopyOnWrite& operator=(T value) {
+        data_ = std::make_shared<T>(std::move(value));
+        return *this;
+    }
+
+    const T& get() const { return *data_; }
+    const T& operator*() const { return *data_; }
+    const T* operator->() const { return data_.get(); }
+
+    /*
+     * Returns a mutable reference to the data, copying it first if it is shared with other
+     * instances.
+     */
+    T& modify() {
+        if (data_.use_count() > 1) data_ = std::make_shared<T>(*data_);
+        return *data_;
+    }
+
+    bool isShared() const { return data_.use_count() > 1; }
+
+private:
+    std::shared_ptr<T> data_;
+};
+
+}  // namespace tensorutil
+}  // namespace inviwo
@@ -34,6 +34,7 @@
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
 #include <inviwo/tensorvisbase/algorithm/tensorfieldsampling.h>
+#include <inviwo/utilities/util/parallel.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 #include <Eigen/Dense>
 #include <modules/eigenutils/eigenutils.h>
@@ -46,18 +47,31 @@ namespace inviwo {
 namespace tensorutil {
 
 IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTexture(
-    std::shared_ptr<Image>& texture, std::shared_ptr<const TensorField2D> tensorField,
+    std::shared_ptr<const Image>& texture, std::shared_ptr<const TensorField2D> tensorField,
     Shader& shader, TextureUnitContainer& textureUnits);
 
-IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTexture(std::shared_ptr<Image>& texture,
-                                                                TensorField2DInport& inport,
+IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTexture(
+    std::shared_ptr<const Image>& texture, TensorField2DInport& inport, Shader& shader,
+    TextureUnitContainer& textureUnits);
+
+IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTexture(const Image& texture,
                                                                 Shader& shader,
                                                                 TextureUnitContainer& textureUnits);
 
+/**
+ * Binds the tensor field as two vec3 volumes, "tensorFieldDiagonal" holding (xx, yy, zz) and
+ * "tensorFieldOffDiagonal" holding (xy, yz, xz). The volumes are returned in textures and have to
+ * be kept alive while the shader is in use.
+ */
 IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTextures(
-    std::shared_ptr<const TensorField3D>& tensorField, Shader* shader,
+    std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>& textures,
+    std::shared_ptr<const TensorField3D> tensorField, Shader& shader,
     TextureUnitContainer& textureUnits);
 
+IVW_MODULE_TENSORVISBASE_API void bindTensorFieldAsColorTextures(
+    const std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>& textures,
+    Shader& shader, TextureUnitContainer& textureUnits);
+
 std::shared_ptr<TensorField2D> IVW_MODULE_TENSORVISBASE_API
 subsample2D(std::shared_ptr<const TensorField2D> tensorField, size2_t newDimensions,
             const InterpolationMethod method = InterpolationMethod::Barycentric);
@@ -68,7 +82,30 @@ IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField3D> subsample3D(
 
 IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField3D> subsample3D(
     std::shared_ptr<const TensorField3D> tensorField, size3_t newDimensions,
-    const InterpolationMethod method, std::function<void(float)> fun);
+    const InterpolationMethod method, std::function<void(float)> fun,
+    std::function<bool()> stop = nullptr);
+
+/**
+ * Downsamples the tensor field by averaging the block of tensors covered by each tensor of the
+ * new field, in parallel over rows or slices of the new field. Dimensions larger than those of
+ * the input are clamped. Blocks containing tensors that are not symmetric positive definite are
+ * averaged linearly.
+ *
+ * With Log-Euclidean averaging the 3D version takes the logarithms from the eigen system of the
+ * input if it is already computed, and the new field inherits the eigen system of the averaged
+ * logarithms when all blocks could be averaged that way.
+ *
+ * The 3D versions of subsampling and downsampling stop starting new slices once stop returns true
+ * and return nullptr in that case.
+ */
+IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField2D> downsample2D(
+    std::shared_ptr<const TensorField2D> tensorField, size2_t newDimensions,
+    const Averaging averaging = Averaging::LogEuclidean);
+
+IVW_MODULE_TENSORVISBASE_API std::shared_ptr<TensorField3D> downsample3D(
+    std::shared_ptr<const TensorField3D> tensorField, size3_t newDimensions,
+    const Averaging averaging = Averaging::LogEuclidean,
+    std::function<void(float)> progress = nullptr, std::function<bool()> stop = nullptr);
 
 IVW_MODULE_TENSORVISBASE_API std::shared_ptr<PosTexColorMesh>
 generateBoundingBoxAdjacencyForTensorField(std::shared_ptr<const TensorField3D> tensorField,
@@ -105,40 +142,31 @@ void forEachVoxel(const TensorField3D& v, C callback) {
     }
 }
 
+/**
+ * Calls callback for every voxel, in parallel over z slices on the Inviwo thread pool. The slices
+ * are split into jobs ranges, or about four per pool thread if jobs is zero. No further slices
+ * are started once stop returns true.
+ */
 template <typename C>
-void forEachVoxelParallel(const TensorField3D& v, C callback, size_t jobs = 0) {
+void forEachVoxelParallel(const TensorField3D& v, C callback, size_t jobs = 0,
+                          const std::function<bool()>& stop = nullptr) {
     const auto& dims = v.getDimensions();
+    const auto grainSize =
+        jobs == 0 ? util::defaultGrainSize(dims.z, 1) : (dims.z + jobs - 1) / jobs;
 
-    if (jobs == 0) {
-        const auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
-        jobs = 4 * settings->poolSize_.get();
-        if (jobs == 0) {  // if poolsize is zero
-            forEachVoxel(v, callback);
-            return;
-        }
-    }
-
-    std::vector<std::future<void>> futures;
-    for (size_t job = 0; job < jobs; ++job) {
-        const auto start = size3_t(0, 0, job * dims.z / jobs);
-        const auto stop = size3_t(dims.x, dims.y, std::min(dims.z, (job + 1) * dims.z / jobs));
-
-        futures.push_back(dispatchPool([&callback, start, stop]() {
+    util::forEachRangeParallel(
+        dims.z, grainSize,
+        [&](size_t begin, size_t end) {
             size3_t pos{0};
-
-            for (pos.z = start.z; pos.z < stop.z; ++pos.z) {
-                for (pos.y = start.y; pos.y < stop.y; ++pos.y) {
-                    for (pos.x = start.x; pos.x < stop.x; ++pos.x) {
+            for (pos.z = begin; pos.z < end; ++pos.z) {
+                for (pos.y = 0; pos.y < dims.y; ++pos.y) {
+                    for (pos.x = 0; pos.x < dims.x; ++pos.x) {
                         callback(pos);
                     }
                 }
             }
-        }));
-    }
-
-    for (const auto& e : futures) {
-        e.wait();
-    }
+        },
+        stop);
 }
 
 template <typename C>
@@ -152,38 +180,28 @@ void forEachFixel(const TensorField2D& v, C callback) {
     }
 }
 
+/**
+ * Calls callback for every fixel, in parallel over rows on the Inviwo thread pool, see
+ * forEachVoxelParallel.
+ */
 template <typename C>
-void forEachFixelParallel(const TensorField2D& v, C callback, size_t jobs = 0) {
+void forEachFixelParallel(const TensorField2D& v, C callback, size_t jobs = 0,
+                          const std::function<bool()>& stop = nullptr) {
     const auto& dims = v.getDimensions();
+    const auto grainSize =
+        jobs == 0 ? util::defaultGrainSize(dims.y, 1) : (dims.y + jobs - 1) / jobs;
 
-    if (jobs == 0) {
-        const auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
-        jobs = 4 * settings->poolSize_.get();
-        if (jobs == 0) {  // if poolsize is zero
-            forEachFixel(v, callback);
-            return;
-        }
-    }
-
-    std::vector<std::future<void>> futures;
-    for (size_t job = 0; job < jobs; ++job) {
-        const auto start = size2_t(0, job * dims.y / jobs);
-        const auto stop = size2_t(dims.x, std::min(dims.y, (job + 1) * dims.y / jobs));
-
-        futures.push_back(dispatchPool([&callback, start, stop]() {
+    util::forEachRangeParallel(
+        dims.y, grainSize,
+        [&](size_t begin, size_t end) {
             size2_t pos{0};
-
-            for (pos.y = start.y; pos.y < stop.y; ++pos.y) {
-                for (pos.x = start.x; pos.x < stop.x; ++pos.x) {
+            for (pos.y = begin; pos.y < end; ++pos.y) {
+                for (pos.x = 0; pos.x < dims.x; ++pos.x) {
                     callback(pos);
                 }
             }
-        }));
-    }
-
-    for (const auto& e : futures) {
-        e.wait();
-    }
+        },
+        stop);
 }
 
 }  // namespace tensorutil
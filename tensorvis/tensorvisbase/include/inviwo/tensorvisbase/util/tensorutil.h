@@ -38,9 +38,18 @@
 #include <modules/opengl/shader/shaderutils.h>
 #include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
 
+#include <optional>
+
 namespace inviwo {
 namespace tensorutil {
 
+/*
+ * How blocks of tensors are averaged when downsampling. Log-Euclidean averaging averages the
+ * matrix logarithms, which preserves the determinant and avoids the swelling of linear
+ * averaging, and is only defined for symmetric positive definite tensors.
+ */
+enum class Averaging { Linear, LogEuclidean };
+
 enum class Anisotropy {
     abs_lamda1_minus_lamda2,
     abs_lamda1_minus_lamda3,
@@ -173,13 +182,56 @@ dmat3 IVW_MODULE_TENSORVISBASE_API meanNormalStressTensor(const dmat3& tensor);
 dmat3 IVW_MODULE_TENSORVISBASE_API meanHydrostaticStressTensor(const dmat3& tensor);
 dmat3 IVW_MODULE_TENSORVISBASE_API volumetricStressTensor(const dmat3& tensor);
 
+/*
+ * Returns true if the off-diagonal elements of the tensor match up to a tolerance relative to the
+ * largest absolute element of the tensor.
+ */
+bool IVW_MODULE_TENSORVISBASE_API isSymmetric(const dmat3& tensor, double epsilon = 1e-12);
+bool IVW_MODULE_TENSORVISBASE_API isSymmetric(const dmat2& tensor, double epsilon = 1e-12);
+
+/*
+ * Closed-form eigen decomposition for symmetric tensors. Only the lower triangle of the tensor is
+ * considered. The result is sorted such that lambda1>lambda2>lambda3 and the eigenvectors are
+ * normalized.
+ */
+std::array<std::pair<double, dvec3>, 3> IVW_MODULE_TENSORVISBASE_API
+calculateSymmetricEigenValuesAndEigenVectors(const dmat3& tensor);
+
 std::array<std::pair<double, dvec3>, 3> IVW_MODULE_TENSORVISBASE_API
 calculateEigenValuesAndEigenVectors(const dmat3& tensor);
 
+/*
+ * Closed-form eigen decomposition of count symmetric 2x2 tensors, e.g. a row of a 2D tensor field.
+ * Only the lower triangle of the tensors is considered. The results are sorted such that
+ * lambda1>=lambda2 and the eigenvectors are normalized, isotropic tensors get the x and y axes.
+ * The loop body has no branches so that it can be vectorized by the compiler.
+ */
+void IVW_MODULE_TENSORVISBASE_API calculateSymmetricEigenSystems(
+    const dmat2* tensors, size_t count, double* majorEigenValues, double* minorEigenValues,
+    dvec2* majorEigenVectors, dvec2* minorEigenVectors);
+
 std::array<double, 3> IVW_MODULE_TENSORVISBASE_API calculateEigenValues(const dmat3& tensor);
 
 dmat3 IVW_MODULE_TENSORVISBASE_API calculateEigenSystem(const dmat3& tensor);
 
+/*
+ * Matrix logarithm of a symmetric positive definite tensor, sum(log(lambda_i) * v_i * v_i^T).
+ * Returns std::nullopt for tensors that are not symmetric positive definite.
+ */
+std::optional<dmat2> IVW_MODULE_TENSORVISBASE_API logTensor(const dmat2& tensor);
+std::optional<dmat3> IVW_MODULE_TENSORVISBASE_API logTensor(const dmat3& tensor);
+
+/*
+ * Matrix logarithm from an already computed eigen system. Returns std::nullopt unless all
+ * eigenvalues are positive.
+ */
+std::optional<dmat3> IVW_MODULE_TENSORVISBASE_API logTensor(
+    const std::array<std::pair<double, dvec3>, 3>& eigenSystem);
+
+// Matrix exponential of a symmetric tensor, the inverse of logTensor
+dmat2 IVW_MODULE_TENSORVISBASE_API expTensor(const dmat2& tensor);
+dmat3 IVW_MODULE_TENSORVISBASE_API expTensor(const dmat3& tensor);
+
 static const std::string lamda_str{u8"λ"};
 
 static const std::string lamda1_str{u8"λ₁"};
@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisbase/tensorvisbasemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <limits>
+#include <vector>
+
+namespace inviwo {
+namespace tensorutil {
+
+/**
+ * Minimum and maximum of a volume over all of its channels, together with the minimum and
+ * maximum of each brick of brickSize^3 voxels. The bricks are reduced in parallel, each row of
+ * a brick in a tight loop over the contiguous components which the compiler can vectorize.
+ *
+ * The range of a sub-box is combined from the ranges of the bricks it overlaps, hence it costs
+ * O(bricks) instead of a scan of the voxels. It encloses the actual range of the sub-box, which
+ * it matches exactly if the box is aligned with the bricks.
+ */
+class IVW_MODULE_TENSORVISBASE_API VolumeRangeSummary {
+public:
+    VolumeRangeSummary() = default;
+    VolumeRangeSummary(const VolumeRAM& volume, size_t brickSize = 32);
+
+    /**
+     * Range of all voxels, an inverted range (min > max) if the volume is empty
+     */
+    dvec2 range() const { return range_; }
+    /**
+     * Range of the bricks overlapping the voxels from lower to upper, both inclusive. An
+     * inverted range (min > max) if the box is empty.
+     */
+    dvec2 range(const size3_t& lower, const size3_t& upper) const;
+
+    const size3_t& getDimensions() const { return dims_; }
+    size_t getBrickSize() const { return brickSize_; }
+    const size3_t& getBrickCount() const { return bricks_; }
+    const std::vector<dvec2>& getBrickRanges() const { return brickRanges_; }
+
+private:
+    size3_t dims_{0};
+    size_t brickSize_ = 1;
+    size3_t bricks_{0};
+    std::vector<dvec2> brickRanges_;
+    dvec2 range_{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+};
+
+}  // namespace tensorutil
+}  // namespace inviwo
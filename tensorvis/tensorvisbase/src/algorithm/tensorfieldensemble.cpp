@@ -0,0 +1,209 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldensemble.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inviwo {
+namespace tensorutil {
+
+namespace {
+
+double frobeniusNorm(const dmat3& tensor) {
+    double sum = 0.0;
+    for (glm::length_t i = 0; i < 3; ++i) {
+        sum += glm::dot(tensor[i], tensor[i]);
+    }
+    return std::sqrt(sum);
+}
+
+dvec3 majorEigenVector(const dmat3& tensor) {
+    return calculateSymmetricEigenValuesAndEigenVectors(tensor)[0].second;
+}
+
+}  // namespace
+
+std::optional<EnsembleStatistics> ensembleStatistics(const TensorField3DSequence& ensemble,
+                                                     EnsembleDistance distance,
+                                                     const std::function<bool()>& stop,
+                                                     const std::function<void(float)>& progress) {
+    const auto numMembers = ensemble.size();
+    if (numMembers == 0) {
+        throw Exception("Ensemble has no members",
+                        IVW_CONTEXT_CUSTOM("tensorutil::ensembleStatistics"));
+    }
+
+    const auto isStopped = [&]() { return stop && stop(); };
+    const auto reportProgress = [&](size_t pass, size_t member) {
+        if (progress) {
+            progress(static_cast<float>(pass * numMembers + member + 1) /
+                     static_cast<float>(2 * numMembers));
+        }
+    };
+
+    EnsembleStatistics result;
+    size_t size = 0;
+
+    const auto getMember = [&](size_t member) {
+        auto field = ensemble.get(member);
+        if (!field) {
+            throw Exception("Failed to load ensemble member " + std::to_string(member),
+                            IVW_CONTEXT_CUSTOM("tensorutil::ensembleStatistics"));
+        }
+        if (member == 0 && size == 0) {
+            result.dimensions = field->getDimensions();
+            result.basisAndOffset = field->getBasisAndOffset();
+            size = field->getSize();
+        } else if (field->getDimensions() != result.dimensions) {
+            throw Exception("Ensemble member " + std::to_string(member) + " has dimensions " +
+                                toString(field->getDimensions()) + ", expected " +
+                                toString(result.dimensions),
+                            IVW_CONTEXT_CUSTOM("tensorutil::ensembleStatistics"));
+        }
+        return field;
+    };
+
+    // Pass 1: mean tensor, of the matrix logarithms for the Log-Euclidean distance. Tensors which
+    // are not symmetric positive definite do not contribute, hence the per voxel counts.
+    std::vector<dmat3> meanTensors;
+    std::vector<uint32_t> counts;
+    for (size_t member = 0; member < numMembers; ++member) {
+        const auto field = getMember(member);
+        if (member == 0) {
+            meanTensors.assign(size, dmat3(0.0));
+            counts.assign(size, 0);
+        }
+
+        const bool done = util::forEachRangeParallel(
+            size, util::defaultGrainSize(size),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const auto tensor = field->tensor(i);
+                    if (distance == EnsembleDistance::LogEuclidean) {
+                        if (const auto log = logTensor(tensor)) {
+                            meanTensors[i] += *log;
+                            ++counts[i];
+                        }
+                    } else {
+                        meanTensors[i] += tensor;
+                        ++counts[i];
+                    }
+                }
+            },
+            stop);
+        if (!done || isStopped()) return std::nullopt;
+        reportProgress(0, member);
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        if (counts[i] > 0) meanTensors[i] /= static_cast<double>(counts[i]);
+    }
+
+    std::vector<dvec3> meanMajorEigenVectors;
+    if (distance == EnsembleDistance::EigenAngle) {
+        meanMajorEigenVectors.resize(size);
+        const bool done = util::forEachRangeParallel(
+            size, util::defaultGrainSize(size),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    meanMajorEigenVectors[i] = majorEigenVector(meanTensors[i]);
+                }
+            },
+            stop);
+        if (!done || isStopped()) return std::nullopt;
+        std::vector<dmat3>{}.swap(meanTensors);
+    }
+
+    // Pass 2: running mean and variance (Welford) and maximum of the distances to the mean
+    result.mean.assign(size, 0.0);
+    result.variance.assign(size, 0.0);
+    std::vector<double> maxDistances(size, 0.0);
+    counts.assign(size, 0);
+
+    for (size_t member = 0; member < numMembers; ++member) {
+        const auto field = getMember(member);
+        const std::vector<dvec3>* majorEigenVectors =
+            distance == EnsembleDistance::EigenAngle ? &field->majorEigenVectors() : nullptr;
+
+        const bool done = util::forEachRangeParallel(
+            size, util::defaultGrainSize(size),
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    double d = 0.0;
+                    switch (distance) {
+                        case EnsembleDistance::Frobenius:
+                            d = frobeniusNorm(field->tensor(i) - meanTensors[i]);
+                            break;
+                        case EnsembleDistance::LogEuclidean:
+                            if (const auto log = logTensor(field->tensor(i))) {
+                                d = frobeniusNorm(*log - meanTensors[i]);
+                            } else {
+                                continue;
+                            }
+                            break;
+                        case EnsembleDistance::EigenAngle:
+                            d = std::acos(std::min(
+                                1.0, std::abs(glm::dot((*majorEigenVectors)[i],
+                                                       meanMajorEigenVectors[i]))));
+                            break;
+                    }
+
+                    const auto n = static_cast<double>(++counts[i]);
+                    const auto delta = d - result.mean[i];
+                    result.mean[i] += delta / n;
+                    result.variance[i] += delta * (d - result.mean[i]);
+                    maxDistances[i] = std::max(maxDistances[i], d);
+                }
+            },
+            stop);
+        if (!done || isStopped()) return std::nullopt;
+        reportProgress(1, member);
+    }
+
+    result.outlierScore.assign(size, 0.0);
+    for (size_t i = 0; i < size; ++i) {
+        if (counts[i] == 0) continue;
+        result.variance[i] /= static_cast<double>(counts[i]);
+        const auto stdDev = std::sqrt(result.variance[i]);
+        if (stdDev > 0.0) {
+            result.outlierScore[i] = (maxDistances[i] - result.mean[i]) / stdDev;
+        }
+    }
+
+    return result;
+}
+
+}  // namespace tensorutil
+}  // namespace inviwo
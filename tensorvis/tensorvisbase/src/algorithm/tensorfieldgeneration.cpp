@@ -0,0 +1,218 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldgeneration.h>
+#include <inviwo/tensorvisbase/datastructures/symmetrictensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfieldmetadataspecializations.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <random>
+
+namespace inviwo {
+namespace tensorutil {
+
+namespace {
+
+// Decorrelates the seeds of neighbouring slices
+constexpr uint64_t splitMix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+template <typename T>
+std::unique_ptr<MetaDataBase> makeMetaData(std::vector<typename T::TType> data,
+                                           TensorFeature type) {
+    auto metaData = std::make_unique<T>();
+    metaData->data_ = std::move(data);
+    metaData->type_ = type;
+    return metaData;
+}
+
+}  // namespace
+
+std::shared_ptr<TensorField3D> generateTensorField3D(const SyntheticTensorField3D& settings,
+                                                     std::function<void(float)> progress) {
+    const auto dimensions = settings.dimensions;
+    if (glm::compMul(dimensions) == 0) {
+        throw Exception("Synthetic tensor field with zero-sized dimension",
+                        IVW_CONTEXT_CUSTOM("tensorutil::generateTensorField3D"));
+    }
+    const auto size = glm::compMul(dimensions);
+    const auto sliceSize = dimensions.x * dimensions.y;
+    // Keeps the eigenvalues positive
+    const auto noise = glm::clamp(settings.noise, 0.0, 0.9);
+
+    std::vector<dmat3> tensors;
+    SymmetricTensorStorage3D<double> packed;
+    SymmetricTensorStorage3D<float> packedFloat;
+    FullTensorStorage3D<float> fullFloat;
+    // Generated fields have no mask, sparse storage falls back to full tensors
+    switch (settings.storage) {
+        case TensorStorage::Full:
+        case TensorStorage::Sparse:
+            tensors.resize(size);
+            break;
+        case TensorStorage::Symmetric:
+            packed = SymmetricTensorStorage3D<double>(size);
+            break;
+        case TensorStorage::SymmetricFloat:
+            packedFloat = SymmetricTensorStorage3D<float>(size);
+            break;
+        case TensorStorage::FullFloat:
+            fullFloat = FullTensorStorage3D<float>(size);
+            break;
+    }
+    const auto store = [&](size_t i, const dmat3& tensor) {
+        switch (settings.storage) {
+            case TensorStorage::Full:
+            case TensorStorage::Sparse:
+                tensors[i] = tensor;
+                break;
+            case TensorStorage::Symmetric:
+                packed.set(i, tensor);
+                break;
+            case TensorStorage::SymmetricFloat:
+                packedFloat.set(i, tensor);
+                break;
+            case TensorStorage::FullFloat:
+                fullFloat.set(i, tensor);
+                break;
+        }
+    };
+
+    std::array<std::vector<double>, 3> eigenValues;
+    std::array<std::vector<dvec3>, 3> eigenVectors;
+    if (settings.eigenSystem) {
+        for (size_t k = 0; k < 3; ++k) {
+            eigenValues[k].resize(size);
+            eigenVectors[k].resize(size);
+        }
+    }
+
+    std::atomic<size_t> slicesDone{0};
+    std::mutex progressMutex;
+
+    std::vector<size_t> slices(dimensions.z);
+    util::forEachParallel(slices, [&](size_t, size_t z) {
+        std::mt19937_64 engine(splitMix64(settings.seed ^ splitMix64(z)));
+        std::uniform_real_distribution<double> dist(-noise, noise);
+
+        const auto pz = static_cast<double>(z) / static_cast<double>(dimensions.z);
+        for (size_t y = 0; y < dimensions.y; ++y) {
+            const auto py = static_cast<double>(y) / static_cast<double>(dimensions.y);
+            for (size_t x = 0; x < dimensions.x; ++x) {
+                const auto px = static_cast<double>(x) / static_cast<double>(dimensions.x);
+                const auto theta = glm::two_pi<double>() * pz + dist(engine);
+                const auto phi = 0.5 * glm::half_pi<double>() * (2.0 * px - 1.0) + dist(engine);
+
+                // Orthonormal eigen frame and positive eigenvalues
+                const dvec3 e1{std::cos(theta) * std::cos(phi), std::sin(theta) * std::cos(phi),
+                               std::sin(phi)};
+                const dvec3 e2{-std::sin(theta), std::cos(theta), 0.0};
+                std::array<std::pair<double, dvec3>, 3> eigen{
+                    {{(3.0 + std::sin(glm::two_pi<double>() * py)) * (1.0 + dist(engine)), e1},
+                     {1.5 * (1.0 + dist(engine)), e2},
+                     {0.5 * (1.0 + dist(engine)), glm::cross(e1, e2)}}};
+                // Strong noise can reorder the eigenvalues
+                std::sort(eigen.begin(), eigen.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+
+                const auto i = x + y * dimensions.x + z * sliceSize;
+                dmat3 tensor{0.0};
+                for (size_t k = 0; k < 3; ++k) {
+                    tensor += eigen[k].first * glm::outerProduct(eigen[k].second, eigen[k].second);
+                }
+                store(i, tensor);
+
+                if (settings.eigenSystem) {
+                    for (size_t k = 0; k < 3; ++k) {
+                        eigenValues[k][i] = eigen[k].first;
+                        eigenVectors[k][i] = eigen[k].second;
+                    }
+                }
+            }
+        }
+
+        if (progress) {
+            std::scoped_lock lock{progressMutex};
+            progress(static_cast<float>(++slicesDone) / static_cast<float>(dimensions.z));
+        }
+    });
+
+    std::shared_ptr<TensorField3D> tensorField;
+    switch (settings.storage) {
+        case TensorStorage::Full:
+        case TensorStorage::Sparse:
+            tensorField =
+                std::make_shared<TensorField3D>(dimensions, std::move(tensors), settings.extent);
+            break;
+        case TensorStorage::Symmetric:
+            tensorField =
+                std::make_shared<TensorField3D>(dimensions, std::move(packed), settings.extent);
+            break;
+        case TensorStorage::SymmetricFloat:
+            tensorField = std::make_shared<TensorField3D>(dimensions, std::move(packedFloat),
+                                                          settings.extent);
+            break;
+        case TensorStorage::FullFloat:
+            tensorField = std::make_shared<TensorField3D>(dimensions, std::move(fullFloat),
+                                                          settings.extent);
+            break;
+    }
+
+    if (settings.eigenSystem) {
+        std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData;
+        metaData[MajorEigenValues::id()] =
+            makeMetaData<MajorEigenValues>(std::move(eigenValues[0]), TensorFeature::Sigma1);
+        metaData[IntermediateEigenValues::id()] = makeMetaData<IntermediateEigenValues>(
+            std::move(eigenValues[1]), TensorFeature::Sigma2);
+        metaData[MinorEigenValues::id()] =
+            makeMetaData<MinorEigenValues>(std::move(eigenValues[2]), TensorFeature::Sigma3);
+        metaData[MajorEigenVectors::id()] = makeMetaData<MajorEigenVectors>(
+            std::move(eigenVectors[0]), TensorFeature::MajorEigenVector);
+        metaData[IntermediateEigenVectors::id()] = makeMetaData<IntermediateEigenVectors>(
+            std::move(eigenVectors[1]), TensorFeature::IntermediateEigenVector);
+        metaData[MinorEigenVectors::id()] = makeMetaData<MinorEigenVectors>(
+            std::move(eigenVectors[2]), TensorFeature::MinorEigenVector);
+        // Skips the deferred eigen decomposition of the field
+        tensorField->setMetaData(std::move(metaData));
+    }
+
+    return tensorField;
+}
+
+}  // namespace tensorutil
+}  // namespace inviwo
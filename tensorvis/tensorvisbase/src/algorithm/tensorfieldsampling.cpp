@@ -117,53 +117,186 @@ dmat2 sample(std::shared_ptr<const TensorField2D> tensorField, const dvec2& posi
 std::pair<glm::uint8, dmat3> sample(std::shared_ptr<const TensorField3D> tensorField,
                                     const dvec3& position,
                                     const tensorutil::InterpolationMethod method) {
-    // Position is in texture space [0,1], translate to index space
-    const auto bounds = tensorField->getBounds<double>();
-    const auto indexPosition = position * bounds;
+    switch (method) {
+        case tensorutil::InterpolationMethod::Linear:
+            return sample<tensorutil::InterpolationMethod::Linear>(*tensorField, position);
+        case tensorutil::InterpolationMethod::Nearest:
+            return sample<tensorutil::InterpolationMethod::Nearest>(*tensorField, position);
+        case tensorutil::InterpolationMethod::Barycentric:
+            return sample<tensorutil::InterpolationMethod::Barycentric>(*tensorField, position);
+    }
+    return std::pair<glm::uint8, dmat3>(glm::uint8{1}, dmat3{0.0});
+}
 
-    dmat3 val{0.0};
+TensorField3DSampleFunction makeSampleFunction(std::shared_ptr<const TensorField3D> tensorField,
+                                               const tensorutil::InterpolationMethod method) {
+    switch (method) {
+        case tensorutil::InterpolationMethod::Nearest:
+            return [tensorField](const dvec3& position) {
+                return sample<tensorutil::InterpolationMethod::Nearest>(*tensorField, position);
+            };
+        case tensorutil::InterpolationMethod::Barycentric:
+            return [tensorField](const dvec3& position) {
+                return sample<tensorutil::InterpolationMethod::Barycentric>(*tensorField,
+                                                                            position);
+            };
+        case tensorutil::InterpolationMethod::Linear:
+        default:
+            return [tensorField](const dvec3& position) {
+                return sample<tensorutil::InterpolationMethod::Linear>(*tensorField, position);
+            };
+    }
+}
 
-    if (method == tensorutil::InterpolationMethod::Linear) {
-        const auto xm = glm::floor(indexPosition.x);
-        const auto ym = glm::floor(indexPosition.y);
-        const auto zm = glm::floor(indexPosition.z);
+TensorField3DSampler::TensorField3DSampler(const TensorField3D& tensorField,
+                                           tensorutil::InterpolationMethod method)
+    : method_(method)
+    , dimensions_(tensorField.getDimensions())
+    , bounds_(dvec3(dimensions_ - size3_t(1)))
+    , strideY_(dimensions_.x)
+    , strideZ_(dimensions_.x * dimensions_.y) {
 
-        const auto xp = glm::ceil(indexPosition.x);
-        const auto yp = glm::ceil(indexPosition.y);
-        const auto zp = glm::ceil(indexPosition.z);
+    if (const auto packed = tensorField.symmetricTensors<double>()) {
+        for (size_t c = 0; c < 6; ++c) components_[c] = packed->component(c).data();
+    } else if (const auto packed = tensorField.symmetricTensors<float>()) {
+        for (size_t c = 0; c < 6; ++c) floatComponents_[c] = packed->component(c).data();
+    } else if (const auto full = tensorField.floatTensors()) {
+        floatTensors_ = full->tensors().data();
+    } else {
+        tensors_ = tensorField.tensors().data();
+    }
+}
 
-        const auto xFrac = glm::fract(position.x * bounds.x);
-        const auto yFrac = glm::fract(position.y * bounds.y);
-        const auto zFrac = glm::fract(position.z * bounds.z);
+dmat3 TensorField3DSampler::sample(const dvec3& position) const {
+    if (method_ == tensorutil::InterpolationMethod::Nearest) {
+        return get(nearestIndex(position));
+    }
+    return interpolate(corners(position));
+}
 
-        // Upper layer
-        const auto& tensor010 = tensorField->at(size3_t(xm, yp, zm)).second;
-        const auto& tensor011 = tensorField->at(size3_t(xm, yp, zp)).second;
-        const auto tensorUpperLeft = glm::mix(tensor010, tensor011, zFrac);
+void TensorField3DSampler::sample(const dvec3* positions, size_t count, dmat3* result) const {
+    // Dispatch once for the whole batch
+    if (method_ == tensorutil::InterpolationMethod::Nearest) {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = get(nearestIndex(positions[i]));
+        }
+    } else if (tensors_) {
+        for (size_t i = 0; i < count; ++i) {
+            const auto c = corners(positions[i]);
+            dmat3 tensor{0.0};
+            for (size_t j = 0; j < 8; ++j) {
+                tensor += c.weights[j] * tensors_[c.indices[j]];
+            }
+            result[i] = tensor;
+        }
+    } else if (floatTensors_) {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = interpolate(corners(positions[i]));
+        }
+    } else if (components_[0]) {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = interpolatePacked(components_, corners(positions[i]));
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = interpolatePacked(floatComponents_, corners(positions[i]));
+        }
+    }
+}
 
-        const auto& tensor111 = tensorField->at(size3_t(xp, yp, zp)).second;
-        const auto& tensor110 = tensorField->at(size3_t(xp, yp, zm)).second;
-        const auto tensorUpperRight = glm::mix(tensor110, tensor111, zFrac);
+std::vector<dmat3> TensorField3DSampler::sample(const std::vector<dvec3>& positions) const {
+    std::vector<dmat3> result(positions.size());
+    sample(positions.data(), positions.size(), result.data());
+    return result;
+}
 
-        const auto tensorUpper = glm::mix(tensorUpperLeft, tensorUpperRight, xFrac);
+size_t TensorField3DSampler::nearestIndex(const dvec3& position) const {
+    const auto index =
+        size3_t(glm::round(glm::clamp(position, dvec3(0.0), dvec3(1.0)) * bounds_));
+    return index.x + index.y * strideY_ + index.z * strideZ_;
+}
 
-        // Lower layer
-        const auto& tensor000 = tensorField->at(size3_t(xm, ym, zm)).second;
-        const auto& tensor001 = tensorField->at(size3_t(xm, ym, zp)).second;
-        const auto tensorLowerLeft = glm::mix(tensor000, tensor001, zFrac);
+TensorField3DSampler::Corners TensorField3DSampler::corners(const dvec3& position) const {
+    const auto indexPosition = glm::clamp(position, dvec3(0.0), dvec3(1.0)) * bounds_;
+    const auto lower = glm::floor(indexPosition);
+    const auto frac = indexPosition - lower;
 
-        const auto& tensor100 = tensorField->at(size3_t(xp, ym, zm)).second;
-        const auto& tensor101 = tensorField->at(size3_t(xp, ym, zp)).second;
-        const auto tensorLowerRight = glm::mix(tensor100, tensor101, zFrac);
+    const auto i0 = size3_t(lower);
+    const auto i1 = glm::min(i0 + size3_t(1), dimensions_ - size3_t(1));
 
-        const auto tensorLower = glm::mix(tensorLowerLeft, tensorLowerRight, xFrac);
+    const size_t x[2] = {i0.x, i1.x};
+    const size_t y[2] = {i0.y * strideY_, i1.y * strideY_};
+    const size_t z[2] = {i0.z * strideZ_, i1.z * strideZ_};
+    const double wx[2] = {1.0 - frac.x, frac.x};
+    const double wy[2] = {1.0 - frac.y, frac.y};
+    const double wz[2] = {1.0 - frac.z, frac.z};
 
-        val = glm::mix(tensorLower, tensorUpper, yFrac);
-    } else {
-        if (method == tensorutil::InterpolationMethod::Nearest) {
-            val = tensorField->at(size3_t(glm::round(indexPosition))).second;
+    Corners c;
+    for (size_t k = 0; k < 2; ++k) {
+        for (size_t j = 0; j < 2; ++j) {
+            for (size_t i = 0; i < 2; ++i) {
+                const auto corner = i + 2 * j + 4 * k;
+                c.indices[corner] = x[i] + y[j] + z[k];
+                c.weights[corner] = wx[i] * wy[j] * wz[k];
+            }
+        }
+    }
+    return c;
+}
+
+dmat3 TensorField3DSampler::get(size_t index) const {
+    if (tensors_) return tensors_[index];
+    if (floatTensors_) return dmat3(floatTensors_[index]);
+
+    Corners c{};
+    c.indices[0] = index;
+    c.weights[0] = 1.0;
+    return components_[0] ? interpolatePacked(components_, c)
+                          : interpolatePacked(floatComponents_, c);
+}
+
+dmat3 TensorField3DSampler::interpolate(const Corners& c) const {
+    if (tensors_) {
+        dmat3 tensor{0.0};
+        for (size_t j = 0; j < 8; ++j) {
+            tensor += c.weights[j] * tensors_[c.indices[j]];
         }
+        return tensor;
     }
-    return std::pair<glm::uint8, dmat3>(glm::uint8{1}, dmat3());
+    if (floatTensors_) {
+        // Accumulate in double precision, only the loads are in float
+        dmat3 tensor{0.0};
+        for (size_t j = 0; j < 8; ++j) {
+            tensor += c.weights[j] * dmat3(floatTensors_[c.indices[j]]);
+        }
+        return tensor;
+    }
+    return components_[0] ? interpolatePacked(components_, c)
+                          : interpolatePacked(floatComponents_, c);
 }
+
+template <typename T>
+dmat3 TensorField3DSampler::interpolatePacked(const std::array<const T*, 6>& components,
+                                              const Corners& c) {
+    // Interpolate each of the six unique components separately, this only touches contiguous
+    // arrays and is straightforward to vectorize
+    std::array<double, 6> values{};
+    for (size_t comp = 0; comp < 6; ++comp) {
+        const auto data = components[comp];
+        double value = 0.0;
+        for (size_t j = 0; j < 8; ++j) {
+            value += c.weights[j] * static_cast<double>(data[c.indices[j]]);
+        }
+        values[comp] = value;
+    }
+
+    dmat3 tensor;
+    const auto indices = SymmetricTensorStorage3D<T>::indices();
+    for (size_t comp = 0; comp < 6; ++comp) {
+        const auto [col, row] = indices[comp];
+        tensor[col][row] = tensor[row][col] = values[comp];
+    }
+    return tensor;
+}
+
 }  // namespace inviwo
\ No newline at end of file
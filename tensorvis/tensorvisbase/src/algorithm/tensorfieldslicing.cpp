@@ -30,62 +30,86 @@
 #include <inviwo/tensorvisbase/algorithm/tensorfieldslicing.h>
 #include <inviwo/core/util/indexmapper.h>
 #include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <algorithm>
 
 namespace inviwo {
 namespace detail {
-std::shared_ptr<TensorField2D> getSlice2D(std::shared_ptr<const TensorField3D> inTensorField,
-                                          const CartesianCoordinateAxis axis,
-                                          const size_t sliceNumber) {
-    auto fieldDimensions = inTensorField->getDimensions();
-    size2_t dimensions{0};
+namespace {
+/*
+ * Indices into the 3D field of the voxels in the slice, in the row-major order of the slice. The
+ * slice spans (y, z) for X, (x, z) for Y, and (x, y) for Z.
+ */
+std::vector<size_t> sliceIndices(const size3_t& dimensions, const CartesianCoordinateAxis axis,
+                                 const size_t sliceNumber) {
+    const util::IndexMapper3D indexMapper(dimensions);
+    std::vector<size_t> indices;
 
     switch (axis) {
         case CartesianCoordinateAxis::X:
-            dimensions = size2_t(fieldDimensions.y, fieldDimensions.z);
+            indices.reserve(dimensions.y * dimensions.z);
+            for (size_t z = 0; z < dimensions.z; z++) {
+                for (size_t y = 0; y < dimensions.y; y++) {
+                    indices.push_back(indexMapper(size3_t(sliceNumber, y, z)));
+                }
+            }
             break;
         case CartesianCoordinateAxis::Y:
-            dimensions = size2_t(fieldDimensions.x, fieldDimensions.z);
+            indices.reserve(dimensions.x * dimensions.z);
+            for (size_t z = 0; z < dimensions.z; z++) {
+                for (size_t x = 0; x < dimensions.x; x++) {
+                    indices.push_back(indexMapper(size3_t(x, sliceNumber, z)));
+                }
+            }
             break;
         case CartesianCoordinateAxis::Z:
-            dimensions = size2_t(fieldDimensions.x, fieldDimensions.y);
+            indices.reserve(dimensions.x * dimensions.y);
+            const auto first = indexMapper(size3_t(0, 0, sliceNumber));
+            for (size_t i = 0; i < dimensions.x * dimensions.y; i++) {
+                indices.push_back(first + i);
+            }
             break;
     }
 
-    util::IndexMapper2D indexMapper(dimensions);
+    return indices;
+}
 
-    std::vector<dmat2> sliceData;
-    sliceData.resize(dimensions.x * dimensions.y);
+template <typename T>
+std::vector<T> gather(const std::vector<T>& data, const std::vector<size_t>& indices) {
+    std::vector<T> result(indices.size());
+    std::transform(indices.begin(), indices.end(), result.begin(),
+                   [&](size_t i) { return data[i]; });
+    return result;
+}
+}  // namespace
+
+std::shared_ptr<TensorField2D> getSlice2D(std::shared_ptr<const TensorField3D> inTensorField,
+                                          const CartesianCoordinateAxis axis,
+                                          const size_t sliceNumber) {
+    auto fieldDimensions = inTensorField->getDimensions();
+    size2_t dimensions{0};
 
     switch (axis) {
         case CartesianCoordinateAxis::X:
-            for (size_t z = 0; z < dimensions.y; z++) {
-                for (size_t y = 0; y < dimensions.x; y++) {
-                    auto x = sliceNumber;
-                    sliceData[indexMapper(size2_t(y, z))] =
-                        tensorutil::getProjectedTensor(inTensorField->at(x, y, z).second, axis);
-                }
-            }
+            dimensions = size2_t(fieldDimensions.y, fieldDimensions.z);
             break;
         case CartesianCoordinateAxis::Y:
-            for (size_t z = 0; z < dimensions.y; z++) {
-                for (size_t x = 0; x < dimensions.x; x++) {
-                    auto y = sliceNumber;
-                    sliceData[indexMapper(size2_t(x, z))] =
-                        tensorutil::getProjectedTensor(inTensorField->at(x, y, z).second, axis);
-                }
-            }
+            dimensions = size2_t(fieldDimensions.x, fieldDimensions.z);
             break;
         case CartesianCoordinateAxis::Z:
-            for (size_t y = 0; y < dimensions.y; y++) {
-                for (size_t x = 0; x < dimensions.x; x++) {
-                    auto z = sliceNumber;
-                    sliceData[indexMapper(size2_t(x, y))] =
-                        tensorutil::getProjectedTensor(inTensorField->at(x, y, z).second, axis);
-                }
-            }
+            dimensions = size2_t(fieldDimensions.x, fieldDimensions.y);
             break;
     }
 
+    const auto indices = sliceIndices(fieldDimensions, axis, sliceNumber);
+
+    // tensor(i) reads packed storage directly instead of expanding the whole field
+    std::vector<dmat2> sliceData(indices.size());
+    util::forEachParallel(indices, [&](size_t index, size_t i) {
+        sliceData[i] = tensorutil::getProjectedTensor(inTensorField->tensor(index), axis);
+    });
+
     auto tensorField = std::make_shared<TensorField2D>(dimensions, sliceData);
     tensorField->setOffset(inTensorField->getOffset());
 
@@ -98,6 +122,7 @@ std::shared_ptr<TensorField3D> getSlice3D(std::shared_ptr<const TensorField3D> i
     auto fieldDimensions = inTensorField->getDimensions();
     size3_t dimensions{0};
     float frac{0.0f};
+    vec3 offset{0};
 
     auto stepSize = inTensorField->getSpacing<float>();
 
@@ -105,58 +130,104 @@ std::shared_ptr<TensorField3D> getSlice3D(std::shared_ptr<const TensorField3D> i
         case CartesianCoordinateAxis::X:
             dimensions = size3_t(1, fieldDimensions.y, fieldDimensions.z);
             frac = static_cast<float>(sliceNumber) * stepSize.x;
+            offset.x = frac;
             break;
         case CartesianCoordinateAxis::Y:
             dimensions = size3_t(fieldDimensions.x, 1, fieldDimensions.z);
             frac = static_cast<float>(sliceNumber) * stepSize.y;
+            offset.y = frac;
             break;
         case CartesianCoordinateAxis::Z:
             dimensions = size3_t(fieldDimensions.x, fieldDimensions.y, 1);
             frac = static_cast<float>(sliceNumber) * stepSize.z;
+            offset.z = frac;
             break;
     }
 
-    util::IndexMapper3D indexMapper(dimensions);
-
-    std::vector<dmat3> sliceData{};
-    sliceData.resize(dimensions.x * dimensions.y * dimensions.z);
-    vec3 offset{0};
-
-    switch (axis) {
-        case CartesianCoordinateAxis::X:
-            for (size_t z = 0; z < dimensions.z; z++) {
-                for (size_t y = 0; y < dimensions.y; y++) {
-                    auto x = sliceNumber;
-                    sliceData[indexMapper(size3_t(0, y, z))] = inTensorField->at(x, y, z).second;
-                    offset.x = frac;
-                }
-            }
-            break;
-        case CartesianCoordinateAxis::Y:
-            for (size_t z = 0; z < dimensions.z; z++) {
-                for (size_t x = 0; x < dimensions.x; x++) {
-                    auto y = sliceNumber;
-                    sliceData[indexMapper(size3_t(x, 0, z))] = inTensorField->at(x, y, z).second;
-                    offset.y = frac;
-                }
-            }
-            break;
-        case CartesianCoordinateAxis::Z:
-            for (size_t y = 0; y < dimensions.y; y++) {
-                for (size_t x = 0; x < dimensions.x; x++) {
-                    auto z = sliceNumber;
-                    sliceData[indexMapper(size3_t(x, y, 0))] = inTensorField->at(x, y, z).second;
-                    offset.z = frac;
-                }
-            }
-            break;
+    const auto indices = sliceIndices(fieldDimensions, axis, sliceNumber);
+
+    std::vector<dmat3> sliceData(indices.size());
+    util::forEachParallel(indices, [&](size_t index, size_t i) {
+        sliceData[i] = inTensorField->tensor(index);
+    });
+
+    std::shared_ptr<TensorField3D> tensorField;
+    if (inTensorField->hasEigenDecomposition()) {
+        // The slice inherits the eigen system of the field instead of recomputing it
+        tensorField = std::make_shared<TensorField3D>(
+            dimensions, std::move(sliceData), gather(inTensorField->majorEigenValues(), indices),
+            gather(inTensorField->middleEigenValues(), indices),
+            gather(inTensorField->minorEigenValues(), indices),
+            gather(inTensorField->majorEigenVectors(), indices),
+            gather(inTensorField->middleEigenVectors(), indices),
+            gather(inTensorField->minorEigenVectors(), indices), inTensorField->getExtents(),
+            frac);
+    } else {
+        tensorField = std::make_shared<TensorField3D>(dimensions, std::move(sliceData),
+                                                      inTensorField->getExtents(), frac);
     }
-
-    auto tensorField =
-        std::make_shared<TensorField3D>(dimensions, sliceData, inTensorField->getExtents(), frac);
     tensorField->setOffset(offset);
 
     return tensorField;
 }
 }  // namespace detail
+
+TensorFieldSliceCache::TensorFieldSliceCache(size_t capacity) : capacity_{capacity} {}
+
+std::shared_ptr<const TensorField2D> TensorFieldSliceCache::slice2D(
+    std::shared_ptr<const TensorField3D> tensorField, const CartesianCoordinateAxis axis,
+    const size_t sliceNumber) {
+    setSource(tensorField);
+    return lookup(slices2D_[static_cast<size_t>(axis)], sliceNumber,
+                  [&]() { return detail::getSlice2D(tensorField, axis, sliceNumber); });
+}
+
+std::shared_ptr<const TensorField3D> TensorFieldSliceCache::slice3D(
+    std::shared_ptr<const TensorField3D> tensorField, const CartesianCoordinateAxis axis,
+    const size_t sliceNumber) {
+    setSource(tensorField);
+    return lookup(slices3D_[static_cast<size_t>(axis)], sliceNumber,
+                  [&]() { return detail::getSlice3D(tensorField, axis, sliceNumber); });
+}
+
+void TensorFieldSliceCache::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    for (auto& slices : slices2D_) {
+        while (slices.size() > capacity_) slices.pop_back();
+    }
+    for (auto& slices : slices3D_) {
+        while (slices.size() > capacity_) slices.pop_back();
+    }
+}
+
+void TensorFieldSliceCache::clear() {
+    for (auto& slices : slices2D_) slices.clear();
+    for (auto& slices : slices3D_) slices.clear();
+}
+
+void TensorFieldSliceCache::setSource(const std::shared_ptr<const TensorField3D>& tensorField) {
+    if (source_.lock() == tensorField) return;
+    clear();
+    source_ = tensorField;
+}
+
+template <typename T, typename Create>
+std::shared_ptr<const T> TensorFieldSliceCache::lookup(std::list<Entry<T>>& slices,
+                                                       size_t sliceNumber, Create create) {
+    auto it = std::find_if(slices.begin(), slices.end(),
+                           [&](const Entry<T>& entry) { return entry.sliceNumber == sliceNumber; });
+    if (it != slices.end()) {
+        // Move to the front, most recently used first
+        slices.splice(slices.begin(), slices, it);
+        return slices.front().field;
+    }
+
+    std::shared_ptr<const T> field = create();
+    if (capacity_ == 0) return field;
+
+    slices.push_front({sliceNumber, field});
+    if (slices.size() > capacity_) slices.pop_back();
+    return field;
+}
+
 }  // namespace inviwo
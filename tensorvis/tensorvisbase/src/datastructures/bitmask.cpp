@@ -0,0 +1,165 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/bitmask.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <string>
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t numWords(size_t size) {
+    return (size + BitMask::wordBits - 1) / BitMask::wordBits;
+}
+
+void checkSizes(const BitMask& a, const BitMask& b) {
+    if (a.size() != b.size()) {
+        throw Exception("Combining masks of size " + std::to_string(a.size()) + " and " +
+                            std::to_string(b.size()),
+                        IVW_CONTEXT_CUSTOM("BitMask"));
+    }
+}
+
+}  // namespace
+
+BitMask::BitMask(size_t size, bool value)
+    : size_{size}, words_(numWords(size), value ? ~Word{0} : Word{0}) {
+    clearPadding();
+}
+
+BitMask::BitMask(const std::vector<glm::uint8>& mask)
+    : size_{mask.size()}, words_(numWords(size_)) {
+    for (size_t w = 0; w < words_.size(); ++w) {
+        const auto first = w * wordBits;
+        const auto last = std::min(first + wordBits, size_);
+        Word word{0};
+        for (size_t i = first; i < last; ++i) {
+            word |= Word{mask[i] != 0} << (i - first);
+        }
+        words_[w] = word;
+    }
+}
+
+size_t BitMask::count() const {
+    size_t res = 0;
+    for (const auto word : words_) res += bitmask::popcount(word);
+    return res;
+}
+
+bool BitMask::any() const {
+    return std::any_of(words_.begin(), words_.end(), [](Word word) { return word != 0; });
+}
+
+BitMask& BitMask::operator&=(const BitMask& rhs) {
+    checkSizes(*this, rhs);
+    for (size_t w = 0; w < words_.size(); ++w) words_[w] &= rhs.words_[w];
+    return *this;
+}
+
+BitMask& BitMask::operator|=(const BitMask& rhs) {
+    checkSizes(*this, rhs);
+    for (size_t w = 0; w < words_.size(); ++w) words_[w] |= rhs.words_[w];
+    return *this;
+}
+
+BitMask& BitMask::subtract(const BitMask& rhs) {
+    checkSizes(*this, rhs);
+    for (size_t w = 0; w < words_.size(); ++w) words_[w] &= ~rhs.words_[w];
+    return *this;
+}
+
+BitMask& BitMask::flip() {
+    for (auto& word : words_) word = ~word;
+    clearPadding();
+    return *this;
+}
+
+auto BitMask::wordAt(size_t first) const -> Word {
+    const auto w = first / wordBits;
+    const auto shift = first % wordBits;
+    auto word = words_[w] >> shift;
+    if (shift != 0 && w + 1 < words_.size()) word |= words_[w + 1] << (wordBits - shift);
+    return word;
+}
+
+void BitMask::copyBits(const BitMask& src, size_t srcFirst, size_t first, size_t count) {
+    // first partial destination word, then whole destination words
+    while (count > 0) {
+        const auto w = first / wordBits;
+        const auto shift = first % wordBits;
+        const auto n = std::min(count, wordBits - shift);
+        const auto bits = n == wordBits ? ~Word{0} : ((Word{1} << n) - 1);
+        const auto word = src.wordAt(srcFirst) & bits;
+        words_[w] = (words_[w] & ~(bits << shift)) | (word << shift);
+        first += n;
+        srcFirst += n;
+        count -= n;
+    }
+}
+
+std::vector<size_t> BitMask::setIndices() const {
+    std::vector<size_t> indices;
+    indices.reserve(count());
+    forEachSetBit([&](size_t i) { indices.push_back(i); });
+    return indices;
+}
+
+std::vector<glm::uint8> BitMask::toBytes() const {
+    std::vector<glm::uint8> bytes(size_, 0);
+    forEachSetBit([&](size_t i) { bytes[i] = 1; });
+    return bytes;
+}
+
+std::vector<std::uint32_t> BitMask::toWords32() const {
+    std::vector<std::uint32_t> words((size_ + 31) / 32, 0);
+    for (size_t w = 0; w < words.size(); ++w) {
+        words[w] = static_cast<std::uint32_t>(words_[w / 2] >> (32 * (w % 2)));
+    }
+    return words;
+}
+
+void BitMask::clearPadding() {
+    if (const auto rest = size_ % wordBits; rest != 0) {
+        words_.back() &= (Word{1} << rest) - 1;
+    }
+}
+
+BitMask operator&(BitMask a, const BitMask& b) {
+    a &= b;
+    return a;
+}
+BitMask operator|(BitMask a, const BitMask& b) {
+    a |= b;
+    return a;
+}
+
+}  // namespace inviwo
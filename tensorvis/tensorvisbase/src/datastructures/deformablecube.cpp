@@ -30,17 +30,21 @@
 #include <inviwo/tensorvisbase/datastructures/deformablecube.h>
 
 namespace inviwo {
-DeformableCube::DeformableCube(const vec4& color) {
-    createCube(color);
-
+DeformableCube::DeformableCube(const vec4& color)
+    : topology_(topology())
+    , vertices_(topology_->vertices)
+    , normals_(topology_->numVertices())
+    , colors_(topology_->numVertices(), color) {
     calculateNormals();
 }
 
-void DeformableCube::createCube(const vec4& color) {
-    mesh_ = std::make_shared<BasicMesh>();
+std::shared_ptr<const GlyphTopology> DeformableCube::topology() {
+    static const auto topology = createCube();
+    return topology;
+}
 
-    auto indexBuffer = mesh_->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
-    indexBuffer->getDataContainer().reserve(36);
+std::shared_ptr<const GlyphTopology> DeformableCube::createCube() {
+    auto topology = std::make_shared<GlyphTopology>();
 
     const auto p000 = vec3(-0.5f, -0.5f, -0.5f);
     const auto p001 = vec3(-0.5f, -0.5f, +0.5f);
@@ -51,45 +55,36 @@ void DeformableCube::createCube(const vec4& color) {
     const auto p110 = vec3(+0.5f, +0.5f, -0.5f);
     const auto p111 = vec3(+0.5f, +0.5f, +0.5f);
 
-    const auto xNorm = vec3(1, 0, 0);
-    const auto yNorm = vec3(0, 1, 0);
-    const auto zNorm = vec3(0, 0, 1);
-
     const auto pos00 = vec3(0, 0, 0);
     const auto pos10 = vec3(1, 0, 0);
     const auto pos11 = vec3(1, 1, 0);
-    // pos normal tex color
 
-    glm::uint32_t offset = 0;
+    size_t offset = 0;
 
-    auto addFace = [&](const vec3& v1, const vec3& v2, const vec3& v3, const vec3& v4,
-                       const vec3& normal) {
-        mesh_->addVertices({
-            {v1, normal, pos00, color},
-            {v2, normal, pos10, color},
-            {v3, normal, pos11, color},
-            {v4, normal, pos00, color},
-        });
-        indexBuffer->add({offset + 0, offset + 1, offset + 2, offset + 0, offset + 2, offset + 3});
+    auto addFace = [&](const vec3& v1, const vec3& v2, const vec3& v3, const vec3& v4) {
+        topology->vertices.insert(topology->vertices.end(), {v1, v2, v3, v4});
+        topology->texCoords.insert(topology->texCoords.end(), {pos00, pos10, pos11, pos00});
 
-        faces_.emplace_back(offset + 0, offset + 1, offset + 2);
-        faces_.emplace_back(offset + 0, offset + 2, offset + 3);
+        topology->faces.emplace_back(offset + 0, offset + 1, offset + 2);
+        topology->faces.emplace_back(offset + 0, offset + 2, offset + 3);
 
         offset += 4;
     };
 
-    addFace(p000, p100, p110, p010, zNorm);
-    addFace(p100, p101, p111, p110, xNorm);
-    addFace(p010, p110, p111, p011, yNorm);
-    addFace(p001, p000, p010, p011, -xNorm);
-    addFace(p011, p111, p101, p001, -zNorm);
-    addFace(p001, p101, p100, p000, -yNorm);
+    addFace(p000, p100, p110, p010);
+    addFace(p100, p101, p111, p110);
+    addFace(p010, p110, p111, p011);
+    addFace(p001, p000, p010, p011);
+    addFace(p011, p111, p101, p001);
+    addFace(p001, p101, p100, p000);
+
+    topology->finalize();
+    return topology;
 }
 
 void DeformableCube::deform(const std::function<void(vec3& vertex)>& lambda,
                             const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -111,9 +106,8 @@ void DeformableCube::deform(const std::function<void(vec3& vertex)>& lambda,
 
 void DeformableCube::deform(const std::function<void(vec3& vertex, vec4& color)>& lambda,
                             const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& colors = mesh_->getEditableColors()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
+    auto& colors = colors_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -141,46 +135,17 @@ void DeformableCube::transform(const vec3& pos, const vec3& scale) {
     auto translation = glm::translate(pos);
     auto scaling = glm::scale(vec3(scale));
 
-    mesh_->setWorldMatrix(mat4(1) * translation * scaling);
+    worldMatrix_ = mat4(1) * translation * scaling;
 }
 
 std::shared_ptr<BasicMesh> DeformableCube::getGeometry() {
-    return std::make_shared<BasicMesh>(*mesh_);
+    auto mesh = topology_->createMesh(vertices_, normals_, colors_);
+    mesh->setWorldMatrix(worldMatrix_);
+    return mesh;
 }
 
 void DeformableCube::calculateNormals() {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& normals = mesh_->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer();
-
-    for (auto& normal : normals) {
-        normal = vec3(0.f);
-    }
-
-    for (const auto& face : faces_) {
-        auto v1 = vertices[face.x];
-        auto v2 = vertices[face.y];
-        auto v3 = vertices[face.z];
-
-        auto edge1 = v2 - v1;
-        auto edge2 = v3 - v1;
-
-        auto faceNormal = glm::cross(edge1, edge2);
-
-        normals[face.x] += faceNormal;
-        normals[face.y] += faceNormal;
-        normals[face.z] += faceNormal;
-    }
-
-    size_t i = 0;
-    for (auto& normal : normals) {
-        normal = glm::normalize(normal);
-        auto cosAlpha = glm::dot(normal, glm::normalize(vertices[i]));
-
-        if (cosAlpha < 0.f) {
-            normal = -normal;
-        }
-        i++;
-    }
+    topology_->computeNormals(vertices_.data(), normals_.data());
 }
-}  // namespace inviwo
\ No newline at end of file
+
+}  // namespace inviwo
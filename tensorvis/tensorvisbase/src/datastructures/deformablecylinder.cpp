@@ -29,19 +29,36 @@
 
 #include <inviwo/tensorvisbase/datastructures/deformablecylinder.h>
 
-namespace inviwo {
-DeformableCylinder::DeformableCylinder(const size_t& numTheta, const vec4& color) {
-    createCylinder(numTheta, color);
+#include <map>
+#include <mutex>
 
+namespace inviwo {
+DeformableCylinder::DeformableCylinder(const size_t& numTheta, const vec4& color)
+    : topology_(topology(numTheta))
+    , vertices_(topology_->vertices)
+    , normals_(topology_->numVertices())
+    , colors_(topology_->numVertices(), color) {
     calculateNormals();
 }
 
-void DeformableCylinder::createCylinder(const size_t& numTheta, const vec4& color) {
-    mesh_ = std::make_shared<BasicMesh>();
+std::shared_ptr<const GlyphTopology> DeformableCylinder::topology(const size_t& numTheta) {
+    static std::mutex mutex;
+    static std::map<size_t, std::shared_ptr<const GlyphTopology>> cache;
 
-    auto rotation_matrix = mat3(glm::rotate(mat4(1), static_cast<float>(M_PI / 2.), vec3(1, 0, 0)));
+    std::scoped_lock lock{mutex};
+    auto& topology = cache[numTheta];
+    if (!topology) topology = createCylinder(numTheta);
+    return topology;
+}
+
+std::shared_ptr<const GlyphTopology> DeformableCylinder::createCylinder(const size_t& numTheta) {
+    auto topology = std::make_shared<GlyphTopology>();
+    topology->orientation = GlyphTopology::NormalOrientation::Reversed;
 
-    auto indexBuffer = mesh_->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    auto& vertices = topology->vertices;
+    auto& faces = topology->faces;
+
+    auto rotation_matrix = mat3(glm::rotate(mat4(1), static_cast<float>(M_PI / 2.), vec3(1, 0, 0)));
 
     // 2 for the centers plus the first one on the ring with 2 normals respectively
     glm::uint32_t num_indices = 0;
@@ -54,72 +71,55 @@ void DeformableCylinder::createCylinder(const size_t& numTheta, const vec4& colo
     const auto bot_start = vec3(0.5f, -0.5f, 1.0f) - vec3(0.5f);
     const auto rot_vector = vec3(0.0f, 0.0f, 0.5f);
 
-    mesh_->addVertices({{rotation_matrix * top_center,
-                         glm::normalize(rotation_matrix * vec3(0, 1, 0)), vec3(), color},
-                        {rotation_matrix * bot_center,
-                         glm::normalize(rotation_matrix * vec3(0, -1, 0)), vec3(), color},
-                        {rotation_matrix * top_start,
-                         glm::normalize(rotation_matrix * vec3(0, 1, 0)), vec3(), color},
-                        {rotation_matrix * bot_start,
-                         glm::normalize(rotation_matrix * vec3(0, -1, 0)), vec3(), color},
-                        {rotation_matrix * top_start,
-                         glm::normalize(rotation_matrix * vec3(0, 0, 1)), vec3(), color},
-                        {rotation_matrix * bot_start,
-                         glm::normalize(rotation_matrix * vec3(0, 0, 1)), vec3(), color}});
+    vertices.insert(vertices.end(),
+                    {rotation_matrix * top_center, rotation_matrix * bot_center,
+                     rotation_matrix * top_start, rotation_matrix * bot_start,
+                     rotation_matrix * top_start, rotation_matrix * bot_start});
 
     num_indices += 6;
 
     for (glm::uint32_t i = 1; i < numTheta; i++) {
         const auto cur_vec = glm::rotateY(rot_vector, i * frac);
 
-        mesh_->addVertices({
-            {rotation_matrix * (top_center + cur_vec),
-             glm::normalize(rotation_matrix * vec3(0, 1, 0)), vec3(), color},  // 0  top y dir
-            {rotation_matrix * (bot_center + cur_vec),
-             glm::normalize(rotation_matrix * vec3(0, -1, 0)), vec3(), color},  // 1  bot y dir
-            {rotation_matrix * (top_center + cur_vec), glm::normalize(rotation_matrix * cur_vec),
-             vec3(), color},  // 2  top out dir
-            {rotation_matrix * (bot_center + cur_vec), glm::normalize(rotation_matrix * cur_vec),
-             vec3(), color}  // 3  bot out dir
-        });
+        // Top and bottom of the caps, followed by top and bottom of the side
+        vertices.insert(vertices.end(),
+                        {rotation_matrix * (top_center + cur_vec),
+                         rotation_matrix * (bot_center + cur_vec),
+                         rotation_matrix * (top_center + cur_vec),
+                         rotation_matrix * (bot_center + cur_vec)});
 
         num_indices += 4;
 
-        indexBuffer->add({0, num_indices - 4, num_indices - 4 - 4});
-        faces_.emplace_back(0, num_indices - 4, num_indices - 4 - 4);
+        faces.emplace_back(0, num_indices - 4, num_indices - 4 - 4);
 
-        indexBuffer->add({1, num_indices - 4 - 3, num_indices - 3});
-        faces_.emplace_back(1, num_indices - 4 - 3, num_indices - 3);
+        faces.emplace_back(1, num_indices - 4 - 3, num_indices - 3);
 
         auto v1 = num_indices - 2;
         auto v2 = num_indices - 2 - 4;
         auto v3 = num_indices - 1;
         auto v4 = num_indices - 1 - 4;
 
-        indexBuffer->add({v3, v2, v1});
-        faces_.emplace_back(v3, v2, v1);
+        faces.emplace_back(v3, v2, v1);
 
-        indexBuffer->add({v3, v4, v2});
-        faces_.emplace_back(v3, v4, v2);
+        faces.emplace_back(v3, v4, v2);
     }
 
-    indexBuffer->add({0, 2, num_indices - 4});
-    faces_.emplace_back(0, 2, num_indices - 4);
+    faces.emplace_back(0, 2, num_indices - 4);
 
-    indexBuffer->add({1, num_indices - 3, 3});
-    faces_.emplace_back(1, num_indices - 3, 3);
+    faces.emplace_back(1, num_indices - 3, 3);
 
-    indexBuffer->add({5, num_indices - 2, 4});
-    faces_.emplace_back(5, num_indices - 2, 4);
+    faces.emplace_back(5, num_indices - 2, 4);
 
-    indexBuffer->add({5, num_indices - 1, num_indices - 2});
-    faces_.emplace_back(5, num_indices - 1, num_indices - 2);
+    faces.emplace_back(5, num_indices - 1, num_indices - 2);
+
+    topology->texCoords.resize(vertices.size(), vec3(0.f));
+    topology->finalize();
+    return topology;
 }
 
 void DeformableCylinder::deform(const std::function<void(vec3& vertex)>& lambda,
                                 const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -141,9 +141,8 @@ void DeformableCylinder::deform(const std::function<void(vec3& vertex)>& lambda,
 
 void DeformableCylinder::deform(const std::function<void(vec3& vertex, vec4& color)>& lambda,
                                 const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& colors = mesh_->getEditableColors()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
+    auto& colors = colors_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -171,37 +170,17 @@ void DeformableCylinder::transform(const vec3& pos, const vec3& scale) {
     auto translation = glm::translate(pos);
     auto scaling = glm::scale(vec3(scale));
 
-    mesh_->setWorldMatrix(mat4(1) * translation * scaling);
+    worldMatrix_ = mat4(1) * translation * scaling;
 }
 
 std::shared_ptr<BasicMesh> DeformableCylinder::getGeometry() {
-    return std::make_shared<BasicMesh>(*mesh_);
+    auto mesh = topology_->createMesh(vertices_, normals_, colors_);
+    mesh->setWorldMatrix(worldMatrix_);
+    return mesh;
 }
 
 void DeformableCylinder::calculateNormals() {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& normals = mesh_->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer();
-
-    for (auto& normal : normals) {
-        normal = vec3(0.f);
-    }
-
-    for (const auto& face : faces_) {
-        auto v1 = vertices[face.x];
-        auto v2 = vertices[face.y];
-        auto v3 = vertices[face.z];
-
-        auto edge1 = v2 - v1;
-        auto edge2 = v3 - v1;
-
-        auto faceNormal = glm::cross(edge1, edge2);
-
-        normals[face.x] += faceNormal;
-        normals[face.y] += faceNormal;
-        normals[face.z] += faceNormal;
-    }
-
-    for (auto& normal : normals) normal = -glm::normalize(normal);
+    topology_->computeNormals(vertices_.data(), normals_.data());
 }
-}  // namespace inviwo
\ No newline at end of file
+
+}  // namespace inviwo
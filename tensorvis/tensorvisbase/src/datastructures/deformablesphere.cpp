@@ -29,42 +29,42 @@
 
 #include <inviwo/tensorvisbase/datastructures/deformablesphere.h>
 
+#include <map>
+#include <mutex>
+
 namespace inviwo {
 DeformableSphere::DeformableSphere(const size_t& numTheta, const size_t& numPhi,
-                                   const vec4& color) {
-    createSphere(numTheta, numPhi, color);
-
+                                   const vec4& color)
+    : topology_(topology(numTheta, numPhi))
+    , vertices_(topology_->vertices)
+    , normals_(topology_->numVertices())
+    , colors_(topology_->numVertices(), color) {
     calculateNormals();
 }
 
-void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi,
-                                    const vec4& color) {
-    mesh_ = std::make_shared<BasicMesh>();
+std::shared_ptr<const GlyphTopology> DeformableSphere::topology(const size_t& numTheta,
+                                                                const size_t& numPhi) {
+    static std::mutex mutex;
+    static std::map<std::pair<size_t, size_t>, std::shared_ptr<const GlyphTopology>> cache;
 
-    auto nFaces = (numPhi - 3) * (numTheta - 1) * 2 + (numPhi - 3) * 2 + 2 * ((numTheta - 1) + 1);
+    std::scoped_lock lock{mutex};
+    auto& topology = cache[{numTheta, numPhi}];
+    if (!topology) topology = createSphere(numTheta, numPhi);
+    return topology;
+}
 
-    auto indexBuffer = mesh_->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
-    indexBuffer->getDataContainer().reserve(nFaces * 3);
+std::shared_ptr<const GlyphTopology> DeformableSphere::createSphere(const size_t& numTheta,
+                                                                    const size_t& numPhi) {
+    auto topology = std::make_shared<GlyphTopology>();
 
-    auto nIndices = (numPhi - 1) * numTheta + 2;
-    std::vector<uint32_t> addedIndices;
-    addedIndices.reserve(nIndices);
+    auto nFaces = (numPhi - 3) * (numTheta - 1) * 2 + (numPhi - 3) * 2 + 2 * ((numTheta - 1) + 1);
 
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& normals = mesh_->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer();
-    auto& texCoords =
-        mesh_->getEditableTexCoords()->getEditableRAMRepresentation()->getDataContainer();
-    auto& colors = mesh_->getEditableColors()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = topology->vertices;
+    auto& faces = topology->faces;
 
     auto totalVertices = (numPhi - 1) * numTheta + 2;  // 2 extreme points
     vertices.reserve(totalVertices);
-    normals.reserve(totalVertices);
-    texCoords.reserve(totalVertices);
-    colors.reserve(totalVertices);
-
-    faces_.clear();
-    faces_.reserve(nFaces);
+    faces.reserve(nFaces);
 
     auto calcVert = [](vec3 & vertex, const float& cosphi, const float& sinphi,
                        const float& costheta, const float& sintheta) -> auto {
@@ -77,14 +77,6 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
         vertex.y = (sgnsintheta * std::abs(sintheta)) * (sgnsinphi * std::abs(sinphi));
         vertex.z = sgncosphi * std::abs(cosphi);
     };
-    auto addVertex = [&](const vec3& vertex, const vec3& texCoord, const vec3& normal,
-                         const vec4& color) -> auto {
-        vertices.emplace_back(vertex);
-        normals.emplace_back(normal);
-        texCoords.emplace_back(texCoord);
-        colors.emplace_back(color);
-        return static_cast<uint32_t>(vertices.size() - 1);
-    };
 
     // Generate main geometry body
     for (size_t j = 1; j < numPhi - 1; j++) {
@@ -103,7 +95,7 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
 
             calcVert(vertex, cosphi, sinphi, costheta, sintheta);
 
-            addedIndices.emplace_back(addVertex(vertex, vec3(0), vec3(0), color));
+            vertices.emplace_back(vertex);
         }
     }
 
@@ -111,7 +103,7 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
 
     calcVert(vertex, 1.f, 0.f, 1.f, 0.f);
 
-    addedIndices.emplace_back(addVertex(vertex, vec3(0), vec3(0), color));
+    vertices.emplace_back(vertex);
 
     // Generate second extreme point
     auto theta = (static_cast<float>(numTheta) - 1.f) * 2.f * static_cast<float>(M_PI) /
@@ -127,7 +119,7 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
 
     calcVert(vertex, cosphi, sinphi, costheta, sintheta);
 
-    addedIndices.emplace_back(addVertex(vertex, vec3(0), vec3(0), color));
+    vertices.emplace_back(vertex);
 
     // Tesselate main geometry
     // First, we create the triangles for the "sides"
@@ -136,24 +128,10 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
             auto firstItemInFirstRow = numTheta * j;
             auto firstItemInSecondRow = numTheta * (j + 1);
 
-            auto idx1 = firstItemInSecondRow + i;     // 0,0
-            auto idx2 = firstItemInFirstRow + 1 + i;  // 1,1
-            auto idx3 = firstItemInFirstRow + i;      // 0,1
-
-            auto idx4 = firstItemInFirstRow + 1 + i;
-            auto idx5 = firstItemInSecondRow + i;
-            auto idx6 = firstItemInSecondRow + 1 + i;
-
-            indexBuffer->add(addedIndices.at(idx1));
-            indexBuffer->add(addedIndices.at(idx2));
-            indexBuffer->add(addedIndices.at(idx3));
-            faces_.emplace_back(addedIndices.at(idx1), addedIndices.at(idx2),
-                                addedIndices.at(idx3));
-            indexBuffer->add(addedIndices.at(idx4));
-            indexBuffer->add(addedIndices.at(idx5));
-            indexBuffer->add(addedIndices.at(idx6));
-            faces_.emplace_back(addedIndices.at(idx4), addedIndices.at(idx5),
-                                addedIndices.at(idx6));
+            faces.emplace_back(firstItemInSecondRow + i, firstItemInFirstRow + 1 + i,
+                               firstItemInFirstRow + i);
+            faces.emplace_back(firstItemInFirstRow + 1 + i, firstItemInSecondRow + i,
+                               firstItemInSecondRow + 1 + i);
         }
     }
 
@@ -163,62 +141,38 @@ void DeformableSphere::createSphere(const size_t& numTheta, const size_t& numPhi
         auto lastItemInFirstRow = (j * numTheta) + (numTheta - 1);
         auto lastItemInSecondRow = ((j + 1) * numTheta) + (numTheta - 1);
 
-        indexBuffer->add(addedIndices.at(lastItemInSecondRow));
-        indexBuffer->add(addedIndices.at(firstItemInFirstRow));
-        indexBuffer->add(addedIndices.at(lastItemInFirstRow));
-        faces_.emplace_back(addedIndices.at(lastItemInSecondRow),
-                            addedIndices.at(firstItemInFirstRow),
-                            addedIndices.at(lastItemInFirstRow));
-
-        indexBuffer->add(addedIndices.at(firstItemInFirstRow));
-        indexBuffer->add(addedIndices.at(lastItemInSecondRow));
-        indexBuffer->add(addedIndices.at(firstItemInSecondRow));
-        faces_.emplace_back(addedIndices.at(firstItemInFirstRow),
-                            addedIndices.at(lastItemInSecondRow),
-                            addedIndices.at(firstItemInSecondRow));
+        faces.emplace_back(lastItemInSecondRow, firstItemInFirstRow, lastItemInFirstRow);
+        faces.emplace_back(firstItemInFirstRow, lastItemInSecondRow, firstItemInSecondRow);
     }
 
     // Tesselate first extreme point
     // Now, we need to create the triangles connected to the extreme points
-    auto extremePoint1 = addedIndices.at(addedIndices.size() - 2);
+    const size_t extremePoint1 = vertices.size() - 2;
 
     for (size_t i = 0; i < numTheta - 1; i++) {
-        indexBuffer->add(extremePoint1);
-        indexBuffer->add(addedIndices.at(i));
-        indexBuffer->add(addedIndices.at((i + 1)));
-        faces_.emplace_back(extremePoint1, addedIndices.at(i), addedIndices.at((i + 1)));
+        faces.emplace_back(extremePoint1, i, i + 1);
     }
-
-    indexBuffer->add(extremePoint1);
-    indexBuffer->add(addedIndices.at(numTheta - 1));
-    indexBuffer->add(0);
-    faces_.emplace_back(extremePoint1, addedIndices.at(numTheta - 1), addedIndices.at(0));
+    faces.emplace_back(extremePoint1, numTheta - 1, 0);
 
     // Tesselate second extreme point
     // Now, we need to create the triangles connected to the extreme points
-    auto extremePoint2 = addedIndices.at(addedIndices.size() - 1);
+    const size_t extremePoint2 = vertices.size() - 1;
 
     for (size_t i = 0; i < numTheta - 1; i++) {
-        indexBuffer->add(extremePoint2);
-        indexBuffer->add(addedIndices.at((i + 1) + numTheta * (numPhi - 3)));
-        indexBuffer->add(addedIndices.at(i + numTheta * (numPhi - 3)));
-        faces_.emplace_back(extremePoint2, addedIndices.at((i + 1) + numTheta * (numPhi - 3)),
-                            addedIndices.at(i + numTheta * (numPhi - 3)));
+        faces.emplace_back(extremePoint2, (i + 1) + numTheta * (numPhi - 3),
+                           i + numTheta * (numPhi - 3));
     }
+    faces.emplace_back(extremePoint2, numTheta * (numPhi - 2) - numTheta,
+                       numTheta * (numPhi - 2) - 1);
 
-    indexBuffer->add(extremePoint2);
-
-    indexBuffer->add(addedIndices.at(numTheta * (numPhi - 2) - numTheta));
-    indexBuffer->add(addedIndices.at(numTheta * (numPhi - 2) - 1));
-
-    faces_.emplace_back(extremePoint2, addedIndices.at(numTheta * (numPhi - 2) - numTheta),
-                        addedIndices.at(numTheta * (numPhi - 2) - 1));
+    topology->texCoords.resize(vertices.size(), vec3(0.f));
+    topology->finalize();
+    return topology;
 }
 
 void DeformableSphere::deform(const std::function<void(vec3& vertex)>& lambda,
                               const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -240,9 +194,8 @@ void DeformableSphere::deform(const std::function<void(vec3& vertex)>& lambda,
 
 void DeformableSphere::deform(const std::function<void(vec3& vertex, vec4& color)>& lambda,
                               const bool& normalize) {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& colors = mesh_->getEditableColors()->getEditableRAMRepresentation()->getDataContainer();
+    auto& vertices = vertices_;
+    auto& colors = colors_;
 
     if (normalize) {
         auto maxDist = std::numeric_limits<float>::lowest();
@@ -270,46 +223,17 @@ void DeformableSphere::transform(const vec3& pos, const vec3& scale) {
     auto translation = glm::translate(pos);
     auto scaling = glm::scale(vec3(scale));
 
-    mesh_->setWorldMatrix(mat4(1) * translation * scaling);
+    worldMatrix_ = mat4(1) * translation * scaling;
 }
 
 std::shared_ptr<BasicMesh> DeformableSphere::getGeometry() {
-    return std::make_shared<BasicMesh>(*mesh_);
+    auto mesh = topology_->createMesh(vertices_, normals_, colors_);
+    mesh->setWorldMatrix(worldMatrix_);
+    return mesh;
 }
 
 void DeformableSphere::calculateNormals() {
-    auto& vertices =
-        mesh_->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer();
-    auto& normals = mesh_->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer();
-
-    for (auto& normal : normals) {
-        normal = vec3(0.f);
-    }
-
-    for (const auto& face : faces_) {
-        auto v1 = vertices[face.x];
-        auto v2 = vertices[face.y];
-        auto v3 = vertices[face.z];
-
-        auto edge1 = v2 - v1;
-        auto edge2 = v3 - v1;
-
-        auto faceNormal = glm::cross(edge1, edge2);
-
-        normals[face.x] += faceNormal;
-        normals[face.y] += faceNormal;
-        normals[face.z] += faceNormal;
-    }
-
-    size_t i = 0;
-    for (auto& normal : normals) {
-        normal = glm::normalize(normal);
-        auto cosAlpha = glm::dot(normal, glm::normalize(vertices[i]));
-
-        if (cosAlpha < 0.f) {
-            normal = -normal;
-        }
-        i++;
-    }
+    topology_->computeNormals(vertices_.data(), normals_.data());
 }
-}  // namespace inviwo
\ No newline at end of file
+
+}  // namespace inviwo
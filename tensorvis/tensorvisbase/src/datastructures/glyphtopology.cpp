@@ -0,0 +1,86 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/glyphtopology.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+
+namespace inviwo {
+
+void GlyphTopology::finalize() {
+    auto indexRAM = std::make_shared<IndexBufferRAM>(faces.size() * 3);
+    auto& data = indexRAM->getDataContainer();
+    for (size_t i = 0; i < faces.size(); ++i) {
+        data[3 * i + 0] = static_cast<uint32_t>(faces[i].x);
+        data[3 * i + 1] = static_cast<uint32_t>(faces[i].y);
+        data[3 * i + 2] = static_cast<uint32_t>(faces[i].z);
+    }
+    indices = std::make_shared<IndexBuffer>(indexRAM);
+}
+
+void GlyphTopology::computeNormals(const vec3* vertices, vec3* normals,
+                                   const vec3& center) const {
+    const auto numVertices = this->vertices.size();
+    std::fill(normals, normals + numVertices, vec3(0.f));
+
+    for (const auto& face : faces) {
+        const auto v1 = vertices[face.x];
+        const auto faceNormal = glm::cross(vertices[face.y] - v1, vertices[face.z] - v1);
+
+        normals[face.x] += faceNormal;
+        normals[face.y] += faceNormal;
+        normals[face.z] += faceNormal;
+    }
+
+    for (size_t i = 0; i < numVertices; ++i) {
+        auto& normal = normals[i];
+        normal = glm::normalize(normal);
+        if (orientation == NormalOrientation::Reversed) {
+            normal = -normal;
+        } else if (glm::dot(normal, glm::normalize(vertices[i] - center)) < 0.f) {
+            normal = -normal;
+        }
+    }
+}
+
+std::shared_ptr<BasicMesh> GlyphTopology::createMesh(std::vector<vec3> vertices,
+                                                     std::vector<vec3> normals,
+                                                     std::vector<vec4> colors) const {
+    auto mesh = std::make_shared<BasicMesh>();
+    mesh->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(vertices);
+    mesh->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(normals);
+    mesh->getEditableColors()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(colors);
+    mesh->getEditableTexCoords()->getEditableRAMRepresentation()->getDataContainer() = texCoords;
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None), indices);
+    return mesh;
+}
+
+}  // namespace inviwo
@@ -1,5 +1,7 @@
 #include <inviwo/tensorvisbase/datastructures/hyperstreamlinetracer.h>
 
+#include <algorithm>
+
 namespace inviwo {
 HyperStreamLineTracer::HyperStreamLineTracer(
     std::shared_ptr<const SpatialSampler<3, 3, double>> sampler,
@@ -17,11 +19,38 @@ HyperStreamLineTracer::HyperStreamLineTracer(
     , transformOutputToWorldSpace_{false} {}
 
 typename HyperStreamLineTracer::Result HyperStreamLineTracer::traceFrom(const SpatialVector &pIn) {
+    Result res;
+    IntegralLine &line = res.line;
+
+    LineBuffers buffers(line, metaSamplers_, steps_ + 2);
+    const auto info = trace(pIn, buffers, 0);
+
+    line.setBackwardTerminationReason(info.backward);
+    line.setForwardTerminationReason(info.forward);
+    res.seedIndex = info.seedIndex;
+    return res;
+}
+
+bool HyperStreamLineTracer::traceInto(const SpatialVector &pIn, size_t seedID,
+                                      PackedLineSet &lines) {
+    LineBuffers buffers(lines, metaSamplers_);
+    auto info = trace(pIn, buffers, lines.getLineBegin());
+
+    if (lines.getNumberOfVertices() - lines.getLineBegin() < 2) {
+        lines.discardLine();
+        return false;
+    }
+    info.seedID = seedID;
+    lines.commitLine(info);
+    return true;
+}
+
+PackedLineSet::LineInfo HyperStreamLineTracer::trace(const SpatialVector &pIn,
+                                                     LineBuffers &buffers, size_t begin) {
     SpatialVector p =
         detail::seedTransform<DataVector, DataHomogenousVector>(seedTransformation_, pIn);
 
-    Result res;
-    IntegralLine &line = res.line;
+    PackedLineSet::LineInfo info;
 
     bool both = dir_ == IntegralLineProperties::Direction::BOTH;
     bool fwd = both || dir_ == IntegralLineProperties::Direction::FWD;
@@ -34,38 +63,38 @@ typename HyperStreamLineTracer::Result HyperStreamLineTracer::traceFrom(const Sp
         stepsBWD = steps_ / 2;
         stepsFWD = steps_ - stepsBWD;
     } else if (fwd) {
-        line.setBackwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+        info.backward = IntegralLine::TerminationReason::StartPoint;
         stepsFWD = steps_;
     } else if (bwd) {
-        line.setForwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+        info.forward = IntegralLine::TerminationReason::StartPoint;
         stepsBWD = steps_;
     }
 
     stepsBWD++;  // for adjendency info
     stepsFWD++;
 
-    line.getPositions().reserve(steps_ + 2);
-    line.getMetaData<dvec3>("velocity", true).reserve(steps_ + 2);
-
-    for (auto &m : metaSamplers_) {
-        line.getMetaData<typename SpatialSampler<3, 3, double>::ReturnType>(m.first, true)
-            .reserve(steps_ + 2);
+    if (occupancy_) {
+        // Seeds close to existing lines are skipped, the empty line is discarded
+        const auto seed = util::glm_convert<dvec3>(p);
+        if (occupancy_->isOccupied(seed, occupancy_->getSeparation())) return info;
+        buffers.occupancyTag = occupancy_->newLineTag();
+        buffers.lastOccupied = seed;
     }
 
-    if (!addPoint(line, p)) {
-        return res;  // Zero velocity at seed point
+    if (!addPoint(buffers, p)) {
+        return info;  // Zero velocity at seed point
     }
+    if (occupancy_) occupancy_->insert(buffers.lastOccupied, buffers.occupancyTag);
 
-    line.setBackwardTerminationReason(integrate(stepsBWD, p, line, false));
+    info.backward = integrate(stepsBWD, p, buffers, false);
 
-    if (!line.getPositions().empty()) {
-        line.reverse();
-        res.seedIndex = line.getPositions().size() - 1;
-    }
+    buffers.reverse(begin);
+    info.seedIndex = buffers.positions.size() - begin - 1;
 
-    line.setForwardTerminationReason(integrate(stepsFWD, p, line, true));
+    if (occupancy_) buffers.lastOccupied = util::glm_convert<dvec3>(p);
+    info.forward = integrate(stepsFWD, p, buffers, true);
 
-    return res;
+    return info;
 }
 
 void HyperStreamLineTracer::addMetaDataSampler(
@@ -86,11 +115,67 @@ bool HyperStreamLineTracer::isTransformingOutputToWorldSpace() const {
     return transformOutputToWorldSpace_;
 }
 
-bool HyperStreamLineTracer::addPoint(IntegralLine &line, const SpatialVector &pos) {
+void HyperStreamLineTracer::setAdaptiveStepping(const AdaptiveStepping &adaptive) {
+    adaptive_ = adaptive;
+}
+
+const HyperStreamLineTracer::AdaptiveStepping &HyperStreamLineTracer::getAdaptiveStepping()
+    const {
+    return adaptive_;
+}
+
+void HyperStreamLineTracer::setOccupancy(std::shared_ptr<LineOccupancyGrid> occupancy,
+                                         double testRatio) {
+    occupancy_ = std::move(occupancy);
+    occupancyTestRatio_ = glm::clamp(testRatio, 0.0, 1.0);
+}
+
+const std::shared_ptr<LineOccupancyGrid> &HyperStreamLineTracer::getOccupancy() const {
+    return occupancy_;
+}
+
+HyperStreamLineTracer::LineBuffers::LineBuffers(
+    IntegralLine &line,
+    const std::unordered_map<std::string, std::shared_ptr<const SpatialSampler<3, 3, double>>>
+        &metaSamplers,
+    size_t capacity)
+    : positions(line.getPositions()), velocities(line.getMetaData<dvec3>("velocity", true)) {
+    positions.reserve(capacity);
+    velocities.reserve(capacity);
+
+    meta.reserve(metaSamplers.size());
+    for (auto &m : metaSamplers) {
+        auto &data =
+            line.getMetaData<typename SpatialSampler<3, 3, double>::ReturnType>(m.first, true);
+        data.reserve(capacity);
+        meta.emplace_back(m.second.get(), &data);
+    }
+}
+
+HyperStreamLineTracer::LineBuffers::LineBuffers(
+    PackedLineSet &lines,
+    const std::unordered_map<std::string, std::shared_ptr<const SpatialSampler<3, 3, double>>>
+        &metaSamplers)
+    : positions(lines.getPositions()), velocities(lines.getMetaData("velocity", true)) {
+    meta.reserve(metaSamplers.size());
+    for (auto &m : metaSamplers) {
+        meta.emplace_back(m.second.get(), &lines.getMetaData(m.first, true));
+    }
+}
+
+void HyperStreamLineTracer::LineBuffers::reverse(size_t begin) {
+    std::reverse(positions.begin() + begin, positions.end());
+    std::reverse(velocities.begin() + begin, velocities.end());
+    for (auto &m : meta) {
+        std::reverse(m.second->begin() + begin, m.second->end());
+    }
+}
+
+bool HyperStreamLineTracer::addPoint(LineBuffers &line, const SpatialVector &pos) {
     return addPoint(line, pos, sampler_->sample(pos));
 }
 
-bool HyperStreamLineTracer::addPoint(IntegralLine &line, const SpatialVector &pos,
+bool HyperStreamLineTracer::addPoint(LineBuffers &line, const SpatialVector &pos,
                                      const DataVector &worldVelocity) {
 
     if (glm::length(worldVelocity) < std::numeric_limits<double>::epsilon()) {
@@ -101,23 +186,38 @@ bool HyperStreamLineTracer::addPoint(IntegralLine &line, const SpatialVector &po
         SpatialVector worldPos =
             detail::seedTransform<DataVector, DataHomogenousVector>(toWorld_, pos);
 
-        line.getPositions().emplace_back(util::glm_convert<dvec3>(worldPos));
+        line.positions.emplace_back(util::glm_convert<dvec3>(worldPos));
     } else {
-        line.getPositions().emplace_back(util::glm_convert<dvec3>(pos));
+        line.positions.emplace_back(util::glm_convert<dvec3>(pos));
     }
 
-    line.getMetaData<dvec3>("velocity").emplace_back(util::glm_convert<dvec3>(worldVelocity));
+    line.velocities.emplace_back(util::glm_convert<dvec3>(worldVelocity));
 
-    for (auto &m : metaSamplers_) {
-        line.getMetaData<typename SpatialSampler<3, 3, double>::ReturnType>(m.first).emplace_back(
-            util::glm_convert<dvec3>(m.second->sample(pos)));
+    for (auto &[sampler, data] : line.meta) {
+        data->emplace_back(util::glm_convert<dvec3>(sampler->sample(pos)));
     }
     return true;
 }
 
+bool HyperStreamLineTracer::occupy(LineBuffers &line, const SpatialVector &pos) {
+    if (!occupancy_) return false;
+
+    const auto p = util::glm_convert<dvec3>(pos);
+    const auto separation = occupancy_->getSeparation();
+    if (occupancy_->isOccupied(p, occupancyTestRatio_ * separation, line.occupancyTag)) {
+        return true;
+    }
+    if (glm::distance(p, line.lastOccupied) >= 0.5 * separation) {
+        occupancy_->insert(p, line.occupancyTag);
+        line.lastOccupied = p;
+    }
+    return false;
+}
+
 IntegralLine::TerminationReason HyperStreamLineTracer::integrate(size_t steps, SpatialVector pos,
-                                                                 IntegralLine &line, bool fwd) {
+                                                                 LineBuffers &line, bool fwd) {
     if (steps == 0) return IntegralLine::TerminationReason::StartPoint;
+    if (adaptive_.enabled) return integrateAdaptive(steps, pos, line, fwd);
 
     DataVector worldVelocity;
     bool flipped{false};
@@ -131,6 +231,9 @@ IntegralLine::TerminationReason HyperStreamLineTracer::integrate(size_t steps, S
             pos, integrationScheme_, stepSize_ * (fwd ? 1.0 : -1.0), invBasis_, normalizeSamples_,
             *sampler_, flipped);
 
+        // There is no dedicated termination reason for lines running into other lines
+        if (occupy(line, pos)) return IntegralLine::TerminationReason::Steps;
+
         if (!addPoint(line, pos, worldVelocity)) {
             return IntegralLine::TerminationReason::ZeroVelocity;
         }
@@ -138,4 +241,39 @@ IntegralLine::TerminationReason HyperStreamLineTracer::integrate(size_t steps, S
 
     return IntegralLine::TerminationReason::Steps;
 }
-}  // namespace inviwo
\ No newline at end of file
+
+IntegralLine::TerminationReason HyperStreamLineTracer::integrateAdaptive(size_t steps,
+                                                                         SpatialVector pos,
+                                                                         LineBuffers &line,
+                                                                         bool fwd) {
+    double stepSize = stepSize_ * (fwd ? 1.0 : -1.0);
+    double arcLength = 0.0;
+    DataVector reference{0.0};
+
+    for (size_t i = 0; i < steps; i++) {
+        if (!sampler_->withinBounds(pos)) {
+            return IntegralLine::TerminationReason::OutOfBounds;
+        }
+        if (arcLength >= adaptive_.maxArcLength) {
+            return IntegralLine::TerminationReason::Steps;
+        }
+
+        const auto step = detail::adaptiveHyperstep<SpatialVector, DataVector>(
+            pos, stepSize, adaptive_.tolerance, adaptive_.minStepSize, adaptive_.maxStepSize,
+            invBasis_, normalizeSamples_, *sampler_, reference);
+
+        pos = step.position;
+        stepSize = step.nextStepSize;
+        reference = step.direction;
+        arcLength += std::abs(step.stepSize) * glm::length(step.direction);
+
+        if (occupy(line, pos)) return IntegralLine::TerminationReason::Steps;
+
+        if (!addPoint(line, pos, step.velocity)) {
+            return IntegralLine::TerminationReason::ZeroVelocity;
+        }
+    }
+
+    return IntegralLine::TerminationReason::Steps;
+}
+}  // namespace inviwo
@@ -1,6 +1,8 @@
 #include <inviwo/tensorvisbase/datastructures/invariantspace.h>
 #include <inviwo/tensorvisbase/util/misc.h>
 
+#include <algorithm>
+
 namespace inviwo {
 InvariantSpace::InvariantSpace(size_t numberOfDimensions,
                                const std::vector<std::string>& identifiers,
@@ -22,6 +24,146 @@ InvariantSpace::InvariantSpace(size_t numberOfDimensions,
                    std::array<glm::f64, 2>{std::numeric_limits<double>::max(),
                                            std::numeric_limits<double>::lowest()});
 }
+void InvariantSpace::addAxis(const std::string& identifier, Column data, TensorFeature type) {
+    identifiers_.push_back(identifier);
+    metaDataTypes_.push_back(type);
+
+    if (data->empty()) {
+        minmax_.push_back({std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::lowest()});
+    } else {
+        const auto minmax = std::minmax_element(data->begin(), data->end());
+        minmax_.push_back({*minmax.first, *minmax.second});
+    }
+
+    data_.push_back(std::move(data));
+    owned_.push_back(nullptr);
+}
+
+void InvariantSpace::addAxis(const std::string& identifier, InvariantSpaceAxis data,
+                             TensorFeature type) {
+    auto column = std::make_shared<InvariantSpaceAxis>(std::move(data));
+    addAxis(identifier, Column(column), type);
+    owned_.back() = column;
+}
+
+void InvariantSpace::addAxes(const InvariantSpace& invariantSpace) {
+    for (size_t i = 0; i < invariantSpace.getNumberOfDimensions(); ++i) {
+        identifiers_.push_back(invariantSpace.identifiers_[i]);
+        metaDataTypes_.push_back(invariantSpace.metaDataTypes_[i]);
+        minmax_.push_back(invariantSpace.minmax_[i]);
+        data_.push_back(invariantSpace.data_[i]);
+        owned_.push_back(invariantSpace.owned_[i]);
+    }
+}
+
+void InvariantSpace::addAxes(std::shared_ptr<const InvariantSpace> invariantSpace) {
+    addAxes(*invariantSpace);
+}
+
+void InvariantSpace::addPoint(const std::vector<double>& v) {
+    if (v.size() != data_.size()) {
+        LogError("Tried to add feature of wrong dimensionality ("
+                 << std::to_string(v.size()) << " instead of " << std::to_string(data_.size())
+                 << ")");
+        return;
+    }
+    for (size_t i = 0; i < v.size(); ++i) {
+        const auto val = v[i];
+        editableAxis(i).push_back(val);
+
+        // update minmax
+        minmax_[i][0] = std::min(minmax_[i][0], val);
+        minmax_[i][1] = std::max(minmax_[i][1], val);
+    }
+}
+
+void InvariantSpace::getPoint(size_t idx, std::vector<double>& point) const {
+    point.resize(data_.size());
+    for (size_t j = 0; j < data_.size(); j++) {
+        point[j] = (*data_[j])[idx];
+    }
+}
+
+std::vector<double> InvariantSpace::getPoint(size_t idx) const {
+    std::vector<double> feature;
+
+    if (!data_.size()) return feature;
+    if (!getNumElements()) return feature;
+
+    getPoint(idx, feature);
+    return feature;
+}
+
+std::vector<double> InvariantSpace::flatten() const {
+    std::vector<double> flattened;
+
+    if (!data_.size()) return flattened;
+    if (!getNumElements()) return flattened;
+
+    const auto numDims = data_.size();
+    flattened.resize(getNumElements() * numDims);
+    for (size_t j = 0; j < numDims; j++) {
+        const auto& axis = *data_[j];
+        for (size_t i = 0; i < axis.size(); i++) {
+            flattened[i * numDims + j] = axis[i];
+        }
+    }
+
+    return flattened;
+}
+
+std::shared_ptr<InvariantSpace> InvariantSpace::select(const std::vector<size_t>& indices) const {
+    auto selection = std::make_shared<InvariantSpace>();
+
+    for (size_t j = 0; j < data_.size(); j++) {
+        const auto& axis = *data_[j];
+        InvariantSpaceAxis selected(indices.size());
+        std::transform(indices.begin(), indices.end(), selected.begin(),
+                       [&](size_t i) { return axis[i]; });
+        selection->addAxis(identifiers_[j], std::move(selected), metaDataTypes_[j]);
+    }
+
+    return selection;
+}
+
+void InvariantSpace::clear() {
+    data_.clear();
+    owned_.clear();
+    identifiers_.clear();
+    metaDataTypes_.clear();
+    minmax_.clear();
+}
+
+void InvariantSpace::setNumberOfDimensions(size_t n) {
+    if (data_.size() > n) {
+        LogError("Reduction of dimensionality would mean loss of data. Aborting");
+        return;
+    }
+
+    while (data_.size() < n) {
+        auto column = std::make_shared<InvariantSpaceAxis>();
+        data_.push_back(column);
+        owned_.push_back(column);
+    }
+}
+
+void InvariantSpace::setNumberOfElements(size_t n) {
+    for (size_t i = 0; i < data_.size(); ++i) {
+        editableAxis(i).resize(n);
+    }
+}
+
+InvariantSpaceAxis& InvariantSpace::editableAxis(size_t index) {
+    // An owned column is referenced by data_ and owned_ of this invariant space only
+    if (!owned_[index] || data_[index].use_count() > 2) {
+        auto column = std::make_shared<InvariantSpaceAxis>(*data_[index]);
+        data_[index] = column;
+        owned_[index] = column;
+    }
+    return *owned_[index];
+}
+
 std::string InvariantSpace::getDataInfo() const {
     std::stringstream ss;
     ss << "<table border='0' cellspacing='0' cellpadding='0' "
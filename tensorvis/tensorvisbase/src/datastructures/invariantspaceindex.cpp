@@ -0,0 +1,156 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/invariantspaceindex.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace inviwo {
+
+InvariantSpaceIndex::InvariantSpaceIndex(const InvariantSpace& invariantSpace)
+    : numElements_{invariantSpace.getNumElements()}
+    , columns_{invariantSpace.data()}
+    , order_(columns_.size()) {
+    if (numElements_ > std::numeric_limits<glm::u32>::max()) {
+        throw Exception("Invariant space too large to be indexed (" +
+                            std::to_string(numElements_) + " elements)",
+                        IVW_CONTEXT);
+    }
+
+    std::vector<size_t> axes(columns_.size());
+    util::forEachParallel(axes, [&](size_t, size_t axis) {
+        const auto& column = *columns_[axis];
+        auto& order = order_[axis];
+        order.resize(numElements_);
+        std::iota(order.begin(), order.end(), glm::u32{0});
+        std::sort(order.begin(), order.end(),
+                  [&](glm::u32 a, glm::u32 b) { return column[a] < column[b]; });
+    });
+}
+
+size_t InvariantSpaceIndex::count(size_t axis, dvec2 range) const {
+    const auto [first, last] = span(axis, range);
+    return last - first;
+}
+
+InvariantSpaceIndex::Selection InvariantSpaceIndex::query(const std::vector<dvec2>& ranges) const {
+    if (ranges.size() != columns_.size()) {
+        throw Exception("Expected " + std::to_string(columns_.size()) + " ranges, got " +
+                            std::to_string(ranges.size()),
+                        IVW_CONTEXT);
+    }
+    if (columns_.empty()) return Selection(numElements_, true);
+
+    // Walk the most selective axis and test the others
+    size_t axis = 0;
+    std::pair<size_t, size_t> narrowest{0, numElements_ + 1};
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        const auto s = span(i, ranges[i]);
+        if (s.second - s.first < narrowest.second - narrowest.first) {
+            narrowest = s;
+            axis = i;
+        }
+    }
+
+    Selection selection(numElements_, false);
+    const auto& order = order_[axis];
+    for (auto k = narrowest.first; k < narrowest.second; ++k) {
+        const auto row = order[k];
+        if (contains(row, ranges, axis)) selection[row] = true;
+    }
+    return selection;
+}
+
+void InvariantSpaceIndex::update(Selection& selection, const std::vector<dvec2>& previousRanges,
+                                 const std::vector<dvec2>& ranges) const {
+    if (selection.size() != numElements_ || previousRanges.size() != ranges.size() ||
+        ranges.size() != columns_.size()) {
+        selection = query(ranges);
+        return;
+    }
+
+    std::vector<size_t> changed;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (previousRanges[i] != ranges[i]) changed.push_back(i);
+    }
+    if (changed.empty()) return;
+    if (changed.size() > 1) {
+        selection = query(ranges);
+        return;
+    }
+
+    const auto axis = changed.front();
+    const auto& order = order_[axis];
+    const auto [oldFirst, oldLast] = span(axis, previousRanges[axis]);
+    const auto [newFirst, newLast] = span(axis, ranges[axis]);
+
+    // Rows that left the range on the changed axis
+    const auto deselect = [&](size_t first, size_t last) {
+        for (auto k = first; k < last; ++k) selection[order[k]] = false;
+    };
+    deselect(oldFirst, std::min(oldLast, newFirst));
+    deselect(std::max(oldFirst, newLast), oldLast);
+
+    // Rows that entered it, selected if they are inside the other ranges as well
+    const auto select = [&](size_t first, size_t last) {
+        for (auto k = first; k < last; ++k) {
+            const auto row = order[k];
+            if (contains(row, ranges, axis)) selection[row] = true;
+        }
+    };
+    select(newFirst, std::min(newLast, oldFirst));
+    select(std::max(newFirst, oldLast), newLast);
+}
+
+std::pair<size_t, size_t> InvariantSpaceIndex::span(size_t axis, dvec2 range) const {
+    const auto& column = *columns_[axis];
+    const auto& order = order_[axis];
+    if (range.x > range.y) return {0, 0};
+
+    const auto first = std::lower_bound(order.begin(), order.end(), range.x,
+                                        [&](glm::u32 row, double v) { return column[row] < v; });
+    const auto last = std::upper_bound(first, order.end(), range.y,
+                                       [&](double v, glm::u32 row) { return v < column[row]; });
+    return {static_cast<size_t>(first - order.begin()), static_cast<size_t>(last - order.begin())};
+}
+
+bool InvariantSpaceIndex::contains(size_t row, const std::vector<dvec2>& ranges,
+                                   size_t skipAxis) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (i == skipAxis) continue;
+        const auto value = (*columns_[i])[row];
+        if (value < ranges[i].x || value > ranges[i].y) return false;
+    }
+    return true;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,110 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/tensorvisbase/datastructures/lineoccupancygrid.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inviwo {
+
+LineOccupancyGrid::LineOccupancyGrid(const dvec3& lower, const dvec3& upper, double separation)
+    : lower_{lower}, separation_{separation} {
+    if (!(separation > 0.0)) {
+        throw Exception("Separation has to be positive",
+                        IVW_CONTEXT_CUSTOM("LineOccupancyGrid::LineOccupancyGrid"));
+    }
+    const auto extent = glm::max(upper - lower, dvec3{0.0});
+    dims_ = size3_t{glm::floor(extent / separation)} + size3_t{1};
+    if (glm::compMul(dims_) > maxCells) {
+        throw Exception("Separation " + std::to_string(separation) + " results in too many cells",
+                        IVW_CONTEXT_CUSTOM("LineOccupancyGrid::LineOccupancyGrid"));
+    }
+    cells_ = std::make_unique<Cell[]>(glm::compMul(dims_));
+}
+
+uint32_t LineOccupancyGrid::newLineTag() {
+    uint32_t tag = nextTag_.fetch_add(1, std::memory_order_relaxed);
+    // skip the empty tag once the counter wraps around
+    while (tag == 0) tag = nextTag_.fetch_add(1, std::memory_order_relaxed);
+    return tag;
+}
+
+size3_t LineOccupancyGrid::cellIndex(const dvec3& pos) const {
+    return size3_t{glm::floor((pos - lower_) / separation_)};
+}
+
+bool LineOccupancyGrid::insert(const dvec3& pos, uint32_t tag) {
+    const auto rel = (pos - lower_) / separation_;
+    if (glm::any(glm::lessThan(rel, dvec3{0.0})) ||
+        glm::any(glm::greaterThanEqual(rel, dvec3{dims_}))) {
+        return false;
+    }
+    const auto ind = size3_t{rel};
+    auto& cell = cells_[ind.x + dims_.x * (ind.y + dims_.y * ind.z)];
+
+    const auto slot = cell.count.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= slotsPerCell) return false;
+
+    auto& s = cell.slots[slot];
+    s.pos = {static_cast<float>(pos.x), static_cast<float>(pos.y), static_cast<float>(pos.z)};
+    s.tag.store(tag, std::memory_order_release);
+    return true;
+}
+
+bool LineOccupancyGrid::isOccupied(const dvec3& pos, double distance, uint32_t tag) const {
+    const auto rel = (pos - lower_) / separation_;
+    const auto dist2 = std::pow(std::min(distance, separation_), 2.0);
+
+    const auto first = glm::max(glm::floor(rel) - 1.0, dvec3{0.0});
+    const auto last = glm::min(glm::floor(rel) + 1.0, dvec3{dims_} - 1.0);
+    if (glm::any(glm::greaterThan(first, last))) return false;
+
+    const auto begin = size3_t{first};
+    const auto end = size3_t{last};
+    for (size_t z = begin.z; z <= end.z; ++z) {
+        for (size_t y = begin.y; y <= end.y; ++y) {
+            for (size_t x = begin.x; x <= end.x; ++x) {
+                const auto& cell = cells_[x + dims_.x * (y + dims_.y * z)];
+                const auto count = std::min<size_t>(
+                    cell.count.load(std::memory_order_relaxed), slotsPerCell);
+                for (size_t i = 0; i < count; ++i) {
+                    const auto& s = cell.slots[i];
+                    const auto sTag = s.tag.load(std::memory_order_acquire);
+                    if (sTag == 0 || sTag == tag) continue;
+                    const dvec3 d = dvec3{s.pos[0], s.pos[1], s.pos[2]} - pos;
+                    if (glm::dot(d, d) < dist2) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace inviwo
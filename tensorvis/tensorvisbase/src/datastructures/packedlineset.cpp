@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/packedlineset.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace inviwo {
+
+PackedLineSet::PackedLineSet(const mat4& modelMatrix, const mat4& worldMatrix)
+    : modelMatrix_{modelMatrix}, worldMatrix_{worldMatrix}, offsets_{0} {}
+
+bool PackedLineSet::hasMetaData(const std::string& name) const {
+    return metaData_.find(name) != metaData_.end();
+}
+
+std::vector<dvec3>& PackedLineSet::getMetaData(const std::string& name, bool create) {
+    auto it = metaData_.find(name);
+    if (it != metaData_.end()) return it->second;
+    if (!create) {
+        throw Exception("No metadata with name " + name,
+                        IVW_CONTEXT_CUSTOM("PackedLineSet::getMetaData"));
+    }
+    // vertices of a new channel for existing lines are zero
+    return metaData_.emplace(name, std::vector<dvec3>(positions_.size(), dvec3{0.0}))
+        .first->second;
+}
+
+const std::vector<dvec3>& PackedLineSet::getMetaData(const std::string& name) const {
+    auto it = metaData_.find(name);
+    if (it == metaData_.end()) {
+        throw Exception("No metadata with name " + name,
+                        IVW_CONTEXT_CUSTOM("PackedLineSet::getMetaData"));
+    }
+    return it->second;
+}
+
+void PackedLineSet::commitLine(const LineInfo& info) {
+    for (const auto& [name, data] : metaData_) {
+        if (data.size() != positions_.size()) {
+            throw Exception("Metadata " + name + " has " + std::to_string(data.size()) +
+                                " vertices, expected " + std::to_string(positions_.size()),
+                            IVW_CONTEXT_CUSTOM("PackedLineSet::commitLine"));
+        }
+    }
+    offsets_.push_back(positions_.size());
+    lines_.push_back(info);
+}
+
+void PackedLineSet::discardLine() {
+    const auto begin = getLineBegin();
+    positions_.resize(begin);
+    for (auto& [name, data] : metaData_) data.resize(begin);
+}
+
+void PackedLineSet::append(PackedLineSet&& other) {
+    if (other.empty()) return;
+    if (empty() && positions_.empty()) {
+        const auto model = modelMatrix_;
+        const auto world = worldMatrix_;
+        *this = std::move(other);
+        modelMatrix_ = model;
+        worldMatrix_ = world;
+        return;
+    }
+
+    const bool sameChannels =
+        metaData_.size() == other.metaData_.size() &&
+        std::equal(metaData_.begin(), metaData_.end(), other.metaData_.begin(),
+                   [](const auto& a, const auto& b) { return a.first == b.first; });
+    if (!sameChannels) {
+        throw Exception("Cannot append lines with different metadata",
+                        IVW_CONTEXT_CUSTOM("PackedLineSet::append"));
+    }
+
+    // uncommitted vertices of either set are dropped
+    discardLine();
+    const auto count = other.getLineBegin();
+    const auto base = positions_.size();
+    positions_.insert(positions_.end(), other.positions_.begin(),
+                      other.positions_.begin() + count);
+    for (auto& [name, data] : metaData_) {
+        const auto& src = other.metaData_[name];
+        data.insert(data.end(), src.begin(), src.begin() + count);
+    }
+    std::transform(other.offsets_.begin() + 1, other.offsets_.end(), std::back_inserter(offsets_),
+                   [base](size_t offset) { return base + offset; });
+    lines_.insert(lines_.end(), other.lines_.begin(), other.lines_.end());
+}
+
+std::shared_ptr<IntegralLineSet> PackedLineSet::toIntegralLineSet() const {
+    auto lines = std::make_shared<IntegralLineSet>(modelMatrix_, worldMatrix_);
+    for (size_t i = 0; i < size(); ++i) {
+        const auto begin = static_cast<std::ptrdiff_t>(offsets_[i]);
+        const auto end = static_cast<std::ptrdiff_t>(offsets_[i + 1]);
+
+        IntegralLine line;
+        line.getPositions().assign(positions_.begin() + begin, positions_.begin() + end);
+        for (const auto& [name, data] : metaData_) {
+            line.getMetaData<dvec3>(name, true).assign(data.begin() + begin, data.begin() + end);
+        }
+        line.setBackwardTerminationReason(lines_[i].backward);
+        line.setForwardTerminationReason(lines_[i].forward);
+        lines->push_back(std::move(line), lines_[i].seedID);
+    }
+    return lines;
+}
+
+std::shared_ptr<Mesh> PackedLineSet::toMesh() const {
+    const auto numVertices = getLineBegin();
+    std::vector<vec3> vertices(numVertices);
+    std::transform(positions_.begin(), positions_.begin() + numVertices, vertices.begin(),
+                   [](const dvec3& p) { return vec3(p); });
+
+    std::vector<uint32_t> indices;
+    indices.reserve(2 * (numVertices - std::min(numVertices, size())));
+    for (size_t i = 0; i < size(); ++i) {
+        for (auto v = static_cast<uint32_t>(offsets_[i]); v + 1 < offsets_[i + 1]; ++v) {
+            indices.push_back(v);
+            indices.push_back(v + 1);
+        }
+    }
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->setModelMatrix(modelMatrix_);
+    mesh->setWorldMatrix(worldMatrix_);
+    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(vertices)));
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                     std::make_shared<IndexBuffer>(
+                         std::make_shared<IndexBufferRAM>(std::move(indices))));
+    return mesh;
+}
+
+}  // namespace inviwo
@@ -29,6 +29,7 @@
 
 #include <inviwo/tensorvisbase/datastructures/tensorfield2d.h>
 #include <inviwo/core/datastructures/image/imageram.h>
+#include <inviwo/utilities/util/parallel.h>
 
 namespace inviwo {
 TensorField2D::TensorField2D(const size2_t dimensions, const std::vector<dmat2>& data,
@@ -197,6 +198,68 @@ TensorField2D::TensorField2D(const size_t x, const size_t y, const std::vector<d
     computeNormalizedScreenCoordinates();
 }
 
+TensorField2D::TensorField2D(const size2_t dimensions, SymmetricTensorStorage2D<double> data,
+                             const dvec2& extends)
+    : dimensions_(dimensions)
+    , extends_(extends)
+    , size_(dimensions.x * dimensions.y)
+    , rank_(2)
+    , dimensionality_(2)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data)) {
+    fullTensorsPending_ = true;
+    computeEigenValuesAndEigenVectors();
+    computeNormalizedScreenCoordinates();
+}
+
+TensorField2D::TensorField2D(const size2_t dimensions, SymmetricTensorStorage2D<float> data,
+                             const dvec2& extends)
+    : dimensions_(dimensions)
+    , extends_(extends)
+    , size_(dimensions.x * dimensions.y)
+    , rank_(2)
+    , dimensionality_(2)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data)) {
+    fullTensorsPending_ = true;
+    computeEigenValuesAndEigenVectors();
+    computeNormalizedScreenCoordinates();
+}
+
+TensorField2D::TensorField2D(const size2_t dimensions, FullTensorStorage2D<float> data,
+                             const dvec2& extends)
+    : dimensions_(dimensions)
+    , extends_(extends)
+    , size_(dimensions.x * dimensions.y)
+    , rank_(2)
+    , dimensionality_(2)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data)) {
+    fullTensorsPending_ = true;
+    computeEigenValuesAndEigenVectors();
+    computeNormalizedScreenCoordinates();
+}
+
+TensorField2D::TensorField2D(const TensorField2D& tf)
+    : majorEigenVectors_(tf.majorEigenVectors_)
+    , minorEigenVectors_(tf.minorEigenVectors_)
+    , majorEigenValues_(tf.majorEigenValues_)
+    , minorEigenValues_(tf.minorEigenValues_)
+    , normalizedImagePositions_(tf.normalizedImagePositions_)
+    , coordinates_(tf.coordinates_)
+    , dimensions_(tf.dimensions_)
+    , extends_(tf.extends_)
+    , offset_(tf.offset_)
+    , size_(tf.size_)
+    , rank_(tf.rank_)
+    , dimensionality_(tf.dimensionality_)
+    , indexMapper_(tf.indexMapper_)
+    , packedTensors_(tf.packedTensors_) {
+    std::lock_guard<std::mutex> lock(tf.tensorsMutex_);
+    tensors_ = tf.tensors_;
+    fullTensorsPending_ = tf.fullTensorsPending_.load();
+}
+
 std::string TensorField2D::getDataInfo() const {
     std::stringstream ss;
     ss << "<table border='0' cellspacing='0' cellpadding='0' "
@@ -214,7 +277,7 @@ std::string TensorField2D::getDataInfo() const {
        << "Number of tensors"
        << "</td>"
        << "<td>"
-       << "<nobr>" << tensors_.size() << "</nobr>"
+       << "<nobr>" << size_ << "</nobr>"
        << "</td>"
        << "</tr>"
        << "<tr>"
@@ -277,40 +340,52 @@ std::string TensorField2D::getDataInfo() const {
     return ss.str();
 }
 
-std::shared_ptr<Image> TensorField2D::getImageRepresentation() const {
-    std::shared_ptr<Image> ret = std::make_shared<Image>(dimensions_, DataVec4Float32::get());
+std::shared_ptr<const Image> TensorField2D::getImageRepresentation() const {
+    std::lock_guard<std::mutex> lock(imageRepresentationMutex_);
+    if (imageRepresentation_) return imageRepresentation_;
 
-    auto colorLayer = ret->getEditableRepresentation<ImageRAM>()->getColorLayerRAM();
+    auto image = std::make_shared<Image>(dimensions_, DataVec4Float32::get());
+    auto colorLayer = image->getEditableRepresentation<ImageRAM>()->getColorLayerRAM();
+    auto data = static_cast<vec4*>(colorLayer->getData());
 
-    for (size_t y = 0; y < dimensions_.y; y++) {
-        for (size_t x = 0; x < dimensions_.x; x++) {
-            auto tensor = at(x, y);
-
-            colorLayer->setFromDVec4(size2_t(x, y),
-                                     dvec4(tensor[0][0], tensor[1][0], tensor[0][1], tensor[1][1]));
-        }
+    for (size_t i = 0; i < size_; ++i) {
+        const auto t = tensor(i);
+        data[i] = vec4(t[0][0], t[1][0], t[0][1], t[1][1]);
     }
 
-    return ret;
+    imageRepresentation_ = image;
+    return imageRepresentation_;
 }
 
-dmat2& TensorField2D::at(const size2_t position) { return tensors_[indexMapper_(position)]; }
+dmat2& TensorField2D::at(const size2_t position) {
+    unpackTensors();
+    return tensors_[indexMapper_(position)];
+}
 
 dmat2& TensorField2D::at(const size_t x, const size_t y) {
+    unpackTensors();
     return tensors_[indexMapper_(size2_t(x, y))];
 }
 
-dmat2& TensorField2D::at(const size_t index) { return tensors_[index]; }
+dmat2& TensorField2D::at(const size_t index) {
+    unpackTensors();
+    return tensors_[index];
+}
 
 const dmat2& TensorField2D::at(const size2_t position) const {
+    ensureFullTensors();
     return tensors_[indexMapper_(position)];
 }
 
 const dmat2& TensorField2D::at(const size_t x, const size_t y) const {
+    ensureFullTensors();
     return tensors_[indexMapper_(size2_t(x, y))];
 }
 
-const dmat2& TensorField2D::at(const size_t index) const { return tensors_[index]; }
+const dmat2& TensorField2D::at(const size_t index) const {
+    ensureFullTensors();
+    return tensors_[index];
+}
 
 size_t TensorField2D::getSize() const { return size_; }
 
@@ -370,7 +445,66 @@ const std::vector<dvec2>& TensorField2D::normalizedImagePositions() const {
     return normalizedImagePositions_;
 }
 
-const std::vector<dmat2>& TensorField2D::tensors() const { return tensors_; }
+const std::vector<dmat2>& TensorField2D::tensors() const {
+    ensureFullTensors();
+    return tensors_;
+}
+
+dmat2 TensorField2D::tensor(const size_t index) const {
+    if (const auto packed = std::get_if<SymmetricTensorStorage2D<double>>(&packedTensors_)) {
+        return packed->get(index);
+    } else if (const auto packedFloat =
+                   std::get_if<SymmetricTensorStorage2D<float>>(&packedTensors_)) {
+        return packedFloat->get(index);
+    } else if (const auto fullFloat = std::get_if<FullTensorStorage2D<float>>(&packedTensors_)) {
+        return fullFloat->get(index);
+    }
+    return tensors_[index];
+}
+
+dmat2 TensorField2D::tensor(const size2_t& position) const {
+    return tensor(indexMapper_(position));
+}
+
+TensorStorage TensorField2D::getTensorStorage() const {
+    if (std::holds_alternative<SymmetricTensorStorage2D<double>>(packedTensors_)) {
+        return TensorStorage::Symmetric;
+    } else if (std::holds_alternative<SymmetricTensorStorage2D<float>>(packedTensors_)) {
+        return TensorStorage::SymmetricFloat;
+    } else if (std::holds_alternative<FullTensorStorage2D<float>>(packedTensors_)) {
+        return TensorStorage::FullFloat;
+    }
+    return TensorStorage::Full;
+}
+
+void TensorField2D::setTensorStorage(TensorStorage storage) {
+    if (storage == getTensorStorage()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(imageRepresentationMutex_);
+        imageRepresentation_.reset();
+    }
+
+    ensureFullTensors();
+    switch (storage) {
+        case TensorStorage::Symmetric:
+            packedTensors_ = SymmetricTensorStorage2D<double>(tensors_);
+            break;
+        case TensorStorage::SymmetricFloat:
+            packedTensors_ = SymmetricTensorStorage2D<float>(tensors_);
+            break;
+        case TensorStorage::FullFloat:
+            packedTensors_ = FullTensorStorage2D<float>(tensors_);
+            break;
+        case TensorStorage::Full:
+        default:
+            packedTensors_ = std::monostate{};
+            return;
+    }
+    tensors_.clear();
+    tensors_.shrink_to_fit();
+    fullTensorsPending_ = true;
+}
 
 std::array<std::pair<double, dvec2>, 2> TensorField2D::getSortedEigenValuesAndEigenVectorsForTensor(
     const size_t index) const {
@@ -465,18 +599,71 @@ void TensorField2D::computeEigenValuesAndEigenVectors() {
     majorEigenVectors_.resize(size_);
     minorEigenVectors_.resize(size_);
 
-#pragma omp parallel for
-    for (int i = 0; i < static_cast<int>(tensors_.size()); i++) {
-        auto tensor = tensors_[i];
+    const bool packed = !std::holds_alternative<std::monostate>(packedTensors_);
+
+    // Ranges of whole rows go through the closed-form batch solver, the general solver is only
+    // used for the tensors that are not symmetric
+    const auto rowLength = std::max<size_t>(dimensions_.x, 1);
+    const auto grainSize =
+        std::max<size_t>(1, util::defaultGrainSize(size_) / rowLength) * rowLength;
+    util::forEachRangeParallel(size_, grainSize, [&](size_t begin, size_t end) {
+        std::vector<dmat2> unpacked;
+        const dmat2* tensors = nullptr;
+        if (packed) {
+            // Packed tensors are symmetric by construction
+            unpacked.resize(end - begin);
+            for (size_t i = begin; i < end; ++i) unpacked[i - begin] = tensor(i);
+            tensors = unpacked.data();
+        } else {
+            tensors = tensors_.data() + begin;
+        }
+
+        tensorutil::calculateSymmetricEigenSystems(
+            tensors, end - begin, majorEigenValues_.data() + begin,
+            minorEigenValues_.data() + begin, majorEigenVectors_.data() + begin,
+            minorEigenVectors_.data() + begin);
 
-        auto eigenValuesAndEigenVectors = func(tensor);
+        if (packed) return;
+        for (size_t i = begin; i < end; ++i) {
+            if (tensorutil::isSymmetric(tensors_[i])) continue;
+            const auto eigenValuesAndEigenVectors = func(tensors_[i]);
 
-        majorEigenVectors_[i] = eigenValuesAndEigenVectors[0].second;
-        minorEigenVectors_[i] = eigenValuesAndEigenVectors[1].second;
+            majorEigenVectors_[i] = eigenValuesAndEigenVectors[0].second;
+            minorEigenVectors_[i] = eigenValuesAndEigenVectors[1].second;
 
-        majorEigenValues_[i] = eigenValuesAndEigenVectors[0].first;
-        minorEigenValues_[i] = eigenValuesAndEigenVectors[1].first;
+            majorEigenValues_[i] = eigenValuesAndEigenVectors[0].first;
+            minorEigenValues_[i] = eigenValuesAndEigenVectors[1].first;
+        }
+    });
+}
+
+void TensorField2D::ensureFullTensors() const {
+    if (!fullTensorsPending_.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(tensorsMutex_);
+    if (!fullTensorsPending_.load(std::memory_order_relaxed)) return;
+
+    std::visit(
+        [this](const auto& packed) {
+            using Packed = std::decay_t<decltype(packed)>;
+            if constexpr (!std::is_same_v<Packed, std::monostate>) {
+                tensors_ = packed.toTensors();
+            }
+        },
+        packedTensors_);
+
+    fullTensorsPending_.store(false, std::memory_order_release);
+}
+
+void TensorField2D::unpackTensors() {
+    {
+        std::lock_guard<std::mutex> lock(imageRepresentationMutex_);
+        imageRepresentation_.reset();
     }
+    if (std::holds_alternative<std::monostate>(packedTensors_)) return;
+
+    ensureFullTensors();
+    packedTensors_ = std::monostate{};
 }
 
 void TensorField2D::computeNormalizedScreenCoordinates() {
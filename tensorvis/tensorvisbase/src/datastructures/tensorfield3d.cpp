@@ -1,9 +1,13 @@
 #include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/memorybudget/firsttouch.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <modules/eigenutils/eigenutils.h>
 #include <inviwo/tensorvisbase/util/misc.h>
+#include <inviwo/utilities/util/parallel.h>
 #include <inviwo/core/util/exception.h>
+#include <stdexcept>
 
 namespace inviwo {
 
@@ -16,13 +20,12 @@ TensorField3D::TensorField3D(const size3_t dimensions, std::vector<dmat3> data,
     , size_(glm::compMul(dimensions))
     , rank_(2)
     , dimensionality_(3) {
-    if (size_ != tensors_.size()) {
+    if (size_ != tensors_->size()) {
         throw Exception("Data/dimensions mismatch in TensorField3D constructor.", IVW_CONTEXT);
     }
 
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -35,6 +38,8 @@ TensorField3D::TensorField3D(const size3_t dimensions, const std::vector<double>
     , size_(glm::compMul(dimensions))
     , rank_(2)
     , dimensionality_(3) {
+    auto &tensors = tensors_.modify();
+    tensors.reserve(data.size() / 9);
     for (size_t i = 0; i < data.size(); i += 9) {
         dmat3 tensor;
         tensor[0][0] = data[i];
@@ -47,12 +52,11 @@ TensorField3D::TensorField3D(const size3_t dimensions, const std::vector<double>
         tensor[1][2] = data[i + 7];
         tensor[2][2] = data[i + 8];
 
-        tensors_.push_back(tensor);
+        tensors.push_back(tensor);
     }
 
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -71,6 +75,8 @@ TensorField3D::TensorField3D(const size3_t dimensions, const std::vector<double>
     , size_(glm::compMul(dimensions))
     , rank_(2)
     , dimensionality_(3) {
+    auto &tensors = tensors_.modify();
+    tensors.reserve(data.size() / 9);
     for (size_t i = 0; i < data.size(); i += 9) {
         dmat3 tensor;
         tensor[0][0] = data[i];
@@ -83,7 +89,7 @@ TensorField3D::TensorField3D(const size3_t dimensions, const std::vector<double>
         tensor[1][2] = data[i + 7];
         tensor[2][2] = data[i + 8];
 
-        tensors_.push_back(tensor);
+        tensors.push_back(tensor);
     }
 
     addMetaData<MajorEigenValues>(majorEigenValues, TensorFeature::Sigma1);
@@ -137,9 +143,8 @@ TensorField3D::TensorField3D(const size_t x, const size_t y, const size_t z,
     , size_(x * y * z)
     , rank_(2)
     , dimensionality_(3) {
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -152,6 +157,8 @@ TensorField3D::TensorField3D(const size_t x, const size_t y, const size_t z,
     , size_(x * y * z)
     , rank_(2)
     , dimensionality_(3) {
+    auto &tensors = tensors_.modify();
+    tensors.reserve(data.size() / 9);
     for (size_t i = 0; i < data.size(); i += 9) {
         dmat3 tensor;
         tensor[0][0] = data[i];
@@ -164,12 +171,11 @@ TensorField3D::TensorField3D(const size_t x, const size_t y, const size_t z,
         tensor[1][2] = data[i + 7];
         tensor[2][2] = data[i + 8];
 
-        tensors_.push_back(tensor);
+        tensors.push_back(tensor);
     }
 
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -182,14 +188,14 @@ TensorField3D::TensorField3D(size3_t dimensions, const double *data, const vec3
     , size_(dimensions.x * dimensions.y * dimensions.z)
     , rank_(2)
     , dimensionality_(3) {
-    tensors_.resize(size_);
+    auto &tensors = tensors_.modify();
+    tensors.resize(size_);
     for (size_t i = 0; i < size_; ++i) {
-        std::copy(data + i * 9, data + (i + 1) * 9, glm::value_ptr(tensors_[i]));
+        std::copy(data + i * 9, data + (i + 1) * 9, glm::value_ptr(tensors[i]));
     }
 
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -202,15 +208,14 @@ TensorField3D::TensorField3D(size3_t dimensions, const float *data, const vec3 &
     , size_(dimensions.x * dimensions.y * dimensions.z)
     , rank_(2)
     , dimensionality_(3) {
+    // Keep the input precision, the tensors are widened to double on access
+    std::vector<mat3> tensors(size_);
+    if (size_ > 0) std::copy(data, data + size_ * 9, glm::value_ptr(tensors.front()));
+    packedTensors_ = FullTensorStorage3D<float>(std::move(tensors));
+    fullTensorsPending_ = true;
 
-    tensors_.resize(size_);
-    for (size_t i = 0; i < size_; ++i) {
-        std::copy(data + i * 9, data + (i + 1) * 9, glm::value_ptr(tensors_[i]));
-    }
-
-    computeEigenValuesAndEigenVectors();
+    deferEigenDecomposition();
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
@@ -227,6 +232,8 @@ TensorField3D::TensorField3D(
     , size_(x * y * z)
     , rank_(2)
     , dimensionality_(3) {
+    auto &tensors = tensors_.modify();
+    tensors.reserve(data.size() / 9);
     for (size_t i = 0; i < data.size(); i += 9) {
         dmat3 tensor;
         tensor[0][0] = data[i];
@@ -239,7 +246,7 @@ TensorField3D::TensorField3D(
         tensor[1][2] = data[i + 7];
         tensor[2][2] = data[i + 8];
 
-        tensors_.push_back(tensor);
+        tensors.push_back(tensor);
     }
 
     addMetaData<MajorEigenValues>(majorEigenValues, TensorFeature::Sigma1);
@@ -299,34 +306,117 @@ TensorField3D::TensorField3D(
     , rank_(2)
     , dimensionality_(3) {
     for (auto &dataItem : metaData) {
-        metaData_.insert(std::make_pair(dataItem.first, dataItem.second->clone()));
+        metaData_.insert(std::make_pair(
+            dataItem.first, std::shared_ptr<const MetaDataBase>(dataItem.second->clone())));
+        updateMetaDataSlot(dataItem.first);
     }
 
     computeNormalizedScreenCoordinates(sliceCoord);
-    computeDataMaps();
+    // An incomplete eigen system is recomputed from the tensors on first access
+    if (hasEigenMetaData()) {
+        computeDataMaps();
+    } else {
+        deferEigenDecomposition();
+    }
+    setBasis(
+        {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
+}
+
+TensorField3D::TensorField3D(const size3_t dimensions, SymmetricTensorStorage3D<double> data,
+                             const vec3 &extent, float sliceCoord)
+    : StructuredGridEntity<3>()
+    , dimensions_(dimensions)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data))
+    , size_(glm::compMul(dimensions))
+    , rank_(2)
+    , dimensionality_(3) {
+    if (size_ != std::get<SymmetricTensorStorage3D<double>>(*packedTensors_).size()) {
+        throw Exception("Data/dimensions mismatch in TensorField3D constructor.", IVW_CONTEXT);
+    }
+
+    fullTensorsPending_ = true;
+    deferEigenDecomposition();
+    computeNormalizedScreenCoordinates(sliceCoord);
+    setBasis(
+        {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
+}
+
+TensorField3D::TensorField3D(const size3_t dimensions, SymmetricTensorStorage3D<float> data,
+                             const vec3 &extent, float sliceCoord)
+    : StructuredGridEntity<3>()
+    , dimensions_(dimensions)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data))
+    , size_(glm::compMul(dimensions))
+    , rank_(2)
+    , dimensionality_(3) {
+    if (size_ != std::get<SymmetricTensorStorage3D<float>>(*packedTensors_).size()) {
+        throw Exception("Data/dimensions mismatch in TensorField3D constructor.", IVW_CONTEXT);
+    }
+
+    fullTensorsPending_ = true;
+    deferEigenDecomposition();
+    computeNormalizedScreenCoordinates(sliceCoord);
+    setBasis(
+        {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
+}
+
+TensorField3D::TensorField3D(const size3_t dimensions, FullTensorStorage3D<float> data,
+                             const vec3 &extent, float sliceCoord)
+    : StructuredGridEntity<3>()
+    , dimensions_(dimensions)
+    , indexMapper_(dimensions)
+    , packedTensors_(std::move(data))
+    , size_(glm::compMul(dimensions))
+    , rank_(2)
+    , dimensionality_(3) {
+    if (size_ != std::get<FullTensorStorage3D<float>>(*packedTensors_).size()) {
+        throw Exception("Data/dimensions mismatch in TensorField3D constructor.", IVW_CONTEXT);
+    }
+
+    fullTensorsPending_ = true;
+    deferEigenDecomposition();
+    computeNormalizedScreenCoordinates(sliceCoord);
     setBasis(
         {vec3{extent[0], 0.0f, 0.0f}, vec3{0.0f, extent[1], 0.0f}, vec3{0.0f, 0.0f, extent[2]}});
 }
 
 TensorField3D::TensorField3D(const TensorField3D &tf)
     : StructuredGridEntity<3>()
-    , dataMapEigenValues_(tf.dataMapEigenValues_)
-    , dataMapEigenVectors_(tf.dataMapEigenVectors_)
     , dimensions_(tf.dimensions_)
     , indexMapper_(util::IndexMapper3D(dimensions_))
-    , tensors_(tf.tensors_)
+    , packedTensors_(tf.packedTensors_)
     , size_(tf.size_)
     , rank_(tf.rank_)
     , dimensionality_(tf.dimensionality_)
     , normalizedVolumePositions_(tf.normalizedVolumePositions_)
-    , binaryMask_(tf.binaryMask_) {
+    , binaryMask_(tf.binaryMask_)
+    , definedIndices_(tf.definedIndices_) {
 
     setOffset(tf.getOffset());
     setBasis(tf.getBasis());
 
-    for (const auto &m : tf.metaData_) {
-        metaData_.insert(std::make_pair(m.first, m.second->clone()));
+    // Tensors, meta data and the volume representation are shared with the source, none of
+    // them depend on the basis or offset
+    {
+        std::lock_guard<std::mutex> lock(tf.tensorsMutex_);
+        tensors_ = tf.tensors_;
+        fullTensorsPending_ = tf.fullTensorsPending_.load();
+    }
+    {
+        std::lock_guard<std::mutex> lock(tf.volumeRepresentationMutex_);
+        volumeRepresentation_ = tf.volumeRepresentation_;
     }
+
+    // A pending eigen decomposition of the source is not triggered by the copy, the copy will
+    // compute its own on first access
+    std::lock_guard<std::mutex> lock(tf.eigenDecompositionMutex_);
+    metaData_ = tf.metaData_;
+    metaDataSlots_ = tf.metaDataSlots_;
+    dataMapEigenValues_ = tf.dataMapEigenValues_;
+    dataMapEigenVectors_ = tf.dataMapEigenVectors_;
+    eigenDecompositionPending_ = tf.eigenDecompositionPending_.load();
 }
 
 std::string TensorField3D::getDataInfo() const {
@@ -334,9 +424,36 @@ std::string TensorField3D::getDataInfo() const {
     ss << "<table border='0' cellspacing='0' cellpadding='0' "
           "style='border-color:white;white-space:pre;'>/n"
        << tensorutil::getHTMLTableRowString("Type", "3D tensor field")
-       << tensorutil::getHTMLTableRowString("Number of tensors", tensors_.size())
-       << tensorutil::getHTMLTableRowString("Dimensions", dimensions_)
-       << tensorutil::getHTMLTableRowString("Max major field eigenvalue",
+       << tensorutil::getHTMLTableRowString("Number of tensors", size_)
+       << tensorutil::getHTMLTableRowString("Dimensions", dimensions_);
+
+    switch (getTensorStorage()) {
+        case TensorStorage::Symmetric:
+            ss << tensorutil::getHTMLTableRowString("Storage", "Symmetric (double)");
+            break;
+        case TensorStorage::SymmetricFloat:
+            ss << tensorutil::getHTMLTableRowString("Storage", "Symmetric (float)");
+            break;
+        case TensorStorage::Sparse:
+            ss << tensorutil::getHTMLTableRowString(
+                "Storage", "Sparse (" + std::to_string(sparseTensors()->numDefined()) +
+                               " defined)");
+            break;
+        case TensorStorage::FullFloat:
+            ss << tensorutil::getHTMLTableRowString("Storage", "Full (float)");
+            break;
+        default:
+            break;
+    }
+
+    // Don't trigger a deferred eigen decomposition just for displaying information
+    if (!hasEigenDecomposition()) {
+        ss << tensorutil::getHTMLTableRowString("Eigen decomposition", "Not computed yet")
+           << tensorutil::getHTMLTableRowString("Extends", getExtents()) << "</table>";
+        return ss.str();
+    }
+
+    ss << tensorutil::getHTMLTableRowString("Max major field eigenvalue",
                                             dataMapEigenValues_[0].valueRange.y)
        << tensorutil::getHTMLTableRowString("Min major field eigenvalue",
                                             dataMapEigenValues_[0].valueRange.x)
@@ -369,83 +486,91 @@ std::string TensorField3D::getDataInfo() const {
  *   The first volume of the pair will then store (xx, yy, zz) and the second volume
  *   will store (xy, yz, xz).
  */
-std::pair<std::shared_ptr<Volume>, std::shared_ptr<Volume>> TensorField3D::getVolumeRepresentation()
-    const {
-    std::pair<std::shared_ptr<Volume>, std::shared_ptr<Volume>> ret;
-
-    auto volume1 = std::make_shared<Volume>(dimensions_, DataVec3Float32::get());
-    auto volume2 = std::make_shared<Volume>(dimensions_, DataVec3Float32::get());
-
-    auto tensorField = std::make_pair(volume1, volume2);
-
-    auto XXYYZZ = tensorField.first->getEditableRepresentation<VolumeRAM>();
-    auto XYYZXZ = tensorField.second->getEditableRepresentation<VolumeRAM>();
-
-    util::IndexMapper3D indexMapper(dimensions_);
-
-    for (size_t z = 0; z < dimensions_.z; z++) {
-        for (size_t x = 0; x < dimensions_.x; x++) {
-            for (size_t y = 0; y < dimensions_.y; y++) {
-                auto tensor = at(size3_t(x, y, z)).second;
-                XXYYZZ->setFromDVec3(size3_t(x, y, z),
-                                     dvec3(tensor[0][0], tensor[1][1], tensor[2][2]));
-
-                XYYZXZ->setFromDVec3(size3_t(x, y, y),
-                                     dvec3(tensor[1][0], tensor[2][1], tensor[2][0]));
-            }
+std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>
+TensorField3D::getVolumeRepresentation() const {
+    std::lock_guard<std::mutex> lock(volumeRepresentationMutex_);
+    if (volumeRepresentation_.first) return volumeRepresentation_;
+
+    // Allocated and filled with the same slice partitioning, see util::allocateFirstTouch
+    auto ram1 = std::static_pointer_cast<VolumeRAMPrecision<vec3>>(
+        util::createVolumeRAMFirstTouch(dimensions_, DataVec3Float32::get()));
+    auto ram2 = std::static_pointer_cast<VolumeRAMPrecision<vec3>>(
+        util::createVolumeRAMFirstTouch(dimensions_, DataVec3Float32::get()));
+
+    auto XXYYZZ = ram1->getDataTyped();
+    auto XYYZXZ = ram2->getDataTyped();
+
+    const auto sliceSize = dimensions_.x * dimensions_.y;
+    util::forEachSliceRangeParallel(dimensions_, [&](size_t begin, size_t end) {
+        for (size_t i = begin * sliceSize; i < end * sliceSize; ++i) {
+            const auto t = tensor(i);
+            XXYYZZ[i] = vec3(t[0][0], t[1][1], t[2][2]);
+            XYYZXZ[i] = vec3(t[1][0], t[2][1], t[2][0]);
         }
-    }
+    });
 
-    return ret;
+    auto volume1 = std::make_shared<Volume>(ram1);
+    auto volume2 = std::make_shared<Volume>(ram2);
+
+    volumeRepresentation_ = std::make_pair(volume1, volume2);
+    return volumeRepresentation_;
 }
 
 std::pair<glm::uint8, dmat3 &> TensorField3D::at(const size3_t position) {
+    unpackTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[indexMapper_(position)];
+    if (hasMask()) maskVal = (*binaryMask_)[indexMapper_(position)];
 
-    return std::pair<glm::uint8, dmat3 &>(maskVal, tensors_[indexMapper_(position)]);
+    return std::pair<glm::uint8, dmat3 &>(maskVal, tensors_.modify()[indexMapper_(position)]);
 }
 
 std::pair<glm::uint8, dmat3 &> TensorField3D::at(const size_t x, const size_t y, const size_t z) {
+    unpackTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[indexMapper_(size3_t(x, y, z))];
+    if (hasMask()) maskVal = (*binaryMask_)[indexMapper_(size3_t(x, y, z))];
 
-    return std::pair<glm::uint8, dmat3 &>(maskVal, tensors_[indexMapper_(size3_t(x, y, z))]);
+    return std::pair<glm::uint8, dmat3 &>(maskVal,
+                                          tensors_.modify()[indexMapper_(size3_t(x, y, z))]);
 }
 
 std::pair<glm::uint8, dmat3 &> TensorField3D::at(const size_t index) {
+    unpackTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[index];
+    if (hasMask()) maskVal = (*binaryMask_)[index];
 
-    return std::pair<glm::uint8, dmat3 &>(maskVal, tensors_[index]);
+    return std::pair<glm::uint8, dmat3 &>(maskVal, tensors_.modify()[index]);
 }
 
 std::pair<glm::uint8, const dmat3 &> TensorField3D::at(const size3_t position) const {
+    ensureFullTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[indexMapper_(position)];
+    if (hasMask()) maskVal = (*binaryMask_)[indexMapper_(position)];
 
-    return std::pair<glm::uint8, const dmat3 &>(maskVal, tensors_[indexMapper_(position)]);
+    return std::pair<glm::uint8, const dmat3 &>(maskVal, (*tensors_)[indexMapper_(position)]);
 }
 
 std::pair<glm::uint8, const dmat3 &> TensorField3D::at(const size_t x, const size_t y,
                                                        const size_t z) const {
+    ensureFullTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[indexMapper_(size3_t(x, y, z))];
+    if (hasMask()) maskVal = (*binaryMask_)[indexMapper_(size3_t(x, y, z))];
 
-    return std::pair<glm::uint8, const dmat3 &>(maskVal, tensors_[indexMapper_(size3_t(x, y, z))]);
+    return std::pair<glm::uint8, const dmat3 &>(maskVal,
+                                                (*tensors_)[indexMapper_(size3_t(x, y, z))]);
 }
 
 std::pair<glm::uint8, const dmat3 &> TensorField3D::at(const size_t index) const {
+    ensureFullTensors();
     glm::uint8 maskVal = 0;
 
-    if (hasMask()) maskVal = binaryMask_[index];
+    if (hasMask()) maskVal = (*binaryMask_)[index];
 
-    return std::pair<glm::uint8, const dmat3 &>(maskVal, tensors_[index]);
+    return std::pair<glm::uint8, const dmat3 &>(maskVal, (*tensors_)[index]);
 }
 
 void TensorField3D::setExtents(const vec3 &extents) {
@@ -457,7 +582,7 @@ void TensorField3D::setExtents(const vec3 &extents) {
 }
 
 vec3 TensorField3D::getNormalizedVolumePosition(const size_t index) const {
-    return normalizedVolumePositions_[index];
+    return (*normalizedVolumePositions_)[index];
 }
 
 mat4 TensorField3D::getBasisAndOffset() const {
@@ -492,112 +617,28 @@ mat4 TensorField3D::getBasisAndOffset() const {
 
 std::array<std::pair<double, dvec3>, 3> TensorField3D::getSortedEigenValuesAndEigenVectorsForTensor(
     const size_t index) const {
-    const auto &majorEigenValues = getMetaData<MajorEigenValues>();
-    const auto &middleEigenValues = getMetaData<IntermediateEigenValues>();
-    const auto &minorEigenValues = getMetaData<MinorEigenValues>();
-
-    const auto &majorEigenValue = majorEigenValues[index];
-    const auto &middleEigenValue = middleEigenValues[index];
-    const auto &minorEigenValue = minorEigenValues[index];
-
-    const auto &majorEigenVectors = getMetaData<MajorEigenVectors>();
-    const auto &middleEigenVectors = getMetaData<IntermediateEigenVectors>();
-    const auto &minorEigenVectors = getMetaData<MinorEigenVectors>();
-
-    const auto &majorEigenVector = majorEigenVectors[index];
-    const auto &middleEigenVector = middleEigenVectors[index];
-    const auto &minorEigenVector = minorEigenVectors[index];
-
-    std::array<std::pair<double, dvec3>, 3> ret;
-    ret[0] = {majorEigenValue, majorEigenVector};
-    ret[1] = {middleEigenValue, middleEigenVector};
-    ret[2] = {minorEigenValue, minorEigenVector};
-
-    return ret;
+    return getEigenView().eigenSystem(index);
 }
 
 std::array<std::pair<double, dvec3>, 3> TensorField3D::getSortedEigenValuesAndEigenVectorsForTensor(
     const size3_t pos) const {
-    auto index = indexMapper_(pos);
-
-    const auto &majorEigenValues = getMetaData<MajorEigenValues>();
-    const auto &middleEigenValues = getMetaData<IntermediateEigenValues>();
-    const auto &minorEigenValues = getMetaData<MinorEigenValues>();
-
-    const auto &majorEigenValue = majorEigenValues[index];
-    const auto &middleEigenValue = middleEigenValues[index];
-    const auto &minorEigenValue = minorEigenValues[index];
-
-    const auto &majorEigenVectors = getMetaData<MajorEigenVectors>();
-    const auto &middleEigenVectors = getMetaData<IntermediateEigenVectors>();
-    const auto &minorEigenVectors = getMetaData<MinorEigenVectors>();
-
-    const auto &majorEigenVector = majorEigenVectors[index];
-    const auto &middleEigenVector = middleEigenVectors[index];
-    const auto &minorEigenVector = minorEigenVectors[index];
-
-    std::array<std::pair<double, dvec3>, 3> ret;
-    ret[0] = {majorEigenValue, majorEigenVector};
-    ret[1] = {middleEigenValue, middleEigenVector};
-    ret[2] = {minorEigenValue, minorEigenVector};
-
-    return ret;
+    return getEigenView().eigenSystem(indexMapper_(pos));
 }
 
 std::array<double, 3> TensorField3D::getSortedEigenValuesForTensor(const size_t index) const {
-    auto ret = std::array<double, 3>();
-
-    const auto &majorEigenValues = getMetaData<MajorEigenValues>();
-    const auto &middleEigenValues = getMetaData<IntermediateEigenValues>();
-    const auto &minorEigenValues = getMetaData<MinorEigenValues>();
-
-    ret[0] = majorEigenValues[index];
-    ret[1] = middleEigenValues[index];
-    ret[2] = minorEigenValues[index];
-    return ret;
+    return getEigenView().eigenValues(index);
 }
 
 std::array<double, 3> TensorField3D::getSortedEigenValuesForTensor(const size3_t &pos) const {
-    auto index = indexMapper_(pos);
-    auto ret = std::array<double, 3>();
-
-    const auto &majorEigenValues = getMetaData<MajorEigenValues>();
-    const auto &middleEigenValues = getMetaData<IntermediateEigenValues>();
-    const auto &minorEigenValues = getMetaData<MinorEigenValues>();
-
-    ret[0] = majorEigenValues[index];
-    ret[1] = middleEigenValues[index];
-    ret[2] = minorEigenValues[index];
-
-    return ret;
+    return getEigenView().eigenValues(indexMapper_(pos));
 }
 
 std::array<dvec3, 3> TensorField3D::getSortedEigenVectorsForTensor(const size_t index) const {
-    auto ret = std::array<dvec3, 3>();
-
-    const auto &majorEigenVectors = getMetaData<MajorEigenVectors>();
-    const auto &middleEigenVectors = getMetaData<IntermediateEigenVectors>();
-    const auto &minorEigenVectors = getMetaData<MinorEigenVectors>();
-
-    ret[0] = majorEigenVectors[index];
-    ret[1] = middleEigenVectors[index];
-    ret[2] = minorEigenVectors[index];
-
-    return ret;
+    return getEigenView().eigenVectors(index);
 }
 
 std::array<dvec3, 3> TensorField3D::getSortedEigenVectorsForTensor(const size3_t &pos) const {
-    auto index = indexMapper_(pos);
-    auto ret = std::array<dvec3, 3>();
-
-    const auto &majorEigenVectors = getMetaData<MajorEigenVectors>();
-    const auto &middleEigenVectors = getMetaData<IntermediateEigenVectors>();
-    const auto &minorEigenVectors = getMetaData<MinorEigenVectors>();
-
-    ret[0] = majorEigenVectors[index];
-    ret[1] = middleEigenVectors[index];
-    ret[2] = minorEigenVectors[index];
-    return ret;
+    return getEigenView().eigenVectors(indexMapper_(pos));
 }
 
 const std::vector<dvec3> &TensorField3D::majorEigenVectors() const {
@@ -624,78 +665,260 @@ const std::vector<double> &TensorField3D::minorEigenValues() const {
     return getMetaData<MinorEigenValues>();
 }
 
-const std::vector<dmat3> &TensorField3D::tensors() const { return tensors_; }
+const std::vector<dmat3> &TensorField3D::tensors() const {
+    ensureFullTensors();
+    return *tensors_;
+}
 
-int TensorField3D::getNumDefinedEntries() const {
-    return static_cast<int>(std::count(std::begin(binaryMask_), std::end(binaryMask_), 1));
+dmat3 TensorField3D::tensor(const size_t index) const {
+    if (const auto packed = std::get_if<SymmetricTensorStorage3D<double>>(&*packedTensors_)) {
+        return packed->get(index);
+    } else if (const auto packedFloat =
+                   std::get_if<SymmetricTensorStorage3D<float>>(&*packedTensors_)) {
+        return packedFloat->get(index);
+    } else if (const auto sparse = std::get_if<SparseTensorStorage3D>(&*packedTensors_)) {
+        return sparse->get(index);
+    } else if (const auto fullFloat = std::get_if<FullTensorStorage3D<float>>(&*packedTensors_)) {
+        return fullFloat->get(index);
+    }
+    return (*tensors_)[index];
 }
 
-bool TensorField3D::hasMetaData(const TensorFeature feature) const {
-    switch (feature) {
-        case TensorFeature::I1:
-            return hasMetaData<I1>();
-        case TensorFeature::I2:
-            return hasMetaData<I2>();
-        case TensorFeature::I3:
-            return hasMetaData<I3>();
-        case TensorFeature::J1:
-            return hasMetaData<J1>();
-        case TensorFeature::J2:
-            return hasMetaData<J2>();
-        case TensorFeature::J3:
-            return hasMetaData<J3>();
-        case TensorFeature::Sigma1:
-            return hasMetaData<MajorEigenValues>();
-        case TensorFeature::Sigma2:
-            return hasMetaData<IntermediateEigenValues>();
-        case TensorFeature::Sigma3:
-            return hasMetaData<MinorEigenValues>();
-        case TensorFeature::MajorEigenVector:
-            return hasMetaData<MajorEigenVectors>();
-        case TensorFeature::IntermediateEigenVector:
-            return hasMetaData<IntermediateEigenVectors>();
-        case TensorFeature::MinorEigenVector:
-            return hasMetaData<MinorEigenVectors>();
-        case TensorFeature::LodeAngle:
-            return hasMetaData<LodeAngle>();
-        case TensorFeature::Anisotropy:
-            return hasMetaData<Anisotropy>();
-        case TensorFeature::LinearAnisotropy:
-            return hasMetaData<LinearAnisotropy>();
-        case TensorFeature::PlanarAnisotropy:
-            return hasMetaData<PlanarAnisotropy>();
-        case TensorFeature::SphericalAnisotropy:
-            return hasMetaData<SphericalAnisotropy>();
-        case TensorFeature::Diffusivity:
-            return hasMetaData<Diffusivity>();
-        case TensorFeature::ShearStress:
-            return hasMetaData<ShearStress>();
-        case TensorFeature::PureShear:
-            return hasMetaData<PureShear>();
-        case TensorFeature::ShapeFactor:
-            return hasMetaData<ShapeFactor>();
-        case TensorFeature::IsotropicScaling:
-            return hasMetaData<IsotropicScaling>();
-        case TensorFeature::Rotation:
-            return hasMetaData<Rotation>();
-        case TensorFeature::FrobeniusNorm:
-            return hasMetaData<FrobeniusNorm>();
-        case TensorFeature::HillYieldCriterion:
-            return hasMetaData<HillYieldCriterion>();
-        default:
+dmat3 TensorField3D::tensor(const size3_t &position) const {
+    return tensor(indexMapper_(position));
+}
+
+TensorStorage TensorField3D::getTensorStorage() const {
+    if (std::holds_alternative<SymmetricTensorStorage3D<double>>(*packedTensors_)) {
+        return TensorStorage::Symmetric;
+    } else if (std::holds_alternative<SymmetricTensorStorage3D<float>>(*packedTensors_)) {
+        return TensorStorage::SymmetricFloat;
+    } else if (std::holds_alternative<SparseTensorStorage3D>(*packedTensors_)) {
+        return TensorStorage::Sparse;
+    } else if (std::holds_alternative<FullTensorStorage3D<float>>(*packedTensors_)) {
+        return TensorStorage::FullFloat;
+    }
+    return TensorStorage::Full;
+}
+
+void TensorField3D::setTensorStorage(TensorStorage storage) {
+    if (storage == getTensorStorage()) return;
+    if (storage == TensorStorage::Sparse && !hasMask()) {
+        LogWarn("Sparse tensor storage requires a mask, keeping the current storage");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(volumeRepresentationMutex_);
+        volumeRepresentation_ = {};
+    }
+
+    ensureFullTensors();
+    switch (storage) {
+        case TensorStorage::Symmetric:
+            packedTensors_ = SymmetricTensorStorage3D<double>(*tensors_);
             break;
+        case TensorStorage::SymmetricFloat:
+            packedTensors_ = SymmetricTensorStorage3D<float>(*tensors_);
+            break;
+        case TensorStorage::Sparse:
+            packedTensors_ = SparseTensorStorage3D(*tensors_, *binaryMask_);
+            break;
+        case TensorStorage::FullFloat:
+            packedTensors_ = FullTensorStorage3D<float>(*tensors_);
+            break;
+        case TensorStorage::Full:
+        default:
+            packedTensors_ = std::monostate{};
+            updateDefinedIndices();
+            return;
+    }
+    updateDefinedIndices();
+    tensors_ = std::vector<dmat3>{};
+    fullTensorsPending_ = true;
+}
+
+void TensorField3D::ensureFullTensors() const {
+    if (!fullTensorsPending_.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(tensorsMutex_);
+    if (!fullTensorsPending_.load(std::memory_order_relaxed)) return;
+
+    std::visit(
+        [this](const auto &packed) {
+            using Packed = std::decay_t<decltype(packed)>;
+            if constexpr (!std::is_same_v<Packed, std::monostate>) {
+                tensors_ = packed.toTensors();
+            }
+        },
+        *packedTensors_);
+
+    fullTensorsPending_.store(false, std::memory_order_release);
+}
+
+void TensorField3D::unpackTensors() {
+    {
+        std::lock_guard<std::mutex> lock(volumeRepresentationMutex_);
+        volumeRepresentation_ = {};
     }
+    if (std::holds_alternative<std::monostate>(*packedTensors_)) return;
+
+    ensureFullTensors();
+    packedTensors_ = std::monostate{};
+    updateDefinedIndices();
+}
+
+void TensorField3D::setMask(const std::vector<glm::uint8> &mask) { setMask(BitMask(mask)); }
+
+void TensorField3D::setMask(BitMask mask) {
+    if (sparseTensors()) {
+        // The stored tensors follow the mask
+        std::lock_guard<std::mutex> lock(volumeRepresentationMutex_);
+        volumeRepresentation_ = {};
+        ensureFullTensors();
+        binaryMask_ = std::move(mask);
+        if (hasMask()) {
+            packedTensors_ = SparseTensorStorage3D(*tensors_, *binaryMask_);
+            tensors_ = std::vector<dmat3>{};
+            fullTensorsPending_ = true;
+        } else {
+            packedTensors_ = std::monostate{};
+        }
+    } else {
+        binaryMask_ = std::move(mask);
+    }
+    updateDefinedIndices();
+}
 
-    return false;
+const std::vector<size_t> &TensorField3D::definedIndices() const {
+    if (const auto sparse = sparseTensors()) return sparse->indices();
+    return *definedIndices_;
+}
+
+void TensorField3D::updateDefinedIndices() {
+    std::vector<size_t> indices;
+    if (!sparseTensors() && hasMask()) indices = binaryMask_->setIndices();
+    definedIndices_ = std::move(indices);
+}
+
+int TensorField3D::getNumDefinedEntries() const {
+    return hasMask() ? static_cast<int>(binaryMask_->count()) : 0;
+}
+
+bool TensorField3D::hasMetaData(const TensorFeature feature) const {
+    const auto slot = tensorutil::metaDataSlot(feature);
+    return slot < metaDataSlots_.size() && metaDataSlots_[slot] != nullptr;
 }
 
 bool TensorField3D::hasMetaData(const uint64_t id) const {
+    const auto slot = tensorutil::metaDataSlot(id);
+    if (slot < metaDataSlots_.size()) return metaDataSlots_[slot] != nullptr;
     return metaData_.find(id) != metaData_.end();
 }
 
+bool TensorField3D::hasEigenMetaData() const {
+    for (const auto id : {MajorEigenValues::id(), IntermediateEigenValues::id(),
+                          MinorEigenValues::id(), MajorEigenVectors::id(),
+                          IntermediateEigenVectors::id(), MinorEigenVectors::id()}) {
+        if (!metaDataSlots_[tensorutil::metaDataSlot(id)]) return false;
+    }
+    return true;
+}
+
+void TensorField3D::updateMetaDataSlot(const uint64_t id) const {
+    const auto slot = tensorutil::metaDataSlot(id);
+    if (slot >= metaDataSlots_.size()) return;
+    const auto it = metaData_.find(id);
+    metaDataSlots_[slot] = it != metaData_.end() ? it->second.get() : nullptr;
+}
+
+TensorField3D::EigenView TensorField3D::getEigenView() const {
+    EigenView view;
+    view.values = {getMetaData<MajorEigenValues>().data(),
+                   getMetaData<IntermediateEigenValues>().data(),
+                   getMetaData<MinorEigenValues>().data()};
+    view.vectors = {getMetaData<MajorEigenVectors>().data(),
+                    getMetaData<IntermediateEigenVectors>().data(),
+                    getMetaData<MinorEigenVectors>().data()};
+    return view;
+}
+
 TensorField3D *TensorField3D::clone() const { return new TensorField3D(*this); }
 
-void TensorField3D::computeEigenValuesAndEigenVectors() {
+const std::array<DataMapper, 3> &TensorField3D::dataMapEigenValues() const {
+    ensureEigenDecomposition();
+    return dataMapEigenValues_;
+}
+
+const std::array<DataMapper, 3> &TensorField3D::dataMapEigenVectors() const {
+    ensureEigenDecomposition();
+    return dataMapEigenVectors_;
+}
+
+void TensorField3D::setDataMapEigenValues(const std::array<DataMapper, 3> &dataMaps) {
+    ensureEigenDecomposition();
+    dataMapEigenValues_ = dataMaps;
+}
+
+void TensorField3D::setDataMapEigenVectors(const std::array<DataMapper, 3> &dataMaps) {
+    ensureEigenDecomposition();
+    dataMapEigenVectors_ = dataMaps;
+}
+
+void TensorField3D::setMetaData(
+    std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData) {
+    const auto numEigenEntries = std::count_if(metaData.begin(), metaData.end(),
+                                               [](const auto &item) {
+                                                   return isEigenMetaData(item.first);
+                                               });
+
+    for (auto &item : metaData) {
+        metaData_[item.first] = std::move(item.second);
+        updateMetaDataSlot(item.first);
+    }
+
+    if (numEigenEntries == 6 && eigenDecompositionPending_.load()) {
+        std::lock_guard<std::mutex> lock(eigenDecompositionMutex_);
+        computeDataMaps();
+        eigenDecompositionPending_.store(false, std::memory_order_release);
+    }
+}
+
+void TensorField3D::deferEigenDecomposition() {
+    addMetaData<MajorEigenValues>(std::vector<double>{}, TensorFeature::Sigma1);
+    addMetaData<IntermediateEigenValues>(std::vector<double>{}, TensorFeature::Sigma2);
+    addMetaData<MinorEigenValues>(std::vector<double>{}, TensorFeature::Sigma3);
+
+    addMetaData<MajorEigenVectors>(std::vector<dvec3>{}, TensorFeature::MajorEigenVector);
+    addMetaData<IntermediateEigenVectors>(std::vector<dvec3>{},
+                                          TensorFeature::IntermediateEigenVector);
+    addMetaData<MinorEigenVectors>(std::vector<dvec3>{}, TensorFeature::MinorEigenVector);
+
+    eigenDecompositionPending_ = true;
+}
+
+void TensorField3D::ensureEigenDecomposition() const {
+    if (!eigenDecompositionPending_.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lock(eigenDecompositionMutex_);
+    if (!eigenDecompositionPending_.load(std::memory_order_relaxed)) return;
+
+    computeEigenValuesAndEigenVectors();
+    computeDataMaps();
+
+    eigenDecompositionPending_.store(false, std::memory_order_release);
+}
+
+namespace {
+template <typename T>
+void replaceMetaData(std::unordered_map<uint64_t, std::shared_ptr<const MetaDataBase>> &metaData,
+                     typename T::DataType data) {
+    auto &entry = metaData.at(T::id());
+    entry = std::make_shared<const T>(std::move(data), static_cast<const T *>(entry.get())->type_);
+}
+}  // namespace
+
+void TensorField3D::computeEigenValuesAndEigenVectors() const {
     auto func = [](const dmat3 &tensor) -> std::array<std::pair<double, dvec3>, 3> {
         if (tensor == dmat3(0.0)) {
             return {{std::make_pair(0, dvec3{0}), std::make_pair(0, dvec3{0}),
@@ -705,6 +928,12 @@ void TensorField3D::computeEigenValuesAndEigenVectors() {
                                                            std::pair<double, dvec3>{0, dvec3(0)}};
         }
 
+        // Most stress and diffusion fields are symmetric, use the closed-form solver for those
+        // and keep the general solver as a fallback
+        if (tensorutil::isSymmetric(tensor)) {
+            return tensorutil::calculateSymmetricEigenValuesAndEigenVectors(tensor);
+        }
+
         Eigen::EigenSolver<Eigen::Matrix3d> solver(util::glm2eigen(tensor));
         const auto eigenValues = util::eigen2glm<double, 3, 1>(solver.eigenvalues().real());
         const auto eigenVectors = util::eigen2glm<double, 3, 3>(solver.eigenvectors().real());
@@ -735,32 +964,50 @@ void TensorField3D::computeEigenValuesAndEigenVectors() {
     middleEigenVectors.resize(size_);
     minorEigenVectors.resize(size_);
 
-#pragma omp parallel for
-    for (int i = 0; i < static_cast<int>(tensors_.size()); i++) {
-        auto tensor = tensors_[i];
-        auto eigenValuesAndEigenVectors = func(tensor);
-
-        majorEigenVectors[i] = eigenValuesAndEigenVectors[0].second;
-        middleEigenVectors[i] = eigenValuesAndEigenVectors[1].second;
-        minorEigenVectors[i] = eigenValuesAndEigenVectors[2].second;
-
-        majorEigenValues[i] = eigenValuesAndEigenVectors[0].first;
-        middleEigenValues[i] = eigenValuesAndEigenVectors[1].first;
-        minorEigenValues[i] = eigenValuesAndEigenVectors[2].first;
+    // Undefined voxels of a masked field keep a zero eigen system
+    const bool masked = hasMask();
+    const auto &indices = definedIndices();
+    const auto sparse = sparseTensors();
+    const auto numItems = masked ? indices.size() : size_;
+
+    util::forEachRangeParallel(
+        numItems, util::defaultGrainSize(numItems), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const auto i = masked ? indices[k] : k;
+                const auto eigenValuesAndEigenVectors =
+                    func(sparse ? sparse->values()[k] : tensor(i));
+
+                majorEigenVectors[i] = eigenValuesAndEigenVectors[0].second;
+                middleEigenVectors[i] = eigenValuesAndEigenVectors[1].second;
+                minorEigenVectors[i] = eigenValuesAndEigenVectors[2].second;
+
+                majorEigenValues[i] = eigenValuesAndEigenVectors[0].first;
+                middleEigenValues[i] = eigenValuesAndEigenVectors[1].first;
+                minorEigenValues[i] = eigenValuesAndEigenVectors[2].first;
+            }
+        });
+
+    // The entries were added by deferEigenDecomposition(), only the mapped values are replaced
+    // here so that concurrent lookups of other meta data are not affected. The placeholders may be
+    // shared with copies of this field and are therefore not modified.
+    replaceMetaData<MajorEigenValues>(metaData_, std::move(majorEigenValues));
+    replaceMetaData<IntermediateEigenValues>(metaData_, std::move(middleEigenValues));
+    replaceMetaData<MinorEigenValues>(metaData_, std::move(minorEigenValues));
+
+    replaceMetaData<MajorEigenVectors>(metaData_, std::move(majorEigenVectors));
+    replaceMetaData<IntermediateEigenVectors>(metaData_, std::move(middleEigenVectors));
+    replaceMetaData<MinorEigenVectors>(metaData_, std::move(minorEigenVectors));
+
+    for (const auto id : {MajorEigenValues::id(), IntermediateEigenValues::id(),
+                          MinorEigenValues::id(), MajorEigenVectors::id(),
+                          IntermediateEigenVectors::id(), MinorEigenVectors::id()}) {
+        updateMetaDataSlot(id);
     }
-
-    addMetaData<MajorEigenValues>(majorEigenValues, TensorFeature::Sigma1);
-    addMetaData<IntermediateEigenValues>(middleEigenValues, TensorFeature::Sigma2);
-    addMetaData<MinorEigenValues>(minorEigenValues, TensorFeature::Sigma3);
-
-    addMetaData<MajorEigenVectors>(majorEigenVectors, TensorFeature::MajorEigenVector);
-    addMetaData<IntermediateEigenVectors>(middleEigenVectors,
-                                          TensorFeature::IntermediateEigenVector);
-    addMetaData<MinorEigenVectors>(minorEigenVectors, TensorFeature::MinorEigenVector);
 }
 
 void TensorField3D::computeNormalizedScreenCoordinates(double sliceCoord) {
-    normalizedVolumePositions_.resize(size_);
+    auto &normalizedVolumePositions = normalizedVolumePositions_.modify();
+    normalizedVolumePositions.resize(size_);
 
     auto stepSize = getSpacing();
 
@@ -772,7 +1019,7 @@ void TensorField3D::computeNormalizedScreenCoordinates(double sliceCoord) {
     for (size_t z = 0; z < dimensions_.z; z++) {
         for (size_t y = 0; y < dimensions_.y; y++) {
             for (size_t x = 0; x < dimensions_.x; x++) {
-                normalizedVolumePositions_[indexMapper_(size3_t(x, y, z))] =
+                normalizedVolumePositions[indexMapper_(size3_t(x, y, z))] =
                     dvec3(dimensions_.x < 2 ? sliceCoord : x * stepSize.x,
                           dimensions_.y < 2 ? sliceCoord : y * stepSize.y,
                           dimensions_.z < 2 ? sliceCoord : z * stepSize.z);
@@ -781,10 +1028,26 @@ void TensorField3D::computeNormalizedScreenCoordinates(double sliceCoord) {
     }
 }
 
-void TensorField3D::computeDataMaps() {
-    const auto &majorEigenValues = getMetaData<MajorEigenValues>();
-    const auto &middleEigenValues = getMetaData<IntermediateEigenValues>();
-    const auto &minorEigenValues = getMetaData<MinorEigenValues>();
+void TensorField3D::computeDataMaps() const {
+    // Access the meta data directly, this is called while computing the deferred decomposition
+    auto slot = [this](uint64_t id) {
+        const auto *metaData = metaDataSlots_[tensorutil::metaDataSlot(id)];
+        if (!metaData) {
+            throw std::out_of_range("TensorField3D: eigen meta data " + std::to_string(id) +
+                                    " is missing");
+        }
+        return metaData;
+    };
+    auto data = [&](uint64_t id) -> const auto & {
+        return static_cast<const MetaDataType<double> *>(slot(id))->data_;
+    };
+    auto vectors = [&](uint64_t id) -> const auto & {
+        return static_cast<const MetaDataType<dvec3> *>(slot(id))->data_;
+    };
+
+    const auto &majorEigenValues = data(MajorEigenValues::id());
+    const auto &middleEigenValues = data(IntermediateEigenValues::id());
+    const auto &minorEigenValues = data(MinorEigenValues::id());
 
     dataMapEigenValues_[0].dataRange.x = dataMapEigenValues_[0].valueRange.x =
         *std::min_element(majorEigenValues.begin(), majorEigenValues.end());
@@ -804,7 +1067,7 @@ void TensorField3D::computeDataMaps() {
 
     auto min = std::numeric_limits<double>::max();
     auto max = std::numeric_limits<double>::lowest();
-    for (const auto &v : getMetaData<MajorEigenVectors>()) {
+    for (const auto &v : vectors(MajorEigenVectors::id())) {
         min = std::min(min_f(v), min);
         max = std::max(max_f(v), max);
     }
@@ -813,7 +1076,7 @@ void TensorField3D::computeDataMaps() {
 
     min = std::numeric_limits<double>::max();
     max = std::numeric_limits<double>::lowest();
-    for (const auto &v : getMetaData<IntermediateEigenVectors>()) {
+    for (const auto &v : vectors(IntermediateEigenVectors::id())) {
         min = std::min(min_f(v), min);
         max = std::max(max_f(v), max);
     }
@@ -822,7 +1085,7 @@ void TensorField3D::computeDataMaps() {
 
     min = std::numeric_limits<double>::max();
     max = std::numeric_limits<double>::lowest();
-    for (const auto &v : getMetaData<MinorEigenVectors>()) {
+    for (const auto &v : vectors(MinorEigenVectors::id())) {
         min = std::min(min_f(v), min);
         max = std::max(max_f(v), max);
     }
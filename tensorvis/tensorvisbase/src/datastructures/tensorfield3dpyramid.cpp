@@ -0,0 +1,160 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/tensorfield3dpyramid.h>
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreach.h>
+
+namespace inviwo {
+
+TensorField3DPyramid::TensorField3DPyramid(std::shared_ptr<const TensorField3D> tensorField,
+                                           Averaging averaging, size_t brickSize)
+    : tensorField_{std::move(tensorField)}, brickSize_{std::max<size_t>(brickSize, 1)} {
+    if (!tensorField_) {
+        throw Exception("No tensor field given for the pyramid", IVW_CONTEXT);
+    }
+
+    while (getDimensions(getNumberOfLevels() - 1) != size3_t(1)) {
+        levels_.push_back(downsample(getNumberOfLevels() - 1, averaging));
+    }
+}
+
+size_t TensorField3DPyramid::getNumberOfLevels() const { return levels_.size() + 1; }
+
+size3_t TensorField3DPyramid::getDimensions(size_t level) const {
+    if (level >= getNumberOfLevels()) {
+        throw RangeException("Level " + std::to_string(level) + " out of range", IVW_CONTEXT);
+    }
+    return level == 0 ? tensorField_->getDimensions() : levels_[level - 1].dimensions;
+}
+
+dvec3 TensorField3DPyramid::getSpacing(size_t level) const {
+    const auto bounds = glm::max(getDimensions(level) - size3_t(1), size3_t(1));
+    return tensorField_->getExtents() / dvec3(bounds);
+}
+
+dmat3 TensorField3DPyramid::tensor(size_t level, const size3_t& position) const {
+    if (level == 0) return tensorField_->tensor(position);
+
+    const auto& l = levels_.at(level - 1);
+    return l.tensors[brickIndex(l, position)];
+}
+
+size_t TensorField3DPyramid::coarsestLevel(double pixelsPerUnit, double maxPixelError) const {
+    for (size_t level = getNumberOfLevels() - 1; level > 0; --level) {
+        if (glm::compMax(getSpacing(level)) * pixelsPerUnit <= maxPixelError) return level;
+    }
+    return 0;
+}
+
+std::shared_ptr<const TensorField3D> TensorField3DPyramid::getLevel(size_t level) const {
+    if (level == 0) return tensorField_;
+
+    std::scoped_lock lock{mutex_};
+    const auto& l = levels_.at(level - 1);
+    if (!l.field) {
+        std::vector<dmat3> tensors(glm::compMul(l.dimensions));
+        size_t i = 0;
+        for (size_t z = 0; z < l.dimensions.z; ++z) {
+            for (size_t y = 0; y < l.dimensions.y; ++y) {
+                for (size_t x = 0; x < l.dimensions.x; ++x) {
+                    tensors[i++] = l.tensors[brickIndex(l, size3_t(x, y, z))];
+                }
+            }
+        }
+
+        auto field = std::make_shared<TensorField3D>(l.dimensions, std::move(tensors),
+                                                     vec3(tensorField_->getExtents()));
+        field->setBasis(tensorField_->getBasis());
+        field->setOffset(tensorField_->getOffset());
+        l.field = field;
+    }
+    return l.field;
+}
+
+size_t TensorField3DPyramid::brickIndex(const Level& level, const size3_t& position) const {
+    const auto brick = position / brickSize_;
+    const auto local = position % brickSize_;
+    const auto brickIndex = brick.x + level.numBricks.x * (brick.y + level.numBricks.y * brick.z);
+    return brickIndex * brickSize_ * brickSize_ * brickSize_ + local.x +
+           brickSize_ * (local.y + brickSize_ * local.z);
+}
+
+auto TensorField3DPyramid::downsample(size_t fineLevel, Averaging averaging) const -> Level {
+    const auto fineDimensions = getDimensions(fineLevel);
+
+    Level level;
+    level.dimensions = glm::max((fineDimensions + size3_t(1)) / size3_t(2), size3_t(1));
+    level.numBricks = (level.dimensions + size3_t(brickSize_ - 1)) / brickSize_;
+    level.tensors.resize(glm::compMul(level.numBricks) * brickSize_ * brickSize_ * brickSize_,
+                         dmat3(0.0));
+
+    std::vector<size_t> slices(level.dimensions.z);
+    util::forEachParallel(slices, [&](size_t, size_t z) {
+        size3_t pos{0, 0, z};
+        for (pos.y = 0; pos.y < level.dimensions.y; ++pos.y) {
+            for (pos.x = 0; pos.x < level.dimensions.x; ++pos.x) {
+                const auto first = pos * size3_t(2);
+                const auto last = glm::min(first + size3_t(1), fineDimensions - size3_t(1));
+
+                dmat3 sum(0.0);
+                dmat3 logSum(0.0);
+                auto logEuclidean = averaging == Averaging::LogEuclidean;
+                size_t count = 0;
+
+                size3_t p;
+                for (p.z = first.z; p.z <= last.z; ++p.z) {
+                    for (p.y = first.y; p.y <= last.y; ++p.y) {
+                        for (p.x = first.x; p.x <= last.x; ++p.x) {
+                            const auto t = tensor(fineLevel, p);
+                            sum += t;
+                            if (logEuclidean) {
+                                if (const auto logT = tensorutil::logTensor(t)) {
+                                    logSum += *logT;
+                                } else {
+                                    logEuclidean = false;
+                                }
+                            }
+                            ++count;
+                        }
+                    }
+                }
+
+                const auto n = static_cast<double>(count);
+                level.tensors[brickIndex(level, pos)] =
+                    logEuclidean ? tensorutil::expTensor(logSum / n) : sum / n;
+            }
+        }
+    });
+
+    return level;
+}
+
+}  // namespace inviwo
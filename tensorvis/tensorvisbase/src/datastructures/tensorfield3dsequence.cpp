@@ -0,0 +1,285 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/datastructures/tensorfield3dsequence.h>
+#include <inviwo/tensorvisbase/util/misc.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace inviwo {
+
+TensorField3DSequence::TensorField3DSequence(size_t numSteps, Loader loader, size_t prefetch,
+                                             size_t memoryBudget)
+    : state_{std::make_shared<State>()} {
+    state_->loader = std::move(loader);
+    state_->numSteps = numSteps;
+    state_->prefetch = prefetch;
+    state_->memoryBudget = memoryBudget;
+    state_->registration = MemoryBudget::global().add(
+        "Tensor field sequence", MemoryBudget::Priority::Normal,
+        [weak = std::weak_ptr<State>{state_}](size_t bytes) {
+            auto self = weak.lock();
+            if (!self) return;
+            std::unique_lock lock{self->mutex, std::try_to_lock};
+            if (!lock) return;
+            self->evictTo(self->memoryUsage > bytes ? self->memoryUsage - bytes : 0);
+        });
+}
+
+size_t TensorField3DSequence::size() const { return state_->numSteps; }
+
+std::shared_ptr<const TensorField3D> TensorField3DSequence::get(size_t step) const {
+    const auto requested = use(step);
+    // The loader job might be queued behind the caller on the pool, take it over
+    if (!requested.started->exchange(true)) state_->load(step, *requested.promise);
+    return requested.field.get();
+}
+
+std::shared_ptr<const TensorField3D> TensorField3DSequence::tryGet(size_t step) const {
+    const auto field = use(step).field;
+    if (field.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return nullptr;
+    return field.get();
+}
+
+void TensorField3DSequence::prefetch(size_t step) const { use(step); }
+
+bool TensorField3DSequence::isLoaded(size_t step) const {
+    std::scoped_lock lock{state_->mutex};
+    const auto it = state_->steps.find(step);
+    return it != state_->steps.end() && it->second.loaded;
+}
+
+void TensorField3DSequence::setPrefetch(size_t prefetch) {
+    std::scoped_lock lock{state_->mutex};
+    state_->prefetch = prefetch;
+    state_->evict();
+}
+
+size_t TensorField3DSequence::getPrefetch() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->prefetch;
+}
+
+void TensorField3DSequence::setMemoryBudget(size_t bytes) {
+    std::scoped_lock lock{state_->mutex};
+    state_->memoryBudget = bytes;
+    state_->evict();
+}
+
+size_t TensorField3DSequence::getMemoryBudget() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->memoryBudget;
+}
+
+size_t TensorField3DSequence::getMemoryUsage() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->memoryUsage;
+}
+
+auto TensorField3DSequence::onLoaded(Callback callback) const -> std::shared_ptr<Callback> {
+    std::scoped_lock lock{state_->callbackMutex};
+    return state_->loaded.add(std::move(callback));
+}
+
+std::string TensorField3DSequence::getDataInfo() const {
+    size_t numLoaded = 0;
+    size_t memoryUsage = 0;
+    size_t memoryBudget = 0;
+    {
+        std::scoped_lock lock{state_->mutex};
+        for (const auto& item : state_->steps) numLoaded += item.second.loaded ? 1 : 0;
+        memoryUsage = state_->memoryUsage;
+        memoryBudget = state_->memoryBudget;
+    }
+
+    std::stringstream ss;
+    ss << "<table border='0' cellspacing='0' cellpadding='0' "
+          "style='border-color:white;white-space:pre;'>\n"
+       << tensorutil::getHTMLTableRowString("Type", "3D tensor field sequence")
+       << tensorutil::getHTMLTableRowString("Time steps", state_->numSteps)
+       << tensorutil::getHTMLTableRowString("Loaded time steps", numLoaded)
+       << tensorutil::getHTMLTableRowString("Memory usage (MB)", memoryUsage >> 20)
+       << tensorutil::getHTMLTableRowString("Memory budget (MB)", memoryBudget >> 20)
+       << "</table>";
+    return ss.str();
+}
+
+size_t TensorField3DSequence::memoryUsage(const TensorField3D& tensorField) {
+    const auto size = tensorField.getSize();
+
+    size_t bytes = 0;
+    switch (tensorField.getTensorStorage()) {
+        case TensorStorage::Full:
+            bytes += size * sizeof(dmat3);
+            break;
+        case TensorStorage::Symmetric:
+            bytes += size * SymmetricTensorStorage3D<double>::numComponents * sizeof(double);
+            break;
+        case TensorStorage::SymmetricFloat:
+            bytes += size * SymmetricTensorStorage3D<float>::numComponents * sizeof(float);
+            break;
+        case TensorStorage::Sparse:
+            bytes += tensorField.sparseTensors()->sizeInBytes();
+            break;
+        case TensorStorage::FullFloat:
+            bytes += tensorField.floatTensors()->sizeInBytes();
+            break;
+    }
+
+    for (const auto& item : tensorField.metaData()) {
+        bytes += size * item.second->getNumberOfComponents() * sizeof(double);
+    }
+    if (tensorField.hasMask()) bytes += tensorField.getMask().sizeInBytes();
+
+    return bytes;
+}
+
+auto TensorField3DSequence::use(size_t step) const -> Step {
+    if (step >= state_->numSteps) {
+        throw RangeException("Time step " + std::to_string(step) + " out of range", IVW_CONTEXT);
+    }
+
+    std::scoped_lock lock{state_->mutex};
+    if (auto it = state_->steps.find(step); it != state_->steps.end() && it->second.loaded) {
+        state_->registration->hit();
+    } else {
+        state_->registration->miss();
+    }
+    state_->current = step;
+    auto requested = state_->request(step, state_);
+    state_->prefetchWindow(step, state_);
+    state_->evict();
+
+    return requested;
+}
+
+auto TensorField3DSequence::State::request(size_t step, const std::shared_ptr<State>& self)
+    -> Step& {
+    auto it = steps.find(step);
+    if (it == steps.end()) {
+        it = steps.emplace(step, Step{}).first;
+
+        auto promise = std::make_shared<Promise>();
+        auto started = std::make_shared<std::atomic<bool>>(false);
+        it->second.field = promise->get_future().share();
+        it->second.promise = promise;
+        it->second.started = started;
+
+        dispatchPool([self, step, promise, started]() {
+            if (!started->exchange(true)) self->load(step, *promise);
+        });
+    }
+
+    it->second.lastUse = ++useCounter;
+    return it->second;
+}
+
+void TensorField3DSequence::State::load(size_t step, Promise& promise) {
+    // The future is only ready after the step is accounted for, the callbacks are called once it
+    // is ready
+    try {
+        std::shared_ptr<const TensorField3D> field = loader(step);
+        if (!field) {
+            throw Exception("No tensor field for time step " + std::to_string(step),
+                            IVW_CONTEXT_CUSTOM("TensorField3DSequence"));
+        }
+        const auto bytes = TensorField3DSequence::memoryUsage(*field);
+        {
+            std::scoped_lock lock{mutex};
+            if (auto entry = steps.find(step); entry != steps.end()) {
+                entry->second.loaded = true;
+                entry->second.bytes = bytes;
+                memoryUsage += bytes;
+                registration->setUsage(memoryUsage);
+                evict();
+            }
+        }
+        promise.set_value(field);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+
+    std::scoped_lock lock{callbackMutex};
+    loaded.invoke(step);
+}
+
+void TensorField3DSequence::State::prefetchWindow(size_t step,
+                                                  const std::shared_ptr<State>& self) {
+    // Steps that are not loaded yet are assumed to be of average size, the window ends where it
+    // would exceed the memory budget
+    size_t numLoaded = 0;
+    for (const auto& item : steps) numLoaded += item.second.loaded ? 1 : 0;
+    const auto average = numLoaded > 0 ? memoryUsage / numLoaded : 0;
+
+    const auto current = steps.find(step);
+    size_t windowBytes = current->second.loaded ? current->second.bytes : average;
+
+    for (size_t i = 1; i <= std::min(prefetch, numSteps - 1); ++i) {
+        const auto next = (step + i) % numSteps;
+        const auto it = steps.find(next);
+        windowBytes += it != steps.end() && it->second.loaded ? it->second.bytes : average;
+        if (windowBytes > budget()) break;
+
+        request(next, self);
+    }
+}
+
+bool TensorField3DSequence::State::inWindow(size_t step) const {
+    return (step + numSteps - current) % numSteps <= prefetch;
+}
+
+size_t TensorField3DSequence::State::budget() const {
+    return std::min(memoryBudget, registration->allowance());
+}
+
+void TensorField3DSequence::State::evict() { evictTo(budget()); }
+
+void TensorField3DSequence::State::evictTo(size_t bytes) {
+    const auto usage = memoryUsage;
+    while (memoryUsage > bytes) {
+        auto victim = steps.end();
+        for (auto it = steps.begin(); it != steps.end(); ++it) {
+            if (it->second.loaded && !inWindow(it->first) &&
+                (victim == steps.end() || it->second.lastUse < victim->second.lastUse)) {
+                victim = it;
+            }
+        }
+        if (victim == steps.end()) break;
+
+        memoryUsage -= victim->second.bytes;
+        steps.erase(victim);
+    }
+    if (memoryUsage != usage) registration->setUsage(memoryUsage);
+}
+
+}  // namespace inviwo
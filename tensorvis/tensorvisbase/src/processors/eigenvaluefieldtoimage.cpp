@@ -29,6 +29,7 @@
 
 #include <inviwo/tensorvisbase/processors/eigenvaluefieldtoimage.h>
 #include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+#include <modules/opengl/texture/textureutils.h>
 
 namespace inviwo {
 
@@ -66,16 +67,9 @@ EigenvalueFieldToImage::EigenvalueFieldToImage()
 
     addProperty(dimensions_);
 
-    tf_.onChange([&]() { invalidate(InvalidationLevel::InvalidResources); });
-    majorMinor_.onChange([&]() { invalidate(InvalidationLevel::InvalidResources); });
+    majorMinor_.onChange([&]() { rangesDirty_ = true; });
     shader_.onReload([&]() { invalidate(InvalidationLevel::InvalidOutput); });
-    inport_.onChange([&]() { invalidate(InvalidationLevel::InvalidResources); });
-}
-
-void EigenvalueFieldToImage::initializeResources() {
-    tf_texture_ = Image(std::shared_ptr<Layer>(tf_.get().getData()->clone()));
-
-    if (!inport_.hasData() || !inport_.getData().get()) return;
+    inport_.onChange([&]() { rangesDirty_ = true; });
 }
 
 void EigenvalueFieldToImage::process() {
@@ -87,20 +81,15 @@ void EigenvalueFieldToImage::process() {
 
     TextureUnitContainer units;
 
-    std::shared_ptr<Image> tensorFieldTexture;
+    std::shared_ptr<const Image> tensorFieldTexture;
 
     // add tensorfield to texture unit container
     tensorutil::bindTensorFieldAsColorTexture(tensorFieldTexture, inport_, shader_, units);
 
-    TextureUnit tf;
+    if (rangesDirty_) updateRanges();
 
-    // Create a subsampled tensorfield to find possible deviations from the initial min/max values
-    // for eigenvalues
-    updateEigenValues();
-    updateAnisotropy();
-
-    shader_.setUniform("tf", tf.getUnitNumber());
-    utilgl::bindColorTexture(tf_texture_, tf);
+    // The transfer function is bound from its layer, which stays resident on the GPU
+    utilgl::bindAndSetUniforms(shader_, units, tf_);
 
     utilgl::setUniforms(shader_, outport_, majorMinor_);
 
@@ -120,67 +109,46 @@ void EigenvalueFieldToImage::process() {
     utilgl::deactivateCurrentTarget();
 }
 
-void EigenvalueFieldToImage::updateEigenValues() {
-    auto subsampled = tensorutil::subsample2D(inport_.getData(),
-                                              inport_.getData()->getDimensions() * size2_t(2, 2));
-
-    std::vector<double> eigenValues;
-    if (majorMinor_.get()) {
-        eigenValues = std::vector<double>(subsampled->minorEigenValues());
-    } else {
-        eigenValues = std::vector<double>(subsampled->majorEigenValues());
-    }
-
-    minVal_ = static_cast<float>(*std::min_element(eigenValues.begin(), eigenValues.end()));
-    maxVal_ = static_cast<float>(*std::max_element(eigenValues.begin(), eigenValues.end()));
-
-    if (minVal_ == 0.0) {
-        // Delete zero entries to find actual minimum
-        eigenValues.erase(
-            std::remove_if(eigenValues.begin(), eigenValues.end(),
-                           [](double x) { return x < std::numeric_limits<double>::epsilon(); }),
-            eigenValues.end());
-
-        minVal_ = static_cast<float>(*std::min_element(eigenValues.begin(), eigenValues.end()));
-        maxVal_ = static_cast<float>(*std::max_element(eigenValues.begin(), eigenValues.end()));
-    }
-
+void EigenvalueFieldToImage::updateRanges() {
+    rangesDirty_ = false;
+
+    // Interpolated tensors can have eigenvalues outside the range of the input, a subsampled
+    // field is used to find these deviations. Both ranges are taken from the same field.
+    const auto subsampled = tensorutil::subsample2D(
+        inport_.getData(), inport_.getData()->getDimensions() * size2_t(2, 2));
+
+    const auto& majorEigenValues = subsampled->majorEigenValues();
+    const auto& minorEigenValues = subsampled->minorEigenValues();
+
+    // Min and max of the values, and of the values that are not zero
+    const auto range = [](size_t size, auto value) {
+        auto minMax = std::make_pair(std::numeric_limits<double>::max(),
+                                     std::numeric_limits<double>::lowest());
+        auto nonZero = minMax;
+        for (size_t i = 0; i < size; ++i) {
+            const auto v = value(i);
+            minMax = {std::min(minMax.first, v), std::max(minMax.second, v)};
+            if (v >= std::numeric_limits<double>::epsilon()) {
+                nonZero = {std::min(nonZero.first, v), std::max(nonZero.second, v)};
+            }
+        }
+        // Ignore zero entries to find the actual minimum
+        if (minMax.first == 0.0 && nonZero.first <= nonZero.second) return nonZero;
+        return minMax;
+    };
+
+    const auto& eigenValues = majorMinor_.get() ? minorEigenValues : majorEigenValues;
+    const auto eigenValueRange =
+        range(eigenValues.size(), [&](size_t i) { return eigenValues[i]; });
+    minVal_ = static_cast<float>(eigenValueRange.first);
+    maxVal_ = static_cast<float>(eigenValueRange.second);
     eigenValueRange_ = glm::abs(minVal_ - maxVal_);
-}
-
-void EigenvalueFieldToImage::updateAnisotropy() {
-    auto subsampled = tensorutil::subsample2D(inport_.getData(),
-                                              inport_.getData()->getDimensions() * size2_t(2, 2));
-
-    std::vector<double> minorEigenValues;
-    std::vector<double> majorEigenValues;
-    std::vector<double> anisotropyValues;
-    minorEigenValues = std::vector<double>(subsampled->minorEigenValues());
-    majorEigenValues = std::vector<double>(subsampled->majorEigenValues());
-    anisotropyValues.resize(minorEigenValues.size());
-
-    for (size_t i = 0; i < minorEigenValues.size(); ++i) {
-        anisotropyValues[i] = glm::abs(majorEigenValues[i] - minorEigenValues[i]);
-    }
-
-    anisotropyMinVal_ =
-        static_cast<float>(*std::min_element(anisotropyValues.begin(), anisotropyValues.end()));
-    anisotropyMaxVal_ =
-        static_cast<float>(*std::max_element(anisotropyValues.begin(), anisotropyValues.end()));
-
-    if (anisotropyMinVal_ == 0.0) {
-        // Delete zero entries to find actual minimum
-        anisotropyValues.erase(
-            std::remove_if(anisotropyValues.begin(), anisotropyValues.end(),
-                           [](double x) { return x < std::numeric_limits<double>::epsilon(); }),
-            anisotropyValues.end());
-
-        anisotropyMinVal_ =
-            static_cast<float>(*std::min_element(anisotropyValues.begin(), anisotropyValues.end()));
-        anisotropyMaxVal_ =
-            static_cast<float>(*std::max_element(anisotropyValues.begin(), anisotropyValues.end()));
-    }
 
+    const auto anisotropyRange = range(minorEigenValues.size(), [&](size_t i) {
+        return glm::abs(majorEigenValues[i] - minorEigenValues[i]);
+    });
+    anisotropyMinVal_ = static_cast<float>(anisotropyRange.first);
+    anisotropyMaxVal_ = static_cast<float>(anisotropyRange.second);
     anisotropyValueRange_ = glm::abs(anisotropyMinVal_ - anisotropyMaxVal_);
 }
 
@@ -1,4 +1,7 @@
 #include <inviwo/tensorvisbase/processors/hyperstreamlines.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
 
 namespace inviwo {
 
@@ -13,15 +16,38 @@ const ProcessorInfo HyperStreamlines::processorInfo_{
 const ProcessorInfo HyperStreamlines::getProcessorInfo() const { return processorInfo_; }
 
 HyperStreamlines::HyperStreamlines()
-    : sampler_("sampler")
+    : PoolProcessor()
+    , sampler_("sampler")
     , seeds_("seeds")
     , lines_("lines")
-    , properties_("properties", "Properties") {
+    , mesh_("mesh")
+    , properties_("properties", "Properties")
+    , batchSize_("batchSize", "Seeds per batch", 65536, 1, 1048576)
+    , adaptive_("adaptive", "Adaptive step size", false)
+    , tolerance_("tolerance", "Tolerance", 1e-4, 1e-10, 1e-1, 1e-6)
+    , minStepSize_("minStepSize", "Min step size", 1e-5, 1e-8, 1.0, 1e-6)
+    , maxStepSize_("maxStepSize", "Max step size", 0.1, 1e-6, 10.0, 1e-3)
+    , maxArcLength_("maxArcLength", "Max arc length", 10.0, 0.0, 1000.0, 0.1)
+    , evenlySpaced_("evenlySpaced", "Evenly spaced", false)
+    , separation_("separation", "Separation", 0.05, 0.02, 0.5, 0.005)
+    , terminationRatio_("terminationRatio", "Termination ratio", 0.5, 0.1, 1.0, 0.05) {
     addPort(sampler_);
     addPort(seeds_);
     addPort(lines_);
+    addPort(mesh_);
 
     addProperty(properties_);
+    addProperty(batchSize_);
+
+    adaptive_.addProperty(tolerance_);
+    adaptive_.addProperty(minStepSize_);
+    adaptive_.addProperty(maxStepSize_);
+    adaptive_.addProperty(maxArcLength_);
+    addProperty(adaptive_);
+
+    evenlySpaced_.addProperty(separation_);
+    evenlySpaced_.addProperty(terminationRatio_);
+    addProperty(evenlySpaced_);
 
     properties_.normalizeSamples_.set(true);
     properties_.normalizeSamples_.setCurrentStateAsDefault();
@@ -31,25 +57,69 @@ HyperStreamlines::~HyperStreamlines() {}
 
 void HyperStreamlines::process() {
     auto sampler = sampler_.getData();
-    auto lines =
-        std::make_shared<IntegralLineSet>(sampler->getModelMatrix(), sampler->getWorldMatrix());
 
+    // The tracer copies its settings, the job does not touch any properties
     HyperStreamLineTracer tracer(sampler, properties_);
+    tracer.setAdaptiveStepping({adaptive_.isChecked(), tolerance_.get(), minStepSize_.get(),
+                                std::max(minStepSize_.get(), maxStepSize_.get()),
+                                maxArcLength_.get()});
+    if (evenlySpaced_.isChecked()) {
+        // Data space spans [0, 1] in every direction, the separation is relative to the domain
+        tracer.setOccupancy(
+            std::make_shared<LineOccupancyGrid>(dvec3{0.0}, dvec3{1.0}, separation_.get()),
+            terminationRatio_.get());
+    }
+
+    using Result = std::pair<std::shared_ptr<IntegralLineSet>, std::shared_ptr<Mesh>>;
+    auto compute = [sampler, tracer, seedSets = seeds_.getVectorData(),
+                    batchSize = batchSize_.get(), needLines = lines_.isConnected(),
+                    needMesh = mesh_.isConnected()](pool::Stop stop,
+                                                    pool::Progress progress) mutable -> Result {
+        PackedLineSet lines(sampler->getModelMatrix(), sampler->getWorldMatrix());
+
+        size_t numSeeds = 0;
+        for (const auto &seeds : seedSets) numSeeds += seeds->size();
+
+        // Seeds per chunk, each chunk is one packed line set filled by a single thread
+        constexpr size_t chunkSize = 1024;
+        std::vector<PackedLineSet> chunks;
+        const auto stopped = [&stop]() { return stop(); };
 
-    std::mutex mutex;
-    size_t startID = 0;
-    for (const auto &seeds : seeds_) {
-        util::forEachParallel(*seeds, [&](const auto &p, size_t i) {
-            IntegralLine line = tracer.traceFrom(p);
-            auto size = line.getPositions().size();
-            if (size > 1) {
-                std::lock_guard<std::mutex> lock(mutex);
-                lines->push_back(std::move(line), startID + i);
+        size_t startID = 0;
+        for (const auto &seeds : seedSets) {
+            for (size_t first = 0; first < seeds->size(); first += batchSize) {
+                if (stop()) return {};
+
+                const auto count = std::min(batchSize, seeds->size() - first);
+
+                chunks.clear();
+                chunks.resize((count + chunkSize - 1) / chunkSize);
+                const auto completed = util::forEachRangeParallel(
+                    count, chunkSize,
+                    [&](size_t begin, size_t end) {
+                        auto &chunk = chunks[begin / chunkSize];
+                        for (size_t i = begin; i < end; ++i) {
+                            tracer.traceInto((*seeds)[first + i], startID + first + i, chunk);
+                        }
+                    },
+                    stopped);
+                if (!completed) return {};
+
+                for (auto &chunk : chunks) lines.append(std::move(chunk));
+
+                progress(startID + first + count, numSeeds);
             }
-        });
-        startID += seeds->size();
-    }
+            startID += seeds->size();
+        }
+
+        return {needLines ? lines.toIntegralLineSet() : nullptr,
+                needMesh ? lines.toMesh() : nullptr};
+    };
 
-    lines_.setData(lines);
+    dispatchOne(compute, [this](Result result) {
+        lines_.setData(result.first);
+        mesh_.setData(result.second);
+        newResults();
+    });
 }
-}  // namespace inviwo
\ No newline at end of file
+}  // namespace inviwo
@@ -0,0 +1,214 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/processors/hyperstreamlinesgl.h>
+#include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/texture/textureunit.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+constexpr size_t workGroupSize = 64;
+}  // namespace
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo HyperStreamlinesGL::processorInfo_{
+    "org.inviwo.HyperStreamlinesGL",  // Class identifier
+    "Hyper Streamlines GL",           // Display name
+    "Tensor Visualization",           // Category
+    CodeState::Experimental,          // Code state
+    Tags::GL,                         // Tags
+};
+const ProcessorInfo HyperStreamlinesGL::getProcessorInfo() const { return processorInfo_; }
+
+HyperStreamlinesGL::HyperStreamlinesGL()
+    : Processor()
+    , tensorField_("tensorField")
+    , seeds_("seeds")
+    , mesh_("mesh")
+    , lines_("lines")
+    , eigenvector_("eigenvector", "Eigenvector",
+                   {{"major", "Major", Eigenvector::Major},
+                    {"intermediate", "Intermediate", Eigenvector::Intermediate},
+                    {"minor", "Minor", Eigenvector::Minor}},
+                   0)
+    , direction_("direction", "Direction",
+                 {{"forward", "Forward", Direction::Forward},
+                  {"backward", "Backward", Direction::Backward},
+                  {"both", "Both", Direction::Both}},
+                 2)
+    , steps_("steps", "Steps", 100, 1, 10000)
+    , stepSize_("stepSize", "Step size", 0.01f, 0.0001f, 1.0f, 0.0001f)
+    , shader_({{ShaderType::Compute, "hyperstreamlines.comp"}}, Shader::Build::No) {
+    addPort(tensorField_);
+    addPort(seeds_);
+    addPort(mesh_);
+    addPort(lines_);
+
+    addProperties(eigenvector_, direction_, steps_, stepSize_);
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+}
+
+void HyperStreamlinesGL::initializeResources() { shader_.build(); }
+
+void HyperStreamlinesGL::process() {
+    const auto tensorField = tensorField_.getData();
+
+    std::vector<vec4> seeds;
+    for (const auto& points : seeds_) {
+        for (const auto& p : *points) seeds.emplace_back(p, 1.0f);
+    }
+    const auto numSeeds = seeds.size();
+
+    const auto direction = direction_.get();
+    const size_t steps = steps_.get();
+    const size_t stepsBackward = direction == Direction::Both       ? steps / 2
+                                 : direction == Direction::Backward ? steps
+                                                                    : 0;
+    const size_t stepsForward = direction == Direction::Backward ? 0 : steps - stepsBackward;
+    const size_t verticesPerLine = stepsBackward + 1 + stepsForward;
+
+    auto seedBuffer = std::make_shared<Buffer<vec4>>(
+        std::make_shared<BufferRAMPrecision<vec4>>(std::move(seeds)));
+    auto positions = std::make_shared<Buffer<vec4>>(numSeeds * verticesPerLine,
+                                                    BufferUsage::Dynamic);
+    auto colors = std::make_shared<Buffer<vec4>>(numSeeds * verticesPerLine, BufferUsage::Dynamic);
+
+    if (numSeeds > 0) {
+        shader_.activate();
+
+        TextureUnitContainer units;
+        tensorutil::bindTensorFieldAsColorTextures(tensorFieldVolumes_, tensorField, shader_,
+                                                   units);
+
+        shader_.setUniform("numSeeds", static_cast<int>(numSeeds));
+        shader_.setUniform("stepsForward", static_cast<int>(stepsForward));
+        shader_.setUniform("stepsBackward", static_cast<int>(stepsBackward));
+        shader_.setUniform("stepSize", stepSize_.get());
+        shader_.setUniform("eigenvector", static_cast<int>(eigenvector_.get()));
+        shader_.setUniform("invBasis", glm::inverse(mat3(tensorField->getBasis())));
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                         seedBuffer->getRepresentation<BufferGL>()->getId());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                         positions->getEditableRepresentation<BufferGL>()->getId());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                         colors->getEditableRepresentation<BufferGL>()->getId());
+
+        const auto numWorkGroups = (numSeeds + workGroupSize - 1) / workGroupSize;
+        utilgl::dispatchChunked(shader_, numWorkGroups, "offset", workGroupSize);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                        GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        shader_.deactivate();
+    }
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->setModelMatrix(tensorField->getModelMatrix());
+    mesh->setWorldMatrix(tensorField->getWorldMatrix());
+    mesh->addBuffer(BufferType::PositionAttrib, positions);
+    mesh->addBuffer(BufferType::ColorAttrib, colors);
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                     segmentIndices(numSeeds, verticesPerLine));
+    mesh_.setData(mesh);
+
+    if (lines_.isConnected()) {
+        auto lines = readBack(*positions, numSeeds, verticesPerLine, stepsBackward);
+        lines_.setData(lines);
+    }
+}
+
+std::shared_ptr<IndexBuffer> HyperStreamlinesGL::segmentIndices(size_t numLines,
+                                                                size_t verticesPerLine) {
+    const size2_t shape{numLines, verticesPerLine};
+    if (indices_ && indicesShape_ == shape) return indices_;
+
+    const auto numIndices = 2 * numLines * (verticesPerLine - 1);
+
+    std::vector<uint32_t> indices;
+    indices.reserve(numIndices);
+    for (size_t line = 0; line < numLines; ++line) {
+        const auto first = static_cast<uint32_t>(line * verticesPerLine);
+        for (uint32_t i = 0; i + 1 < verticesPerLine; ++i) {
+            indices.push_back(first + i);
+            indices.push_back(first + i + 1);
+        }
+    }
+
+    indices_ = std::make_shared<IndexBuffer>(
+        std::make_shared<IndexBufferRAM>(std::move(indices)));
+    indicesShape_ = shape;
+    return indices_;
+}
+
+std::shared_ptr<IntegralLineSet> HyperStreamlinesGL::readBack(const Buffer<vec4>& positions,
+                                                              size_t numLines,
+                                                              size_t verticesPerLine,
+                                                              size_t seedVertex) const {
+    const auto tensorField = tensorField_.getData();
+    auto lines = std::make_shared<IntegralLineSet>(tensorField->getModelMatrix(),
+                                                   tensorField->getWorldMatrix());
+
+    const auto& data = positions.getRAMRepresentation()->getDataContainer();
+    for (size_t line = 0; line < numLines; ++line) {
+        const auto begin = data.begin() + line * verticesPerLine;
+        const auto end = begin + verticesPerLine;
+
+        // Strip the repeated vertices on both ends of the line
+        auto first = begin + seedVertex;
+        while (first != begin && *(first - 1) != *first) --first;
+        auto last = begin + seedVertex + 1;
+        while (last != end && *last != *(last - 1)) ++last;
+        if (std::distance(first, last) < 2) continue;
+
+        IntegralLine integralLine;
+        auto& linePositions = integralLine.getPositions();
+        auto& velocities = integralLine.getMetaData<dvec3>("velocity", true);
+        for (auto it = first; it != last; ++it) {
+            linePositions.emplace_back(dvec3(*it));
+            const auto next = (it + 1 != last) ? it + 1 : it;
+            const auto prev = (it + 1 != last) ? it : it - 1;
+            velocities.emplace_back(dvec3(*next) - dvec3(*prev));
+        }
+        lines->push_back(std::move(integralLine), line);
+    }
+
+    return lines;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/processors/invariantspacebrush.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo InvariantSpaceBrush::processorInfo_{
+    "org.inviwo.InvariantSpaceBrush",  // Class identifier
+    "Invariant Space Brush",           // Display name
+    "Tensor",                          // Category
+    CodeState::Experimental,           // Code state
+    Tags::CPU,                         // Tags
+};
+const ProcessorInfo InvariantSpaceBrush::getProcessorInfo() const { return processorInfo_; }
+
+InvariantSpaceBrush::InvariantSpaceBrush()
+    : Processor(), inport_("inport"), outport_("outport"), ranges_("ranges", "Ranges") {
+    addPort(inport_);
+    addPort(outport_);
+    addProperty(ranges_);
+
+    inport_.onChange([this]() { updateRanges(); });
+}
+
+void InvariantSpaceBrush::updateRanges() {
+    index_.reset();
+    selection_.clear();
+    previousRanges_.clear();
+
+    if (!inport_.hasData()) return;
+    const auto& invariantSpace = *inport_.getData();
+    const size_t numDims = invariantSpace.getNumberOfDimensions();
+
+    while (ranges_.size() > numDims) {
+        ranges_.removeProperty(ranges_.size() - 1);
+    }
+    for (size_t i = 0; i < numDims; ++i) {
+        const auto minmax = invariantSpace.getMinMax(i);
+        const dvec2 range{minmax[0], std::max(minmax[0], minmax[1])};
+        if (i < ranges_.size()) {
+            auto property = static_cast<DoubleMinMaxProperty*>(ranges_[i]);
+            property->setDisplayName(invariantSpace.getIdentifier(i));
+            // Keep the brush of a matching axis, clamped to the new range
+            const auto value = glm::clamp(property->get(), range.x, range.y);
+            property->setRange(range);
+            property->set(value);
+        } else {
+            ranges_.addProperty(new DoubleMinMaxProperty("axis" + std::to_string(i),
+                                                         invariantSpace.getIdentifier(i), range.x,
+                                                         range.y, range.x, range.y,
+                                                         (range.y - range.x) / 1000.0),
+                                true);
+        }
+    }
+}
+
+void InvariantSpaceBrush::process() {
+    auto invariantSpace = inport_.getData();
+
+    if (!index_) {
+        index_ = std::make_unique<InvariantSpaceIndex>(*invariantSpace);
+    }
+
+    std::vector<dvec2> ranges;
+    for (auto property : ranges_.getProperties()) {
+        ranges.push_back(static_cast<DoubleMinMaxProperty*>(property)->get());
+    }
+    if (ranges.size() != index_->getNumberOfDimensions()) return;
+
+    index_->update(selection_, previousRanges_, ranges);
+    previousRanges_ = ranges;
+
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < selection_.size(); ++i) {
+        if (selection_[i]) indices.push_back(i);
+    }
+
+    outport_.setData(invariantSpace->select(indices));
+}
+
+}  // namespace inviwo
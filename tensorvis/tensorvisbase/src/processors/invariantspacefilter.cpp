@@ -57,12 +57,6 @@ void InvariantSpaceFilter::process() {
     auto tensorField = tensorField3DInport_.getData();
     auto invariantSpace = invariantSpaceInport_.getData();
 
-    const auto& tensors = tensorField->tensors();
-    auto filteredInvariantSpace = std::make_shared<InvariantSpace>(
-        invariantSpace->getNumberOfDimensions(), invariantSpace->getIdentifiers(),
-        invariantSpace->getMetaDataTypes());
-
-    size_t numberOfFilteredTensors{0};
     const auto numberOfElements = invariantSpace->getNumElements();
     const auto epsilon{std::numeric_limits<double>::epsilon()};
 
@@ -78,13 +72,17 @@ void InvariantSpaceFilter::process() {
         return false;
     };
 
+    // Collect the rows to keep first and gather them column by column afterwards
+    std::vector<size_t> indices;
     for (size_t i = 0; i < numberOfElements; i++) {
-        if (!lessThanEpsilon(glm::value_ptr(tensors[i]))) {
-            //        if (glm::all(glm::lessThan(glm::abs(tensors[i]), epsilon))){
-            filteredInvariantSpace->addPoint(invariantSpace->getPoint(i));
-            numberOfFilteredTensors++;
+        const auto tensor = tensorField->tensor(i);
+        if (!lessThanEpsilon(glm::value_ptr(tensor))) {
+            indices.push_back(i);
         }
     }
+    const auto numberOfFilteredTensors = indices.size();
+
+    auto filteredInvariantSpace = invariantSpace->select(indices);
 
     LogProcessorInfo(
         std::to_string((float(numberOfFilteredTensors) / float(numberOfElements)) * 100.f)
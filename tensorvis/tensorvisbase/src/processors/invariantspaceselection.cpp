@@ -143,7 +143,8 @@ void InvariantSpaceSelection::process() {
 
     if (sigma1_.get()) {
         if (tensorField->hasMetaData<MajorEigenValues>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<MajorEigenValues>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<MajorEigenValues>());
         else
             LogWarn(
                 "Requested meta data MajorEigenValues not available. Consider adding a meta data "
@@ -151,7 +152,8 @@ void InvariantSpaceSelection::process() {
     }
     if (sigma2_.get()) {
         if (tensorField->hasMetaData<IntermediateEigenValues>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<IntermediateEigenValues>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<IntermediateEigenValues>());
         else
             LogWarn(
                 "Requested meta data IntermediateEigenValues not available. Consider adding a meta "
@@ -159,7 +161,8 @@ void InvariantSpaceSelection::process() {
     }
     if (sigma3_.get()) {
         if (tensorField->hasMetaData<MinorEigenValues>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<MinorEigenValues>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<MinorEigenValues>());
         else
             LogWarn(
                 "Requested meta data MinorEigenValues not available. Consider adding a meta data "
@@ -167,43 +170,43 @@ void InvariantSpaceSelection::process() {
     }
     if (i1_.get()) {
         if (tensorField->hasMetaData<I1>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<I1>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<I1>());
         else
             LogWarn("Requested meta data I1 not available. Consider adding a meta data processor.")
     }
     if (i2_.get()) {
         if (tensorField->hasMetaData<I2>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<I2>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<I2>());
         else
             LogWarn("Requested meta data I2 not available. Consider adding a meta data processor.")
     }
     if (i3_.get()) {
         if (tensorField->hasMetaData<I3>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<I3>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<I3>());
         else
             LogWarn("Requested meta data I3 not available. Consider adding a meta data processor.")
     }
     if (j1_.get()) {
         if (tensorField->hasMetaData<J1>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<J1>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<J1>());
         else
             LogWarn("Requested meta data J1 not available. Consider adding a meta data processor.")
     }
     if (j2_.get()) {
         if (tensorField->hasMetaData<J2>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<J2>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<J2>());
         else
             LogWarn("Requested meta data J2 not available. Consider adding a meta data processor.")
     }
     if (j3_.get()) {
         if (tensorField->hasMetaData<J3>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<J3>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<J3>());
         else
             LogWarn("Requested meta data J3 not available. Consider adding a meta data processor.")
     }
     if (lodeAngle_.get()) {
         if (tensorField->hasMetaData<LodeAngle>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<LodeAngle>(),
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<LodeAngle>(),
                                     lodeAngle_.getDisplayName());
         else
             LogWarn(
@@ -212,7 +215,7 @@ void InvariantSpaceSelection::process() {
     }
     if (anisotropy_.get()) {
         if (tensorField->hasMetaData<Anisotropy>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<Anisotropy>(),
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<Anisotropy>(),
                                     anisotropy_.getDisplayName());
         else
             LogWarn(
@@ -221,7 +224,8 @@ void InvariantSpaceSelection::process() {
     }
     if (linearAnisotropy_.get()) {
         if (tensorField->hasMetaData<LinearAnisotropy>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<LinearAnisotropy>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<LinearAnisotropy>());
         else
             LogWarn(
                 "Requested meta data LinearAnisotropy not available. Consider adding a meta data "
@@ -229,7 +233,8 @@ void InvariantSpaceSelection::process() {
     }
     if (planarAnisotropy_.get()) {
         if (tensorField->hasMetaData<PlanarAnisotropy>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<PlanarAnisotropy>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<PlanarAnisotropy>());
         else
             LogWarn(
                 "Requested meta data PlanarAnisotropy not available. Consider adding a meta data "
@@ -237,7 +242,8 @@ void InvariantSpaceSelection::process() {
     }
     if (sphericalAnisotropy_.get()) {
         if (tensorField->hasMetaData<SphericalAnisotropy>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<SphericalAnisotropy>());
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<SphericalAnisotropy>());
         else
             LogWarn(
                 "Requested meta data SphericalAnisotropy not available. Consider adding a meta "
@@ -245,7 +251,7 @@ void InvariantSpaceSelection::process() {
     }
     if (diffusivity_.get()) {
         if (tensorField->hasMetaData<Diffusivity>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<Diffusivity>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<Diffusivity>());
         else
             LogWarn(
                 "Requested meta data Diffusivity not available. Consider adding a meta data "
@@ -253,7 +259,7 @@ void InvariantSpaceSelection::process() {
     }
     if (shearStress_.get()) {
         if (tensorField->hasMetaData<ShearStress>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<ShearStress>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<ShearStress>());
         else
             LogWarn(
                 "Requested meta data ShearStress not available. Consider adding a meta data "
@@ -261,7 +267,7 @@ void InvariantSpaceSelection::process() {
     }
     if (pureShear_.get()) {
         if (tensorField->hasMetaData<PureShear>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<PureShear>());
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<PureShear>());
         else
             LogWarn(
                 "Requested meta data PureShear not available. Consider adding a meta data "
@@ -269,7 +275,7 @@ void InvariantSpaceSelection::process() {
     }
     if (shapeFactor_.get()) {
         if (tensorField->hasMetaData<ShapeFactor>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<ShapeFactor>(),
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<ShapeFactor>(),
                                     shapeFactor_.getDisplayName());
         else
             LogWarn(
@@ -278,7 +284,8 @@ void InvariantSpaceSelection::process() {
     }
     if (isotropicScaling_.get()) {
         if (tensorField->hasMetaData<IsotropicScaling>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<IsotropicScaling>(),
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<IsotropicScaling>(),
                                     isotropicScaling_.getDisplayName());
         else
             LogWarn(
@@ -287,7 +294,7 @@ void InvariantSpaceSelection::process() {
     }
     if (rotation_.get()) {
         if (tensorField->hasMetaData<Rotation>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<Rotation>(),
+            invariantSpace->addAxis(tensorField, tensorField->getMetaDataContainer<Rotation>(),
                                     rotation_.getDisplayName());
         else
             LogWarn(
@@ -296,7 +303,8 @@ void InvariantSpaceSelection::process() {
     }
     if (hill_.get()) {
         if (tensorField->hasMetaData<HillYieldCriterion>())
-            invariantSpace->addAxis(tensorField->getMetaDataContainer<HillYieldCriterion>(),
+            invariantSpace->addAxis(tensorField,
+                                    tensorField->getMetaDataContainer<HillYieldCriterion>(),
                                     hill_.getDisplayName());
         else
             LogWarn(
@@ -28,6 +28,10 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisbase/processors/invariantspacetodataframe.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+
+#include <algorithm>
 
 namespace inviwo {
 
@@ -53,22 +57,34 @@ void InvariantSpaceToDataFrame::process() {
 
     auto dataFrame = std::make_shared<DataFrame>();
 
+    // Buffers own their data, so each axis is converted once and its buffer is then shared by
+    // the columns of all data frames. Conversions of axes no longer in use are dropped.
+    std::vector<ConvertedAxis> converted;
     size_t i{0};
-    for (const auto axis : invariantSpace) {
-        auto buffer = std::make_shared<Buffer<glm::f32>>();
-
-        buffer->setSize(axis->size());
-
-        const auto data = axis->data();
-
-        for (size_t j{0}; j < axis->size(); ++j) {
-            buffer->getEditableRepresentation<BufferRAM>()->setFromDouble(j, data[j]);
+    for (const auto& axis : invariantSpace) {
+        auto it = std::find_if(converted_.begin(), converted_.end(),
+                               [&](const ConvertedAxis& c) { return c.axis.lock() == axis; });
+        auto buffer = it != converted_.end() ? it->buffer : nullptr;
+        if (!buffer) {
+            auto ram = std::make_shared<BufferRAMPrecision<glm::f32>>(axis->size());
+            auto& data = ram->getDataContainer();
+            util::forEachRangeParallel(
+                axis->size(), util::defaultGrainSize(axis->size(), 1 << 16),
+                [&](size_t begin, size_t end) {
+                    std::transform(axis->begin() + begin, axis->begin() + end,
+                                   data.begin() + begin,
+                                   [](glm::f64 v) { return static_cast<glm::f32>(v); });
+                });
+            buffer = std::make_shared<Buffer<glm::f32>>(ram);
         }
+        converted.push_back({axis, buffer});
 
-        dataFrame->addColumnFromBuffer(invariantSpace.getIdentifier(i), buffer);
+        dataFrame->addColumn(
+            std::make_shared<TemplateColumn<glm::f32>>(invariantSpace.getIdentifier(i), buffer));
 
         i++;
     }
+    converted_ = std::move(converted);
 
     dataFrame->updateIndexBuffer();
 
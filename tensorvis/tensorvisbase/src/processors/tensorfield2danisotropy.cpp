@@ -30,8 +30,8 @@
 #include <inviwo/tensorvisbase/processors/tensorfield2danisotropy.h>
 #include <inviwo/core/datastructures/image/image.h>
 #include <inviwo/core/datastructures/image/imageram.h>
-#include <inviwo/core/util/indexmapper.h>
 #include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+#include <inviwo/utilities/util/parallel.h>
 
 namespace inviwo {
 
@@ -63,54 +63,39 @@ TensorField2DAnisotropy::TensorField2DAnisotropy()
 
 void TensorField2DAnisotropy::process() {
     auto tensorField = tensorFieldInport_.getData();
-    std::shared_ptr<Image> outputImage;
-    auto dimensions = tensorField->getDimensions();
-    std::function<void(const size2_t&)> func;
-    util::IndexMapper2D indexMapper(dimensions);
-    const auto& majorEigenValues = tensorField->majorEigenValues();
-    const auto& minorEigenValues = tensorField->minorEigenValues();
-    auto min = std::numeric_limits<double>::max();
-    auto max = std::numeric_limits<double>::lowest();
+    const auto dimensions = tensorField->getDimensions();
+    const auto size = dimensions.x * dimensions.y;
+    const auto majorEigenValues = tensorField->majorEigenValues().data();
+    const auto minorEigenValues = tensorField->minorEigenValues().data();
+
+    const auto compute = [&](auto anisotropy) {
+        auto outputImage = std::make_shared<Image>(dimensions, DataFloat32::get());
+        auto data = static_cast<glm::f32*>(
+            outputImage->getEditableRepresentation<ImageRAM>()->getColorLayerRAM()->getData());
 
+        // Plain loops over contiguous ranges of the precomputed eigenvalues, vectorized by the
+        // compiler
+        util::forEachRangeParallel(
+            size, util::defaultGrainSize(size), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    data[i] = static_cast<glm::f32>(
+                        anisotropy(majorEigenValues[i], minorEigenValues[i]));
+                }
+            });
+        return outputImage;
+    };
+
+    std::shared_ptr<Image> outputImage;
     switch (anisotropy_.get()) {
         case tensorutil::Anisotropy::abs_lamda1_minus_lamda2:
-            outputImage = std::make_shared<Image>(dimensions, DataFloat32::get());
-            {
-                auto data =
-                    static_cast<glm::f32*>(outputImage->getEditableRepresentation<ImageRAM>()
-                                               ->getColorLayerRAM()
-                                               ->getData());
-
-                tensorutil::forEachFixelParallel(
-                    *(tensorField.get()), [&](const size2_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        const auto val =
-                            glm::abs(majorEigenValues[index] - minorEigenValues[index]);
-                        max = std::max(max, val);
-                        min = std::min(min, val);
-                        data[index] = static_cast<glm::f32>(val);
-                    });
-            }
+            outputImage = compute([](double major, double minor) {
+                return glm::abs(major - minor);
+            });
             break;
         case tensorutil::Anisotropy::abs_lamda1_minus_abs_lamda2:
-            outputImage = std::make_shared<Image>(dimensions, DataFloat32::get());
-            {
-                auto data =
-                    static_cast<glm::f32*>(outputImage->getEditableRepresentation<ImageRAM>()
-                                               ->getColorLayerRAM()
-                                               ->getData());
-
-                tensorutil::forEachFixelParallel(
-                    *(tensorField.get()), [&](const size2_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        const auto val =
-                            glm::abs(majorEigenValues[index]) - glm::abs(minorEigenValues[index]);
-
-                        max = std::max(max, val);
-                        min = std::min(min, val);
-                        data[index] = static_cast<glm::f32>(val);
-                    });
-            }
+            outputImage = compute([](double major, double minor) {
+                return glm::abs(major) - glm::abs(minor);
+            });
             break;
         default:
             break;
@@ -53,22 +53,36 @@ TensorField2DSubsample::TensorField2DSubsample()
           {{"linear", "Linear", tensorutil::InterpolationMethod::Linear},
            {"nearest", "Nearest neighbour", tensorutil::InterpolationMethod::Nearest},
            {"barycentric", "Barycentric", tensorutil::InterpolationMethod::Barycentric}},
-          0) {
+          0)
+    , averageBlocks_("averageBlocks", "Average blocks when downsampling", false)
+    , averaging_("averaging", "Averaging",
+                 {{"logEuclidean", "Log-Euclidean", tensorutil::Averaging::LogEuclidean},
+                  {"linear", "Linear", tensorutil::Averaging::Linear}},
+                 0) {
     addPort(inport_);
     addPort(outport_);
 
     addProperty(resolutionMultiplier_);
 
     addProperty(interpolationMethod_);
+    addProperty(averageBlocks_);
+    addProperty(averaging_);
+    averaging_.visibilityDependsOn(averageBlocks_, [](const auto& p) { return p.get(); });
 }
 
 void TensorField2DSubsample::initializeResources() {}
 
 void TensorField2DSubsample::process() {
-    outport_.setData(tensorutil::subsample2D(
-        inport_.getData(),
-        size2_t(glm::round(vec2(inport_.getData()->getDimensions()) * resolutionMultiplier_.get())),
-        interpolationMethod_.get()));
+    const auto tensorField = inport_.getData();
+    const auto newDimensions =
+        size2_t(glm::round(vec2(tensorField->getDimensions()) * resolutionMultiplier_.get()));
+
+    if (averageBlocks_.get() && resolutionMultiplier_.get() < 1.0f) {
+        outport_.setData(tensorutil::downsample2D(tensorField, newDimensions, averaging_.get()));
+    } else {
+        outport_.setData(
+            tensorutil::subsample2D(tensorField, newDimensions, interpolationMethod_.get()));
+    }
 }
 
 }  // namespace inviwo
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisbase/processors/tensorfield3dangle.h>
+#include <inviwo/core/util/foreach.h>
 #include <glm/gtx/vector_angle.hpp>
 
 namespace inviwo {
@@ -65,21 +66,29 @@ void TensorField3DAngle::process() {
     const auto& maev2 = fot->majorEigenVectors();
 
     const auto numberOfElements = maev1.size();
-
-    auto iv = std::make_shared<InvariantSpace>(
-        3, std::vector<std::string>{u8"φmax", u8"φmiddle", u8"φmin"},
-        std::vector<TensorFeature>{TensorFeature::Unspecified, TensorFeature::Unspecified,
-                                   TensorFeature::Unspecified});
+    if (maev2.size() != numberOfElements) {
+        LogError("Tensor fields differ in size (" << numberOfElements << " and " << maev2.size()
+                                                   << " elements)");
+        return;
+    }
 
     auto convertAngle = [](auto angle) {
         return angle >= glm::half_pi<double>() ? glm::pi<double>() - angle : angle;
     };
 
-    for (size_t i = 0; i < numberOfElements; ++i) {
-        iv->addPoint({convertAngle(glm::angle(maev1[i], maev2[i])),
-                      convertAngle(glm::angle(inev1[i], maev2[i])),
-                      convertAngle(glm::angle(miev1[i], maev2[i]))});
-    }
+    InvariantSpaceAxis maxAngles(numberOfElements);
+    InvariantSpaceAxis middleAngles(numberOfElements);
+    InvariantSpaceAxis minAngles(numberOfElements);
+    util::forEachParallel(maev2, [&](const dvec3& fiber, size_t i) {
+        maxAngles[i] = convertAngle(glm::angle(maev1[i], fiber));
+        middleAngles[i] = convertAngle(glm::angle(inev1[i], fiber));
+        minAngles[i] = convertAngle(glm::angle(miev1[i], fiber));
+    });
+
+    auto iv = std::make_shared<InvariantSpace>();
+    iv->addAxis(u8"φmax", std::move(maxAngles), TensorFeature::Unspecified);
+    iv->addAxis(u8"φmiddle", std::move(middleAngles), TensorFeature::Unspecified);
+    iv->addAxis(u8"φmin", std::move(minAngles), TensorFeature::Unspecified);
 
     invariantSpaceOutport_.setData(iv);
 }
@@ -32,7 +32,9 @@
 #include <inviwo/tensorvisbase/util/tensorutil.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
-#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/memorybudget/firsttouch.h>
 #include <modules/opengl/volume/volumegl.h>
 
 namespace inviwo {
@@ -70,115 +72,91 @@ TensorField3DAnisotropy::TensorField3DAnisotropy()
     addProperty(interpolationScheme_);
 }
 
+namespace {
+/*
+ * Evaluates kernel for every voxel, in ranges of z slices on the thread pool, and writes the
+ * result straight into the RAM representation of a new volume. The inner loop runs over
+ * contiguous indices so that simple kernels are vectorized. Returns the volume and the min/max
+ * over all components.
+ */
+template <typename T, typename Kernel>
+std::pair<std::shared_ptr<Volume>, dvec2> computeVolume(const TensorField3D& tensorField,
+                                                         Kernel kernel) {
+    const auto dimensions = tensorField.getDimensions();
+    // The pages are first touched with the same partitioning as the kernel evaluation
+    auto ram = std::static_pointer_cast<VolumeRAMPrecision<T>>(
+        util::createVolumeRAMFirstTouch(dimensions, DataFormat<T>::get()));
+    auto data = ram->getDataTyped();
+
+    const auto sliceSize = dimensions.x * dimensions.y;
+    util::forEachSliceRangeParallel(dimensions, [&](size_t begin, size_t end) {
+        const auto last = end * sliceSize;
+        for (auto index = begin * sliceSize; index < last; ++index) {
+            data[index] = kernel(index);
+        }
+    });
+    auto volume = std::make_shared<Volume>(ram);
+
+    using Component = typename util::value_type<T>::type;
+    const auto components = reinterpret_cast<const Component*>(data);
+    const auto numComponents = tensorField.getSize() * util::extent<T>::value;
+    if (numComponents == 0) return {volume, dvec2(0.0)};
+    const auto minmax = std::minmax_element(components, components + numComponents);
+    return {volume, dvec2(*minmax.first, *minmax.second)};
+}
+}  // namespace
+
 void TensorField3DAnisotropy::process() {
     auto tensorField = tensorFieldInport_.getData();
-    std::shared_ptr<Volume> outputVolume;
-    auto dimensions = tensorField->getDimensions();
-    std::function<void(const size3_t&)> func;
-    util::IndexMapper3D indexMapper(dimensions);
-    const auto& majorEigenValues = tensorField->majorEigenValues();
-    const auto& intermediateEigenValues = tensorField->middleEigenValues();
-    const auto& minorEigenValues = tensorField->minorEigenValues();
-    auto min = std::numeric_limits<double>::max();
-    auto max = std::numeric_limits<double>::lowest();
+    const auto majorEigenValues = tensorField->majorEigenValues().data();
+    const auto intermediateEigenValues = tensorField->middleEigenValues().data();
+    const auto minorEigenValues = tensorField->minorEigenValues().data();
 
+    std::pair<std::shared_ptr<Volume>, dvec2> result;
     switch (anisotropy_.get()) {
         case tensorutil::Anisotropy::abs_lamda1_minus_lamda2:
-            outputVolume = std::make_shared<Volume>(dimensions, DataFloat32::get());
-            {
-                auto data = static_cast<glm::f32*>(
-                    outputVolume->getEditableRepresentation<VolumeRAM>()->getData());
-
-                tensorutil::forEachVoxelParallel(
-                    *(tensorField.get()), [&](const size3_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        const auto val =
-                            glm::abs(majorEigenValues[index] - intermediateEigenValues[index]);
-                        max = std::max(max, val);
-                        min = std::min(min, val);
-                        data[index] = static_cast<glm::f32>(val);
-                    });
-            }
+            result = computeVolume<glm::f32>(*tensorField, [&](size_t i) {
+                return static_cast<glm::f32>(
+                    glm::abs(majorEigenValues[i] - intermediateEigenValues[i]));
+            });
             break;
         case tensorutil::Anisotropy::abs_lamda1_minus_lamda3:
-            outputVolume = std::make_shared<Volume>(dimensions, DataFloat32::get());
-            {
-                auto data = static_cast<glm::f32*>(
-                    outputVolume->getEditableRepresentation<VolumeRAM>()->getData());
-
-                tensorutil::forEachVoxelParallel(
-                    *(tensorField.get()), [&](const size3_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        const auto val =
-                            glm::abs(majorEigenValues[index] - minorEigenValues[index]);
-
-                        max = std::max(max, val);
-                        min = std::min(min, val);
-                        data[index] = static_cast<glm::f32>(val);
-                    });
-            }
+            result = computeVolume<glm::f32>(*tensorField, [&](size_t i) {
+                return static_cast<glm::f32>(glm::abs(majorEigenValues[i] - minorEigenValues[i]));
+            });
             break;
         case tensorutil::Anisotropy::barycentric:
-            outputVolume = std::make_shared<Volume>(dimensions, DataVec3Float32::get());
-            {
-                auto data = static_cast<glm::vec3*>(
-                    outputVolume->getEditableRepresentation<VolumeRAM>()->getData());
-
-                tensorutil::forEachVoxelParallel(
-                    *(tensorField.get()), [&](const size3_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        auto eigenValues = std::array<double, 3>{majorEigenValues[index],
-                                                                 intermediateEigenValues[index],
-                                                                 minorEigenValues[index]};
-
-                        std::transform(eigenValues.begin(), eigenValues.end(), eigenValues.begin(),
-                                       [](const double& val) { return glm::abs(val); });
-
-                        std::sort(
-                            eigenValues.begin(), eigenValues.end(),
-                            [](const double& valA, const double& valB) { return valA > valB; });
-
-                        auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
-                        if (denominator < std::numeric_limits<double>::epsilon())
-                            denominator = std::numeric_limits<double>::epsilon();
-                        const auto c_l_ = (eigenValues[0] - eigenValues[1]) / denominator;
-                        const auto c_p_ = (2. * (eigenValues[1] - eigenValues[2])) / denominator;
-                        const auto c_s_ = (3. * eigenValues[2]) / denominator;
-
-                        const auto barycentricCoordinates = dvec3(c_l_, c_p_, c_s_);
-
-                        max = std::max(max, barycentricCoordinates.x);
-                        max = std::max(max, barycentricCoordinates.y);
-                        max = std::max(max, barycentricCoordinates.z);
-                        min = std::min(min, barycentricCoordinates.x);
-                        min = std::min(min, barycentricCoordinates.y);
-                        min = std::min(min, barycentricCoordinates.z);
-
-                        data[index] = vec3(barycentricCoordinates);
-                    });
-            }
+            result = computeVolume<vec3>(*tensorField, [&](size_t i) {
+                // Absolute eigenvalues sorted in descending order
+                auto l1 = glm::abs(majorEigenValues[i]);
+                auto l2 = glm::abs(intermediateEigenValues[i]);
+                auto l3 = glm::abs(minorEigenValues[i]);
+                if (l1 < l2) std::swap(l1, l2);
+                if (l2 < l3) std::swap(l2, l3);
+                if (l1 < l2) std::swap(l1, l2);
+
+                const auto denominator =
+                    std::max(l1 + l2 + l3, std::numeric_limits<double>::epsilon());
+                const auto c_l_ = (l1 - l2) / denominator;
+                const auto c_p_ = (2. * (l2 - l3)) / denominator;
+                const auto c_s_ = (3. * l3) / denominator;
+
+                return vec3(c_l_, c_p_, c_s_);
+            });
             break;
         case tensorutil::Anisotropy::abs_lamda1_minus_abs_lamda2:
-            outputVolume = std::make_shared<Volume>(dimensions, DataFloat32::get());
-            {
-                auto data = static_cast<glm::f32*>(
-                    outputVolume->getEditableRepresentation<VolumeRAM>()->getData());
-
-                tensorutil::forEachVoxelParallel(
-                    *(tensorField.get()), [&](const size3_t& pos) -> void {
-                        const auto index = indexMapper(pos);
-                        const auto val =
-                            glm::abs(majorEigenValues[index]) - glm::abs(minorEigenValues[index]);
-
-                        max = std::max(max, val);
-                        min = std::min(min, val);
-                        data[index] = static_cast<glm::f32>(val);
-                    });
-            }
+            result = computeVolume<glm::f32>(*tensorField, [&](size_t i) {
+                return static_cast<glm::f32>(glm::abs(majorEigenValues[i]) -
+                                             glm::abs(minorEigenValues[i]));
+            });
             break;
         default:
-            break;
+            return;
     }
+    auto outputVolume = result.first;
+    const auto min = result.second.x;
+    const auto max = result.second.y;
+
     outputVolume->dataMap_.dataRange = vec2(min, max);
     outputVolume->dataMap_.valueRange = vec2(min, max);
 
@@ -0,0 +1,113 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/processors/tensorfield3densemblestatistics.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <algorithm>
+#include <array>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo TensorField3DEnsembleStatistics::processorInfo_{
+    "org.inviwo.TensorField3DEnsembleStatistics",  // Class identifier
+    "Tensor Field 3D Ensemble Statistics",         // Display name
+    "Tensor",                                      // Category
+    CodeState::Experimental,                       // Code state
+    Tags::CPU,                                     // Tags
+};
+const ProcessorInfo TensorField3DEnsembleStatistics::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+TensorField3DEnsembleStatistics::TensorField3DEnsembleStatistics()
+    : PoolProcessor()
+    , inport_("inport")
+    , meanOutport_("mean")
+    , varianceOutport_("variance")
+    , outlierOutport_("outlier")
+    , distance_("distance", "Distance",
+                {{"frobenius", "Frobenius", tensorutil::EnsembleDistance::Frobenius},
+                 {"logEuclidean", "Log-Euclidean", tensorutil::EnsembleDistance::LogEuclidean},
+                 {"eigenAngle", "Major eigenvector angle",
+                  tensorutil::EnsembleDistance::EigenAngle}},
+                0) {
+    addPort(inport_);
+    addPort(meanOutport_);
+    addPort(varianceOutport_);
+    addPort(outlierOutport_);
+
+    addProperty(distance_);
+}
+
+namespace {
+
+std::shared_ptr<Volume> toVolume(const std::vector<double>& values, const size3_t& dimensions,
+                                 const mat4& basisAndOffset) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dimensions);
+    std::transform(values.begin(), values.end(), ram->getDataTyped(),
+                   [](double v) { return static_cast<float>(v); });
+
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setModelMatrix(basisAndOffset);
+    if (!values.empty()) {
+        const auto minmax = std::minmax_element(values.begin(), values.end());
+        volume->dataMap_.dataRange = dvec2(*minmax.first, *minmax.second);
+        volume->dataMap_.valueRange = volume->dataMap_.dataRange;
+    }
+    return volume;
+}
+
+}  // namespace
+
+void TensorField3DEnsembleStatistics::process() {
+    using Result = std::array<std::shared_ptr<Volume>, 3>;
+    auto compute = [ensemble = inport_.getData(), distance = distance_.get()](
+                       pool::Stop stop, pool::Progress progress) -> Result {
+        const auto stats = tensorutil::ensembleStatistics(
+            *ensemble, distance, [&stop]() { return stop(); },
+            [&progress](float f) { progress(f); });
+        if (!stats) return {};
+
+        return {toVolume(stats->mean, stats->dimensions, stats->basisAndOffset),
+                toVolume(stats->variance, stats->dimensions, stats->basisAndOffset),
+                toVolume(stats->outlierScore, stats->dimensions, stats->basisAndOffset)};
+    };
+
+    dispatchOne(compute, [this](Result result) {
+        meanOutport_.setData(result[0]);
+        varianceOutport_.setData(result[1]);
+        outlierOutport_.setData(result[2]);
+        newResults();
+    });
+}
+
+}  // namespace inviwo
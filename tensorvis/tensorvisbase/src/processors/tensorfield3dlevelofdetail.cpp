@@ -0,0 +1,89 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/processors/tensorfield3dlevelofdetail.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo TensorField3DLevelOfDetail::processorInfo_{
+    "org.inviwo.TensorField3DLevelOfDetail",  // Class identifier
+    "Tensor Field 3D Level Of Detail",         // Display name
+    "Tensor visualization",                    // Category
+    CodeState::Experimental,                   // Code state
+    Tags::CPU,                                 // Tags
+};
+const ProcessorInfo TensorField3DLevelOfDetail::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+TensorField3DLevelOfDetail::TensorField3DLevelOfDetail()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , averaging_("averaging", "Averaging",
+                 {{"linear", "Linear", TensorField3DPyramid::Averaging::Linear},
+                  {"logEuclidean", "Log-Euclidean", TensorField3DPyramid::Averaging::LogEuclidean}},
+                 0)
+    , maxPixelError_("maxPixelError", "Max pixel error", 1.0f, 0.1f, 64.0f, 0.1f)
+    , viewportHeight_("viewportHeight", "Viewport height", 1024, 1, 16384)
+    , camera_("camera", "Camera")
+    , level_("level", "Level", 0, 0, 64, 1, InvalidationLevel::Valid) {
+    addPort(inport_);
+    addPort(outport_);
+
+    level_.setReadOnly(true);
+    addProperties(averaging_, maxPixelError_, viewportHeight_, camera_, level_);
+
+    inport_.onChange([this]() { pyramid_.reset(); });
+    averaging_.onChange([this]() { pyramid_.reset(); });
+}
+
+void TensorField3DLevelOfDetail::process() {
+    if (!pyramid_) {
+        pyramid_ = std::make_unique<TensorField3DPyramid>(inport_.getData(), averaging_.get());
+        level_.setMaxValue(pyramid_->getNumberOfLevels() - 1);
+    }
+
+    // Screen pixels per world unit at the center of the tensor field, valid for perspective and
+    // orthographic projections
+    const auto& camera = camera_.get();
+    const auto center =
+        camera.getViewMatrix() * inport_.getData()->getBasisAndOffset() * vec4(vec3(0.5f), 1.0f);
+    const auto clip = camera.getProjectionMatrix() * center;
+    const auto pixelsPerUnit = 0.5 * viewportHeight_.get() *
+                               camera.getProjectionMatrix()[1][1] /
+                               std::max(std::abs(static_cast<double>(clip.w)), 1e-6);
+
+    const auto level = pyramid_->coarsestLevel(pixelsPerUnit, maxPixelError_.get());
+    level_.set(level);
+    outport_.setData(pyramid_->getLevel(level));
+}
+
+}  // namespace inviwo
@@ -1,6 +1,8 @@
 #include <inviwo/tensorvisbase/processors/tensorfield3dmasktovolume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 
+#include <algorithm>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -48,7 +50,7 @@ TensorField3DMaskToVolume::TensorField3DMaskToVolume()
 
 void TensorField3DMaskToVolume::process() {
     auto tensorField = inport_.getData();
-    auto mask = tensorField->getMask();
+    const auto& mask = tensorField->getMask();
     auto dimensions = tensorField->getDimensions();
     auto extends = tensorField->getExtents();
 
@@ -56,11 +58,7 @@ void TensorField3DMaskToVolume::process() {
     auto volumeRAM = volume->getEditableRepresentation<VolumeRAM>();
     auto volumeData = static_cast<glm::f32*>(volumeRAM->getData());
 
-    std::vector<glm::f32> f;
-
-    for (const auto val : mask) f.push_back(glm::f32(val));
-
-    std::transform(std::begin(f), std::end(f), std::begin(f), [this](glm::f32 val) {
+    const auto map = [this](glm::f32 val) {
         float factor = val == 0.f ? zeroFactor_.get() : oneFactor_.get();
         switch (method_.get()) {
                 // None
@@ -88,13 +86,27 @@ void TensorField3DMaskToVolume::process() {
                 break;
         }
         return 0.f;
-    });
-
-    const auto min = *std::min_element(std::begin(f), std::end(f));
-    const auto max = *std::max_element(std::begin(f), std::end(f));
-
-    auto fData = f.data();
-    std::memcpy(volumeData, fData, f.size());
+    };
+
+    // The mask only has two values, fill the undefined value and write the defined one per set
+    // bit. A field without a mask is defined everywhere.
+    const auto size = tensorField->getSize();
+    const auto zeroValue = map(0.f);
+    const auto oneValue = map(1.f);
+    const auto numDefined = tensorField->hasMask() ? mask.count() : size;
+    if (numDefined == size) {
+        std::fill(volumeData, volumeData + size, oneValue);
+    } else {
+        std::fill(volumeData, volumeData + size, zeroValue);
+        mask.forEachSetBit([&](size_t i) { volumeData[i] = oneValue; });
+    }
+
+    auto min = numDefined == size ? oneValue : zeroValue;
+    auto max = min;
+    if (numDefined > 0 && numDefined < size) {
+        min = std::min(zeroValue, oneValue);
+        max = std::max(zeroValue, oneValue);
+    }
 
     glm::mat3 basis(1);
     basis[0][0] = static_cast<float>(extends.x);
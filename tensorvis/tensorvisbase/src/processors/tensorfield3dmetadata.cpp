@@ -30,16 +30,92 @@
 #include <inviwo/tensorvisbase/processors/tensorfield3dmetadata.h>
 #include <inviwo/tensorvisbase/util/tensorutil.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglutils.h>
+#include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>
 
 namespace inviwo {
 
+namespace {
+constexpr size_t workGroupSize = 256;
+
+// Feature indices, same order as in tensorfeatures.comp
+namespace feature {
+enum : size_t {
+    I1,
+    I2,
+    I3,
+    J1,
+    J2,
+    J3,
+    LodeAngle,
+    Anisotropy,
+    LinearAnisotropy,
+    PlanarAnisotropy,
+    SphericalAnisotropy,
+    Diffusivity,
+    ShearStress,
+    PureShear,
+    ShapeFactor,
+    IsotropicScaling,
+    Rotation,
+    FrobeniusNorm
+};
+// Features from Anisotropy onwards are derived from the eigenvalues
+constexpr size_t firstEigenValueFeature = Anisotropy;
+}  // namespace feature
+
+template <typename T, TensorFeature feature>
+void addFeature(TensorField3D& tensorField, std::vector<double> data) {
+    tensorField.addMetaData<T>(std::move(data), feature);
+}
+
+/*
+ * Returns the unique components of the tensor field as six consecutive arrays in the order of
+ * SymmetricTensorStorage3D, or an empty vector if the tensor field is not symmetric.
+ */
+std::vector<float> uniqueComponents(const TensorField3D& tensorField) {
+    const auto concatenate = [&](const auto& storage) {
+        std::vector<float> components;
+        components.reserve(6 * storage.size());
+        for (size_t c = 0; c < 6; ++c) {
+            const auto& component = storage.component(c);
+            components.insert(components.end(), component.begin(), component.end());
+        }
+        return components;
+    };
+
+    if (const auto packed = tensorField.symmetricTensors<float>()) return concatenate(*packed);
+    if (const auto packed = tensorField.symmetricTensors<double>()) return concatenate(*packed);
+
+    const auto& tensors = tensorField.tensors();
+    const auto symmetric =
+        std::all_of(tensors.begin(), tensors.end(),
+                    [](const dmat3& tensor) { return tensorutil::isSymmetric(tensor, 1e-6); });
+    if (!symmetric) return {};
+
+    return concatenate(SymmetricTensorStorage3D<float>(tensors));
+}
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo TensorField3DMetaData::processorInfo_{
     "org.inviwo.TensorField3DMetaData",  // Class identifier
     "Tensor Field 3D Meta Data",         // Display name
     "Tensor",                            // Category
     CodeState::Experimental,             // Code state
-    Tags::CPU,                           // Tags
+    Tags::CPU | Tags::GL,                // Tags
 };
 const ProcessorInfo TensorField3DMetaData::getProcessorInfo() const { return processorInfo_; }
 
@@ -74,6 +150,9 @@ TensorField3DMetaData::TensorField3DMetaData()
     , hillYieldCriterion_("hillYieldCriterion", "Hill yield criterion", true)
     , selectAll_("selectAll", "Select all")
     , deselectAll_("deselectAll", "Deselect all")
+    , backend_("backend", "Backend",
+               {{"cpu", "CPU", Backend::CPU}, {"gpu", "GPU (compute shader)", Backend::GPU}}, 0)
+    , shader_({{ShaderType::Compute, "tensorfeatures.comp"}}, Shader::Build::No)
     , tensorFieldOut_(nullptr) {
 
     addPort(inport_);
@@ -108,6 +187,8 @@ TensorField3DMetaData::TensorField3DMetaData()
     addProperty(selectAll_);
     addProperty(deselectAll_);
 
+    addProperty(backend_);
+
     sigma1_.setReadOnly(true);
     sigma2_.setReadOnly(true);
     sigma3_.setReadOnly(true);
@@ -118,6 +199,8 @@ TensorField3DMetaData::TensorField3DMetaData()
     inport_.onChange([this]() { invalidate(InvalidationLevel::InvalidResources); });
     selectAll_.onChange([this]() { selectAll(); });
     deselectAll_.onChange([this]() { deselectAll(); });
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidOutput); });
 }
 
 void TensorField3DMetaData::initializeResources() {
@@ -160,327 +243,232 @@ void TensorField3DMetaData::initializeResources() {
     }
 }
 
-void TensorField3DMetaData::addMetaData() {
-    const auto& tensors = tensorFieldOut_->tensors();
-
-    if (i1_.get() && !tensorFieldOut_->hasMetaData<I1>()) {
-        std::vector<double> i1;
-
-        for (const auto& tensor : tensors) {
-            i1.emplace_back(tensorutil::calculateI1(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<I1>(i1, TensorFeature::I1);
-    }
-    if (i2_.get() && !tensorFieldOut_->hasMetaData<I2>()) {
-        std::vector<double> i2;
-
-        for (const auto& tensor : tensors) {
-            i2.emplace_back(tensorutil::calculateI2(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<I2>(i2, TensorFeature::I2);
-    }
-    if (i3_.get() && !tensorFieldOut_->hasMetaData<I3>()) {
-        std::vector<double> i3;
-
-        for (const auto& tensor : tensors) {
-            i3.emplace_back(tensorutil::calculateI3(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<I3>(i3, TensorFeature::I3);
-    }
-    if (j1_.get() && !tensorFieldOut_->hasMetaData<J1>()) {
-        std::vector<double> j1;
-
-        for (const auto& tensor : tensors) {
-            j1.emplace_back(tensorutil::calculateJ1(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<J1>(j1, TensorFeature::J1);
-    }
-    if (j2_.get() && !tensorFieldOut_->hasMetaData<J2>()) {
-        std::vector<double> j2;
-
-        for (const auto& tensor : tensors) {
-            j2.emplace_back(tensorutil::calculateJ2(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<J2>(j2, TensorFeature::J2);
-    }
-    if (j3_.get() && !tensorFieldOut_->hasMetaData<J3>()) {
-        std::vector<double> j3;
-
-        for (const auto& tensor : tensors) {
-            j3.emplace_back(tensorutil::calculateJ3(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<J3>(j3, TensorFeature::J3);
-    }
-    if (lodeAngle_.get() && !tensorFieldOut_->hasMetaData<LodeAngle>()) {
-        std::vector<double> lodeAngle;
-
-        for (const auto& tensor : tensors) {
-            lodeAngle.emplace_back(tensorutil::calculateLodeAngle(tensor));
-        }
-
-        tensorFieldOut_->addMetaData<LodeAngle>(lodeAngle, TensorFeature::LodeAngle);
-    }
-    if (anisotropy_.get() && !tensorFieldOut_->hasMetaData<Anisotropy>()) {
-        std::vector<double> anisotropy;
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < tensors.size(); i++) {
-            anisotropy.emplace_back(std::abs(majorEigenValues[i] - minorEigenValues[i]));
-        }
-
-        tensorFieldOut_->addMetaData<Anisotropy>(anisotropy, TensorFeature::Anisotropy);
-    }
-    if (linearAnisotropy_.get() && !tensorFieldOut_->hasMetaData<LinearAnisotropy>()) {
-        std::vector<double> linearAnisotropy;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            std::array<double, 3> eigenValues{majorEigenValues[i], intermediateEigenValues[i],
-                                              minorEigenValues[i]};
-
-            std::transform(eigenValues.begin(), eigenValues.end(), eigenValues.begin(),
-                           [](const double& val) { return glm::abs(val); });
-
-            std::sort(eigenValues.begin(), eigenValues.end(),
-                      [](const double& valA, const double& valB) { return valA > valB; });
-
-            auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
-            if (denominator < std::numeric_limits<double>::epsilon())
-                denominator = std::numeric_limits<double>::epsilon();
-
-            linearAnisotropy.emplace_back((eigenValues[0] - eigenValues[1]) / denominator);
-        }
+std::array<TensorField3DMetaData::FeatureInfo, TensorField3DMetaData::numFeatures>
+TensorField3DMetaData::features() const {
+    return {{{&i1_, I1::id(), &addFeature<I1, TensorFeature::I1>},
+             {&i2_, I2::id(), &addFeature<I2, TensorFeature::I2>},
+             {&i3_, I3::id(), &addFeature<I3, TensorFeature::I3>},
+             {&j1_, J1::id(), &addFeature<J1, TensorFeature::J1>},
+             {&j2_, J2::id(), &addFeature<J2, TensorFeature::J2>},
+             {&j3_, J3::id(), &addFeature<J3, TensorFeature::J3>},
+             {&lodeAngle_, LodeAngle::id(), &addFeature<LodeAngle, TensorFeature::LodeAngle>},
+             {&anisotropy_, Anisotropy::id(), &addFeature<Anisotropy, TensorFeature::Anisotropy>},
+             {&linearAnisotropy_, LinearAnisotropy::id(),
+              &addFeature<LinearAnisotropy, TensorFeature::LinearAnisotropy>},
+             {&planarAnisotropy_, PlanarAnisotropy::id(),
+              &addFeature<PlanarAnisotropy, TensorFeature::PlanarAnisotropy>},
+             {&sphericalAnisotropy_, SphericalAnisotropy::id(),
+              &addFeature<SphericalAnisotropy, TensorFeature::SphericalAnisotropy>},
+             {&diffusivity_, Diffusivity::id(),
+              &addFeature<Diffusivity, TensorFeature::Diffusivity>},
+             {&shearStress_, ShearStress::id(),
+              &addFeature<ShearStress, TensorFeature::ShearStress>},
+             {&pureShear_, PureShear::id(), &addFeature<PureShear, TensorFeature::PureShear>},
+             {&shapeFactor_, ShapeFactor::id(),
+              &addFeature<ShapeFactor, TensorFeature::ShapeFactor>},
+             {&isotropicScaling_, IsotropicScaling::id(),
+              &addFeature<IsotropicScaling, TensorFeature::IsotropicScaling>},
+             {&rotation_, Rotation::id(), &addFeature<Rotation, TensorFeature::Rotation>},
+             {&frobeniusNorm_, FrobeniusNorm::id(),
+              &addFeature<FrobeniusNorm, TensorFeature::FrobeniusNorm>}}};
+}
 
-        tensorFieldOut_->addMetaData<LinearAnisotropy>(linearAnisotropy,
-                                                       TensorFeature::LinearAnisotropy);
+size_t TensorField3DMetaData::requestedFeatures(std::array<int, numFeatures>& outputSlot) const {
+    const auto featureInfo = features();
+    int numRequested = 0;
+    for (size_t f = 0; f < numFeatures; ++f) {
+        const auto& info = featureInfo[f];
+        const auto requested = info.property->get() && !tensorFieldOut_->hasMetaData(info.id);
+        outputSlot[f] = requested ? numRequested++ : -1;
     }
-    if (planarAnisotropy_.get() && !tensorFieldOut_->hasMetaData<PlanarAnisotropy>()) {
-        std::vector<double> planarAnisotropy;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            std::array<double, 3> eigenValues{majorEigenValues[i], intermediateEigenValues[i],
-                                              minorEigenValues[i]};
-
-            std::transform(eigenValues.begin(), eigenValues.end(), eigenValues.begin(),
-                           [](const double& val) { return glm::abs(val); });
-
-            std::sort(eigenValues.begin(), eigenValues.end(),
-                      [](const double& valA, const double& valB) { return valA > valB; });
-
-            auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
-            if (denominator < std::numeric_limits<double>::epsilon())
-                denominator = std::numeric_limits<double>::epsilon();
+    return static_cast<size_t>(numRequested);
+}
 
-            planarAnisotropy.emplace_back((2.0 * (eigenValues[1] - eigenValues[2])) / denominator);
-        }
+bool TensorField3DMetaData::addMetaDataGPU() {
+    std::array<int, numFeatures> outputSlot;
+    const auto numRequested = requestedFeatures(outputSlot);
+    if (numRequested == 0) return true;
 
-        tensorFieldOut_->addMetaData<PlanarAnisotropy>(planarAnisotropy,
-                                                       TensorFeature::PlanarAnisotropy);
+    // The shader indexes the six component arrays and the feature arrays with uints
+    const auto numTensors = tensorFieldOut_->getSize();
+    if (std::max<size_t>(6, numRequested) * numTensors > std::numeric_limits<GLuint>::max()) {
+        LogWarn("Tensor field is too large for the compute shader, computing meta data on the CPU");
+        return false;
     }
-    if (sphericalAnisotropy_.get() && !tensorFieldOut_->hasMetaData<SphericalAnisotropy>()) {
-        std::vector<double> sphericalAnisotropy;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            std::array<double, 3> eigenValues{majorEigenValues[i], intermediateEigenValues[i],
-                                              minorEigenValues[i]};
-
-            std::transform(eigenValues.begin(), eigenValues.end(), eigenValues.begin(),
-                           [](const double& val) { return glm::abs(val); });
-
-            std::sort(eigenValues.begin(), eigenValues.end(),
-                      [](const double& valA, const double& valB) { return valA > valB; });
-
-            auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
-            if (denominator < std::numeric_limits<double>::epsilon())
-                denominator = std::numeric_limits<double>::epsilon();
-
-            sphericalAnisotropy.emplace_back((3.0 * eigenValues[2]) / denominator);
-        }
 
-        tensorFieldOut_->addMetaData<SphericalAnisotropy>(sphericalAnisotropy,
-                                                          TensorFeature::SphericalAnisotropy);
+    auto components = uniqueComponents(*tensorFieldOut_);
+    if (components.empty()) {
+        LogWarn("Tensor field is not symmetric, computing meta data on the CPU");
+        return false;
     }
-    if (diffusivity_.get() && !tensorFieldOut_->hasMetaData<Diffusivity>()) {
-        std::vector<double> diffusivity;
 
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
+    auto tensorBuffer = std::make_shared<Buffer<float>>(
+        std::make_shared<BufferRAMPrecision<float>>(std::move(components)));
+    auto featureBuffer = std::make_shared<Buffer<float>>(numTensors * numRequested);
+    const auto tensorBufferGL = tensorBuffer->getRepresentation<BufferGL>();
+    auto featureBufferGL = featureBuffer->getEditableRepresentation<BufferGL>();
 
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            std::array<double, 3> eigenValues{majorEigenValues[i], intermediateEigenValues[i],
-                                              minorEigenValues[i]};
+    // Undefined voxels of a masked field get zero features, the same as on the CPU
+    const bool masked = tensorFieldOut_->hasMask();
+    auto maskBuffer = std::make_shared<Buffer<std::uint32_t>>(
+        std::make_shared<BufferRAMPrecision<std::uint32_t>>(
+            masked ? tensorFieldOut_->getMask().toWords32() : std::vector<std::uint32_t>(1, 0)));
+    const auto maskBufferGL = maskBuffer->getRepresentation<BufferGL>();
 
-            std::transform(eigenValues.begin(), eigenValues.end(), eigenValues.begin(),
-                           [](const double& val) { return glm::abs(val); });
+    if (!shader_.isReady()) shader_.build();
 
-            std::sort(eigenValues.begin(), eigenValues.end(),
-                      [](const double& valA, const double& valB) { return valA > valB; });
+    shader_.activate();
+    shader_.setUniform("numTensors", static_cast<GLuint>(numTensors));
+    shader_.setUniform("outputSlot", outputSlot.size(), outputSlot.data());
+    shader_.setUniform("masked", masked);
 
-            diffusivity.emplace_back(eigenValues[0] * eigenValues[0] +
-                                     eigenValues[1] * eigenValues[1] +
-                                     eigenValues[2] * eigenValues[2]);
-        }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, tensorBufferGL->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, featureBufferGL->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, maskBufferGL->getId());
 
-        tensorFieldOut_->addMetaData<Diffusivity>(diffusivity, TensorFeature::Diffusivity);
-    }
-    if (shearStress_.get() && !tensorFieldOut_->hasMetaData<ShearStress>()) {
-        std::vector<double> shearStress;
+    progressBar_.show();
+    updateProgress(0.f);
 
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
+    // Large fields exceed the maximum work group count of a single dispatch
+    const auto numWorkGroups = (numTensors + workGroupSize - 1) / workGroupSize;
+    utilgl::dispatchChunked(shader_, numWorkGroups, "offset", workGroupSize, [&](size_t done) {
+        updateProgress(0.9f * static_cast<float>(done) / static_cast<float>(numWorkGroups));
+    });
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
 
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            shearStress.emplace_back((majorEigenValues[i] - minorEigenValues[i]) / 2.0);
-        }
+    shader_.deactivate();
 
-        tensorFieldOut_->addMetaData<ShearStress>(shearStress, TensorFeature::ShearStress);
+    // Download once and split into the individual features
+    const auto featureInfo = features();
+    const auto& data = featureBuffer->getRAMRepresentation()->getDataContainer();
+    for (size_t f = 0; f < numFeatures; ++f) {
+        if (outputSlot[f] < 0) continue;
+        const auto begin = data.begin() + outputSlot[f] * numTensors;
+        featureInfo[f].add(*tensorFieldOut_, std::vector<double>(begin, begin + numTensors));
     }
-    if (pureShear_.get() && !tensorFieldOut_->hasMetaData<PureShear>()) {
-        std::vector<double> pureShear;
 
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
+    updateProgress(1.f);
+    progressBar_.hide();
 
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            pureShear.emplace_back(0);
-        }
+    return true;
+}
 
-        tensorFieldOut_->addMetaData<PureShear>(pureShear, TensorFeature::PureShear);
-    }
-    if (shapeFactor_.get() && !tensorFieldOut_->hasMetaData<ShapeFactor>()) {
-        std::vector<double> shapeFactor;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            shapeFactor.emplace_back((majorEigenValues[i] - intermediateEigenValues[i]) /
-                                     (majorEigenValues[i] - minorEigenValues[i]));
+std::optional<std::vector<std::vector<double>>> TensorField3DMetaData::computeFeatures(
+    const TensorField3D& tensorField, const std::array<int, numFeatures>& outputSlot,
+    size_t numRequested, const std::function<bool()>& stop,
+    const std::function<void(float)>& progress) {
+    const auto numTensors = tensorField.getSize();
+
+    // Preallocated output for every requested feature, nullptr for the others
+    std::vector<std::vector<double>> results(numRequested, std::vector<double>(numTensors));
+    std::array<double*, numFeatures> out{};
+    for (size_t f = 0; f < numFeatures; ++f) {
+        if (outputSlot[f] >= 0) out[f] = results[outputSlot[f]].data();
+    }
+
+    const auto needsInvariants =
+        std::any_of(out.begin(), out.begin() + feature::firstEigenValueFeature,
+                    [](const double* ptr) { return ptr != nullptr; });
+    const auto needsEigenValues =
+        std::any_of(out.begin() + feature::firstEigenValueFeature, out.end(),
+                    [](const double* ptr) { return ptr != nullptr; });
+
+    const double* majorEigenValues = nullptr;
+    const double* intermediateEigenValues = nullptr;
+    const double* minorEigenValues = nullptr;
+    if (needsEigenValues) {
+        majorEigenValues = tensorField.getMetaData<MajorEigenValues>().data();
+        intermediateEigenValues = tensorField.getMetaData<IntermediateEigenValues>().data();
+        minorEigenValues = tensorField.getMetaData<MinorEigenValues>().data();
+    }
+
+    const auto dims = tensorField.getDimensions();
+    const auto sliceSize = dims.x * dims.y;
+
+    std::atomic<size_t> slicesDone{0};
+    std::mutex progressMutex;
+
+    // Undefined voxels of a masked field are skipped and keep zero features
+    const bool masked = tensorField.hasMask();
+    const auto& definedIndices = tensorField.definedIndices();
+
+    // Single pass over the tensor field computing all requested features per voxel
+    const auto slice = [&](size_t z, size_t) {
+        auto first = definedIndices.begin();
+        auto last = definedIndices.begin();
+        if (masked) {
+            first = std::lower_bound(definedIndices.begin(), definedIndices.end(), z * sliceSize);
+            last = std::lower_bound(first, definedIndices.end(), (z + 1) * sliceSize);
         }
-
-        tensorFieldOut_->addMetaData<ShapeFactor>(shapeFactor, TensorFeature::ShapeFactor);
-    }
-    if (isotropicScaling_.get() && !tensorFieldOut_->hasMetaData<IsotropicScaling>()) {
-        std::vector<double> isotropicScaling;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            isotropicScaling.emplace_back(
-                (majorEigenValues[i] + intermediateEigenValues[i] + minorEigenValues[i]) / 3.0);
+        const auto count = masked ? static_cast<size_t>(std::distance(first, last)) : sliceSize;
+
+        for (size_t k = 0; k < count; ++k) {
+            const auto i = masked ? first[k] : z * sliceSize + k;
+            const auto store = [&](size_t f, double value) {
+                if (out[f]) out[f][i] = value;
+            };
+
+            if (needsInvariants) {
+                const auto tensor = tensorField.tensor(i);
+                const auto i1 = tensorutil::calculateI1(tensor);
+                const auto i2 = tensorutil::calculateI2(tensor);
+                const auto i3 = tensorutil::calculateI3(tensor);
+                const auto j2 = (1. / 3.) * i1 * i1 - i2;
+                const auto j3 = (2. / 27.) * i1 * i1 * i1 - (1. / 3.) * i1 * i2 + i3;
+
+                store(feature::I1, i1);
+                store(feature::I2, i2);
+                store(feature::I3, i3);
+                // The first invariant of the stress deviator tensor is zero by definition
+                store(feature::J1, 0.0);
+                store(feature::J2, j2);
+                store(feature::J3, j3);
+                store(feature::LodeAngle, (1. / 3.) * std::acos((3. * std::sqrt(3.)) * .5 * j3 /
+                                                                std::pow(j2, 1.5)));
+            }
+
+            if (needsEigenValues) {
+                const std::array<double, 3> ev{majorEigenValues[i], intermediateEigenValues[i],
+                                               minorEigenValues[i]};
+
+                std::array<double, 3> absEv{std::abs(ev[0]), std::abs(ev[1]), std::abs(ev[2])};
+                std::sort(absEv.begin(), absEv.end(), std::greater<double>());
+
+                const auto denominator = std::max(absEv[0] + absEv[1] + absEv[2],
+                                                  std::numeric_limits<double>::epsilon());
+
+                store(feature::Anisotropy, std::abs(ev[0] - ev[2]));
+                store(feature::LinearAnisotropy, (absEv[0] - absEv[1]) / denominator);
+                store(feature::PlanarAnisotropy, (2.0 * (absEv[1] - absEv[2])) / denominator);
+                store(feature::SphericalAnisotropy, (3.0 * absEv[2]) / denominator);
+                store(feature::Diffusivity,
+                      absEv[0] * absEv[0] + absEv[1] * absEv[1] + absEv[2] * absEv[2]);
+                store(feature::ShearStress, (ev[0] - ev[2]) / 2.0);
+                store(feature::PureShear, 0.0);
+                store(feature::ShapeFactor, (ev[0] - ev[1]) / (ev[0] - ev[2]));
+                store(feature::IsotropicScaling, (ev[0] + ev[1] + ev[2]) / 3.0);
+                store(feature::Rotation, 0.0);
+                store(feature::FrobeniusNorm,
+                      std::sqrt(ev[0] * ev[0] + ev[1] * ev[1] + ev[2] * ev[2]));
+            }
         }
 
-        tensorFieldOut_->addMetaData<IsotropicScaling>(isotropicScaling,
-                                                       TensorFeature::IsotropicScaling);
-    }
-    if (rotation_.get() && !tensorFieldOut_->hasMetaData<Rotation>()) {
-        std::vector<double> rotation;
-
-        rotation.resize(tensors.size(), 0.0);
-
-        tensorFieldOut_->addMetaData<Rotation>(rotation, TensorFeature::Rotation);
-    }
-    if (frobeniusNorm_.get() && !tensorFieldOut_->hasMetaData<FrobeniusNorm>()) {
-        std::vector<double> frobeniusNorm;
-
-        const auto& majorEigenValues = tensorFieldOut_->getMetaData<MajorEigenValues>();
-        const auto& intermediateEigenValues =
-            tensorFieldOut_->getMetaData<IntermediateEigenValues>();
-        const auto& minorEigenValues = tensorFieldOut_->getMetaData<MinorEigenValues>();
-
-        for (size_t i = 0; i < majorEigenValues.size(); i++) {
-            auto eigenValues = std::array<double, 3>{
-                majorEigenValues[i], intermediateEigenValues[i], minorEigenValues[i]};
-            frobeniusNorm.emplace_back(::sqrt(
-                std::accumulate(eigenValues.begin(), eigenValues.end(), 0.,
-                                [](const double& a, const double& b) { return a + (b * b); })));
+        if (progress) {
+            std::scoped_lock lock{progressMutex};
+            progress(static_cast<float>(++slicesDone) / static_cast<float>(dims.z));
         }
+    };
+    if (!util::forEachRangeParallel(dims.z, 1, slice, stop)) return std::nullopt;
 
-        tensorFieldOut_->addMetaData<FrobeniusNorm>(frobeniusNorm, TensorFeature::FrobeniusNorm);
-    }
+    return results;
 }
 
-void TensorField3DMetaData::removeMetaData() {
-    if (!i1_.get()) {
-        tensorFieldOut_->removeMetaData<I1>();
-    }
-    if (!i2_.get()) {
-        tensorFieldOut_->removeMetaData<I2>();
-    }
-    if (!i3_.get()) {
-        tensorFieldOut_->removeMetaData<I3>();
-    }
-    if (!j1_.get()) {
-        tensorFieldOut_->removeMetaData<J1>();
-    }
-    if (!j2_.get()) {
-        tensorFieldOut_->removeMetaData<J2>();
-    }
-    if (!j3_.get()) {
-        tensorFieldOut_->removeMetaData<J3>();
-    }
-    if (!lodeAngle_.get()) {
-        tensorFieldOut_->removeMetaData<LodeAngle>();
-    }
-    if (!anisotropy_.get()) {
-        tensorFieldOut_->removeMetaData<Anisotropy>();
-    }
-    if (!linearAnisotropy_.get()) {
-        tensorFieldOut_->removeMetaData<LinearAnisotropy>();
-    }
-    if (!planarAnisotropy_.get()) {
-        tensorFieldOut_->removeMetaData<PlanarAnisotropy>();
-    }
-    if (!sphericalAnisotropy_.get()) {
-        tensorFieldOut_->removeMetaData<SphericalAnisotropy>();
-    }
-    if (!diffusivity_.get()) {
-        tensorFieldOut_->removeMetaData<Diffusivity>();
-    }
-    if (!shearStress_.get()) {
-        tensorFieldOut_->removeMetaData<ShearStress>();
-    }
-    if (!pureShear_.get()) {
-        tensorFieldOut_->removeMetaData<PureShear>();
-    }
-    if (!shapeFactor_.get()) {
-        tensorFieldOut_->removeMetaData<ShapeFactor>();
-    }
-    if (!isotropicScaling_.get()) {
-        tensorFieldOut_->removeMetaData<IsotropicScaling>();
-    }
-    if (!rotation_.get()) {
-        tensorFieldOut_->removeMetaData<Rotation>();
-    }
-    if (!frobeniusNorm_.get()) {
-        tensorFieldOut_->removeMetaData<FrobeniusNorm>();
+std::vector<uint64_t> TensorField3DMetaData::deselectedFeatures() const {
+    std::vector<uint64_t> ids;
+    for (const auto& info : features()) {
+        if (!info.property->get()) ids.push_back(info.id);
     }
+    return ids;
 }
 
 void TensorField3DMetaData::selectAll() {
@@ -528,11 +516,47 @@ void TensorField3DMetaData::deselectAll() {
 void TensorField3DMetaData::process() {
     if (!tensorFieldOut_) return;
 
-    addMetaData();
+    const auto deselected = deselectedFeatures();
+
+    // The compute shader needs the OpenGL context and runs synchronously
+    if (backend_.get() == Backend::GPU) {
+        // A CPU job may still read the current output
+        tensorFieldOut_ = std::shared_ptr<TensorField3D>(tensorFieldOut_->clone());
+        if (addMetaDataGPU()) {
+            for (const auto id : deselected) tensorFieldOut_->removeMetaData(id);
+            outport_.setData(tensorFieldOut_);
+            return;
+        }
+    }
+
+    std::array<int, numFeatures> outputSlot;
+    const auto numRequested = requestedFeatures(outputSlot);
+
+    using Result = std::shared_ptr<TensorField3D>;
+    auto compute = [tensorField = std::shared_ptr<const TensorField3D>(tensorFieldOut_),
+                    featureInfo = features(), outputSlot, numRequested,
+                    deselected](pool::Stop stop, pool::Progress progress) -> Result {
+        auto results = computeFeatures(
+            *tensorField, outputSlot, numRequested, [&stop]() { return stop(); },
+            [&progress](float f) { progress(f); });
+        if (!results) return nullptr;
+
+        // Features are added to a copy, the current output may still be in use downstream
+        auto result = std::shared_ptr<TensorField3D>(tensorField->clone());
+        for (size_t f = 0; f < numFeatures; ++f) {
+            if (outputSlot[f] < 0) continue;
+            featureInfo[f].add(*result, std::move((*results)[outputSlot[f]]));
+        }
+        for (const auto id : deselected) result->removeMetaData(id);
 
-    removeMetaData();
+        return result;
+    };
 
-    outport_.setData(tensorFieldOut_);
+    dispatchOne(compute, [this](Result result) {
+        tensorFieldOut_ = result;
+        outport_.setData(result);
+        newResults();
+    });
 }
 
 }  // namespace inviwo
@@ -0,0 +1,96 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/processors/tensorfield3dsequenceselector.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo TensorField3DSequenceSelector::processorInfo_{
+    "org.inviwo.TensorField3DSequenceSelector",  // Class identifier
+    "Tensor Field 3D Sequence Selector",          // Display name
+    "Tensor",                                     // Category
+    CodeState::Experimental,                      // Code state
+    Tags::CPU,                                    // Tags
+};
+const ProcessorInfo TensorField3DSequenceSelector::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+TensorField3DSequenceSelector::TensorField3DSequenceSelector()
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , timeStep_("timeStep", "Time step", 1, 1, 1)
+    , waitForTimeStep_("waitForTimeStep", "Wait for time step", false) {
+    addPort(inport_);
+    addPort(outport_);
+
+    addProperties(timeStep_, waitForTimeStep_);
+
+    inport_.onChange([this]() {
+        onLoaded_.reset();
+        pending_ = std::numeric_limits<size_t>::max();
+        if (!inport_.hasData()) return;
+
+        const auto sequence = inport_.getData();
+        timeStep_.setMaxValue(std::max<size_t>(sequence->size(), 1));
+
+        onLoaded_ = sequence->onLoaded([this](size_t step) {
+            if (step == pending_) {
+                dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+            }
+        });
+    });
+}
+
+void TensorField3DSequenceSelector::process() {
+    const auto sequence = inport_.getData();
+    if (sequence->size() == 0) {
+        outport_.clear();
+        return;
+    }
+
+    const auto step = std::min(timeStep_.get(), sequence->size()) - 1;
+    if (waitForTimeStep_) {
+        pending_ = std::numeric_limits<size_t>::max();
+        outport_.setData(sequence->get(step));
+        return;
+    }
+
+    // Set before checking, a step loaded in between still invalidates the processor
+    pending_ = step;
+    if (auto tensorField = sequence->tryGet(step)) {
+        pending_ = std::numeric_limits<size_t>::max();
+        outport_.setData(tensorField);
+    }
+}
+
+}  // namespace inviwo
@@ -43,67 +43,57 @@ const ProcessorInfo TensorField3DSubsample::processorInfo_{
 const ProcessorInfo TensorField3DSubsample::getProcessorInfo() const { return processorInfo_; }
 
 TensorField3DSubsample::TensorField3DSubsample()
-    : Processor()
+    : PoolProcessor()
     , inport_("inport")
     , outport_("outport")
     , resolutionMultiplier_("resolutionMultiplier", "Resolution multiplier", 1.0f, 0.1f, 10.0f,
-                            0.1f, InvalidationLevel::Valid)
+                            0.1f)
     , interpolationMethod_(
           "interpolationMethod", "Interpolation method",
           {{"linear", "Linear", tensorutil::InterpolationMethod::Linear},
            {"nearest", "Nearest neighbour", tensorutil::InterpolationMethod::Nearest}},
-          0, InvalidationLevel::Valid)
-    , tf_(nullptr) {
+          0)
+    , averageBlocks_("averageBlocks", "Average blocks when downsampling", false)
+    , averaging_("averaging", "Averaging",
+                 {{"logEuclidean", "Log-Euclidean", tensorutil::Averaging::LogEuclidean},
+                  {"linear", "Linear", tensorutil::Averaging::Linear}},
+                 0) {
     addPort(inport_);
     addPort(outport_);
 
     addProperty(resolutionMultiplier_);
 
     addProperty(interpolationMethod_);
-
-    inport_.onChange([this]() { subsample(); });
-    resolutionMultiplier_.onChange([this]() { subsample(); });
-    interpolationMethod_.onChange([this]() { subsample(); });
+    addProperty(averageBlocks_);
+    addProperty(averaging_);
+    averaging_.visibilityDependsOn(averageBlocks_, [](const auto& p) { return p.get(); });
 }
 
-void TensorField3DSubsample::initializeResources() {}
-
 void TensorField3DSubsample::process() {
-    if (tf_) outport_.setData(tf_);
-}
-
-void TensorField3DSubsample::subsample() {
-    if (inport_.hasData()) {
-        if (!isRunning_) {
-            dispatchPool([this, &bar = progressBar_]() {
-                auto on_progress = [&bar](float progress) { bar.updateProgress(progress); };
-                isRunning_ = true;
-
-                const auto resolutionMultiplier = resolutionMultiplier_.get();
-                const auto interpolationMethod = interpolationMethod_.get();
-
-                do {
-                    bar.show();
-                    bar.updateProgress(0.f);
-
-                    tf_ = tensorutil::subsample3D(
-                        inport_.getData(),
-                        size3_t(glm::round(vec3(inport_.getData()->getDimensions()) *
-                                           resolutionMultiplier)),
-                        interpolationMethod, on_progress);
-
-                    on_progress(1.f);
-
-                    bar.hide();
-                } while (resolutionMultiplier != resolutionMultiplier_.get() ||
-                         interpolationMethod != interpolationMethod_.get());
-
-                dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
-
-                isRunning_ = false;
-            });
+    using Result = std::shared_ptr<TensorField3D>;
+    auto compute = [tensorField = inport_.getData(),
+                    resolutionMultiplier = resolutionMultiplier_.get(),
+                    interpolationMethod = interpolationMethod_.get(),
+                    averageBlocks = averageBlocks_.get(),
+                    averaging = averaging_.get()](pool::Stop stop,
+                                                  pool::Progress progress) -> Result {
+        const auto newDimensions =
+            size3_t(glm::round(vec3(tensorField->getDimensions()) * resolutionMultiplier));
+        const auto onProgress = [&progress](float f) { progress(f); };
+        const auto stopped = [&stop]() { return stop(); };
+
+        if (averageBlocks && resolutionMultiplier < 1.0f) {
+            return tensorutil::downsample3D(tensorField, newDimensions, averaging, onProgress,
+                                            stopped);
         }
-    }
+        return tensorutil::subsample3D(tensorField, newDimensions, interpolationMethod,
+                                       onProgress, stopped);
+    };
+
+    dispatchOne(compute, [this](Result result) {
+        outport_.setData(result);
+        newResults();
+    });
 }
 
 }  // namespace inviwo
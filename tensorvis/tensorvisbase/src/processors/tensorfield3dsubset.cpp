@@ -104,6 +104,23 @@ void TensorField3DSubset::process() {
         std::make_shared<TensorField3D>(dimensions, rawData, spacing * vec3(dimensions));
     outField->setOffset(tensorField->getOffset() + vec3(origin_.get()) * spacing);
 
+    // Copy the mask row by row, whole words at a time
+    if (tensorField->hasMask()) {
+        const auto& mask = tensorField->getMask();
+        const auto inDims = tensorField->getDimensions();
+        const size3_t origin{origin_.get()};
+        BitMask subsetMask(dimensions.x * dimensions.y * dimensions.z);
+        for (size_t z = 0; z < dimensions.z; ++z) {
+            for (size_t y = 0; y < dimensions.y; ++y) {
+                const auto src =
+                    origin.x + inDims.x * (origin.y + y + inDims.y * (origin.z + z));
+                subsetMask.copyBits(mask, src, dimensions.x * (y + dimensions.y * z),
+                                    dimensions.x);
+            }
+        }
+        outField->setMask(std::move(subsetMask));
+    }
+
     outport_.setData(outField);
 }
 
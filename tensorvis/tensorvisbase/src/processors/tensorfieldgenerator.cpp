@@ -28,6 +28,9 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisbase/processors/tensorfieldgenerator.h>
+#include <inviwo/tensorvisbase/algorithm/tensorfieldgeneration.h>
+
+#include <limits>
 
 namespace inviwo {
 
@@ -111,7 +114,19 @@ TensorFieldGenerator::TensorFieldGenerator()
                         inc)
     , collectionRow5T5_("collectionRow5T5_", "T5", dmat2(dvec2(14, 6.4), dvec2(6.4, 14)), min, max,
                         inc)
-    , outport2D_("outport2d") {
+    , outport2D_("outport2d")
+    , field3D_("field3D", "Synthetic 3D field")
+    , dimensions3D_("dimensions3D", "Dimensions", size3_t(64), size3_t(1), size3_t(2048))
+    , seed_("seed", "Seed", 0, 0, std::numeric_limits<int>::max())
+    , noise_("noise", "Noise", 0.0, 0.0, 0.9)
+    , storage_("storage", "Storage",
+               {{"symmetric", "Symmetric", TensorStorage::Symmetric},
+                {"symmetricFloat", "Symmetric float", TensorStorage::SymmetricFloat},
+                {"full", "Full", TensorStorage::Full},
+                {"fullFloat", "Full float", TensorStorage::FullFloat}},
+               0)
+    , eigenSystem_("eigenSystem", "Analytical eigen system", true)
+    , outport3D_("outport3d") {
 
     tensors_.addProperties(T12D_, T22D_, T32D_, T42D_);
 
@@ -129,12 +144,29 @@ TensorFieldGenerator::TensorFieldGenerator()
     collectionField_.addProperties(collectionRow1_, collectionRow2_, collectionRow3_,
                                    collectionRow4_, collectionRow5_);
 
-    addProperties(singularityPresets_, tensors_, collectionField_);
+    field3D_.addProperties(dimensions3D_, seed_, noise_, storage_, eigenSystem_);
+
+    addProperties(singularityPresets_, tensors_, collectionField_, field3D_);
 
     addPort(outport2D_);
+    addPort(outport3D_);
+}
+
+void TensorFieldGenerator::process() {
+    generate2DField();
+    if (outport3D_.isConnected()) generate3DField();
 }
 
-void TensorFieldGenerator::process() { generate2DField(); }
+void TensorFieldGenerator::generate3DField() {
+    tensorutil::SyntheticTensorField3D settings;
+    settings.dimensions = dimensions3D_.get();
+    settings.seed = static_cast<uint64_t>(seed_.get());
+    settings.noise = noise_.get();
+    settings.storage = storage_.get();
+    settings.eigenSystem = eigenSystem_.get();
+
+    outport3D_.setData(tensorutil::generateTensorField3D(settings));
+}
 
 void TensorFieldGenerator::generate2DField() {
     std::vector<dmat2> rawData;
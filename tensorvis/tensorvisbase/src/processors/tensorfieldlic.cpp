@@ -28,10 +28,25 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisbase/processors/tensorfieldlic.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <algorithm>
 
 namespace inviwo {
 
+namespace {
+
+float halton(int index, int base) {
+    float result = 0.0f;
+    float f = 1.0f;
+    for (; index > 0; index /= base) {
+        f /= static_cast<float>(base);
+        result += f * static_cast<float>(index % base);
+    }
+    return result;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo TensorFieldLIC::processorInfo_{
     "org.inviwo.TensorFieldLIC",  // Class identifier
@@ -57,6 +72,10 @@ TensorFieldLIC::TensorFieldLIC()
     , majorMinor_("useMinor", "Use minor eigenvectors", false)
     , backgroundColor_("backgroundColor", "Background color", vec4(1.0f), vec4(0.0f), vec4(1.0f),
                        vec4(0.01f), InvalidationLevel::InvalidOutput, PropertySemantics::Color)
+    , adaptiveKernel_("adaptiveKernel", "Adaptive kernel length", false)
+    , minKernelLength_("minKernelLength", "Min kernel length", 0.25f, 0.0f, 1.0f, 0.01f)
+    , progressive_("progressive", "Progressive refinement", false)
+    , progressiveFrames_("progressiveFrames", "Accumulated frames", 16, 1, 256)
     , shader_("tensorlic2d.frag") {
     imageInport_.setOptional(true);
 
@@ -67,6 +86,10 @@ TensorFieldLIC::TensorFieldLIC()
     addProperty(useRK4_);
     addProperty(majorMinor_);
     addProperty(backgroundColor_);
+    addProperty(adaptiveKernel_);
+    addProperty(minKernelLength_);
+    addProperty(progressive_);
+    addProperty(progressiveFrames_);
 
     shader_.onReload([&]() { invalidate(InvalidationLevel::InvalidOutput); });
 
@@ -77,11 +100,22 @@ TensorFieldLIC::TensorFieldLIC()
 
     inport_.onChange([&]() { invalidate(InvalidationLevel::InvalidResources); });
     majorMinor_.onChange([&]() { invalidate(InvalidationLevel::InvalidResources); });
+
+    // Any change restarts the accumulation of progressive frames
+    for (auto property : getProperties()) {
+        property->onChange([this]() { frame_ = 0; });
+    }
+    for (auto port : getInports()) {
+        port->onChange([this]() { frame_ = 0; });
+    }
 }
 
 void TensorFieldLIC::initializeResources() {
+    tensorFieldTexture_.reset();
+    frame_ = 0;
     if (!inport_.hasData() || !inport_.getData().get()) return;
 
+    tensorFieldTexture_ = inport_.getData()->getImageRepresentation();
     updateEigenValues();
 }
 
@@ -118,10 +152,8 @@ void TensorFieldLIC::process() {
 
     shader_.activate();
     TextureUnitContainer units;
-    std::shared_ptr<Image> tensorFieldTexture;
     // add tensorfield to texture unit container
-    tensorutil::bindTensorFieldAsColorTexture(tensorFieldTexture, inport_.getData(), shader_,
-                                              units);
+    tensorutil::bindTensorFieldAsColorTexture(*tensorFieldTexture_, shader_, units);
     // add noise texture to texture unit container
     utilgl::bindAndSetUniforms(shader_, units, noiseTexture_, ImageType::ColorOnly);
 
@@ -131,12 +163,23 @@ void TensorFieldLIC::process() {
         utilgl::bindAndSetUniforms(shader_, units, imageInport_, ImageType::ColorOnly);
     }
 
-    // Create a subsampled tensorfield to find possible deviations from the initial min/max values
-    // for eigenvalues
-    updateEigenValues();
+    if (!progressive_ || !previousFrame_ ||
+        previousFrame_->getDimensions() != outport_.getDimensions()) {
+        frame_ = 0;
+    }
+    if (frame_ > 0) {
+        utilgl::bindAndSetUniforms(shader_, units, *previousFrame_, "previousFrame",
+                                   ImageType::ColorOnly);
+    }
+    // Jitter the noise lookup within one noise texel for every accumulated frame
+    const auto jitter = progressive_ ? vec2(halton(frame_ + 1, 2), halton(frame_ + 1, 3)) - 0.5f
+                                     : vec2(0.0f);
+    shader_.setUniform("frame", frame_);
+    shader_.setUniform("jitter", jitter / vec2(noiseTexture_.getData()->getDimensions()));
 
     utilgl::setUniforms(shader_, outport_, samples_, stepLength_, normalizeVectors_,
-                        intensityMapping_, useRK4_, majorMinor_, backgroundColor_);
+                        intensityMapping_, useRK4_, majorMinor_, backgroundColor_,
+                        adaptiveKernel_, minKernelLength_);
     shader_.setUniform("minEigenValue", minVal_);
     shader_.setUniform("maxEigenValue", maxVal_);
     shader_.setUniform("eigenValueRange", eigenValueRange_);
@@ -151,6 +194,20 @@ void TensorFieldLIC::process() {
     utilgl::singleDrawImagePlaneRect();
     shader_.deactivate();
     utilgl::deactivateCurrentTarget();
+
+    if (progressive_) {
+        if (!previousFrame_ || previousFrame_->getDimensions() != outport_.getDimensions()) {
+            previousFrame_ = std::make_unique<Image>(outport_.getDimensions(),
+                                                     outport_.getData()->getDataFormat());
+        }
+        outport_.getData()->copyRepresentationsTo(previousFrame_.get());
+
+        if (++frame_ < progressiveFrames_) {
+            dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
+        }
+    } else {
+        previousFrame_.reset();
+    }
 }
 
 }  // namespace inviwo
@@ -80,6 +80,7 @@ TensorFieldSlice::TensorFieldSlice()
     addProperty(planeColor_);
 
     inport_.onChange([&]() {
+        sliceCache_.clear();
         if (!inport_.hasData() || !inport_.getData().get()) return;
 
         size_t numSlices{0};
@@ -162,8 +163,8 @@ void TensorFieldSlice::process() {
     auto offset = offsetDimensions.x * offsetDimensions.y * (sliceNr_.get());
     offsetOutport_.setData(std::make_shared<unsigned int>(static_cast<unsigned int>(offset)));
 
-    outport2D_.setData(slice<2>(inport_.getData(), sliceAlongAxis_.get(), sliceNr_.get()));
-    outport3D_.setData(slice<3>(inport_.getData(), sliceAlongAxis_.get(), sliceNr_.get()));
+    outport2D_.setData(sliceCache_.slice2D(tensorField, sliceAlongAxis_.get(), sliceNr_.get()));
+    outport3D_.setData(sliceCache_.slice3D(tensorField, sliceAlongAxis_.get(), sliceNr_.get()));
     sliceOutport_.setData(tensorutil::generateSliceLevelGeometryForTensorField(
         inport_.getData(), sliceColor_.get(), sliceAlongAxis_.get(), sliceNr_.get()));
     planeOutport_.setData(tensorutil::generateSlicePlaneGeometryForTensorField(
@@ -66,7 +66,7 @@ void TensorFieldToRGBA::process() {
 
     shader_.activate();
     TextureUnitContainer units;
-    std::shared_ptr<Image> tensorFieldTexture;
+    std::shared_ptr<const Image> tensorFieldTexture;
     tensorutil::bindTensorFieldAsColorTexture(tensorFieldTexture, inport_.getData(), shader_,
                                               units);
 
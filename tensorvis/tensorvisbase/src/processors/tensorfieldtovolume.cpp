@@ -34,9 +34,39 @@
 #include <inviwo/core/util/volumeramutils.h>
 #include <modules/base/algorithm/dataminmax.h>
 #include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <modules/opengl/inviwoopengl.h>
+#include <modules/opengl/texture/texture3d.h>
+#include <modules/opengl/volume/volumegl.h>
+
+#include <mutex>
 
 namespace inviwo {
 
+namespace {
+// Combined range of the components, up to the first component that is zero everywhere
+DataMapper featureDataMap(const dvec4& minValues, const dvec4& maxValues) {
+    DataMapper datamap;
+
+    double max = std::numeric_limits<float>::lowest();
+    double min = std::numeric_limits<float>::max();
+    for (glm::length_t i = 0; i < 4; ++i) {
+        if ((minValues[i] == maxValues[i]) && (minValues[i] == 0.0)) {
+            break;
+        }
+        max = std::max(max, maxValues[i]);
+        min = std::min(min, minValues[i]);
+    }
+
+    datamap.dataRange = dvec2{min, max};
+    datamap.valueRange = dvec2{min, max};
+    return datamap;
+}
+
+// Upper bound of the size of one brick streamed to the GPU
+constexpr size_t brickBytes = 16 * 1024 * 1024;
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo TensorFieldToVolume::processorInfo_{
     "org.inviwo.TensorFieldToVolume",  // Class identifier
@@ -60,12 +90,14 @@ TensorFieldToVolume::TensorFieldToVolume()
                 {"intermediateEigenValue", "Intermediate eigenvalue", TensorFeature::Sigma2},
                 {"minorEigenValue", "Minor eigenvalue", TensorFeature::Sigma3},
                 {"hill", "Hill", TensorFeature::HillYieldCriterion}})
-    , normalizeVectors_("normalize", "Normalize eigenvectors") {
+    , normalizeVectors_("normalize", "Normalize eigenvectors")
+    , directUpload_("directUpload", "Upload directly to GPU", false) {
     addPort(inport_);
     addPort(outport_);
 
     addProperty(feature_);
     addProperty(normalizeVectors_);
+    addProperty(directUpload_);
 
     /*feature_.onChange([this]() {
         if (feature_.get() > 2)
@@ -90,6 +122,15 @@ void TensorFieldToVolume::process() {
     const auto metaData = tensorField->getMetaDataContainer(uint64_t(feature_.get()));
     const auto numberOfComponents = metaData->getNumberOfComponents();
 
+    if (directUpload_.get()) {
+        DataMapper map;
+        auto vol = uploadToGL(*metaData, tensorField->getDimensions(), map);
+        vol->setModelMatrix(tensorField->getBasisAndOffset());
+        vol->dataMap_ = map;
+        outport_.setData(vol);
+        return;
+    }
+
     auto vol =
         std::make_shared<Volume>(tensorField->getDimensions(),
                                  DataFormatBase::get(NumericType::Float, numberOfComponents, 32));
@@ -110,22 +151,7 @@ void TensorFieldToVolume::process() {
 #include <warn/pop>
 
                 const auto minmax = util::dataMinMax(srcData, glm::compMul(repr->getDimensions()));
-
-                DataMapper datamap;
-
-                double max = std::numeric_limits<float>::lowest();
-                double min = std::numeric_limits<float>::max();
-                for (size_t i = 0; i < 4; ++i) {
-                    if ((minmax.first[i] == minmax.second[i]) && (minmax.first[i] == 0.0)) {
-                        break;
-                    }
-                    max = std::max(max, minmax.second[i]);
-                    min = std::min(min, minmax.first[i]);
-                }
-
-                datamap.dataRange = dvec2{min, max};
-                datamap.valueRange = dvec2{min, max};
-                return datamap;
+                return featureDataMap(minmax.first, minmax.second);
             });
 
     vol->setModelMatrix(tensorField->getBasisAndOffset());
@@ -133,4 +159,81 @@ void TensorFieldToVolume::process() {
     outport_.setData(vol);
 }
 
+std::shared_ptr<Volume> TensorFieldToVolume::uploadToGL(const MetaDataBase& metaData,
+                                                        const size3_t& dimensions,
+                                                        DataMapper& dataMap) const {
+    const auto numberOfComponents = metaData.getNumberOfComponents();
+    auto volumeGL = std::make_shared<VolumeGL>(
+        dimensions, DataFormatBase::get(NumericType::Float, numberOfComponents, 32));
+    auto texture = volumeGL->getTexture();
+
+    // Meta data is stored as doubles, interleaved for vector valued features
+    const auto srcData = static_cast<const double*>(metaData.getDataPtr());
+    const auto sliceValues = dimensions.x * dimensions.y * numberOfComponents;
+    const auto slicesPerBrick =
+        std::clamp<size_t>(brickBytes / (sliceValues * sizeof(float)), 1, dimensions.z);
+
+    // Two pixel buffers, one is filled while the upload from the other one is in flight
+    std::array<GLuint, 2> pixelBuffers{};
+    glGenBuffers(2, pixelBuffers.data());
+    for (const auto buffer : pixelBuffers) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, slicesPerBrick * sliceValues * sizeof(float),
+                     nullptr, GL_STREAM_DRAW);
+    }
+
+    dvec4 minValues{std::numeric_limits<double>::max()};
+    dvec4 maxValues{std::numeric_limits<double>::lowest()};
+    for (size_t c = numberOfComponents; c < 4; ++c) {
+        minValues[static_cast<glm::length_t>(c)] = maxValues[static_cast<glm::length_t>(c)] = 0.0;
+    }
+    const auto initialMin = minValues;
+    const auto initialMax = maxValues;
+    std::mutex rangeMutex;
+
+    texture->bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    size_t brick = 0;
+    for (size_t z = 0; z < dimensions.z; z += slicesPerBrick, ++brick) {
+        const auto numSlices = std::min(slicesPerBrick, dimensions.z - z);
+        const auto numValues = numSlices * sliceValues;
+        const auto src = srcData + z * sliceValues;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[brick % 2]);
+        auto dst = static_cast<float*>(
+            glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, numValues * sizeof(float),
+                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+        // Ranges are multiples of the number of components to keep track of the component ranges
+        const auto grainSize = util::defaultGrainSize(numValues) / numberOfComponents *
+                               numberOfComponents;
+        util::forEachRangeParallel(
+            numValues, std::max(grainSize, numberOfComponents), [&](size_t begin, size_t end) {
+                auto localMin = initialMin;
+                auto localMax = initialMax;
+                for (size_t i = begin; i < end; ++i) {
+                    const auto c = static_cast<glm::length_t>(i % numberOfComponents);
+                    localMin[c] = std::min(localMin[c], src[i]);
+                    localMax[c] = std::max(localMax[c], src[i]);
+                    dst[i] = static_cast<float>(src[i]);
+                }
+                std::scoped_lock lock{rangeMutex};
+                minValues = glm::min(minValues, localMin);
+                maxValues = glm::max(maxValues, localMax);
+            });
+
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, static_cast<GLint>(z),
+                        static_cast<GLsizei>(dimensions.x), static_cast<GLsizei>(dimensions.y),
+                        static_cast<GLsizei>(numSlices), texture->getFormat(),
+                        texture->getDataType(), nullptr);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    texture->unbind();
+    glDeleteBuffers(2, pixelBuffers.data());
+
+    dataMap = featureDataMap(minValues, maxValues);
+    return std::make_shared<Volume>(volumeGL);
+}
+
 }  // namespace inviwo
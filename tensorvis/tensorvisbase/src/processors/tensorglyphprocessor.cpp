@@ -44,51 +44,79 @@ const ProcessorInfo TensorGlyphProcessor::processorInfo_{
 const ProcessorInfo TensorGlyphProcessor::getProcessorInfo() const { return processorInfo_; }
 
 TensorGlyphProcessor::TensorGlyphProcessor()
-    : Processor()
+    : PoolProcessor()
     , inport_("inport")
     , outport_("outport")
     , glyphParameters_("glyphParameters", "Glyph parameters")
-
-{
+    , mergeGlyphs_("mergeGlyphs", "Merge into one mesh", false) {
     addPort(outport_);
     addPort(inport_);
 
     addProperty(glyphParameters_);
+    addProperty(mergeGlyphs_);
 }
 
 void TensorGlyphProcessor::process() {
     if (!inport_.hasData() || !inport_.getData().get()) return;
 
-    auto tensorField = inport_.getData();
-
-    auto dimensions = tensorField->getDimensions();
-
-    util::IndexMapper3D indexMapper(dimensions);
-
-    auto comp = glm::zero<dmat3>();
-
-    auto meshes = new std::vector<std::shared_ptr<Mesh>>();
-
-    const vec3 voxelDist{tensorField->getSpacing()};
-    const vec3 offset{tensorField->getOffset()};
-
-    for (size_t z = 0; z < dimensions.z; z++) {
-        for (size_t y = 0; y < dimensions.y; y++) {
-            for (size_t x = 0; x < dimensions.x; x++) {
-                const auto& tensor = tensorField->at(size3_t(x, y, z)).second;
-                if (tensor == comp) continue;
-                const auto index = indexMapper(size3_t(x, y, z));
-
-                // const auto dpos = tensorField->getNormalizedVolumePosition(index);
-                // const auto pos = vec3(dpos);
+    // The job works on a copy of the glyph settings, they may change while it runs
+    std::shared_ptr<TensorGlyphProperty> glyphParameters(glyphParameters_.clone());
+    const bool merge = mergeGlyphs_.get() && glyphParameters->supportsInstancing();
+
+    using Result = std::shared_ptr<std::vector<std::shared_ptr<Mesh>>>;
+    auto compute = [tensorField = inport_.getData(), glyphParameters, merge](
+                       pool::Stop stop, pool::Progress progress) -> Result {
+        auto dimensions = tensorField->getDimensions();
+
+        auto comp = glm::zero<dmat3>();
+
+        auto meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>();
+
+        const vec3 voxelDist{tensorField->getSpacing()};
+        const vec3 offset{tensorField->getOffset()};
+
+        std::vector<size_t> indices;
+        std::vector<dvec3> positions;
+
+        // Only the defined voxels are visited for masked fields
+        const auto total = tensorField->hasMask() ? tensorField->definedIndices().size()
+                                                  : tensorField->getSize();
+        size_t visited = 0;
+        bool stopped = false;
+        tensorField->forEachDefinedTensor([&](size_t index, const dmat3& tensor) {
+            if (stopped) return;
+            if (++visited % 4096 == 0) {
+                if (stop()) {
+                    stopped = true;
+                    return;
+                }
+                progress(visited, total);
+            }
+            if (tensor == comp) return;
 
-                const vec3 pos{voxelDist * vec3{x, y, z} + offset};
+            const size3_t voxel{index % dimensions.x, (index / dimensions.x) % dimensions.y,
+                                index / (dimensions.x * dimensions.y)};
+            const vec3 pos{voxelDist * vec3{voxel} + offset};
 
-                meshes->emplace_back(glyphParameters_.generateGlyph(tensorField, index, pos));
+            if (merge) {
+                indices.push_back(index);
+                positions.emplace_back(pos);
+            } else {
+                meshes->emplace_back(glyphParameters->generateGlyph(tensorField, index, pos));
             }
+        });
+        if (stopped) return nullptr;
+
+        if (merge && !indices.empty()) {
+            meshes->emplace_back(glyphParameters->generateGlyphs(*tensorField, indices, positions));
         }
-    }
 
-    outport_.setData(meshes);
+        return meshes;
+    };
+
+    dispatchOne(compute, [this](Result result) {
+        outport_.setData(result);
+        newResults();
+    });
 }
 }  // namespace inviwo
@@ -33,6 +33,18 @@
 #include <inviwo/core/interaction/events/mouseevent.h>
 #include <inviwo/core/rendering/meshdrawerfactory.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/geometry/meshgl.h>
+#include <modules/opengl/rendering/meshdrawergl.h>
+#include <modules/opengl/texture/textureunit.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace inviwo {
 
@@ -54,6 +66,7 @@ TensorGlyphRenderer::TensorGlyphRenderer()
     , imageInport_("imageInport")
     , selectedMeshOutport_("selectedMeshOutport")
     , indexOutport_("indexOutport")
+    , selectedIndicesOutport_("selectedIndicesOutport")
     , outport_("outport")
     , camera_("camera", "Camera")
     , trackball_(&camera_)
@@ -70,8 +83,26 @@ TensorGlyphRenderer::TensorGlyphRenderer()
     , selectedID_(-1)
     , previouslySelectedID_(-1)
     , selectMode_("selectMode", "Select mode", true)
-    , glyphType_("glyphType", "Glyph type") {
+    , outputSelectedMesh_("outputSelectedMesh", "Output selected mesh", true)
+    , glyphType_("glyphType", "Glyph type")
+    , renderMode_("renderMode", "Render mode",
+                  {{"meshes", "Glyph meshes", RenderMode::Meshes},
+                   {"instanced", "Instanced", RenderMode::Instanced},
+                   {"impostors", "Superquadric impostors", RenderMode::Impostors}},
+                  0)
+    , instancedShader_("tensorglyphinstanced.vert", "tensorglyphpicking.frag", Shader::Build::No)
+    , impostorShader_({{ShaderType::Vertex, "superquadricglyph.vert"},
+                       {ShaderType::Geometry, "superquadric.geom"},
+                       {ShaderType::Fragment, "superquadricglyph.frag"}},
+                      Shader::Build::No)
+    , lod_("lod", "Culling and Level of Detail")
+    , cullGlyphs_("cullGlyphs", "Cull glyphs", true)
+    , minPixelSize_("minPixelSize", "Min size (px)", 1.0f, 0.0f, 20.0f, 0.1f)
+    , fullDetailSize_("fullDetailSize", "Full detail size (px)", 64.0f, 1.0f, 1024.0f, 1.0f)
+    , lodLevels_("lodLevels", "Detail levels", 3, 1, maxLodLevels)
+    , cullingShader_({{ShaderType::Compute, "tensorglyphculling.comp"}}, Shader::Build::No) {
     addPort(meshInport_);
+    meshInport_.setOptional(true);
     addPort(tensorFieldInport_);
     offsetInport_.setOptional(true);
     addPort(offsetInport_);
@@ -80,9 +111,14 @@ TensorGlyphRenderer::TensorGlyphRenderer()
     addPort(outport_);
     addPort(selectedMeshOutport_);
     addPort(indexOutport_);
+    addPort(selectedIndicesOutport_);
 
     addProperty(selectMode_);
+    addProperty(outputSelectedMesh_);
     addProperty(glyphType_);
+    addProperty(renderMode_);
+    lod_.addProperties(cullGlyphs_, minPixelSize_, fullDetailSize_, lodLevels_);
+    addProperty(lod_);
 
     addProperty(camera_);
     addProperty(trackball_);
@@ -90,9 +126,22 @@ TensorGlyphRenderer::TensorGlyphRenderer()
     addProperty(cullFace_);
 
     shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+    instancedShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+    impostorShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+    cullingShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+
+    tensorFieldInport_.onChange([this]() { instancesDirty_ = true; });
+    glyphType_.onChange([this]() { instancesDirty_ = true; });
+    renderMode_.onChange([this]() {
+        instancesDirty_ = true;
+        if (renderMode_.get() == RenderMode::Meshes && meshInport_.hasData()) {
+            picking_.resize(meshInport_.getData()->size());
+        }
+    });
 
     meshInport_.onChange([&]() {
         meshDrawers_.clear();
+        if (!meshInport_.hasData()) return;
 
         for (const auto& mesh : *meshInport_.getData()) {
             meshDrawers_.emplace_back(
@@ -108,9 +157,294 @@ TensorGlyphRenderer::TensorGlyphRenderer()
     selectedIDProperty_.setReadOnly(false);
 }
 
-void TensorGlyphRenderer::initializeResources() { addCommonShaderDefines(shader_); }
+void TensorGlyphRenderer::initializeResources() {
+    addCommonShaderDefines(shader_);
+
+    instancedShader_.getFragmentShaderObject()->addShaderDefine("INSTANCED_GLYPHS");
+    addCommonShaderDefines(instancedShader_);
+
+    addCommonShaderDefines(impostorShader_);
+
+    cullingShader_.build();
+}
+
+TensorGlyphRenderer::RenderMode TensorGlyphRenderer::activeRenderMode() const {
+    if (!tensorFieldInport_.hasData()) return RenderMode::Meshes;
+
+    switch (renderMode_.get()) {
+        case RenderMode::Instanced:
+            return glyphType_.supportsInstancing() ? RenderMode::Instanced : RenderMode::Meshes;
+        case RenderMode::Impostors:
+            return glyphType_.type() == TensorGlyphProperty::GlyphType::Superquadric
+                       ? RenderMode::Impostors
+                       : RenderMode::Meshes;
+        case RenderMode::Meshes:
+        default:
+            return RenderMode::Meshes;
+    }
+}
+
+size_t TensorGlyphRenderer::glyphIndex(size_t id) const {
+    if (activeRenderMode() != RenderMode::Meshes && id < instanceIndices_.size()) {
+        return instanceIndices_[id];
+    }
+    return id;
+}
+
+namespace {
+size3_t voxelOf(const size3_t& dimensions, size_t index) {
+    return {index % dimensions.x, (index / dimensions.x) % dimensions.y,
+            index / (dimensions.x * dimensions.y)};
+}
+}  // namespace
+
+void TensorGlyphRenderer::updateInstances() {
+    instancesDirty_ = false;
+
+    const auto tensorField = tensorFieldInport_.getData();
+    const auto dimensions = tensorField->getDimensions();
+    const vec3 voxelDist{tensorField->getSpacing()};
+    const vec3 offset{tensorField->getOffset()};
+    const auto comp = glm::zero<dmat3>();
+
+    // Same glyph placement as TensorGlyphProcessor
+    std::vector<TensorGlyphProperty::GlyphInstance> instances;
+    instanceIndices_.clear();
+    tensorField->forEachDefinedTensor([&](size_t index, const dmat3& tensor) {
+        if (tensor == comp) return;
+
+        const vec3 pos{voxelDist * vec3{voxelOf(dimensions, index)} + offset};
+        instances.push_back(glyphType_.generateGlyphInstance(*tensorField, index, pos));
+        instanceIndices_.push_back(index);
+    });
+
+    static_assert(sizeof(TensorGlyphProperty::GlyphInstance) == 6 * sizeof(vec4),
+                  "GlyphInstance has to match the std430 layout in tensorglyphinstanced.vert");
+    std::vector<vec4> data(6 * instances.size());
+    if (!instances.empty()) {
+        std::memcpy(data.data(), instances.data(), data.size() * sizeof(vec4));
+    }
+    instanceBuffer_ =
+        std::make_shared<Buffer<vec4>>(std::make_shared<BufferRAMPrecision<vec4>>(std::move(data)));
+    pickingBuffer_.reset();
+
+    templateGlyphs_.clear();
+}
+
+void TensorGlyphRenderer::updateInstanceStates() {
+    const auto numInstances = instanceIndices_.size();
+    const auto state = [&](size_t i) {
+        const auto id = static_cast<int>(i);
+        return uvec2(static_cast<unsigned int>(picking_.getPickingId(i)),
+                     (id == selectedID_ ? 1u : 0u) | (id == hoveredID_ ? 2u : 0u));
+    };
+
+    if (!pickingBuffer_ || picking_.getSize() != numInstances) {
+        picking_.resize(numInstances);
+
+        std::vector<uvec2> data(numInstances);
+        for (size_t i = 0; i < numInstances; ++i) {
+            data[i] = state(i);
+        }
+        const auto bytes = data.size() * sizeof(uvec2);
+        pickingBuffer_ = std::make_unique<BufferObject>(bytes, DataVec2UInt32::get(),
+                                                        BufferUsage::Dynamic, BufferTarget::Data);
+        pickingBuffer_->upload(data.data(), bytes);
+    } else if (!dirtyInstances_.empty()) {
+        // Hovering and selection only touch the affected instances
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, pickingBuffer_->getId());
+        for (const auto id : dirtyInstances_) {
+            if (id < 0 || static_cast<size_t>(id) >= numInstances) continue;
+            const auto value = state(static_cast<size_t>(id));
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, id * sizeof(uvec2), sizeof(uvec2), &value);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    dirtyInstances_.clear();
+}
+
+namespace {
+constexpr GLuint cullingGroupSize = 128;
+
+// parameters of glDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLuint baseVertex;
+    GLuint baseInstance;
+};
+}  // namespace
+
+void TensorGlyphRenderer::cullInstances() {
+    const auto numInstances = instanceIndices_.size();
+    const auto numLevels = templateGlyphs_.size();
+
+    std::array<DrawElementsIndirectCommand, maxLodLevels> commands{};
+    for (size_t l = 0; l < numLevels; ++l) {
+        commands[l].count = static_cast<GLuint>(templateGlyphs_[l]->getIndices(0)->getSize());
+    }
+    if (!drawCommands_) {
+        drawCommands_ = std::make_unique<BufferObject>(
+            sizeof(commands), DataUInt32::get(), BufferUsage::Dynamic, BufferTarget::Data);
+    }
+    drawCommands_->upload(commands.data(), sizeof(commands));
+
+    const auto visibleBytes = maxLodLevels * numInstances * sizeof(GLuint);
+    if (!visibleInstances_ ||
+        static_cast<size_t>(visibleInstances_->getSizeInBytes()) != visibleBytes) {
+        visibleInstances_ = std::make_unique<BufferObject>(
+            visibleBytes, DataUInt32::get(), BufferUsage::Dynamic, BufferTarget::Data);
+        visibleInstances_->initialize(nullptr, visibleBytes);
+    }
+
+    cullingShader_.activate();
+    utilgl::setShaderUniforms(cullingShader_, camera_, "camera");
+    utilgl::setShaderUniforms(cullingShader_, *templateGlyphs_.front(), "geometry");
+    cullingShader_.setUniform("viewport", vec2(outport_.getDimensions()));
+    cullingShader_.setUniform("numInstances", static_cast<int>(numInstances));
+    cullingShader_.setUniform("numLevels", static_cast<int>(numLevels));
+    cullingShader_.setUniform("cull", cullGlyphs_.get());
+    cullingShader_.setUniform("minPixels", minPixelSize_.get());
+    cullingShader_.setUniform("fullDetailPixels", fullDetailSize_.get());
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                     instanceBuffer_->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, drawCommands_->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, visibleInstances_->getId());
+
+    const auto groups = (numInstances + cullingGroupSize - 1) / cullingGroupSize;
+    utilgl::dispatchChunked(cullingShader_, groups, "invocationOffset", cullingGroupSize);
+    cullingShader_.deactivate();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void TensorGlyphRenderer::renderInstanced() {
+    if (instancesDirty_) updateInstances();
+    if (instanceIndices_.empty()) return;
+    updateInstanceStates();
+
+    const size_t numLevels = cullGlyphs_.get() ? lodLevels_.get() : 1;
+    if (templateGlyphs_.size() != numLevels) {
+        templateGlyphs_.clear();
+        for (size_t l = 0; l < numLevels; ++l) {
+            templateGlyphs_.push_back(glyphType_.generateTemplateGlyph(l));
+        }
+    }
+
+    cullInstances();
+
+    instancedShader_.activate();
+
+    utilgl::setShaderUniforms(instancedShader_, camera_, "camera");
+    utilgl::setShaderUniforms(instancedShader_, lighting_, "light");
+    utilgl::setShaderUniforms(instancedShader_, *templateGlyphs_.front(), "geometry");
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                     instanceBuffer_->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, pickingBuffer_->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, visibleInstances_->getId());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommands_->getId());
+
+    {
+        utilgl::CullFaceState culling(cullFace_.get());
+
+        // One indirect draw per level of detail, each template mesh has a single triangle index
+        // buffer and the instance counts are written by the culling pass
+        for (size_t l = 0; l < templateGlyphs_.size(); ++l) {
+            const auto& glyph = templateGlyphs_[l];
+            instancedShader_.setUniform("visibleOffset",
+                                        static_cast<unsigned int>(l * instanceIndices_.size()));
+            MeshDrawerGL::DrawObject drawer{glyph->getRepresentation<MeshGL>(),
+                                            glyph->getDefaultMeshInfo()};
+            const auto indices = glyph->getIndices(0)->getRepresentation<BufferGL>();
+            indices->bind();
+            glDrawElementsIndirect(
+                GL_TRIANGLES, indices->getFormatType(),
+                reinterpret_cast<const void*>(l * sizeof(DrawElementsIndirectCommand)));
+        }
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    instancedShader_.deactivate();
+}
+
+void TensorGlyphRenderer::updateImpostors() {
+    instancesDirty_ = false;
+
+    const auto tensorField = tensorFieldInport_.getData();
+    const auto dimensions = tensorField->getDimensions();
+    const vec3 voxelDist{tensorField->getSpacing()};
+    const vec3 offset{tensorField->getOffset()};
+    const auto comp = glm::zero<dmat3>();
+
+    // One point per glyph, the voxel is used to fetch the tensor in the geometry shader
+    std::vector<vec3> positions;
+    std::vector<vec3> voxels;
+    instanceIndices_.clear();
+    tensorField->forEachDefinedTensor([&](size_t index, const dmat3& tensor) {
+        if (tensor == comp) return;
+
+        const vec3 voxel{voxelOf(dimensions, index)};
+        positions.emplace_back(voxelDist * voxel + offset);
+        voxels.emplace_back(voxel);
+        instanceIndices_.push_back(index);
+    });
+
+    impostorPoints_ = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
+    impostorPoints_->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
+    impostorPoints_->addBuffer(BufferType::TexCoordAttrib, util::makeBuffer(std::move(voxels)));
+
+    tensorFieldVolumes_ = tensorField->getVolumeRepresentation();
+}
+
+void TensorGlyphRenderer::renderImpostors() {
+    if (instancesDirty_ || !impostorPoints_) updateImpostors();
+    if (instanceIndices_.empty()) return;
+    if (picking_.getSize() != instanceIndices_.size()) picking_.resize(instanceIndices_.size());
+
+    impostorShader_.activate();
+
+    TextureUnitContainer units;
+    tensorutil::bindTensorFieldAsColorTextures(tensorFieldVolumes_, impostorShader_, units);
+
+    utilgl::setShaderUniforms(impostorShader_, camera_, "camera");
+    utilgl::setShaderUniforms(impostorShader_, lighting_, "light");
+    utilgl::setShaderUniforms(impostorShader_, *impostorPoints_, "geometry");
+    impostorShader_.setUniform("pickingOffset",
+                               static_cast<unsigned int>(picking_.getPickingId(0)));
+    impostorShader_.setUniform("selectedInstance", selectedID_);
+    impostorShader_.setUniform("glyphSize", glyphType_.size());
+    impostorShader_.setUniform("gamma", glyphType_.gamma());
+    impostorShader_.setUniform("glyphColor", glyphType_.color());
+    impostorShader_.setUniform("useEigenBasis", glyphType_.useEigenBasis());
+
+    MeshDrawerGL::DrawObject drawer{impostorPoints_->getRepresentation<MeshGL>(),
+                                    impostorPoints_->getDefaultMeshInfo()};
+    drawer.draw();
+
+    impostorShader_.deactivate();
+}
+
+void TensorGlyphRenderer::setHovered(int id) {
+    if (id == hoveredID_) return;
+    dirtyInstances_.push_back(hoveredID_);
+    dirtyInstances_.push_back(id);
+    hoveredID_ = id;
+    invalidate(InvalidationLevel::InvalidOutput);
+}
 
 void TensorGlyphRenderer::handlePickingEvent(PickingEvent* p) {
+    if (p->getPressState() == PickingPressState::None) {
+        if (p->getHoverState() == PickingHoverState::Enter ||
+            p->getHoverState() == PickingHoverState::Move) {
+            setHovered(static_cast<int>(p->getPickedId()));
+        } else if (p->getHoverState() == PickingHoverState::Exit) {
+            setHovered(-1);
+        }
+    }
+
     if (selectMode_.get()) {
         if (p->getState() == PickingState::Updated &&
             p->getEvent()->hash() == MouseEvent::chash()) {
@@ -125,14 +459,16 @@ void TensorGlyphRenderer::handlePickingEvent(PickingEvent* p) {
             }
 
             if (triggerSelect_) {
+                dirtyInstances_.push_back(selectedID_);
                 selectedID_ = static_cast<int>(id);
+                dirtyInstances_.push_back(selectedID_);
 
                 size_t offset = 0;
                 if (offsetInport_.isConnected() && offsetInport_.hasData()) {
                     offset = *offsetInport_.getData();
                 }
 
-                selectedIDProperty_.set(selectedID_ + offset);
+                selectedIDProperty_.set(glyphIndex(selectedID_) + offset);
 
                 triggerSelect_ = false;
 
@@ -140,6 +476,7 @@ void TensorGlyphRenderer::handlePickingEvent(PickingEvent* p) {
             }
 
             if (button & MouseButton::Left && state & MouseState::Release) {
+                dirtyInstances_.push_back(selectedID_);
                 selectedID_ = -1;
                 invalidate(InvalidationLevel::InvalidOutput);
             }
@@ -197,18 +534,33 @@ void TensorGlyphRenderer::process() {
             offset = *offsetInport_.getData();
         }
 
-        selectedMeshOutport_.setData(
-            glyphType_.generateGlyph(tensorField, selectedID_ + offset, vec3(0.f)));
+        const auto index = glyphIndex(selectedID_) + offset;
 
-        indexOutport_.setData(
-            std::make_shared<unsigned int>(static_cast<unsigned int>(selectedID_ + offset)));
-    } else {
+        if (outputSelectedMesh_.get()) {
+            selectedMeshOutport_.setData(glyphType_.generateGlyph(tensorField, index, vec3(0.f)));
+        }
+
+        indexOutport_.setData(std::make_shared<unsigned int>(static_cast<unsigned int>(index)));
+        selectedIndicesOutport_.setData(std::make_shared<std::vector<size_t>>(1, index));
+    } else if (!selectedMeshOutport_.hasData()) {
         selectedMeshOutport_.setData(
             glyphType_.generateQuadric(dmat3(1), dvec3(0), glyphType_.size(), dvec4(1)));
     }
 }
 
 void TensorGlyphRenderer::render() {
+    switch (activeRenderMode()) {
+        case RenderMode::Instanced:
+            renderInstanced();
+            return;
+        case RenderMode::Impostors:
+            renderImpostors();
+            return;
+        case RenderMode::Meshes:
+        default:
+            break;
+    }
+
     shader_.activate();
 
     utilgl::setShaderUniforms(shader_, camera_, "camera");
@@ -220,6 +572,7 @@ void TensorGlyphRenderer::render() {
         shader_.setUniform("pickingColor", picking_.getColor(i));
         utilgl::setShaderUniforms(shader_, *(drawer->getMesh()), "geometry");
         shader_.setUniform("highlight", i == selectedID_);
+        shader_.setUniform("hovered", i == hoveredID_);
         {
             utilgl::CullFaceState culling1(cullFace_.get());
             drawer->draw();
@@ -16,36 +16,63 @@ const ProcessorInfo VolumeActualDataAndValueRange::getProcessorInfo() const {
 }
 
 VolumeActualDataAndValueRange::VolumeActualDataAndValueRange()
-    : Processor(), inport_("inport"), outport_("outport") {
+    : Processor()
+    , inport_("inport")
+    , outport_("outport")
+    , brickSize_("brickSize", "Brick Size", 32, 1, 256)
+    , restrictToRegion_("restrictToRegion", "Restrict to Region", false)
+    , rangeX_("rangeX", "X Range", 0, 255, 0, 255, 1, 0)
+    , rangeY_("rangeY", "Y Range", 0, 255, 0, 255, 1, 0)
+    , rangeZ_("rangeZ", "Z Range", 0, 255, 0, 255, 1, 0) {
     addPort(inport_);
     addPort(outport_);
+    addProperties(brickSize_, restrictToRegion_, rangeX_, rangeY_, rangeZ_);
+
+    for (auto prop : {&rangeX_, &rangeY_, &rangeZ_}) {
+        prop->visibilityDependsOn(restrictToRegion_, [](const auto& p) { return p.get(); });
+    }
+
+    inport_.onChange([this]() {
+        if (!inport_.hasData()) return;
+        const auto dims = inport_.getData()->getDimensions();
+        size_t i = 0;
+        for (auto prop : {&rangeX_, &rangeY_, &rangeZ_}) {
+            const auto last = std::max<size_t>(dims[i++], 1) - 1;
+            const bool fullRange = prop->getStart() == 0 && prop->getEnd() == prop->getRangeMax();
+            prop->setRangeMax(last);
+            if (fullRange) prop->set(size2_t{0, last});
+        }
+    });
 }
 
 void VolumeActualDataAndValueRange::process() {
     auto inVolume = inport_.getData();
 
-    auto inVolumeRAM = inVolume->getRepresentation<VolumeRAM>();
-
-    auto inVolumeData = static_cast<const glm::f32*>(inVolumeRAM->getData());
-
-    auto dimensions = inVolume->getDimensions();
-
-    auto numElements = dimensions.x * dimensions.y * dimensions.z;
-
-    auto outVolume = inVolume->clone();
-
-    auto min = std::numeric_limits<float>::max();
-    auto max = std::numeric_limits<float>::lowest();
-
-    for (size_t i = 0; i < numElements; i++) {
-        min = std::min(min, inVolumeData[i]);
-        max = std::max(max, inVolumeData[i]);
+    // Producers may rewrite a volume in place and set the same pointer again, so any new data on
+    // the inport invalidates the summary
+    if (inport_.isChanged() || brickSize_.isModified()) {
+        summary_ = tensorutil::VolumeRangeSummary(*inVolume->getRepresentation<VolumeRAM>(),
+                                                  brickSize_.get());
+        result_.reset();
     }
 
-    outVolume->dataMap_.dataRange = vec2(min, max);
-    outVolume->dataMap_.valueRange = vec2(min, max);
+    const auto range =
+        restrictToRegion_.get()
+            ? summary_.range(size3_t{rangeX_.getStart(), rangeY_.getStart(), rangeZ_.getStart()},
+                             size3_t{rangeX_.getEnd(), rangeY_.getEnd(), rangeZ_.getEnd()})
+            : summary_.range();
+    if (range.x > range.y) {
+        outport_.setData(inVolume);
+        return;
+    }
 
-    outport_.setData(std::make_shared<Volume>(*outVolume));
+    // the copy of the volume is only made once per range
+    if (!result_ || result_->dataMap_.dataRange != range) {
+        result_.reset(inVolume->clone());
+        result_->dataMap_.dataRange = range;
+        result_->dataMap_.valueRange = range;
+    }
+    outport_.setData(result_);
 }
 
 }  // namespace inviwo
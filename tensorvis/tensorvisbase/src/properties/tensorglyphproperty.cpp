@@ -28,9 +28,14 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisbase/properties/tensorglyphproperty.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 #include <inviwo/tensorvisbase/datastructures/deformablesphere.h>
 #include <inviwo/tensorvisbase/datastructures/deformablecube.h>
 #include <inviwo/tensorvisbase/datastructures/deformablecylinder.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
 
 namespace inviwo {
 const std::string TensorGlyphProperty::classIdentifier{"org.inviwo.TensorGlyphProperty"};
@@ -107,6 +112,8 @@ vec4 TensorGlyphProperty::color() const { return color_.get(); }
 
 float TensorGlyphProperty::gamma() const { return gamma_.get(); }
 
+bool TensorGlyphProperty::useEigenBasis() const { return useEigenBasis_.get(); }
+
 void TensorGlyphProperty::evalColorReadOnly() {
     switch (static_cast<GlyphType>(glyphType_.get())) {
         case GlyphType::CombinedReynoldsHYW:
@@ -184,13 +191,10 @@ std::pair<bool, dvec3> TensorGlyphProperty::intersectTriangle(
     return {true, dvec3(1. - v - w, v, w)};
 }
 
-const std::shared_ptr<BasicMesh> TensorGlyphProperty::generateSuperquadric(
-    std::shared_ptr<const TensorField3D> tensorField, size_t index, const dvec3 pos,
-    const dvec4& color, const float size) {
-    DeformableSphere sphere(resolutionTheta_.get(), resolutionPhi_.get(), color);
-
+std::pair<dmat3, std::array<double, 3>> TensorGlyphProperty::superquadricBasis(
+    const TensorField3D& tensorField, size_t index) const {
     auto eigenValuesAndEigenVectors =
-        tensorField->getSortedEigenValuesAndEigenVectorsForTensor(index);
+        tensorField.getSortedEigenValuesAndEigenVectorsForTensor(index);
 
     auto magicScalingNumer = 0.00001;
     std::transform(eigenValuesAndEigenVectors.begin(), eigenValuesAndEigenVectors.end(),
@@ -228,6 +232,29 @@ const std::shared_ptr<BasicMesh> TensorGlyphProperty::generateSuperquadric(
         basis[2] = -basis[2];
     }
 
+    return {basis, eigenValues};
+}
+
+std::tuple<double, double, bool> TensorGlyphProperty::superquadricExponents(
+    const std::array<double, 3>& eigenValues) const {
+    auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
+    auto linearAnisotropy = (eigenValues[0] - eigenValues[1]) / denominator;
+    auto planarAnisotropy = (2. * (eigenValues[1] - eigenValues[2])) / denominator;
+
+    if (linearAnisotropy >= planarAnisotropy) {
+        return {glm::pow(1. - planarAnisotropy, gamma_.get()),
+                glm::pow(1. - linearAnisotropy, gamma_.get()), false};
+    } else {
+        return {glm::pow(1. - linearAnisotropy, gamma_.get()),
+                glm::pow(1. - planarAnisotropy, gamma_.get()), true};
+    }
+}
+
+const std::shared_ptr<BasicMesh> TensorGlyphProperty::generateSuperquadric(
+    std::shared_ptr<const TensorField3D> tensorField, size_t index, const dvec3 pos,
+    const dvec4& color, const float size) {
+    const auto [basis, eigenValues] = superquadricBasis(*tensorField, index);
+
     auto mesh = createSuperquadric(eigenValues, pos, size, color);
     mesh->setBasis(basis);
 
@@ -258,41 +285,11 @@ std::shared_ptr<BasicMesh> TensorGlyphProperty::createSuperquadric(
     const dvec4& color) const {
     DeformableSphere sphere(resolutionTheta_.get(), resolutionPhi_.get(), color);
 
-    auto denominator = eigenValues[0] + eigenValues[1] + eigenValues[2];
-    auto linearAnisotropy = (eigenValues[0] - eigenValues[1]) / denominator;
-    auto planarAnisotropy = (2. * (eigenValues[1] - eigenValues[2])) / denominator;
-
-    double alpha;
-    double beta;
-
-    if (linearAnisotropy >= planarAnisotropy) {
-        alpha = glm::pow(1. - planarAnisotropy, gamma_.get());
-        beta = glm::pow(1. - linearAnisotropy, gamma_.get());
-    } else {
-        alpha = glm::pow(1. - linearAnisotropy, gamma_.get());
-        beta = glm::pow(1. - planarAnisotropy, gamma_.get());
-    }
+    const auto [alpha, beta, swapAxes] = superquadricExponents(eigenValues);
 
     sphere.deform(
-        [&](vec3& v) {
-            /// Geometry calculation
-            auto sphericalCoords = cartesianToSpherical(v);
-
-            const auto sinphi = glm::sin(sphericalCoords.y);
-            const auto cosphi = glm::cos(sphericalCoords.y);
-            const auto sintheta = glm::sin(sphericalCoords.z);
-            const auto costheta = glm::cos(sphericalCoords.z);
-
-            v = {glm::sign(cosphi) * std::pow(std::abs(cosphi), beta),
-                 (-glm::sign(sintheta) * std::pow(std::abs(sintheta), alpha)) *
-                     (glm::sign(sinphi) * std::pow(std::abs(sinphi), beta)),
-                 (glm::sign(costheta) * std::pow(std::abs(costheta), alpha)) *
-                     (glm::sign(sinphi) * std::pow(std::abs(sinphi), beta))};
-
-            if (linearAnisotropy < planarAnisotropy) {
-                std::swap(v.x, v.z);
-                v.y *= -1.0f;
-            }
+        [&, alpha = alpha, beta = beta, swapAxes = swapAxes](vec3& v) {
+            v = superquadricVertex(v, alpha, beta, swapAxes);
         },
         false);
     sphere.transform(pos, dvec3(size));
@@ -300,6 +297,29 @@ std::shared_ptr<BasicMesh> TensorGlyphProperty::createSuperquadric(
     return sphere.getGeometry();
 }
 
+vec3 TensorGlyphProperty::superquadricVertex(const vec3& v, double alpha, double beta,
+                                             bool swapAxes) const {
+    /// Geometry calculation
+    auto sphericalCoords = cartesianToSpherical(v);
+
+    const auto sinphi = glm::sin(sphericalCoords.y);
+    const auto cosphi = glm::cos(sphericalCoords.y);
+    const auto sintheta = glm::sin(sphericalCoords.z);
+    const auto costheta = glm::cos(sphericalCoords.z);
+
+    vec3 result{glm::sign(cosphi) * std::pow(std::abs(cosphi), beta),
+                (-glm::sign(sintheta) * std::pow(std::abs(sintheta), alpha)) *
+                    (glm::sign(sinphi) * std::pow(std::abs(sinphi), beta)),
+                (glm::sign(costheta) * std::pow(std::abs(costheta), alpha)) *
+                    (glm::sign(sinphi) * std::pow(std::abs(sinphi), beta))};
+
+    if (swapAxes) {
+        std::swap(result.x, result.z);
+        result.y *= -1.0f;
+    }
+    return result;
+}
+
 const std::shared_ptr<BasicMesh> TensorGlyphProperty::generateReynolds(
     std::shared_ptr<const TensorField3D> tensorField, size_t index, const dvec3 pos,
     const float size) {
@@ -676,4 +696,140 @@ const std::shared_ptr<BasicMesh> TensorGlyphProperty::generateGlyph(
     return generateSuperquadric(eigenvalues, pos, size, color);
 }
 
+bool TensorGlyphProperty::supportsInstancing() const {
+    switch (glyphType_.get()) {
+        case GlyphType::Superquadric:
+        case GlyphType::Quadric:
+        case GlyphType::Cube:
+        case GlyphType::Cylinder:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::shared_ptr<BasicMesh> TensorGlyphProperty::generateTemplateGlyph(size_t level) const {
+    const auto theta = std::max(resolutionTheta_.get() >> level, resolutionTheta_.getMinValue());
+    const auto phi = std::max(resolutionPhi_.get() >> level, resolutionPhi_.getMinValue());
+    switch (glyphType_.get()) {
+        case GlyphType::Cube:
+            return DeformableCube(vec4(1.f)).getGeometry();
+        case GlyphType::Cylinder:
+            return DeformableCylinder(theta, vec4(1.f)).getGeometry();
+        case GlyphType::Superquadric:
+        case GlyphType::Quadric:
+        default:
+            return DeformableSphere(theta, phi, vec4(1.f)).getGeometry();
+    }
+}
+
+std::shared_ptr<BasicMesh> TensorGlyphProperty::generateGlyphs(
+    const TensorField3D& tensorField, const std::vector<size_t>& indices,
+    const std::vector<dvec3>& positions) const {
+    if (!supportsInstancing()) return nullptr;
+    if (indices.size() != positions.size()) {
+        throw Exception("Number of glyph indices and positions differ",
+                        IVW_CONTEXT_CUSTOM("TensorGlyphProperty::generateGlyphs"));
+    }
+
+    std::shared_ptr<const GlyphTopology> topology;
+    switch (glyphType_.get()) {
+        case GlyphType::Cube:
+            topology = DeformableCube::topology();
+            break;
+        case GlyphType::Cylinder:
+            topology = DeformableCylinder::topology(resolutionTheta_.get());
+            break;
+        default:
+            topology = DeformableSphere::topology(resolutionTheta_.get(), resolutionPhi_.get());
+            break;
+    }
+
+    const auto numGlyphs = indices.size();
+    const auto numVertices = topology->numVertices();
+    const auto numFaces = topology->faces.size();
+
+    std::vector<vec3> vertices(numGlyphs * numVertices);
+    std::vector<vec3> normals(numGlyphs * numVertices);
+    std::vector<vec4> colors(numGlyphs * numVertices);
+    auto indexRAM = std::make_shared<IndexBufferRAM>(numGlyphs * numFaces * 3);
+    auto& triangles = indexRAM->getDataContainer();
+
+    // Every glyph writes its own contiguous range of the buffers. This runs in processor pool
+    // jobs, so the loop has to be safe to nest in the pool
+    util::forEachRangeParallel(numGlyphs, util::defaultGrainSize(numGlyphs, 64),
+                               [&](size_t begin, size_t end) {
+        for (size_t glyph = begin; glyph < end; ++glyph) {
+            const auto index = indices[glyph];
+            const auto instance = generateGlyphInstance(tensorField, index, positions[glyph]);
+            const auto center = vec3(instance.position);
+            const auto size = instance.position.w;
+            const mat3 basis{vec3(instance.basis[0]), vec3(instance.basis[1]),
+                             vec3(instance.basis[2])};
+            const auto superquadric = instance.shape.w > 0.5f;
+
+            const auto first = glyph * numVertices;
+            for (size_t i = 0; i < numVertices; ++i) {
+                auto v = topology->vertices[i];
+                if (superquadric) {
+                    v = superquadricVertex(v, instance.shape.x, instance.shape.y,
+                                           instance.shape.z > 0.5f);
+                }
+                vertices[first + i] = center + size * (basis * v);
+                colors[first + i] = instance.color;
+            }
+            topology->computeNormals(vertices.data() + first, normals.data() + first, center);
+
+            auto triangle = triangles.begin() + glyph * numFaces * 3;
+            for (const auto& face : topology->faces) {
+                *triangle++ = static_cast<uint32_t>(first + face.x);
+                *triangle++ = static_cast<uint32_t>(first + face.y);
+                *triangle++ = static_cast<uint32_t>(first + face.z);
+            }
+        }
+    });
+
+    auto mesh = std::make_shared<BasicMesh>();
+    mesh->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(vertices);
+    mesh->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(normals);
+    mesh->getEditableColors()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(colors);
+    auto& texCoords =
+        mesh->getEditableTexCoords()->getEditableRAMRepresentation()->getDataContainer();
+    texCoords.reserve(numGlyphs * numVertices);
+    for (size_t glyph = 0; glyph < numGlyphs; ++glyph) {
+        texCoords.insert(texCoords.end(), topology->texCoords.begin(), topology->texCoords.end());
+    }
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                     std::make_shared<IndexBuffer>(indexRAM));
+    return mesh;
+}
+
+TensorGlyphProperty::GlyphInstance TensorGlyphProperty::generateGlyphInstance(
+    const TensorField3D& tensorField, size_t index, const dvec3& pos) const {
+    GlyphInstance instance;
+    instance.position = vec4(vec3(pos), size_.get());
+    instance.color = color_.get();
+
+    auto setBasis = [&](const mat3& basis) {
+        for (glm::length_t i = 0; i < 3; ++i) {
+            instance.basis[i] = vec4(basis[i], 0.f);
+        }
+    };
+
+    if (glyphType_.get() == GlyphType::Superquadric) {
+        const auto [basis, eigenValues] = superquadricBasis(tensorField, index);
+        const auto [alpha, beta, swapAxes] = superquadricExponents(eigenValues);
+        setBasis(mat3(basis));
+        instance.shape = vec4(alpha, beta, swapAxes ? 1.f : 0.f, 1.f);
+    } else {
+        setBasis(mat3(tensorField.tensor(index)));
+        instance.shape = vec4(1.f, 1.f, 0.f, 0.f);
+    }
+
+    return instance;
+}
+
 }  // namespace inviwo
@@ -38,7 +38,9 @@
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/tensorvisbase/processors/eigenvaluefieldtoimage.h>
 #include <inviwo/tensorvisbase/processors/hyperstreamlines.h>
+#include <inviwo/tensorvisbase/processors/hyperstreamlinesgl.h>
 #include <inviwo/tensorvisbase/processors/imagetospherefield.h>
+#include <inviwo/tensorvisbase/processors/invariantspacebrush.h>
 #include <inviwo/tensorvisbase/processors/invariantspacecombine.h>
 #include <inviwo/tensorvisbase/processors/invariantspacefilter.h>
 #include <inviwo/tensorvisbase/processors/invariantspaceselection.h>
@@ -50,8 +52,11 @@
 #include <inviwo/tensorvisbase/processors/tensorfield3danisotropy.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dbasismanipulation.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dboundingbox.h>
+#include <inviwo/tensorvisbase/processors/tensorfield3densemblestatistics.h>
+#include <inviwo/tensorvisbase/processors/tensorfield3dlevelofdetail.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dmasktovolume.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dmetadata.h>
+#include <inviwo/tensorvisbase/processors/tensorfield3dsequenceselector.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dsubsample.h>
 #include <inviwo/tensorvisbase/processors/tensorfield3dsubset.h>
 #include <inviwo/tensorvisbase/processors/tensorfieldgenerator.h>
@@ -74,7 +79,9 @@ TensorVisBaseModule::TensorVisBaseModule(InviwoApplication* app)
 
     registerProcessor<EigenvalueFieldToImage>();
     registerProcessor<HyperStreamlines>();
+    registerProcessor<HyperStreamlinesGL>();
     registerProcessor<ImageToSphereField>();
+    registerProcessor<InvariantSpaceBrush>();
     registerProcessor<InvariantSpaceCombine>();
     registerProcessor<InvariantSpaceFilter>();
     registerProcessor<TensorField2DAnisotropy>();
@@ -84,8 +91,11 @@ TensorVisBaseModule::TensorVisBaseModule(InviwoApplication* app)
     registerProcessor<TensorField3DAnisotropy>();
     registerProcessor<TensorField3DBasisManipulation>();
     registerProcessor<TensorField3DBoundingBox>();
+    registerProcessor<TensorField3DEnsembleStatistics>();
+    registerProcessor<TensorField3DLevelOfDetail>();
     registerProcessor<TensorField3DMaskToVolume>();
     registerProcessor<TensorField3DMetaData>();
+    registerProcessor<TensorField3DSequenceSelector>();
     registerProcessor<TensorField3DSubsample>();
     registerProcessor<TensorField3DSubset>();
     registerProcessor<TensorFieldGenerator>();
@@ -31,10 +31,14 @@
 #include <modules/opengl/texture/textureutils.h>
 #include <inviwo/tensorvisbase/util/tensorfieldutil.h>
 #include <inviwo/tensorvisbase/algorithm/tensorfieldsampling.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <atomic>
+#include <mutex>
 
 namespace inviwo {
 namespace tensorutil {
-void bindTensorFieldAsColorTexture(std::shared_ptr<Image>& texture,
+void bindTensorFieldAsColorTexture(std::shared_ptr<const Image>& texture,
                                    std::shared_ptr<const TensorField2D> tensorField, Shader& shader,
                                    TextureUnitContainer& textureUnits) {
     texture = tensorField->getImageRepresentation();
@@ -42,8 +46,9 @@ void bindTensorFieldAsColorTexture(std::shared_ptr<Image>& texture,
     utilgl::bindAndSetUniforms(shader, textureUnits, *texture, "tensorField", ImageType::ColorOnly);
 }
 
-void bindTensorFieldAsColorTexture(std::shared_ptr<Image>& texture, TensorField2DInport& inport,
-                                   Shader& shader, TextureUnitContainer& textureUnits) {
+void bindTensorFieldAsColorTexture(std::shared_ptr<const Image>& texture,
+                                   TensorField2DInport& inport, Shader& shader,
+                                   TextureUnitContainer& textureUnits) {
     auto tensorField = inport.getData();
 
     texture = tensorField->getImageRepresentation();
@@ -51,9 +56,25 @@ void bindTensorFieldAsColorTexture(std::shared_ptr<Image>& texture, TensorField2
     utilgl::bindAndSetUniforms(shader, textureUnits, *texture, "tensorField", ImageType::ColorOnly);
 }
 
-void bindTensorFieldAsColorTextures(std::shared_ptr<const TensorField3D>&, Shader*,
-                                    TextureUnitContainer&) {
-    // auto volumes = tensorField->getVolumeRepresentation();
+void bindTensorFieldAsColorTexture(const Image& texture, Shader& shader,
+                                   TextureUnitContainer& textureUnits) {
+    utilgl::bindAndSetUniforms(shader, textureUnits, texture, "tensorField", ImageType::ColorOnly);
+}
+
+void bindTensorFieldAsColorTextures(
+    std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>& textures,
+    std::shared_ptr<const TensorField3D> tensorField, Shader& shader,
+    TextureUnitContainer& textureUnits) {
+    textures = tensorField->getVolumeRepresentation();
+
+    bindTensorFieldAsColorTextures(textures, shader, textureUnits);
+}
+
+void bindTensorFieldAsColorTextures(
+    const std::pair<std::shared_ptr<const Volume>, std::shared_ptr<const Volume>>& textures,
+    Shader& shader, TextureUnitContainer& textureUnits) {
+    utilgl::bindAndSetUniforms(shader, textureUnits, *textures.first, "tensorFieldDiagonal");
+    utilgl::bindAndSetUniforms(shader, textureUnits, *textures.second, "tensorFieldOffDiagonal");
 }
 
 std::shared_ptr<TensorField2D> subsample2D(std::shared_ptr<const TensorField2D> tensorField,
@@ -69,8 +90,9 @@ std::shared_ptr<TensorField2D> subsample2D(std::shared_ptr<const TensorField2D>
     auto yFrac = static_cast<double>(tensorField->getDimensions().y - 1) /
                  static_cast<double>(newDimensions.y - 1);
 
-    for (size_t x = 0; x < newDimensions.x; x++) {
-        for (size_t y = 0; y < newDimensions.y; y++) {
+    std::vector<size_t> rows(newDimensions.y);
+    util::forEachParallel(rows, [&](size_t, size_t y) {
+        for (size_t x = 0; x < newDimensions.x; x++) {
             // Find position in old tensor field
             auto pos = dvec2(xFrac * static_cast<double>(x), yFrac * static_cast<double>(y));
             auto posNormalized =
@@ -83,7 +105,7 @@ std::shared_ptr<TensorField2D> subsample2D(std::shared_ptr<const TensorField2D>
             // Assign tensor at x,y
             dataNew[indexMapperNew(size2_t(x, y))] = tensor;
         }
-    }
+    });
 
     return std::make_shared<TensorField2D>(newDimensions, dataNew);
 }
@@ -91,68 +113,200 @@ std::shared_ptr<TensorField2D> subsample2D(std::shared_ptr<const TensorField2D>
 std::shared_ptr<TensorField3D> IVW_MODULE_TENSORVISBASE_API
 subsample3D(std::shared_ptr<const TensorField3D> tensorField, size3_t newDimensions,
             const InterpolationMethod method) {
+    return subsample3D(tensorField, newDimensions, method, [](float) {});
+}
+
+std::shared_ptr<TensorField3D> IVW_MODULE_TENSORVISBASE_API
+subsample3D(std::shared_ptr<const TensorField3D> tensorField, size3_t newDimensions,
+            const InterpolationMethod method, std::function<void(float)> fun,
+            std::function<bool()> stop) {
     std::vector<dmat3> dataNew;
     dataNew.resize(newDimensions.x * newDimensions.y * newDimensions.z);
 
-    util::IndexMapper3D indexMapperNew(newDimensions);
+    const TensorField3DSampler sampler(*tensorField, method);
 
     auto xFrac = 1. / static_cast<double>(newDimensions.x - 1);
     auto yFrac = 1. / static_cast<double>(newDimensions.y - 1);
     auto zFrac = 1. / static_cast<double>(newDimensions.z - 1);
 
-    for (size_t x = 0; x < newDimensions.x; x++) {
-        for (size_t y = 0; y < newDimensions.y; y++) {
-            for (size_t z = 0; z < newDimensions.z; z++) {
-                // Find position in old tensor field
-                auto pos = dvec3(xFrac * static_cast<double>(x), yFrac * static_cast<double>(y),
-                                 zFrac * static_cast<double>(z));
-
-                // Sample old tensor field at position
-                auto tensor = sample(tensorField, pos, method);
+    std::atomic<size_t> slicesDone{0};
+    std::mutex progressMutex;
 
-                // Assign tensor at x,y
-                dataNew[indexMapperNew(size3_t(x, y, z))] = tensor.second;
+    // Sample one row along x at a time, rows are contiguous in the new tensor field
+    const auto slice = [&](size_t z, size_t) {
+        std::vector<dvec3> positions(newDimensions.x);
+        for (size_t y = 0; y < newDimensions.y; y++) {
+            // Find positions in old tensor field
+            for (size_t x = 0; x < newDimensions.x; x++) {
+                positions[x] = dvec3(xFrac * static_cast<double>(x), yFrac * static_cast<double>(y),
+                                     zFrac * static_cast<double>(z));
             }
+
+            const auto offset = (z * newDimensions.y + y) * newDimensions.x;
+            sampler.sample(positions.data(), positions.size(), dataNew.data() + offset);
         }
-    }
+
+        std::scoped_lock lock{progressMutex};
+        fun(std::min(0.99f, static_cast<float>(++slicesDone) /
+                                static_cast<float>(newDimensions.z)));
+    };
+    if (!util::forEachRangeParallel(newDimensions.z, 1, slice, stop)) return nullptr;
 
     return std::make_shared<TensorField3D>(newDimensions, dataNew, tensorField->getExtents());
 }
 
-std::shared_ptr<TensorField3D> IVW_MODULE_TENSORVISBASE_API
-subsample3D(std::shared_ptr<const TensorField3D> tensorField, size3_t newDimensions,
-            const InterpolationMethod method, std::function<void(float)> fun) {
-    std::vector<dmat3> dataNew;
-    dataNew.resize(newDimensions.x * newDimensions.y * newDimensions.z);
-
-    util::IndexMapper3D indexMapperNew(newDimensions);
+namespace {
+// Range [first, last) of the input indices averaged into index i of the output
+std::pair<size_t, size_t> footprint(size_t i, size_t inputSize, size_t outputSize) {
+    const auto first = i * inputSize / outputSize;
+    const auto last = std::max(first + 1, (i + 1) * inputSize / outputSize);
+    return {first, last};
+}
+}  // namespace
+
+std::shared_ptr<TensorField2D> downsample2D(std::shared_ptr<const TensorField2D> tensorField,
+                                            size2_t newDimensions, const Averaging averaging) {
+    const auto dimensions = tensorField->getDimensions();
+    newDimensions = glm::clamp(newDimensions, size2_t(1), dimensions);
+    const util::IndexMapper2D indexMapper(dimensions);
+
+    std::vector<dmat2> tensors(newDimensions.x * newDimensions.y);
+
+    std::vector<size_t> rows(newDimensions.y);
+    util::forEachParallel(rows, [&](size_t, size_t y) {
+        const auto [y0, y1] = footprint(y, dimensions.y, newDimensions.y);
+        for (size_t x = 0; x < newDimensions.x; x++) {
+            const auto [x0, x1] = footprint(x, dimensions.x, newDimensions.x);
+
+            dmat2 sum(0.0);
+            dmat2 logSum(0.0);
+            auto logEuclidean = averaging == Averaging::LogEuclidean;
+            for (auto yy = y0; yy < y1; ++yy) {
+                for (auto xx = x0; xx < x1; ++xx) {
+                    const auto t = tensorField->tensor(indexMapper(size2_t(xx, yy)));
+                    sum += t;
+                    if (!logEuclidean) continue;
+                    if (const auto logT = logTensor(t)) {
+                        logSum += *logT;
+                    } else {
+                        logEuclidean = false;
+                    }
+                }
+            }
 
-    auto xFrac = 1. / static_cast<double>(newDimensions.x - 1);
-    auto yFrac = 1. / static_cast<double>(newDimensions.y - 1);
-    auto zFrac = 1. / static_cast<double>(newDimensions.z - 1);
+            const auto n = static_cast<double>((x1 - x0) * (y1 - y0));
+            tensors[x + y * newDimensions.x] = logEuclidean ? expTensor(logSum / n) : sum / n;
+        }
+    });
 
-    const auto numElements =
-        static_cast<float>(newDimensions.x * newDimensions.y * newDimensions.z);
-    float i = 0.f;
+    auto result = std::make_shared<TensorField2D>(newDimensions, tensors,
+                                                  tensorField->getExtents<double>());
+    result->setOffset(tensorField->getOffset());
+    return result;
+}
 
-    for (size_t x = 0; x < newDimensions.x; x++) {
-        for (size_t y = 0; y < newDimensions.y; y++) {
-            for (size_t z = 0; z < newDimensions.z; z++) {
-                fun(std::min(0.99f, i++ / numElements));
-                // Find position in old tensor field
-                auto pos = dvec3(xFrac * static_cast<double>(x), yFrac * static_cast<double>(y),
-                                 zFrac * static_cast<double>(z));
+std::shared_ptr<TensorField3D> downsample3D(std::shared_ptr<const TensorField3D> tensorField,
+                                            size3_t newDimensions, const Averaging averaging,
+                                            std::function<void(float)> progress,
+                                            std::function<bool()> stop) {
+    const auto dimensions = tensorField->getDimensions();
+    newDimensions = glm::clamp(newDimensions, size3_t(1), dimensions);
+    const util::IndexMapper3D indexMapper(dimensions);
+    const auto size = newDimensions.x * newDimensions.y * newDimensions.z;
+
+    const auto logEuclidean = averaging == Averaging::LogEuclidean;
+
+    // Take the logarithms from the eigen system of the input if it has been computed already
+    const auto inputEigen = logEuclidean && tensorField->hasEigenDecomposition();
+    const auto logOf = [&](size_t i, const dmat3& t) -> std::optional<dmat3> {
+        if (!inputEigen) return logTensor(t);
+        if (!isSymmetric(t)) return std::nullopt;
+        const std::array<std::pair<double, dvec3>, 3> eigen{
+            {{tensorField->majorEigenValues()[i], tensorField->majorEigenVectors()[i]},
+             {tensorField->middleEigenValues()[i], tensorField->middleEigenVectors()[i]},
+             {tensorField->minorEigenValues()[i], tensorField->minorEigenVectors()[i]}}};
+        return logTensor(eigen);
+    };
+
+    std::vector<dmat3> tensors(size);
+    // The eigen system of exp(L) is exp of the eigen system of L, which is computed anyway
+    std::array<std::vector<double>, 3> eigenValues;
+    std::array<std::vector<dvec3>, 3> eigenVectors;
+    if (logEuclidean) {
+        for (size_t k = 0; k < 3; ++k) {
+            eigenValues[k].resize(size);
+            eigenVectors[k].resize(size);
+        }
+    }
+    std::atomic<bool> inheritEigen{logEuclidean};
 
-                // Sample old tensor field at position
-                auto tensor = sample(tensorField, pos, method);
+    std::atomic<size_t> slicesDone{0};
+    std::mutex progressMutex;
 
-                // Assign tensor at x,y
-                dataNew[indexMapperNew(size3_t(x, y, z))] = tensor.second;
+    // One slice of the new field per task, reading a slab of the input
+    const auto slice = [&](size_t z, size_t) {
+        const auto [z0, z1] = footprint(z, dimensions.z, newDimensions.z);
+        for (size_t y = 0; y < newDimensions.y; y++) {
+            const auto [y0, y1] = footprint(y, dimensions.y, newDimensions.y);
+            for (size_t x = 0; x < newDimensions.x; x++) {
+                const auto [x0, x1] = footprint(x, dimensions.x, newDimensions.x);
+
+                dmat3 sum(0.0);
+                dmat3 logSum(0.0);
+                auto useLog = logEuclidean;
+                for (auto zz = z0; zz < z1; ++zz) {
+                    for (auto yy = y0; yy < y1; ++yy) {
+                        for (auto xx = x0; xx < x1; ++xx) {
+                            const auto i = indexMapper(size3_t(xx, yy, zz));
+                            const auto t = tensorField->tensor(i);
+                            sum += t;
+                            if (!useLog) continue;
+                            if (const auto logT = logOf(i, t)) {
+                                logSum += *logT;
+                            } else {
+                                useLog = false;
+                            }
+                        }
+                    }
+                }
+
+                const auto n = static_cast<double>((x1 - x0) * (y1 - y0) * (z1 - z0));
+                const auto index = x + newDimensions.x * (y + newDimensions.y * z);
+                if (useLog) {
+                    const auto eigen = calculateSymmetricEigenValuesAndEigenVectors(logSum / n);
+                    dmat3 t(0.0);
+                    for (size_t k = 0; k < 3; ++k) {
+                        const auto lambda = std::exp(eigen[k].first);
+                        t += lambda * glm::outerProduct(eigen[k].second, eigen[k].second);
+                        eigenValues[k][index] = lambda;
+                        eigenVectors[k][index] = eigen[k].second;
+                    }
+                    tensors[index] = t;
+                } else {
+                    tensors[index] = sum / n;
+                    inheritEigen = false;
+                }
             }
         }
-    }
 
-    return std::make_shared<TensorField3D>(newDimensions, dataNew, tensorField->getExtents());
+        if (progress) {
+            std::scoped_lock lock{progressMutex};
+            progress(static_cast<float>(++slicesDone) / static_cast<float>(newDimensions.z));
+        }
+    };
+    if (!util::forEachRangeParallel(newDimensions.z, 1, slice, stop)) return nullptr;
+
+    std::shared_ptr<TensorField3D> result;
+    if (inheritEigen) {
+        result = std::make_shared<TensorField3D>(
+            newDimensions, std::move(tensors), eigenValues[0], eigenValues[1], eigenValues[2],
+            eigenVectors[0], eigenVectors[1], eigenVectors[2], vec3(tensorField->getExtents()));
+    } else {
+        result = std::make_shared<TensorField3D>(newDimensions, std::move(tensors),
+                                                 vec3(tensorField->getExtents()));
+    }
+    result->setOffset(tensorField->getOffset());
+    return result;
 }
 
 std::shared_ptr<PosTexColorMesh> generateBoundingBoxAdjacencyForTensorField(
@@ -31,6 +31,9 @@
 
 #include <inviwo/core/util/exception.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace inviwo {
 namespace tensorutil {
 vec4 tensor2DToDvec4(const dmat2& tensor) {
@@ -128,9 +131,49 @@ dmat3 meanHydrostaticStressTensor(const dmat3& tensor) { return meanNormalStress
  */
 dmat3 volumetricStressTensor(const dmat3& tensor) { return meanNormalStressTensor(tensor); }
 
+bool isSymmetric(const dmat3& tensor, double epsilon) {
+    double scale = 0.0;
+    for (glm::length_t i = 0; i < 3; ++i) {
+        for (glm::length_t j = 0; j < 3; ++j) {
+            scale = std::max(scale, std::abs(tensor[i][j]));
+        }
+    }
+    const auto tolerance = epsilon * scale;
+
+    return std::abs(tensor[0][1] - tensor[1][0]) <= tolerance &&
+           std::abs(tensor[0][2] - tensor[2][0]) <= tolerance &&
+           std::abs(tensor[1][2] - tensor[2][1]) <= tolerance;
+}
+
+/*
+Calculates the eigen system of a symmetric tensor using the closed-form solver of Eigen. This avoids
+the iterative QR steps of the general solver and does not allocate. Eigen returns the eigenvalues in
+increasing order, hence the reversed indexing.
+*/
+std::array<std::pair<double, dvec3>, 3> calculateSymmetricEigenValuesAndEigenVectors(
+    const dmat3& tensor) {
+    if (tensor == dmat3(0.0)) {
+        return std::array<std::pair<double, dvec3>, 3>{std::pair<double, dvec3>{0, dvec3(0)},
+                                                       std::pair<double, dvec3>{0, dvec3(0)},
+                                                       std::pair<double, dvec3>{0, dvec3(0)}};
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 3, 3>> solver;
+    solver.computeDirect(util::glm2eigen(tensor));
+
+    const auto& values = solver.eigenvalues();
+    const auto& vectors = solver.eigenvectors();
+
+    return std::array<std::pair<double, dvec3>, 3>{
+        std::pair<double, dvec3>{values[2], dvec3(vectors(0, 2), vectors(1, 2), vectors(2, 2))},
+        std::pair<double, dvec3>{values[1], dvec3(vectors(0, 1), vectors(1, 1), vectors(2, 1))},
+        std::pair<double, dvec3>{values[0], dvec3(vectors(0, 0), vectors(1, 0), vectors(2, 0))}};
+}
+
 /*
 Calculates and return 3 pairs of eigenvector and eigenvalue. The array is sorted such that
-lambda1>lambda2>lambda3
+lambda1>lambda2>lambda3. Symmetric tensors are handled by the closed-form solver, the general
+solver is used as a fallback for non-symmetric tensors.
 */
 std::array<std::pair<double, dvec3>, 3> calculateEigenValuesAndEigenVectors(const dmat3& tensor) {
     if (tensor == dmat3(0.0)) {
@@ -139,6 +182,10 @@ std::array<std::pair<double, dvec3>, 3> calculateEigenValuesAndEigenVectors(cons
                                                        std::pair<double, dvec3>{0, dvec3(0)}};
     }
 
+    if (isSymmetric(tensor)) {
+        return calculateSymmetricEigenValuesAndEigenVectors(tensor);
+    }
+
     Eigen::EigenSolver<Eigen::Matrix<double, 3, 3>> solver(util::glm2eigen(tensor));
 
     auto lambda1 = solver.eigenvalues().col(0)[0].real();
@@ -173,6 +220,13 @@ std::array<double, 3> calculateEigenValues(const dmat3& tensor) {
         return std::array<double, 3>{0, 0, 0};
     }
 
+    if (isSymmetric(tensor)) {
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 3, 3>> solver;
+        solver.computeDirect(util::glm2eigen(tensor), Eigen::EigenvaluesOnly);
+        const auto& values = solver.eigenvalues();
+        return std::array<double, 3>{values[2], values[1], values[0]};
+    }
+
     Eigen::EigenSolver<Eigen::Matrix<double, 3, 3>> solver(util::glm2eigen(tensor));
 
     auto lambda1 = solver.eigenvalues().col(0)[0].real();
@@ -314,5 +368,107 @@ dmat3 reconstruct(const std::array<double, 3>& eigenvalues,
     return S * lambda * S_inv;
 }
 
+namespace {
+// Eigen system of a symmetric 2x2 tensor, sorted such that lambda1 >= lambda2
+std::array<std::pair<double, dvec2>, 2> symmetricEigenSystem(const dmat2& tensor) {
+    const auto a = tensor[0][0];
+    const auto b = tensor[0][1];
+    const auto c = tensor[1][1];
+
+    const auto mean = 0.5 * (a + c);
+    const auto radius = std::sqrt(0.25 * (a - c) * (a - c) + b * b);
+    const auto lambda1 = mean + radius;
+    const auto lambda2 = mean - radius;
+
+    dvec2 v1{1.0, 0.0};
+    if (radius > 0.0) {
+        // Pick the numerically larger of the two equivalent expressions for the eigenvector
+        v1 = a >= c ? dvec2(lambda1 - c, b) : dvec2(b, lambda1 - a);
+        v1 = glm::normalize(v1);
+    }
+    return {{{lambda1, v1}, {lambda2, dvec2(-v1.y, v1.x)}}};
+}
+}  // namespace
+
+bool isSymmetric(const dmat2& tensor, double epsilon) {
+    const auto scale = std::max({std::abs(tensor[0][0]), std::abs(tensor[0][1]),
+                                 std::abs(tensor[1][0]), std::abs(tensor[1][1])});
+    return std::abs(tensor[0][1] - tensor[1][0]) <= epsilon * scale;
+}
+
+std::optional<dmat2> logTensor(const dmat2& tensor) {
+    if (!isSymmetric(tensor)) return std::nullopt;
+
+    dmat2 result(0.0);
+    for (const auto& [lambda, v] : symmetricEigenSystem(tensor)) {
+        if (!(lambda > 0.0)) return std::nullopt;
+        result += std::log(lambda) * glm::outerProduct(v, v);
+    }
+    return result;
+}
+
+std::optional<dmat3> logTensor(const dmat3& tensor) {
+    if (!isSymmetric(tensor)) return std::nullopt;
+
+    return logTensor(calculateSymmetricEigenValuesAndEigenVectors(tensor));
+}
+
+std::optional<dmat3> logTensor(const std::array<std::pair<double, dvec3>, 3>& eigenSystem) {
+    dmat3 result(0.0);
+    for (const auto& [lambda, v] : eigenSystem) {
+        if (!(lambda > 0.0)) return std::nullopt;
+        result += std::log(lambda) * glm::outerProduct(v, v);
+    }
+    return result;
+}
+
+void calculateSymmetricEigenSystems(const dmat2* tensors, size_t count, double* majorEigenValues,
+                                    double* minorEigenValues, dvec2* majorEigenVectors,
+                                    dvec2* minorEigenVectors) {
+    for (size_t i = 0; i < count; ++i) {
+        const auto a = tensors[i][0][0];
+        const auto b = tensors[i][0][1];
+        const auto c = tensors[i][1][1];
+
+        const auto mean = 0.5 * (a + c);
+        const auto half = 0.5 * (a - c);
+        const auto radius = std::sqrt(half * half + b * b);
+        const auto isotropic = radius == 0.0;
+
+        // With the major eigenvector at angle theta, cos(theta)^2 = (radius + half) / (2 radius)
+        // and sin(theta)^2 = (radius - half) / (2 radius). The cancelling one of the two sums is
+        // computed as b^2 / (radius + |half|) instead.
+        const auto large = isotropic ? 1.0 : radius + std::abs(half);
+        const auto small = isotropic ? 0.0 : (b * b) / large;
+        const auto denominator = isotropic ? 1.0 : 2.0 * radius;
+        const auto cos2 = (half >= 0.0 ? large : small) / denominator;
+        const auto sin2 = (half >= 0.0 ? small : large) / denominator;
+
+        const auto cosTheta = std::sqrt(cos2);
+        const auto sinTheta = std::copysign(std::sqrt(sin2), b);
+
+        majorEigenValues[i] = mean + radius;
+        minorEigenValues[i] = mean - radius;
+        majorEigenVectors[i] = dvec2(cosTheta, sinTheta);
+        minorEigenVectors[i] = dvec2(-sinTheta, cosTheta);
+    }
+}
+
+dmat2 expTensor(const dmat2& tensor) {
+    dmat2 result(0.0);
+    for (const auto& [lambda, v] : symmetricEigenSystem(tensor)) {
+        result += std::exp(lambda) * glm::outerProduct(v, v);
+    }
+    return result;
+}
+
+dmat3 expTensor(const dmat3& tensor) {
+    dmat3 result(0.0);
+    for (const auto& [lambda, v] : calculateSymmetricEigenValuesAndEigenVectors(tensor)) {
+        result += std::exp(lambda) * glm::outerProduct(v, v);
+    }
+    return result;
+}
+
 }  // namespace tensorutil
 }  // namespace inviwo
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisbase/util/volumerange.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace inviwo {
+namespace tensorutil {
+
+namespace {
+
+dvec2 emptyRange() {
+    return {std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+}
+
+dvec2 combine(const dvec2& a, const dvec2& b) {
+    return {std::min(a.x, b.x), std::max(a.y, b.y)};
+}
+
+}  // namespace
+
+VolumeRangeSummary::VolumeRangeSummary(const VolumeRAM& volume, size_t brickSize)
+    : dims_{volume.getDimensions()}
+    , brickSize_{std::max<size_t>(brickSize, 1)}
+    , bricks_{(dims_ + brickSize_ - size_t{1}) / brickSize_}
+    , brickRanges_(glm::compMul(bricks_), emptyRange()) {
+
+    volume.dispatch<void, dispatching::filter::All>([&](auto ram) {
+        using ValueType = util::PrecisionValueType<decltype(ram)>;
+        using Primitive = typename util::value_type<ValueType>::type;
+        constexpr size_t components = util::extent<ValueType>::value;
+        const auto data = reinterpret_cast<const Primitive*>(ram->getDataTyped());
+
+        util::forEachRangeParallel(brickRanges_.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                const size3_t brick{b % bricks_.x, (b / bricks_.x) % bricks_.y,
+                                    b / (bricks_.x * bricks_.y)};
+                const size3_t lower = brick * brickSize_;
+                const size3_t upper = glm::min(lower + brickSize_, dims_);
+                const size_t rowSize = components * (upper.x - lower.x);
+
+                auto lo = std::numeric_limits<Primitive>::max();
+                auto hi = std::numeric_limits<Primitive>::lowest();
+                for (size_t z = lower.z; z < upper.z; ++z) {
+                    for (size_t y = lower.y; y < upper.y; ++y) {
+                        const auto row =
+                            data + components * (lower.x + dims_.x * (y + dims_.y * z));
+                        for (size_t i = 0; i < rowSize; ++i) {
+                            lo = std::min(lo, row[i]);
+                            hi = std::max(hi, row[i]);
+                        }
+                    }
+                }
+                brickRanges_[b] = dvec2{static_cast<double>(lo), static_cast<double>(hi)};
+            }
+        });
+    });
+
+    for (const auto& r : brickRanges_) {
+        range_ = combine(range_, r);
+    }
+}
+
+dvec2 VolumeRangeSummary::range(const size3_t& lower, const size3_t& upper) const {
+    auto result = emptyRange();
+    if (glm::any(glm::greaterThan(lower, upper)) ||
+        glm::any(glm::greaterThanEqual(lower, dims_))) {
+        return result;
+    }
+    const size3_t first = lower / brickSize_;
+    const size3_t last = glm::min(upper, dims_ - size_t{1}) / brickSize_;
+    for (size_t z = first.z; z <= last.z; ++z) {
+        for (size_t y = first.y; y <= last.y; ++y) {
+            for (size_t x = first.x; x <= last.x; ++x) {
+                result = combine(result, brickRanges_[x + bricks_.x * (y + bricks_.y * z)]);
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace tensorutil
+}  // namespace inviwo
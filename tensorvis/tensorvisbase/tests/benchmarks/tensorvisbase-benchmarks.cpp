@@ -0,0 +1,267 @@
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/tensorvisbase/tensorvisbasemodule.h>
+#include <inviwo/tensorvisbase/tensorvisbasemodulesharedlibrary.h>
+#include <inviwo/tensorvisbase/algorithm/tensorfieldgeneration.h>
+#include <inviwo/tensorvisbase/algorithm/tensorfieldsampling.h>
+#include <inviwo/tensorvisbase/datastructures/hyperstreamlinetracer.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/tensorvisbase/properties/tensorglyphproperty.h>
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <warn/pop>
+
+#include <cmath>
+
+/*
+ * Throughput benchmarks of the hot paths of the module on synthetic fields. The field size is
+ * the benchmark argument, the number of voxels n^3 is reported as items processed.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+// Smoothly varying, symmetric positive definite tensors I + v v^T
+std::vector<dmat3> syntheticTensors(const size3_t& dimensions) {
+    std::vector<dmat3> tensors;
+    tensors.reserve(dimensions.x * dimensions.y * dimensions.z);
+    for (size_t z = 0; z < dimensions.z; ++z) {
+        for (size_t y = 0; y < dimensions.y; ++y) {
+            for (size_t x = 0; x < dimensions.x; ++x) {
+                const dvec3 p = dvec3(x, y, z) / dvec3(dimensions);
+                const dvec3 v{std::sin(6.0 * p.y), std::cos(6.0 * p.x), 2.0 * p.z - 1.0};
+                tensors.push_back(dmat3(1.0) + glm::outerProduct(v, v));
+            }
+        }
+    }
+    return tensors;
+}
+
+std::shared_ptr<TensorField3D> syntheticField(size_t size) {
+    const size3_t dimensions{size};
+    return std::make_shared<TensorField3D>(dimensions, syntheticTensors(dimensions));
+}
+
+// Positions spread quasi randomly over the unit cube
+std::vector<dvec3> samplePositions(size_t count) {
+    std::vector<dvec3> positions(count);
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = dvec3(std::fmod(i * 0.618034, 1.0), std::fmod(i * 0.414214, 1.0),
+                             std::fmod(i * 0.732051, 1.0));
+    }
+    return positions;
+}
+
+void setVoxelItems(benchmark::State& state) {
+    const auto size = static_cast<int64_t>(state.range(0));
+    state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+}  // namespace
+
+static void symmetricEigenDecomposition(benchmark::State& state) {
+    const auto tensors = syntheticTensors(size3_t(static_cast<size_t>(state.range(0))));
+    for (auto _ : state) {
+        for (const auto& tensor : tensors) {
+            benchmark::DoNotOptimize(
+                tensorutil::calculateSymmetricEigenValuesAndEigenVectors(tensor));
+        }
+    }
+    setVoxelItems(state);
+}
+BENCHMARK(symmetricEigenDecomposition)->Arg(32)->Arg(64);
+
+static void tensorFieldEigenDecomposition(benchmark::State& state) {
+    const size3_t dimensions{static_cast<size_t>(state.range(0))};
+    const auto tensors = syntheticTensors(dimensions);
+    for (auto _ : state) {
+        const TensorField3D tensorField(dimensions, tensors);
+        benchmark::DoNotOptimize(tensorField.majorEigenValues().data());
+    }
+    setVoxelItems(state);
+}
+BENCHMARK(tensorFieldEigenDecomposition)->Arg(32)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void tensorFieldGeneration(benchmark::State& state) {
+    tensorutil::SyntheticTensorField3D settings;
+    settings.dimensions = size3_t(static_cast<size_t>(state.range(0)));
+    settings.noise = 0.1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tensorutil::generateTensorField3D(settings));
+    }
+    setVoxelItems(state);
+}
+BENCHMARK(tensorFieldGeneration)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond);
+
+static void trilinearSampling(benchmark::State& state) {
+    const auto tensorField = syntheticField(64);
+    const TensorField3DSampler sampler(*tensorField, tensorutil::InterpolationMethod::Linear);
+    const auto positions = samplePositions(static_cast<size_t>(state.range(0)));
+    std::vector<dmat3> result(positions.size());
+    for (auto _ : state) {
+        sampler.sample(positions.data(), positions.size(), result.data());
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(trilinearSampling)->Arg(1 << 16)->Arg(1 << 20);
+
+// Single position entry points of the sampling, with the interpolation method known at compile
+// time, dispatched at runtime, and bound once in a sample function or a sampler
+enum class SampleEntry { Template, Runtime, Functor, Sampler };
+
+static void samplingEntryPoint(benchmark::State& state, SampleEntry entry) {
+    constexpr auto method = tensorutil::InterpolationMethod::Linear;
+    const std::shared_ptr<const TensorField3D> tensorField = syntheticField(64);
+    const auto positions = samplePositions(static_cast<size_t>(state.range(0)));
+    const auto sampleFunction = makeSampleFunction(tensorField, method);
+    const TensorField3DSampler sampler(*tensorField, method);
+
+    const auto run = [&](auto&& fun) {
+        for (auto _ : state) {
+            dmat3 sum{0.0};
+            for (const auto& position : positions) sum += fun(position);
+            benchmark::DoNotOptimize(sum);
+        }
+    };
+    switch (entry) {
+        case SampleEntry::Template:
+            run([&](const dvec3& p) { return sample<method>(tensorField, p).second; });
+            break;
+        case SampleEntry::Runtime:
+            run([&](const dvec3& p) { return sample(tensorField, p, method).second; });
+            break;
+        case SampleEntry::Functor:
+            run([&](const dvec3& p) { return sampleFunction(p).second; });
+            break;
+        case SampleEntry::Sampler:
+            run([&](const dvec3& p) { return sampler.sample(p); });
+            break;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(samplingEntryPoint, compileTime, SampleEntry::Template)->Arg(1 << 20);
+BENCHMARK_CAPTURE(samplingEntryPoint, runtime, SampleEntry::Runtime)->Arg(1 << 20);
+BENCHMARK_CAPTURE(samplingEntryPoint, functor, SampleEntry::Functor)->Arg(1 << 20);
+BENCHMARK_CAPTURE(samplingEntryPoint, sampler, SampleEntry::Sampler)->Arg(1 << 20);
+
+// The per voxel invariants computed by the Tensor Field 3D Meta Data processor
+static void metaDataComputation(benchmark::State& state) {
+    const auto tensors = syntheticTensors(size3_t(static_cast<size_t>(state.range(0))));
+    std::vector<double> values(tensors.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            const auto& t = tensors[i];
+            values[i] = tensorutil::calculateI1(t) + tensorutil::calculateI2(t) +
+                        tensorutil::calculateI3(t) + tensorutil::calculateJ2(t) +
+                        tensorutil::calculateJ3(t) + tensorutil::calculateLodeAngle(t);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    setVoxelItems(state);
+}
+BENCHMARK(metaDataComputation)->Arg(32)->Arg(64);
+
+static void hyperstreamlineTracing(benchmark::State& state) {
+    const auto tensorField = syntheticField(64);
+    const auto dimensions = tensorField->getDimensions();
+
+    auto ram = std::make_shared<VolumeRAMPrecision<dvec3>>(dimensions);
+    std::copy(tensorField->majorEigenVectors().begin(), tensorField->majorEigenVectors().end(),
+              ram->getDataTyped());
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(tensorField->getBasis());
+    volume->setOffset(tensorField->getOffset());
+    auto sampler = std::make_shared<VolumeDoubleSampler<3>>(volume);
+
+    IntegralLineProperties properties("properties", "Properties");
+    properties.normalizeSamples_.set(true);
+    HyperStreamLineTracer tracer(sampler, properties);
+
+    const auto seeds = samplePositions(static_cast<size_t>(state.range(0)));
+    size_t numPoints = 0;
+    for (auto _ : state) {
+        for (const auto& seed : seeds) {
+            numPoints += tracer.traceFrom(seed).line.getPositions().size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["points"] = benchmark::Counter(static_cast<double>(numPoints),
+                                                  benchmark::Counter::kIsRate);
+}
+BENCHMARK(hyperstreamlineTracing)->Arg(256)->Unit(benchmark::kMillisecond);
+
+// Same as hyperstreamlineTracing but appending all lines to one packed line set
+static void hyperstreamlineTracingPacked(benchmark::State& state) {
+    const auto tensorField = syntheticField(64);
+    const auto dimensions = tensorField->getDimensions();
+
+    auto ram = std::make_shared<VolumeRAMPrecision<dvec3>>(dimensions);
+    std::copy(tensorField->majorEigenVectors().begin(), tensorField->majorEigenVectors().end(),
+              ram->getDataTyped());
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(tensorField->getBasis());
+    volume->setOffset(tensorField->getOffset());
+    auto sampler = std::make_shared<VolumeDoubleSampler<3>>(volume);
+
+    IntegralLineProperties properties("properties", "Properties");
+    properties.normalizeSamples_.set(true);
+    HyperStreamLineTracer tracer(sampler, properties);
+
+    const auto seeds = samplePositions(static_cast<size_t>(state.range(0)));
+    size_t numPoints = 0;
+    for (auto _ : state) {
+        PackedLineSet lines;
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            tracer.traceInto(seeds[i], i, lines);
+        }
+        numPoints += lines.getNumberOfVertices();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["points"] = benchmark::Counter(static_cast<double>(numPoints),
+                                                  benchmark::Counter::kIsRate);
+}
+BENCHMARK(hyperstreamlineTracingPacked)->Arg(256)->Unit(benchmark::kMillisecond);
+
+static void glyphGeneration(benchmark::State& state) {
+    const auto tensors = syntheticTensors(size3_t(static_cast<size_t>(state.range(0))));
+    TensorGlyphProperty glyph;
+    for (auto _ : state) {
+        for (const auto& tensor : tensors) {
+            benchmark::DoNotOptimize(glyph.generateGlyph(tensor, dvec3(0.0), 1.0f));
+        }
+    }
+    setVoxelItems(state);
+}
+BENCHMARK(glyphGeneration)->Arg(8)->Arg(16)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    inviwo::LogCentral::init();
+
+    // The application provides the thread pool used by the parallel code paths
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-TensorVisBase");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        modules.emplace_back(createTensorVisBaseModule());
+        app.registerModules(std::move(modules));
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/bitmask.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace {
+
+// Sizes that are not a multiple of the word size, with set bits on both sides of word borders
+std::vector<glm::uint8> testBytes(size_t size, size_t period) {
+    std::vector<glm::uint8> bytes(size, 0);
+    for (size_t i = 0; i < size; ++i) bytes[i] = (i % period == 0 || i % 64 == 63) ? 1 : 0;
+    return bytes;
+}
+
+}  // namespace
+
+TEST(BitMaskTests, bytesRoundTrip) {
+    const auto bytes = testBytes(200, 3);
+    const BitMask mask(bytes);
+
+    EXPECT_EQ(200, mask.size());
+    EXPECT_EQ(4 * sizeof(BitMask::Word), mask.sizeInBytes());
+    EXPECT_EQ(bytes, mask.toBytes());
+    EXPECT_EQ(static_cast<size_t>(std::count(bytes.begin(), bytes.end(), 1)), mask.count());
+
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        if (bytes[i]) indices.push_back(i);
+    }
+    EXPECT_EQ(indices, mask.setIndices());
+
+    const auto words = mask.toWords32();
+    ASSERT_EQ(size_t{7}, words.size());
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        EXPECT_EQ(bytes[i] != 0, ((words[i / 32] >> (i % 32)) & 1u) != 0) << i;
+    }
+}
+
+TEST(BitMaskTests, wordParallelOperations) {
+    const auto a = testBytes(130, 2);
+    const auto b = testBytes(130, 3);
+    const BitMask maskA(a);
+    const BitMask maskB(b);
+
+    const auto both = maskA & maskB;
+    const auto either = maskA | maskB;
+    auto onlyA = maskA;
+    onlyA.subtract(maskB);
+    auto inverted = maskA;
+    inverted.flip();
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i] && b[i], both[i]) << "bit " << i;
+        EXPECT_EQ(a[i] || b[i], either[i]) << "bit " << i;
+        EXPECT_EQ(a[i] && !b[i], onlyA[i]) << "bit " << i;
+        EXPECT_EQ(!a[i], inverted[i]) << "bit " << i;
+    }
+    // the bits past the end stay clear
+    EXPECT_EQ(a.size() - maskA.count(), inverted.count());
+    EXPECT_EQ(130, BitMask(130, true).count());
+
+    EXPECT_THROW(maskA & BitMask(129), Exception);
+}
+
+TEST(BitMaskTests, copyBitsAcrossWords) {
+    const auto bytes = testBytes(300, 5);
+    const BitMask src(bytes);
+    BitMask dst(300, true);
+
+    dst.copyBits(src, 37, 101, 150);
+    for (size_t i = 0; i < dst.size(); ++i) {
+        const bool expected = (i >= 101 && i < 251) ? bytes[i - 101 + 37] != 0 : true;
+        EXPECT_EQ(expected, dst[i]) << "bit " << i;
+    }
+}
+
+TEST(BitMaskTests, tensorFieldMask) {
+    const size3_t dimensions{5, 4, 3};
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < 60; ++i) tensors.push_back(dmat3(static_cast<double>(i + 1)));
+    TensorField3D tensorField(dimensions, tensors);
+    EXPECT_FALSE(tensorField.hasMask());
+
+    const auto bytes = testBytes(60, 4);
+    tensorField.setMask(bytes);
+    ASSERT_TRUE(tensorField.hasMask());
+    EXPECT_EQ(bytes, tensorField.getMask().toBytes());
+    EXPECT_EQ(static_cast<int>(tensorField.getMask().count()),
+              tensorField.getNumDefinedEntries());
+    EXPECT_EQ(tensorField.getMask().setIndices(), tensorField.definedIndices());
+    EXPECT_EQ(1, tensorField.at(size_t{4}).first);
+    EXPECT_EQ(0, tensorField.at(size_t{5}).first);
+
+    tensorField.setTensorStorage(TensorStorage::Sparse);
+    ASSERT_NE(nullptr, tensorField.sparseTensors());
+    EXPECT_EQ(tensorField.getMask().setIndices(), tensorField.sparseTensors()->indices());
+    EXPECT_EQ(dmat3(5.0), tensorField.tensor(4));
+    EXPECT_EQ(dmat3(0.0), tensorField.tensor(5));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,89 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+
+namespace inviwo {
+TEST(TensorUtilTests, isSymmetric) {
+    const dmat3 symmetric{4.0, 1.0, 0.5, 1.0, 3.0, 0.25, 0.5, 0.25, 2.0};
+    const dmat3 nonSymmetric{4.0, 1.0, 0.5, 2.0, 3.0, 0.25, 0.5, 0.25, 2.0};
+
+    EXPECT_TRUE(tensorutil::isSymmetric(symmetric));
+    EXPECT_FALSE(tensorutil::isSymmetric(nonSymmetric));
+    EXPECT_TRUE(tensorutil::isSymmetric(dmat3(0.0)));
+}
+
+TEST(TensorUtilTests, symmetricEigenSystemIsSorted) {
+    const dmat3 tensor{1.0, 0.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0, 2.0};
+
+    const auto eigen = tensorutil::calculateSymmetricEigenValuesAndEigenVectors(tensor);
+
+    EXPECT_DOUBLE_EQ(3.0, eigen[0].first);
+    EXPECT_DOUBLE_EQ(2.0, eigen[1].first);
+    EXPECT_DOUBLE_EQ(1.0, eigen[2].first);
+
+    EXPECT_NEAR(1.0, std::abs(eigen[0].second.y), 1e-12);
+    EXPECT_NEAR(1.0, std::abs(eigen[1].second.z), 1e-12);
+    EXPECT_NEAR(1.0, std::abs(eigen[2].second.x), 1e-12);
+}
+
+TEST(TensorUtilTests, symmetricEigenSystemMatchesGeneralSolver) {
+    const dmat3 tensor{4.0, 1.0, 0.5, 1.0, 3.0, 0.25, 0.5, 0.25, 2.0};
+
+    const auto eigen = tensorutil::calculateSymmetricEigenValuesAndEigenVectors(tensor);
+
+    Eigen::EigenSolver<Eigen::Matrix<double, 3, 3>> solver(util::glm2eigen(tensor));
+    std::array<double, 3> reference{solver.eigenvalues()[0].real(), solver.eigenvalues()[1].real(),
+                                    solver.eigenvalues()[2].real()};
+    std::sort(reference.begin(), reference.end(), std::greater<double>());
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(reference[i], eigen[i].first, 1e-10);
+
+        // T * v == lambda * v
+        const auto lhs = tensor * eigen[i].second;
+        const auto rhs = eigen[i].first * eigen[i].second;
+        EXPECT_NEAR(lhs.x, rhs.x, 1e-10);
+        EXPECT_NEAR(lhs.y, rhs.y, 1e-10);
+        EXPECT_NEAR(lhs.z, rhs.z, 1e-10);
+        EXPECT_NEAR(1.0, glm::length(eigen[i].second), 1e-10);
+    }
+
+    const auto values = tensorutil::calculateEigenValues(tensor);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(reference[i], values[i], 1e-10);
+    }
+}
+
+TEST(TensorUtilTests, symmetricEigenSystems2D) {
+    const std::vector<dmat2> tensors{dmat2{3.0, 1.0, 1.0, 2.0}, dmat2{1.0, 0.0, 0.0, 4.0},
+                                     dmat2{2.0, 0.0, 0.0, 2.0}, dmat2{-1.0, 1e-9, 1e-9, 5.0},
+                                     dmat2{0.5, -2.0, -2.0, 0.5}};
+    const auto n = tensors.size();
+
+    std::vector<double> major(n), minor(n);
+    std::vector<dvec2> majorVectors(n), minorVectors(n);
+    tensorutil::calculateSymmetricEigenSystems(tensors.data(), n, major.data(), minor.data(),
+                                               majorVectors.data(), minorVectors.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_GE(major[i], minor[i]);
+        EXPECT_NEAR(tensors[i][0][0] + tensors[i][1][1], major[i] + minor[i], 1e-12);
+        EXPECT_NEAR(1.0, glm::length(majorVectors[i]), 1e-12);
+        EXPECT_NEAR(0.0, glm::dot(majorVectors[i], minorVectors[i]), 1e-12);
+
+        // T * v == lambda * v
+        const auto lhs = tensors[i] * majorVectors[i];
+        const auto rhs = major[i] * majorVectors[i];
+        EXPECT_NEAR(lhs.x, rhs.x, 1e-10);
+        EXPECT_NEAR(lhs.y, rhs.y, 1e-10);
+    }
+
+    // Isotropic tensors get the coordinate axes
+    EXPECT_EQ(dvec2(1.0, 0.0), majorVectors[2]);
+    EXPECT_EQ(dvec2(0.0, 1.0), minorVectors[2]);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,84 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/invariantspaceindex.h>
+
+#include <random>
+
+namespace inviwo {
+namespace {
+InvariantSpace randomInvariantSpace(size_t numElements, size_t numDims) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    InvariantSpace invariantSpace;
+    for (size_t i = 0; i < numDims; ++i) {
+        InvariantSpaceAxis axis(numElements);
+        for (auto& v : axis) v = dist(gen);
+        invariantSpace.addAxis(std::to_string(i), std::move(axis), TensorFeature::Unspecified);
+    }
+    return invariantSpace;
+}
+
+InvariantSpaceIndex::Selection linearScan(const InvariantSpace& invariantSpace,
+                                          const std::vector<dvec2>& ranges) {
+    InvariantSpaceIndex::Selection selection(invariantSpace.getNumElements(), false);
+    for (size_t row = 0; row < selection.size(); ++row) {
+        bool inside = true;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            const auto v = invariantSpace.get(i, row);
+            inside = inside && v >= ranges[i].x && v <= ranges[i].y;
+        }
+        selection[row] = inside;
+    }
+    return selection;
+}
+}  // namespace
+
+TEST(InvariantSpaceIndexTests, count) {
+    InvariantSpace invariantSpace;
+    invariantSpace.addAxis("a", InvariantSpaceAxis{3.0, 1.0, 2.0, 2.0, 5.0},
+                           TensorFeature::Unspecified);
+    const InvariantSpaceIndex index(invariantSpace);
+
+    EXPECT_EQ(3, index.count(0, dvec2(2.0, 3.0)));
+    EXPECT_EQ(5, index.count(0, dvec2(0.0, 10.0)));
+    EXPECT_EQ(0, index.count(0, dvec2(3.5, 4.5)));
+    EXPECT_EQ(0, index.count(0, dvec2(3.0, 2.0)));
+}
+
+TEST(InvariantSpaceIndexTests, queryMatchesLinearScan) {
+    const auto invariantSpace = randomInvariantSpace(1000, 3);
+    const InvariantSpaceIndex index(invariantSpace);
+
+    const std::vector<dvec2> ranges{{-0.5, 0.25}, {-1.0, 1.0}, {0.0, 0.75}};
+    EXPECT_EQ(linearScan(invariantSpace, ranges), index.query(ranges));
+}
+
+TEST(InvariantSpaceIndexTests, incrementalUpdateMatchesQuery) {
+    const auto invariantSpace = randomInvariantSpace(1000, 3);
+    const InvariantSpaceIndex index(invariantSpace);
+
+    std::vector<dvec2> ranges{{-0.5, 0.25}, {-1.0, 1.0}, {0.0, 0.75}};
+    auto selection = index.query(ranges);
+
+    // Drag the brush on one axis: shift, grow, shrink, and move it out of range
+    for (const auto& range :
+         {dvec2(-0.25, 0.5), dvec2(-0.75, 0.9), dvec2(0.1, 0.2), dvec2(2.0, 3.0), dvec2(-1, 1)}) {
+        auto previous = ranges;
+        ranges[0] = range;
+        index.update(selection, previous, ranges);
+        EXPECT_EQ(linearScan(invariantSpace, ranges), selection);
+    }
+
+    // Several axes at once fall back to a full query
+    auto previous = ranges;
+    ranges[1] = dvec2(-0.5, 0.5);
+    ranges[2] = dvec2(-0.1, 0.1);
+    index.update(selection, previous, ranges);
+    EXPECT_EQ(linearScan(invariantSpace, ranges), selection);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,64 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/invariantspace.h>
+
+namespace inviwo {
+TEST(InvariantSpaceTests, metaDataAxisIsView) {
+    auto metaData = std::make_shared<I1>(std::vector<double>{3.0, 1.0, 2.0}, TensorFeature::I1);
+
+    InvariantSpace invariantSpace;
+    invariantSpace.addAxis(metaData, metaData.get());
+
+    EXPECT_EQ(3, invariantSpace.getNumElements());
+    EXPECT_EQ(&metaData->getData(), &invariantSpace[0]);
+    EXPECT_DOUBLE_EQ(1.0, invariantSpace.getMinMax(0)[0]);
+    EXPECT_DOUBLE_EQ(3.0, invariantSpace.getMinMax(0)[1]);
+
+    // The view keeps the meta data alive
+    const auto* data = &metaData->getData();
+    metaData.reset();
+    EXPECT_EQ(data, &invariantSpace[0]);
+    EXPECT_DOUBLE_EQ(2.0, invariantSpace.get(0, 2));
+}
+
+TEST(InvariantSpaceTests, copyOnWrite) {
+    auto metaData = std::make_shared<I1>(std::vector<double>{3.0, 1.0}, TensorFeature::I1);
+
+    InvariantSpace invariantSpace;
+    invariantSpace.addAxis(metaData, metaData.get());
+    invariantSpace.addAxis("b", InvariantSpaceAxis{5.0, 6.0}, TensorFeature::Unspecified);
+
+    const InvariantSpace copy = invariantSpace;
+    EXPECT_EQ(&copy[1], &invariantSpace[1]);
+
+    invariantSpace.addPoint({4.0, 7.0});
+
+    EXPECT_EQ(3, invariantSpace.getNumElements());
+    EXPECT_EQ(2, copy.getNumElements());
+    EXPECT_EQ(2, metaData->getData().size());
+    EXPECT_DOUBLE_EQ(4.0, invariantSpace.getMinMax(0)[1]);
+    EXPECT_DOUBLE_EQ(7.0, invariantSpace.get(1, 2));
+}
+
+TEST(InvariantSpaceTests, getPointAndSelect) {
+    InvariantSpace invariantSpace;
+    invariantSpace.addAxis("a", InvariantSpaceAxis{1.0, 2.0, 3.0}, TensorFeature::Unspecified);
+    invariantSpace.addAxis("b", InvariantSpaceAxis{4.0, 5.0, 6.0}, TensorFeature::Unspecified);
+
+    std::vector<double> point;
+    invariantSpace.getPoint(1, point);
+    EXPECT_EQ((std::vector<double>{2.0, 5.0}), point);
+    EXPECT_EQ((std::vector<double>{1.0, 4.0, 2.0, 5.0, 3.0, 6.0}), invariantSpace.flatten());
+
+    const auto selection = invariantSpace.select({2, 0});
+    EXPECT_EQ(2, selection->getNumberOfDimensions());
+    EXPECT_EQ((InvariantSpaceAxis{3.0, 1.0}), (*selection)[0]);
+    EXPECT_EQ((InvariantSpaceAxis{6.0, 4.0}), (*selection)[1]);
+    EXPECT_EQ("b", selection->getIdentifier(1));
+    EXPECT_DOUBLE_EQ(4.0, selection->getMinMax(1)[0]);
+}
+
+}  // namespace inviwo
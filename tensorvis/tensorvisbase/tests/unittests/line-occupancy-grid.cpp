@@ -0,0 +1,87 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/lineoccupancygrid.h>
+#include <inviwo/core/util/exception.h>
+
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+TEST(LineOccupancyGridTests, findsSamplesWithinDistance) {
+    LineOccupancyGrid grid(dvec3{0.0}, dvec3{1.0}, 0.1);
+    const auto tag = grid.newLineTag();
+    EXPECT_NE(uint32_t{0}, tag);
+
+    EXPECT_FALSE(grid.isOccupied(dvec3{0.5}, 0.1));
+    EXPECT_TRUE(grid.insert(dvec3{0.5}, tag));
+
+    EXPECT_TRUE(grid.isOccupied(dvec3{0.55, 0.5, 0.5}, 0.1));
+    // neighbouring cell
+    EXPECT_TRUE(grid.isOccupied(dvec3{0.5, 0.59, 0.5}, 0.1));
+    EXPECT_FALSE(grid.isOccupied(dvec3{0.55, 0.5, 0.5}, 0.04));
+    EXPECT_FALSE(grid.isOccupied(dvec3{0.5, 0.5, 0.75}, 0.1));
+}
+
+TEST(LineOccupancyGridTests, ignoresSamplesOfOwnLine) {
+    LineOccupancyGrid grid(dvec3{0.0}, dvec3{1.0}, 0.1);
+    const auto a = grid.newLineTag();
+    const auto b = grid.newLineTag();
+    EXPECT_NE(a, b);
+
+    grid.insert(dvec3{0.2}, a);
+    EXPECT_FALSE(grid.isOccupied(dvec3{0.21}, 0.1, a));
+    EXPECT_TRUE(grid.isOccupied(dvec3{0.21}, 0.1, b));
+}
+
+TEST(LineOccupancyGridTests, ignoresSamplesOutsideGrid) {
+    LineOccupancyGrid grid(dvec3{0.0}, dvec3{1.0}, 0.1);
+    EXPECT_FALSE(grid.insert(dvec3{-0.01, 0.5, 0.5}, grid.newLineTag()));
+    EXPECT_FALSE(grid.insert(dvec3{0.5, 1.2, 0.5}, grid.newLineTag()));
+    EXPECT_FALSE(grid.isOccupied(dvec3{0.0, 0.5, 0.5}, 0.1));
+    EXPECT_FALSE(grid.isOccupied(dvec3{5.0}, 0.1));
+}
+
+TEST(LineOccupancyGridTests, dropsSamplesInFullCells) {
+    LineOccupancyGrid grid(dvec3{0.0}, dvec3{1.0}, 0.1);
+    const auto tag = grid.newLineTag();
+    for (size_t i = 0; i < LineOccupancyGrid::slotsPerCell; ++i) {
+        EXPECT_TRUE(grid.insert(dvec3{0.51 + 0.001 * static_cast<double>(i)}, tag));
+    }
+    EXPECT_FALSE(grid.insert(dvec3{0.52}, tag));
+}
+
+TEST(LineOccupancyGridTests, throwsForTooManyCells) {
+    EXPECT_THROW(LineOccupancyGrid(dvec3{0.0}, dvec3{1.0}, 0.0), Exception);
+    EXPECT_THROW(LineOccupancyGrid(dvec3{0.0}, dvec3{1.0}, 1e-4), Exception);
+}
+
+TEST(LineOccupancyGridTests, concurrentInsertsAreVisible) {
+    LineOccupancyGrid grid(dvec3{0.0}, dvec3{1.0}, 0.05);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&grid, t]() {
+            const auto tag = grid.newLineTag();
+            for (size_t i = 0; i < 20; ++i) {
+                grid.insert(dvec3{0.025 + 0.05 * static_cast<double>(i),
+                                  0.125 + 0.25 * static_cast<double>(t), 0.5},
+                            tag);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (size_t t = 0; t < 4; ++t) {
+        for (size_t i = 0; i < 20; ++i) {
+            EXPECT_TRUE(grid.isOccupied(dvec3{0.025 + 0.05 * static_cast<double>(i),
+                                              0.125 + 0.25 * static_cast<double>(t), 0.51},
+                                        0.05));
+        }
+    }
+}
+
+}  // namespace inviwo
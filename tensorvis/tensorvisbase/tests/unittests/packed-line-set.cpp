@@ -0,0 +1,105 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/packedlineset.h>
+#include <inviwo/core/util/exception.h>
+
+namespace inviwo {
+
+namespace {
+void addLine(PackedLineSet& lines, size_t seedID, size_t numVertices) {
+    auto& positions = lines.getPositions();
+    auto& velocities = lines.getMetaData("velocity", true);
+    for (size_t i = 0; i < numVertices; ++i) {
+        positions.emplace_back(static_cast<double>(seedID), static_cast<double>(i), 0.0);
+        velocities.emplace_back(1.0, 0.0, 0.0);
+    }
+    PackedLineSet::LineInfo info;
+    info.seedID = seedID;
+    lines.commitLine(info);
+}
+}  // namespace
+
+TEST(PackedLineSetTests, offsetsDelimitLines) {
+    PackedLineSet lines;
+    addLine(lines, 0, 3);
+    addLine(lines, 1, 2);
+
+    ASSERT_EQ(size_t{2}, lines.size());
+    EXPECT_EQ(size_t{5}, lines.getNumberOfVertices());
+    EXPECT_EQ((std::vector<size_t>{0, 3, 5}), lines.getOffsets());
+    EXPECT_EQ(dvec3(1.0, 0.0, 0.0), lines.getPositions()[3]);
+}
+
+TEST(PackedLineSetTests, discardRemovesUncommittedVertices) {
+    PackedLineSet lines;
+    addLine(lines, 0, 3);
+    lines.getPositions().emplace_back(0.0);
+    lines.getMetaData("velocity").emplace_back(0.0);
+    lines.discardLine();
+
+    EXPECT_EQ(size_t{1}, lines.size());
+    EXPECT_EQ(size_t{3}, lines.getPositions().size());
+    EXPECT_EQ(size_t{3}, lines.getMetaData("velocity").size());
+}
+
+TEST(PackedLineSetTests, commitThrowsForMismatchedChannels) {
+    PackedLineSet lines;
+    lines.getMetaData("velocity", true);
+    lines.getPositions().emplace_back(0.0);
+    EXPECT_THROW(lines.commitLine({}), Exception);
+}
+
+TEST(PackedLineSetTests, appendKeepsLineOrder) {
+    PackedLineSet lines;
+    addLine(lines, 0, 2);
+
+    PackedLineSet other;
+    addLine(other, 1, 4);
+    addLine(other, 2, 3);
+    lines.append(std::move(other));
+
+    ASSERT_EQ(size_t{3}, lines.size());
+    EXPECT_EQ((std::vector<size_t>{0, 2, 6, 9}), lines.getOffsets());
+    EXPECT_EQ(size_t{9}, lines.getMetaData("velocity").size());
+    EXPECT_EQ(size_t{2}, lines.getLineInfos()[2].seedID);
+    EXPECT_EQ(dvec3(2.0, 0.0, 0.0), lines.getPositions()[6]);
+}
+
+TEST(PackedLineSetTests, appendToEmptySetTakesChannels) {
+    PackedLineSet lines;
+    PackedLineSet other;
+    addLine(other, 5, 2);
+    lines.append(std::move(other));
+
+    ASSERT_EQ(size_t{1}, lines.size());
+    EXPECT_TRUE(lines.hasMetaData("velocity"));
+}
+
+TEST(PackedLineSetTests, convertsToIntegralLineSet) {
+    PackedLineSet lines;
+    addLine(lines, 3, 2);
+    addLine(lines, 7, 4);
+
+    const auto set = lines.toIntegralLineSet();
+    ASSERT_EQ(size_t{2}, set->size());
+    EXPECT_EQ(size_t{4}, set->at(1).getPositions().size());
+    EXPECT_EQ(size_t{4}, set->at(1).getMetaData<dvec3>("velocity").size());
+    EXPECT_EQ(size_t{7}, set->at(1).getIndex());
+}
+
+TEST(PackedLineSetTests, meshHasOneSegmentPerStep) {
+    PackedLineSet lines;
+    addLine(lines, 0, 3);
+    addLine(lines, 1, 2);
+
+    const auto mesh = lines.toMesh();
+    ASSERT_EQ(size_t{1}, mesh->getNumberOfBuffers());
+    EXPECT_EQ(size_t{5}, mesh->getBuffer(0)->getSize());
+    ASSERT_EQ(size_t{1}, mesh->getNumberOfIndicies());
+    EXPECT_EQ(size_t{6}, mesh->getIndices(0)->getSize());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,81 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/symmetrictensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/sparsetensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+
+namespace inviwo {
+TEST(TensorStorageTests, symmetric3DRoundTrip) {
+    const std::vector<dmat3> tensors{dmat3{4.0, 1.0, 0.5, 1.0, 3.0, 0.25, 0.5, 0.25, 2.0},
+                                     dmat3{1.0, -2.0, 3.0, -2.0, 5.0, 6.0, 3.0, 6.0, 9.0}};
+
+    const SymmetricTensorStorage3D<double> storage(tensors);
+
+    EXPECT_EQ(2, storage.size());
+    EXPECT_EQ(6 * 2 * sizeof(double), storage.sizeInBytes());
+    EXPECT_EQ(tensors[0], storage.get(0));
+    EXPECT_EQ(tensors[1], storage.get(1));
+    EXPECT_EQ(tensors, storage.toTensors());
+
+    // xx, yy, zz, xy, yz, xz
+    EXPECT_DOUBLE_EQ(5.0, storage.component(1)[1]);
+    EXPECT_DOUBLE_EQ(-2.0, storage.component(3)[1]);
+    EXPECT_DOUBLE_EQ(6.0, storage.component(4)[1]);
+    EXPECT_DOUBLE_EQ(3.0, storage.component(5)[1]);
+}
+
+TEST(TensorStorageTests, symmetric2DFloatRoundTrip) {
+    const std::vector<dmat2> tensors{dmat2{0.5, 0.25, 0.25, 2.0}};
+
+    const SymmetricTensorStorage2D<float> storage(tensors);
+
+    EXPECT_EQ(3 * sizeof(float), storage.sizeInBytes());
+    EXPECT_EQ(tensors[0], storage.get(0));
+}
+
+TEST(TensorStorageTests, fullFloatKeepsAntisymmetricPart) {
+    const std::vector<dmat3> tensors{dmat3{1.0, 2.0, 3.0, -2.0, 5.0, 6.0, 0.5, 0.25, 9.0}};
+
+    const FullTensorStorage3D<float> storage(tensors);
+
+    EXPECT_EQ(9 * sizeof(float), storage.sizeInBytes());
+    EXPECT_EQ(tensors[0], storage.get(0));
+    EXPECT_EQ(tensors, storage.toTensors());
+}
+
+TEST(TensorStorageTests, floatInputKeepsPrecision) {
+    std::vector<float> data(2 * 9);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = 0.5f * static_cast<float>(i);
+
+    TensorField3D tensorField(size3_t{2, 1, 1}, data.data());
+
+    EXPECT_EQ(TensorStorage::FullFloat, tensorField.getTensorStorage());
+    ASSERT_NE(nullptr, tensorField.floatTensors());
+    EXPECT_DOUBLE_EQ(0.5, tensorField.tensor(0)[0][1]);
+    EXPECT_DOUBLE_EQ(0.5 * 17, tensorField.tensor(1)[2][2]);
+
+    tensorField.setTensorStorage(TensorStorage::Full);
+    EXPECT_EQ(nullptr, tensorField.floatTensors());
+    EXPECT_DOUBLE_EQ(0.5 * 12, tensorField.tensors()[1][1][0]);
+}
+
+TEST(TensorStorageTests, sparseKeepsDefinedVoxels) {
+    const std::vector<dmat3> tensors{dmat3(1.0), dmat3(2.0), dmat3(3.0), dmat3(4.0)};
+    const std::vector<glm::uint8> mask{0, 1, 0, 1};
+
+    const SparseTensorStorage3D storage(tensors, mask);
+
+    EXPECT_EQ(4, storage.size());
+    EXPECT_EQ(2, storage.numDefined());
+    EXPECT_EQ((std::vector<size_t>{1, 3}), storage.indices());
+    EXPECT_EQ(dmat3(0.0), storage.get(0));
+    EXPECT_EQ(tensors[1], storage.get(1));
+    EXPECT_EQ(tensors[3], storage.get(3));
+    EXPECT_EQ((std::vector<dmat3>{dmat3(0.0), dmat3(2.0), dmat3(0.0), dmat3(4.0)}),
+              storage.toTensors());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,58 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+
+namespace inviwo {
+TEST(TensorFieldCopyTests, copySharesDataUntilModified) {
+    const size3_t dimensions{2, 2, 2};
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < 8; ++i) tensors.push_back(dmat3(static_cast<double>(i + 1)));
+    const TensorField3D tensorField(dimensions, tensors);
+
+    TensorField3D copy(tensorField);
+    EXPECT_EQ(tensorField.tensors().data(), copy.tensors().data());
+
+    // Changing the basis does not touch the shared buffers
+    copy.setOffset(vec3{1.0f, 2.0f, 3.0f});
+    EXPECT_EQ(tensorField.tensors().data(), copy.tensors().data());
+
+    copy.at(size_t{0}).second = dmat3(-1.0);
+    EXPECT_NE(tensorField.tensors().data(), copy.tensors().data());
+    EXPECT_EQ(dmat3(1.0), tensorField.tensor(0));
+    EXPECT_EQ(dmat3(-1.0), copy.tensor(0));
+    EXPECT_EQ(tensorField.tensor(1), copy.tensor(1));
+}
+
+}  // namespace inviwo
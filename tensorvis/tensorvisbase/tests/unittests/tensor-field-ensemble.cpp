@@ -0,0 +1,70 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldensemble.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+namespace inviwo {
+TEST(TensorFieldEnsembleTests, frobeniusStatistics) {
+    // Members are the isotropic tensors 1*I, 2*I and 3*I, the mean is 2*I
+    TensorField3DSequence ensemble(3, [](size_t step) {
+        return std::make_shared<TensorField3D>(size3_t(2),
+                                               std::vector<dmat3>(8, dmat3(step + 1.0)));
+    });
+
+    const auto stats =
+        tensorutil::ensembleStatistics(ensemble, tensorutil::EnsembleDistance::Frobenius);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(size3_t(2), stats->dimensions);
+    ASSERT_EQ(8u, stats->mean.size());
+
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_NEAR(2.0 * std::sqrt(3.0) / 3.0, stats->mean[i], 1e-12);
+        EXPECT_NEAR(2.0 / 3.0, stats->variance[i], 1e-12);
+        EXPECT_NEAR(1.0 / std::sqrt(2.0), stats->outlierScore[i], 1e-12);
+    }
+}
+
+TEST(TensorFieldEnsembleTests, identicalMembersHaveNoOutliers) {
+    TensorField3DSequence ensemble(4, [](size_t) {
+        return std::make_shared<TensorField3D>(
+            size3_t(2), std::vector<dmat3>(8, dmat3{3.0, 1.0, 0.0, 1.0, 2.0, 0.0, 0.0, 0.0, 1.0}));
+    });
+
+    for (auto distance :
+         {tensorutil::EnsembleDistance::Frobenius, tensorutil::EnsembleDistance::LogEuclidean,
+          tensorutil::EnsembleDistance::EigenAngle}) {
+        const auto stats = tensorutil::ensembleStatistics(ensemble, distance);
+        ASSERT_TRUE(stats.has_value());
+        for (size_t i = 0; i < 8; ++i) {
+            EXPECT_NEAR(0.0, stats->mean[i], 1e-5);
+            EXPECT_NEAR(0.0, stats->outlierScore[i], 1e-12);
+        }
+    }
+}
+
+TEST(TensorFieldEnsembleTests, statisticsInPoolJobWithSinglePoolThread) {
+    auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
+    const auto poolSize = settings->poolSize_.get();
+    settings->poolSize_.set(1);
+
+    // The loaders are queued behind the job on the only pool thread
+    TensorField3DSequence ensemble(3, [](size_t step) {
+        return std::make_shared<TensorField3D>(size3_t(2),
+                                               std::vector<dmat3>(8, dmat3(step + 1.0)));
+    });
+    const auto stats = dispatchPool([&]() {
+                           return tensorutil::ensembleStatistics(
+                               ensemble, tensorutil::EnsembleDistance::Frobenius);
+                       }).get();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_NEAR(2.0 / 3.0, stats->variance[0], 1e-12);
+
+    settings->poolSize_.set(poolSize);
+}
+
+}  // namespace inviwo
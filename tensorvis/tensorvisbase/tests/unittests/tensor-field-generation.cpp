@@ -0,0 +1,65 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldgeneration.h>
+
+namespace inviwo {
+TEST(TensorFieldGenerationTests, deterministic) {
+    tensorutil::SyntheticTensorField3D settings;
+    settings.dimensions = size3_t(8, 6, 5);
+    settings.seed = 42;
+    settings.noise = 0.2;
+
+    const auto a = tensorutil::generateTensorField3D(settings);
+    const auto b = tensorutil::generateTensorField3D(settings);
+    settings.seed = 43;
+    const auto c = tensorutil::generateTensorField3D(settings);
+
+    ASSERT_EQ(settings.dimensions, a->getDimensions());
+    bool differs = false;
+    for (size_t i = 0; i < a->getSize(); ++i) {
+        EXPECT_EQ(a->tensor(i), b->tensor(i));
+        differs |= a->tensor(i) != c->tensor(i);
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(TensorFieldGenerationTests, analyticalEigenSystem) {
+    tensorutil::SyntheticTensorField3D settings;
+    settings.dimensions = size3_t(4, 4, 4);
+    settings.noise = 0.5;
+    settings.storage = TensorStorage::Full;
+
+    const auto tensorField = tensorutil::generateTensorField3D(settings);
+    ASSERT_TRUE(tensorField->hasEigenDecomposition());
+
+    for (size_t i = 0; i < tensorField->getSize(); ++i) {
+        const auto tensor = tensorField->tensor(i);
+        const std::array<std::pair<double, dvec3>, 3> eigen{
+            {{tensorField->majorEigenValues()[i], tensorField->majorEigenVectors()[i]},
+             {tensorField->middleEigenValues()[i], tensorField->middleEigenVectors()[i]},
+             {tensorField->minorEigenValues()[i], tensorField->minorEigenVectors()[i]}}};
+
+        EXPECT_GE(eigen[0].first, eigen[1].first);
+        EXPECT_GE(eigen[1].first, eigen[2].first);
+        EXPECT_GT(eigen[2].first, 0.0);
+        for (const auto& [lambda, v] : eigen) {
+            const auto residual = tensor * v - lambda * v;
+            EXPECT_NEAR(0.0, glm::length(residual), 1e-10);
+        }
+    }
+}
+
+TEST(TensorFieldGenerationTests, deferredEigenSystem) {
+    tensorutil::SyntheticTensorField3D settings;
+    settings.dimensions = size3_t(3, 3, 3);
+    settings.eigenSystem = false;
+
+    const auto tensorField = tensorutil::generateTensorField3D(settings);
+    EXPECT_FALSE(tensorField->hasEigenDecomposition());
+    EXPECT_EQ(tensorField->getSize(), tensorField->majorEigenValues().size());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,88 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+
+namespace inviwo {
+TEST(TensorFieldMetaDataTests, slotsAreKnownAtCompileTime) {
+    static_assert(tensorutil::hasMetaDataSlot<HillYieldCriterion>());
+    static_assert(tensorutil::metaDataSlot(TensorFeature::Sigma1) ==
+                  tensorutil::metaDataSlot(MajorEigenValues::id()));
+    static_assert(tensorutil::metaDataSlot(TensorFeature::Unspecified) ==
+                  tensorutil::metaDataIds.size());
+}
+
+TEST(TensorFieldMetaDataTests, lookupFollowsAddAndRemove) {
+    const size3_t dimensions{2, 2, 2};
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < 8; ++i) tensors.push_back(dmat3(static_cast<double>(i + 1)));
+    TensorField3D tensorField(dimensions, tensors);
+
+    EXPECT_FALSE(tensorField.hasMetaData<FrobeniusNorm>());
+    EXPECT_FALSE(tensorField.hasMetaData(TensorFeature::FrobeniusNorm));
+    EXPECT_THROW(tensorField.getMetaData<FrobeniusNorm>(), Exception);
+
+    tensorField.addMetaData<FrobeniusNorm>(std::vector<double>(8, 2.0),
+                                           TensorFeature::FrobeniusNorm);
+    EXPECT_TRUE(tensorField.hasMetaData(TensorFeature::FrobeniusNorm));
+    EXPECT_TRUE(tensorField.hasMetaData(FrobeniusNorm::id()));
+    EXPECT_EQ(2.0, tensorField.getMetaDataView<FrobeniusNorm>()[7]);
+
+    // Copies share the entries and keep their own slots
+    TensorField3D copy(tensorField);
+    tensorField.removeMetaData<FrobeniusNorm>();
+    EXPECT_FALSE(tensorField.hasMetaData(TensorFeature::FrobeniusNorm));
+    EXPECT_TRUE(copy.hasMetaData(TensorFeature::FrobeniusNorm));
+    EXPECT_EQ(size_t{8}, copy.getMetaDataView<FrobeniusNorm>().size);
+}
+
+TEST(TensorFieldMetaDataTests, movedDataIsNotCopied) {
+    const size3_t dimensions{2, 2, 2};
+    std::vector<dmat3> tensors(8, dmat3(1.0));
+    TensorField3D tensorField(dimensions, tensors);
+
+    std::vector<double> data(8, 3.0);
+    const auto ptr = data.data();
+    tensorField.addMetaData<FrobeniusNorm>(std::move(data), TensorFeature::FrobeniusNorm);
+    EXPECT_EQ(ptr, tensorField.getMetaData<FrobeniusNorm>().data());
+}
+
+TEST(TensorFieldMetaDataTests, eigenViewMatchesMetaData) {
+    const size3_t dimensions{2, 2, 2};
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < 8; ++i) {
+        const auto s = static_cast<double>(i + 1);
+        tensors.push_back(dmat3(dvec3(s, 0.0, 0.0), dvec3(0.0, 2.0 * s, 0.0),
+                                dvec3(0.0, 0.0, 3.0 * s)));
+    }
+    const TensorField3D tensorField(dimensions, tensors);
+
+    const auto view = tensorField.getEigenView();
+    for (size_t i = 0; i < tensorField.getSize(); ++i) {
+        EXPECT_EQ(tensorField.majorEigenValues()[i], view.eigenValues(i)[0]);
+        EXPECT_EQ(tensorField.middleEigenValues()[i], view.eigenValues(i)[1]);
+        EXPECT_EQ(tensorField.minorEigenValues()[i], view.eigenValues(i)[2]);
+        EXPECT_EQ(tensorField.majorEigenVectors()[i], view.eigenVectors(i)[0]);
+        EXPECT_NEAR(3.0 * static_cast<double>(i + 1), view.eigenValues(i)[0], 1e-9);
+    }
+}
+
+TEST(TensorFieldMetaDataTests, incompleteEigenMetaDataIsRecomputed) {
+    const size3_t dimensions{2, 2, 2};
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < 8; ++i) tensors.push_back(dmat3(static_cast<double>(i + 1)));
+
+    std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData;
+    metaData[MajorEigenValues::id()] =
+        std::make_unique<MajorEigenValues>(std::vector<double>(8, 0.0), TensorFeature::Sigma1);
+
+    const TensorField3D tensorField(dimensions, tensors, metaData);
+    EXPECT_FALSE(tensorField.hasEigenDecomposition());
+    EXPECT_NEAR(8.0, tensorField.majorEigenValues()[7], 1e-9);
+    EXPECT_NEAR(8.0, tensorField.dataMapEigenValues()[0].dataRange.y, 1e-9);
+    EXPECT_TRUE(tensorField.hasEigenDecomposition());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,97 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldsampling.h>
+
+namespace inviwo {
+namespace {
+std::vector<dmat3> linearTensors(const size3_t& dimensions) {
+    std::vector<dmat3> tensors;
+    for (size_t z = 0; z < dimensions.z; ++z) {
+        for (size_t y = 0; y < dimensions.y; ++y) {
+            for (size_t x = 0; x < dimensions.x; ++x) {
+                const auto v = dvec3(x, y, z);
+                tensors.push_back(dmat3{v.x, v.y, v.z, v.y, 2.0 * v.x, v.x + v.z, v.z, v.x + v.z,
+                                        v.y - v.z});
+            }
+        }
+    }
+    return tensors;
+}
+
+void expectNear(const dmat3& expected, const dmat3& actual) {
+    for (glm::length_t col = 0; col < 3; ++col) {
+        for (glm::length_t row = 0; row < 3; ++row) {
+            EXPECT_NEAR(expected[col][row], actual[col][row], 1e-6);
+        }
+    }
+}
+}  // namespace
+
+TEST(TensorFieldSamplingTests, trilinearSamplerIsExactForLinearFields) {
+    const size3_t dimensions{3, 4, 5};
+    const auto tensors = linearTensors(dimensions);
+    const TensorField3D tensorField(dimensions, tensors);
+
+    const TensorField3DSampler sampler(tensorField);
+
+    // Voxel centers
+    EXPECT_EQ(tensors[0], sampler.sample(dvec3(0.0)));
+    EXPECT_EQ(tensors.back(), sampler.sample(dvec3(1.0)));
+
+    // The field is linear in the index position, so trilinear interpolation reproduces it
+    const dvec3 position{0.3, 0.55, 0.8};
+    const auto indexPosition = position * dvec3(dimensions - size3_t(1));
+    const auto& v = indexPosition;
+    expectNear(dmat3{v.x, v.y, v.z, v.y, 2.0 * v.x, v.x + v.z, v.z, v.x + v.z, v.y - v.z},
+               sampler.sample(position));
+
+    // Outside positions are clamped to the border
+    EXPECT_EQ(tensors.back(), sampler.sample(dvec3(2.0)));
+}
+
+TEST(TensorFieldSamplingTests, batchMatchesSingleSamples) {
+    const size3_t dimensions{4, 3, 2};
+    const auto tensors = linearTensors(dimensions);
+    const TensorField3D full(dimensions, tensors);
+    const TensorField3D packed(dimensions, SymmetricTensorStorage3D<float>(tensors));
+
+    const std::vector<dvec3> positions{dvec3(0.1, 0.2, 0.3), dvec3(0.9, 0.5, 0.0),
+                                       dvec3(0.5, 1.0, 0.75)};
+
+    for (auto method :
+         {tensorutil::InterpolationMethod::Linear, tensorutil::InterpolationMethod::Nearest}) {
+        const TensorField3DSampler fullSampler(full, method);
+        const TensorField3DSampler packedSampler(packed, method);
+
+        const auto batch = fullSampler.sample(positions);
+        const auto packedBatch = packedSampler.sample(positions);
+        ASSERT_EQ(positions.size(), batch.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            EXPECT_EQ(fullSampler.sample(positions[i]), batch[i]);
+            expectNear(batch[i], packedBatch[i]);
+        }
+    }
+}
+
+TEST(TensorFieldSamplingTests, runtimeDispatchMatchesTemplate) {
+    const size3_t dimensions{4, 3, 2};
+    const auto tensorField =
+        std::make_shared<const TensorField3D>(dimensions, linearTensors(dimensions));
+    const dvec3 position{0.4, 0.7, 0.2};
+
+    const auto linear = sample<tensorutil::InterpolationMethod::Linear>(tensorField, position);
+    const auto nearest = sample<tensorutil::InterpolationMethod::Nearest>(tensorField, position);
+
+    EXPECT_EQ(linear, sample(tensorField, position, tensorutil::InterpolationMethod::Linear));
+    EXPECT_EQ(nearest, sample(tensorField, position, tensorutil::InterpolationMethod::Nearest));
+
+    EXPECT_EQ(linear,
+              makeSampleFunction(tensorField, tensorutil::InterpolationMethod::Linear)(position));
+    EXPECT_EQ(nearest,
+              makeSampleFunction(tensorField, tensorutil::InterpolationMethod::Nearest)(position));
+}
+
+}  // namespace inviwo
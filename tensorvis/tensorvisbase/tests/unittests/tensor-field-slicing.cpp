@@ -0,0 +1,67 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/algorithm/tensorfieldslicing.h>
+
+namespace inviwo {
+namespace {
+std::shared_ptr<const TensorField3D> indexedField(const size3_t& dimensions) {
+    std::vector<dmat3> tensors;
+    for (size_t i = 0; i < dimensions.x * dimensions.y * dimensions.z; ++i) {
+        const auto v = static_cast<double>(i);
+        tensors.push_back(dmat3{v, 1.0, 0.0, 1.0, 2.0 * v, 0.0, 0.0, 0.0, 1.0});
+    }
+    return std::make_shared<TensorField3D>(dimensions, tensors);
+}
+}  // namespace
+
+TEST(TensorFieldSlicingTests, slice3DMatchesField) {
+    const size3_t dimensions{3, 4, 5};
+    const auto tensorField = indexedField(dimensions);
+    const util::IndexMapper3D indexMapper(dimensions);
+
+    const auto sliceY = slice<3>(tensorField, CartesianCoordinateAxis::Y, 2);
+    EXPECT_EQ(size3_t(3, 1, 5), sliceY->getDimensions());
+    for (size_t z = 0; z < dimensions.z; ++z) {
+        for (size_t x = 0; x < dimensions.x; ++x) {
+            const auto expected = tensorField->tensor(indexMapper(size3_t(x, 2, z)));
+            EXPECT_EQ(expected, sliceY->tensor(x + z * dimensions.x));
+        }
+    }
+
+    // The eigen system is inherited from the field
+    tensorField->majorEigenValues();
+    const auto sliceZ = slice<3>(tensorField, CartesianCoordinateAxis::Z, 4);
+    EXPECT_TRUE(sliceZ->hasEigenDecomposition());
+    const auto first = indexMapper(size3_t(0, 0, 4));
+    for (size_t i = 0; i < sliceZ->getSize(); ++i) {
+        EXPECT_DOUBLE_EQ(tensorField->majorEigenValues()[first + i],
+                         sliceZ->majorEigenValues()[i]);
+    }
+}
+
+TEST(TensorFieldSlicingTests, cacheReturnsRecentSlices) {
+    const auto tensorField = indexedField(size3_t(3, 4, 5));
+    TensorFieldSliceCache cache(2);
+
+    const auto slice0 = cache.slice2D(tensorField, CartesianCoordinateAxis::Z, 0);
+    const auto slice1 = cache.slice2D(tensorField, CartesianCoordinateAxis::Z, 1);
+    EXPECT_EQ(slice0, cache.slice2D(tensorField, CartesianCoordinateAxis::Z, 0));
+    EXPECT_EQ(size2_t(3, 4), slice0->getDimensions());
+
+    // Slice 1 is the least recently used and gets evicted
+    cache.slice2D(tensorField, CartesianCoordinateAxis::Z, 2);
+    EXPECT_NE(slice1, cache.slice2D(tensorField, CartesianCoordinateAxis::Z, 1));
+
+    // Axes are cached separately
+    const auto sliceX = cache.slice3D(tensorField, CartesianCoordinateAxis::X, 0);
+    EXPECT_EQ(sliceX, cache.slice3D(tensorField, CartesianCoordinateAxis::X, 0));
+
+    // A different field invalidates the cache
+    const auto other = indexedField(size3_t(3, 4, 5));
+    EXPECT_NE(sliceX, cache.slice3D(other, CartesianCoordinateAxis::X, 0));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,69 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/util/tensorutil.h>
+#include <inviwo/tensorvisbase/util/tensorfieldutil.h>
+
+namespace inviwo {
+TEST(TensorFieldSubsamplingTests, logExpRoundtrip) {
+    const dmat3 tensor{4.0, 1.0, 0.5, 1.0, 3.0, 0.25, 0.5, 0.25, 2.0};
+
+    const auto logT = tensorutil::logTensor(tensor);
+    ASSERT_TRUE(logT.has_value());
+
+    const auto expT = tensorutil::expTensor(*logT);
+    for (glm::length_t c = 0; c < 3; ++c) {
+        for (glm::length_t r = 0; r < 3; ++r) {
+            EXPECT_NEAR(tensor[c][r], expT[c][r], 1e-10);
+        }
+    }
+
+    EXPECT_FALSE(tensorutil::logTensor(dmat3(-1.0)).has_value());
+    EXPECT_FALSE(tensorutil::logTensor(dmat2(0.0)).has_value());
+}
+
+TEST(TensorFieldSubsamplingTests, logEuclideanDownsamplePreservesDeterminant) {
+    // Alternating diag(4, 1, 1) and diag(1, 4, 1), both with determinant 4
+    const size3_t dimensions{4, 4, 4};
+    std::vector<dmat3> tensors(dimensions.x * dimensions.y * dimensions.z);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        tensors[i] = i % 2 == 0 ? dmat3{4.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0}
+                                : dmat3{1.0, 0.0, 0.0, 0.0, 4.0, 0.0, 0.0, 0.0, 1.0};
+    }
+    auto tensorField = std::make_shared<TensorField3D>(dimensions, tensors);
+
+    const auto logEuclidean =
+        tensorutil::downsample3D(tensorField, size3_t(2), tensorutil::Averaging::LogEuclidean);
+    const auto linear =
+        tensorutil::downsample3D(tensorField, size3_t(2), tensorutil::Averaging::Linear);
+
+    ASSERT_EQ(size3_t(2), logEuclidean->getDimensions());
+    for (size_t i = 0; i < logEuclidean->getSize(); ++i) {
+        EXPECT_NEAR(4.0, glm::determinant(logEuclidean->tensor(i)), 1e-10);
+        EXPECT_NEAR(6.25, glm::determinant(linear->tensor(i)), 1e-10);
+    }
+    EXPECT_TRUE(logEuclidean->hasEigenDecomposition());
+    EXPECT_NEAR(2.0, logEuclidean->majorEigenValues()[0], 1e-10);
+}
+
+TEST(TensorFieldSubsamplingTests, downsampleConstantField) {
+    const dmat2 tensor{2.0, 0.5, 0.5, 1.0};
+    auto tensorField =
+        std::make_shared<TensorField2D>(size2_t(5, 3), std::vector<dmat2>(15, tensor));
+
+    const auto result = tensorutil::downsample2D(tensorField, size2_t(2, 2));
+
+    ASSERT_EQ(size2_t(2, 2), result->getDimensions());
+    for (size_t i = 0; i < 4; ++i) {
+        const auto t = result->tensor(i);
+        for (glm::length_t c = 0; c < 2; ++c) {
+            for (glm::length_t r = 0; r < 2; ++r) {
+                EXPECT_NEAR(tensor[c][r], t[c][r], 1e-10);
+            }
+        }
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,78 @@
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/tensorvisbase/util/volumerange.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <algorithm>
+#include <random>
+
+namespace inviwo {
+namespace {
+VolumeRAMPrecision<float> randomVolume(const size3_t& dims) {
+    VolumeRAMPrecision<float> volume(dims);
+    std::mt19937 rand(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::generate(volume.getDataTyped(), volume.getDataTyped() + glm::compMul(dims),
+                  [&]() { return dist(rand); });
+    return volume;
+}
+
+dvec2 bruteForceRange(const VolumeRAMPrecision<float>& volume, const size3_t& lower,
+                      const size3_t& upper) {
+    const auto dims = volume.getDimensions();
+    dvec2 range{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+    for (size_t z = lower.z; z <= upper.z; ++z) {
+        for (size_t y = lower.y; y <= upper.y; ++y) {
+            for (size_t x = lower.x; x <= upper.x; ++x) {
+                const double v = volume.getDataTyped()[x + dims.x * (y + dims.y * z)];
+                range = dvec2{std::min(range.x, v), std::max(range.y, v)};
+            }
+        }
+    }
+    return range;
+}
+}  // namespace
+
+TEST(VolumeRangeTests, matchesSerialScan) {
+    const size3_t dims{37, 20, 11};
+    const auto volume = randomVolume(dims);
+    const tensorutil::VolumeRangeSummary summary(volume, 8);
+
+    EXPECT_EQ(size3_t(5, 3, 2), summary.getBrickCount());
+    EXPECT_EQ(bruteForceRange(volume, size3_t{0}, dims - size_t{1}), summary.range());
+}
+
+TEST(VolumeRangeTests, brickAlignedRegionIsExact) {
+    const size3_t dims{37, 20, 11};
+    const auto volume = randomVolume(dims);
+    const tensorutil::VolumeRangeSummary summary(volume, 8);
+
+    const size3_t lower{8, 0, 8};
+    const size3_t upper{23, 15, 10};
+    EXPECT_EQ(bruteForceRange(volume, lower, upper), summary.range(lower, upper));
+}
+
+TEST(VolumeRangeTests, regionRangeEnclosesActualRange) {
+    const size3_t dims{37, 20, 11};
+    const auto volume = randomVolume(dims);
+    const tensorutil::VolumeRangeSummary summary(volume, 8);
+
+    const size3_t lower{3, 5, 2};
+    const size3_t upper{17, 9, 4};
+    const auto actual = bruteForceRange(volume, lower, upper);
+    const auto range = summary.range(lower, upper);
+    EXPECT_LE(range.x, actual.x);
+    EXPECT_GE(range.y, actual.y);
+}
+
+TEST(VolumeRangeTests, emptyRegionHasInvertedRange) {
+    const auto volume = randomVolume(size3_t{4, 4, 4});
+    const tensorutil::VolumeRangeSummary summary(volume, 2);
+
+    const auto range = summary.range(size3_t{3, 0, 0}, size3_t{2, 3, 3});
+    EXPECT_GT(range.x, range.y);
+}
+}  // namespace inviwo
@@ -3,4 +3,5 @@
 set(dependencies
     InviwoTensorVisBaseModule
 	InviwoVTKModule
+    InviwoUtilitiesModule
 )
@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisio/tensorvisiomoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfield3d.h>
+#include <inviwo/tensorvisbase/datastructures/symmetrictensorstorage.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace inviwo {
+
+namespace tfb {
+
+enum class ChunkStorage : glm::uint8 { Full = 0, Symmetric = 1 };
+// Lossless compression of each chunk
+enum class Compression : glm::uint8 { None = 0, Deflate = 1 };
+// Meta data encoding, Quantized16 maps every value linearly to 16 bit between min and max
+enum class Encoding : glm::uint8 { Raw = 0, Quantized16 = 1 };
+
+constexpr size_t defaultChunkSize = 65536;
+
+/*
+ * Since TFB version 6 the tensors are stored in chunks preceded by a chunk table, since version 7
+ * the meta data entries as well:
+ *   compression (uint8, version 7 and later), elements per chunk (uint64), number of chunks
+ *   (uint64), and for every chunk its absolute file offset and stored size in bytes (uint64 each).
+ * Chunk i holds the elements [i * chunkSize, min((i + 1) * chunkSize, numElements)) and is
+ * compressed independently of the other chunks, which allows reading chunks in parallel or on
+ * demand.
+ *
+ * The tensor section starts with the storage (uint8). Full chunks store nine doubles per tensor
+ * in row-major order, Symmetric chunks store one array of doubles per unique component in the
+ * order (xx, yy, zz, xy, yz, xz).
+ *
+ * A meta data entry (version 7) consists of id and feature type (uint64 each), encoding (uint8),
+ * number of components (uint64), min and max (double each, only if quantized), and the chunk
+ * table with the chunks holding the values of each element consecutively.
+ */
+struct IVW_MODULE_TENSORVISIO_API ChunkTable {
+    struct Chunk {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    Compression compression{Compression::None};
+    size_t chunkSize{defaultChunkSize};
+    size_t numElements{0};
+    std::vector<Chunk> chunks;
+    uint64_t tableEnd{0};  // file offset right after the chunk table
+
+    size_t first(size_t chunk) const { return chunk * chunkSize; }
+    size_t count(size_t chunk) const { return std::min(chunkSize, numElements - first(chunk)); }
+    // File offset right after the last chunk
+    uint64_t end() const;
+};
+
+using Tensors = std::variant<std::vector<dmat3>, SymmetricTensorStorage3D<double>>;
+
+/*
+ * Writes the tensor section at the current position of the stream. Fields with symmetric tensor
+ * storage are written as Symmetric chunks.
+ */
+IVW_MODULE_TENSORVISIO_API void writeTensors(std::ostream& out, const TensorField3D& tensorField,
+                                             Compression compression = Compression::None,
+                                             size_t chunkSize = defaultChunkSize);
+
+/*
+ * Reads the tensor section at the current position of the stream, version 5 files are read as a
+ * contiguous chunk layout. All chunks are read and decompressed in parallel, every chunk by its
+ * own file stream directly into the final storage. The stream is positioned after the tensor
+ * section.
+ */
+IVW_MODULE_TENSORVISIO_API Tensors readTensors(std::istream& in, const std::string& filePath,
+                                               size_t numTensors, size_t version);
+
+/*
+ * Writes a meta data entry with numElements elements including its id.
+ */
+IVW_MODULE_TENSORVISIO_API void writeMetaData(std::ostream& out, const MetaDataBase& metaData,
+                                              size_t numElements,
+                                              Compression compression = Compression::None,
+                                              Encoding encoding = Encoding::Raw,
+                                              size_t chunkSize = defaultChunkSize);
+
+/*
+ * Reads the meta data entry written by writeMetaData into metaData, the id is expected to be
+ * already read. The chunks are decompressed in parallel.
+ */
+IVW_MODULE_TENSORVISIO_API void readMetaData(std::istream& in, const std::string& filePath,
+                                             MetaDataBase& metaData, size_t numElements);
+
+}  // namespace tfb
+
+}  // namespace inviwo
@@ -41,23 +41,22 @@ namespace inviwo {
 
 /** \docpage{org.inviwo.AmiraTensorReader, Amira Tensor Reader}
  * ![](org.inviwo.AmiraTensorReader.png?classIdentifier=org.inviwo.AmiraTensorReader)
- * Explanation of how to use the processor.
- *
- * ### Inports
- *   * __<Inport1>__ <description>.
+ * Reads a 3D tensor field from a binary AmiraMesh file. Fields with six components per voxel
+ * are read as symmetric tensors (xx, xy, xz, yy, yz, zz), fields with nine components as full
+ * tensors. The tensors are kept in single precision like in the file.
  *
  * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __outportRaw__ The tensor field. Its eigen decomposition is computed on first use.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __File__ AmiraMesh file to read.
  */
 
 /**
  * \class AmiraTensorReader
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ * \brief Reads binary AmiraMesh tensor fields
+ * The file is memory mapped and the data section is assembled in parallel straight from the
+ * mapping into the packed storage of the field, without an intermediate copy.
  */
 class IVW_MODULE_TENSORVISIO_API AmiraTensorReader : public Processor {
 public:
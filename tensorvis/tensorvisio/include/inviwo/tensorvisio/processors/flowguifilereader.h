@@ -33,31 +33,45 @@
 #include <inviwo/tensorvisio/tensorvisiomoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/fileproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/volumeport.h>
 #include <inviwo/core/properties/optionproperty.h>
 
+#include <memory>
+
 namespace inviwo {
 
-/** \docpage{org.inviwo.WitoFileReader, Wito File Reader}
- * ![](org.inviwo.WitoFileReader.png?classIdentifier=org.inviwo.WitoFileReader)
- * Explanation of how to use the processor.
- *
- * ### Inports
- *   * __<Inport1>__ <description>.
+/** \docpage{org.inviwo.FlowGUIFileReader, Wito File Reader}
+ * ![](org.inviwo.FlowGUIFileReader.png?classIdentifier=org.inviwo.FlowGUIFileReader)
+ * Reads time-dependent scalar or vector fields from a FlowGUI file. The header is parsed once
+ * per file into an offset table of the time steps, so a single time step is read without
+ * touching the others. The time steps following the current one are read in advance in the
+ * background.
  *
  * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __outport__ All time steps, scalar or vec4 volumes depending on the field type. Only
+ *     filled if __All time steps__ is checked.
+ *   * __outportVec3__ All time steps of a vec4 field as vec3 volumes. Only filled if __All time
+ *     steps__ is checked.
+ *   * __timeStep__ The current time step, scalar or vec4 volume.
+ *   * __timeStepVec3__ The current time step of a vec4 field as vec3 volume.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __File__ FlowGUI file to read.
+ *   * __Field type__ Scalar or vec4 data.
+ *   * __All time steps__ Read all time steps into the sequence outports.
+ *   * __Time step__ Time step to output on the time step outports.
+ *   * __Prefetched steps__ Number of time steps after the current one to read in advance.
  */
 
 /**
- * \class WitoFileReader
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ * \class FlowGUIFileReader
+ * \brief Reader for FlowGUI time-dependent fields with random access to the time steps
+ * The time steps are stored back to back after the header. The file is memory mapped and each
+ * time step is copied out of the mapping, so prefetching runs on pool threads next to the main
+ * read.
  */
 class IVW_MODULE_TENSORVISIO_API FlowGUIFileReader : public Processor {
 public:
@@ -70,12 +84,24 @@ public:
     static const ProcessorInfo processorInfo_;
 
 private:
+    struct TimeSeries;
+
+    void prefetch(size_t step);
+
     FileProperty inFile_;
 
     OptionPropertyInt fieldType_;
+    BoolProperty allTimeSteps_;
+    IntSizeTProperty timeStep_;
+    IntSizeTProperty prefetch_;
 
     VolumeSequenceOutport outport_;
     VolumeSequenceOutport outportVec3_;
+    VolumeOutport timeStepOutport_;
+    VolumeOutport timeStepVec3Outport_;
+
+    std::shared_ptr<TimeSeries> series_;
+    bool reload_ = true;
 };
 
 }  // namespace inviwo
@@ -34,37 +34,41 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/activityindicator.h>
 #include <inviwo/core/properties/compositeproperty.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 
+#include <atomic>
+#include <memory>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.TensorField2DExport, Tensor Field2DExport}
  * ![](org.inviwo.TensorField2DExport.png?classIdentifier=org.inviwo.TensorField2DExport)
- * Explanation of how to use the processor.
+ * Writes a 2D tensor field to a tensor field binary (tfb) file in the background, the network
+ * keeps running while the file is written.
  *
  * ### Inports
- *   * __<Inport1>__ <description>.
- *
- * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __inport__ Tensor field to write.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __Export to__ File to write.
+ *   * __Export__ Writes the current tensor field.
+ *   * __Include eigen info__ Write the eigenvalues and eigenvectors as well.
  */
 
 /**
  * \class TensorField2DExport
- * \brief VERY_BRIEFLY_DESCRIBE_THE_PROCESSOR
- * DESCRIBE_THE_PROCESSOR_FROM_A_DEVELOPER_PERSPECTIVE
+ * \brief Writes a TensorField2D to a tfb file
+ * The export is done by a pool thread, every buffer is written in a single call.
  */
-class IVW_MODULE_TENSORVISIO_API TensorField2DExport : public Processor {
+class IVW_MODULE_TENSORVISIO_API TensorField2DExport : public Processor,
+                                                     public ActivityIndicatorOwner {
 public:
     TensorField2DExport();
-    virtual ~TensorField2DExport() = default;
+    virtual ~TensorField2DExport();
 
     virtual void process() override;
 
@@ -79,7 +83,9 @@ private:
     ButtonProperty exportButton_;
     BoolProperty includeEigenInfo_;
 
-    void exportBinary() const;
+    void exportBinary();
+
+    std::shared_ptr<std::atomic<bool>> processorExists_;
 };
 }  // namespace inviwo
 
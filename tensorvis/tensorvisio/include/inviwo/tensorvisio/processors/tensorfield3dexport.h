@@ -34,37 +34,47 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/activityindicator.h>
 #include <inviwo/core/properties/compositeproperty.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/tensorvisio/io/tensorfieldchunks.h>
+
+#include <atomic>
+#include <memory>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.TensorField3DExport, Tensor Field Export}
  * ![](org.inviwo.TensorField3DExport.png?classIdentifier=org.inviwo.TensorField3DExport)
- * Explanation of how to use the processor.
+ * Writes a tensor field to a tensor field binary (tfb) file in the background, the network
+ * keeps running while the file is written.
  *
  * ### Inports
- *   * __<Inport1>__ <description>.
- *
- * ### Outports
- *   * __<Outport1>__ <description>.
+ *   * __inport__ Tensor field to write.
  *
  * ### Properties
- *   * __<Prop1>__ <description>.
- *   * __<Prop2>__ <description>
+ *   * __Export to__ File to write.
+ *   * __Export__ Writes the current tensor field.
+ *   * __Include meta data__ Write all meta data, otherwise only the eigen system.
+ *   * __Compression__ Lossless compression of the tensor and meta data chunks.
+ *   * __Quantize eigenvectors__ Store the eigenvectors with 16 bit per component.
+ *   * __Quantize meta data__ Store the remaining meta data with 16 bit per component.
  */
 
 /**
  * \class TensorField3DExport
- * \brief <brief description>
- * <Detailed description from a developer prespective>
+ * \brief Writes a TensorField3D to a tfb file
+ * The export works on a copy of the inport data, which shares its buffers with the original,
+ * and is done by a pool thread.
  */
-class IVW_MODULE_TENSORVISIO_API TensorField3DExport : public Processor {
+class IVW_MODULE_TENSORVISIO_API TensorField3DExport : public Processor,
+                                                     public ActivityIndicatorOwner {
 public:
     TensorField3DExport();
-    virtual ~TensorField3DExport() = default;
+    virtual ~TensorField3DExport();
 
     virtual void process() override;
 
@@ -78,8 +88,14 @@ private:
     FileProperty exportFile_;
     ButtonProperty exportButton_;
     BoolProperty includeMetaData_;
+    TemplateOptionProperty<tfb::Compression> compression_;
+    // Lossy 16 bit quantization of the eigenvectors and the remaining meta data respectively
+    BoolProperty quantizeEigenVectors_;
+    BoolProperty quantizeMetaData_;
+
+    void exportBinary();
 
-    void exportBinary() const;
+    std::shared_ptr<std::atomic<bool>> processorExists_;
 };
 
 }  // namespace inviwo
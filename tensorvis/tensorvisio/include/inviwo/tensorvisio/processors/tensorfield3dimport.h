@@ -85,8 +85,6 @@ private:
     std::shared_ptr<TensorField3D> tensorFieldOut_;
 
     dvec3 dextents_;
-
-    void buildTensors(const std::vector<double>& data, std::vector<dmat3>& tensors) const;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,78 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/tensorvisio/tensorvisiomoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/filepatternproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/tensorvisbase/ports/tensorfieldport.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.TensorField3DSequenceImport, Tensor Field 3D Sequence Import}
+ * ![](org.inviwo.TensorField3DSequenceImport.png?classIdentifier=org.inviwo.TensorField3DSequenceImport)
+ * Reads a time series of tfb files as a tensor field sequence. The time steps are read on demand
+ * in background threads, see TensorField3DSequence.
+ *
+ * ### Outports
+ *   * __outport__ Tensor field sequence, one time step per file.
+ *
+ * ### Properties
+ *   * __Files__ File pattern of the time steps, the files are sorted by name.
+ *   * __Normalize extents__ Scale the extents of each time step to a maximum of 1.
+ *   * __Prefetched time steps__ Number of time steps read ahead of the selected time step.
+ *   * __Memory budget__ Memory of the loaded time steps in MB before the least recently used
+ *     ones are released.
+ */
+class IVW_MODULE_TENSORVISIO_API TensorField3DSequenceImport : public Processor {
+public:
+    TensorField3DSequenceImport();
+    virtual ~TensorField3DSequenceImport() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    TensorField3DSequenceOutport outport_;
+
+    FilePatternProperty files_;
+    BoolProperty normalizeExtents_;
+    IntSizeTProperty prefetch_;
+    IntSizeTProperty memoryBudget_;
+
+    std::shared_ptr<TensorField3DSequence> sequence_;
+};
+
+}  // namespace inviwo
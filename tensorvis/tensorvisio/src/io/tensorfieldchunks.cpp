@@ -0,0 +1,392 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisio/io/tensorfieldchunks.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <zlib.h>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace inviwo {
+
+namespace tfb {
+
+namespace {
+
+template <typename T>
+void write(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read(std::istream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+template <typename T>
+std::vector<char> toBytes(const std::vector<T>& data) {
+    std::vector<char> bytes(data.size() * sizeof(T));
+    std::memcpy(bytes.data(), data.data(), bytes.size());
+    return bytes;
+}
+
+constexpr size_t numComponents(ChunkStorage storage) {
+    return storage == ChunkStorage::Symmetric ? SymmetricTensorStorage3D<double>::numComponents
+                                              : 9;
+}
+
+std::vector<char> compress(std::vector<char> raw, Compression compression) {
+    if (compression == Compression::None) return raw;
+
+    auto size = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<char> stored(size);
+    if (compress2(reinterpret_cast<Bytef*>(stored.data()), &size,
+                  reinterpret_cast<const Bytef*>(raw.data()), static_cast<uLong>(raw.size()),
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+        throw Exception("Could not compress tensor field chunk", IVW_CONTEXT_CUSTOM("tfb"));
+    }
+    stored.resize(size);
+    return stored;
+}
+
+std::vector<char> decompress(std::vector<char> stored, size_t rawSize, Compression compression) {
+    if (compression == Compression::None) {
+        if (stored.size() != rawSize) {
+            throw Exception("Invalid size of tensor field chunk", IVW_CONTEXT_CUSTOM("tfb"));
+        }
+        return stored;
+    }
+
+    std::vector<char> raw(rawSize);
+    auto size = static_cast<uLongf>(rawSize);
+    if (uncompress(reinterpret_cast<Bytef*>(raw.data()), &size,
+                   reinterpret_cast<const Bytef*>(stored.data()),
+                   static_cast<uLong>(stored.size())) != Z_OK ||
+        size != rawSize) {
+        throw Exception("Could not decompress tensor field chunk", IVW_CONTEXT_CUSTOM("tfb"));
+    }
+    return raw;
+}
+
+/*
+ * Writes the chunk table followed by the chunks, chunkData returns the uncompressed bytes of the
+ * elements [first, first + count).
+ */
+void writeChunks(std::ostream& out, size_t numElements, size_t chunkSize, Compression compression,
+                 const std::function<std::vector<char>(size_t first, size_t count)>& chunkData) {
+    ChunkTable table;
+    table.compression = compression;
+    table.chunkSize = std::max<size_t>(chunkSize, 1);
+    table.numElements = numElements;
+    table.chunks.resize((numElements + table.chunkSize - 1) / table.chunkSize);
+
+    write(out, table.compression);
+    write(out, static_cast<uint64_t>(table.chunkSize));
+    write(out, static_cast<uint64_t>(table.chunks.size()));
+
+    // The table is written again once the chunk offsets are known
+    const auto tablePos = out.tellp();
+    for (const auto& chunk : table.chunks) write(out, chunk);
+
+    for (size_t i = 0; i < table.chunks.size(); ++i) {
+        const auto stored = compress(chunkData(table.first(i), table.count(i)), compression);
+
+        table.chunks[i].offset = static_cast<uint64_t>(out.tellp());
+        table.chunks[i].size = stored.size();
+        out.write(stored.data(), stored.size());
+    }
+
+    const auto endPos = out.tellp();
+    out.seekp(tablePos);
+    for (const auto& chunk : table.chunks) write(out, chunk);
+    out.seekp(endPos);
+}
+
+ChunkTable readChunkTable(std::istream& in, size_t numElements, bool hasCompression) {
+    ChunkTable table;
+    if (hasCompression) table.compression = read<Compression>(in);
+    table.chunkSize = static_cast<size_t>(read<uint64_t>(in));
+    table.numElements = numElements;
+
+    const auto numChunks = static_cast<size_t>(read<uint64_t>(in));
+    if (!in || table.chunkSize == 0 ||
+        numChunks != (numElements + table.chunkSize - 1) / table.chunkSize ||
+        (table.compression != Compression::None && table.compression != Compression::Deflate)) {
+        throw Exception("Invalid chunk table", IVW_CONTEXT_CUSTOM("tfb::readChunkTable"));
+    }
+
+    table.chunks.resize(numChunks);
+    for (auto& chunk : table.chunks) chunk = read<ChunkTable::Chunk>(in);
+    table.tableEnd = static_cast<uint64_t>(in.tellg());
+
+    return table;
+}
+
+/*
+ * Reads and decompresses all chunks in parallel, every chunk with its own file stream.
+ * chunkData receives the uncompressed bytes of each chunk. The sequence loaders call this from
+ * pool jobs, hence the re-entrant range loop, which reads the chunks on the calling thread when
+ * no other pool thread is free.
+ */
+void readChunks(const std::string& filePath, const ChunkTable& table, size_t elementSize,
+                const std::function<void(size_t chunk, const std::vector<char>& raw)>& chunkData) {
+    util::forEachRangeParallel(table.chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& chunk = table.chunks[i];
+            std::ifstream in(filePath, std::ios::in | std::ios::binary);
+            std::vector<char> stored(chunk.size);
+            in.seekg(chunk.offset);
+            in.read(stored.data(), stored.size());
+            if (!in) {
+                throw Exception("Could not read chunk " + std::to_string(i),
+                                IVW_CONTEXT_CUSTOM("tfb::readChunks"));
+            }
+            chunkData(i, decompress(std::move(stored), table.count(i) * elementSize,
+                                    table.compression));
+        }
+    });
+}
+
+// Chunk data in file layout, see ChunkTable
+std::vector<double> tensorChunk(const TensorField3D& tensorField, ChunkStorage storage,
+                                size_t first, size_t count) {
+    std::vector<double> data(count * numComponents(storage));
+
+    if (storage == ChunkStorage::Symmetric) {
+        constexpr auto indices = SymmetricTensorStorage3D<double>::indices();
+        if (const auto packed = tensorField.symmetricTensors<double>()) {
+            for (size_t c = 0; c < indices.size(); ++c) {
+                const auto begin = packed->component(c).begin() + first;
+                std::copy(begin, begin + count, data.begin() + c * count);
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                const auto tensor = tensorField.tensor(first + i);
+                for (size_t c = 0; c < indices.size(); ++c) {
+                    data[c * count + i] = tensor[indices[c].first][indices[c].second];
+                }
+            }
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            const auto tensor = tensorField.tensor(first + i);
+            for (glm::length_t row = 0; row < 3; ++row) {
+                for (glm::length_t col = 0; col < 3; ++col) {
+                    data[i * 9 + row * 3 + col] = tensor[col][row];
+                }
+            }
+        }
+    }
+
+    return data;
+}
+
+// All meta data types are vectors of doubles or dvec3s
+template <typename M, typename F>
+auto visitMetaData(M& metaData, F&& f) {
+    using Base = std::conditional_t<std::is_const_v<M>, const MetaDataBase, MetaDataBase>;
+    using Scalars = std::conditional_t<std::is_const_v<M>, const MetaDataType<double>,
+                                       MetaDataType<double>>;
+    using Vectors = std::conditional_t<std::is_const_v<M>, const MetaDataType<dvec3>,
+                                       MetaDataType<dvec3>>;
+
+    if (auto scalars = dynamic_cast<Scalars*>(static_cast<Base*>(&metaData))) {
+        return f(*scalars);
+    } else if (auto vectors = dynamic_cast<Vectors*>(static_cast<Base*>(&metaData))) {
+        return f(*vectors);
+    }
+    throw Exception("Unsupported meta data type " + metaData.getDisplayName(),
+                    IVW_CONTEXT_CUSTOM("tfb"));
+}
+
+}  // namespace
+
+uint64_t ChunkTable::end() const {
+    if (chunks.empty()) return tableEnd;
+    return chunks.back().offset + chunks.back().size;
+}
+
+void writeTensors(std::ostream& out, const TensorField3D& tensorField, Compression compression,
+                  size_t chunkSize) {
+    // Sparse fields are written densely, the mask is stored separately
+    const auto storage = tensorField.getTensorStorage() == TensorStorage::Symmetric ||
+                                 tensorField.getTensorStorage() == TensorStorage::SymmetricFloat
+                             ? ChunkStorage::Symmetric
+                             : ChunkStorage::Full;
+    write(out, storage);
+
+    writeChunks(out, tensorField.getSize(), chunkSize, compression,
+                [&](size_t first, size_t count) {
+                    return toBytes(tensorChunk(tensorField, storage, first, count));
+                });
+}
+
+Tensors readTensors(std::istream& in, const std::string& filePath, size_t numTensors,
+                    size_t version) {
+    auto storage = ChunkStorage::Full;
+    ChunkTable table;
+    if (version >= 6) {
+        storage = read<ChunkStorage>(in);
+        if (storage != ChunkStorage::Full && storage != ChunkStorage::Symmetric) {
+            throw Exception("Invalid tensor storage", IVW_CONTEXT_CUSTOM("tfb::readTensors"));
+        }
+        table = readChunkTable(in, numTensors, version >= 7);
+    } else {
+        // Version 5 stores all tensors contiguously in full storage
+        table.numElements = numTensors;
+        table.tableEnd = static_cast<uint64_t>(in.tellg());
+        table.chunks.resize((numTensors + table.chunkSize - 1) / table.chunkSize);
+        for (size_t i = 0; i < table.chunks.size(); ++i) {
+            table.chunks[i].size = table.count(i) * 9 * sizeof(double);
+            table.chunks[i].offset = table.tableEnd + table.first(i) * 9 * sizeof(double);
+        }
+    }
+
+    Tensors tensors;
+    if (storage == ChunkStorage::Symmetric) {
+        tensors = SymmetricTensorStorage3D<double>(numTensors);
+    } else {
+        tensors = std::vector<dmat3>(numTensors);
+    }
+
+    readChunks(filePath, table, numComponents(storage) * sizeof(double),
+               [&](size_t chunk, const std::vector<char>& raw) {
+                   const auto first = table.first(chunk);
+                   const auto count = table.count(chunk);
+                   const auto data = reinterpret_cast<const double*>(raw.data());
+
+                   if (auto packed = std::get_if<SymmetricTensorStorage3D<double>>(&tensors)) {
+                       for (size_t c = 0; c < SymmetricTensorStorage3D<double>::numComponents;
+                            ++c) {
+                           std::copy(data + c * count, data + (c + 1) * count,
+                                     packed->component(c).begin() + first);
+                       }
+                   } else {
+                       auto& full = std::get<std::vector<dmat3>>(tensors);
+                       for (size_t i = 0; i < count; ++i) {
+                           const auto d = data + i * 9;
+                           full[first + i] =
+                               dmat3(dvec3(d[0], d[3], d[6]), dvec3(d[1], d[4], d[7]),
+                                     dvec3(d[2], d[5], d[8]));
+                       }
+                   }
+               });
+
+    in.seekg(table.end());
+    return tensors;
+}
+
+void writeMetaData(std::ostream& out, const MetaDataBase& metaData, size_t numElements,
+                   Compression compression, Encoding encoding, size_t chunkSize) {
+    const auto type = visitMetaData(metaData, [](const auto& m) { return m.type_; });
+    const auto components = metaData.getNumberOfComponents();
+    const auto values = static_cast<const double*>(metaData.getDataPtr());
+    const auto numValues = numElements * components;
+
+    write(out, metaData.getId());
+    write(out, type);
+    write(out, encoding);
+    write(out, static_cast<uint64_t>(components));
+
+    if (encoding == Encoding::Quantized16) {
+        const auto [minIt, maxIt] = std::minmax_element(values, values + numValues);
+        const double min = numValues > 0 ? *minIt : 0.0;
+        const double max = numValues > 0 ? *maxIt : 0.0;
+        const double scale = max > min ? 65535.0 / (max - min) : 0.0;
+        write(out, min);
+        write(out, max);
+
+        writeChunks(out, numElements, chunkSize, compression, [&](size_t first, size_t count) {
+            std::vector<glm::u16> quantized(count * components);
+            for (size_t i = 0; i < quantized.size(); ++i) {
+                quantized[i] = static_cast<glm::u16>(
+                    std::round((values[first * components + i] - min) * scale));
+            }
+            return toBytes(quantized);
+        });
+    } else {
+        writeChunks(out, numElements, chunkSize, compression, [&](size_t first, size_t count) {
+            return toBytes(std::vector<double>(values + first * components,
+                                               values + (first + count) * components));
+        });
+    }
+}
+
+void readMetaData(std::istream& in, const std::string& filePath, MetaDataBase& metaData,
+                  size_t numElements) {
+    const auto type = read<TensorFeature>(in);
+    const auto encoding = read<Encoding>(in);
+    const auto components = static_cast<size_t>(read<uint64_t>(in));
+
+    if (components != metaData.getNumberOfComponents() ||
+        (encoding != Encoding::Raw && encoding != Encoding::Quantized16)) {
+        throw Exception("Invalid meta data entry " + metaData.getDisplayName(),
+                        IVW_CONTEXT_CUSTOM("tfb::readMetaData"));
+    }
+
+    double min = 0.0;
+    double max = 0.0;
+    if (encoding == Encoding::Quantized16) {
+        min = read<double>(in);
+        max = read<double>(in);
+    }
+    const auto table = readChunkTable(in, numElements, true);
+
+    const auto values = visitMetaData(metaData, [&](auto& m) {
+        m.type_ = type;
+        m.data_.resize(numElements);
+        return reinterpret_cast<double*>(m.data_.data());
+    });
+
+    const auto valueSize = encoding == Encoding::Quantized16 ? sizeof(glm::u16) : sizeof(double);
+    readChunks(filePath, table, components * valueSize,
+               [&](size_t chunk, const std::vector<char>& raw) {
+                   auto out = values + table.first(chunk) * components;
+                   const auto count = table.count(chunk) * components;
+                   if (encoding == Encoding::Quantized16) {
+                       const auto quantized = reinterpret_cast<const glm::u16*>(raw.data());
+                       const auto scale = (max - min) / 65535.0;
+                       for (size_t i = 0; i < count; ++i) out[i] = min + quantized[i] * scale;
+                   } else {
+                       std::memcpy(out, raw.data(), count * sizeof(double));
+                   }
+               });
+
+    in.seekg(table.end());
+}
+
+}  // namespace tfb
+
+}  // namespace inviwo
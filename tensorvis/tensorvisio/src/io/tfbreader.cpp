@@ -0,0 +1,274 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisio/io/tfbreader.h>
+#include <inviwo/tensorvisio/io/tensorfieldchunks.h>
+#include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
+#include <inviwo/core/datastructures/datamapper.h>
+#include <inviwo/core/util/exception.h>
+
+#include <fstream>
+#include <ios>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace tfb {
+
+std::shared_ptr<TensorField3D> readTensorField3D(const std::string& filePath) {
+    std::ifstream inFile(filePath, std::ios::in | std::ios::binary);
+
+    if (!inFile) {
+        throw Exception("Couldn't open file " + filePath,
+                        IVW_CONTEXT_CUSTOM("tfb::readTensorField3D"));
+    }
+
+    size_t version;
+    size3_t dimensions;
+    auto extents = dvec3(1.0);
+    auto offset = dvec3(0.0);
+    size_t rank;
+    size_t dimensionality;
+    glm::uint8 hasMetaData;
+    std::array<DataMapper, 3> dataMapperEigenValues;
+    std::array<DataMapper, 3> dataMapperEigenVectors;
+    std::vector<glm::uint8> mask;
+    std::unordered_map<uint64_t, std::unique_ptr<MetaDataBase>> metaData;
+
+    std::string versionStr;
+    size_t size;
+    inFile.read(reinterpret_cast<char*>(&size), sizeof(size_t));
+    versionStr.resize(size);
+    inFile.read(&versionStr[0], size);
+
+    if (versionStr != "TFBVersion:") {
+        throw Exception("No valid tfb file " + filePath,
+                        IVW_CONTEXT_CUSTOM("tfb::readTensorField3D"));
+    }
+
+    inFile.read(reinterpret_cast<char*>(&version), sizeof(size_t));
+
+    // Version 5 files store the tensors contiguously and are read as a single chunk layout,
+    // version 6 files have uncompressed chunks
+    if (version < 5) {
+        throw Exception("Please update the tfb file. Current version is " +
+                            std::to_string(TFB_CURRENT_VERSION) + ", file has " +
+                            std::to_string(version),
+                        IVW_CONTEXT_CUSTOM("tfb::readTensorField3D"));
+    }
+
+    inFile.read(reinterpret_cast<char*>(&dimensionality), sizeof(size_t));
+    inFile.read(reinterpret_cast<char*>(&rank), sizeof(size_t));
+    inFile.read(reinterpret_cast<char*>(&hasMetaData), sizeof(glm::uint8));
+
+    if (dimensionality != 3) {
+        throw Exception("The loaded file is not a 3D tensor field. Try the 2D reader.",
+                        IVW_CONTEXT_CUSTOM("tfb::readTensorField3D"));
+    }
+
+    inFile.read(reinterpret_cast<char*>(&dimensions.x), sizeof(size_t));
+    inFile.read(reinterpret_cast<char*>(&dimensions.y), sizeof(size_t));
+    inFile.read(reinterpret_cast<char*>(&dimensions.z), sizeof(size_t));
+
+    // Read the extents
+
+    inFile.read(reinterpret_cast<char*>(&extents.x), sizeof(double));
+    inFile.read(reinterpret_cast<char*>(&extents.y), sizeof(double));
+    inFile.read(reinterpret_cast<char*>(&extents.z), sizeof(double));
+
+    inFile.read(reinterpret_cast<char*>(&offset.x), sizeof(double));
+    inFile.read(reinterpret_cast<char*>(&offset.y), sizeof(double));
+    inFile.read(reinterpret_cast<char*>(&offset.z), sizeof(double));
+
+    // Read the data maps
+
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenValues[0].dataRange), sizeof(double) * 2);
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenValues[1].dataRange), sizeof(double) * 2);
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenValues[2].dataRange), sizeof(double) * 2);
+    dataMapperEigenValues[0].valueRange = dataMapperEigenValues[0].dataRange;
+    dataMapperEigenValues[1].valueRange = dataMapperEigenValues[1].dataRange;
+    dataMapperEigenValues[2].valueRange = dataMapperEigenValues[2].dataRange;
+
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenVectors[0].dataRange), sizeof(double) * 2);
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenVectors[1].dataRange), sizeof(double) * 2);
+    inFile.read(reinterpret_cast<char*>(&dataMapperEigenVectors[2].dataRange), sizeof(double) * 2);
+    dataMapperEigenVectors[0].valueRange = dataMapperEigenVectors[0].dataRange;
+    dataMapperEigenVectors[1].valueRange = dataMapperEigenVectors[1].dataRange;
+    dataMapperEigenVectors[2].valueRange = dataMapperEigenVectors[2].dataRange;
+
+    const auto numElements = dimensions.x * dimensions.y * dimensions.z;
+
+    auto tensors = readTensors(inFile, filePath, numElements, version);
+
+    glm::uint8 hasMask;
+    inFile.read(reinterpret_cast<char*>(&hasMask), sizeof(glm::uint8));
+
+    if (hasMask) {
+        mask.resize(numElements);
+        auto maskData = mask.data();
+        inFile.read(reinterpret_cast<char*>(maskData), sizeof(glm::uint8) * numElements);
+    }
+
+    // Since version 7 the number of entries is also written for the eigen system only
+    if (hasMetaData || version >= 7) {
+        size_t numMetaDataEntries;
+        inFile.read(reinterpret_cast<char*>(&numMetaDataEntries), sizeof(size_t));
+
+        for (size_t i = 0; i < numMetaDataEntries; i++) {
+            uint64_t id;
+            inFile.read(reinterpret_cast<char*>(&id), sizeof(uint64_t));
+
+            std::unique_ptr<MetaDataBase> ptr = nullptr;
+
+            switch (id) {
+                case MajorEigenVectors::id():
+                    ptr = std::make_unique<MajorEigenVectors>();
+                    break;
+                case IntermediateEigenVectors::id():
+                    ptr = std::make_unique<IntermediateEigenVectors>();
+                    break;
+                case MinorEigenVectors::id():
+                    ptr = std::make_unique<MinorEigenVectors>();
+                    break;
+                case MajorEigenValues::id():
+                    ptr = std::make_unique<MajorEigenValues>();
+                    break;
+                case IntermediateEigenValues::id():
+                    ptr = std::make_unique<IntermediateEigenValues>();
+                    break;
+                case MinorEigenValues::id():
+                    ptr = std::make_unique<MinorEigenValues>();
+                    break;
+                case I1::id():
+                    ptr = std::make_unique<I1>();
+                    break;
+                case I2::id():
+                    ptr = std::make_unique<I2>();
+                    break;
+                case I3::id():
+                    ptr = std::make_unique<I3>();
+                    break;
+                case J1::id():
+                    ptr = std::make_unique<J1>();
+                    break;
+                case J2::id():
+                    ptr = std::make_unique<J2>();
+                    break;
+                case J3::id():
+                    ptr = std::make_unique<J3>();
+                    break;
+                case LodeAngle::id():
+                    ptr = std::make_unique<LodeAngle>();
+                    break;
+                case Anisotropy::id():
+                    ptr = std::make_unique<Anisotropy>();
+                    break;
+                case LinearAnisotropy::id():
+                    ptr = std::make_unique<LinearAnisotropy>();
+                    break;
+                case PlanarAnisotropy::id():
+                    ptr = std::make_unique<PlanarAnisotropy>();
+                    break;
+                case SphericalAnisotropy::id():
+                    ptr = std::make_unique<SphericalAnisotropy>();
+                    break;
+                case Diffusivity::id():
+                    ptr = std::make_unique<Diffusivity>();
+                    break;
+                case ShearStress::id():
+                    ptr = std::make_unique<ShearStress>();
+                    break;
+                case PureShear::id():
+                    ptr = std::make_unique<PureShear>();
+                    break;
+                case ShapeFactor::id():
+                    ptr = std::make_unique<ShapeFactor>();
+                    break;
+                case IsotropicScaling::id():
+                    ptr = std::make_unique<IsotropicScaling>();
+                    break;
+                case Rotation::id():
+                    ptr = std::make_unique<Rotation>();
+                    break;
+                case FrobeniusNorm::id():
+                    ptr = std::make_unique<FrobeniusNorm>();
+                    break;
+                case HillYieldCriterion::id():
+                    ptr = std::make_unique<HillYieldCriterion>();
+                    break;
+                default:
+                    LogErrorCustom("tfb::readTensorField3D",
+                                   "Default case reached. Revise tensor field import for missing "
+                                   "meta data entry.");
+                    LogErrorCustom("tfb::readTensorField3D",
+                                   "The imported tensor field now does not have all the meta data "
+                                   "with which it was stored.");
+
+                    continue;
+            }
+
+            if (version >= 7) {
+                readMetaData(inFile, filePath, *ptr, numElements);
+            } else {
+                ptr->deserialize(inFile, numElements);
+            }
+
+            metaData.insert(std::make_pair(id, std::move(ptr)));
+        }
+    }
+
+    std::string str;
+    inFile.read(reinterpret_cast<char*>(&size), sizeof(size_t));
+    str.resize(size);
+    inFile.read(&str[0], size);
+
+    if (str != "EOFreached") {
+        throw Exception("EOF not reached", IVW_CONTEXT_CUSTOM("tfb::readTensorField3D"));
+    }
+
+    inFile.close();
+
+    auto tensorField = std::visit(
+        [&](auto& t) { return std::make_shared<TensorField3D>(dimensions, std::move(t), extents); },
+        tensors);
+    tensorField->setMetaData(std::move(metaData));
+
+    tensorField->setDataMapEigenValues(dataMapperEigenValues);
+    tensorField->setDataMapEigenVectors(dataMapperEigenVectors);
+
+    tensorField->setOffset(offset);
+
+    tensorField->setMask(mask);
+
+    return tensorField;
+}
+
+}  // namespace tfb
+
+}  // namespace inviwo
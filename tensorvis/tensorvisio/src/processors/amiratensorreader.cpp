@@ -1,4 +1,11 @@
 #include <inviwo/tensorvisio/processors/amiratensorreader.h>
+#include <inviwo/utilities/util/parallel.h>
+#include <inviwo/utilities/io/mappedfile.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
@@ -30,30 +37,27 @@ void AmiraTensorReader::process() {
     const char* FileName = inFile_.get().c_str();
     // const char* FileName = "testvector3c.am";
 
-    FILE* fp = fopen(FileName, "rb");
-    if (!fp) {
-        LogError("Could not find " << FileName);
-        return;
-    }
+    // The data section is accessed in place, only the pages of the file being converted are read
+    const MappedFile file(FileName);
 
     LogInfo("Reading " << FileName);
 
-    // We read the first 2k bytes into memory to parse the header.
+    // We copy the first 2k bytes to parse the header.
     // The fixed buffer size looks a bit like a hack, and it is one, but it gets the job done.
     char buffer[2048];
-    if (fread(buffer, sizeof(char), 2047, fp) != 2047) return;
+    if (file.size() < 2047) return;
+    std::memcpy(buffer, file.data(), 2047);
     buffer[2047] = '\0';  // The following string routines prefer null-terminated strings
 
     if (!strstr(buffer, "# AmiraMesh BINARY-LITTLE-ENDIAN 2.1")) {
         LogError("Not a proper AmiraMesh file.\n");
-        fclose(fp);
         return;
     }
 
     // Find the Lattice definition, i.e., the dimensions of the uniform grid
     int xDim(0), yDim(0), zDim(0);
     sscanf(FindAndJump(buffer, "define Lattice"), "%d %d %d", &xDim, &yDim, &zDim);
-    printf("\tGrid Dimensions: %d %d %d\n", xDim, yDim, zDim);
+    LogInfo("Grid Dimensions: " << xDim << " " << yDim << " " << zDim);
 
     // Find the BoundingBox
     float xmin(1.0f), ymin(1.0f), zmin(1.0f);
@@ -77,82 +81,70 @@ void AmiraTensorReader::process() {
     }
     LogInfo("Number of Components: " << NumComponents);
 
-    // Find the beginning of the data section
-    const long idxStartData = long(strstr(buffer, "# Data section follows") - buffer);
-    if (idxStartData > 0) {
-        // Set the file pointer to the beginning of "# Data section follows"
-        fseek(fp, idxStartData, SEEK_SET);
-        // Consume this line, which is "# Data section follows"
-        if (!fgets(buffer, 2047, fp)) return;
-        // Consume the next line, which is "@1"
-        if (!fgets(buffer, 2047, fp)) return;
-
-        // Read the data
-        // - how much to read
-        const size_t NumToRead = xDim * yDim * zDim * NumComponents;
-        // - prepare memory; use malloc() if you're using pure C
-        float* pData = new float[NumToRead];
-        if (pData) {
-            // - do it
-            const size_t ActRead = fread((void*)pData, sizeof(float), NumToRead, fp);
-            // - ok?
-            if (NumToRead != ActRead) {
-                LogError(
-                    "Something went wrong while reading the binary data section.\nPremature end of "
-                    "file?\n");
-                delete[] pData;
-                fclose(fp);
-                return;
-            }
-
-            // Test: Print all data values
-            // Note: Data runs x-fastest, i.e., the loop over the x-axis is the innermost
-            printf("\nPrinting all values in the same order in which they are in memory:\n");
-            int Idx(0);
-
-            std::vector<dmat3> data;
-            std::vector<double> rawData_;
-
-            for (int z = 0; z < zDim; z++) {
-                for (int y = 0; y < yDim; y++) {
-                    for (int x = 0; x < xDim; x++) {
-                        auto dataPoint1 = pData[Idx * NumComponents];
-                        auto dataPoint2 = pData[Idx * NumComponents + 1];
-                        auto dataPoint3 = pData[Idx * NumComponents + 2];
-                        auto dataPoint4 = pData[Idx * NumComponents + 3];
-                        auto dataPoint5 = pData[Idx * NumComponents + 4];
-                        auto dataPoint6 = pData[Idx * NumComponents + 5];
-
-                        auto tensor = dmat3(dvec3(dataPoint1, dataPoint2, dataPoint3),
-                                            dvec3(dataPoint2, dataPoint4, dataPoint5),
-                                            dvec3(dataPoint3, dataPoint5, dataPoint6));
-
-                        rawData_.push_back(dataPoint1);
-                        rawData_.push_back(dataPoint2);
-                        rawData_.push_back(dataPoint3);
-
-                        rawData_.push_back(dataPoint2);
-                        rawData_.push_back(dataPoint4);
-                        rawData_.push_back(dataPoint5);
-
-                        rawData_.push_back(dataPoint3);
-                        rawData_.push_back(dataPoint5);
-                        rawData_.push_back(dataPoint6);
+    // Six components are the unique entries (xx, xy, xz, yy, yz, zz) of symmetric tensors, nine
+    // components are full tensors
+    if (NumComponents != 6 && NumComponents != 9) {
+        LogError("Unsupported number of components "
+                 << NumComponents << ", expected a 6 or 9 component tensor field");
+        return;
+    }
 
-                        data.push_back(tensor);
+    // Find the beginning of the data section
+    const auto dataSection = strstr(buffer, "# Data section follows");
+    if (!dataSection) return;
+
+    // Skip this line, which is "# Data section follows", and the next line, which is "@1"
+    const auto begin = reinterpret_cast<const char*>(file.data());
+    const auto end = begin + file.size();
+    auto payload = begin + (dataSection - buffer);
+    for (int line = 0; line < 2; ++line) {
+        payload = std::find(payload, end, '\n');
+        if (payload != end) ++payload;
+    }
 
-                        Idx++;
-                    }
+    const size3_t dimensions(xDim, yDim, zDim);
+    const auto numTensors = glm::compMul(dimensions);
+    const auto payloadBytes = numTensors * NumComponents * sizeof(float);
+    if (static_cast<size_t>(end - payload) < payloadBytes) {
+        LogError(
+            "Something went wrong while reading the binary data section.\nPremature end of "
+            "file?\n");
+        return;
+    }
+    // The payload is not necessarily aligned for floats, hence the values are copied bytewise
+    const auto value = [payload](size_t i) {
+        float v;
+        std::memcpy(&v, payload + i * sizeof(float), sizeof(float));
+        return v;
+    };
+
+    // The data runs x-fastest like the tensor field, so voxel i maps to index i. The tensors are
+    // assembled in parallel straight from the mapping into float storage of the field, the eigen
+    // decomposition is deferred until it is needed.
+    const auto grainSize = util::defaultGrainSize(numTensors);
+    if (NumComponents == 6) {
+        // Packed order of the storage is (xx, yy, zz, xy, yz, xz)
+        constexpr std::array<size_t, 6> fileComponent{0, 3, 5, 1, 4, 2};
+        SymmetricTensorStorage3D<float> packed(numTensors);
+        util::forEachRangeParallel(numTensors, grainSize, [&](size_t first, size_t last) {
+            for (size_t c = 0; c < 6; ++c) {
+                auto component = packed.component(c).data();
+                for (size_t i = first; i < last; ++i) {
+                    component[i] = value(i * 6 + fileComponent[c]);
                 }
             }
-
-            delete[] pData;
-
-            outport_.setData(std::make_shared<TensorField3D>(xDim, yDim, zDim, rawData_, extents));
-        }
+        });
+        outport_.setData(
+            std::make_shared<TensorField3D>(dimensions, std::move(packed), vec3(extents)));
+    } else {
+        FullTensorStorage3D<float> full(numTensors);
+        util::forEachRangeParallel(numTensors, grainSize, [&](size_t first, size_t last) {
+            std::memcpy(glm::value_ptr(full.tensors()[first]), payload + first * 9 * sizeof(float),
+                        (last - first) * 9 * sizeof(float));
+        });
+        outport_.setData(
+            std::make_shared<TensorField3D>(dimensions, std::move(full), vec3(extents)));
     }
-
-    fclose(fp);
 }
 
 }  // namespace inviwo
@@ -1,7 +1,14 @@
 #include <inviwo/tensorvisio/processors/flowguifilereader.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/utilities/io/mappedfile.h>
 
-#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
 
 namespace inviwo {
 
@@ -15,127 +22,214 @@ const ProcessorInfo FlowGUIFileReader::processorInfo_{
 };
 const ProcessorInfo FlowGUIFileReader::getProcessorInfo() const { return processorInfo_; }
 
-FlowGUIFileReader::FlowGUIFileReader()
-    : Processor()
-    , inFile_("inFile", "File", "")
-    , fieldType_("fieldType", "Field type", {{"scalar", "Scalar", 0}, {"vec4", "Vec4", 1}})
-    , outport_("outport")
-    , outportVec3_("outportVec3") {
-    addProperty(inFile_);
-    addProperty(fieldType_);
-    addPort(outport_);
-    addPort(outportVec3_);
-}
+/*
+ * Header and offset table of a FlowGUI file. The file starts with the length of the name, the
+ * name, the min and max bounds as vec4 and the dimensions as ivec4 where w is the number of time
+ * steps, followed by the time steps of numElements scalars or vec4s each.
+ */
+struct FlowGUIFileReader::TimeSeries {
+    using Future = std::shared_future<std::shared_ptr<Volume>>;
+
+    TimeSeries(const std::string& file, bool isVec4)
+        : file{file}, isVec4{isVec4}, mappedFile{file} {
+        size_t pos = 0;
+        const auto readHeader = [&](void* dest, size_t bytes) {
+            if (pos + bytes > mappedFile.size()) {
+                throw Exception("Invalid header in " + file,
+                                IVW_CONTEXT_CUSTOM("FlowGUIFileReader"));
+            }
+            std::memcpy(dest, mappedFile.data() + pos, bytes);
+            pos += bytes;
+        };
+
+        int length = 0;
+        readHeader(&length, sizeof(int));
+        name.resize(std::max(length, 0));
+        readHeader(name.data(), name.size());
+
+        readHeader(&minBounds, sizeof(float) * 4);
+        readHeader(&maxBounds, sizeof(float) * 4);
+        ivec4 dims{0};
+        readHeader(&dims, sizeof(int) * 4);
+        if (glm::any(glm::lessThan(dims, ivec4(0)))) {
+            throw Exception("Invalid header in " + file, IVW_CONTEXT_CUSTOM("FlowGUIFileReader"));
+        }
+        dimensions = size3_t(dims);
+
+        // Steps that do not fit into the file are dropped
+        const auto stepBytes = stepSize();
+        for (int i = 0; i < dims.w; ++i) {
+            const auto offset = pos + static_cast<size_t>(i) * stepBytes;
+            if (offset + stepBytes > mappedFile.size()) break;
+            offsets.push_back(offset);
+        }
+    }
 
-void FlowGUIFileReader::process() {
-    std::ifstream inFile(inFile_.get(), std::ios::in | std::ios::binary);
+    size_t numElements() const { return glm::compMul(dimensions); }
+    size_t stepSize() const { return numElements() * (isVec4 ? 4 : 1) * sizeof(float); }
+    size_t numSteps() const { return offsets.size(); }
+
+    // Copies one time step out of the mapping, safe to call concurrently
+    std::shared_ptr<Volume> read(size_t step) const {
+        auto volume = std::make_shared<Volume>(
+            dimensions, isVec4 ? static_cast<const DataFormatBase*>(DataVec4Float32::get())
+                               : static_cast<const DataFormatBase*>(DataFloat32::get()));
+        auto volumeRAM = volume->getEditableRepresentation<VolumeRAM>();
+        std::memcpy(volumeRAM->getData(), mappedFile.data() + offsets[step], stepSize());
+
+        volume->setOffset(minBounds);
+        auto basis = mat3(1.f);
+        const auto extents = maxBounds - minBounds;
+        basis[0][0] = extents.x;
+        basis[1][1] = extents.y;
+        basis[2][2] = extents.z;
+        volume->setBasis(basis);
+
+        if (!isVec4) {
+            const auto data = static_cast<const glm::f32*>(volumeRAM->getData());
+            auto min = std::numeric_limits<float>::max();
+            auto max = std::numeric_limits<float>::lowest();
+            for (size_t j = 0; j < numElements(); j++) {
+                min = std::min(min, data[j]);
+                max = std::max(max, data[j]);
+            }
+            volume->dataMap_.valueRange = vec2(min, max);
+            volume->dataMap_.dataRange = vec2(min, max);
+        }
+        return volume;
+    }
 
-    if (!inFile) {
-        LogError("Couldn't open file");
-        return;
+    // Schedules reading the time step on the pool unless it is cached already
+    static Future request(const std::shared_ptr<TimeSeries>& self, size_t step) {
+        std::scoped_lock lock{self->mutex};
+        auto it = self->cache.find(step);
+        if (it == self->cache.end()) {
+            auto future = dispatchPool([self, step]() { return self->read(step); }).share();
+            it = self->cache.emplace(step, std::move(future)).first;
+        }
+        return it->second;
     }
 
-    // Length of Name
-    int length;
-    inFile.read(reinterpret_cast<char*>(&length), sizeof(int));
+    // Returns the time step, waiting for it if it is being read
+    static std::shared_ptr<Volume> get(const std::shared_ptr<TimeSeries>& self, size_t step) {
+        auto future = request(self, step);
+        try {
+            return future.get();
+        } catch (...) {
+            std::scoped_lock lock{self->mutex};
+            self->cache.erase(step);
+            throw;
+        }
+    }
 
+    std::string file;
+    bool isVec4;
+    MappedFile mappedFile;
     std::string name;
-    name.resize(length);
+    vec4 minBounds{0.0f};
+    vec4 maxBounds{0.0f};
+    size3_t dimensions{0};
+    std::vector<size_t> offsets;
 
-    inFile.read(&name[0], length * sizeof(char));
-
-    LogInfo(name);
-
-    // Bounds
-    vec4 minBounds;
-    inFile.read(reinterpret_cast<char*>(&minBounds), sizeof(float) * 4);
-
-    vec4 maxBounds;
-    inFile.read(reinterpret_cast<char*>(&maxBounds), sizeof(float) * 4);
-
-    ivec4 dimensions;
-    inFile.read(reinterpret_cast<char*>(&dimensions), sizeof(int) * 4);
-
-    LogInfo(minBounds);
-    LogInfo(maxBounds);
-    LogInfo(dimensions);
+    std::mutex mutex;
+    std::map<size_t, Future> cache;
+};
 
-    const auto numElements = dimensions.x * dimensions.y * dimensions.z;
+namespace {
 
-    auto volumes = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
-    auto volumes_vec3 = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
+std::shared_ptr<Volume> toVec3(const Volume& volume) {
+    auto volumeVec3 = std::make_shared<Volume>(volume.getDimensions(), DataVec3Float32::get());
+    const auto src =
+        static_cast<const vec4*>(volume.getRepresentation<VolumeRAM>()->getData());
+    auto dst = static_cast<vec3*>(volumeVec3->getEditableRepresentation<VolumeRAM>()->getData());
+    const auto numElements = glm::compMul(volume.getDimensions());
+    for (size_t j = 0; j < numElements; j++) {
+        dst[j] = vec3(src[j]);
+    }
+    volumeVec3->setOffset(volume.getOffset());
+    volumeVec3->setBasis(volume.getBasis());
+    return volumeVec3;
+}
 
-    if (fieldType_.get() == 1) {
-        for (int i = 0; i < dimensions.w; i++) {
-            volumes->emplace_back(
-                std::make_shared<Volume>(size3_t(dimensions), DataVec4Float32::get()));
+}  // namespace
 
-            auto volume = volumes->back();
+FlowGUIFileReader::FlowGUIFileReader()
+    : Processor()
+    , inFile_("inFile", "File", "")
+    , fieldType_("fieldType", "Field type", {{"scalar", "Scalar", 0}, {"vec4", "Vec4", 1}})
+    , allTimeSteps_("allTimeSteps", "All time steps", true)
+    , timeStep_("timeStep", "Time step", 0, 0, 0)
+    , prefetch_("prefetch", "Prefetched steps", 2, 0, 16, 1, InvalidationLevel::Valid)
+    , outport_("outport")
+    , outportVec3_("outportVec3")
+    , timeStepOutport_("timeStep")
+    , timeStepVec3Outport_("timeStepVec3") {
+    addProperties(inFile_, fieldType_, allTimeSteps_, timeStep_, prefetch_);
+    addPort(outport_);
+    addPort(outportVec3_);
+    addPort(timeStepOutport_);
+    addPort(timeStepVec3Outport_);
 
-            auto volumeRAM = volume->getEditableRepresentation<VolumeRAM>();
-            auto volumeData = static_cast<vec4*>(volumeRAM->getData());
+    inFile_.onChange([this]() { reload_ = true; });
+    fieldType_.onChange([this]() { reload_ = true; });
+    prefetch_.onChange([this]() { prefetch(timeStep_.get()); });
+}
 
-            inFile.read(reinterpret_cast<char*>(volumeData), sizeof(float) * 4 * numElements);
+void FlowGUIFileReader::process() {
+    if (reload_) {
+        series_ = std::make_shared<TimeSeries>(inFile_.get(), fieldType_.get() == 1);
+        reload_ = false;
 
-            volume->setOffset(minBounds);
-            auto basis = mat3(1.f);
-            auto extents = maxBounds - minBounds;
-            basis[0][0] = extents.x;
-            basis[1][1] = extents.y;
-            basis[2][2] = extents.z;
-            volume->setBasis(basis);
+        LogInfo(series_->name);
+        LogInfo(series_->minBounds);
+        LogInfo(series_->maxBounds);
+        LogInfo(series_->dimensions << ", " << series_->numSteps() << " time steps");
 
-            volumes_vec3->emplace_back(
-                std::make_shared<Volume>(size3_t(dimensions), DataVec3Float32::get()));
+        timeStep_.setMaxValue(std::max<size_t>(series_->numSteps(), 1) - 1);
+    }
+    if (series_->numSteps() == 0) {
+        LogError("No time steps in " << inFile_.get());
+        return;
+    }
 
-            auto volume_vec3 = volumes_vec3->back();
+    const bool isVec4 = series_->isVec4;
+    const auto step = std::min(timeStep_.get(), series_->numSteps() - 1);
 
-            auto volumeRAM_vec3 = volume_vec3->getEditableRepresentation<VolumeRAM>();
-            auto volumeData_vec3 = static_cast<vec3*>(volumeRAM_vec3->getData());
+    if (allTimeSteps_.get()) {
+        // Schedule all steps before waiting for the first one, they are read concurrently
+        for (size_t i = 0; i < series_->numSteps(); ++i) TimeSeries::request(series_, i);
 
-            for (int j = 0; j < numElements; j++) {
-                volumeData_vec3[j] = vec3(volumeData[j]);
-            }
-            volume_vec3->setOffset(minBounds);
-            volume_vec3->setBasis(basis);
+        auto volumes = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
+        auto volumesVec3 = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
+        for (size_t i = 0; i < series_->numSteps(); ++i) {
+            volumes->push_back(TimeSeries::get(series_, i));
+            if (isVec4) volumesVec3->push_back(toVec3(*volumes->back()));
         }
-
         outport_.setData(volumes);
+        if (isVec4) outportVec3_.setData(volumesVec3);
+    }
 
-        outportVec3_.setData(volumes_vec3);
-    } else {
-        for (int i = 0; i < dimensions.w; i++) {
-            volumes->emplace_back(
-                std::make_shared<Volume>(size3_t(dimensions), DataFloat32::get()));
-
-            auto volume = volumes->back();
-
-            auto volumeRAM = volume->getEditableRepresentation<VolumeRAM>();
-            auto volumeData = static_cast<glm::f32*>(volumeRAM->getData());
-
-            inFile.read(reinterpret_cast<char*>(volumeData), sizeof(float) * numElements);
-
-            auto min = std::numeric_limits<float>::max();
-            auto max = std::numeric_limits<float>::lowest();
-
-            for (int j = 0; j < numElements; j++) {
-                min = std::min(min, volumeData[j]);
-                max = std::max(max, volumeData[j]);
-            }
-
-            volume->setOffset(minBounds);
-            auto basis = mat3(1);
-            auto extents = maxBounds - minBounds;
-            basis[0][0] = extents.x;
-            basis[1][1] = extents.y;
-            basis[2][2] = extents.z;
-            volume->setBasis(basis);
-
-            volume->dataMap_.valueRange = vec2(min, max);
-            volume->dataMap_.dataRange = vec2(min, max);
-        }
+    const auto volume = TimeSeries::get(series_, step);
+    timeStepOutport_.setData(volume);
+    if (isVec4) timeStepVec3Outport_.setData(toVec3(*volume));
+    prefetch(step);
+}
 
-        outport_.setData(volumes);
+void FlowGUIFileReader::prefetch(size_t step) {
+    if (!series_ || allTimeSteps_.get()) return;
+    const auto numSteps = series_->numSteps();
+    if (numSteps == 0) return;
+    const size_t last = std::min(step + prefetch_.get(), numSteps - 1);
+
+    std::scoped_lock lock{series_->mutex};
+    // Only the current step and the prefetched ones are kept in memory
+    auto& cache = series_->cache;
+    for (auto it = cache.begin(); it != cache.end();) {
+        it = (it->first < step || it->first > last) ? cache.erase(it) : std::next(it);
+    }
+    for (size_t i = step + 1; i <= last; ++i) {
+        if (cache.count(i)) continue;
+        cache[i] = dispatchPool([series = series_, i]() { return series->read(i); }).share();
     }
 }
 
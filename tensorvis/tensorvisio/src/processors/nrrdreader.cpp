@@ -31,6 +31,12 @@
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <zlib.h>
+
+#include <array>
+#include <cstring>
 
 namespace inviwo {
 
@@ -129,81 +135,105 @@ void NRRDReader::process() {
         LogError("Raw file does not exist");
         return;
     }
-    std::ifstream rawFile(rawFileName, std::ios::in | std::ios::binary);
 
-    if (!rawFile) {
-        LogError("Couldn't open raw file");
-        return;
-    }
+    const auto valueOf = [&](const std::string& key, const std::string& defaultValue) {
+        auto it = values.find(key);
+        return it != values.end() ? it->second : defaultValue;
+    };
+    const auto encoding = valueOf("encoding", "raw");
+    // Files without endian field have so far been read as big endian
+    const auto bigEndian = valueOf("endian", "big") != "little";
 
     auto numberOfTensors = dimensions.x * dimensions.y * dimensions.z;
 
+    // Confidence followed by xx, xy, xz, yy, yz, zz for every voxel
+    constexpr size_t valuesPerVoxel = 7;
+    std::vector<float> payload(numberOfTensors * valuesPerVoxel);
+    const auto payloadBytes = payload.size() * sizeof(float);
+    auto payloadData = reinterpret_cast<char*>(payload.data());
+
+    if (encoding == "raw") {
+        std::ifstream rawFile(rawFileName, std::ios::in | std::ios::binary);
+
+        if (!rawFile) {
+            LogError("Couldn't open raw file");
+            return;
+        }
+
+        rawFile.read(payloadData, payloadBytes);
+        if (static_cast<size_t>(rawFile.gcount()) != payloadBytes) {
+            LogError("Raw file is smaller than the tensor field");
+            return;
+        }
+    } else if (encoding == "gzip" || encoding == "gz") {
+        auto rawFile = gzopen(rawFileName.c_str(), "rb");
+
+        if (!rawFile) {
+            LogError("Couldn't open raw file");
+            return;
+        }
+
+        // gzread decompresses directly into the payload, at most INT_MAX bytes per call
+        gzbuffer(rawFile, 1 << 20);
+        size_t bytesRead = 0;
+        while (bytesRead < payloadBytes) {
+            const auto count = std::min<size_t>(payloadBytes - bytesRead, size_t{1} << 30);
+            const auto read =
+                gzread(rawFile, payloadData + bytesRead, static_cast<unsigned>(count));
+            if (read <= 0) break;
+            bytesRead += static_cast<size_t>(read);
+        }
+        gzclose(rawFile);
+
+        if (bytesRead != payloadBytes) {
+            LogError("Raw file is smaller than the tensor field");
+            return;
+        }
+    } else {
+        LogError("Unsupported encoding " << encoding);
+        return;
+    }
+
     std::vector<dmat3> dataForTensorField;
 
     dataForTensorField.resize(numberOfTensors);
 
-    util::IndexMapper3D indexMapper(dimensions);
-
     auto vol = std::make_shared<Volume>(dimensions, DataFloat32::get());
     auto volRam = vol->getEditableRepresentation<VolumeRAM>();
     auto volRamData = static_cast<float*>(volRam->getData());
 
-    auto toLittleEndian = [](const float val) -> float {
-        float read = val;
-        float write;
-        auto r_ptr = reinterpret_cast<char*>(&read);
-        auto w_ptr = reinterpret_cast<char*>(&write);
-        w_ptr[0] = r_ptr[3];
-        w_ptr[1] = r_ptr[2];
-        w_ptr[2] = r_ptr[1];
-        w_ptr[3] = r_ptr[0];
-        return write;
+    auto swapEndian = [](const float val) -> float {
+        glm::u32 bits;
+        std::memcpy(&bits, &val, sizeof(float));
+        bits = (bits >> 24) | ((bits >> 8) & 0x0000ff00u) | ((bits << 8) & 0x00ff0000u) |
+               (bits << 24);
+        float swapped;
+        std::memcpy(&swapped, &bits, sizeof(float));
+        return swapped;
     };
 
-    for (size_t z = 0; z < dimensions.z; z++) {
-        for (size_t y = 0; y < dimensions.y; y++) {
-            for (size_t x = 0; x < dimensions.x; x++) {
-                auto index = indexMapper(size3_t(x, y, z));
-                float confidence;
-                float xx;
-                float yy;
-                float zz;
-                float xy;
-                float xz;
-                float yz;
-
-                rawFile.read(reinterpret_cast<char*>(&confidence), sizeof(float));
-
-                rawFile.read(reinterpret_cast<char*>(&xx), sizeof(float));
-                rawFile.read(reinterpret_cast<char*>(&xy), sizeof(float));
-                rawFile.read(reinterpret_cast<char*>(&xz), sizeof(float));
-
-                rawFile.read(reinterpret_cast<char*>(&yy), sizeof(float));
-                rawFile.read(reinterpret_cast<char*>(&yz), sizeof(float));
-                rawFile.read(reinterpret_cast<char*>(&zz), sizeof(float));
-
-                confidence = toLittleEndian(confidence);
-                xx = toLittleEndian(xx);
-                yy = toLittleEndian(yy);
-                zz = toLittleEndian(zz);
-                xy = toLittleEndian(xy);
-                xz = toLittleEndian(xz);
-                yz = toLittleEndian(yz);
-
-                double weight = 0.;
-                if (confidence == 1.) {
-                    weight = 1.;
-                }
-
-                dvec3 col1(xx, xy, xz);
-                dvec3 col2(xy, yy, yz);
-                dvec3 col3(xz, yz, zz);
-
-                dataForTensorField[index] = dmat3(col1, col2, col3) * weight;
-                volRamData[index] = confidence;
-            }
+    // The raw data is ordered x fastest, like the tensor field, so voxel i maps to index i
+    util::forEachParallel(dataForTensorField, [&](const dmat3&, size_t i) {
+        std::array<float, valuesPerVoxel> v;
+        std::copy_n(payload.data() + i * valuesPerVoxel, valuesPerVoxel, v.begin());
+        if (bigEndian) {
+            for (auto& value : v) value = swapEndian(value);
         }
-    }
+
+        const auto [confidence, xx, xy, xz, yy, yz, zz] = v;
+
+        double weight = 0.;
+        if (confidence == 1.) {
+            weight = 1.;
+        }
+
+        dvec3 col1(xx, xy, xz);
+        dvec3 col2(xy, yy, yz);
+        dvec3 col3(xz, yz, zz);
+
+        dataForTensorField[i] = dmat3(col1, col2, col3) * weight;
+        volRamData[i] = confidence;
+    });
 
     vol->setBasis(mat3(1.f));
     vol->setOffset(vec3(0.f));
@@ -28,9 +28,73 @@
  *********************************************************************************/
 
 #include <inviwo/tensorvisio/processors/tensorfield2dexport.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <fstream>
 
 namespace inviwo {
 
+namespace {
+
+void writeBinary(std::ostream& out, const TensorField2D& tensorField, bool includeEigenInfo) {
+    std::string versionStr("TFBVersion:");
+    size_t size = versionStr.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+    out.write(&versionStr[0], size);
+
+    size_t version = 2;
+    out.write(reinterpret_cast<const char*>(&version), sizeof(size_t));
+
+    size_t dimensionality = tensorField.dimensionality();
+    out.write(reinterpret_cast<const char*>(&dimensionality), sizeof(size_t));
+
+    size_t rank = tensorField.rank();
+    out.write(reinterpret_cast<const char*>(&rank), sizeof(size_t));
+
+    out.write(reinterpret_cast<const char*>(&includeEigenInfo), sizeof(bool));
+
+    auto dimensions = tensorField.getDimensions();
+    out.write(reinterpret_cast<const char*>(&dimensions), sizeof(size_t) * 2);
+
+    auto extents = tensorField.getExtents();
+    out.write(reinterpret_cast<const char*>(&extents), sizeof(double) * 2);
+
+    // Diagonal and symmetric part of every tensor, gathered to write them in one go
+    const auto& tensors = tensorField.tensors();
+    std::vector<double> data(tensors.size() * 3);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        data[i * 3 + 0] = tensors[i][0][0];
+        data[i * 3 + 1] = tensors[i][1][1];
+        data[i * 3 + 2] = tensors[i][1][0];
+    }
+    out.write(reinterpret_cast<const char*>(data.data()), sizeof(double) * data.size());
+
+    if (includeEigenInfo) {
+        auto majorEigenValues = tensorField.majorEigenValues().data();
+        auto minorEigenValues = tensorField.minorEigenValues().data();
+
+        auto majorEigenVectors = tensorField.majorEigenVectors().data();
+        auto minorEigenVectors = tensorField.minorEigenVectors().data();
+
+        auto numItems = tensorField.getSize();
+
+        out.write(reinterpret_cast<const char*>(majorEigenValues), sizeof(double) * numItems);
+
+        out.write(reinterpret_cast<const char*>(minorEigenValues), sizeof(double) * numItems);
+
+        out.write(reinterpret_cast<const char*>(majorEigenVectors), sizeof(double) * numItems * 2);
+
+        out.write(reinterpret_cast<const char*>(minorEigenVectors), sizeof(double) * numItems * 2);
+    }
+
+    std::string str("EOFreached");
+    size = str.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+    out.write(&str[0], size);
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo TensorField2DExport::processorInfo_{
     "org.inviwo.TensorField2DExport",  // Class identifier
@@ -43,13 +107,16 @@ const ProcessorInfo TensorField2DExport::getProcessorInfo() const { return proce
 
 TensorField2DExport::TensorField2DExport()
     : Processor()
+    , ActivityIndicatorOwner()
     , inport_("inport")
     , export_("export", "Export")
     , exportFile_("exportFile", "Export to", "")
     , exportButton_("exportButton", "Export")
-    , includeEigenInfo_("includeEigenInfo", "Include eigen info", true) {
+    , includeEigenInfo_("includeEigenInfo", "Include eigen info", true)
+    , processorExists_(std::make_shared<std::atomic<bool>>(true)) {
     export_.addProperty(exportFile_);
     export_.addProperty(exportButton_);
+    export_.addProperty(includeEigenInfo_);
     addProperty(export_);
 
     exportFile_.setFileMode(FileMode::AnyFile);
@@ -64,84 +131,55 @@ TensorField2DExport::TensorField2DExport()
     addPort(inport_);
 }
 
+TensorField2DExport::~TensorField2DExport() { *processorExists_ = false; }
+
 void TensorField2DExport::process() {}
 
-void TensorField2DExport::exportBinary() const {
+void TensorField2DExport::exportBinary() {
     if (!inport_.hasData() || !inport_.getData().get()) {
         LogWarn("Inport has no data");
         return;
     }
 
-    LogInfo("Exporting...");
+    if (exportFile_.get().empty()) exportFile_.requestFile();
+    if (exportFile_.get().empty()) return;
 
+    // Keeps the field alive while it is written, the lazily expanded tensors are guarded by the
+    // field itself
     auto tensorField = inport_.getData();
-
-    std::ofstream outFile;
-    outFile.open(exportFile_.get(), std::ios::out | std::ios::binary);
-
-    std::string versionStr("TFBVersion:");
-    size_t size = versionStr.size();
-    outFile.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    outFile.write(&versionStr[0], size);
-
-    size_t version = 2;
-    outFile.write(reinterpret_cast<const char*>(&version), sizeof(size_t));
-
-    size_t dimensionality = tensorField->dimensionality();
-    outFile.write(reinterpret_cast<const char*>(&dimensionality), sizeof(size_t));
-
-    size_t rank = tensorField->rank();
-    outFile.write(reinterpret_cast<const char*>(&rank), sizeof(size_t));
-
-    bool hasEigenInfo = includeEigenInfo_.get();
-    outFile.write(reinterpret_cast<const char*>(&hasEigenInfo), sizeof(bool));
-
-    auto dimensions = tensorField->getDimensions();
-    outFile.write(reinterpret_cast<const char*>(&dimensions), sizeof(size_t) * 2);
-
-    auto extents = tensorField->getExtents();
-    outFile.write(reinterpret_cast<const char*>(&extents), sizeof(double) * 2);
-
-    const auto& data = tensorField->tensors();
-
-    for (const auto& val : data) {
-        // Diagonal
-        outFile.write(reinterpret_cast<const char*>(&val[0][0]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[1][1]), sizeof(double));
-
-        // Symmetric part
-        outFile.write(reinterpret_cast<const char*>(&val[1][0]), sizeof(double));
-    }
-
-    if (includeEigenInfo_.get()) {
-        // Create tensor field here so eigen properties get calculated
-        auto majorEigenValues = tensorField->majorEigenValues().data();
-        auto minorEigenValues = tensorField->minorEigenValues().data();
-
-        auto majorEigenVectors = tensorField->majorEigenVectors().data();
-        auto minorEigenVectors = tensorField->minorEigenVectors().data();
-
-        auto numItems = tensorField->getSize();
-
-        outFile.write(reinterpret_cast<const char*>(majorEigenValues), sizeof(double) * numItems);
-
-        outFile.write(reinterpret_cast<const char*>(minorEigenValues), sizeof(double) * numItems);
-
-        outFile.write(reinterpret_cast<const char*>(majorEigenVectors),
-                      sizeof(double) * numItems * 2);
-
-        outFile.write(reinterpret_cast<const char*>(minorEigenVectors),
-                      sizeof(double) * numItems * 2);
-    }
-
-    std::string str("EOFreached");
-    size = str.size();
-    outFile.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    outFile.write(&str[0], size);
-
-    outFile.close();
-
-    LogInfo("Exporting done.");
+    const auto path = exportFile_.get();
+    const bool includeEigenInfo = includeEigenInfo_.get();
+
+    getActivityIndicator().setActive(true);
+    dispatchPool([this, tensorField, path, includeEigenInfo, exists = processorExists_]() {
+        std::string message;
+        bool failed = false;
+        try {
+            std::ofstream outFile(path, std::ios::out | std::ios::binary);
+            if (!outFile) throw Exception("Could not open " + path, IVW_CONTEXT_CUSTOM("TFB"));
+            writeBinary(outFile, *tensorField, includeEigenInfo);
+            outFile.close();
+            if (!outFile) throw Exception("Could not write " + path, IVW_CONTEXT_CUSTOM("TFB"));
+            message = "File written to " + path;
+        } catch (const Exception& e) {
+            message = e.getMessage();
+            failed = true;
+        } catch (const std::exception& e) {
+            message = e.what();
+            failed = true;
+        }
+
+        if (!*exists) return;
+        dispatchFront([this, exists, message, failed]() {
+            if (!*exists) return;
+            getActivityIndicator().setActive(false);
+            if (failed) {
+                LogProcessorError(message);
+            } else {
+                LogProcessorInfo(message);
+            }
+        });
+    });
 }
 
 }  // namespace inviwo
@@ -30,9 +30,115 @@
 #include <inviwo/tensorvisio/processors/tensorfield3dexport.h>
 #include <inviwo/tensorvisbase/ports/tensorfieldport.h>
 #include <inviwo/tensorvisbase/datastructures/tensorfieldmetadata.h>
+#include <inviwo/tensorvisio/io/tensorfieldchunks.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <fstream>
 
 namespace inviwo {
 
+namespace {
+
+struct ExportSettings {
+    bool includeMetaData;
+    tfb::Compression compression;
+    bool quantizeEigenVectors;
+    bool quantizeMetaData;
+};
+
+void writeBinary(std::ostream& out, const TensorField3D& tensorField,
+                 const ExportSettings& settings) {
+    std::string versionStr("TFBVersion:");
+    size_t size = versionStr.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+    out.write(&versionStr[0], size);
+
+    size_t version = TFB_CURRENT_VERSION;
+    out.write(reinterpret_cast<const char*>(&version), sizeof(size_t));
+
+    size_t dimensionality = tensorField.dimensionality();
+    out.write(reinterpret_cast<const char*>(&dimensionality), sizeof(size_t));
+
+    size_t rank = tensorField.rank();
+    out.write(reinterpret_cast<const char*>(&rank), sizeof(size_t));
+
+    auto hasMetaData = glm::uint8(settings.includeMetaData);
+    out.write(reinterpret_cast<const char*>(&hasMetaData), sizeof(glm::uint8));
+
+    auto dimensions = tensorField.getDimensions();
+    out.write(reinterpret_cast<const char*>(&dimensions), sizeof(size_t) * 3);
+
+    auto extents = tensorField.getExtents();
+    out.write(reinterpret_cast<const char*>(&extents), sizeof(double) * 3);
+
+    auto offset = tensorField.getOffset();
+    out.write(reinterpret_cast<const char*>(&offset), sizeof(double) * 3);
+
+    auto& eigenValueDataMaps = tensorField.dataMapEigenValues();
+    out.write(reinterpret_cast<const char*>(&eigenValueDataMaps[0].dataRange), sizeof(double) * 2);
+    out.write(reinterpret_cast<const char*>(&eigenValueDataMaps[1].dataRange), sizeof(double) * 2);
+    out.write(reinterpret_cast<const char*>(&eigenValueDataMaps[2].dataRange), sizeof(double) * 2);
+
+    auto& eigenVectorDataMaps = tensorField.dataMapEigenVectors();
+    out.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[0].dataRange), sizeof(double) * 2);
+    out.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[1].dataRange), sizeof(double) * 2);
+    out.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[2].dataRange), sizeof(double) * 2);
+
+    tfb::writeTensors(out, tensorField, settings.compression);
+
+    auto hasMask = glm::uint8(tensorField.hasMask());
+    out.write(reinterpret_cast<char*>(&hasMask), sizeof(glm::uint8));
+
+    // The file keeps one byte per voxel
+    if (hasMask) {
+        const auto mask = tensorField.getMask().toBytes();
+        out.write(reinterpret_cast<const char*>(mask.data()), sizeof(glm::uint8) * mask.size());
+    }
+
+    // We always include eigenvalues and eigenvectors
+    const auto isEigenSystem = [](uint64_t id) {
+        switch (id) {
+            case MajorEigenValues::id():
+            case IntermediateEigenValues::id():
+            case MinorEigenValues::id():
+            case MajorEigenVectors::id():
+            case IntermediateEigenVectors::id():
+            case MinorEigenVectors::id():
+                return true;
+            default:
+                return false;
+        }
+    };
+    const auto isEigenVectors = [](uint64_t id) {
+        return id == MajorEigenVectors::id() || id == IntermediateEigenVectors::id() ||
+               id == MinorEigenVectors::id();
+    };
+
+    std::vector<const MetaDataBase*> entries;
+    for (const auto& dataItem : tensorField.metaData()) {
+        if (settings.includeMetaData || isEigenSystem(dataItem.first)) {
+            entries.push_back(dataItem.second.get());
+        }
+    }
+
+    const auto numMetaDataEntries = entries.size();
+    out.write(reinterpret_cast<const char*>(&numMetaDataEntries), sizeof(size_t));
+
+    for (const auto entry : entries) {
+        const auto quantize = isEigenVectors(entry->getId()) ? settings.quantizeEigenVectors
+                                                             : settings.quantizeMetaData;
+        tfb::writeMetaData(out, *entry, tensorField.getSize(), settings.compression,
+                           quantize ? tfb::Encoding::Quantized16 : tfb::Encoding::Raw);
+    }
+
+    std::string str("EOFreached");
+    size = str.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+    out.write(&str[0], size);
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo TensorField3DExport::processorInfo_{
     "org.inviwo.TensorField3DExport",  // Class identifier
@@ -45,14 +151,25 @@ const ProcessorInfo TensorField3DExport::getProcessorInfo() const { return proce
 
 TensorField3DExport::TensorField3DExport()
     : Processor()
+    , ActivityIndicatorOwner()
     , inport_("inport")
     , export_("export", "Export")
     , exportFile_("exportFile", "Export to", "")
     , exportButton_("exportButton", "Export")
-    , includeMetaData_("includeMetaData", "Include meta data", true) {
+    , includeMetaData_("includeMetaData", "Include meta data", true)
+    , compression_("compression", "Compression",
+                   {{"none", "None", tfb::Compression::None},
+                    {"deflate", "Deflate", tfb::Compression::Deflate}},
+                   0)
+    , quantizeEigenVectors_("quantizeEigenVectors", "Quantize eigenvectors", false)
+    , quantizeMetaData_("quantizeMetaData", "Quantize meta data", false)
+    , processorExists_(std::make_shared<std::atomic<bool>>(true)) {
     export_.addProperty(exportFile_);
     export_.addProperty(exportButton_);
     export_.addProperty(includeMetaData_);
+    export_.addProperty(compression_);
+    export_.addProperty(quantizeEigenVectors_);
+    export_.addProperty(quantizeMetaData_);
     addProperty(export_);
 
     exportFile_.setFileMode(FileMode::AnyFile);
@@ -67,136 +184,55 @@ TensorField3DExport::TensorField3DExport()
     addPort(inport_);
 }
 
+TensorField3DExport::~TensorField3DExport() { *processorExists_ = false; }
+
 void TensorField3DExport::process() {}
 
-void TensorField3DExport::exportBinary() const {
+void TensorField3DExport::exportBinary() {
     if (!inport_.hasData() || !inport_.getData().get()) {
         LogWarn("Inport has no data");
         return;
     }
 
-    LogInfo("Exporting...");
-
-    auto tensorField = inport_.getData();
-
-    std::ofstream outFile;
-    outFile.open(exportFile_.get(), std::ios::out | std::ios::binary);
-
-    std::string versionStr("TFBVersion:");
-    size_t size = versionStr.size();
-    outFile.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    outFile.write(&versionStr[0], size);
-
-    size_t version = TFB_CURRENT_VERSION;
-    outFile.write(reinterpret_cast<const char*>(&version), sizeof(size_t));
-
-    size_t dimensionality = tensorField->dimensionality();
-    outFile.write(reinterpret_cast<const char*>(&dimensionality), sizeof(size_t));
-
-    size_t rank = tensorField->rank();
-    outFile.write(reinterpret_cast<const char*>(&rank), sizeof(size_t));
-
-    auto hasMetaData = glm::uint8(includeMetaData_.get());
-    outFile.write(reinterpret_cast<const char*>(&hasMetaData), sizeof(glm::uint8));
-
-    auto dimensions = tensorField->getDimensions();
-    outFile.write(reinterpret_cast<const char*>(&dimensions), sizeof(size_t) * 3);
-
-    auto extents = tensorField->getExtents();
-    outFile.write(reinterpret_cast<const char*>(&extents), sizeof(double) * 3);
-
-    auto offset = tensorField->getOffset();
-    outFile.write(reinterpret_cast<const char*>(&offset), sizeof(double) * 3);
-
-    auto& eigenValueDataMaps = tensorField->dataMapEigenValues_;
-    outFile.write(reinterpret_cast<const char*>(&eigenValueDataMaps[0].dataRange),
-                  sizeof(double) * 2);
-    outFile.write(reinterpret_cast<const char*>(&eigenValueDataMaps[1].dataRange),
-                  sizeof(double) * 2);
-    outFile.write(reinterpret_cast<const char*>(&eigenValueDataMaps[2].dataRange),
-                  sizeof(double) * 2);
-
-    auto& eigenVectorDataMaps = tensorField->dataMapEigenVectors_;
-    outFile.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[0].dataRange),
-                  sizeof(double) * 2);
-    outFile.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[1].dataRange),
-                  sizeof(double) * 2);
-    outFile.write(reinterpret_cast<const char*>(&eigenVectorDataMaps[2].dataRange),
-                  sizeof(double) * 2);
-
-    const auto& data = tensorField->tensors();
-
-    for (const auto& val : data) {
-        // Upper row
-        outFile.write(reinterpret_cast<const char*>(&val[0][0]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[1][0]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[2][0]), sizeof(double));
-
-        // Middle row
-        outFile.write(reinterpret_cast<const char*>(&val[0][1]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[1][1]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[2][1]), sizeof(double));
-
-        // Bottom row
-        outFile.write(reinterpret_cast<const char*>(&val[0][2]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[1][2]), sizeof(double));
-        outFile.write(reinterpret_cast<const char*>(&val[2][2]), sizeof(double));
-    }
-
-    auto hasMask = glm::uint8(tensorField->hasMask());
-    outFile.write(reinterpret_cast<char*>(&hasMask), sizeof(glm::uint8));
-
-    if (hasMask) {
-        auto& mask = tensorField->getMask();
-        auto maskData = mask.data();
-        outFile.write(reinterpret_cast<const char*>(maskData), sizeof(glm::uint8) * mask.size());
-    }
-
-    if (includeMetaData_.get()) {
-        const auto numMetaDataEntries = tensorField->metaData().size();
-        outFile.write(reinterpret_cast<const char*>(&numMetaDataEntries), sizeof(size_t));
-
-        for (const auto& dataItem : tensorField->metaData()) {
-            dataItem.second->serialize(outFile);
+    if (exportFile_.get().empty()) exportFile_.requestFile();
+    if (exportFile_.get().empty()) return;
+
+    // The copy shares all buffers with the inport data but evaluates its lazily computed tensors
+    // and eigen decomposition on its own, hence the writer never races with the network
+    auto tensorField = std::make_shared<TensorField3D>(*inport_.getData());
+    const auto path = exportFile_.get();
+    const ExportSettings settings{includeMetaData_.get(), compression_.get(),
+                                  quantizeEigenVectors_.get(), quantizeMetaData_.get()};
+
+    getActivityIndicator().setActive(true);
+    dispatchPool([this, tensorField, path, settings, exists = processorExists_]() {
+        std::string message;
+        bool failed = false;
+        try {
+            std::ofstream outFile(path, std::ios::out | std::ios::binary);
+            if (!outFile) throw Exception("Could not open " + path, IVW_CONTEXT_CUSTOM("TFB"));
+            writeBinary(outFile, *tensorField, settings);
+            outFile.close();
+            if (!outFile) throw Exception("Could not write " + path, IVW_CONTEXT_CUSTOM("TFB"));
+            message = "File written to " + path;
+        } catch (const Exception& e) {
+            message = e.getMessage();
+            failed = true;
+        } catch (const std::exception& e) {
+            message = e.what();
+            failed = true;
         }
-    }
-    // We always include eigenvalues and eigenvectors
-    else {
-        for (const auto& dataItem : tensorField->metaData()) {
-            auto id = dataItem.first;
-
-            switch (id) {
-                case MajorEigenValues::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                case IntermediateEigenValues::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                case MinorEigenValues::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                case MajorEigenVectors::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                case IntermediateEigenVectors::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                case MinorEigenVectors::id():
-                    dataItem.second->serialize(outFile);
-                    break;
-                default:
-                    break;
-            }
-        }
-    }
 
-    std::string str("EOFreached");
-    size = str.size();
-    outFile.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    outFile.write(&str[0], size);
-
-    outFile.close();
-
-    LogInfo("Exporting done.");
+        if (!*exists) return;
+        dispatchFront([this, exists, message, failed]() {
+            if (!*exists) return;
+            getActivityIndicator().setActive(false);
+            if (failed) {
+                LogProcessorError(message);
+            } else {
+                LogProcessorInfo(message);
+            }
+        });
+    });
 }
 }  // namespace inviwo
\ No newline at end of file
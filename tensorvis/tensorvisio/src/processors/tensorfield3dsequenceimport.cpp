@@ -0,0 +1,93 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/tensorvisio/processors/tensorfield3dsequenceimport.h>
+#include <inviwo/tensorvisio/io/tfbreader.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo TensorField3DSequenceImport::processorInfo_{
+    "org.inviwo.TensorField3DSequenceImport",  // Class identifier
+    "Tensor Field 3D Sequence Import",          // Display name
+    "Tensor Field IO",                          // Category
+    CodeState::Experimental,                    // Code state
+    Tags::None,                                 // Tags
+};
+const ProcessorInfo TensorField3DSequenceImport::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+TensorField3DSequenceImport::TensorField3DSequenceImport()
+    : Processor()
+    , outport_("outport")
+    , files_("files", "Files", "*.tfb")
+    , normalizeExtents_("normalizeExtents", "Normalize extents", true)
+    , prefetch_("prefetch", "Prefetched time steps", 4, 0, 64)
+    , memoryBudget_("memoryBudget", "Memory budget (MB)",
+                    TensorField3DSequence::defaultMemoryBudget >> 20, 64, 65536) {
+    addPort(outport_);
+
+    files_.addNameFilter("Tensor field binary (*.tfb)");
+    addProperties(files_, normalizeExtents_, prefetch_, memoryBudget_);
+
+    files_.onChange([this]() { sequence_.reset(); });
+    normalizeExtents_.onChange([this]() { sequence_.reset(); });
+}
+
+void TensorField3DSequenceImport::process() {
+    if (!sequence_) {
+        auto files = files_.getFileList();
+        std::sort(files.begin(), files.end());
+
+        sequence_ = std::make_shared<TensorField3DSequence>(
+            files.size(),
+            [files, normalize = normalizeExtents_.get()](size_t step) {
+                auto tensorField = tfb::readTensorField3D(files[step]);
+                if (normalize) {
+                    const auto extents = tensorField->getExtents();
+                    tensorField->setExtents(
+                        vec3(extents / std::max(std::max(extents.x, extents.y), extents.z)));
+                }
+                return tensorField;
+            },
+            prefetch_, memoryBudget_ << 20);
+        // Start reading the first time steps right away
+        if (sequence_->size() > 0) sequence_->prefetch(0);
+    } else {
+        sequence_->setPrefetch(prefetch_);
+        sequence_->setMemoryBudget(memoryBudget_ << 20);
+    }
+
+    outport_.setData(sequence_);
+}
+
+}  // namespace inviwo
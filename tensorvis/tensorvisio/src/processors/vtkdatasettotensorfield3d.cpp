@@ -31,6 +31,7 @@
 #include <inviwo/vtk/util/vtkutil.h>
 #include <inviwo/core/util/stringconversion.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/util/foreach.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -43,8 +44,76 @@
 #include <vtkCellData.h>
 #include <warn/pop>
 
+#include <atomic>
+
 namespace inviwo {
 
+namespace {
+
+constexpr size_t conversionChunkSize = 65536;
+
+std::vector<size_t> conversionChunks(size_t size) {
+    return std::vector<size_t>((size + conversionChunkSize - 1) / conversionChunkSize);
+}
+
+/*
+ * Converts the tuples of nine components into the final tensor storage in one parallel pass.
+ * Exactly symmetric tensors are packed in the precision of the array, which avoids a full double
+ * precision copy of the array. Otherwise the tensors are copied into full storage, float arrays
+ * keep their precision.
+ */
+template <typename T>
+std::shared_ptr<TensorField3D> makeTensorField(size3_t dimensions, const T* data,
+                                               const vec3& extent) {
+    const auto size = glm::compMul(dimensions);
+    const auto chunks = conversionChunks(size);
+    constexpr auto indices = SymmetricTensorStorage3D<T>::indices();
+
+    std::atomic<bool> symmetric{true};
+    SymmetricTensorStorage3D<T> packed(size);
+    util::forEachParallel(chunks, [&](size_t, size_t chunk) {
+        const auto last = std::min(size, (chunk + 1) * conversionChunkSize);
+        for (size_t i = chunk * conversionChunkSize; i < last && symmetric; ++i) {
+            const auto tensor = data + i * 9;
+            if (tensor[1] != tensor[3] || tensor[2] != tensor[6] || tensor[5] != tensor[7]) {
+                symmetric = false;
+                return;
+            }
+            for (size_t c = 0; c < indices.size(); ++c) {
+                packed.component(c)[i] = tensor[indices[c].first * 3 + indices[c].second];
+            }
+        }
+    });
+    if (symmetric) return std::make_shared<TensorField3D>(dimensions, std::move(packed), extent);
+
+    packed = SymmetricTensorStorage3D<T>();
+    std::vector<glm::mat<3, 3, T>> tensors(size);
+    util::forEachParallel(chunks, [&](size_t, size_t chunk) {
+        const auto first = chunk * conversionChunkSize;
+        const auto last = std::min(size, first + conversionChunkSize);
+        std::copy(data + first * 9, data + last * 9, glm::value_ptr(tensors[first]));
+    });
+    if constexpr (std::is_same_v<T, float>) {
+        return std::make_shared<TensorField3D>(
+            dimensions, FullTensorStorage3D<float>(std::move(tensors)), extent);
+    } else {
+        return std::make_shared<TensorField3D>(dimensions, std::move(tensors), extent);
+    }
+}
+
+template <typename T>
+std::vector<double> toDoubles(const T* data, size_t size) {
+    std::vector<double> values(size);
+    util::forEachParallel(conversionChunks(size), [&](size_t, size_t chunk) {
+        const auto first = chunk * conversionChunkSize;
+        const auto last = std::min(size, first + conversionChunkSize);
+        std::copy(data + first, data + last, values.begin() + first);
+    });
+    return values;
+}
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo VTKDataSetToTensorField3D::processorInfo_{
     "org.inviwo.VTKDataSetToTensorField3D",  // Class identifier
@@ -155,12 +224,12 @@ void VTKDataSetToTensorField3D::generate() {
 
         std::shared_ptr<TensorField3D> tensorField;
         if (tensorArray->GetDataType() == VTK_DOUBLE) {
-            tensorField = std::make_shared<TensorField3D>(
+            tensorField = makeTensorField(
                 dimensions, vtkDoubleArray::SafeDownCast(tensorArray)->GetPointer(0), extent);
             tensorField->setOffset(offset);
 
         } else if (tensorArray->GetDataType() == VTK_FLOAT) {
-            tensorField = std::make_shared<TensorField3D>(
+            tensorField = makeTensorField(
                 dimensions, vtkFloatArray::SafeDownCast(tensorArray)->GetPointer(0), extent);
             tensorField->setOffset(offset);
         } else {
@@ -172,35 +241,22 @@ void VTKDataSetToTensorField3D::generate() {
         // Add meta data from scalar array
         if (!scalars_.getOptions().empty() && scalars_.get() != "none") {
             auto scalarArray = dataSet->GetPointData()->GetArray(scalars_.get().c_str());
-            const auto size = scalarArray->GetNumberOfValues();
+            const auto size = static_cast<size_t>(scalarArray->GetNumberOfValues());
 
             std::vector<double> scalars{};
-            scalars.resize(size);
-            auto scalarIterator = scalars.begin();
-
             if (scalarArray->GetDataType() == VTK_DOUBLE) {
-                const auto data = vtkDoubleArray::SafeDownCast(scalarArray)->GetPointer(0);
-
-                for (int i = 0; i < size; ++i) {
-                    std::copy(data + i, data + (i + 1), scalarIterator++);
-                }
-
-                tensorField->addMetaData<HillYieldCriterion>(scalars,
-                                                             TensorFeature::HillYieldCriterion);
+                scalars = toDoubles(vtkDoubleArray::SafeDownCast(scalarArray)->GetPointer(0), size);
             } else if (scalarArray->GetDataType() == VTK_FLOAT) {
-                const auto data = vtkFloatArray::SafeDownCast(scalarArray)->GetPointer(0);
-
-                for (int i = 0; i < size; ++i) {
-                    std::copy(data + i, data + (i + 1), scalarIterator++);
-                }
-                tensorField->addMetaData<HillYieldCriterion>(scalars,
-                                                             TensorFeature::HillYieldCriterion);
+                scalars = toDoubles(vtkFloatArray::SafeDownCast(scalarArray)->GetPointer(0), size);
             } else {
                 LogProcessorError("Failed to generate meta data from array \""
                                   << std::string{scalarArray->GetName()}
                                   << "\" because data type is "
                                   << std::string{scalarArray->GetDataTypeAsString()} << ".") return;
             }
+
+            tensorField->addMetaData<HillYieldCriterion>(scalars,
+                                                         TensorFeature::HillYieldCriterion);
         }
 
         busy_ = false;
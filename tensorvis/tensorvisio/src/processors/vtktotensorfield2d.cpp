@@ -40,6 +40,7 @@
 #include <inviwo/tensorvisbase/datastructures/tensorfield2d.h>
 #include <inviwo/tensorvisbase/util/misc.h>
 #include <inviwo/vtk/util/vtkutil.h>
+#include <inviwo/core/util/foreach.h>
 #include <fmt/format.h>
 
 namespace inviwo {
@@ -92,41 +93,31 @@ void VTKToTensorField2D::process() {
     std::vector<dmat2> tensorVector2D;
     tensorVector2D.resize(numberOfElements);
 
-    // Check to see if we need to project the tensor
-    if (tensors->GetNumberOfComponents() == 9) {
-        // If so, find out onto which plane to project
-        CartesianCoordinateAxis axis = dimensions.z == 1   ? CartesianCoordinateAxis::Z
-                                       : dimensions.y == 1 ? CartesianCoordinateAxis::Y
-                                                           : CartesianCoordinateAxis::X;
-
-        std::vector<dmat3> tensorVector3D;
-        tensorVector3D.resize(numberOfElements);
-        auto tensorVector3DRawData = reinterpret_cast<double*>(tensorVector3D.data());
-
-        if (tensors->GetDataType() == VTK_DOUBLE) {
-            const double* raw = vtkDoubleArray::SafeDownCast(tensors)->GetPointer(0);
-            std::memcpy(tensorVector3DRawData, raw, 9 * sizeof(double) * tensorVector3D.size());
-        } else if (tensors->GetDataType() == VTK_FLOAT) {
-            const float* raw = vtkFloatArray::SafeDownCast(tensors)->GetPointer(0);
-            for (size_t i{0}; i < tensorVector3D.size(); ++i) {
-                tensorVector3DRawData[i] = static_cast<double>(raw[i]);
-            }
+    // Converts the tuples directly into the 2D tensors, without an intermediate copy of the array
+    const auto convert = [&](const auto* raw) {
+        // Check to see if we need to project the tensor
+        if (tensors->GetNumberOfComponents() == 9) {
+            // If so, find out onto which plane to project
+            CartesianCoordinateAxis axis = dimensions.z == 1   ? CartesianCoordinateAxis::Z
+                                           : dimensions.y == 1 ? CartesianCoordinateAxis::Y
+                                                               : CartesianCoordinateAxis::X;
+
+            util::forEachParallel(tensorVector2D, [&](const dmat2&, size_t i) {
+                dmat3 tensor;
+                std::copy(raw + i * 9, raw + (i + 1) * 9, glm::value_ptr(tensor));
+                tensorVector2D[i] = tensorutil::getProjectedTensor(tensor, axis);
+            });
+        } else {
+            util::forEachParallel(tensorVector2D, [&](const dmat2&, size_t i) {
+                std::copy(raw + i * 4, raw + (i + 1) * 4, glm::value_ptr(tensorVector2D[i]));
+            });
         }
+    };
 
-        std::transform(
-            tensorVector3D.begin(), tensorVector3D.end(), tensorVector2D.begin(),
-            [&](const dmat3& tensor) { return tensorutil::getProjectedTensor(tensor, axis); });
+    if (tensors->GetDataType() == VTK_DOUBLE) {
+        convert(vtkDoubleArray::SafeDownCast(tensors)->GetPointer(0));
     } else {
-        auto tensorVector2DRawData = reinterpret_cast<double*>(tensorVector2D.data());
-        if (tensors->GetDataType() == VTK_DOUBLE) {
-            const double* raw = vtkDoubleArray::SafeDownCast(tensors)->GetPointer(0);
-            std::memcpy(tensorVector2DRawData, raw, 4 * sizeof(double) * tensorVector2D.size());
-        } else if (tensors->GetDataType() == VTK_FLOAT) {
-            const float* raw = vtkFloatArray::SafeDownCast(tensors)->GetPointer(0);
-            for (size_t i{0}; i < tensorVector2D.size(); ++i) {
-                tensorVector2DRawData[i] = static_cast<double>(raw[i]);
-            }
-        }
+        convert(vtkFloatArray::SafeDownCast(tensors)->GetPointer(0));
     }
 
     tensorField2DOutport_.setData(
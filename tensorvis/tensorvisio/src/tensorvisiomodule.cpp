@@ -36,6 +36,7 @@
 #include <inviwo/tensorvisio/processors/tensorfield2dtovtk.h>
 #include <inviwo/tensorvisio/processors/tensorfield3dexport.h>
 #include <inviwo/tensorvisio/processors/tensorfield3dimport.h>
+#include <inviwo/tensorvisio/processors/tensorfield3dsequenceimport.h>
 #include <inviwo/tensorvisio/processors/vtkdatasettotensorfield3d.h>
 #include <inviwo/tensorvisio/processors/flowguifilereader.h>
 #include <inviwo/tensorvisio/processors/vtktotensorfield2d.h>
@@ -51,6 +52,7 @@ TensorVisIOModule::TensorVisIOModule(InviwoApplication* app) : InviwoModule{app,
     registerProcessor<TensorField2DToVTK>();
     registerProcessor<TensorField3DExport>();
     registerProcessor<TensorField3DImport>();
+    registerProcessor<TensorField3DSequenceImport>();
     registerProcessor<VTKDataSetToTensorField3D>();
     registerProcessor<FlowGUIFileReader>();
     registerProcessor<VTKToTensorField2D>();
@@ -0,0 +1,110 @@
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/tensorvisbase/tensorvisbasemodule.h>
+#include <inviwo/tensorvisbase/tensorvisbasemodulesharedlibrary.h>
+#include <inviwo/tensorvisio/io/tensorfieldchunks.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <warn/pop>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+/*
+ * Throughput of the tfb tensor chunk export and import on a synthetic field, the field size is
+ * the benchmark argument.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+std::shared_ptr<TensorField3D> syntheticField(size_t size) {
+    const size3_t dimensions{size};
+    std::vector<dmat3> tensors;
+    tensors.reserve(size * size * size);
+    for (size_t z = 0; z < size; ++z) {
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                const dvec3 p = dvec3(x, y, z) / dvec3(dimensions);
+                const dvec3 v{std::sin(6.0 * p.y), std::cos(6.0 * p.x), 2.0 * p.z - 1.0};
+                tensors.push_back(dmat3(1.0) + glm::outerProduct(v, v));
+            }
+        }
+    }
+    return std::make_shared<TensorField3D>(dimensions, std::move(tensors));
+}
+
+// Chunks are read in parallel from the file, so both directions go through a temporary file
+std::string benchmarkFile() {
+    return (std::filesystem::temp_directory_path() / "tensorvisio-benchmark.tfb").string();
+}
+
+}  // namespace
+
+static void exportTensors(benchmark::State& state) {
+    const auto tensorField = syntheticField(static_cast<size_t>(state.range(0)));
+    const auto compression = static_cast<tfb::Compression>(state.range(1));
+    const auto filePath = benchmarkFile();
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        std::ofstream out(filePath, std::ios::out | std::ios::binary);
+        tfb::writeTensors(out, *tensorField, compression);
+        bytes += static_cast<int64_t>(out.tellp());
+    }
+    state.SetBytesProcessed(bytes);
+    std::filesystem::remove(filePath);
+}
+BENCHMARK(exportTensors)
+    ->Args({64, static_cast<int>(tfb::Compression::None)})
+    ->Args({64, static_cast<int>(tfb::Compression::Deflate)})
+    ->Unit(benchmark::kMillisecond);
+
+static void importTensors(benchmark::State& state) {
+    const auto tensorField = syntheticField(static_cast<size_t>(state.range(0)));
+    const auto compression = static_cast<tfb::Compression>(state.range(1));
+    const auto filePath = benchmarkFile();
+    {
+        std::ofstream out(filePath, std::ios::out | std::ios::binary);
+        tfb::writeTensors(out, *tensorField, compression);
+    }
+    const auto fileSize = static_cast<int64_t>(std::filesystem::file_size(filePath));
+
+    for (auto _ : state) {
+        std::ifstream in(filePath, std::ios::in | std::ios::binary);
+        benchmark::DoNotOptimize(
+            tfb::readTensors(in, filePath, tensorField->getSize(), TFB_CURRENT_VERSION));
+    }
+    state.SetBytesProcessed(state.iterations() * fileSize);
+    std::filesystem::remove(filePath);
+}
+BENCHMARK(importTensors)
+    ->Args({64, static_cast<int>(tfb::Compression::None)})
+    ->Args({64, static_cast<int>(tfb::Compression::Deflate)})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    inviwo::LogCentral::init();
+
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-TensorVisIO");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        modules.emplace_back(createTensorVisBaseModule());
+        app.registerModules(std::move(modules));
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -3,6 +3,8 @@
 set(dependencies
     InviwoPlottingModule
     InviwoSpringSystemModule
+    InviwoMemoryBudgetModule
+    InviwoUtilitiesModule
     #InviwoEigenUtilsModule
 )
 
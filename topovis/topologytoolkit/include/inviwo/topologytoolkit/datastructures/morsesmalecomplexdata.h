@@ -53,6 +53,11 @@ IVW_MODULE_TOPOLOGYTOOLKIT_API CellType extremaDimToType(int dimensionality, cha
 IVW_MODULE_TOPOLOGYTOOLKIT_API CellType seperatrixTypeToType(int dimensionality, char type);
 
 struct IVW_MODULE_TOPOLOGYTOOLKIT_API MorseSmaleComplexData {
+    /**
+     * create an empty Morse-Smale complex, e.g. for restoring a cached result
+     */
+    MorseSmaleComplexData() = default;
+
 
     /**
      * set the various outputs of the ttk Morse-Smale complex \p msc to the arrays in this struct.
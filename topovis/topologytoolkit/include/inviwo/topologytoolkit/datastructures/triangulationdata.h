@@ -39,6 +39,7 @@
 #include <inviwo/core/datastructures/datamapper.h>
 #include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 #include <inviwo/core/util/document.h>
+#include <inviwo/core/util/stringconversion.h>
 #include <inviwo/core/metadata/metadataowner.h>
 #include <inviwo/core/datastructures/spatialdata.h>
 
@@ -48,6 +49,8 @@
 #include <warn/pop>
 
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <sstream>
 
@@ -63,6 +66,15 @@ namespace topology {
  * At the moment, TTK internally only supports float positions even though ttk::Triangulation might
  * hold doubles. When accessing the point data, it is converted to float. See
  * ttk::ExplicitTriangulation::getVertexPoint().
+ *
+ * The ttk::Triangulation and its points and cells are shared between copies, including the
+ * precondition data built by TTK algorithms (edges, stars, links, ...). Copies with different
+ * scalar values on the same triangulation will therefore not recompute its topology. The
+ * triangulation is detached before it is modified.
+ *
+ * Several named scalar fields can be associated with the vertices, one of them is selected and
+ * used by getScalarValues() and getOffsets(). Selecting another field on a copy is cheap since
+ * the scalar buffers are shared between copies as well, they must not be modified once set.
  */
 class IVW_MODULE_TOPOLOGYTOOLKIT_API TriangulationData : public SpatialEntity<3>,
                                                          public MetaDataOwner {
@@ -86,11 +98,11 @@ public:
                       InputTriangulation type = InputTriangulation::Triangles);
     TriangulationData(std::vector<vec3> points, const std::vector<uint32_t>& indices,
                       Mesh::MeshInfo meshInfo);
-    TriangulationData(const TriangulationData& rhs);
+    TriangulationData(const TriangulationData& rhs) = default;
     TriangulationData(TriangulationData&& rhs);
     ~TriangulationData() = default;
 
-    TriangulationData& operator=(const TriangulationData& rhs);
+    TriangulationData& operator=(const TriangulationData& rhs) = default;
     TriangulationData& operator=(TriangulationData&& rhs);
 
     virtual TriangulationData* clone() const;
@@ -167,6 +179,13 @@ public:
     void addIndices(const std::vector<uint32_t>& indices, InputTriangulation type);
     void addIndices(const std::vector<uint32_t>& indices, Mesh::MeshInfo meshInfo);
 
+    /**
+     * \brief remove cells referring to the same vertex more than once, e.g. after merging vertices
+     *
+     * @return number of removed cells
+     */
+    size_t removeDegenerateCells();
+
     /**
      * \brief set scalar values associated with vertex positions of the triangulation
      *
@@ -181,6 +200,8 @@ public:
     /**
      * \brief set scalar values associated with vertex positions of the triangulation
      *
+     * Replaces the selected scalar values, or adds them as defaultScalarName if there are none.
+     *
      * @param buffer    buffer of scalar values
      * @throw TTKException if buffer elements are not scalar, i.e. have more than one component
      * @throw TTKException if buffer size is less than number of vertices in triangulation
@@ -189,6 +210,8 @@ public:
     /**
      * \brief set scalar values associated with vertex positions of the triangulation
      *
+     * The buffer is used without a copy if it only has one component.
+     *
      * @param buffer    buffer of scalar values
      * @param component   selects buffer component to be used as scalars
      * @throw TTKException if buffer size is less than number of vertices in triangulation
@@ -196,10 +219,45 @@ public:
     void setScalarValues(std::shared_ptr<BufferBase> buffer, size_t component);
     void setScalarValues(const BufferBase& buffer, size_t component);
 
+    /**
+     * \brief return the selected scalar values, nullptr if there are none
+     */
     std::shared_ptr<BufferBase> getScalarValues() const;
 
+    //! name of the scalar values created by setScalarValues() if there are none yet
+    static const std::string defaultScalarName;
+
+    /**
+     * \brief add scalar values named \p name, or replace them if they exist
+     *
+     * The first scalar values added are selected.
+     *
+     * @throw TTKException if buffer elements are not scalar, i.e. have more than one component
+     * @throw TTKException if buffer size is less than number of vertices in triangulation
+     */
+    void addScalarValues(const std::string& name, std::shared_ptr<BufferBase> buffer);
+    void removeScalarValues(const std::string& name);
+    std::vector<std::string> getScalarNames() const;
+    bool hasScalarValues(const std::string& name) const;
+    /**
+     * \brief return the scalar values named \p name, nullptr if there are none
+     */
+    std::shared_ptr<BufferBase> getScalarValues(const std::string& name) const;
+    /**
+     * \brief select the scalar values used by getScalarValues(), getOffsets(), and
+     * setScalarValues()
+     *
+     * @throw TTKException if there are no scalar values named \p name
+     */
+    void selectScalarValues(const std::string& name);
+    /**
+     * \brief return the name of the selected scalar values, empty if there are none
+     */
+    const std::string& getSelectedScalarName() const;
+
     /**
-     * \brief set position/scalar value offsets used in connection with ttk triangulation data
+     * \brief set position/scalar value offsets of the selected scalar values used in connection
+     * with ttk triangulation data
      *
      * @throw TTKException if number of offsets is different from number of vertices
      */
@@ -221,9 +279,30 @@ public:
     const std::vector<long long int>& getCells() const;
     const std::vector<vec3>& getPoints() const;
     vec3 getPoint(const int index) const;
+    /**
+     * return the ttk::Triangulation, a shared triangulation is detached, i.e. copied, first
+     */
     ttk::Triangulation& getTriangulation();
     const ttk::Triangulation& getTriangulation() const;
 
+    /**
+     * \brief use the ttk::Triangulation of \p grid if both describe the same uniform grid
+     *
+     * This keeps the precondition data of \p grid, e.g. when the scalar values of a uniform grid
+     * change but the grid stays the same.
+     *
+     * @return true if the triangulation is shared, false if the grids differ
+     */
+    bool shareTriangulation(const TriangulationData& grid);
+    /**
+     * query whether \p rhs is an implicit triangulation of the same uniform grid
+     */
+    bool hasSameGrid(const TriangulationData& rhs) const;
+    /**
+     * query whether this and \p rhs share the same ttk::Triangulation
+     */
+    bool sharesTriangulation(const TriangulationData& rhs) const;
+
     vec3& operator[](size_t i);
     const vec3& operator[](size_t i) const;
 
@@ -233,6 +312,10 @@ public:
      * @return number of cells
      */
     size_t getCellCount() const;
+    /**
+     * return number of vertices of the triangulation
+     */
+    size_t getVertexCount() const;
 
     virtual const SpatialCameraCoordinateTransformer<3>& getCoordinateTransformer(
         const Camera& camera) const;
@@ -244,47 +327,66 @@ private:
     std::vector<uint32_t> convertToLines(const std::vector<uint32_t>& indices,
                                          Mesh::MeshInfo meshInfo);
 
-    void unsetGrid();
+    /**
+     * The ttk::Triangulation together with the input it refers to. It is shared between copies
+     * of TriangulationData and detached before it is modified, see editGeometry().
+     */
+    struct Geometry {
+        Geometry() = default;
+        Geometry(const Geometry& rhs);
+        Geometry& operator=(const Geometry&) = delete;
+
+        bool isUniformGrid() const { return glm::compMul(gridDims) > 0u; }
+        //! points of the triangulation, computed on first use for uniform grids
+        const std::vector<vec3>& getPoints() const;
+        size_t getCellCount() const;
+        //! set points and cells as input of the triangulation of an explicit triangulation
+        void updateInput();
+
+        /**
+         *  input cells of the triangulation, corresponds to VTK triangle representation
+         * Format: <#vertices in cell 1>, <v0_1>, <v1_1>, ..., <#vertices in cell 2>, <v0_2>,
+         * <v1_2>, ...
+         */
+        std::vector<long long int> cells;
+        mutable std::vector<vec3> points;  //!< triangle vertices
+        mutable std::mutex pointsMutex;
+        ttk::Triangulation triangulation;
+
+        size3_t gridDims{0u};
+        vec3 gridOrigin{0.0f};
+        vec3 gridExtent{0.0f};
+    };
+
+    struct ScalarField {
+        std::string name;
+        std::shared_ptr<BufferBase> values;
+        mutable std::vector<int> offsets;  //!< matching offsets, set on first use if empty
+    };
 
     /**
-     *  input cells of the triangulation, corresponds to VTK triangle representation
-     * Format: <#vertices in cell 1>, <v0_1>, <v1_1>, ..., <#vertices in cell 2>, <v0_2>, <v1_2>,
-     * ...
+     * return the geometry for modification, a shared geometry is detached, i.e. copied, first
      */
-    std::vector<long long int> cells_;
-    mutable std::vector<vec3>
-        points_;  //!< triangle vertices, mutable due to possible change in getPoints
-    mutable std::vector<int> offsets_;  //!< matching offsets
+    Geometry& editGeometry();
+    void checkScalarValues(const BufferBase& buffer) const;
 
-    ttk::Triangulation triangulation_;
+    std::shared_ptr<Geometry> geometry_ = std::make_shared<Geometry>();
 
-    std::shared_ptr<BufferBase> scalars_;  //!< scalars associated with vertices of triangulation
+    std::vector<ScalarField> fields_;  //!< scalars associated with vertices of triangulation
+    size_t selected_ = 0;
+    mutable std::vector<int> defaultOffsets_;  //!< offsets used without scalar values
     DataMapper volumeDataMapper_;  //!< Data mapper associated with volume scalar values, only used
                                    //!< for implicit grids
-
-    size3_t gridDims_;
-    vec3 gridOrigin_;
-    vec3 gridExtent_;
 };
 
 template <typename T, typename std::enable_if<util::rank<T>::value == 0>::type>
 void TriangulationData::setScalarValues(const std::vector<T>& values) {
-    if (values.size() < points_.size()) {
-        throw TTKException("Too little data (" + std::to_string(values.size()) +
-                           " values given, but triangulation holds " +
-                           std::to_string(points_.size()) + " positions");
-    }
-    scalars_ = util::makeBuffer<T>(std::move(std::vector<T>(values)));
+    setScalarValues(util::makeBuffer<T>(std::vector<T>(values)));
 }
 
 template <typename T, typename std::enable_if<util::rank<T>::value == 0>::type>
 void TriangulationData::setScalarValues(std::vector<T>&& values) {
-    if (values.size() < points_.size()) {
-        throw TTKException("Too little data (" + std::to_string(values.size()) +
-                           " values given, but triangulation holds " +
-                           std::to_string(points_.size()) + " positions");
-    }
-    scalars_ = util::makeBuffer<T>(std::move(values));
+    setScalarValues(util::makeBuffer<T>(std::move(values)));
 }
 
 }  // namespace topology
@@ -300,7 +402,8 @@ struct DataTraits<topology::TriangulationData> {
         Document doc;
         doc.append("b", dataName(), {{"style", "color:white;"}});
         utildoc::TableBuilder tb(doc.handle(), P::end());
-        auto triangulation = data.getTriangulation();
+        // avoid copying the triangulation, some of the queries are not const in TTK
+        auto& triangulation = const_cast<ttk::Triangulation&>(data.getTriangulation());
         tb(H("Implicit Triangulation"), data.isUniformGrid());
         tb(H("Dimensionality"), triangulation.getDimensionality());
         tb(H("Number of Cells"), triangulation.getNumberOfCells());
@@ -308,10 +411,14 @@ struct DataTraits<topology::TriangulationData> {
         tb(H("Number of Triangles"), triangulation.getNumberOfTriangles());
         tb(H("Number of Vertices"), triangulation.getNumberOfVertices());
         if (auto scalars = data.getScalarValues()) {
+            tb(H("Scalars"), data.getSelectedScalarName());
             tb(H("Type of Scalars"), scalars->getDataFormat()->getString());
         } else {
             tb(H("Type of Scalars"), "<none>");
         }
+        if (data.getScalarNames().size() > 1) {
+            tb(H("Scalar Fields"), joinString(data.getScalarNames(), ", "));
+        }
         return doc;
     }
 };
@@ -47,7 +47,8 @@ namespace inviwo {
 
 namespace topology {
 
-// See PersistenceDiagram::computeCTPersistenceDiagram
+// See PersistenceDiagram::computeCTPersistenceDiagram. The persistence diagram processors output
+// the pairs sorted by increasing persistence, see topology::sortByPersistence
 using PersistenceDiagramData =
     std::vector<std::tuple<ttk::SimplexId, ttk::CriticalType, ttk::SimplexId, ttk::CriticalType,
                            float, ttk::SimplexId>>;
@@ -0,0 +1,98 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
+#include <inviwo/topologytoolkit/ports/persistencediagramport.h>
+#include <inviwo/topologytoolkit/utils/brickedpersistence.h>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/poolprocessor.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+
+#include <inviwo/dataframe/datastructures/dataframe.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ttk.BrickedPersistenceDiagram, Bricked Persistence Diagram}
+ * ![](org.inviwo.ttk.BrickedPersistenceDiagram.png?classIdentifier=org.inviwo.ttk.BrickedPersistenceDiagram)
+ * Computes the persistence diagram of a volume brick by brick, which bounds the memory of the
+ * analysis by a few bricks instead of a TTK triangulation of the whole volume. The bricks are
+ * processed in parallel and merged over their shared boundaries, the result matches the
+ * persistence diagram of a triangulation of the whole volume without saddle connectors.
+ *
+ * \see topology::brickedPersistence
+ *
+ * ### Inports
+ *   * __volume__   input volume
+ *
+ * ### Outports
+ *   * __outport__   resulting persistence diagram
+ *   * __dataframe__ DataFrame with birth and death of the persistence pairs
+ *   * __tree__      simplified join and split trees as branch decompositions. Each row is a
+ *                   branch with its tree (0 join, 1 split), the vertex ids of its extremum, its
+ *                   saddle and the extremum of its parent branch (-1 for the root), as well as
+ *                   birth, death, and persistence
+ *
+ * ### Properties
+ *   * __Channel__      channel of the input volume used as scalar values
+ *   * __Brick Size__   number of cells of a brick along each axis
+ *   * __Simplification Threshold__  branches with a persistence below this fraction of the
+ *                                   value range are removed from the trees
+ */
+class IVW_MODULE_TOPOLOGYTOOLKIT_API BrickedPersistenceDiagram : public PoolProcessor {
+public:
+    BrickedPersistenceDiagram();
+    virtual ~BrickedPersistenceDiagram() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    void updateTrees();
+
+    VolumeInport inport_;
+    topology::PersistenceDiagramOutport outport_;
+    DataFrameOutport dataFrameOutport_;
+    DataFrameOutport treeOutport_;
+
+    OptionPropertyInt channel_;
+    IntSizeTProperty brickSize_;
+    FloatProperty threshold_;
+
+    //! kept for simplifying the trees without recomputing the pairs
+    std::shared_ptr<const topology::BrickedPersistence> result_;
+};
+
+}  // namespace inviwo
@@ -46,6 +46,7 @@
 #include <inviwo/core/properties/buttonproperty.h>
 
 #include <inviwo/topologytoolkit/ports/contourtreeport.h>
+#include <inviwo/topologytoolkit/utils/resultcache.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -69,9 +70,12 @@ namespace inviwo {
  *                     as spheres and the connecting arcs as lines
  *
  * ### Properties
+ *	 * __Scalars__ Scalar values of the triangulation used for the tree, the ones selected in
+ *	             the input by default
  *	 * __Contour Tree__
  *		+ __Tree Type__ Defines which tree type to calculate
- *		+ __Number of Threads__ Defines how many threads to use when calculating the tree
+ *		+ __Number of Threads__ Defines how many threads to use when calculating the tree, 0 uses
+ *		                        the thread policy of the TTK settings
  *
  */
 
@@ -93,12 +97,17 @@ private:
     topology::TriangulationInport inport_;
     topology::ContourTreeOutport outport_;
 
+    OptionPropertyString scalars_;
+
     TemplateOptionProperty<topology::TreeType> treeType_;
     IntProperty threadCount_;
     BoolProperty segmentation_;
     BoolProperty normalization_;
 
-    std::shared_ptr<topology::ContourTreeData> treeData_;
+    std::shared_ptr<const topology::ContourTreeData> treeData_;
+    //! trees for the most recent inputs, keyed on the content of the triangulation. Trees are
+    //! only cached in memory, see topology::diskcache
+    topology::ResultCache<topology::ContourTreeData> cache_{"Contour tree results"};
     bool treeIsFinished_ = true;
     bool inportChanged_ = false;
 
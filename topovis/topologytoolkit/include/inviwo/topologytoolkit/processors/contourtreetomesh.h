@@ -78,6 +78,9 @@ private:
     FloatVec4Property localMinimaColor_;
     FloatVec4Property saddleColor_;
     FloatVec4Property arcColor_;
+
+    // output mesh, its buffers are reused between runs if nobody else holds it
+    std::shared_ptr<Mesh> mesh_;
 };
 
 }  // namespace inviwo
@@ -36,6 +36,8 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/meshport.h>
 
 namespace inviwo {
@@ -54,6 +56,10 @@ namespace inviwo {
  * ### Properties
  *   * __Buffer__      selects data associated with the vertices of the triangulation
  *   * __Component__   component of the selected buffer which is interpreted as scalar data
+ *   * __Merge Coincident Vertices__   merge vertices sharing a position before creating the
+ *                                     triangulation, otherwise their cells are not connected
+ *   * __Tolerance__   vertices in the same cell of a grid with this spacing are merged, only
+ *                     identical positions are merged if 0
  */
 
 /**
@@ -76,6 +82,8 @@ private:
 
     OptionPropertyInt selectedBuffer_;
     OptionPropertyInt component_;
+    BoolProperty mergeVertices_;
+    FloatProperty tolerance_;
 };
 
 }  // namespace inviwo
@@ -36,6 +36,7 @@
 
 #include <inviwo/topologytoolkit/ports/triangulationdataport.h>
 #include <inviwo/topologytoolkit/ports/morsesmalecomplexport.h>
+#include <inviwo/topologytoolkit/utils/resultcache.h>
 
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
@@ -82,6 +83,8 @@ private:
     FloatProperty saddleConnectorsPersistenceThreshold_;
 
     std::future<std::shared_ptr<const topology::MorseSmaleComplexData>> newMsc_;
+    //! results for the most recent inputs, keyed on the content of the triangulation
+    topology::ResultCache<topology::MorseSmaleComplexData> cache_{"Morse-Smale complex results"};
 
     bool mscDirty_ = true;
     bool hasNewData_ = false;
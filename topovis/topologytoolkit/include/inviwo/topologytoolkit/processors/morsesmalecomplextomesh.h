@@ -85,6 +85,9 @@ protected:
 
     PickingMapper pickingExtrema_;
     PickingMapper pickingSeperatrix_;
+
+    /// Output mesh, its buffers are reused between runs if nobody else holds it
+    std::shared_ptr<Mesh> mesh_;
 };
 
 }  // namespace inviwo
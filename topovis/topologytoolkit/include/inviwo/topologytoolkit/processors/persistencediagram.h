@@ -33,14 +33,19 @@
 #include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
 #include <inviwo/topologytoolkit/ports/persistencediagramport.h>
 #include <inviwo/topologytoolkit/ports/triangulationdataport.h>
+#include <inviwo/topologytoolkit/utils/resultcache.h>
 #include <inviwo/core/processors/activityindicator.h>
 
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 
 #include <inviwo/dataframe/datastructures/dataframe.h>
 
+#include <atomic>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.ttk.PersistenceDiagram, Persistence Diagram}
@@ -57,6 +62,15 @@ namespace inviwo {
  *   * __dataframe__ DataFrame with birth and death of the extremum-saddle pairs. The
  *                   persistence diagram can be created of these by setting X to birth and
  *                   drawing vertical lines from birth to death
+ *
+ * ### Properties
+ *   * __Scalars__ Scalar values of the triangulation used for the diagram, the ones selected in
+ *                 the input by default
+ *   * __Compute Saddle Connectors__ also compute the saddle-saddle pairs
+ *   * __Progressive__ for uniform grids, first output the diagram of a subsampled grid which is
+ *                     replaced by the exact diagram once it is available
+ *   * __Time Budget (ms)__ time the coarse diagram should take, the subsampling is chosen based
+ *                          on the speed of the previous computations
  */
 
 /**
@@ -77,7 +91,20 @@ private:
     topology::TriangulationInport inport_;
     topology::PersistenceDiagramOutport outport_;
     DataFrameOutport dataFrameOutport_;
+    OptionPropertyString scalars_;
     BoolProperty computeSaddleConnectors_;
+    BoolProperty progressive_;
+    IntProperty timeBudget_;
+
+    //! discards coarse results of outdated jobs
+    size_t generation_ = 0;
+    //! speed of the most recent exact computation, used to pick the coarse grid
+    std::atomic<double> verticesPerSecond_{5.0e6};
+
+    //! results for the most recent inputs, keyed on the content of the triangulation
+    topology::ResultCache<std::pair<std::shared_ptr<topology::PersistenceDiagramData>,
+                                    std::shared_ptr<DataFrame>>>
+        cache_{"Persistence diagram results"};
 };
 
 }  // namespace inviwo
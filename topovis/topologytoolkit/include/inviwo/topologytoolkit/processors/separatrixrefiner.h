@@ -33,6 +33,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/topologytoolkit/ports/morsesmalecomplexport.h>
 #include <inviwo/core/ports/meshport.h>
 
@@ -44,8 +45,34 @@
 
 namespace inviwo {
 
+namespace detail {
+
+/**
+ * Nodes and springs of the spring system of a Morse-Smale complex. The critical points come
+ * first followed by the interior points of each separatrix, each separatrix cell is a spring.
+ */
+struct SeparatrixTopology {
+    std::vector<vec3> positions;
+    std::vector<topology::CellType> types;
+    std::vector<std::pair<size_t, size_t>> springs;
+};
+
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<const SeparatrixTopology> makeSeparatrixTopology(
+    const topology::MorseSmaleComplexData& msc);
+
+}  // namespace detail
+
 /** \docpage{org.inviwo.SeparatrixRefiner, Separatrix Refiner}
  * ![](org.inviwo.SeparatrixRefiner.png?classIdentifier=org.inviwo.SeparatrixRefiner)
+ *
+ * ### Properties
+ *   * __Timesteps__  maximum number of timesteps
+ *   * __Integrator__  explicit Verlet or implicit projective dynamics, the latter remains stable
+ *                     for much larger timesteps with stiff springs
+ *   * __Projective Iterations__  local/global iterations of each projective timestep
+ *   * __Convergence Tolerance__  stop early when no node moves more than this during a
+ *                                timestep, 0 always runs all timesteps
+ *   * __Steps Taken__  number of timesteps done by the last refinement
  */
 
 class IVW_MODULE_TOPOLOGYTOOLKIT_API SeparatrixRefiner : public Processor {
@@ -72,11 +99,19 @@ private:
     CompositeProperty springSys_;
     IntSizeTProperty timesteps_;
     FloatProperty timestep_;
+    TemplateOptionProperty<SpringIntegrator> integrator_;
+    IntSizeTProperty projectiveIterations_;
     FloatProperty springLength_;
     FloatProperty springLinearConstant_;
     FloatProperty springSquareConstant_;
     FloatProperty springDamping_;
     FloatProperty gradientScale_;
+    /// stop when no node moves more than this in a timestep, 0 always runs all timesteps
+    FloatProperty tolerance_;
+    IntSizeTProperty stepsTaken_;
+
+    /// reused as long as the input is unchanged
+    std::shared_ptr<const detail::SeparatrixTopology> topology_;
 };
 
 }  // namespace inviwo
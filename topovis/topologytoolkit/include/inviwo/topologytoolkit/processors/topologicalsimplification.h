@@ -33,18 +33,24 @@
 #include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
 #include <inviwo/topologytoolkit/ports/persistencediagramport.h>
 #include <inviwo/topologytoolkit/ports/triangulationdataport.h>
+#include <inviwo/topologytoolkit/utils/resultcache.h>
 
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/poolprocessor.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 
+#include <optional>
+#include <vector>
+
 namespace inviwo {
 
 /** \docpage{org.inviwo.ttk.TopologicalSimplification, Topological Simplification}
  * ![](org.inviwo.ttk.TopologicalSimplification.png?classIdentifier=org.inviwo.ttk.TopologicalSimplification)
  * Removes critical points that have a persistence below the given threshold.
- * Used in conjunction with PersistenceDiagram.
+ * Used in conjunction with PersistenceDiagram. The persistence pairs are sorted once per
+ * diagram, thresholds selecting the same pairs reuse the current result and recent results are
+ * cached, see TTKSettings.
  *
  * ### Inports
  *   * __triangulation__   input triangulation
@@ -79,6 +85,16 @@ private:
 
     FloatProperty threshold_;
     BoolProperty invert_;
+
+    //! sort the pairs of the persistence diagram by persistence, clears cached results
+    void updateHierarchy();
+
+    //! indices of the persistence pairs in order of increasing persistence
+    std::vector<size_t> pairOrder_;
+    std::vector<float> sortedPersistence_;
+    //! simplified triangulations keyed on the selected pairs, see process()
+    topology::ResultCache<topology::TriangulationData> results_{"Simplification results"};
+    std::optional<uint64_t> currentKey_;
 };
 
 }  // namespace inviwo
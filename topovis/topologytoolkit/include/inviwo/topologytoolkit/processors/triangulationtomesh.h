@@ -38,6 +38,7 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/transferfunctionproperty.h>
 #include <inviwo/core/ports/meshport.h>
 
 namespace inviwo {
@@ -45,6 +46,8 @@ namespace inviwo {
 /** \docpage{org.inviwo.ttk.TriangulationToMesh, Triangulation To Mesh}
  * ![](org.inviwo.ttk.TriangulationToMesh.png?classIdentifier=org.inviwo.ttk.TriangulationToMesh)
  * converts a TTK triangulation to a regular Mesh with individual triangles.
+ * The index buffers are kept as long as the triangulation stays the same, e.g. after a topological
+ * simplification, where only the scalar values change.
  *
  * ### Inports
  *   * __triangulation__ TTK triangulation
@@ -54,6 +57,8 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Mesh Color__       color of mesh vertices
+ *   * __Map Scalars to Color__ color the vertices by their scalar value instead
+ *   * __Transfer Function__ maps the normalized scalar values to colors
  *   * __Map to Component__ if mapping to position is enabled, scalar values of the
  *                          triangulation overwrite this component
  */
@@ -77,8 +82,16 @@ private:
     MeshOutport outport_;
 
     FloatVec4Property color_;
+    BoolProperty colorScalars_;
+    TransferFunctionProperty transferFunction_;
     BoolProperty mapScalars_;
     OptionPropertyInt component_;
+
+    //! triangulation the buffers below were created for
+    std::shared_ptr<const topology::TriangulationData> data_;
+    Mesh::IndexVector indices_;
+    std::shared_ptr<Buffer<vec3>> positions_;
+    std::shared_ptr<Buffer<vec4>> colors_;
 };
 
 }  // namespace inviwo
@@ -36,18 +36,27 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.ttk.TriangulationToVolume, Triangulation To Volume}
  * ![](org.inviwo.ttk.TriangulationToVolume.png?classIdentifier=org.inviwo.ttk.TriangulationToVolume)
- * converts a TTK triangulation to a regular Volume using the associated scalar values.
+ * converts a TTK triangulation to a regular Volume using the associated scalar values. Uniform
+ * grids are converted directly, explicit triangulations of tetrahedra or surfaces are resampled
+ * at the voxel centers of a volume spanning their bounding box.
  *
  * ### Inports
  *   * __triangulation__ TTK triangulation
  *
  * ### Outports
  *   * __outport__  volume created from triangulation
+ *
+ * ### Properties
+ *   * __Resample Uniform Grids__  resample uniform grids instead of converting them directly
+ *   * __Dimensions__  dimensions of the resampled volume
+ *   * __Background Value__  value of resampled voxels not covered by the triangulation
  */
 
 /**
@@ -67,6 +76,10 @@ public:
 private:
     topology::TriangulationInport inport_;
     VolumeOutport outport_;
+
+    BoolProperty resample_;
+    IntSize3Property dimensions_;
+    DoubleProperty background_;
 };
 
 }  // namespace inviwo
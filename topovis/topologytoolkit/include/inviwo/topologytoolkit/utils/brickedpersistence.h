@@ -0,0 +1,118 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
+#include <inviwo/topologytoolkit/ports/persistencediagramport.h>
+
+#include <inviwo/core/common/inviwo.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Volume;
+
+namespace topology {
+
+/**
+ * Branch of a merge tree given by an extremum and the saddle at which its component merges into
+ * an older one, i.e. a persistence pair together with the branch it merges into.
+ */
+struct IVW_MODULE_TOPOLOGYTOOLKIT_API MergeTreeBranch {
+    ttk::SimplexId birth;  //!< extremum
+    //! saddle where the branch merges into its parent, the opposite global extremum for the root
+    ttk::SimplexId death;
+    float birthValue;
+    float deathValue;
+    ttk::SimplexId parent;  //!< birth of the parent branch, -1 for the root branch
+};
+
+struct IVW_MODULE_TOPOLOGYTOOLKIT_API BrickedPersistence {
+    //! extremum-saddle pairs and the global minimum-maximum pair, see ttk::PersistenceDiagram
+    PersistenceDiagramData diagram;
+    //! branch decomposition of the join tree, i.e. minima merging at saddles
+    std::vector<MergeTreeBranch> joinTree;
+    //! branch decomposition of the split tree, i.e. maxima merging at saddles
+    std::vector<MergeTreeBranch> splitTree;
+};
+
+/**
+ * Fills \p values with the scalar values of the brick starting at \p offset with \p dims vertices,
+ * x being the fastest running index. Is called concurrently for different bricks.
+ */
+using BrickReader = std::function<void(const size3_t& offset, const size3_t& dims,
+                                       std::vector<float>& values)>;
+
+/**
+ * Brick reader for channel \p channel of \p volume
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API BrickReader volumeBrickReader(std::shared_ptr<const Volume> volume,
+                                                             size_t channel);
+
+/**
+ * \brief compute the persistence pairs of a uniform grid brick by brick
+ *
+ * The grid with \p dims vertices is split into bricks of \p brickSize cells along each axis which
+ * share their boundary vertices with the neighboring bricks. The join and split trees of each
+ * brick are swept locally. Pairs of components never touching the brick boundary are final,
+ * everything else is reduced to a graph over the boundary vertices, which is merged globally.
+ * The connectivity and the tie breaking by vertex id match an implicit ttk::Triangulation of the
+ * whole grid, hence the pairs are the same as those of ttk::PersistenceDiagram on the whole grid
+ * without saddle connectors.
+ *
+ * At most \p threads bricks are processed at the same time and only their scalar values are
+ * read, the rest of the grid is never held in memory. The memory of the global merge is
+ * proportional to the number of boundary vertices.
+ *
+ * @param dims       number of vertices of the grid
+ * @param reader     source of the scalar values of each brick
+ * @param brickSize  number of cells of a brick along each axis
+ * @param threads    number of bricks processed concurrently
+ * @throw TTKException if \p brickSize is zero
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API BrickedPersistence brickedPersistence(const size3_t& dims,
+                                                                     const BrickReader& reader,
+                                                                     size_t brickSize,
+                                                                     int threads);
+
+/**
+ * Simplify a branch decomposition by removing all branches with a persistence less than
+ * \p threshold. The parent of a branch is at least as persistent as the branch itself, hence
+ * the result is still a tree.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::vector<MergeTreeBranch> simplifyBranches(
+    const std::vector<MergeTreeBranch>& branches, float threshold);
+
+}  // namespace topology
+
+}  // namespace inviwo
@@ -0,0 +1,250 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
+#include <inviwo/topologytoolkit/datastructures/triangulationdata.h>
+#include <inviwo/topologytoolkit/datastructures/morsesmalecomplexdata.h>
+#include <inviwo/topologytoolkit/datastructures/contourtreedata.h>
+#include <inviwo/topologytoolkit/ports/persistencediagramport.h>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+#include <inviwo/memorybudget/memorybudget.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+namespace topology {
+
+/**
+ * \brief incremental 64 bit hash of raw memory, used as key for cached results
+ */
+class IVW_MODULE_TOPOLOGYTOOLKIT_API ContentHash {
+public:
+    ContentHash& add(const void* data, size_t bytes);
+
+    template <typename T>
+    ContentHash& add(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+        return add(&value, sizeof(T));
+    }
+    template <typename T>
+    ContentHash& add(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+        add(values.size());
+        return add(values.data(), values.size() * sizeof(T));
+    }
+
+    uint64_t get() const { return hash_; }
+
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+};
+
+/**
+ * \brief hash of the grid or points and cells, the boundary conditions, the offsets, and the
+ * scalar values of \p data. Two triangulations with equal hashes yield the same topological
+ * results.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API uint64_t contentHash(const TriangulationData& data);
+
+/**
+ * \brief estimated memory of a cached result in bytes, reported to the MemoryBudget by the
+ * ResultCache. The input triangulation referred to by a result is not included.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API size_t memoryUsage(const TriangulationData& data);
+IVW_MODULE_TOPOLOGYTOOLKIT_API size_t memoryUsage(const MorseSmaleComplexData& data);
+IVW_MODULE_TOPOLOGYTOOLKIT_API size_t memoryUsage(const ContourTreeData& data);
+IVW_MODULE_TOPOLOGYTOOLKIT_API size_t memoryUsage(const PersistenceDiagramData& data);
+IVW_MODULE_TOPOLOGYTOOLKIT_API size_t memoryUsage(const DataFrame& data);
+
+template <typename A, typename B>
+size_t memoryUsage(const std::pair<std::shared_ptr<A>, std::shared_ptr<B>>& data) {
+    return (data.first ? memoryUsage(*data.first) : 0) +
+           (data.second ? memoryUsage(*data.second) : 0);
+}
+
+/**
+ * \class ResultCache
+ * \brief thread-safe in-memory cache of the most recently used results, keyed on a content hash
+ *
+ * The cache is registered with the global MemoryBudget under \p name, with low priority since its
+ * results can be recomputed. It keeps at most capacity results, evicts the least recently used
+ * ones when asked to by the budget, and reports the estimated memory of its results, see
+ * memoryUsage.
+ */
+template <typename T>
+class ResultCache {
+public:
+    explicit ResultCache(std::string name, size_t capacity = 2)
+        : state_{std::make_shared<State>()} {
+        state_->capacity = capacity;
+        state_->registration = MemoryBudget::global().add(
+            std::move(name), MemoryBudget::Priority::Low,
+            [weak = std::weak_ptr<State>{state_}](size_t bytes) {
+                auto self = weak.lock();
+                if (!self) return;
+                std::unique_lock lock{self->mutex, std::try_to_lock};
+                if (!lock) return;
+                self->evictTo(self->memoryUsage > bytes ? self->memoryUsage - bytes : 0);
+            });
+    }
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    /**
+     * return the cached result for \p key and mark it as most recently used, nullptr if not cached
+     */
+    std::shared_ptr<const T> get(uint64_t key) const {
+        std::scoped_lock lock{state_->mutex};
+        auto& entries = state_->entries;
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [key](const auto& entry) { return entry.key == key; });
+        if (it == entries.end()) {
+            state_->registration->miss();
+            return nullptr;
+        }
+        state_->registration->hit();
+        entries.splice(entries.begin(), entries, it);
+        return entries.front().value;
+    }
+
+    void put(uint64_t key, std::shared_ptr<const T> value) {
+        std::scoped_lock lock{state_->mutex};
+        state_->remove(key);
+        if (state_->capacity > 0 && value) {
+            const auto bytes = memoryUsage(*value);
+            state_->entries.push_front(Entry{key, std::move(value), bytes});
+            state_->memoryUsage += bytes;
+        }
+        state_->registration->setUsage(state_->memoryUsage);
+        state_->evict();
+    }
+
+    void setCapacity(size_t capacity) {
+        std::scoped_lock lock{state_->mutex};
+        state_->capacity = capacity;
+        state_->evict();
+    }
+
+    void clear() {
+        std::scoped_lock lock{state_->mutex};
+        state_->evictTo(0);
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        std::shared_ptr<const T> value;
+        size_t bytes;
+    };
+
+    // Shared with the eviction callback of the memory budget
+    struct State {
+        std::mutex mutex;
+        size_t capacity;
+        //! most recently used first
+        std::list<Entry> entries;
+        size_t memoryUsage = 0;
+        std::unique_ptr<MemoryBudget::Registration> registration;
+
+        void remove(uint64_t key) {
+            for (auto it = entries.begin(); it != entries.end();) {
+                if (it->key == key) {
+                    memoryUsage -= it->bytes;
+                    it = entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        void evict() { evictTo(registration->allowance()); }
+        void evictTo(size_t bytes) {
+            const auto usage = memoryUsage;
+            while (!entries.empty() && (entries.size() > capacity || memoryUsage > bytes)) {
+                memoryUsage -= entries.back().bytes;
+                entries.pop_back();
+            }
+            if (memoryUsage != usage) registration->setUsage(memoryUsage);
+        }
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * \brief on-disk copies of cached results
+ *
+ * One file per result in the cache directory of the TTKSettings, named after the key. Failing to
+ * read or write a file is not an error, the result is then just computed again. Contour trees
+ * are not stored since ttk::ftm::FTMTree cannot be restored without recomputing the tree.
+ */
+namespace diskcache {
+
+/**
+ * return the cache directory of the TTKSettings, or an empty string if the disk cache is
+ * disabled. Has to be called on the main thread.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::string cacheDirectory();
+/**
+ * return the cache file for \p key in \p directory, or an empty string if \p directory is empty
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::string cacheFile(const std::string& directory, uint64_t key,
+                                                     const std::string& extension);
+
+IVW_MODULE_TOPOLOGYTOOLKIT_API bool write(const std::string& file,
+                                          const PersistenceDiagramData& diagram);
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<PersistenceDiagramData> readPersistenceDiagram(
+    const std::string& file);
+
+IVW_MODULE_TOPOLOGYTOOLKIT_API bool write(const std::string& file,
+                                          const MorseSmaleComplexData& msc);
+/**
+ * restore a Morse-Smale complex computed for \p triangulation, its scalar values determine the
+ * format of the scalar buffers
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<MorseSmaleComplexData> readMorseSmaleComplex(
+    const std::string& file, std::shared_ptr<const TriangulationData> triangulation);
+
+}  // namespace diskcache
+
+}  // namespace topology
+
+}  // namespace inviwo
@@ -35,6 +35,7 @@
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/directoryproperty.h>
 
 namespace inviwo {
 
@@ -45,6 +46,18 @@ public:
     virtual ~TTKSettings() = default;
 
     IntProperty globalLoglevel;
+
+    //! threads used by each TTK algorithm, 0 splits the cores between running jobs, see
+    //! topology::ThreadPolicy
+    IntProperty threadsPerJob;
+    //! TTK jobs taking longer are logged, in milliseconds
+    IntProperty logTimingThreshold;
+
+    //! number of results kept in memory by each ContourTree, MorseSmaleComplex, and
+    //! PersistenceDiagram processor, see topology::ResultCache
+    IntSizeTProperty resultCacheSize;
+    BoolProperty diskCache;
+    DirectoryProperty cacheDirectory;
 };
 
 }  // namespace topology
@@ -0,0 +1,106 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace inviwo {
+
+namespace topology {
+
+/**
+ * \brief number of threads used by TTK algorithms, see TTKSettings
+ *
+ * TTK algorithms are run inside pool jobs and use several threads of their own. To avoid
+ * oversubscribing the cores, a thread count of 0 splits the cores evenly between all TTK jobs
+ * running at the same time. Any other value is used as is.
+ */
+struct IVW_MODULE_TOPOLOGYTOOLKIT_API ThreadPolicy {
+    int threads = 0;
+    //! log the timing of jobs taking at least this long
+    std::chrono::milliseconds logThreshold{500};
+};
+
+/**
+ * return the thread policy of the TTKSettings. Has to be called on the main thread, the result
+ * is then passed on to the pool job.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API ThreadPolicy threadPolicy();
+
+/**
+ * \class TTKJob
+ * \brief scope of a TTK computation in a pool job
+ *
+ * Determines the number of threads the TTK algorithm should use and measures the wall time of
+ * the job. The timings are accumulated per processor, see jobStatistics().
+ *
+ * \code{.cpp}
+ * topology::TTKJob job{policy, "MorseSmaleComplex"};
+ * ttk::MorseSmaleComplex morseSmaleComplex;
+ * morseSmaleComplex.setThreadNumber(job.threadCount());
+ * \endcode
+ */
+class IVW_MODULE_TOPOLOGYTOOLKIT_API TTKJob {
+public:
+    TTKJob(const ThreadPolicy& policy, std::string processor);
+    TTKJob(const TTKJob&) = delete;
+    TTKJob& operator=(const TTKJob&) = delete;
+    ~TTKJob();
+
+    int threadCount() const { return threads_; }
+
+private:
+    ThreadPolicy policy_;
+    std::string processor_;
+    int threads_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+struct IVW_MODULE_TOPOLOGYTOOLKIT_API JobStatistics {
+    size_t count = 0;
+    std::chrono::duration<double> total{0};
+    std::chrono::duration<double> max{0};
+    //! thread count of the most recent job
+    int threads = 0;
+};
+
+/**
+ * return the accumulated timings of all finished TTK jobs, by processor
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::map<std::string, JobStatistics> jobStatistics();
+
+}  // namespace topology
+
+}  // namespace inviwo
@@ -32,11 +32,17 @@
 
 #include <inviwo/topologytoolkit/topologytoolkitmoduledefine.h>
 #include <inviwo/topologytoolkit/datastructures/triangulationdata.h>
+#include <inviwo/topologytoolkit/ports/persistencediagramport.h>
 
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/transferfunction.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/utilities/util/parallel.h>
 
+#include <algorithm>
 #include <vector>
 
 namespace inviwo {
@@ -58,11 +64,51 @@ namespace topology {
  */
 IVW_MODULE_TOPOLOGYTOOLKIT_API TriangulationData meshToTTKTriangulation(const Mesh& mesh);
 
+/**
+ * \brief convert a Mesh to TriangulationData merging coincident vertices
+ *
+ * Like meshToTTKTriangulation(const Mesh&), but vertices are merged first, see weldVertices(), and
+ * cells which become degenerate are removed. Since the vertices of the triangulation no longer
+ * match the ones of the mesh, \p sourceVertices is set to the index of the mesh vertex each
+ * vertex of the triangulation was taken from. Use it with gatherScalars() to set scalar values.
+ *
+ * @param mesh   input Mesh
+ * @param tolerance   vertices in the same cell of a grid with this spacing are merged, exactly
+ *                    coincident vertices are merged if 0
+ * @param sourceVertices   set to the mesh vertex of each vertex of the triangulation
+ * @return TriangulationData with ttk::Triangulation
+ * @throw TTKConversionException if conversion fails, e.g. the mesh does not have a position buffer
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API TriangulationData meshToTTKTriangulation(
+    const Mesh& mesh, float tolerance, std::vector<uint32_t>& sourceVertices);
+
+/**
+ * \brief merge coincident vertices in place using spatial hashing
+ *
+ * Vertices are hashed to the cells of a grid with spacing \p tolerance, and all vertices within the
+ * same cell are merged into the first of them. If \p tolerance is 0, only vertices with identical
+ * positions are merged. The remaining vertices keep their relative order. Runs in parallel.
+ *
+ * @param points   positions, replaced by the merged positions
+ * @param tolerance   grid spacing, or 0 for exact matches
+ * @return for each original vertex the index of the merged vertex it maps to
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::vector<uint32_t> weldVertices(std::vector<vec3>& points,
+                                                                  float tolerance = 0.0f);
+
+/**
+ * \brief extract component \p component of the elements \p indices of \p buffer
+ *
+ * @return scalar buffer of the same primitive type as \p buffer with one value per index
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<BufferBase> gatherScalars(
+    const BufferBase& buffer, size_t component, const std::vector<uint32_t>& indices);
+
 /**
  * \brief convert TriangulationData into a Mesh
  *
  * Convert TriangulationData \p data into a Mesh, scalars can optionally overwrite one
- * position component
+ * position component. The vertices and cells are converted in parallel.
  *
  * TODO: mesh normals based on neighborhood information
  *
@@ -77,6 +123,57 @@ std::shared_ptr<Mesh> ttkTriangulationToMesh(const TriangulationData& data,
                                              const vec4& color = vec4(1.0f),
                                              bool applyScalars = false, size_t component = 0);
 
+/**
+ * \brief assemble a Mesh of \p data from already converted buffers
+ *
+ * The buffers are shared with the mesh, not copied. Together with the functions below, this
+ * allows to keep the index buffers, or the positions, of a previous conversion when only the
+ * scalars or colors of a triangulation change.
+ *
+ * \see ttkTriangulationToIndices, ttkTriangulationToPositions, ttkTriangulationToColors
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API
+std::shared_ptr<Mesh> ttkTriangulationToMesh(const TriangulationData& data,
+                                             std::shared_ptr<Buffer<vec3>> positions,
+                                             std::shared_ptr<Buffer<vec4>> colors,
+                                             const Mesh::IndexVector& indices);
+
+/**
+ * \brief convert the cells of \p data into index buffers
+ *
+ * Edges result in a line index buffer, triangles and the faces of tetrahedra in a triangle index
+ * buffer. Index buffers without any cells are omitted. The index buffers only depend on the
+ * triangulation, not on the scalar values, and can be reused for all copies of \p data sharing
+ * its triangulation, see TriangulationData::sharesTriangulation().
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API Mesh::IndexVector ttkTriangulationToIndices(
+    const TriangulationData& data);
+
+/**
+ * \brief positions of the vertices of \p data
+ *
+ * @param data    triangulation data
+ * @param applyScalars  if true, scalar values will overwrite one position component
+ * @param component  scalar values overwrite this component of the vertex positions, i.e. x, y, or z
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<Buffer<vec3>> ttkTriangulationToPositions(
+    const TriangulationData& data, bool applyScalars = false, size_t component = 0);
+
+/**
+ * \brief vertex colors of \p data, all set to \p color
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<Buffer<vec4>> ttkTriangulationToColors(
+    const TriangulationData& data, const vec4& color);
+
+/**
+ * \brief vertex colors of \p data by mapping its scalar values with \p tf
+ *
+ * The scalar values are normalized to [0,1] using their range. All vertices are set to the first
+ * color of \p tf if \p data has no scalar values.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<Buffer<vec4>> ttkTriangulationToColors(
+    const TriangulationData& data, const TransferFunction& tf);
+
 /**
  * \brief convert a Volume to TriangulationData
  *
@@ -103,6 +200,99 @@ IVW_MODULE_TOPOLOGYTOOLKIT_API TriangulationData volumeToTTKTriangulation(const
 IVW_MODULE_TOPOLOGYTOOLKIT_API
 std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data);
 
+/**
+ * \brief resample the scalars of an explicit triangulation into a Volume
+ *
+ * The volume spans the bounding box of the triangulation. Each voxel is sampled at its center in
+ * parallel, the cells containing it are looked up in a bounding volume hierarchy. If the
+ * triangulation holds tetrahedra, the scalars are interpolated linearly within the tetrahedron
+ * containing the voxel center. Otherwise its triangles are treated as a surface, and voxels whose
+ * center is within half a voxel diagonal of it get the value interpolated at the closest point on
+ * the surface. Edges are ignored. Voxels not covered by any cell are set to \p background.
+ *
+ * @param data    triangulation data with tetrahedra or triangles
+ * @param dims    dimensions of the resulting volume
+ * @param background  value of voxels outside the triangulation
+ * @return Volume of type float holding the resampled scalars, an empty volume if the
+ *         triangulation has no scalars
+ * @throw TTKConversionException if \p dims is zero or the triangulation has neither triangles nor
+ *        tetrahedra
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API
+std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data,
+                                                 const size3_t& dims, double background = 0.0);
+
+/**
+ * \brief return \p data with the scalar values named \p name selected
+ *
+ * Returns \p data itself if \p name is empty, unknown, or already selected. Otherwise a copy is
+ * returned, which shares the triangulation and the scalar buffers with \p data.
+ *
+ * \see TriangulationData::selectScalarValues
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::shared_ptr<const TriangulationData> selectScalarValues(
+    std::shared_ptr<const TriangulationData> data, const std::string& name);
+
+/**
+ * \brief prepare a point and line mesh whose buffers are refilled in place
+ *
+ * Keeps \p mesh if it is only referenced by the caller and the outport it was last set on, its
+ * buffers are then overwritten by the next result and need no new GPU allocation. Otherwise \p mesh
+ * is replaced by a new mesh with position, color, radii, and optionally picking buffers, in this
+ * order, and two index buffers, one for points and one for lines.
+ *
+ * \see meshBufferData, meshIndexData
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API void preparePointLineMesh(std::shared_ptr<Mesh>& mesh,
+                                                         bool picking);
+
+/**
+ * \brief editable data of buffer \p index of \p mesh, resized to \p size
+ */
+template <typename T>
+std::vector<T>& meshBufferData(Mesh& mesh, size_t index, size_t size) {
+    auto& data = static_cast<Buffer<T>*>(mesh.getBuffer(index))
+                     ->getEditableRAMRepresentation()
+                     ->getDataContainer();
+    data.resize(size);
+    return data;
+}
+
+/**
+ * \brief editable data of index buffer \p index of \p mesh, resized to \p size
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::vector<uint32_t>& meshIndexData(Mesh& mesh, size_t index,
+                                                                    size_t size);
+
+/**
+ * \brief order of the pairs of \p diagram by increasing persistence
+ *
+ * Ties are broken by the index of the pair. Chunks are sorted in parallel and then merged.
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API std::vector<size_t> persistenceOrder(
+    const PersistenceDiagramData& diagram);
+
+/**
+ * \brief sort the pairs of \p diagram by increasing persistence, if they are not already sorted
+ *
+ * Pairs output by the persistence diagram processors are sorted, hence all pairs above a
+ * persistence threshold can be found with a binary search.
+ *
+ * \see persistenceOrder, isSortedByPersistence
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API void sortByPersistence(PersistenceDiagramData& diagram);
+
+/**
+ * \brief check whether the pairs of \p diagram are sorted by increasing persistence
+ */
+IVW_MODULE_TOPOLOGYTOOLKIT_API bool isSortedByPersistence(const PersistenceDiagramData& diagram);
+
+/**
+ * \brief number of elements per range of the parallel loops of this module
+ * \see util::forEachRangeParallel
+ */
+constexpr size_t parallelGrainSize = size_t{1} << 16;
+
 }  // namespace topology
 
 }  // namespace inviwo
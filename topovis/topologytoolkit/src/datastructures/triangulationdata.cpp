@@ -25,18 +25,72 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
- *********************************************************************************/
 
 #include <inviwo/topologytoolkit/datastructures/triangulationdata.h>
 #include <inviwo/topologytoolkit/utils/ttkexception.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
 
 #include <algorithm>
+#include <numeric>
+#include <utility>
 #include <inviwo/core/util/formats.h>
 
 namespace inviwo {
 
 namespace topology {
 
+const std::string TriangulationData::defaultScalarName{"scalars"};
+
+TriangulationData::Geometry::Geometry(const Geometry& rhs)
+    : cells{rhs.cells}
+    , points{rhs.getPoints()}
+    , triangulation{rhs.triangulation}
+    , gridDims{rhs.gridDims}
+    , gridOrigin{rhs.gridOrigin}
+    , gridExtent{rhs.gridExtent} {
+    // the copied triangulation still refers to the input of rhs
+    if (!isUniformGrid()) {
+        updateInput();
+    }
+}
+
+const std::vector<vec3>& TriangulationData::Geometry::getPoints() const {
+    if (isUniformGrid()) {
+        std::scoped_lock lock{pointsMutex};
+        if (points.empty()) {
+            // some of the queries are not const in TTK
+            auto& grid = const_cast<ttk::Triangulation&>(triangulation);
+            const auto numVertices = grid.getNumberOfVertices();
+            points.resize(numVertices);
+            for (int index = 0; index < numVertices; index++) {
+                grid.getVertexPoint(index, points[index].x, points[index].y, points[index].z);
+            }
+        }
+    }
+    return points;
+}
+
+size_t TriangulationData::Geometry::getCellCount() const {
+    // determine number of cells based on VTK index list
+    size_t numCells = 0;
+    for (size_t i = 0; i < cells.size(); i += cells[i] + 1) {
+        ++numCells;
+    }
+    return numCells;
+}
+
+void TriangulationData::Geometry::updateInput() {
+    int retVal =
+        triangulation.setInputPoints(static_cast<int>(points.size()), points.data(), false);
+    if (retVal < 0) {
+        throw TTKException("Error setting input points of ttk::Triangulation");
+    }
+    retVal = triangulation.setInputCells(static_cast<int>(getCellCount()), cells.data());
+    if (retVal < 0) {
+        throw TTKException("Error setting input cells of ttk::Triangulation");
+    }
+}
+
 TriangulationData::TriangulationData(const size3_t& dims, const vec3& origin, const vec3& extent,
                                      const DataMapper& dataMapper) {
     set(dims, origin, extent, dataMapper);
@@ -52,73 +106,16 @@ TriangulationData::TriangulationData(std::vector<vec3> points, const std::vector
     set(std::move(points), indices, meshInfo);
 }
 
-TriangulationData::TriangulationData(const TriangulationData& rhs)
-    : SpatialEntity<3>(rhs)
-    , MetaDataOwner(rhs)
-    , cells_(rhs.cells_)
-    , points_(rhs.points_)
-    , offsets_(rhs.offsets_)
-    , triangulation_{rhs.triangulation_}
-    , scalars_(rhs.scalars_->clone())
-    , gridDims_(rhs.gridDims_)
-    , gridOrigin_(rhs.gridOrigin_)
-    , gridExtent_(rhs.gridExtent_) {
-
-    if (rhs.isUniformGrid()) {
-        set(gridDims_, gridOrigin_, gridExtent_, rhs.getDataMapper());
-    } else {
-        triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
-        triangulation_.setInputCells(static_cast<int>(getCellCount()), cells_.data());
-        triangulation_.setPeriodicBoundaryConditions(
-            rhs.triangulation_.usesPeriodicBoundaryConditions());
-    }
-}
-
 TriangulationData::TriangulationData(TriangulationData&& rhs)
     : SpatialEntity<3>(rhs)
     , MetaDataOwner(rhs)
-    , cells_(std::move(rhs.cells_))
-    , points_(std::move(rhs.points_))
-    , offsets_(std::move(rhs.offsets_))
-    , triangulation_{std::move(rhs.triangulation_)}
-    , scalars_(std::move(rhs.scalars_))
-    , gridDims_(std::move(rhs.gridDims_))
-    , gridOrigin_(std::move(rhs.gridOrigin_))
-    , gridExtent_(std::move(rhs.gridExtent_)) {
-    if (rhs.isUniformGrid()) {
-        set(gridDims_, gridOrigin_, gridExtent_, rhs.getDataMapper());
-    } else {
-        triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
-        triangulation_.setInputCells(static_cast<int>(getCellCount()), cells_.data());
-        triangulation_.setPeriodicBoundaryConditions(
-            rhs.triangulation_.usesPeriodicBoundaryConditions());
-    }
-}
-
-TriangulationData& TriangulationData::operator=(const TriangulationData& rhs) {
-    if (this != &rhs) {
-        SpatialEntity<3>::operator=(rhs);
-        MetaDataOwner::operator=(rhs);
-
-        cells_ = rhs.cells_;
-        points_ = rhs.points_;
-        offsets_ = rhs.offsets_;
-        triangulation_ = rhs.triangulation_;
-        scalars_.reset(rhs.scalars_->clone());
-        gridDims_ = rhs.gridDims_;
-        gridOrigin_ = rhs.gridOrigin_;
-        gridExtent_ = rhs.gridExtent_;
-
-        if (rhs.isUniformGrid()) {
-            set(gridDims_, gridOrigin_, gridExtent_, rhs.getDataMapper());
-        } else {
-            triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
-            triangulation_.setInputCells(static_cast<int>(getCellCount()), cells_.data());
-            triangulation_.setPeriodicBoundaryConditions(
-                rhs.triangulation_.usesPeriodicBoundaryConditions());
-        }
-    }
-    return *this;
+    , geometry_{std::move(rhs.geometry_)}
+    , fields_{std::move(rhs.fields_)}
+    , selected_{rhs.selected_}
+    , defaultOffsets_{std::move(rhs.defaultOffsets_)}
+    , volumeDataMapper_(std::move(rhs.volumeDataMapper_)) {
+    rhs.geometry_ = std::make_shared<Geometry>();
+    rhs.selected_ = 0;
 }
 
 TriangulationData& TriangulationData::operator=(TriangulationData&& rhs) {
@@ -126,57 +123,47 @@ TriangulationData& TriangulationData::operator=(TriangulationData&& rhs) {
         SpatialEntity<3>::operator=(rhs);
         MetaDataOwner::operator=(rhs);
 
-        cells_ = std::move(rhs.cells_);
-        points_ = std::move(rhs.points_);
-        offsets_ = std::move(rhs.offsets_);
-        triangulation_ = std::move(rhs.triangulation_);
-        scalars_ = std::move(rhs.scalars_);
-        gridDims_ = std::move(rhs.gridDims_);
-        gridOrigin_ = std::move(rhs.gridOrigin_);
-        gridExtent_ = std::move(rhs.gridExtent_);
-
-        if (rhs.isUniformGrid()) {
-            set(gridDims_, gridOrigin_, gridExtent_, rhs.getDataMapper());
-        } else {
-            triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
-            triangulation_.setInputCells(static_cast<int>(getCellCount()), cells_.data());
-            triangulation_.setPeriodicBoundaryConditions(
-                rhs.triangulation_.usesPeriodicBoundaryConditions());
-        }
+        geometry_ = std::move(rhs.geometry_);
+        rhs.geometry_ = std::make_shared<Geometry>();
+        fields_ = std::move(rhs.fields_);
+        selected_ = rhs.selected_;
+        rhs.selected_ = 0;
+        defaultOffsets_ = std::move(rhs.defaultOffsets_);
+        volumeDataMapper_ = std::move(rhs.volumeDataMapper_);
     }
     return *this;
 }
 
 TriangulationData* TriangulationData::clone() const { return new TriangulationData(*this); }
 
-bool TriangulationData::isUniformGrid() const {
-    // cannot use triangulation_.getGridDimensions(std::vector<int>&) here since it is not const
-    return glm::compMul(gridDims_) > 0u;
-}
+bool TriangulationData::isUniformGrid() const { return geometry_->isUniformGrid(); }
 
 DataMapper TriangulationData::getDataMapper() const {
     return isUniformGrid() ? volumeDataMapper_ : DataMapper();
 }
 
 size3_t TriangulationData::getGridDimensions() const {
-    return isUniformGrid() ? gridDims_ : size3_t(0u);
+    return isUniformGrid() ? geometry_->gridDims : size3_t(0u);
 }
 
-vec3 TriangulationData::getGridOrigin() const { return isUniformGrid() ? gridOrigin_ : vec3(0.0f); }
+vec3 TriangulationData::getGridOrigin() const {
+    return isUniformGrid() ? geometry_->gridOrigin : vec3(0.0f);
+}
 
-vec3 TriangulationData::getGridExtent() const { return isUniformGrid() ? gridExtent_ : vec3(0.0f); }
+vec3 TriangulationData::getGridExtent() const {
+    return isUniformGrid() ? geometry_->gridExtent : vec3(0.0f);
+}
 
 void TriangulationData::set(const size3_t& dims, const vec3& origin, const vec3& extent,
                             const DataMapper& dataMapper) {
-    points_.clear();
-    cells_.clear();
+    geometry_ = std::make_shared<Geometry>();
     const vec3 spacing(extent / vec3(dims));
-    triangulation_.setInputGrid(origin.x, origin.y, origin.z, spacing.x, spacing.y, spacing.z,
-                                static_cast<int>(dims.x), static_cast<int>(dims.y),
-                                static_cast<int>(dims.z));
-    gridDims_ = dims;
-    gridOrigin_ = origin;
-    gridExtent_ = extent;
+    geometry_->triangulation.setInputGrid(origin.x, origin.y, origin.z, spacing.x, spacing.y,
+                                          spacing.z, static_cast<int>(dims.x),
+                                          static_cast<int>(dims.y), static_cast<int>(dims.z));
+    geometry_->gridDims = dims;
+    geometry_->gridOrigin = origin;
+    geometry_->gridExtent = extent;
     volumeDataMapper_ = dataMapper;
 }
 
@@ -187,14 +174,9 @@ void TriangulationData::set(const std::vector<vec3>& points, const std::vector<u
 
 void TriangulationData::set(std::vector<vec3>&& points, const std::vector<uint32_t>& indices,
                             InputTriangulation type) {
-    points_ = std::move(points);
-    cells_.clear();
-
-    // init ttk::Triangulation
-    triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
+    geometry_ = std::make_shared<Geometry>();
+    geometry_->points = std::move(points);
     addIndices(indices, type);
-
-    unsetGrid();
 }
 
 void TriangulationData::set(const std::vector<vec3>& points, const std::vector<uint32_t>& indices,
@@ -207,17 +189,19 @@ void TriangulationData::set(std::vector<vec3>&& points, const std::vector<uint32
     switch (meshInfo.dt) {
         case DrawType::Lines: {
             if (meshInfo.ct == ConnectivityType::None) {
-                set(points, indices, InputTriangulation::Edges);
+                set(std::move(points), indices, InputTriangulation::Edges);
             } else {
-                set(points, convertToLines(indices, meshInfo), InputTriangulation::Edges);
+                set(std::move(points), convertToLines(indices, meshInfo),
+                    InputTriangulation::Edges);
             }
             break;
         }
         case DrawType::Triangles: {
             if (meshInfo.ct == ConnectivityType::None) {
-                set(points, indices, InputTriangulation::Triangles);
+                set(std::move(points), indices, InputTriangulation::Triangles);
             } else {
-                set(points, convertToTriangles(indices, meshInfo), InputTriangulation::Triangles);
+                set(std::move(points), convertToTriangles(indices, meshInfo),
+                    InputTriangulation::Triangles);
             }
             break;
         }
@@ -237,27 +221,10 @@ void TriangulationData::set(const std::vector<vec3>& points,
 }
 
 void TriangulationData::set(std::vector<vec3>&& points, std::vector<long long int>&& cells) {
-    points_ = std::move(points);
-    cells_ = std::move(cells);
-
-    // determine number of cells
-    int numCells = 0;
-    for (size_t i = 0; i < cells.size(); i += cells[i] + 1) {
-        ++numCells;
-    }
-
-    unsetGrid();
-
-    // init ttk::Triangulation
-    int retVal =
-        triangulation_.setInputPoints(static_cast<int>(points_.size()), points_.data(), false);
-    if (retVal < 0) {
-        throw TTKException("Error setting input points of ttk::Triangulation");
-    }
-    retVal = triangulation_.setInputCells(numCells, cells_.data());
-    if (retVal < 0) {
-        throw TTKException("Error setting input cells of ttk::Triangulation");
-    }
+    geometry_ = std::make_shared<Geometry>();
+    geometry_->points = std::move(points);
+    geometry_->cells = std::move(cells);
+    geometry_->updateInput();
 }
 
 void TriangulationData::addIndices(const std::vector<uint32_t>& indices, InputTriangulation type) {
@@ -280,22 +247,27 @@ void TriangulationData::addIndices(const std::vector<uint32_t>& indices, InputTr
             break;
     }
 
-    const int newCellCount = numCells + static_cast<int>(getCellCount());
-    cells_.reserve(cells_.size() + numCells * (pointsPerCell + 1));
-    for (size_t i = 0; i < numCells * pointsPerCell; ++i) {
-        if (i % pointsPerCell == 0) {
-            cells_.push_back(pointsPerCell);
-        }
-        cells_.push_back(indices[i]);
+    if (isUniformGrid()) {
+        // turn the uniform grid into an explicit triangulation of its points
+        auto points = geometry_->getPoints();
+        geometry_ = std::make_shared<Geometry>();
+        geometry_->points = std::move(points);
     }
 
-    unsetGrid();
+    auto& geometry = editGeometry();
+    auto& cells = geometry.cells;
+    const size_t offset = cells.size();
+    cells.resize(offset + numCells * (pointsPerCell + 1));
+    util::forEachRangeParallel(numCells, parallelGrainSize, [&](size_t begin, size_t end) {
+        auto dst = cells.begin() + offset + begin * (pointsPerCell + 1);
+        for (size_t cell = begin; cell < end; ++cell) {
+            *dst++ = pointsPerCell;
+            dst = std::copy_n(indices.begin() + cell * pointsPerCell, pointsPerCell, dst);
+        }
+    });
 
     // update TTK triangulation
-    int retVal = triangulation_.setInputCells(newCellCount, cells_.data());
-    if (retVal < 0) {
-        throw TTKException("Error setting input cells of ttk::Triangulation");
-    }
+    geometry.updateInput();
 }
 
 void TriangulationData::addIndices(const std::vector<uint32_t>& indices, Mesh::MeshInfo meshInfo) {
@@ -326,64 +298,84 @@ void TriangulationData::addIndices(const std::vector<uint32_t>& indices, Mesh::M
     }
 }
 
-void TriangulationData::setScalarValues(std::shared_ptr<BufferBase> buffer) {
-    if (buffer->getDataFormat()->getComponents() > 1) {
-        throw TTKException("TriangulationData supports only scalar data");
+size_t TriangulationData::removeDegenerateCells() {
+    if (isUniformGrid()) return 0;
+
+    // check first to avoid detaching the geometry if nothing changes
+    auto isDegenerate = [](auto begin, auto end) {
+        for (auto it = begin + 1; it != end; ++it) {
+            if (std::find(it + 1, end, *it) != end) return true;
+        }
+        return false;
+    };
+    const auto& cells = geometry_->cells;
+    bool hasDegenerate = false;
+    for (size_t i = 0; i < cells.size() && !hasDegenerate; i += cells[i] + 1) {
+        hasDegenerate = isDegenerate(cells.begin() + i, cells.begin() + i + cells[i] + 1);
     }
-    if (isUniformGrid()) {
-        if (buffer->getSize() < glm::compMul(gridDims_)) {
-            throw TTKException("Too little data (" + std::to_string(buffer->getSize()) +
-                               " values given, but implicit triangulation holds " +
-                               std::to_string(glm::compMul(gridDims_)) + " positions");
+    if (!hasDegenerate) return 0;
+
+    auto& editable = editGeometry().cells;
+    size_t removed = 0;
+    size_t dst = 0;
+    for (size_t i = 0; i < editable.size();) {
+        const auto size = static_cast<size_t>(editable[i]) + 1;
+        const auto begin = editable.begin() + i;
+        const auto end = begin + size;
+        if (isDegenerate(begin, end)) {
+            ++removed;
+        } else {
+            // cells are moved towards the front, the copy never overlaps the remaining cells
+            if (dst != i) std::copy(begin, end, editable.begin() + dst);
+            dst += size;
         }
-    } else if (buffer->getSize() < points_.size()) {
-        throw TTKException("Too little data (" + std::to_string(buffer->getSize()) +
-                           " values given, but triangulation holds " +
-                           std::to_string(points_.size()) + " positions");
+        i += size;
     }
-    scalars_ = buffer;
+    editable.resize(dst);
+    geometry_->updateInput();
+    return removed;
 }
 
-void TriangulationData::setScalarValues(std::shared_ptr<BufferBase> buffer, size_t component) {
+void TriangulationData::checkScalarValues(const BufferBase& buffer) const {
     if (isUniformGrid()) {
-        if (buffer->getSize() < glm::compMul(gridDims_)) {
-            throw TTKException("Too little data (" + std::to_string(buffer->getSize()) +
+        const auto size = glm::compMul(geometry_->gridDims);
+        if (buffer.getSize() < size) {
+            throw TTKException("Too little data (" + std::to_string(buffer.getSize()) +
                                " values given, but implicit triangulation holds " +
-                               std::to_string(glm::compMul(gridDims_)) + " positions");
+                               std::to_string(size) + " positions");
         }
-    } else if (buffer->getSize() < points_.size()) {
-        throw TTKException("Too little data (" + std::to_string(buffer->getSize()) +
+    } else if (buffer.getSize() < geometry_->points.size()) {
+        throw TTKException("Too little data (" + std::to_string(buffer.getSize()) +
                            " values given, but triangulation holds " +
-                           std::to_string(points_.size()) + " positions");
+                           std::to_string(geometry_->points.size()) + " positions");
     }
+}
 
-    auto convertBuffer = [](auto buffer, size_t component) {
-        using ValueType = util::PrecisionValueType<decltype(buffer)>;
-        using PrimitiveType = typename DataFormat<ValueType>::primitive;
-
-        std::vector<PrimitiveType> scalarData(buffer->getSize());
-        std::transform(buffer->getDataContainer().begin(), buffer->getDataContainer().end(),
-                       scalarData.begin(),
-                       [component](auto elem) { return util::glmcomp(elem, component); });
-        return util::makeBuffer<PrimitiveType>(std::move(scalarData));
-    };
+void TriangulationData::setScalarValues(std::shared_ptr<BufferBase> buffer) {
+    if (buffer->getDataFormat()->getComponents() > 1) {
+        throw TTKException("TriangulationData supports only scalar data");
+    }
+    checkScalarValues(*buffer);
+    if (fields_.empty()) {
+        fields_.push_back({defaultScalarName, buffer, std::move(defaultOffsets_)});
+        selected_ = 0;
+        defaultOffsets_.clear();
+    } else {
+        fields_[selected_].values = buffer;
+    }
+}
 
-    scalars_ = buffer->getRepresentation<BufferRAM>()->dispatch<std::shared_ptr<BufferBase>>(
-        convertBuffer, component);
+void TriangulationData::setScalarValues(std::shared_ptr<BufferBase> buffer, size_t component) {
+    if (buffer->getDataFormat()->getComponents() == 1 && component == 0) {
+        // scalar buffers can be used as is
+        setScalarValues(buffer);
+        return;
+    }
+    setScalarValues(*buffer, component);
 }
 
 void TriangulationData::setScalarValues(const BufferBase& buffer, size_t component) {
-    if (isUniformGrid()) {
-        if (buffer.getSize() < glm::compMul(gridDims_)) {
-            throw TTKException("Too little data (" + std::to_string(buffer.getSize()) +
-                               " values given, but implicit triangulation holds " +
-                               std::to_string(glm::compMul(gridDims_)) + " positions");
-        }
-    } else if (buffer.getSize() < points_.size()) {
-        throw TTKException("Too little data (" + std::to_string(buffer.getSize()) +
-                           " values given, but triangulation holds " +
-                           std::to_string(points_.size()) + " positions");
-    }
+    checkScalarValues(buffer);
 
     auto convertBuffer = [](auto bufferpr, size_t component) {
         using ValueType = util::PrecisionValueType<decltype(bufferpr)>;
@@ -396,67 +388,153 @@ void TriangulationData::setScalarValues(const BufferBase& buffer, size_t compone
         return util::makeBuffer<PrimitiveType>(std::move(scalarData));
     };
 
-    scalars_ = buffer.getRepresentation<BufferRAM>()->dispatch<std::shared_ptr<BufferBase>>(
-        convertBuffer, component);
+    setScalarValues(buffer.getRepresentation<BufferRAM>()->dispatch<std::shared_ptr<BufferBase>>(
+        convertBuffer, component));
 }
 
-std::shared_ptr<BufferBase> TriangulationData::getScalarValues() const { return scalars_; }
+std::shared_ptr<BufferBase> TriangulationData::getScalarValues() const {
+    return fields_.empty() ? nullptr : fields_[selected_].values;
+}
+
+void TriangulationData::addScalarValues(const std::string& name,
+                                        std::shared_ptr<BufferBase> buffer) {
+    if (buffer->getDataFormat()->getComponents() > 1) {
+        throw TTKException("TriangulationData supports only scalar data");
+    }
+    checkScalarValues(*buffer);
+    auto it = std::find_if(fields_.begin(), fields_.end(),
+                           [&](const ScalarField& field) { return field.name == name; });
+    if (it != fields_.end()) {
+        it->values = buffer;
+        it->offsets.clear();
+    } else {
+        fields_.push_back({name, buffer, {}});
+    }
+}
+
+void TriangulationData::removeScalarValues(const std::string& name) {
+    auto it = std::find_if(fields_.begin(), fields_.end(),
+                           [&](const ScalarField& field) { return field.name == name; });
+    if (it == fields_.end()) return;
+
+    const auto index = static_cast<size_t>(it - fields_.begin());
+    fields_.erase(it);
+    if (selected_ > index || selected_ >= fields_.size()) {
+        selected_ = selected_ > 0 ? selected_ - 1 : 0;
+    }
+}
+
+std::vector<std::string> TriangulationData::getScalarNames() const {
+    std::vector<std::string> names;
+    for (const auto& field : fields_) {
+        names.push_back(field.name);
+    }
+    return names;
+}
+
+bool TriangulationData::hasScalarValues(const std::string& name) const {
+    return std::any_of(fields_.begin(), fields_.end(),
+                       [&](const ScalarField& field) { return field.name == name; });
+}
+
+std::shared_ptr<BufferBase> TriangulationData::getScalarValues(const std::string& name) const {
+    auto it = std::find_if(fields_.begin(), fields_.end(),
+                           [&](const ScalarField& field) { return field.name == name; });
+    return it != fields_.end() ? it->values : nullptr;
+}
+
+void TriangulationData::selectScalarValues(const std::string& name) {
+    auto it = std::find_if(fields_.begin(), fields_.end(),
+                           [&](const ScalarField& field) { return field.name == name; });
+    if (it == fields_.end()) {
+        throw TTKException("No scalar values named '" + name + "'");
+    }
+    selected_ = static_cast<size_t>(it - fields_.begin());
+}
+
+const std::string& TriangulationData::getSelectedScalarName() const {
+    static const std::string none;
+    return fields_.empty() ? none : fields_[selected_].name;
+}
 
 void TriangulationData::setOffsets(const std::vector<int>& offsets) {
     setOffsets(std::vector<int>(offsets));
 }
 
 void TriangulationData::setOffsets(std::vector<int>&& offsets) {
-    const auto numelems = isUniformGrid() ? glm::compMul(gridDims_) : points_.size();
+    const auto numelems = getVertexCount();
     if (offsets.size() != numelems) {
         throw TTKException("Mismatch in range (" + std::to_string(offsets.size()) + " offsets, " +
                            std::to_string(numelems) + " vertices)");
     }
-    offsets_ = std::move(offsets);
+    if (fields_.empty()) {
+        defaultOffsets_ = std::move(offsets);
+    } else {
+        fields_[selected_].offsets = std::move(offsets);
+    }
 }
 
 std::vector<int>& TriangulationData::getOffsets() {
-    const auto numelems = isUniformGrid() ? glm::compMul(gridDims_) : points_.size();
-    if (offsets_.size() != numelems) {
-        offsets_.resize(numelems);
-        std::iota(offsets_.begin(), offsets_.end(), 0);
-    }
-    return offsets_;
+    return const_cast<std::vector<int>&>(std::as_const(*this).getOffsets());
 }
 
 const std::vector<int>& TriangulationData::getOffsets() const {
-    const auto numelems = isUniformGrid() ? glm::compMul(gridDims_) : points_.size();
-    if (offsets_.size() != numelems) {
-        offsets_.resize(numelems);
-        std::iota(offsets_.begin(), offsets_.end(), 0);
+    auto& offsets = fields_.empty() ? defaultOffsets_ : fields_[selected_].offsets;
+    const auto numelems = getVertexCount();
+    if (offsets.size() != numelems) {
+        offsets.resize(numelems);
+        std::iota(offsets.begin(), offsets.end(), 0);
     }
-    return offsets_;
+    return offsets;
 }
 
-const std::vector<long long int>& TriangulationData::getCells() const { return cells_; }
-
-const std::vector<vec3>& TriangulationData::getPoints() const {
-    if (isUniformGrid() && points_.empty()) {
-        for (int index = 0; index < triangulation_.getNumberOfVertices(); index++) {
-            points_.push_back(getPoint(index));
-        }
-    }
-    return points_;
+const std::vector<long long int>& TriangulationData::getCells() const {
+    return geometry_->cells;
 }
 
+const std::vector<vec3>& TriangulationData::getPoints() const { return geometry_->getPoints(); }
+
 vec3 TriangulationData::getPoint(const int index) const {
     vec3 point;
-    triangulation_.getVertexPoint(index, point.x, point.y, point.z);
+    geometry_->triangulation.getVertexPoint(index, point.x, point.y, point.z);
     return point;
 }
 
-ttk::Triangulation& TriangulationData::getTriangulation() { return triangulation_; }
+ttk::Triangulation& TriangulationData::getTriangulation() {
+    return editGeometry().triangulation;
+}
+
+const ttk::Triangulation& TriangulationData::getTriangulation() const {
+    return geometry_->triangulation;
+}
 
-const ttk::Triangulation& TriangulationData::getTriangulation() const { return triangulation_; }
+bool TriangulationData::shareTriangulation(const TriangulationData& grid) {
+    if (!hasSameGrid(grid) || geometry_->triangulation.usesPeriodicBoundaryConditions() !=
+                                  grid.geometry_->triangulation.usesPeriodicBoundaryConditions()) {
+        return false;
+    }
+    geometry_ = grid.geometry_;
+    return true;
+}
 
-vec3& TriangulationData::operator[](size_t i) { return points_[i]; }
+bool TriangulationData::hasSameGrid(const TriangulationData& rhs) const {
+    return isUniformGrid() && rhs.isUniformGrid() &&
+           geometry_->gridDims == rhs.geometry_->gridDims &&
+           geometry_->gridOrigin == rhs.geometry_->gridOrigin &&
+           geometry_->gridExtent == rhs.geometry_->gridExtent;
+}
 
-const vec3& TriangulationData::operator[](size_t i) const { return points_[i]; }
+bool TriangulationData::sharesTriangulation(const TriangulationData& rhs) const {
+    return geometry_ == rhs.geometry_;
+}
+
+vec3& TriangulationData::operator[](size_t i) {
+    auto& geometry = editGeometry();
+    geometry.getPoints();
+    return geometry.points[i];
+}
+
+const vec3& TriangulationData::operator[](size_t i) const { return getPoints()[i]; }
 
 const SpatialCameraCoordinateTransformer<3>& TriangulationData::getCoordinateTransformer(
     const Camera& camera) const {
@@ -572,20 +650,17 @@ std::vector<uint32_t> TriangulationData::convertToLines(const std::vector<uint32
     return ind;
 }
 
-size_t TriangulationData::getCellCount() const {
-    // determine number of cells based on VTK index list
-    size_t numCells = 0;
-    for (size_t i = 0; i < cells_.size(); i += cells_[i] + 1) {
-        ++numCells;
-    }
-    return numCells;
+size_t TriangulationData::getCellCount() const { return geometry_->getCellCount(); }
+
+size_t TriangulationData::getVertexCount() const {
+    return isUniformGrid() ? glm::compMul(geometry_->gridDims) : geometry_->points.size();
 }
 
-void TriangulationData::unsetGrid() {
-    // unset grid information
-    gridDims_ = size3_t(0u);
-    gridOrigin_ = vec3(0.0f);
-    gridExtent_ = vec3(0.0f);
+TriangulationData::Geometry& TriangulationData::editGeometry() {
+    if (geometry_.use_count() > 1) {
+        geometry_ = std::make_shared<Geometry>(*geometry_);
+    }
+    return *geometry_;
 }
 
 }  // namespace topology
@@ -0,0 +1,199 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/topologytoolkit/processors/brickedpersistencediagram.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+
+#include <cmath>
+#include <tuple>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo BrickedPersistenceDiagram::processorInfo_{
+    "org.inviwo.ttk.BrickedPersistenceDiagram",  // Class identifier
+    "Bricked Persistence Diagram",               // Display name
+    "Topology",                                  // Category
+    CodeState::Experimental,                     // Code state
+    "CPU, Topology, TTK, Volume, Persistence",   // Tags
+};
+const ProcessorInfo BrickedPersistenceDiagram::getProcessorInfo() const { return processorInfo_; }
+
+BrickedPersistenceDiagram::BrickedPersistenceDiagram()
+    : PoolProcessor()
+    , inport_("volume")
+    , outport_("outport")
+    , dataFrameOutport_("dataframe")
+    , treeOutport_("tree")
+    , channel_("channel", "Channel")
+    , brickSize_("brickSize", "Brick Size", size_t{128}, size_t{8}, size_t{1024})
+    , threshold_("threshold", "Simplification Threshold", 0.01f, 0.0f, 1.0f) {
+
+    addPort(inport_);
+    addPort(outport_);
+    addPort(dataFrameOutport_);
+    addPort(treeOutport_);
+
+    channel_.addOption("Channel 1", "Channel 1", 0);
+    channel_.setSerializationMode(PropertySerializationMode::All);
+    channel_.setCurrentStateAsDefault();
+
+    addProperties(channel_, brickSize_, threshold_);
+
+    inport_.onChange([this]() {
+        if (inport_.hasData()) {
+            size_t channels = inport_.getData()->getDataFormat()->getComponents();
+
+            if (channels == channel_.size()) return;
+
+            std::vector<OptionPropertyIntOption> channelOptions;
+            for (size_t i = 0; i < channels; i++) {
+                channelOptions.emplace_back("Channel " + toString(i + 1),
+                                            "Channel " + toString(i + 1), static_cast<int>(i));
+            }
+            channel_.replaceOptions(channelOptions);
+            channel_.setCurrentStateAsDefault();
+        }
+    });
+}
+
+void BrickedPersistenceDiagram::process() {
+    // only the simplification of the trees depends on the threshold
+    if (result_ && !inport_.isChanged() && !channel_.isModified() && !brickSize_.isModified()) {
+        updateTrees();
+        return;
+    }
+
+    using Result = std::tuple<std::shared_ptr<const topology::BrickedPersistence>,
+                              std::shared_ptr<topology::PersistenceDiagramData>,
+                              std::shared_ptr<DataFrame>>;
+
+    auto compute = [volume = inport_.getData(), channel = static_cast<size_t>(channel_.get()),
+                    brickSize = brickSize_.get(), policy = topology::threadPolicy()]() {
+        topology::TTKJob job{policy, "BrickedPersistenceDiagram"};
+        auto result = std::make_shared<topology::BrickedPersistence>(
+            topology::brickedPersistence(volume->getDimensions(),
+                                         topology::volumeBrickReader(volume, channel), brickSize,
+                                         job.threadCount()));
+
+        // birth and death in the same order as the pairs of the diagram, i.e. the values of the
+        // lower and the upper vertex of each pair
+        std::vector<float> birth;
+        std::vector<float> death;
+        for (auto it = result->joinTree.begin(); it + 1 != result->joinTree.end(); ++it) {
+            birth.push_back(it->birthValue);
+            death.push_back(it->deathValue);
+        }
+        for (auto it = result->splitTree.begin(); it + 1 != result->splitTree.end(); ++it) {
+            birth.push_back(it->deathValue);
+            death.push_back(it->birthValue);
+        }
+        birth.push_back(result->joinTree.back().birthValue);
+        death.push_back(result->joinTree.back().deathValue);
+
+        // sort the pairs by persistence like the Persistence Diagram processor
+        const auto order = topology::persistenceOrder(result->diagram);
+        auto diagram = std::make_shared<topology::PersistenceDiagramData>(order.size());
+        std::vector<float> sortedBirth(order.size());
+        std::vector<float> sortedDeath(order.size());
+        util::forEachRangeParallel(
+            order.size(), topology::parallelGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    (*diagram)[i] = result->diagram[order[i]];
+                    sortedBirth[i] = birth[order[i]];
+                    sortedDeath[i] = death[order[i]];
+                }
+            });
+        result->diagram.clear();
+
+        auto dataFrame = std::make_shared<DataFrame>();
+        dataFrame->addColumnFromBuffer("Birth", util::makeBuffer<float>(std::move(sortedBirth)));
+        dataFrame->addColumnFromBuffer("Death", util::makeBuffer<float>(std::move(sortedDeath)));
+        dataFrame->updateIndexBuffer();
+        return Result{result, diagram, dataFrame};
+    };
+
+    result_.reset();
+    outport_.setData(nullptr);
+    dataFrameOutport_.setData(nullptr);
+    treeOutport_.setData(nullptr);
+    dispatchOne(compute, [this](Result result) {
+        result_ = std::get<0>(result);
+        outport_.setData(std::get<1>(result));
+        dataFrameOutport_.setData(std::get<2>(result));
+        updateTrees();
+        newResults();
+    });
+}
+
+void BrickedPersistenceDiagram::updateTrees() {
+    const auto& root = result_->joinTree.back();
+    const auto threshold = threshold_.get() * (root.deathValue - root.birthValue);
+
+    std::vector<int> tree;
+    std::vector<int> birthVertex;
+    std::vector<int> deathVertex;
+    std::vector<int> parentVertex;
+    std::vector<float> birth;
+    std::vector<float> death;
+    std::vector<float> persistence;
+
+    const auto addBranches = [&](const std::vector<topology::MergeTreeBranch>& branches,
+                                 int type) {
+        for (const auto& branch : topology::simplifyBranches(branches, threshold)) {
+            tree.push_back(type);
+            birthVertex.push_back(static_cast<int>(branch.birth));
+            deathVertex.push_back(static_cast<int>(branch.death));
+            parentVertex.push_back(static_cast<int>(branch.parent));
+            birth.push_back(branch.birthValue);
+            death.push_back(branch.deathValue);
+            persistence.push_back(std::abs(branch.deathValue - branch.birthValue));
+        }
+    };
+    addBranches(result_->joinTree, 0);
+    addBranches(result_->splitTree, 1);
+
+    auto dataFrame = std::make_shared<DataFrame>();
+    dataFrame->addColumnFromBuffer("Tree", util::makeBuffer<int>(std::move(tree)));
+    dataFrame->addColumnFromBuffer("Birth Vertex", util::makeBuffer<int>(std::move(birthVertex)));
+    dataFrame->addColumnFromBuffer("Death Vertex", util::makeBuffer<int>(std::move(deathVertex)));
+    dataFrame->addColumnFromBuffer("Parent Vertex",
+                                   util::makeBuffer<int>(std::move(parentVertex)));
+    dataFrame->addColumnFromBuffer("Birth", util::makeBuffer<float>(std::move(birth)));
+    dataFrame->addColumnFromBuffer("Death", util::makeBuffer<float>(std::move(death)));
+    dataFrame->addColumnFromBuffer("Persistence",
+                                   util::makeBuffer<float>(std::move(persistence)));
+    dataFrame->updateIndexBuffer();
+
+    treeOutport_.setData(dataFrame);
+}
+
+}  // namespace inviwo
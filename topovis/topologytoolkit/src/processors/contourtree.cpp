@@ -29,6 +29,8 @@
 
 #include <inviwo/topologytoolkit/processors/contourtree.h>
 #include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
@@ -62,6 +64,7 @@ const ProcessorInfo ContourTree::getProcessorInfo() const { return processorInfo
 ContourTree::ContourTree()
     : inport_("triangulation")
     , outport_("outport")
+    , scalars_("scalars", "Scalars")
     , treeType_("treeType", "Tree Type",
                 {
                     {"join", "Join Tree", topology::TreeType::Join},
@@ -72,29 +75,44 @@ ContourTree::ContourTree()
                     // The resulting tree has no data
                 },
                 2)
-    , threadCount_("threadCount", "Number of Threads", 1, 1, 100)
+    , threadCount_("threadCount", "Number of Threads (0 = TTK Settings)", 0, 0, 100)
     , segmentation_("segmentation", "Segmentation", true)
     , normalization_("normalization", "Normalization", false) {
 
     addPort(inport_);
     addPort(outport_);
 
+    addProperty(scalars_);
     addProperty(treeType_);
     addProperty(threadCount_);
     addProperty(segmentation_);
     addProperty(normalization_);
+
+    scalars_.addOption("selected", "Selected in Input", "");
+    scalars_.setSerializationMode(PropertySerializationMode::All);
+    scalars_.setCurrentStateAsDefault();
+    inport_.onChange([this]() {
+        std::vector<OptionPropertyStringOption> options{{"selected", "Selected in Input", ""}};
+        if (auto data = inport_.getData()) {
+            for (const auto& name : data->getScalarNames()) {
+                options.emplace_back(name, name, name);
+            }
+        }
+        scalars_.replaceOptions(options);
+    });
 }
 
 void ContourTree::process() {
     // Save input and properties needed to calculate ttk contour tree to local variables
-    const auto inportData = inport_.getData();
-    const auto threadCount = threadCount_.get();
+    const auto inportData = topology::selectScalarValues(inport_.getData(), scalars_.get());
+    auto policy = topology::threadPolicy();
+    if (threadCount_.get() > 0) policy.threads = threadCount_.get();
     const auto treeType = treeType_.get();
     const auto segmentation = segmentation_.get();
     const auto normalization = normalization_.get();
 
     // construction of ttk contour tree
-    auto computeTree = [inportData, threadCount, treeType, segmentation,
+    auto computeTree = [inportData, policy, treeType, segmentation,
                         normalization](const auto buffer) {
         using ValueType = util::PrecisionValueType<decltype(buffer)>;
         using PrimitiveType = typename DataFormat<ValueType>::primitive;
@@ -103,7 +121,8 @@ void ContourTree::process() {
 
         auto tree = std::make_shared<topology::ContourTree>();
 
-        tree->setThreadNumber(threadCount);
+        topology::TTKJob job{policy, "ContourTree"};
+        tree->setThreadNumber(job.threadCount());
         tree->setupTriangulation(const_cast<ttk::Triangulation*>(&inportData->getTriangulation()));
         // tree->setDebugLevel(0);
         tree->setVertexScalars(buffer->getDataContainer().data());
@@ -120,22 +139,40 @@ void ContourTree::process() {
     // save that event so that a new contour tree can be calculated after the computation is
     // done.
     if (inport_.isChanged()) inportChanged_ = true;
-    dirty_ |= (treeType_.isModified() || segmentation_.isModified() || normalization_.isModified());
+    dirty_ |= (scalars_.isModified() || treeType_.isModified() || segmentation_.isModified() ||
+               normalization_.isModified());
 
     if ((inportChanged_ || dirty_) && treeIsFinished_) {
         treeIsFinished_ = false;
         inportChanged_ = false;
         dirty_ = false;
 
-        dispatchPool([this, inportData, treeType, computeTree]() {
-            auto treeData = std::make_shared<topology::ContourTreeData>();
-            treeData->type = treeType;
-            treeData->triangulation = inportData;
-
-            treeData->tree = inportData->getScalarValues()
-                                 ->getRepresentation<BufferRAM>()
-                                 ->dispatch<std::shared_ptr<topology::ContourTree>,
-                                            dispatching::filter::Scalars>(computeTree);
+        if (auto settings =
+                InviwoApplication::getPtr()->getSettingsByType<topology::TTKSettings>()) {
+            cache_.setCapacity(settings->resultCacheSize.get());
+        }
+
+        dispatchPool([this, inportData, treeType, segmentation, normalization, computeTree]() {
+            // the number of threads does not affect the tree
+            const auto key = topology::ContentHash{}
+                                 .add(topology::contentHash(*inportData))
+                                 .add(treeType)
+                                 .add(segmentation)
+                                 .add(normalization)
+                                 .get();
+            auto treeData = cache_.get(key);
+            if (!treeData) {
+                auto newTreeData = std::make_shared<topology::ContourTreeData>();
+                newTreeData->type = treeType;
+                newTreeData->triangulation = inportData;
+
+                newTreeData->tree = inportData->getScalarValues()
+                                        ->getRepresentation<BufferRAM>()
+                                        ->dispatch<std::shared_ptr<topology::ContourTree>,
+                                                   dispatching::filter::Scalars>(computeTree);
+                cache_.put(key, newTreeData);
+                treeData = newTreeData;
+            }
 
             dispatchFront([this, treeData]() {
                 treeData_ = treeData;
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/topologytoolkit/processors/contourtreetodataframe.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 
@@ -98,18 +99,21 @@ void ContourTreeToDataFrame::process() {
 
         const auto& scalarValues = buffer->getDataContainer();
 
-        for (ttk::ftm::idNode i = 0; i < numNodes; ++i) {
-            auto node = tree->getNode(i);
-            const bool up = node->getNumberOfUpSuperArcs() > 0;
-            const bool down = node->getNumberOfDownSuperArcs() > 0;
-
-            vertexIDs[i] = node->getVertexId();
-            upFlag[i] = up ? 1 : 0;
-            downFlag[i] = down ? 1 : 0;
-            valenceUp[i] = node->getNumberOfUpSuperArcs();
-            valenceDown[i] = node->getNumberOfDownSuperArcs();
-            scalars[i] = scalarValues[vertexIDs[i]];
-        }
+        util::forEachRangeParallel(
+            numNodes, topology::parallelGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    auto node = tree->getNode(static_cast<ttk::ftm::idNode>(i));
+                    const bool up = node->getNumberOfUpSuperArcs() > 0;
+                    const bool down = node->getNumberOfDownSuperArcs() > 0;
+
+                    vertexIDs[i] = node->getVertexId();
+                    upFlag[i] = up ? 1 : 0;
+                    downFlag[i] = down ? 1 : 0;
+                    valenceUp[i] = node->getNumberOfUpSuperArcs();
+                    valenceDown[i] = node->getNumberOfDownSuperArcs();
+                    scalars[i] = scalarValues[vertexIDs[i]];
+                }
+            });
 
         // convert critical points of ttk::ContourTree into a DataFrame
         //
@@ -29,10 +29,12 @@
 
 #include <inviwo/topologytoolkit/processors/contourtreetomesh.h>
 
-//#include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
 #include <inviwo/core/datastructures/geometry/meshram.h>
 
+#include <numeric>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -98,57 +100,62 @@ ContourTreeToMesh::ContourTreeToMesh()
 void ContourTreeToMesh::process() {
     auto tree = inport_.getData()->getTree();
 
-    const size_t numPoints = tree->getNumberOfNodes() + tree->getNumberOfSuperArcs() * 2;
+    const size_t numNodes = tree->getNumberOfNodes();
+    const size_t numArcs = tree->getNumberOfSuperArcs();
+    const size_t numPoints = numNodes + numArcs * 2;
 
-    std::vector<vec3> positions;
-    std::vector<vec4> colors;
-    std::vector<float> radius(numPoints, 0.0f);
-    std::fill(radius.begin(), radius.begin() + tree->getNumberOfNodes(), sphereRadius_.get());
-    positions.reserve(numPoints);
-    colors.reserve(numPoints);
+    topology::preparePointLineMesh(mesh_, false);
+    auto& positions = topology::meshBufferData<vec3>(*mesh_, 0, numPoints);
+    auto& colors = topology::meshBufferData<vec4>(*mesh_, 1, numPoints);
+    auto& radius = topology::meshBufferData<float>(*mesh_, 2, numPoints);
 
     // create a mesh with critical points and arcs
     auto triangulation = inport_.getData()->triangulation;
-    for (ttk::ftm::idNode i = 0; i < tree->getNumberOfNodes(); ++i) {
-        auto node = tree->getNode(i);
-
-        const bool up = node->getNumberOfUpSuperArcs() > 0;
-        const bool down = node->getNumberOfDownSuperArcs() > 0;
-
-        positions.push_back(triangulation->getPoint(node->getVertexId()));
-        colors.push_back(up && down ? saddleColor_ : (up ? localMaximaColor_ : localMinimaColor_));
-    }
+    const vec4 maxColor = localMaximaColor_;
+    const vec4 minColor = localMinimaColor_;
+    const vec4 saddleColor = saddleColor_;
+    const float sphereRadius = sphereRadius_.get();
+    util::forEachRangeParallel(
+        numNodes, topology::parallelGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto node = tree->getNode(static_cast<ttk::ftm::idNode>(i));
+
+                const bool up = node->getNumberOfUpSuperArcs() > 0;
+                const bool down = node->getNumberOfDownSuperArcs() > 0;
+
+                positions[i] = triangulation->getPoint(node->getVertexId());
+                colors[i] = up && down ? saddleColor : (up ? maxColor : minColor);
+                radius[i] = sphereRadius;
+            }
+        });
 
     // arcs
-    for (ttk::ftm::idSuperArc i = 0; i < tree->getNumberOfSuperArcs(); ++i) {
-        auto arc = tree->getSuperArc(i);
-
-        positions.push_back(
-            triangulation->getPoint(tree->getNode(arc->getUpNodeId())->getVertexId()));
-        positions.push_back(
-            triangulation->getPoint(tree->getNode(arc->getDownNodeId())->getVertexId()));
-
-        colors.push_back(arcColor_);
-        colors.push_back(arcColor_);
-    }
-
-    auto mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
-    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
-    mesh->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(std::move(radius)));
+    const vec4 arcColor = arcColor_;
+    util::forEachRangeParallel(numArcs, topology::parallelGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto arc = tree->getSuperArc(static_cast<ttk::ftm::idSuperArc>(i));
+            const auto v = numNodes + 2 * i;
+
+            positions[v] =
+                triangulation->getPoint(tree->getNode(arc->getUpNodeId())->getVertexId());
+            positions[v + 1] =
+                triangulation->getPoint(tree->getNode(arc->getDownNodeId())->getVertexId());
+
+            colors[v] = arcColor;
+            colors[v + 1] = arcColor;
+            radius[v] = 0.0f;
+            radius[v + 1] = 0.0f;
+        }
+    });
 
     // critical points
-    std::vector<uint32_t> indices(tree->getNumberOfNodes());
+    auto& indices = topology::meshIndexData(*mesh_, 0, numNodes);
     std::iota(indices.begin(), indices.end(), 0);
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(indices)));
     // arcs
-    std::vector<uint32_t> arcIndices(tree->getNumberOfSuperArcs() * 2);
-    std::iota(arcIndices.begin(), arcIndices.end(), tree->getNumberOfNodes());
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(arcIndices)));
+    auto& arcIndices = topology::meshIndexData(*mesh_, 1, numArcs * 2);
+    std::iota(arcIndices.begin(), arcIndices.end(), static_cast<uint32_t>(numNodes));
 
-    outport_.setData(mesh);
+    outport_.setData(mesh_);
 }
 
 }  // namespace inviwo
@@ -51,7 +51,9 @@ MeshToTriangulation::MeshToTriangulation()
     , meshInport_("mesh")
     , outport_("outport")
     , selectedBuffer_("selectedBuffer", "Buffer")
-    , component_("component", "Component") {
+    , component_("component", "Component")
+    , mergeVertices_("mergeVertices", "Merge Coincident Vertices", true)
+    , tolerance_("tolerance", "Tolerance", 0.0f, 0.0f, 1.0f, 0.0001f) {
 
     addPort(meshInport_);
     addPort(outport_);
@@ -68,6 +70,8 @@ MeshToTriangulation::MeshToTriangulation()
 
     addProperty(selectedBuffer_);
     addProperty(component_);
+    addProperties(mergeVertices_, tolerance_);
+    tolerance_.visibilityDependsOn(mergeVertices_, [](const auto& p) { return p.get(); });
 
     auto updateComponents = [this]() {
         component_.setReadOnly(selectedBuffer_.getReadOnly());
@@ -118,12 +122,22 @@ MeshToTriangulation::MeshToTriangulation()
 }
 
 void MeshToTriangulation::process() {
-    auto data = std::make_shared<topology::TriangulationData>(
-        topology::meshToTTKTriangulation(*meshInport_.getData().get()));
-
-    // set data associated with vertex positions
-    data->setScalarValues(*meshInport_.getData()->getBuffer(selectedBuffer_.get()),
-                          component_.get());
+    const auto& mesh = *meshInport_.getData();
+    const auto& buffer = *mesh.getBuffer(selectedBuffer_.get());
+
+    std::shared_ptr<topology::TriangulationData> data;
+    if (mergeVertices_) {
+        std::vector<uint32_t> sourceVertices;
+        data = std::make_shared<topology::TriangulationData>(
+            topology::meshToTTKTriangulation(mesh, tolerance_.get(), sourceVertices));
+        // set data associated with the vertices each merged vertex was taken from
+        data->setScalarValues(topology::gatherScalars(buffer, component_.get(), sourceVertices));
+    } else {
+        data =
+            std::make_shared<topology::TriangulationData>(topology::meshToTTKTriangulation(mesh));
+        // set data associated with vertex positions
+        data->setScalarValues(buffer, component_.get());
+    }
     outport_.setData(data);
 }
 
@@ -29,13 +29,14 @@
 
 #include <inviwo/topologytoolkit/processors/morsesmalecomplex.h>
 #include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/datastructures/geometry/mesh.h>
 #include <inviwo/core/datastructures/geometry/meshram.h>
 #include <inviwo/core/util/stdextensions.h>
-#include <inviwo/core/util/clock.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -109,22 +110,46 @@ void MorseSmaleComplex::updateOutport() {
     const auto csc = *computeSaddleConnectors_;
     const auto scpt = *saddleConnectorsPersistenceThreshold_;
 
-    auto compute = [inportData, done, rsc, csc,
-                    scpt]() -> std::shared_ptr<const topology::MorseSmaleComplexData> {
-        ScopedClockCPU clock{"MorseSmaleComplex", "Morse-Smale complex calculation",
-                             std::chrono::milliseconds(500), LogLevel::Info};
+    if (auto settings = InviwoApplication::getPtr()->getSettingsByType<topology::TTKSettings>()) {
+        cache_.setCapacity(settings->resultCacheSize.get());
+    }
+
+    auto compute = [inportData, done, rsc, csc, scpt, policy = topology::threadPolicy(),
+                    cacheDir = topology::diskcache::cacheDirectory(),
+                    cache = &cache_]() -> std::shared_ptr<const topology::MorseSmaleComplexData> {
+        const auto key = topology::ContentHash{}
+                             .add(topology::contentHash(*inportData))
+                             .add(rsc)
+                             .add(csc)
+                             .add(scpt)
+                             .get();
+        if (auto cached = cache->get(key)) {
+            done();
+            return cached;
+        }
+        const auto cacheFile = topology::diskcache::cacheFile(cacheDir, key, "msc");
+        if (!cacheFile.empty()) {
+            if (auto mscData = topology::diskcache::readMorseSmaleComplex(cacheFile, inportData)) {
+                cache->put(key, mscData);
+                done();
+                return mscData;
+            }
+        }
+
         auto mscData =
             inportData->getScalarValues()
                 ->getRepresentation<BufferRAM>()
                 ->dispatch<std::shared_ptr<topology::MorseSmaleComplexData>,
                            dispatching::filter::Scalars>(
-                    [inportData, rsc, csc, scpt](const auto buffer) {
+                    [inportData, rsc, csc, scpt, &policy](const auto buffer) {
                         using ValueType = util::PrecisionValueType<decltype(buffer)>;
                         using PrimitiveType = typename DataFormat<ValueType>::primitive;
 
                         std::vector<int> offsets(inportData->getOffsets());
 
+                        topology::TTKJob job{policy, "MorseSmaleComplex"};
                         ttk::MorseSmaleComplex morseSmaleComplex;
+                        morseSmaleComplex.setThreadNumber(job.threadCount());
                         morseSmaleComplex.setupTriangulation(
                             const_cast<ttk::Triangulation*>(&inportData->getTriangulation()));
                         morseSmaleComplex.setInputScalarField(buffer->getDataContainer().data());
@@ -142,6 +167,10 @@ void MorseSmaleComplex::updateOutport() {
                         return mscData;
                     });
 
+        cache->put(key, mscData);
+        if (!cacheFile.empty()) {
+            topology::diskcache::write(cacheFile, *mscData);
+        }
         done();
         return mscData;
     };
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/topologytoolkit/processors/morsesmalecomplextomesh.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
 
 #include <modules/opengl/inviwoopengl.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
@@ -37,6 +38,8 @@
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <fmt/format.h>
 
 namespace inviwo {
@@ -44,87 +47,101 @@ namespace inviwo {
 namespace {
 
 template <bool PBC>
-std::shared_ptr<Mesh> MSCToMesh(const topology::MorseSmaleComplexData& msc,
-                                const TopologyColorsProperty& colorProp,
-                                const TopologyFilterProperty& filterProp, float sphereRadius,
-                                float lineThickness, PickingMapper& pickingExtrema,
-                                PickingMapper& pickingSeperatrix) {
-    // Prepare Memory
-    std::vector<vec3> positions;
-    std::vector<vec4> colors;
-    std::vector<float> radius;
-    std::vector<uint32_t> picking;
-
+void MSCToMesh(const topology::MorseSmaleComplexData& msc, Mesh& mesh,
+               const TopologyColorsProperty& colorProp, const TopologyFilterProperty& filterProp,
+               float sphereRadius, float lineThickness, PickingMapper& pickingExtrema,
+               PickingMapper& pickingSeperatrix) {
     const auto& trig = msc.triangulation->getTriangulation();
     const auto numcp = msc.criticalPoints.numberOfPoints;
+    const auto numCells = msc.separatrixCells.numberOfCells;
     const auto dimensionality = trig.getDimensionality();
     const auto ext = msc.triangulation->getGridExtent();
 
-    std::unordered_map<ttk::SimplexId, char> idToDims;
+    // Dense lookup tables for cell dimensions and separatrix types, which are small integers
+    std::array<bool, 256> showExtrema;
+    std::array<bool, 256> showSeperatrix;
+    std::array<vec4, 256> extremaColor;
+    for (int i = 0; i < 256; ++i) {
+        const auto dim = static_cast<char>(i);
+        showExtrema[i] = filterProp.showExtrema(dimensionality, dim);
+        showSeperatrix[i] = filterProp.showSeperatrix(dimensionality, dim);
+        extremaColor[i] = colorProp.getColor(dimensionality, dim);
+    }
+    const vec4 arcColor = *colorProp.arc_;
+    const auto lut = [](const auto& table, char value) {
+        return table[static_cast<unsigned char>(value)];
+    };
+
+    // Count the visible primitives first, the vertices are then written in parallel
+    std::vector<ttk::SimplexId> cps;
+    cps.reserve(numcp);
+    for (ttk::SimplexId i = 0; i < numcp; i++) {
+        if (lut(showExtrema, msc.criticalPoints.cellDimensions[i])) cps.push_back(i);
+    }
+    std::vector<ttk::SimplexId> cells;
+    cells.reserve(numCells);
+    for (ttk::SimplexId i = 0; i < numCells; ++i) {
+        if (lut(showSeperatrix, msc.separatrixCells.types[i])) cells.push_back(i);
+    }
+    const auto numVertices = cps.size() + 2 * cells.size();
+
+    auto& positions = topology::meshBufferData<vec3>(mesh, 0, numVertices);
+    auto& colors = topology::meshBufferData<vec4>(mesh, 1, numVertices);
+    auto& radius = topology::meshBufferData<float>(mesh, 2, numVertices);
+    auto& picking = topology::meshBufferData<uint32_t>(mesh, 3, numVertices);
 
     // Add critical points with their color
     pickingExtrema.resize(numcp);
     const auto& cpoints = msc.criticalPoints.points;
-    std::vector<uint32_t> cpIndices;
-    for (ttk::SimplexId i = 0; i < numcp; i++) {
-        const auto cellDim = msc.criticalPoints.cellDimensions[i];
-        idToDims[msc.criticalPoints.cellIds[i]] = cellDim;
-
-        if (!filterProp.showExtrema(dimensionality, cellDim)) continue;
-
-        positions.emplace_back(cpoints[i * 3 + 0], cpoints[i * 3 + 1], cpoints[i * 3 + 2]);
-        colors.emplace_back(colorProp.getColor(dimensionality, cellDim));
-        radius.emplace_back(sphereRadius);
-        picking.emplace_back(pickingExtrema.getPickingId(i));
-        cpIndices.emplace_back(positions.size() - 1);
-    }
+    util::forEachRangeParallel(
+        cps.size(), topology::parallelGrainSize, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                const auto i = cps[j];
+                positions[j] = vec3{cpoints[i * 3 + 0], cpoints[i * 3 + 1], cpoints[i * 3 + 2]};
+                colors[j] = lut(extremaColor, msc.criticalPoints.cellDimensions[i]);
+                radius[j] = sphereRadius;
+                picking[j] = static_cast<uint32_t>(pickingExtrema.getPickingId(i));
+            }
+        });
+    auto& cpIndices = topology::meshIndexData(mesh, 0, cps.size());
+    std::iota(cpIndices.begin(), cpIndices.end(), uint32_t{0});
 
     // Add the separatrixCells
-    pickingSeperatrix.resize(msc.separatrixCells.numberOfCells);
+    pickingSeperatrix.resize(numCells);
     const auto& spoints = msc.separatrixPoints.points;
-    std::vector<uint32_t> sepIndices;
-
-    for (ttk::SimplexId i = 0; i < msc.separatrixCells.numberOfCells; ++i) {
-        if (!filterProp.showSeperatrix(dimensionality, msc.separatrixCells.types[i])) continue;
-
-        const auto src = msc.separatrixCells.cells[3 * i + 1];
-        const auto dst = msc.separatrixCells.cells[3 * i + 2];
-
-        std::array<vec3, 2> points{
-            {{spoints[3 * src + 0], spoints[3 * src + 1], spoints[3 * src + 2]},
-             {spoints[3 * dst + 0], spoints[3 * dst + 1], spoints[3 * dst + 2]}}};
-
-        if constexpr (PBC) {
-            points[0] += vec3{glm::lessThan(points[0] - points[1], -0.5f * ext)} * ext;
-            points[1] += vec3{glm::greaterThan(points[0] - points[1], 0.5f * ext)} * ext;
-        }
-
-        for (const auto& point : points) {
-            positions.emplace_back(point);
-            colors.emplace_back(*colorProp.arc_);
-            radius.emplace_back(lineThickness);
-            picking.emplace_back(pickingSeperatrix.getPickingId(i));
-            sepIndices.emplace_back(positions.size() - 1);
-        }
-    }
-
-    auto mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
-    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
-    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
-    mesh->addBuffer(BufferType::RadiiAttrib, util::makeBuffer(std::move(radius)));
-    mesh->addBuffer(BufferType::PickingAttrib, util::makeBuffer(std::move(picking)));
-
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(cpIndices)));
-    mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
-                     util::makeIndexBuffer(std::move(sepIndices)));
+    const auto& scells = msc.separatrixCells.cells;
+    util::forEachRangeParallel(
+        cells.size(), topology::parallelGrainSize, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                const auto i = cells[j];
+                const auto src = scells[3 * i + 1];
+                const auto dst = scells[3 * i + 2];
+
+                std::array<vec3, 2> points{
+                    {{spoints[3 * src + 0], spoints[3 * src + 1], spoints[3 * src + 2]},
+                     {spoints[3 * dst + 0], spoints[3 * dst + 1], spoints[3 * dst + 2]}}};
+
+                if constexpr (PBC) {
+                    points[0] += vec3{glm::lessThan(points[0] - points[1], -0.5f * ext)} * ext;
+                    points[1] += vec3{glm::greaterThan(points[0] - points[1], 0.5f * ext)} * ext;
+                }
+
+                const auto v = cps.size() + 2 * j;
+                for (size_t k = 0; k < 2; ++k) {
+                    positions[v + k] = points[k];
+                    colors[v + k] = arcColor;
+                    radius[v + k] = lineThickness;
+                    picking[v + k] = static_cast<uint32_t>(pickingSeperatrix.getPickingId(i));
+                }
+            }
+        });
+    auto& sepIndices = topology::meshIndexData(mesh, 1, 2 * cells.size());
+    std::iota(sepIndices.begin(), sepIndices.end(), static_cast<uint32_t>(cps.size()));
 
     // vertex positions are already transformed
-    mesh->setModelMatrix(mat4(1.0f));
-    mesh->setWorldMatrix(msc.triangulation->getWorldMatrix());
-    mesh->copyMetaDataFrom(*msc.triangulation);
-
-    return mesh;
+    mesh.setModelMatrix(mat4(1.0f));
+    mesh.setWorldMatrix(msc.triangulation->getWorldMatrix());
+    mesh.copyMetaDataFrom(*msc.triangulation);
 }
 
 }  // namespace
@@ -157,13 +174,15 @@ MorseSmaleComplexToMesh::MorseSmaleComplexToMesh()
 void MorseSmaleComplexToMesh::process() {
     auto msc = mscInport_.getData();
 
+    topology::preparePointLineMesh(mesh_, true);
     if (msc->triangulation->getTriangulation().usesPeriodicBoundaryConditions()) {
-        outport_.setData(MSCToMesh<true>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_,
-                                         pickingExtrema_, pickingSeperatrix_));
+        MSCToMesh<true>(*msc, *mesh_, colors_, filters_, *sphereRadius_, *lineThickness_,
+                        pickingExtrema_, pickingSeperatrix_);
     } else {
-        outport_.setData(MSCToMesh<false>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_,
-                                          pickingExtrema_, pickingSeperatrix_));
+        MSCToMesh<false>(*msc, *mesh_, colors_, filters_, *sphereRadius_, *lineThickness_,
+                         pickingExtrema_, pickingSeperatrix_);
     }
+    outport_.setData(mesh_);
 }
 
 void MorseSmaleComplexToMesh::handleExtremaPicking(PickingEvent* p) {
@@ -29,6 +29,7 @@
 
 #include <inviwo/topologytoolkit/processors/persistencecurve.h>
 #include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 
@@ -60,7 +61,7 @@ PersistenceCurve::PersistenceCurve()
 
 void PersistenceCurve::process() {
     using Result = std::shared_ptr<DataFrame>;
-    auto compute = [data = inport_.getData()]() {
+    auto compute = [data = inport_.getData(), policy = topology::threadPolicy()]() {
         return data->getScalarValues()
             ->getEditableRepresentation<BufferRAM>()
             ->dispatch<Result, dispatching::filter::Scalars>([&](const auto buffer) {
@@ -70,7 +71,9 @@ void PersistenceCurve::process() {
                 std::vector<int> offsets(data->getOffsets());
 
                 // Computing the persistence curve
+                topology::TTKJob job{policy, "PersistenceCurve"};
                 ttk::PersistenceCurve curve;
+                curve.setThreadNumber(job.threadCount());
                 std::vector<std::pair<PrimitiveType, ttk::SimplexId>> outputCurve;
                 curve.setupTriangulation(
                     const_cast<ttk::Triangulation*>(&data->getTriangulation()));
@@ -86,14 +89,15 @@ void PersistenceCurve::process() {
                 // convert result of ttk::PersistenceCurve into a DataFrame
                 auto dataFrame = std::make_shared<DataFrame>();
 
-                std::vector<PrimitiveType> persistence;
-                std::vector<unsigned int> count;
-                persistence.reserve(outputCurve.size());
-                count.reserve(outputCurve.size());
-                for (const auto& p : outputCurve) {
-                    persistence.emplace_back(p.first);
-                    count.emplace_back(static_cast<unsigned int>(p.second));
-                }
+                std::vector<PrimitiveType> persistence(outputCurve.size());
+                std::vector<unsigned int> count(outputCurve.size());
+                util::forEachRangeParallel(
+                    outputCurve.size(), topology::parallelGrainSize, [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i) {
+                            persistence[i] = outputCurve[i].first;
+                            count[i] = static_cast<unsigned int>(outputCurve[i].second);
+                        }
+                    });
 
                 dataFrame->addColumnFromBuffer(
                     "Persistence", util::makeBuffer<PrimitiveType>(std::move(persistence)));
@@ -29,6 +29,9 @@
 
 #include <inviwo/topologytoolkit/processors/persistencediagram.h>
 #include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/util/zip.h>
 #include <inviwo/core/util/stdextensions.h>
@@ -39,9 +42,40 @@
 #include <warn/pop>
 
 #include <algorithm>
+#include <chrono>
+#include <numeric>
 
 namespace inviwo {
 
+namespace {
+
+/**
+ * Every stride-th vertex of a uniform grid along each axis
+ */
+struct CoarseGrid {
+    CoarseGrid(const size3_t& dims, size_t stride)
+        : dims{dims}, coarseDims{(dims - size3_t{1}) / stride + size3_t{1}}, stride{stride} {}
+
+    //! id of coarse vertex \p i in the full grid
+    ttk::SimplexId fineIndex(ttk::SimplexId i) const {
+        const auto v = static_cast<size_t>(i);
+        const size3_t pos{v % coarseDims.x, (v / coarseDims.x) % coarseDims.y,
+                          v / (coarseDims.x * coarseDims.y)};
+        return static_cast<ttk::SimplexId>(stride * (pos.x + dims.x * (pos.y + dims.y * pos.z)));
+    }
+
+    //! extent of the coarse grid given the extent of the full grid
+    vec3 coarseExtent(const vec3& extent) const {
+        return extent / vec3{dims} * vec3{coarseDims} * static_cast<float>(stride);
+    }
+
+    size3_t dims;
+    size3_t coarseDims;
+    size_t stride;
+};
+
+}  // namespace
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo PersistenceDiagram::processorInfo_{
     "org.inviwo.ttk.PersistenceDiagram",               // Class identifier
@@ -57,12 +91,29 @@ PersistenceDiagram::PersistenceDiagram()
     , inport_("triangulation")
     , outport_("outport")
     , dataFrameOutport_("dataframe")
-    , computeSaddleConnectors_{"computeSaddleConnectors", "Compute Saddle Connectors", false} {
+    , scalars_("scalars", "Scalars")
+    , computeSaddleConnectors_{"computeSaddleConnectors", "Compute Saddle Connectors", false}
+    , progressive_{"progressive", "Progressive", false}
+    , timeBudget_{"timeBudget", "Time Budget (ms)", 100, 10, 10000} {
 
     addPort(inport_);
     addPort(outport_);
     addPort(dataFrameOutport_);
-    addProperties(computeSaddleConnectors_);
+    addProperties(scalars_, computeSaddleConnectors_, progressive_, timeBudget_);
+    timeBudget_.visibilityDependsOn(progressive_, [](const auto& p) { return p.get(); });
+
+    scalars_.addOption("selected", "Selected in Input", "");
+    scalars_.setSerializationMode(PropertySerializationMode::All);
+    scalars_.setCurrentStateAsDefault();
+    inport_.onChange([this]() {
+        std::vector<OptionPropertyStringOption> options{{"selected", "Selected in Input", ""}};
+        if (auto data = inport_.getData()) {
+            for (const auto& name : data->getScalarNames()) {
+                options.emplace_back(name, name, name);
+            }
+        }
+        scalars_.replaceOptions(options);
+    });
 }
 
 void PersistenceDiagram::process() {
@@ -71,69 +122,177 @@ void PersistenceDiagram::process() {
     using Result =
         std::pair<std::shared_ptr<topology::PersistenceDiagramData>, std::shared_ptr<DataFrame>>;
 
-    auto compute = [data = inport_.getData(), css = computeSaddleConnectors_.get()]() {
-        return data->getScalarValues()
-            ->getEditableRepresentation<BufferRAM>()
-            ->dispatch<Result, dispatching::filter::Scalars>([&](const auto buffer) -> Result {
-                using ValueType = util::PrecisionValueType<decltype(buffer)>;
-                using DiagramOutput =
-                    std::vector<std::tuple<ttk::SimplexId, ttk::CriticalType, ttk::SimplexId,
-                                           ttk::CriticalType, ValueType, ttk::SimplexId>>;
-
-                std::vector<int> offsets(buffer->getSize());
-                std::iota(offsets.begin(), offsets.end(), 0);
-
-                DiagramOutput output;
-                ttk::PersistenceDiagram diagram;
-                diagram.setComputeSaddleConnectors(css);
-                diagram.setupTriangulation(
-                    const_cast<ttk::Triangulation*>(&data->getTriangulation()));
-                diagram.setOutputCTDiagram(&output);
-                diagram.setInputScalars(buffer->getDataContainer().data());
-                diagram.setInputOffsets(offsets.data());
-
-                int retVal = diagram.execute<typename DataFormat<ValueType>::primitive, int>();
-                if (retVal != 0) {
-                    throw TTKException("Error computing ttk::PersistenceDiagram");
-                }
-
-                // convert result of ttk::PersistenceDiagram into a DataFrame
-                std::vector<ValueType> birth;
-                std::vector<ValueType> death;
-
-                const auto& scalars = buffer->getDataContainer();
-                birth.reserve(output.size());
-                death.reserve(output.size());
-                for (const auto& extremumPair : output) {
-                    birth.push_back(scalars[std::get<0>(extremumPair)]);
-                    death.push_back(scalars[std::get<2>(extremumPair)]);
-                }
-
-                auto dataFrame = std::make_shared<DataFrame>();
-                dataFrame->addColumnFromBuffer("Birth",
-                                               util::makeBuffer<ValueType>(std::move(birth)));
-                dataFrame->addColumnFromBuffer("Death",
-                                               util::makeBuffer<ValueType>(std::move(death)));
-                dataFrame->updateIndexBuffer();
-
-                // TODO: use proper data structure with a Buffer<ValueType> instead of conversion,
-                // needs to match type of scalar buffer!
-
-                // convert diagram output to topology::PersistenceDiagramData, i.e. float
-                auto diagramOutput = std::make_shared<topology::PersistenceDiagramData>();
-                diagramOutput->reserve(output.size());
-                for (auto& elem : output) {
-                    diagramOutput->emplace_back(std::make_tuple(
-                        std::get<0>(elem), std::get<1>(elem), std::get<2>(elem), std::get<3>(elem),
-                        static_cast<float>(std::get<4>(elem)), std::get<5>(elem)));
-                }
-
-                return std::make_pair(diagramOutput, dataFrame);
-            });
+    if (auto settings = InviwoApplication::getPtr()->getSettingsByType<topology::TTKSettings>()) {
+        cache_.setCapacity(settings->resultCacheSize.get());
+    }
+
+    auto data = topology::selectScalarValues(inport_.getData(), scalars_.get());
+
+    // stride of the coarse grid computed first in progressive mode, chosen based on the speed of
+    // the previous computations to finish within the time budget
+    size_t stride = 1;
+    if (progressive_.get() && data->isUniformGrid()) {
+        const auto dims = data->getGridDimensions();
+        const auto budget = static_cast<double>(timeBudget_.get()) / 1000.0 * verticesPerSecond_;
+        const auto coarseSize = [&](size_t s) {
+            return glm::compMul(CoarseGrid{dims, s}.coarseDims);
+        };
+        while (static_cast<double>(coarseSize(stride)) > budget &&
+               coarseSize(2 * stride) < coarseSize(stride)) {
+            stride *= 2;
+        }
+    }
+
+    const auto generation = ++generation_;
+    auto showCoarse = [this, generation](Result result) {
+        dispatchFront([this, generation, result]() {
+            if (generation != generation_) return;
+            outport_.setData(result.first);
+            dataFrameOutport_.setData(result.second);
+            newResults();
+        });
+    };
+
+    auto compute = [data, css = computeSaddleConnectors_.get(), stride, showCoarse,
+                    policy = topology::threadPolicy(),
+                    cacheDir = topology::diskcache::cacheDirectory(), cache = &cache_,
+                    verticesPerSecond = &verticesPerSecond_](pool::Stop stop,
+                                                             pool::Progress progress) -> Result {
+        const auto key = topology::ContentHash{}.add(topology::contentHash(*data)).add(css).get();
+        if (auto cached = cache->get(key)) return *cached;
+        const auto cacheFile = topology::diskcache::cacheFile(cacheDir, key, "pd");
+
+        auto result =
+            data->getScalarValues()
+                ->getEditableRepresentation<BufferRAM>()
+                ->dispatch<Result, dispatching::filter::Scalars>([&](const auto buffer) -> Result {
+                    using ValueType = util::PrecisionValueType<decltype(buffer)>;
+                    using DiagramOutput =
+                        std::vector<std::tuple<ttk::SimplexId, ttk::CriticalType, ttk::SimplexId,
+                                               ttk::CriticalType, ValueType, ttk::SimplexId>>;
+
+                    // convert diagram output to topology::PersistenceDiagramData, i.e. float
+                    const auto computeDiagram = [&](const ttk::Triangulation& triangulation,
+                                                    const std::vector<ValueType>& scalars) {
+                        std::vector<int> offsets(scalars.size());
+                        std::iota(offsets.begin(), offsets.end(), 0);
+
+                        DiagramOutput output;
+                        topology::TTKJob job{policy, "PersistenceDiagram"};
+                        ttk::PersistenceDiagram diagram;
+                        diagram.setThreadNumber(job.threadCount());
+                        diagram.setComputeSaddleConnectors(css);
+                        diagram.setupTriangulation(
+                            const_cast<ttk::Triangulation*>(&triangulation));
+                        diagram.setOutputCTDiagram(&output);
+                        diagram.setInputScalars(const_cast<ValueType*>(scalars.data()));
+                        diagram.setInputOffsets(offsets.data());
+
+                        int retVal =
+                            diagram.execute<typename DataFormat<ValueType>::primitive, int>();
+                        if (retVal != 0) {
+                            throw TTKException("Error computing ttk::PersistenceDiagram");
+                        }
+
+                        // TODO: use proper data structure with a Buffer<ValueType> instead of
+                        // conversion, needs to match type of scalar buffer!
+                        auto res = std::make_shared<topology::PersistenceDiagramData>(
+                            output.size());
+                        util::forEachRangeParallel(
+                            output.size(), topology::parallelGrainSize,
+                            [&](size_t begin, size_t end) {
+                                for (size_t i = begin; i < end; ++i) {
+                                    const auto& elem = output[i];
+                                    (*res)[i] = std::make_tuple(
+                                        std::get<0>(elem), std::get<1>(elem), std::get<2>(elem),
+                                        std::get<3>(elem), static_cast<float>(std::get<4>(elem)),
+                                        std::get<5>(elem));
+                                }
+                            });
+                        topology::sortByPersistence(*res);
+                        return res;
+                    };
+
+                    // convert the persistence diagram into a DataFrame
+                    const auto& scalars = buffer->getDataContainer();
+                    const auto makeResult =
+                        [&](std::shared_ptr<topology::PersistenceDiagramData> diagramOutput) {
+                            std::vector<ValueType> birth(diagramOutput->size());
+                            std::vector<ValueType> death(diagramOutput->size());
+                            util::forEachRangeParallel(
+                                diagramOutput->size(), topology::parallelGrainSize,
+                                [&](size_t begin, size_t end) {
+                                    for (size_t i = begin; i < end; ++i) {
+                                        const auto& extremumPair = (*diagramOutput)[i];
+                                        birth[i] = scalars[std::get<0>(extremumPair)];
+                                        death[i] = scalars[std::get<2>(extremumPair)];
+                                    }
+                                });
+
+                            auto dataFrame = std::make_shared<DataFrame>();
+                            dataFrame->addColumnFromBuffer(
+                                "Birth", util::makeBuffer<ValueType>(std::move(birth)));
+                            dataFrame->addColumnFromBuffer(
+                                "Death", util::makeBuffer<ValueType>(std::move(death)));
+                            dataFrame->updateIndexBuffer();
+
+                            return std::make_pair(diagramOutput, dataFrame);
+                        };
+
+                    auto diagramOutput =
+                        cacheFile.empty() ? nullptr
+                                          : topology::diskcache::readPersistenceDiagram(cacheFile);
+                    if (diagramOutput) {
+                        // diagrams cached by earlier versions are not sorted
+                        topology::sortByPersistence(*diagramOutput);
+                        return makeResult(diagramOutput);
+                    }
+
+                    if (stride > 1) {
+                        const CoarseGrid grid{data->getGridDimensions(), stride};
+                        std::vector<ValueType> coarseScalars(glm::compMul(grid.coarseDims));
+                        for (size_t i = 0; i < coarseScalars.size(); ++i) {
+                            coarseScalars[i] =
+                                scalars[grid.fineIndex(static_cast<ttk::SimplexId>(i))];
+                        }
+                        const topology::TriangulationData coarse(
+                            grid.coarseDims, data->getGridOrigin(),
+                            grid.coarseExtent(data->getGridExtent()), DataMapper{});
+
+                        auto coarseDiagram =
+                            computeDiagram(coarse.getTriangulation(), coarseScalars);
+                        for (auto& pair : *coarseDiagram) {
+                            std::get<0>(pair) = grid.fineIndex(std::get<0>(pair));
+                            std::get<2>(pair) = grid.fineIndex(std::get<2>(pair));
+                        }
+                        showCoarse(makeResult(coarseDiagram));
+                        progress(0.1f);
+                    }
+                    if (stop) return {};
+
+                    const auto start = std::chrono::steady_clock::now();
+                    diagramOutput = computeDiagram(data->getTriangulation(), scalars);
+                    const std::chrono::duration<double> elapsed =
+                        std::chrono::steady_clock::now() - start;
+                    if (elapsed.count() > 0.0) {
+                        *verticesPerSecond = static_cast<double>(scalars.size()) / elapsed.count();
+                    }
+
+                    if (!cacheFile.empty()) {
+                        topology::diskcache::write(cacheFile, *diagramOutput);
+                    }
+                    return makeResult(diagramOutput);
+                });
+
+        if (result.first) cache->put(key, std::make_shared<Result>(result));
+        return result;
     };
 
-    outport_.setData(nullptr);
-    dataFrameOutport_.setData(nullptr);
+    // keep showing the previous diagram until the coarse one is available
+    if (stride == 1) {
+        outport_.setData(nullptr);
+        dataFrameOutport_.setData(nullptr);
+    }
     dispatchOne(compute, [this](Result result) {
         outport_.setData(result.first);
         dataFrameOutport_.setData(result.second);
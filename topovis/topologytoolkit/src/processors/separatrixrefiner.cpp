@@ -28,12 +28,78 @@
  *********************************************************************************/
 
 #include <inviwo/topologytoolkit/processors/separatrixrefiner.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/core/util/foreach.h>
 #include <ttk/core/base/discreteGradient/DiscreteGradient.h>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+
 namespace inviwo {
 
 namespace {
 
+/**
+ * Gradient sampled once at the vertices of a uniform grid and interpolated trilinearly, which
+ * avoids a virtual call and a cell lookup in the sampler for every node in every timestep.
+ */
+struct GradientGrid {
+    GradientGrid(const SpatialSampler<3, 3, double>& sampler, size3_t dims, vec3 origin,
+                 vec3 extent, bool periodic)
+        : dims{dims}
+        , origin{origin}
+        , spacing{extent / vec3{dims}}
+        , periodic{periodic}
+        , values(glm::compMul(dims)) {
+        std::vector<size_t> slices(dims.z);
+        util::forEachParallel(slices, [&](size_t, size_t z) {
+            for (size_t y = 0; y < dims.y; ++y) {
+                for (size_t x = 0; x < dims.x; ++x) {
+                    const auto pos = origin + vec3{x, y, z} * spacing;
+                    values[index(x, y, z)] =
+                        static_cast<vec3>(sampler.sample(dvec3{pos}, CoordinateSpace::Model));
+                }
+            }
+        });
+    }
+
+    size_t index(size_t x, size_t y, size_t z) const { return x + dims.x * (y + dims.y * z); }
+
+    vec3 operator()(const vec3& pos) const {
+        const auto gridPos = (pos - origin) / spacing;
+        const auto cell = glm::floor(gridPos);
+        const auto t = gridPos - cell;
+
+        std::array<size_t, 2> x, y, z;
+        const auto corner = [&](float c, size_t dim, std::array<size_t, 2>& res) {
+            const auto n = static_cast<std::ptrdiff_t>(dim);
+            for (std::ptrdiff_t i = 0; i < 2; ++i) {
+                auto v = static_cast<std::ptrdiff_t>(c) + i;
+                v = periodic ? ((v % n) + n) % n : std::clamp<std::ptrdiff_t>(v, 0, n - 1);
+                res[i] = static_cast<size_t>(v);
+            }
+        };
+        corner(cell.x, dims.x, x);
+        corner(cell.y, dims.y, y);
+        corner(cell.z, dims.z, z);
+
+        const auto lerpX = [&](size_t j, size_t k) {
+            return glm::mix(values[index(x[0], y[j], z[k])], values[index(x[1], y[j], z[k])],
+                            t.x);
+        };
+        return glm::mix(glm::mix(lerpX(0, 0), lerpX(1, 0), t.y),
+                        glm::mix(lerpX(0, 1), lerpX(1, 1), t.y), t.z);
+    }
+
+    size3_t dims;
+    vec3 origin;
+    vec3 spacing;
+    bool periodic;
+    std::vector<vec3> values;
+};
+
 template <size_t N, typename T, typename PBC>
 class SeparatrixSpringSystem : public SpringSystem<N, T, SeparatrixSpringSystem<N, T, PBC>, PBC> {
 public:
@@ -42,48 +108,57 @@ public:
     static constexpr size_t Components = N;
     using Vector = typename Base::Vector;
 
-    SeparatrixSpringSystem(const SpatialSampler<3, 3, double>& sampler, T gradientScale, T timeStep,
+    SeparatrixSpringSystem(const SpatialSampler<3, 3, double>& sampler,
+                           const GradientGrid* gradient, T gradientScale, T timeStep,
                            std::vector<Vector> positions, std::vector<SpringIndices> springs,
                            std::vector<topology::CellType> aTypes, T nodeMass,
                            T springLinearConstant, T springSquareConstant, T springLength,
                            T springDampning, Vector origin, Vector ext)
         : Base(timeStep, std::move(positions), std::move(springs), origin, ext)
         , sampler{sampler}
+        , gradient{gradient}
         , gradientScale{gradientScale}
         , types{std::move(aTypes)}
+        , factors(types.size())
         , globalNodeMass{nodeMass}
         , springLinearConstant{springLinearConstant}
         , springSquareConstant{springSquareConstant}
         , globalSpringLength{springLength}
-        , globalSpringDampning{springDampning} {}
+        , globalSpringDampning{springDampning} {
+        std::transform(types.begin(), types.end(), factors.begin(), &gradientFactor);
+    }
 
     bool isLocked(size_t i) const { return types[i] == topology::CellType::saddle; }
 
     Vector externalForce(size_t i) {
+        if (factors[i] == 0.0f) return Vector{0};
+        const auto& pos = this->positions_[i];
+        return factors[i] * gradientScale *
+               (gradient ? (*gradient)(pos)
+                         : static_cast<Vector>(sampler.sample(pos, CoordinateSpace::Model)));
+    }
 
-        const float factor = [&]() {
-            switch (types[i]) {
-                case topology::CellType::minimum:
-                    return 1.0f;
-                case topology::CellType::maxSaddle:
-                    return 1.0f;
-                case topology::CellType::maximum:
-                    return -1.0f;
-                case topology::CellType::minSaddle:
-                    return -1.0f;
-                case topology::CellType::saddle:
-                    return 0.0f;
-                case topology::CellType::saddleSaddle:
-                    return 0.0f;
-                case topology::CellType::unkown:
-                    return 0.0f;
-                default:
-                    return 0.0f;
-            }
-        }();
-        return factor * gradientScale *
-               static_cast<Vector>(sampler.sample(this->positions_[i], CoordinateSpace::Model));
+    static float gradientFactor(topology::CellType type) {
+        switch (type) {
+            case topology::CellType::minimum:
+                return 1.0f;
+            case topology::CellType::maxSaddle:
+                return 1.0f;
+            case topology::CellType::maximum:
+                return -1.0f;
+            case topology::CellType::minSaddle:
+                return -1.0f;
+            case topology::CellType::saddle:
+                return 0.0f;
+            case topology::CellType::saddleSaddle:
+                return 0.0f;
+            case topology::CellType::unkown:
+                return 0.0f;
+            default:
+                return 0.0f;
+        }
     }
+
     T nodeMass(size_t) { return globalNodeMass; }
 
     T forceMagnitude(size_t, T displacement) {
@@ -97,9 +172,18 @@ public:
     void constrainPosition(size_t, Vector&) const {}
     void constrainVelocity(size_t, Vector&) const {}
 
+    void permuteNodes(const std::vector<size_t>& order) {
+        detail::permute(types, order);
+        detail::permute(factors, order);
+    }
+
     const SpatialSampler<3, 3, double>& sampler;
+    // used instead of the sampler if available
+    const GradientGrid* gradient;
     T gradientScale;
     std::vector<topology::CellType> types;
+    // sign of the gradient force of each node, given by its type
+    std::vector<float> factors;
     T globalNodeMass{1};
     T springLinearConstant{1};
     T springSquareConstant{1};
@@ -110,11 +194,14 @@ public:
 struct SpringSettings {
     size_t timesteps;
     float timestep;
+    SpringIntegrator integrator;
+    size_t projectiveIterations;
     float length;
     float linearConstant;
     float squareConstant;
     float damping;
     float gradientScale;
+    float tolerance;
 };
 
 template <size_t SelectionSize, typename T, size_t InputSize>
@@ -145,81 +232,40 @@ constexpr auto permutations(const std::array<T, InputSize>& values) {
 }
 
 template <bool PBC>
-std::shared_ptr<Mesh> refine(const topology::MorseSmaleComplexData& msc,
-                             const TopologyColorsProperty& colorProp,
-                             const TopologyFilterProperty& filterProp, float sphereRadius,
-                             float lineThickness, bool fillPBC,
-                             const SpatialSampler<3, 3, double>& sampler,
-                             SpringSettings springSettings) {
+std::pair<std::shared_ptr<Mesh>, size_t> refine(const topology::MorseSmaleComplexData& msc,
+                                                const TopologyColorsProperty& colorProp,
+                                                const TopologyFilterProperty& filterProp,
+                                                float sphereRadius, float lineThickness,
+                                                bool fillPBC,
+                                                const SpatialSampler<3, 3, double>& sampler,
+                                                const detail::SeparatrixTopology& topology,
+                                                SpringSettings springSettings) {
     using Sys = SeparatrixSpringSystem<3, float, std::integer_sequence<bool, PBC, PBC, PBC>>;
 
     const auto& cp = msc.criticalPoints;
-    const auto& sp = msc.separatrixPoints;
-    const auto& sc = msc.separatrixCells;
-
     const auto ncp = cp.numberOfPoints;
-    const auto nsc = sc.numberOfCells;
     const auto dimensionality = msc.triangulation->getTriangulation().getDimensionality();
 
     const auto ext = msc.triangulation->getGridExtent();
     const auto origin = msc.triangulation->getGridOrigin();
 
-    std::vector<vec3> positions;
-    std::vector<topology::CellType> types;
-    std::vector<typename Sys::SpringIndices> springs;
-
-    const auto id = [](const auto& item, auto i) {
-        return std::make_tuple(item.cellDimensions[i], item.cellIds[i]);
-    };
-
-    std::unordered_map<std::tuple<char, ttk::SimplexId>, size_t> cellIdToPosIndex;
-    for (ttk::SimplexId i = 0; i < ncp; i++) {
-        positions.emplace_back(cp.points[3 * i + 0], cp.points[3 * i + 1], cp.points[3 * i + 2]);
-        types.push_back(topology::extremaDimToType(dimensionality, cp.cellDimensions[i]));
-        cellIdToPosIndex[id(cp, i)] = positions.size() - 1;
-    }
-
-    std::vector<std::pair<ttk::SimplexId, ttk::SimplexId>> seperatixBeginEnd;
-    for (ttk::SimplexId i = 1, begin = 0; i < nsc; ++i) {
-        if (sc.separatrixIds[i - 1] != sc.separatrixIds[i]) {
-            seperatixBeginEnd.emplace_back(begin, i);
-            begin = i;
-        }
-    }
-
-    seperatixBeginEnd.emplace_back(seperatixBeginEnd.back().second, sc.separatrixIds.size());
-
-    for (auto& sep : seperatixBeginEnd) {
-        const auto src = sc.cells[3 * sep.first + 1];
-        const auto srcCPIndex = cellIdToPosIndex.find(id(sp, src));
-        IVW_ASSERT(srcCPIndex != cellIdToPosIndex.end(), "Should always find a CP index");
-
-        ttk::SimplexId srcPosIndex = srcCPIndex->second;
-
-        for (ttk::SimplexId i = sep.first; i < sep.second - 1; ++i) {
-            const auto dstInd = sc.cells[3 * i + 2];
-
-            positions.emplace_back(sp.points[3 * dstInd + 0], sp.points[3 * dstInd + 1],
-                                   sp.points[3 * dstInd + 2]);
-
-            types.push_back(topology::seperatrixTypeToType(dimensionality, sc.types[i]));
-            springs.emplace_back(srcPosIndex, positions.size() - 1);
-            srcPosIndex = positions.size() - 1;
-        }
-
-        const auto dst = sc.cells[3 * (sep.second - 1) + 2];
-        const auto dstCPIndex = cellIdToPosIndex.find(id(sp, dst));
-        IVW_ASSERT(dstCPIndex != cellIdToPosIndex.end(), "Should always find a CP index");
-
-        springs.emplace_back(srcPosIndex, dstCPIndex->second);
+    // Sampling the gradient once per grid vertex is cheaper than sampling it for every node in
+    // every timestep as soon as there are more node samples than grid vertices
+    std::optional<GradientGrid> gradient;
+    const auto gridDims = msc.triangulation->getGridDimensions();
+    if (glm::compMul(gridDims) > 0 &&
+        glm::compMul(gridDims) <
+            topology.positions.size() * std::max<size_t>(springSettings.timesteps, 1)) {
+        gradient.emplace(sampler, gridDims, origin, ext, PBC);
     }
 
     Sys sys{sampler,
+            gradient ? &*gradient : nullptr,
             springSettings.gradientScale,
             springSettings.timestep,
-            std::move(positions),
-            std::move(springs),
-            std::move(types),
+            topology.positions,
+            topology.springs,
+            topology.types,
             1.0f,
             springSettings.linearConstant,
             springSettings.squareConstant,
@@ -227,7 +273,15 @@ std::shared_ptr<Mesh> refine(const topology::MorseSmaleComplexData& msc,
             springSettings.damping,
             origin,
             ext};
-    sys.integrate(springSettings.timesteps);
+    sys.reorderNodes();
+    sys.setIntegrator(springSettings.integrator);
+    sys.setProjectiveIterations(springSettings.projectiveIterations);
+    auto steps = springSettings.timesteps;
+    if (springSettings.tolerance > 0.0f) {
+        steps = sys.integrateUntilConverged(springSettings.timesteps, springSettings.tolerance);
+    } else {
+        sys.integrate(springSettings.timesteps);
+    }
 
     std::vector<vec3> vertices;
     std::vector<vec4> colors;
@@ -245,7 +299,7 @@ std::shared_ptr<Mesh> refine(const topology::MorseSmaleComplexData& msc,
 
     for (ttk::SimplexId i = 0; i < ncp; i++) {
         if (!filterProp.showExtrema(dimensionality, cp.cellDimensions[i])) continue;
-        const auto pos = sys.position(i);
+        const auto pos = sys.position(sys.nodeIndex(i));
         const auto color = colorProp.getColor(dimensionality, cp.cellDimensions[i]);
 
         const auto add = [&](const vec3 pos) {
@@ -340,11 +394,103 @@ std::shared_ptr<Mesh> refine(const topology::MorseSmaleComplexData& msc,
     mesh->setWorldMatrix(msc.triangulation->getWorldMatrix());
     mesh->copyMetaDataFrom(*msc.triangulation);
 
-    return mesh;
+    return {mesh, steps};
 }
 
 }  // namespace
 
+namespace detail {
+
+std::shared_ptr<const SeparatrixTopology> makeSeparatrixTopology(
+    const topology::MorseSmaleComplexData& msc) {
+    constexpr auto npos = std::numeric_limits<size_t>::max();
+    constexpr size_t grainSize = 1 << 16;
+
+    const auto& cp = msc.criticalPoints;
+    const auto& sp = msc.separatrixPoints;
+    const auto& sc = msc.separatrixCells;
+
+    const auto ncp = static_cast<size_t>(cp.numberOfPoints);
+    const auto nsc = static_cast<size_t>(sc.numberOfCells);
+    const auto dimensionality = msc.triangulation->getTriangulation().getDimensionality();
+
+    // node index of each critical cell, one dense array per cell dimension indexed by cell id
+    std::array<std::vector<size_t>, 4> cellIdToPosIndex;
+    for (size_t i = 0; i < ncp; ++i) {
+        auto& lookup = cellIdToPosIndex[static_cast<size_t>(cp.cellDimensions[i])];
+        lookup.resize(std::max(lookup.size(), static_cast<size_t>(cp.cellIds[i]) + 1), npos);
+    }
+    for (size_t i = 0; i < ncp; ++i) {
+        cellIdToPosIndex[static_cast<size_t>(cp.cellDimensions[i])][cp.cellIds[i]] = i;
+    }
+    const auto cpIndex = [&](ttk::SimplexId pointIndex) {
+        const auto& lookup = cellIdToPosIndex[static_cast<size_t>(sp.cellDimensions[pointIndex])];
+        const auto cellId = static_cast<size_t>(sp.cellIds[pointIndex]);
+        IVW_ASSERT(cellId < lookup.size() && lookup[cellId] != npos,
+                   "Should always find a CP index");
+        return lookup[cellId];
+    };
+
+    // first cell of each separatrix, the cells of a separatrix are stored consecutively
+    std::vector<std::vector<size_t>> chunkStarts((nsc + grainSize - 1) / grainSize);
+    if (nsc > 0) {
+        util::forEachRangeParallel(nsc, grainSize, [&](size_t begin, size_t end) {
+            auto& starts = chunkStarts[begin / grainSize];
+            for (size_t i = begin; i < end; ++i) {
+                if (i == 0 || sc.separatrixIds[i - 1] != sc.separatrixIds[i]) {
+                    starts.push_back(i);
+                }
+            }
+        });
+    }
+    std::vector<size_t> starts;
+    for (const auto& chunk : chunkStarts) starts.insert(starts.end(), chunk.begin(), chunk.end());
+    const auto nsep = starts.size();
+    starts.push_back(nsc);
+
+    // Separatrix k with the cells [b, e) adds one spring per cell and a node for each cell but
+    // the last one, which ends in a critical point. Hence its springs start at b and its nodes
+    // at ncp + b - k, and every cell can be handled independently.
+    auto res = std::make_shared<SeparatrixTopology>();
+    res->positions.resize(ncp + nsc - nsep);
+    res->types.resize(ncp + nsc - nsep);
+    res->springs.resize(nsc);
+
+    util::forEachRangeParallel(ncp, topology::parallelGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            res->positions[i] = vec3{cp.points[3 * i + 0], cp.points[3 * i + 1],
+                                     cp.points[3 * i + 2]};
+            res->types[i] = topology::extremaDimToType(dimensionality, cp.cellDimensions[i]);
+        }
+    });
+
+    util::forEachRangeParallel(nsc, grainSize, [&](size_t begin, size_t end) {
+        size_t k = std::upper_bound(starts.begin(), starts.end(), begin) - starts.begin() - 1;
+        for (size_t i = begin; i < end; ++i) {
+            while (starts[k + 1] <= i) ++k;
+            const auto first = i == starts[k];
+            const auto last = i + 1 == starts[k + 1];
+            const auto node = ncp + i - k;
+
+            const auto src = first ? cpIndex(sc.cells[3 * i + 1]) : node - 1;
+            const auto dstInd = sc.cells[3 * i + 2];
+            if (last) {
+                res->springs[i] = {src, cpIndex(dstInd)};
+            } else {
+                res->positions[node] = vec3{sp.points[3 * dstInd + 0],
+                                            sp.points[3 * dstInd + 1],
+                                            sp.points[3 * dstInd + 2]};
+                res->types[node] = topology::seperatrixTypeToType(dimensionality, sc.types[i]);
+                res->springs[i] = {src, node};
+            }
+        }
+    });
+
+    return res;
+}
+
+}  // namespace detail
+
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo SeparatrixRefiner::processorInfo_{
     "org.inviwo.SeparatrixRefiner",  // Class identifier
@@ -370,18 +516,31 @@ SeparatrixRefiner::SeparatrixRefiner()
     , springSys_("springSys", "Spring System")
     , timesteps_{"timesteps", "Timesteps", size_t{100}, size_t{0}, size_t{1000000}}
     , timestep_{"timestep", "Timestep", 0.01f, 0.0f, 100.0f}
+    , integrator_{"integrator",
+                  "Integrator",
+                  {{"verlet", "Verlet", SpringIntegrator::Verlet},
+                   {"projective", "Projective Dynamics", SpringIntegrator::Projective}},
+                  0}
+    , projectiveIterations_{"projectiveIterations", "Projective Iterations", size_t{10},
+                            size_t{1}, size_t{100}}
     , springLength_{"springLength", "Spring Length", 0.01f, 0.0f, 100.0f}
     , springLinearConstant_{"springLinearConstant", "Spring Linear Constant", 1.0f, -2.0f, 2.0f}
     , springSquareConstant_{"springSquareConstant", "Spring Square Constant", 0.0f, -20.0f, 20.0f}
     , springDamping_{"springDamping", "Spring Damping", 0.01f, 0.0f, 2.0f}
-    , gradientScale_{"gradientScale", "Gradient Scale", 1.0f, -1.0f, 1.0f} {
+    , gradientScale_{"gradientScale", "Gradient Scale", 1.0f, -1.0f, 1.0f}
+    , tolerance_{"tolerance", "Convergence Tolerance", 0.0f, 0.0f, 0.01f, 0.00001f}
+    , stepsTaken_{"stepsTaken", "Steps Taken", size_t{0}, size_t{0}, size_t{1000000}} {
 
     addPort(inport_);
     addPort(sampler_);
     addPort(outport_);
 
-    springSys_.addProperties(timesteps_, timestep_, springLength_, springLinearConstant_,
-                             springSquareConstant_, springDamping_, gradientScale_);
+    springSys_.addProperties(timesteps_, timestep_, integrator_, projectiveIterations_,
+                             springLength_, springLinearConstant_, springSquareConstant_,
+                             springDamping_, gradientScale_, tolerance_, stepsTaken_);
+    stepsTaken_.setReadOnly(true);
+    stepsTaken_.setInvalidationLevel(InvalidationLevel::Valid);
+    stepsTaken_.setSerializationMode(PropertySerializationMode::None);
 
     addProperties(colors_, sphereRadius_, lineThickness_, fillPBC_, filters_, springSys_);
 }
@@ -389,21 +548,30 @@ SeparatrixRefiner::SeparatrixRefiner()
 void SeparatrixRefiner::process() {
     auto msc = inport_.getData();
 
+    // the nodes and springs only depend on the complex, not on the spring settings
+    if (inport_.isChanged() || !topology_) {
+        topology_ = detail::makeSeparatrixTopology(*msc);
+    }
+
     SpringSettings settings{*timesteps_,
                             *timestep_,
+                            *integrator_,
+                            *projectiveIterations_,
                             *springLength_,
                             *springLinearConstant_,
                             *springSquareConstant_,
                             *springDamping_,
-                            *gradientScale_};
-
-    if (msc->triangulation->getTriangulation().usesPeriodicBoundaryConditions()) {
-        outport_.setData(refine<true>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_,
-                                      *fillPBC_, *sampler_.getData(), settings));
-    } else {
-        outport_.setData(refine<false>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_,
-                                       *fillPBC_, *sampler_.getData(), settings));
-    }
+                            *gradientScale_,
+                            *tolerance_};
+
+    const auto [mesh, steps] =
+        msc->triangulation->getTriangulation().usesPeriodicBoundaryConditions()
+            ? refine<true>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_, *fillPBC_,
+                           *sampler_.getData(), *topology_, settings)
+            : refine<false>(*msc, colors_, filters_, *sphereRadius_, *lineThickness_, *fillPBC_,
+                            *sampler_.getData(), *topology_, settings);
+    stepsTaken_.set(steps);
+    outport_.setData(mesh);
 }
 
 }  // namespace inviwo
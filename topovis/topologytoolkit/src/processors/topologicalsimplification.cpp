@@ -29,6 +29,9 @@
 
 #include <inviwo/topologytoolkit/processors/topologicalsimplification.h>
 #include <inviwo/topologytoolkit/utils/ttkutils.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/util/zip.h>
@@ -40,6 +43,9 @@
 #include <warn/pop>
 #include <inviwo/core/util/formats.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace inviwo {
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -69,12 +75,15 @@ TopologicalSimplification::TopologicalSimplification()
 
     persistenceInport_.onChange([this]() {
         if (persistenceInport_.hasData()) {
-            // Adjust max value to highest persistence value
-            auto endIt = std::end(*persistenceInport_.getData());
-            auto maxIt = std::max_element(
-                std::begin(*persistenceInport_.getData()), endIt,
-                [](const auto& a, const auto& b) { return std::get<4>(a) < std::get<4>(b); });
-            if (maxIt != endIt) {
+            // Adjust max value to highest persistence value, the last one of sorted diagrams
+            const auto& diagram = *persistenceInport_.getData();
+            auto maxIt = topology::isSortedByPersistence(diagram)
+                             ? (diagram.empty() ? diagram.end() : diagram.end() - 1)
+                             : std::max_element(diagram.begin(), diagram.end(),
+                                                [](const auto& a, const auto& b) {
+                                                    return std::get<4>(a) < std::get<4>(b);
+                                                });
+            if (maxIt != diagram.end()) {
                 threshold_.setMaxValue(std::get<4>(*maxIt));
             }
         }
@@ -82,35 +91,50 @@ TopologicalSimplification::TopologicalSimplification()
 }
 
 void TopologicalSimplification::process() {
-    // Save input and properties needed to calculate ttk contour tree to local variables
-    const auto inportData = inport_.getData();
-    const auto persistenceDiagram = persistenceInport_.getData();
+    if (inport_.isChanged() || persistenceInport_.isChanged()) {
+        updateHierarchy();
+    }
+    if (auto settings = InviwoApplication::getPtr()->getSettingsByType<topology::TTKSettings>()) {
+        results_.setCapacity(settings->resultCacheSize.get());
+    }
+
+    // Only the set of selected pairs matters, which does not change while the threshold moves
+    // between two persistence values
+    const auto& diagramData = *persistenceInport_.getData();
+    const auto split = static_cast<size_t>(
+        std::lower_bound(sortedPersistence_.begin(), sortedPersistence_.end(), threshold_.get()) -
+        sortedPersistence_.begin());
+    const uint64_t key = 2 * split + (invert_.get() ? 1 : 0);
+    if (key == currentKey_) return;
+    if (auto cached = results_.get(key)) {
+        currentKey_ = key;
+        outport_.setData(cached);
+        return;
+    }
+
+    // select most/least persistent critical point pairs
+    const auto begin = invert_.get() ? pairOrder_.begin() : pairOrder_.begin() + split;
+    const auto end = invert_.get() ? pairOrder_.begin() + split : pairOrder_.end();
+    std::vector<int> authorizedCriticalPoints;
+    authorizedCriticalPoints.reserve(2 * (end - begin));
+    for (auto it = begin; it != end; ++it) {
+        authorizedCriticalPoints.push_back(std::get<0>(diagramData[*it]));
+        authorizedCriticalPoints.push_back(std::get<2>(diagramData[*it]));
+    }
 
     using Result = std::shared_ptr<topology::TriangulationData>;
 
-    auto compute = [inportData, persistenceDiagram, threshold = threshold_.get(),
-                    invert = invert_.get()](pool::Stop stop, pool::Progress progress) -> Result {
+    auto compute = [inportData = inport_.getData(),
+                    authorizedCriticalPoints = std::move(authorizedCriticalPoints),
+                    policy = topology::threadPolicy()](pool::Stop stop,
+                                                       pool::Progress progress) -> Result {
         return inportData->getScalarValues()
             ->getEditableRepresentation<BufferRAM>()
             ->dispatch<std::shared_ptr<topology::TriangulationData>, dispatching::filter::Scalars>(
-                [inportData, &diagramData = *persistenceDiagram, threshold, invert, stop,
-                 progress](const auto buffer) -> Result {
+                [&](const auto buffer) -> Result {
                     if (stop) return nullptr;
                     using ValueType = util::PrecisionValueType<decltype(buffer)>;
 
-                    progress(0.1f);
-
-                    // select most/least persistent critical point pairs
-                    std::vector<int> authorizedCriticalPoints;
-                    for (int i = 0; i < (int)diagramData.size(); i++) {
-                        auto persistence = std::get<4>(diagramData[i]);
-                        if ((persistence >= threshold) != invert) {
-                            authorizedCriticalPoints.push_back(std::get<0>(diagramData[i]));
-                            authorizedCriticalPoints.push_back(std::get<2>(diagramData[i]));
-                        }
-                    }
-                    if (stop) return nullptr;
-
                     progress(0.2f);
 
                     // create a copy of the data values, nth component will be overwritten by
@@ -120,7 +144,9 @@ void TopologicalSimplification::process() {
                     std::vector<int> offsets(inportData->getOffsets());
                     if (!authorizedCriticalPoints.empty()) {
                         // perform topological simplification
+                        topology::TTKJob job{policy, "TopologicalSimplification"};
                         ttk::TopologicalSimplification simplification;
+                        simplification.setThreadNumber(job.threadCount());
                         simplification.setupTriangulation(
                             const_cast<ttk::Triangulation*>(&inportData->getTriangulation()));
                         simplification.setInputScalarFieldPointer(
@@ -131,7 +157,7 @@ void TopologicalSimplification::process() {
                         simplification.setConstraintNumber(
                             static_cast<int>(authorizedCriticalPoints.size()));
                         simplification.setVertexIdentifierScalarFieldPointer(
-                            authorizedCriticalPoints.data());
+                            const_cast<int*>(authorizedCriticalPoints.data()));
 
                         int retVal = simplification
                                          .execute<typename DataFormat<ValueType>::primitive, int>();
@@ -143,7 +169,8 @@ void TopologicalSimplification::process() {
 
                     progress(0.8f);
 
-                    // create a new triangulation based on the old one, but with new scalar values
+                    // create a new triangulation based on the old one, but with new scalar values.
+                    // The copy shares the triangulation of an implicit grid.
                     auto result = std::make_shared<topology::TriangulationData>(*inportData);
                     result->setScalarValues(util::makeBuffer(std::move(simplifiedDataValues)));
                     result->setOffsets(std::move(offsets));
@@ -155,10 +182,32 @@ void TopologicalSimplification::process() {
     };
 
     outport_.clear();
-    dispatchOne(compute, [this](Result result) {
+    currentKey_ = std::nullopt;
+    dispatchOne(compute, [this, key](Result result) {
+        if (result) {
+            results_.put(key, result);
+            currentKey_ = key;
+        }
         outport_.setData(result);
         newResults();
     });
 }
 
+void TopologicalSimplification::updateHierarchy() {
+    results_.clear();
+    currentKey_ = std::nullopt;
+
+    const auto& diagramData = *persistenceInport_.getData();
+    if (topology::isSortedByPersistence(diagramData)) {
+        pairOrder_.resize(diagramData.size());
+        std::iota(pairOrder_.begin(), pairOrder_.end(), size_t{0});
+    } else {
+        pairOrder_ = topology::persistenceOrder(diagramData);
+    }
+
+    sortedPersistence_.resize(pairOrder_.size());
+    std::transform(pairOrder_.begin(), pairOrder_.end(), sortedPersistence_.begin(),
+                   [&](size_t i) { return std::get<4>(diagramData[i]); });
+}
+
 }  // namespace inviwo
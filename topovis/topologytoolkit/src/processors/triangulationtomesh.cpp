@@ -49,6 +49,8 @@ TriangulationToMesh::TriangulationToMesh()
     , inport_("triangulation")
     , outport_("outport")
     , color_("color", "Mesh Color", vec4(1.0f), vec4(0.0f), vec4(1.0f))
+    , colorScalars_("colorScalars", "Map Scalars to Color", false)
+    , transferFunction_("transferFunction", "Transfer Function")
     , mapScalars_("mapScalars", "Map Scalars to Position", false)
     , component_("component", "Map to Component",
                  {{"componentX", "x component", 0},
@@ -62,9 +64,14 @@ TriangulationToMesh::TriangulationToMesh()
     color_.setSemantics(PropertySemantics::Color);
 
     addProperty(color_);
+    addProperty(colorScalars_);
+    addProperty(transferFunction_);
     addProperty(mapScalars_);
     addProperty(component_);
 
+    color_.visibilityDependsOn(colorScalars_, [](const auto& p) { return !p.get(); });
+    transferFunction_.visibilityDependsOn(colorScalars_, [](const auto& p) { return p.get(); });
+
     // scalar mapping is only available if input triangulation features scalars
     mapScalars_.setReadOnly(true);
     component_.setReadOnly(true);
@@ -82,11 +89,35 @@ TriangulationToMesh::TriangulationToMesh()
 }
 
 void TriangulationToMesh::process() {
-    // set output mesh
-    auto mesh = topology::ttkTriangulationToMesh(*inport_.getData().get(), color_.get(),
-                                                 mapScalars_.get(), component_.get());
+    const auto data = inport_.getData();
+    if (data->getPoints().empty()) {
+        data_.reset();
+        outport_.setData(std::make_shared<Mesh>());
+        return;
+    }
+
+    // Copies of a triangulation, e.g. the result of a topological simplification, share the
+    // geometry. Then only the buffers depending on the scalar values have to be updated.
+    const bool sameGeometry = data_ && data->sharesTriangulation(*data_);
+    const bool sameScalars = sameGeometry && data->getScalarValues() == data_->getScalarValues();
+
+    if (!sameGeometry) {
+        indices_ = topology::ttkTriangulationToIndices(*data);
+    }
+    if (!sameGeometry || (mapScalars_.get() && !sameScalars) || mapScalars_.isModified() ||
+        component_.isModified()) {
+        positions_ = topology::ttkTriangulationToPositions(*data, mapScalars_.get(),
+                                                           component_.get());
+    }
+    if (!sameGeometry || (colorScalars_.get() && !sameScalars) || colorScalars_.isModified() ||
+        color_.isModified() || transferFunction_.isModified()) {
+        colors_ = colorScalars_.get()
+                      ? topology::ttkTriangulationToColors(*data, transferFunction_.get())
+                      : topology::ttkTriangulationToColors(*data, color_.get());
+    }
+    data_ = data;
 
-    outport_.setData(mesh);
+    outport_.setData(topology::ttkTriangulationToMesh(*data, positions_, colors_, indices_));
 }
 
 }  // namespace inviwo
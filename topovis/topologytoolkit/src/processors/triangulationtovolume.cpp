@@ -43,14 +43,25 @@ const ProcessorInfo TriangulationToVolume::processorInfo_{
 const ProcessorInfo TriangulationToVolume::getProcessorInfo() const { return processorInfo_; }
 
 TriangulationToVolume::TriangulationToVolume()
-    : Processor(), inport_("triangulation"), outport_("outport") {
+    : Processor()
+    , inport_("triangulation")
+    , outport_("outport")
+    , resample_("resample", "Resample Uniform Grids", false)
+    , dimensions_("dimensions", "Dimensions", size3_t(64), size3_t(1), size3_t(1024))
+    , background_("background", "Background Value", 0.0, -1.0e6, 1.0e6) {
 
     addPort(inport_);
     addPort(outport_);
+
+    addProperties(resample_, dimensions_, background_);
 }
 
 void TriangulationToVolume::process() {
-    auto volume = topology::ttkTriangulationToVolume(*inport_.getData().get());
+    const auto& data = *inport_.getData();
+    auto volume =
+        data.isUniformGrid() && !resample_
+            ? topology::ttkTriangulationToVolume(data)
+            : topology::ttkTriangulationToVolume(data, dimensions_.get(), background_.get());
 
     outport_.setData(volume);
 }
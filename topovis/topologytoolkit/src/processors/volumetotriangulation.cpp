@@ -82,6 +82,10 @@ void VolumeToTriangulation::process() {
         *volumeInport_.getData().get(), static_cast<size_t>(channel_.get())));
 
     data->getTriangulation().setPeriodicBoundaryConditions(*usePBC_);
+    // keep the precondition data of the previous triangulation if only the scalars have changed
+    if (auto previous = outport_.getData()) {
+        data->shareTriangulation(*previous);
+    }
 
     outport_.setData(data);
 }
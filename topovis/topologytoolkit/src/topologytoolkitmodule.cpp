@@ -42,6 +42,7 @@
 #include <inviwo/topologytoolkit/processors/persistencediagram.h>
 #include <inviwo/topologytoolkit/processors/triangulationtovolume.h>
 #include <inviwo/topologytoolkit/processors/contourtree.h>
+#include <inviwo/topologytoolkit/processors/brickedpersistencediagram.h>
 #include <inviwo/topologytoolkit/properties/topologycolorsproperty.h>
 #include <inviwo/topologytoolkit/properties/topologyfilterproperty.h>
 
@@ -70,6 +71,7 @@ TopologyToolKitModule::TopologyToolKitModule(InviwoApplication* app)
     registerProcessor<PersistenceDiagram>();
     registerProcessor<TriangulationToVolume>();
     registerProcessor<ContourTree>();
+    registerProcessor<BrickedPersistenceDiagram>();
 
     registerProperty<TopologyColorsProperty>();
     registerProperty<TopologyFilterProperty>();
@@ -0,0 +1,529 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/topologytoolkit/utils/brickedpersistence.h>
+#include <inviwo/topologytoolkit/utils/ttkexception.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/glm.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <ttk/core/base/triangulation/Triangulation.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace inviwo {
+
+namespace topology {
+
+namespace {
+
+constexpr auto npos = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Vertex offsets of the neighbors of an interior vertex of an implicit ttk::Triangulation, which
+ * are the same for all vertices of a uniform grid.
+ */
+std::vector<ivec3> neighborStencil(const size3_t& dims) {
+    const ivec3 probe{dims.x > 1 ? 3 : 1, dims.y > 1 ? 3 : 1, dims.z > 1 ? 3 : 1};
+    const ivec3 center{probe / 2};
+
+    ttk::Triangulation triangulation;
+    triangulation.setInputGrid(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, probe.x, probe.y, probe.z);
+    triangulation.preprocessVertexNeighbors();
+
+    const ttk::SimplexId vertex = center.x + probe.x * (center.y + probe.y * center.z);
+    std::vector<ivec3> stencil;
+    for (ttk::SimplexId i = 0; i < triangulation.getVertexNeighborNumber(vertex); ++i) {
+        ttk::SimplexId neighbor = -1;
+        triangulation.getVertexNeighbor(vertex, i, neighbor);
+        const ivec3 pos{neighbor % probe.x, (neighbor / probe.x) % probe.y,
+                        neighbor / (probe.x * probe.y)};
+        stencil.push_back(pos - center);
+    }
+    return stencil;
+}
+
+/**
+ * Bricks of at most \p brickSize cells along each axis, neighboring bricks share a layer of
+ * vertices
+ */
+std::vector<std::pair<size3_t, size3_t>> makeBricks(const size3_t& dims, size_t brickSize) {
+    const auto count = [&](size_t dim) {
+        return dim > 1 ? (dim - 1 + brickSize - 1) / brickSize : size_t{1};
+    };
+    const auto extent = [&](size_t dim, size_t offset) {
+        return dim > 1 ? std::min(brickSize, dim - 1 - offset) + 1 : size_t{1};
+    };
+
+    std::vector<std::pair<size3_t, size3_t>> bricks;
+    for (size_t z = 0; z < count(dims.z); ++z) {
+        for (size_t y = 0; y < count(dims.y); ++y) {
+            for (size_t x = 0; x < count(dims.x); ++x) {
+                const size3_t offset{x * brickSize, y * brickSize, z * brickSize};
+                bricks.emplace_back(offset, size3_t{extent(dims.x, offset.x),
+                                                    extent(dims.y, offset.y),
+                                                    extent(dims.z, offset.z)});
+            }
+        }
+    }
+    return bricks;
+}
+
+uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+struct SweepPair {
+    uint32_t birth;
+    uint32_t death;
+    //! birth of the parent branch, npos if the parent is only known globally
+    uint32_t parent;
+    //! node whose component holds the parent branch, if the parent is only known globally
+    uint32_t parentNode;
+};
+
+struct SweepResult {
+    //! vertices kept in the reduced graph
+    std::vector<uint32_t> nodes;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<SweepPair> pairs;
+    //! births of the components alive at the end which never touched the boundary
+    std::vector<uint32_t> roots;
+};
+
+/**
+ * Union-find sweep over the vertices in \p order, which builds the branch decomposition of the
+ * merge tree. Once a component touches a boundary vertex, its connectivity is no longer known
+ * locally. Such components are instead recorded as a reduced graph over the boundary vertices,
+ * the saddles merging them and the births of their oldest branch. Pairs of components which
+ * never touch the boundary are final.
+ *
+ * @param order       vertices in sweep order
+ * @param neighbors   neighbors(v, callback) calls callback(u) for each neighbor u of v
+ * @param isBoundary  isBoundary(v) whether v is shared with other bricks
+ * @param visit       visit(v, birth) is called after v is added to the component born at birth
+ */
+template <typename Neighbors, typename IsBoundary, typename Visit>
+SweepResult sweep(const std::vector<uint32_t>& order, Neighbors&& neighbors,
+                  IsBoundary&& isBoundary, Visit&& visit) {
+    const auto n = order.size();
+    std::vector<uint32_t> rank(n);
+    for (size_t i = 0; i < n; ++i) rank[order[i]] = static_cast<uint32_t>(i);
+
+    std::vector<uint32_t> parent(n, npos);
+    std::vector<uint32_t> birth(n, npos);
+    std::vector<uint32_t> last(n, npos);
+    std::vector<char> touches(n, 0);
+
+    SweepResult res;
+    const auto addNode = [&](uint32_t v) {
+        res.nodes.push_back(v);
+        return static_cast<uint32_t>(res.nodes.size() - 1);
+    };
+
+    std::vector<uint32_t> roots;
+    for (const auto v : order) {
+        roots.clear();
+        neighbors(v, [&](uint32_t u) {
+            if (parent[u] == npos) return;
+            const auto root = findRoot(parent, u);
+            if (std::find(roots.begin(), roots.end(), root) == roots.end()) roots.push_back(root);
+        });
+        const bool boundary = isBoundary(v);
+
+        if (roots.empty()) {
+            parent[v] = v;
+            birth[v] = v;
+            touches[v] = boundary;
+            last[v] = boundary ? addNode(v) : npos;
+            visit(v, v);
+            continue;
+        }
+
+        std::sort(roots.begin(), roots.end(),
+                  [&](uint32_t a, uint32_t b) { return rank[birth[a]] < rank[birth[b]]; });
+        const auto oldest = roots.front();
+        const bool touching = boundary || std::any_of(roots.begin(), roots.end(),
+                                                      [&](uint32_t r) { return touches[r]; });
+
+        if (!touching || (roots.size() == 1 && !boundary)) {
+            // the component of v lies inside the brick, hence the younger branches end here
+            for (auto it = roots.begin() + 1; it != roots.end(); ++it) {
+                res.pairs.push_back({birth[*it], v, birth[oldest], npos});
+                parent[*it] = oldest;
+            }
+        } else {
+            const auto node = addNode(v);
+            for (const auto root : roots) {
+                if (touches[root]) {
+                    res.edges.emplace_back(last[root], node);
+                } else if (root == oldest) {
+                    res.edges.emplace_back(addNode(birth[root]), node);
+                } else {
+                    res.pairs.push_back({birth[root], v, npos, node});
+                }
+                if (root != oldest) parent[root] = oldest;
+            }
+            touches[oldest] = 1;
+            last[oldest] = node;
+        }
+        parent[v] = oldest;
+        visit(v, birth[oldest]);
+    }
+
+    for (uint32_t v = 0; v < n; ++v) {
+        if (parent[v] == v && !touches[v]) res.roots.push_back(birth[v]);
+    }
+    return res;
+}
+
+struct Pair {
+    ttk::SimplexId birth;
+    ttk::SimplexId death;
+    float birthValue;
+    float deathValue;
+    ttk::SimplexId parent;
+    uint32_t parentNode;
+};
+
+/**
+ * Reduced merge tree of a brick in terms of global vertex ids
+ */
+struct ReducedTree {
+    std::vector<ttk::SimplexId> nodes;
+    std::vector<float> nodeValues;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<Pair> pairs;
+};
+
+template <typename VertexId>
+ReducedTree reduce(SweepResult&& result, const std::vector<float>& values, VertexId&& vertexId) {
+    ReducedTree res;
+    // components which never touched the boundary are only left if the brick is the whole grid
+    for (const auto root : result.roots) result.nodes.push_back(root);
+
+    res.nodes.reserve(result.nodes.size());
+    res.nodeValues.reserve(result.nodes.size());
+    for (const auto v : result.nodes) {
+        res.nodes.push_back(vertexId(v));
+        res.nodeValues.push_back(values[v]);
+    }
+    res.edges = std::move(result.edges);
+    res.pairs.reserve(result.pairs.size());
+    for (const auto& p : result.pairs) {
+        res.pairs.push_back({vertexId(p.birth), vertexId(p.death), values[p.birth],
+                             values[p.death], p.parent == npos ? -1 : vertexId(p.parent),
+                             p.parentNode});
+    }
+    return res;
+}
+
+std::pair<ReducedTree, ReducedTree> processBrick(const size3_t& dims, const size3_t& offset,
+                                                 const size3_t& brickDims,
+                                                 const std::vector<ivec3>& stencil,
+                                                 const BrickReader& reader,
+                                                 std::vector<float>& values) {
+    reader(offset, brickDims, values);
+
+    const auto n = static_cast<uint32_t>(glm::compMul(brickDims));
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), uint32_t{0});
+    // vertex ids increase with the local index, which is therefore enough to break ties
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return values[a] < values[b] || (values[a] == values[b] && a < b);
+    });
+
+    const ivec3 bdims{brickDims};
+    const auto coord = [&](uint32_t v) {
+        const auto i = static_cast<int>(v);
+        return ivec3{i % bdims.x, (i / bdims.x) % bdims.y, i / (bdims.x * bdims.y)};
+    };
+    const auto neighbors = [&](uint32_t v, auto callback) {
+        const auto pos = coord(v);
+        for (const auto& o : stencil) {
+            const auto p = pos + o;
+            if (glm::any(glm::lessThan(p, ivec3{0})) || glm::any(glm::greaterThanEqual(p, bdims)))
+                continue;
+            callback(static_cast<uint32_t>(p.x + bdims.x * (p.y + bdims.y * p.z)));
+        }
+    };
+    const auto isBoundary = [&](uint32_t v) {
+        const size3_t pos{coord(v)};
+        for (size_t i = 0; i < 3; ++i) {
+            if ((pos[i] == 0 && offset[i] > 0) ||
+                (pos[i] + 1 == brickDims[i] && offset[i] + brickDims[i] < dims[i])) {
+                return true;
+            }
+        }
+        return false;
+    };
+    const auto vertexId = [&](uint32_t v) {
+        const auto pos = offset + size3_t{coord(v)};
+        return static_cast<ttk::SimplexId>(pos.x + dims.x * (pos.y + dims.y * pos.z));
+    };
+    const auto noVisit = [](uint32_t, uint32_t) {};
+
+    auto join = reduce(sweep(order, neighbors, isBoundary, noVisit), values, vertexId);
+    std::reverse(order.begin(), order.end());
+    auto split = reduce(sweep(order, neighbors, isBoundary, noVisit), values, vertexId);
+    return {std::move(join), std::move(split)};
+}
+
+/**
+ * Merge the reduced trees of all bricks by sweeping the graph given by their union. Returns the
+ * branches of all bricks and of the merged graph, the root branch is last.
+ */
+std::vector<MergeTreeBranch> mergeBricks(std::vector<ReducedTree>& trees, bool ascending) {
+    std::vector<size_t> base(trees.size() + 1, 0);
+    for (size_t i = 0; i < trees.size(); ++i) base[i + 1] = base[i] + trees[i].nodes.size();
+
+    // identify the boundary vertices shared between bricks
+    std::vector<ttk::SimplexId> ids(base.back());
+    std::vector<float> values(base.back());
+    for (size_t i = 0; i < trees.size(); ++i) {
+        std::copy(trees[i].nodes.begin(), trees[i].nodes.end(), ids.begin() + base[i]);
+        std::copy(trees[i].nodeValues.begin(), trees[i].nodeValues.end(),
+                  values.begin() + base[i]);
+        trees[i].nodes = {};
+        trees[i].nodeValues = {};
+    }
+    std::vector<uint32_t> sorted(ids.size());
+    std::iota(sorted.begin(), sorted.end(), uint32_t{0});
+    std::sort(sorted.begin(), sorted.end(),
+              [&](uint32_t a, uint32_t b) { return ids[a] < ids[b]; });
+
+    std::vector<uint32_t> unique(ids.size());
+    std::vector<ttk::SimplexId> nodes;
+    std::vector<float> nodeValues;
+    for (const auto i : sorted) {
+        if (nodes.empty() || nodes.back() != ids[i]) {
+            nodes.push_back(ids[i]);
+            nodeValues.push_back(values[i]);
+        }
+        unique[i] = static_cast<uint32_t>(nodes.size() - 1);
+    }
+    ids = {};
+    values = {};
+    sorted = {};
+
+    const auto n = nodes.size();
+    std::vector<uint32_t> adjacencyOffsets(n + 1, 0);
+    for (size_t i = 0; i < trees.size(); ++i) {
+        for (const auto& [a, b] : trees[i].edges) {
+            ++adjacencyOffsets[unique[base[i] + a] + 1];
+            ++adjacencyOffsets[unique[base[i] + b] + 1];
+        }
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+    std::vector<uint32_t> adjacency(adjacencyOffsets.back());
+    {
+        auto fill = adjacencyOffsets;
+        for (size_t i = 0; i < trees.size(); ++i) {
+            for (const auto& [a, b] : trees[i].edges) {
+                const auto ua = unique[base[i] + a];
+                const auto ub = unique[base[i] + b];
+                adjacency[fill[ua]++] = ub;
+                adjacency[fill[ub]++] = ua;
+            }
+            trees[i].edges = {};
+        }
+    }
+
+    // pairs whose parent branch is given by the component of a node at the time of the node
+    std::vector<MergeTreeBranch> branches;
+    std::vector<std::pair<uint32_t, size_t>> pending;
+    for (size_t i = 0; i < trees.size(); ++i) {
+        for (const auto& p : trees[i].pairs) {
+            if (p.parentNode != npos) {
+                pending.emplace_back(unique[base[i] + p.parentNode], branches.size());
+            }
+            branches.push_back({p.birth, p.death, p.birthValue, p.deathValue, p.parent});
+        }
+        trees[i].pairs = {};
+    }
+    std::sort(pending.begin(), pending.end());
+    unique = {};
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), uint32_t{0});
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (nodeValues[a] != nodeValues[b]) {
+            return ascending ? nodeValues[a] < nodeValues[b] : nodeValues[a] > nodeValues[b];
+        }
+        return ascending ? nodes[a] < nodes[b] : nodes[a] > nodes[b];
+    });
+
+    const auto neighbors = [&](uint32_t v, auto callback) {
+        for (auto i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1]; ++i) {
+            callback(adjacency[i]);
+        }
+    };
+    const auto visit = [&](uint32_t v, uint32_t birth) {
+        auto it = std::lower_bound(pending.begin(), pending.end(), std::make_pair(v, size_t{0}));
+        for (; it != pending.end() && it->first == v; ++it) {
+            branches[it->second].parent = nodes[birth];
+        }
+    };
+    auto res = sweep(order, neighbors, [](uint32_t) { return false; }, visit);
+
+    for (const auto& p : res.pairs) {
+        branches.push_back({nodes[p.birth], nodes[p.death], nodeValues[p.birth],
+                            nodeValues[p.death], nodes[p.parent]});
+    }
+    if (res.roots.size() != 1) {
+        throw TTKException("Grid is not connected", IVW_CONTEXT_CUSTOM("topology::mergeBricks"));
+    }
+    const auto root = res.roots.front();
+    branches.push_back({nodes[root], nodes[root], nodeValues[root], nodeValues[root], -1});
+    return branches;
+}
+
+}  // namespace
+
+BrickReader volumeBrickReader(std::shared_ptr<const Volume> volume, size_t channel) {
+    const auto* ram = volume->getRepresentation<VolumeRAM>();
+    return [volume, ram, channel](const size3_t& offset, const size3_t& dims,
+                                  std::vector<float>& values) {
+        values.resize(glm::compMul(dims));
+        ram->dispatch<void>([&](auto vrprecision) {
+            const auto data = vrprecision->getDataTyped();
+            const auto volDims = vrprecision->getDimensions();
+            for (size_t z = 0; z < dims.z; ++z) {
+                for (size_t y = 0; y < dims.y; ++y) {
+                    const auto src =
+                        data + offset.x + volDims.x * (offset.y + y + volDims.y * (offset.z + z));
+                    const auto dst = values.begin() + dims.x * (y + dims.y * z);
+                    std::transform(src, src + dims.x, dst, [channel](const auto& elem) {
+                        return static_cast<float>(util::glmcomp(elem, channel));
+                    });
+                }
+            }
+        });
+    };
+}
+
+BrickedPersistence brickedPersistence(const size3_t& dims, const BrickReader& reader,
+                                      size_t brickSize, int threads) {
+    if (brickSize == 0) {
+        throw TTKException("Brick size has to be positive",
+                           IVW_CONTEXT_CUSTOM("topology::brickedPersistence"));
+    }
+
+    const auto stencil = neighborStencil(dims);
+    const auto bricks = makeBricks(dims, brickSize);
+
+    std::vector<ReducedTree> joinTrees(bricks.size());
+    std::vector<ReducedTree> splitTrees(bricks.size());
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex mutex;
+    const auto worker = [&]() {
+        std::vector<float> values;
+        try {
+            for (size_t i = next++; i < bricks.size(); i = next++) {
+                std::tie(joinTrees[i], splitTrees[i]) = processBrick(
+                    dims, bricks[i].first, bricks[i].second, stencil, reader, values);
+            }
+        } catch (...) {
+            std::scoped_lock lock{mutex};
+            if (!error) error = std::current_exception();
+            next = bricks.size();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min<int>(threads, static_cast<int>(bricks.size())); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) thread.join();
+    if (error) std::rethrow_exception(error);
+
+    BrickedPersistence res;
+    res.joinTree = mergeBricks(joinTrees, true);
+    res.splitTree = mergeBricks(splitTrees, false);
+
+    // the root branches run from the global minimum to the global maximum and vice versa
+    auto& joinRoot = res.joinTree.back();
+    auto& splitRoot = res.splitTree.back();
+    joinRoot.death = splitRoot.birth;
+    joinRoot.deathValue = splitRoot.birthValue;
+    splitRoot.death = joinRoot.birth;
+    splitRoot.deathValue = joinRoot.birthValue;
+
+    const auto dimensionality = static_cast<ttk::SimplexId>(
+        glm::compAdd(size3_t{glm::greaterThan(dims, size3_t{1})}));
+    const auto splitSaddle =
+        dimensionality == 3 ? ttk::CriticalType::Saddle2 : ttk::CriticalType::Saddle1;
+
+    auto& diagram = res.diagram;
+    diagram.reserve(res.joinTree.size() + res.splitTree.size() - 1);
+    for (auto it = res.joinTree.begin(); it + 1 != res.joinTree.end(); ++it) {
+        diagram.emplace_back(it->birth, ttk::CriticalType::Local_minimum, it->death,
+                             ttk::CriticalType::Saddle1, it->deathValue - it->birthValue, 0);
+    }
+    for (auto it = res.splitTree.begin(); it + 1 != res.splitTree.end(); ++it) {
+        diagram.emplace_back(it->death, splitSaddle, it->birth, ttk::CriticalType::Local_maximum,
+                             it->birthValue - it->deathValue, dimensionality - 1);
+    }
+    diagram.emplace_back(joinRoot.birth, ttk::CriticalType::Local_minimum, joinRoot.death,
+                         ttk::CriticalType::Local_maximum,
+                         joinRoot.deathValue - joinRoot.birthValue, -1);
+
+    return res;
+}
+
+std::vector<MergeTreeBranch> simplifyBranches(const std::vector<MergeTreeBranch>& branches,
+                                              float threshold) {
+    std::vector<MergeTreeBranch> res;
+    std::copy_if(branches.begin(), branches.end(), std::back_inserter(res),
+                 [threshold](const MergeTreeBranch& b) {
+                     return b.parent == -1 || std::abs(b.deathValue - b.birthValue) >= threshold;
+                 });
+    return res;
+}
+
+}  // namespace topology
+
+}  // namespace inviwo
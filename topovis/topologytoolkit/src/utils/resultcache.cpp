@@ -0,0 +1,406 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/topologytoolkit/utils/resultcache.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace inviwo {
+
+namespace topology {
+
+ContentHash& ContentHash::add(const void* data, size_t bytes) {
+    const auto mix = [this](uint64_t word) {
+        word *= 0xff51afd7ed558ccdull;
+        word ^= word >> 33;
+        hash_ = (hash_ ^ word) * 1099511628211ull;
+    };
+
+    // hash 8 bytes at a time, the scalars of large volumes are hashed on every change
+    const auto ptr = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, ptr + i, sizeof(uint64_t));
+        mix(word);
+    }
+    if (i < bytes) {
+        uint64_t word = 0;
+        std::memcpy(&word, ptr + i, bytes - i);
+        mix(word ^ (static_cast<uint64_t>(bytes - i) << 56));
+    }
+    return *this;
+}
+
+uint64_t contentHash(const TriangulationData& data) {
+    ContentHash hash;
+    hash.add(data.isUniformGrid());
+    if (data.isUniformGrid()) {
+        hash.add(data.getGridDimensions()).add(data.getGridOrigin()).add(data.getGridExtent());
+    } else {
+        hash.add(data.getPoints()).add(data.getCells());
+    }
+    hash.add(data.getTriangulation().usesPeriodicBoundaryConditions());
+    hash.add(data.getOffsets());
+
+    if (auto scalars = data.getScalarValues()) {
+        const auto format = scalars->getDataFormat();
+        const auto ram = scalars->getRepresentation<BufferRAM>();
+        hash.add(format->getId()).add(ram->getSize());
+        hash.add(ram->getData(), ram->getSize() * format->getSize());
+    }
+    return hash.get();
+}
+
+namespace {
+
+template <typename T>
+size_t vectorBytes(const std::vector<T>& values) {
+    return values.size() * sizeof(T);
+}
+
+size_t bufferBytes(const std::shared_ptr<const BufferBase>& buffer) {
+    return buffer ? buffer->getSize() * buffer->getDataFormat()->getSize() : 0;
+}
+
+}  // namespace
+
+size_t memoryUsage(const TriangulationData& data) {
+    // a geometry shared with the input is counted as well
+    size_t bytes = vectorBytes(data.getCells()) + data.getVertexCount() * sizeof(int);
+    for (const auto& name : data.getScalarNames()) bytes += bufferBytes(data.getScalarValues(name));
+    return bytes;
+}
+
+size_t memoryUsage(const MorseSmaleComplexData& data) {
+    const auto& points = data.criticalPoints;
+    const auto& sepPoints = data.separatrixPoints;
+    const auto& sepCells = data.separatrixCells;
+    const auto& segmentation = data.segmentation;
+    return vectorBytes(points.points) + vectorBytes(points.cellDimensions) +
+           vectorBytes(points.cellIds) + vectorBytes(points.isOnBoundary) +
+           vectorBytes(points.PLVertexIdentifiers) + vectorBytes(points.manifoldSize) +
+           bufferBytes(points.scalars) + vectorBytes(sepPoints.points) +
+           vectorBytes(sepPoints.smoothingMask) + vectorBytes(sepPoints.cellDimensions) +
+           vectorBytes(sepPoints.cellIds) + vectorBytes(sepCells.cells) +
+           vectorBytes(sepCells.sourceIds) + vectorBytes(sepCells.destinationIds) +
+           vectorBytes(sepCells.separatrixIds) + vectorBytes(sepCells.types) +
+           vectorBytes(sepCells.isOnBoundary) + bufferBytes(sepCells.functionMaxima) +
+           bufferBytes(sepCells.functionMinima) + bufferBytes(sepCells.functionDiffs) +
+           vectorBytes(segmentation.ascending) + vectorBytes(segmentation.descending) +
+           vectorBytes(segmentation.msc);
+}
+
+size_t memoryUsage(const ContourTreeData& data) {
+    // the trees keep a few arrays of ids per vertex and per node, assume four of each
+    if (!data.tree) return 0;
+    const auto tree = data.getTree();
+    if (!tree) return 0;
+    return 4 * sizeof(ttk::SimplexId) *
+           static_cast<size_t>(tree->getNumberOfVertices() + tree->getNumberOfNodes());
+}
+
+size_t memoryUsage(const PersistenceDiagramData& data) { return vectorBytes(data); }
+
+size_t memoryUsage(const DataFrame& data) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < data.getNumberOfColumns(); ++i) {
+        bytes += bufferBytes(data.getColumn(i)->getBuffer());
+    }
+    return bytes;
+}
+
+namespace diskcache {
+
+namespace {
+
+constexpr uint32_t version = 1;
+constexpr char magic[8] = {'I', 'V', 'W', 'T', 'T', 'K', 'C', '\0'};
+
+enum class Kind : uint32_t { PersistenceDiagram = 0, MorseSmaleComplex = 1 };
+
+class Writer {
+public:
+    explicit Writer(const std::string& file) : file_{file}, out_{file + ".tmp", std::ios::binary} {
+        out_.write(magic, sizeof(magic));
+        value(version);
+        value(static_cast<uint32_t>(sizeof(ttk::SimplexId)));
+    }
+
+    template <typename T>
+    void value(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+        out_.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+    template <typename T>
+    void vector(const std::vector<T>& v) {
+        value(static_cast<uint64_t>(v.size()));
+        out_.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+    void buffer(const std::shared_ptr<BufferBase>& buffer) {
+        const auto ram = buffer->getRepresentation<BufferRAM>();
+        value(buffer->getDataFormat()->getId());
+        value(static_cast<uint64_t>(ram->getSize()));
+        out_.write(static_cast<const char*>(ram->getData()),
+                   ram->getSize() * buffer->getDataFormat()->getSize());
+    }
+
+    // move the temporary file into place so that readers never see a partial file
+    bool commit() {
+        out_.close();
+        if (!out_) {
+            std::remove((file_ + ".tmp").c_str());
+            return false;
+        }
+        std::remove(file_.c_str());
+        return std::rename((file_ + ".tmp").c_str(), file_.c_str()) == 0;
+    }
+
+private:
+    std::string file_;
+    std::ofstream out_;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::string& file) : in_{file, std::ios::binary} {
+        if (!in_) return;
+        in_.seekg(0, std::ios::end);
+        remaining_ = static_cast<uint64_t>(in_.tellg());
+        in_.seekg(0, std::ios::beg);
+
+        char fileMagic[sizeof(magic)] = {};
+        read(fileMagic, sizeof(fileMagic));
+        const auto fileVersion = value<uint32_t>();
+        const auto idSize = value<uint32_t>();
+        if (std::memcmp(fileMagic, magic, sizeof(magic)) != 0 || fileVersion != version ||
+            idSize != sizeof(ttk::SimplexId)) {
+            in_.setstate(std::ios::failbit);
+        }
+    }
+
+    explicit operator bool() const { return static_cast<bool>(in_); }
+
+    template <typename T>
+    T value() {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types");
+        T v{};
+        read(&v, sizeof(T));
+        return v;
+    }
+    template <typename T>
+    void vector(std::vector<T>& v) {
+        const auto size = value<uint64_t>();
+        if (!in_ || size > remaining_ / sizeof(T)) {
+            in_.setstate(std::ios::failbit);
+            return;
+        }
+        v.resize(size);
+        read(v.data(), size * sizeof(T));
+    }
+    template <typename T>
+    std::shared_ptr<BufferBase> buffer() {
+        const auto id = value<DataFormatId>();
+        auto ram = std::make_shared<BufferRAMPrecision<T>>();
+        if (id != DataFormat<T>::id()) in_.setstate(std::ios::failbit);
+        vector(ram->getDataContainer());
+        return std::make_shared<Buffer<T>>(ram);
+    }
+
+private:
+    void read(void* dst, uint64_t bytes) {
+        if (!in_ || bytes > remaining_) {
+            in_.setstate(std::ios::failbit);
+            return;
+        }
+        in_.read(static_cast<char*>(dst), bytes);
+        remaining_ -= bytes;
+    }
+
+    std::ifstream in_;
+    uint64_t remaining_ = 0;
+};
+
+}  // namespace
+
+std::string cacheDirectory() {
+    auto settings = InviwoApplication::getPtr()->getSettingsByType<TTKSettings>();
+    if (!settings || !settings->diskCache.get()) return {};
+    return settings->cacheDirectory.get();
+}
+
+std::string cacheFile(const std::string& directory, uint64_t key, const std::string& extension) {
+    if (directory.empty()) return {};
+    filesystem::createDirectoryRecursively(directory);
+    std::ostringstream ss;
+    ss << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << "."
+       << extension;
+    return ss.str();
+}
+
+bool write(const std::string& file, const PersistenceDiagramData& diagram) {
+    Writer out{file};
+    out.value(Kind::PersistenceDiagram);
+    out.value(static_cast<uint64_t>(diagram.size()));
+    for (const auto& pair : diagram) {
+        out.value(std::get<0>(pair));
+        out.value(std::get<1>(pair));
+        out.value(std::get<2>(pair));
+        out.value(std::get<3>(pair));
+        out.value(std::get<4>(pair));
+        out.value(std::get<5>(pair));
+    }
+    return out.commit();
+}
+
+std::shared_ptr<PersistenceDiagramData> readPersistenceDiagram(const std::string& file) {
+    Reader in{file};
+    if (!in || in.value<Kind>() != Kind::PersistenceDiagram) return nullptr;
+
+    auto diagram = std::make_shared<PersistenceDiagramData>();
+    const auto size = in.value<uint64_t>();
+    for (uint64_t i = 0; i < size && in; ++i) {
+        const auto v0 = in.value<ttk::SimplexId>();
+        const auto t0 = in.value<ttk::CriticalType>();
+        const auto v1 = in.value<ttk::SimplexId>();
+        const auto t1 = in.value<ttk::CriticalType>();
+        const auto persistence = in.value<float>();
+        const auto pairType = in.value<ttk::SimplexId>();
+        diagram->emplace_back(v0, t0, v1, t1, persistence, pairType);
+    }
+    return in ? diagram : nullptr;
+}
+
+bool write(const std::string& file, const MorseSmaleComplexData& msc) {
+    Writer out{file};
+    out.value(Kind::MorseSmaleComplex);
+
+    const auto& cp = msc.criticalPoints;
+    out.value(cp.numberOfPoints);
+    out.vector(cp.points);
+    out.vector(cp.cellDimensions);
+    out.vector(cp.cellIds);
+    out.vector(cp.isOnBoundary);
+    out.vector(cp.PLVertexIdentifiers);
+    out.vector(cp.manifoldSize);
+    out.buffer(cp.scalars);
+
+    const auto& sp = msc.separatrixPoints;
+    out.value(sp.numberOfPoints);
+    out.vector(sp.points);
+    out.vector(sp.smoothingMask);
+    out.vector(sp.cellDimensions);
+    out.vector(sp.cellIds);
+
+    const auto& sc = msc.separatrixCells;
+    out.value(sc.numberOfCells);
+    out.vector(sc.cells);
+    out.vector(sc.sourceIds);
+    out.vector(sc.destinationIds);
+    out.vector(sc.separatrixIds);
+    out.vector(sc.types);
+    out.vector(sc.isOnBoundary);
+    out.buffer(sc.functionMaxima);
+    out.buffer(sc.functionMinima);
+    out.buffer(sc.functionDiffs);
+
+    out.vector(msc.segmentation.ascending);
+    out.vector(msc.segmentation.descending);
+    out.vector(msc.segmentation.msc);
+
+    return out.commit();
+}
+
+std::shared_ptr<MorseSmaleComplexData> readMorseSmaleComplex(
+    const std::string& file, std::shared_ptr<const TriangulationData> triangulation) {
+    if (!triangulation || !triangulation->getScalarValues()) return nullptr;
+
+    Reader in{file};
+    if (!in || in.value<Kind>() != Kind::MorseSmaleComplex) return nullptr;
+
+    auto msc = std::make_shared<MorseSmaleComplexData>();
+    msc->triangulation = triangulation;
+
+    triangulation->getScalarValues()
+        ->getRepresentation<BufferRAM>()
+        ->dispatch<void, dispatching::filter::Scalars>([&](const auto buffer) {
+            using ValueType = util::PrecisionValueType<decltype(buffer)>;
+
+            auto& cp = msc->criticalPoints;
+            cp.numberOfPoints = in.template value<ttk::SimplexId>();
+            in.vector(cp.points);
+            in.vector(cp.cellDimensions);
+            in.vector(cp.cellIds);
+            in.vector(cp.isOnBoundary);
+            in.vector(cp.PLVertexIdentifiers);
+            in.vector(cp.manifoldSize);
+            cp.scalars = in.template buffer<ValueType>();
+
+            auto& sp = msc->separatrixPoints;
+            sp.numberOfPoints = in.template value<ttk::SimplexId>();
+            in.vector(sp.points);
+            in.vector(sp.smoothingMask);
+            in.vector(sp.cellDimensions);
+            in.vector(sp.cellIds);
+
+            auto& sc = msc->separatrixCells;
+            sc.numberOfCells = in.template value<ttk::SimplexId>();
+            in.vector(sc.cells);
+            in.vector(sc.sourceIds);
+            in.vector(sc.destinationIds);
+            in.vector(sc.separatrixIds);
+            in.vector(sc.types);
+            in.vector(sc.isOnBoundary);
+            sc.functionMaxima = in.template buffer<ValueType>();
+            sc.functionMinima = in.template buffer<ValueType>();
+            sc.functionDiffs = in.template buffer<ValueType>();
+
+            in.vector(msc->segmentation.ascending);
+            in.vector(msc->segmentation.descending);
+            in.vector(msc->segmentation.msc);
+        });
+
+    return in ? msc : nullptr;
+}
+
+}  // namespace diskcache
+
+}  // namespace topology
+
+}  // namespace inviwo
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/topologytoolkit/utils/settings.h>
+#include <inviwo/core/util/filesystem.h>
 #include <ttk/core/base/common/Debug.h>
 
 namespace inviwo {
@@ -36,9 +37,18 @@ namespace topology {
 
 TTKSettings::TTKSettings(InviwoApplication* app)
     : Settings("TTK Settings", app)
-    , globalLoglevel("globalLoglevel", "Global Loglevel", 0, 0, 5, 1) {
-
-    addProperties(globalLoglevel);
+    , globalLoglevel("globalLoglevel", "Global Loglevel", 0, 0, 5, 1)
+    , threadsPerJob("threadsPerJob", "Threads per TTK Job (0 = Automatic)", 0, 0, 256, 1)
+    , logTimingThreshold("logTimingThreshold", "Log TTK Jobs Longer Than (ms)", 500, 0, 600000,
+                         100)
+    , resultCacheSize("resultCacheSize", "Cached Results per Processor", 2, 0, 32, 1)
+    , diskCache("diskCache", "Cache Results on Disk", false)
+    , cacheDirectory("cacheDirectory", "Cache Directory",
+                     filesystem::getInviwoUserSettingsPath() + "/ttkcache") {
+
+    addProperties(globalLoglevel, threadsPerJob, logTimingThreshold, resultCacheSize, diskCache,
+                  cacheDirectory);
+    cacheDirectory.visibilityDependsOn(diskCache, [](const auto& p) { return p.get(); });
 
     globalLoglevel.onChange([&]() { ttk::globalDebugLevel_ = *globalLoglevel; });
 
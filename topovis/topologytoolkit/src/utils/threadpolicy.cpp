@@ -0,0 +1,101 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/settings.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace inviwo {
+
+namespace topology {
+
+namespace {
+
+std::atomic<int> runningJobs{0};
+
+std::mutex statisticsMutex;
+std::map<std::string, JobStatistics> statistics;
+
+}  // namespace
+
+ThreadPolicy threadPolicy() {
+    ThreadPolicy policy;
+    if (auto settings = InviwoApplication::getPtr()->getSettingsByType<TTKSettings>()) {
+        policy.threads = settings->threadsPerJob.get();
+        policy.logThreshold = std::chrono::milliseconds{settings->logTimingThreshold.get()};
+    }
+    return policy;
+}
+
+TTKJob::TTKJob(const ThreadPolicy& policy, std::string processor)
+    : policy_{policy}
+    , processor_{std::move(processor)}
+    , threads_{policy.threads}
+    , start_{std::chrono::steady_clock::now()} {
+    const int jobs = ++runningJobs;
+    if (threads_ <= 0) {
+        const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        threads_ = std::max(1, cores / jobs);
+    }
+}
+
+TTKJob::~TTKJob() {
+    --runningJobs;
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+
+    {
+        std::scoped_lock lock{statisticsMutex};
+        auto& stats = statistics[processor_];
+        ++stats.count;
+        stats.total += duration;
+        stats.max = std::max(stats.max, duration);
+        stats.threads = threads_;
+    }
+
+    if (duration >= policy_.logThreshold) {
+        LogInfoCustom(processor_, "TTK job took " << msToString(duration.count() * 1000.0)
+                                                  << " using " << threads_ << " threads");
+    }
+}
+
+std::map<std::string, JobStatistics> jobStatistics() {
+    std::scoped_lock lock{statisticsMutex};
+    return statistics;
+}
+
+}  // namespace topology
+
+}  // namespace inviwo
@@ -36,16 +36,24 @@
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/foreach.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <numeric>
 #include <inviwo/core/util/formats.h>
 
 namespace inviwo {
 
 namespace topology {
 
-TriangulationData meshToTTKTriangulation(const Mesh& mesh) {
-    auto buffers = mesh.getBuffers();
+namespace {
+
+std::vector<vec3> meshPositions(const Mesh& mesh) {
+    const auto& buffers = mesh.getBuffers();
     auto isPositionBuffer =
         [](const std::pair<Mesh::BufferInfo, std::shared_ptr<BufferBase>>& buffer) -> bool {
         return buffer.first.type == BufferType::PositionAttrib;
@@ -63,16 +71,37 @@ TriangulationData meshToTTKTriangulation(const Mesh& mesh) {
 
     // convert position buffer of input mesh to vec3
     auto bufferRAM = bufferIt->second->getRepresentation<BufferRAM>();
-    auto positions = bufferRAM->dispatch<std::vector<vec3>>([modelMatrix](auto posBuffer) {
-        auto data = posBuffer->getDataContainer();
+    return bufferRAM->dispatch<std::vector<vec3>>([modelMatrix](auto posBuffer) {
+        const auto& data = posBuffer->getDataContainer();
         std::vector<vec3> result(data.size());
-        std::transform(data.begin(), data.end(), result.begin(), [modelMatrix](auto& elem) {
-            auto v = util::glm_convert<vec3>(elem);
-            // apply model transform
-            return vec3(modelMatrix * vec4(v, 1.0f));
+        util::forEachRangeParallel(data.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+            std::transform(data.begin() + begin, data.begin() + end, result.begin() + begin,
+                           [modelMatrix](auto& elem) {
+                               auto v = util::glm_convert<vec3>(elem);
+                               // apply model transform
+                               return vec3(modelMatrix * vec4(v, 1.0f));
+                           });
         });
         return result;
     });
+}
+
+/**
+ * create the triangulation of \p mesh from \p positions, the vertex indices of the mesh are mapped
+ * through \p vertexMap unless it is empty
+ */
+TriangulationData meshToTriangulation(const Mesh& mesh, std::vector<vec3>&& positions,
+                                      const std::vector<uint32_t>& vertexMap) {
+    auto remap = [&](const std::vector<uint32_t>& indices) {
+        std::vector<uint32_t> result(indices.size());
+        util::forEachRangeParallel(
+            indices.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    result[i] = vertexMap[indices[i]];
+                }
+            });
+        return result;
+    };
 
     TriangulationData data;
 
@@ -84,17 +113,24 @@ TriangulationData meshToTTKTriangulation(const Mesh& mesh) {
         std::vector<uint32_t> indices(positions.size());
         std::iota(indices.begin(), indices.end(), 0);
 
-        data.set(std::move(positions), indices,
+        data.set(std::move(positions), vertexMap.empty() ? indices : vertexMap,
                  Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None));
     } else {
         data.set(std::move(positions), {},
                  Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None));
         // add each index buffer
         for (auto& indexElem : mesh.getIndexBuffers()) {
-            data.addIndices(indexElem.second->getRAMRepresentation()->getDataContainer(),
-                            indexElem.first);
+            const auto& indices = indexElem.second->getRAMRepresentation()->getDataContainer();
+            if (vertexMap.empty()) {
+                data.addIndices(indices, indexElem.first);
+            } else {
+                data.addIndices(remap(indices), indexElem.first);
+            }
         }
     }
+    if (!vertexMap.empty()) {
+        data.removeDegenerateCells();
+    }
 
     data.copyMetaDataFrom(mesh);
     data.setModelMatrix(mat4(1.0f));
@@ -103,93 +139,357 @@ TriangulationData meshToTTKTriangulation(const Mesh& mesh) {
     return data;
 }
 
-std::shared_ptr<Mesh> ttkTriangulationToMesh(const TriangulationData& data, const vec4& color,
-                                             bool applyScalars, size_t component) {
-    auto mesh = std::make_shared<Mesh>();
+}  // namespace
 
-    if (data.getPoints().empty()) {
-        return mesh;
+TriangulationData meshToTTKTriangulation(const Mesh& mesh) {
+    return meshToTriangulation(mesh, meshPositions(mesh), {});
+}
+
+TriangulationData meshToTTKTriangulation(const Mesh& mesh, float tolerance,
+                                         std::vector<uint32_t>& sourceVertices) {
+    auto positions = meshPositions(mesh);
+    const auto vertexMap = weldVertices(positions, tolerance);
+
+    // the first vertex mapped to each merged vertex is the one it was taken from
+    sourceVertices.assign(positions.size(), 0);
+    for (size_t i = vertexMap.size(); i-- > 0;) {
+        sourceVertices[vertexMap[i]] = static_cast<uint32_t>(i);
     }
 
-    std::vector<vec3> vertices(data.getPoints());  // make a copy
-    if (applyScalars && component < 3 && data.getScalarValues()) {
-        // overwrite vertex[component] with matching scalar value
-        data.getScalarValues()
-            ->getRepresentation<BufferRAM>()
-            ->dispatch<void, dispatching::filter::Scalars>([&vertices, component](auto bufferpr) {
-                auto& scalars = bufferpr->getDataContainer();
-                for (size_t i = 0; i < std::min(bufferpr->getSize(), vertices.size()); ++i) {
-                    vertices[i][component] = static_cast<float>(scalars[i]);
+    return meshToTriangulation(mesh, std::move(positions), vertexMap);
+}
+
+std::vector<uint32_t> weldVertices(std::vector<vec3>& points, float tolerance) {
+    const size_t size = points.size();
+
+    // grid cell of each vertex, exact matches compare the bit patterns of the positions
+    std::vector<ivec3> keys(size);
+    util::forEachRangeParallel(size, parallelGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (tolerance > 0.0f) {
+                const vec3 cell = glm::floor(points[i] / tolerance);
+                keys[i] = ivec3{glm::clamp(cell, vec3{-2.0e9f}, vec3{2.0e9f})};
+            } else {
+                // adding 0 turns -0 into +0
+                const vec3 p = points[i] + 0.0f;
+                std::memcpy(&keys[i], &p, sizeof(vec3));
+            }
+        }
+    });
+
+    auto hash = [&](const ivec3& k) {
+        uint64_t h = static_cast<uint32_t>(k.x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(k.y) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint32_t>(k.z) * 0x165667B19E3779F9ull;
+        return h ^ (h >> 29);
+    };
+
+    // distribute the vertices into shards by the hash of their cell, keeping their order
+    constexpr size_t numShards = 256;
+    std::vector<uint8_t> shards(size);
+    util::forEachRangeParallel(size, parallelGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            shards[i] = static_cast<uint8_t>(hash(keys[i]) >> 56);
+        }
+    });
+    std::array<size_t, numShards + 1> shardBegin{};
+    for (auto shard : shards) {
+        ++shardBegin[shard + 1];
+    }
+    std::partial_sum(shardBegin.begin(), shardBegin.end(), shardBegin.begin());
+    std::vector<uint32_t> order(size);
+    {
+        auto next = shardBegin;
+        for (size_t i = 0; i < size; ++i) {
+            order[next[shards[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // within each shard, map all vertices of a cell to the first one using a hash table with
+    // linear probing
+    std::vector<uint32_t> vertexMap(size);
+    util::forEachRangeParallel(numShards, 1, [&](size_t begin, size_t end) {
+        struct Entry {
+            ivec3 key;
+            uint32_t vertex;
+        };
+        constexpr uint32_t empty = std::numeric_limits<uint32_t>::max();
+        std::vector<Entry> table;
+        for (size_t shard = begin; shard < end; ++shard) {
+            const auto count = shardBegin[shard + 1] - shardBegin[shard];
+            size_t capacity = 16;
+            while (capacity < 2 * count) capacity *= 2;
+            table.assign(capacity, Entry{ivec3{0}, empty});
+
+            for (size_t j = shardBegin[shard]; j < shardBegin[shard + 1]; ++j) {
+                const auto vertex = order[j];
+                const auto& key = keys[vertex];
+                auto slot = static_cast<size_t>(hash(key)) & (capacity - 1);
+                while (table[slot].vertex != empty && table[slot].key != key) {
+                    slot = (slot + 1) & (capacity - 1);
                 }
-            });
+                if (table[slot].vertex == empty) table[slot] = Entry{key, vertex};
+                vertexMap[vertex] = table[slot].vertex;
+            }
+        }
+    });
+
+    // compact the vertices, the vertex a vertex maps to never comes after it
+    uint32_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (vertexMap[i] == i) {
+            points[count] = points[i];
+            vertexMap[i] = count++;
+        } else {
+            vertexMap[i] = vertexMap[vertexMap[i]];
+        }
     }
+    points.resize(count);
 
-    auto vertexRAM = std::make_shared<BufferRAMPrecision<vec3>>(std::move(vertices));
-    auto colorRAM = std::make_shared<BufferRAMPrecision<vec4>>();
-    colorRAM->getDataContainer().resize(data.getPoints().size(), color);
+    return vertexMap;
+}
 
-    mesh->addBuffer(Mesh::BufferInfo(BufferType::PositionAttrib),
-                    std::make_shared<Buffer<vec3>>(vertexRAM));
-    mesh->addBuffer(Mesh::BufferInfo(BufferType::ColorAttrib),
-                    std::make_shared<Buffer<vec4>>(colorRAM));
+std::shared_ptr<BufferBase> gatherScalars(const BufferBase& buffer, size_t component,
+                                          const std::vector<uint32_t>& indices) {
+    if (!indices.empty() &&
+        *std::max_element(indices.begin(), indices.end()) >= buffer.getSize()) {
+        throw TTKException("Too little data (" + std::to_string(buffer.getSize()) +
+                           " values given, but more vertices are referenced)");
+    }
 
-    // create index buffer(s)
-    std::vector<uint32_t> indicesLines;
-    std::vector<uint32_t> indicesTriangles;
+    return buffer.getRepresentation<BufferRAM>()->dispatch<std::shared_ptr<BufferBase>>(
+        [&](auto bufferpr) {
+            using ValueType = util::PrecisionValueType<decltype(bufferpr)>;
+            using PrimitiveType = typename DataFormat<ValueType>::primitive;
+
+            const auto& data = bufferpr->getDataContainer();
+            std::vector<PrimitiveType> scalarData(indices.size());
+            util::forEachRangeParallel(
+                indices.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        scalarData[i] = util::glmcomp(data[indices[i]], component);
+                    }
+                });
+            return util::makeBuffer<PrimitiveType>(std::move(scalarData));
+        });
+}
 
-    auto line = [&indicesLines](auto i1, auto i2) {
-        indicesLines.push_back(static_cast<uint32_t>(i1));
-        indicesLines.push_back(static_cast<uint32_t>(i2));
-    };
-    auto triangle = [&indicesTriangles](auto i1, auto i2, auto i3) {
-        indicesTriangles.push_back(static_cast<uint32_t>(i1));
-        indicesTriangles.push_back(static_cast<uint32_t>(i2));
-        indicesTriangles.push_back(static_cast<uint32_t>(i3));
-    };
+std::shared_ptr<Mesh> ttkTriangulationToMesh(const TriangulationData& data, const vec4& color,
+                                             bool applyScalars, size_t component) {
+    if (data.getPoints().empty()) {
+        return std::make_shared<Mesh>();
+    }
+    return ttkTriangulationToMesh(data, ttkTriangulationToPositions(data, applyScalars, component),
+                                  ttkTriangulationToColors(data, color),
+                                  ttkTriangulationToIndices(data));
+}
+
+std::shared_ptr<Mesh> ttkTriangulationToMesh(const TriangulationData& data,
+                                             std::shared_ptr<Buffer<vec3>> positions,
+                                             std::shared_ptr<Buffer<vec4>> colors,
+                                             const Mesh::IndexVector& indices) {
+    auto mesh = std::make_shared<Mesh>();
+    mesh->addBuffer(Mesh::BufferInfo(BufferType::PositionAttrib), positions);
+    mesh->addBuffer(Mesh::BufferInfo(BufferType::ColorAttrib), colors);
+    for (const auto& [meshInfo, indexBuffer] : indices) {
+        mesh->addIndices(meshInfo, indexBuffer);
+    }
+
+    mesh->setModelMatrix(data.getModelMatrix());
+    mesh->setWorldMatrix(data.getWorldMatrix());
+    mesh->copyMetaDataFrom(data);
+
+    return mesh;
+}
 
-    // loop over VTK index list
+Mesh::IndexVector ttkTriangulationToIndices(const TriangulationData& data) {
+    // VTK index list
     // <#indices in cell 1>, <v1_1>, ..., v1_n>, <#indices in cell 2>, <v2_1> ...
-    size_t invalid = 0;
     const auto& cells = data.getCells();
-    for (size_t i = 0; i < cells.size(); i += cells[i] + 1) {
-        const auto numIndices = cells[i];
 
+    // The start of each cell is only stored if the cells have different numbers of vertices,
+    // otherwise it follows from the common stride
+    const size_t stride = cells.empty() ? 0 : static_cast<size_t>(cells.front()) + 1;
+    bool uniform = stride > 1 && cells.size() % stride == 0;
+    if (uniform) {
+        std::atomic<bool> same{true};
+        util::forEachRangeParallel(
+            cells.size() / stride, parallelGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (static_cast<size_t>(cells[i * stride]) + 1 != stride) {
+                        same = false;
+                        return;
+                    }
+                }
+            });
+        uniform = same;
+    }
+    std::vector<size_t> starts;
+    if (!uniform) {
+        for (size_t i = 0; i < cells.size(); i += cells[i] + 1) {
+            starts.push_back(i);
+        }
+    }
+    const size_t numCells = uniform ? cells.size() / stride : starts.size();
+    auto cellStart = [&](size_t i) { return uniform ? i * stride : starts[i]; };
+
+    struct IndexCount {
+        size_t lines = 0;
+        size_t triangles = 0;
+        size_t invalid = 0;
+    };
+    auto count = [](IndexCount& c, long long int numIndices) {
         switch (numIndices) {
             case 2:  // edge
-                line(cells[i + 1], cells[i + 2]);
+                c.lines += 2;
                 break;
             case 3:  // triangle
-                triangle(cells[i + 1], cells[i + 2], cells[i + 3]);
+                c.triangles += 3;
                 break;
             case 4:  // tetrahedron
-                triangle(cells[i + 1], cells[i + 2], cells[i + 3]);
-                triangle(cells[i + 1], cells[i + 3], cells[i + 4]);
-                triangle(cells[i + 2], cells[i + 1], cells[i + 4]);
-                triangle(cells[i + 2], cells[i + 4], cells[i + 3]);
+                c.triangles += 12;
                 break;
             default:
-                ++invalid;
+                ++c.invalid;
         }
+    };
+
+    // count the indices of each chunk of cells, their prefix sum gives the output offsets
+    constexpr size_t grainSize = 1 << 16;
+    std::vector<IndexCount> offsets((numCells + grainSize - 1) / grainSize + 1);
+    util::forEachRangeParallel(numCells, grainSize, [&](size_t begin, size_t end) {
+        auto& c = offsets[begin / grainSize + 1];
+        for (size_t i = begin; i < end; ++i) count(c, cells[cellStart(i)]);
+    });
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i].lines += offsets[i - 1].lines;
+        offsets[i].triangles += offsets[i - 1].triangles;
+        offsets[i].invalid += offsets[i - 1].invalid;
     }
-    if (invalid > 0) {
+
+    std::vector<uint32_t> indicesLines(offsets.back().lines);
+    std::vector<uint32_t> indicesTriangles(offsets.back().triangles);
+    util::forEachRangeParallel(numCells, grainSize, [&](size_t begin, size_t end) {
+        auto line = indicesLines.begin() + offsets[begin / grainSize].lines;
+        auto triangle = indicesTriangles.begin() + offsets[begin / grainSize].triangles;
+        auto add = [](auto& it, std::initializer_list<long long int> vertices) {
+            for (auto v : vertices) *it++ = static_cast<uint32_t>(v);
+        };
+        for (size_t i = begin; i < end; ++i) {
+            const auto c = &cells[cellStart(i)];
+            switch (c[0]) {
+                case 2:  // edge
+                    add(line, {c[1], c[2]});
+                    break;
+                case 3:  // triangle
+                    add(triangle, {c[1], c[2], c[3]});
+                    break;
+                case 4:  // tetrahedron
+                    add(triangle, {c[1], c[2], c[3], c[1], c[3], c[4]});
+                    add(triangle, {c[2], c[1], c[4], c[2], c[4], c[3]});
+                    break;
+                default:
+                    break;
+            }
+        }
+    });
+
+    if (offsets.back().invalid > 0) {
         LogWarnCustom("topology::ttkTriangulationToMesh",
-                      "Triangulation contains " + std::to_string(invalid) + " invalid cells.");
+                      "Triangulation contains " + std::to_string(offsets.back().invalid) +
+                          " invalid cells.");
     }
 
+    Mesh::IndexVector indices;
     if (!indicesLines.empty()) {
-        mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
-                         util::makeIndexBuffer(std::move(indicesLines)));
+        indices.emplace_back(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                             util::makeIndexBuffer(std::move(indicesLines)));
     }
     if (!indicesTriangles.empty()) {
-        mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
-                         util::makeIndexBuffer(std::move(indicesTriangles)));
+        indices.emplace_back(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                             util::makeIndexBuffer(std::move(indicesTriangles)));
     }
+    return indices;
+}
 
-    mesh->setModelMatrix(data.getModelMatrix());
-    mesh->setWorldMatrix(data.getWorldMatrix());
-    mesh->copyMetaDataFrom(data);
+std::shared_ptr<Buffer<vec3>> ttkTriangulationToPositions(const TriangulationData& data,
+                                                          bool applyScalars, size_t component) {
+    const auto& points = data.getPoints();
+    auto positionRAM = std::make_shared<BufferRAMPrecision<vec3>>(points.size());
+    auto& positions = positionRAM->getDataContainer();
 
-    return mesh;
+    if (applyScalars && component < 3 && data.getScalarValues()) {
+        // overwrite vertex[component] with matching scalar value
+        data.getScalarValues()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<void, dispatching::filter::Scalars>([&](auto bufferpr) {
+                const auto& scalars = bufferpr->getDataContainer();
+                const size_t numScalars = std::min(scalars.size(), points.size());
+                util::forEachRangeParallel(
+                    points.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+                        std::copy(points.begin() + begin, points.begin() + end,
+                                  positions.begin() + begin);
+                        for (size_t i = begin; i < std::min(end, numScalars); ++i) {
+                            positions[i][component] = static_cast<float>(scalars[i]);
+                        }
+                    });
+            });
+    } else {
+        util::forEachRangeParallel(points.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+            std::copy(points.begin() + begin, points.begin() + end, positions.begin() + begin);
+        });
+    }
+    return std::make_shared<Buffer<vec3>>(positionRAM);
+}
+
+std::shared_ptr<Buffer<vec4>> ttkTriangulationToColors(const TriangulationData& data,
+                                                       const vec4& color) {
+    const size_t size = data.getPoints().size();
+    auto colorRAM = std::make_shared<BufferRAMPrecision<vec4>>(size);
+    auto colors = colorRAM->getDataContainer().begin();
+    util::forEachRangeParallel(size, parallelGrainSize, [&](size_t begin, size_t end) {
+        std::fill(colors + begin, colors + end, color);
+    });
+    return std::make_shared<Buffer<vec4>>(colorRAM);
+}
+
+std::shared_ptr<Buffer<vec4>> ttkTriangulationToColors(const TriangulationData& data,
+                                                       const TransferFunction& tf) {
+    const auto scalarValues = data.getScalarValues();
+    if (!scalarValues) {
+        return ttkTriangulationToColors(data, tf.sample(0.0));
+    }
+
+    // sample the transfer function once, the vertices then only look up their color
+    constexpr size_t tableSize = 1024;
+    std::vector<vec4> table(tableSize);
+    for (size_t i = 0; i < tableSize; ++i) {
+        table[i] = tf.sample(static_cast<double>(i) / (tableSize - 1));
+    }
+
+    const size_t size = data.getPoints().size();
+    auto colorRAM = std::make_shared<BufferRAMPrecision<vec4>>(size);
+    auto& colors = colorRAM->getDataContainer();
+    scalarValues->getRepresentation<BufferRAM>()->dispatch<void, dispatching::filter::Scalars>(
+        [&](auto bufferpr) {
+            const auto& scalars = bufferpr->getDataContainer();
+            const size_t numScalars = std::min(scalars.size(), size);
+            if (numScalars == 0) return;
+
+            const auto [minIt, maxIt] =
+                std::minmax_element(scalars.begin(), scalars.begin() + numScalars);
+            const double min = static_cast<double>(*minIt);
+            const double range = static_cast<double>(*maxIt) - min;
+            const double scale = range > 0.0 ? (tableSize - 1) / range : 0.0;
+
+            util::forEachRangeParallel(size, parallelGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const double v = i < numScalars ? static_cast<double>(scalars[i]) : min;
+                    colors[i] = table[static_cast<size_t>((v - min) * scale + 0.5)];
+                }
+            });
+        });
+    return std::make_shared<Buffer<vec4>>(colorRAM);
 }
 
 TriangulationData volumeToTTKTriangulation(const Volume& volume, size_t channel) {
@@ -205,12 +505,24 @@ TriangulationData volumeToTTKTriangulation(const Volume& volume, size_t channel)
         using PrimitiveType = typename DataFormat<ValueType>::primitive;
 
         auto volData = vrprecision->getDataTyped();
-        const size_t volSize = glm::compMul(vrprecision->getDimensions());
-
-        std::vector<PrimitiveType> scalarData(volSize);
-        std::transform(volData, volData + volSize, scalarData.begin(),
-                       [channel](auto elem) { return util::glmcomp(elem, channel); });
-        data.setScalarValues(util::makeBuffer<PrimitiveType>(std::move(scalarData)));
+        const auto dims = vrprecision->getDimensions();
+        const size_t volSize = glm::compMul(dims);
+
+        if constexpr (util::rank<ValueType>::value == 0) {
+            data.setScalarValues(util::makeBuffer<PrimitiveType>(
+                std::vector<PrimitiveType>(volData, volData + volSize)));
+        } else {
+            // extract the channel slice by slice in parallel
+            std::vector<PrimitiveType> scalarData(volSize);
+            const size_t sliceSize = dims.x * dims.y;
+            std::vector<size_t> slices(dims.z);
+            util::forEachParallel(slices, [&](size_t, size_t z) {
+                const auto begin = volData + z * sliceSize;
+                std::transform(begin, begin + sliceSize, scalarData.begin() + z * sliceSize,
+                               [channel](auto elem) { return util::glmcomp(elem, channel); });
+            });
+            data.setScalarValues(util::makeBuffer<PrimitiveType>(std::move(scalarData)));
+        }
     };
 
     volume.getRepresentation<VolumeRAM>()->dispatch<void>(convertVolumeToBuffer, channel);
@@ -222,6 +534,163 @@ TriangulationData volumeToTTKTriangulation(const Volume& volume, size_t channel)
     return data;
 }
 
+namespace {
+
+/**
+ * Bounding volume hierarchy over axis-aligned boxes, e.g. the bounding boxes of cells. Nodes are
+ * split at the median of the box centers along their longest axis.
+ */
+class BoxHierarchy {
+public:
+    BoxHierarchy(std::vector<vec3> boxMin, std::vector<vec3> boxMax)
+        : boxMin_{std::move(boxMin)}, boxMax_{std::move(boxMax)}, boxes_(boxMin_.size()) {
+        std::iota(boxes_.begin(), boxes_.end(), uint32_t{0});
+        build();
+    }
+
+    /**
+     * call \p callback(box) for each box containing \p p until it returns true
+     */
+    template <typename Callback>
+    void query(const vec3& p, Callback&& callback) const {
+        if (nodes_.empty()) return;
+        // the depth of the tree is logarithmic due to the median split
+        std::array<uint32_t, 64> stack;
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const auto& node = nodes_[stack[--top]];
+            if (!contains(node.min, node.max, p)) continue;
+            if (node.count > 0) {
+                for (auto i = node.first; i < node.first + node.count; ++i) {
+                    const auto box = boxes_[i];
+                    if (contains(boxMin_[box], boxMax_[box], p) && callback(box)) return;
+                }
+            } else {
+                stack[top++] = node.first + 1;
+                stack[top++] = node.first;
+            }
+        }
+    }
+
+private:
+    struct Node {
+        vec3 min;
+        vec3 max;
+        uint32_t first;  //!< first box of a leaf, or the left child followed by the right one
+        uint32_t count;  //!< number of boxes of a leaf, 0 for inner nodes
+    };
+    static constexpr uint32_t leafSize = 8;
+
+    static bool contains(const vec3& min, const vec3& max, const vec3& p) {
+        return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y &&
+               p.z <= max.z;
+    }
+
+    void build() {
+        if (boxes_.empty()) return;
+
+        struct Range {
+            uint32_t node;
+            uint32_t begin;
+            uint32_t end;
+        };
+        std::vector<Range> todo{{0, 0, static_cast<uint32_t>(boxes_.size())}};
+        nodes_.emplace_back();
+        while (!todo.empty()) {
+            const auto range = todo.back();
+            todo.pop_back();
+
+            Node node{vec3{std::numeric_limits<float>::max()},
+                      vec3{std::numeric_limits<float>::lowest()}, range.begin,
+                      range.end - range.begin};
+            vec3 centerMin{std::numeric_limits<float>::max()};
+            vec3 centerMax{std::numeric_limits<float>::lowest()};
+            for (auto i = range.begin; i < range.end; ++i) {
+                node.min = glm::min(node.min, boxMin_[boxes_[i]]);
+                node.max = glm::max(node.max, boxMax_[boxes_[i]]);
+                const auto c = center(boxes_[i]);
+                centerMin = glm::min(centerMin, c);
+                centerMax = glm::max(centerMax, c);
+            }
+
+            const auto extent = centerMax - centerMin;
+            const int axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2)
+                                                   : (extent.y >= extent.z ? 1 : 2);
+            // keep a leaf if it is small enough or cannot be split further
+            if (node.count > leafSize && extent[axis] > 0.0f) {
+                const auto mid = range.begin + node.count / 2;
+                std::nth_element(boxes_.begin() + range.begin, boxes_.begin() + mid,
+                                 boxes_.begin() + range.end, [&](uint32_t a, uint32_t b) {
+                                     return center(a)[axis] < center(b)[axis];
+                                 });
+                node.first = static_cast<uint32_t>(nodes_.size());
+                node.count = 0;
+                nodes_.emplace_back();
+                nodes_.emplace_back();
+                todo.push_back({node.first, range.begin, mid});
+                todo.push_back({node.first + 1, mid, range.end});
+            }
+            nodes_[range.node] = node;
+        }
+    }
+
+    vec3 center(uint32_t box) const { return 0.5f * (boxMin_[box] + boxMax_[box]); }
+
+    std::vector<vec3> boxMin_;
+    std::vector<vec3> boxMax_;
+    std::vector<uint32_t> boxes_;
+    std::vector<Node> nodes_;
+};
+
+/**
+ * barycentric coordinates of the point on triangle \p a, \p b, \p c closest to \p p, see
+ * C. Ericson, Real-Time Collision Detection, 2005, section 5.1.5
+ */
+vec3 closestPointOnTriangle(const vec3& p, const vec3& a, const vec3& b, const vec3& c) {
+    const vec3 ab = b - a;
+    const vec3 ac = c - a;
+    const vec3 ap = p - a;
+    const float d1 = glm::dot(ab, ap);
+    const float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return vec3{1.0f, 0.0f, 0.0f};
+
+    const vec3 bp = p - b;
+    const float d3 = glm::dot(ab, bp);
+    const float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return vec3{0.0f, 1.0f, 0.0f};
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        const float v = d1 / (d1 - d3);
+        return vec3{1.0f - v, v, 0.0f};
+    }
+
+    const vec3 cp = p - c;
+    const float d5 = glm::dot(ab, cp);
+    const float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return vec3{0.0f, 0.0f, 1.0f};
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        const float w = d2 / (d2 - d6);
+        return vec3{1.0f - w, 0.0f, w};
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return vec3{0.0f, 1.0f - w, w};
+    }
+
+    const float denom = 1.0f / (va + vb + vc);
+    const float v = vb * denom;
+    const float w = vc * denom;
+    return vec3{1.0f - v - w, v, w};
+}
+
+}  // namespace
+
 std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data) {
     if (!data.isUniformGrid()) {
         throw TTKConversionException(
@@ -248,8 +717,12 @@ std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data)
         auto volumeRep =
             std::make_shared<VolumeRAMPrecision<PrimitiveType>>(data.getGridDimensions());
         // fill volume with the scalar data of the triangulation
-        std::copy(bufferpr->getDataContainer().begin(), bufferpr->getDataContainer().end(),
-                  volumeRep->getDataTyped());
+        const auto& values = bufferpr->getDataContainer();
+        auto dst = volumeRep->getDataTyped();
+        const auto size = std::min(values.size(), glm::compMul(volumeRep->getDimensions()));
+        util::forEachRangeParallel(size, parallelGrainSize, [&](size_t begin, size_t end) {
+            std::copy(values.begin() + begin, values.begin() + end, dst + begin);
+        });
 
         // create volume and set basis and offset
         auto volume = std::make_shared<Volume>(volumeRep);
@@ -265,6 +738,234 @@ std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data)
         ->dispatch<std::shared_ptr<Volume>, dispatching::filter::Scalars>(createVolume);
 }
 
+std::shared_ptr<Volume> ttkTriangulationToVolume(const TriangulationData& data,
+                                                 const size3_t& dims, double background) {
+    if (glm::compMul(dims) == 0) {
+        throw TTKConversionException("Invalid volume dimensions.");
+    }
+
+    const auto& points = data.getPoints();
+    const auto& cellList = data.getCells();
+    // triangles only use the first three vertices
+    std::vector<std::array<uint32_t, 4>> tetrahedra;
+    std::vector<std::array<uint32_t, 4>> triangles;
+    for (size_t i = 0; i < cellList.size(); i += cellList[i] + 1) {
+        auto v = [&](size_t j) { return static_cast<uint32_t>(cellList[i + j]); };
+        if (cellList[i] == 4) {
+            tetrahedra.push_back({v(1), v(2), v(3), v(4)});
+        } else if (cellList[i] == 3) {
+            triangles.push_back({v(1), v(2), v(3), 0});
+        }
+    }
+    if (tetrahedra.empty() && triangles.empty()) {
+        throw TTKConversionException("Triangulation contains neither triangles nor tetrahedra.");
+    }
+
+    vec3 origin{std::numeric_limits<float>::max()};
+    vec3 extent{std::numeric_limits<float>::lowest()};
+    for (auto& p : points) {
+        origin = glm::min(origin, p);
+        extent = glm::max(extent, p);
+    }
+    extent -= origin;
+    // flat triangulations get a thin volume
+    extent = glm::max(extent, vec3{std::max(glm::compMax(extent), 1.0f) * 1.0e-3f});
+    const vec3 spacing = extent / vec3{dims};
+
+    auto volumeRep = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto volume = std::make_shared<Volume>(volumeRep);
+    volume->setBasis(mat3{vec3{extent.x, 0.0f, 0.0f}, vec3{0.0f, extent.y, 0.0f},
+                          vec3{0.0f, 0.0f, extent.z}});
+    volume->setOffset(origin);
+    volume->setModelMatrix(data.getModelMatrix() * volume->getModelMatrix());
+    volume->setWorldMatrix(data.getWorldMatrix());
+    volume->copyMetaDataFrom(data);
+
+    if (!data.getScalarValues()) {
+        LogWarnCustom("topology::ttkTriangulationToVolume",
+                      "Triangulation contains no scalar values. Creating empty volume.");
+        return volume;
+    }
+
+    const auto scalars =
+        data.getScalarValues()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<std::vector<float>, dispatching::filter::Scalars>([](auto bufferpr) {
+                auto& values = bufferpr->getDataContainer();
+                std::vector<float> result(values.size());
+                std::transform(values.begin(), values.end(), result.begin(),
+                               [](auto v) { return static_cast<float>(v); });
+                return result;
+            });
+    const auto [minValue, maxValue] = std::minmax_element(scalars.begin(), scalars.end());
+    if (minValue != scalars.end()) {
+        volume->dataMap_.dataRange = dvec2{*minValue, *maxValue};
+        volume->dataMap_.valueRange = volume->dataMap_.dataRange;
+    }
+
+    const auto bg = static_cast<float>(background);
+    auto dst = volumeRep->getDataTyped();
+    auto resample = [&](auto sample) {
+        util::forEachRangeParallel(
+            glm::compMul(dims), size_t{1} << 12, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const size3_t index{i % dims.x, (i / dims.x) % dims.y, i / (dims.x * dims.y)};
+                    dst[i] = sample(origin + (vec3{index} + 0.5f) * spacing);
+                }
+            });
+    };
+
+    if (!tetrahedra.empty()) {
+        // map into the barycentric coordinates of each tetrahedron, degenerate ones are skipped
+        std::vector<mat3> toBarycentric;
+        std::vector<vec3> boxMin;
+        std::vector<vec3> boxMax;
+        size_t count = 0;
+        for (const auto& t : tetrahedra) {
+            const vec3 a = points[t[0]];
+            const mat3 m{points[t[1]] - a, points[t[2]] - a, points[t[3]] - a};
+            if (glm::determinant(m) == 0.0f) continue;
+            tetrahedra[count++] = t;
+            toBarycentric.push_back(glm::inverse(m));
+            const vec3 &b = points[t[1]], &c = points[t[2]], &d = points[t[3]];
+            boxMin.push_back(glm::min(glm::min(a, b), glm::min(c, d)));
+            boxMax.push_back(glm::max(glm::max(a, b), glm::max(c, d)));
+        }
+        tetrahedra.resize(count);
+        const BoxHierarchy bvh{std::move(boxMin), std::move(boxMax)};
+
+        constexpr float eps = 1.0e-5f;
+        resample([&](const vec3& p) {
+            float value = bg;
+            bvh.query(p, [&](uint32_t cell) {
+                const auto& t = tetrahedra[cell];
+                const vec3 l = toBarycentric[cell] * (p - points[t[0]]);
+                const float l0 = 1.0f - l.x - l.y - l.z;
+                if (glm::compMin(l) < -eps || l0 < -eps) return false;
+                value = l0 * scalars[t[0]] + l.x * scalars[t[1]] + l.y * scalars[t[2]] +
+                        l.z * scalars[t[3]];
+                return true;
+            });
+            return value;
+        });
+    } else {
+        // voxels within half a voxel diagonal of the surface are covered, degenerate triangles
+        // are skipped
+        const float radius = 0.5f * glm::length(spacing);
+        std::vector<vec3> boxMin;
+        std::vector<vec3> boxMax;
+        size_t count = 0;
+        for (const auto& t : triangles) {
+            const vec3 &a = points[t[0]], &b = points[t[1]], &c = points[t[2]];
+            const vec3 n = glm::cross(b - a, c - a);
+            if (glm::dot(n, n) == 0.0f) continue;
+            triangles[count++] = t;
+            boxMin.push_back(glm::min(glm::min(a, b), c) - radius);
+            boxMax.push_back(glm::max(glm::max(a, b), c) + radius);
+        }
+        triangles.resize(count);
+        const BoxHierarchy bvh{std::move(boxMin), std::move(boxMax)};
+
+        resample([&](const vec3& p) {
+            float value = bg;
+            float minDist2 = radius * radius;
+            bvh.query(p, [&](uint32_t cell) {
+                const auto& t = triangles[cell];
+                const vec3 &a = points[t[0]], &b = points[t[1]], &c = points[t[2]];
+                const vec3 l = closestPointOnTriangle(p, a, b, c);
+                const vec3 d = p - (l.x * a + l.y * b + l.z * c);
+                const float dist2 = glm::dot(d, d);
+                if (dist2 <= minDist2) {
+                    minDist2 = dist2;
+                    value = l.x * scalars[t[0]] + l.y * scalars[t[1]] + l.z * scalars[t[2]];
+                }
+                return false;
+            });
+            return value;
+        });
+    }
+
+    return volume;
+}
+
+std::shared_ptr<const TriangulationData> selectScalarValues(
+    std::shared_ptr<const TriangulationData> data, const std::string& name) {
+    if (!data || name.empty() || name == data->getSelectedScalarName() ||
+        !data->hasScalarValues(name)) {
+        return data;
+    }
+    auto selected = std::make_shared<TriangulationData>(*data);
+    selected->selectScalarValues(name);
+    return selected;
+}
+
+void preparePointLineMesh(std::shared_ptr<Mesh>& mesh, bool picking) {
+    // the outport holds the other reference
+    if (mesh && mesh.use_count() <= 2 && mesh->getNumberOfBuffers() == (picking ? 4u : 3u)) {
+        return;
+    }
+
+    mesh = std::make_shared<Mesh>(DrawType::Points, ConnectivityType::None);
+    mesh->addBuffer(BufferType::PositionAttrib, std::make_shared<Buffer<vec3>>());
+    mesh->addBuffer(BufferType::ColorAttrib, std::make_shared<Buffer<vec4>>());
+    mesh->addBuffer(BufferType::RadiiAttrib, std::make_shared<Buffer<float>>());
+    if (picking) {
+        mesh->addBuffer(BufferType::PickingAttrib, std::make_shared<Buffer<uint32_t>>());
+    }
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Points, ConnectivityType::None),
+                     std::make_shared<IndexBuffer>());
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                     std::make_shared<IndexBuffer>());
+}
+
+std::vector<uint32_t>& meshIndexData(Mesh& mesh, size_t index, size_t size) {
+    auto& data = mesh.getIndices(index)->getEditableRAMRepresentation()->getDataContainer();
+    data.resize(size);
+    return data;
+}
+
+std::vector<size_t> persistenceOrder(const PersistenceDiagramData& diagram) {
+    std::vector<size_t> order(diagram.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+
+    const auto less = [&](size_t a, size_t b) {
+        const auto pa = std::get<4>(diagram[a]);
+        const auto pb = std::get<4>(diagram[b]);
+        return pa < pb || (pa == pb && a < b);
+    };
+
+    // sort chunks in parallel, then merge neighboring runs of twice the width in each round
+    constexpr size_t grainSize = 1 << 16;
+    util::forEachRangeParallel(order.size(), grainSize, [&](size_t begin, size_t end) {
+        std::sort(order.begin() + begin, order.begin() + end, less);
+    });
+    for (size_t width = grainSize; width < order.size(); width *= 2) {
+        util::forEachRangeParallel(order.size(), 2 * width, [&](size_t begin, size_t end) {
+            const auto mid = std::min(begin + width, end);
+            std::inplace_merge(order.begin() + begin, order.begin() + mid,
+                               order.begin() + end, less);
+        });
+    }
+    return order;
+}
+
+bool isSortedByPersistence(const PersistenceDiagramData& diagram) {
+    return std::is_sorted(diagram.begin(), diagram.end(), [](const auto& a, const auto& b) {
+        return std::get<4>(a) < std::get<4>(b);
+    });
+}
+
+void sortByPersistence(PersistenceDiagramData& diagram) {
+    if (isSortedByPersistence(diagram)) return;
+
+    const auto order = persistenceOrder(diagram);
+    PersistenceDiagramData sorted(diagram.size());
+    util::forEachRangeParallel(sorted.size(), parallelGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) sorted[i] = diagram[order[i]];
+    });
+    diagram = std::move(sorted);
+}
+
 }  // namespace topology
 
 }  // namespace inviwo
@@ -0,0 +1,489 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/datareaderfactory.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/logcentral.h>
+#include <modules/base/basemodulesharedlibrary.h>
+#include <inviwo/topologytoolkit/datastructures/contourtreedata.h>
+#include <inviwo/topologytoolkit/datastructures/morsesmalecomplexdata.h>
+#include <inviwo/topologytoolkit/datastructures/triangulationdata.h>
+#include <inviwo/topologytoolkit/utils/brickedpersistence.h>
+#include <inviwo/topologytoolkit/utils/ttkexception.h>
+#include <inviwo/topologytoolkit/utils/threadpolicy.h>
+#include <inviwo/topologytoolkit/utils/ttkutils.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <ttk/core/base/ftmTree/FTMTree_MT.h>
+#include <ttk/core/base/morseSmaleComplex/MorseSmaleComplex.h>
+#include <ttk/core/base/persistenceDiagram/PersistenceDiagram.h>
+#include <ttk/core/base/topologicalSimplification/TopologicalSimplification.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <numeric>
+#include <random>
+#include <thread>
+
+/*
+ * Scaling of the TTK algorithms behind the ContourTree, MorseSmaleComplex, PersistenceDiagram,
+ * and TopologicalSimplification processors, the bricked persistence diagram, and the conversions
+ * between volumes, meshes, and triangulations. The algorithms are set up the same way as in the
+ * processors. The arguments are the grid size along each axis and the number of threads (0 splits
+ * all hardware threads like the default TTK settings). Together with --benchmark_out the results
+ * give the scaling curves over grid size and thread count.
+ *
+ * The volume benchmarks run on synthetic scalar fields with many critical points of varying
+ * persistence. A real volume can be used instead, by setting the environment variable
+ * IVW_TTK_BENCHMARK_VOLUME to a volume file readable by the base module. The grids of increasing
+ * size are then cropped from the center of its first channel. The surface benchmarks use height
+ * fields like the morse-smale2d regression workspace.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+using DiagramOutput = std::vector<std::tuple<ttk::SimplexId, ttk::CriticalType, ttk::SimplexId,
+                                             ttk::CriticalType, float, ttk::SimplexId>>;
+
+// smooth waves with some noise, giving both persistent and noisy critical points
+float syntheticValue(const vec3& p, std::mt19937& rand) {
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    return std::sin(12.0f * p.x) * std::cos(9.0f * p.y) + 0.5f * std::sin(7.0f * (p.y + p.z)) +
+           0.25f * std::cos(23.0f * p.x * p.z) + noise(rand);
+}
+
+std::shared_ptr<Volume> syntheticVolume(const size3_t& dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    std::mt19937 rand(static_cast<unsigned int>(dims.x));
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const vec3 p = vec3(x, y, z) / vec3(glm::max(dims, size3_t{2}) - size3_t{1});
+                data[x + dims.x * (y + dims.y * z)] = syntheticValue(p, rand);
+            }
+        }
+    }
+    return std::make_shared<Volume>(ram);
+}
+
+// Returns the volume set by IVW_TTK_BENCHMARK_VOLUME, loaded on first use
+std::shared_ptr<const Volume> realVolume() {
+    static std::shared_ptr<const Volume> volume = []() -> std::shared_ptr<const Volume> {
+        const char* file = std::getenv("IVW_TTK_BENCHMARK_VOLUME");
+        if (!file) return nullptr;
+        auto factory = InviwoApplication::getPtr()->getDataReaderFactory();
+        auto reader = factory->getReaderForTypeAndExtension<Volume>(
+            filesystem::getFileExtension(file));
+        if (!reader) {
+            throw Exception(fmt::format("no volume reader for '{}'", file),
+                            IVW_CONTEXT_CUSTOM("realVolume"));
+        }
+        return reader->readData(file);
+    }();
+    return volume;
+}
+
+// Crops at most size^3 voxels from the center of the real volume, converted to float
+std::shared_ptr<Volume> croppedVolume(const Volume& volume, size_t size) {
+    const auto src = volume.getRepresentation<VolumeRAM>();
+    const auto srcDims = src->getDimensions();
+    const auto dims = glm::min(srcDims, size3_t{size});
+    const auto offset = (srcDims - dims) / size_t{2};
+
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[x + dims.x * (y + dims.y * z)] =
+                    static_cast<float>(src->getAsDouble(offset + size3_t{x, y, z}));
+            }
+        }
+    }
+    auto result = std::make_shared<Volume>(ram);
+    result->dataMap_ = volume.dataMap_;
+    return result;
+}
+
+// Returns the volume of the given size, cached since creating it is not benchmarked
+std::shared_ptr<const Volume> gridVolume(size_t size) {
+    static std::map<size_t, std::shared_ptr<const Volume>> volumes;
+    auto& volume = volumes[size];
+    if (!volume) {
+        if (auto real = realVolume()) {
+            volume = croppedVolume(*real, size);
+        } else {
+            volume = syntheticVolume(size3_t{size});
+        }
+    }
+    return volume;
+}
+
+std::shared_ptr<const topology::TriangulationData> grid(size_t size) {
+    static std::map<size_t, std::shared_ptr<const topology::TriangulationData>> grids;
+    auto& data = grids[size];
+    if (!data) {
+        data = std::make_shared<topology::TriangulationData>(
+            topology::volumeToTTKTriangulation(*gridVolume(size), 0));
+    }
+    return data;
+}
+
+const std::vector<float>& scalars(const topology::TriangulationData& data) {
+    return static_cast<const BufferRAMPrecision<float>*>(
+               data.getScalarValues()->getRepresentation<BufferRAM>())
+        ->getDataContainer();
+}
+
+// Height field of size x size vertices, either with shared vertices or as a triangle soup
+std::shared_ptr<Mesh> heightField(size_t size, bool soup) {
+    std::vector<vec3> points(size * size);
+    std::mt19937 rand(static_cast<unsigned int>(size));
+    for (size_t y = 0; y < size; ++y) {
+        for (size_t x = 0; x < size; ++x) {
+            const vec2 p = vec2(x, y) / static_cast<float>(size - 1);
+            points[x + size * y] = vec3(p, syntheticValue(vec3(p, 0.0f), rand));
+        }
+    }
+    std::vector<uint32_t> indices;
+    indices.reserve(6 * (size - 1) * (size - 1));
+    for (size_t y = 0; y + 1 < size; ++y) {
+        for (size_t x = 0; x + 1 < size; ++x) {
+            const auto i = static_cast<uint32_t>(x + size * y);
+            const auto s = static_cast<uint32_t>(size);
+            for (auto v : {i, i + 1, i + s + 1, i, i + s + 1, i + s}) indices.push_back(v);
+        }
+    }
+    if (soup) {
+        std::vector<vec3> soupPoints;
+        soupPoints.reserve(indices.size());
+        for (auto& i : indices) {
+            soupPoints.push_back(points[i]);
+            i = static_cast<uint32_t>(soupPoints.size() - 1);
+        }
+        points = std::move(soupPoints);
+    }
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(points)));
+    mesh->addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::None),
+                     util::makeIndexBuffer(std::move(indices)));
+    return mesh;
+}
+
+int hardwareThreads() { return std::max(1, static_cast<int>(std::thread::hardware_concurrency())); }
+
+int threadCount(benchmark::State& state) {
+    const auto threads = static_cast<int>(state.range(1));
+    state.counters["threads"] = threads;
+    return threads;
+}
+
+// TTK threads per job as in TTKSettings, without logging the timings of the jobs
+topology::ThreadPolicy threadPolicy(benchmark::State& state) {
+    topology::ThreadPolicy policy;
+    policy.threads = threadCount(state);
+    policy.logThreshold = std::chrono::hours{1};
+    return policy;
+}
+
+// Conversions run on the thread pool, use the requested number of threads there
+void resizePool(benchmark::State& state) {
+    const auto threads = static_cast<size_t>(threadCount(state));
+    InviwoApplication::getPtr()->resizePool(
+        threads > 0 ? threads : static_cast<size_t>(hardwareThreads()));
+}
+
+void setVerticesProcessed(benchmark::State& state, size_t vertices) {
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(vertices));
+    state.counters["vertices"] = static_cast<double>(vertices);
+    state.SetLabel(std::getenv("IVW_TTK_BENCHMARK_VOLUME") ? "volume" : "synthetic");
+}
+
+DiagramOutput persistencePairs(const topology::TriangulationData& data, int threads) {
+    std::vector<int> offsets(data.getOffsets());
+    DiagramOutput output;
+    ttk::PersistenceDiagram diagram;
+    diagram.setThreadNumber(threads);
+    diagram.setupTriangulation(const_cast<ttk::Triangulation*>(&data.getTriangulation()));
+    diagram.setOutputCTDiagram(&output);
+    diagram.setInputScalars(const_cast<float*>(scalars(data).data()));
+    diagram.setInputOffsets(offsets.data());
+    if (diagram.execute<float, int>() != 0) {
+        throw TTKException("Error computing ttk::PersistenceDiagram",
+                           IVW_CONTEXT_CUSTOM("persistencePairs"));
+    }
+    return output;
+}
+
+// Vertices of the persistence pairs kept by the simplification, the 10% most persistent ones
+const std::vector<int>& authorizedCriticalPoints(size_t size) {
+    static std::map<size_t, std::vector<int>> points;
+    auto& vertices = points[size];
+    if (vertices.empty()) {
+        auto pairs = persistencePairs(*grid(size), hardwareThreads());
+        std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+            return std::get<4>(a) > std::get<4>(b);
+        });
+        pairs.resize(std::max<size_t>(1, pairs.size() / 10));
+        for (const auto& pair : pairs) {
+            vertices.push_back(static_cast<int>(std::get<0>(pair)));
+            vertices.push_back(static_cast<int>(std::get<2>(pair)));
+        }
+    }
+    return vertices;
+}
+
+void runMorseSmaleComplex(benchmark::State& state,
+                          std::shared_ptr<const topology::TriangulationData> data) {
+    const auto policy = threadPolicy(state);
+    for (auto _ : state) {
+        std::vector<int> offsets(data->getOffsets());
+        topology::TTKJob job{policy, "MorseSmaleComplex"};
+        ttk::MorseSmaleComplex morseSmaleComplex;
+        morseSmaleComplex.setThreadNumber(job.threadCount());
+        morseSmaleComplex.setupTriangulation(
+            const_cast<ttk::Triangulation*>(&data->getTriangulation()));
+        morseSmaleComplex.setInputScalarField(scalars(*data).data());
+        morseSmaleComplex.setInputOffsets(offsets.data());
+        topology::MorseSmaleComplexData mscData(morseSmaleComplex, data);
+        morseSmaleComplex.setReturnSaddleConnectors(false);
+        morseSmaleComplex.setComputeSaddleConnectors(true);
+        morseSmaleComplex.execute<float, ttk::SimplexId>();
+        benchmark::DoNotOptimize(mscData);
+    }
+    setVerticesProcessed(state, scalars(*data).size());
+}
+
+}  // namespace
+
+static void persistenceDiagram(benchmark::State& state) {
+    const auto data = grid(static_cast<size_t>(state.range(0)));
+    const auto policy = threadPolicy(state);
+    for (auto _ : state) {
+        topology::TTKJob job{policy, "PersistenceDiagram"};
+        benchmark::DoNotOptimize(persistencePairs(*data, job.threadCount()));
+    }
+    setVerticesProcessed(state, scalars(*data).size());
+}
+BENCHMARK(persistenceDiagram)
+    ->ArgsProduct({{32, 64, 128}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Persistence pairs of the join and split trees brick by brick, read from the volume
+static void brickedPersistenceDiagram(benchmark::State& state) {
+    const auto volume = gridVolume(static_cast<size_t>(state.range(0)));
+    const auto threads = threadCount(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::brickedPersistence(
+            volume->getDimensions(), topology::volumeBrickReader(volume, 0), 32,
+            threads > 0 ? threads : hardwareThreads()));
+    }
+    setVerticesProcessed(state, glm::compMul(volume->getDimensions()));
+}
+BENCHMARK(brickedPersistenceDiagram)
+    ->ArgsProduct({{32, 64, 128}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void contourTree(benchmark::State& state) {
+    const auto data = grid(static_cast<size_t>(state.range(0)));
+    const auto policy = threadPolicy(state);
+    for (auto _ : state) {
+        std::vector<int> offsets(data->getOffsets());
+        topology::TTKJob job{policy, "ContourTree"};
+        topology::ContourTree tree;
+        tree.setThreadNumber(job.threadCount());
+        tree.setupTriangulation(const_cast<ttk::Triangulation*>(&data->getTriangulation()));
+        tree.setVertexScalars(scalars(*data).data());
+        tree.setVertexSoSoffsets(offsets.data());
+        tree.setTreeType(static_cast<int>(topology::TreeType::Contour));
+        tree.setSegmentation(true);
+        tree.setNormalizeIds(false);
+        tree.build<float, ttk::SimplexId>();
+    }
+    setVerticesProcessed(state, scalars(*data).size());
+}
+BENCHMARK(contourTree)
+    ->ArgsProduct({{32, 64, 128}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void morseSmaleComplex(benchmark::State& state) {
+    runMorseSmaleComplex(state, grid(static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(morseSmaleComplex)
+    ->ArgsProduct({{32, 64, 128}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Morse-Smale complex of a height field, the setup of the morse-smale2d regression workspace
+static void morseSmaleComplex2D(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    auto data = std::make_shared<topology::TriangulationData>(
+        topology::meshToTTKTriangulation(*heightField(size, false)));
+    std::vector<float> values(data->getPoints().size());
+    std::transform(data->getPoints().begin(), data->getPoints().end(), values.begin(),
+                   [](const vec3& p) { return p.z; });
+    data->setScalarValues(std::move(values));
+    runMorseSmaleComplex(state, data);
+}
+BENCHMARK(morseSmaleComplex2D)
+    ->ArgsProduct({{256, 512, 1024}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void topologicalSimplification(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto data = grid(size);
+    const auto& authorized = authorizedCriticalPoints(size);
+    const auto policy = threadPolicy(state);
+    for (auto _ : state) {
+        auto simplified = scalars(*data);
+        std::vector<int> offsets(data->getOffsets());
+        topology::TTKJob job{policy, "TopologicalSimplification"};
+        ttk::TopologicalSimplification simplification;
+        simplification.setThreadNumber(job.threadCount());
+        simplification.setupTriangulation(
+            const_cast<ttk::Triangulation*>(&data->getTriangulation()));
+        simplification.setInputScalarFieldPointer(const_cast<float*>(scalars(*data).data()));
+        simplification.setInputOffsetScalarFieldPointer(offsets.data());
+        simplification.setOutputScalarFieldPointer(simplified.data());
+        simplification.setOutputOffsetScalarFieldPointer(offsets.data());
+        simplification.setConstraintNumber(static_cast<int>(authorized.size()));
+        simplification.setVertexIdentifierScalarFieldPointer(const_cast<int*>(authorized.data()));
+        if (simplification.execute<float, int>() < 0) {
+            state.SkipWithError("could not simplify");
+            break;
+        }
+        benchmark::DoNotOptimize(simplified.data());
+    }
+    setVerticesProcessed(state, scalars(*data).size());
+    state.counters["constraints"] = static_cast<double>(authorized.size());
+}
+BENCHMARK(topologicalSimplification)
+    ->ArgsProduct({{32, 64, 128}, {1, 2, 4, 8, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void volumeToTriangulation(benchmark::State& state) {
+    const auto volume = gridVolume(static_cast<size_t>(state.range(0)));
+    resizePool(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::volumeToTTKTriangulation(*volume, 0));
+    }
+    setVerticesProcessed(state, glm::compMul(volume->getDimensions()));
+}
+BENCHMARK(volumeToTriangulation)
+    ->ArgsProduct({{32, 64, 128}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void triangulationToVolume(benchmark::State& state) {
+    const auto data = grid(static_cast<size_t>(state.range(0)));
+    resizePool(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::ttkTriangulationToVolume(*data));
+    }
+    setVerticesProcessed(state, scalars(*data).size());
+}
+BENCHMARK(triangulationToVolume)
+    ->ArgsProduct({{32, 64, 128}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void meshToTriangulation(benchmark::State& state) {
+    const auto mesh = heightField(static_cast<size_t>(state.range(0)), false);
+    resizePool(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::meshToTTKTriangulation(*mesh));
+    }
+    setVerticesProcessed(state, mesh->getBuffer(0)->getSize());
+}
+BENCHMARK(meshToTriangulation)
+    ->ArgsProduct({{256, 512, 1024}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Converting a triangle soup, i.e. welding its coincident vertices first
+static void meshToTriangulationWelded(benchmark::State& state) {
+    const auto mesh = heightField(static_cast<size_t>(state.range(0)), true);
+    resizePool(state);
+    std::vector<uint32_t> sourceVertices;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::meshToTTKTriangulation(*mesh, 0.0f, sourceVertices));
+    }
+    setVerticesProcessed(state, mesh->getBuffer(0)->getSize());
+}
+BENCHMARK(meshToTriangulationWelded)
+    ->ArgsProduct({{256, 512, 1024}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+static void triangulationToMesh(benchmark::State& state) {
+    const auto data = topology::meshToTTKTriangulation(
+        *heightField(static_cast<size_t>(state.range(0)), false));
+    resizePool(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology::ttkTriangulationToMesh(data));
+    }
+    setVerticesProcessed(state, data.getPoints().size());
+}
+BENCHMARK(triangulationToMesh)
+    ->ArgsProduct({{256, 512, 1024}, {1, 4, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    inviwo::LogCentral::init();
+
+    InviwoApplication app(argc, argv, "Inviwo-Benchmarks-TopologyToolKit");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createInviwoCore());
+        modules.emplace_back(createBaseModule());
+        app.registerModules(std::move(modules));
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -1,8 +1,13 @@
 # Inviwo module dependencies for current module
 # List modules on the format "Inviwo<ModuleName>Module"
 set(dependencies
+    InviwoBrushingAndLinkingModule
+    InviwoDataFrameClusteringModule
+    InviwoOpenGLModule
     InviwoPlottingModule  
     InviwoVectorFieldVisualizationModule  
+    InviwoUtilitiesGLModule
+    InviwoUtilitiesModule
 )
 
 # Add an alias for this module. Several modules can share an alias. 
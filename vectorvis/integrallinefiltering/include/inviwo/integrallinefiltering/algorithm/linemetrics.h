@@ -0,0 +1,78 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \namespace inviwo::linemetrics
+ * Geometric measures of the polylines of integral lines.
+ */
+namespace linemetrics {
+
+struct IVW_MODULE_INTEGRALLINEFILTERING_API GeometricMetrics {
+    double arcLength = 0.0;
+    /// arc length divided by the distance between the first and the last vertex
+    double tortuosity = 0.0;
+    /// total turning angle divided by the arc length
+    double meanCurvature = 0.0;
+    /// largest curvature of the circles through three consecutive vertices
+    double maxCurvature = 0.0;
+    /// total absolute angle between consecutive osculating planes divided by the arc length
+    double meanTorsion = 0.0;
+};
+
+/**
+ * Buffers for geometricMetrics(), the segments of a line are stored as structure of arrays such
+ * that each metric is a simple loop over contiguous arrays which the compiler can vectorize.
+ * Reusing the buffers between lines avoids allocations.
+ */
+struct IVW_MODULE_INTEGRALLINEFILTERING_API GeometricScratch {
+    std::vector<double> x, y, z, length;
+    // binormals, the cross products of consecutive segments
+    std::vector<double> bx, by, bz;
+};
+
+/**
+ * Computes all geometric metrics of the polyline \p positions at once. Lines with less than two
+ * vertices get zero for all metrics, and metrics are zero where the polyline has no curvature or
+ * torsion, e.g. the torsion of lines with less than four vertices.
+ */
+IVW_MODULE_INTEGRALLINEFILTERING_API GeometricMetrics
+geometricMetrics(const std::vector<dvec3>& positions, GeometricScratch& scratch);
+
+}  // namespace linemetrics
+
+}  // namespace inviwo
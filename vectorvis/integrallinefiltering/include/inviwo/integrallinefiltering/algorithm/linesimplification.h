@@ -0,0 +1,73 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/vectorfieldvisualization/datastructures/integralline.h>
+
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \namespace inviwo::simplification
+ * Reduces the number of vertices of integral lines while bounding the error of their positions
+ * and meta data.
+ */
+namespace simplification {
+
+/**
+ * Douglas-Peucker simplification of the polyline \p positions. A vertex is dropped if its
+ * distance to the segment between the kept vertices around it is at most \p tolerance, and, if
+ * \p channelTolerance is positive, each of the \p channels differs by at most channelTolerance
+ * from its linear interpolation along that segment. The interpolation parameter is the
+ * projection of the vertex onto the segment, hence meta data of dropped vertices is recovered by
+ * interpolating along the simplified line. Each channel holds one value per vertex.
+ *
+ * @return indices of the kept vertices in increasing order, the first and the last vertex are
+ * always kept
+ */
+IVW_MODULE_INTEGRALLINEFILTERING_API std::vector<size_t> douglasPeucker(
+    const std::vector<dvec3>& positions, double tolerance,
+    const std::vector<std::vector<dvec4>>& channels = {}, double channelTolerance = 0.0);
+
+/**
+ * Simplifies \p line with douglasPeucker(), using all of its meta data buffers as channels.
+ * The kept vertices keep their positions and meta data unchanged, and the index and termination
+ * reasons of \p line are copied.
+ */
+IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLine simplify(const IntegralLine& line,
+                                                           double tolerance,
+                                                           double metaDataTolerance = 0.0);
+
+}  // namespace simplification
+
+}  // namespace inviwo
@@ -116,7 +116,9 @@ double shannonEntropyScalars(const std::vector<T>& data, size_t numBins = 8,
     T min = *minmax->first;
     T max = *minmax->second;
 
-    SparseHistogram<size_t> histogram;
+    // the bins are known to be in [0, numBins), a dense histogram reused between calls suffices
+    thread_local std::vector<size_t> histogram;
+    histogram.assign(numBins, 0);
 
     for (const auto& v : data) {
         auto x = (v - min) / (max - min);
@@ -127,7 +129,9 @@ double shannonEntropyScalars(const std::vector<T>& data, size_t numBins = 8,
         histogram[i]++;
     }
     if (normalize == PerformNormalization::Yes) {
-        return shannonEntropy(histogram) / shannonEntropyMax(histogram.numberOfBins());
+        const auto usedBins = static_cast<size_t>(
+            std::count_if(histogram.begin(), histogram.end(), [](size_t c) { return c != 0; }));
+        return shannonEntropy(histogram) / shannonEntropyMax(usedBins);
     } else {
         return shannonEntropy(histogram);
     }
@@ -169,18 +173,15 @@ double shannonEntropyEuclidean(const std::vector<glm::vec<Dims, T>>& points,
                                PerformNormalization normalize = PerformNormalization::Yes) {
     static_assert(std::is_floating_point_v<T>);
     using bin_t = glm::vec<Dims, glm::i64>;
-    SparseHistogram<bin_t> histogram;
+    // reused between calls to avoid allocations
+    thread_local SparseHistogram<bin_t> histogram;
+    histogram.clear();
 
     for (const auto& v : points) {
         const auto bin = static_cast<bin_t>(glm::ceil(v / binSize));
         histogram[bin]++;
     }
 
-    SparseHistogram<size_t> binHist;
-    for (auto bin : histogram) {
-        binHist[bin.second]++;
-    }
-
     if (normalize == PerformNormalization::Yes) {
         return shannonEntropy(histogram) / shannonEntropyMax(histogram.numberOfBins());
     } else {
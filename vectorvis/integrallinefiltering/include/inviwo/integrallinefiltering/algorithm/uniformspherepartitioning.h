@@ -35,6 +35,15 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/ports/imageport.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 namespace inviwo {
 namespace detail {
 
@@ -69,6 +78,11 @@ T colatitudeAngle(const T sphericalCapArea) {
  * \image html sphere-partitioning.png "Image demostrating 100k points binned using a
  * directional histogram with 100 bins"
  *
+ * The patch of a direction is looked up in a precomputed table over the octahedral map of the
+ * sphere. Cells of the table which are close to a patch boundary fall back to the exact
+ * computation, which needs a few trigonometric functions. Construction of the table is not free,
+ * use get() to share partitionings with the same number of patches.
+ *
  * [1] Leopardi, Paul. "A partition of the unit sphere into regions of equal area and small
  * diameter." Electronic Transactions on Numerical Analysis 25.12 (2006): 309-327.
  */
@@ -170,6 +184,8 @@ public:
 
         IVW_ASSERT(count == segments,
                    "Code failed to partion the sphere into the right number of segments");
+
+        buildLookupTable();
     }
 
     UniformSpherePartitioning(const UniformSpherePartitioning&) = default;
@@ -182,17 +198,196 @@ public:
      */
     size_t numberOfPatches() const { return collars_.back().startIndex + collars_.back().patches_; }
 
+    /**
+     * Returns the collars from the north pole to the south pole, each as the cosine of the
+     * colatitude where it ends, its number of patches and the index of its first patch. The patch
+     * of a unit vector is in the first collar ending below it, and divides the collar evenly in
+     * azimuth as in getExactRegionForDirection().
+     */
+    std::vector<std::tuple<T, size_t, size_t>> getCollars() const {
+        std::vector<std::tuple<T, size_t, size_t>> collars;
+        for (const auto& collar : collars_) {
+            collars.emplace_back(collar.cosAngle_, collar.patches_, collar.startIndex);
+        }
+        return collars;
+    }
+
+    /**
+     * Returns a partitioning with the given number of patches shared with all other callers, such
+     * that its lookup table is only built once.
+     */
+    static std::shared_ptr<const UniformSpherePartitioning> get(const size_t segments) {
+        static std::mutex mutex;
+        static std::unordered_map<size_t, std::shared_ptr<const UniformSpherePartitioning>> cache;
+        std::scoped_lock lock{mutex};
+        auto& partitioning = cache[segments];
+        if (!partitioning) {
+            partitioning = std::make_shared<const UniformSpherePartitioning>(segments);
+        }
+        return partitioning;
+    }
+
     /**
      * Return the index of the partition for the given direction.
      */
     size_t getRegionForDirection(const glm::vec<3, T>& in_dir) const {
+        if (!lut_.empty()) {
+            const auto cell = cellIndex(in_dir);
+            if (cell >= 0 && lut_[cell] != ambiguous) return lut_[cell];
+        }
+        return getExactRegionForDirection(in_dir);
+    }
+
+    /**
+     * Return the indices of the partitions for \p count directions in \p regions. The table cells
+     * are computed for blocks of directions in a branch free loop, which the compiler can
+     * vectorize, before the patches are looked up.
+     */
+    void getRegionsForDirections(const glm::vec<3, T>* directions, size_t count,
+                                 size_t* regions) const {
+        if (lut_.empty()) {
+            for (size_t i = 0; i < count; ++i) {
+                regions[i] = getExactRegionForDirection(directions[i]);
+            }
+            return;
+        }
+
+        constexpr size_t blockSize = 256;
+        std::int32_t cells[blockSize];
+        for (size_t begin = 0; begin < count; begin += blockSize) {
+            const size_t n = std::min(blockSize, count - begin);
+            const auto* block = directions + begin;
+            for (size_t i = 0; i < n; ++i) {
+                cells[i] = cellIndex(block[i]);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                const auto region = cells[i] >= 0 ? lut_[cells[i]] : ambiguous;
+                regions[begin + i] =
+                    region != ambiguous ? region : getExactRegionForDirection(block[i]);
+            }
+        }
+    }
+
+    /**
+     * Return the index of the partition for the given direction without using the lookup table.
+     */
+    size_t getExactRegionForDirection(const glm::vec<3, T>& in_dir) const {
         const auto dir = glm::normalize(in_dir);
         const auto it = std::lower_bound(collars_.begin(), collars_.end(), dir.z);
         return it->index(dir.x, dir.y);
     }
 
 private:
+    static constexpr std::uint32_t ambiguous = std::numeric_limits<std::uint32_t>::max();
+
+    // lookup table cell of the octahedral map of a direction, -1 for zero or non-finite ones
+    std::int32_t cellIndex(const glm::vec<3, T>& dir) const {
+        const T ax = std::abs(dir.x);
+        const T ay = std::abs(dir.y);
+        const T l1 = ax + ay + std::abs(dir.z);
+        const bool valid = l1 > 0 && l1 < std::numeric_limits<T>::infinity();
+        const T inv = valid ? 1 / l1 : T(0);
+
+        // the lower hemisphere is folded over the diagonals
+        const T su = dir.x >= 0 ? T(1) : T(-1);
+        const T sv = dir.y >= 0 ? T(1) : T(-1);
+        const T u = dir.z >= 0 ? dir.x * inv : (1 - ay * inv) * su;
+        const T v = dir.z >= 0 ? dir.y * inv : (1 - ax * inv) * sv;
+
+        const T max = static_cast<T>(lutResolution_ - 1);
+        const auto cell = [&](T x) {
+            const T scaled = (x + 1) * T(0.5) * static_cast<T>(lutResolution_);
+            return static_cast<std::int32_t>(std::clamp(scaled, T(0), max));
+        };
+        const auto index = cell(v) * static_cast<std::int32_t>(lutResolution_) + cell(u);
+        return valid ? index : -1;
+    }
+
+    static glm::vec<3, T> octahedralDecode(const glm::vec<2, T>& uv) {
+        glm::vec<3, T> dir{uv.x, uv.y, 1 - std::abs(uv.x) - std::abs(uv.y)};
+        if (dir.z < 0) {
+            dir.x = (1 - std::abs(uv.y)) * (uv.x >= 0 ? 1 : -1);
+            dir.y = (1 - std::abs(uv.x)) * (uv.y >= 0 ? 1 : -1);
+        }
+        return glm::normalize(dir);
+    }
+
+    // lower bound of the angle between the unit vector dir and the boundary of its patch
+    T distanceToPatchBoundary(const glm::vec<3, T>& dir) const {
+        const auto it = std::lower_bound(collars_.begin(), collars_.end(), dir.z);
+        const T colatitude = std::acos(std::clamp(dir.z, T(-1), T(1)));
+
+        T distance = std::numeric_limits<T>::max();
+        if (it != collars_.begin()) {
+            distance = std::min(distance, colatitude - std::acos(std::prev(it)->cosAngle_));
+        }
+        if (std::next(it) != collars_.end()) {
+            distance = std::min(distance, std::acos(it->cosAngle_) - colatitude);
+        }
+        if (it->patches_ > 1) {
+            // angle to the great circle of the closest meridian bounding the patch
+            const T alpha = (std::atan2(dir.y, dir.x) / glm::two_pi<T>() + T(0.5)) * it->patches_;
+            const T azimuth = std::min(alpha - std::floor(alpha), std::ceil(alpha) - alpha) *
+                              glm::two_pi<T>() / it->patches_;
+            const T meridian =
+                std::asin(std::sin(colatitude) * std::sin(std::min(azimuth, glm::half_pi<T>())));
+            distance = std::min(distance, meridian);
+        }
+        return distance;
+    }
+
+    /*
+     * The table covers the octahedral map with cells much smaller than the patches. A cell
+     * gets the patch of its center if the center is farther from the patch boundary than from
+     * any corner of the cell, with a safety margin for the curvature of the cell edges. Other
+     * cells, about 5-15% of them, are marked ambiguous.
+     */
+    void buildLookupTable() {
+        // without collars of several patches the exact computation needs no trigonometry
+        if (std::all_of(collars_.begin(), collars_.end(),
+                        [](const Collar& collar) { return collar.patches_ == 1; })) {
+            return;
+        }
+        const size_t patches = numberOfPatches();
+
+        size_t resolution = 64;
+        while (resolution < 1024 && resolution < 48 * std::sqrt(static_cast<T>(patches))) {
+            resolution *= 2;
+        }
+        lutResolution_ = resolution;
+        lut_.resize(resolution * resolution);
+
+        const auto coordinate = [&](T i) { return 2 * i / resolution - 1; };
+        std::vector<glm::vec<3, T>> corners((resolution + 1) * (resolution + 1));
+        for (size_t j = 0; j <= resolution; ++j) {
+            for (size_t i = 0; i <= resolution; ++i) {
+                corners[j * (resolution + 1) + i] = octahedralDecode(
+                    {coordinate(static_cast<T>(i)), coordinate(static_cast<T>(j))});
+            }
+        }
+
+        for (size_t j = 0; j < resolution; ++j) {
+            for (size_t i = 0; i < resolution; ++i) {
+                const auto center = octahedralDecode(
+                    {coordinate(i + T(0.5)), coordinate(j + T(0.5))});
+                T minCos = 1;
+                for (auto corner : {j * (resolution + 1) + i, j * (resolution + 1) + i + 1,
+                                    (j + 1) * (resolution + 1) + i,
+                                    (j + 1) * (resolution + 1) + i + 1}) {
+                    minCos = std::min(minCos, glm::dot(center, corners[corner]));
+                }
+                const T radius = T(1.25) * std::acos(std::clamp(minCos, T(-1), T(1)));
+                lut_[j * resolution + i] =
+                    distanceToPatchBoundary(center) > radius
+                        ? static_cast<std::uint32_t>(getExactRegionForDirection(center))
+                        : ambiguous;
+            }
+        }
+    }
+
     std::vector<Collar> collars_;
+    size_t lutResolution_ = 0;
+    std::vector<std::uint32_t> lut_;
 };
 
 }  // namespace inviwo
@@ -34,10 +34,140 @@
 
 #include <inviwo/integrallinefiltering/algorithm/uniformspherepartitioning.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 namespace inviwo {
 
 namespace histogram {
 
+namespace detail {
+
+// number of directions binned per block by the batch kernels
+constexpr size_t blockSize = 256;
+
+template <typename T>
+size_t exactDirectionalBin(const glm::vec<2, T>& dir, size_t numberOfBins) {
+    const auto a = atan2(dir.y, dir.x) / glm::two_pi<T>() + 0.5;
+    return std::min(static_cast<size_t>(a * numberOfBins), numberOfBins - 1);
+}
+
+/*
+ * Branch free atan2 using the minimax polynomial of Abramowitz and Stegun 4.4.49 for atan on
+ * [0, 1], accurate to 2e-8 rad. Returns NaN for the zero vector.
+ */
+template <typename T>
+T fastAtan2(T y, T x) {
+    const T ax = std::abs(x);
+    const T ay = std::abs(y);
+    const T t = std::min(ax, ay) / std::max(ax, ay);
+    const T s = t * t;
+    T p = T(0.0028662257);
+    p = p * s - T(0.0161657367);
+    p = p * s + T(0.0429096138);
+    p = p * s - T(0.0752896400);
+    p = p * s + T(0.1065626393);
+    p = p * s - T(0.1420889944);
+    p = p * s + T(0.1999355085);
+    p = p * s - T(0.3333314528);
+    p = (p * s + T(1)) * t;
+    T r = ay > ax ? glm::half_pi<T>() - p : p;
+    r = x < 0 ? glm::pi<T>() - r : r;
+    return y < 0 ? -r : r;
+}
+
+}  // namespace detail
+
+/**
+ * Add the directional histogram of \p count 2D vectors starting at \p directions to the
+ * \p numberOfBins counts in \p bins. The bins match calculateDirectionalHistogram() exactly, but
+ * are computed in blocks using a polynomial atan2 in a branch free loop, which the compiler can
+ * vectorize. Directions close to the border of a bin, within the error of the polynomial, are
+ * binned using std::atan2.
+ */
+template <typename T>
+void calculateDirectionalHistogram(const glm::vec<2, T>* directions, size_t count,
+                                   size_t numberOfBins, size_t* bins) {
+    static_assert(std::is_floating_point_v<T>);
+    // bound of the error of the polynomial and of std::atan2, in radians
+    constexpr T epsilon = std::is_same_v<T, float> ? T(1e-5) : T(1e-7);
+    const T scale = static_cast<T>(numberOfBins) / glm::two_pi<T>();
+    const T margin = epsilon * scale;
+    const T maxBin = static_cast<T>(numberOfBins - 1);
+
+    std::int32_t blockBins[detail::blockSize];
+    for (size_t begin = 0; begin < count; begin += detail::blockSize) {
+        const size_t n = std::min(detail::blockSize, count - begin);
+        const auto* block = directions + begin;
+        for (size_t i = 0; i < n; ++i) {
+            const T a = (detail::fastAtan2(block[i].y, block[i].x) + glm::pi<T>()) * scale;
+            const T border = std::abs(a - std::round(a));
+            // also false for NaN
+            const bool safe = border > margin;
+            blockBins[i] = safe ? static_cast<std::int32_t>(std::min(a, maxBin)) : -1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (blockBins[i] >= 0) {
+                bins[blockBins[i]]++;
+            } else {
+                bins[detail::exactDirectionalBin(block[i], numberOfBins)]++;
+            }
+        }
+    }
+}
+
+/**
+ * Add the directional histogram of \p count 3D vectors starting at \p directions to the counts
+ * in \p bins, one per patch of \p partitioning. The patches are looked up in blocks.
+ * @see UniformSpherePartitioning::getRegionsForDirections
+ */
+template <typename T>
+void calculateDirectionalHistogram(const UniformSpherePartitioning<T>& partitioning,
+                                   const glm::vec<3, T>* directions, size_t count, size_t* bins) {
+    static_assert(std::is_floating_point_v<T>);
+    size_t regions[detail::blockSize];
+    for (size_t begin = 0; begin < count; begin += detail::blockSize) {
+        const size_t n = std::min(detail::blockSize, count - begin);
+        partitioning.getRegionsForDirections(directions + begin, n, regions);
+        for (size_t i = 0; i < n; ++i) {
+            bins[regions[i]]++;
+        }
+    }
+}
+
+/**
+ * Compute the directional histograms of \p numberOfLines lines in one pass. The directions of
+ * line i are directions[offsets[i]] to directions[offsets[i + 1]], so \p offsets holds
+ * numberOfLines + 1 entries. The histogram of line i is written to
+ * bins[i * numberOfBins, (i + 1) * numberOfBins), the caller provided arena \p bins thus has to
+ * hold numberOfLines * numberOfBins counts. No memory is allocated, except for the shared
+ * UniformSpherePartitioning in 3D.
+ */
+template <size_t Dims, typename T>
+void calculateDirectionalHistograms(const glm::vec<Dims, T>* directions, const size_t* offsets,
+                                    size_t numberOfLines, size_t numberOfBins, size_t* bins) {
+    static_assert(std::is_floating_point_v<T>);
+    static_assert(Dims == 2 || Dims == 3);
+
+    std::fill(bins, bins + numberOfLines * numberOfBins, size_t{0});
+    if constexpr (Dims == 2) {
+        for (size_t line = 0; line < numberOfLines; ++line) {
+            calculateDirectionalHistogram(directions + offsets[line],
+                                          offsets[line + 1] - offsets[line], numberOfBins,
+                                          bins + line * numberOfBins);
+        }
+    } else {
+        const auto partitioning = UniformSpherePartitioning<T>::get(numberOfBins);
+        for (size_t line = 0; line < numberOfLines; ++line) {
+            calculateDirectionalHistogram(*partitioning, directions + offsets[line],
+                                          offsets[line + 1] - offsets[line],
+                                          bins + line * numberOfBins);
+        }
+    }
+}
+
 /**
  * Funcion to compute a histgram of a set of 2D vectors. Only their
  * direction is considered, magnitudes are ignored. The histogram consits of N bins, each
@@ -48,11 +178,7 @@ const std::vector<size_t> calculateDirectionalHistogram(
     const std::vector<glm::vec<2, T>>& directions, const size_t numberOfBins = 20) {
     static_assert(std::is_floating_point_v<T>);
     std::vector<size_t> bins(numberOfBins, 0);
-    for (const auto& dir : directions) {
-        const auto a = atan2(dir.y, dir.x) / glm::two_pi<T>() + 0.5;
-        const auto I = std::min(static_cast<size_t>(a * numberOfBins), numberOfBins - 1);
-        bins[I]++;
-    }
+    calculateDirectionalHistogram(directions.data(), directions.size(), numberOfBins, bins.data());
     return bins;
 }
 
@@ -67,11 +193,9 @@ const std::vector<size_t> calculateDirectionalHistogram(
     const std::vector<glm::vec<3, T>>& directions, const size_t numberOfBins = 20) {
     static_assert(std::is_floating_point_v<T>);
 
-    UniformSpherePartitioning<T> partions(numberOfBins);
+    const auto partions = UniformSpherePartitioning<T>::get(numberOfBins);
     std::vector<size_t> bins(numberOfBins, 0);
-    for (const auto& dir : directions) {
-        bins[partions.getRegionForDirection(dir)]++;
-    }
+    calculateDirectionalHistogram(*partions, directions.data(), directions.size(), bins.data());
     return bins;
 }
 
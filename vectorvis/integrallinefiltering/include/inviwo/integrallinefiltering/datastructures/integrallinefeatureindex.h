@@ -0,0 +1,102 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+class DataFrame;
+
+/**
+ * \brief Lines sorted by each of their metrics, for fast threshold and top-K queries
+ * The index is built once from a DataFrame with one row per line, such as the output of
+ * IntegralLinesToDataFrame, where the index column holds the line indices. For each numerical
+ * column the line indices are sorted by their value, so that the lines within a range of values
+ * or with the K largest or smallest values are found by binary search and returned as a
+ * contiguous range of line indices, without copying any lines. Categorical columns are skipped,
+ * and rows with NaN values are left out of the metric.
+ */
+class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLineFeatureIndex {
+public:
+    using LineRange = util::iter_range<std::vector<std::uint32_t>::const_iterator>;
+
+    IntegralLineFeatureIndex() = default;
+    explicit IntegralLineFeatureIndex(const DataFrame& dataFrame);
+
+    size_t numberOfMetrics() const { return metrics_.size(); }
+    const std::string& getName(size_t metric) const { return metrics_[metric].name; }
+    /**
+     * Returns the index of the metric with the given column header, or numberOfMetrics() if
+     * there is none.
+     */
+    size_t find(const std::string& name) const;
+
+    /**
+     * Returns the smallest and largest value of \p metric, or (0, 0) if it has no values.
+     */
+    dvec2 getRange(size_t metric) const;
+
+    /**
+     * Returns one more than the largest line index, i.e. the size of a mask over all lines.
+     */
+    size_t numberOfLines() const { return numberOfLines_; }
+
+    /**
+     * Returns the lines with a value of \p metric in [min, max], ordered by their value.
+     */
+    LineRange query(size_t metric, double min, double max) const;
+    /**
+     * Returns the \p count lines with the largest values of \p metric, ordered by their value.
+     */
+    LineRange largest(size_t metric, size_t count) const;
+    /**
+     * Returns the \p count lines with the smallest values of \p metric, ordered by their value.
+     */
+    LineRange smallest(size_t metric, size_t count) const;
+
+private:
+    struct Metric {
+        std::string name;
+        std::vector<double> values;  // sorted ascending
+        std::vector<std::uint32_t> lines;
+    };
+
+    std::vector<Metric> metrics_;
+    size_t numberOfLines_ = 0;
+};
+
+}  // namespace inviwo
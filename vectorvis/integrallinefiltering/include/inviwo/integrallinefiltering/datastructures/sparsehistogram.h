@@ -32,7 +32,11 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/util/glm.h>
 
-#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace inviwo {
 
@@ -42,53 +46,193 @@ namespace inviwo {
  * is a 1D histogram accepting both negative and positive indices, i.e. [INT_MIN INT_MAX].
  * SparseHistgram can represent multi dimensional histogram when using vec as index type: For
  * example, `SparseHistogram<glm::ivec2>` represents a 2D histogram.
+ *
+ * The bins are stored in a flat hash table with open addressing and linear probing. Up to
+ * \p InlineBins bins are stored within the histogram itself, without heap allocations. Larger
+ * histograms move to the heap, and clear() keeps the allocated storage such that a histogram can
+ * be reused without allocations, for example when computing the entropy of many lines.
  */
-template <typename IndexType = glm::i64>
+template <typename IndexType = glm::i64, size_t InlineBins = 16>
 class SparseHistogram {
 public:
     using index_type = IndexType;
     using value_type = typename util::value_type<IndexType>::type;
+    using bin_type = std::pair<IndexType, size_t>;
 
     static_assert(std::is_integral_v<value_type>);
+    static_assert(InlineBins > 0 && (InlineBins & (InlineBins - 1)) == 0,
+                  "InlineBins must be a power of two");
+
+private:
+    struct Slot {
+        bin_type bin{};
+        bool used = false;
+    };
+
+    template <typename SlotType, typename BinType>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = bin_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = BinType*;
+        using reference = BinType&;
+
+        Iterator(SlotType* slot, SlotType* end) : slot_{slot}, end_{end} { skipUnused(); }
+
+        reference operator*() const { return slot_->bin; }
+        pointer operator->() const { return &slot_->bin; }
+
+        Iterator& operator++() {
+            ++slot_;
+            skipUnused();
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto it = *this;
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const Iterator& rhs) const { return slot_ == rhs.slot_; }
+        bool operator!=(const Iterator& rhs) const { return slot_ != rhs.slot_; }
+
+    private:
+        void skipUnused() {
+            while (slot_ != end_ && !slot_->used) ++slot_;
+        }
+
+        SlotType* slot_;
+        SlotType* end_;
+    };
+
+public:
+    using iterator = Iterator<Slot, bin_type>;
+    using const_iterator = Iterator<const Slot, const bin_type>;
 
     SparseHistogram() = default;
     SparseHistogram(const SparseHistogram&) = default;
-    SparseHistogram(SparseHistogram&&) noexcept = default;
+    SparseHistogram(SparseHistogram&& rhs) noexcept
+        : inline_{rhs.inline_}, heap_{std::move(rhs.heap_)}, size_{rhs.size_} {
+        rhs.reset();
+    }
     SparseHistogram& operator=(const SparseHistogram&) = default;
-    SparseHistogram& operator=(SparseHistogram&&) noexcept = default;
+    SparseHistogram& operator=(SparseHistogram&& rhs) noexcept {
+        if (this != &rhs) {
+            inline_ = rhs.inline_;
+            heap_ = std::move(rhs.heap_);
+            size_ = rhs.size_;
+            rhs.reset();
+        }
+        return *this;
+    }
 
     size_t operator[](index_type binId) const {
-        const auto it = bins_.find(binId);
-        return it != bins_.end() ? it->second : 0;
+        const size_t mask = capacity() - 1;
+        for (size_t i = hash(binId) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots()[i];
+            if (!slot.used) return 0;
+            if (slot.bin.first == binId) return slot.bin.second;
+        }
     }
 
-    size_t& operator[](index_type binId) { return bins_[binId]; }
+    size_t& operator[](index_type binId) {
+        // keep the load factor below 3/4
+        if (4 * (size_ + 1) > 3 * capacity()) grow();
+        const size_t mask = capacity() - 1;
+        for (size_t i = hash(binId) & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots()[i];
+            if (!slot.used) {
+                slot.used = true;
+                slot.bin = bin_type{binId, 0};
+                ++size_;
+                return slot.bin.second;
+            }
+            if (slot.bin.first == binId) return slot.bin.second;
+        }
+    }
 
-    auto begin() { return bins_.begin(); }
-    auto end() { return bins_.end(); }
-    auto begin() const { return bins_.begin(); }
-    auto end() const { return bins_.end(); }
+    iterator begin() { return {slots(), slots() + capacity()}; }
+    iterator end() { return {slots() + capacity(), slots() + capacity()}; }
+    const_iterator begin() const { return {slots(), slots() + capacity()}; }
+    const_iterator end() const { return {slots() + capacity(), slots() + capacity()}; }
 
     /*
      * Returns the current number of used bins.
      */
-    size_t numberOfBins() const { return bins_.size(); }
+    size_t numberOfBins() const { return size_; }
+
+    /*
+     * Removes all bins but keeps the allocated storage.
+     */
+    void clear() {
+        if (size_ == 0) return;
+        for (size_t i = 0; i < capacity(); ++i) {
+            slots()[i].used = false;
+        }
+        size_ = 0;
+    }
 
     /*
      * Removed bins where count is zero.
      */
     void cleanup() {
-        for (auto it = bins_.begin(); it != bins_.end();) {
-            if (it->second == 0) {
-                it = bins_.erase(it);
-            } else {
-                ++it;
-            }
+        // single bins can not be removed from the table without breaking the probe sequences of
+        // other bins, the remaining bins are inserted again instead
+        std::vector<bin_type> bins;
+        for (const auto& bin : *this) {
+            if (bin.second != 0) bins.push_back(bin);
+        }
+        clear();
+        for (const auto& bin : bins) {
+            (*this)[bin.first] = bin.second;
         }
     }
 
 private:
-    std::unordered_map<IndexType, size_t> bins_;
+    static size_t hash(const index_type& binId) {
+        std::uint64_t h = 0;
+        const auto mix = [&h](auto v) {
+            h = (h ^ static_cast<std::uint64_t>(v)) * std::uint64_t{0x9E3779B97F4A7C15};
+        };
+        if constexpr (std::is_integral_v<index_type>) {
+            mix(binId);
+        } else {
+            for (glm::length_t i = 0; i < index_type::length(); ++i) mix(binId[i]);
+        }
+        // the table index uses the low bits, fold in the well mixed high bits
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    size_t capacity() const { return heap_.empty() ? InlineBins : heap_.size(); }
+    Slot* slots() { return heap_.empty() ? inline_.data() : heap_.data(); }
+    const Slot* slots() const { return heap_.empty() ? inline_.data() : heap_.data(); }
+
+    void grow() {
+        std::vector<Slot> slots(2 * capacity());
+        const size_t mask = slots.size() - 1;
+        for (const auto& bin : *this) {
+            size_t i = hash(bin.first) & mask;
+            while (slots[i].used) i = (i + 1) & mask;
+            slots[i].used = true;
+            slots[i].bin = bin;
+        }
+        if (heap_.empty()) {
+            for (auto& slot : inline_) slot.used = false;
+        }
+        heap_ = std::move(slots);
+    }
+
+    // empty histogram using the inline storage
+    void reset() noexcept {
+        heap_.clear();
+        for (auto& slot : inline_) slot.used = false;
+        size_ = 0;
+    }
+
+    std::array<Slot, InlineBins> inline_{};
+    std::vector<Slot> heap_;
+    size_t size_ = 0;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,132 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/poolprocessor.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/ports/bufferport.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+#include <modules/opengl/shader/shader.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.IntegralLineClusteringGL, Integral Line Clustering GL}
+ * ![](org.inviwo.IntegralLineClusteringGL.png?classIdentifier=org.inviwo.IntegralLineClusteringGL)
+ *
+ * Groups similar integral lines. Each line is resampled to a fixed number of points equally
+ * spaced along its arc length in a compute shader. The resampled points of a line form its
+ * feature vector, scaled such that the Euclidean distance of two feature vectors is the root mean
+ * square distance of corresponding points. The feature vectors are clustered natively in the
+ * background with the methods of the DataFrameClustering module, see clustering::kmeans,
+ * clustering::miniBatchKMeans, and clustering::dbscan.
+ *
+ * The pairwise distances of the lines can be computed as well, by a second compute shader which
+ * loads tiles of resampled lines into shared memory. Besides the root mean square distance, the
+ * mean of closest point distances (MCP) and the Hausdorff distance of the resampled lines are
+ * supported.
+ *
+ * ### Inports
+ *   * __lines__ The set of lines.
+ *
+ * ### Outports
+ *   * __clusters__ Buffer with the cluster of each line, indexed as the lines of the set. The
+ *     largest cluster is 0, noise of DBSCAN is -1.
+ *   * __distances__ Row-major matrix of the distances between all lines, only computed if
+ *     connected and for at most maxDistanceLines lines.
+ *
+ * ### Properties
+ *   * __Samples per Line__ Number of points each line is resampled to.
+ *   * __Distance__ Distance measure of the distance matrix.
+ *   * __Method__ Clustering method, with its parameters below.
+ */
+class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLineClusteringGL : public PoolProcessor {
+public:
+    enum class Distance { RootMeanSquare, MeanClosestPoint, Hausdorff };
+    enum class Method { KMeans, MiniBatchKMeans, DBSCAN };
+
+    IntegralLineClusteringGL();
+    virtual ~IntegralLineClusteringGL() = default;
+
+    virtual void initializeResources() override;
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+    /**
+     * Maximum number of samples per line, the samples of a tile of lines have to fit in shared
+     * memory.
+     */
+    static constexpr size_t maxSamples = 128;
+    /**
+     * Maximum number of lines of the distance matrix, which holds the square of it floats.
+     */
+    static constexpr size_t maxDistanceLines = 8192;
+
+private:
+    void uploadPositions(const IntegralLineSet& lines);
+    void resample(size_t numLines);
+    std::shared_ptr<Buffer<float>> computeDistances(size_t numLines);
+
+    IntegralLineSetInport lines_;
+    BufferOutport clusters_;
+    BufferOutport distances_;
+
+    IntSizeTProperty samples_;
+    TemplateOptionProperty<Distance> distance_;
+    TemplateOptionProperty<Method> method_;
+    CompositeProperty kmeans_;
+    IntProperty numberOfClusters_;
+    IntProperty batchSize_;
+    CompositeProperty dbscan_;
+    DoubleProperty eps_;
+    IntProperty minPoints_;
+
+    Shader resampleShader_;
+    Shader distanceShader_;
+
+    // positions of all lines and the index of the first position of each line, followed by the
+    // total number of positions
+    std::shared_ptr<Buffer<vec4>> positions_;
+    std::shared_ptr<Buffer<std::uint32_t>> offsets_;
+    // samples per line consecutive for each line
+    std::shared_ptr<Buffer<vec4>> resampled_;
+    // centers of the last mini-batch k-means run and its number of samples, used as initial
+    // centers of the next run with the same number of samples
+    std::vector<double> centers_;
+    size_t centerSamples_ = 0;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,111 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/ports/bufferport.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+#include <modules/opengl/shader/shader.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.IntegralLineEntropyGL, Integral Line Entropy GL}
+ * ![](org.inviwo.IntegralLineEntropyGL.png?classIdentifier=org.inviwo.IntegralLineEntropyGL)
+ *
+ * Computes the Shannon entropy of each integral line with a compute shader. The values of the
+ * lines are uploaded once into a packed buffer, segmented per line by an offsets buffer. Each
+ * line is then binned by one work group into a histogram in shared memory, and the entropy is
+ * written to a per line buffer which stays on the GPU. Changing the number of bins or the
+ * normalization only runs the shader again.
+ *
+ * The entropies match entropy::shannonEntropyDirectional() and entropy::shannonEntropyScalars()
+ * up to single precision, except that lines without any value get an entropy of zero.
+ *
+ * ### Inports
+ *   * __lines__ The set of lines.
+ *
+ * ### Outports
+ *   * __entropy__ Buffer with the entropy of each line, indexed as the lines of the set.
+ *
+ * ### Properties
+ *   * __Mode__ Directional entropy of a vector meta data, binned by a UniformSpherePartitioning,
+ * or entropy of the magnitudes of a meta data, binned between their minimum and maximum.
+ *   * __Meta Data__ The meta data to compute the entropy of.
+ *   * __Number of Bins__ Number of bins of the histograms.
+ *   * __Normalize__ Divide the entropy by the maximum entropy of the histogram.
+ */
+class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLineEntropyGL : public Processor {
+public:
+    enum class Mode { Directional, Scalar };
+
+    IntegralLineEntropyGL();
+    virtual ~IntegralLineEntropyGL() = default;
+
+    virtual void initializeResources() override;
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+    /**
+     * Maximum number of bins, the histograms of a work group has to fit in shared memory
+     */
+    static constexpr size_t maxBins = 1024;
+
+private:
+    void uploadValues(const IntegralLineSet& lines);
+    void uploadCollars();
+
+    IntegralLineSetInport lines_;
+    BufferOutport entropy_;
+
+    TemplateOptionProperty<Mode> mode_;
+    OptionPropertyString metaData_;
+    IntSizeTProperty numberOfBins_;
+    BoolProperty normalize_;
+
+    Shader shader_;
+
+    // per vertex values of all lines and the index of the first vertex of each line, followed by
+    // the total number of vertices
+    std::shared_ptr<Buffer<vec4>> values_;
+    std::shared_ptr<Buffer<std::uint32_t>> offsets_;
+    // cosine of the end colatitude, number of patches and first patch of each collar
+    std::shared_ptr<Buffer<vec4>> collars_;
+    size_t collarBins_ = 0;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,94 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/core/ports/bufferport.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+#include <modules/brushingandlinking/ports/brushingandlinkingports.h>
+
+#include <inviwo/integrallinefiltering/datastructures/integrallinefeatureindex.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.IntegralLineFeatureFilter, Integral Line Feature Filter}
+ * ![](org.inviwo.IntegralLineFeatureFilter.png?classIdentifier=org.inviwo.IntegralLineFeatureFilter)
+ *
+ * Selects integral lines by one of their metrics, for example the entropy computed by
+ * IntegralLinesToDataFrame. The lines are sorted by each metric once when the data frame
+ * changes, see IntegralLineFeatureIndex. Changing the threshold or the number of lines is then
+ * answered by a binary search, and the selection is output as a mask over the lines instead of
+ * a filtered copy of them.
+ *
+ * ### Inports
+ *   * __dataFrame__ One row per line, with the line indices in the index column.
+ *   * __brushing__ Optional, the lines which are not selected are filtered, such that line
+ * renderers connected to the same brushing and linking processor only show the selected lines.
+ *
+ * ### Outports
+ *   * __mask__ Buffer with one element per line index, 1 for selected lines and 0 otherwise.
+ *
+ * ### Properties
+ *   * __Metric__ The column to select the lines by.
+ *   * __Selection__ Lines within a range, or the lines with the largest or smallest values.
+ *   * __Range__ Range of the values of the selected lines.
+ *   * __Number of Lines__ Number of lines with the largest or smallest values to select.
+ */
+class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLineFeatureFilter : public Processor {
+public:
+    enum class Selection { Range, Largest, Smallest };
+
+    IntegralLineFeatureFilter();
+    virtual ~IntegralLineFeatureFilter() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    DataFrameInport dataFrame_;
+    BrushingAndLinkingInport brushing_;
+    BufferOutport mask_;
+
+    OptionPropertyString metric_;
+    TemplateOptionProperty<Selection> selection_;
+    DoubleMinMaxProperty range_;
+    IntSizeTProperty count_;
+
+    IntegralLineFeatureIndex index_;
+};
+
+}  // namespace inviwo
@@ -0,0 +1,78 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/integrallinefiltering/integrallinefilteringmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.IntegralLineSimplification, Integral Line Simplification}
+ * ![](org.inviwo.IntegralLineSimplification.png?classIdentifier=org.inviwo.IntegralLineSimplification)
+ *
+ * Reduces the number of vertices of each integral line with the Douglas-Peucker algorithm, see
+ * simplification::douglasPeucker(). Lines traced with small fixed steps carry many nearly
+ * collinear vertices, simplifying them first lets entropy filtering and rendering run on a
+ * fraction of the vertices. The lines are simplified in parallel. Kept vertices keep their meta
+ * data, and the meta data of dropped vertices can be bounded to be recovered by interpolation.
+ *
+ * ### Inports
+ *   * __lines__ The set of lines.
+ *
+ * ### Outports
+ *   * __simplified__ The simplified lines with the same indices and termination reasons.
+ *
+ * ### Properties
+ *   * __Tolerance__ Maximum distance of a dropped vertex to the simplified line.
+ *   * __Meta Data Tolerance__ Maximum difference of the meta data of a dropped vertex to its
+ *     interpolation along the simplified line, 0 does not constrain the meta data.
+ */
+class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLineSimplification : public Processor {
+public:
+    IntegralLineSimplification();
+    virtual ~IntegralLineSimplification() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    IntegralLineSetInport lines_;
+    IntegralLineSetOutport simplified_;
+
+    DoubleProperty tolerance_;
+    DoubleProperty metaDataTolerance_;
+};
+
+}  // namespace inviwo
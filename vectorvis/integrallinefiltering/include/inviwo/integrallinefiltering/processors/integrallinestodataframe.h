@@ -39,7 +39,6 @@
 #include <inviwo/dataframe/datastructures/dataframe.h>
 
 #include <inviwo/core/properties/boolcompositeproperty.h>
-#include <inviwo/core/util/zip.h>
 
 #include <inviwo/core/util/utilities.h>
 
@@ -65,6 +64,9 @@ namespace inviwo {
  * parameter.
  *   * __Include Line Length__ Check to include the arc length of the line as a parameter.
  *   * __Include Tortuosity__ Check to include the lines tortuosity as a parameter.
+ *   * __Include Curvature__ Check to include the mean and maximum curvature of each line as
+ * parameters, see linemetrics::geometricMetrics().
+ *   * __Include Torsion__ Check to include the mean torsion of each line as a parameter.
  *   * __Include Termination Reasons__ Check to include each lines termination reason as a
  * parameter.
  *   * __Include Entropy__ Check to include each lines entropy as a parameter.
@@ -77,7 +79,13 @@ namespace inviwo {
  */
 class IVW_MODULE_INTEGRALLINEFILTERING_API IntegralLinesToDataFrame : public Processor {
 public:
-    using MetricCalcFunction = std::function<void(const IntegralLine& line)>;
+    /**
+     * Computes the metrics of \p line and writes them to \p row of the preallocated data frame
+     * columns. Called in parallel for different rows, \p scratch is reused between the lines of
+     * the same thread.
+     */
+    using MetricCalcFunction =
+        std::function<void(const IntegralLine& line, size_t row, std::vector<float>& scratch)>;
     class MetaDataSettings : public BoolCompositeProperty {
     public:
         virtual std::string getClassIdentifier() const override { return classIdentifier; }
@@ -106,69 +114,12 @@ public:
         StringProperty percentiles_{"percentiles",
                                     "Percentiles (space separated, float [0-1] or ints (0-100) )"};
 
+        /**
+         * Add one function computing all the selected statistics of the meta data in \p ram to
+         * \p funcs, and columns with \p rows rows for them to \p dataFrame.
+         */
         void initFunctions(std::vector<MetricCalcFunction>& funcs, const BufferRAM* ram,
-                           DataFrame& dataFrame);
-
-        template <typename T, typename C>
-        void createFunction(std::vector<MetricCalcFunction>& funcs, DataFrame& dataFrame,
-                            std::vector<double> percentiles, std::string name, C toFloat) {
-            std::vector<float>* avg = nullptr;
-            std::vector<float>* sds = nullptr;
-            if (avg_.get()) {
-                avg = &dataFrame.addColumn<float>(name + u8" μ")
-                           ->getTypedBuffer()
-                           ->getEditableRAMRepresentation()
-                           ->getDataContainer();
-            }
-            if (sd_.get()) {
-                sds = &dataFrame.addColumn<float>(name + u8" σ")
-                           ->getTypedBuffer()
-                           ->getEditableRAMRepresentation()
-                           ->getDataContainer();
-            }
-            std::vector<std::vector<float>*> percentilesColumns;
-            for (auto p : percentiles) {
-                percentilesColumns.push_back(
-                    &dataFrame.addColumn<float>(name + " (p:" + std::to_string(p) + ")")
-                         ->getTypedBuffer()
-                         ->getEditableRAMRepresentation()
-                         ->getDataContainer());
-            }
-            funcs.push_back([=](const IntegralLine& line) {
-                auto& vec = line.getMetaData<T>(Property::getDisplayName());
-                std::vector<float> values;
-                std::transform(vec.begin() + 1, vec.end() - 1, std::back_inserter(values),
-                               [&](const auto& v) {
-                                   if (log_.get()) {
-                                       return std::log(1 + toFloat(v));
-                                   } else {
-                                       return toFloat(v);
-                                   }
-                               });
-
-                if (avg || sds) {
-                    const auto mean = std::accumulate(values.begin(), values.end(), 0.f) /
-                                      std::max(size_t(1), values.size());
-                    if (avg) {
-                        avg->push_back(mean);
-                    }
-                    if (sds) {
-                        float stdev = std::accumulate(
-                            values.begin(), values.end(), 0.0f,
-                            [mean](float d, auto& v) { return d + (v - mean) * (v - mean); });
-                        stdev = std::sqrt(stdev / (values.size() - 1));
-                        sds->push_back(stdev);
-                    }
-                }
-                if (!percentiles.empty()) {
-                    std::sort(values.begin(), values.end());
-                    for (auto zipped : util::zip(percentilesColumns, percentiles)) {
-                        get<0>(zipped)->push_back(
-                            values[static_cast<size_t>(get<1>(zipped) * (values.size() - 1))]);
-                    }
-                }
-            });
-        }
+                           DataFrame& dataFrame, size_t rows);
     };
 
     IntegralLinesToDataFrame();
@@ -191,6 +142,8 @@ private:
     BoolProperty includeNumberOfPoints_;
     BoolProperty includeLineLength_;
     BoolProperty includeTortuosity_;
+    BoolProperty includeCurvature_;
+    BoolProperty includeTorsion_;
     BoolProperty includeTerminationReason_;
     BoolProperty includeEntropy_;
     BoolProperty includeStartPositions_;
@@ -0,0 +1,106 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/algorithm/linemetrics.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace inviwo {
+
+namespace linemetrics {
+
+GeometricMetrics geometricMetrics(const std::vector<dvec3>& positions, GeometricScratch& s) {
+    GeometricMetrics metrics;
+    if (positions.size() < 2) return metrics;
+
+    const size_t segments = positions.size() - 1;
+    s.x.resize(segments);
+    s.y.resize(segments);
+    s.z.resize(segments);
+    s.length.resize(segments);
+    for (size_t i = 0; i < segments; ++i) {
+        s.x[i] = positions[i + 1].x - positions[i].x;
+        s.y[i] = positions[i + 1].y - positions[i].y;
+        s.z[i] = positions[i + 1].z - positions[i].z;
+    }
+    for (size_t i = 0; i < segments; ++i) {
+        s.length[i] = std::sqrt(s.x[i] * s.x[i] + s.y[i] * s.y[i] + s.z[i] * s.z[i]);
+    }
+    for (size_t i = 0; i < segments; ++i) metrics.arcLength += s.length[i];
+
+    metrics.tortuosity =
+        metrics.arcLength / glm::length(positions.back() - positions.front());
+
+    // curvature at the inner vertices, from segment i and i + 1
+    const size_t corners = segments - 1;
+    s.bx.resize(corners);
+    s.by.resize(corners);
+    s.bz.resize(corners);
+    double turning = 0.0;
+    for (size_t i = 0; i < corners; ++i) {
+        s.bx[i] = s.y[i] * s.z[i + 1] - s.z[i] * s.y[i + 1];
+        s.by[i] = s.z[i] * s.x[i + 1] - s.x[i] * s.z[i + 1];
+        s.bz[i] = s.x[i] * s.y[i + 1] - s.y[i] * s.x[i + 1];
+    }
+    for (size_t i = 0; i < corners; ++i) {
+        const double cross = std::sqrt(s.bx[i] * s.bx[i] + s.by[i] * s.by[i] + s.bz[i] * s.bz[i]);
+        const double dot = s.x[i] * s.x[i + 1] + s.y[i] * s.y[i + 1] + s.z[i] * s.z[i + 1];
+        turning += std::atan2(cross, dot);
+
+        // curvature of the circle through the three vertices, 2 |a x b| / (|a| |b| |a + b|)
+        const double cx = s.x[i] + s.x[i + 1];
+        const double cy = s.y[i] + s.y[i + 1];
+        const double cz = s.z[i] + s.z[i + 1];
+        const double denom =
+            s.length[i] * s.length[i + 1] * std::sqrt(cx * cx + cy * cy + cz * cz);
+        const double curvature = denom > 0.0 ? 2.0 * cross / denom : 0.0;
+        metrics.maxCurvature = std::max(metrics.maxCurvature, curvature);
+    }
+
+    // torsion at the inner segments, the signed angle between consecutive binormals around the
+    // segment between them
+    double twisting = 0.0;
+    for (size_t i = 0; i + 1 < corners; ++i) {
+        const size_t j = i + 1;
+        const double dot = s.bx[i] * s.bx[j] + s.by[i] * s.by[j] + s.bz[i] * s.bz[j];
+        const double triple = s.x[i] * s.bx[j] + s.y[i] * s.by[j] + s.z[i] * s.bz[j];
+        twisting += std::abs(std::atan2(s.length[j] * triple, dot));
+    }
+
+    if (metrics.arcLength > 0.0) {
+        metrics.meanCurvature = turning / metrics.arcLength;
+        metrics.meanTorsion = twisting / metrics.arcLength;
+    }
+    return metrics;
+}
+
+}  // namespace linemetrics
+
+}  // namespace inviwo
@@ -0,0 +1,161 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/algorithm/linesimplification.h>
+
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/glm.h>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace inviwo {
+
+namespace simplification {
+
+std::vector<size_t> douglasPeucker(const std::vector<dvec3>& positions, double tolerance,
+                                   const std::vector<std::vector<dvec4>>& channels,
+                                   double channelTolerance) {
+    const size_t size = positions.size();
+    if (size <= 2) {
+        std::vector<size_t> all(size);
+        std::iota(all.begin(), all.end(), size_t{0});
+        return all;
+    }
+
+    const bool useChannels = channelTolerance > 0.0 && !channels.empty();
+
+    // error of dropping vertex i from the segment [a, b], relative to the tolerances
+    const auto error = [&](size_t i, size_t a, size_t b) {
+        const auto ab = positions[b] - positions[a];
+        const auto ai = positions[i] - positions[a];
+        const auto len2 = glm::dot(ab, ab);
+        // a degenerate segment is parameterized by the vertex indices instead
+        const double t = len2 > 0.0 ? glm::clamp(glm::dot(ai, ab) / len2, 0.0, 1.0)
+                                    : static_cast<double>(i - a) / static_cast<double>(b - a);
+
+        // a tolerance of zero only drops vertices lying exactly on the segment
+        const double distance = glm::length(ai - t * ab);
+        double err = tolerance > 0.0 ? distance / tolerance : (distance > 0.0 ? 2.0 : 0.0);
+        if (useChannels) {
+            for (const auto& channel : channels) {
+                const auto expected = glm::mix(channel[a], channel[b], t);
+                err = std::max(err, glm::length(channel[i] - expected) / channelTolerance);
+            }
+        }
+        return err;
+    };
+
+    std::vector<bool> keep(size, false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // segments still to be split, processed iteratively since lines can be very long
+    std::vector<std::pair<size_t, size_t>> segments{{0, size - 1}};
+    while (!segments.empty()) {
+        const auto [a, b] = segments.back();
+        segments.pop_back();
+
+        double maxError = 1.0;
+        size_t split = a;
+        for (size_t i = a + 1; i < b; ++i) {
+            const auto err = error(i, a, b);
+            if (err > maxError) {
+                maxError = err;
+                split = i;
+            }
+        }
+        if (split != a) {
+            keep[split] = true;
+            segments.emplace_back(a, split);
+            segments.emplace_back(split, b);
+        }
+    }
+
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < size; ++i) {
+        if (keep[i]) kept.push_back(i);
+    }
+    return kept;
+}
+
+IntegralLine simplify(const IntegralLine& line, double tolerance, double metaDataTolerance) {
+    const auto& positions = line.getPositions();
+
+    std::vector<std::vector<dvec4>> channels;
+    if (metaDataTolerance > 0.0) {
+        for (const auto& keyBuf : line.getMetaDataBuffers()) {
+            keyBuf.second->getRepresentation<BufferRAM>()
+                ->dispatch<void, dispatching::filter::All>([&](auto ram) {
+                    using T = util::PrecisionValueType<decltype(ram)>;
+                    constexpr size_t components = std::min<size_t>(util::extent<T>::value, 4);
+                    const auto& data = ram->getDataContainer();
+                    if (data.size() != positions.size()) return;
+                    auto& channel = channels.emplace_back(data.size(), dvec4{0.0});
+                    for (size_t v = 0; v < data.size(); ++v) {
+                        for (size_t c = 0; c < components; ++c) {
+                            channel[v][c] = static_cast<double>(util::glmcomp(data[v], c));
+                        }
+                    }
+                });
+        }
+    }
+
+    const auto kept = douglasPeucker(positions, tolerance, channels, metaDataTolerance);
+
+    IntegralLine result;
+    auto& resultPositions = result.getPositions();
+    resultPositions.reserve(kept.size());
+    for (auto i : kept) resultPositions.push_back(positions[i]);
+
+    for (const auto& keyBuf : line.getMetaDataBuffers()) {
+        keyBuf.second->getRepresentation<BufferRAM>()
+            ->dispatch<void, dispatching::filter::All>([&](auto ram) {
+                using T = util::PrecisionValueType<decltype(ram)>;
+                const auto& data = ram->getDataContainer();
+                auto& resultData = result.getMetaData<T>(keyBuf.first, true);
+                if (data.size() != positions.size()) {
+                    resultData = data;  // not per vertex, keep as is
+                    return;
+                }
+                resultData.reserve(kept.size());
+                for (auto i : kept) resultData.push_back(data[i]);
+            });
+    }
+
+    result.setIndex(line.getIndex());
+    result.setBackwardTerminationReason(line.getBackwardTerminationReason());
+    result.setForwardTerminationReason(line.getForwardTerminationReason());
+    return result;
+}
+
+}  // namespace simplification
+
+}  // namespace inviwo
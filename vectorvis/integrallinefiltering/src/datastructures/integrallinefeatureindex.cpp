@@ -0,0 +1,129 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/datastructures/integrallinefeatureindex.h>
+
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace inviwo {
+
+IntegralLineFeatureIndex::IntegralLineFeatureIndex(const DataFrame& dataFrame) {
+    const size_t rows = dataFrame.getNumberOfRows();
+
+    std::vector<std::uint32_t> lineIndices(rows);
+    const auto indexColumn = dataFrame.getIndexColumn();
+    indexColumn->getBuffer()
+        ->getRepresentation<BufferRAM>()
+        ->dispatch<void, dispatching::filter::Scalars>([&](auto br) {
+            const auto& data = br->getDataContainer();
+            std::transform(data.begin(), data.begin() + std::min(rows, data.size()),
+                           lineIndices.begin(),
+                           [](auto v) { return static_cast<std::uint32_t>(v); });
+        });
+    if (!lineIndices.empty()) {
+        numberOfLines_ = *std::max_element(lineIndices.begin(), lineIndices.end()) + size_t{1};
+    }
+
+    std::vector<std::shared_ptr<const Column>> columns;
+    for (size_t i = 0; i < dataFrame.getNumberOfColumns(); ++i) {
+        auto column = dataFrame.getColumn(i);
+        if (column == indexColumn || dynamic_cast<const CategoricalColumn*>(column.get())) {
+            continue;
+        }
+        metrics_.push_back({column->getHeader(), {}, {}});
+        columns.push_back(std::move(column));
+    }
+
+    // the columns are sorted independently of each other
+    util::forEachParallel(columns, [&](const auto& column, size_t i) {
+        auto& metric = metrics_[i];
+        std::vector<double> values(rows, std::numeric_limits<double>::quiet_NaN());
+        column->getBuffer()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<void, dispatching::filter::Scalars>([&](auto br) {
+                const auto& data = br->getDataContainer();
+                std::transform(data.begin(), data.begin() + std::min(rows, data.size()),
+                               values.begin(), [](auto v) { return static_cast<double>(v); });
+            });
+
+        std::vector<std::uint32_t> order(rows);
+        std::iota(order.begin(), order.end(), std::uint32_t{0});
+        const auto last = std::partition(order.begin(), order.end(), [&](std::uint32_t row) {
+            return !std::isnan(values[row]);
+        });
+        order.erase(last, order.end());
+        std::sort(order.begin(), order.end(),
+                  [&](std::uint32_t a, std::uint32_t b) { return values[a] < values[b]; });
+
+        metric.values.reserve(order.size());
+        metric.lines.reserve(order.size());
+        for (auto row : order) {
+            metric.values.push_back(values[row]);
+            metric.lines.push_back(lineIndices[row]);
+        }
+    });
+}
+
+size_t IntegralLineFeatureIndex::find(const std::string& name) const {
+    const auto it = std::find_if(metrics_.begin(), metrics_.end(),
+                                 [&](const Metric& metric) { return metric.name == name; });
+    return static_cast<size_t>(std::distance(metrics_.begin(), it));
+}
+
+dvec2 IntegralLineFeatureIndex::getRange(size_t metric) const {
+    const auto& values = metrics_[metric].values;
+    if (values.empty()) return dvec2{0.0};
+    return dvec2{values.front(), values.back()};
+}
+
+auto IntegralLineFeatureIndex::query(size_t metric, double min, double max) const -> LineRange {
+    const auto& m = metrics_[metric];
+    const auto first = std::lower_bound(m.values.begin(), m.values.end(), min);
+    const auto last = std::upper_bound(first, m.values.end(), max);
+    return util::as_range(m.lines.begin() + std::distance(m.values.begin(), first),
+                          m.lines.begin() + std::distance(m.values.begin(), last));
+}
+
+auto IntegralLineFeatureIndex::largest(size_t metric, size_t count) const -> LineRange {
+    const auto& lines = metrics_[metric].lines;
+    return util::as_range(lines.end() - std::min(count, lines.size()), lines.end());
+}
+
+auto IntegralLineFeatureIndex::smallest(size_t metric, size_t count) const -> LineRange {
+    const auto& lines = metrics_[metric].lines;
+    return util::as_range(lines.begin(), lines.begin() + std::min(count, lines.size()));
+}
+
+}  // namespace inviwo
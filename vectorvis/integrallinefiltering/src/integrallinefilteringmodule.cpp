@@ -28,12 +28,24 @@
  *********************************************************************************/
 
 #include <inviwo/integrallinefiltering/integrallinefilteringmodule.h>
+#include <inviwo/integrallinefiltering/processors/integrallineclusteringgl.h>
+#include <inviwo/integrallinefiltering/processors/integrallineentropygl.h>
+#include <inviwo/integrallinefiltering/processors/integrallinefeaturefilter.h>
+#include <inviwo/integrallinefiltering/processors/integrallinesimplification.h>
 #include <inviwo/integrallinefiltering/processors/integrallinestodataframe.h>
 
+#include <modules/opengl/shader/shadermanager.h>
+
 namespace inviwo {
 
 IntegralLineFilteringModule::IntegralLineFilteringModule(InviwoApplication* app)
     : InviwoModule(app, "IntegralLineFiltering") {
+    ShaderManager::getPtr()->addShaderSearchPath(getPath(ModulePath::GLSL));
+
+    registerProcessor<IntegralLineClusteringGL>();
+    registerProcessor<IntegralLineEntropyGL>();
+    registerProcessor<IntegralLineFeatureFilter>();
+    registerProcessor<IntegralLineSimplification>();
     registerProcessor<IntegralLinesToDataFrame>();
 
     registerProperty<IntegralLinesToDataFrame::MetaDataSettings>();
@@ -0,0 +1,288 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/processors/integrallineclusteringgl.h>
+
+#include <inviwo/dataframeclustering/algorithm/clustering.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/shader/shaderobject.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace inviwo {
+
+namespace {
+constexpr size_t workGroupSize = 64;
+// lines per side of a tile of the distance matrix
+constexpr size_t tileSize = 8;
+}  // namespace
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo IntegralLineClusteringGL::processorInfo_{
+    "org.inviwo.IntegralLineClusteringGL",  // Class identifier
+    "Integral Line Clustering GL",          // Display name
+    "Integral Line Filtering",              // Category
+    CodeState::Experimental,                // Code state
+    Tags::GL,                               // Tags
+};
+const ProcessorInfo IntegralLineClusteringGL::getProcessorInfo() const { return processorInfo_; }
+
+IntegralLineClusteringGL::IntegralLineClusteringGL()
+    : PoolProcessor()
+    , lines_("lines")
+    , clusters_("clusters")
+    , distances_("distances")
+    , samples_("samples", "Samples per Line", 16, 2, maxSamples)
+    , distance_("distance", "Distance",
+                {{"rms", "Root Mean Square", Distance::RootMeanSquare},
+                 {"mcp", "Mean Closest Point", Distance::MeanClosestPoint},
+                 {"hausdorff", "Hausdorff", Distance::Hausdorff}},
+                0)
+    , method_("method", "Method",
+              {{"kmeans", "KMeans", Method::KMeans},
+               {"minibatch", "Mini-Batch KMeans", Method::MiniBatchKMeans},
+               {"dbscan", "DBSCAN", Method::DBSCAN}},
+              0)
+    , kmeans_("kmeans", "K-Means")
+    , numberOfClusters_("numberOfClusters", "Number Of Clusters", 3,
+                        {1, ConstraintBehavior::Immutable}, {10, ConstraintBehavior::Ignore})
+    , batchSize_("batchSize", "Batch Size", 1024, {1, ConstraintBehavior::Immutable},
+                 {65536, ConstraintBehavior::Ignore})
+    , dbscan_("dbscan", "DBSCAN")
+    , eps_("eps", "Epsilon", 0.1, {0.0, ConstraintBehavior::Immutable},
+           {1.0, ConstraintBehavior::Ignore}, 0.001)
+    , minPoints_("minPoints", "Min Points", 10, {1, ConstraintBehavior::Immutable},
+                 {100, ConstraintBehavior::Ignore})
+    , resampleShader_({{ShaderType::Compute, "integrallineresample.comp"}}, Shader::Build::No)
+    , distanceShader_({{ShaderType::Compute, "integrallinedistance.comp"}}, Shader::Build::No) {
+
+    addPort(lines_);
+    addPort(clusters_);
+    addPort(distances_);
+
+    kmeans_.addProperties(numberOfClusters_, batchSize_);
+    dbscan_.addProperties(eps_, minPoints_);
+    addProperties(samples_, distance_, method_, kmeans_, dbscan_);
+
+    const auto updateVisibility = [this]() {
+        kmeans_.setVisible(method_.get() != Method::DBSCAN);
+        batchSize_.setVisible(method_.get() == Method::MiniBatchKMeans);
+        dbscan_.setVisible(method_.get() == Method::DBSCAN);
+    };
+    method_.onChange(updateVisibility);
+    updateVisibility();
+
+    resampleShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+    distanceShader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+}
+
+void IntegralLineClusteringGL::initializeResources() {
+    resampleShader_.getShaderObject(ShaderType::Compute)
+        ->addShaderDefine("WORK_GROUP_SIZE", toString(workGroupSize));
+    resampleShader_.build();
+
+    auto compute = distanceShader_.getShaderObject(ShaderType::Compute);
+    compute->addShaderDefine("TILE_SIZE", toString(tileSize));
+    compute->addShaderDefine("MAX_SAMPLES", toString(maxSamples));
+    distanceShader_.build();
+
+    resampled_.reset();
+}
+
+void IntegralLineClusteringGL::process() {
+    const auto lines = lines_.getData();
+    const auto numLines = lines->size();
+    const auto samples = samples_.get();
+
+    // the positions are only uploaded again if the lines change, and the lines are only resampled
+    // again if the number of samples changes as well
+    if (lines_.isChanged() || !positions_) {
+        uploadPositions(*lines);
+        resampled_.reset();
+    }
+    if (samples_.isModified() || !resampled_) {
+        resample(numLines);
+    }
+
+    if (distances_.isConnected()) {
+        distances_.setData(computeDistances(numLines));
+    }
+
+    // features of the clustering, the samples of each line scaled such that the Euclidean
+    // distance of two lines is the root mean square distance of their samples
+    clustering::Features features;
+    features.rows = numLines;
+    features.cols = 3 * samples;
+    features.values.reserve(features.rows * features.cols);
+    const auto scale = 1.0 / std::sqrt(static_cast<double>(samples));
+    const auto& resampled = resampled_->getRAMRepresentation()->getDataContainer();
+    for (size_t i = 0; i < numLines * samples; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            features.values.push_back(scale * static_cast<double>(resampled[i][c]));
+        }
+    }
+
+    // start mini-batch k-means from the previous centers if the features are comparable
+    std::vector<double> centers;
+    if (method_.get() == Method::MiniBatchKMeans && centerSamples_ == samples) {
+        centers = centers_;
+    }
+
+    using Result = std::pair<std::shared_ptr<BufferBase>, std::vector<double>>;
+    auto compute = [features = std::move(features), method = method_.get(),
+                    k = numberOfClusters_.get(), batchSize = batchSize_.get(), eps = eps_.get(),
+                    minPoints = minPoints_.get(),
+                    centers = std::move(centers)](pool::Stop stop,
+                                                  pool::Progress progress) mutable -> Result {
+        const auto onProgress = [&progress](float f) { progress(f); };
+        const auto stopped = [&stop]() { return stop(); };
+
+        std::vector<int> labels;
+        if (features.rows > 0) {
+            k = std::min(k, static_cast<int>(features.rows));
+            switch (method) {
+                case Method::DBSCAN:
+                    labels = clustering::dbscan(features, eps, minPoints, onProgress, stopped);
+                    break;
+                case Method::MiniBatchKMeans:
+                    labels = clustering::miniBatchKMeans(features, k, centers, batchSize, 100,
+                                                         1e-3, 0, onProgress, stopped);
+                    break;
+                case Method::KMeans:
+                default:
+                    labels = clustering::kmeans(features, k, 10, 300, 0, onProgress, stopped);
+                    break;
+            }
+            if (stop()) return {};
+            clustering::remapLabels(labels);
+        }
+        return {util::makeBuffer<int>(std::move(labels)), std::move(centers)};
+    };
+
+    dispatchOne(compute, [this, samples](Result result) {
+        if (!result.first) return;
+        clusters_.setData(result.first);
+        if (method_.get() == Method::MiniBatchKMeans) {
+            centers_ = std::move(result.second);
+            centerSamples_ = samples;
+        }
+        newResults();
+    });
+}
+
+void IntegralLineClusteringGL::uploadPositions(const IntegralLineSet& lines) {
+    std::vector<vec4> positions;
+    std::vector<std::uint32_t> offsets;
+    offsets.reserve(lines.size() + 1);
+    for (const auto& line : lines) {
+        offsets.push_back(static_cast<std::uint32_t>(positions.size()));
+        for (const auto& p : line.getPositions()) {
+            positions.emplace_back(vec3{p}, 1.0f);
+        }
+        if (positions.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw Exception("Too many vertices for the GPU buffers", IVW_CONTEXT);
+        }
+    }
+    offsets.push_back(static_cast<std::uint32_t>(positions.size()));
+    // empty buffers can not be bound
+    if (positions.empty()) positions.emplace_back(0.0f);
+
+    positions_ = std::make_shared<Buffer<vec4>>(
+        std::make_shared<BufferRAMPrecision<vec4>>(std::move(positions)));
+    offsets_ = std::make_shared<Buffer<std::uint32_t>>(
+        std::make_shared<BufferRAMPrecision<std::uint32_t>>(std::move(offsets)));
+}
+
+void IntegralLineClusteringGL::resample(size_t numLines) {
+    const auto samples = samples_.get();
+    resampled_ = std::make_shared<Buffer<vec4>>(std::max<size_t>(numLines * samples, 1),
+                                                BufferUsage::Dynamic);
+    if (numLines == 0) return;
+
+    resampleShader_.activate();
+    resampleShader_.setUniform("numLines", static_cast<int>(numLines));
+    resampleShader_.setUniform("numSamples", static_cast<int>(samples));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                     positions_->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, offsets_->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                     resampled_->getEditableRepresentation<BufferGL>()->getId());
+
+    // one invocation per line
+    const auto numGroups = (numLines + workGroupSize - 1) / workGroupSize;
+    utilgl::dispatchChunked(resampleShader_, numGroups, "offset", workGroupSize);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    resampleShader_.deactivate();
+    LGL_ERROR;
+}
+
+std::shared_ptr<Buffer<float>> IntegralLineClusteringGL::computeDistances(size_t numLines) {
+    if (numLines > maxDistanceLines) {
+        throw Exception(fmt::format("The distance matrix is limited to {} lines, got {}",
+                                    maxDistanceLines, numLines),
+                        IVW_CONTEXT);
+    }
+
+    auto distances = std::make_shared<Buffer<float>>(std::max<size_t>(numLines * numLines, 1),
+                                                     BufferUsage::Dynamic);
+    if (numLines == 0) return distances;
+
+    distanceShader_.activate();
+    distanceShader_.setUniform("numLines", static_cast<int>(numLines));
+    distanceShader_.setUniform("numSamples", static_cast<int>(samples_.get()));
+    distanceShader_.setUniform("measure", static_cast<int>(distance_.get()));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                     resampled_->getRepresentation<BufferGL>()->getId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                     distances->getEditableRepresentation<BufferGL>()->getId());
+
+    // one work group per tile, at most 1024 x 1024 tiles for maxDistanceLines
+    const auto numTiles = static_cast<GLuint>((numLines + tileSize - 1) / tileSize);
+    glDispatchCompute(numTiles, numTiles, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    distanceShader_.deactivate();
+    LGL_ERROR;
+
+    return distances;
+}
+
+}  // namespace inviwo
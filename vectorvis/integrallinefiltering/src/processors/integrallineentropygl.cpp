@@ -0,0 +1,213 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/processors/integrallineentropygl.h>
+
+#include <inviwo/integrallinefiltering/algorithm/uniformspherepartitioning.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/utilitiesgl/util/dispatch.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/util/utilities.h>
+#include <modules/opengl/buffer/buffergl.h>
+#include <modules/opengl/openglutils.h>
+#include <modules/opengl/shader/shaderobject.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace inviwo {
+
+namespace {
+constexpr size_t workGroupSize = 128;
+}  // namespace
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo IntegralLineEntropyGL::processorInfo_{
+    "org.inviwo.IntegralLineEntropyGL",  // Class identifier
+    "Integral Line Entropy GL",          // Display name
+    "Integral Line Filtering",           // Category
+    CodeState::Experimental,             // Code state
+    Tags::GL,                            // Tags
+};
+const ProcessorInfo IntegralLineEntropyGL::getProcessorInfo() const { return processorInfo_; }
+
+IntegralLineEntropyGL::IntegralLineEntropyGL()
+    : Processor()
+    , lines_("lines")
+    , entropy_("entropy")
+    , mode_("mode", "Mode",
+            {{"directional", "Directional", Mode::Directional}, {"scalar", "Scalar", Mode::Scalar}},
+            0)
+    , metaData_("metaData", "Meta Data")
+    , numberOfBins_("numberOfBins", "Number of Bins", 33, 1, maxBins)
+    , normalize_("normalize", "Normalize", true)
+    , shader_({{ShaderType::Compute, "integrallineentropy.comp"}}, Shader::Build::No) {
+
+    addPort(lines_);
+    addPort(entropy_);
+
+    addProperties(mode_, metaData_, numberOfBins_, normalize_);
+
+    lines_.onChange([this]() {
+        auto lines = lines_.getData();
+        if (!lines || lines->size() == 0) return;
+
+        std::vector<OptionPropertyStringOption> options;
+        for (const auto& keyBuf : lines->front().getMetaDataBuffers()) {
+            options.emplace_back(util::stripIdentifier(keyBuf.first), keyBuf.first, keyBuf.first);
+        }
+        metaData_.replaceOptions(options);
+    });
+
+    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+}
+
+void IntegralLineEntropyGL::initializeResources() {
+    auto compute = shader_.getShaderObject(ShaderType::Compute);
+    compute->addShaderDefine("WORK_GROUP_SIZE", toString(workGroupSize));
+    compute->addShaderDefine("MAX_BINS", toString(maxBins));
+    shader_.build();
+}
+
+void IntegralLineEntropyGL::process() {
+    const auto lines = lines_.getData();
+    const auto numLines = lines->size();
+
+    // the values are only uploaded again if the lines or the selected meta data change, the
+    // other properties only require the shader to run again
+    if (lines_.isChanged() || mode_.isModified() || metaData_.isModified() || !values_) {
+        uploadValues(*lines);
+    }
+    if (mode_.get() == Mode::Directional && collarBins_ != numberOfBins_.get()) {
+        uploadCollars();
+    }
+
+    auto entropy = std::make_shared<Buffer<float>>(numLines, BufferUsage::Dynamic);
+
+    if (numLines > 0) {
+        shader_.activate();
+        shader_.setUniform("numLines", static_cast<int>(numLines));
+        shader_.setUniform("numBins", static_cast<int>(numberOfBins_.get()));
+        shader_.setUniform("mode", static_cast<int>(mode_.get()));
+        shader_.setUniform("normalizeEntropy", normalize_.get());
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0,
+                         values_->getRepresentation<BufferGL>()->getId());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                         offsets_->getRepresentation<BufferGL>()->getId());
+        if (mode_.get() == Mode::Directional) {
+            shader_.setUniform("numCollars", static_cast<int>(collars_->getSize()));
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                             collars_->getRepresentation<BufferGL>()->getId());
+        } else {
+            // the collars are not accessed for scalars, any buffer can be bound
+            shader_.setUniform("numCollars", 0);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                             values_->getRepresentation<BufferGL>()->getId());
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3,
+                         entropy->getEditableRepresentation<BufferGL>()->getId());
+
+        // one work group per line
+        utilgl::dispatchChunked(shader_, numLines, "offset");
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                        GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        shader_.deactivate();
+        LGL_ERROR;
+    }
+
+    entropy_.setData(entropy);
+}
+
+void IntegralLineEntropyGL::uploadValues(const IntegralLineSet& lines) {
+    const auto& name = metaData_.get();
+    const auto mode = mode_.get();
+
+    std::vector<vec4> values;
+    std::vector<std::uint32_t> offsets;
+    offsets.reserve(lines.size() + 1);
+    for (const auto& line : lines) {
+        offsets.push_back(static_cast<std::uint32_t>(values.size()));
+        if (!line.hasMetaData(name)) continue;
+
+        line.getMetaDataBuffer(name)
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<void, dispatching::filter::All>([&](auto ram) {
+                using T = util::PrecisionValueType<decltype(ram)>;
+                constexpr size_t components = util::extent<T>::value;
+                if (mode == Mode::Directional && components != 3) {
+                    throw Exception(fmt::format("Directional entropy requires 3D vectors, '{}' "
+                                                "has {} component(s)",
+                                                name, components),
+                                    IVW_CONTEXT);
+                }
+                for (const auto& v : ram->getDataContainer()) {
+                    vec4 value{0.0f};
+                    double magnitude = 0.0;
+                    for (size_t i = 0; i < components; ++i) {
+                        const auto c = static_cast<double>(util::glmcomp(v, i));
+                        if (i < 3) value[i] = static_cast<float>(c);
+                        magnitude += c * c;
+                    }
+                    // the magnitude of vectors is binned for scalar entropy
+                    if (mode == Mode::Scalar) value.x = static_cast<float>(std::sqrt(magnitude));
+                    values.push_back(value);
+                }
+            });
+        if (values.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw Exception("Too many vertices for the GPU buffers", IVW_CONTEXT);
+        }
+    }
+    offsets.push_back(static_cast<std::uint32_t>(values.size()));
+    // empty buffers can not be bound
+    if (values.empty()) values.emplace_back(0.0f);
+
+    values_ = std::make_shared<Buffer<vec4>>(
+        std::make_shared<BufferRAMPrecision<vec4>>(std::move(values)));
+    offsets_ = std::make_shared<Buffer<std::uint32_t>>(
+        std::make_shared<BufferRAMPrecision<std::uint32_t>>(std::move(offsets)));
+}
+
+void IntegralLineEntropyGL::uploadCollars() {
+    std::vector<vec4> collars;
+    for (const auto& [cosAngle, patches, startIndex] :
+         UniformSpherePartitioning<double>::get(numberOfBins_.get())->getCollars()) {
+        collars.emplace_back(static_cast<float>(cosAngle), static_cast<float>(patches),
+                             static_cast<float>(startIndex), 0.0f);
+    }
+    collars_ = std::make_shared<Buffer<vec4>>(
+        std::make_shared<BufferRAMPrecision<vec4>>(std::move(collars)));
+    collarBins_ = numberOfBins_.get();
+}
+
+}  // namespace inviwo
@@ -0,0 +1,130 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/processors/integrallinefeaturefilter.h>
+
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/utilities.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo IntegralLineFeatureFilter::processorInfo_{
+    "org.inviwo.IntegralLineFeatureFilter",  // Class identifier
+    "Integral Line Feature Filter",          // Display name
+    "Integral Line Filtering",               // Category
+    CodeState::Experimental,                 // Code state
+    Tags::CPU,                               // Tags
+};
+const ProcessorInfo IntegralLineFeatureFilter::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+IntegralLineFeatureFilter::IntegralLineFeatureFilter()
+    : Processor()
+    , dataFrame_("dataFrame")
+    , brushing_("brushing")
+    , mask_("mask")
+    , metric_("metric", "Metric")
+    , selection_("selection", "Selection",
+                 {{"range", "Range", Selection::Range},
+                  {"largest", "Largest Values", Selection::Largest},
+                  {"smallest", "Smallest Values", Selection::Smallest}},
+                 0)
+    , range_("range", "Range", 0.0, 1.0, 0.0, 1.0)
+    , count_("count", "Number of Lines", 100, 0, 10000) {
+
+    addPort(dataFrame_);
+    addPort(brushing_);
+    addPort(mask_);
+    brushing_.setOptional(true);
+
+    addProperties(metric_, selection_, range_, count_);
+
+    range_.visibilityDependsOn(selection_,
+                               [](const auto& p) { return p.get() == Selection::Range; });
+    count_.visibilityDependsOn(selection_,
+                               [](const auto& p) { return p.get() != Selection::Range; });
+}
+
+void IntegralLineFeatureFilter::process() {
+    // sorting is only done when the data changes, other changes are answered from the index
+    if (dataFrame_.isChanged()) {
+        index_ = IntegralLineFeatureIndex(*dataFrame_.getData());
+
+        std::vector<OptionPropertyStringOption> options;
+        for (size_t i = 0; i < index_.numberOfMetrics(); ++i) {
+            const auto& name = index_.getName(i);
+            options.emplace_back(util::stripIdentifier(toLower(name)), name, name);
+        }
+        metric_.replaceOptions(options);
+    }
+
+    const auto metric = index_.find(metric_.get());
+    if (metric < index_.numberOfMetrics()) {
+        if (dataFrame_.isChanged() || metric_.isModified()) {
+            range_.setRange(index_.getRange(metric));
+        }
+        count_.setMaxValue(std::max<size_t>(index_.numberOfLines(), 1));
+    }
+
+    std::vector<std::uint32_t> mask(index_.numberOfLines(), 0);
+    if (metric < index_.numberOfMetrics()) {
+        const auto lines = [&]() {
+            switch (selection_.get()) {
+                case Selection::Largest:
+                    return index_.largest(metric, count_.get());
+                case Selection::Smallest:
+                    return index_.smallest(metric, count_.get());
+                case Selection::Range:
+                default:
+                    return index_.query(metric, range_.get().x, range_.get().y);
+            }
+        }();
+        for (auto line : lines) {
+            mask[line] = 1;
+        }
+    }
+
+    if (brushing_.isConnected()) {
+        std::unordered_set<size_t> filtered;
+        for (size_t line = 0; line < mask.size(); ++line) {
+            if (!mask[line]) filtered.insert(line);
+        }
+        brushing_.sendFilterEvent(filtered);
+    }
+
+    mask_.setData(std::make_shared<Buffer<std::uint32_t>>(
+        std::make_shared<BufferRAMPrecision<std::uint32_t>>(std::move(mask))));
+}
+
+}  // namespace inviwo
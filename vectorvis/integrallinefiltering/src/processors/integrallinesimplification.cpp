@@ -0,0 +1,82 @@
+﻿/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/processors/integrallinesimplification.h>
+#include <inviwo/integrallinefiltering/algorithm/linesimplification.h>
+
+#include <inviwo/core/util/foreach.h>
+
+namespace inviwo {
+
+// The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
+const ProcessorInfo IntegralLineSimplification::processorInfo_{
+    "org.inviwo.IntegralLineSimplification",  // Class identifier
+    "Integral Line Simplification",           // Display name
+    "Integral Line Filtering",                // Category
+    CodeState::Experimental,                  // Code state
+    Tags::CPU,                                // Tags
+};
+const ProcessorInfo IntegralLineSimplification::getProcessorInfo() const {
+    return processorInfo_;
+}
+
+IntegralLineSimplification::IntegralLineSimplification()
+    : Processor()
+    , lines_("lines")
+    , simplified_("simplified")
+    , tolerance_("tolerance", "Tolerance", 0.001, 0.0, 1.0, 0.0001)
+    , metaDataTolerance_("metaDataTolerance", "Meta Data Tolerance", 0.0, 0.0, 10.0, 0.001) {
+
+    addPort(lines_);
+    addPort(simplified_);
+
+    addProperties(tolerance_, metaDataTolerance_);
+}
+
+void IntegralLineSimplification::process() {
+    const auto lines = lines_.getData();
+    const auto tolerance = tolerance_.get();
+    const auto metaDataTolerance = metaDataTolerance_.get();
+
+    // one slot per line, no synchronization needed
+    std::vector<IntegralLine> simplified(lines->size());
+    util::forEachParallel(*lines, [&](const IntegralLine& line, size_t i) {
+        simplified[i] = simplification::simplify(line, tolerance, metaDataTolerance);
+    });
+
+    auto result =
+        std::make_shared<IntegralLineSet>(lines->getModelMatrix(), lines->getWorldMatrix());
+    for (auto& line : simplified) {
+        const auto index = line.getIndex();
+        result->push_back(std::move(line), index);
+    }
+    simplified_.setData(result);
+}
+
+}  // namespace inviwo
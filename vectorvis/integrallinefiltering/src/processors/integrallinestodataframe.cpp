@@ -29,10 +29,109 @@
 
 #include <inviwo/integrallinefiltering/processors/integrallinestodataframe.h>
 
+#include <inviwo/integrallinefiltering/algorithm/linemetrics.h>
 #include <inviwo/integrallinefiltering/algorithm/shannonentropy.h>
+#include <inviwo/utilities/util/parallel.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
 
 namespace inviwo {
 
+namespace detail {
+
+template <typename T>
+std::vector<T>& createColumn(DataFrame& df, std::string name, size_t rows) {
+    auto& data = df.addColumn<T>(name)
+                     ->getTypedBuffer()
+                     ->getEditableRAMRepresentation()
+                     ->getDataContainer();
+    data.resize(rows);
+    return data;
+}
+
+// Columns of the statistics of one channel of a meta data buffer, i.e. its magnitude or one of
+// its components
+struct ChannelColumns {
+    int component;  // -1 for the magnitude
+    float* avg = nullptr;
+    float* sd = nullptr;
+    std::vector<float*> percentiles;
+};
+
+template <typename T>
+float channelValue(const T& v, int component) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        return static_cast<float>(v);
+    } else {
+        if (component >= 0) return static_cast<float>(util::glmcomp(v, component));
+        float l = 0;
+        for (size_t i = 0; i < util::extent<T>::value; i++) {
+            l += static_cast<float>(util::glmcomp(v, i) * util::glmcomp(v, i));
+        }
+        return std::sqrt(l);
+    }
+}
+
+/*
+ * Statistics of the values of the inner vertices of a line, the first and last vertex are
+ * excluded. The values of each channel are gathered once into the scratch buffer. The mean and
+ * standard deviation are then computed in two passes over it, and the percentiles are selected
+ * with nth_element in order of increasing percentiles, each on the range right of the previous.
+ */
+template <typename T>
+IntegralLinesToDataFrame::MetricCalcFunction createKernel(std::string name, bool log,
+                                                          std::vector<ChannelColumns> channels,
+                                                          std::vector<double> percentiles) {
+    std::vector<size_t> order(percentiles.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return percentiles[a] < percentiles[b]; });
+
+    return [name = std::move(name), log, channels = std::move(channels),
+            percentiles = std::move(percentiles),
+            order = std::move(order)](const IntegralLine& line, size_t row,
+                                      std::vector<float>& values) {
+        const auto& vec = line.getMetaData<T>(name);
+        const size_t n = vec.size() > 2 ? vec.size() - 2 : 0;
+        values.resize(n);
+
+        for (const auto& channel : channels) {
+            for (size_t i = 0; i < n; ++i) {
+                const float v = channelValue(vec[i + 1], channel.component);
+                values[i] = log ? std::log(1 + v) : v;
+            }
+
+            if (channel.avg || channel.sd) {
+                double sum = 0.0;
+                for (auto v : values) sum += v;
+                const double mean = sum / std::max(size_t(1), n);
+                if (channel.avg) channel.avg[row] = static_cast<float>(mean);
+                if (channel.sd) {
+                    double sq = 0.0;
+                    for (auto v : values) sq += (v - mean) * (v - mean);
+                    channel.sd[row] = n > 1 ? static_cast<float>(std::sqrt(sq / (n - 1))) : 0.0f;
+                }
+            }
+
+            auto first = values.begin();
+            for (auto i : order) {
+                if (n == 0) {
+                    channel.percentiles[i][row] = std::numeric_limits<float>::quiet_NaN();
+                    continue;
+                }
+                const auto nth = values.begin() + static_cast<size_t>(percentiles[i] * (n - 1));
+                std::nth_element(first, nth, values.end());
+                first = nth;
+                channel.percentiles[i][row] = *nth;
+            }
+        }
+    };
+}
+
+}  // namespace detail
+
 IntegralLinesToDataFrame::MetaDataSettings::MetaDataSettings(std::string identifier,
                                                              std::string displayName)
     : BoolCompositeProperty(identifier, displayName, true) {
@@ -93,7 +192,8 @@ void IntegralLinesToDataFrame::MetaDataSettings::updateDataFormat(const DataForm
 }
 
 void IntegralLinesToDataFrame::MetaDataSettings::initFunctions(
-    std::vector<MetricCalcFunction>& funcs, const BufferRAM* ram, DataFrame& dataFrame) {
+    std::vector<MetricCalcFunction>& funcs, const BufferRAM* ram, DataFrame& dataFrame,
+    size_t rows) {
 
     if (!isChecked()) {
         return;
@@ -123,48 +223,37 @@ void IntegralLinesToDataFrame::MetaDataSettings::initFunctions(
         return;
     }
 
-    if (c == 1) {  // scalars
-        ram->dispatch<void, dispatching::filter::Scalars>([=, &funcs, df = &dataFrame](auto ramT) {
-            using T = typename util::PrecisionValueType<decltype(ramT)>;
-            createFunction<T>(funcs, *df, percentiles, name,
-                              [=](const T& v) -> float { return static_cast<float>(v); });
-        });
+    auto addChannel = [&](int component, const std::string& channelName) {
+        detail::ChannelColumns channel{component};
+        auto addColumn = [&](const std::string& columnName) {
+            return detail::createColumn<float>(dataFrame, columnName, rows).data();
+        };
+        if (avg_.get()) channel.avg = addColumn(channelName + u8" μ");
+        if (sd_.get()) channel.sd = addColumn(channelName + u8" σ");
+        for (auto p : percentiles) {
+            const auto columnName = channelName + " (p:" + std::to_string(p) + ")";
+            channel.percentiles.push_back(addColumn(columnName));
+        }
+        return channel;
+    };
 
+    std::vector<detail::ChannelColumns> channels;
+    if (c == 1) {  // scalars
+        channels.push_back(addChannel(0, name));
     } else {  // vectors
-        return ram->dispatch<void, dispatching::filter::Vecs>([this, &funcs, name, percentiles, c,
-                                                               df = &dataFrame](auto ramT) {
-            using T = typename util::PrecisionValueType<decltype(ramT)>;
-            if (useMagnitude_.get()) {
-                createFunction<T>(funcs, *df, percentiles, name + "", [c](const T& v) -> float {
-                    float l = 0;
-                    for (size_t i = 0; i < c; i++) {
-                        l += static_cast<float>(util::glmcomp(v, i) * util::glmcomp(v, i));
-                    }
-                    return std::sqrt(l);
-                });
-            }
-            if (x_.get()) {
-                createFunction<T>(funcs, *df, percentiles, name + "-x", [](const T& v) -> float {
-                    return static_cast<float>(util::glmcomp(v, 0));
-                });
-            }
-            if (y_.get()) {
-                createFunction<T>(funcs, *df, percentiles, name + "-y", [](const T& v) -> float {
-                    return static_cast<float>(util::glmcomp(v, 1));
-                });
-            }
-            if (z_.get()) {
-                createFunction<T>(funcs, *df, percentiles, name + "-w", [](const T& v) -> float {
-                    return static_cast<float>(util::glmcomp(v, 2));
-                });
-            }
-            if (w_.get()) {
-                createFunction<T>(funcs, *df, percentiles, name + "-z", [](const T& v) -> float {
-                    return static_cast<float>(util::glmcomp(v, 3));
-                });
-            }
-        });
+        if (useMagnitude_.get()) channels.push_back(addChannel(-1, name));
+        if (x_.get()) channels.push_back(addChannel(0, name + "-x"));
+        if (y_.get()) channels.push_back(addChannel(1, name + "-y"));
+        if (z_.get() && c > 2) channels.push_back(addChannel(2, name + "-z"));
+        if (w_.get() && c > 3) channels.push_back(addChannel(3, name + "-w"));
     }
+    if (channels.empty()) return;
+
+    ram->dispatch<void, dispatching::filter::All>([&](auto ramT) {
+        using T = typename util::PrecisionValueType<decltype(ramT)>;
+        funcs.push_back(
+            detail::createKernel<T>(name, log_.get(), std::move(channels), percentiles));
+    });
 }
 
 const std::string IntegralLinesToDataFrame::MetaDataSettings::classIdentifier =
@@ -190,6 +279,8 @@ IntegralLinesToDataFrame::IntegralLinesToDataFrame()
 
     , includeLineLength_("includeLineLength", "Include Line Length", true)
     , includeTortuosity_("includeTurtuosity", "Include Tortuosity", true)
+    , includeCurvature_("includeCurvature", "Include Curvature", false)
+    , includeTorsion_("includeTorsion", "Include Torsion", false)
     , includeTerminationReason_("includeTerminationReason", "Include Termination Reasons", true)
     , includeEntropy_("includeEntropy", "Include Entropy", true)
     , includeStartPositions_("includeStartPositions", "Include Line Start Coordinates", false)
@@ -199,8 +290,8 @@ IntegralLinesToDataFrame::IntegralLinesToDataFrame()
     addPort(dataframe_);
 
     addProperties(includeLineID_, includeNumberOfPoints_, includeLineLength_, includeTortuosity_,
-                  includeTerminationReason_, includeEntropy_, includeStartPositions_,
-                  includeEndPositions_, metaDataSettings_);
+                  includeCurvature_, includeTorsion_, includeTerminationReason_, includeEntropy_,
+                  includeStartPositions_, includeEndPositions_, metaDataSettings_);
 
     lines_.onChange([this]() {
         if (auto lines = lines_.getData()) {
@@ -219,16 +310,6 @@ IntegralLinesToDataFrame::IntegralLinesToDataFrame()
     });
 }
 
-namespace detail {
-template <typename T>
-std::vector<T>& createColumn(DataFrame& df, std::string name) {
-    return df.addColumn<T>(name)
-        ->getTypedBuffer()
-        ->getEditableRAMRepresentation()
-        ->getDataContainer();
-}
-}  // namespace detail
-
 void IntegralLinesToDataFrame::process() {
     auto lines = lines_.getData();
 
@@ -238,117 +319,129 @@ void IntegralLinesToDataFrame::process() {
 
         const auto& firstLine = lines->front();
 
-        std::vector<std::function<void(const IntegralLine& line)>> funcs;
-
-        if (includeLineID_.get()) {
-            auto& ids = detail::createColumn<glm::uint32>(*df, "Line ID");
-            funcs.push_back([&ids](const IntegralLine& line) {
-                ids.emplace_back((glm::uint32)line.getIndex());
-            });
+        // one row per line with at least two vertices
+        std::vector<const IntegralLine*> rows;
+        rows.reserve(lines->size());
+        for (const auto& line : *lines) {
+            if (line.getPositions().size() >= 2) {
+                rows.push_back(&line);
+            }
         }
+        const size_t n = rows.size();
 
-        if (includeNumberOfPoints_.get()) {
-            auto& numPoints = detail::createColumn<glm::uint32>(*df, "#Points");
-            funcs.push_back([&numPoints](const IntegralLine& line) {
-                numPoints.emplace_back(static_cast<uint32_t>(line.getPositions().size()));
-            });
-        }
+        // the columns are preallocated and filled in parallel, nullptr if not included
+        auto column = [&](bool include, const std::string& name) -> float* {
+            return include ? detail::createColumn<float>(*df, name, n).data() : nullptr;
+        };
 
-        if (includeLineLength_.get()) {
-            auto& lengths = detail::createColumn<float>(*df, "Length");
-            funcs.push_back([&lengths](const IntegralLine& line) {
-                lengths.push_back(static_cast<float>(line.getLength()));
-            });
-        }
-        if (includeTortuosity_.get()) {
-            auto& tortuosities = detail::createColumn<float>(*df, "Tortuosity");
-            funcs.push_back([&tortuosities](const IntegralLine& line) {
-                double v = glm::length(line.getPositions().front() - line.getPositions().back());
-                tortuosities.emplace_back(static_cast<float>(line.getLength() / v));
-            });
+        glm::uint32* ids = nullptr;
+        if (includeLineID_.get()) {
+            ids = detail::createColumn<glm::uint32>(*df, "Line ID", n).data();
         }
-
-        if (firstLine.hasMetaData("timestamp")) {
-            auto& startTimes = detail::createColumn<float>(*df, "StartTimes");
-            auto& endTimes = detail::createColumn<float>(*df, "EndTimes");
-            auto& durations = detail::createColumn<float>(*df, "Durations");
-
-            funcs.push_back([&startTimes, &endTimes, &durations](const IntegralLine& line) {
-                line.getMetaDataBuffer("timestamp")
-                    ->getRepresentation<BufferRAM>()
-                    ->dispatch<void, dispatching::filter::Scalars>(
-                        [&startTimes, &endTimes, &durations](auto ram) {
-                            auto a = static_cast<float>(ram->getDataContainer().front());
-                            auto b = static_cast<float>(ram->getDataContainer().back());
-                            startTimes.emplace_back(a);
-                            endTimes.emplace_back(b);
-                            durations.emplace_back(std::abs(b - a));
-                        });
-            });
+        glm::uint32* numPoints = nullptr;
+        if (includeNumberOfPoints_.get()) {
+            numPoints = detail::createColumn<glm::uint32>(*df, "#Points", n).data();
         }
-
+        float* lengths = column(includeLineLength_.get(), "Length");
+        float* tortuosities = column(includeTortuosity_.get(), "Tortuosity");
+        float* meanCurvatures = column(includeCurvature_.get(), "Mean Curvature");
+        float* maxCurvatures = column(includeCurvature_.get(), "Max Curvature");
+        float* meanTorsions = column(includeTorsion_.get(), "Mean Torsion");
+        const bool geometric = lengths || tortuosities || meanCurvatures || meanTorsions;
+
+        const bool timestamps = firstLine.hasMetaData("timestamp");
+        float* startTimes = column(timestamps, "StartTimes");
+        float* endTimes = column(timestamps, "EndTimes");
+        float* durations = column(timestamps, "Durations");
+
+        // categorical columns are filled serially afterwards
+        std::shared_ptr<CategoricalColumn> fwdTerminationReason;
+        std::shared_ptr<CategoricalColumn> bwdTerminationReason;
         if (includeTerminationReason_.get()) {
-            auto fwdTarminationReason = df->addCategoricalColumn("Termination Reason (fwd)");
-            auto bwdTarminationReason = df->addCategoricalColumn("Termination Reason (bwd)");
-
-            funcs.push_back(
-                [fwd = fwdTarminationReason, bwd = bwdTarminationReason](const IntegralLine& line) {
-                    fwd->add(inviwo::toString(line.getForwardTerminationReason()));
-                    bwd->add(inviwo::toString(line.getBackwardTerminationReason()));
-                });
+            fwdTerminationReason = df->addCategoricalColumn("Termination Reason (fwd)");
+            bwdTerminationReason = df->addCategoricalColumn("Termination Reason (bwd)");
         }
 
-        if (includeEntropy_.get()) {
-            if (firstLine.hasMetaData("velocity")) {
-                auto& entropies = detail::createColumn<float>(*df, "Entropy");
-                funcs.push_back([&](const IntegralLine& line) {
-                    entropies.push_back(static_cast<float>(entropy::shannonEntropyDirectional(
-                        line.getMetaData<dvec3>("velocity"), 33)));
-                });
-            }
-        }
+        float* entropies =
+            column(includeEntropy_.get() && firstLine.hasMetaData("velocity"), "Entropy");
 
-        if (includeStartPositions_.get()) {
-            auto& startXs = detail::createColumn<float>(*df, "StartX");
-            auto& startYs = detail::createColumn<float>(*df, "StartY");
-            auto& startZs = detail::createColumn<float>(*df, "StartZ");
-            funcs.push_back([&](const IntegralLine& line) {
-                const auto& s = line.getPositions().front();
-                startXs.push_back((float)s.x);
-                startYs.push_back((float)s.y);
-                startZs.push_back((float)s.z);
-            });
-        }
-
-        if (includeEndPositions_.get()) {
-            auto& endXs = detail::createColumn<float>(*df, "EndX");
-            auto& endYs = detail::createColumn<float>(*df, "EndY");
-            auto& endZs = detail::createColumn<float>(*df, "EndZ");
-            funcs.push_back([&](const IntegralLine& line) {
-                const auto& e = line.getPositions().back();
-                endXs.push_back((float)e.x);
-                endYs.push_back((float)e.y);
-                endZs.push_back((float)e.z);
-            });
-        }
+        float* startXs = column(includeStartPositions_.get(), "StartX");
+        float* startYs = column(includeStartPositions_.get(), "StartY");
+        float* startZs = column(includeStartPositions_.get(), "StartZ");
+        float* endXs = column(includeEndPositions_.get(), "EndX");
+        float* endYs = column(includeEndPositions_.get(), "EndY");
+        float* endZs = column(includeEndPositions_.get(), "EndZ");
 
+        std::vector<MetricCalcFunction> funcs;
         for (const auto& keyBuf : firstLine.getMetaDataBuffers()) {
             auto prop = geMetaDataSettings(keyBuf.first);
-            prop->initFunctions(funcs, keyBuf.second->getRepresentation<BufferRAM>(), *df);
+            prop->initFunctions(funcs, keyBuf.second->getRepresentation<BufferRAM>(), *df, n);
         }
 
         auto& idBuf = df->getIndexColumn()
                           ->getTypedBuffer()
                           ->getEditableRAMRepresentation()
                           ->getDataContainer();
-        idBuf.clear();
-        for (const auto& line : *lines) {
-            if (line.getPositions().size() < 2) {
-                continue;
+        idBuf.resize(n);
+
+        util::forEachRangeParallel(n, 256, [&](size_t begin, size_t end) {
+            std::vector<float> scratch;
+            linemetrics::GeometricScratch geometricScratch;
+            for (size_t row = begin; row < end; ++row) {
+                const auto& line = *rows[row];
+                const auto& positions = line.getPositions();
+
+                idBuf[row] = static_cast<uint32_t>(line.getIndex());
+                if (ids) ids[row] = static_cast<glm::uint32>(line.getIndex());
+                if (numPoints) numPoints[row] = static_cast<glm::uint32>(positions.size());
+                if (geometric) {
+                    const auto metrics = linemetrics::geometricMetrics(positions, geometricScratch);
+                    if (lengths) lengths[row] = static_cast<float>(metrics.arcLength);
+                    if (tortuosities) tortuosities[row] = static_cast<float>(metrics.tortuosity);
+                    if (meanCurvatures) {
+                        meanCurvatures[row] = static_cast<float>(metrics.meanCurvature);
+                        maxCurvatures[row] = static_cast<float>(metrics.maxCurvature);
+                    }
+                    if (meanTorsions) meanTorsions[row] = static_cast<float>(metrics.meanTorsion);
+                }
+                if (timestamps) {
+                    line.getMetaDataBuffer("timestamp")
+                        ->getRepresentation<BufferRAM>()
+                        ->dispatch<void, dispatching::filter::Scalars>([&](auto ram) {
+                            const auto a = static_cast<float>(ram->getDataContainer().front());
+                            const auto b = static_cast<float>(ram->getDataContainer().back());
+                            startTimes[row] = a;
+                            endTimes[row] = b;
+                            durations[row] = std::abs(b - a);
+                        });
+                }
+                if (entropies) {
+                    entropies[row] = static_cast<float>(entropy::shannonEntropyDirectional(
+                        line.getMetaData<dvec3>("velocity"), 33));
+                }
+                if (startXs) {
+                    const auto& s = positions.front();
+                    startXs[row] = static_cast<float>(s.x);
+                    startYs[row] = static_cast<float>(s.y);
+                    startZs[row] = static_cast<float>(s.z);
+                }
+                if (endXs) {
+                    const auto& e = positions.back();
+                    endXs[row] = static_cast<float>(e.x);
+                    endYs[row] = static_cast<float>(e.y);
+                    endZs[row] = static_cast<float>(e.z);
+                }
+
+                for (auto& fun : funcs) {
+                    fun(line, row, scratch);
+                }
             }
-            idBuf.push_back(static_cast<uint32_t>(line.getIndex()));
-            for (auto& fun : funcs) {
-                fun(line);
+        });
+
+        if (includeTerminationReason_.get()) {
+            for (auto line : rows) {
+                fwdTerminationReason->add(inviwo::toString(line->getForwardTerminationReason()));
+                bwdTerminationReason->add(inviwo::toString(line->getBackwardTerminationReason()));
             }
         }
     }
@@ -0,0 +1,165 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/integrallinefiltering/datastructures/sparsehistogram.h>
+#include <inviwo/integrallinefiltering/algorithm/shannonentropy.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <benchmark/benchmark.h>
+#include <warn/pop>
+
+#include <random>
+#include <unordered_map>
+
+/*
+ * Compares SparseHistogram to the std::unordered_map it used to be based on, for the index types
+ * of the SparseHistogram tests. Each iteration fills one histogram per line, the number of
+ * samples per line is the benchmark argument.
+ */
+
+using namespace inviwo;
+
+namespace {
+
+constexpr size_t numLines = 1000;
+
+template <typename IndexType>
+std::vector<IndexType> randomBins(size_t count, int range) {
+    std::mt19937 rand;
+    std::uniform_int_distribution<int> dist(-range, range);
+    std::vector<IndexType> bins(count);
+    for (auto& bin : bins) {
+        if constexpr (std::is_integral_v<IndexType>) {
+            bin = static_cast<IndexType>(std::abs(dist(rand)));
+        } else {
+            for (glm::length_t i = 0; i < IndexType::length(); ++i) {
+                bin[i] = static_cast<typename IndexType::value_type>(std::abs(dist(rand)));
+            }
+        }
+    }
+    return bins;
+}
+
+template <typename Histogram, bool Reuse, typename IndexType>
+void fillHistograms(benchmark::State& state, int range) {
+    const auto samples = static_cast<size_t>(state.range(0));
+    const auto bins = randomBins<IndexType>(samples, range);
+    Histogram reused;
+    for (auto _ : state) {
+        for (size_t line = 0; line < numLines; ++line) {
+            if constexpr (Reuse) {
+                reused.clear();
+                for (const auto& bin : bins) reused[bin]++;
+                benchmark::DoNotOptimize(reused);
+            } else {
+                Histogram histogram;
+                for (const auto& bin : bins) histogram[bin]++;
+                benchmark::DoNotOptimize(histogram);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numLines * samples);
+}
+
+template <typename IndexType>
+void unorderedMap(benchmark::State& state) {
+    fillHistograms<std::unordered_map<IndexType, size_t>, false, IndexType>(state, 16);
+}
+template <typename IndexType>
+void sparseHistogram(benchmark::State& state) {
+    fillHistograms<SparseHistogram<IndexType>, false, IndexType>(state, 16);
+}
+template <typename IndexType>
+void sparseHistogramReused(benchmark::State& state) {
+    fillHistograms<SparseHistogram<IndexType>, true, IndexType>(state, 16);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(unorderedMap, int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogram, int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogramReused, int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(unorderedMap, unsigned int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogram, unsigned int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogramReused, unsigned int)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(unorderedMap, ivec2)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogram, ivec2)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogramReused, ivec2)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(unorderedMap, size3_t)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogram, size3_t)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(sparseHistogramReused, size3_t)->Arg(64)->Arg(1024);
+
+// fill, zero one bin, and remove the empty bins, like the SizeAndCleanup test
+static void sparseHistogramCleanup(benchmark::State& state) {
+    const auto bins = randomBins<int>(static_cast<size_t>(state.range(0)), 64);
+    for (auto _ : state) {
+        SparseHistogram<int> histogram;
+        for (auto bin : bins) histogram[bin]++;
+        histogram[bins.front()] = 0;
+        histogram.cleanup();
+        benchmark::DoNotOptimize(histogram.numberOfBins());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(sparseHistogramCleanup)->Arg(64)->Arg(1024);
+
+static void entropyEuclidean(benchmark::State& state) {
+    std::mt19937 rand;
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<dvec3> points(static_cast<size_t>(state.range(0)));
+    for (auto& p : points) p = dvec3(dist(rand), dist(rand), dist(rand));
+    for (auto _ : state) {
+        for (size_t line = 0; line < numLines; ++line) {
+            benchmark::DoNotOptimize(entropy::shannonEntropyEuclidean(points, 0.1));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numLines * state.range(0));
+}
+BENCHMARK(entropyEuclidean)->Arg(64)->Arg(1024);
+
+static void entropyScalars(benchmark::State& state) {
+    std::mt19937 rand;
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> values(static_cast<size_t>(state.range(0)));
+    for (auto& v : values) v = dist(rand);
+    for (auto _ : state) {
+        for (size_t line = 0; line < numLines; ++line) {
+            benchmark::DoNotOptimize(entropy::shannonEntropyScalars(values, 32));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numLines * state.range(0));
+}
+BENCHMARK(entropyScalars)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <inviwo/integrallinefiltering/datastructures/directionalhistogram.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <random>
+
+namespace inviwo {
+
+TEST(DirectionalHistogramTest, Batch2DMatchesAtan2) {
+    std::mt19937 rand;
+    std::normal_distribution<float> dist;
+
+    std::vector<vec2> directions{vec2(1, 0),  vec2(-1, 0),    vec2(0, 1),
+                                 vec2(0, -1), vec2(-1, -0.f), vec2(0, 0)};
+    for (size_t i = 0; i < 100000; ++i) {
+        directions.emplace_back(dist(rand), dist(rand));
+    }
+
+    for (size_t numberOfBins : {1, 4, 20, 360}) {
+        std::vector<size_t> expected(numberOfBins, 0);
+        for (const auto& dir : directions) {
+            expected[histogram::detail::exactDirectionalBin(dir, numberOfBins)]++;
+        }
+        EXPECT_EQ(histogram::calculateDirectionalHistogram(directions, numberOfBins), expected)
+            << "bins " << numberOfBins;
+    }
+}
+
+TEST(DirectionalHistogramTest, BatchOfLines) {
+    std::mt19937 rand;
+    std::normal_distribution<double> dist;
+    std::uniform_int_distribution<size_t> length(0, 600);
+
+    std::vector<dvec3> directions;
+    std::vector<size_t> offsets{0};
+    for (size_t line = 0; line < 50; ++line) {
+        for (size_t i = length(rand); i > 0; --i) {
+            directions.emplace_back(dist(rand), dist(rand), dist(rand));
+        }
+        offsets.push_back(directions.size());
+    }
+    const size_t numberOfLines = offsets.size() - 1;
+    const size_t numberOfBins = 33;
+
+    std::vector<size_t> bins(numberOfLines * numberOfBins, 1);
+    histogram::calculateDirectionalHistograms(directions.data(), offsets.data(), numberOfLines,
+                                              numberOfBins, bins.data());
+
+    for (size_t line = 0; line < numberOfLines; ++line) {
+        const std::vector<dvec3> lineDirections(directions.begin() + offsets[line],
+                                                directions.begin() + offsets[line + 1]);
+        const auto expected =
+            histogram::calculateDirectionalHistogram(lineDirections, numberOfBins);
+        EXPECT_TRUE(
+            std::equal(expected.begin(), expected.end(), bins.begin() + line * numberOfBins))
+            << "line " << line;
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,90 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/datastructures/integrallinefeatureindex.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+DataFrame createDataFrame() {
+    DataFrame df(5);
+    auto& ids = df.getIndexColumn()
+                    ->getTypedBuffer()
+                    ->getEditableRAMRepresentation()
+                    ->getDataContainer();
+    ids = {10, 11, 12, 13, 14};
+
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    df.addColumn<float>("Entropy", std::vector<float>{0.5f, 0.1f, nan, 0.9f, 0.3f});
+    df.addCategoricalColumn("Termination Reason", 5);
+    return df;
+}
+
+std::vector<std::uint32_t> toVector(IntegralLineFeatureIndex::LineRange range) {
+    return std::vector<std::uint32_t>(range.begin(), range.end());
+}
+
+}  // namespace
+
+TEST(IntegralLineFeatureIndexTest, Metrics) {
+    const IntegralLineFeatureIndex index(createDataFrame());
+
+    ASSERT_EQ(index.numberOfMetrics(), 1);
+    EXPECT_EQ(index.getName(0), "Entropy");
+    EXPECT_EQ(index.find("Entropy"), 0);
+    EXPECT_EQ(index.find("Termination Reason"), index.numberOfMetrics());
+    EXPECT_EQ(index.numberOfLines(), 15);
+    EXPECT_FLOAT_EQ(static_cast<float>(index.getRange(0).x), 0.1f);
+    EXPECT_FLOAT_EQ(static_cast<float>(index.getRange(0).y), 0.9f);
+}
+
+TEST(IntegralLineFeatureIndexTest, Queries) {
+    const IntegralLineFeatureIndex index(createDataFrame());
+
+    EXPECT_EQ(toVector(index.query(0, 0.2, 0.6)), (std::vector<std::uint32_t>{14, 10}));
+    EXPECT_EQ(toVector(index.query(0, 0.0, 1.0)), (std::vector<std::uint32_t>{11, 14, 10, 13}));
+    EXPECT_TRUE(toVector(index.query(0, 0.6, 0.8)).empty());
+
+    EXPECT_EQ(toVector(index.largest(0, 2)), (std::vector<std::uint32_t>{10, 13}));
+    EXPECT_EQ(toVector(index.smallest(0, 1)), (std::vector<std::uint32_t>{11}));
+    EXPECT_EQ(toVector(index.largest(0, 100)).size(), 4);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,99 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/algorithm/linemetrics.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <cmath>
+#include <vector>
+
+namespace inviwo {
+
+TEST(LineMetricsTest, StraightLine) {
+    std::vector<dvec3> positions;
+    for (int i = 0; i <= 10; ++i) positions.emplace_back(0.0, 0.2 * i, 0.0);
+
+    linemetrics::GeometricScratch scratch;
+    const auto metrics = linemetrics::geometricMetrics(positions, scratch);
+    EXPECT_NEAR(metrics.arcLength, 2.0, 1e-12);
+    EXPECT_NEAR(metrics.tortuosity, 1.0, 1e-12);
+    EXPECT_NEAR(metrics.meanCurvature, 0.0, 1e-12);
+    EXPECT_NEAR(metrics.maxCurvature, 0.0, 1e-12);
+    EXPECT_NEAR(metrics.meanTorsion, 0.0, 1e-12);
+}
+
+TEST(LineMetricsTest, Helix) {
+    // curvature r / (r^2 + c^2) = 0.8 and torsion c / (r^2 + c^2) = 0.4
+    const double r = 1.0;
+    const double c = 0.5;
+    std::vector<dvec3> positions;
+    for (int i = 0; i <= 1000; ++i) {
+        const double t = 0.01 * i;
+        positions.emplace_back(r * std::cos(t), r * std::sin(t), c * t);
+    }
+
+    linemetrics::GeometricScratch scratch;
+    const auto metrics = linemetrics::geometricMetrics(positions, scratch);
+    EXPECT_NEAR(metrics.arcLength, 10.0 * std::sqrt(r * r + c * c), 1e-3);
+    EXPECT_NEAR(metrics.meanCurvature, 0.8, 2e-3);
+    EXPECT_NEAR(metrics.maxCurvature, 0.8, 1e-3);
+    EXPECT_NEAR(metrics.meanTorsion, 0.4, 2e-3);
+}
+
+TEST(LineMetricsTest, CircleArcHasExactMaxCurvature) {
+    std::vector<dvec3> positions;
+    for (int i = 0; i <= 7; ++i) {
+        const double t = 0.3 * i;
+        positions.emplace_back(2.0 * std::cos(t), 2.0 * std::sin(t), 1.0);
+    }
+
+    linemetrics::GeometricScratch scratch;
+    const auto metrics = linemetrics::geometricMetrics(positions, scratch);
+    EXPECT_NEAR(metrics.maxCurvature, 0.5, 1e-12);
+    EXPECT_NEAR(metrics.meanTorsion, 0.0, 1e-12);
+}
+
+TEST(LineMetricsTest, ShortLines) {
+    linemetrics::GeometricScratch scratch;
+    const auto empty = linemetrics::geometricMetrics({}, scratch);
+    EXPECT_EQ(empty.arcLength, 0.0);
+
+    const auto segment =
+        linemetrics::geometricMetrics({dvec3{0.0}, dvec3{0.0, 0.0, 3.0}}, scratch);
+    EXPECT_NEAR(segment.arcLength, 3.0, 1e-12);
+    EXPECT_NEAR(segment.tortuosity, 1.0, 1e-12);
+    EXPECT_EQ(segment.meanCurvature, 0.0);
+    EXPECT_EQ(segment.meanTorsion, 0.0);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,98 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/algorithm/linesimplification.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <algorithm>
+#include <vector>
+
+namespace inviwo {
+
+TEST(LineSimplificationTest, CollinearVerticesAreDropped) {
+    std::vector<dvec3> positions;
+    for (int i = 0; i <= 100; ++i) positions.emplace_back(0.01 * i, 0.0, 0.0);
+
+    const auto kept = simplification::douglasPeucker(positions, 1e-6);
+    EXPECT_EQ(kept, (std::vector<size_t>{0, 100}));
+}
+
+TEST(LineSimplificationTest, CornersAreKept) {
+    const std::vector<dvec3> positions{{0.0, 0.0, 0.0}, {0.5, 0.0, 0.0}, {1.0, 0.0, 0.0},
+                                       {1.0, 0.5, 0.0}, {1.0, 1.0, 0.0}};
+
+    EXPECT_EQ(simplification::douglasPeucker(positions, 0.1),
+              (std::vector<size_t>{0, 2, 4}));
+    // a tolerance larger than the distance of the corner drops it as well
+    EXPECT_EQ(simplification::douglasPeucker(positions, 1.0), (std::vector<size_t>{0, 4}));
+}
+
+TEST(LineSimplificationTest, ShortLinesAreUnchanged) {
+    EXPECT_TRUE(simplification::douglasPeucker({}, 1.0).empty());
+    EXPECT_EQ(simplification::douglasPeucker({dvec3{0.0}, dvec3{1.0}}, 1.0),
+              (std::vector<size_t>{0, 1}));
+}
+
+TEST(LineSimplificationTest, ChannelsBoundTheInterpolationError) {
+    std::vector<dvec3> positions;
+    std::vector<dvec4> values;
+    for (int i = 0; i <= 10; ++i) {
+        positions.emplace_back(0.1 * i, 0.0, 0.0);
+        values.emplace_back(i == 5 ? 1.0 : 0.0);
+    }
+
+    EXPECT_EQ(simplification::douglasPeucker(positions, 0.01, {values}, 0.0),
+              (std::vector<size_t>{0, 10}));
+    const auto kept = simplification::douglasPeucker(positions, 0.01, {values}, 0.1);
+    EXPECT_NE(std::find(kept.begin(), kept.end(), size_t{5}), kept.end());
+}
+
+TEST(LineSimplificationTest, SimplifyKeepsMetaDataOfKeptVertices) {
+    IntegralLine line;
+    auto& positions = line.getPositions();
+    auto& velocities = line.getMetaData<dvec3>("velocity", true);
+    for (int i = 0; i <= 10; ++i) {
+        positions.emplace_back(0.1 * i, i == 5 ? 0.5 : 0.0, 0.0);
+        velocities.emplace_back(static_cast<double>(i));
+    }
+    line.setIndex(7);
+
+    const auto simplified = simplification::simplify(line, 0.01);
+    ASSERT_EQ(simplified.getPositions().size(), 5);
+    const auto& simplifiedVelocities = simplified.getMetaData<dvec3>("velocity");
+    ASSERT_EQ(simplifiedVelocities.size(), 5);
+    EXPECT_EQ(simplifiedVelocities[2], dvec3{5.0});
+    EXPECT_EQ(simplified.getIndex(), 7);
+}
+
+}  // namespace inviwo
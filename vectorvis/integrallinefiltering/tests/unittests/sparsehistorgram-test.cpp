@@ -35,6 +35,7 @@
 #include <warn/pop>
 
 #include <random>
+#include <utility>
 
 namespace inviwo {
 
@@ -79,4 +80,46 @@ TEST(SpraseHistgoramTest, SizeAndCleanup) {
     EXPECT_EQ(histogram.numberOfBins(), 1);
 }
 
+TEST(SpraseHistgoramTest, GrowAndClear) {
+    auto histogram = SparseHistogram<ivec2>();
+
+    // more bins than fit in the inline storage
+    for (int i = 0; i < 100; i++) {
+        histogram[ivec2(i % 50, -(i % 50) % 7)]++;
+    }
+    EXPECT_EQ(histogram.numberOfBins(), 50);
+    EXPECT_EQ(std::as_const(histogram)[ivec2(3, -3)], 2);
+    EXPECT_EQ(std::as_const(histogram)[ivec2(3, 3)], 0);
+
+    size_t total = 0;
+    for (const auto& bin : histogram) {
+        total += bin.second;
+    }
+    EXPECT_EQ(total, 100);
+
+    histogram.clear();
+    EXPECT_EQ(histogram.numberOfBins(), 0);
+    EXPECT_TRUE(histogram.begin() == histogram.end());
+
+    histogram[ivec2(1, 2)]++;
+    EXPECT_EQ(histogram.numberOfBins(), 1);
+    EXPECT_EQ(std::as_const(histogram)[ivec2(1, 2)], 1);
+}
+
+TEST(SpraseHistgoramTest, CopyAndMove) {
+    auto histogram = SparseHistogram<int>();
+    for (int i = -20; i < 20; i++) {
+        histogram[i] += 2;
+    }
+
+    auto copy = histogram;
+    EXPECT_EQ(copy.numberOfBins(), 40);
+    EXPECT_EQ(std::as_const(copy)[-20], 2);
+
+    auto moved = std::move(copy);
+    EXPECT_EQ(moved.numberOfBins(), 40);
+    EXPECT_EQ(std::as_const(moved)[19], 2);
+    EXPECT_EQ(std::as_const(histogram)[0], 2);
+}
+
 }  // namespace inviwo
\ No newline at end of file
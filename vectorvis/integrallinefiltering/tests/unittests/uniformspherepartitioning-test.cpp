@@ -0,0 +1,77 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/integrallinefiltering/algorithm/uniformspherepartitioning.h>
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <random>
+
+namespace inviwo {
+
+TEST(UniformSpherePartitioningTest, LookupMatchesExact) {
+    std::mt19937 rand;
+    std::normal_distribution<double> dist;
+
+    for (size_t segments : {3, 10, 33, 100, 1000}) {
+        const UniformSpherePartitioning<double> partitioning(segments);
+        EXPECT_EQ(partitioning.numberOfPatches(), segments);
+
+        std::vector<dvec3> directions{dvec3(0, 0, 1),  dvec3(0, 0, -1), dvec3(1, 0, 0),
+                                      dvec3(-1, 0, 0), dvec3(0, 1, 0),  dvec3(0, -1, 0),
+                                      dvec3(0, 0, 0)};
+        for (size_t i = 0; i < 100000; ++i) {
+            directions.emplace_back(dist(rand), dist(rand), dist(rand));
+        }
+        std::vector<size_t> regions(directions.size());
+        partitioning.getRegionsForDirections(directions.data(), directions.size(),
+                                             regions.data());
+
+        for (size_t i = 0; i < directions.size(); ++i) {
+            ASSERT_EQ(regions[i], partitioning.getExactRegionForDirection(directions[i]))
+                << "segments " << segments << ", direction " << directions[i];
+            EXPECT_LT(regions[i], segments);
+        }
+    }
+}
+
+TEST(UniformSpherePartitioningTest, SharedPartitionings) {
+    const auto a = UniformSpherePartitioning<float>::get(33);
+    const auto b = UniformSpherePartitioning<float>::get(33);
+    const auto c = UniformSpherePartitioning<float>::get(34);
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(c->numberOfPatches(), 34);
+}
+
+}  // namespace inviwo